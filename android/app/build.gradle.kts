@@ -34,6 +34,13 @@ android {
         ndk {
             abiFilters.add("arm64-v8a")
         }
+
+        // GPU offload for llama.cpp: -PracLlamaCppGpu=VULKAN or OPENCL (default CPU only)
+        externalNativeBuild {
+            cmake {
+                arguments += "-DRAC_LLAMACPP_GPU=${project.findProperty("racLlamaCppGpu") ?: "NONE"}"
+            }
+        }
     }
 
     buildTypes {
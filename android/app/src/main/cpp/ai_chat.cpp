@@ -1,8 +1,25 @@
 #include <android/log.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sched.h>
 #include <sstream>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/system_properties.h>
+#include <thread>
 #include <unistd.h>
 #include <vector>
 
@@ -20,83 +37,568 @@
 constexpr int N_THREADS_MIN = 2;
 constexpr int N_THREADS_MAX = 4;
 constexpr int N_THREADS_HEADROOM = 2;
-constexpr int DEFAULT_CONTEXT_SIZE = 256;
+
+// Thread autotuning: candidate thread counts are timed once per device model
+// and the winners cached in the state cache dir.
+constexpr int TUNING_PREFILL_TOKENS = 64;
+constexpr int TUNING_DECODE_STEPS = 8;
+constexpr const char* TUNING_CACHE_FILE = "/thread_tuning.cfg";
+
+constexpr int DEFAULT_CONTEXT_SIZE = 256;  // per session
+constexpr int MAX_SESSIONS = 4;
 constexpr int OVERFLOW_HEADROOM = 4;
-constexpr int BATCH_SIZE = 1;
+
+// Sliding-window context policy: the first tokens of a sequence (attention
+// sinks, covered by the system prompt when there is one) are never evicted and
+// the oldest conversation tokens are dropped a few at a time as the window fills.
+constexpr int DEFAULT_SINK_TOKENS = 4;
+constexpr int DEFAULT_EVICT_CHUNK = 16;
 constexpr float DEFAULT_SAMPLER_TEMP = 0.7f;
 
+// Idle-time KV compaction: after a turn, a session whose KV stream has at least
+// this share of holes (and at least KV_COMPACT_MIN_HOLES of them) is repacked
+// into contiguous cells before the next turn. A decode that finds no free slot
+// repacks its session right away.
+constexpr float KV_COMPACT_FRAGMENTATION = 0.25f;
+constexpr int KV_COMPACT_MIN_HOLES = 32;
+
+// Prefill batching: prompts are decoded in chunks of up to g_prefill_batch_size
+// tokens; generation always decodes a single token per step.
+constexpr int PREFILL_BATCH_MIN = 32;
+constexpr int PREFILL_BATCH_MAX = 512;
+// Rough activation footprint per batched token, in floats per embedding dim
+constexpr int PREFILL_ACTIVATION_FACTOR = 16;
+// Fraction of currently available RAM the prefill compute buffers may claim
+constexpr int PREFILL_MEMORY_BUDGET_DIVISOR = 16;
+
+// System-prompt KV snapshots
+constexpr uint32_t KV_SNAPSHOT_MAGIC = 0x564B4941;  // "AIKV"
+constexpr uint32_t KV_SNAPSHOT_VERSION = 1;
+constexpr size_t MODEL_FINGERPRINT_SAMPLE = 64 * 1024;
+
+struct KvSnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t model_fingerprint;
+    uint32_t n_ctx;
+    uint32_t n_tokens;
+    uint64_t state_size;
+};
+
+// Token streaming: the generation thread appends complete UTF-8 pieces to an
+// SPSC byte ring and Dart drains it in batches after a listener notification.
+constexpr size_t TOKEN_RING_CAPACITY = 64 * 1024;
+constexpr auto TOKEN_RING_FULL_BACKOFF = std::chrono::milliseconds(1);
+
+enum TokenStreamEvent : int32_t {
+    TOKEN_STREAM_DATA = 0,
+    TOKEN_STREAM_DONE = 1,
+    TOKEN_STREAM_ERROR = 2,
+    TOKEN_STREAM_CANCELLED = 3,
+};
+
+// Invoked from the generation thread; Dart registers a NativeCallable.listener
+typedef void (*token_stream_listener_fn)(int32_t event);
+
+class TokenRing {
+   public:
+    void reset() {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    size_t free_space() const {
+        return TOKEN_RING_CAPACITY - (head_.load(std::memory_order_relaxed) -
+                                      tail_.load(std::memory_order_acquire));
+    }
+
+    // Producer only. Caller guarantees `size <= free_space()`.
+    void write(const char* bytes, const size_t size) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < size; i++) {
+            data_[(head + i) % TOKEN_RING_CAPACITY] = bytes[i];
+        }
+        head_.store(head + size, std::memory_order_release);
+    }
+
+    // Consumer only. Never splits a UTF-8 sequence, so every drain is valid text.
+    size_t read(char* out, const size_t capacity) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t available = head_.load(std::memory_order_acquire) - tail;
+        size_t n = std::min(available, capacity);
+        while (n > 0 && n < available &&
+               ((unsigned char)data_[(tail + n) % TOKEN_RING_CAPACITY] & 0xC0) == 0x80) {
+            n--;
+        }
+        for (size_t i = 0; i < n; i++) {
+            out[i] = data_[(tail + i) % TOKEN_RING_CAPACITY];
+        }
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+   private:
+    char data_[TOKEN_RING_CAPACITY];
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+};
+
+// Sampler chain settings. An empty grammar leaves output unconstrained; a GBNF
+// grammar (e.g. a tool-call JSON schema) is enforced token by token.
+struct SamplerSpec {
+    int32_t top_k = 40;
+    float top_p = 0.95f;
+    float min_p = 0.0f;
+    float temp = DEFAULT_SAMPLER_TEMP;
+    int32_t penalty_last_n = 64;
+    float penalty_repeat = 1.0f;
+    float penalty_freq = 0.0f;
+    float penalty_present = 0.0f;
+    std::string grammar;
+};
+
+struct ChatTurn {
+    std::string role;
+    std::string content;
+};
+
+// A conversation bound to one llama sequence of the shared context. Sessions
+// share the model, context and batch; switching between them is a pointer swap.
+struct ChatSession {
+    llama_seq_id seq_id = 0;
+    llama_sampler* sampler = nullptr;
+    SamplerSpec sampler_spec;
+
+    // Turns rendered through the model's chat template. chat_text is the
+    // rendered text the sequence holds, so a new turn only tokenizes the delta.
+    std::vector<ChatTurn> chat_history;
+    std::string chat_text;
+    bool reply_pending = false;
+    llama_pos system_prompt_position = 0;
+    llama_pos current_position = 0;
+    llama_pos stop_generation_position = 0;
+    llama_pos turn_start_position = 0;  // rollback point if the turn is cancelled
+    size_t turn_start_text_length = 0;
+    std::string cached_token_chars;
+    std::ostringstream assistant_ss;
+
+    // Cells evictions freed inside the session's KV stream since it was last
+    // packed, measured on the cache. llama.cpp refills some of them, so this
+    // is an upper bound.
+    int kv_holes = 0;
+};
+
 // Global state
 static llama_model* g_model = nullptr;
 static llama_context* g_context = nullptr;
 static llama_batch g_batch;
-static llama_sampler* g_sampler = nullptr;
+static int g_prefill_batch_size = PREFILL_BATCH_MIN;
+static std::string g_state_cache_dir;
+static uint64_t g_model_fingerprint = 0;
+static std::vector<int> g_performance_cores;
+static std::string g_chat_template;
+static SamplerSpec g_default_sampler_spec;  // applied to newly created sessions
+static int g_sink_tokens = DEFAULT_SINK_TOKENS;
+static int g_evict_chunk = DEFAULT_EVICT_CHUNK;
+
+static TokenRing g_token_ring;
+static std::atomic<token_stream_listener_fn> g_token_listener{nullptr};
+static std::atomic<bool> g_token_notify_pending{false};
 
-static std::vector<llama_chat_message> chat_msgs;
-static llama_pos system_prompt_position = 0;
-static llama_pos current_position = 0;
-static llama_pos stop_generation_position = 0;
-static std::string cached_token_chars;
-static std::ostringstream assistant_ss;
+// Generation worker: a native thread that runs prefill and decode for queued
+// commands, so neither blocks the Dart isolate. Stop ends the turn keeping what
+// was generated; cancel also aborts an in-flight llama_decode and rolls the
+// session back to where the turn started.
+enum class WorkerCommandType { PROMPT_AND_GENERATE, GENERATE, EXIT };
+
+struct WorkerCommand {
+    WorkerCommandType type;
+    ChatSession* session = nullptr;
+    std::string prompt;
+    int n_predict = 0;
+};
+
+static std::thread g_worker_thread;
+static std::mutex g_worker_mutex;
+static std::condition_variable g_worker_cv;
+static std::deque<WorkerCommand> g_worker_queue;
+static bool g_worker_busy = false;
+static std::atomic<bool> g_generation_stop{false};
+static std::atomic<bool> g_generation_cancel{false};
+
+// Indexed by sequence id; g_session is the one the prompt/generate calls act on
+static std::unique_ptr<ChatSession> g_sessions[MAX_SESSIONS];
+static ChatSession* g_session = nullptr;
+
+// KV cache metrics, written by whichever thread owns the sessions and read by
+// get_kv_cache_stats_ffi at any time
+static std::atomic<float> g_kv_fragmentation{0.0f};
+static std::atomic<int> g_kv_compactions{0};
+static std::atomic<double> g_kv_compaction_ms{0.0};
+
+// ----------------------------------------------------------------------------
+// KV cache fragmentation
+// ----------------------------------------------------------------------------
+
+// Cells the session's sequence holds, read from the cache. Evictions slide the
+// later tokens back, so its positions stay contiguous.
+static int kv_occupancy(const ChatSession& session) {
+    if (!g_context) {
+        return 0;
+    }
+    llama_memory_t memory = llama_get_memory(g_context);
+    const llama_pos pos_max = llama_memory_seq_pos_max(memory, session.seq_id);
+    if (pos_max < 0) {
+        return 0;
+    }
+    return pos_max - llama_memory_seq_pos_min(memory, session.seq_id) + 1;
+}
+
+static void update_kv_fragmentation() {
+    int span = 0;
+    int holes = 0;
+    for (const auto& session : g_sessions) {
+        if (session) {
+            span += kv_occupancy(*session) + session->kv_holes;
+            holes += session->kv_holes;
+        }
+    }
+    g_kv_fragmentation.store(span > 0 ? (float)holes / (float)span : 0.0f,
+                             std::memory_order_relaxed);
+}
 
 // Helper functions
-static void reset_long_term_states(const bool clear_kv_cache = true) {
-    chat_msgs.clear();
-    system_prompt_position = 0;
-    current_position = 0;
+static void reset_long_term_states(ChatSession& session, const bool clear_kv_cache = true) {
+    session.chat_history.clear();
+    session.chat_text.clear();
+    session.reply_pending = false;
+    session.system_prompt_position = 0;
+    session.current_position = 0;
     
     if (clear_kv_cache && g_context) {
-        llama_memory_clear(llama_get_memory(g_context), false);
+        llama_memory_seq_rm(llama_get_memory(g_context), session.seq_id, -1, -1);
+        session.kv_holes = 0;
+        update_kv_fragmentation();
     }
 }
 
-static void reset_short_term_states() {
-    stop_generation_position = 0;
-    cached_token_chars.clear();
-    assistant_ss.str("");
+static void reset_short_term_states(ChatSession& session) {
+    session.stop_generation_position = 0;
+    session.cached_token_chars.clear();
+    session.assistant_ss.str("");
 }
 
-static void shift_context() {
-    const int n_discard = (current_position - system_prompt_position) / 2;
-    LOGi("Discarding %d tokens", n_discard);
-    llama_memory_seq_rm(llama_get_memory(g_context), 0, system_prompt_position, 
-                       system_prompt_position + n_discard);
-    llama_memory_seq_add(llama_get_memory(g_context), 0, 
-                        system_prompt_position + n_discard, current_position, -n_discard);
-    current_position -= n_discard;
-    LOGi("Context shifting done! Current position: %d", current_position);
+// Frees room for `n_needed` more tokens by evicting the oldest tokens after the
+// protected prefix (system prompt / attention sinks) and sliding the rest back.
+// Evicts at least g_evict_chunk tokens so small steps don't shift on every token.
+static bool shift_context(ChatSession& session, const int n_needed) {
+    llama_memory_t memory = llama_get_memory(g_context);
+    if (!llama_memory_can_shift(memory)) {
+        LOGe("Model memory does not support context shifting");
+        return false;
+    }
+
+    const int n_keep = std::max((int)session.system_prompt_position, g_sink_tokens);
+    const int n_evictable = session.current_position - n_keep;
+    const int n_discard = std::min(n_evictable, std::max(n_needed, g_evict_chunk));
+    if (n_discard <= 0 || n_discard < n_needed) {
+        LOGe("Cannot free %d tokens (keep=%d, position=%d)", n_needed, n_keep,
+             session.current_position);
+        return false;
+    }
+
+    const int n_occupied = kv_occupancy(session);
+    llama_memory_seq_rm(memory, session.seq_id, n_keep, n_keep + n_discard);
+    llama_memory_seq_add(memory, session.seq_id, n_keep + n_discard, session.current_position,
+                         -n_discard);
+    session.kv_holes += n_occupied - kv_occupancy(session);
+    update_kv_fragmentation();
+    session.current_position -= n_discard;
+    session.turn_start_position = std::max((llama_pos)n_keep, session.turn_start_position - n_discard);
+    LOGd("Evicted %d tokens from session %d (keep=%d), position now %d", n_discard,
+         session.seq_id, n_keep, session.current_position);
+    return true;
 }
 
-static int decode_tokens_in_batches(llama_context* context, llama_batch& batch,
-                                    const std::vector<llama_token>& tokens,
-                                    const llama_pos start_pos,
+// Repacks the session's sequence into the front of its KV stream. llama.cpp
+// cannot move cells in place, so the sequence is saved, removed and restored,
+// which places it in contiguous cells from the head that the removal reset.
+// Positions are unchanged, so the session state needs no update.
+static bool compact_kv_stream(ChatSession& session) {
+    const auto start = std::chrono::steady_clock::now();
+    const int holes = session.kv_holes;
+    const size_t state_size = llama_state_seq_get_size(g_context, session.seq_id);
+    std::vector<uint8_t> state(state_size);
+    if (state_size == 0 ||
+        llama_state_seq_get_data(g_context, state.data(), state.size(), session.seq_id) != state_size) {
+        LOGw("Failed to read KV state of session %d for compaction", session.seq_id);
+        return false;
+    }
+
+    llama_memory_seq_rm(llama_get_memory(g_context), session.seq_id, -1, -1);
+    session.kv_holes = 0;
+    if (llama_state_seq_set_data(g_context, state.data(), state.size(), session.seq_id) != state_size) {
+        LOGe("Failed to restore KV state of session %d after compaction, resetting it",
+             session.seq_id);
+        reset_long_term_states(session);
+        reset_short_term_states(session);
+        return false;
+    }
+    update_kv_fragmentation();
+
+    const double ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    g_kv_compactions.fetch_add(1, std::memory_order_relaxed);
+    g_kv_compaction_ms.store(g_kv_compaction_ms.load(std::memory_order_relaxed) + ms,
+                             std::memory_order_relaxed);
+    LOGd("Compacted KV of session %d: %d holes, %.2f ms", session.seq_id, holes, ms);
+    return true;
+}
+
+// llama_decode returns 1 when the batch finds no free cells. Holes the
+// estimate missed can cause that, so the session is repacked and the batch
+// retried once.
+static int decode_session_batch(ChatSession& session, llama_context* context, llama_batch& batch) {
+    const int result = llama_decode(context, batch);
+    if (result != 1 || !compact_kv_stream(session)) {
+        return result;
+    }
+    LOGw("No KV slot for session %d, retrying after compaction", session.seq_id);
+    return llama_decode(context, batch);
+}
+
+// Runs in the idle gap after a turn: compacts every session whose stream has
+// fragmented past KV_COMPACT_FRAGMENTATION.
+static void compact_fragmented_sessions() {
+    for (const auto& session : g_sessions) {
+        if (!session) {
+            continue;
+        }
+        const int holes = session->kv_holes;
+        const int span = kv_occupancy(*session) + holes;
+        if (holes < KV_COMPACT_MIN_HOLES || (float)holes < KV_COMPACT_FRAGMENTATION * (float)span) {
+            continue;
+        }
+        compact_kv_stream(*session);
+    }
+}
+
+static size_t available_memory_bytes() {
+    const long pages = sysconf(_SC_AVPHYS_PAGES);
+    const long page_size = sysconf(_SC_PAGE_SIZE);
+    if (pages <= 0 || page_size <= 0) {
+        return 0;
+    }
+    return (size_t)pages * (size_t)page_size;
+}
+
+// Pick the largest power-of-two prefill batch whose compute buffers fit into a
+// small slice of the currently available memory.
+static int select_prefill_batch_size(const llama_model* model, const int n_ctx) {
+    const size_t n_embd = (size_t)llama_model_n_embd(model);
+    const size_t n_head = (size_t)llama_model_n_head(model);
+    const size_t bytes_per_token =
+        n_embd * sizeof(float) * PREFILL_ACTIVATION_FACTOR + (size_t)n_ctx * n_head * sizeof(float);
+    const size_t budget = available_memory_bytes() / PREFILL_MEMORY_BUDGET_DIVISOR;
+
+    int batch_size = PREFILL_BATCH_MAX;
+    while (batch_size > PREFILL_BATCH_MIN && (size_t)batch_size * bytes_per_token > budget) {
+        batch_size /= 2;
+    }
+
+    const int ctx_limit = n_ctx - OVERFLOW_HEADROOM;
+    batch_size = std::min(batch_size, ctx_limit);
+    LOGi("Prefill batch size: %d (budget %zu bytes, %zu bytes/token)", batch_size, budget,
+         bytes_per_token);
+    return std::max(1, batch_size);
+}
+
+// Decodes `tokens` into the session's sequence starting at its current position,
+// in chunks of up to n_batch tokens, and advances current_position past them.
+static int decode_tokens_in_batches(ChatSession& session, llama_context* context, llama_batch& batch,
+                                    const std::vector<llama_token>& tokens, const int n_batch,
                                     const bool compute_last_logit = false) {
-    LOGd("Decode %d tokens starting at position %d", (int)tokens.size(), start_pos);
-    
-    for (int i = 0; i < (int)tokens.size(); i += BATCH_SIZE) {
-        const int cur_batch_size = std::min((int)tokens.size() - i, BATCH_SIZE);
+    const int n_tokens = (int)tokens.size();
+    LOGd("Decode %d tokens starting at position %d in chunks of %d", n_tokens,
+         session.current_position, n_batch);
+
+    for (int i = 0; i < n_tokens; i += n_batch) {
+        const int cur_batch_size = std::min(n_tokens - i, n_batch);
         common_batch_clear(batch);
-        
-        if (start_pos + i + cur_batch_size >= DEFAULT_CONTEXT_SIZE - OVERFLOW_HEADROOM) {
-            LOGw("Current batch won't fit into context! Shifting...");
-            shift_context();
+
+        const int n_overflow = session.current_position + cur_batch_size -
+                               (DEFAULT_CONTEXT_SIZE - OVERFLOW_HEADROOM) + 1;
+        if (n_overflow > 0 && !shift_context(session, n_overflow)) {
+            return 1;
         }
-        
+
         for (int j = 0; j < cur_batch_size; j++) {
             const llama_token token_id = tokens[i + j];
-            const llama_pos position = start_pos + i + j;
-            const bool want_logit = compute_last_logit && (i + j == tokens.size() - 1);
-            common_batch_add(batch, token_id, position, {0}, want_logit);
+            const llama_pos position = session.current_position + j;
+            const bool want_logit = compute_last_logit && (i + j == n_tokens - 1);
+            common_batch_add(batch, token_id, position, {session.seq_id}, want_logit);
         }
-        
-        const int decode_result = llama_decode(context, batch);
+
+        const int decode_result = decode_session_batch(session, context, batch);
         if (decode_result) {
             LOGe("llama_decode failed w/ %d", decode_result);
             return 1;
         }
+        session.current_position += cur_batch_size;
     }
+    update_kv_fragmentation();
     return 0;
 }
 
+// ----------------------------------------------------------------------------
+// System prompt KV snapshot persistence
+// ----------------------------------------------------------------------------
+
+static uint64_t fnv1a_64(const void* data, const size_t size, uint64_t hash = 0xcbf29ce484222325ULL) {
+    const auto* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Cheap model identity: file size plus the first and last 64 KB, which covers
+// the GGUF header/metadata and the tail of the tensor data.
+static uint64_t compute_model_fingerprint(const char* model_path) {
+    const int fd = open(model_path, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return 0;
+    }
+
+    const uint64_t file_size = (uint64_t)st.st_size;
+    uint64_t hash = fnv1a_64(&file_size, sizeof(file_size));
+
+    std::vector<unsigned char> sample(MODEL_FINGERPRINT_SAMPLE);
+    ssize_t n = pread(fd, sample.data(), sample.size(), 0);
+    if (n > 0) {
+        hash = fnv1a_64(sample.data(), (size_t)n, hash);
+    }
+    if (file_size > MODEL_FINGERPRINT_SAMPLE) {
+        n = pread(fd, sample.data(), sample.size(), (off_t)(file_size - MODEL_FINGERPRINT_SAMPLE));
+        if (n > 0) {
+            hash = fnv1a_64(sample.data(), (size_t)n, hash);
+        }
+    }
+
+    close(fd);
+    return hash;
+}
+
+static std::string kv_snapshot_path(const std::vector<llama_token>& tokens) {
+    if (g_state_cache_dir.empty() || g_model_fingerprint == 0) {
+        return "";
+    }
+    const uint64_t prompt_hash = fnv1a_64(tokens.data(), tokens.size() * sizeof(llama_token));
+    char name[96];
+    snprintf(name, sizeof(name), "/sysprompt-%016llx-%016llx.kv",
+             (unsigned long long)g_model_fingerprint, (unsigned long long)prompt_hash);
+    return g_state_cache_dir + name;
+}
+
+// Maps a snapshot file and restores the session's sequence from it. Returns true
+// only if the snapshot matches the model, context size and exact prompt tokens.
+static bool restore_kv_snapshot(ChatSession& session, const std::string& path,
+                                const std::vector<llama_token>& tokens) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(KvSnapshotHeader)) {
+        close(fd);
+        return false;
+    }
+
+    const size_t file_size = (size_t)st.st_size;
+    void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    bool restored = false;
+    const auto* base = (const uint8_t*)mapping;
+    KvSnapshotHeader header{};
+    memcpy(&header, base, sizeof(header));
+
+    const size_t tokens_bytes = (size_t)header.n_tokens * sizeof(llama_token);
+    const bool header_ok = header.magic == KV_SNAPSHOT_MAGIC &&
+                           header.version == KV_SNAPSHOT_VERSION &&
+                           header.model_fingerprint == g_model_fingerprint &&
+                           header.n_ctx == llama_n_ctx(g_context) &&
+                           header.n_tokens == tokens.size() &&
+                           sizeof(header) + tokens_bytes + header.state_size == file_size;
+
+    if (header_ok && memcmp(base + sizeof(header), tokens.data(), tokens_bytes) == 0) {
+        const uint8_t* state = base + sizeof(header) + tokens_bytes;
+        restored = llama_state_seq_set_data(g_context, state, header.state_size, session.seq_id) ==
+                   header.state_size;
+        if (!restored) {
+            LOGw("KV snapshot rejected by llama.cpp, re-decoding: %s", path.c_str());
+            llama_memory_seq_rm(llama_get_memory(g_context), session.seq_id, -1, -1);
+        }
+    }
+
+    munmap(mapping, file_size);
+    return restored;
+}
+
+// Writes the session's sequence to a temp file and renames it into place so a
+// crash never leaves a truncated snapshot behind.
+static void save_kv_snapshot(const ChatSession& session, const std::string& path,
+                             const std::vector<llama_token>& tokens) {
+    const size_t state_size = llama_state_seq_get_size(g_context, session.seq_id);
+    if (state_size == 0) {
+        return;
+    }
+
+    std::vector<uint8_t> state(state_size);
+    if (llama_state_seq_get_data(g_context, state.data(), state.size(), session.seq_id) != state_size) {
+        LOGw("Failed to read KV state for snapshot");
+        return;
+    }
+
+    KvSnapshotHeader header{};
+    header.magic = KV_SNAPSHOT_MAGIC;
+    header.version = KV_SNAPSHOT_VERSION;
+    header.model_fingerprint = g_model_fingerprint;
+    header.n_ctx = llama_n_ctx(g_context);
+    header.n_tokens = (uint32_t)tokens.size();
+    header.state_size = state_size;
+
+    const std::string tmp_path = path + ".tmp";
+    FILE* file = fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        LOGw("Cannot create KV snapshot: %s", tmp_path.c_str());
+        return;
+    }
+
+    const bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                         fwrite(tokens.data(), sizeof(llama_token), tokens.size(), file) == tokens.size() &&
+                         fwrite(state.data(), 1, state.size(), file) == state.size();
+    const bool closed = fclose(file) == 0;
+
+    if (!written || !closed || rename(tmp_path.c_str(), path.c_str()) != 0) {
+        LOGw("Failed to write KV snapshot: %s", path.c_str());
+        unlink(tmp_path.c_str());
+        return;
+    }
+    LOGi("Saved system prompt KV snapshot (%zu bytes): %s", state_size, path.c_str());
+}
+
 static bool is_valid_utf8(const char* string) {
     if (!string) return true;
     
@@ -127,6 +629,584 @@ static bool is_valid_utf8(const char* string) {
     return true;
 }
 
+// ----------------------------------------------------------------------------
+// CPU topology and thread tuning
+// ----------------------------------------------------------------------------
+
+static long read_cpu_max_freq(const int cpu) {
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return -1;
+    }
+    long freq = -1;
+    if (fscanf(file, "%ld", &freq) != 1) {
+        freq = -1;
+    }
+    fclose(file);
+    return freq;
+}
+
+// Cores outside the slowest frequency cluster. Empty if the topology can't be
+// read or all cores are identical (nothing to prefer).
+static std::vector<int> detect_performance_cores() {
+    const int n_cpus = (int)sysconf(_SC_NPROCESSORS_CONF);
+    std::map<long, std::vector<int>> clusters;
+    for (int cpu = 0; cpu < n_cpus; cpu++) {
+        const long freq = read_cpu_max_freq(cpu);
+        if (freq <= 0) {
+            return {};
+        }
+        clusters[freq].push_back(cpu);
+    }
+    if (clusters.size() < 2) {
+        return {};
+    }
+
+    std::vector<int> cores;
+    for (auto it = std::next(clusters.begin()); it != clusters.end(); ++it) {
+        cores.insert(cores.end(), it->second.begin(), it->second.end());
+    }
+    std::sort(cores.begin(), cores.end());
+    return cores;
+}
+
+// ggml creates its compute threads from the decoding thread, so they inherit
+// this affinity mask.
+static void pin_current_thread_to_performance_cores() {
+    if (g_performance_cores.empty()) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const int cpu : g_performance_cores) {
+        CPU_SET(cpu, &set);
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        LOGw("sched_setaffinity failed; running unpinned");
+    }
+}
+
+static std::string device_model_name() {
+    char value[PROP_VALUE_MAX] = {0};
+    if (__system_property_get("ro.product.model", value) <= 0) {
+        return "unknown";
+    }
+    std::string name(value);
+    std::replace(name.begin(), name.end(), ' ', '_');
+    return name;
+}
+
+static bool load_cached_thread_tuning(const std::string& device, int& n_threads, int& n_threads_batch) {
+    if (g_state_cache_dir.empty()) {
+        return false;
+    }
+    FILE* file = fopen((g_state_cache_dir + TUNING_CACHE_FILE).c_str(), "r");
+    if (!file) {
+        return false;
+    }
+    char cached_device[PROP_VALUE_MAX + 1] = {0};
+    const bool ok = fscanf(file, "%92s %d %d", cached_device, &n_threads, &n_threads_batch) == 3 &&
+                    device == cached_device && n_threads > 0 && n_threads_batch > 0;
+    fclose(file);
+    return ok;
+}
+
+static void save_thread_tuning(const std::string& device, const int n_threads, const int n_threads_batch) {
+    if (g_state_cache_dir.empty()) {
+        return;
+    }
+    FILE* file = fopen((g_state_cache_dir + TUNING_CACHE_FILE).c_str(), "w");
+    if (!file) {
+        return;
+    }
+    fprintf(file, "%s %d %d\n", device.c_str(), n_threads, n_threads_batch);
+    fclose(file);
+}
+
+static double elapsed_ms(const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Times one prefill chunk and a few single-token steps on scratch sequence 0.
+static void time_decode(const int n_threads, double& prefill_ms, double& decode_ms) {
+    const llama_token token = llama_vocab_bos(llama_model_get_vocab(g_model));
+    const int n_prefill = std::min(TUNING_PREFILL_TOKENS, g_prefill_batch_size);
+    llama_set_n_threads(g_context, n_threads, n_threads);
+
+    common_batch_clear(g_batch);
+    for (int i = 0; i < n_prefill; i++) {
+        common_batch_add(g_batch, token, i, {0}, i == n_prefill - 1);
+    }
+    auto start = std::chrono::steady_clock::now();
+    llama_decode(g_context, g_batch);
+    prefill_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < TUNING_DECODE_STEPS; i++) {
+        common_batch_clear(g_batch);
+        common_batch_add(g_batch, token, n_prefill + i, {0}, true);
+        llama_decode(g_context, g_batch);
+    }
+    decode_ms = elapsed_ms(start);
+
+    llama_memory_seq_rm(llama_get_memory(g_context), 0, -1, -1);
+}
+
+// Chooses n_threads (decode) and n_threads_batch (prefill) separately; decode is
+// memory-bound and usually peaks below the core count, prefill scales further.
+static void autotune_threads(int& n_threads, int& n_threads_batch) {
+    const std::string device = device_model_name();
+    if (load_cached_thread_tuning(device, n_threads, n_threads_batch)) {
+        LOGi("Thread tuning (cached for %s): decode=%d, batch=%d", device.c_str(), n_threads,
+             n_threads_batch);
+        llama_set_n_threads(g_context, n_threads, n_threads_batch);
+        return;
+    }
+
+    const int max_threads = g_performance_cores.empty() ? (int)sysconf(_SC_NPROCESSORS_ONLN)
+                                                        : (int)g_performance_cores.size();
+    double best_prefill = 0, best_decode = 0;
+    std::thread calibration([&] {
+        pin_current_thread_to_performance_cores();
+        time_decode(1, best_prefill, best_decode);  // warm-up, discarded
+        best_prefill = best_decode = 0;
+        for (int candidate = 1; candidate <= max_threads; candidate++) {
+            double prefill_ms = 0, decode_ms = 0;
+            time_decode(candidate, prefill_ms, decode_ms);
+            LOGd("Thread tuning: %d threads -> prefill %.1f ms, decode %.1f ms", candidate,
+                 prefill_ms, decode_ms);
+            if (best_decode == 0 || decode_ms < best_decode) {
+                best_decode = decode_ms;
+                n_threads = candidate;
+            }
+            if (best_prefill == 0 || prefill_ms < best_prefill) {
+                best_prefill = prefill_ms;
+                n_threads_batch = candidate;
+            }
+        }
+    });
+    calibration.join();
+
+    LOGi("Thread tuning for %s: decode=%d, batch=%d", device.c_str(), n_threads, n_threads_batch);
+    llama_set_n_threads(g_context, n_threads, n_threads_batch);
+    save_thread_tuning(device, n_threads, n_threads_batch);
+}
+
+// ----------------------------------------------------------------------------
+// Chat template
+// ----------------------------------------------------------------------------
+
+// Renders messages with g_chat_template; returns false if the template is unsupported.
+static bool render_chat(const std::vector<ChatTurn>& turns, const bool add_assistant, std::string& out) {
+    std::vector<llama_chat_message> messages;
+    messages.reserve(turns.size());
+    for (const auto& turn : turns) {
+        messages.push_back({turn.role.c_str(), turn.content.c_str()});
+    }
+    
+    out.resize(std::max<size_t>(1024, out.capacity()));
+    int32_t len = llama_chat_apply_template(g_chat_template.c_str(), messages.data(), messages.size(),
+                                            add_assistant, out.data(), (int32_t)out.size());
+    if (len > (int32_t)out.size()) {
+        out.resize(len);
+        len = llama_chat_apply_template(g_chat_template.c_str(), messages.data(), messages.size(),
+                                        add_assistant, out.data(), (int32_t)out.size());
+    }
+    if (len < 0) {
+        return false;
+    }
+    out.resize(len);
+    return true;
+}
+
+// Uses the GGUF tokenizer.chat_template when llama.cpp recognises it, ChatML otherwise.
+static void select_chat_template() {
+    const char* model_template = llama_model_chat_template(g_model, nullptr);
+    g_chat_template = model_template ? model_template : "chatml";
+    
+    std::string probe;
+    if (!render_chat({{"user", "hi"}}, true, probe)) {
+        LOGw("Unsupported model chat template, falling back to chatml");
+        g_chat_template = "chatml";
+    }
+}
+
+// Adds a turn to the history and returns only the text not yet in the sequence.
+static std::string append_turn(ChatSession& session, const char* role, const char* content,
+                               const bool add_assistant) {
+    session.chat_history.push_back({role, content});
+    
+    std::string rendered;
+    if (!render_chat(session.chat_history, add_assistant, rendered)) {
+        LOGe("Failed to apply chat template");
+        session.chat_history.pop_back();
+        return "";
+    }
+    
+    std::string delta;
+    if (rendered.compare(0, session.chat_text.size(), session.chat_text) == 0) {
+        delta = rendered.substr(session.chat_text.size());
+    } else {
+        // Template re-rendered earlier turns differently; the sequence keeps the old
+        // text and only the new turn is appended.
+        LOGw("Chat template output diverged from cached prefix");
+        std::string previous;
+        std::vector<ChatTurn> history(session.chat_history.begin(), session.chat_history.end() - 1);
+        render_chat(history, false, previous);
+        delta = rendered.substr(std::min(previous.size(), rendered.size()));
+    }
+    session.chat_text += delta;
+    return delta;
+}
+
+// Records the generated reply (plus the end-of-turn token text, if one was
+// decoded) so the next turn's delta starts right after it.
+static void commit_assistant_turn(ChatSession& session, const std::string& end_of_turn = "") {
+    if (!session.reply_pending) {
+        return;
+    }
+    const std::string reply = session.assistant_ss.str();
+    session.chat_history.push_back({"assistant", reply});
+    session.chat_text += reply + end_of_turn;
+    session.reply_pending = false;
+}
+
+// ----------------------------------------------------------------------------
+// Sessions
+// ----------------------------------------------------------------------------
+
+// Grammar runs first so the truncation samplers only see tokens it allows.
+static llama_sampler* create_sampler(const SamplerSpec& spec) {
+    auto sparams = llama_sampler_chain_default_params();
+    sparams.no_perf = true;
+    llama_sampler* sampler = llama_sampler_chain_init(sparams);
+    
+    if (!spec.grammar.empty()) {
+        llama_sampler* grammar = llama_sampler_init_grammar(
+            llama_model_get_vocab(g_model), spec.grammar.c_str(), "root");
+        if (!grammar) {
+            LOGe("Failed to parse sampler grammar");
+            llama_sampler_free(sampler);
+            return nullptr;
+        }
+        llama_sampler_chain_add(sampler, grammar);
+    }
+    if (spec.penalty_last_n != 0 &&
+        (spec.penalty_repeat != 1.0f || spec.penalty_freq != 0.0f || spec.penalty_present != 0.0f)) {
+        llama_sampler_chain_add(sampler, llama_sampler_init_penalties(
+            spec.penalty_last_n, spec.penalty_repeat, spec.penalty_freq, spec.penalty_present));
+    }
+    if (spec.top_k > 0) {
+        llama_sampler_chain_add(sampler, llama_sampler_init_top_k(spec.top_k));
+    }
+    if (spec.top_p < 1.0f) {
+        llama_sampler_chain_add(sampler, llama_sampler_init_top_p(spec.top_p, 1));
+    }
+    if (spec.min_p > 0.0f) {
+        llama_sampler_chain_add(sampler, llama_sampler_init_min_p(spec.min_p, 1));
+    }
+    if (spec.temp <= 0.0f) {
+        llama_sampler_chain_add(sampler, llama_sampler_init_greedy());
+    } else {
+        llama_sampler_chain_add(sampler, llama_sampler_init_temp(spec.temp));
+        llama_sampler_chain_add(sampler, llama_sampler_init_dist(LLAMA_DEFAULT_SEED));
+    }
+    return sampler;
+}
+
+static ChatSession* create_session(const llama_seq_id seq_id) {
+    auto session = std::make_unique<ChatSession>();
+    session->seq_id = seq_id;
+    session->sampler_spec = g_default_sampler_spec;
+    session->sampler = create_sampler(session->sampler_spec);
+    if (!session->sampler) {
+        return nullptr;
+    }
+    
+    g_sessions[seq_id] = std::move(session);
+    LOGi("Session %d created", seq_id);
+    return g_sessions[seq_id].get();
+}
+
+static void destroy_session(const llama_seq_id seq_id, const bool clear_kv_cache) {
+    auto& session = g_sessions[seq_id];
+    if (!session) {
+        return;
+    }
+    
+    reset_long_term_states(*session, clear_kv_cache);
+    reset_short_term_states(*session);
+    if (session->sampler) {
+        llama_sampler_free(session->sampler);
+    }
+    session.reset();
+}
+
+// ----------------------------------------------------------------------------
+// Generation
+// ----------------------------------------------------------------------------
+
+enum class GenerationStep {
+    TOKEN,    // `piece` holds complete UTF-8 text (may be empty mid-codepoint)
+    FINISHED, // stop position or end-of-generation token reached
+    FAILED,
+};
+
+// Samples and decodes one token for the session.
+static GenerationStep generate_step(ChatSession& session, std::string& piece) {
+    piece.clear();
+    
+    if (session.current_position >= DEFAULT_CONTEXT_SIZE - OVERFLOW_HEADROOM &&
+        !shift_context(session, 1)) {
+        return GenerationStep::FAILED;
+    }
+    
+    if (session.current_position >= session.stop_generation_position) {
+        LOGd("Reached stop position: %d", session.stop_generation_position);
+        commit_assistant_turn(session);
+        return GenerationStep::FINISHED;
+    }
+    
+    const auto new_token_id = llama_sampler_sample(session.sampler, g_context, -1);
+    llama_sampler_accept(session.sampler, new_token_id);
+    
+    common_batch_clear(g_batch);
+    common_batch_add(g_batch, new_token_id, session.current_position, {session.seq_id}, true);
+    
+    if (decode_session_batch(session, g_context, g_batch) != 0) {
+        LOGe("llama_decode failed for generated token");
+        return GenerationStep::FAILED;
+    }
+    
+    session.current_position++;
+    
+    const auto vocab = llama_model_get_vocab(g_model);
+    if (llama_vocab_is_eog(vocab, new_token_id)) {
+        LOGd("End of generation (EOG token)");
+        commit_assistant_turn(session, common_token_to_piece(g_context, new_token_id, true));
+        return GenerationStep::FINISHED;
+    }
+    
+    session.cached_token_chars += common_token_to_piece(g_context, new_token_id);
+    if (is_valid_utf8(session.cached_token_chars.c_str())) {
+        piece.swap(session.cached_token_chars);
+        session.assistant_ss << piece;
+        session.cached_token_chars.clear();
+    }
+    return GenerationStep::TOKEN;
+}
+
+static void notify_token_listener(const TokenStreamEvent event) {
+    token_stream_listener_fn listener = g_token_listener.load(std::memory_order_acquire);
+    if (!listener) {
+        return;
+    }
+    // Data notifications coalesce until Dart drains the ring
+    if (event == TOKEN_STREAM_DATA && g_token_notify_pending.exchange(true)) {
+        return;
+    }
+    listener(event);
+}
+
+// Blocks (with backoff) while the ring is full; returns false if stopped meanwhile.
+static bool push_token_piece(const std::string& piece) {
+    size_t offset = 0;
+    while (offset < piece.size()) {
+        const size_t space = g_token_ring.free_space();
+        if (space == 0) {
+            if (g_generation_stop.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            std::this_thread::sleep_for(TOKEN_RING_FULL_BACKOFF);
+            continue;
+        }
+        const size_t n = std::min(space, piece.size() - offset);
+        g_token_ring.write(piece.data() + offset, n);
+        offset += n;
+        notify_token_listener(TOKEN_STREAM_DATA);
+    }
+    return true;
+}
+
+// Drops everything the current turn added to the session's sequence and history.
+static void rollback_turn(ChatSession& session) {
+    if (session.reply_pending) {
+        session.chat_history.pop_back();
+        session.chat_text.resize(session.turn_start_text_length);
+        session.reply_pending = false;
+    }
+    llama_memory_seq_rm(llama_get_memory(g_context), session.seq_id, session.turn_start_position, -1);
+    update_kv_fragmentation();
+    session.current_position = session.turn_start_position;
+    session.cached_token_chars.clear();
+    session.assistant_ss.str("");
+}
+
+static int prefill_user_prompt(ChatSession& session, const char* user_prompt, const int n_predict) {
+    commit_assistant_turn(session);  // previous reply was stopped early
+    reset_short_term_states(session);
+    session.turn_start_position = session.current_position;
+    session.turn_start_text_length = session.chat_text.size();
+    // Grammar and penalty state is per reply
+    llama_sampler_reset(session.sampler);
+    
+    LOGd("User prompt received: %s", user_prompt);
+    
+    const std::string user_text = append_turn(session, "user", user_prompt, true);
+    if (user_text.empty()) {
+        return 1;
+    }
+    session.reply_pending = true;
+    auto user_tokens = common_tokenize(g_context, user_text, session.current_position == 0, true);
+    
+    const int user_prompt_size = (int)user_tokens.size();
+    const int max_batch_size = DEFAULT_CONTEXT_SIZE - OVERFLOW_HEADROOM;
+    
+    if (user_prompt_size > max_batch_size) {
+        const int skipped_tokens = user_prompt_size - max_batch_size;
+        user_tokens.resize(max_batch_size);
+        LOGw("User prompt too long! Skipped %d tokens", skipped_tokens);
+    }
+    
+    if (decode_tokens_in_batches(session, g_context, g_batch, user_tokens, g_prefill_batch_size, true)) {
+        LOGe("Failed to decode user tokens");
+        rollback_turn(session);
+        return 2;
+    }
+    
+    session.stop_generation_position = session.current_position + n_predict;
+    
+    LOGi("User prompt processed successfully");
+    return 0;
+}
+
+static TokenStreamEvent run_generation(ChatSession& session) {
+    std::string piece;
+    while (!g_generation_stop.load(std::memory_order_relaxed)) {
+        const GenerationStep step = generate_step(session, piece);
+        if (step == GenerationStep::FAILED) {
+            return TOKEN_STREAM_ERROR;
+        }
+        if (step == GenerationStep::FINISHED) {
+            return TOKEN_STREAM_DONE;
+        }
+        if (!piece.empty() && !push_token_piece(piece)) {
+            break;
+        }
+    }
+    return TOKEN_STREAM_DONE;
+}
+
+static void run_worker_command(const WorkerCommand& command) {
+    ChatSession& session = *command.session;
+    TokenStreamEvent event = TOKEN_STREAM_DONE;
+    
+    if (command.type == WorkerCommandType::PROMPT_AND_GENERATE &&
+        prefill_user_prompt(session, command.prompt.c_str(), command.n_predict) != 0) {
+        event = TOKEN_STREAM_ERROR;
+    } else {
+        event = run_generation(session);
+    }
+    
+    if (g_generation_cancel.load(std::memory_order_relaxed)) {
+        rollback_turn(session);
+        event = TOKEN_STREAM_CANCELLED;
+        LOGi("Generation cancelled, session %d rolled back to %d", session.seq_id,
+             session.current_position);
+    } else {
+        commit_assistant_turn(session);
+    }
+    notify_token_listener(event);
+}
+
+static void worker_main() {
+    pin_current_thread_to_performance_cores();
+    while (true) {
+        WorkerCommand command;
+        {
+            std::unique_lock<std::mutex> lock(g_worker_mutex);
+            g_worker_cv.wait(lock, [] { return !g_worker_queue.empty(); });
+            command = std::move(g_worker_queue.front());
+            g_worker_queue.pop_front();
+            if (command.type == WorkerCommandType::EXIT) {
+                return;
+            }
+            g_worker_busy = true;
+        }
+        
+        run_worker_command(command);
+        
+        // Compact fragmented sessions in the gap before the next turn, unless
+        // one is already queued or a caller is waiting for the worker
+        bool idle = false;
+        {
+            std::lock_guard<std::mutex> lock(g_worker_mutex);
+            idle = g_worker_queue.empty() && !g_generation_stop.load(std::memory_order_relaxed);
+        }
+        if (idle) {
+            compact_fragmented_sessions();
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(g_worker_mutex);
+            g_worker_busy = false;
+        }
+        g_worker_cv.notify_all();
+    }
+}
+
+static bool abort_decode_callback(void* /*data*/) {
+    return g_generation_cancel.load(std::memory_order_relaxed);
+}
+
+static void submit_worker_command(WorkerCommand command) {
+    {
+        std::lock_guard<std::mutex> lock(g_worker_mutex);
+        g_generation_stop.store(false, std::memory_order_relaxed);
+        g_generation_cancel.store(false, std::memory_order_relaxed);
+        g_token_ring.reset();
+        g_token_notify_pending.store(false);
+        g_worker_queue.push_back(std::move(command));
+    }
+    g_worker_cv.notify_all();
+}
+
+// Stops any queued or running turn and waits until the worker is idle. Must run
+// before any other code touches the context or session state.
+static void wait_for_worker_idle(const bool cancel = false) {
+    std::unique_lock<std::mutex> lock(g_worker_mutex);
+    g_worker_queue.clear();
+    if (!g_worker_busy) {
+        return;
+    }
+    g_generation_stop.store(true, std::memory_order_relaxed);
+    if (cancel) {
+        g_generation_cancel.store(true, std::memory_order_relaxed);
+    }
+    g_worker_cv.wait(lock, [] { return !g_worker_busy; });
+}
+
+static void start_worker() {
+    if (!g_worker_thread.joinable()) {
+        g_worker_thread = std::thread(worker_main);
+    }
+}
+
+static void stop_worker() {
+    if (!g_worker_thread.joinable()) {
+        return;
+    }
+    wait_for_worker_idle(true);
+    {
+        std::lock_guard<std::mutex> lock(g_worker_mutex);
+        g_worker_queue.push_back({WorkerCommandType::EXIT});
+    }
+    g_worker_cv.notify_all();
+    g_worker_thread.join();
+}
+
 // ============================================================================
 // FFI EXPORTS for Flutter
 // ============================================================================
@@ -151,6 +1231,12 @@ void init_ffi(const char* backend_path) {
     LOGi("Backend initiated; Log handler set.");
 }
 
+__attribute__((visibility("default"))) __attribute__((used))
+void set_state_cache_dir_ffi(const char* cache_dir) {
+    g_state_cache_dir = cache_dir ? cache_dir : "";
+    LOGi("KV snapshot cache dir: %s", g_state_cache_dir.empty() ? "(disabled)" : g_state_cache_dir.c_str());
+}
+
 __attribute__((visibility("default"))) __attribute__((used))
 int load_model_ffi(const char* model_path) {
     if (!model_path) {
@@ -167,6 +1253,8 @@ int load_model_ffi(const char* model_path) {
         return 1;
     }
     
+    g_model_fingerprint = compute_model_fingerprint(model_path);
+    select_chat_template();
     LOGi("Model loaded successfully");
     return 0;
 }
@@ -178,18 +1266,24 @@ int prepare_session_ffi() {
         return 1;
     }
     
-    const int n_threads = std::max(N_THREADS_MIN, std::min(N_THREADS_MAX,
+    // Heuristic start value; replaced by autotune_threads once the context exists
+    int n_threads = std::max(N_THREADS_MIN, std::min(N_THREADS_MAX,
         (int)sysconf(_SC_NPROCESSORS_ONLN) - N_THREADS_HEADROOM));
-    LOGi("Using %d threads", n_threads);
+    int n_threads_batch = n_threads;
+    g_performance_cores = detect_performance_cores();
+    LOGi("Performance cores: %zu", g_performance_cores.size());
     
     llama_context_params ctx_params = llama_context_default_params();
-    const int trained_context_size = llama_model_n_ctx_train(g_model);
-    
-    ctx_params.n_ctx = DEFAULT_CONTEXT_SIZE;
-    ctx_params.n_batch = BATCH_SIZE;
-    ctx_params.n_ubatch = BATCH_SIZE;
+    g_prefill_batch_size = select_prefill_batch_size(g_model, DEFAULT_CONTEXT_SIZE);
+
+    // One KV stream per session so every sequence keeps its own DEFAULT_CONTEXT_SIZE window
+    ctx_params.n_ctx = DEFAULT_CONTEXT_SIZE * MAX_SESSIONS;
+    ctx_params.n_seq_max = MAX_SESSIONS;
+    ctx_params.kv_unified = false;
+    ctx_params.n_batch = g_prefill_batch_size;
+    ctx_params.n_ubatch = g_prefill_batch_size;
     ctx_params.n_threads = n_threads;
-    ctx_params.n_threads_batch = n_threads;
+    ctx_params.n_threads_batch = n_threads_batch;
     ctx_params.no_perf = true;
     
     g_context = llama_init_from_model(g_model, ctx_params);
@@ -198,163 +1292,267 @@ int prepare_session_ffi() {
         return 1;
     }
     
-    g_batch = llama_batch_init(BATCH_SIZE, 0, 1);
+    g_batch = llama_batch_init(g_prefill_batch_size, 0, 1);
+    autotune_threads(n_threads, n_threads_batch);
+    llama_set_abort_callback(g_context, abort_decode_callback, nullptr);
+    start_worker();
     
-    // Initialize sampler
-    auto sparams = llama_sampler_chain_default_params();
-    sparams.no_perf = true;
-    g_sampler = llama_sampler_chain_init(sparams);
-    
-    llama_sampler_chain_add(g_sampler, llama_sampler_init_top_k(40));
-    llama_sampler_chain_add(g_sampler, llama_sampler_init_top_p(0.95f, 1));
-    llama_sampler_chain_add(g_sampler, llama_sampler_init_temp(DEFAULT_SAMPLER_TEMP));
-    llama_sampler_chain_add(g_sampler, llama_sampler_init_dist(LLAMA_DEFAULT_SEED));
+    g_session = create_session(0);
+    if (!g_session) {
+        LOGe("Failed to create default session");
+        return 1;
+    }
     
     LOGi("Session prepared successfully");
     return 0;
 }
 
 __attribute__((visibility("default"))) __attribute__((used))
-int process_system_prompt_ffi(const char* system_prompt) {
-    if (!system_prompt || !g_context) {
-        LOGe("Invalid parameters");
+void set_context_policy_ffi(int sink_tokens, int evict_chunk) {
+    g_sink_tokens = std::max(0, sink_tokens);
+    g_evict_chunk = std::max(1, std::min(evict_chunk, DEFAULT_CONTEXT_SIZE / 2));
+    LOGi("Context policy: sink_tokens=%d, evict_chunk=%d", g_sink_tokens, g_evict_chunk);
+}
+
+// Replaces the active session's sampler chain and makes the spec the default
+// for sessions created later. grammar may be null or empty for free-form text.
+// Returns 1 if the grammar fails to parse; the previous sampler stays in place.
+__attribute__((visibility("default"))) __attribute__((used))
+int set_sampler_ffi(int top_k, float top_p, float min_p, float temp, int penalty_last_n,
+                    float penalty_repeat, float penalty_freq, float penalty_present,
+                    const char* grammar) {
+    wait_for_worker_idle();
+    if (!g_model) {
+        LOGe("Model not loaded");
         return 1;
     }
     
-    reset_long_term_states();
-    reset_short_term_states();
+    SamplerSpec spec;
+    spec.top_k = top_k;
+    spec.top_p = top_p;
+    spec.min_p = min_p;
+    spec.temp = temp;
+    spec.penalty_last_n = penalty_last_n;
+    spec.penalty_repeat = penalty_repeat;
+    spec.penalty_freq = penalty_freq;
+    spec.penalty_present = penalty_present;
+    spec.grammar = grammar ? grammar : "";
     
-    LOGd("System prompt received: %s", system_prompt);
+    if (g_session) {
+        llama_sampler* sampler = create_sampler(spec);
+        if (!sampler) {
+            return 1;
+        }
+        llama_sampler_free(g_session->sampler);
+        g_session->sampler = sampler;
+        g_session->sampler_spec = spec;
+    }
+    g_default_sampler_spec = spec;
     
-    // Simple format: just use the system prompt as-is
-    std::string formatted_prompt = std::string("System: ") + system_prompt + "\n";
+    LOGi("Sampler: top_k=%d top_p=%.2f min_p=%.2f temp=%.2f repeat=%.2f grammar=%s", top_k,
+         top_p, min_p, temp, penalty_repeat, spec.grammar.empty() ? "none" : "set");
+    return 0;
+}
+
+__attribute__((visibility("default"))) __attribute__((used))
+int create_session_ffi() {
+    wait_for_worker_idle();
+    if (!g_context) {
+        LOGe("Context not initialized");
+        return -1;
+    }
     
-    const auto system_tokens = common_tokenize(g_context, formatted_prompt, true, true);
+    for (int seq_id = 0; seq_id < MAX_SESSIONS; seq_id++) {
+        if (!g_sessions[seq_id]) {
+            return create_session(seq_id) ? seq_id : -1;
+        }
+    }
     
-    if ((int)system_tokens.size() > DEFAULT_CONTEXT_SIZE - OVERFLOW_HEADROOM) {
-        LOGe("System prompt too long: %d tokens", (int)system_tokens.size());
+    LOGe("All %d sessions in use", MAX_SESSIONS);
+    return -1;
+}
+
+__attribute__((visibility("default"))) __attribute__((used))
+int set_active_session_ffi(int session_id) {
+    wait_for_worker_idle();
+    if (session_id < 0 || session_id >= MAX_SESSIONS || !g_sessions[session_id]) {
+        LOGe("Unknown session %d", session_id);
         return 1;
     }
     
-    if (decode_tokens_in_batches(g_context, g_batch, system_tokens, current_position)) {
-        LOGe("Failed to decode system tokens");
-        return 2;
+    g_session = g_sessions[session_id].get();
+    LOGd("Active session: %d", session_id);
+    return 0;
+}
+
+__attribute__((visibility("default"))) __attribute__((used))
+void destroy_session_ffi(int session_id) {
+    wait_for_worker_idle();
+    if (session_id < 0 || session_id >= MAX_SESSIONS || !g_sessions[session_id]) {
+        return;
     }
     
-    system_prompt_position = current_position = (int)system_tokens.size();
-    LOGi("System prompt processed successfully");
-    return 0;
+    if (g_session == g_sessions[session_id].get()) {
+        g_session = nullptr;
+    }
+    destroy_session(session_id, true);
+    LOGi("Session %d destroyed", session_id);
 }
 
 __attribute__((visibility("default"))) __attribute__((used))
-int process_user_prompt_ffi(const char* user_prompt, int n_predict) {
-    if (!user_prompt || !g_context) {
+int process_system_prompt_ffi(const char* system_prompt) {
+    wait_for_worker_idle();
+    if (!system_prompt || !g_context || !g_session) {
         LOGe("Invalid parameters");
         return 1;
     }
+    ChatSession& session = *g_session;
     
-    reset_short_term_states();
+    reset_long_term_states(session);
+    reset_short_term_states(session);
     
-    LOGd("User prompt received: %s", user_prompt);
+    LOGd("System prompt received: %s", system_prompt);
     
-    std::string formatted_prompt = std::string("User: ") + user_prompt + "\nAssistant: ";
-    auto user_tokens = common_tokenize(g_context, formatted_prompt, true, true);
+    const std::string system_text = append_turn(session, "system", system_prompt, false);
+    if (system_text.empty()) {
+        return 1;
+    }
+    const auto system_tokens = common_tokenize(g_context, system_text, true, true);
     
-    const int user_prompt_size = (int)user_tokens.size();
-    const int max_batch_size = DEFAULT_CONTEXT_SIZE - OVERFLOW_HEADROOM;
+    if ((int)system_tokens.size() > DEFAULT_CONTEXT_SIZE - OVERFLOW_HEADROOM) {
+        LOGe("System prompt too long: %d tokens", (int)system_tokens.size());
+        return 1;
+    }
     
-    if (user_prompt_size > max_batch_size) {
-        const int skipped_tokens = user_prompt_size - max_batch_size;
-        user_tokens.resize(max_batch_size);
-        LOGw("User prompt too long! Skipped %d tokens", skipped_tokens);
+    const std::string snapshot_path = kv_snapshot_path(system_tokens);
+    if (!snapshot_path.empty() && restore_kv_snapshot(session, snapshot_path, system_tokens)) {
+        update_kv_fragmentation();
+        session.current_position = (int)system_tokens.size();
+        session.system_prompt_position = session.current_position;
+        LOGi("System prompt restored from KV snapshot (%d tokens)", session.current_position);
+        return 0;
     }
     
-    if (decode_tokens_in_batches(g_context, g_batch, user_tokens, current_position, true)) {
-        LOGe("Failed to decode user tokens");
+    if (decode_tokens_in_batches(session, g_context, g_batch, system_tokens, g_prefill_batch_size)) {
+        LOGe("Failed to decode system tokens");
         return 2;
     }
     
-    current_position += user_prompt_size;
-    stop_generation_position = current_position + n_predict;
-    
-    LOGi("User prompt processed successfully");
+    session.system_prompt_position = session.current_position;
+    if (!snapshot_path.empty()) {
+        save_kv_snapshot(session, snapshot_path, system_tokens);
+    }
+    LOGi("System prompt processed successfully");
     return 0;
 }
 
 __attribute__((visibility("default"))) __attribute__((used))
-const char* generate_next_token_ffi() {
-    if (!g_context || !g_sampler) {
-        LOGe("Context or sampler not initialized");
-        return nullptr;
+int process_user_prompt_ffi(const char* user_prompt, int n_predict) {
+    wait_for_worker_idle();
+    if (!user_prompt || !g_context || !g_session) {
+        LOGe("Invalid parameters");
+        return 1;
     }
-    
-    if (current_position >= DEFAULT_CONTEXT_SIZE - OVERFLOW_HEADROOM) {
-        LOGw("Context full! Shifting...");
-        shift_context();
+    return prefill_user_prompt(*g_session, user_prompt, n_predict);
+}
+
+// Queues prefill + generation of a user turn on the worker and returns at once.
+// Text and completion arrive through the token listener.
+__attribute__((visibility("default"))) __attribute__((used))
+int submit_user_prompt_ffi(const char* user_prompt, int n_predict) {
+    wait_for_worker_idle();
+    if (!user_prompt || !g_context || !g_session) {
+        LOGe("Invalid parameters");
+        return 1;
     }
     
-    if (current_position >= stop_generation_position) {
-        LOGd("Reached stop position: %d", stop_generation_position);
+    WorkerCommand command{WorkerCommandType::PROMPT_AND_GENERATE};
+    command.session = g_session;
+    command.prompt = user_prompt;
+    command.n_predict = n_predict;
+    submit_worker_command(std::move(command));
+    return 0;
+}
+
+__attribute__((visibility("default"))) __attribute__((used))
+const char* generate_next_token_ffi() {
+    wait_for_worker_idle();
+    if (!g_context || !g_session) {
+        LOGe("Context or session not initialized");
         return nullptr;
     }
     
-    const auto new_token_id = llama_sampler_sample(g_sampler, g_context, -1);
-    llama_sampler_accept(g_sampler, new_token_id);
-    
-    common_batch_clear(g_batch);
-    common_batch_add(g_batch, new_token_id, current_position, {0}, true);
-    
-    if (llama_decode(g_context, g_batch) != 0) {
-        LOGe("llama_decode failed for generated token");
+    static std::string ret_buf;
+    if (generate_step(*g_session, ret_buf) != GenerationStep::TOKEN) {
         return nullptr;
     }
-    
-    current_position++;
-    
-    const auto vocab = llama_model_get_vocab(g_model);
-    if (llama_vocab_is_eog(vocab, new_token_id)) {
-        LOGd("End of generation (EOG token)");
-        return nullptr;
+    return ret_buf.c_str();
+}
+
+__attribute__((visibility("default"))) __attribute__((used))
+void set_token_listener_ffi(token_stream_listener_fn listener) {
+    g_token_listener.store(listener, std::memory_order_release);
+}
+
+__attribute__((visibility("default"))) __attribute__((used))
+int start_generation_ffi() {
+    wait_for_worker_idle();
+    if (!g_context || !g_session) {
+        LOGe("Context or session not initialized");
+        return 1;
     }
     
-    auto new_token_chars = common_token_to_piece(g_context, new_token_id);
-    cached_token_chars += new_token_chars;
-    
-    static std::string ret_buf;
-    ret_buf.clear();
-    
-    if (is_valid_utf8(cached_token_chars.c_str())) {
-        ret_buf = cached_token_chars;
-        assistant_ss << cached_token_chars;
-        cached_token_chars.clear();
-        return ret_buf.c_str();
-    } else {
-        return "";
+    WorkerCommand command{WorkerCommandType::GENERATE};
+    command.session = g_session;
+    submit_worker_command(std::move(command));
+    return 0;
+}
+
+// Copies up to `capacity` bytes of pending UTF-8 text into `out` and re-arms
+// the data notification. Returns the number of bytes written.
+__attribute__((visibility("default"))) __attribute__((used))
+int drain_tokens_ffi(char* out, int capacity) {
+    if (!out || capacity <= 0) {
+        return 0;
     }
+    g_token_notify_pending.store(false);
+    return (int)g_token_ring.read(out, (size_t)capacity);
 }
 
 __attribute__((visibility("default"))) __attribute__((used))
 void stop_generation_ffi() {
-    reset_short_term_states();
+    wait_for_worker_idle();
+    if (g_session) {
+        commit_assistant_turn(*g_session);
+        reset_short_term_states(*g_session);
+    }
     LOGi("Generation stopped");
 }
 
+// Aborts the current turn, including an in-flight prefill, and discards it
+__attribute__((visibility("default"))) __attribute__((used))
+void cancel_generation_ffi() {
+    wait_for_worker_idle(true);
+    LOGi("Generation cancelled");
+}
+
 __attribute__((visibility("default"))) __attribute__((used))
 void reset_conversation_ffi() {
-    reset_long_term_states();
-    reset_short_term_states();
+    wait_for_worker_idle();
+    if (g_session) {
+        reset_long_term_states(*g_session);
+        reset_short_term_states(*g_session);
+    }
     LOGi("Conversation reset");
 }
 
 __attribute__((visibility("default"))) __attribute__((used))
 void unload_ffi() {
-    reset_long_term_states(false);
-    reset_short_term_states();
-    
-    if (g_sampler) {
-        llama_sampler_free(g_sampler);
-        g_sampler = nullptr;
+    stop_worker();
+    for (int seq_id = 0; seq_id < MAX_SESSIONS; seq_id++) {
+        destroy_session(seq_id, false);
     }
+    g_session = nullptr;
     
     if (g_context) {
         llama_batch_free(g_batch);
@@ -366,6 +1564,7 @@ void unload_ffi() {
         llama_model_free(g_model);
         g_model = nullptr;
     }
+    g_model_fingerprint = 0;
     
     LOGi("Resources unloaded");
 }
@@ -377,6 +1576,24 @@ void shutdown_ffi() {
     LOGi("Backend shutdown");
 }
 
+// KV cache fragmentation over all sessions (estimated share of the cells sessions
+// span that are eviction holes) and the compactions run since the library was
+// loaded.
+// Safe to call while the worker is generating. Any output may be null.
+__attribute__((visibility("default"))) __attribute__((used))
+void get_kv_cache_stats_ffi(float* out_fragmentation, int* out_compactions,
+                            double* out_compaction_ms) {
+    if (out_fragmentation) {
+        *out_fragmentation = g_kv_fragmentation.load(std::memory_order_relaxed);
+    }
+    if (out_compactions) {
+        *out_compactions = g_kv_compactions.load(std::memory_order_relaxed);
+    }
+    if (out_compaction_ms) {
+        *out_compaction_ms = g_kv_compaction_ms.load(std::memory_order_relaxed);
+    }
+}
+
 __attribute__((visibility("default"))) __attribute__((used))
 const char* get_system_info_ffi() {
     return llama_print_system_info();
@@ -62,4 +62,5 @@ message(STATUS "    SHERPA_ONNX_VERSION_ANDROID: ${RAC_SHERPA_ONNX_VERSION_ANDRO
 message(STATUS "    SHERPA_ONNX_VERSION_MACOS: ${RAC_SHERPA_ONNX_VERSION_MACOS}")
 message(STATUS "  Other:")
 message(STATUS "    LLAMACPP_VERSION: ${RAC_LLAMACPP_VERSION}")
+message(STATUS "    WHISPERCPP_VERSION: ${RAC_WHISPERCPP_VERSION}")
 message(STATUS "    NLOHMANN_JSON_VERSION: ${RAC_NLOHMANN_JSON_VERSION}")
@@ -0,0 +1,87 @@
+# =============================================================================
+# PGO.cmake
+# =============================================================================
+# Two-stage profile-guided build of rac_commons and the backends, selected with
+# RAC_PGO:
+#
+#   OFF       Plain build (default)
+#   GENERATE  Instrumented build. Running rac_bench / rac_llm_bench writes
+#             profiles to RAC_PGO_PROFILE (a directory).
+#   USE       Optimized build from those profiles, with ThinLTO (Clang) or
+#             LTO (GCC) so rac_commons, the backends and their engines are
+#             optimized across library boundaries.
+#
+# Clang profiles must be merged before USE:
+#   llvm-profdata merge -o default.profdata <dir>/*.profraw
+# and RAC_PGO_PROFILE then names the .profdata file. GCC reads the .gcda
+# directory directly and needs both stages built in the same build directory.
+# scripts/build-pgo.sh runs the whole sequence.
+#
+# Included before the backends are added, so the flags also reach the
+# FetchContent engines (llama.cpp, whisper.cpp).
+# =============================================================================
+
+set(RAC_PGO "OFF" CACHE STRING "Profile-guided optimization stage (OFF, GENERATE, USE)")
+set_property(CACHE RAC_PGO PROPERTY STRINGS OFF GENERATE USE)
+set(RAC_PGO_PROFILE "${CMAKE_BINARY_DIR}/pgo-profiles" CACHE PATH
+    "GENERATE: profile output directory. USE: merged .profdata (Clang) or .gcda directory (GCC)")
+
+if(RAC_PGO STREQUAL "OFF")
+    return()
+endif()
+
+if(NOT RAC_PGO MATCHES "^(GENERATE|USE)$")
+    message(FATAL_ERROR "RAC_PGO must be OFF, GENERATE or USE (got '${RAC_PGO}')")
+endif()
+
+if(NOT CMAKE_CXX_COMPILER_ID MATCHES "Clang|GNU")
+    message(FATAL_ERROR "RAC_PGO requires Clang or GCC (got ${CMAKE_CXX_COMPILER_ID})")
+endif()
+
+if(NOT CMAKE_BUILD_TYPE STREQUAL "Release")
+    message(WARNING "RAC_PGO=${RAC_PGO} with CMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE}; "
+                    "profiles only match between builds with the same flags, use Release")
+endif()
+
+if(RAC_PGO STREQUAL "GENERATE")
+    file(MAKE_DIRECTORY "${RAC_PGO_PROFILE}")
+    # Atomic counters: the LLM and voice pipelines run on several threads
+    set(_rac_pgo_flags "-fprofile-generate=${RAC_PGO_PROFILE}" -fprofile-update=atomic)
+    add_compile_options(${_rac_pgo_flags})
+    add_link_options(${_rac_pgo_flags})
+    message(STATUS "PGO: instrumented build, profiles -> ${RAC_PGO_PROFILE}")
+    return()
+endif()
+
+# USE
+if(NOT EXISTS "${RAC_PGO_PROFILE}")
+    message(FATAL_ERROR "RAC_PGO=USE: profile '${RAC_PGO_PROFILE}' not found")
+endif()
+
+if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    if(IS_DIRECTORY "${RAC_PGO_PROFILE}")
+        message(FATAL_ERROR "RAC_PGO=USE: Clang needs a merged profile; run "
+                            "llvm-profdata merge -o default.profdata ${RAC_PGO_PROFILE}/*.profraw "
+                            "and set RAC_PGO_PROFILE to the .profdata file")
+    endif()
+    # Code the workloads never reach (other platforms' paths, error handling)
+    # has no counters; that is expected, not a stale profile
+    set(_rac_pgo_flags "-fprofile-use=${RAC_PGO_PROFILE}"
+        -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date)
+    set(_rac_lto_flags -flto=thin)
+else()
+    set(_rac_pgo_flags "-fprofile-use=${RAC_PGO_PROFILE}" -fprofile-partial-training
+        -Wno-missing-profile)
+    set(_rac_lto_flags -flto=auto)
+endif()
+
+add_compile_options(${_rac_pgo_flags} ${_rac_lto_flags})
+add_link_options(${_rac_pgo_flags} ${_rac_lto_flags})
+
+# Static archives of LTO objects need an archiver that indexes bitcode/GIMPLE
+if(CMAKE_CXX_COMPILER_AR AND CMAKE_CXX_COMPILER_RANLIB)
+    set(CMAKE_AR "${CMAKE_CXX_COMPILER_AR}")
+    set(CMAKE_RANLIB "${CMAKE_CXX_COMPILER_RANLIB}")
+endif()
+
+message(STATUS "PGO: optimized build from ${RAC_PGO_PROFILE} with ${_rac_lto_flags}")
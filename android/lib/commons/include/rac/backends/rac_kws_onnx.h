@@ -0,0 +1,91 @@
+/**
+ * @file rac_kws_onnx.h
+ * @brief RunAnywhere Core - ONNX Backend RAC API for Keyword Spotting
+ *
+ * Streaming keyword spotting with sherpa-onnx's KeywordSpotter: a small
+ * zipformer transducer whose search only follows the configured keywords.
+ */
+
+#ifndef RAC_KWS_ONNX_H
+#define RAC_KWS_ONNX_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+#include "rac/features/kws/rac_kws_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// EXPORT MACRO
+// =============================================================================
+
+#if defined(RAC_ONNX_BUILDING)
+#if defined(_WIN32)
+#define RAC_ONNX_API __declspec(dllexport)
+#elif defined(__GNUC__) || defined(__clang__)
+#define RAC_ONNX_API __attribute__((visibility("default")))
+#else
+#define RAC_ONNX_API
+#endif
+#else
+#define RAC_ONNX_API
+#endif
+
+// =============================================================================
+// CONFIGURATION
+// =============================================================================
+
+typedef struct rac_kws_onnx_config {
+    /** Keywords, one per line in the model's token format; NULL = keywords.txt of the model */
+    const char* keywords;
+    /** Detection threshold (0-1), higher is stricter */
+    float keywords_threshold;
+    /** Boost for keyword paths during search */
+    float keywords_score;
+    int32_t num_threads;
+} rac_kws_onnx_config_t;
+
+static const rac_kws_onnx_config_t RAC_KWS_ONNX_CONFIG_DEFAULT = {
+    .keywords = NULL, .keywords_threshold = 0.25f, .keywords_score = 1.0f, .num_threads = 1};
+
+// =============================================================================
+// ONNX KWS API
+// =============================================================================
+
+/**
+ * Loads a streaming KWS model.
+ *
+ * @param model_path Model directory (encoder/decoder/joiner .onnx + tokens.txt)
+ * @param config Configuration (NULL for defaults)
+ * @param out_handle Output: KWS handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_ONNX_API rac_result_t rac_kws_onnx_create(const char* model_path,
+                                              const rac_kws_onnx_config_t* config,
+                                              rac_handle_t* out_handle);
+
+/**
+ * Feeds audio; decodes whatever complete feature frames it yields.
+ *
+ * @param handle KWS handle
+ * @param samples Float32 PCM samples (mono)
+ * @param num_samples Number of samples
+ * @param sample_rate Sample rate of samples (resampled to 16 kHz)
+ * @param out_detection Output: Keyword that ended within this audio, if any
+ * @return RAC_SUCCESS or error code
+ */
+RAC_ONNX_API rac_result_t rac_kws_onnx_process(rac_handle_t handle, const float* samples,
+                                               size_t num_samples, int32_t sample_rate,
+                                               rac_kws_detection_t* out_detection);
+
+RAC_ONNX_API rac_result_t rac_kws_onnx_reset(rac_handle_t handle);
+
+RAC_ONNX_API void rac_kws_onnx_destroy(rac_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_KWS_ONNX_H */
@@ -14,6 +14,7 @@
 #include "rac/core/rac_error.h"
 #include "rac/core/rac_types.h"
 #include "rac/features/llm/rac_llm.h"
+#include "rac/features/llm/rac_llm_metrics.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,11 +52,46 @@ typedef struct rac_llm_llamacpp_config {
     /** Number of threads (0 = auto-detect) */
     int32_t num_threads;
 
-    /** Number of layers to offload to GPU (Metal on iOS/macOS) */
+    /** Number of layers to offload to GPU (Metal on iOS/macOS, Vulkan/OpenCL on
+     *  Android GPU builds). -1 = as many as fit in free GPU memory, 0 = CPU only. */
     int32_t gpu_layers;
 
     /** Batch size for prompt processing */
     int32_t batch_size;
+
+    /** Optional draft GGUF for speculative decoding (NULL = disabled).
+     *  Must share the main model's vocabulary. */
+    const char* draft_model_path;
+
+    /** Tokens the draft proposes per step (0 = default of 4) */
+    int32_t draft_tokens;
+
+    /** KV cache element types: "f16" (NULL = default), "q8_0", "q4_0", ...
+     *  q8_0 halves the cache; a quantized V cache turns on flash attention. */
+    const char* kv_cache_type_k;
+    const char* kv_cache_type_v;
+
+    /** Flash attention: -1 = auto, 0 = off, 1 = on */
+    int32_t flash_attention;
+
+    /** With context_size = 0, cap the context so weights plus KV cache fit
+     *  this many MB (0 = no cap) */
+    int32_t memory_budget_mb;
+
+    /** rac_model_load_mode_t: 0 = mmap, 1 = mmap + background prefetch,
+     *  2 = mmap + mlock, 3 = read without mmap */
+    int32_t load_mode;
+
+    /** Vision projector GGUF (mmproj) for image input. NULL looks for an
+     *  mmproj*.gguf next to the model; "" turns image input off. */
+    const char* mmproj_path;
+
+    /** Cached image embeddings budget in MB (0 = default of 64) */
+    int32_t image_cache_mb;
+
+    /** Images are shrunk so their longer side is at most this before encoding
+     *  (0 = default of 1024, -1 = keep the size) */
+    int32_t image_max_edge;
 } rac_llm_llamacpp_config_t;
 
 /**
@@ -64,8 +100,18 @@ typedef struct rac_llm_llamacpp_config {
 static const rac_llm_llamacpp_config_t RAC_LLM_LLAMACPP_CONFIG_DEFAULT = {
     .context_size = 0,  // Auto-detect
     .num_threads = 0,   // Auto-detect
-    .gpu_layers = -1,   // All layers on GPU
-    .batch_size = 512};
+    .gpu_layers = -1,   // Auto: as many layers as fit on the GPU
+    .batch_size = 512,
+    .draft_model_path = RAC_NULL,
+    .draft_tokens = 0,
+    .kv_cache_type_k = RAC_NULL,
+    .kv_cache_type_v = RAC_NULL,
+    .flash_attention = -1,
+    .memory_budget_mb = 0,
+    .load_mode = 0,
+    .mmproj_path = RAC_NULL,
+    .image_cache_mb = 0,
+    .image_max_edge = 0};
 
 // =============================================================================
 // LLAMACPP-SPECIFIC API
@@ -163,6 +209,59 @@ RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_generate_stream(
     rac_handle_t handle, const char* prompt, const rac_llm_options_t* options,
     rac_llm_llamacpp_stream_callback_fn callback, void* user_data);
 
+/**
+ * Gets why the last rac_llm_llamacpp_generate_stream call that this thread
+ * made on the handle stopped, e.g. at a time budget.
+ *
+ * @param handle Service handle
+ * @param out_reason Output: Stop reason
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_FOUND if this thread has not streamed
+ *         on the handle
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_get_stop_reason(rac_handle_t handle,
+                                                               rac_llm_stop_reason_t* out_reason);
+
+/**
+ * Generates text for several prompts at once.
+ *
+ * Prompts run concurrently on the model's parallel sequences; a shared prompt
+ * prefix is decoded once and copied between sequences. The callback is invoked
+ * once per prompt as each finishes (not in index order, never concurrently);
+ * the result is only valid during the callback. After cancel, remaining
+ * prompts are reported with RAC_ERROR_CANCELLED.
+ *
+ * @param handle Service handle
+ * @param prompts Input prompts
+ * @param num_prompts Number of prompts
+ * @param options Generation options shared by all prompts (can be NULL)
+ * @param callback Per-prompt result callback
+ * @param user_data User context passed to callback
+ * @return RAC_SUCCESS or error code
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_generate_batch(
+    rac_handle_t handle, const char* const* prompts, size_t num_prompts,
+    const rac_llm_options_t* options, rac_llm_batch_callback_fn callback, void* user_data);
+
+/**
+ * Draws options->n_samples replies to one prompt, at most one per parallel
+ * sequence (max_parallel_requests). The prompt is decoded once; the other
+ * sequences copy its KV cells and all replies decode in the same batches.
+ * Each reply gets its own seed; with temperature 0 they are all the same.
+ * max_tokens applies per reply and is lowered if the replies would not fit
+ * in the context together.
+ *
+ * @param handle Service handle
+ * @param prompt Input prompt
+ * @param options Generation options (can be NULL: one reply)
+ * @param out_samples Output: Replies with log-probabilities (free with
+ *                    rac_llm_samples_free)
+ * @return RAC_SUCCESS, RAC_ERROR_CANCELLED or RAC_ERROR_GENERATION_FAILED
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_generate_samples(rac_handle_t handle,
+                                                                const char* prompt,
+                                                                const rac_llm_options_t* options,
+                                                                rac_llm_samples_t* out_samples);
+
 /**
  * Cancels ongoing generation.
  *
@@ -181,6 +280,155 @@ RAC_LLAMACPP_API void rac_llm_llamacpp_cancel(rac_handle_t handle);
  */
 RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_get_model_info(rac_handle_t handle, char** out_json);
 
+/**
+ * Gets speculative decoding counters since the model was loaded.
+ *
+ * @param handle Service handle
+ * @param out_metrics Output: counters (enabled = RAC_FALSE without a draft model)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_get_speculative_metrics(
+    rac_handle_t handle, rac_speculative_metrics_t* out_metrics);
+
+/**
+ * Gets the memory held by the loaded model.
+ *
+ * @param handle Service handle
+ * @param out_usage Output: memory breakdown (all zero if no model is loaded)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_get_memory_usage(rac_handle_t handle,
+                                                               rac_llm_memory_usage_t* out_usage);
+
+/**
+ * Counts the tokens the loaded model's tokenizer produces for text.
+ *
+ * @param handle Service handle
+ * @param text Text to tokenize
+ * @param out_count Output: token count
+ * @return RAC_SUCCESS, or RAC_ERROR_MODEL_NOT_LOADED if no model is loaded
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_count_tokens(rac_handle_t handle, const char* text,
+                                                           int32_t* out_count);
+
+/**
+ * Saves the KV cache of the conversation that last finished a request.
+ *
+ * @param handle Service handle
+ * @param path File to write (replaced atomically)
+ * @param out_token_count Output: tokens saved (can be NULL)
+ * @return RAC_SUCCESS, RAC_ERROR_BACKEND_BUSY while generating,
+ *         RAC_ERROR_INVALID_STATE if nothing was generated yet, or
+ *         RAC_ERROR_FILE_WRITE_FAILED
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_save_state(rac_handle_t handle, const char* path,
+                                                         int32_t* out_token_count);
+
+/**
+ * Restores a conversation saved by rac_llm_llamacpp_save_state.
+ *
+ * @param handle Service handle
+ * @param path File to read
+ * @param out_token_count Output: tokens restored (can be NULL)
+ * @return RAC_SUCCESS, RAC_ERROR_BACKEND_BUSY while generating,
+ *         RAC_ERROR_FILE_NOT_FOUND, RAC_ERROR_INVALID_FORMAT,
+ *         RAC_ERROR_MODEL_INCOMPATIBLE if saved with another model or KV
+ *         cache type, or RAC_ERROR_CONTEXT_TOO_LONG
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_restore_state(rac_handle_t handle, const char* path,
+                                                            int32_t* out_token_count);
+
+/**
+ * Loads a LoRA adapter GGUF for the loaded model under a name.
+ *
+ * Adapters stay in memory until removed or the model is unloaded, and
+ * requests select one by name (rac_llm_options_t.lora_adapter).
+ * Loading the same name and path again is a no-op.
+ *
+ * @param handle Service handle
+ * @param name Name requests use
+ * @param path Adapter GGUF
+ * @return RAC_SUCCESS, RAC_ERROR_MODEL_NOT_LOADED, RAC_ERROR_INVALID_ARGUMENT
+ *         if the name is taken by another file, or RAC_ERROR_MODEL_LOAD_FAILED
+ *         (e.g. an adapter for another base model)
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_load_lora(rac_handle_t handle, const char* name,
+                                                        const char* path);
+
+/**
+ * Frees a LoRA adapter and the conversation caches computed with it.
+ *
+ * @param handle Service handle
+ * @param name Adapter name
+ * @return RAC_SUCCESS, RAC_ERROR_NOT_FOUND, or RAC_ERROR_BACKEND_BUSY while a
+ *         request uses it
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_remove_lora(rac_handle_t handle, const char* name);
+
+/**
+ * Sets the adapter for requests that do not name one.
+ *
+ * @param handle Service handle
+ * @param name Adapter name, or NULL / "" for the base model
+ * @param scale Adapter scale (0 = 1.0)
+ * @return RAC_SUCCESS or RAC_ERROR_NOT_FOUND
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_set_lora(rac_handle_t handle, const char* name,
+                                                       float scale);
+
+/**
+ * Loads a dedicated embedding model (e.g. a small BERT-style GGUF).
+ *
+ * Without one, embeddings are computed with the loaded generation model.
+ * Passing NULL unloads the dedicated model.
+ *
+ * @param handle Service handle
+ * @param model_path Path to the embedding GGUF, or NULL
+ * @return RAC_SUCCESS or RAC_ERROR_MODEL_LOAD_FAILED
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_load_embedding_model(rac_handle_t handle,
+                                                                  const char* model_path);
+
+/**
+ * Gets the number of floats in one embedding vector.
+ *
+ * @param handle Service handle
+ * @param out_dim Output: embedding dimension
+ * @return RAC_SUCCESS, or RAC_ERROR_MODEL_NOT_LOADED if no model is available
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_get_embedding_dim(rac_handle_t handle,
+                                                               int32_t* out_dim);
+
+/**
+ * Computes pooled embeddings for a batch of texts.
+ *
+ * Vectors are written row by row into the caller's buffer, so no memory is
+ * allocated per vector. Inputs are packed into as few decodes as possible;
+ * inputs longer than the embedding context are truncated.
+ *
+ * @param handle Service handle
+ * @param texts Input texts
+ * @param num_texts Number of texts
+ * @param normalize RAC_TRUE to L2-normalize each vector (cosine similarity becomes a dot product)
+ * @param out_embeddings Output: num_texts * dim floats
+ * @param capacity Number of floats out_embeddings can hold
+ * @return RAC_SUCCESS, RAC_ERROR_BUFFER_TOO_SMALL, or error code
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_embed(rac_handle_t handle, const char* const* texts,
+                                                   size_t num_texts, rac_bool_t normalize,
+                                                   float* out_embeddings, size_t capacity);
+
+/**
+ * Releases cached memory: MODERATE drops the prefix cache and pooled samplers,
+ * LOW also halves the context (down to 1024 tokens). Skipped while generating.
+ *
+ * @param handle Service handle
+ * @param level Pressure level
+ * @return RAC_SUCCESS or error code
+ */
+RAC_LLAMACPP_API rac_result_t rac_llm_llamacpp_trim_memory(rac_handle_t handle,
+                                                          rac_llm_memory_pressure_t level);
+
 /**
  * Destroys a LlamaCPP LLM service.
  *
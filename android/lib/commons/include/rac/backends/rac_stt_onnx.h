@@ -84,6 +84,24 @@ RAC_ONNX_API rac_bool_t rac_stt_onnx_stream_is_ready(rac_handle_t handle, rac_ha
 RAC_ONNX_API rac_result_t rac_stt_onnx_decode_stream(rac_handle_t handle, rac_handle_t stream,
                                                      char** out_text);
 
+/**
+ * @brief Decode several offline streams in one batched recognizer call
+ *
+ * Queued utterances (voice notes, file chunks) share one pass through the
+ * model instead of one pass each. Online streams in the list are decoded
+ * individually.
+ *
+ * @param handle STT handle
+ * @param streams Streams to decode
+ * @param num_streams Number of streams
+ * @param out_texts Output: Caller-allocated array of num_streams entries, each set to
+ *                  a transcript to free with free() (NULL for an unknown stream)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_ONNX_API rac_result_t rac_stt_onnx_decode_batch(rac_handle_t handle,
+                                                    const rac_handle_t* streams,
+                                                    size_t num_streams, char** out_texts);
+
 RAC_ONNX_API void rac_stt_onnx_input_finished(rac_handle_t handle, rac_handle_t stream);
 
 RAC_ONNX_API rac_bool_t rac_stt_onnx_is_endpoint(rac_handle_t handle, rac_handle_t stream);
@@ -41,6 +41,35 @@ extern "C" {
 // CONFIGURATION
 // =============================================================================
 
+/**
+ * Decoding quality/latency policy.
+ */
+typedef enum rac_stt_whispercpp_decoding {
+    /** One greedy pass per window, no retries (lowest latency) */
+    RAC_STT_WHISPERCPP_DECODING_GREEDY_FAST = 0,
+    /** Greedy; windows whose entropy/logprob miss the thresholds are re-decoded
+        at rising temperatures */
+    RAC_STT_WHISPERCPP_DECODING_GREEDY_FALLBACK = 1,
+    /** Beam search with the same fallback; streams use it for the final decode only */
+    RAC_STT_WHISPERCPP_DECODING_BEAM = 2,
+} rac_stt_whispercpp_decoding_t;
+
+/**
+ * Silence pre-pass of (non-streaming) transcriptions.
+ *
+ * Leading and trailing silence is dropped and long pauses are shortened
+ * before the audio reaches the encoder; segment and word timestamps still
+ * refer to the original audio. Clips without speech are not decoded at all.
+ */
+typedef enum rac_stt_whispercpp_silence_trim {
+    /** Transcribe the whole buffer */
+    RAC_STT_WHISPERCPP_SILENCE_TRIM_OFF = 0,
+    /** Frame energy against the clip's noise floor */
+    RAC_STT_WHISPERCPP_SILENCE_TRIM_ENERGY = 1,
+    /** whisper.cpp's Silero VAD (vad_model_path); energy if it cannot be loaded */
+    RAC_STT_WHISPERCPP_SILENCE_TRIM_VAD = 2,
+} rac_stt_whispercpp_silence_trim_t;
+
 /**
  * WhisperCPP-specific configuration.
  */
@@ -51,7 +80,11 @@ typedef struct rac_stt_whispercpp_config {
     /** Enable GPU acceleration (Metal on Apple) */
     rac_bool_t use_gpu;
 
-    /** Enable CoreML acceleration (Apple only) */
+    /** Encode with the model's Core ML companion on the Neural Engine (Apple
+        builds with RAC_WHISPERCPP_COREML). whisper.cpp loads
+        "<model>-encoder.mlmodelc" from beside the GGML file; with this set, one
+        found elsewhere in the model's folder is linked there first. Without a
+        companion, encoding falls back to Metal/CPU. */
     rac_bool_t use_coreml;
 
     /** Language code for transcription (NULL = auto-detect) */
@@ -59,6 +92,23 @@ typedef struct rac_stt_whispercpp_config {
 
     /** Translate to English (when source is non-English) */
     rac_bool_t translate;
+
+    /** Decoding policy */
+    rac_stt_whispercpp_decoding_t decoding;
+
+    /** Beam width for RAC_STT_WHISPERCPP_DECODING_BEAM (2-8, 0 = 5) */
+    int32_t beam_size;
+
+    /** Decode a second of silence on a background thread after load, so the first
+        request does not pay for buffer allocation ("stt.model.warmup.completed"
+        reports the duration) */
+    rac_bool_t warmup;
+
+    /** Silence pre-pass */
+    rac_stt_whispercpp_silence_trim_t silence_trim;
+
+    /** GGML Silero VAD model for RAC_STT_WHISPERCPP_SILENCE_TRIM_VAD */
+    const char* vad_model_path;
 } rac_stt_whispercpp_config_t;
 
 /**
@@ -69,7 +119,12 @@ static const rac_stt_whispercpp_config_t RAC_STT_WHISPERCPP_CONFIG_DEFAULT = {
     .use_gpu = RAC_TRUE,
     .use_coreml = RAC_TRUE,
     .language = NULL,
-    .translate = RAC_FALSE};
+    .translate = RAC_FALSE,
+    .decoding = RAC_STT_WHISPERCPP_DECODING_GREEDY_FALLBACK,
+    .beam_size = 0,
+    .warmup = RAC_TRUE,
+    .silence_trim = RAC_STT_WHISPERCPP_SILENCE_TRIM_OFF,
+    .vad_model_path = NULL};
 
 // =============================================================================
 // WHISPERCPP STT API
@@ -103,6 +158,17 @@ RAC_WHISPERCPP_API rac_result_t rac_stt_whispercpp_transcribe(rac_handle_t handl
                                                               const rac_stt_options_t* options,
                                                               rac_stt_result_t* out_result);
 
+/**
+ * Gets where encoder passes of the loaded model run.
+ *
+ * @param handle Service handle
+ * @param out_accelerator Output: "coreml" (Neural Engine encoder, ggml
+ *        decoder), "metal" or "cpu"; static, do not free
+ * @return RAC_SUCCESS, or RAC_ERROR_MODEL_NOT_LOADED
+ */
+RAC_WHISPERCPP_API rac_result_t rac_stt_whispercpp_get_accelerator(rac_handle_t handle,
+                                                                   const char** out_accelerator);
+
 /**
  * Gets detected language after transcription.
  *
@@ -113,6 +179,116 @@ RAC_WHISPERCPP_API rac_result_t rac_stt_whispercpp_transcribe(rac_handle_t handl
 RAC_WHISPERCPP_API rac_result_t rac_stt_whispercpp_get_language(rac_handle_t handle,
                                                                 char** out_language);
 
+/**
+ * Detects the spoken language without transcribing.
+ *
+ * Runs the encoder once over the first 30 seconds and no decoder pass. The
+ * result is also returned by rac_stt_whispercpp_get_language.
+ *
+ * @param handle Service handle
+ * @param audio_samples Float32 mono PCM
+ * @param num_samples Number of samples
+ * @param sample_rate Sample rate of audio_samples (resampled to 16 kHz)
+ * @param out_language Output: Language code (caller must free)
+ * @param out_probability Output: Probability of the language (can be NULL)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_WHISPERCPP_API rac_result_t rac_stt_whispercpp_detect_language(rac_handle_t handle,
+                                                                   const float* audio_samples,
+                                                                   size_t num_samples,
+                                                                   int32_t sample_rate,
+                                                                   char** out_language,
+                                                                   float* out_probability);
+
+// =============================================================================
+// STREAMING API
+// =============================================================================
+
+/**
+ * Result of a streaming decode step.
+ *
+ * committed_text is the transcript confirmed so far; it only grows.
+ * tentative_text is the unconfirmed tail, which may change on the next step.
+ */
+typedef struct rac_stt_whispercpp_partial {
+    /** Confirmed transcript (caller must free) */
+    char* committed_text;
+    /** Unconfirmed tail (caller must free, can be NULL) */
+    char* tentative_text;
+    /** RAC_TRUE once input is finished and everything is committed */
+    rac_bool_t is_final;
+} rac_stt_whispercpp_partial_t;
+
+/**
+ * Creates a transcription stream.
+ *
+ * Fed audio is transcribed in overlapping windows every step_ms; words that
+ * two consecutive windows agree on are committed.
+ *
+ * @param handle Service handle
+ * @param language Language code (NULL = auto-detect)
+ * @param step_ms New audio between decode steps (0 = 1000 ms)
+ * @param out_stream_id Output: Stream identifier (caller must free)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_WHISPERCPP_API rac_result_t rac_stt_whispercpp_stream_create(rac_handle_t handle,
+                                                                 const char* language,
+                                                                 int32_t step_ms,
+                                                                 char** out_stream_id);
+
+/**
+ * Appends audio to a stream.
+ *
+ * @param handle Service handle
+ * @param stream_id Stream identifier
+ * @param samples Float32 PCM samples (mono)
+ * @param num_samples Number of samples
+ * @param sample_rate Sample rate of samples
+ * @return RAC_SUCCESS or error code
+ */
+RAC_WHISPERCPP_API rac_result_t rac_stt_whispercpp_stream_feed(rac_handle_t handle,
+                                                               const char* stream_id,
+                                                               const float* samples,
+                                                               size_t num_samples,
+                                                               int32_t sample_rate);
+
+/**
+ * Runs a decode step if a full step of new audio is buffered (or input is
+ * finished). Otherwise returns RAC_ERROR_BACKEND_NOT_READY.
+ *
+ * @param handle Service handle
+ * @param stream_id Stream identifier
+ * @param out_partial Output: Committed and tentative text
+ * @return RAC_SUCCESS or error code
+ */
+RAC_WHISPERCPP_API rac_result_t rac_stt_whispercpp_stream_decode(
+    rac_handle_t handle, const char* stream_id, rac_stt_whispercpp_partial_t* out_partial);
+
+/**
+ * Marks the end of input; the next decode commits the remaining audio.
+ *
+ * @param handle Service handle
+ * @param stream_id Stream identifier
+ */
+RAC_WHISPERCPP_API void rac_stt_whispercpp_stream_finish(rac_handle_t handle,
+                                                         const char* stream_id);
+
+/**
+ * Destroys a stream.
+ *
+ * @param handle Service handle
+ * @param stream_id Stream identifier
+ */
+RAC_WHISPERCPP_API void rac_stt_whispercpp_stream_destroy(rac_handle_t handle,
+                                                          const char* stream_id);
+
+/**
+ * Frees the strings of a partial result.
+ *
+ * @param partial Partial result to free
+ */
+RAC_WHISPERCPP_API void rac_stt_whispercpp_partial_free(rac_stt_whispercpp_partial_t* partial);
+
 /**
  * Checks if model is loaded and ready.
  *
@@ -128,6 +304,65 @@ RAC_WHISPERCPP_API rac_bool_t rac_stt_whispercpp_is_ready(rac_handle_t handle);
  */
 RAC_WHISPERCPP_API void rac_stt_whispercpp_destroy(rac_handle_t handle);
 
+// =============================================================================
+// MODEL VARIANT SELECTION
+// =============================================================================
+
+/**
+ * Target real-time factor used when the service registry creates a WhisperCPP
+ * service for a model with registered variants; leaves headroom for streaming.
+ */
+#define RAC_STT_WHISPERCPP_DEFAULT_TARGET_RTF 0.5f
+
+/**
+ * A quantized variant of a Whisper model (see rac_model_registry_get_variants).
+ */
+typedef struct rac_stt_whispercpp_variant {
+    /** Path to the GGML model file */
+    const char* model_path;
+
+    /** Weight quantization, e.g. "f16", "q8_0", "q5_0" (informational, can be NULL) */
+    const char* quantization;
+
+    /** Real-time factor on the reference device (0 = unknown) */
+    float expected_rtf;
+} rac_stt_whispercpp_variant_t;
+
+/**
+ * Selects the best-quality variant expected to run within target_rtf here.
+ *
+ * A variant's expected RTF is scaled by the device speed (measured RTF over
+ * expected RTF). If no device speed is known yet, the fastest variant is
+ * loaded once and timed; the result is kept for the process lifetime. When no
+ * variant meets the target, the fastest one is selected.
+ *
+ * @param variants Variants, best quality first
+ * @param count Number of variants
+ * @param target_rtf Highest acceptable real-time factor (e.g. 0.5)
+ * @param out_index Output: Index of the selected variant
+ * @return RAC_SUCCESS or error code
+ */
+RAC_WHISPERCPP_API rac_result_t rac_stt_whispercpp_select_variant(
+    const rac_stt_whispercpp_variant_t* variants, size_t count, float target_rtf,
+    size_t* out_index);
+
+/**
+ * Gets the device speed factor (measured RTF / reference RTF).
+ *
+ * @param out_scale Output: Speed factor, 0 if not benchmarked yet
+ * @return RAC_SUCCESS or error code
+ */
+RAC_WHISPERCPP_API rac_result_t rac_stt_whispercpp_get_device_speed(float* out_scale);
+
+/**
+ * Sets the device speed factor, e.g. one persisted from an earlier run, so
+ * selection skips the benchmark.
+ *
+ * @param scale Speed factor (> 0)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_WHISPERCPP_API rac_result_t rac_stt_whispercpp_set_device_speed(float scale);
+
 // =============================================================================
 // BACKEND REGISTRATION
 // =============================================================================
@@ -57,9 +57,31 @@ RAC_ONNX_API rac_result_t rac_tts_onnx_synthesize(rac_handle_t handle, const cha
                                                   const rac_tts_options_t* options,
                                                   rac_tts_result_t* out_result);
 
+/**
+ * Synthesizes text sentence by sentence, invoking callback with float PCM
+ * for each sentence as soon as it is generated. Stops early on
+ * rac_tts_onnx_stop().
+ */
+RAC_ONNX_API rac_result_t rac_tts_onnx_synthesize_stream(rac_handle_t handle, const char* text,
+                                                         const rac_tts_options_t* options,
+                                                         rac_tts_stream_callback_t callback,
+                                                         void* user_data);
+
 RAC_ONNX_API rac_result_t rac_tts_onnx_get_voices(rac_handle_t handle, char*** out_voices,
                                                   size_t* out_count);
 
+/**
+ * Registers a custom voice on the loaded model, no reload needed. The voice
+ * renders with one of the model's speakers at its own speed; it can be used
+ * as a voice id right away and is listed by rac_tts_onnx_get_voices().
+ * An existing voice with the same id is replaced.
+ */
+RAC_ONNX_API rac_result_t rac_tts_onnx_add_voice(rac_handle_t handle, const char* voice_id,
+                                                 const char* name, int32_t speaker_id,
+                                                 float speed);
+
+RAC_ONNX_API rac_result_t rac_tts_onnx_remove_voice(rac_handle_t handle, const char* voice_id);
+
 RAC_ONNX_API void rac_tts_onnx_stop(rac_handle_t handle);
 
 RAC_ONNX_API void rac_tts_onnx_destroy(rac_handle_t handle);
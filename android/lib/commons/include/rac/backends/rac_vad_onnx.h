@@ -38,11 +38,47 @@ extern "C" {
 
 typedef struct rac_vad_onnx_config {
     int32_t sample_rate;
+    /** Speech probability threshold (0-1) of the Silero model */
     float energy_threshold;
     float frame_length;
     int32_t num_threads;
 } rac_vad_onnx_config_t;
 
+/**
+ * Result of feeding audio to a VAD stream.
+ */
+typedef struct rac_vad_onnx_stream_result {
+    /** RAC_TRUE while speech is ongoing at the end of the fed audio */
+    rac_bool_t is_speech;
+    /** Speech probability of the last 32 ms frame */
+    float probability;
+    /** Audio processed by the stream so far, in ms */
+    double timestamp_ms;
+    /** Speech segments that ended within this call */
+    int32_t segments_ended;
+    /** Bounds of the last segment that ended (valid if segments_ended > 0) */
+    double segment_start_ms;
+    double segment_end_ms;
+} rac_vad_onnx_stream_result_t;
+
+/**
+ * Audio for one stream in a batched feed.
+ */
+typedef struct rac_vad_onnx_stream_input {
+    const char* stream_id;
+    const float* samples;
+    size_t num_samples;
+    int32_t sample_rate;
+} rac_vad_onnx_stream_input_t;
+
+/**
+ * A detected speech segment.
+ */
+typedef struct rac_vad_onnx_segment {
+    double start_ms;
+    double end_ms;
+} rac_vad_onnx_segment_t;
+
 static const rac_vad_onnx_config_t RAC_VAD_ONNX_CONFIG_DEFAULT = {
     .sample_rate = 16000, .energy_threshold = 0.5f, .frame_length = 0.032f, .num_threads = 0};
 
@@ -69,6 +105,111 @@ RAC_ONNX_API rac_bool_t rac_vad_onnx_is_speech_active(rac_handle_t handle);
 
 RAC_ONNX_API void rac_vad_onnx_destroy(rac_handle_t handle);
 
+/**
+ * Finds the speech segments of a complete recording.
+ *
+ * @param handle VAD handle
+ * @param samples Float32 PCM samples (mono)
+ * @param num_samples Number of samples
+ * @param sample_rate Sample rate of samples (resampled to 16 kHz)
+ * @param out_segments Output: Segments (free with rac_vad_onnx_segments_free)
+ * @param out_count Output: Number of segments
+ * @return RAC_SUCCESS or error code
+ */
+RAC_ONNX_API rac_result_t rac_vad_onnx_detect_segments(rac_handle_t handle, const float* samples,
+                                                       size_t num_samples, int32_t sample_rate,
+                                                       rac_vad_onnx_segment_t** out_segments,
+                                                       size_t* out_count);
+
+RAC_ONNX_API void rac_vad_onnx_segments_free(rac_vad_onnx_segment_t* segments);
+
+// =============================================================================
+// STREAMING API
+// =============================================================================
+
+/**
+ * Creates a VAD stream with its own recurrent model state.
+ *
+ * @param handle VAD handle
+ * @param out_stream_id Output: Stream identifier (caller must free)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_ONNX_API rac_result_t rac_vad_onnx_stream_create(rac_handle_t handle, char** out_stream_id);
+
+/**
+ * Feeds audio to a stream; every complete 32 ms frame is evaluated.
+ *
+ * @param handle VAD handle
+ * @param stream_id Stream identifier
+ * @param samples Float32 PCM samples (mono)
+ * @param num_samples Number of samples
+ * @param sample_rate Sample rate of samples (resampled to 16 kHz)
+ * @param out_result Output: Speech state after this audio
+ * @return RAC_SUCCESS or error code
+ */
+RAC_ONNX_API rac_result_t rac_vad_onnx_stream_feed(rac_handle_t handle, const char* stream_id,
+                                                   const float* samples, size_t num_samples,
+                                                   int32_t sample_rate,
+                                                   rac_vad_onnx_stream_result_t* out_result);
+
+/**
+ * Feeds several streams at once. Their frames are evaluated together, one
+ * batched inference per 32 ms step, which is cheaper than separate feeds.
+ *
+ * @param handle VAD handle
+ * @param inputs Audio per stream
+ * @param count Number of inputs
+ * @param out_results Output: count results, in input order
+ * @return RAC_SUCCESS or error code
+ */
+RAC_ONNX_API rac_result_t rac_vad_onnx_stream_feed_batch(rac_handle_t handle,
+                                                         const rac_vad_onnx_stream_input_t* inputs,
+                                                         size_t count,
+                                                         rac_vad_onnx_stream_result_t* out_results);
+
+RAC_ONNX_API rac_result_t rac_vad_onnx_stream_reset(rac_handle_t handle, const char* stream_id);
+
+RAC_ONNX_API void rac_vad_onnx_stream_destroy(rac_handle_t handle, const char* stream_id);
+
+// =============================================================================
+// RUNTIME CONFIGURATION
+// =============================================================================
+
+typedef enum rac_onnx_execution_provider {
+    RAC_ONNX_PROVIDER_CPU = 0,
+    RAC_ONNX_PROVIDER_XNNPACK = 1,
+    RAC_ONNX_PROVIDER_NNAPI = 2,
+    RAC_ONNX_PROVIDER_QNN = 3,
+} rac_onnx_execution_provider_t;
+
+/**
+ * ONNX Runtime settings applied to every STT/TTS/VAD session created after
+ * the call. With use_global_thread_pool, all sessions run on one process-wide
+ * pool sized by the first backend to initialize.
+ */
+typedef struct rac_onnx_runtime_config {
+    /** Intra-op threads; 0 = half the cores, at most 4 (leaves room for llama.cpp) */
+    int32_t intra_op_threads;
+    int32_t inter_op_threads;
+    /** 0 = disabled, 1 = basic, 2 = extended, 99 = all */
+    int32_t graph_optimization_level;
+    /** Falls back to CPU when the provider is not available */
+    rac_onnx_execution_provider_t execution_provider;
+    rac_bool_t use_global_thread_pool;
+    /** Save graph-optimised ORT-format copies next to models and load those */
+    rac_bool_t cache_optimized_models;
+} rac_onnx_runtime_config_t;
+
+static const rac_onnx_runtime_config_t RAC_ONNX_RUNTIME_CONFIG_DEFAULT = {
+    .intra_op_threads = 0,
+    .inter_op_threads = 1,
+    .graph_optimization_level = 99,
+    .execution_provider = RAC_ONNX_PROVIDER_CPU,
+    .use_global_thread_pool = RAC_TRUE,
+    .cache_optimized_models = RAC_TRUE};
+
+RAC_ONNX_API rac_result_t rac_backend_onnx_set_runtime_config(const rac_onnx_runtime_config_t* config);
+
 // =============================================================================
 // BACKEND REGISTRATION
 // =============================================================================
@@ -79,6 +79,23 @@ typedef struct rac_lifecycle_metrics {
     int32_t total_unloads;
 } rac_lifecycle_metrics_t;
 
+/**
+ * @brief How model weights are brought into memory
+ *
+ * Backends that cannot honour a mode fall back to their default load.
+ */
+typedef enum rac_model_load_mode {
+    /** Backend default (memory-mapped for llama.cpp) */
+    RAC_MODEL_LOAD_MODE_DEFAULT = 0,
+    /** Memory-map and prefetch the file on a background thread; load returns
+     *  once the mapping exists, and warm reloads are mostly page-cache hits */
+    RAC_MODEL_LOAD_MODE_MMAP_PREFETCH = 1,
+    /** Memory-map and mlock the weights (hot models; subject to RLIMIT_MEMLOCK) */
+    RAC_MODEL_LOAD_MODE_MLOCK = 2,
+    /** Read the whole file into anonymous memory */
+    RAC_MODEL_LOAD_MODE_NO_MMAP = 3,
+} rac_model_load_mode_t;
+
 /**
  * @brief Lifecycle configuration
  */
@@ -91,6 +108,9 @@ typedef struct rac_lifecycle_config {
 
     /** User data for callbacks */
     void* user_data;
+
+    /** Load mode passed to the service on load (0 = backend default) */
+    rac_model_load_mode_t load_mode;
 } rac_lifecycle_config_t;
 
 /**
@@ -139,6 +159,9 @@ RAC_API rac_result_t rac_lifecycle_create(const rac_lifecycle_config_t* config,
  *
  * Mirrors Swift's ManagedLifecycle.load(_:)
  * If already loaded with same ID, skips duplicate load.
+ * A different model replaces the current one, which is parked within the
+ * residency budget (see rac_model_residency_config_t); loading a parked
+ * model switches back to it without calling the create callback.
  *
  * @param handle Lifecycle manager handle
  * @param model_path File path to the model (used for loading) - REQUIRED
@@ -153,10 +176,117 @@ RAC_API rac_result_t rac_lifecycle_load(rac_handle_t handle, const char* model_p
                                         const char* model_id, const char* model_name,
                                         rac_handle_t* out_service);
 
+// =============================================================================
+// ASYNC LOAD API
+// =============================================================================
+
+/** Opaque handle to an asynchronous load */
+typedef struct rac_lifecycle_load_op* rac_lifecycle_load_handle_t;
+
+/**
+ * @brief Load progress callback
+ *
+ * Called on the loader thread.
+ *
+ * @param progress Fraction loaded (0.0 - 1.0)
+ * @param user_data User-provided context
+ */
+typedef void (*rac_lifecycle_load_progress_fn)(float progress, void* user_data);
+
+/**
+ * @brief Load completion callback
+ *
+ * Called once on the loader thread, after the load handle is done.
+ *
+ * @param result RAC_SUCCESS, RAC_ERROR_CANCELLED, or the load error
+ * @param service Loaded service (NULL unless result is RAC_SUCCESS)
+ * @param user_data User-provided context
+ */
+typedef void (*rac_lifecycle_load_complete_fn)(rac_result_t result, rac_handle_t service,
+                                               void* user_data);
+
+/**
+ * @brief Load a model on a background thread
+ *
+ * Behaves like rac_lifecycle_load. Loads on one lifecycle still run one at a
+ * time, but the state and model getters never wait for them.
+ * rac_lifecycle_destroy cancels pending loads and waits for their completion
+ * callbacks, so the callbacks must not destroy the lifecycle themselves.
+ *
+ * @param handle Lifecycle manager handle
+ * @param model_path File path to the model - REQUIRED
+ * @param model_id Model identifier for telemetry (NULL = model_path)
+ * @param model_name Human-readable model name (NULL = model_id)
+ * @param progress_fn Progress callback (can be NULL)
+ * @param complete_fn Completion callback (can be NULL)
+ * @param user_data Passed to both callbacks
+ * @param out_load Output: Load handle (release with rac_lifecycle_load_release)
+ * @return RAC_SUCCESS if the load was started, or error code
+ */
+RAC_API rac_result_t rac_lifecycle_load_async(rac_handle_t handle, const char* model_path,
+                                              const char* model_id, const char* model_name,
+                                              rac_lifecycle_load_progress_fn progress_fn,
+                                              rac_lifecycle_load_complete_fn complete_fn,
+                                              void* user_data,
+                                              rac_lifecycle_load_handle_t* out_load);
+
+/**
+ * @brief Cancel an asynchronous load
+ *
+ * A load still waiting for an earlier one never starts. A running load stops
+ * at the backend's next progress report; if the backend cannot stop, the
+ * service it creates is destroyed. Either way the load completes with
+ * RAC_ERROR_CANCELLED. Does nothing once the load is done.
+ *
+ * @param load Load handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_lifecycle_load_cancel(rac_lifecycle_load_handle_t load);
+
+/**
+ * @brief Wait for an asynchronous load to finish
+ *
+ * @param load Load handle
+ * @param out_service Output: Loaded service (can be NULL)
+ * @return Result of the load
+ */
+RAC_API rac_result_t rac_lifecycle_load_wait(rac_lifecycle_load_handle_t load,
+                                             rac_handle_t* out_service);
+
+/**
+ * @brief Latest progress of an asynchronous load
+ *
+ * @param load Load handle
+ * @return Fraction loaded (0.0 - 1.0), 1.0 once done
+ */
+RAC_API float rac_lifecycle_load_get_progress(rac_lifecycle_load_handle_t load);
+
+/**
+ * @brief Release a load handle
+ *
+ * The load itself continues unless cancelled.
+ *
+ * @param load Load handle
+ */
+RAC_API void rac_lifecycle_load_release(rac_lifecycle_load_handle_t load);
+
+/**
+ * @brief Report progress from a create callback
+ *
+ * Backends call this from wherever they learn load progress (e.g. llama.cpp's
+ * progress callback). Only loads started with rac_lifecycle_load_async see
+ * the reports; elsewhere this does nothing.
+ *
+ * @param progress Fraction loaded (0.0 - 1.0)
+ * @return RAC_FALSE if the load was cancelled and the backend should stop
+ */
+RAC_API rac_bool_t rac_lifecycle_report_load_progress(float progress);
+
 /**
  * @brief Unload the currently loaded model
  *
  * Mirrors Swift's ManagedLifecycle.unload()
+ * Destroys the current service; services this lifecycle parked stay parked.
  *
  * @param handle Lifecycle manager handle
  * @return RAC_SUCCESS or error code
@@ -167,6 +297,7 @@ RAC_API rac_result_t rac_lifecycle_unload(rac_handle_t handle);
  * @brief Reset all state
  *
  * Mirrors Swift's ManagedLifecycle.reset()
+ * Also destroys the services this lifecycle parked.
  *
  * @param handle Lifecycle manager handle
  * @return RAC_SUCCESS or error code
@@ -211,6 +342,25 @@ RAC_API const char* rac_lifecycle_get_model_id(rac_handle_t handle);
  */
 RAC_API const char* rac_lifecycle_get_model_name(rac_handle_t handle);
 
+/**
+ * @brief Get the load mode used for the next load
+ *
+ * Safe to call from the service creation callback.
+ *
+ * @param handle Lifecycle manager handle
+ * @return Load mode (RAC_MODEL_LOAD_MODE_DEFAULT if handle is NULL)
+ */
+RAC_API rac_model_load_mode_t rac_lifecycle_get_load_mode(rac_handle_t handle);
+
+/**
+ * @brief Change the load mode for subsequent loads
+ *
+ * @param handle Lifecycle manager handle
+ * @param mode New load mode
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_lifecycle_set_load_mode(rac_handle_t handle, rac_model_load_mode_t mode);
+
 /**
  * @brief Get current service handle
  *
@@ -263,6 +413,99 @@ RAC_API rac_result_t rac_lifecycle_get_metrics(rac_handle_t handle,
  */
 RAC_API void rac_lifecycle_destroy(rac_handle_t handle);
 
+// =============================================================================
+// RESIDENCY API - Keeps recently used services loaded across model switches
+// =============================================================================
+
+/**
+ * @brief Residency configuration
+ *
+ * When a lifecycle loads a different model, its current service is parked
+ * instead of destroyed, and a later rac_lifecycle_load of a parked model
+ * switches back without reloading. Parked services of all lifecycles share
+ * one budget with the loaded ones; the least recently used parked services
+ * are destroyed to stay within it. Their model files remain in the page
+ * cache, so even an evicted model reloads faster than a cold one.
+ *
+ * Service sizes are estimated from the model files on disk.
+ */
+typedef struct rac_model_residency_config {
+    /** Bytes that loaded and parked services may use together
+        (0 = max_memory_fraction of device RAM) */
+    int64_t budget_bytes;
+
+    /** Share of total device RAM used when budget_bytes is 0; parking is off
+        if device memory is not known */
+    float max_memory_fraction;
+
+    /** Most services parked at once across all lifecycles (0 = never park) */
+    int32_t max_parked_services;
+} rac_model_residency_config_t;
+
+static const rac_model_residency_config_t RAC_MODEL_RESIDENCY_CONFIG_DEFAULT = {
+    .budget_bytes = 0, .max_memory_fraction = 0.35f, .max_parked_services = 2};
+
+/**
+ * @brief Residency counters
+ */
+typedef struct rac_model_residency_stats {
+    /** Estimated bytes of loaded plus parked services */
+    int64_t resident_bytes;
+
+    /** Budget in effect (0 = parking off) */
+    int64_t budget_bytes;
+
+    int32_t loaded_services;
+    int32_t parked_services;
+
+    /** Loads served from a parked service */
+    int64_t hits;
+
+    /** Loads that created a service */
+    int64_t misses;
+
+    /** Parked services destroyed for the budget or by rac_model_residency_trim */
+    int64_t evictions;
+} rac_model_residency_stats_t;
+
+/**
+ * @brief Replace the residency configuration
+ *
+ * Parked services beyond the new limits are destroyed right away.
+ *
+ * @param config Configuration (NULL for defaults)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_residency_configure(const rac_model_residency_config_t* config);
+
+/**
+ * @brief Destroy all parked services
+ *
+ * Call under memory pressure; loaded services are left alone. Also runs
+ * in the DROP_CACHES stage of rac_memory_pressure_notify.
+ *
+ * @return Estimated bytes released
+ */
+RAC_API int64_t rac_model_residency_trim(void);
+
+/**
+ * @brief Get residency counters
+ *
+ * @param out_stats Output: Counters
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_residency_get_stats(rac_model_residency_stats_t* out_stats);
+
+/**
+ * @brief Estimated bytes of a lifecycle's loaded service
+ *
+ * Estimated from the model files on disk, like the residency budget.
+ *
+ * @param handle Lifecycle manager handle
+ * @return Bytes, 0 if nothing is loaded
+ */
+RAC_API int64_t rac_lifecycle_get_resident_bytes(rac_handle_t handle);
+
 // =============================================================================
 // CONVENIENCE STATE HELPERS
 // =============================================================================
@@ -0,0 +1,168 @@
+/**
+ * @file rac_allocator.h
+ * @brief RunAnywhere Commons - Pluggable Allocator and Allocation Tracking
+ *
+ * Every buffer the SDK hands across the C API (results, events, telemetry
+ * payloads, model records, errors) is allocated through rac_alloc and freed
+ * through rac_free. The host can route those allocations to its own
+ * allocator (mimalloc, or an arena it selects per request inside its
+ * callbacks), and can turn on tracking to see live bytes and allocation
+ * counts per subsystem tag.
+ *
+ * Tracking keeps block sizes in a side table rather than in a header, so it
+ * can be switched on and off at any time: blocks allocated while it is on
+ * are accounted until they are freed, others are freed untouched. It costs
+ * a locked table update per allocation and is meant for profiling builds
+ * and debug screens, not for production.
+ *
+ * Backend engines (llama.cpp, whisper.cpp, ONNX Runtime) and C++ containers
+ * inside the SDK keep their own allocators.
+ */
+
+#ifndef RAC_ALLOCATOR_H
+#define RAC_ALLOCATOR_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Subsystem an allocation is accounted to
+ */
+typedef enum rac_alloc_tag {
+    RAC_ALLOC_TAG_GENERAL = 0,   /**< Untagged rac_alloc/rac_strdup */
+    RAC_ALLOC_TAG_RESULT = 1,    /**< LLM/STT/TTS/VAD results and service objects */
+    RAC_ALLOC_TAG_EVENT = 2,     /**< Events and stream payloads */
+    RAC_ALLOC_TAG_TELEMETRY = 3, /**< Telemetry JSON and analytics ids */
+    RAC_ALLOC_TAG_MODEL = 4,     /**< Model registry, downloads, storage */
+    RAC_ALLOC_TAG_NETWORK = 5,   /**< HTTP requests/responses and auth */
+    RAC_ALLOC_TAG_AUDIO = 6,     /**< WAV buffers and cached audio */
+    RAC_ALLOC_TAG_ERROR = 7,     /**< Structured errors */
+    RAC_ALLOC_TAG_COUNT = 8
+} rac_alloc_tag_t;
+
+/**
+ * @brief Host allocator
+ *
+ * All three functions are required. Returned memory must be aligned for any
+ * C type (like malloc). realloc and free are only given pointers this
+ * allocator returned. user_data is passed through unchanged.
+ */
+typedef struct rac_allocator {
+    void* (*alloc)(size_t size, void* user_data);
+    void* (*realloc)(void* ptr, size_t size, void* user_data);
+    void (*free)(void* ptr, void* user_data);
+    void* user_data;
+} rac_allocator_t;
+
+/**
+ * @brief Allocation counters for one tag
+ *
+ * Only allocations made while tracking is on are counted.
+ */
+typedef struct rac_alloc_stats {
+    /** Bytes currently allocated */
+    int64_t live_bytes;
+
+    /** Blocks currently allocated */
+    int64_t live_count;
+
+    /** Highest live_bytes since tracking started or the last reset */
+    int64_t peak_bytes;
+
+    /** Allocations (including reallocations) since the last reset */
+    int64_t total_count;
+
+    /** Bytes requested by those allocations */
+    int64_t total_bytes;
+} rac_alloc_stats_t;
+
+// =============================================================================
+// ALLOCATOR API
+// =============================================================================
+
+/**
+ * @brief Install the allocator behind rac_alloc, rac_realloc and rac_free
+ *
+ * Must be called before anything is allocated through rac_alloc, i.e.
+ * before rac_init, since memory cannot move between allocators. Buffers the
+ * host returns through platform callbacks that are documented as "freed
+ * with rac_free" must then come from this allocator too.
+ *
+ * @param allocator Allocator to use (copied), or NULL for malloc/free
+ * @return RAC_SUCCESS, RAC_ERROR_INVALID_ARGUMENT if a function is missing,
+ *         or RAC_ERROR_INVALID_STATE if memory has already been allocated
+ */
+RAC_API rac_result_t rac_set_allocator(const rac_allocator_t* allocator);
+
+/**
+ * @brief Allocate memory accounted to a tag
+ */
+RAC_API void* rac_alloc_tagged(rac_alloc_tag_t tag, size_t size);
+
+/**
+ * @brief Allocate zeroed memory for count elements, accounted to a tag
+ */
+RAC_API void* rac_calloc_tagged(rac_alloc_tag_t tag, size_t count, size_t size);
+
+/**
+ * @brief Duplicate a string, accounted to a tag
+ */
+RAC_API char* rac_strdup_tagged(rac_alloc_tag_t tag, const char* str);
+
+// =============================================================================
+// TRACKING API
+// =============================================================================
+
+/**
+ * @brief Turn allocation tracking on or off
+ */
+RAC_API void rac_alloc_set_tracking(rac_bool_t enabled);
+
+/**
+ * @brief Whether allocation tracking is on
+ */
+RAC_API rac_bool_t rac_alloc_is_tracking(void);
+
+/**
+ * @brief Read the counters for one tag
+ *
+ * @param tag Tag to read
+ * @param out_stats Output: Counters
+ * @return RAC_SUCCESS or RAC_ERROR_INVALID_ARGUMENT
+ */
+RAC_API rac_result_t rac_alloc_get_stats(rac_alloc_tag_t tag, rac_alloc_stats_t* out_stats);
+
+/**
+ * @brief Read the counters for every tag as JSON
+ *
+ * Format: {"tracking":bool,"tags":{name:{"live_bytes","live_count",
+ *          "peak_bytes","total_count","total_bytes"}}}
+ *
+ * @param out_json Output: JSON string (must be freed with rac_free)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_alloc_stats_json(char** out_json);
+
+/**
+ * @brief Zero the totals and restart the peaks from the live values
+ */
+RAC_API void rac_alloc_reset_stats(void);
+
+/**
+ * @brief Lowercase name of a tag ("result", "telemetry", ...)
+ */
+RAC_API const char* rac_alloc_tag_name(rac_alloc_tag_t tag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_ALLOCATOR_H */
@@ -121,6 +121,8 @@ typedef enum rac_event_type {
     // Device Events (900-999)
     RAC_EVENT_DEVICE_REGISTERED = 900,
     RAC_EVENT_DEVICE_REGISTRATION_FAILED = 901,
+    RAC_EVENT_DEVICE_PROFILED = 902,
+    RAC_EVENT_DEVICE_PERF_SAMPLED = 903,
 
     // Network Events (1000-1099)
     RAC_EVENT_NETWORK_CONNECTIVITY_CHANGED = 1000,
@@ -180,6 +182,12 @@ typedef struct rac_analytics_llm_generation {
     rac_result_t error_code;
     /** Error message (NULL if no error) */
     const char* error_message;
+    /** Highest process RSS during the call in bytes (completed events, 0 if unknown) */
+    int64_t peak_rss_bytes;
+    /** Process RSS change over the call in bytes */
+    int64_t rss_delta_bytes;
+    /** Memory the backend reports holding in bytes (0 if unknown) */
+    int64_t backend_memory_bytes;
 } rac_analytics_llm_generation_t;
 
 /**
@@ -240,6 +248,12 @@ typedef struct rac_analytics_stt_transcription {
     rac_result_t error_code;
     /** Error message (NULL if no error) */
     const char* error_message;
+    /** Highest process RSS during the call in bytes (completed events, 0 if unknown) */
+    int64_t peak_rss_bytes;
+    /** Process RSS change over the call in bytes */
+    int64_t rss_delta_bytes;
+    /** Memory the backend reports holding in bytes (0 if unknown) */
+    int64_t backend_memory_bytes;
 } rac_analytics_stt_transcription_t;
 
 /**
@@ -271,6 +285,12 @@ typedef struct rac_analytics_tts_synthesis {
     rac_result_t error_code;
     /** Error message (NULL if no error) */
     const char* error_message;
+    /** Highest process RSS during the call in bytes (completed events, 0 if unknown) */
+    int64_t peak_rss_bytes;
+    /** Process RSS change over the call in bytes */
+    int64_t rss_delta_bytes;
+    /** Memory the backend reports holding in bytes (0 if unknown) */
+    int64_t backend_memory_bytes;
 } rac_analytics_tts_synthesis_t;
 
 /**
@@ -322,6 +342,8 @@ typedef struct rac_analytics_sdk_lifecycle {
     rac_result_t error_code;
     /** Error message (NULL if no error) */
     const char* error_message;
+    /** Initialized subsystem (rac_init_graph), NULL for the SDK as a whole */
+    const char* subsystem;
 } rac_analytics_sdk_lifecycle_t;
 
 /**
@@ -350,6 +372,53 @@ typedef struct rac_analytics_device {
     const char* error_message;
 } rac_analytics_device_t;
 
+/**
+ * @brief Device performance profile event data
+ * Used for: DEVICE_PROFILED
+ */
+typedef struct rac_analytics_device_profile {
+    /** Device class name ("low", "mid", "high") */
+    const char* device_class;
+    /** Multi-threaded single-precision matmul throughput */
+    double matmul_gflops;
+    /** Sustained memory bandwidth in GB/s */
+    double memory_bandwidth_gbps;
+    /** Reference model prompt processing speed (0 if not measured) */
+    double prefill_tokens_per_second;
+    /** Reference model decode speed (0 if not measured) */
+    double decode_tokens_per_second;
+    /** Reference model ID (NULL if not measured) */
+    const char* reference_model_id;
+    /** Thread count the matmul peaked at */
+    int32_t best_threads;
+    /** Calibration wall time */
+    double duration_ms;
+} rac_analytics_device_profile_t;
+
+/**
+ * @brief Field performance sample event data (rac_perf_sampler.h)
+ * Used for: DEVICE_PERF_SAMPLED
+ */
+typedef struct rac_analytics_perf_sample {
+    /** Trace span name ("LLM.decode") */
+    const char* stage;
+    /** Thermal state while the spans ended ("nominal", "fair", ...) */
+    const char* thermal_state;
+    /** Spans timed in the window */
+    int32_t count;
+    /** Duration percentiles and maximum in milliseconds */
+    double p50_ms;
+    double p95_ms;
+    double p99_ms;
+    double max_ms;
+    /** Sparse histogram, "<bucket lower bound us>:<count>" joined by ',' */
+    const char* histogram;
+    /** Mean CPU frequency across cores over the window (0 if unknown) */
+    double cpu_freq_mhz;
+    /** Window length in milliseconds */
+    double window_ms;
+} rac_analytics_perf_sample_t;
+
 /**
  * @brief Network event data
  * Used for: NETWORK_CONNECTIVITY_CHANGED
@@ -401,6 +470,32 @@ typedef struct rac_analytics_voice_agent_state {
     const char* error_message;
 } rac_analytics_voice_agent_state_t;
 
+/**
+ * @brief Voice agent turn event data
+ * Used for: VOICE_AGENT_TURN_COMPLETED, VOICE_AGENT_TURN_FAILED
+ * Stage durations are in milliseconds, -1 for stages the turn did not complete.
+ */
+typedef struct rac_analytics_voice_agent_turn {
+    /** Whole turn */
+    double total_ms;
+    /** End of speech until end of turn was declared */
+    double endpoint_ms;
+    /** Final transcription */
+    double stt_ms;
+    /** Response generation */
+    double llm_ms;
+    /** Generation start to first token */
+    double llm_first_token_ms;
+    /** Speech synthesis */
+    double tts_ms;
+    /** Synthesis start to first audio */
+    double tts_first_chunk_ms;
+    /** Turn start to first audio handed to the app */
+    double first_audio_ms;
+    /** Error code (RAC_SUCCESS if no error) */
+    rac_result_t error_code;
+} rac_analytics_voice_agent_turn_t;
+
 /**
  * @brief Union of all event data types
  */
@@ -416,9 +511,12 @@ typedef struct rac_analytics_event_data {
         rac_analytics_sdk_lifecycle_t sdk_lifecycle;
         rac_analytics_storage_t storage;
         rac_analytics_device_t device;
+        rac_analytics_device_profile_t device_profile;
+        rac_analytics_perf_sample_t perf_sample;
         rac_analytics_network_t network;
         rac_analytics_sdk_error_t sdk_error;
         rac_analytics_voice_agent_state_t voice_agent_state;
+        rac_analytics_voice_agent_turn_t voice_agent_turn;
     } data;
 } rac_analytics_event_data_t;
 
@@ -451,6 +549,19 @@ typedef void (*rac_analytics_callback_fn)(rac_event_type_t type,
 RAC_API rac_result_t rac_analytics_events_set_callback(rac_analytics_callback_fn callback,
                                                        void* user_data);
 
+/**
+ * @brief Limit the analytics callback to some event types
+ *
+ * Other types are not delivered to it, and emitters skip building events no
+ * callback wants (see rac_analytics_event_is_observed).
+ *
+ * @param types Event types to deliver (NULL for every type, the default)
+ * @param count Number of types
+ * @return RAC_SUCCESS, or RAC_ERROR_INVALID_ARGUMENT for an unknown type
+ */
+RAC_API rac_result_t rac_analytics_events_set_callback_filter(const rac_event_type_t* types,
+                                                              size_t count);
+
 /**
  * @brief Emit an analytics event
  *
@@ -510,6 +621,50 @@ RAC_API rac_result_t rac_analytics_events_set_public_callback(rac_public_event_c
  */
 RAC_API rac_bool_t rac_analytics_events_has_public_callback(void);
 
+/**
+ * @brief Limit the public callback to some event types
+ *
+ * @param types Event types to deliver (NULL for every type, the default)
+ * @param count Number of types
+ * @return RAC_SUCCESS, or RAC_ERROR_INVALID_ARGUMENT for an unknown type
+ */
+RAC_API rac_result_t rac_analytics_events_set_public_callback_filter(
+    const rac_event_type_t* types, size_t count);
+
+/**
+ * @brief Check whether an event of this type would reach any callback
+ *
+ * Accounts for registered callbacks, their filters and the type's
+ * destination. One relaxed atomic load, no lock: emitters call it before
+ * filling rac_analytics_event_data_t. A callback registered concurrently may
+ * miss events emitted while it is being set.
+ *
+ * @param type Event type
+ * @return RAC_TRUE if some callback receives the type, RAC_FALSE otherwise
+ */
+RAC_API rac_bool_t rac_analytics_event_is_observed(rac_event_type_t type);
+
+// =============================================================================
+// EVENT COALESCING
+// =============================================================================
+
+/** Default coalescing window for high-frequency progress events */
+#define RAC_ANALYTICS_COALESCE_WINDOW_DEFAULT_MS 100
+
+/**
+ * @brief Set the coalescing window for high-frequency progress events
+ *
+ * LLM_STREAMING_UPDATE (per generation_id), MODEL_DOWNLOAD_PROGRESS and
+ * MODEL_EXTRACTION_PROGRESS (per model_id) reach the callbacks at most once
+ * per window and ID, always with the latest state. An update held back is
+ * delivered when its window ends, and always before the completed, failed or
+ * cancelled event of its ID.
+ *
+ * @param window_ms Window in milliseconds (0 delivers every update)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_analytics_events_set_coalesce_window(int32_t window_ms);
+
 // =============================================================================
 // DEFAULT EVENT DATA
 // =============================================================================
@@ -530,7 +685,10 @@ static const rac_analytics_llm_generation_t RAC_ANALYTICS_LLM_GENERATION_DEFAULT
     .max_tokens = 0,
     .context_length = 0,
     .error_code = RAC_SUCCESS,
-    .error_message = RAC_NULL};
+    .error_message = RAC_NULL,
+    .peak_rss_bytes = 0,
+    .rss_delta_bytes = 0,
+    .backend_memory_bytes = 0};
 
 /** Default STT transcription event */
 static const rac_analytics_stt_transcription_t RAC_ANALYTICS_STT_TRANSCRIPTION_DEFAULT = {
@@ -549,7 +707,10 @@ static const rac_analytics_stt_transcription_t RAC_ANALYTICS_STT_TRANSCRIPTION_D
     .is_streaming = RAC_FALSE,
     .framework = RAC_FRAMEWORK_UNKNOWN,
     .error_code = RAC_SUCCESS,
-    .error_message = RAC_NULL};
+    .error_message = RAC_NULL,
+    .peak_rss_bytes = 0,
+    .rss_delta_bytes = 0,
+    .backend_memory_bytes = 0};
 
 /** Default TTS synthesis event */
 static const rac_analytics_tts_synthesis_t RAC_ANALYTICS_TTS_SYNTHESIS_DEFAULT = {
@@ -564,7 +725,10 @@ static const rac_analytics_tts_synthesis_t RAC_ANALYTICS_TTS_SYNTHESIS_DEFAULT =
     .sample_rate = 0,
     .framework = RAC_FRAMEWORK_UNKNOWN,
     .error_code = RAC_SUCCESS,
-    .error_message = RAC_NULL};
+    .error_message = RAC_NULL,
+    .peak_rss_bytes = 0,
+    .rss_delta_bytes = 0,
+    .backend_memory_bytes = 0};
 
 /** Default VAD event */
 static const rac_analytics_vad_t RAC_ANALYTICS_VAD_DEFAULT = {.speech_duration_ms = 0.0,
@@ -584,7 +748,11 @@ static const rac_analytics_model_download_t RAC_ANALYTICS_MODEL_DOWNLOAD_DEFAULT
 
 /** Default SDK lifecycle event */
 static const rac_analytics_sdk_lifecycle_t RAC_ANALYTICS_SDK_LIFECYCLE_DEFAULT = {
-    .duration_ms = 0.0, .count = 0, .error_code = RAC_SUCCESS, .error_message = RAC_NULL};
+    .duration_ms = 0.0,
+    .count = 0,
+    .error_code = RAC_SUCCESS,
+    .error_message = RAC_NULL,
+    .subsystem = RAC_NULL};
 
 /** Default storage event */
 static const rac_analytics_storage_t RAC_ANALYTICS_STORAGE_DEFAULT = {
@@ -594,6 +762,30 @@ static const rac_analytics_storage_t RAC_ANALYTICS_STORAGE_DEFAULT = {
 static const rac_analytics_device_t RAC_ANALYTICS_DEVICE_DEFAULT = {
     .device_id = RAC_NULL, .error_code = RAC_SUCCESS, .error_message = RAC_NULL};
 
+/** Default device profile event */
+static const rac_analytics_device_profile_t RAC_ANALYTICS_DEVICE_PROFILE_DEFAULT = {
+    .device_class = RAC_NULL,
+    .matmul_gflops = 0.0,
+    .memory_bandwidth_gbps = 0.0,
+    .prefill_tokens_per_second = 0.0,
+    .decode_tokens_per_second = 0.0,
+    .reference_model_id = RAC_NULL,
+    .best_threads = 0,
+    .duration_ms = 0.0};
+
+/** Default perf sample event */
+static const rac_analytics_perf_sample_t RAC_ANALYTICS_PERF_SAMPLE_DEFAULT = {
+    .stage = RAC_NULL,
+    .thermal_state = RAC_NULL,
+    .count = 0,
+    .p50_ms = 0.0,
+    .p95_ms = 0.0,
+    .p99_ms = 0.0,
+    .max_ms = 0.0,
+    .histogram = RAC_NULL,
+    .cpu_freq_mhz = 0.0,
+    .window_ms = 0.0};
+
 /** Default network event */
 static const rac_analytics_network_t RAC_ANALYTICS_NETWORK_DEFAULT = {.is_online = RAC_FALSE};
 
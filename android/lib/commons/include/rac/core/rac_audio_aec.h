@@ -0,0 +1,125 @@
+/**
+ * @file rac_audio_aec.h
+ * @brief RunAnywhere Commons - Acoustic Echo Canceller
+ *
+ * Removes the assistant's own playback from the microphone signal so speech
+ * detection can keep running while TTS plays (barge-in). The playback signal
+ * is fed as reference; an NLMS adaptive filter models the speaker-to-mic path
+ * and subtracts the predicted echo. Adaptation freezes while the near end is
+ * talking (Geigel double-talk detector), so the user's voice is not cancelled.
+ *
+ * The reference must be fed at the rate it is played, e.g. from the playback
+ * callback, and the microphone signal processed at the rate it is captured:
+ * each microphone sample consumes one reference sample. The filter length has
+ * to cover the output-to-input latency plus the room's echo tail.
+ */
+
+#ifndef RAC_AUDIO_AEC_H
+#define RAC_AUDIO_AEC_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Echo canceller configuration
+ */
+typedef struct rac_audio_aec_config {
+    /** Sample rate of both signals in Hz */
+    int32_t sample_rate;
+
+    /** Echo path length covered by the filter, in milliseconds */
+    int32_t filter_length_ms;
+
+    /** NLMS step size (0-1; larger converges faster but is noisier) */
+    float step_size;
+
+    /** Near-end talk is declared when |mic| exceeds this times the recent
+        reference peak; adaptation pauses while it lasts. 0.5 assumes the echo
+        is at least 6 dB quieter than playback; raise it for louder coupling */
+    float double_talk_ratio;
+} rac_audio_aec_config_t;
+
+/**
+ * @brief Default configuration (16 kHz, 128 ms echo path)
+ */
+static const rac_audio_aec_config_t RAC_AUDIO_AEC_CONFIG_DEFAULT = {
+    .sample_rate = 16000, .filter_length_ms = 128, .step_size = 0.3f, .double_talk_ratio = 0.5f};
+
+/**
+ * @brief Opaque handle for an echo canceller
+ */
+typedef struct rac_audio_aec* rac_audio_aec_t;
+
+// =============================================================================
+// ECHO CANCELLER API
+// =============================================================================
+
+/**
+ * @brief Create an echo canceller
+ *
+ * @param config Configuration (NULL for defaults)
+ * @param out_aec Output: Echo canceller handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_audio_aec_create(const rac_audio_aec_config_t* config,
+                                          rac_audio_aec_t* out_aec);
+
+/**
+ * @brief Feed playback (far-end) audio as it is played
+ *
+ * Safe to call from a different thread than rac_audio_aec_process.
+ *
+ * @param aec Echo canceller handle
+ * @param samples Float32 samples being played
+ * @param num_samples Number of samples
+ */
+RAC_API void rac_audio_aec_feed_reference(rac_audio_aec_t aec, const float* samples,
+                                          size_t num_samples);
+
+/**
+ * @brief Remove echo from captured microphone audio
+ *
+ * @param aec Echo canceller handle
+ * @param mic Captured samples
+ * @param out Output: Echo-cancelled samples (may be the same buffer as mic)
+ * @param num_samples Number of samples
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_audio_aec_process(rac_audio_aec_t aec, const float* mic, float* out,
+                                           size_t num_samples);
+
+/**
+ * @brief Whether reference audio is queued or still echoing
+ *
+ * @param aec Echo canceller handle
+ * @return RAC_TRUE while playback fed in the last filter length is pending
+ */
+RAC_API rac_bool_t rac_audio_aec_is_active(rac_audio_aec_t aec);
+
+/**
+ * @brief Drop queued reference audio and the learned echo path
+ *
+ * @param aec Echo canceller handle
+ */
+RAC_API void rac_audio_aec_reset(rac_audio_aec_t aec);
+
+/**
+ * @brief Destroy an echo canceller
+ *
+ * @param aec Echo canceller handle
+ */
+RAC_API void rac_audio_aec_destroy(rac_audio_aec_t aec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_AUDIO_AEC_H */
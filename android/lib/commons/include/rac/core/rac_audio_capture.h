@@ -0,0 +1,184 @@
+/**
+ * @file rac_audio_capture.h
+ * @brief RunAnywhere Commons - Native Microphone Capture
+ *
+ * Records the microphone in native code and hands Float32 mono samples to a
+ * callback on the capture thread, so audio reaches the VAD and STT without
+ * passing through Kotlin/Dart buffers and a JNI/FFI copy per frame. On
+ * Android the stream is opened with AAudio (API 26+, loaded at runtime) in
+ * low-latency mode, whose callback thread is already real-time. Elsewhere
+ * (an AVAudioEngine input tap on iOS) the platform adapter's
+ * audio_capture_start/audio_capture_stop callbacks provide the audio.
+ *
+ * Audio arriving at another rate than requested is resampled and multi-
+ * channel input is downmixed before the callback sees it. The callback must
+ * not block: rac_voice_session_feed_audio and rac_vad_component_push_audio
+ * are lock-free and meant to be called from it.
+ */
+
+#ifndef RAC_AUDIO_CAPTURE_H
+#define RAC_AUDIO_CAPTURE_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Where captured audio comes from
+ */
+typedef enum rac_audio_capture_backend {
+    /** AAudio where available, otherwise the platform adapter */
+    RAC_AUDIO_CAPTURE_BACKEND_AUTO = 0,
+    /** Android AAudio */
+    RAC_AUDIO_CAPTURE_BACKEND_AAUDIO = 1,
+    /** Platform adapter audio_capture_start/audio_capture_stop */
+    RAC_AUDIO_CAPTURE_BACKEND_PLATFORM = 2,
+} rac_audio_capture_backend_t;
+
+/**
+ * @brief Capture configuration
+ */
+typedef struct rac_audio_capture_config {
+    /** Sample rate delivered to the callback in Hz */
+    int32_t sample_rate;
+
+    /** Samples per callback at the device rate (0 = the device burst) */
+    int32_t frames_per_callback;
+
+    /** Prefer the low-latency path (AAudio MMAP when the device has it) */
+    rac_bool_t low_latency;
+
+    /** Use the voice recognition input preset: no AGC or noise suppression
+        tuned for calls (Android 9+) */
+    rac_bool_t voice_recognition;
+
+    /** Input device ID (0 = default microphone) */
+    int32_t device_id;
+
+    /** Backend to open */
+    rac_audio_capture_backend_t backend;
+} rac_audio_capture_config_t;
+
+/**
+ * @brief Default configuration (16 kHz for speech models, low latency)
+ */
+static const rac_audio_capture_config_t RAC_AUDIO_CAPTURE_CONFIG_DEFAULT = {
+    .sample_rate = 16000,
+    .frames_per_callback = 0,
+    .low_latency = RAC_TRUE,
+    .voice_recognition = RAC_TRUE,
+    .device_id = 0,
+    .backend = RAC_AUDIO_CAPTURE_BACKEND_AUTO};
+
+/**
+ * @brief Callback receiving captured audio
+ *
+ * Invoked on the capture thread; must not block or allocate.
+ *
+ * @param samples Float32 mono samples at the configured rate (valid during the call)
+ * @param num_samples Number of samples
+ * @param user_data User-provided context
+ */
+typedef void (*rac_audio_capture_callback_fn)(const float* samples, size_t num_samples,
+                                              void* user_data);
+
+/**
+ * @brief Capture counters
+ */
+typedef struct rac_audio_capture_stats {
+    /** Backend in use (AUTO while stopped) */
+    rac_audio_capture_backend_t backend;
+
+    /** Rate the device records at in Hz (0 until audio arrives) */
+    int32_t device_sample_rate;
+
+    /** Frames per device burst (0 if the backend does not report it) */
+    int32_t burst_frames;
+
+    /** Samples handed to the callback since start */
+    int64_t samples_delivered;
+
+    /** Overruns the device reported since start (AAudio only) */
+    int32_t xruns;
+} rac_audio_capture_stats_t;
+
+/**
+ * @brief Opaque handle for a capture source
+ */
+typedef struct rac_audio_capture* rac_audio_capture_handle_t;
+
+// =============================================================================
+// AUDIO CAPTURE API
+// =============================================================================
+
+/**
+ * @brief Whether native capture can be opened on this device
+ *
+ * True with AAudio (Android 8.0+) or a platform adapter that implements
+ * audio_capture_start.
+ */
+RAC_API rac_bool_t rac_audio_capture_is_available(void);
+
+/**
+ * @brief Create a capture source (stopped)
+ *
+ * @param config Configuration (NULL for defaults)
+ * @param callback Callback receiving the audio
+ * @param user_data User context passed to callback
+ * @param out_handle Output: Capture handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_audio_capture_create(const rac_audio_capture_config_t* config,
+                                              rac_audio_capture_callback_fn callback,
+                                              void* user_data,
+                                              rac_audio_capture_handle_t* out_handle);
+
+/**
+ * @brief Open the microphone and start delivering audio
+ *
+ * The app must hold the record permission. On Android a disconnected device
+ * (headset unplugged) is reopened on the default microphone.
+ *
+ * @param handle Capture handle
+ * @return RAC_SUCCESS, RAC_ERROR_NOT_SUPPORTED without a backend, or
+ *         RAC_ERROR_AUDIO_SESSION_FAILED if the device could not be opened
+ */
+RAC_API rac_result_t rac_audio_capture_start(rac_audio_capture_handle_t handle);
+
+/**
+ * @brief Stop capturing; the callback is not called once this returns
+ *
+ * @param handle Capture handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_audio_capture_stop(rac_audio_capture_handle_t handle);
+
+/**
+ * @brief Read the capture counters
+ *
+ * @param handle Capture handle
+ * @param out_stats Output: Counters
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_audio_capture_get_stats(rac_audio_capture_handle_t handle,
+                                                 rac_audio_capture_stats_t* out_stats);
+
+/**
+ * @brief Stop and destroy a capture source
+ *
+ * @param handle Capture handle
+ */
+RAC_API void rac_audio_capture_destroy(rac_audio_capture_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_AUDIO_CAPTURE_H */
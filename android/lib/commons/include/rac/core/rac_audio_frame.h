@@ -0,0 +1,92 @@
+/**
+ * @file rac_audio_frame.h
+ * @brief RunAnywhere Commons - Pooled Audio Frames
+ *
+ * Reference-counted Float32 sample buffers carved from slab arenas. Released
+ * buffers go back to a free list for their size class instead of the heap,
+ * so a voice session that keeps converting frames of similar size stops
+ * allocating once the pool is warm. Buffers larger than the biggest class
+ * (about 65 s at 16 kHz) are allocated and freed directly.
+ *
+ * Data is 64-byte aligned. Buffers are not zeroed when acquired. Slab memory
+ * is kept for the life of the process.
+ */
+
+#ifndef RAC_AUDIO_FRAME_H
+#define RAC_AUDIO_FRAME_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Opaque handle for a pooled audio frame
+ */
+typedef struct rac_audio_frame* rac_audio_frame_t;
+
+/**
+ * @brief Pool usage counters
+ */
+typedef struct rac_audio_frame_pool_stats {
+    /** Bytes held in slabs, free or in use */
+    size_t slab_bytes;
+
+    /** Frames currently acquired (pooled and oversized) */
+    size_t frames_in_use;
+
+    /** Slab allocations since start; flat in steady state */
+    size_t slab_allocations;
+} rac_audio_frame_pool_stats_t;
+
+// =============================================================================
+// AUDIO BUFFER API
+// =============================================================================
+
+/**
+ * @brief Acquire a frame of num_samples samples, with a reference count of 1
+ *
+ * @param num_samples Number of samples
+ * @param out_frame Output: Frame handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_audio_frame_acquire(size_t num_samples, rac_audio_frame_t* out_frame);
+
+/**
+ * @brief Sample storage of the frame
+ */
+RAC_API float* rac_audio_frame_data(rac_audio_frame_t frame);
+
+/**
+ * @brief Number of samples requested at acquire time
+ */
+RAC_API size_t rac_audio_frame_size(rac_audio_frame_t frame);
+
+/**
+ * @brief Add a reference (thread-safe)
+ */
+RAC_API void rac_audio_frame_retain(rac_audio_frame_t frame);
+
+/**
+ * @brief Drop a reference; the last one returns the frame to the pool
+ */
+RAC_API void rac_audio_frame_release(rac_audio_frame_t frame);
+
+/**
+ * @brief Read the pool usage counters
+ *
+ * @param out_stats Output: Counters
+ */
+RAC_API void rac_audio_frame_pool_get_stats(rac_audio_frame_pool_stats_t* out_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_AUDIO_FRAME_H */
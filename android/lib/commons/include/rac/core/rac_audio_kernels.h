@@ -0,0 +1,80 @@
+/**
+ * @file rac_audio_kernels.h
+ * @brief RunAnywhere Commons - Vectorised Audio Kernels
+ *
+ * Per-sample loops shared by the audio paths (VAD energy, WAV encoding,
+ * PCM conversion). Each kernel has a scalar reference implementation and
+ * SIMD versions: NEON on arm64, SSE2 on x86, and AVX2 picked at runtime on
+ * x86 CPUs that support it. The implementation is chosen once, on first use.
+ *
+ * For finite input, SIMD results match the scalar reference exactly for
+ * conversion, gain, mixing and peak. Sums of squares and dot products may
+ * differ in the last bits because the order of additions is different.
+ */
+
+#ifndef RAC_AUDIO_KERNELS_H
+#define RAC_AUDIO_KERNELS_H
+
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// AUDIO KERNELS API
+// =============================================================================
+
+/**
+ * @brief Sum of squared samples
+ */
+RAC_API float rac_audio_sum_squares(const float* samples, size_t count);
+
+/**
+ * @brief Dot product of two buffers
+ */
+RAC_API float rac_audio_dot(const float* a, const float* b, size_t count);
+
+/**
+ * @brief Root mean square of the samples (0 for an empty buffer)
+ */
+RAC_API float rac_audio_rms(const float* samples, size_t count);
+
+/**
+ * @brief Largest absolute sample value (0 for an empty buffer)
+ */
+RAC_API float rac_audio_peak(const float* samples, size_t count);
+
+/**
+ * @brief Clamp Float32 samples to [-1, 1] and scale to Int16
+ *
+ * Scales by 32767 and truncates toward zero. output may point at input to
+ * narrow a buffer in place.
+ */
+RAC_API void rac_audio_float_to_int16(const float* input, int16_t* output, size_t count);
+
+/**
+ * @brief Convert Int16 samples to Float32 in [-1, 1) (divides by 32768)
+ */
+RAC_API void rac_audio_int16_to_float(const int16_t* input, float* output, size_t count);
+
+/**
+ * @brief Multiply samples in place by gain
+ */
+RAC_API void rac_audio_apply_gain(float* samples, size_t count, float gain);
+
+/**
+ * @brief Mix src into dst: dst[i] += src[i] * gain
+ */
+RAC_API void rac_audio_mix(float* dst, const float* src, size_t count, float gain);
+
+/**
+ * @brief Name of the implementation in use ("neon", "avx2", "sse2" or "scalar")
+ */
+RAC_API const char* rac_audio_kernels_isa(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_AUDIO_KERNELS_H */
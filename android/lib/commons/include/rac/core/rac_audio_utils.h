@@ -81,6 +81,210 @@ RAC_API rac_result_t rac_audio_int16_to_wav(const void* pcm_data, size_t pcm_siz
  */
 RAC_API size_t rac_audio_wav_header_size(void);
 
+// =============================================================================
+// STREAMING WAV WRITER API
+// =============================================================================
+
+/**
+ * @brief Opaque handle for a streaming WAV writer
+ */
+typedef struct rac_audio_wav_writer* rac_audio_wav_writer_t;
+
+/**
+ * @brief Open a WAV writer on a file descriptor
+ *
+ * Writes a placeholder header at the current offset. Samples are converted to
+ * Int16 in small chunks as they are appended, so memory use does not grow with
+ * the recording length. Finalize seeks back to fill in the header sizes; for
+ * non-seekable descriptors (pipes, sockets) the header keeps the streaming
+ * placeholder sizes (0xFFFFFFFF), which most players accept.
+ *
+ * The descriptor is not closed by the writer.
+ *
+ * @param fd Open, writable file descriptor
+ * @param sample_rate Sample rate in Hz
+ * @param out_writer Output: Writer handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_audio_wav_writer_open_fd(int fd, int32_t sample_rate,
+                                                  rac_audio_wav_writer_t* out_writer);
+
+/**
+ * @brief Open a WAV writer on a caller-owned buffer
+ *
+ * Samples are converted straight into the buffer after the 44-byte header;
+ * nothing is allocated per chunk.
+ *
+ * @param buffer Destination buffer (must outlive the writer)
+ * @param capacity Size of buffer in bytes (at least rac_audio_wav_header_size())
+ * @param sample_rate Sample rate in Hz
+ * @param out_writer Output: Writer handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_audio_wav_writer_open_buffer(void* buffer, size_t capacity,
+                                                      int32_t sample_rate,
+                                                      rac_audio_wav_writer_t* out_writer);
+
+/**
+ * @brief Append Float32 samples (clamped to [-1, 1] and converted to Int16)
+ *
+ * @param writer Writer handle
+ * @param samples Float32 samples
+ * @param num_samples Number of samples
+ * @return RAC_SUCCESS, RAC_ERROR_BUFFER_TOO_SMALL (buffer target full, nothing
+ *         written), or error code
+ */
+RAC_API rac_result_t rac_audio_wav_writer_append_float32(rac_audio_wav_writer_t writer,
+                                                         const float* samples,
+                                                         size_t num_samples);
+
+/**
+ * @brief Append Int16 samples
+ *
+ * @param writer Writer handle
+ * @param samples Int16 samples
+ * @param num_samples Number of samples
+ * @return RAC_SUCCESS, RAC_ERROR_BUFFER_TOO_SMALL (buffer target full, nothing
+ *         written), or error code
+ */
+RAC_API rac_result_t rac_audio_wav_writer_append_int16(rac_audio_wav_writer_t writer,
+                                                       const int16_t* samples,
+                                                       size_t num_samples);
+
+/**
+ * @brief Write the final header sizes
+ *
+ * No more samples can be appended afterwards.
+ *
+ * @param writer Writer handle
+ * @param out_wav_size Output: Total WAV size in bytes, header included (optional)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_audio_wav_writer_finalize(rac_audio_wav_writer_t writer,
+                                                   size_t* out_wav_size);
+
+/**
+ * @brief Destroy a WAV writer (does not finalize)
+ *
+ * @param writer Writer handle
+ */
+RAC_API void rac_audio_wav_writer_destroy(rac_audio_wav_writer_t writer);
+
+// =============================================================================
+// IMA-ADPCM CODEC API
+// =============================================================================
+
+/**
+ * @brief IMA-ADPCM codec state
+ *
+ * Zero-initialize to start a stream. Encoder and decoder each keep their own
+ * state; carrying it across calls makes the codec streaming.
+ */
+typedef struct rac_audio_adpcm_state {
+    int32_t predictor;
+    int32_t step_index;
+} rac_audio_adpcm_state_t;
+
+/**
+ * @brief Bytes needed to encode num_samples samples (4 bits per sample)
+ */
+RAC_API size_t rac_audio_adpcm_encoded_size(size_t num_samples);
+
+/**
+ * @brief Encode Float32 mono samples to IMA-ADPCM
+ *
+ * Two samples per byte, the first in the low nibble (the WAV IMA-ADPCM
+ * order). Compresses 16-bit PCM 4:1 and Float32 8:1 at speech quality.
+ * When streaming, pass an even number of samples in every call but the
+ * last; an odd count pads the final byte's high nibble.
+ *
+ * @param state Encoder state
+ * @param samples Float32 samples in [-1, 1]
+ * @param num_samples Number of samples
+ * @param out_data Output buffer of rac_audio_adpcm_encoded_size(num_samples) bytes
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_audio_adpcm_encode(rac_audio_adpcm_state_t* state, const float* samples,
+                                            size_t num_samples, uint8_t* out_data);
+
+/**
+ * @brief Decode IMA-ADPCM to Float32 mono samples
+ *
+ * @param state Decoder state
+ * @param data Encoded data (rac_audio_adpcm_encoded_size(num_samples) bytes)
+ * @param num_samples Number of samples to decode
+ * @param out_samples Output buffer of num_samples samples
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_audio_adpcm_decode(rac_audio_adpcm_state_t* state, const uint8_t* data,
+                                            size_t num_samples, float* out_samples);
+
+// =============================================================================
+// RESAMPLING API
+// =============================================================================
+
+/**
+ * @brief Opaque handle for a streaming resampler
+ */
+typedef struct rac_audio_resampler* rac_audio_resampler_t;
+
+/**
+ * @brief Create a streaming polyphase resampler
+ *
+ * Converts between any two integer rates with a Kaiser-windowed sinc filter
+ * 72 samples of the lower rate long. Downsampling 44.1/48 kHz to 16 kHz keeps
+ * the band up to 7.2 kHz within 0.3 dB and attenuates content that would alias
+ * by at least 66 dB from 8 kHz and 78 dB from 8.5 kHz; the 7-8 kHz transition
+ * band is not protected. Filter state carries across calls, so audio can be fed
+ * in frames of any size; the output lags the input by about 2.3 ms.
+ *
+ * @param input_rate Input sample rate in Hz
+ * @param output_rate Output sample rate in Hz
+ * @param out_resampler Output: Resampler handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_audio_resampler_create(int32_t input_rate, int32_t output_rate,
+                                                rac_audio_resampler_t* out_resampler);
+
+/**
+ * @brief Upper bound on the samples produced for num_input input samples
+ *
+ * @param resampler Resampler handle
+ * @param num_input Number of input samples
+ * @return Maximum number of output samples
+ */
+RAC_API size_t rac_audio_resampler_max_output(rac_audio_resampler_t resampler, size_t num_input);
+
+/**
+ * @brief Resample a chunk of Float32 mono samples
+ *
+ * @param resampler Resampler handle
+ * @param input Input samples
+ * @param num_input Number of input samples
+ * @param output Output buffer
+ * @param output_capacity Samples output can hold (see rac_audio_resampler_max_output)
+ * @param out_written Output: Samples written
+ * @return RAC_SUCCESS or RAC_ERROR_BUFFER_TOO_SMALL
+ */
+RAC_API rac_result_t rac_audio_resampler_process(rac_audio_resampler_t resampler,
+                                                 const float* input, size_t num_input,
+                                                 float* output, size_t output_capacity,
+                                                 size_t* out_written);
+
+/**
+ * @brief Clear the filter state (e.g. between utterances)
+ *
+ * @param resampler Resampler handle
+ */
+RAC_API void rac_audio_resampler_reset(rac_audio_resampler_t resampler);
+
+/**
+ * @brief Destroy a resampler
+ *
+ * @param resampler Resampler handle
+ */
+RAC_API void rac_audio_resampler_destroy(rac_audio_resampler_t resampler);
+
 #ifdef __cplusplus
 }
 #endif
@@ -56,6 +56,10 @@ typedef struct rac_config {
  * This must be called before any other RAC functions. The platform adapter
  * is required and provides callbacks for platform-specific operations.
  *
+ * Only records the configuration and registers the built-in subsystems with
+ * the init graph (rac_init_graph.h); they initialize on first use or after
+ * rac_init_graph_start_background.
+ *
  * @param config Configuration options (platform_adapter is required)
  * @return RAC_SUCCESS on success, or an error code on failure
  *
@@ -273,6 +277,18 @@ RAC_API rac_result_t rac_service_unregister_provider(const char* name, rac_capab
  * Mirrors Swift's createSTT/LLM/TTS/VAD methods.
  * Finds first provider that canHandle the request (sorted by priority).
  *
+ * The registry lock is not held while providers' can_handle and create run,
+ * so services can be created in parallel from several threads (e.g. loading
+ * the STT, LLM and TTS models at once). Providers must therefore tolerate
+ * concurrent calls, and stay callable until in-flight creates return even
+ * if they are unregistered meanwhile.
+ *
+ * The chosen provider is remembered per capability, identifier, framework
+ * and model path, so repeated requests for the same model call create
+ * directly without probing can_handle again. Registering or unregistering a
+ * provider clears this cache; a cached provider whose create fails is
+ * probed for again.
+ *
  * @param capability The capability needed
  * @param request The service request (can have identifier and config)
  * @param out_handle Pointer to receive the service handle
@@ -324,6 +340,106 @@ RAC_API rac_result_t rac_register_model(const struct rac_model_info* model);
  */
 RAC_API rac_result_t rac_get_model(const char* model_id, struct rac_model_info** out_model);
 
+// =============================================================================
+// MEMORY PRESSURE API
+// =============================================================================
+
+/**
+ * System memory pressure level.
+ * Values match rac_llm_memory_pressure_t. Android's onTrimMemory levels map
+ * as RUNNING_MODERATE -> MODERATE, RUNNING_LOW / UI_HIDDEN -> LOW,
+ * RUNNING_CRITICAL / BACKGROUND and above -> CRITICAL; an iOS memory warning
+ * is CRITICAL.
+ */
+typedef enum rac_memory_pressure_level {
+    RAC_MEMORY_PRESSURE_NONE = 0,
+    RAC_MEMORY_PRESSURE_MODERATE = 1, /**< Runs DROP_CACHES */
+    RAC_MEMORY_PRESSURE_LOW = 2,      /**< Also SHRINK_CONTEXT and RELEASE_BUFFERS */
+    RAC_MEMORY_PRESSURE_CRITICAL = 3  /**< Also UNLOAD_IDLE */
+} rac_memory_pressure_level_t;
+
+/**
+ * Degradation stages, cheapest to recover first.
+ */
+typedef enum rac_memory_pressure_stage {
+    /** Drop caches that are rebuilt on demand (prefix KV, phrase audio, parked models) */
+    RAC_MEMORY_PRESSURE_STAGE_DROP_CACHES = 0,
+    /** Shrink KV caches and contexts */
+    RAC_MEMORY_PRESSURE_STAGE_SHRINK_CONTEXT = 1,
+    /** Release compute and scratch buffers */
+    RAC_MEMORY_PRESSURE_STAGE_RELEASE_BUFFERS = 2,
+    /** Unload models that are not in use */
+    RAC_MEMORY_PRESSURE_STAGE_UNLOAD_IDLE = 3
+} rac_memory_pressure_stage_t;
+
+/** Number of degradation stages */
+#define RAC_MEMORY_PRESSURE_STAGE_COUNT 4
+
+/**
+ * Memory pressure handler.
+ * Called once per stage the level includes, on the notifying thread.
+ *
+ * @param stage Stage to carry out
+ * @param user_data Handler context
+ * @return Bytes freed (estimated; 0 if nothing was freed)
+ */
+typedef int64_t (*rac_memory_pressure_handler_fn)(rac_memory_pressure_stage_t stage,
+                                                  void* user_data);
+
+/**
+ * Result of a memory pressure notification.
+ */
+typedef struct rac_memory_pressure_report {
+    /** Bytes freed by each stage */
+    int64_t stage_bytes[RAC_MEMORY_PRESSURE_STAGE_COUNT];
+
+    /** Sum of stage_bytes */
+    int64_t total_bytes;
+
+    /** Handlers called */
+    int32_t handler_count;
+} rac_memory_pressure_report_t;
+
+/**
+ * Registers a memory pressure handler.
+ * Components register on create and unregister on destroy.
+ *
+ * @param name Handler name for logging
+ * @param handler Handler function
+ * @param user_data Passed to the handler; with handler, identifies the registration
+ * @return RAC_SUCCESS (registering the same pair again does nothing)
+ */
+RAC_API rac_result_t rac_memory_pressure_register(const char* name,
+                                                  rac_memory_pressure_handler_fn handler,
+                                                  void* user_data);
+
+/**
+ * Unregisters a memory pressure handler.
+ * Waits for a notification in progress, so it must not be called from a
+ * handler.
+ *
+ * @param handler Handler function
+ * @param user_data User data it was registered with
+ * @return RAC_SUCCESS or RAC_ERROR_NOT_FOUND
+ */
+RAC_API rac_result_t rac_memory_pressure_unregister(rac_memory_pressure_handler_fn handler,
+                                                    void* user_data);
+
+/**
+ * Reports system memory pressure to every registered handler.
+ *
+ * Runs the stages the level includes in order, each across all handlers
+ * before the next, so cheap caches go before any context shrinks or model
+ * unloads. Notifications are serialized. Call from the platform's
+ * onTrimMemory or memory warning handler.
+ *
+ * @param level Pressure level
+ * @param out_report Output: Bytes freed per stage (can be NULL)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_memory_pressure_notify(rac_memory_pressure_level_t level,
+                                                rac_memory_pressure_report_t* out_report);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,219 @@
+/**
+ * @file rac_cpu_budget.h
+ * @brief RunAnywhere Commons - Shared CPU Budget
+ *
+ * STT, LLM and TTS backends each size their own thread pools for the whole
+ * machine, so an overlapped voice pipeline oversubscribes the cores. The CPU
+ * budget hands out thread counts and core sets to the stages that are running,
+ * by priority: TTS (audio deadline) first, then LLM decode, then STT. Every
+ * active stage gets at least one thread; the higher priority stages get
+ * their wanted count before the lower ones get more.
+ *
+ * Backends acquire their stage around each run and read the grant. The grant
+ * changes as stages start and stop; long-running stages (LLM decode) poll
+ * rac_cpu_budget_threads between steps to follow it.
+ *
+ * Audio threads stay outside the budget. They do little work but have a
+ * deadline every frame, so the budget can raise their scheduling priority
+ * and move them to the fastest core instead (rac_cpu_budget_promote_audio_thread).
+ */
+
+#ifndef RAC_CPU_BUDGET_H
+#define RAC_CPU_BUDGET_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Budgeted stages, highest priority first
+ */
+typedef enum rac_cpu_stage {
+    RAC_CPU_STAGE_TTS = 0, /**< Speech synthesis (audio deadline) */
+    RAC_CPU_STAGE_LLM = 1, /**< Text generation */
+    RAC_CPU_STAGE_STT = 2  /**< Transcription */
+} rac_cpu_stage_t;
+
+/** Number of budgeted stages */
+#define RAC_CPU_STAGE_COUNT 3
+
+/**
+ * @brief CPU budget configuration
+ */
+typedef struct rac_cpu_budget_config {
+    /** Cores to share out (0 = online cores) */
+    int32_t total_cores;
+
+    /** Cores left to the app and UI threads */
+    int32_t reserved_cores;
+
+    /** Bind the budgeted threads to their cores (Linux/Android only) */
+    rac_bool_t pin_threads;
+} rac_cpu_budget_config_t;
+
+/**
+ * @brief Default configuration (all online cores, one left to the app, no pinning)
+ */
+static const rac_cpu_budget_config_t RAC_CPU_BUDGET_CONFIG_DEFAULT = {
+    .total_cores = 0, .reserved_cores = 1, .pin_threads = RAC_FALSE};
+
+/**
+ * @brief Scheduling level of an audio thread, lowest first
+ */
+typedef enum rac_audio_thread_priority {
+    RAC_AUDIO_THREAD_PRIORITY_NORMAL = 0,       /**< Left as created */
+    RAC_AUDIO_THREAD_PRIORITY_URGENT_AUDIO = 1, /**< Nice -19 (ANDROID_PRIORITY_URGENT_AUDIO) */
+    RAC_AUDIO_THREAD_PRIORITY_REALTIME = 2      /**< SCHED_FIFO */
+} rac_audio_thread_priority_t;
+
+/**
+ * @brief Audio thread scheduling configuration
+ */
+typedef struct rac_audio_thread_config {
+    /**
+     * Level to ask for. REALTIME falls back to URGENT_AUDIO and URGENT_AUDIO
+     * to NORMAL when the process is not allowed to set it.
+     */
+    rac_audio_thread_priority_t priority;
+
+    /** SCHED_FIFO priority for REALTIME (1-99; low values stay below the system audio HAL) */
+    int32_t fifo_priority;
+
+    /** Bind the thread to the fastest core (Linux/Android only) */
+    rac_bool_t pin_to_fast_core;
+} rac_audio_thread_config_t;
+
+/**
+ * @brief Default audio thread configuration (real-time if allowed, fastest core)
+ */
+static const rac_audio_thread_config_t RAC_AUDIO_THREAD_CONFIG_DEFAULT = {
+    .priority = RAC_AUDIO_THREAD_PRIORITY_REALTIME,
+    .fifo_priority = 2,
+    .pin_to_fast_core = RAC_TRUE};
+
+// =============================================================================
+// CPU BUDGET API
+// =============================================================================
+
+/**
+ * @brief Replace the budget configuration
+ *
+ * Active grants are recomputed right away.
+ *
+ * @param config Configuration (NULL for defaults)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_cpu_budget_configure(const rac_cpu_budget_config_t* config);
+
+/**
+ * @brief Mark a stage as running and get its thread count
+ *
+ * Calls nest: a stage stays active until every acquire has been released.
+ *
+ * @param stage Stage starting work
+ * @param wanted Threads the backend would use on its own (<= 0 for no limit)
+ * @return Threads granted to the stage, at least 1
+ */
+RAC_API int32_t rac_cpu_budget_acquire(rac_cpu_stage_t stage, int32_t wanted);
+
+/**
+ * @brief Mark one acquire of a stage as finished
+ *
+ * @param stage Stage that finished
+ */
+RAC_API void rac_cpu_budget_release(rac_cpu_stage_t stage);
+
+/**
+ * @brief Limit the budget to a share of its cores
+ *
+ * Set by the thermal governor (rac_thermal_governor.h) to cool the device
+ * down; every stage keeps at least one thread. Active grants are recomputed
+ * right away.
+ *
+ * @param percent Share of the cores to hand out, 1-100
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_cpu_budget_set_core_percent(int32_t percent);
+
+/**
+ * @brief Current thread grant of a stage
+ *
+ * Lock-free; cheap enough to call per decode step.
+ *
+ * @param stage Stage
+ * @return Threads granted, 0 if the stage is not active
+ */
+RAC_API int32_t rac_cpu_budget_threads(rac_cpu_stage_t stage);
+
+/**
+ * @brief Bind the calling thread to the cores of a stage
+ *
+ * Threads a library starts afterwards inherit the binding. Does nothing
+ * unless pin_threads is configured.
+ *
+ * @param stage Stage the calling thread works for
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_SUPPORTED where affinity cannot be set
+ */
+RAC_API rac_result_t rac_cpu_budget_bind_current_thread(rac_cpu_stage_t stage);
+
+/**
+ * @brief Raise the calling thread to audio scheduling
+ *
+ * For threads that consume audio on a frame deadline, such as the VAD
+ * pipeline worker. The thread keeps the level until it exits.
+ *
+ * @param config Configuration (NULL for defaults)
+ * @param out_applied Output: Level actually set (can be NULL)
+ * @return RAC_SUCCESS if the requested level was set, RAC_ERROR_PERMISSION_DENIED
+ *         if a lower one was, RAC_ERROR_NOT_SUPPORTED where priorities cannot be set
+ */
+RAC_API rac_result_t rac_cpu_budget_promote_audio_thread(const rac_audio_thread_config_t* config,
+                                                         rac_audio_thread_priority_t* out_applied);
+
+#ifdef __cplusplus
+}
+#endif
+
+// =============================================================================
+// C++ CONVENIENCE CLASS
+// =============================================================================
+
+#ifdef __cplusplus
+
+namespace rac {
+
+/**
+ * @brief Holds a stage of the CPU budget for the lifetime of the object.
+ *
+ * Usage:
+ *   rac::ScopedCpuBudget budget(RAC_CPU_STAGE_STT, num_threads_);
+ *   params.n_threads = budget.threads();
+ */
+class ScopedCpuBudget {
+   public:
+    ScopedCpuBudget(rac_cpu_stage_t stage, int32_t wanted)
+        : stage_(stage), threads_(rac_cpu_budget_acquire(stage, wanted)) {}
+    ~ScopedCpuBudget() { rac_cpu_budget_release(stage_); }
+
+    ScopedCpuBudget(const ScopedCpuBudget&) = delete;
+    ScopedCpuBudget& operator=(const ScopedCpuBudget&) = delete;
+
+    int32_t threads() const { return threads_; }
+
+   private:
+    rac_cpu_stage_t stage_;
+    int32_t threads_;
+};
+
+}  // namespace rac
+
+#endif  // __cplusplus
+
+#endif /* RAC_CPU_BUDGET_H */
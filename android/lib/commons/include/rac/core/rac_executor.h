@@ -0,0 +1,125 @@
+/**
+ * @file rac_executor.h
+ * @brief RunAnywhere Commons - Native Request Executor
+ *
+ * A process-wide pool of native worker threads that runs submitted requests
+ * by priority, oldest first within a priority. Bindings submit inference
+ * here and return a request ID right away instead of blocking the calling
+ * platform thread; workers are long-lived, so platform bridges can attach
+ * them to their runtime once and keep delivering results from them.
+ *
+ * A request passes through three optional hooks: run does the work, cancel
+ * asks a running request to stop, and release is called exactly once at the
+ * end, after run returns or instead of run if the request is cancelled while
+ * still queued.
+ */
+
+#ifndef RAC_EXECUTOR_H
+#define RAC_EXECUTOR_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Request identifier (never 0)
+ */
+typedef uint64_t rac_request_id_t;
+
+/**
+ * @brief Request priority, lowest first
+ */
+typedef enum rac_request_priority {
+    RAC_REQUEST_PRIORITY_LOW = 0,    /**< Background work (prefetch, warmup) */
+    RAC_REQUEST_PRIORITY_NORMAL = 1, /**< Default */
+    RAC_REQUEST_PRIORITY_HIGH = 2,   /**< Interactive work a user is waiting on */
+} rac_request_priority_t;
+
+/**
+ * @brief Request hooks; run is required, the others are optional
+ */
+typedef struct rac_request {
+    rac_request_priority_t priority;
+
+    /** Does the work on a worker thread */
+    void (*run)(rac_request_id_t id, void* user_data);
+
+    /**
+     * Asks a running request to stop. Called on the cancelling thread, with
+     * the executor lock held, so it must not block or call the executor.
+     */
+    void (*cancel)(rac_request_id_t id, void* user_data);
+
+    /**
+     * Called once at the end: after run returns (ran = RAC_TRUE, on the
+     * worker) or instead of run when cancelled while queued (ran = RAC_FALSE,
+     * on the cancelling thread). No other hook is called afterwards.
+     */
+    void (*release)(rac_request_id_t id, rac_bool_t ran, void* user_data);
+
+    void* user_data;
+} rac_request_t;
+
+/** Default number of worker threads */
+#define RAC_EXECUTOR_DEFAULT_WORKERS 2
+
+// =============================================================================
+// EXECUTOR API
+// =============================================================================
+
+/**
+ * @brief Queue a request
+ *
+ * @param request Request hooks (copied)
+ * @param out_id Output: Request ID
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_executor_submit(const rac_request_t* request, rac_request_id_t* out_id);
+
+/**
+ * @brief Cancel a request
+ *
+ * A queued request is removed and released without running. A running
+ * request is flagged (see rac_executor_is_cancelled) and its cancel hook is
+ * called.
+ *
+ * @param id Request ID
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_FOUND if it already finished
+ */
+RAC_API rac_result_t rac_executor_cancel(rac_request_id_t id);
+
+/**
+ * @brief Whether a running request has been cancelled
+ *
+ * @param id Request ID
+ * @return RAC_TRUE if cancelled
+ */
+RAC_API rac_bool_t rac_executor_is_cancelled(rac_request_id_t id);
+
+/**
+ * @brief Set the number of worker threads
+ *
+ * The pool only grows; shrinking takes effect as surplus workers go idle.
+ *
+ * @param count Worker count (at least 1)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_executor_set_workers(int32_t count);
+
+/**
+ * @brief Number of requests waiting to run
+ */
+RAC_API int32_t rac_executor_queued_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_EXECUTOR_H */
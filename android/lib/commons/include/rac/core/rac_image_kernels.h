@@ -0,0 +1,87 @@
+/**
+ * @file rac_image_kernels.h
+ * @brief RunAnywhere Commons - Vectorised Image Kernels
+ *
+ * Converts an app's pixel buffer (RGBA from Android bitmaps and Flutter,
+ * BGRA from iOS pixel buffers, or RGB) to the packed RGB8 that vision
+ * encoders take, resizing it on the way. Downscaling box-averages whole
+ * blocks of source pixels, then interpolates bilinearly to the exact size,
+ * so a camera-sized photo shrinks in one pass without aliasing.
+ *
+ * The per-pixel loops have a scalar reference and SIMD versions: NEON on
+ * arm64, SSE2 on x86, and SSSE3 shuffles picked at runtime on x86 CPUs that
+ * support them. Results match the scalar reference exactly.
+ */
+
+#ifndef RAC_IMAGE_KERNELS_H
+#define RAC_IMAGE_KERNELS_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Pixel layout of an image buffer
+ */
+typedef enum rac_image_format {
+    /** R, G, B: 3 bytes per pixel */
+    RAC_IMAGE_FORMAT_RGB8 = 0,
+    /** R, G, B, A: Android ARGB_8888 bitmaps, Flutter rawRgba */
+    RAC_IMAGE_FORMAT_RGBA8 = 1,
+    /** B, G, R, A: iOS kCVPixelFormatType_32BGRA */
+    RAC_IMAGE_FORMAT_BGRA8 = 2,
+} rac_image_format_t;
+
+/**
+ * @brief Pixel buffer (alpha is ignored)
+ */
+typedef struct rac_image {
+    const uint8_t* data;
+    int32_t width;
+    int32_t height;
+    /** Bytes per row (0 = tightly packed) */
+    int32_t stride;
+    rac_image_format_t format;
+} rac_image_t;
+
+// =============================================================================
+// IMAGE KERNELS API
+// =============================================================================
+
+/**
+ * @brief Size that fits within max_edge on its longer side, keeping the aspect
+ *
+ * Images already within max_edge, and max_edge <= 0, keep their size.
+ */
+RAC_API void rac_image_fit_size(int32_t width, int32_t height, int32_t max_edge,
+                                int32_t* out_width, int32_t* out_height);
+
+/**
+ * @brief Convert an image to packed RGB8, resized to out_width x out_height
+ *
+ * @param image Source image
+ * @param out_width Output width in pixels
+ * @param out_height Output height in pixels
+ * @param out_rgb Output: out_width * out_height * 3 bytes
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_image_to_rgb(const rac_image_t* image, int32_t out_width,
+                                      int32_t out_height, uint8_t* out_rgb);
+
+/**
+ * @brief Name of the implementation in use ("neon", "ssse3", "sse2" or "scalar")
+ */
+RAC_API const char* rac_image_kernels_isa(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_IMAGE_KERNELS_H */
@@ -0,0 +1,141 @@
+/**
+ * @file rac_init_graph.h
+ * @brief RunAnywhere Commons - Lazy, Dependency-Ordered Initialization
+ *
+ * rac_init only records configuration; everything else an SDK sets up
+ * (registries, device registration, telemetry, model assignments) is a
+ * subsystem here. A subsystem initializes the first time something requires
+ * it, after the subsystems it depends on, or on a background worker once the
+ * platform calls rac_init_graph_start_background (e.g. after the first
+ * frame). Nothing in the graph runs on the thread that called rac_init.
+ *
+ * Each initialization is timed and reported as RAC_EVENT_SDK_INIT_COMPLETED
+ * (or RAC_EVENT_SDK_INIT_FAILED) with the subsystem's name, and once every
+ * background subsystem is up a final RAC_EVENT_SDK_INIT_COMPLETED without a
+ * name reports the total.
+ */
+
+#ifndef RAC_INIT_GRAPH_H
+#define RAC_INIT_GRAPH_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/** Subsystems registered by the commons library itself */
+#define RAC_SUBSYSTEM_MODEL_REGISTRY "model_registry"
+
+/**
+ * @brief When a subsystem initializes, besides on first use
+ */
+typedef enum rac_subsystem_start {
+    RAC_SUBSYSTEM_START_ON_FIRST_USE = 0, /**< Only when required */
+    RAC_SUBSYSTEM_START_BACKGROUND = 1,   /**< Also by rac_init_graph_start_background */
+} rac_subsystem_start_t;
+
+/**
+ * @brief Initializes one subsystem
+ *
+ * Runs once, on whichever thread requires the subsystem first.
+ *
+ * @param user_data Subsystem context
+ * @return RAC_SUCCESS or error code; a failure is final
+ */
+typedef rac_result_t (*rac_subsystem_init_fn)(void* user_data);
+
+/**
+ * @brief Subsystem description
+ */
+typedef struct rac_subsystem_desc {
+    /** Unique name */
+    const char* name;
+
+    /** Names of subsystems initialized first; each must be registered already */
+    const char* const* dependencies;
+    size_t dependency_count;
+
+    rac_subsystem_init_fn init;
+    void* user_data;
+
+    rac_subsystem_start_t start;
+} rac_subsystem_desc_t;
+
+/**
+ * @brief Initialization state of one subsystem
+ */
+typedef struct rac_subsystem_status {
+    /** Whether initialization has finished, successfully or not */
+    rac_bool_t initialized;
+
+    /** Result of the init function (RAC_SUCCESS until it has run) */
+    rac_result_t result;
+
+    /** Time spent in the init function itself, in milliseconds */
+    double init_ms;
+} rac_subsystem_status_t;
+
+// =============================================================================
+// INIT GRAPH API
+// =============================================================================
+
+/**
+ * @brief Add a subsystem
+ *
+ * Requiring dependencies to be registered first keeps the graph acyclic.
+ *
+ * @param desc Description (strings are copied)
+ * @return RAC_SUCCESS, RAC_ERROR_ALREADY_INITIALIZED if the name is taken, or
+ * RAC_ERROR_NOT_FOUND if a dependency is unknown
+ */
+RAC_API rac_result_t rac_init_graph_register(const rac_subsystem_desc_t* desc);
+
+/**
+ * @brief Initialize a subsystem and its dependencies, if not done yet
+ *
+ * Blocks until they are initialized; concurrent callers share one run.
+ *
+ * @param name Subsystem name
+ * @return The subsystem's init result (or its first failed dependency's),
+ * RAC_ERROR_NOT_FOUND if unknown, or RAC_ERROR_INVALID_STATE when called
+ * from the subsystem's own init function
+ */
+RAC_API rac_result_t rac_init_graph_require(const char* name);
+
+/**
+ * @brief Initialize background subsystems on the request executor
+ *
+ * Runs at low priority in registration order, which is dependency order.
+ * Returns at once; calling it again only picks up subsystems registered
+ * since.
+ *
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_init_graph_start_background(void);
+
+/**
+ * @brief Whether a subsystem has initialized successfully
+ */
+RAC_API rac_bool_t rac_init_graph_is_ready(const char* name);
+
+/**
+ * @brief Initialization state of a subsystem
+ *
+ * @param name Subsystem name
+ * @param out_status Output: Status
+ * @return RAC_SUCCESS or RAC_ERROR_NOT_FOUND
+ */
+RAC_API rac_result_t rac_init_graph_get_status(const char* name,
+                                               rac_subsystem_status_t* out_status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_INIT_GRAPH_H */
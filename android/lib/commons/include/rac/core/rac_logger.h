@@ -8,6 +8,11 @@
  * - Supports log levels, categories, and structured metadata
  * - Enables remote telemetry for production error tracking
  *
+ * Lines are queued in a fixed ring buffer and written out by a background
+ * thread, so a log call never waits on the platform adapter. Disabled levels
+ * are filtered before the message is formatted, and levels below
+ * RAC_MIN_LOG_LEVEL are removed from the build entirely.
+ *
  * Usage:
  *   RAC_LOG_INFO("LLM", "Model loaded successfully");
  *   RAC_LOG_ERROR("STT", "Failed to load model: %s", error_msg);
@@ -97,6 +102,25 @@ RAC_API rac_result_t rac_logger_init(rac_log_level_t min_level);
  */
 RAC_API void rac_logger_shutdown(void);
 
+/**
+ * @brief Wait until the lines logged so far have been written out.
+ *
+ * Waits at most one second. ERROR and FATAL lines flush on their own.
+ */
+RAC_API void rac_logger_flush(void);
+
+/**
+ * @brief Enable or disable the background writer.
+ *
+ * When enabled (default: true), lines are queued and written by a background
+ * thread; lines below ERROR are dropped (and counted) if the queue is full,
+ * and queued lines longer than 1 KB are truncated. When disabled, every call
+ * writes its line before returning.
+ *
+ * @param enabled Whether to write lines from the background thread
+ */
+RAC_API void rac_logger_set_async(rac_bool_t enabled);
+
 /**
  * @brief Set the minimum log level.
  *
@@ -113,6 +137,16 @@ RAC_API void rac_logger_set_min_level(rac_log_level_t level);
  */
 RAC_API rac_log_level_t rac_logger_get_min_level(void);
 
+/**
+ * @brief Whether a message at this level would be logged.
+ *
+ * Lock-free; the macros call it before building the message.
+ *
+ * @param level Log level
+ * @return RAC_TRUE if level is at or above the minimum level
+ */
+RAC_API rac_bool_t rac_logger_enabled(rac_log_level_t level);
+
 /**
  * @brief Enable or disable fallback to stderr when platform adapter unavailable.
  *
@@ -199,65 +233,60 @@ RAC_API void rac_logger_logv(rac_log_level_t level, const char* category,
         __FILE__, __LINE__, __func__, 0, NULL, (mid), (fw), NULL, NULL, NULL, NULL \
     }
 
-// --- Level-specific logging macros with automatic source location ---
+/**
+ * Lowest level compiled into the RAC_LOG_* macros (0 = TRACE ... 5 = FATAL).
+ * Calls below it, including their argument expressions, are removed from the
+ * binary. The build sets it (RAC_MIN_LOG_LEVEL option); release builds
+ * default to INFO, so TRACE and DEBUG logging costs nothing there.
+ */
+#ifndef RAC_MIN_LOG_LEVEL
+#define RAC_MIN_LOG_LEVEL 0
+#endif
 
-#define RAC_LOG_TRACE(category, ...)                                   \
-    do {                                                               \
-        rac_log_metadata_t _meta = RAC_LOG_META_HERE();                \
-        rac_logger_logf(RAC_LOG_TRACE, category, &_meta, __VA_ARGS__); \
+/**
+ * Logs with the given metadata if the level is compiled in and enabled.
+ * Arguments are not evaluated otherwise.
+ */
+#define RAC_LOG_AT(level, category, meta, ...)                                     \
+    do {                                                                           \
+        if ((int)(level) >= RAC_MIN_LOG_LEVEL && rac_logger_enabled(level) != 0) { \
+            rac_log_metadata_t _meta = meta;                                       \
+            rac_logger_logf(level, category, &_meta, __VA_ARGS__);                 \
+        }                                                                          \
     } while (0)
 
-#define RAC_LOG_DEBUG(category, ...)                                   \
-    do {                                                               \
-        rac_log_metadata_t _meta = RAC_LOG_META_HERE();                \
-        rac_logger_logf(RAC_LOG_DEBUG, category, &_meta, __VA_ARGS__); \
-    } while (0)
+// --- Level-specific logging macros with automatic source location ---
 
-#define RAC_LOG_INFO(category, ...)                                   \
-    do {                                                              \
-        rac_log_metadata_t _meta = RAC_LOG_META_HERE();               \
-        rac_logger_logf(RAC_LOG_INFO, category, &_meta, __VA_ARGS__); \
-    } while (0)
+#define RAC_LOG_TRACE(category, ...) \
+    RAC_LOG_AT(RAC_LOG_TRACE, category, RAC_LOG_META_HERE(), __VA_ARGS__)
 
-#define RAC_LOG_WARNING(category, ...)                                   \
-    do {                                                                 \
-        rac_log_metadata_t _meta = RAC_LOG_META_HERE();                  \
-        rac_logger_logf(RAC_LOG_WARNING, category, &_meta, __VA_ARGS__); \
-    } while (0)
+#define RAC_LOG_DEBUG(category, ...) \
+    RAC_LOG_AT(RAC_LOG_DEBUG, category, RAC_LOG_META_HERE(), __VA_ARGS__)
 
-#define RAC_LOG_ERROR(category, ...)                                   \
-    do {                                                               \
-        rac_log_metadata_t _meta = RAC_LOG_META_HERE();                \
-        rac_logger_logf(RAC_LOG_ERROR, category, &_meta, __VA_ARGS__); \
-    } while (0)
+#define RAC_LOG_INFO(category, ...) \
+    RAC_LOG_AT(RAC_LOG_INFO, category, RAC_LOG_META_HERE(), __VA_ARGS__)
 
-#define RAC_LOG_FATAL(category, ...)                                   \
-    do {                                                               \
-        rac_log_metadata_t _meta = RAC_LOG_META_HERE();                \
-        rac_logger_logf(RAC_LOG_FATAL, category, &_meta, __VA_ARGS__); \
-    } while (0)
+#define RAC_LOG_WARNING(category, ...) \
+    RAC_LOG_AT(RAC_LOG_WARNING, category, RAC_LOG_META_HERE(), __VA_ARGS__)
+
+#define RAC_LOG_ERROR(category, ...) \
+    RAC_LOG_AT(RAC_LOG_ERROR, category, RAC_LOG_META_HERE(), __VA_ARGS__)
+
+#define RAC_LOG_FATAL(category, ...) \
+    RAC_LOG_AT(RAC_LOG_FATAL, category, RAC_LOG_META_HERE(), __VA_ARGS__)
 
 // --- Error logging with code ---
 
-#define RAC_LOG_ERROR_CODE(category, code, ...)                        \
-    do {                                                               \
-        rac_log_metadata_t _meta = RAC_LOG_META_ERROR(code, NULL);     \
-        rac_logger_logf(RAC_LOG_ERROR, category, &_meta, __VA_ARGS__); \
-    } while (0)
+#define RAC_LOG_ERROR_CODE(category, code, ...) \
+    RAC_LOG_AT(RAC_LOG_ERROR, category, RAC_LOG_META_ERROR(code, NULL), __VA_ARGS__)
 
 // --- Model context logging ---
 
-#define RAC_LOG_MODEL_INFO(category, model_id, framework, ...)              \
-    do {                                                                    \
-        rac_log_metadata_t _meta = RAC_LOG_META_MODEL(model_id, framework); \
-        rac_logger_logf(RAC_LOG_INFO, category, &_meta, __VA_ARGS__);       \
-    } while (0)
+#define RAC_LOG_MODEL_INFO(category, model_id, framework, ...) \
+    RAC_LOG_AT(RAC_LOG_INFO, category, RAC_LOG_META_MODEL(model_id, framework), __VA_ARGS__)
 
-#define RAC_LOG_MODEL_ERROR(category, model_id, framework, ...)             \
-    do {                                                                    \
-        rac_log_metadata_t _meta = RAC_LOG_META_MODEL(model_id, framework); \
-        rac_logger_logf(RAC_LOG_ERROR, category, &_meta, __VA_ARGS__);      \
-    } while (0)
+#define RAC_LOG_MODEL_ERROR(category, model_id, framework, ...) \
+    RAC_LOG_AT(RAC_LOG_ERROR, category, RAC_LOG_META_MODEL(model_id, framework), __VA_ARGS__)
 
 // =============================================================================
 // LEGACY COMPATIBILITY (maps to new logging system)
@@ -316,6 +345,8 @@ class Logger {
     explicit Logger(const std::string& category) : category_(category.c_str()) {}
 
     void trace(const char* format, ...) const {
+        if (RAC_LOG_TRACE < RAC_MIN_LOG_LEVEL)
+            return;
         va_list args;
         va_start(args, format);
         rac_logger_logv(RAC_LOG_TRACE, category_, nullptr, format, args);
@@ -323,6 +354,8 @@ class Logger {
     }
 
     void debug(const char* format, ...) const {
+        if (RAC_LOG_DEBUG < RAC_MIN_LOG_LEVEL)
+            return;
         va_list args;
         va_start(args, format);
         rac_logger_logv(RAC_LOG_DEBUG, category_, nullptr, format, args);
@@ -0,0 +1,126 @@
+/**
+ * @file rac_memory_watermark.h
+ * @brief RunAnywhere Commons - Per-Call Memory High-Water Marks
+ *
+ * The low-memory killer (Android) and jetsam (iOS) act on process memory,
+ * not on what a model file weighs. The LLM, STT and TTS components bracket
+ * every call with this probe and attach the result to rac_llm_result_t,
+ * rac_stt_result_t and rac_tts_result_t, record it in rac_metrics
+ * ("<llm|stt|tts>.peak_rss_mb" etc.) and report it in telemetry, so models
+ * and configurations that run a device close to its limit show up before
+ * they crash.
+ *
+ * Sources per platform:
+ *   Linux/Android  VmRSS and VmHWM from /proc/self/status, Pss from
+ *                  /proc/self/smaps_rollup (kernel 4.14+). The kernel
+ *                  high-water mark is reset at the start of a call (write "5"
+ *                  to /proc/self/clear_refs) when no other call is measuring,
+ *                  so the peak covers that call only.
+ *   Apple          resident_size, resident_size_peak and phys_footprint
+ *                  (the figure jetsam uses, reported as PSS).
+ *
+ * Memory is per process: a peak measured while other work runs concurrently
+ * includes that work, so treat it as an upper bound.
+ */
+
+#ifndef RAC_MEMORY_WATERMARK_H
+#define RAC_MEMORY_WATERMARK_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Process memory counters (0 where the platform does not report one)
+ */
+typedef struct rac_process_memory {
+    /** Resident set size */
+    int64_t rss_bytes;
+
+    /** Proportional set size (Apple: physical footprint) */
+    int64_t pss_bytes;
+
+    /** Highest resident set size since start (or since the last reset) */
+    int64_t peak_rss_bytes;
+} rac_process_memory_t;
+
+/**
+ * @brief Memory used by one inference call
+ */
+typedef struct rac_inference_memory {
+    /** Highest process RSS while the call ran */
+    int64_t peak_rss_bytes;
+
+    /** Process RSS after the call minus before it */
+    int64_t rss_delta_bytes;
+
+    /** Process PSS after the call minus before it (0 if unavailable) */
+    int64_t pss_delta_bytes;
+
+    /** Memory the backend reports holding after the call (0 if unknown) */
+    int64_t backend_bytes;
+
+    /**
+     * RAC_TRUE when peak_rss_bytes is a kernel high-water mark; RAC_FALSE
+     * when the peak could not be isolated and is the larger of the RSS
+     * before and after the call
+     */
+    rac_bool_t peak_is_exact;
+} rac_inference_memory_t;
+
+/**
+ * @brief State kept between rac_memory_watermark_begin and _end
+ */
+typedef struct rac_memory_watermark {
+    rac_process_memory_t start;
+    rac_bool_t hwm_reset;
+    rac_bool_t valid;
+} rac_memory_watermark_t;
+
+// =============================================================================
+// API
+// =============================================================================
+
+/**
+ * @brief Read the current process memory counters
+ *
+ * Reading PSS walks the process page tables, so its cost grows with the
+ * memory mapped; that is fine around an inference call, not per token.
+ *
+ * @param out_memory Output: counters
+ * @return RAC_SUCCESS, RAC_ERROR_NULL_POINTER, or RAC_ERROR_NOT_SUPPORTED on
+ *         platforms without a memory source
+ */
+RAC_API rac_result_t rac_process_memory_read(rac_process_memory_t* out_memory);
+
+/**
+ * @brief Start measuring a call
+ *
+ * Every begin must be matched by rac_memory_watermark_end on the same mark.
+ *
+ * @param mark Output: state for rac_memory_watermark_end
+ */
+RAC_API void rac_memory_watermark_begin(rac_memory_watermark_t* mark);
+
+/**
+ * @brief Finish measuring a call
+ *
+ * @param mark State from rac_memory_watermark_begin
+ * @param backend_bytes Memory the backend reports holding (0 if unknown)
+ * @param out_memory Output: usage (all zero if the platform has no source)
+ */
+RAC_API void rac_memory_watermark_end(const rac_memory_watermark_t* mark, int64_t backend_bytes,
+                                      rac_inference_memory_t* out_memory);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_MEMORY_WATERMARK_H */
@@ -0,0 +1,184 @@
+/**
+ * @file rac_metrics.h
+ * @brief RunAnywhere Commons - In-Process Metrics Registry
+ *
+ * One registry of named counters, gauges and histograms that components
+ * report into, and that apps read as a snapshot (for a live performance HUD
+ * or to ship aggregates instead of raw events).
+ *
+ * Recording is lock-free: counters are sharded per thread and summed at
+ * snapshot time, gauges are a single atomic, and histograms use log-linear
+ * buckets (4 per power of two, HDR style) so percentiles are within ~19%.
+ * Registration takes a lock; look a metric up once and keep its id (the C++
+ * classes below do this with a function-local static).
+ *
+ * Names use dotted lowercase with the unit as suffix, e.g. "stt.latency_ms".
+ */
+
+#ifndef RAC_METRICS_H
+#define RAC_METRICS_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Metric kinds
+ */
+typedef enum rac_metric_type {
+    RAC_METRIC_COUNTER = 0,  /**< Monotonic total */
+    RAC_METRIC_GAUGE = 1,    /**< Last set value */
+    RAC_METRIC_HISTOGRAM = 2 /**< Distribution of recorded values */
+} rac_metric_type_t;
+
+/** Metric id returned by rac_metrics_register (-1 if the registry is full) */
+typedef int32_t rac_metric_id_t;
+
+/** Most metrics the registry holds */
+#define RAC_METRICS_MAX 256
+
+/**
+ * @brief Value of one metric at snapshot time
+ */
+typedef struct rac_metric_snapshot {
+    /** Registered name (valid for the lifetime of the process) */
+    const char* name;
+
+    /** Metric kind */
+    rac_metric_type_t type;
+
+    /** Counter total, or number of histogram samples */
+    int64_t count;
+
+    /** Gauge value (0 for other kinds) */
+    double value;
+
+    /** Histogram sum, smallest and largest sample (0 for other kinds) */
+    int64_t sum;
+    int64_t min;
+    int64_t max;
+
+    /** Histogram percentiles (bucket upper bounds, capped at max) */
+    int64_t p50;
+    int64_t p90;
+    int64_t p99;
+} rac_metric_snapshot_t;
+
+// =============================================================================
+// METRICS API
+// =============================================================================
+
+/**
+ * @brief Register a metric, or look up one already registered
+ *
+ * @param name Metric name (copied)
+ * @param type Metric kind; must match an earlier registration of the name
+ * @return Metric id, or -1 if the registry is full or the kinds differ
+ */
+RAC_API rac_metric_id_t rac_metrics_register(const char* name, rac_metric_type_t type);
+
+/**
+ * @brief Add to a counter
+ */
+RAC_API void rac_metrics_counter_add(rac_metric_id_t id, int64_t delta);
+
+/**
+ * @brief Set a gauge
+ */
+RAC_API void rac_metrics_gauge_set(rac_metric_id_t id, double value);
+
+/**
+ * @brief Record one histogram sample (negative values count as 0)
+ */
+RAC_API void rac_metrics_histogram_record(rac_metric_id_t id, int64_t value);
+
+/**
+ * @brief Read every registered metric
+ *
+ * Fills at most capacity entries, in registration order. Values recorded
+ * while the snapshot runs may or may not be included.
+ *
+ * @param out_metrics Output array (may be NULL when capacity is 0)
+ * @param capacity Entries available in out_metrics
+ * @param out_count Output: Number of registered metrics (may exceed capacity)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_metrics_snapshot(rac_metric_snapshot_t* out_metrics, size_t capacity,
+                                          size_t* out_count);
+
+/**
+ * @brief Read every registered metric as JSON
+ *
+ * Format: {"counters":{name:n},"gauges":{name:x},
+ *          "histograms":{name:{"count","sum","min","max","p50","p90","p99"}}}
+ *
+ * @param out_json Output: JSON string (must be freed with rac_free)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_metrics_snapshot_json(char** out_json);
+
+/**
+ * @brief Zero every metric; registrations and ids are kept
+ */
+RAC_API void rac_metrics_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+// =============================================================================
+// C++ CONVENIENCE CLASSES
+// =============================================================================
+
+#ifdef __cplusplus
+
+namespace rac {
+
+/**
+ * @brief Registered metric handles.
+ *
+ * Usage:
+ *   static const rac::MetricHistogram latency("stt.latency_ms");
+ *   latency.record(elapsed_ms);
+ */
+class MetricCounter {
+   public:
+    explicit MetricCounter(const char* name)
+        : id_(rac_metrics_register(name, RAC_METRIC_COUNTER)) {}
+    void add(int64_t delta = 1) const { rac_metrics_counter_add(id_, delta); }
+
+   private:
+    rac_metric_id_t id_;
+};
+
+class MetricGauge {
+   public:
+    explicit MetricGauge(const char* name) : id_(rac_metrics_register(name, RAC_METRIC_GAUGE)) {}
+    void set(double value) const { rac_metrics_gauge_set(id_, value); }
+
+   private:
+    rac_metric_id_t id_;
+};
+
+class MetricHistogram {
+   public:
+    explicit MetricHistogram(const char* name)
+        : id_(rac_metrics_register(name, RAC_METRIC_HISTOGRAM)) {}
+    void record(int64_t value) const { rac_metrics_histogram_record(id_, value); }
+
+   private:
+    rac_metric_id_t id_;
+};
+
+}  // namespace rac
+
+#endif  // __cplusplus
+
+#endif /* RAC_METRICS_H */
@@ -0,0 +1,115 @@
+/**
+ * @file rac_perf_sampler.h
+ * @brief RunAnywhere Commons - Continuous On-Device Performance Sampling
+ *
+ * Production devices cannot run simpleperf or Instruments, so this opt-in
+ * mode keeps a cheap record of how long pipeline stages take in the field.
+ * While it runs, every span opened through the trace API (rac_trace.h,
+ * RAC_TRACE_SCOPE) is timed whether or not a profiler is attached, and the
+ * duration goes into a histogram for its stage name and the thermal state
+ * at the time. A background thread samples the mean CPU frequency and the
+ * thermal state at a low rate.
+ *
+ * Once per report interval, each stage histogram with samples is emitted as
+ * an RAC_EVENT_DEVICE_PERF_SAMPLED analytics event and then cleared. The
+ * telemetry manager uploads these events tagged with the device model. Each
+ * event carries percentiles and a sparse histogram string, so the backend
+ * can merge histograms from many devices before it reads fleet percentiles.
+ *
+ * Timing a span costs two clock reads and a few atomic adds. Histograms
+ * use log-linear buckets (4 per power of two of microseconds), so
+ * percentiles are accurate to about 19%. Builds with RAC_ENABLE_TRACING=OFF
+ * have no spans to time and report only frequency and thermal samples.
+ */
+
+#ifndef RAC_PERF_SAMPLER_H
+#define RAC_PERF_SAMPLER_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/** Most distinct stage names tracked; spans with further names are dropped */
+#define RAC_PERF_SAMPLER_MAX_STAGES 64
+
+/**
+ * @brief Sampler configuration
+ */
+typedef struct rac_perf_sampler_config {
+    /** Time one in every N spans on each thread (1 = every span) */
+    int32_t span_sample_every;
+
+    /** Period of the CPU frequency / thermal state samples in milliseconds */
+    int32_t system_sample_interval_ms;
+
+    /** Period of the analytics reports in milliseconds (0 = only on demand) */
+    int32_t report_interval_ms;
+} rac_perf_sampler_config_t;
+
+/**
+ * @brief Default configuration: every span, system samples every 10 s,
+ *        one report every 15 minutes
+ */
+static const rac_perf_sampler_config_t RAC_PERF_SAMPLER_CONFIG_DEFAULT = {1, 10000, 900000};
+
+// =============================================================================
+// SAMPLER API
+// =============================================================================
+
+/**
+ * @brief Start sampling
+ *
+ * Restarting while already running applies the new configuration and keeps
+ * the collected samples.
+ *
+ * @param config Configuration (NULL for RAC_PERF_SAMPLER_CONFIG_DEFAULT)
+ * @return RAC_SUCCESS, RAC_ERROR_INVALID_ARGUMENT for non-positive
+ *         intervals, or RAC_ERROR_OUT_OF_MEMORY
+ */
+RAC_API rac_result_t rac_perf_sampler_start(const rac_perf_sampler_config_t* config);
+
+/**
+ * @brief Stop sampling and report what was collected
+ */
+RAC_API void rac_perf_sampler_stop(void);
+
+/**
+ * @brief Whether sampling is running
+ */
+RAC_API rac_bool_t rac_perf_sampler_is_running(void);
+
+/**
+ * @brief Emit the current window as analytics events now and start a new one
+ *
+ * Apps call this when they go to the background so that a window cut short
+ * still gets reported.
+ *
+ * @return RAC_SUCCESS, or RAC_ERROR_INVALID_STATE if sampling is not running
+ */
+RAC_API rac_result_t rac_perf_sampler_report(void);
+
+/**
+ * @brief Read the current window as JSON without resetting it
+ *
+ * Format: {"window_ms","cpu_freq_mhz","thermal_state","stages":[{"stage",
+ *          "thermal_state","count","p50_ms","p95_ms","p99_ms","max_ms",
+ *          "histogram"}]}
+ * Histograms are "<bucket lower bound us>:<count>" pairs joined by ','.
+ *
+ * @param out_json Output: JSON string (must be freed with rac_free)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_perf_sampler_snapshot_json(char** out_json);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_PERF_SAMPLER_H */
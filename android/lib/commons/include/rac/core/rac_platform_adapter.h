@@ -13,6 +13,7 @@
 #define RAC_PLATFORM_ADAPTER_H
 
 #include "rac/core/rac_error.h"
+#include "rac/core/rac_thermal_governor.h"
 #include "rac/core/rac_types.h"
 #include "rac/infrastructure/model_management/rac_model_types.h"
 
@@ -51,6 +52,16 @@ typedef void (*rac_http_complete_callback_fn)(rac_result_t result, const char* d
 typedef void (*rac_extract_progress_callback_fn)(int32_t files_extracted, int32_t total_files,
                                                  void* callback_user_data);
 
+/**
+ * Audio capture sink type (called from the platform's capture thread).
+ * @param samples Float32 mono samples
+ * @param num_samples Number of samples
+ * @param sample_rate Sample rate of samples in Hz (resampled to the capture rate)
+ * @param capture_context Context passed to audio_capture_start
+ */
+typedef void (*rac_audio_capture_push_fn)(const float* samples, size_t num_samples,
+                                          int32_t sample_rate, void* capture_context);
+
 // =============================================================================
 // PLATFORM ADAPTER STRUCTURE
 // =============================================================================
@@ -235,6 +246,50 @@ typedef struct rac_platform_adapter {
                                     rac_extract_progress_callback_fn progress_callback,
                                     void* callback_user_data, void* user_data);
 
+    // -------------------------------------------------------------------------
+    // Thermal State (Optional - can be NULL)
+    // -------------------------------------------------------------------------
+
+    /**
+     * Get the device thermal state (e.g. ProcessInfo.thermalState).
+     * Polled by the thermal governor; not needed on Android 11+, where the
+     * governor reads AThermal directly.
+     *
+     * @param out_state Output thermal state
+     * @param user_data Platform context
+     * @return RAC_SUCCESS on success, error code on failure
+     */
+    rac_result_t (*get_thermal_state)(rac_thermal_state_t* out_state, void* user_data);
+
+    // -------------------------------------------------------------------------
+    // Audio Capture (Optional - can be NULL)
+    // -------------------------------------------------------------------------
+
+    /**
+     * Start recording the microphone (e.g. an AVAudioEngine input tap).
+     * Used by rac_audio_capture where AAudio is unavailable. Push the first
+     * channel of each buffer as it arrives, at whatever rate the hardware
+     * runs; no conversion is needed.
+     *
+     * @param sample_rate Rate the capture delivers, a hint for the session
+     * @param frames_per_callback Preferred buffer size (0 = platform default)
+     * @param push Sink for captured audio
+     * @param capture_context Context to pass to push
+     * @param user_data Platform context
+     * @return RAC_SUCCESS if recording started, error code otherwise
+     */
+    rac_result_t (*audio_capture_start)(int32_t sample_rate, int32_t frames_per_callback,
+                                        rac_audio_capture_push_fn push, void* capture_context,
+                                        void* user_data);
+
+    /**
+     * Stop recording; push must not be called for capture_context afterwards.
+     *
+     * @param capture_context Context passed to audio_capture_start
+     * @param user_data Platform context
+     */
+    void (*audio_capture_stop)(void* capture_context, void* user_data);
+
     // -------------------------------------------------------------------------
     // User Data
     // -------------------------------------------------------------------------
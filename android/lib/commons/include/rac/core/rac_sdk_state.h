@@ -9,7 +9,8 @@
  * Pattern mirrors Swift's ServiceContainer:
  * - Singleton access via rac_state_get_instance()
  * - Lazy initialization for sub-components
- * - Thread-safe access via internal mutex
+ * - Thread-safe access: getters read an immutable snapshot without locking,
+ *   and returned strings stay valid after later updates
  * - Reset capability for testing
  *
  * State Categories:
@@ -285,6 +286,26 @@ typedef const char* (*rac_load_callback_t)(const char* key, void* user_data);
 void rac_state_set_persistence_callbacks(rac_persist_callback_t persist, rac_load_callback_t load,
                                          void* user_data);
 
+/**
+ * @brief Persist a value through the registered persist callback
+ *
+ * For state owned by other modules (e.g. the device performance profile).
+ *
+ * @param key The key to store under
+ * @param value The value to store (NULL to delete)
+ * @return true if a persist callback was registered
+ */
+bool rac_state_persist_value(const char* key, const char* value);
+
+/**
+ * @brief Load a value through the registered load callback
+ *
+ * @param key The key to load
+ * @return Copy of the stored value (caller must free with rac_free), or NULL
+ * if absent or no load callback is registered
+ */
+char* rac_state_load_value(const char* key);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,68 @@
+/**
+ * @file rac_sha256.h
+ * @brief RunAnywhere Commons - Incremental SHA-256
+ *
+ * Hashes data fed in any number of pieces, so a download can be verified
+ * while it is written instead of being read back afterwards. arm64 CPUs
+ * with the ARMv8 crypto extensions use the SHA-256 instructions (picked at
+ * runtime on Android and Linux); other CPUs use a portable implementation.
+ */
+
+#ifndef RAC_SHA256_H
+#define RAC_SHA256_H
+
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Digest size in bytes */
+#define RAC_SHA256_DIGEST_SIZE 32
+
+/** Hex digest length, without the terminator */
+#define RAC_SHA256_HEX_LENGTH 64
+
+/**
+ * @brief Hash state; treat the fields as private
+ */
+typedef struct rac_sha256 {
+    uint32_t state[8];
+    uint64_t length;      /**< Bytes hashed so far */
+    uint8_t buffer[64];   /**< Partial block */
+} rac_sha256_t;
+
+// =============================================================================
+// SHA-256 API
+// =============================================================================
+
+/**
+ * @brief Start a new hash
+ */
+RAC_API void rac_sha256_init(rac_sha256_t* ctx);
+
+/**
+ * @brief Hash the next bytes
+ */
+RAC_API void rac_sha256_update(rac_sha256_t* ctx, const void* data, size_t size);
+
+/**
+ * @brief Finish the hash; ctx must be initialised again before reuse
+ */
+RAC_API void rac_sha256_final(rac_sha256_t* ctx, uint8_t out_digest[RAC_SHA256_DIGEST_SIZE]);
+
+/**
+ * @brief Format a digest as lowercase hex (out_hex holds 65 bytes)
+ */
+RAC_API void rac_sha256_to_hex(const uint8_t digest[RAC_SHA256_DIGEST_SIZE], char* out_hex);
+
+/**
+ * @brief Name of the implementation in use ("armv8" or "scalar")
+ */
+RAC_API const char* rac_sha256_isa(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_SHA256_H */
@@ -0,0 +1,169 @@
+/**
+ * @file rac_thermal_governor.h
+ * @brief RunAnywhere Commons - Thermal and Battery Governor
+ *
+ * A long decode at full speed heats a phone until the SoC throttles, and the
+ * throughput then drops off a cliff while the UI janks. The governor backs
+ * off before that happens. It maps the device's thermal state, raised by a
+ * low battery or power-save mode, to a policy that backends follow between
+ * decode steps:
+ *
+ * - fewer threads, applied through the CPU budget (rac_cpu_budget.h), so
+ *   every budgeted stage shrinks together
+ * - smaller batches, so a prefill chunk does not hold the cores for long
+ * - decode pacing, which holds generation at a fraction of the speed
+ *   measured while cool, giving a steady token rate instead of bursts
+ *   followed by throttling
+ *
+ * Thermal state comes from AThermal_getCurrentThermalStatus on Android 11+,
+ * otherwise from the platform adapter's get_thermal_state callback (iOS
+ * ProcessInfo.thermalState), polled at most once per poll interval. Platforms
+ * can also push state with rac_thermal_governor_report.
+ */
+
+#ifndef RAC_THERMAL_GOVERNOR_H
+#define RAC_THERMAL_GOVERNOR_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Device thermal state (ProcessInfo.ThermalState, PowerManager thermal status)
+ */
+typedef enum rac_thermal_state {
+    RAC_THERMAL_STATE_NOMINAL = 0,
+    RAC_THERMAL_STATE_FAIR = 1,
+    RAC_THERMAL_STATE_SERIOUS = 2,
+    RAC_THERMAL_STATE_CRITICAL = 3,
+} rac_thermal_state_t;
+
+/** Number of thermal states */
+#define RAC_THERMAL_STATE_COUNT 4
+
+/**
+ * @brief Power state reported by the platform
+ */
+typedef struct rac_power_state {
+    rac_thermal_state_t thermal_state;
+
+    /** Battery level 0.0-1.0, negative if unknown */
+    float battery_level;
+
+    /** Whether the device is charging */
+    rac_bool_t is_charging;
+
+    /** Whether the OS power-save (low power) mode is on */
+    rac_bool_t power_save_mode;
+} rac_power_state_t;
+
+/**
+ * @brief What backends do at one thermal level
+ */
+typedef struct rac_thermal_policy {
+    /** Share of the CPU budget's cores to use, 1-100 */
+    int32_t core_percent;
+
+    /** Most tokens per decode batch (0 = backend default) */
+    int32_t max_batch_tokens;
+
+    /**
+     * Target decode speed as a fraction of the speed measured at the
+     * nominal level (0 = no pacing)
+     */
+    float pace_fraction;
+} rac_thermal_policy_t;
+
+/**
+ * @brief Governor configuration
+ */
+typedef struct rac_thermal_governor_config {
+    /** Follow the policies (RAC_FALSE = always full speed) */
+    rac_bool_t enabled;
+
+    /** Minimum time between thermal state polls in milliseconds */
+    int32_t poll_interval_ms;
+
+    /**
+     * Battery level below which, while not charging, the governor acts at
+     * least at the fair level (0 = ignore battery). Power-save mode does the
+     * same.
+     */
+    float low_battery_level;
+
+    /** Policy per thermal state, indexed by rac_thermal_state_t */
+    rac_thermal_policy_t policies[RAC_THERMAL_STATE_COUNT];
+} rac_thermal_governor_config_t;
+
+/**
+ * @brief Default configuration
+ *
+ * Nominal runs unrestricted. Fair keeps 75% of the cores, 256-token batches
+ * and 85% speed; serious 50%, 128 and 60%; critical 25%, 64 and 40%.
+ */
+static const rac_thermal_governor_config_t RAC_THERMAL_GOVERNOR_CONFIG_DEFAULT = {
+    RAC_TRUE,
+    1000,
+    0.15f,
+    {{100, 0, 0.0f}, {75, 256, 0.85f}, {50, 128, 0.60f}, {25, 64, 0.40f}}};
+
+// =============================================================================
+// GOVERNOR API
+// =============================================================================
+
+/**
+ * @brief Replace the configuration
+ *
+ * @param config Configuration (NULL for RAC_THERMAL_GOVERNOR_CONFIG_DEFAULT)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_thermal_governor_configure(const rac_thermal_governor_config_t* config);
+
+/**
+ * @brief Push the current power state
+ *
+ * Replaces the last reported state; a polled thermal source (AThermal,
+ * platform adapter) still overrides the thermal state on its next poll.
+ */
+RAC_API rac_result_t rac_thermal_governor_report(const rac_power_state_t* state);
+
+/**
+ * @brief Last known power state
+ */
+RAC_API rac_result_t rac_thermal_governor_get_state(rac_power_state_t* out_state);
+
+/**
+ * @brief Policy for the current state, polling the thermal source if due
+ *
+ * Cheap enough to call before every decode step.
+ *
+ * @param out_policy Output: Policy in effect
+ * @return The thermal level the policy belongs to, after battery and power-save adjustments
+ */
+RAC_API rac_thermal_state_t rac_thermal_governor_get_policy(rac_thermal_policy_t* out_policy);
+
+/**
+ * @brief Report a finished decode step and get the pause that paces it
+ *
+ * At the nominal level the step updates the measured decode speed; at
+ * other levels the returned pause stretches the step to the paced speed.
+ * Prefill steps should not be reported.
+ *
+ * @param tokens Tokens generated by the step
+ * @param step_us Wall time the step took in microseconds
+ * @return Microseconds to sleep before the next step (0 = none)
+ */
+RAC_API int64_t rac_thermal_governor_pace_decode(int32_t tokens, int64_t step_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_THERMAL_GOVERNOR_H */
@@ -0,0 +1,146 @@
+/**
+ * @file rac_trace.h
+ * @brief RunAnywhere Commons - Trace Spans and Counters
+ *
+ * Emits markers for system profilers so the voice pipeline shows up on a
+ * timeline: ATrace sections on Android (Perfetto, systrace) and os_signpost
+ * intervals on Apple platforms (Instruments). Elsewhere the calls do nothing.
+ *
+ * Markers cost one check while no profiler is recording. Building with
+ * RAC_TRACE_ENABLED=0 (CMake option RAC_ENABLE_TRACING=OFF) removes the
+ * macros entirely.
+ *
+ * Usage:
+ *   RAC_TRACE_SCOPE("LLM.decode");
+ *   RAC_TRACE_COUNTER("LLM.batch_tokens", n_tokens);
+ */
+
+#ifndef RAC_TRACE_H
+#define RAC_TRACE_H
+
+#include "rac/core/rac_types.h"
+
+#ifndef RAC_TRACE_ENABLED
+#define RAC_TRACE_ENABLED 1
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TRACE API
+// =============================================================================
+
+/**
+ * @brief Whether a profiler is recording markers right now
+ */
+RAC_API rac_bool_t rac_trace_is_enabled(void);
+
+/**
+ * @brief Begin a span on the calling thread
+ *
+ * Spans nest and must end on the thread that began them.
+ *
+ * @param name Span name
+ */
+RAC_API void rac_trace_begin(const char* name);
+
+/**
+ * @brief End the innermost span of the calling thread
+ */
+RAC_API void rac_trace_end(void);
+
+/**
+ * @brief Begin a span that may end on another thread
+ *
+ * @param name Span name; the same name must be passed to rac_trace_async_end
+ * @param cookie Tells concurrent spans of the same name apart
+ */
+RAC_API void rac_trace_async_begin(const char* name, int32_t cookie);
+
+/**
+ * @brief End a span begun with rac_trace_async_begin
+ */
+RAC_API void rac_trace_async_end(const char* name, int32_t cookie);
+
+/**
+ * @brief Record the current value of a counter track
+ *
+ * @param name Counter name
+ * @param value Current value
+ */
+RAC_API void rac_trace_counter(const char* name, int64_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+// =============================================================================
+// C++ CONVENIENCE CLASS
+// =============================================================================
+
+#ifdef __cplusplus
+
+namespace rac {
+
+/**
+ * @brief Span covering the lifetime of the object.
+ *
+ * A span begun while no profiler was recording is not ended either, so
+ * sections stay balanced when recording starts mid-span.
+ */
+class TraceScope {
+   public:
+    explicit TraceScope(const char* name) : active_(rac_trace_is_enabled() == RAC_TRUE) {
+        if (active_) {
+            rac_trace_begin(name);
+        }
+    }
+    ~TraceScope() {
+        if (active_) {
+            rac_trace_end();
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+   private:
+    bool active_;
+};
+
+}  // namespace rac
+
+#endif  // __cplusplus
+
+// =============================================================================
+// CONVENIENCE MACROS
+// =============================================================================
+
+#define RAC_TRACE_CONCAT_INNER(a, b) a##b
+#define RAC_TRACE_CONCAT(a, b) RAC_TRACE_CONCAT_INNER(a, b)
+
+#if RAC_TRACE_ENABLED
+
+/** Span until the end of the enclosing C++ scope */
+#define RAC_TRACE_SCOPE(name) rac::TraceScope RAC_TRACE_CONCAT(_rac_trace_, __LINE__)(name)
+
+#define RAC_TRACE_BEGIN(name) rac_trace_begin(name)
+#define RAC_TRACE_END() rac_trace_end()
+#define RAC_TRACE_ASYNC_BEGIN(name, cookie) rac_trace_async_begin(name, cookie)
+#define RAC_TRACE_ASYNC_END(name, cookie) rac_trace_async_end(name, cookie)
+#define RAC_TRACE_COUNTER(name, value) rac_trace_counter(name, (int64_t)(value))
+
+#else
+
+#define RAC_TRACE_SCOPE(name) ((void)0)
+#define RAC_TRACE_BEGIN(name) ((void)0)
+#define RAC_TRACE_END() ((void)0)
+#define RAC_TRACE_ASYNC_BEGIN(name, cookie) ((void)0)
+#define RAC_TRACE_ASYNC_END(name, cookie) ((void)0)
+#define RAC_TRACE_COUNTER(name, value) ((void)0)
+
+#endif  // RAC_TRACE_ENABLED
+
+#endif /* RAC_TRACE_H */
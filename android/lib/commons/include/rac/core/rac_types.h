@@ -166,12 +166,13 @@ typedef struct rac_memory_info {
  */
 typedef enum rac_capability {
     RAC_CAPABILITY_UNKNOWN = 0,
-    RAC_CAPABILITY_TEXT_GENERATION = 1, /**< LLM text generation */
-    RAC_CAPABILITY_EMBEDDINGS = 2,      /**< Text embeddings */
-    RAC_CAPABILITY_STT = 3,             /**< Speech-to-text */
-    RAC_CAPABILITY_TTS = 4,             /**< Text-to-speech */
-    RAC_CAPABILITY_VAD = 5,             /**< Voice activity detection */
-    RAC_CAPABILITY_DIARIZATION = 6,     /**< Speaker diarization */
+    RAC_CAPABILITY_TEXT_GENERATION = 1,  /**< LLM text generation */
+    RAC_CAPABILITY_EMBEDDINGS = 2,       /**< Text embeddings */
+    RAC_CAPABILITY_STT = 3,              /**< Speech-to-text */
+    RAC_CAPABILITY_TTS = 4,              /**< Text-to-speech */
+    RAC_CAPABILITY_VAD = 5,              /**< Voice activity detection */
+    RAC_CAPABILITY_DIARIZATION = 6,      /**< Speaker diarization */
+    RAC_CAPABILITY_KEYWORD_SPOTTING = 7, /**< Wake word / keyword spotting */
 } rac_capability_t;
 
 /**
@@ -249,6 +250,24 @@ RAC_API void rac_free(void* ptr);
  */
 RAC_API void* rac_alloc(size_t size);
 
+/**
+ * Allocates zeroed memory for count elements using the RAC allocator.
+ *
+ * @param count Number of elements
+ * @param size Size of each element
+ * @return Pointer to allocated memory, or NULL on failure or overflow
+ */
+RAC_API void* rac_calloc(size_t count, size_t size);
+
+/**
+ * Resizes memory allocated by the RAC allocator.
+ *
+ * @param ptr Memory to resize (NULL allocates)
+ * @param size New size in bytes (0 frees ptr and returns NULL)
+ * @return Pointer to resized memory, or NULL on failure (ptr is then unchanged)
+ */
+RAC_API void* rac_realloc(void* ptr, size_t size);
+
 /**
  * Duplicates a null-terminated string.
  *
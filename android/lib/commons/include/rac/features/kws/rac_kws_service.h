@@ -0,0 +1,116 @@
+/**
+ * @file rac_kws_service.h
+ * @brief RunAnywhere Commons - Keyword Spotting Service Interface
+ *
+ * Defines the generic keyword spotting API and vtable for multi-backend
+ * dispatch. Backends (ONNX via sherpa-onnx) implement the vtable and
+ * register for RAC_CAPABILITY_KEYWORD_SPOTTING with the service registry.
+ */
+
+#ifndef RAC_KWS_SERVICE_H
+#define RAC_KWS_SERVICE_H
+
+#include "rac/core/rac_error.h"
+#include "rac/features/kws/rac_kws_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// SERVICE VTABLE - Backend implementations provide this
+// =============================================================================
+
+/**
+ * Keyword spotting service operations vtable.
+ * Each backend implements these functions and provides a static vtable.
+ */
+typedef struct rac_kws_service_ops {
+    /** Feed Float32 mono audio and report a keyword that ended within it */
+    rac_result_t (*process)(void* impl, const float* samples, size_t num_samples,
+                            int32_t sample_rate, rac_kws_detection_t* out_detection);
+
+    /** Drop buffered audio and decoder state */
+    rac_result_t (*reset)(void* impl);
+
+    /** Destroy the service */
+    void (*destroy)(void* impl);
+} rac_kws_service_ops_t;
+
+/**
+ * Keyword spotting service instance.
+ * Contains vtable pointer and backend-specific implementation.
+ */
+typedef struct rac_kws_service {
+    /** Vtable with backend operations */
+    const rac_kws_service_ops_t* ops;
+
+    /** Backend-specific implementation handle */
+    void* impl;
+
+    /** Model ID for reference */
+    const char* model_id;
+} rac_kws_service_t;
+
+// =============================================================================
+// PUBLIC API - Generic service functions
+// =============================================================================
+
+/**
+ * @brief Create a keyword spotter
+ *
+ * Routes through the service registry to find a backend. config_json may
+ * set:
+ *   "keywords"            Keywords, one per line in the model's token format
+ *                         (e.g. "▁HE Y ▁S I RI @hey_siri"); defaults to the
+ *                         keywords.txt next to the model
+ *   "keywords_threshold"  Detection threshold, higher is stricter (0.25)
+ *   "keywords_score"      Boost for keyword paths during search (1.0)
+ *   "num_threads"         Inference threads (1)
+ *
+ * @param model_path Streaming KWS model directory (encoder/decoder/joiner + tokens.txt)
+ * @param config_json Configuration JSON (can be NULL)
+ * @param out_handle Output: Handle to the created service
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_kws_create(const char* model_path, const char* config_json,
+                                    rac_handle_t* out_handle);
+
+/**
+ * @brief Feed audio and check for a keyword
+ *
+ * Audio can arrive in chunks of any size; the spotter keeps its own state
+ * between calls. After a detection the spotter starts over, so the same
+ * utterance is reported once.
+ *
+ * @param handle Service handle
+ * @param samples Float32 mono samples
+ * @param num_samples Number of samples
+ * @param sample_rate Sample rate of samples (resampled to the model rate)
+ * @param out_detection Output: Detection result
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_kws_process(rac_handle_t handle, const float* samples,
+                                     size_t num_samples, int32_t sample_rate,
+                                     rac_kws_detection_t* out_detection);
+
+/**
+ * @brief Drop buffered audio and decoder state
+ *
+ * @param handle Service handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_kws_reset(rac_handle_t handle);
+
+/**
+ * @brief Destroy a keyword spotter
+ *
+ * @param handle Service handle to destroy
+ */
+RAC_API void rac_kws_destroy(rac_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_KWS_SERVICE_H */
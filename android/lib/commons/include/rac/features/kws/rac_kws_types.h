@@ -0,0 +1,56 @@
+/**
+ * @file rac_kws_types.h
+ * @brief RunAnywhere Commons - Keyword Spotting Types
+ *
+ * Keyword spotting (wake word detection) runs a small streaming model over
+ * microphone audio and reports when one of a fixed set of phrases is
+ * spoken. It costs a fraction of continuous STT, so a hands-free pipeline
+ * can leave it running and start VAD and STT only after a detection.
+ *
+ * This header defines data structures only. For the service interface,
+ * see rac_kws_service.h.
+ */
+
+#ifndef RAC_KWS_TYPES_H
+#define RAC_KWS_TYPES_H
+
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// CONSTANTS
+// =============================================================================
+
+#define RAC_KWS_DEFAULT_SAMPLE_RATE 16000
+
+/** Longest keyword name reported in a detection, including the terminator */
+#define RAC_KWS_MAX_KEYWORD_LENGTH 64
+
+// =============================================================================
+// DETECTION
+// =============================================================================
+
+/**
+ * @brief Result of feeding audio to a keyword spotter
+ *
+ * Fixed size so the audio path never allocates.
+ */
+typedef struct rac_kws_detection {
+    /** RAC_TRUE if a keyword ended within the fed audio */
+    rac_bool_t detected;
+
+    /** Name of the detected keyword (empty if none; truncated if longer) */
+    char keyword[RAC_KWS_MAX_KEYWORD_LENGTH];
+
+    /** Start of the keyword in the spotter's audio timeline (ms) */
+    double start_ms;
+} rac_kws_detection_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_KWS_TYPES_H */
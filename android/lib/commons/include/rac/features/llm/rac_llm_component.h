@@ -14,6 +14,7 @@
 
 #include "rac/core/capabilities/rac_lifecycle.h"
 #include "rac/core/rac_error.h"
+#include "rac/features/llm/rac_llm_context.h"
 #include "rac/features/llm/rac_llm_types.h"
 
 #ifdef __cplusplus
@@ -120,6 +121,58 @@ RAC_API const char* rac_llm_component_get_model_id(rac_handle_t handle);
 RAC_API rac_result_t rac_llm_component_load_model(rac_handle_t handle, const char* model_path,
                                                   const char* model_id, const char* model_name);
 
+/**
+ * @brief Load a model on a background thread, with progress and cancellation
+ *
+ * See rac_lifecycle_load_async. llama.cpp reports progress while it reads the
+ * weights and stops at the next report after rac_lifecycle_load_cancel.
+ *
+ * @param handle Component handle
+ * @param model_path File path to the model - REQUIRED
+ * @param model_id Model identifier for telemetry (NULL = model_path)
+ * @param model_name Human-readable model name (NULL = model_id)
+ * @param progress_fn Progress callback (can be NULL)
+ * @param complete_fn Completion callback (can be NULL)
+ * @param user_data Passed to both callbacks
+ * @param out_load Output: Load handle (release with rac_lifecycle_load_release)
+ * @return RAC_SUCCESS if the load was started, or error code
+ */
+RAC_API rac_result_t rac_llm_component_load_model_async(
+    rac_handle_t handle, const char* model_path, const char* model_id, const char* model_name,
+    rac_lifecycle_load_progress_fn progress_fn, rac_lifecycle_load_complete_fn complete_fn,
+    void* user_data, rac_lifecycle_load_handle_t* out_load);
+
+/**
+ * @brief Set how the next load brings model weights into memory
+ *
+ * With RAC_MODEL_LOAD_MODE_MMAP_PREFETCH, rac_llm_component_load_model returns
+ * once the file is mapped and pages are prefetched in the background.
+ *
+ * @param handle Component handle
+ * @param mode Load mode
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_component_set_load_mode(rac_handle_t handle,
+                                                     rac_model_load_mode_t mode);
+
+/**
+ * @brief Set backend options for the next load
+ *
+ * The JSON object is forwarded to the backend that creates the service. The
+ * llama.cpp backend reads the fields of rac_llm_llamacpp_config_t:
+ * {"num_threads": 4, "batch_size": 256, "context_size": 4096,
+ *  "kv_cache_type_k": "q8_0", "kv_cache_type_v": "q8_0", "flash_attention": 1,
+ *  "gpu_layers": 0}. Keys override the load mode set with
+ * rac_llm_component_set_load_mode. A loaded model keeps its options until
+ * it is unloaded and loaded again.
+ *
+ * @param handle Component handle
+ * @param config_json JSON object (NULL or empty to clear)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_component_set_backend_config(rac_handle_t handle,
+                                                          const char* config_json);
+
 /**
  * @brief Unload the current model
  *
@@ -166,6 +219,45 @@ RAC_API rac_result_t rac_llm_component_generate(rac_handle_t handle, const char*
                                                 const rac_llm_options_t* options,
                                                 rac_llm_result_t* out_result);
 
+/**
+ * @brief Generate text for several prompts at once
+ *
+ * Runs the prompts concurrently when the backend supports batching, otherwise
+ * one by one. The callback is invoked once per prompt as each finishes.
+ *
+ * @param handle Component handle
+ * @param prompts Input prompts
+ * @param num_prompts Number of prompts
+ * @param options Generation options shared by all prompts (can be NULL for defaults)
+ * @param callback Per-prompt result callback
+ * @param user_data User context passed to callback
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_component_generate_batch(rac_handle_t handle,
+                                                      const char* const* prompts,
+                                                      size_t num_prompts,
+                                                      const rac_llm_options_t* options,
+                                                      rac_llm_batch_callback_fn callback,
+                                                      void* user_data);
+
+/**
+ * @brief Draw several replies to one prompt over a single prefill
+ *
+ * For best-of-N and self-consistency voting (e.g. asking three times which
+ * tool to call). See rac_llm_generate_samples.
+ *
+ * @param handle Component handle
+ * @param prompt Input prompt
+ * @param options Generation options; n_samples sets how many replies (can be
+ *                NULL for the component defaults: one reply)
+ * @param out_samples Output: Replies with log-probabilities (free with
+ *                    rac_llm_samples_free)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_component_generate_samples(rac_handle_t handle, const char* prompt,
+                                                        const rac_llm_options_t* options,
+                                                        rac_llm_samples_t* out_samples);
+
 /**
  * @brief Check if streaming is supported
  *
@@ -196,6 +288,65 @@ RAC_API rac_result_t rac_llm_component_generate_stream(
     rac_llm_component_complete_callback_fn complete_callback,
     rac_llm_component_error_callback_fn error_callback, void* user_data);
 
+/**
+ * @brief Decode a prompt ahead of time so a later generation starts warm
+ *
+ * Runs a one-token generation with the component's default options and
+ * discards the output. Backends with a prompt prefix cache (llama.cpp) keep
+ * the decoded prompt, so a later generation whose prompt shares a prefix
+ * with it only decodes the remainder. Others gain nothing. No analytics
+ * events are emitted.
+ *
+ * @param handle Component handle
+ * @param prompt Prompt expected to start a later generation
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_component_prefill(rac_handle_t handle, const char* prompt);
+
+// =============================================================================
+// CONVERSATION API - Multi-turn chat within a context budget
+// =============================================================================
+
+/**
+ * @brief Configure the conversation context budget
+ *
+ * @param handle Component handle
+ * @param config Budget configuration (NULL for defaults)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_component_set_context_config(rac_handle_t handle,
+                                                          const rac_llm_context_config_t* config);
+
+/**
+ * @brief Drop the conversation history and summary
+ *
+ * @param handle Component handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_component_clear_conversation(rac_handle_t handle);
+
+/**
+ * @brief Send a user message in the ongoing conversation with streaming
+ *
+ * Appends the message to the history, evicts or summarises the oldest turns
+ * once the history exceeds the context budget, streams the reply, and records
+ * it as an assistant turn on completion.
+ *
+ * @param handle Component handle
+ * @param message User message
+ * @param options Generation options (can be NULL for defaults)
+ * @param token_callback Called for each generated token
+ * @param complete_callback Called when generation completes
+ * @param error_callback Called on error
+ * @param user_data User context passed to callbacks
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_component_chat_stream(
+    rac_handle_t handle, const char* message, const rac_llm_options_t* options,
+    rac_llm_component_token_callback_fn token_callback,
+    rac_llm_component_complete_callback_fn complete_callback,
+    rac_llm_component_error_callback_fn error_callback, void* user_data);
+
 /**
  * @brief Get lifecycle state
  *
@@ -214,6 +365,158 @@ RAC_API rac_lifecycle_state_t rac_llm_component_get_state(rac_handle_t handle);
 RAC_API rac_result_t rac_llm_component_get_metrics(rac_handle_t handle,
                                                    rac_lifecycle_metrics_t* out_metrics);
 
+/**
+ * @brief Get memory held by the loaded model
+ *
+ * Complements rac_llm_component_get_metrics with the backend's memory
+ * breakdown, for memory-pressure handling.
+ *
+ * @param handle Component handle
+ * @param out_usage Output: Memory breakdown
+ * @return RAC_SUCCESS, RAC_ERROR_NOT_INITIALIZED if no model is loaded, or
+ *         RAC_ERROR_NOT_SUPPORTED if the backend cannot report it
+ */
+RAC_API rac_result_t rac_llm_component_get_memory_usage(rac_handle_t handle,
+                                                        rac_llm_memory_usage_t* out_usage);
+
+/**
+ * @brief Count the tokens of a text with the loaded model's tokenizer
+ *
+ * Counts are cached per model, so checking a prompt budget repeatedly only
+ * tokenizes text that has not been counted before. Falls back to a
+ * four-characters-per-token estimate if the backend has no tokenizer. Does
+ * not wait for an in-flight generation.
+ *
+ * @param handle Component handle
+ * @param text Text to count
+ * @param out_count Output: Token count
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_INITIALIZED if no model is loaded
+ */
+RAC_API rac_result_t rac_llm_component_count_tokens(rac_handle_t handle, const char* text,
+                                                    int32_t* out_count);
+
+/**
+ * @brief Count the tokens of several texts in one call
+ *
+ * For prompt budgets over a chat history: pass each turn separately, so as
+ * the history grows only the new turns reach the tokenizer. Counts can
+ * differ slightly from counting the joined text, where tokens can merge
+ * across a boundary.
+ *
+ * @param handle Component handle
+ * @param texts Texts to count (NULL entries count as 0)
+ * @param count Number of texts
+ * @param out_counts Output: Token count per text (count entries)
+ * @param out_total Output: Sum of the counts (can be NULL)
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_INITIALIZED if no model is loaded
+ */
+RAC_API rac_result_t rac_llm_component_count_tokens_batch(rac_handle_t handle,
+                                                          const char* const* texts, size_t count,
+                                                          int32_t* out_counts, int64_t* out_total);
+
+/**
+ * @brief Get the context window of the loaded model in tokens
+ *
+ * @param handle Component handle
+ * @param out_context_size Output: Context size (the configured context_length
+ *                         if the backend does not report one)
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_INITIALIZED if no model is loaded
+ */
+RAC_API rac_result_t rac_llm_component_get_context_size(rac_handle_t handle,
+                                                        int32_t* out_context_size);
+
+/**
+ * @brief Save the conversation the last generation ran in
+ *
+ * Writes that conversation's KV cache and tokens to a file. The KV cache is
+ * stored in the context's cache type, so a q8_0 cache (kv_cache_type_k/v)
+ * gives about half the size of the f16 default. Call it after a generation
+ * returns, e.g. when the app goes to the background.
+ *
+ * @param handle Component handle
+ * @param path File to write (replaced atomically)
+ * @param out_token_count Output: Tokens saved (can be NULL)
+ * @return RAC_SUCCESS, RAC_ERROR_NOT_INITIALIZED if no model is loaded,
+ *         RAC_ERROR_BACKEND_BUSY while generating, RAC_ERROR_INVALID_STATE
+ *         if nothing was generated yet, or RAC_ERROR_NOT_SUPPORTED
+ */
+RAC_API rac_result_t rac_llm_component_save_state(rac_handle_t handle, const char* path,
+                                                  int32_t* out_token_count);
+
+/**
+ * @brief Restore a conversation saved by rac_llm_component_save_state
+ *
+ * The file is memory-mapped and its tokens checked against the hash in its
+ * header. The restored cache then serves as the prefix of later prompts,
+ * so a generation whose prompt continues that conversation only prefills
+ * the new turns instead of the whole transcript.
+ *
+ * @param handle Component handle
+ * @param path File to read
+ * @param out_token_count Output: Tokens restored (can be NULL)
+ * @return RAC_SUCCESS, RAC_ERROR_NOT_INITIALIZED, RAC_ERROR_BACKEND_BUSY,
+ *         RAC_ERROR_FILE_NOT_FOUND, RAC_ERROR_INVALID_FORMAT,
+ *         RAC_ERROR_MODEL_INCOMPATIBLE if saved with another model or KV
+ *         cache type, RAC_ERROR_CONTEXT_TOO_LONG, or RAC_ERROR_NOT_SUPPORTED
+ */
+RAC_API rac_result_t rac_llm_component_restore_state(rac_handle_t handle, const char* path,
+                                                     int32_t* out_token_count);
+
+/**
+ * @brief Load a LoRA adapter on top of the base model
+ *
+ * Adapters are small and stay in memory next to the one copy of the base
+ * weights, so switching between them (per request with
+ * rac_llm_options_t.lora_adapter, or with rac_llm_component_set_lora) takes
+ * milliseconds instead of a model load. The component reloads its adapters
+ * whenever it loads a model; adapters that do not fit it are dropped.
+ * Without a loaded model the adapter is loaded with the next one.
+ *
+ * @param handle Component handle
+ * @param name Name requests select it by (e.g. a persona)
+ * @param path LoRA adapter GGUF
+ * @return RAC_SUCCESS, RAC_ERROR_INVALID_ARGUMENT if the name is taken by
+ *         another file, RAC_ERROR_MODEL_LOAD_FAILED if the adapter does not
+ *         fit the loaded model, or RAC_ERROR_NOT_SUPPORTED
+ */
+RAC_API rac_result_t rac_llm_component_load_lora(rac_handle_t handle, const char* name,
+                                                 const char* path);
+
+/**
+ * @brief Remove a LoRA adapter and free its weights
+ *
+ * @param handle Component handle
+ * @param name Adapter name
+ * @return RAC_SUCCESS, RAC_ERROR_NOT_FOUND, or RAC_ERROR_BACKEND_BUSY while a
+ *         generation uses it
+ */
+RAC_API rac_result_t rac_llm_component_remove_lora(rac_handle_t handle, const char* name);
+
+/**
+ * @brief Select the adapter for generations whose options do not name one
+ *
+ * @param handle Component handle
+ * @param name Adapter name, or NULL / "" for the base model
+ * @param scale Adapter scale (0 = 1.0)
+ * @return RAC_SUCCESS or RAC_ERROR_NOT_FOUND
+ */
+RAC_API rac_result_t rac_llm_component_set_lora(rac_handle_t handle, const char* name,
+                                                float scale);
+
+/**
+ * @brief React to system memory pressure (e.g. Android onTrimMemory)
+ *
+ * Any level first destroys parked models (rac_model_residency_trim). MODERATE
+ * and LOW then ask the backend to drop caches and shrink the context;
+ * CRITICAL cancels any generation and unloads the model.
+ *
+ * @param handle Component handle
+ * @param level Pressure level
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_component_handle_memory_pressure(rac_handle_t handle,
+                                                              rac_llm_memory_pressure_t level);
+
 /**
  * @brief Destroy the LLM component
  *
@@ -0,0 +1,167 @@
+/**
+ * @file rac_llm_context.h
+ * @brief RunAnywhere Commons - LLM Conversation Context Budget
+ *
+ * Tracks conversation turns with their token counts and keeps the rendered
+ * prompt inside a token budget, either by evicting the oldest turns or by
+ * folding them into a rolling summary generated by an LLM service.
+ */
+
+#ifndef RAC_LLM_CONTEXT_H
+#define RAC_LLM_CONTEXT_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief What to do with the oldest turns when the budget is exceeded
+ */
+typedef enum rac_llm_context_strategy {
+    /** Drop the oldest turns */
+    RAC_LLM_CONTEXT_EVICT_OLDEST = 0,
+    /** Replace the oldest turns with a rolling summary (falls back to eviction) */
+    RAC_LLM_CONTEXT_SUMMARIZE = 1,
+} rac_llm_context_strategy_t;
+
+/**
+ * @brief Context budget configuration
+ */
+typedef struct rac_llm_context_config {
+    /** Prompt token budget (0 = context length minus the reply's max_tokens) */
+    int32_t budget_tokens;
+
+    /** Eviction strategy */
+    rac_llm_context_strategy_t strategy;
+
+    /** Most recent turns that are never evicted or summarised (minimum 1) */
+    int32_t keep_recent_turns;
+
+    /** Token cap for a generated summary */
+    int32_t summary_max_tokens;
+} rac_llm_context_config_t;
+
+/**
+ * @brief Default context budget configuration
+ */
+static const rac_llm_context_config_t RAC_LLM_CONTEXT_CONFIG_DEFAULT = {
+    .budget_tokens = 0,
+    .strategy = RAC_LLM_CONTEXT_SUMMARIZE,
+    .keep_recent_turns = 2,
+    .summary_max_tokens = 128};
+
+/**
+ * @brief Opaque handle for a conversation context
+ */
+typedef struct rac_llm_context* rac_llm_context_handle_t;
+
+// =============================================================================
+// CONTEXT API
+// =============================================================================
+
+/**
+ * @brief Create a conversation context
+ *
+ * @param config Budget configuration (NULL for defaults)
+ * @param out_handle Output: Context handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_context_create(const rac_llm_context_config_t* config,
+                                            rac_llm_context_handle_t* out_handle);
+
+/**
+ * @brief Destroy a conversation context
+ *
+ * @param handle Context handle
+ */
+RAC_API void rac_llm_context_destroy(rac_llm_context_handle_t handle);
+
+/**
+ * @brief Replace the budget configuration (turns are kept)
+ *
+ * @param handle Context handle
+ * @param config New configuration
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_context_set_config(rac_llm_context_handle_t handle,
+                                                const rac_llm_context_config_t* config);
+
+/**
+ * @brief Get the budget configuration
+ *
+ * @param handle Context handle
+ * @param out_config Output: Current configuration
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_context_get_config(rac_llm_context_handle_t handle,
+                                                rac_llm_context_config_t* out_config);
+
+/**
+ * @brief Append a turn
+ *
+ * @param handle Context handle
+ * @param role "user" or "assistant"
+ * @param text Turn text
+ * @param token_count Tokens in text (see rac_llm_count_tokens)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_context_add_turn(rac_llm_context_handle_t handle, const char* role,
+                                              const char* text, int32_t token_count);
+
+/**
+ * @brief Drop all turns and the summary
+ *
+ * @param handle Context handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_context_clear(rac_llm_context_handle_t handle);
+
+/**
+ * @brief Get the tokens currently held (summary plus turns)
+ *
+ * @param handle Context handle
+ * @param out_tokens Output: Token count
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_context_get_token_count(rac_llm_context_handle_t handle,
+                                                     int32_t* out_tokens);
+
+/**
+ * @brief Bring the context within a token budget
+ *
+ * Evicts or summarises the oldest turns until the held tokens fit. The most
+ * recent keep_recent_turns are never touched, so the result can still be over
+ * budget; the backend then caps the reply.
+ *
+ * @param handle Context handle
+ * @param service LLM service used for summaries and token counts (can be NULL to evict only)
+ * @param budget_tokens Token budget
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_context_fit(rac_llm_context_handle_t handle, rac_handle_t service,
+                                         int32_t budget_tokens);
+
+/**
+ * @brief Render the summary and turns as a single prompt
+ *
+ * A context holding one turn and no summary renders as that turn's text.
+ *
+ * @param handle Context handle
+ * @param out_prompt Output: Prompt text (must be freed with rac_free)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_context_build_prompt(rac_llm_context_handle_t handle,
+                                                  char** out_prompt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_LLM_CONTEXT_H */
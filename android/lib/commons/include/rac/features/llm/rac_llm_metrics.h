@@ -71,6 +71,28 @@ static const rac_generation_metrics_t RAC_GENERATION_METRICS_DEFAULT = {
     .start_time_ms = 0,
     .last_event_time_ms = 0};
 
+/** Buckets in a latency histogram: 4 per power of two from 64 us to ~4.2 s */
+#define RAC_LATENCY_HISTOGRAM_BUCKETS 64
+
+/**
+ * @brief Fixed-bucket latency histogram (log-linear, HDR style).
+ * Not part of the Swift source. Bucket i covers a ~19% wide range, so
+ * percentiles read from it are within that relative error.
+ */
+typedef struct rac_latency_histogram {
+    /** Samples per bucket (see rac_latency_histogram_bucket_upper_ms) */
+    uint32_t counts[RAC_LATENCY_HISTOGRAM_BUCKETS];
+
+    /** Total samples */
+    int64_t total_count;
+
+    /** Sum of samples in ms (for the mean) */
+    double sum_ms;
+
+    /** Largest sample in ms */
+    double max_ms;
+} rac_latency_histogram_t;
+
 /**
  * @brief Streaming generation result.
  * Mirrors Swift's LLMGenerationResult for streaming.
@@ -105,6 +127,14 @@ typedef struct rac_streaming_result {
 
     /** Response tokens (excluding thinking) */
     int32_t response_tokens;
+
+    /** Inter-token latency percentiles in ms (0 with fewer than two tokens) */
+    double inter_token_p50_ms;
+    double inter_token_p95_ms;
+    double inter_token_p99_ms;
+
+    /** Largest inter-token gap in ms */
+    double inter_token_max_ms;
 } rac_streaming_result_t;
 
 /**
@@ -119,7 +149,51 @@ static const rac_streaming_result_t RAC_STREAMING_RESULT_DEFAULT = {.text = RAC_
                                                                     .tokens_per_second = 0.0,
                                                                     .ttft_ms = 0.0,
                                                                     .thinking_tokens = 0,
-                                                                    .response_tokens = 0};
+                                                                    .response_tokens = 0,
+                                                                    .inter_token_p50_ms = 0.0,
+                                                                    .inter_token_p95_ms = 0.0,
+                                                                    .inter_token_p99_ms = 0.0,
+                                                                    .inter_token_max_ms = 0.0};
+
+/**
+ * @brief Speculative decoding counters, for the draft model and for prompt
+ * lookup (rac_llm_options_t.prompt_lookup).
+ * Not part of the Swift source; filled by rac_llm_llamacpp_get_speculative_metrics.
+ */
+typedef struct rac_speculative_metrics {
+    /** RAC_TRUE if a draft model is loaded */
+    rac_bool_t enabled;
+
+    /** Tokens proposed by the draft model */
+    int64_t drafted_tokens;
+
+    /** Draft tokens accepted by the main model */
+    int64_t accepted_tokens;
+
+    /** Verification decodes run on the main model */
+    int64_t target_decodes;
+
+    /** Tokens produced by those decodes */
+    int64_t generated_tokens;
+
+    /** accepted_tokens / drafted_tokens */
+    double acceptance_rate;
+
+    /** generated_tokens / target_decodes (1.0 = no speedup over plain decoding) */
+    double tokens_per_target_decode;
+
+    /** Tokens proposed by prompt lookup */
+    int64_t lookup_drafted_tokens;
+
+    /** Prompt lookup tokens accepted by the model */
+    int64_t lookup_accepted_tokens;
+
+    /** Decode steps that verified a prompt lookup proposal */
+    int64_t lookup_decodes;
+
+    /** lookup_accepted_tokens / lookup_drafted_tokens */
+    double lookup_acceptance_rate;
+} rac_speculative_metrics_t;
 
 // =============================================================================
 // OPAQUE HANDLES
@@ -159,6 +233,19 @@ RAC_API rac_result_t rac_streaming_metrics_create(const char* model_id, const ch
  */
 RAC_API void rac_streaming_metrics_destroy(rac_streaming_metrics_handle_t handle);
 
+/**
+ * @brief Enable or disable text accumulation (default enabled).
+ *
+ * Call before mark_start. With capture off, record_token only counts and
+ * timestamps tokens, and results carry an empty text.
+ *
+ * @param handle Collector handle
+ * @param capture RAC_TRUE to accumulate token text
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_streaming_metrics_set_capture_text(rac_streaming_metrics_handle_t handle,
+                                                            rac_bool_t capture);
+
 /**
  * @brief Mark the start of generation.
  *
@@ -173,7 +260,8 @@ RAC_API rac_result_t rac_streaming_metrics_mark_start(rac_streaming_metrics_hand
  * @brief Record a token received during streaming.
  *
  * Mirrors Swift's StreamingMetricsCollector.recordToken(_:).
- * First call records TTFT.
+ * First call records TTFT. Lock-free; must be called from a single thread
+ * (the one producing tokens).
  *
  * @param handle Collector handle
  * @param token Token string received
@@ -208,7 +296,8 @@ RAC_API rac_result_t rac_streaming_metrics_mark_failed(rac_streaming_metrics_han
  * @brief Get the generation result.
  *
  * Mirrors Swift's StreamingMetricsCollector.buildResult().
- * Only valid after markComplete() is called.
+ * Only valid after markComplete() is called; earlier calls return the
+ * timing so far with an empty text.
  *
  * @param handle Collector handle
  * @param out_result Output: Streaming result (must be freed with rac_streaming_result_free)
@@ -237,9 +326,35 @@ RAC_API rac_result_t rac_streaming_metrics_get_ttft(rac_streaming_metrics_handle
 RAC_API rac_result_t rac_streaming_metrics_get_token_count(rac_streaming_metrics_handle_t handle,
                                                            int32_t* out_token_count);
 
+/**
+ * @brief Get the decode rate over the most recent tokens (up to 255).
+ *
+ * Safe to call from any thread while tokens are being recorded.
+ *
+ * @param handle Collector handle
+ * @param out_tokens_per_second Output: Recent tokens per second (0 before two tokens)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_streaming_metrics_get_recent_rate(rac_streaming_metrics_handle_t handle,
+                                                           double* out_tokens_per_second);
+
+/**
+ * @brief Get the inter-token latency histogram recorded so far.
+ *
+ * Safe to call from any thread while tokens are being recorded.
+ *
+ * @param handle Collector handle
+ * @param out_histogram Output: Gaps between consecutive tokens
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_streaming_metrics_get_inter_token_histogram(
+    rac_streaming_metrics_handle_t handle, rac_latency_histogram_t* out_histogram);
+
 /**
  * @brief Get accumulated text.
  *
+ * Call from the recording thread or after mark_complete/mark_failed.
+ *
  * @param handle Collector handle
  * @param out_text Output: Accumulated text (owned, must be freed)
  * @return RAC_SUCCESS or error code
@@ -384,6 +499,53 @@ RAC_API rac_result_t rac_generation_analytics_get_metrics(rac_generation_analyti
  */
 RAC_API rac_result_t rac_generation_analytics_reset(rac_generation_analytics_handle_t handle);
 
+/**
+ * @brief Fold a finished stream's latencies into the aggregate histograms.
+ *
+ * Adds the collector's inter-token gaps and its prefill time (start to first
+ * token) to the service-wide tail latency histograms.
+ *
+ * @param handle Analytics service handle
+ * @param metrics Completed streaming metrics collector
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_generation_analytics_merge_streaming(
+    rac_generation_analytics_handle_t handle, rac_streaming_metrics_handle_t metrics);
+
+/**
+ * @brief Get the aggregate latency histograms.
+ *
+ * @param handle Analytics service handle
+ * @param out_inter_token Output: Inter-token gaps across all merged streams (can be NULL)
+ * @param out_prefill Output: Per-request prefill times (can be NULL)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_generation_analytics_get_latency_histograms(
+    rac_generation_analytics_handle_t handle, rac_latency_histogram_t* out_inter_token,
+    rac_latency_histogram_t* out_prefill);
+
+// =============================================================================
+// LATENCY HISTOGRAM
+// =============================================================================
+
+/**
+ * @brief Upper bound of a histogram bucket in ms.
+ *
+ * @param bucket Bucket index
+ * @return Upper bound in ms
+ */
+RAC_API double rac_latency_histogram_bucket_upper_ms(int32_t bucket);
+
+/**
+ * @brief Read a percentile from a histogram.
+ *
+ * @param histogram Histogram
+ * @param percentile Percentile in [0, 100]
+ * @return Latency in ms (bucket upper bound, capped at max_ms), 0 if empty
+ */
+RAC_API double rac_latency_histogram_percentile(const rac_latency_histogram_t* histogram,
+                                                double percentile);
+
 // =============================================================================
 // MEMORY MANAGEMENT
 // =============================================================================
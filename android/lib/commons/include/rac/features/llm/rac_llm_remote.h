@@ -0,0 +1,66 @@
+/**
+ * @file rac_llm_remote.h
+ * @brief RunAnywhere Commons - Remote LLM Service
+ *
+ * An LLM service backed by an OpenAI-compatible chat completions endpoint,
+ * reached through the platform HTTP executor (rac_http_client.h). It
+ * implements the regular service vtable, so rac_llm_generate and the router
+ * (rac_llm_router.h) drive it like any on-device backend.
+ *
+ * The HTTP executor delivers whole responses, so streaming delivers the
+ * reply as a single token once it arrives.
+ */
+
+#ifndef RAC_LLM_REMOTE_H
+#define RAC_LLM_REMOTE_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Remote endpoint configuration
+ */
+typedef struct rac_llm_remote_config {
+    /** Chat completions URL, e.g. "https://api.example.com/v1/chat/completions" (required) */
+    const char* endpoint_url;
+
+    /** Bearer token (can be NULL) */
+    const char* api_key;
+
+    /** Model name sent in the request body (required) */
+    const char* model;
+
+    /** Request timeout in milliseconds (0 = 60000) */
+    int32_t timeout_ms;
+} rac_llm_remote_config_t;
+
+// =============================================================================
+// REMOTE SERVICE API
+// =============================================================================
+
+/**
+ * @brief Create a remote LLM service
+ *
+ * The configuration is copied. Requests fail with RAC_ERROR_HTTP_NOT_SUPPORTED
+ * until the platform registers an HTTP executor.
+ *
+ * @param config Endpoint configuration
+ * @param out_handle Output: LLM service handle (destroy with rac_llm_destroy)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_remote_create(const rac_llm_remote_config_t* config,
+                                           rac_handle_t* out_handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_LLM_REMOTE_H */
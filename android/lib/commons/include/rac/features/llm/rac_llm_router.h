@@ -0,0 +1,261 @@
+/**
+ * @file rac_llm_router.h
+ * @brief RunAnywhere Commons - Latency-Aware LLM Routing
+ *
+ * rac_service_create picks an on-device provider once, by static priority.
+ * The router instead chooses per request between up to three LLM services,
+ * the local backend (e.g. llama.cpp), the platform backend (rac_llm_platform)
+ * and a remote endpoint (rac_llm_remote), using what it has measured:
+ * each route's recent decode speed and time to first token, how many
+ * requests it is already running, and the device's thermal and battery
+ * state as reported by the platform.
+ *
+ * A route whose predicted latency meets the configured targets is used in
+ * preference order (local, platform, remote). When none meets them the
+ * fastest predicted route is used. If the chosen route fails, the request
+ * falls back to the next candidate; cancellation never falls back, and a
+ * stream only falls back before its first token.
+ *
+ * Services are borrowed: the router never initializes or destroys them.
+ */
+
+#ifndef RAC_LLM_ROUTER_H
+#define RAC_LLM_ROUTER_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_thermal_governor.h"
+#include "rac/core/rac_types.h"
+#include "rac/features/llm/rac_llm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Route, in preference order
+ */
+typedef enum rac_llm_route {
+    RAC_LLM_ROUTE_LOCAL = 0,    /**< On-device backend (llama.cpp, ONNX) */
+    RAC_LLM_ROUTE_PLATFORM = 1, /**< Platform backend (Foundation Models) */
+    RAC_LLM_ROUTE_REMOTE = 2,   /**< Remote endpoint */
+} rac_llm_route_t;
+
+/** Number of routes */
+#define RAC_LLM_ROUTE_COUNT 3
+
+/**
+ * @brief Device state reported by the platform
+ */
+typedef struct rac_llm_router_device_state {
+    rac_thermal_state_t thermal_state;
+
+    /** Battery level 0.0-1.0, negative if unknown */
+    float battery_level;
+
+    /** Whether the device is charging */
+    rac_bool_t is_charging;
+
+    /** Whether the network is reachable (remote route) */
+    rac_bool_t network_available;
+} rac_llm_router_device_state_t;
+
+/**
+ * @brief Default device state: cool, battery unknown, online
+ */
+static const rac_llm_router_device_state_t RAC_LLM_ROUTER_DEVICE_STATE_DEFAULT = {
+    .thermal_state = RAC_THERMAL_STATE_NOMINAL,
+    .battery_level = -1.0f,
+    .is_charging = RAC_FALSE,
+    .network_available = RAC_TRUE};
+
+/**
+ * @brief Router configuration
+ */
+typedef struct rac_llm_router_config {
+    /** Target time to first token in milliseconds (0 = no target) */
+    int32_t target_ttft_ms;
+
+    /** Target total generation time in milliseconds (0 = no target) */
+    int32_t target_total_ms;
+
+    /**
+     * Hottest thermal state on-device routes are preferred in. Above it they
+     * are only used when no other route is available.
+     */
+    rac_thermal_state_t max_on_device_thermal;
+
+    /**
+     * Battery level below which on-device routes are avoided while not
+     * charging (0 = ignore battery)
+     */
+    float min_on_device_battery;
+
+    /** Allow the remote route (e.g. off for privacy-sensitive requests) */
+    rac_bool_t remote_enabled;
+
+    /** Retry on the next route when the chosen one fails */
+    rac_bool_t fallback_enabled;
+} rac_llm_router_config_t;
+
+/**
+ * @brief Default config: 10 s total target, avoid on-device when throttled
+ * or below 15% battery
+ */
+static const rac_llm_router_config_t RAC_LLM_ROUTER_CONFIG_DEFAULT = {
+    .target_ttft_ms = 0,
+    .target_total_ms = 10000,
+    .max_on_device_thermal = RAC_THERMAL_STATE_FAIR,
+    .min_on_device_battery = 0.15f,
+    .remote_enabled = RAC_TRUE,
+    .fallback_enabled = RAC_TRUE};
+
+/**
+ * @brief What the router has measured for one route
+ */
+typedef struct rac_llm_route_stats {
+    /** Whether a service is set for the route */
+    rac_bool_t available;
+
+    /** Smoothed decode speed, 0 until measured */
+    float tokens_per_second;
+
+    /** Smoothed time to first token in milliseconds, 0 until measured */
+    float ttft_ms;
+
+    /** Requests currently running on the route */
+    int32_t in_flight;
+
+    int64_t successes;
+    int64_t failures;
+
+    /** Failures since the last success; 3 or more puts the route in cooldown */
+    int32_t consecutive_failures;
+} rac_llm_route_stats_t;
+
+/**
+ * @brief Opaque router handle
+ */
+typedef struct rac_llm_router* rac_llm_router_handle_t;
+
+// =============================================================================
+// ROUTER API
+// =============================================================================
+
+/**
+ * @brief Create a router with no routes
+ *
+ * @param config Configuration (NULL for RAC_LLM_ROUTER_CONFIG_DEFAULT)
+ * @param out_handle Output: Router handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_router_create(const rac_llm_router_config_t* config,
+                                           rac_llm_router_handle_t* out_handle);
+
+/**
+ * @brief Destroy a router; its services are left alone
+ *
+ * No generation may be running on the router.
+ */
+RAC_API void rac_llm_router_destroy(rac_llm_router_handle_t handle);
+
+/**
+ * @brief Replace the configuration
+ */
+RAC_API rac_result_t rac_llm_router_configure(rac_llm_router_handle_t handle,
+                                              const rac_llm_router_config_t* config);
+
+/**
+ * @brief Set the LLM service for a route
+ *
+ * Replacing a service resets the route's measurements.
+ *
+ * @param handle Router handle
+ * @param route Route
+ * @param service LLM service handle (rac_llm_create, rac_llm_remote_create), or NULL to
+ * remove the route. Must stay valid while set.
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_router_set_route(rac_llm_router_handle_t handle,
+                                              rac_llm_route_t route, rac_handle_t service);
+
+/**
+ * @brief Report the device's current state
+ *
+ * Platforms call this as thermal, battery or connectivity change.
+ */
+RAC_API rac_result_t rac_llm_router_set_device_state(rac_llm_router_handle_t handle,
+                                                     const rac_llm_router_device_state_t* state);
+
+/**
+ * @brief Route a request would take now, without running it
+ *
+ * @param handle Router handle
+ * @param options Generation options (NULL for defaults; max_tokens sizes the prediction)
+ * @param out_route Output: Chosen route
+ * @param out_predicted_ms Output: Predicted total time, or -1 if unmeasured (can be NULL)
+ * @return RAC_SUCCESS, or RAC_ERROR_SERVICE_NOT_AVAILABLE if no route is usable
+ */
+RAC_API rac_result_t rac_llm_router_select(rac_llm_router_handle_t handle,
+                                           const rac_llm_options_t* options,
+                                           rac_llm_route_t* out_route,
+                                           int64_t* out_predicted_ms);
+
+/**
+ * @brief Generate on the best route, falling back on failure
+ *
+ * @param handle Router handle
+ * @param prompt Input prompt
+ * @param options Generation options (can be NULL for defaults)
+ * @param out_result Output: Generation result (caller must free with rac_llm_result_free)
+ * @param out_route Output: Route that produced the result (can be NULL)
+ * @return RAC_SUCCESS or the last route's error code
+ */
+RAC_API rac_result_t rac_llm_router_generate(rac_llm_router_handle_t handle, const char* prompt,
+                                             const rac_llm_options_t* options,
+                                             rac_llm_result_t* out_result,
+                                             rac_llm_route_t* out_route);
+
+/**
+ * @brief Stream on the best route, falling back until the first token
+ *
+ * @param handle Router handle
+ * @param prompt Input prompt
+ * @param options Generation options (can be NULL for defaults)
+ * @param callback Callback for each token
+ * @param user_data User context passed to callback
+ * @param out_route Output: Route that streamed (can be NULL)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_router_generate_stream(rac_llm_router_handle_t handle,
+                                                    const char* prompt,
+                                                    const rac_llm_options_t* options,
+                                                    rac_llm_stream_callback_fn callback,
+                                                    void* user_data,
+                                                    rac_llm_route_t* out_route);
+
+/**
+ * @brief Cancel running generations on every route
+ */
+RAC_API rac_result_t rac_llm_router_cancel(rac_llm_router_handle_t handle);
+
+/**
+ * @brief Measurements for one route
+ */
+RAC_API rac_result_t rac_llm_router_get_stats(rac_llm_router_handle_t handle,
+                                              rac_llm_route_t route,
+                                              rac_llm_route_stats_t* out_stats);
+
+/**
+ * @brief Route name ("local", "platform", "remote")
+ */
+RAC_API const char* rac_llm_route_name(rac_llm_route_t route);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_LLM_ROUTER_H */
@@ -49,6 +49,43 @@ typedef struct rac_llm_service_ops {
 
     /** Destroy the service */
     void (*destroy)(void* impl);
+
+    /** Report memory held by the loaded model (optional) */
+    rac_result_t (*get_memory_usage)(void* impl, rac_llm_memory_usage_t* out_usage);
+
+    /** Release memory for a pressure level (optional) */
+    rac_result_t (*trim_memory)(void* impl, rac_llm_memory_pressure_t level);
+
+    /** Count tokens with the model's tokenizer (optional) */
+    rac_result_t (*count_tokens)(void* impl, const char* text, int32_t* out_count);
+
+    /** Generate for many prompts at once (optional, blocking) */
+    rac_result_t (*generate_batch)(void* impl, const char* const* prompts, size_t num_prompts,
+                                   const rac_llm_options_t* options,
+                                   rac_llm_batch_callback_fn callback, void* user_data);
+
+    /** Save the KV cache of the last conversation to a file (optional) */
+    rac_result_t (*save_state)(void* impl, const char* path, int32_t* out_token_count);
+
+    /** Restore a conversation saved by save_state (optional) */
+    rac_result_t (*restore_state)(void* impl, const char* path, int32_t* out_token_count);
+
+    /** Load a LoRA adapter under a name (optional) */
+    rac_result_t (*load_lora)(void* impl, const char* name, const char* path);
+
+    /** Free a LoRA adapter (optional) */
+    rac_result_t (*remove_lora)(void* impl, const char* name);
+
+    /** Set the adapter for requests that do not name one (optional) */
+    rac_result_t (*set_lora)(void* impl, const char* name, float scale);
+
+    /** Draw options->n_samples replies over one prefill (optional, blocking) */
+    rac_result_t (*generate_samples)(void* impl, const char* prompt,
+                                     const rac_llm_options_t* options,
+                                     rac_llm_samples_t* out_samples);
+
+    /** Why this thread's last generate_stream call stopped (optional) */
+    rac_result_t (*get_stop_reason)(void* impl, rac_llm_stop_reason_t* out_reason);
 } rac_llm_service_ops_t;
 
 /**
@@ -81,6 +118,20 @@ typedef struct rac_llm_service {
  */
 RAC_API rac_result_t rac_llm_create(const char* model_id, rac_handle_t* out_handle);
 
+/**
+ * @brief Create an LLM service with backend configuration
+ *
+ * Same as rac_llm_create, with a JSON config forwarded to the backend through
+ * rac_service_request_t.config_json (e.g. {"load_mode": 1}).
+ *
+ * @param model_id Model identifier (registry ID or path to model file)
+ * @param config_json Backend configuration JSON (can be NULL)
+ * @param out_handle Output: Handle to the created service
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_llm_create_with_config(const char* model_id, const char* config_json,
+                                                rac_handle_t* out_handle);
+
 /**
  * @brief Initialize an LLM service
  *
@@ -117,6 +168,44 @@ RAC_API rac_result_t rac_llm_generate_stream(rac_handle_t handle, const char* pr
                                              const rac_llm_options_t* options,
                                              rac_llm_stream_callback_fn callback, void* user_data);
 
+/**
+ * @brief Generate text for many prompts (blocking)
+ *
+ * Backends with multi-sequence decoding (llama.cpp) run the prompts
+ * concurrently and reuse shared prompt prefixes; others fall back to
+ * generating them one by one.
+ *
+ * @param handle Service handle
+ * @param prompts Input prompts
+ * @param num_prompts Number of prompts
+ * @param options Generation options applied to every prompt (can be NULL for defaults)
+ * @param callback Called once per prompt as it finishes
+ * @param user_data User context passed to callback
+ * @return RAC_SUCCESS or error code (per-prompt failures go to the callback)
+ */
+RAC_API rac_result_t rac_llm_generate_batch(rac_handle_t handle, const char* const* prompts,
+                                            size_t num_prompts, const rac_llm_options_t* options,
+                                            rac_llm_batch_callback_fn callback, void* user_data);
+
+/**
+ * @brief Draw several replies to one prompt (blocking)
+ *
+ * For best-of-N and self-consistency voting. Backends with multi-sequence
+ * decoding (llama.cpp) prefill the prompt once, copy its KV cache to one
+ * sequence per reply, and decode the replies in one batch, each with its own
+ * random seed. Others generate the replies one by one, without logprobs.
+ *
+ * @param handle Service handle
+ * @param prompt Input prompt
+ * @param options Generation options; n_samples sets how many replies (capped
+ *                at the backend's parallel sequences)
+ * @param out_samples Output: Replies (free with rac_llm_samples_free)
+ * @return RAC_SUCCESS, RAC_ERROR_CANCELLED, or the generation error
+ */
+RAC_API rac_result_t rac_llm_generate_samples(rac_handle_t handle, const char* prompt,
+                                              const rac_llm_options_t* options,
+                                              rac_llm_samples_t* out_samples);
+
 /**
  * @brief Get service information
  *
@@ -142,6 +231,94 @@ RAC_API rac_result_t rac_llm_cancel(rac_handle_t handle);
  */
 RAC_API rac_result_t rac_llm_cleanup(rac_handle_t handle);
 
+/**
+ * @brief Get memory held by the loaded model
+ *
+ * @param handle Service handle
+ * @param out_usage Output: Memory breakdown
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_SUPPORTED if the backend cannot report it
+ */
+RAC_API rac_result_t rac_llm_get_memory_usage(rac_handle_t handle,
+                                              rac_llm_memory_usage_t* out_usage);
+
+/**
+ * @brief Release memory for a pressure level
+ *
+ * Backends skip the trim while a generation is running.
+ *
+ * @param handle Service handle
+ * @param level Pressure level (CRITICAL is handled by the caller by unloading)
+ * @return RAC_SUCCESS or error code (no-op if not supported)
+ */
+RAC_API rac_result_t rac_llm_trim_memory(rac_handle_t handle, rac_llm_memory_pressure_t level);
+
+/**
+ * @brief Count tokens in text with the loaded model's tokenizer
+ *
+ * @param handle Service handle
+ * @param text Text to tokenize
+ * @param out_count Output: Token count
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_SUPPORTED if the backend has no tokenizer
+ */
+RAC_API rac_result_t rac_llm_count_tokens(rac_handle_t handle, const char* text, int32_t* out_count);
+
+/**
+ * @brief Save the KV cache of the conversation that last finished a request
+ *
+ * @param handle Service handle
+ * @param path File to write
+ * @param out_token_count Output: Tokens saved (can be NULL)
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_SUPPORTED if the backend keeps no state
+ */
+RAC_API rac_result_t rac_llm_save_state(rac_handle_t handle, const char* path,
+                                        int32_t* out_token_count);
+
+/**
+ * @brief Restore a conversation saved by rac_llm_save_state
+ *
+ * @param handle Service handle
+ * @param path File to read
+ * @param out_token_count Output: Tokens restored (can be NULL)
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_SUPPORTED if the backend keeps no state
+ */
+RAC_API rac_result_t rac_llm_restore_state(rac_handle_t handle, const char* path,
+                                           int32_t* out_token_count);
+
+/**
+ * @brief Load a LoRA adapter under a name
+ *
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_SUPPORTED if the backend has no adapters
+ */
+RAC_API rac_result_t rac_llm_load_lora(rac_handle_t handle, const char* name, const char* path);
+
+/**
+ * @brief Free a LoRA adapter loaded with rac_llm_load_lora
+ *
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_SUPPORTED if the backend has no adapters
+ */
+RAC_API rac_result_t rac_llm_remove_lora(rac_handle_t handle, const char* name);
+
+/**
+ * @brief Set the adapter for requests that do not name one (NULL = base model)
+ *
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_SUPPORTED if the backend has no adapters
+ */
+RAC_API rac_result_t rac_llm_set_lora(rac_handle_t handle, const char* name, float scale);
+
+/**
+ * @brief Get why the calling thread's last rac_llm_generate_stream stopped
+ *
+ * Blocking calls report this in rac_llm_result_t::stop_reason; a stream has
+ * no result struct, so it is read afterwards on the same thread.
+ *
+ * @param handle Service handle
+ * @param out_reason Output: Stop reason (RAC_LLM_STOP_REASON_END if the
+ *                   backend does not report one)
+ * @return RAC_SUCCESS or RAC_ERROR_NULL_POINTER
+ */
+RAC_API rac_result_t rac_llm_get_stop_reason(rac_handle_t handle,
+                                             rac_llm_stop_reason_t* out_reason);
+
 /**
  * @brief Destroy an LLM service instance
  *
@@ -118,9 +118,13 @@ RAC_API rac_result_t rac_structured_output_get_system_prompt(const char* json_sc
  *
  * Ported from Swift StructuredOutputHandler.validateStructuredOutput(text:config:) (lines 264-282)
  *
+ * When config has a json_schema, the extracted JSON is also checked against
+ * it with rac_structured_output_validate_json.
+ *
  * @param text Text to validate
  * @param config Structured output configuration (can be NULL for basic validation)
- * @param out_validation Output: Validation result (caller must free extracted_json with rac_free)
+ * @param out_validation Output: Validation result (caller must free with
+ *                       rac_structured_output_validation_free)
  * @return RAC_SUCCESS on success, error code otherwise
  */
 RAC_API rac_result_t
@@ -134,6 +138,136 @@ rac_structured_output_validate(const char* text, const rac_structured_output_con
  */
 RAC_API void rac_structured_output_validation_free(rac_structured_output_validation_t* validation);
 
+// =============================================================================
+// INCREMENTAL JSON PARSER - Not part of the Swift source
+// =============================================================================
+
+/**
+ * @brief Incremental JSON parser state
+ */
+typedef enum rac_structured_output_stream_state {
+    /** No '{' or '[' seen yet (leading prose and code fences are skipped) */
+    RAC_STRUCTURED_OUTPUT_STREAM_SEARCHING = 0,
+    /** Inside the top-level value */
+    RAC_STRUCTURED_OUTPUT_STREAM_PARSING = 1,
+    /** Top-level value closed; further input is ignored */
+    RAC_STRUCTURED_OUTPUT_STREAM_COMPLETE = 2,
+    /** Mismatched bracket; further input is ignored */
+    RAC_STRUCTURED_OUTPUT_STREAM_ERROR = 3,
+} rac_structured_output_stream_state_t;
+
+/**
+ * @brief Called when a top-level object member has been fully received
+ *
+ * @param key Member name (raw, escapes left as generated)
+ * @param value_json Member value as JSON text
+ * @param user_data User-provided context
+ */
+typedef void (*rac_structured_output_field_fn)(const char* key, const char* value_json,
+                                               void* user_data);
+
+/**
+ * @brief Opaque handle for an incremental JSON parser
+ */
+typedef struct rac_structured_output_stream* rac_structured_output_stream_t;
+
+/**
+ * @brief Create an incremental JSON parser
+ *
+ * Feed it the tokens of a streaming generation; each byte is examined once.
+ * When rac_structured_output_stream_feed reports COMPLETE, return RAC_FALSE
+ * from the token callback to stop generating.
+ *
+ * @param on_field Called per completed top-level member (can be NULL)
+ * @param user_data User context passed to on_field
+ * @param out_stream Output: Parser handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_structured_output_stream_create(rac_structured_output_field_fn on_field,
+                                                         void* user_data,
+                                                         rac_structured_output_stream_t* out_stream);
+
+/**
+ * @brief Feed generated text
+ *
+ * @param stream Parser handle
+ * @param text Text chunk (e.g. one token)
+ * @param length Chunk length in bytes
+ * @param out_state Output: State after this chunk (can be NULL)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_structured_output_stream_feed(rac_structured_output_stream_t stream,
+                                                       const char* text, size_t length,
+                                                       rac_structured_output_stream_state_t* out_state);
+
+/**
+ * @brief Get the JSON received so far
+ *
+ * @param stream Parser handle
+ * @param out_json Output: JSON text from the opening bracket, complete once the
+ *                 state is COMPLETE (caller must free with rac_free)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_structured_output_stream_get_json(rac_structured_output_stream_t stream,
+                                                           char** out_json);
+
+/**
+ * @brief Reset the parser for a new generation
+ *
+ * @param stream Parser handle
+ */
+RAC_API void rac_structured_output_stream_reset(rac_structured_output_stream_t stream);
+
+/**
+ * @brief Destroy an incremental JSON parser
+ *
+ * @param stream Parser handle
+ */
+RAC_API void rac_structured_output_stream_destroy(rac_structured_output_stream_t stream);
+
+// =============================================================================
+// SCHEMA VALIDATION - Not part of the Swift source
+// =============================================================================
+
+/**
+ * @brief Hash identifying a schema in the compiled-schema caches
+ *
+ * 64-bit FNV-1a of the schema text. Compiled validators and the llama.cpp
+ * backend's compiled grammars are both cached under this key.
+ *
+ * @param json_schema JSON schema text
+ * @return Hash of the schema (0xcbf29ce484222325 for NULL or "")
+ */
+RAC_API uint64_t rac_structured_output_schema_hash(const char* json_schema);
+
+/**
+ * @brief Validate JSON against a JSON schema
+ *
+ * The schema is compiled on first use and cached (LRU, by
+ * rac_structured_output_schema_hash); later calls with the same schema only
+ * parse and walk the JSON. Supports the common keywords (type, enum, const,
+ * numeric and length bounds, items, properties, required,
+ * additionalProperties, allOf/anyOf/oneOf/not and local $ref); pattern,
+ * format, patternProperties and propertyNames are not enforced, and
+ * additionalProperties is ignored where patternProperties is present.
+ *
+ * @param json JSON text
+ * @param length Length of json in bytes
+ * @param json_schema JSON schema text
+ * @param out_valid Output: RAC_TRUE if json is valid JSON matching the schema
+ * @param out_error Output: Why validation failed, e.g. "$.items[2].id: expected
+ *                  integer, got string" (caller must free with rac_free; can be NULL)
+ * @return RAC_SUCCESS, or RAC_ERROR_INVALID_ARGUMENT if the schema is invalid
+ */
+RAC_API rac_result_t rac_structured_output_validate_json(const char* json, size_t length,
+                                                         const char* json_schema,
+                                                         rac_bool_t* out_valid, char** out_error);
+
+/**
+ * @brief Drop all compiled schemas
+ */
+RAC_API void rac_structured_output_schema_cache_clear(void);
+
 #ifdef __cplusplus
 }
 #endif
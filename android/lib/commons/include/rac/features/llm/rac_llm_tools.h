@@ -0,0 +1,167 @@
+/**
+ * @file rac_llm_tools.h
+ * @brief RunAnywhere Commons - LLM Tool Calling
+ *
+ * Tools are registered once as a toolset, which prepares the instructions
+ * that describe them to the model and a combined JSON schema that a grammar
+ * backend compiles once and caches. Generation with a toolset watches the
+ * token stream for a tool call: prose before it is streamed as usual, the
+ * call itself is parsed as it arrives, and generation stops as soon as the
+ * call's arguments close, so the caller can dispatch the tool without
+ * waiting for the rest of the response or paying for tokens after it.
+ *
+ * The model calls a tool by writing
+ *
+ *   <tool_call>{"name": "<tool>", "arguments": {...}}</tool_call>
+ *
+ * With RAC_LLM_TOOL_CHOICE_REQUIRED the output is constrained to the bare
+ * JSON object instead, and a tool call is the only possible response.
+ */
+
+#ifndef RAC_LLM_TOOLS_H
+#define RAC_LLM_TOOLS_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+#include "rac/features/llm/rac_llm_component.h"
+#include "rac/features/llm/rac_llm_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief A tool the model can call
+ */
+typedef struct rac_llm_tool {
+    /** Tool name, unique within a toolset */
+    const char* name;
+
+    /** What the tool does, shown to the model (can be NULL) */
+    const char* description;
+
+    /** JSON schema of the arguments object (NULL = any object) */
+    const char* parameters_schema;
+} rac_llm_tool_t;
+
+/**
+ * @brief Whether the model may answer without calling a tool
+ */
+typedef enum rac_llm_tool_choice {
+    /** Prose or a tool call, as the model decides */
+    RAC_LLM_TOOL_CHOICE_AUTO = 0,
+    /** Exactly one tool call, enforced by the JSON schema grammar */
+    RAC_LLM_TOOL_CHOICE_REQUIRED = 1,
+} rac_llm_tool_choice_t;
+
+/**
+ * @brief Opaque handle for a registered set of tools
+ */
+typedef struct rac_llm_toolset* rac_llm_toolset_t;
+
+/**
+ * @brief Called once when the model has made a complete tool call
+ *
+ * Generation has already been asked to stop; no further tokens follow.
+ *
+ * @param name Name of a tool in the toolset
+ * @param arguments_json Arguments as JSON text
+ * @param user_data User-provided context
+ */
+typedef void (*rac_llm_tool_call_fn)(const char* name, const char* arguments_json,
+                                     void* user_data);
+
+// =============================================================================
+// TOOLSET API
+// =============================================================================
+
+/**
+ * @brief Register a set of tools
+ *
+ * Strings are copied. The instructions and the combined schema are built
+ * here, once, rather than for every generation.
+ *
+ * @param tools Tool definitions
+ * @param num_tools Number of tools (at least 1)
+ * @param out_toolset Output: Toolset handle (destroy with rac_llm_toolset_destroy)
+ * @return RAC_SUCCESS, RAC_ERROR_INVALID_ARGUMENT if a name is missing or
+ *         repeated, or RAC_ERROR_OUT_OF_MEMORY
+ */
+RAC_API rac_result_t rac_llm_toolset_create(const rac_llm_tool_t* tools, size_t num_tools,
+                                            rac_llm_toolset_t* out_toolset);
+
+/**
+ * @brief Get the instructions that describe the tools to the model
+ *
+ * rac_llm_component_generate_with_tools puts them before the prompt; use
+ * this to place them elsewhere, e.g. in a system turn.
+ *
+ * @param toolset Toolset handle
+ * @param choice Tool choice the instructions are written for
+ * @return Instructions (owned by the toolset), or NULL for a NULL toolset
+ */
+RAC_API const char* rac_llm_toolset_get_prompt(rac_llm_toolset_t toolset,
+                                               rac_llm_tool_choice_t choice);
+
+/**
+ * @brief Get the combined JSON schema that RAC_LLM_TOOL_CHOICE_REQUIRED uses
+ *
+ * One object per tool with "name" fixed to the tool's name and "arguments"
+ * following its parameters schema.
+ *
+ * @param toolset Toolset handle
+ * @return JSON schema (owned by the toolset), or NULL for a NULL toolset
+ */
+RAC_API const char* rac_llm_toolset_get_schema(rac_llm_toolset_t toolset);
+
+/**
+ * @brief Destroy a toolset
+ *
+ * @param toolset Toolset handle
+ */
+RAC_API void rac_llm_toolset_destroy(rac_llm_toolset_t toolset);
+
+// =============================================================================
+// GENERATION API
+// =============================================================================
+
+/**
+ * @brief Generate with tools, stopping at the first tool call
+ *
+ * Text before a tool call is passed to token_callback; the call markup
+ * itself is not. When the call's arguments close, tool_call_callback runs
+ * and generation stops; complete_callback then reports the tokens generated
+ * up to that point, with text NULL. A response without a tool call
+ * completes normally. A call to a tool that is not in the toolset, or one
+ * that is not valid JSON, ends with RAC_ERROR_INVALID_FORMAT.
+ *
+ * @param handle LLM component handle
+ * @param toolset Toolset handle
+ * @param prompt Input prompt (the tool instructions are put before it)
+ * @param options Generation options (NULL for defaults; json_schema is
+ *                replaced by the toolset's schema for REQUIRED)
+ * @param choice Tool choice
+ * @param token_callback Called for each prose token (can be NULL)
+ * @param tool_call_callback Called for the tool call (can be NULL)
+ * @param complete_callback Called when generation completes (can be NULL)
+ * @param error_callback Called on error (can be NULL)
+ * @param user_data User context passed to callbacks
+ * @return RAC_SUCCESS (also when generation stopped for a tool call) or error code
+ */
+RAC_API rac_result_t rac_llm_component_generate_with_tools(
+    rac_handle_t handle, rac_llm_toolset_t toolset, const char* prompt,
+    const rac_llm_options_t* options, rac_llm_tool_choice_t choice,
+    rac_llm_component_token_callback_fn token_callback,
+    rac_llm_tool_call_fn tool_call_callback,
+    rac_llm_component_complete_callback_fn complete_callback,
+    rac_llm_component_error_callback_fn error_callback, void* user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_LLM_TOOLS_H */
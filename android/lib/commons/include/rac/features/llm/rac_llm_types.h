@@ -13,6 +13,8 @@
 #ifndef RAC_LLM_TYPES_H
 #define RAC_LLM_TYPES_H
 
+#include "rac/core/rac_image_kernels.h"
+#include "rac/core/rac_memory_watermark.h"
 #include "rac/core/rac_types.h"
 
 #ifdef __cplusplus
@@ -93,6 +95,69 @@ typedef struct rac_llm_options {
 
     /** System prompt (can be NULL) */
     const char* system_prompt;
+
+    /**
+     * JSON schema the output must match (can be NULL). Backends with grammar
+     * support (llama.cpp) enforce it during sampling; others ignore it.
+     */
+    const char* json_schema;
+
+    /**
+     * Regenerate the prompt's last token so the reply can continue a partial
+     * word naturally (default: false). Only applies when the prompt does not
+     * end in a control token; llama.cpp only.
+     */
+    rac_bool_t token_healing;
+
+    /**
+     * LoRA adapter for this request, by the name it was loaded under
+     * (rac_llm_component_load_lora). NULL uses the component's current
+     * adapter (rac_llm_component_set_lora); "" runs the base model.
+     * llama.cpp only.
+     */
+    const char* lora_adapter;
+
+    /** Scale of lora_adapter (0 = 1.0) */
+    float lora_scale;
+
+    /**
+     * Prompt lookup decoding (default: false). Each step proposes the tokens
+     * that followed the latest earlier occurrence of the last few tokens in
+     * the prompt or reply, and verifies them in the same decode. Faster for
+     * replies that copy from the prompt (summaries, extraction, rewriting);
+     * the output is unchanged. Needs no draft model; llama.cpp only.
+     */
+    rac_bool_t prompt_lookup;
+
+    /**
+     * Samples rac_llm_generate_samples draws (0 = 1). The prompt is prefilled
+     * once and shared by all of them; other generate calls ignore this.
+     */
+    int32_t n_samples;
+
+    /**
+     * Time budgets in milliseconds from the call, 0 = none (llama.cpp only).
+     * max_prefill_ms bounds the wait for the first token; a prompt whose
+     * prefill is projected to overrun it stops before it is decoded, so the
+     * caller can retry with a shorter prompt or a smaller model at once.
+     * max_total_ms bounds the whole reply. Either ends the reply early with
+     * stop_reason set; the call still succeeds.
+     */
+    int32_t max_prefill_ms;
+    int32_t max_total_ms;
+
+    /** Stop once decoding runs slower than this (0 = no minimum) */
+    float min_tokens_per_second;
+
+    /**
+     * Images the prompt asks about (can be NULL). Each goes where the prompt
+     * has llama.cpp's media marker "<__media__>", or ahead of the prompt when
+     * it has none. Embeddings are cached by image content, so follow-up
+     * questions about the same image skip the vision encoder. llama.cpp with
+     * a vision projector (mmproj) only; other backends ignore them.
+     */
+    const rac_image_t* images;
+    size_t num_images;
 } rac_llm_options_t;
 
 /**
@@ -104,12 +169,39 @@ static const rac_llm_options_t RAC_LLM_OPTIONS_DEFAULT = {.max_tokens = 100,
                                                           .stop_sequences = RAC_NULL,
                                                           .num_stop_sequences = 0,
                                                           .streaming_enabled = RAC_FALSE,
-                                                          .system_prompt = RAC_NULL};
+                                                          .system_prompt = RAC_NULL,
+                                                          .json_schema = RAC_NULL,
+                                                          .token_healing = RAC_FALSE,
+                                                          .lora_adapter = RAC_NULL,
+                                                          .lora_scale = 0.0f,
+                                                          .prompt_lookup = RAC_FALSE,
+                                                          .n_samples = 0,
+                                                          .max_prefill_ms = 0,
+                                                          .max_total_ms = 0,
+                                                          .min_tokens_per_second = 0.0f,
+                                                          .images = RAC_NULL,
+                                                          .num_images = 0};
 
 // =============================================================================
 // RESULT - Mirrors Swift's LLMGenerationResult
 // =============================================================================
 
+/**
+ * @brief Why a generation stopped
+ */
+typedef enum rac_llm_stop_reason {
+    /** End-of-generation token or stop sequence */
+    RAC_LLM_STOP_REASON_END = 0,
+    /** max_tokens (or the context) reached */
+    RAC_LLM_STOP_REASON_MAX_TOKENS = 1,
+    /** max_prefill_ms passed, or was projected to pass, before the first token */
+    RAC_LLM_STOP_REASON_PREFILL_DEADLINE = 2,
+    /** max_total_ms passed */
+    RAC_LLM_STOP_REASON_DEADLINE = 3,
+    /** Decoding ran slower than min_tokens_per_second */
+    RAC_LLM_STOP_REASON_TOO_SLOW = 4,
+} rac_llm_stop_reason_t;
+
 /**
  * @brief LLM generation result
  */
@@ -134,8 +226,52 @@ typedef struct rac_llm_result {
 
     /** Tokens per second */
     float tokens_per_second;
+
+    /** Memory used by the call (set by rac_llm_component_*) */
+    rac_inference_memory_t memory;
+
+    /** Why generation stopped */
+    rac_llm_stop_reason_t stop_reason;
 } rac_llm_result_t;
 
+/**
+ * @brief One reply drawn by rac_llm_generate_samples
+ */
+typedef struct rac_llm_sample {
+    /** Generated text (owned, freed by rac_llm_samples_free) */
+    char* text;
+
+    /** Number of tokens generated */
+    int32_t completion_tokens;
+
+    /** Sum of the model's log-probabilities of the generated tokens, before
+        temperature and top-k/top-p (0 if the backend does not report them) */
+    double logprob;
+
+    /** logprob / completion_tokens, to compare replies of different lengths */
+    double mean_logprob;
+
+    /** RAC_TRUE if the reply was cut off at max_tokens */
+    rac_bool_t truncated;
+} rac_llm_sample_t;
+
+/**
+ * @brief Replies drawn by rac_llm_generate_samples
+ */
+typedef struct rac_llm_samples {
+    /** Replies, in the order they were drawn (owned) */
+    rac_llm_sample_t* samples;
+
+    /** Number of replies */
+    int32_t num_samples;
+
+    /** Number of tokens in the shared prompt */
+    int32_t prompt_tokens;
+
+    /** Total time for all replies in milliseconds */
+    int64_t total_time_ms;
+} rac_llm_samples_t;
+
 // =============================================================================
 // INFO - Mirrors Swift's LLMService properties
 // =============================================================================
@@ -159,6 +295,64 @@ typedef struct rac_llm_info {
     rac_bool_t supports_streaming;
 } rac_llm_info_t;
 
+/**
+ * @brief Memory held by a loaded LLM, in bytes
+ *
+ * Weights mapped from the model file only cost the resident pages; everything
+ * else is heap. Estimates are marked as such.
+ */
+typedef struct rac_llm_memory_usage {
+    /** Model tensor data */
+    int64_t model_bytes;
+
+    /** Size of the model file mapping (0 if the model is not memory-mapped) */
+    int64_t model_mapped_bytes;
+
+    /** Resident pages of the model file mapping */
+    int64_t model_resident_bytes;
+
+    /** KV cache allocated for the full context */
+    int64_t kv_cache_bytes;
+
+    /** KV state currently in use */
+    int64_t kv_used_bytes;
+
+    /** Output and compute buffers (estimate) */
+    int64_t compute_bytes;
+
+    /** Sampler state (estimate) */
+    int64_t sampler_bytes;
+
+    /** Draft model for speculative decoding, 0 if none */
+    int64_t draft_bytes;
+
+    /** Vision projector and cached image embeddings, 0 if none */
+    int64_t vision_bytes;
+
+    /** Bytes the model actually costs: resident weights plus all heap buffers */
+    int64_t total_bytes;
+
+    /** Current context size in tokens */
+    int32_t context_size;
+} rac_llm_memory_usage_t;
+
+/**
+ * @brief Memory pressure levels for rac_llm_component_handle_memory_pressure
+ *
+ * Android's ComponentCallbacks2.onTrimMemory levels map as:
+ * RUNNING_MODERATE -> MODERATE, RUNNING_LOW / UI_HIDDEN -> LOW,
+ * RUNNING_CRITICAL / BACKGROUND and above -> CRITICAL.
+ */
+typedef enum rac_llm_memory_pressure {
+    RAC_LLM_MEMORY_PRESSURE_NONE = 0,
+    /** Drop caches that are cheap to rebuild (prefix KV, pooled samplers) */
+    RAC_LLM_MEMORY_PRESSURE_MODERATE = 1,
+    /** Also shrink the context */
+    RAC_LLM_MEMORY_PRESSURE_LOW = 2,
+    /** Unload the model */
+    RAC_LLM_MEMORY_PRESSURE_CRITICAL = 3,
+} rac_llm_memory_pressure_t;
+
 // =============================================================================
 // CALLBACKS
 // =============================================================================
@@ -175,6 +369,20 @@ typedef struct rac_llm_info {
  */
 typedef rac_bool_t (*rac_llm_stream_callback_fn)(const char* token, void* user_data);
 
+/**
+ * @brief LLM batch result callback
+ *
+ * Called once per prompt as it finishes, in completion order. Calls are
+ * serialized but may come from backend worker threads.
+ *
+ * @param index Index of the prompt in the batch
+ * @param status RAC_SUCCESS, RAC_ERROR_CANCELLED, or the generation error
+ * @param result Generation result (valid only during the call, NULL on error)
+ * @param user_data User-provided context
+ */
+typedef void (*rac_llm_batch_callback_fn)(size_t index, rac_result_t status,
+                                          const rac_llm_result_t* result, void* user_data);
+
 // =============================================================================
 // THINKING TAG PATTERN - Mirrors Swift's ThinkingTagPattern
 // =============================================================================
@@ -377,6 +585,13 @@ typedef struct rac_llm_stream_result {
  */
 RAC_API void rac_llm_result_free(rac_llm_result_t* result);
 
+/**
+ * @brief Free the replies of rac_llm_generate_samples and zero the struct
+ *
+ * @param samples Samples to free (can be NULL)
+ */
+RAC_API void rac_llm_samples_free(rac_llm_samples_t* samples);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,148 @@
+/**
+ * @file rac_llm_vector_index.h
+ * @brief RunAnywhere Commons - On-Device Vector Index
+ *
+ * Compact index over embedding vectors (see rac_llm_llamacpp_embed) for
+ * retrieval without leaving the process. Vectors live in a memory-mapped file
+ * under the model paths base directory and are appended in place.
+ *
+ * Scores are inner products, so vectors should be L2-normalized for cosine
+ * similarity. Small indexes are searched with a flat scan; once an index holds
+ * ivf_threshold vectors, an IVF (inverted file) partition is trained and only
+ * the ivf_nprobe closest lists are scanned. The partition is kept in memory and
+ * retrained on open and whenever the index doubles in size.
+ */
+
+#ifndef RAC_LLM_VECTOR_INDEX_H
+#define RAC_LLM_VECTOR_INDEX_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Vector index configuration
+ */
+typedef struct rac_vector_index_config {
+    /** Floats per vector (0 = take it from an existing index file) */
+    int32_t dimension;
+
+    /** Vector count from which searches use IVF (0 = always flat) */
+    int32_t ivf_threshold;
+
+    /** IVF lists scanned per query; higher is more accurate and slower */
+    int32_t ivf_nprobe;
+} rac_vector_index_config_t;
+
+/**
+ * @brief Default vector index configuration
+ */
+static const rac_vector_index_config_t RAC_VECTOR_INDEX_CONFIG_DEFAULT = {
+    .dimension = 0, .ivf_threshold = 4096, .ivf_nprobe = 8};
+
+/**
+ * @brief A search hit
+ */
+typedef struct rac_vector_match {
+    /** Caller-assigned id of the vector */
+    uint64_t id;
+    /** Inner product with the query */
+    float score;
+} rac_vector_match_t;
+
+/**
+ * @brief Opaque handle for a vector index
+ */
+typedef struct rac_vector_index* rac_vector_index_handle_t;
+
+// =============================================================================
+// VECTOR INDEX API
+// =============================================================================
+
+/**
+ * @brief Open or create a vector index
+ *
+ * A plain name resolves to `{base_dir}/RunAnywhere/Indexes/{name}.rvi`
+ * (requires rac_model_paths_set_base_dir); an absolute path is used as is.
+ *
+ * @param name Index name or absolute file path
+ * @param config Configuration (dimension is required for a new index)
+ * @param out_handle Output: Index handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vector_index_open(const char* name, const rac_vector_index_config_t* config,
+                                           rac_vector_index_handle_t* out_handle);
+
+/**
+ * @brief Flush and close a vector index
+ *
+ * @param handle Index handle
+ */
+RAC_API void rac_vector_index_close(rac_vector_index_handle_t handle);
+
+/**
+ * @brief Append vectors
+ *
+ * @param handle Index handle
+ * @param ids One id per vector
+ * @param vectors count * dimension floats, row by row
+ * @param count Number of vectors
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vector_index_add(rac_vector_index_handle_t handle, const uint64_t* ids,
+                                          const float* vectors, size_t count);
+
+/**
+ * @brief Find the vectors with the highest inner product with a query
+ *
+ * @param handle Index handle
+ * @param query dimension floats
+ * @param k Maximum number of matches
+ * @param out_matches Output: Up to k matches, best first
+ * @param out_count Output: Number of matches written
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vector_index_search(rac_vector_index_handle_t handle, const float* query,
+                                             size_t k, rac_vector_match_t* out_matches,
+                                             size_t* out_count);
+
+/**
+ * @brief Get the number of vectors held
+ *
+ * @param handle Index handle
+ * @param out_count Output: Vector count
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vector_index_get_count(rac_vector_index_handle_t handle,
+                                                size_t* out_count);
+
+/**
+ * @brief Get the vector dimension
+ *
+ * @param handle Index handle
+ * @param out_dimension Output: Floats per vector
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vector_index_get_dimension(rac_vector_index_handle_t handle,
+                                                    int32_t* out_dimension);
+
+/**
+ * @brief Write pending changes to the index file
+ *
+ * @param handle Index handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vector_index_flush(rac_vector_index_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_LLM_VECTOR_INDEX_H */
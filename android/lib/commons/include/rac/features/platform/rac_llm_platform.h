@@ -90,6 +90,38 @@ typedef rac_result_t (*rac_platform_llm_generate_fn)(rac_handle_t handle, const
                                                      const rac_llm_platform_options_t* options,
                                                      char** out_response, void* user_data);
 
+/**
+ * Receives one streamed chunk of generated text.
+ *
+ * Has the signature of rac_llm_stream_callback_fn, so the SDK hands the
+ * caller's stream callback straight to Swift: chunks reach it without any
+ * copy, lock or allocation in between.
+ *
+ * @param chunk NUL-terminated text, valid only during the call
+ * @param context Context passed to generate_stream
+ * @return RAC_TRUE to continue, RAC_FALSE to stop generation
+ */
+typedef rac_bool_t (*rac_platform_llm_chunk_fn)(const char* chunk, void* context);
+
+/**
+ * Callback to stream generated text.
+ * Implemented in Swift.
+ *
+ * Calls on_chunk for each chunk on the calling thread and returns when
+ * generation finishes or on_chunk returns RAC_FALSE.
+ *
+ * @param handle Service handle from create
+ * @param prompt Input prompt
+ * @param options Generation options
+ * @param on_chunk Chunk callback
+ * @param chunk_context Context for on_chunk
+ * @param user_data User-provided context
+ * @return RAC_SUCCESS or error code
+ */
+typedef rac_result_t (*rac_platform_llm_generate_stream_fn)(
+    rac_handle_t handle, const char* prompt, const rac_llm_platform_options_t* options,
+    rac_platform_llm_chunk_fn on_chunk, void* chunk_context, void* user_data);
+
 /**
  * Callback to destroy platform LLM service.
  * Implemented in Swift.
@@ -108,6 +140,8 @@ typedef struct rac_platform_llm_callbacks {
     rac_platform_llm_generate_fn generate;
     rac_platform_llm_destroy_fn destroy;
     void* user_data;
+    /** Optional; without it streams are delivered as one chunk */
+    rac_platform_llm_generate_stream_fn generate_stream;
 } rac_platform_llm_callbacks_t;
 
 // =============================================================================
@@ -118,6 +152,10 @@ typedef struct rac_platform_llm_callbacks {
  * Sets the Swift callbacks for platform LLM operations.
  * Must be called before using platform LLM services.
  *
+ * The callbacks are published as one immutable table, so calls into Swift
+ * take no lock. Services created before a replacement keep working; tables
+ * that were replaced stay allocated for the life of the process.
+ *
  * @param callbacks Callback functions (copied internally)
  * @return RAC_SUCCESS on success
  */
@@ -126,7 +164,8 @@ RAC_API rac_result_t rac_platform_llm_set_callbacks(const rac_platform_llm_callb
 /**
  * Gets the current Swift callbacks.
  *
- * @return Pointer to callbacks, or NULL if not set
+ * @return Pointer to callbacks, or NULL if not set. Stays valid for the life
+ * of the process.
  */
 RAC_API const rac_platform_llm_callbacks_t* rac_platform_llm_get_callbacks(void);
 
@@ -173,6 +212,25 @@ RAC_API rac_result_t rac_llm_platform_generate(rac_llm_platform_handle_t handle,
                                                const rac_llm_platform_options_t* options,
                                                char** out_response);
 
+/**
+ * Streams text using platform LLM.
+ *
+ * Chunks go from Swift to callback directly. If Swift did not register
+ * generate_stream, the full response is delivered as a single chunk.
+ *
+ * @param handle Service handle
+ * @param prompt Input prompt
+ * @param options Generation options (can be NULL for defaults)
+ * @param callback Called with each chunk; return RAC_FALSE to stop
+ * @param user_data User context passed to callback
+ * @return RAC_SUCCESS on success, or error code
+ */
+RAC_API rac_result_t rac_llm_platform_generate_stream(rac_llm_platform_handle_t handle,
+                                                      const char* prompt,
+                                                      const rac_llm_platform_options_t* options,
+                                                      rac_platform_llm_chunk_fn callback,
+                                                      void* user_data);
+
 // =============================================================================
 // BACKEND REGISTRATION
 // =============================================================================
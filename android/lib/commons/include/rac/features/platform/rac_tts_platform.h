@@ -15,6 +15,7 @@
 #define RAC_TTS_PLATFORM_H
 
 #include "rac/core/rac_types.h"
+#include "rac/features/tts/rac_tts_types.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -94,6 +95,38 @@ typedef rac_result_t (*rac_platform_tts_synthesize_fn)(rac_handle_t handle, cons
                                                        const rac_tts_platform_options_t* options,
                                                        void* user_data);
 
+/**
+ * Receives one buffer of synthesized audio.
+ *
+ * @param samples Float32 mono samples, valid only during the call
+ * @param sample_count Number of samples
+ * @param sample_rate Sample rate of samples in Hz
+ * @param context Context passed to synthesize_stream
+ */
+typedef void (*rac_platform_tts_audio_fn)(const float* samples, size_t sample_count,
+                                          int32_t sample_rate, void* context);
+
+/**
+ * Callback to synthesize speech into audio buffers instead of playing it.
+ * Implemented in Swift (AVSpeechSynthesizer.write).
+ *
+ * Calls on_audio for each buffer as the synthesizer produces it, on any
+ * thread but never concurrently, and returns once the utterance is finished
+ * or stopped. Buffers the synthesizer delivers as Int16 are converted to
+ * Float32 in Swift.
+ *
+ * @param handle Service handle from create
+ * @param text Text to synthesize
+ * @param options Synthesis options
+ * @param on_audio Audio callback
+ * @param audio_context Context for on_audio
+ * @param user_data User-provided context
+ * @return RAC_SUCCESS or error code
+ */
+typedef rac_result_t (*rac_platform_tts_synthesize_stream_fn)(
+    rac_handle_t handle, const char* text, const rac_tts_platform_options_t* options,
+    rac_platform_tts_audio_fn on_audio, void* audio_context, void* user_data);
+
 /**
  * Callback to stop speech.
  * Implemented in Swift.
@@ -122,6 +155,8 @@ typedef struct rac_platform_tts_callbacks {
     rac_platform_tts_stop_fn stop;
     rac_platform_tts_destroy_fn destroy;
     void* user_data;
+    /** Optional; without it streaming synthesis plays through the speaker */
+    rac_platform_tts_synthesize_stream_fn synthesize_stream;
 } rac_platform_tts_callbacks_t;
 
 // =============================================================================
@@ -132,6 +167,10 @@ typedef struct rac_platform_tts_callbacks {
  * Sets the Swift callbacks for platform TTS operations.
  * Must be called before using platform TTS services.
  *
+ * The callbacks are published as one immutable table, so calls into Swift
+ * take no lock and stop can interrupt a synthesis in progress. Tables that
+ * were replaced stay allocated for the life of the process.
+ *
  * @param callbacks Callback functions (copied internally)
  * @return RAC_SUCCESS on success
  */
@@ -140,7 +179,8 @@ RAC_API rac_result_t rac_platform_tts_set_callbacks(const rac_platform_tts_callb
 /**
  * Gets the current Swift callbacks.
  *
- * @return Pointer to callbacks, or NULL if not set
+ * @return Pointer to callbacks, or NULL if not set. Stays valid for the life
+ * of the process.
  */
 RAC_API const rac_platform_tts_callbacks_t* rac_platform_tts_get_callbacks(void);
 
@@ -183,6 +223,29 @@ RAC_API void rac_tts_platform_destroy(rac_tts_platform_handle_t handle);
 RAC_API rac_result_t rac_tts_platform_synthesize(rac_tts_platform_handle_t handle, const char* text,
                                                  const rac_tts_platform_options_t* options);
 
+/**
+ * Synthesizes speech into a stream of audio chunks.
+ *
+ * Each buffer from the system synthesizer is forwarded as Float32 mono PCM
+ * as soon as it is produced, resampled to sample_rate if the voice renders
+ * at another rate. Without a Swift synthesize_stream callback the text is
+ * spoken aloud instead and no chunks are delivered.
+ *
+ * @param handle Service handle
+ * @param text Text to synthesize
+ * @param options Synthesis options (can be NULL for defaults)
+ * @param sample_rate Output sample rate in Hz (0 = the voice's own rate)
+ * @param callback Called with each chunk (audio_size in bytes)
+ * @param user_data User context passed to callback
+ * @return RAC_SUCCESS on success, or error code
+ */
+RAC_API rac_result_t rac_tts_platform_synthesize_stream(rac_tts_platform_handle_t handle,
+                                                        const char* text,
+                                                        const rac_tts_platform_options_t* options,
+                                                        int32_t sample_rate,
+                                                        rac_tts_stream_callback_t callback,
+                                                        void* user_data);
+
 /**
  * Stops current speech synthesis.
  *
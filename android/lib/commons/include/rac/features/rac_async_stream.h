@@ -0,0 +1,207 @@
+/**
+ * @file rac_async_stream.h
+ * @brief RunAnywhere Commons - Asynchronous Streaming for FFI Listeners
+ *
+ * Fire-and-forget variants of the LLM, STT and TTS streaming calls for
+ * bindings whose callbacks are delivered asynchronously on another event
+ * loop, such as Dart's NativeCallable.listener. Each call copies its inputs,
+ * returns immediately, and runs the inference on a native worker thread.
+ * Every token, partial transcript and audio chunk is handed to the listener
+ * as a self-contained heap event that the receiver owns and frees with
+ * rac_async_event_free; the worker never waits for the receiver, so a slow
+ * event loop delays delivery but never inference.
+ *
+ * Each stream ends with exactly one COMPLETE or ERROR event, also after a
+ * cancel. The component must not be destroyed before that event arrives.
+ */
+
+#ifndef RAC_ASYNC_STREAM_H
+#define RAC_ASYNC_STREAM_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+#include "rac/features/llm/rac_llm_tools.h"
+#include "rac/features/llm/rac_llm_types.h"
+#include "rac/features/stt/rac_stt_types.h"
+#include "rac/features/tts/rac_tts_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Kind of an asynchronous stream event
+ */
+typedef enum rac_async_event_type {
+    RAC_ASYNC_EVENT_TOKEN = 0,              /**< LLM token in text */
+    RAC_ASYNC_EVENT_PARTIAL_TRANSCRIPT = 1, /**< STT partial transcript in text */
+    RAC_ASYNC_EVENT_FINAL_TRANSCRIPT = 2,   /**< STT final transcript in text */
+    RAC_ASYNC_EVENT_AUDIO_CHUNK = 3,        /**< TTS audio in audio_data */
+    RAC_ASYNC_EVENT_COMPLETE = 4,           /**< Stream finished; LLM metrics filled */
+    RAC_ASYNC_EVENT_ERROR = 5,              /**< Stream failed; error_code and text */
+    RAC_ASYNC_EVENT_TOOL_CALL = 6,          /**< LLM tool call in text, as
+                                                 {"name": ..., "arguments": ...} */
+} rac_async_event_type_t;
+
+/**
+ * @brief One asynchronous stream event
+ *
+ * A single allocation: text and audio_data point into the event itself, so
+ * the receiver frees everything with one rac_async_event_free call.
+ */
+typedef struct rac_async_event {
+    rac_async_event_type_t type;
+
+    /** Error code (ERROR events; RAC_ERROR_CANCELLED after a cancel) */
+    rac_result_t error_code;
+
+    /** Token, transcript, tool call or error message (NULL for audio chunks) */
+    const char* text;
+
+    /** Audio chunk bytes (AUDIO_CHUNK events) */
+    const void* audio_data;
+    size_t audio_size;
+
+    /** LLM generation metrics (COMPLETE events of LLM streams) */
+    int32_t prompt_tokens;
+    int32_t completion_tokens;
+    int64_t time_to_first_token_ms;
+    int64_t total_time_ms;
+    float tokens_per_second;
+    rac_llm_stop_reason_t stop_reason;
+} rac_async_event_t;
+
+/**
+ * @brief Listener for stream events
+ *
+ * Called on the worker thread and must return promptly; ownership of the
+ * event passes to the receiver. A NativeCallable.listener function pointer
+ * satisfies this directly, since it only posts the call to its isolate.
+ *
+ * @param event Event (free with rac_async_event_free)
+ * @param user_data User-provided context
+ */
+typedef void (*rac_async_listener_fn)(rac_async_event_t* event, void* user_data);
+
+/**
+ * @brief Opaque handle of a running stream
+ */
+typedef struct rac_async_stream rac_async_stream_t;
+
+// =============================================================================
+// STREAMING API
+// =============================================================================
+
+/**
+ * @brief Start streaming LLM generation
+ *
+ * @param handle LLM component handle
+ * @param prompt Input prompt (copied)
+ * @param options Generation options (NULL for defaults; strings are copied)
+ * @param listener Receives TOKEN events then COMPLETE or ERROR
+ * @param user_data User context passed to listener
+ * @param out_stream Output: Stream handle (release with rac_async_stream_release)
+ * @return RAC_SUCCESS or error code (no events are posted on failure)
+ */
+RAC_API rac_result_t rac_llm_component_generate_async(rac_handle_t handle, const char* prompt,
+                                                      const rac_llm_options_t* options,
+                                                      rac_async_listener_fn listener,
+                                                      void* user_data,
+                                                      rac_async_stream_t** out_stream);
+
+/**
+ * @brief Start streaming LLM generation with tools
+ *
+ * Runs rac_llm_component_generate_with_tools. A tool call arrives as one
+ * TOOL_CALL event, followed by COMPLETE. The toolset must not be destroyed
+ * before the final event arrives.
+ *
+ * @param handle LLM component handle
+ * @param toolset Toolset handle
+ * @param prompt Input prompt (copied)
+ * @param options Generation options (NULL for defaults; strings are copied)
+ * @param choice Tool choice
+ * @param listener Receives TOKEN events, at most one TOOL_CALL, then COMPLETE
+ *                 or ERROR
+ * @param user_data User context passed to listener
+ * @param out_stream Output: Stream handle (release with rac_async_stream_release)
+ * @return RAC_SUCCESS or error code (no events are posted on failure)
+ */
+RAC_API rac_result_t rac_llm_component_generate_with_tools_async(
+    rac_handle_t handle, rac_llm_toolset_t toolset, const char* prompt,
+    const rac_llm_options_t* options, rac_llm_tool_choice_t choice,
+    rac_async_listener_fn listener, void* user_data, rac_async_stream_t** out_stream);
+
+/**
+ * @brief Start streaming transcription of an audio buffer
+ *
+ * @param handle STT component handle
+ * @param audio_data Audio data (copied)
+ * @param audio_size Size of audio data in bytes
+ * @param options Transcription options (NULL for defaults; strings are copied)
+ * @param listener Receives transcript events then COMPLETE or ERROR
+ * @param user_data User context passed to listener
+ * @param out_stream Output: Stream handle (release with rac_async_stream_release)
+ * @return RAC_SUCCESS or error code (no events are posted on failure)
+ */
+RAC_API rac_result_t rac_stt_component_transcribe_async(rac_handle_t handle,
+                                                        const void* audio_data, size_t audio_size,
+                                                        const rac_stt_options_t* options,
+                                                        rac_async_listener_fn listener,
+                                                        void* user_data,
+                                                        rac_async_stream_t** out_stream);
+
+/**
+ * @brief Start streaming synthesis
+ *
+ * @param handle TTS component handle
+ * @param text Text to synthesize (copied)
+ * @param options Synthesis options (NULL for defaults; strings are copied)
+ * @param listener Receives AUDIO_CHUNK events then COMPLETE or ERROR
+ * @param user_data User context passed to listener
+ * @param out_stream Output: Stream handle (release with rac_async_stream_release)
+ * @return RAC_SUCCESS or error code (no events are posted on failure)
+ */
+RAC_API rac_result_t rac_tts_component_synthesize_async(rac_handle_t handle, const char* text,
+                                                        const rac_tts_options_t* options,
+                                                        rac_async_listener_fn listener,
+                                                        void* user_data,
+                                                        rac_async_stream_t** out_stream);
+
+/**
+ * @brief Ask a stream to stop
+ *
+ * Further token, transcript and audio events are dropped, LLM generation
+ * stops at the next token, and the stream ends with an ERROR event carrying
+ * RAC_ERROR_CANCELLED. Safe to call from any thread, any number of times.
+ *
+ * @param stream Stream handle
+ */
+RAC_API void rac_async_stream_cancel(rac_async_stream_t* stream);
+
+/**
+ * @brief Release the caller's reference to a stream
+ *
+ * Does not cancel; the stream keeps running and posting events. The handle
+ * must not be used afterwards.
+ *
+ * @param stream Stream handle
+ */
+RAC_API void rac_async_stream_release(rac_async_stream_t* stream);
+
+/**
+ * @brief Free an event received by a listener
+ *
+ * @param event Event to free
+ */
+RAC_API void rac_async_event_free(rac_async_event_t* event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_ASYNC_STREAM_H */
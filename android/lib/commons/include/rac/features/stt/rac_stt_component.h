@@ -105,6 +105,22 @@ RAC_API rac_result_t rac_stt_component_transcribe(rac_handle_t handle, const voi
                                                   const rac_stt_options_t* options,
                                                   rac_stt_result_t* out_result);
 
+/**
+ * @brief Transcribe an audio file from disk
+ *
+ * Streams the file in chunks cut at silence and transcribes them in parallel
+ * (see rac_stt_transcribe_file), so long recordings need not fit in memory.
+ *
+ * @param handle Component handle
+ * @param file_path WAV or headerless PCM16 file
+ * @param options Transcription options (can be NULL for defaults)
+ * @param out_result Output: Transcription result
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_stt_component_transcribe_file(rac_handle_t handle, const char* file_path,
+                                                       const rac_stt_options_t* options,
+                                                       rac_stt_result_t* out_result);
+
 /**
  * @brief Check if streaming is supported
  *
@@ -116,6 +116,26 @@ RAC_API rac_result_t rac_stt_transcribe_stream(rac_handle_t handle, const void*
                                                size_t audio_size, const rac_stt_options_t* options,
                                                rac_stt_stream_callback_t callback, void* user_data);
 
+/**
+ * @brief Transcribe an audio file in bounded memory
+ *
+ * Reads a WAV (PCM16 or Float32, any channel count) or headerless PCM16 file
+ * from disk and cuts it into chunks of at most 28 s, at silence where
+ * possible. Up to max_parallel chunks are transcribed through
+ * rac_stt_transcribe concurrently while the rest of the file is read; the
+ * merged result has word timestamps in file time.
+ *
+ * @param handle Service handle
+ * @param file_path Audio file path (headerless files use options->sample_rate)
+ * @param options Transcription options (can be NULL for defaults)
+ * @param max_parallel Chunks transcribed at once (0 = 2)
+ * @param out_result Output: Merged result (caller must free with rac_stt_result_free)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_stt_transcribe_file(rac_handle_t handle, const char* file_path,
+                                             const rac_stt_options_t* options,
+                                             int32_t max_parallel, rac_stt_result_t* out_result);
+
 /**
  * @brief Get service information
  *
@@ -16,6 +16,7 @@
 #ifndef RAC_STT_TYPES_H
 #define RAC_STT_TYPES_H
 
+#include "rac/core/rac_memory_watermark.h"
 #include "rac/core/rac_types.h"
 
 #ifdef __cplusplus
@@ -204,6 +205,9 @@ typedef struct rac_stt_result {
 
     /** Processing time in milliseconds */
     int64_t processing_time_ms;
+
+    /** Memory used by the call (set by rac_stt_component_*) */
+    rac_inference_memory_t memory;
 } rac_stt_result_t;
 
 // =============================================================================
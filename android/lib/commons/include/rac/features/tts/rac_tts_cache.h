@@ -0,0 +1,135 @@
+/**
+ * @file rac_tts_cache.h
+ * @brief RunAnywhere Commons - Synthesized Phrase Cache
+ *
+ * LRU cache of synthesized audio keyed by (voice, speed, normalized text), so
+ * short phrases an assistant repeats ("Message sent", "Opening app") play
+ * without running the model again. Text is normalized by trimming and
+ * collapsing whitespace; case is kept, since "US" and "us" sound different.
+ *
+ * Entries are evicted least-recently-used first once the memory budget is
+ * exceeded. With a disk directory, entries are also written there and read
+ * back on a memory miss, so they survive restarts.
+ *
+ * Float32 PCM is kept IMA-ADPCM compressed by default (8:1), both in memory
+ * and on disk, and decoded on lookup.
+ */
+
+#ifndef RAC_TTS_CACHE_H
+#define RAC_TTS_CACHE_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+#include "rac/features/tts/rac_tts_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Phrase cache configuration
+ */
+typedef struct rac_tts_cache_config {
+    /** Memory budget for cached audio in bytes (0 disables the cache) */
+    size_t max_memory_bytes;
+
+    /** Longest text in bytes worth caching; longer requests bypass the cache */
+    int32_t max_text_length;
+
+    /** Directory for on-disk persistence (NULL = memory only) */
+    const char* disk_directory;
+
+    /** Store Float32 PCM entries as IMA-ADPCM (8x smaller, speech quality) */
+    rac_bool_t compress_audio;
+} rac_tts_cache_config_t;
+
+/**
+ * @brief Default phrase cache configuration (4 MB compressed, memory only)
+ */
+static const rac_tts_cache_config_t RAC_TTS_CACHE_CONFIG_DEFAULT = {
+    .max_memory_bytes = 4 * 1024 * 1024,
+    .max_text_length = 128,
+    .disk_directory = RAC_NULL,
+    .compress_audio = RAC_TRUE};
+
+/**
+ * @brief Opaque handle for a phrase cache
+ */
+typedef struct rac_tts_cache* rac_tts_cache_handle_t;
+
+// =============================================================================
+// PHRASE CACHE API
+// =============================================================================
+
+/**
+ * @brief Create a phrase cache
+ *
+ * @param config Configuration (NULL for defaults)
+ * @param out_handle Output: Cache handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_tts_cache_create(const rac_tts_cache_config_t* config,
+                                          rac_tts_cache_handle_t* out_handle);
+
+/**
+ * @brief Look up cached audio
+ *
+ * @param handle Cache handle
+ * @param voice Voice key (NULL for the default voice)
+ * @param rate Speech rate the audio was synthesized at
+ * @param text Text to synthesize
+ * @param out_result Output: Copy of the cached audio, free with rac_tts_result_free
+ * @return RAC_SUCCESS on a hit, RAC_ERROR_NOT_FOUND on a miss
+ */
+RAC_API rac_result_t rac_tts_cache_lookup(rac_tts_cache_handle_t handle, const char* voice,
+                                          float rate, const char* text,
+                                          rac_tts_result_t* out_result);
+
+/**
+ * @brief Store synthesized audio
+ *
+ * No-op for text longer than max_text_length or audio larger than the budget
+ * (after compression).
+ *
+ * @param handle Cache handle
+ * @param voice Voice key (NULL for the default voice)
+ * @param rate Speech rate the audio was synthesized at
+ * @param text Text that was synthesized
+ * @param result Synthesis result to copy into the cache
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_tts_cache_store(rac_tts_cache_handle_t handle, const char* voice,
+                                         float rate, const char* text,
+                                         const rac_tts_result_t* result);
+
+/**
+ * @brief Drop every entry, including persisted ones
+ *
+ * @param handle Cache handle
+ */
+RAC_API void rac_tts_cache_clear(rac_tts_cache_handle_t handle);
+
+/**
+ * @brief Drop the in-memory entries, keeping persisted ones on disk
+ *
+ * @param handle Cache handle
+ * @return Bytes of audio released
+ */
+RAC_API int64_t rac_tts_cache_trim_memory(rac_tts_cache_handle_t handle);
+
+/**
+ * @brief Destroy a phrase cache (persisted entries are kept)
+ *
+ * @param handle Cache handle
+ */
+RAC_API void rac_tts_cache_destroy(rac_tts_cache_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_TTS_CACHE_H */
@@ -14,6 +14,7 @@
 
 #include "rac/core/capabilities/rac_lifecycle.h"
 #include "rac/core/rac_error.h"
+#include "rac/features/tts/rac_tts_cache.h"
 #include "rac/features/tts/rac_tts_types.h"
 
 #ifdef __cplusplus
@@ -44,6 +45,26 @@ RAC_API rac_result_t rac_tts_component_create(rac_handle_t* out_handle);
 RAC_API rac_result_t rac_tts_component_configure(rac_handle_t handle,
                                                  const rac_tts_config_t* config);
 
+/**
+ * @brief Configure the phrase cache used by rac_tts_component_synthesize
+ *
+ * The component starts with RAC_TTS_CACHE_CONFIG_DEFAULT (4 MB, memory only).
+ * Reconfiguring drops in-memory entries.
+ *
+ * @param handle Component handle
+ * @param config Cache configuration (NULL or max_memory_bytes 0 disables it)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_tts_component_configure_cache(rac_handle_t handle,
+                                                       const rac_tts_cache_config_t* config);
+
+/**
+ * @brief Drop every cached phrase, including persisted ones
+ *
+ * @param handle Component handle
+ */
+RAC_API void rac_tts_component_clear_cache(rac_handle_t handle);
+
 /**
  * @brief Check if voice is loaded
  *
@@ -111,6 +132,28 @@ RAC_API rac_result_t rac_tts_component_synthesize(rac_handle_t handle, const cha
                                                   const rac_tts_options_t* options,
                                                   rac_tts_result_t* out_result);
 
+/**
+ * @brief Synthesize text into a caller-provided buffer
+ *
+ * Writes Float32 PCM straight into buffer (e.g. a Java DirectByteBuffer), the
+ * only copy made of the backend's output.
+ *
+ * @param handle Component handle
+ * @param text Text to synthesize
+ * @param options Synthesis options (can be NULL for defaults)
+ * @param buffer Destination for the audio
+ * @param buffer_size Capacity of buffer in bytes
+ * @param out_audio_size Output: Bytes written, or bytes required when the
+ *        buffer is too small
+ * @param out_sample_rate Output: Sample rate of the audio (can be NULL)
+ * @return RAC_SUCCESS, RAC_ERROR_BUFFER_TOO_SMALL or error code
+ */
+RAC_API rac_result_t rac_tts_component_synthesize_into(rac_handle_t handle, const char* text,
+                                                       const rac_tts_options_t* options,
+                                                       void* buffer, size_t buffer_size,
+                                                       size_t* out_audio_size,
+                                                       int32_t* out_sample_rate);
+
 /**
  * @brief Synthesize text with streaming
  *
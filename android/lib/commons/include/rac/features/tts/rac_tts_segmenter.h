@@ -0,0 +1,142 @@
+/**
+ * @file rac_tts_segmenter.h
+ * @brief RunAnywhere Commons - Streaming TTS Text Segmenter and Normalizer
+ *
+ * Turns streamed LLM text into speakable sentences as tokens arrive, so
+ * synthesis of the first sentence can start while the rest is generated.
+ *
+ * A sentence ends at '.', '!' or '?' followed by whitespace, at CJK 。！？
+ * and at a newline. Abbreviations ("Dr.", "e.g."), initials and list
+ * numbers at the start of a line do not end a sentence; runs without
+ * punctuation are cut at a space once they reach max_sentence_chars.
+ *
+ * With normalization on, each sentence is rewritten for speech before it is
+ * emitted: markdown markup, fenced code blocks, link targets and emoji are
+ * removed, and numbers, currency, percentages, times, ordinals, common
+ * abbreviations and symbols are spelled out (English). Other text passes
+ * through unchanged. Sentences left with nothing speakable are dropped.
+ *
+ * The segmenter keeps its buffers between calls; steady-state feeding does
+ * not allocate.
+ */
+
+#ifndef RAC_TTS_SEGMENTER_H
+#define RAC_TTS_SEGMENTER_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Segmenter configuration
+ */
+typedef struct rac_tts_segmenter_config {
+    /** Pieces shorter than this are merged into the next sentence (bytes) */
+    int32_t min_sentence_chars;
+
+    /** Runs without sentence punctuation are cut at a space once this long (bytes) */
+    int32_t max_sentence_chars;
+
+    /** Rewrite sentences for speech (markdown, emoji, numbers, abbreviations) */
+    rac_bool_t normalize;
+} rac_tts_segmenter_config_t;
+
+/**
+ * @brief Default segmenter configuration
+ */
+static const rac_tts_segmenter_config_t RAC_TTS_SEGMENTER_CONFIG_DEFAULT = {
+    .min_sentence_chars = 3, .max_sentence_chars = 200, .normalize = RAC_TRUE};
+
+/**
+ * @brief Receives one sentence, valid only during the call
+ */
+typedef void (*rac_tts_sentence_callback_fn)(const char* sentence, void* user_data);
+
+/**
+ * @brief Opaque handle for a segmenter
+ */
+typedef struct rac_tts_segmenter* rac_tts_segmenter_handle_t;
+
+// =============================================================================
+// SEGMENTER API
+// =============================================================================
+
+/**
+ * @brief Create a segmenter
+ *
+ * @param config Configuration (NULL for defaults)
+ * @param out_handle Output: Segmenter handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_tts_segmenter_create(const rac_tts_segmenter_config_t* config,
+                                              rac_tts_segmenter_handle_t* out_handle);
+
+/**
+ * @brief Append streamed text
+ *
+ * Text may be split anywhere, including inside a UTF-8 sequence. Each
+ * sentence completed by it is passed to callback, in order, before this
+ * returns.
+ *
+ * @param handle Segmenter handle
+ * @param text Next piece of text
+ * @param callback Receives completed sentences
+ * @param user_data User context passed to callback
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_tts_segmenter_feed(rac_tts_segmenter_handle_t handle, const char* text,
+                                            rac_tts_sentence_callback_fn callback,
+                                            void* user_data);
+
+/**
+ * @brief End of input: emit whatever is left as the last sentence
+ *
+ * The segmenter is ready for a new text afterwards.
+ *
+ * @param handle Segmenter handle
+ * @param callback Receives the last sentence, if any
+ * @param user_data User context passed to callback
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_tts_segmenter_flush(rac_tts_segmenter_handle_t handle,
+                                             rac_tts_sentence_callback_fn callback,
+                                             void* user_data);
+
+/**
+ * @brief Drop buffered text without emitting it
+ *
+ * @param handle Segmenter handle
+ */
+RAC_API void rac_tts_segmenter_reset(rac_tts_segmenter_handle_t handle);
+
+/**
+ * @brief Destroy a segmenter
+ *
+ * @param handle Segmenter handle
+ */
+RAC_API void rac_tts_segmenter_destroy(rac_tts_segmenter_handle_t handle);
+
+/**
+ * @brief Normalize a complete text for speech in one call
+ *
+ * Same rewriting as a normalizing segmenter; sentences are joined with a
+ * space.
+ *
+ * @param text Text to normalize
+ * @param out_text Output: Normalized text, free with rac_free
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_tts_normalize_text(const char* text, char** out_text);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_TTS_SEGMENTER_H */
@@ -15,6 +15,7 @@
 #ifndef RAC_TTS_TYPES_H
 #define RAC_TTS_TYPES_H
 
+#include "rac/core/rac_memory_watermark.h"
 #include "rac/core/rac_types.h"
 #include "rac/features/stt/rac_stt_types.h"  // For rac_audio_format_enum_t
 
@@ -192,7 +193,7 @@ static const rac_tts_input_t RAC_TTS_INPUT_DEFAULT = {.text = RAC_NULL,
  * @brief TTS synthesis result
  */
 typedef struct rac_tts_result {
-    /** Audio data (owned, must be freed with rac_free) */
+    /** Audio data (owned, released by rac_tts_result_free) */
     void* audio_data;
 
     /** Size of audio data in bytes */
@@ -209,6 +210,18 @@ typedef struct rac_tts_result {
 
     /** Processing time in milliseconds */
     int64_t processing_time_ms;
+
+    /**
+     * Releases audio_data when it is a backend-owned buffer rather than a
+     * malloc'd copy. NULL means rac_tts_result_free uses free().
+     */
+    void (*release_audio)(void* audio_data, void* release_context);
+
+    /** Context passed to release_audio */
+    void* release_context;
+
+    /** Memory used by the call (set by rac_tts_component_*) */
+    rac_inference_memory_t memory;
 } rac_tts_result_t;
 
 // =============================================================================
@@ -13,6 +13,8 @@
 #define RAC_VAD_COMPONENT_H
 
 #include "rac/core/capabilities/rac_lifecycle.h"
+#include "rac/core/rac_audio_aec.h"
+#include "rac/core/rac_cpu_budget.h"
 #include "rac/core/rac_error.h"
 #include "rac/features/vad/rac_vad_types.h"
 
@@ -116,6 +118,47 @@ RAC_API rac_result_t rac_vad_component_stop(rac_handle_t handle);
  */
 RAC_API rac_result_t rac_vad_component_reset(rac_handle_t handle);
 
+/**
+ * @brief Notify that TTS playback is starting (raises the threshold)
+ *
+ * Without echo cancellation, audio is ignored until notify_tts_finish.
+ *
+ * @param handle Component handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vad_component_notify_tts_start(rac_handle_t handle);
+
+/**
+ * @brief Notify that TTS playback has finished
+ *
+ * @param handle Component handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vad_component_notify_tts_finish(rac_handle_t handle);
+
+/**
+ * @brief Cancel playback echo so speech is detected while TTS plays
+ *
+ * See rac_energy_vad_enable_echo_cancellation.
+ *
+ * @param handle Component handle
+ * @param config Echo canceller configuration (NULL for defaults at the VAD sample rate)
+ * @return RAC_SUCCESS, RAC_ERROR_ALREADY_INITIALIZED, or error code
+ */
+RAC_API rac_result_t rac_vad_component_enable_echo_cancellation(
+    rac_handle_t handle, const rac_audio_aec_config_t* config);
+
+/**
+ * @brief Feed playback audio as it is handed to the speaker
+ *
+ * @param handle Component handle
+ * @param samples Float32 samples being played, at the VAD sample rate
+ * @param num_samples Number of samples
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vad_component_feed_playback(rac_handle_t handle, const float* samples,
+                                                     size_t num_samples);
+
 /**
  * @brief Process audio samples
  *
@@ -128,6 +171,117 @@ RAC_API rac_result_t rac_vad_component_reset(rac_handle_t handle);
 RAC_API rac_result_t rac_vad_component_process(rac_handle_t handle, const float* samples,
                                                size_t num_samples, rac_bool_t* out_is_speech);
 
+/**
+ * @brief Process consecutive frames through the live detector in one call
+ *
+ * Equivalent to calling rac_vad_component_process once per frame (state,
+ * callbacks and events included), but takes the component lock once. Trailing
+ * samples that do not fill a frame are not processed.
+ *
+ * @param handle Component handle
+ * @param samples Float audio samples (PCM)
+ * @param num_samples Number of samples
+ * @param frame_length_samples Samples per frame (0 = configured frame_length)
+ * @param out_decisions Output: Per-frame speech decision
+ * @param max_decisions Capacity of out_decisions; processing stops when full
+ * @param out_frames Output: Number of frames processed
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vad_component_process_frames(rac_handle_t handle, const float* samples,
+                                                      size_t num_samples,
+                                                      size_t frame_length_samples,
+                                                      rac_bool_t* out_decisions,
+                                                      size_t max_decisions, size_t* out_frames);
+
+/**
+ * @brief A speech segment found by rac_vad_component_process_buffer
+ */
+typedef struct rac_vad_segment {
+    double start_ms;
+    double end_ms;
+} rac_vad_segment_t;
+
+/**
+ * @brief Find the speech segments of a recorded buffer in one call
+ *
+ * Scans the whole buffer with the component's current threshold and the same
+ * start/end hysteresis as live detection, without firing callbacks or events
+ * and without touching the live detector's state.
+ *
+ * @param handle Component handle
+ * @param samples Float audio samples (PCM, at the configured sample rate)
+ * @param num_samples Number of samples
+ * @param frame_length_samples Samples per frame (0 = configured frame_length)
+ * @param out_segments Output: Segments (free with rac_vad_segments_free)
+ * @param out_count Output: Number of segments
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vad_component_process_buffer(rac_handle_t handle, const float* samples,
+                                                      size_t num_samples,
+                                                      size_t frame_length_samples,
+                                                      rac_vad_segment_t** out_segments,
+                                                      size_t* out_count);
+
+/**
+ * @brief Free segments returned by rac_vad_component_process_buffer
+ *
+ * @param segments Segments to free
+ */
+RAC_API void rac_vad_segments_free(rac_vad_segment_t* segments);
+
+/**
+ * @brief Start the asynchronous frame pipeline
+ *
+ * Audio pushed with rac_vad_component_push_audio goes through a lock-free
+ * single-producer ring to a worker thread, which runs detection one frame
+ * (config frame_length) at a time. Activity and audio callbacks are invoked
+ * on that worker thread, which is raised to audio scheduling as configured
+ * with rac_vad_component_set_pipeline_thread (by default real-time if
+ * allowed, on the fastest core), so detection and whatever the audio
+ * callback feeds keep their frame deadline under app load.
+ *
+ * @param handle Component handle
+ * @param capacity_samples Ring capacity in samples (0 = one second of audio)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vad_component_start_pipeline(rac_handle_t handle, size_t capacity_samples);
+
+/**
+ * @brief Set how the pipeline worker is scheduled
+ *
+ * Takes effect at the next rac_vad_component_start_pipeline.
+ *
+ * @param handle Component handle
+ * @param config Worker scheduling (NULL for RAC_AUDIO_THREAD_CONFIG_DEFAULT)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vad_component_set_pipeline_thread(rac_handle_t handle,
+                                                           const rac_audio_thread_config_t* config);
+
+/**
+ * @brief Queue audio for the pipeline (audio-thread safe)
+ *
+ * Never blocks and never takes a lock, so it can be called from a real-time
+ * capture callback. Only one thread may push at a time, and pushing must not
+ * overlap rac_vad_component_start_pipeline/stop_pipeline.
+ *
+ * @param handle Component handle
+ * @param samples Float audio samples (PCM)
+ * @param num_samples Number of samples
+ * @return RAC_SUCCESS, or RAC_ERROR_BUFFER_TOO_SMALL if the ring was full and
+ *         samples were dropped
+ */
+RAC_API rac_result_t rac_vad_component_push_audio(rac_handle_t handle, const float* samples,
+                                                  size_t num_samples);
+
+/**
+ * @brief Stop the pipeline, processing whatever audio is still queued
+ *
+ * @param handle Component handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_vad_component_stop_pipeline(rac_handle_t handle);
+
 /**
  * @brief Get current speech activity state
  *
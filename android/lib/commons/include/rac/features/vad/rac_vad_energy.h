@@ -12,6 +12,7 @@
 #ifndef RAC_VAD_ENERGY_H
 #define RAC_VAD_ENERGY_H
 
+#include "rac/core/rac_audio_aec.h"
 #include "rac/core/rac_error.h"
 #include "rac/core/rac_types.h"
 #include "rac/features/vad/rac_vad_types.h"
@@ -57,6 +58,18 @@ extern "C" {
 /** Maximum recent values for statistics */
 #define RAC_VAD_MAX_RECENT_VALUES 50
 
+/** Non-speech frames per background recalibration (~30 seconds at 100ms) */
+#define RAC_VAD_RECALIBRATION_FRAMES 300
+
+/** Spectral mode: minimum share of energy in the 200-4000 Hz speech band */
+#define RAC_VAD_SPECTRAL_MIN_BAND_RATIO 0.3f
+
+/** Spectral mode: maximum spectral flatness (1.0 = white noise) */
+#define RAC_VAD_SPECTRAL_MAX_FLATNESS 0.45f
+
+/** Spectral mode: maximum zero-crossing rate (crossings per sample) */
+#define RAC_VAD_SPECTRAL_MAX_ZCR 0.35f
+
 // =============================================================================
 // TYPES
 // =============================================================================
@@ -75,6 +88,18 @@ typedef enum rac_speech_activity_event {
     RAC_SPEECH_ACTIVITY_ENDED = 1    /**< Speech has ended */
 } rac_speech_activity_event_t;
 
+/**
+ * @brief Frame classifier used by the energy VAD.
+ */
+typedef enum rac_energy_vad_mode {
+    /** RMS energy against the threshold only (mirrors Swift) */
+    RAC_ENERGY_VAD_MODE_RMS = 0,
+    /** RMS gate plus spectral checks: speech-band energy ratio, spectral
+        flatness and zero-crossing rate. Rejects broadband noise (fans, traffic,
+        rustling) that RMS alone reports as speech. */
+    RAC_ENERGY_VAD_MODE_SPECTRAL = 1
+} rac_energy_vad_mode_t;
+
 /**
  * @brief Configuration for energy VAD.
  * Mirrors Swift's SimpleEnergyVADService init parameters.
@@ -88,6 +113,9 @@ typedef struct rac_energy_vad_config {
 
     /** Energy threshold for voice detection (default: 0.005) */
     float energy_threshold;
+
+    /** Frame classifier (default: RAC_ENERGY_VAD_MODE_RMS) */
+    rac_energy_vad_mode_t mode;
 } rac_energy_vad_config_t;
 
 /**
@@ -96,7 +124,8 @@ typedef struct rac_energy_vad_config {
 static const rac_energy_vad_config_t RAC_ENERGY_VAD_CONFIG_DEFAULT = {
     .sample_rate = RAC_VAD_DEFAULT_SAMPLE_RATE,
     .frame_length = RAC_VAD_DEFAULT_FRAME_LENGTH,
-    .energy_threshold = RAC_VAD_DEFAULT_ENERGY_THRESHOLD};
+    .energy_threshold = RAC_VAD_DEFAULT_ENERGY_THRESHOLD,
+    .mode = RAC_ENERGY_VAD_MODE_RMS};
 
 /**
  * @brief Energy VAD statistics for debugging.
@@ -283,6 +312,22 @@ RAC_API rac_result_t rac_energy_vad_start_calibration(rac_energy_vad_handle_t ha
 RAC_API rac_result_t rac_energy_vad_is_calibrating(rac_energy_vad_handle_t handle,
                                                    rac_bool_t* out_is_calibrating);
 
+/**
+ * @brief Enable or disable continuous background recalibration.
+ *
+ * When enabled, the 90th percentile of non-speech frame energy is tracked
+ * with a streaming estimator, and every RAC_VAD_RECALIBRATION_FRAMES such
+ * frames the ambient level and threshold are recomputed as in calibration.
+ * The threshold then follows noise changes mid-session. This overrides
+ * thresholds set with rac_energy_vad_set_threshold(). Disabled by default.
+ *
+ * @param handle Service handle
+ * @param enabled RAC_TRUE to enable
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_energy_vad_set_background_recalibration(rac_energy_vad_handle_t handle,
+                                                                 rac_bool_t enabled);
+
 /**
  * @brief Set calibration parameters.
  *
@@ -333,6 +378,36 @@ RAC_API rac_result_t rac_energy_vad_notify_tts_finish(rac_energy_vad_handle_t ha
 RAC_API rac_result_t rac_energy_vad_set_tts_multiplier(rac_energy_vad_handle_t handle,
                                                        float multiplier);
 
+/**
+ * @brief Cancel TTS echo instead of blocking audio while TTS plays.
+ *
+ * Without echo cancellation every frame is ignored between notify_tts_start
+ * and notify_tts_finish. Once enabled, those frames are echo-cancelled against
+ * the playback fed through rac_energy_vad_feed_playback and analysed with the
+ * normal hysteresis, so the user can interrupt (barge-in). The raised TTS
+ * threshold still applies to absorb residual echo. Cannot be disabled again.
+ *
+ * @param handle Service handle
+ * @param config Echo canceller configuration (NULL for defaults at the VAD sample rate)
+ * @return RAC_SUCCESS, RAC_ERROR_ALREADY_INITIALIZED, or error code
+ */
+RAC_API rac_result_t rac_energy_vad_enable_echo_cancellation(rac_energy_vad_handle_t handle,
+                                                             const rac_audio_aec_config_t* config);
+
+/**
+ * @brief Feed TTS audio as it is handed to the speaker.
+ *
+ * Must be called at playback time, at the VAD sample rate. Does not wait on
+ * the audio path. Ignored unless echo cancellation is enabled.
+ *
+ * @param handle Service handle
+ * @param samples Float32 samples being played
+ * @param num_samples Number of samples
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_energy_vad_feed_playback(rac_energy_vad_handle_t handle,
+                                                  const float* samples, size_t num_samples);
+
 // =============================================================================
 // STATE QUERY API
 // =============================================================================
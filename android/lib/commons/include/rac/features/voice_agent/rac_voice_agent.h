@@ -14,6 +14,7 @@
 #ifndef RAC_VOICE_AGENT_H
 #define RAC_VOICE_AGENT_H
 
+#include "rac/core/rac_audio_capture.h"
 #include "rac/core/rac_error.h"
 #include "rac/core/rac_types.h"
 #include "rac/features/llm/rac_llm_types.h"
@@ -82,7 +83,13 @@ typedef enum rac_voice_agent_event_type {
     RAC_VOICE_AGENT_EVENT_TRANSCRIPTION = 2,     /**< Transcription available from STT */
     RAC_VOICE_AGENT_EVENT_RESPONSE = 3,          /**< Response generated from LLM */
     RAC_VOICE_AGENT_EVENT_AUDIO_SYNTHESIZED = 4, /**< Audio synthesized from TTS */
-    RAC_VOICE_AGENT_EVENT_ERROR = 5              /**< Error occurred during processing */
+    RAC_VOICE_AGENT_EVENT_ERROR = 5,             /**< Error occurred during processing */
+    RAC_VOICE_AGENT_EVENT_RESPONSE_CHUNK = 6,    /**< Sentence of the response sent to TTS */
+    RAC_VOICE_AGENT_EVENT_AUDIO_CHUNK = 7,       /**< Audio synthesized for one sentence */
+    RAC_VOICE_AGENT_EVENT_PARTIAL_TRANSCRIPTION = 8, /**< Interim transcript of ongoing speech */
+    RAC_VOICE_AGENT_EVENT_STATE_CHANGED = 9,         /**< Voice session pipeline state changed */
+    RAC_VOICE_AGENT_EVENT_INTERRUPTED = 10,          /**< User barged in; drop queued playback */
+    RAC_VOICE_AGENT_EVENT_WAKE_WORD = 11             /**< Wake word heard; session now listening */
 } rac_voice_agent_event_type_t;
 
 /**
@@ -145,6 +152,30 @@ typedef struct rac_voice_agent_tts_config {
     const char* voice_name;
 } rac_voice_agent_tts_config_t;
 
+/**
+ * @brief Model loading policy for rac_voice_agent_initialize.
+ *
+ * A zeroed struct loads sequentially and waits for every model.
+ */
+typedef struct rac_voice_agent_load_config {
+    /** Load STT, LLM and TTS on parallel threads */
+    rac_bool_t parallel;
+
+    /** Load TTS in the background after initialize returns; the first
+        synthesis waits for it */
+    rac_bool_t defer_tts;
+
+    /** Loads run in parallel only if available memory covers the model files
+        plus this fraction of them; otherwise one at a time */
+    float memory_margin;
+} rac_voice_agent_load_config_t;
+
+/**
+ * @brief Default loading policy (parallel, TTS loaded up front, 25% margin).
+ */
+static const rac_voice_agent_load_config_t RAC_VOICE_AGENT_LOAD_CONFIG_DEFAULT = {
+    .parallel = RAC_TRUE, .defer_tts = RAC_FALSE, .memory_margin = 0.25f};
+
 /**
  * @brief Voice agent configuration.
  * Mirrors Swift's VoiceAgentConfiguration.
@@ -161,6 +192,9 @@ typedef struct rac_voice_agent_config {
 
     /** TTS configuration */
     rac_voice_agent_tts_config_t tts_config;
+
+    /** Model loading policy */
+    rac_voice_agent_load_config_t load_config;
 } rac_voice_agent_config_t;
 
 /**
@@ -170,7 +204,8 @@ static const rac_voice_agent_config_t RAC_VOICE_AGENT_CONFIG_DEFAULT = {
     .vad_config = {.sample_rate = 16000, .frame_length = 0.1f, .energy_threshold = 0.005f},
     .stt_config = {.model_path = RAC_NULL, .model_id = RAC_NULL, .model_name = RAC_NULL},
     .llm_config = {.model_path = RAC_NULL, .model_id = RAC_NULL, .model_name = RAC_NULL},
-    .tts_config = {.voice_path = RAC_NULL, .voice_id = RAC_NULL, .voice_name = RAC_NULL}};
+    .tts_config = {.voice_path = RAC_NULL, .voice_id = RAC_NULL, .voice_name = RAC_NULL},
+    .load_config = {.parallel = RAC_TRUE, .defer_tts = RAC_FALSE, .memory_margin = 0.25f}};
 
 // =============================================================================
 // AUDIO PIPELINE STATE MANAGER CONFIG - Mirrors Swift's AudioPipelineStateManager.Configuration
@@ -235,6 +270,105 @@ RAC_API rac_bool_t rac_audio_pipeline_can_play_tts(rac_audio_pipeline_state_t cu
 RAC_API rac_bool_t rac_audio_pipeline_is_valid_transition(rac_audio_pipeline_state_t from_state,
                                                           rac_audio_pipeline_state_t to_state);
 
+/**
+ * @brief Stages of a voice turn trace
+ *
+ * TURN is the root and starts when the user stops speaking (voice sessions)
+ * or when the processing call is made. LLM_FIRST_TOKEN is a child of LLM,
+ * TTS_FIRST_CHUNK a child of TTS; the other stages are children of TURN.
+ */
+typedef enum rac_voice_turn_stage {
+    RAC_VOICE_TURN_STAGE_TURN = 0,            /**< Whole turn, until the result is ready */
+    RAC_VOICE_TURN_STAGE_ENDPOINT = 1,        /**< End of speech until end of turn was declared */
+    RAC_VOICE_TURN_STAGE_STT = 2,             /**< Final transcription */
+    RAC_VOICE_TURN_STAGE_LLM = 3,             /**< Response generation */
+    RAC_VOICE_TURN_STAGE_LLM_FIRST_TOKEN = 4, /**< Generation start to first token (prefill) */
+    RAC_VOICE_TURN_STAGE_TTS = 5,             /**< First synthesis start to last synthesis end */
+    RAC_VOICE_TURN_STAGE_TTS_FIRST_CHUNK = 6, /**< Synthesis start to first audio ready */
+    RAC_VOICE_TURN_STAGE_FIRST_AUDIO = 7      /**< Turn start to first audio handed to the app */
+} rac_voice_turn_stage_t;
+
+/** Number of trace stages */
+#define RAC_VOICE_TURN_STAGE_COUNT 8
+
+/**
+ * @brief One timed stage of a voice turn
+ */
+typedef struct rac_voice_turn_span {
+    /** Stage this span measures */
+    rac_voice_turn_stage_t stage;
+
+    /** Parent stage, -1 for the root */
+    int32_t parent;
+
+    /** Monotonic start time in nanoseconds (0 if the stage was not reached) */
+    int64_t start_ns;
+
+    /** Monotonic end time in nanoseconds (0 if the stage did not finish) */
+    int64_t end_ns;
+} rac_voice_turn_span_t;
+
+/**
+ * @brief Per-stage timing of a voice turn
+ */
+typedef struct rac_voice_turn_trace {
+    /** Spans indexed by rac_voice_turn_stage_t */
+    rac_voice_turn_span_t spans[RAC_VOICE_TURN_STAGE_COUNT];
+} rac_voice_turn_trace_t;
+
+/**
+ * @brief Duration of a traced stage
+ *
+ * @param trace Turn trace
+ * @param stage Stage
+ * @return Duration in milliseconds, or -1 if the stage was not completed
+ */
+RAC_API double rac_voice_turn_trace_stage_ms(const rac_voice_turn_trace_t* trace,
+                                             rac_voice_turn_stage_t stage);
+
+/**
+ * @brief Encoding of synthesized speech handed to the app
+ */
+typedef enum rac_voice_audio_format {
+    RAC_VOICE_AUDIO_FORMAT_WAV = 0,     /**< 16-bit mono WAV file (default) */
+    RAC_VOICE_AUDIO_FORMAT_PCM_F32 = 1, /**< Raw Float32 samples as synthesized, no conversion */
+    RAC_VOICE_AUDIO_FORMAT_PCM_S16 = 2  /**< Raw Int16 samples, no header */
+} rac_voice_audio_format_t;
+
+/**
+ * @brief Callback receiving synthesized speech as it is produced
+ *
+ * @param samples Audio samples in the configured format (valid during the call)
+ * @param size Size of samples in bytes
+ * @param format PCM_F32 or PCM_S16
+ * @param user_data User-provided context
+ */
+typedef void (*rac_voice_audio_chunk_fn)(const void* samples, size_t size,
+                                         rac_voice_audio_format_t format, void* user_data);
+
+/**
+ * @brief How voice turns deliver synthesized speech
+ */
+typedef struct rac_voice_output_config {
+    /** Encoding of the audio in results and audio events */
+    rac_voice_audio_format_t format;
+
+    /** Stream audio from the synthesizer as it is produced (can be NULL).
+        Used by process_voice_turn and process_stream, whose result and
+        AUDIO_SYNTHESIZED event then carry no audio. Chunks are PCM; the WAV
+        format streams PCM_S16 chunks. */
+    rac_voice_audio_chunk_fn chunk_callback;
+
+    /** User context passed to chunk_callback */
+    void* chunk_user_data;
+} rac_voice_output_config_t;
+
+/**
+ * @brief Default output (one WAV per response, no streaming)
+ */
+static const rac_voice_output_config_t RAC_VOICE_OUTPUT_CONFIG_DEFAULT = {
+    .format = RAC_VOICE_AUDIO_FORMAT_WAV, .chunk_callback = RAC_NULL, .chunk_user_data = RAC_NULL};
+
 /**
  * @brief Voice agent processing result.
  * Mirrors Swift's VoiceAgentResult.
@@ -254,6 +388,15 @@ typedef struct rac_voice_agent_result {
 
     /** Size of synthesized audio data in bytes */
     size_t synthesized_audio_size;
+
+    /** Stage timings of the turn (also emitted as VOICE_AGENT_TURN_* analytics) */
+    rac_voice_turn_trace_t trace;
+
+    /** Encoding of synthesized_audio */
+    rac_voice_audio_format_t audio_format;
+
+    /** Sample rate of synthesized_audio in Hz */
+    int32_t audio_sample_rate;
 } rac_voice_agent_result_t;
 
 /**
@@ -271,20 +414,29 @@ typedef struct rac_voice_agent_event {
         /** For VAD_TRIGGERED event: true if speech started, false if ended */
         rac_bool_t vad_speech_active;
 
-        /** For TRANSCRIPTION event */
+        /** For TRANSCRIPTION and PARTIAL_TRANSCRIPTION events */
         const char* transcription;
 
-        /** For RESPONSE event */
+        /** For RESPONSE and RESPONSE_CHUNK events */
         const char* response;
 
-        /** For AUDIO_SYNTHESIZED event */
+        /** For AUDIO_SYNTHESIZED and AUDIO_CHUNK events */
         struct {
             const void* audio_data;
             size_t audio_size;
+            /** Encoding set with rac_voice_agent_set_output_config (WAV by default) */
+            rac_voice_audio_format_t format;
+            int32_t sample_rate;
         } audio;
 
         /** For ERROR event */
         rac_result_t error_code;
+
+        /** For STATE_CHANGED event: the new state */
+        rac_audio_pipeline_state_t pipeline_state;
+
+        /** For WAKE_WORD event: the keyword that was spotted */
+        const char* keyword;
     } data;
 } rac_voice_agent_event_t;
 
@@ -452,7 +604,9 @@ RAC_API const char* rac_voice_agent_get_tts_voice_id(rac_voice_agent_handle_t ha
  * @brief Initialize the voice agent with configuration.
  *
  * Mirrors Swift's VoiceAgentCapability.initialize(_:).
- * This method is smart about reusing already-loaded models.
+ * This method is smart about reusing already-loaded models. Models are
+ * loaded as config->load_config says; each reports its own LOADING, LOADED
+ * or ERROR state event as it goes.
  *
  * @param handle Voice agent handle
  * @param config Configuration (can be NULL for defaults)
@@ -498,6 +652,20 @@ RAC_API rac_result_t rac_voice_agent_is_ready(rac_voice_agent_handle_t handle,
 // VOICE PROCESSING API
 // =============================================================================
 
+/**
+ * @brief Choose how voice turns deliver synthesized speech.
+ *
+ * Applies to later processing calls and voice sessions on this agent. Raw
+ * PCM lets the player take the synthesizer's samples without a WAV round
+ * trip; PCM_F32 hands over the synthesizer's buffer with no copy.
+ *
+ * @param handle Voice agent handle
+ * @param config Output configuration (NULL for defaults)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_voice_agent_set_output_config(rac_voice_agent_handle_t handle,
+                                                       const rac_voice_output_config_t* config);
+
 /**
  * @brief Process a complete voice turn: audio → transcription → LLM response → synthesized speech.
  *
@@ -532,8 +700,225 @@ RAC_API rac_result_t rac_voice_agent_process_stream(rac_voice_agent_handle_t han
                                                     rac_voice_agent_event_callback_fn callback,
                                                     void* user_data);
 
+/**
+ * @brief Process audio with the LLM and TTS stages overlapped.
+ *
+ * Like rac_voice_agent_process_stream, but the response is streamed from the
+ * LLM and cut into sentences; each sentence is synthesized on a worker thread
+ * while generation continues. Events, never delivered concurrently:
+ * TRANSCRIPTION, then interleaved RESPONSE_CHUNK (sentence text as it is
+ * spoken, see rac_tts_segmenter.h) and AUDIO_CHUNK (audio for one sentence,
+ * in order), then RESPONSE with the full text and PROCESSED. Chunk data is
+ * only valid during the callback. The PROCESSED result carries no audio
+ * since it was delivered in chunks. A transcript without words skips the
+ * response: PROCESSED then reports speech_detected = RAC_FALSE.
+ *
+ * Falls back to one chunk per sentence of a blocking generate when the LLM
+ * does not support streaming.
+ *
+ * @param handle Voice agent handle
+ * @param audio_data Audio data from user
+ * @param audio_size Size of audio data in bytes
+ * @param callback Event callback function
+ * @param user_data User context passed to callback
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_voice_agent_process_stream_pipelined(
+    rac_voice_agent_handle_t handle, const void* audio_data, size_t audio_size,
+    rac_voice_agent_event_callback_fn callback, void* user_data);
+
+// =============================================================================
+// VOICE SESSION API - Continuous microphone input with automatic turn taking
+// =============================================================================
+
+/**
+ * @brief Voice session configuration
+ *
+ * A turn starts once min_speech_ms of consecutive voiced audio has been seen
+ * and ends after end_of_turn_ms of silence (the hangover).
+ */
+typedef struct rac_voice_session_config {
+    /** Sample rate of the microphone audio in Hz (must match the STT model) */
+    int32_t sample_rate;
+
+    /** Consecutive voiced audio required to start a turn (milliseconds) */
+    int32_t min_speech_ms;
+
+    /** Silence after speech that ends the turn (milliseconds) */
+    int32_t end_of_turn_ms;
+
+    /** Audio from before the speech onset kept with the turn (milliseconds) */
+    int32_t pre_roll_ms;
+
+    /** Turns longer than this are ended regardless of silence (milliseconds) */
+    int32_t max_turn_ms;
+
+    /** Emit a partial transcript every this much turn audio (0 = disabled).
+        Only used when the STT model supports streaming */
+    int32_t partial_interval_ms;
+
+    /** Cooldown after playback and the playback timeout */
+    rac_audio_pipeline_config_t pipeline;
+
+    /** Silence after which the transcript so far is prefilled into the LLM
+        while end of turn is still pending (0 = disabled). With a prefix
+        cache the turn's generation then only decodes what changed. Should
+        be well below end_of_turn_ms */
+    int32_t speculative_prefill_ms;
+
+    /** Keep listening while responding: speech during generation or
+        playback cancels the response and starts the next turn. Enables the
+        VAD's echo canceller; feed playback with rac_voice_session_feed_playback */
+    rac_bool_t barge_in;
+
+    /** Keyword spotter from rac_kws_create (not owned; NULL = always listening).
+        While asleep only the spotter sees microphone audio; VAD and turns
+        start after a detection */
+    rac_handle_t wake_word;
+
+    /** Idle listening after a wake word or a response before going back to
+        sleep (milliseconds). Only used with wake_word */
+    int32_t wake_window_ms;
+} rac_voice_session_config_t;
+
+/**
+ * @brief Default voice session configuration
+ */
+static const rac_voice_session_config_t RAC_VOICE_SESSION_CONFIG_DEFAULT = {
+    .sample_rate = 16000,
+    .min_speech_ms = 150,
+    .end_of_turn_ms = 700,
+    .pre_roll_ms = 300,
+    .max_turn_ms = 20000,
+    .partial_interval_ms = 500,
+    .pipeline = {.cooldown_duration = 0.8f, .strict_transitions = RAC_TRUE, .max_tts_duration = 30.0f},
+    .speculative_prefill_ms = 0,
+    .barge_in = RAC_FALSE,
+    .wake_word = NULL,
+    .wake_window_ms = 8000};
+
+/**
+ * @brief Opaque handle for a voice session
+ */
+typedef struct rac_voice_session* rac_voice_session_handle_t;
+
+/**
+ * @brief Start an always-on voice session on an initialized voice agent
+ *
+ * Audio fed to the session runs through the agent's VAD; when a turn ends
+ * it is transcribed and answered as in rac_voice_agent_process_stream_pipelined.
+ * The session follows rac_audio_pipeline_state_t (STATE_CHANGED events):
+ * LISTENING -> PROCESSING_SPEECH -> GENERATING_RESPONSE -> PLAYING_TTS ->
+ * COOLDOWN -> IDLE -> LISTENING. Microphone audio fed outside LISTENING is
+ * dropped unless barge-in is enabled. Additional events: VAD_TRIGGERED at
+ * turn start and end, PARTIAL_TRANSCRIPTION while the user speaks,
+ * INTERRUPTED when a barge-in abandons the response, and WAKE_WORD when
+ * a configured wake word opens the session for turns.
+ *
+ * Events are delivered on the session's threads, never concurrently. The
+ * agent must outlive the session.
+ *
+ * @param agent Initialized voice agent
+ * @param config Session configuration (NULL for defaults)
+ * @param callback Event callback
+ * @param user_data User context passed to callback
+ * @param out_session Output: Session handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_voice_session_create(rac_voice_agent_handle_t agent,
+                                              const rac_voice_session_config_t* config,
+                                              rac_voice_agent_event_callback_fn callback,
+                                              void* user_data,
+                                              rac_voice_session_handle_t* out_session);
+
+/**
+ * @brief Feed captured microphone audio
+ *
+ * Lock-free, so it can be called from a real-time capture callback: samples
+ * go through a single-producer ring to the worker. Only one thread may feed
+ * at a time, and not while native capture is running.
+ *
+ * @param session Session handle
+ * @param samples Float32 mono samples at the configured sample rate
+ * @param num_samples Number of samples
+ * @return RAC_SUCCESS, or RAC_ERROR_BUFFER_TOO_SMALL if the worker is more
+ *         than 10 s behind and samples were dropped
+ */
+RAC_API rac_result_t rac_voice_session_feed_audio(rac_voice_session_handle_t session,
+                                                  const float* samples, size_t num_samples);
+
+/**
+ * @brief Record the microphone natively and feed it to the session
+ *
+ * Opens a rac_audio_capture source (AAudio on Android, the platform adapter
+ * elsewhere) at the session sample rate whose callback feeds the session
+ * directly, in place of rac_voice_session_feed_audio calls from the app.
+ * Stopped by rac_voice_session_stop_capture or when the session is destroyed.
+ *
+ * @param session Session handle
+ * @param config Capture configuration; sample_rate is ignored (NULL for defaults)
+ * @return RAC_SUCCESS, RAC_ERROR_NOT_SUPPORTED without a capture backend, or
+ *         error code
+ */
+RAC_API rac_result_t rac_voice_session_start_capture(rac_voice_session_handle_t session,
+                                                     const rac_audio_capture_config_t* config);
+
+/**
+ * @brief Stop native capture started with rac_voice_session_start_capture
+ *
+ * @param session Session handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_voice_session_stop_capture(rac_voice_session_handle_t session);
+
+/**
+ * @brief Feed response audio as it is handed to the speaker
+ *
+ * Used as the echo reference for barge-in; call from the playback path with
+ * Float32 samples at the session sample rate. Ignored without barge-in.
+ *
+ * @param session Session handle
+ * @param samples Float32 samples being played
+ * @param num_samples Number of samples
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_voice_session_feed_playback(rac_voice_session_handle_t session,
+                                                     const float* samples, size_t num_samples);
+
+/**
+ * @brief Report that the app finished playing the response audio
+ *
+ * Call once the audio of the turn's PROCESSED event has been played. Moves
+ * the session from PLAYING_TTS into COOLDOWN; without this call it leaves
+ * PLAYING_TTS after the configured max_tts_duration.
+ *
+ * @param session Session handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_voice_session_notify_playback_finished(rac_voice_session_handle_t session);
+
+/**
+ * @brief Get the current pipeline state
+ *
+ * @param session Session handle
+ * @return Current state (RAC_AUDIO_PIPELINE_IDLE for a NULL handle)
+ */
+RAC_API rac_audio_pipeline_state_t rac_voice_session_get_state(rac_voice_session_handle_t session);
+
+/**
+ * @brief Stop and destroy a voice session
+ *
+ * Cancels a response in progress and waits for it to stop.
+ *
+ * @param session Session handle
+ */
+RAC_API void rac_voice_session_destroy(rac_voice_session_handle_t session);
+
 // =============================================================================
 // INDIVIDUAL COMPONENT ACCESS API
+// Calls for different components run concurrently (e.g. detect_speech on the
+// mic thread while generate_response runs); calls for one component queue on
+// that component. Loading or cleanup waits for calls in flight.
 // =============================================================================
 
 /**
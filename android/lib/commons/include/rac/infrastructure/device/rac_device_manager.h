@@ -143,6 +143,22 @@ RAC_API rac_result_t rac_device_manager_set_callbacks(const rac_device_callbacks
 RAC_API rac_result_t rac_device_manager_register_if_needed(rac_environment_t env,
                                                            const char* build_token);
 
+/**
+ * @brief Register through the outbound queue, without blocking
+ *
+ * Queues a high-priority RAC_OUTBOUND_KIND_DEVICE_REGISTRATION item that runs
+ * rac_device_manager_register_if_needed once the device is online, retrying
+ * network failures as the queue backs off. Repeated calls collapse into one
+ * queued registration.
+ *
+ * @param env Current SDK environment
+ * @param build_token Optional build token for development mode (can be NULL).
+ * Kept in memory only; never persisted with the queued item.
+ * @return RAC_SUCCESS if queued, error code otherwise
+ */
+RAC_API rac_result_t rac_device_manager_register_deferred(rac_environment_t env,
+                                                          const char* build_token);
+
 /**
  * @brief Check if device is registered
  *
@@ -169,6 +185,18 @@ RAC_API void rac_device_manager_clear_registration(void);
  */
 RAC_API const char* rac_device_manager_get_device_id(void);
 
+/**
+ * @brief Get the device's RAM
+ *
+ * Delegates to the get_device_info callback.
+ *
+ * @param out_total_memory Output: Total RAM in bytes
+ * @param out_available_memory Output: Available RAM in bytes (0 if unknown)
+ * @return RAC_SUCCESS, or RAC_ERROR_INVALID_STATE if callbacks not set
+ */
+RAC_API rac_result_t rac_device_manager_get_memory(int64_t* out_total_memory,
+                                                   int64_t* out_available_memory);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,191 @@
+/**
+ * @file rac_device_profile.h
+ * @brief Device Performance Profile - One-Time Calibration
+ *
+ * The device manager registers who a device is, not how fast it is, so
+ * thread counts and model choices fall back to one-size heuristics. The
+ * profile closes that gap with a short calibration run once per device:
+ *
+ * - single-precision matmul throughput, at increasing thread counts, which
+ *   also finds the thread count compute stops scaling at
+ * - sustained memory bandwidth (triad), the limit for decode
+ * - prefill and decode speed of a reference model, if a loaded LLM service
+ *   is passed in
+ *
+ * The result is persisted through the SDK state persistence callbacks
+ * (rac_state_set_persistence_callbacks), reported once as a
+ * RAC_EVENT_DEVICE_PROFILED analytics event, and turned into a device class
+ * that model assignment and backend defaults key off.
+ */
+
+#ifndef RAC_DEVICE_PROFILE_H
+#define RAC_DEVICE_PROFILE_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/** Profile format version; profiles of another version are recalibrated */
+#define RAC_DEVICE_PROFILE_VERSION 1
+
+/** Key the profile is persisted under */
+#define RAC_DEVICE_PROFILE_STORAGE_KEY "device_performance_profile"
+
+/** Longest reference model ID kept in a profile, including the terminator */
+#define RAC_DEVICE_PROFILE_MODEL_ID_MAX 128
+
+/**
+ * @brief Coarse performance class
+ */
+typedef enum rac_device_class {
+    RAC_DEVICE_CLASS_UNKNOWN = 0, /**< Not calibrated */
+    RAC_DEVICE_CLASS_LOW = 1,     /**< Entry-level; small models only */
+    RAC_DEVICE_CLASS_MID = 2,     /**< Mainstream */
+    RAC_DEVICE_CLASS_HIGH = 3,    /**< Flagship */
+} rac_device_class_t;
+
+/**
+ * @brief Measured performance of this device
+ */
+typedef struct rac_device_profile {
+    /** RAC_DEVICE_PROFILE_VERSION of the calibration that produced it */
+    int32_t version;
+
+    /** Multi-threaded single-precision matmul throughput at best_threads */
+    double matmul_gflops;
+
+    /** Single-threaded matmul throughput */
+    double matmul_gflops_single;
+
+    /** Sustained memory bandwidth in GB/s */
+    double memory_bandwidth_gbps;
+
+    /** Smallest thread count within 90% of the peak matmul throughput */
+    int32_t best_threads;
+
+    /** Online cores when calibrated */
+    int32_t core_count;
+
+    /** Reference model prompt processing speed (0 if not measured) */
+    double prefill_tokens_per_second;
+
+    /** Reference model decode speed (0 if not measured) */
+    double decode_tokens_per_second;
+
+    /** Reference model ID (empty if not measured) */
+    char reference_model_id[RAC_DEVICE_PROFILE_MODEL_ID_MAX];
+
+    rac_device_class_t device_class;
+
+    /** Unix time of the calibration in milliseconds */
+    int64_t measured_at_ms;
+} rac_device_profile_t;
+
+/**
+ * @brief Defaults derived from a profile
+ */
+typedef struct rac_device_recommendation {
+    /** LLM decode threads */
+    int32_t llm_threads;
+
+    /** LLM prompt batch size in tokens */
+    int32_t llm_batch_tokens;
+
+    /** Default LLM context length in tokens */
+    int32_t llm_context_length;
+
+    /** Largest model worth assigning, in bytes (0 = no limit) */
+    int64_t max_model_bytes;
+} rac_device_recommendation_t;
+
+/**
+ * @brief Called when a background calibration finishes
+ *
+ * @param result RAC_SUCCESS, or the error that stopped the calibration
+ * @param profile The new profile (NULL on error; valid during the call)
+ * @param user_data User context
+ */
+typedef void (*rac_device_profile_callback_fn)(rac_result_t result,
+                                               const rac_device_profile_t* profile,
+                                               void* user_data);
+
+// =============================================================================
+// PROFILE API
+// =============================================================================
+
+/**
+ * @brief Run the calibration on the calling thread
+ *
+ * Takes a fraction of a second without a reference model, plus one short
+ * generation with one. The result replaces the current profile, is
+ * persisted, and is reported through analytics.
+ *
+ * @param reference_llm Loaded LLM service to time (NULL to skip)
+ * @param out_profile Output: The new profile (can be NULL)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_device_profile_calibrate(rac_handle_t reference_llm,
+                                                  rac_device_profile_t* out_profile);
+
+/**
+ * @brief Calibrate in the background unless this device already has a profile
+ *
+ * Runs on the request executor at low priority. Does nothing, and does not
+ * call the callback, if a current-version profile is already stored.
+ *
+ * @param reference_llm Loaded LLM service to time (NULL to skip). Must stay
+ * loaded until the callback runs.
+ * @param callback Completion callback (can be NULL)
+ * @param user_data User context passed to callback
+ * @return RAC_SUCCESS if a calibration was queued or is not needed
+ */
+RAC_API rac_result_t rac_device_profile_ensure(rac_handle_t reference_llm,
+                                               rac_device_profile_callback_fn callback,
+                                               void* user_data);
+
+/**
+ * @brief Current profile, loading the persisted one on first use
+ *
+ * @param out_profile Output: Profile
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_FOUND if the device is not calibrated
+ */
+RAC_API rac_result_t rac_device_profile_get(rac_device_profile_t* out_profile);
+
+/**
+ * @brief Forget the profile, in memory and in storage
+ */
+RAC_API void rac_device_profile_clear(void);
+
+/**
+ * @brief Current device class (RAC_DEVICE_CLASS_UNKNOWN if not calibrated)
+ */
+RAC_API rac_device_class_t rac_device_profile_get_class(void);
+
+/**
+ * @brief Defaults for the current profile
+ *
+ * Without a profile every field is 0, meaning "use the backend default".
+ *
+ * @param out_recommendation Output: Recommended defaults
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_FOUND if the device is not calibrated
+ */
+RAC_API rac_result_t
+rac_device_profile_recommend(rac_device_recommendation_t* out_recommendation);
+
+/**
+ * @brief Device class name ("unknown", "low", "mid", "high")
+ */
+RAC_API const char* rac_device_class_name(rac_device_class_t device_class);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_DEVICE_PROFILE_H */
@@ -0,0 +1,91 @@
+/**
+ * @file rac_archive_stream.h
+ * @brief Streaming Archive Extraction
+ *
+ * Extracts a model archive from bytes pushed in as they arrive, so a download
+ * can be unpacked while it runs instead of being stored and then extracted.
+ * Supports tar (optionally gzip, bzip2 or xz compressed) and zip (stored and
+ * deflate entries). Codecs are compiled in when the platform provides them;
+ * rac_archive_stream_supported() reports what this build can handle.
+ *
+ * Entries are written under the destination directory. Absolute paths, ".."
+ * components and links are skipped.
+ */
+
+#ifndef RAC_ARCHIVE_STREAM_H
+#define RAC_ARCHIVE_STREAM_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+#include "rac/infrastructure/model_management/rac_model_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque handle for a streaming extraction.
+ */
+typedef struct rac_archive_stream* rac_archive_stream_handle_t;
+
+/**
+ * @brief Whether this build can stream-extract an archive type.
+ */
+RAC_API rac_bool_t rac_archive_stream_supported(rac_archive_type_t type);
+
+/**
+ * @brief Start extracting an archive into a directory.
+ *
+ * @param type Archive type
+ * @param destination_dir Directory to extract into (created if missing)
+ * @param out_handle Output: Stream handle
+ * @return RAC_SUCCESS, RAC_ERROR_UNSUPPORTED_ARCHIVE if this build lacks the codec,
+ *         or error code
+ */
+RAC_API rac_result_t rac_archive_stream_create(rac_archive_type_t type,
+                                               const char* destination_dir,
+                                               rac_archive_stream_handle_t* out_handle);
+
+/**
+ * @brief Feed the next bytes of the archive.
+ *
+ * Bytes must arrive in archive order; any chunk size works.
+ *
+ * @return RAC_SUCCESS, or error code (the stream stays failed afterwards)
+ */
+RAC_API rac_result_t rac_archive_stream_write(rac_archive_stream_handle_t handle,
+                                              const void* data, size_t size);
+
+/**
+ * @brief Finish extraction after the last byte.
+ *
+ * @param handle Stream handle
+ * @param out_file_count Output: Number of files written (can be NULL)
+ * @return RAC_SUCCESS, or RAC_ERROR_EXTRACTION_FAILED if the archive was truncated
+ */
+RAC_API rac_result_t rac_archive_stream_finish(rac_archive_stream_handle_t handle,
+                                               int32_t* out_file_count);
+
+/**
+ * @brief Destroy a stream; files written so far are left in place.
+ */
+RAC_API void rac_archive_stream_destroy(rac_archive_stream_handle_t handle);
+
+/**
+ * @brief Extract an archive file with the streaming extractor.
+ *
+ * @param archive_path Archive on disk
+ * @param type Archive type
+ * @param destination_dir Directory to extract into
+ * @param out_file_count Output: Number of files written (can be NULL)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_archive_extract_file(const char* archive_path, rac_archive_type_t type,
+                                              const char* destination_dir,
+                                              int32_t* out_file_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_ARCHIVE_STREAM_H */
@@ -14,6 +14,14 @@
  * - State management
  * - Retry logic
  * - Post-download extraction
+ *
+ * Alternatively rac_download_manager_transfer() runs the transfer natively over
+ * the registered HTTP executor, using parallel Range requests.
+ *
+ * Tasks are scheduled by priority: at most max_concurrent_downloads of them
+ * may transfer at once, a higher-priority task takes the slot of a lower one,
+ * and the network reported with rac_download_manager_set_network decides which
+ * tasks may run at all.
  */
 
 #ifndef RAC_DOWNLOAD_H
@@ -74,6 +82,25 @@ RAC_API const char* rac_download_stage_display_name(rac_download_stage_t stage);
 RAC_API void rac_download_stage_progress_range(rac_download_stage_t stage, double* out_start,
                                                double* out_end);
 
+/**
+ * @brief Download priority classes.
+ */
+typedef enum rac_download_priority {
+    RAC_DOWNLOAD_PRIORITY_BACKGROUND = 0,     /**< Prefetch nobody is waiting for */
+    RAC_DOWNLOAD_PRIORITY_NORMAL = 1,         /**< Default */
+    RAC_DOWNLOAD_PRIORITY_USER_INITIATED = 2  /**< The user is waiting for it */
+} rac_download_priority_t;
+
+/**
+ * @brief Network the device is currently on.
+ */
+typedef enum rac_download_network {
+    RAC_DOWNLOAD_NETWORK_OFFLINE = 0,     /**< No connectivity */
+    RAC_DOWNLOAD_NETWORK_UNMETERED = 1,   /**< Wi-Fi or Ethernet */
+    RAC_DOWNLOAD_NETWORK_CELLULAR = 2,    /**< Metered mobile data */
+    RAC_DOWNLOAD_NETWORK_CONSTRAINED = 3  /**< Low Data Mode / Data Saver */
+} rac_download_network_t;
+
 /**
  * @brief Download progress information.
  * Mirrors Swift's DownloadProgress struct.
@@ -175,18 +202,36 @@ typedef struct rac_download_config {
 
     /** Whether to allow downloads on low data mode (default: false) */
     rac_bool_t allow_constrained_network;
+
+    /** Parallel Range requests per native transfer (default: 4) */
+    int32_t connections_per_download;
+
+    /** Bytes per Range request in a native transfer (default: 4 MB) */
+    int64_t segment_size_bytes;
+
+    /** Background downloads larger than this wait for an unmetered network (0 = no limit,
+     *  default: 100 MB) */
+    int64_t background_unmetered_only_bytes;
+
+    /** Rate cap for background native transfers on a metered network in bytes per second
+     *  (0 = unlimited, default: 0) */
+    int64_t background_metered_bytes_per_second;
 } rac_download_config_t;
 
 /**
  * @brief Default download configuration.
  */
-static const rac_download_config_t RAC_DOWNLOAD_CONFIG_DEFAULT = {.max_concurrent_downloads = 1,
-                                                                  .request_timeout_seconds = 60,
-                                                                  .max_retry_attempts = 3,
-                                                                  .retry_delay_seconds = 5,
-                                                                  .allow_cellular = RAC_TRUE,
-                                                                  .allow_constrained_network =
-                                                                      RAC_FALSE};
+static const rac_download_config_t RAC_DOWNLOAD_CONFIG_DEFAULT = {
+    .max_concurrent_downloads = 1,
+    .request_timeout_seconds = 60,
+    .max_retry_attempts = 3,
+    .retry_delay_seconds = 5,
+    .allow_cellular = RAC_TRUE,
+    .allow_constrained_network = RAC_FALSE,
+    .connections_per_download = 4,
+    .segment_size_bytes = 4 * 1024 * 1024,
+    .background_unmetered_only_bytes = 100 * 1024 * 1024,
+    .background_metered_bytes_per_second = 0};
 
 // =============================================================================
 // CALLBACKS
@@ -252,6 +297,7 @@ RAC_API void rac_download_manager_destroy(rac_download_manager_handle_t handle);
  *
  * Mirrors Swift's DownloadService.downloadModel(_:).
  * The actual HTTP download is performed by the platform adapter.
+ * The task gets RAC_DOWNLOAD_PRIORITY_NORMAL; see rac_download_manager_set_priority.
  *
  * @param handle Manager handle
  * @param model_id Model identifier
@@ -288,6 +334,7 @@ RAC_API rac_result_t rac_download_manager_cancel(rac_download_manager_handle_t h
  * @brief Pause all active downloads.
  *
  * Mirrors Swift's AlamofireDownloadService.pauseAll().
+ * Native transfers wait after their in-flight segments until resume_all.
  *
  * @param handle Manager handle
  * @return RAC_SUCCESS or error code
@@ -304,6 +351,63 @@ RAC_API rac_result_t rac_download_manager_pause_all(rac_download_manager_handle_
  */
 RAC_API rac_result_t rac_download_manager_resume_all(rac_download_manager_handle_t handle);
 
+// =============================================================================
+// SCHEDULING API
+// =============================================================================
+
+/**
+ * @brief Change a task's priority.
+ *
+ * Pending, downloading and retrying tasks are ordered by priority, then by
+ * start order, and the first max_concurrent_downloads the network allows may
+ * transfer. A task that loses its slot is preempted: its native transfer
+ * finishes the in-flight segments, reports RAC_DOWNLOAD_STATE_PENDING and
+ * waits, keeping what it has downloaded.
+ * A task holds its slot until it completes, fails or is cancelled, including
+ * while it is RETRYING.
+ *
+ * @param handle Manager handle
+ * @param task_id Task ID
+ * @param priority New priority
+ * @return RAC_SUCCESS or error code (RAC_ERROR_NOT_FOUND if task doesn't exist)
+ */
+RAC_API rac_result_t rac_download_manager_set_priority(rac_download_manager_handle_t handle,
+                                                       const char* task_id,
+                                                       rac_download_priority_t priority);
+
+/**
+ * @brief Report a connectivity change.
+ *
+ * Platform adapters call this from their connectivity listener; the manager
+ * assumes an unmetered network until told otherwise. Offline stops every
+ * task. Cellular needs allow_cellular and constrained needs
+ * allow_constrained_network; on either, background tasks larger than
+ * background_unmetered_only_bytes wait for Wi-Fi and background native
+ * transfers are capped at background_metered_bytes_per_second. Changes of
+ * online state are emitted as RAC_EVENT_NETWORK_CONNECTIVITY_CHANGED.
+ *
+ * @param handle Manager handle
+ * @param network Current network
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_download_manager_set_network(rac_download_manager_handle_t handle,
+                                                      rac_download_network_t network);
+
+/**
+ * @brief Check whether a task may transfer now.
+ *
+ * Native transfers wait on their own; platform adapters that download
+ * themselves should hold off while this is RAC_FALSE.
+ *
+ * @param handle Manager handle
+ * @param task_id Task ID
+ * @param out_may_transfer Output: RAC_TRUE if the task has a slot
+ * @return RAC_SUCCESS or error code (RAC_ERROR_NOT_FOUND if task doesn't exist)
+ */
+RAC_API rac_result_t rac_download_manager_may_transfer(rac_download_manager_handle_t handle,
+                                                       const char* task_id,
+                                                       rac_bool_t* out_may_transfer);
+
 // =============================================================================
 // STATUS API
 // =============================================================================
@@ -392,6 +496,50 @@ RAC_API rac_result_t rac_download_manager_mark_failed(rac_download_manager_handl
                                                       const char* task_id, rac_result_t error_code,
                                                       const char* error_message);
 
+// =============================================================================
+// NATIVE TRANSFER API
+// =============================================================================
+
+/**
+ * @brief Download a task's URL natively.
+ *
+ * Splits the file into segment_size_bytes Range requests and runs
+ * connections_per_download of them at a time through the executor registered
+ * with rac_http_set_executor. Segments are written in place into
+ * "<destination>.part", preallocated to the full size, and finished segments
+ * are recorded in "<destination>.part.state". A later transfer of the same URL
+ * to the same destination (even from a new task or process) fetches only the
+ * missing segments. Servers without Range support are fetched in one request.
+ *
+ * When the task requires extraction and this build can stream its archive type
+ * (see rac_archive_stream_supported), segments are fetched in order, at most
+ * 2 * connections_per_download ahead of the extractor, and unpacked into the
+ * destination's directory as they arrive. No archive is stored, the task
+ * completes with that directory without an extraction stage, and an
+ * interrupted transfer starts over.
+ *
+ * When the task's model is registered with a sha256, the file is hashed in
+ * order as segments are written (out-of-order segments are read back from
+ * the page cache once the gap before them fills), so completion needs no
+ * extra read of the file. A mismatch fails the task with
+ * RAC_ERROR_CHECKSUM_MISMATCH and discards the partial file.
+ *
+ * The transfer waits until the task has a slot (see
+ * rac_download_manager_set_priority), and pauses between segments when it
+ * loses it, is paused with rac_download_manager_pause_all or the network
+ * no longer allows it.
+ *
+ * Blocks until the transfer ends, so call it from a background thread. Reports
+ * through rac_download_manager_update_progress and then mark_complete or
+ * mark_failed; cancelling the task stops it after the in-flight segments.
+ *
+ * @param handle Manager handle
+ * @param task_id Task created with rac_download_manager_start
+ * @return RAC_SUCCESS, RAC_ERROR_CANCELLED, or error code
+ */
+RAC_API rac_result_t rac_download_manager_transfer(rac_download_manager_handle_t handle,
+                                                   const char* task_id);
+
 // =============================================================================
 // MEMORY MANAGEMENT
 // =============================================================================
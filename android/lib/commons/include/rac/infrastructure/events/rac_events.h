@@ -8,6 +8,11 @@
  *
  * Events are categorized and can be routed to different destinations
  * (public EventBus or analytics).
+ *
+ * Publishing never calls subscribers directly: the event is copied onto a
+ * lock-free queue and delivered on a dedicated dispatcher thread, so
+ * inference threads do not wait for slow subscribers (e.g. JNI callbacks)
+ * and a subscriber may publish from its callback.
  */
 
 #ifndef RAC_EVENTS_H
@@ -100,6 +105,38 @@ typedef struct rac_event {
  */
 typedef void (*rac_event_callback_fn)(const rac_event_t* event, void* user_data);
 
+/**
+ * What a subscriber gets when events queue up faster than it handles them.
+ */
+typedef enum rac_event_backpressure {
+    /** Deliver every event (default) */
+    RAC_EVENT_BACKPRESSURE_NONE = 0,
+    /** Beyond max_pending queued events, drop the oldest ones */
+    RAC_EVENT_BACKPRESSURE_DROP = 1,
+    /** Beyond max_pending queued events, deliver only the newest of each type */
+    RAC_EVENT_BACKPRESSURE_COALESCE = 2,
+} rac_event_backpressure_t;
+
+/**
+ * Subscription options.
+ */
+typedef struct rac_event_subscription_options {
+    /** Receive every category (the category argument is ignored) */
+    rac_bool_t all_categories;
+
+    /** Policy once more than max_pending events wait for this subscriber */
+    rac_event_backpressure_t backpressure;
+
+    /** Queued events tolerated before the policy applies */
+    uint32_t max_pending;
+} rac_event_subscription_options_t;
+
+/**
+ * Default options (one category, every event delivered)
+ */
+static const rac_event_subscription_options_t RAC_EVENT_SUBSCRIPTION_OPTIONS_DEFAULT = {
+    .all_categories = RAC_FALSE, .backpressure = RAC_EVENT_BACKPRESSURE_NONE, .max_pending = 0};
+
 // =============================================================================
 // EVENT API
 // =============================================================================
@@ -112,8 +149,8 @@ typedef void (*rac_event_callback_fn)(const rac_event_t* event, void* user_data)
  * @param user_data User data passed to the callback
  * @return Subscription ID (0 on failure), use with rac_event_unsubscribe
  *
- * @note The callback is invoked on the thread that publishes the event.
- *       Keep callback execution fast to avoid blocking.
+ * @note The callback is invoked on the event dispatcher thread, in publish
+ *       order. A slow callback delays later events for every subscriber.
  */
 RAC_API uint64_t rac_event_subscribe(rac_event_category_t category, rac_event_callback_fn callback,
                                      void* user_data);
@@ -127,9 +164,25 @@ RAC_API uint64_t rac_event_subscribe(rac_event_category_t category, rac_event_ca
  */
 RAC_API uint64_t rac_event_subscribe_all(rac_event_callback_fn callback, void* user_data);
 
+/**
+ * Subscribes with a backpressure policy.
+ *
+ * @param category The category to subscribe to
+ * @param callback The callback function to invoke
+ * @param user_data User data passed to the callback
+ * @param options Subscription options (NULL for defaults)
+ * @return Subscription ID (0 on failure)
+ */
+RAC_API uint64_t rac_event_subscribe_with_options(rac_event_category_t category,
+                                                  rac_event_callback_fn callback, void* user_data,
+                                                  const rac_event_subscription_options_t* options);
+
 /**
  * Unsubscribes from events.
  *
+ * When called outside a callback, waits for a delivery to this subscription
+ * in progress, so user_data may be freed once it returns.
+ *
  * @param subscription_id The subscription ID returned from subscribe
  */
 RAC_API void rac_event_unsubscribe(uint64_t subscription_id);
@@ -140,11 +193,35 @@ RAC_API void rac_event_unsubscribe(uint64_t subscription_id);
  * This is called by the commons library to publish events.
  * Swift's EventBridge subscribes to receive and re-publish to Swift consumers.
  *
+ * The event and its strings are copied; delivery happens later on the
+ * dispatcher thread. Never blocks on subscribers.
+ *
  * @param event The event to publish
- * @return RAC_SUCCESS on success, or an error code on failure
+ * @return RAC_SUCCESS on success, RAC_ERROR_OUT_OF_MEMORY if the queue is full
  */
 RAC_API rac_result_t rac_event_publish(const rac_event_t* event);
 
+/**
+ * Waits until every event published before the call has been delivered.
+ *
+ * @param timeout_ms Maximum wait in milliseconds (< 0 waits without limit)
+ * @return RAC_SUCCESS, RAC_ERROR_TIMEOUT, or RAC_ERROR_INVALID_STATE when
+ *         called from a subscriber callback
+ */
+RAC_API rac_result_t rac_event_flush(int32_t timeout_ms);
+
+/**
+ * Checks whether any subscription receives events of a category.
+ *
+ * One relaxed atomic load, no lock. Publishers building event properties
+ * call it first; rac_event_publish and rac_event_track drop events of
+ * unsubscribed categories the same way.
+ *
+ * @param category The event category
+ * @return RAC_TRUE if a subscription covers the category, RAC_FALSE otherwise
+ */
+RAC_API rac_bool_t rac_event_has_subscribers(rac_event_category_t category);
+
 /**
  * Track an event (convenience function matching Swift's EventPublisher.track).
  *
@@ -0,0 +1,104 @@
+/**
+ * @file rac_gguf_metadata.h
+ * @brief GGUF Model Metadata Without Loading the Model
+ *
+ * Reads architecture, parameter count, quantization, context length and
+ * chat template from a GGUF file's header. The file is memory-mapped and
+ * only the header pages are read, so this takes milliseconds where loading
+ * the model through llama.cpp takes seconds and maps every weight. The
+ * result also carries the memory profile that rac_model_fit_estimate takes.
+ */
+
+#ifndef RAC_GGUF_METADATA_H
+#define RAC_GGUF_METADATA_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+#include "rac/infrastructure/model_management/rac_model_fit.h"
+#include "rac/infrastructure/model_management/rac_model_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Metadata from a GGUF header
+ *
+ * Strings are owned and freed by rac_gguf_metadata_free; each is NULL when
+ * the header does not have its key.
+ */
+typedef struct rac_gguf_metadata {
+    /** GGUF format version (2 or 3) */
+    uint32_t version;
+
+    /** general.architecture, e.g. "llama", "qwen2" */
+    char* architecture;
+
+    /** general.name */
+    char* name;
+
+    /** Quantization from general.file_type, e.g. "q4_k_m" (registry spelling) */
+    char* quantization;
+
+    /** tokenizer.chat_template (Jinja) */
+    char* chat_template;
+
+    /** general.file_type (llama_ftype), -1 if absent */
+    int32_t file_type;
+
+    /** Number of tensors in the file */
+    int64_t tensor_count;
+
+    /** Whether the chat template has a <think> reasoning block */
+    rac_bool_t supports_thinking;
+
+    /** Sizes and geometry for the fit predictor; includes parameter count
+        and trained context length */
+    rac_model_memory_profile_t profile;
+} rac_gguf_metadata_t;
+
+// =============================================================================
+// API
+// =============================================================================
+
+/**
+ * @brief Read the metadata of a local GGUF file or model folder
+ *
+ * A folder is searched like rac_model_memory_profile_read_file does.
+ *
+ * @param path File or folder path
+ * @param out_metadata Output: Metadata (free with rac_gguf_metadata_free)
+ * @return RAC_SUCCESS, RAC_ERROR_FILE_NOT_FOUND, RAC_ERROR_FILE_READ_FAILED,
+ *         RAC_ERROR_INVALID_FORMAT if the file is not a complete GGUF header,
+ *         or RAC_ERROR_OUT_OF_MEMORY
+ */
+RAC_API rac_result_t rac_gguf_metadata_read(const char* path, rac_gguf_metadata_t* out_metadata);
+
+/**
+ * @brief Fill fields of a model info that are unset from the metadata
+ *
+ * Sets format, and context_length, quantization, memory_required and
+ * supports_thinking when they are 0 / NULL / false. memory_required is the
+ * RAC_MODEL_FIT_CONFIG_DEFAULT estimate.
+ *
+ * @param metadata Metadata from rac_gguf_metadata_read
+ * @param model Model info to update
+ * @return RAC_SUCCESS, RAC_ERROR_INVALID_ARGUMENT or RAC_ERROR_OUT_OF_MEMORY
+ */
+RAC_API rac_result_t rac_gguf_metadata_apply(const rac_gguf_metadata_t* metadata,
+                                             rac_model_info_t* model);
+
+/**
+ * @brief Free the strings of a metadata struct and zero it
+ */
+RAC_API void rac_gguf_metadata_free(rac_gguf_metadata_t* metadata);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_GGUF_METADATA_H */
@@ -32,6 +32,8 @@ typedef struct rac_assignment_http_response {
     const char* response_body;  // Response JSON (must remain valid during processing)
     size_t response_length;     // Length of response body
     const char* error_message;  // Error message (can be NULL)
+    const char* etag;           // ETag response header (can be NULL)
+    const char* last_modified;  // Last-Modified response header (can be NULL)
 } rac_assignment_http_response_t;
 
 /**
@@ -46,6 +48,24 @@ typedef rac_result_t (*rac_assignment_http_get_fn)(const char* endpoint, rac_boo
                                                    rac_assignment_http_response_t* out_response,
                                                    void* user_data);
 
+/**
+ * Make a conditional HTTP GET request for model assignments
+ *
+ * Sends If-None-Match / If-Modified-Since for the non-NULL validators. An
+ * unchanged catalog is reported as status_code 304 with no body.
+ *
+ * @param endpoint Endpoint path
+ * @param requires_auth Whether authentication header is required
+ * @param if_none_match ETag of the cached response (can be NULL)
+ * @param if_modified_since Last-Modified of the cached response (can be NULL)
+ * @param out_response Output parameter for response
+ * @param user_data User-provided context
+ * @return RAC_SUCCESS on success, error code otherwise
+ */
+typedef rac_result_t (*rac_assignment_http_get_conditional_fn)(
+    const char* endpoint, rac_bool_t requires_auth, const char* if_none_match,
+    const char* if_modified_since, rac_assignment_http_response_t* out_response, void* user_data);
+
 /**
  * @brief Callback structure for model assignment operations
  */
@@ -56,8 +76,17 @@ typedef struct rac_assignment_callbacks {
     /** User data passed to all callbacks */
     void* user_data;
 
-    /** If true, automatically fetch models after callbacks are registered */
+    /** If true, fetch models through the outbound queue after callbacks are
+        registered; set_callbacks returns without waiting for the network */
     rac_bool_t auto_fetch;
+
+    /** Receives the "telemetry_policy" object of a fetched response, e.g. for
+        rac_telemetry_manager_set_policy_json (optional) */
+    void (*on_telemetry_policy)(const char* policy_json, size_t length, void* user_data);
+
+    /** Make a conditional HTTP GET request (optional; without it a cached
+        response is always downloaded again) */
+    rac_assignment_http_get_conditional_fn http_get_conditional;
 } rac_assignment_callbacks_t;
 
 // =============================================================================
@@ -100,6 +129,19 @@ rac_model_assignment_set_callbacks(const rac_assignment_callbacks_t* callbacks);
 RAC_API rac_result_t rac_model_assignment_fetch(rac_bool_t force_refresh,
                                                 rac_model_info_t*** out_models, size_t* out_count);
 
+/**
+ * @brief Get all cached model assignments
+ *
+ * Models are in the order the backend returned them. Does not make network
+ * request.
+ *
+ * @param out_models Output array of model infos (caller must free)
+ * @param out_count Number of models returned
+ * @return RAC_SUCCESS on success, error code otherwise
+ */
+RAC_API rac_result_t rac_model_assignment_get_cached(rac_model_info_t*** out_models,
+                                                     size_t* out_count);
+
 /**
  * @brief Get cached model assignments for a specific framework
  *
@@ -133,7 +175,8 @@ RAC_API rac_result_t rac_model_assignment_get_by_category(rac_model_category_t c
 /**
  * @brief Clear model assignment cache
  *
- * Clears the in-memory cache. Next fetch will make network request.
+ * Clears the in-memory cache and the disk cache, if one is set. Next fetch
+ * will make network request.
  */
 RAC_API void rac_model_assignment_clear_cache(void);
 
@@ -146,6 +189,23 @@ RAC_API void rac_model_assignment_clear_cache(void);
  */
 RAC_API void rac_model_assignment_set_cache_timeout(uint32_t timeout_seconds);
 
+/**
+ * @brief Persist fetched assignments to disk
+ *
+ * The response body is stored at path, and its ETag, Last-Modified and fetch
+ * time at "<path>.meta". A stored response is loaded immediately, so models
+ * are available at launch before any network request. Once it is older than
+ * the cache timeout, fetch still returns it at once and revalidates it in the
+ * background with a conditional GET; a 304 keeps it.
+ *
+ * Call after rac_model_assignment_set_callbacks so telemetry policy from the
+ * stored response is applied.
+ *
+ * @param path Cache file path (NULL to stop persisting)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_assignment_set_cache_path(const char* path);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,146 @@
+/**
+ * @file rac_model_delta.h
+ * @brief Delta Updates Between Model Revisions
+ *
+ * A new revision of a model (requantized weights, an updated tokenizer)
+ * usually shares most of its bytes with the old one, often at shifted
+ * offsets. Files are split with content-defined chunking (a gear rolling
+ * hash picks cut points from the content itself; chunks are 16-256 KB,
+ * about 80 KB on average), so an insertion only changes the chunks around it.
+ *
+ * The server publishes a chunk manifest for each revision, built with
+ * rac_model_delta_manifest_create and rac_model_delta_manifest_save. The
+ * client chunks its local copy of the old revision, copies every chunk the
+ * new manifest shares with it, and fetches only the rest with Range
+ * requests over the registered HTTP executor. Every chunk and the whole
+ * file are checked against the manifest's SHA-256 digests.
+ */
+
+#ifndef RAC_MODEL_DELTA_H
+#define RAC_MODEL_DELTA_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_sha256.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief One content-defined chunk of a file
+ */
+typedef struct rac_model_delta_chunk {
+    int64_t offset;
+    int32_t length;
+    uint8_t sha256[RAC_SHA256_DIGEST_SIZE];
+} rac_model_delta_chunk_t;
+
+/**
+ * @brief Chunk manifest of one file revision
+ */
+typedef struct rac_model_delta_manifest {
+    /** File size in bytes */
+    int64_t file_size;
+
+    /** SHA-256 of the whole file */
+    uint8_t sha256[RAC_SHA256_DIGEST_SIZE];
+
+    /** Chunks in file order */
+    rac_model_delta_chunk_t* chunks;
+    size_t chunk_count;
+} rac_model_delta_manifest_t;
+
+/**
+ * @brief What an update reused and fetched
+ */
+typedef struct rac_model_delta_stats {
+    int64_t reused_bytes;
+    int64_t fetched_bytes;
+    int32_t reused_chunks;
+    int32_t fetched_chunks;
+} rac_model_delta_stats_t;
+
+/**
+ * @brief Progress callback: bytes of the new file assembled so far
+ */
+typedef void (*rac_model_delta_progress_fn)(int64_t assembled_bytes, int64_t total_bytes,
+                                            void* user_data);
+
+// =============================================================================
+// MANIFEST API
+// =============================================================================
+
+/**
+ * @brief Chunk a file and build its manifest.
+ *
+ * @param file_path File to chunk
+ * @param out_manifest Output: Manifest (free with rac_model_delta_manifest_free)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_delta_manifest_create(const char* file_path,
+                                                     rac_model_delta_manifest_t** out_manifest);
+
+/**
+ * @brief Write a manifest in its binary form (36 bytes per chunk).
+ */
+RAC_API rac_result_t rac_model_delta_manifest_save(const rac_model_delta_manifest_t* manifest,
+                                                   const char* path);
+
+/**
+ * @brief Parse a manifest from its binary form.
+ *
+ * @param data Manifest bytes (as written by rac_model_delta_manifest_save)
+ * @param size Number of bytes
+ * @param out_manifest Output: Manifest (free with rac_model_delta_manifest_free)
+ * @return RAC_SUCCESS, RAC_ERROR_INVALID_FORMAT, or error code
+ */
+RAC_API rac_result_t rac_model_delta_manifest_parse(const void* data, size_t size,
+                                                    rac_model_delta_manifest_t** out_manifest);
+
+/**
+ * @brief Download and parse a manifest through the HTTP executor.
+ */
+RAC_API rac_result_t rac_model_delta_manifest_fetch(const char* url,
+                                                    rac_model_delta_manifest_t** out_manifest);
+
+/**
+ * @brief Free a manifest
+ */
+RAC_API void rac_model_delta_manifest_free(rac_model_delta_manifest_t* manifest);
+
+// =============================================================================
+// UPDATE API
+// =============================================================================
+
+/**
+ * @brief Assemble a new revision from the old file plus the changed chunks.
+ *
+ * Writes "<destination>.part" and renames it to destination once the whole
+ * file matches the manifest, so destination may be old_path itself. Blocks
+ * until done; call it from a background thread.
+ *
+ * @param old_path Local file of the previous revision
+ * @param manifest Manifest of the new revision
+ * @param new_url URL of the new revision (must support Range requests)
+ * @param destination_path Where to put the new revision
+ * @param progress_callback Progress callback (can be NULL)
+ * @param user_data User data for the callback
+ * @param out_stats Output: What was reused and fetched (can be NULL)
+ * @return RAC_SUCCESS, RAC_ERROR_CHECKSUM_MISMATCH, or error code
+ */
+RAC_API rac_result_t rac_model_delta_update(const char* old_path,
+                                            const rac_model_delta_manifest_t* manifest,
+                                            const char* new_url, const char* destination_path,
+                                            rac_model_delta_progress_fn progress_callback,
+                                            void* user_data, rac_model_delta_stats_t* out_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_MODEL_DELTA_H */
@@ -0,0 +1,237 @@
+/**
+ * @file rac_model_fit.h
+ * @brief Memory Fit Prediction for Models
+ *
+ * rac_storage_analyzer_check_available only says whether a model fits on
+ * disk. This predicts whether it fits in RAM once loaded, before anything is
+ * downloaded: the GGUF header (architecture, tensor types and shapes) is read
+ * from the local file or fetched with a Range request, and the resident size
+ * of the weights, the KV cache for the chosen context and KV type, and the
+ * compute buffers is compared with the memory reported by the device manager.
+ *
+ * Estimates follow llama.cpp's allocations and are approximate; ONNX models
+ * are estimated from their file size.
+ */
+
+#ifndef RAC_MODEL_FIT_H
+#define RAC_MODEL_FIT_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+#include "rac/infrastructure/model_management/rac_model_registry.h"
+#include "rac/infrastructure/model_management/rac_model_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Element type of the KV cache
+ */
+typedef enum rac_kv_cache_type {
+    RAC_KV_CACHE_F16 = 0,  /**< llama.cpp default */
+    RAC_KV_CACHE_F32 = 1,
+    RAC_KV_CACHE_Q8_0 = 2, /**< 8.5 bits per element */
+    RAC_KV_CACHE_Q4_0 = 3  /**< 4.5 bits per element */
+} rac_kv_cache_type_t;
+
+/**
+ * @brief What a model needs in memory, independent of how it is run
+ *
+ * Geometry fields are 0 when unknown; without layer_count no KV cache is
+ * estimated.
+ */
+typedef struct rac_model_memory_profile {
+    rac_model_format_t format;
+
+    /** File size in bytes (0 if unknown) */
+    int64_t file_size;
+
+    /** Number of weights (0 if unknown) */
+    int64_t parameter_count;
+
+    /** Size of the weights as stored, in bytes */
+    int64_t weights_bytes;
+
+    /** Context length the model was trained with */
+    int32_t trained_context_length;
+
+    int32_t layer_count;
+    int32_t embedding_length;
+    int32_t head_count;
+    int32_t head_count_kv;
+
+    /** Per-head key and value sizes */
+    int32_t key_length;
+    int32_t value_length;
+
+    int32_t vocab_size;
+} rac_model_memory_profile_t;
+
+/**
+ * @brief How a model would be run
+ */
+typedef struct rac_model_fit_config {
+    /** Context length in tokens (0 = the model's context_length, at most 4096) */
+    int32_t context_length;
+
+    /** KV cache element type */
+    rac_kv_cache_type_t kv_type;
+
+    /** Tokens evaluated per batch; sizes the compute buffers */
+    int32_t batch_size;
+
+    /** Share of total RAM the app can keep resident before the OS kills it */
+    float max_memory_fraction;
+} rac_model_fit_config_t;
+
+static const rac_model_fit_config_t RAC_MODEL_FIT_CONFIG_DEFAULT = {
+    .context_length = 0,
+    .kv_type = RAC_KV_CACHE_F16,
+    .batch_size = 512,
+    .max_memory_fraction = 0.6f};
+
+/**
+ * @brief Verdict of a fit check
+ */
+typedef enum rac_model_fit {
+    RAC_MODEL_FIT_UNKNOWN = 0,   /**< Device memory not known */
+    RAC_MODEL_FIT_OK = 1,        /**< Fits in the memory available now */
+    RAC_MODEL_FIT_TIGHT = 2,     /**< Fits the budget but not the available memory: pages out */
+    RAC_MODEL_FIT_TOO_LARGE = 3  /**< Exceeds the budget: the OS would kill the app */
+} rac_model_fit_t;
+
+/**
+ * @brief Estimated memory use and verdict
+ */
+typedef struct rac_model_fit_result {
+    rac_model_fit_t fit;
+
+    /** Context length the estimate is for */
+    int32_t context_length;
+
+    int64_t weights_bytes;
+    int64_t kv_cache_bytes;
+
+    /** Compute buffers and runtime overhead */
+    int64_t compute_bytes;
+
+    /** Sum of the above */
+    int64_t total_bytes;
+
+    /** Memory budget (total RAM x max_memory_fraction) and available RAM, 0 if unknown */
+    int64_t budget_bytes;
+    int64_t available_bytes;
+
+    /** Longest context that fits (multiple of 256), 0 if none does */
+    int32_t max_context_length;
+} rac_model_fit_result_t;
+
+// =============================================================================
+// PROFILE API
+// =============================================================================
+
+/**
+ * @brief Read a profile from the start of a GGUF file.
+ *
+ * @param data First bytes of the file
+ * @param size Number of bytes
+ * @param file_size Size of the whole file (0 if unknown)
+ * @param out_profile Output: Profile
+ * @return RAC_SUCCESS, RAC_ERROR_INVALID_FORMAT, or RAC_ERROR_BUFFER_TOO_SMALL
+ *         if the header continues past size
+ */
+RAC_API rac_result_t rac_model_memory_profile_parse_gguf(const void* data, size_t size,
+                                                         int64_t file_size,
+                                                         rac_model_memory_profile_t* out_profile);
+
+/**
+ * @brief Read the profile of a local model file or model folder.
+ *
+ * A folder is searched for its first .gguf or .onnx file.
+ */
+RAC_API rac_result_t rac_model_memory_profile_read_file(const char* path,
+                                                        rac_model_memory_profile_t* out_profile);
+
+/**
+ * @brief Read the profile of a remote GGUF file through the HTTP executor.
+ *
+ * Fetches only the header with Range requests. Blocks; call it from a
+ * background thread.
+ */
+RAC_API rac_result_t rac_model_memory_profile_fetch(const char* url,
+                                                    rac_model_memory_profile_t* out_profile);
+
+/**
+ * @brief Rough profile from registry metadata alone (download size and
+ * context length), for models whose header cannot be read.
+ */
+RAC_API rac_result_t rac_model_memory_profile_from_info(const rac_model_info_t* model,
+                                                        rac_model_memory_profile_t* out_profile);
+
+// =============================================================================
+// FIT API
+// =============================================================================
+
+/**
+ * @brief Estimate the memory a profile needs and compare it with the device.
+ *
+ * @param profile Model profile
+ * @param config Run configuration (NULL = RAC_MODEL_FIT_CONFIG_DEFAULT)
+ * @param total_memory Total device RAM in bytes (0 if unknown)
+ * @param available_memory Available device RAM in bytes (0 if unknown)
+ * @param out_result Output: Estimate and verdict
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_fit_estimate(const rac_model_memory_profile_t* profile,
+                                            const rac_model_fit_config_t* config,
+                                            int64_t total_memory, int64_t available_memory,
+                                            rac_model_fit_result_t* out_result);
+
+/**
+ * @brief Check whether a registered model fits this device.
+ *
+ * Reads the profile from local_path if the model is downloaded, otherwise
+ * fetches the GGUF header from download_url, falling back to the registry
+ * metadata. Device memory comes from rac_device_manager_get_memory. May
+ * block on the network; call it from a background thread.
+ *
+ * @param model Model to check
+ * @param config Run configuration (NULL = RAC_MODEL_FIT_CONFIG_DEFAULT)
+ * @param out_result Output: Estimate and verdict
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_fit_check(const rac_model_info_t* model,
+                                         const rac_model_fit_config_t* config,
+                                         rac_model_fit_result_t* out_result);
+
+/**
+ * @brief Pick the best quantized variant of a model that fits this device.
+ *
+ * Checks the model and its variants (rac_model_registry_get_variants) from
+ * the highest quality down and returns the first whose verdict is
+ * RAC_MODEL_FIT_OK, or RAC_MODEL_FIT_UNKNOWN when device memory is not known.
+ *
+ * @param registry Registry handle
+ * @param model_id Model or any of its variants
+ * @param config Run configuration (NULL = RAC_MODEL_FIT_CONFIG_DEFAULT)
+ * @param out_model_id Output: Chosen model id (owned, free with rac_free)
+ * @param out_result Output: Estimate for the chosen model (can be NULL)
+ * @return RAC_SUCCESS, RAC_ERROR_NOT_FOUND, or RAC_ERROR_INSUFFICIENT_MEMORY
+ *         if no variant fits
+ */
+RAC_API rac_result_t rac_model_fit_select_variant(rac_model_registry_handle_t registry,
+                                                  const char* model_id,
+                                                  const rac_model_fit_config_t* config,
+                                                  char** out_model_id,
+                                                  rac_model_fit_result_t* out_result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_MODEL_FIT_H */
@@ -0,0 +1,190 @@
+/**
+ * @file rac_model_prefetch.h
+ * @brief Model Prefetch and Warm Cache Policy
+ *
+ * Predicts which models the user will need next from their usage history
+ * (last_used and usage_count, kept by rac_model_registry_update_last_used)
+ * and the backend's model assignments. The most likely models are
+ * downloaded ahead of time at background priority while the device is idle
+ * or charging. At launch, the files of the most likely downloaded model are
+ * read ahead into the page cache so the first inference does not stall on
+ * major page faults.
+ */
+
+#ifndef RAC_MODEL_PREFETCH_H
+#define RAC_MODEL_PREFETCH_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+#include "rac/infrastructure/download/rac_download.h"
+#include "rac/infrastructure/model_management/rac_model_registry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/**
+ * @brief Prefetch policy
+ */
+typedef struct rac_model_prefetch_config {
+    /** How many of the most likely models to keep downloaded */
+    int32_t max_models;
+
+    /** Most bytes one rac_model_prefetch_run may queue for download */
+    int64_t max_download_bytes;
+
+    /** Hours after which a use counts half as much */
+    float half_life_hours;
+
+    /** Download while the device is idle */
+    rac_bool_t download_when_idle;
+
+    /** Download while the device is charging */
+    rac_bool_t download_when_charging;
+
+    /** Most bytes rac_model_prefetch_warm reads ahead (also at most half
+        the available RAM, when known) */
+    int64_t warm_max_bytes;
+} rac_model_prefetch_config_t;
+
+static const rac_model_prefetch_config_t RAC_MODEL_PREFETCH_CONFIG_DEFAULT = {
+    .max_models = 2,
+    .max_download_bytes = 4LL * 1024 * 1024 * 1024,
+    .half_life_hours = 72.0f,
+    .download_when_idle = RAC_TRUE,
+    .download_when_charging = RAC_TRUE,
+    .warm_max_bytes = 1024LL * 1024 * 1024};
+
+/**
+ * @brief A model the user is likely to need
+ */
+typedef struct rac_model_prefetch_candidate {
+    char* model_id;
+
+    /** Likelihood score; only the order is meaningful */
+    double score;
+
+    rac_bool_t is_downloaded;
+} rac_model_prefetch_candidate_t;
+
+/** Opaque handle to a prefetch policy */
+typedef struct rac_model_prefetch* rac_model_prefetch_handle_t;
+
+// =============================================================================
+// LIFECYCLE API
+// =============================================================================
+
+/**
+ * @brief Create a prefetch policy.
+ *
+ * @param registry Registry to read usage from and record downloads in
+ * @param download_manager Manager to queue downloads with
+ * @param config Policy (NULL = RAC_MODEL_PREFETCH_CONFIG_DEFAULT)
+ * @param out_handle Output: Policy handle
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_prefetch_create(rac_model_registry_handle_t registry,
+                                               rac_download_manager_handle_t download_manager,
+                                               const rac_model_prefetch_config_t* config,
+                                               rac_model_prefetch_handle_t* out_handle);
+
+/**
+ * @brief Destroy a prefetch policy, cancelling the downloads it queued.
+ *
+ * Destroy it before the registry and download manager.
+ */
+RAC_API void rac_model_prefetch_destroy(rac_model_prefetch_handle_t handle);
+
+// =============================================================================
+// PREDICTION API
+// =============================================================================
+
+/**
+ * @brief Rank models by how likely the user is to need them next.
+ *
+ * Each use counts less the older it is (half_life_hours) and frequent use
+ * counts more. Assigned models get a smaller boost, in assignment order, so
+ * new assignments are ranked before models that were never used.
+ *
+ * @param handle Policy handle
+ * @param out_candidates Output: Candidates, most likely first (free with
+ *                       rac_model_prefetch_candidates_free)
+ * @param out_count Output: Number of candidates
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_prefetch_predict(rac_model_prefetch_handle_t handle,
+                                                rac_model_prefetch_candidate_t** out_candidates,
+                                                size_t* out_count);
+
+/**
+ * @brief Free candidates returned by rac_model_prefetch_predict
+ */
+RAC_API void rac_model_prefetch_candidates_free(rac_model_prefetch_candidate_t* candidates,
+                                                size_t count);
+
+// =============================================================================
+// DOWNLOAD API
+// =============================================================================
+
+/**
+ * @brief Report whether the device is idle and whether it is charging.
+ *
+ * Platform adapters call this from their power and activity listeners; the
+ * policy assumes neither until told. When no download window is open any
+ * more, the downloads it queued are cancelled. Native transfers keep their
+ * partial files and resume on the next run.
+ *
+ * @param handle Policy handle
+ * @param idle Device is idle
+ * @param charging Device is charging
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_prefetch_set_device_state(rac_model_prefetch_handle_t handle,
+                                                         rac_bool_t idle, rac_bool_t charging);
+
+/**
+ * @brief Queue downloads of the most likely models that are missing.
+ *
+ * Does nothing outside a download window. Skips models without a
+ * download URL, models already being prefetched, and models whose metadata
+ * says they cannot fit in this device's memory (see rac_model_fit.h). Tasks
+ * get RAC_DOWNLOAD_PRIORITY_BACKGROUND, so downloads the user starts go
+ * first and metered networks get the manager's background limits. The
+ * registry records each model's local path when its download completes.
+ * The caller runs the returned tasks like any other, e.g. with
+ * rac_download_manager_transfer.
+ *
+ * @param handle Policy handle
+ * @param out_task_ids Output: Tasks queued (free with rac_download_task_ids_free)
+ * @param out_count Output: Number of tasks
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_prefetch_run(rac_model_prefetch_handle_t handle,
+                                            char*** out_task_ids, size_t* out_count);
+
+// =============================================================================
+// WARM CACHE API
+// =============================================================================
+
+/**
+ * @brief Read the most likely downloaded model ahead into the page cache.
+ *
+ * Call at app launch. The read-ahead is asynchronous (posix_fadvise or
+ * F_RDADVISE), so this returns quickly.
+ *
+ * @param handle Policy handle
+ * @param out_model_id Output: Model warmed (owned, free with rac_free; can be NULL)
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_FOUND if no likely model is downloaded
+ */
+RAC_API rac_result_t rac_model_prefetch_warm(rac_model_prefetch_handle_t handle,
+                                             char** out_model_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_MODEL_PREFETCH_H */
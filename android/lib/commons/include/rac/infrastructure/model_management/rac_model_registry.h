@@ -8,6 +8,17 @@
  *
  * IMPORTANT: This is a direct translation of the Swift implementation.
  * Do NOT add features not present in the Swift code.
+ *
+ * The registry can persist itself to an index file (rac_model_registry_open_index).
+ * The next start maps that file once instead of re-registering and
+ * rediscovering every model, and reads use views into it (rac_model_registry_acquire)
+ * rather than copies.
+ *
+ * Listing reads an immutable snapshot of the registry that writers replace
+ * rather than change, so readers never wait for the registry lock and
+ * rac_model_registry_snapshot lists models without copying any of them.
+ * Each snapshot indexes its models by framework, category and download
+ * status, so filtered listings only visit the models they return.
  */
 
 #ifndef RAC_MODEL_REGISTRY_H
@@ -38,6 +49,30 @@ extern "C" {
  */
 typedef struct rac_model_registry* rac_model_registry_handle_t;
 
+/**
+ * @brief Opaque handle for a snapshot of the registry's models.
+ */
+typedef struct rac_model_snapshot* rac_model_snapshot_handle_t;
+
+/**
+ * @brief Filter for rac_model_registry_snapshot_query.
+ *
+ * A model matches when it is in one of the frameworks (if any are given),
+ * one of the categories (if any are given), and downloaded if requested.
+ */
+typedef struct rac_model_query {
+    /** Frameworks to match (NULL = any framework) */
+    const rac_inference_framework_t* frameworks;
+    size_t framework_count;
+
+    /** Categories to match (NULL = any category) */
+    const rac_model_category_t* categories;
+    size_t category_count;
+
+    /** Only models with a local path (see rac_model_info_is_downloaded) */
+    rac_bool_t downloaded_only;
+} rac_model_query_t;
+
 // =============================================================================
 // LIFECYCLE API
 // =============================================================================
@@ -53,10 +88,53 @@ RAC_API rac_result_t rac_model_registry_create(rac_model_registry_handle_t* out_
 /**
  * @brief Destroy a model registry instance.
  *
+ * Writes pending changes to the index, if one is open. Views must be
+ * released first.
+ *
  * @param handle Registry handle
  */
 RAC_API void rac_model_registry_destroy(rac_model_registry_handle_t handle);
 
+// =============================================================================
+// PERSISTENT INDEX API
+// =============================================================================
+
+/**
+ * @brief Load the registry index and keep it up to date from now on.
+ *
+ * The index holds every model's metadata, the size and mtime of its
+ * local_path, the results of discovery's folder checks and the storage
+ * analyzer's directory sizes. It is mapped with a single mmap and models
+ * borrow their strings from the mapping.
+ * Models already saved in this registry win over their index copies.
+ *
+ * Nothing is validated at load: a model's local_path is checked with one
+ * stat() when the model is first read, and dropped if the path is gone.
+ * rac_model_registry_discover_downloaded only lists and checks again the
+ * folders whose mtime changed since the index recorded them.
+ *
+ * A missing or damaged index is not an error; it is rewritten on the next
+ * flush.
+ *
+ * @param handle Registry handle
+ * @param index_path Index file path, e.g. inside the models directory
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_registry_open_index(rac_model_registry_handle_t handle,
+                                                   const char* index_path);
+
+/**
+ * @brief Write pending changes to the index.
+ *
+ * Changes are batched in memory. Call this after bulk updates, such as
+ * saving a fetched catalog or finishing a download. It is a no-op when
+ * nothing changed or no index is open. The file is replaced atomically.
+ *
+ * @param handle Registry handle
+ * @return RAC_SUCCESS or RAC_ERROR_FILE_WRITE_FAILED
+ */
+RAC_API rac_result_t rac_model_registry_flush_index(rac_model_registry_handle_t handle);
+
 // =============================================================================
 // MODEL INFO API - Mirrors Swift's ModelInfoService
 // =============================================================================
@@ -86,6 +164,31 @@ RAC_API rac_result_t rac_model_registry_save(rac_model_registry_handle_t handle,
 RAC_API rac_result_t rac_model_registry_get(rac_model_registry_handle_t handle,
                                             const char* model_id, rac_model_info_t** out_model);
 
+/**
+ * @brief Get a read-only view of model metadata, without copying it.
+ *
+ * The view stays valid and unchanged until it is released, even if the
+ * model is saved again or removed in the meantime; later changes create a
+ * new copy.
+ *
+ * @param handle Registry handle
+ * @param model_id Model identifier
+ * @param out_model Output: View (release with rac_model_registry_release, do not free)
+ * @return RAC_SUCCESS, RAC_ERROR_NOT_FOUND, or other error code
+ */
+RAC_API rac_result_t rac_model_registry_acquire(rac_model_registry_handle_t handle,
+                                                const char* model_id,
+                                                const rac_model_info_t** out_model);
+
+/**
+ * @brief Release a view returned by rac_model_registry_acquire.
+ *
+ * @param handle Registry handle
+ * @param model View to release
+ */
+RAC_API void rac_model_registry_release(rac_model_registry_handle_t handle,
+                                        const rac_model_info_t* model);
+
 /**
  * @brief Load all stored models.
  *
@@ -103,6 +206,7 @@ RAC_API rac_result_t rac_model_registry_get_all(rac_model_registry_handle_t hand
  * @brief Load models for specific frameworks.
  *
  * Mirrors Swift's ModelInfoService.loadModels(for:).
+ * Read from the snapshot's framework index, in model id order.
  *
  * @param handle Registry handle
  * @param frameworks Array of frameworks to filter by
@@ -144,6 +248,7 @@ RAC_API rac_result_t rac_model_registry_remove(rac_model_registry_handle_t handl
  * @brief Get downloaded models.
  *
  * Mirrors Swift's ModelInfoService.getDownloadedModels().
+ * Read from the snapshot's download index, in model id order.
  *
  * @param handle Registry handle
  * @param out_models Output: Array of model info (owned, each must be freed)
@@ -154,6 +259,24 @@ RAC_API rac_result_t rac_model_registry_get_downloaded(rac_model_registry_handle
                                                        rac_model_info_t*** out_models,
                                                        size_t* out_count);
 
+/**
+ * @brief Get a model and its quantized variants.
+ *
+ * Variants are models whose variant_of names the same base model; model_id may
+ * be the base model or any of its variants.
+ *
+ * @param handle Registry handle
+ * @param model_id Model identifier
+ * @param out_models Output: Base model and variants, best quality (most bits
+ *                   per weight) first (owned, each must be freed)
+ * @param out_count Output: Number of models
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_FOUND if model_id is not registered
+ */
+RAC_API rac_result_t rac_model_registry_get_variants(rac_model_registry_handle_t handle,
+                                                     const char* model_id,
+                                                     rac_model_info_t*** out_models,
+                                                     size_t* out_count);
+
 /**
  * @brief Update download status for a model.
  *
@@ -168,6 +291,104 @@ RAC_API rac_result_t rac_model_registry_update_download_status(rac_model_registr
                                                                const char* model_id,
                                                                const char* local_path);
 
+// =============================================================================
+// SNAPSHOT API
+// =============================================================================
+
+/**
+ * @brief Get every stored model as it is now, without copying any of them.
+ *
+ * The models are read-only and stay valid and unchanged until the snapshot
+ * is released, whatever is saved or removed in the meantime, and even after
+ * the registry is destroyed. Taking a snapshot does not wait for writers
+ * unless the models changed since the last one.
+ *
+ * @param handle Registry handle
+ * @param out_snapshot Output: Snapshot (release with rac_model_snapshot_release)
+ * @param out_models Output: Models in id order, owned by the snapshot (NULL if none)
+ * @param out_count Output: Number of models
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_registry_snapshot(rac_model_registry_handle_t handle,
+                                                 rac_model_snapshot_handle_t* out_snapshot,
+                                                 const rac_model_info_t* const** out_models,
+                                                 size_t* out_count);
+
+/**
+ * @brief Get the stored models matching a filter, without copying any of them.
+ *
+ * Like rac_model_registry_snapshot, limited to the models that match query.
+ * The filter is answered from the snapshot's indexes, so the cost grows with
+ * the number of models returned rather than the number stored.
+ *
+ * @param handle Registry handle
+ * @param query Filter (NULL matches every model)
+ * @param out_snapshot Output: Snapshot (release with rac_model_snapshot_release)
+ * @param out_models Output: Matching models in id order, owned by the snapshot (NULL if none)
+ * @param out_count Output: Number of models
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_registry_snapshot_query(rac_model_registry_handle_t handle,
+                                                       const rac_model_query_t* query,
+                                                       rac_model_snapshot_handle_t* out_snapshot,
+                                                       const rac_model_info_t* const** out_models,
+                                                       size_t* out_count);
+
+/**
+ * @brief Release a snapshot and the models it returned.
+ *
+ * @param snapshot Snapshot handle (can be NULL)
+ */
+RAC_API void rac_model_snapshot_release(rac_model_snapshot_handle_t snapshot);
+
+// =============================================================================
+// DIRECTORY SIZE CACHE API
+// =============================================================================
+
+/**
+ * @brief Get a directory's cached size.
+ *
+ * Sizes are kept in the index, so they survive restarts. A size is stale once
+ * the directory's mtime changes, or when a model under it or containing it is
+ * saved, removed or has its download status updated.
+ *
+ * @param handle Registry handle
+ * @param path Directory path
+ * @param out_size Output: Cached size in bytes
+ * @param out_mtime_ns Output: The directory's current mtime, to pass to
+ *                     rac_model_registry_set_dir_size (0 if it does not exist)
+ * @return RAC_SUCCESS, or RAC_ERROR_NOT_FOUND if no fresh size is cached
+ */
+RAC_API rac_result_t rac_model_registry_get_dir_size(rac_model_registry_handle_t handle,
+                                                     const char* path, int64_t* out_size,
+                                                     int64_t* out_mtime_ns);
+
+/**
+ * @brief Cache a directory's size.
+ *
+ * @param handle Registry handle
+ * @param path Directory path
+ * @param mtime_ns Directory mtime from rac_model_registry_get_dir_size, read
+ *                 before the size was measured
+ * @param size Size in bytes
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_model_registry_set_dir_size(rac_model_registry_handle_t handle,
+                                                     const char* path, int64_t mtime_ns,
+                                                     int64_t size);
+
+/**
+ * @brief Drop cached sizes that include a path.
+ *
+ * For changes the registry does not see, such as deleting files directly.
+ *
+ * @param handle Registry handle
+ * @param path Changed path; its ancestors' and subdirectories' sizes are also
+ *             dropped. NULL drops every size.
+ */
+RAC_API void rac_model_registry_invalidate_dir_size(rac_model_registry_handle_t handle,
+                                                    const char* path);
+
 // =============================================================================
 // QUERY HELPERS
 // =============================================================================
@@ -0,0 +1,130 @@
+/**
+ * @file rac_model_store.h
+ * @brief Content-Addressed Model Storage
+ *
+ * The same weights often arrive under several model IDs or framework
+ * folders, e.g. a voice bundle and a standalone STT model that ship the same
+ * whisper file. Each copy costs disk space, and page cache when it is
+ * mmapped.
+ *
+ * The store keeps one copy of each file under its SHA-256:
+ *
+ *   {base_dir}/RunAnywhere/Store/sha256/{first two hex}/{hex}
+ *
+ * Model folders hold hard links to the stored copy. All links share one
+ * inode, so the file is on disk once, and every model that maps it shares
+ * the same page-cache pages. The link count is the reference count. A
+ * stored copy whose only link is the store itself belongs to no model, and
+ * rac_model_store_prune deletes it.
+ *
+ * Stored files are made read-only. Writing through one link would change
+ * every model that shares the file. Updates that write a new file and
+ * rename it over the old one (downloads, delta updates) only replace that
+ * one link.
+ *
+ * A verified single-file download is added to the store automatically, with
+ * the checksum that was already computed. So is each file extracted from an
+ * archive while it downloads. Where hard links are not supported (a
+ * different filesystem, or a FAT-formatted external volume), files keep their
+ * own copies and still work.
+ */
+
+#ifndef RAC_MODEL_STORE_H
+#define RAC_MODEL_STORE_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/** Files smaller than this stay as copies when a folder is added */
+#define RAC_MODEL_STORE_MIN_FILE_SIZE (1024 * 1024)
+
+/**
+ * @brief Result of adding files to the store
+ */
+typedef struct rac_model_store_stats {
+    /** Files replaced by a link to a copy that was already stored */
+    int32_t files_linked;
+
+    /** Files that became the stored copy */
+    int32_t files_added;
+
+    /** Disk space released by linking */
+    int64_t bytes_saved;
+} rac_model_store_stats_t;
+
+// =============================================================================
+// API
+// =============================================================================
+
+/**
+ * @brief Get the store directory ({base_dir}/RunAnywhere/Store)
+ *
+ * @param out_path Output buffer
+ * @param path_size Size of output buffer
+ * @return RAC_SUCCESS, RAC_ERROR_NOT_INITIALIZED if no base directory is set,
+ *         or RAC_ERROR_BUFFER_TOO_SMALL
+ */
+RAC_API rac_result_t rac_model_store_get_directory(char* out_path, size_t path_size);
+
+/**
+ * @brief Share a model file through the store
+ *
+ * If a file with the same content is already stored, path is replaced by a
+ * link to it. Otherwise path becomes the stored copy. This is safe to call
+ * on a file that is already linked.
+ *
+ * @param path File inside the models directory
+ * @param sha256_hex SHA-256 of the file if known (e.g. verified while
+ *                   downloading), or NULL to hash it
+ * @param out_stats Optional output: what changed
+ * @return RAC_SUCCESS, RAC_ERROR_INVALID_ARGUMENT if path is not a regular
+ *         file in the models directory, RAC_ERROR_NOT_INITIALIZED,
+ *         RAC_ERROR_FILE_READ_FAILED, RAC_ERROR_CHECKSUM_MISMATCH if the
+ *         stored copy for the hash has a different size, or
+ *         RAC_ERROR_NOT_SUPPORTED if the filesystem has no hard links (the
+ *         file stays as it is in every failure case)
+ */
+RAC_API rac_result_t rac_model_store_add_file(const char* path, const char* sha256_hex,
+                                              rac_model_store_stats_t* out_stats);
+
+/**
+ * @brief Share every file of a folder through the store
+ *
+ * Recurses into subfolders. Files smaller than RAC_MODEL_STORE_MIN_FILE_SIZE
+ * and files that already have more than one link are skipped without being
+ * hashed, so a second pass over the same folder is cheap. Passing the models
+ * directory deduplicates every model already downloaded.
+ *
+ * @param folder Folder inside the models directory
+ * @param out_stats Optional output: what changed
+ * @return RAC_SUCCESS (files that cannot be shared are skipped),
+ *         RAC_ERROR_INVALID_ARGUMENT, RAC_ERROR_NOT_INITIALIZED or
+ *         RAC_ERROR_FILE_NOT_FOUND
+ */
+RAC_API rac_result_t rac_model_store_add_folder(const char* folder,
+                                                rac_model_store_stats_t* out_stats);
+
+/**
+ * @brief Delete stored copies that no model links to any more
+ *
+ * Call it after deleting models.
+ *
+ * @param out_removed Optional output: stored files deleted
+ * @param out_bytes_freed Optional output: bytes freed
+ * @return RAC_SUCCESS or RAC_ERROR_NOT_INITIALIZED
+ */
+RAC_API rac_result_t rac_model_store_prune(int32_t* out_removed, int64_t* out_bytes_freed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_MODEL_STORE_H */
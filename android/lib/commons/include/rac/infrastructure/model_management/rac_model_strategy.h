@@ -356,6 +356,11 @@ RAC_API rac_result_t rac_model_strategy_get_download_dest(rac_inference_framewor
 /**
  * @brief Post-process download using framework's strategy
  *
+ * Without a registered strategy, an archive is extracted into
+ * destination_folder when this build supports its type (see
+ * rac_archive_stream_supported) and is then deleted. A directory as
+ * downloaded_path means the transfer already extracted it.
+ *
  * @param framework Inference framework
  * @param config Download configuration
  * @param downloaded_path Path to downloaded file
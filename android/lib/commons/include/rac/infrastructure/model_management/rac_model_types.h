@@ -264,6 +264,23 @@ typedef struct rac_model_info {
 
     /** Usage count */
     int32_t usage_count;
+
+    /** ID of the model this one is a re-quantized variant of (NULL = not a variant) */
+    char* variant_of;
+
+    /** Weight quantization, e.g. "f16", "q8_0", "q5_0" (NULL = unknown) */
+    char* quantization;
+
+    /** Expected real-time factor (processing time / audio duration) on the
+        reference device, 0 if unknown; speech models only */
+    float expected_rtf;
+
+    /** Expected SHA-256 of the downloaded file as hex (NULL = not verified) */
+    char* sha256;
+
+    /** Chunk manifest for a delta update from an earlier revision (NULL = full
+        download only); see rac_model_delta.h */
+    char* delta_manifest_url;
 } rac_model_info_t;
 
 // =============================================================================
@@ -0,0 +1,182 @@
+/**
+ * @file rac_shared_weights.h
+ * @brief Reference-counted Cache of Loaded Model Weights
+ *
+ * Several consumers (the LLM component, the voice agent, the structured
+ * output path) can load the same model file, each paying for its weights.
+ * Backends load weights through this cache instead: consumers of the same
+ * file and load parameters get one shared weights object and create their
+ * own contexts on it. The weights are freed when the last consumer releases
+ * them.
+ *
+ * Entries are keyed by canonical path, modification time and size, so a
+ * model replaced on disk is loaded afresh while consumers of the old file
+ * keep theirs.
+ *
+ * C++ only; each backend keeps one cache per weights type.
+ */
+
+#ifndef RAC_SHARED_WEIGHTS_H
+#define RAC_SHARED_WEIGHTS_H
+
+#ifdef __cplusplus
+
+#include <sys/stat.h>
+
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace rac {
+
+/**
+ * @brief Shares loaded weights between consumers of the same model file.
+ *
+ * Usage:
+ *   static rac::SharedWeightsCache<llama_model> cache(llama_model_free);
+ *   llama_model* model = cache.acquire(path, "gpu=99", [&] {
+ *       return llama_model_load_from_file(path.c_str(), params);
+ *   });
+ *   ...
+ *   cache.release(model);
+ */
+template <typename T>
+class SharedWeightsCache {
+   public:
+    using Deleter = void (*)(T*);
+
+    explicit SharedWeightsCache(Deleter deleter) : deleter_(deleter) {}
+
+    SharedWeightsCache(const SharedWeightsCache&) = delete;
+    SharedWeightsCache& operator=(const SharedWeightsCache&) = delete;
+
+    /**
+     * Returns the weights of path loaded with the given parameters, calling
+     * load only if no consumer holds them. Concurrent acquires of the same
+     * weights wait for one load. Returns nullptr if load fails.
+     *
+     * @param path Model file
+     * @param variant Load parameters that change the weights object
+     *                (e.g. GPU offload); consumers differing here do not share
+     * @param load Loads the weights (nullptr on failure)
+     */
+    T* acquire(const std::string& path, const std::string& variant,
+               const std::function<T*()>& load) {
+        const std::string key = make_key(path, variant);
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (key.empty()) {
+            // Not stat-able: load privately rather than risk sharing the wrong file
+            lock.unlock();
+            T* weights = load();
+            lock.lock();
+            if (weights != nullptr) {
+                keys_[weights] = std::string();
+            }
+            return weights;
+        }
+
+        for (;;) {
+            auto it = entries_.find(key);
+            if (it == entries_.end()) {
+                break;
+            }
+            if (!it->second.loading) {
+                it->second.refs++;
+                return it->second.weights;
+            }
+            loaded_cv_.wait(lock);
+        }
+
+        entries_[key].loading = true;
+        lock.unlock();
+        T* weights = load();
+        lock.lock();
+
+        if (weights == nullptr) {
+            entries_.erase(key);
+        } else {
+            Entry& entry = entries_[key];
+            entry.weights = weights;
+            entry.refs = 1;
+            entry.loading = false;
+            keys_[weights] = key;
+        }
+        loaded_cv_.notify_all();
+        return weights;
+    }
+
+    /**
+     * Drops one consumer's hold on weights returned by acquire, freeing them
+     * after the last one. Weights not from this cache are freed directly.
+     */
+    void release(T* weights) {
+        if (weights == nullptr) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto key_it = keys_.find(weights);
+        if (key_it != keys_.end() && !key_it->second.empty()) {
+            Entry& entry = entries_[key_it->second];
+            if (--entry.refs > 0) {
+                return;
+            }
+            entries_.erase(key_it->second);
+        }
+        if (key_it != keys_.end()) {
+            keys_.erase(key_it);
+        }
+        lock.unlock();
+        deleter_(weights);
+    }
+
+    /** Number of consumers holding weights (for logging) */
+    int refs(const T* weights) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto key_it = keys_.find(const_cast<T*>(weights));
+        if (key_it == keys_.end() || key_it->second.empty()) {
+            return key_it == keys_.end() ? 0 : 1;
+        }
+        auto it = entries_.find(key_it->second);
+        return it == entries_.end() ? 0 : it->second.refs;
+    }
+
+   private:
+    struct Entry {
+        T* weights = nullptr;
+        int refs = 0;
+        bool loading = false;
+    };
+
+    static std::string make_key(const std::string& path, const std::string& variant) {
+        char resolved[PATH_MAX];
+        struct stat st = {};
+        if (realpath(path.c_str(), resolved) == nullptr || stat(resolved, &st) != 0) {
+            return std::string();
+        }
+        std::string key = resolved;
+        key += '|';
+        key += std::to_string(static_cast<long long>(st.st_mtime));
+        key += '|';
+        key += std::to_string(static_cast<long long>(st.st_size));
+        key += '|';
+        key += variant;
+        return key;
+    }
+
+    Deleter deleter_;
+    std::mutex mutex_;
+    std::condition_variable loaded_cv_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::unordered_map<T*, std::string> keys_;  // weights to key ("" = private)
+};
+
+}  // namespace rac
+
+#endif  // __cplusplus
+
+#endif /* RAC_SHARED_WEIGHTS_H */
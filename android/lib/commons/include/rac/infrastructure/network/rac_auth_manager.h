@@ -4,6 +4,10 @@
  *
  * Manages authentication state including tokens, expiry, and refresh logic.
  * Platform SDKs provide HTTP transport and secure storage callbacks.
+ *
+ * Refresh is either driven by the platform (rac_auth_get_valid_token
+ * reporting that a refresh is needed) or, once the refresh scheduler is
+ * started, done ahead of expiry in the background.
  */
 
 #ifndef RAC_AUTH_MANAGER_H
@@ -210,6 +214,10 @@ int rac_auth_handle_refresh_response(const char* json);
  * 2. Call rac_auth_handle_refresh_response with result
  * 3. Call this function again to get the new token
  *
+ * While the refresh scheduler runs, the refresh is instead done here
+ * through the HTTP client (joining one already in flight), and 1 is only
+ * returned if it fails.
+ *
  * @param out_token Output pointer for token string
  * @param out_needs_refresh Set to true if refresh HTTP call is needed
  * @return 0 on success (token valid), 1 if refresh needed, -1 on error
@@ -245,6 +253,45 @@ int rac_auth_load_stored_tokens(void);
  */
 int rac_auth_save_tokens(void);
 
+// =============================================================================
+// Refresh Scheduling
+// =============================================================================
+
+/**
+ * @brief Refresh the access token now, through the HTTP client
+ *
+ * Single flight: a caller that finds a refresh already running waits for
+ * it and gets its result instead of sending another. Needs the base URL
+ * from rac_auth_start_refresh_scheduler and a registered HTTP executor.
+ *
+ * @return 0 on success, -1 on error
+ */
+int rac_auth_refresh(void);
+
+/**
+ * @brief Start renewing the access token ahead of its expiry
+ *
+ * A background thread refreshes lead_seconds before token_expires_at
+ * (halfway through the lifetime of shorter-lived tokens), right away for
+ * tokens of unknown expiry, and backs off on failure. Requests then rarely
+ * wait for a refresh round-trip. Calling it again updates the settings.
+ *
+ * @param base_url API base URL the refresh endpoint is relative to
+ * @param lead_seconds How early to refresh (0 = 300 seconds)
+ * @return 0 on success, -1 on error
+ */
+int rac_auth_start_refresh_scheduler(const char* base_url, int32_t lead_seconds);
+
+/**
+ * @brief Stop the refresh scheduler, waiting for its thread to exit
+ */
+void rac_auth_stop_refresh_scheduler(void);
+
+/**
+ * @brief Check if the refresh scheduler is running
+ */
+bool rac_auth_refresh_scheduler_is_running(void);
+
 #ifdef __cplusplus
 }
 #endif
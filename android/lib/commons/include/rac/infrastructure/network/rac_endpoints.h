@@ -29,6 +29,8 @@ extern "C" {
 
 #define RAC_ENDPOINT_DEVICE_REGISTER "/api/v1/devices/register"
 #define RAC_ENDPOINT_TELEMETRY "/api/v1/sdk/telemetry"
+#define RAC_ENDPOINT_TELEMETRY_BATCH "/api/v1/sdk/telemetry/batch"
+#define RAC_ENDPOINT_TELEMETRY_BATCH_CBOR "/api/v1/sdk/telemetry/batch.cbor"
 
 // =============================================================================
 // Device Management - Development (Supabase REST API)
@@ -43,6 +45,22 @@ extern "C" {
 
 #define RAC_ENDPOINT_MODELS_AVAILABLE "/api/v1/models/available"
 
+// =============================================================================
+// Telemetry Encoding
+// =============================================================================
+
+/**
+ * @brief Wire format of production telemetry requests
+ *
+ * Each format has its own endpoint; the SDK only picks a format the backend
+ * serves. Development (Supabase) always takes the plain JSON array.
+ */
+typedef enum rac_telemetry_encoding {
+    RAC_TELEMETRY_ENCODING_JSON = 0,        /**< One JSON request per modality */
+    RAC_TELEMETRY_ENCODING_JSON_MERGED = 1, /**< One JSON request for all modalities */
+    RAC_TELEMETRY_ENCODING_CBOR = 2         /**< One CBOR request for all modalities */
+} rac_telemetry_encoding_t;
+
 // =============================================================================
 // Environment-Based Endpoint Selection
 // =============================================================================
@@ -61,6 +79,15 @@ const char* rac_endpoint_device_registration(rac_environment_t env);
  */
 const char* rac_endpoint_telemetry(rac_environment_t env);
 
+/**
+ * @brief Get telemetry endpoint for environment and wire format
+ * @param env The environment
+ * @param encoding The request encoding
+ * @return Endpoint path string
+ */
+const char* rac_endpoint_telemetry_for_encoding(rac_environment_t env,
+                                                rac_telemetry_encoding_t encoding);
+
 /**
  * @brief Get model assignments endpoint
  * @return Endpoint path string
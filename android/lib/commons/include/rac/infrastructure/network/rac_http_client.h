@@ -5,6 +5,15 @@
  * Defines a platform-agnostic HTTP interface. Platform SDKs implement
  * the actual HTTP transport (URLSession, OkHttp, etc.) and register
  * it via callback.
+ *
+ * Requests pass through a dispatch layer before they reach the platform:
+ * - identical GETs already in flight share one platform request
+ * - idempotent requests that fail in transport (or with 502/503/504) are
+ *   retried, as long as the process-wide retry budget allows
+ * - a session executor (rac_http_set_session_executor) is told which
+ *   origin each request belongs to, so it can keep one pooled, keep-alive
+ *   (and on HTTP/2, multiplexed) client per origin instead of a new
+ *   connection, TLS handshake and radio wake-up per request
  */
 
 #ifndef RAC_HTTP_CLIENT_H
@@ -110,6 +119,40 @@ typedef void (*rac_http_executor_t)(const rac_http_request_t* request, rac_http_
  */
 void rac_http_set_executor(rac_http_executor_t executor);
 
+/**
+ * @brief Connection pool a request belongs to
+ */
+typedef struct {
+    uint32_t id;            // Stable per origin for the process lifetime, never 0
+    const char* origin;     // "scheme://host[:port]"
+    int32_t keep_alive_ms;  // How long idle connections are worth keeping
+} rac_http_session_t;
+
+/**
+ * @brief Session-aware HTTP executor function type
+ *
+ * Like rac_http_executor_t, with the request's session. Platforms keep one
+ * client per session ID (OkHttpClient with a ConnectionPool, a shared
+ * URLSession) so requests to the same origin reuse warm connections.
+ *
+ * @param session The request's session (valid during the call)
+ * @param request The HTTP request to execute
+ * @param callback Callback to invoke with response
+ * @param user_data Opaque user data to pass to callback
+ */
+typedef void (*rac_http_session_executor_t)(const rac_http_session_t* session,
+                                            const rac_http_request_t* request,
+                                            rac_http_callback_t callback, void* user_data);
+
+/**
+ * @brief Register a session-aware platform HTTP executor
+ *
+ * Takes precedence over rac_http_set_executor when both are set.
+ *
+ * @param executor The executor function (NULL to unregister)
+ */
+void rac_http_set_session_executor(rac_http_session_executor_t executor);
+
 /**
  * @brief Check if HTTP executor is registered
  * @return true if executor has been set
@@ -208,6 +251,20 @@ typedef struct {
  */
 void rac_http_execute(const rac_http_request_t* request, rac_http_context_t* context);
 
+/**
+ * @brief Execute HTTP request with a raw response callback
+ *
+ * Unlike rac_http_execute, the callback sees the status code, headers and
+ * body length, so it can handle binary bodies such as Range responses.
+ *
+ * @param request The request to execute
+ * @param callback Callback to invoke with the response
+ * @param user_data Opaque user data passed to callback
+ * @return false if no executor is registered (callback is not invoked)
+ */
+bool rac_http_execute_raw(const rac_http_request_t* request, rac_http_callback_t callback,
+                          void* user_data);
+
 /**
  * @brief Helper: POST JSON to endpoint
  * @param url Full URL
@@ -226,6 +283,59 @@ void rac_http_post_json(const char* url, const char* json_body, const char* auth
  */
 void rac_http_get(const char* url, const char* auth_token, rac_http_context_t* context);
 
+// =============================================================================
+// Dispatch Configuration
+// =============================================================================
+
+/**
+ * @brief Dispatch layer configuration
+ */
+typedef struct {
+    bool coalesce_gets;      // Share identical in-flight GETs (same URL and headers)
+    int32_t max_retries;     // Retries per request (0 = never retry)
+    float retry_budget;      // Retry tokens earned per request; a retry spends one
+    float retry_budget_max;  // Most tokens banked; also the starting balance
+    int32_t keep_alive_ms;   // Passed to the session executor
+} rac_http_client_config_t;
+
+/**
+ * @brief Default configuration
+ *
+ * Up to 2 retries per request, but retries overall stay within 10% of the
+ * request rate once the 10 banked tokens are spent, so a failing backend is
+ * not hit with a retry storm.
+ */
+static const rac_http_client_config_t RAC_HTTP_CLIENT_CONFIG_DEFAULT = {
+    .coalesce_gets = true,
+    .max_retries = 2,
+    .retry_budget = 0.1f,
+    .retry_budget_max = 10.0f,
+    .keep_alive_ms = 60000};
+
+/**
+ * @brief Replace the dispatch configuration
+ * @param config Configuration (NULL for RAC_HTTP_CLIENT_CONFIG_DEFAULT)
+ */
+void rac_http_client_configure(const rac_http_client_config_t* config);
+
+/**
+ * @brief Dispatch counters since process start
+ */
+typedef struct {
+    uint64_t requests;        // Requests submitted by callers
+    uint64_t dispatched;      // Requests handed to the platform, retries included
+    uint64_t coalesced;       // Requests answered by another caller's GET
+    uint64_t retries;         // Retries dispatched
+    uint64_t retries_denied;  // Retries skipped because the budget was spent
+    uint32_t sessions;        // Distinct origins seen
+} rac_http_client_stats_t;
+
+/**
+ * @brief Read the dispatch counters
+ * @param out_stats Output: Counters
+ */
+void rac_http_client_get_stats(rac_http_client_stats_t* out_stats);
+
 #ifdef __cplusplus
 }
 #endif
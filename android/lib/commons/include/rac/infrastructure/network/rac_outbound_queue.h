@@ -0,0 +1,208 @@
+/**
+ * @file rac_outbound_queue.h
+ * @brief RunAnywhere Commons - Offline-First Outbound Queue
+ *
+ * Network-bound SDK work (device registration, model assignment fetches,
+ * telemetry) used to be attempted immediately and retried by each module on
+ * its own schedule. Offline, startup waited on calls that could not succeed,
+ * and when connectivity returned every module fired at once.
+ *
+ * The outbound queue is the one place such work waits. Modules enqueue
+ * items and never block; a single worker sends them, in priority order and
+ * in per-kind batches, whenever the device is online. Items can be persisted
+ * to a file, so work queued offline survives a restart.
+ *
+ * Connectivity comes from emit_network_connectivity_changed (reported by the
+ * download manager) or from rac_outbound_queue_set_online. On reconnect the
+ * queue waits a random jitter before it drains, so a fleet of devices coming
+ * back online does not hit the backend in the same second.
+ */
+
+#ifndef RAC_OUTBOUND_QUEUE_H
+#define RAC_OUTBOUND_QUEUE_H
+
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_executor.h"
+#include "rac/core/rac_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// =============================================================================
+// TYPES
+// =============================================================================
+
+/** Kinds used by the SDK itself */
+#define RAC_OUTBOUND_KIND_DEVICE_REGISTRATION "device.registration"
+#define RAC_OUTBOUND_KIND_MODEL_ASSIGNMENTS "model.assignments"
+
+/**
+ * @brief One queued item, as handed to its handler
+ */
+typedef struct rac_outbound_item {
+    /** Kind the item was enqueued under */
+    const char* kind;
+
+    /** Deduplication key (empty if none) */
+    const char* key;
+
+    /** Payload bytes (can be empty) */
+    const char* payload;
+    size_t payload_length;
+
+    /** Priority (RAC_REQUEST_PRIORITY_*; HIGH is sent first) */
+    rac_request_priority_t priority;
+
+    /** Failed deliveries so far */
+    int32_t attempts;
+
+    /** Unix time the item was enqueued, in milliseconds */
+    int64_t enqueued_at_ms;
+} rac_outbound_item_t;
+
+/**
+ * @brief Sends a batch of items of one kind
+ *
+ * Called on the queue's worker thread, oldest items first. RAC_SUCCESS
+ * removes the batch. A network error (RAC_ERROR_NETWORK_UNAVAILABLE through
+ * RAC_ERROR_HTTP_*, -150 to -179) keeps it for the next attempt, without
+ * counting towards max_attempts. Any other error counts one attempt against
+ * every item in the batch.
+ *
+ * @param items Items, valid during the call
+ * @param count Number of items
+ * @param user_data Handler context
+ * @return RAC_SUCCESS or error code
+ */
+typedef rac_result_t (*rac_outbound_handler_fn)(const rac_outbound_item_t* items, size_t count,
+                                                void* user_data);
+
+/**
+ * @brief Queue configuration
+ */
+typedef struct rac_outbound_queue_config {
+    /** File items are persisted to (NULL = memory only) */
+    const char* storage_path;
+
+    /** Most items kept; when full the oldest lowest-priority item is dropped */
+    int32_t max_items;
+
+    /** Non-network failures after which an item is dropped */
+    int32_t max_attempts;
+
+    /** First retry delay after a failed batch, doubled per failure */
+    int32_t initial_backoff_ms;
+
+    /** Retry delay cap */
+    int32_t max_backoff_ms;
+
+    /** Upper bound of the random delay before draining on reconnect */
+    int32_t reconnect_jitter_ms;
+} rac_outbound_queue_config_t;
+
+/**
+ * @brief Default config: memory only, 256 items, 5 attempts, 2 s to 5 min
+ * backoff, up to 3 s of reconnect jitter
+ */
+static const rac_outbound_queue_config_t RAC_OUTBOUND_QUEUE_CONFIG_DEFAULT = {
+    .storage_path = RAC_NULL,
+    .max_items = 256,
+    .max_attempts = 5,
+    .initial_backoff_ms = 2000,
+    .max_backoff_ms = 300000,
+    .reconnect_jitter_ms = 3000};
+
+// =============================================================================
+// QUEUE API
+// =============================================================================
+
+/**
+ * @brief Replace the configuration
+ *
+ * With a storage_path, items persisted there are loaded and merged into the
+ * queue. Configure once at startup, before enqueuing.
+ *
+ * @param config Configuration (NULL for RAC_OUTBOUND_QUEUE_CONFIG_DEFAULT)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_outbound_queue_configure(const rac_outbound_queue_config_t* config);
+
+/**
+ * @brief Set the handler for a kind
+ *
+ * Items of a kind without a handler wait in the queue, so persisted items
+ * are kept until their module registers again.
+ *
+ * @param kind Item kind
+ * @param handler Handler (NULL to remove)
+ * @param max_batch Most items per call (at least 1)
+ * @param user_data Handler context
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_outbound_queue_set_handler(const char* kind,
+                                                    rac_outbound_handler_fn handler,
+                                                    int32_t max_batch, void* user_data);
+
+/**
+ * @brief Queue an item; never blocks on the network
+ *
+ * An item with the same kind and a non-empty key replaces a queued one,
+ * keeping the higher of the two priorities, so repeated requests for the
+ * same work collapse into one.
+ *
+ * @param kind Item kind
+ * @param key Deduplication key (NULL or empty for none)
+ * @param payload Payload bytes (can be NULL)
+ * @param payload_length Payload length
+ * @param priority Priority
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_outbound_queue_enqueue(const char* kind, const char* key,
+                                                const void* payload, size_t payload_length,
+                                                rac_request_priority_t priority);
+
+/**
+ * @brief Report connectivity
+ *
+ * The queue assumes it is online until told otherwise. Going online resets
+ * the retry backoff and drains after the reconnect jitter.
+ */
+RAC_API void rac_outbound_queue_set_online(rac_bool_t online);
+
+/**
+ * @brief Whether the queue considers the device online
+ */
+RAC_API rac_bool_t rac_outbound_queue_is_online(void);
+
+/**
+ * @brief Whether work of a priority may go out now
+ *
+ * For modules with their own delivery (telemetry): false while offline,
+ * during backoff or reconnect jitter, or while queued work of a higher
+ * priority is waiting for a handler to send it.
+ */
+RAC_API rac_bool_t rac_outbound_queue_may_send(rac_request_priority_t priority);
+
+/**
+ * @brief Number of offline-to-online transitions so far
+ *
+ * Lets modules with their own backoff start over after a reconnect.
+ */
+RAC_API uint32_t rac_outbound_queue_online_epoch(void);
+
+/**
+ * @brief Number of queued items
+ */
+RAC_API int32_t rac_outbound_queue_pending_count(void);
+
+/**
+ * @brief Retry now, skipping any backoff
+ */
+RAC_API void rac_outbound_queue_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAC_OUTBOUND_QUEUE_H */
@@ -130,6 +130,9 @@ typedef struct {
 
 /**
  * @brief Callback to calculate directory size
+ *
+ * Called from several threads at once when many directories need sizing.
+ *
  * @param path Directory path
  * @param user_data User context
  * @return Size in bytes
@@ -213,6 +216,11 @@ RAC_API void rac_storage_analyzer_destroy(rac_storage_analyzer_handle_t handle);
  * - Calls platform callbacks for sizes
  * - Aggregates results
  *
+ * Directory sizes are cached in the registry (see
+ * rac_model_registry_get_dir_size), so only directories changed since the
+ * last analysis are measured, a few at a time in parallel. With an open
+ * registry index the cache survives restarts and is flushed by this call.
+ *
  * @param handle Analyzer handle
  * @param registry_handle Model registry handle
  * @param out_info Output: Storage info (caller must call rac_storage_info_free)
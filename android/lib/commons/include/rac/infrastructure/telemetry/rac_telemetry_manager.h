@@ -19,6 +19,7 @@
 
 #include "rac/core/rac_analytics_events.h"
 #include "rac/core/rac_types.h"
+#include "rac/infrastructure/network/rac_endpoints.h"
 #include "rac/infrastructure/network/rac_environment.h"
 #include "rac/infrastructure/telemetry/rac_telemetry_types.h"
 
@@ -54,7 +55,9 @@ typedef void (*rac_telemetry_http_callback_t)(void* user_data, const char* endpo
 /**
  * @brief HTTP response callback from platform SDK to C++
  *
- * Platform SDK calls this after HTTP completes.
+ * Platform SDK calls this after HTTP completes, once per request. A failed
+ * batch is retried with exponential backoff (from the spool, if one is set).
+ * Platforms that never call this get fire-and-forget delivery.
  *
  * @param manager The telemetry manager
  * @param success Whether HTTP call succeeded
@@ -65,6 +68,53 @@ RAC_API void rac_telemetry_manager_http_complete(rac_telemetry_manager_t* manage
                                                  rac_bool_t success, const char* response_json,
                                                  const char* error_message);
 
+// =============================================================================
+// SAMPLING POLICY
+// =============================================================================
+
+/**
+ * @brief Sampling and rate limit for one event type
+ */
+typedef struct rac_telemetry_sampling_rule {
+    /** Event type ("llm.generation.streaming"), a prefix ending in '*'
+        ("llm.*"), or "*" for every event */
+    const char* event_type;
+
+    /** Fraction of matching events kept (0-1) */
+    float sample_rate;
+
+    /** Sustained matching events per second after sampling (0 = no limit) */
+    float rate_per_second;
+
+    /** Events allowed in a burst above the rate (token bucket size) */
+    int32_t burst;
+} rac_telemetry_sampling_rule_t;
+
+/**
+ * @brief Telemetry volume policy
+ *
+ * The first rule matching an event's type applies; events no rule matches
+ * are kept.
+ */
+typedef struct rac_telemetry_policy {
+    const rac_telemetry_sampling_rule_t* rules;
+    size_t rule_count;
+
+    /** Failures (success false, an error set, or a *.failed type) skip
+        sampling and rate limits */
+    rac_bool_t keep_errors;
+
+    /** Shortest time between background flushes, in development too
+        (0 = flush as soon as a batch is due) */
+    int32_t min_flush_interval_ms;
+} rac_telemetry_policy_t;
+
+/**
+ * @brief Default policy (keep everything)
+ */
+static const rac_telemetry_policy_t RAC_TELEMETRY_POLICY_DEFAULT = {
+    .rules = RAC_NULL, .rule_count = 0, .keep_errors = RAC_TRUE, .min_flush_interval_ms = 0};
+
 // =============================================================================
 // LIFECYCLE
 // =============================================================================
@@ -85,6 +135,8 @@ RAC_API rac_telemetry_manager_t* rac_telemetry_manager_create(rac_environment_t
 
 /**
  * @brief Destroy telemetry manager
+ *
+ * Stops the background flusher and sends the remaining events.
  */
 RAC_API void rac_telemetry_manager_destroy(rac_telemetry_manager_t* manager);
 
@@ -100,12 +152,75 @@ RAC_API void rac_telemetry_manager_set_device_info(rac_telemetry_manager_t* mana
 /**
  * @brief Register HTTP callback
  *
- * Platform SDK must register this to receive HTTP requests.
+ * Platform SDK must register this to receive HTTP requests. The callback
+ * runs on the manager's background flusher thread, or on the thread calling
+ * rac_telemetry_manager_flush.
  */
 RAC_API void rac_telemetry_manager_set_http_callback(rac_telemetry_manager_t* manager,
                                                      rac_telemetry_http_callback_t callback,
                                                      void* user_data);
 
+/**
+ * @brief Keep queued events in a spool file
+ *
+ * Every queued event is also written to the file and stays there until its
+ * batch is acknowledged through rac_telemetry_manager_http_complete, so
+ * events survive a crash and are sent by the next manager that opens the
+ * same file. Delivery is at least once. The spool is capped at 1 MB; when
+ * full, the oldest events are dropped.
+ *
+ * @param manager Telemetry manager
+ * @param path Spool file path, created if missing (NULL closes the spool)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_telemetry_manager_set_spool_path(rac_telemetry_manager_t* manager,
+                                                          const char* path);
+
+/**
+ * @brief Choose the wire format of production requests
+ *
+ * The merged formats send all modalities of a flush in one request, to the
+ * endpoint returned by rac_endpoint_telemetry_for_encoding. CBOR bodies are
+ * binary: the HTTP callback must send json_length bytes as application/cbor
+ * rather than treating json_body as a string. Default is
+ * RAC_TELEMETRY_ENCODING_JSON. Ignored in development.
+ *
+ * @param manager Telemetry manager
+ * @param encoding Request encoding
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_telemetry_manager_set_encoding(rac_telemetry_manager_t* manager,
+                                                        rac_telemetry_encoding_t encoding);
+
+/**
+ * @brief Replace the sampling policy
+ *
+ * Dropped events are never queued. Rate limit buckets start full.
+ *
+ * @param manager Telemetry manager
+ * @param policy Policy, copied (NULL for RAC_TELEMETRY_POLICY_DEFAULT)
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_telemetry_manager_set_policy(rac_telemetry_manager_t* manager,
+                                                      const rac_telemetry_policy_t* policy);
+
+/**
+ * @brief Replace the sampling policy from its backend JSON form
+ *
+ * Takes the "telemetry_policy" object of the model assignment response:
+ * {"keep_errors": true, "min_flush_interval_ms": 1000, "rules": [
+ *   {"event_type": "llm.generation.streaming", "sample_rate": 0.1,
+ *    "rate_per_second": 2, "burst": 10}]}
+ * Missing fields keep their defaults (sample_rate 1, no rate limit).
+ *
+ * @param manager Telemetry manager
+ * @param json Policy object
+ * @param length Length of json in bytes
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_telemetry_manager_set_policy_json(rac_telemetry_manager_t* manager,
+                                                           const char* json, size_t length);
+
 // =============================================================================
 // EVENT TRACKING
 // =============================================================================
@@ -113,7 +228,9 @@ RAC_API void rac_telemetry_manager_set_http_callback(rac_telemetry_manager_t* ma
 /**
  * @brief Track a telemetry payload directly
  *
- * Queues the payload for batching and sending.
+ * Queues the payload for batching and sending. Never sends inline: the
+ * background flusher sends a batch when it is full, after a timeout, or
+ * right away in development.
  */
 RAC_API rac_result_t rac_telemetry_manager_track(rac_telemetry_manager_t* manager,
                                                  const rac_telemetry_payload_t* payload);
@@ -130,7 +247,8 @@ RAC_API rac_result_t rac_telemetry_manager_track_analytics(rac_telemetry_manager
 /**
  * @brief Flush queued events immediately
  *
- * Sends all queued events to the backend.
+ * Sends all queued events to the backend from the calling thread, without
+ * waiting for a retry backoff or for the previous batch's results.
  */
 RAC_API rac_result_t rac_telemetry_manager_flush(rac_telemetry_manager_t* manager);
 
@@ -164,6 +282,25 @@ RAC_API rac_result_t
 rac_telemetry_manager_batch_to_json(const rac_telemetry_batch_request_t* request,
                                     rac_environment_t env, char** out_json, size_t* out_length);
 
+/**
+ * @brief Encode several batch requests as one production request body
+ *
+ * The body is {"device_id", "timestamp", "batches": [<batch request>, ...]},
+ * written as JSON or CBOR. CBOR timestamps are epoch seconds (tag 1).
+ *
+ * @param batches Batch requests, typically one per modality
+ * @param batch_count Number of batch requests
+ * @param device_id Device ID for the request
+ * @param timestamp_ms Request timestamp
+ * @param encoding RAC_TELEMETRY_ENCODING_JSON_MERGED or RAC_TELEMETRY_ENCODING_CBOR
+ * @param out_body Output: Request body, NUL-terminated (caller must free with rac_free)
+ * @param out_length Output: Body length in bytes, without the terminator
+ * @return RAC_SUCCESS or error code
+ */
+RAC_API rac_result_t rac_telemetry_manager_encode_batches(
+    const rac_telemetry_batch_request_t* batches, size_t batch_count, const char* device_id,
+    int64_t timestamp_ms, rac_telemetry_encoding_t encoding, char** out_body, size_t* out_length);
+
 /**
  * @brief Parse batch response from JSON
  *
@@ -34,6 +34,7 @@ extern "C" {
  * - SDK lifecycle events (count)
  * - Storage events (freed bytes)
  * - Network events (online status)
+ * - Device profile events (matmul, bandwidth, reference model speed)
  */
 typedef struct rac_telemetry_payload {
     // Required fields
@@ -113,6 +114,32 @@ typedef struct rac_telemetry_payload {
     // Network fields
     rac_bool_t is_online;
     rac_bool_t has_is_online;
+
+    // Device profile fields
+    const char* device_class;  // "low", "mid", "high"
+    double matmul_gflops;
+    double memory_bandwidth_gbps;
+    double prefill_tokens_per_second;
+    int32_t best_threads;
+
+    // SDK lifecycle fields
+    const char* subsystem;  // rac_init_graph subsystem, NULL for the whole SDK
+
+    // Field performance sample fields (rac_perf_sampler)
+    const char* stage;          // Trace span name
+    const char* thermal_state;  // "nominal", "fair", "serious", "critical"
+    const char* histogram;      // "<bucket lower bound us>:<count>,..."
+    double p50_ms;
+    double p95_ms;
+    double p99_ms;
+    double max_ms;
+    double cpu_freq_mhz;
+    double window_ms;
+
+    // Per-call memory fields (rac_memory_watermark)
+    int64_t peak_rss_bytes;
+    int64_t rss_delta_bytes;
+    int64_t backend_memory_bytes;
 } rac_telemetry_payload_t;
 
 /**
@@ -14,8 +14,10 @@
 #              Supported: arm64-v8a, armeabi-v7a, x86_64, x86
 #
 # Options:
-#   --check   Check 16KB alignment of existing libraries in dist/
-#   --help    Show this help message
+#   --check              Check 16KB alignment of existing libraries in dist/
+#   --pgo-profile <file> Build with profile-guided optimization + ThinLTO from a
+#                        merged .profdata (see scripts/build-pgo.sh)
+#   --help               Show this help message
 #
 # ABI Guide:
 #   arm64-v8a        64-bit ARM (modern devices, ~85% coverage)
@@ -101,6 +103,7 @@ print_info() {
 # =============================================================================
 
 CHECK_ONLY=false
+PGO_PROFILE=""
 
 while [[ "$1" == --* ]]; do
     case "$1" in
@@ -108,8 +111,16 @@ while [[ "$1" == --* ]]; do
             CHECK_ONLY=true
             shift
             ;;
+        --pgo-profile)
+            if [ -z "$2" ] || [ ! -f "$2" ]; then
+                print_error "--pgo-profile needs an existing .profdata file"
+                exit 1
+            fi
+            PGO_PROFILE="$(cd "$(dirname "$2")" && pwd)/$(basename "$2")"
+            shift 2
+            ;;
         --help|-h)
-            head -55 "$0" | tail -50
+            head -57 "$0" | tail -52
             exit 0
             ;;
         *)
@@ -273,6 +284,9 @@ echo "Backends: ONNX=$BUILD_ONNX, LlamaCPP=$BUILD_LLAMACPP, WhisperCPP=$BUILD_WH
 echo "ABIs: ${ABIS}"
 echo "Android API Level: ${ANDROID_API_LEVEL}"
 echo "Output: dist/android/${DIST_SUBDIR}/"
+if [ -n "$PGO_PROFILE" ]; then
+    echo "PGO profile: ${PGO_PROFILE}"
+fi
 
 # =============================================================================
 # Prerequisites
@@ -354,6 +368,11 @@ mkdir -p "${JNI_DIST_DIR}"
 
 IFS=',' read -ra ABI_ARRAY <<< "$ABIS"
 
+PGO_ARGS=()
+if [ -n "$PGO_PROFILE" ]; then
+    PGO_ARGS=(-DRAC_PGO=USE "-DRAC_PGO_PROFILE=${PGO_PROFILE}")
+fi
+
 for ABI in "${ABI_ARRAY[@]}"; do
     print_header "Building for ${ABI}"
 
@@ -375,6 +394,7 @@ for ABI in "${ABI_ARRAY[@]}"; do
         -DRAC_BUILD_SHARED=ON \
         -DANDROID_SUPPORT_FLEXIBLE_PAGE_SIZES=ON \
         -DCMAKE_SHARED_LINKER_FLAGS="-Wl,-z,max-page-size=16384 -Wl,-z,common-page-size=16384" \
+        "${PGO_ARGS[@]}" \
         "${ROOT_DIR}"
 
     cmake --build "${ABI_BUILD_DIR}" \
@@ -530,6 +550,14 @@ for ABI in "${ABI_ARRAY[@]}"; do
             print_warning "librac_backend_llamacpp_jni.so not found - JNI bridge not built"
         fi
 
+        # Copy shared ggml/llama libraries (CPU variant builds load libggml-cpu-*.so at runtime)
+        if [ -d "${ABI_BUILD_DIR}/_deps/llamacpp-build" ]; then
+            find "${ABI_BUILD_DIR}/_deps/llamacpp-build" \( -name "libggml*.so" -o -name "libllama.so" \) -type f | while read -r lib; do
+                cp "$lib" "${DIST_DIR}/llamacpp/${ABI}/"
+                echo "  Copied: $(basename "$lib") -> llamacpp/${ABI}/"
+            done
+        fi
+
         # Copy OpenMP and C++ shared library for LlamaCPP
         # Note: ARCH_PATTERN is already set above in the ABI detection
         LIBOMP_FOUND=$(find "$NDK_PATH/toolchains/llvm/prebuilt" -name "libomp.so" -path "*/${ARCH_PATTERN}/*" 2>/dev/null | head -1)
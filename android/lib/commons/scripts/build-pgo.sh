@@ -0,0 +1,254 @@
+#!/bin/bash
+
+# =============================================================================
+# build-pgo.sh
+# Two-stage profile-guided (PGO + ThinLTO) release build
+#
+# Usage: ./build-pgo.sh [options]
+#
+# Stage 1 builds rac_commons, the LlamaCPP backend and the benchmarks with
+# RAC_PGO=GENERATE and runs the rac_bench micro-benchmarks and, given a model,
+# a short rac_llm_bench sweep to record profiles. Stage 2 rebuilds from the
+# merged profile with RAC_PGO=USE (see cmake/PGO.cmake).
+#
+# Options:
+#   --model <path.gguf>  Also profile LLM prefill/decode through rac_llm_bench
+#                        (without it only the commons hot paths are profiled)
+#   --android            Profile on the connected arm64 device through adb,
+#                        then run build-android.sh --pgo-profile for the release
+#   --build-dir <dir>    Host build directory (default: build/pgo)
+#   --help               Show this help message
+#
+# Examples:
+#   # Host release build (Linux/macOS)
+#   ./build-pgo.sh --model ~/models/qwen2.5-0.5b-q4_k_m.gguf
+#
+#   # Android arm64 release, profiled on a device
+#   ./build-pgo.sh --android --model ~/models/qwen2.5-0.5b-q4_k_m.gguf
+#
+# Profiles only match sources and flags they were recorded with: re-run this
+# script after changing code rather than reusing an old profile.
+# =============================================================================
+
+set -e  # Exit on error
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(cd "${SCRIPT_DIR}/.." && pwd)"
+
+# Load centralized versions
+source "${SCRIPT_DIR}/load-versions.sh"
+
+# Colors
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m'
+
+print_header() {
+    echo ""
+    echo -e "${BLUE}========================================${NC}"
+    echo -e "${BLUE}$1${NC}"
+    echo -e "${BLUE}========================================${NC}"
+    echo ""
+}
+
+print_step() {
+    echo -e "${YELLOW}-> $1${NC}"
+}
+
+print_success() {
+    echo -e "${GREEN}[OK] $1${NC}"
+}
+
+print_error() {
+    echo -e "${RED}[ERROR] $1${NC}"
+}
+
+JOBS=$(nproc 2>/dev/null || sysctl -n hw.ncpu 2>/dev/null || echo 4)
+
+# Profiling workloads: long enough to reach steady state, short enough to
+# keep stage 1 to a few minutes
+BENCH_ARGS=(--min-time-ms 200)
+LLM_BENCH_ARGS=(--prompt-tokens 128,512 --gen-tokens 64 --repetitions 1 --warmup 0)
+
+# =============================================================================
+# Parse Options
+# =============================================================================
+
+MODEL=""
+ANDROID=false
+BUILD_DIR="${ROOT_DIR}/build/pgo"
+
+while [[ "$1" == --* ]]; do
+    case "$1" in
+        --model)
+            if [ -z "$2" ] || [ ! -f "$2" ]; then
+                print_error "--model needs an existing GGUF file"
+                exit 1
+            fi
+            MODEL="$(cd "$(dirname "$2")" && pwd)/$(basename "$2")"
+            shift 2
+            ;;
+        --android)
+            ANDROID=true
+            shift
+            ;;
+        --build-dir)
+            BUILD_DIR="$2"
+            shift 2
+            ;;
+        --help|-h)
+            head -31 "$0" | tail -28
+            exit 0
+            ;;
+        *)
+            print_error "Unknown option: $1"
+            echo "Use --help for usage information"
+            exit 1
+            ;;
+    esac
+done
+
+if [ -n "$MODEL" ]; then
+    BACKEND_ARGS=(-DRAC_BUILD_BACKENDS=ON -DRAC_BACKEND_LLAMACPP=ON
+                  -DRAC_BACKEND_ONNX=OFF -DRAC_BACKEND_WHISPERCPP=OFF)
+else
+    BACKEND_ARGS=(-DRAC_BUILD_BACKENDS=OFF)
+fi
+
+# Merges raw Clang profiles into a .profdata: merge_profiles <llvm-profdata> <dir> <out>
+merge_profiles() {
+    local profdata_tool="$1" profile_dir="$2" out="$3"
+    if ! ls "${profile_dir}"/*.profraw &> /dev/null; then
+        print_error "No .profraw files in ${profile_dir}; the workloads did not run"
+        exit 1
+    fi
+    "$profdata_tool" merge -o "$out" "${profile_dir}"/*.profraw
+    print_success "Merged profile: $out"
+}
+
+# =============================================================================
+# Android: profile on device, then release through build-android.sh
+# =============================================================================
+
+if [ "$ANDROID" = true ]; then
+    NDK_PATH="${ANDROID_NDK_HOME:-$NDK_HOME}"
+    if [ -z "$NDK_PATH" ] || [ ! -d "$NDK_PATH" ]; then
+        print_error "Android NDK not found. Set ANDROID_NDK_HOME or NDK_HOME environment variable."
+        exit 1
+    fi
+    if ! command -v adb &> /dev/null || [ -z "$(adb devices | sed -n '2p')" ]; then
+        print_error "No device found through adb"
+        exit 1
+    fi
+    LLVM_PROFDATA=$(find "$NDK_PATH/toolchains/llvm/prebuilt" -name llvm-profdata -type f | head -1)
+    if [ -z "$LLVM_PROFDATA" ]; then
+        print_error "llvm-profdata not found in the NDK"
+        exit 1
+    fi
+
+    ABI="arm64-v8a"
+    GEN_DIR="${ROOT_DIR}/build/android/pgo-generate"
+    DEVICE_DIR="/data/local/tmp/rac_pgo"
+    PROFILE_DIR="${GEN_DIR}/pgo-profiles"
+
+    print_header "Stage 1: instrumented ${ABI} build"
+    # Same configuration as build-android.sh so the profile matches the release
+    cmake -B "${GEN_DIR}" \
+        -DCMAKE_TOOLCHAIN_FILE="$NDK_PATH/build/cmake/android.toolchain.cmake" \
+        -DANDROID_ABI="${ABI}" \
+        -DANDROID_PLATFORM="android-${ANDROID_MIN_SDK}" \
+        -DANDROID_STL=c++_shared \
+        -DCMAKE_BUILD_TYPE=Release \
+        "${BACKEND_ARGS[@]}" \
+        -DRAC_BUILD_JNI=OFF \
+        -DRAC_BUILD_TESTS=ON \
+        -DRAC_BUILD_SHARED=ON \
+        -DANDROID_SUPPORT_FLEXIBLE_PAGE_SIZES=ON \
+        -DCMAKE_SHARED_LINKER_FLAGS="-Wl,-z,max-page-size=16384 -Wl,-z,common-page-size=16384" \
+        -DRAC_PGO=GENERATE \
+        "${ROOT_DIR}"
+    cmake --build "${GEN_DIR}" -j"${JOBS}"
+
+    print_header "Stage 1: profiling on device"
+    adb shell "rm -rf ${DEVICE_DIR} && mkdir -p ${DEVICE_DIR}/profiles"
+    find "${GEN_DIR}" \( -name "rac_bench" -o -name "rac_llm_bench" -o -name "*.so" \) -type f \
+        -not -path "*/CMakeFiles/*" | while read -r file; do
+        adb push "$file" "${DEVICE_DIR}/" > /dev/null
+    done
+    for lib in libc++_shared.so libomp.so; do
+        found=$(find "$NDK_PATH/toolchains/llvm/prebuilt" -name "$lib" -path "*aarch64*" | head -1)
+        if [ -n "$found" ]; then
+            adb push "$found" "${DEVICE_DIR}/" > /dev/null
+        fi
+    done
+
+    DEVICE_ENV="cd ${DEVICE_DIR} && LD_LIBRARY_PATH=${DEVICE_DIR} LLVM_PROFILE_FILE=${DEVICE_DIR}/profiles/%p-%m.profraw"
+    print_step "Running rac_bench..."
+    adb shell "${DEVICE_ENV} ./rac_bench ${BENCH_ARGS[*]} > /dev/null"
+    if [ -n "$MODEL" ]; then
+        print_step "Running rac_llm_bench..."
+        adb push "$MODEL" "${DEVICE_DIR}/model.gguf" > /dev/null
+        adb shell "${DEVICE_ENV} ./rac_llm_bench --model model.gguf ${LLM_BENCH_ARGS[*]} > /dev/null"
+    fi
+
+    rm -rf "${PROFILE_DIR}"
+    mkdir -p "${PROFILE_DIR}"
+    adb pull "${DEVICE_DIR}/profiles/." "${PROFILE_DIR}/" > /dev/null
+    adb shell "rm -rf ${DEVICE_DIR}"
+    merge_profiles "$LLVM_PROFDATA" "${PROFILE_DIR}" "${GEN_DIR}/default.profdata"
+
+    print_header "Stage 2: optimized release"
+    "${SCRIPT_DIR}/build-android.sh" --pgo-profile "${GEN_DIR}/default.profdata" all "${ABI}"
+    exit 0
+fi
+
+# =============================================================================
+# Host: both stages in one build directory
+# =============================================================================
+# GCC looks up .gcda files by object path, so stage 2 reuses stage 1's tree.
+
+PROFILE_DIR="${BUILD_DIR}/pgo-profiles"
+
+print_header "Stage 1: instrumented build"
+cmake -B "${BUILD_DIR}" \
+    -DCMAKE_BUILD_TYPE=Release \
+    "${BACKEND_ARGS[@]}" \
+    -DRAC_BUILD_TESTS=ON \
+    -DRAC_PGO=GENERATE \
+    -DRAC_PGO_PROFILE="${PROFILE_DIR}" \
+    "${ROOT_DIR}"
+cmake --build "${BUILD_DIR}" -j"${JOBS}"
+
+print_header "Stage 1: profiling"
+rm -rf "${PROFILE_DIR}"
+mkdir -p "${PROFILE_DIR}"
+export LLVM_PROFILE_FILE="${PROFILE_DIR}/%p-%m.profraw"
+print_step "Running rac_bench..."
+"${BUILD_DIR}/tests/rac_bench" "${BENCH_ARGS[@]}" > /dev/null
+if [ -n "$MODEL" ]; then
+    print_step "Running rac_llm_bench..."
+    "${BUILD_DIR}/tests/rac_llm_bench" --model "$MODEL" "${LLM_BENCH_ARGS[@]}" > /dev/null
+fi
+unset LLVM_PROFILE_FILE
+
+COMPILER=$(sed -n 's/^CMAKE_CXX_COMPILER:[A-Z]*=//p' "${BUILD_DIR}/CMakeCache.txt")
+
+if "$COMPILER" --version 2>/dev/null | grep -qi clang; then
+    LLVM_PROFDATA=$(command -v llvm-profdata || xcrun --find llvm-profdata 2>/dev/null || true)
+    if [ -z "$LLVM_PROFDATA" ]; then
+        print_error "llvm-profdata not found"
+        exit 1
+    fi
+    merge_profiles "$LLVM_PROFDATA" "${PROFILE_DIR}" "${BUILD_DIR}/default.profdata"
+    USE_PROFILE="${BUILD_DIR}/default.profdata"
+else
+    USE_PROFILE="${PROFILE_DIR}"
+fi
+
+print_header "Stage 2: optimized build"
+cmake -B "${BUILD_DIR}" -DRAC_PGO=USE -DRAC_PGO_PROFILE="${USE_PROFILE}" "${ROOT_DIR}"
+cmake --build "${BUILD_DIR}" -j"${JOBS}"
+
+print_success "PGO build complete: ${BUILD_DIR}"
@@ -216,7 +216,7 @@ Java_com_runanywhere_sdk_llm_llamacpp_LlamaCPPBridge_nativeGenerate(
         output = env->NewStringUTF(result.text);
         LOGi("nativeGenerate: Success, output_len=%zu", strlen(result.text));
         // Free the allocated text
-        free((void*)result.text);
+        rac_free((void*)result.text);
     }
 
     return output;
@@ -256,7 +256,7 @@ Java_com_runanywhere_sdk_llm_llamacpp_LlamaCPPBridge_nativeGetModelInfo(
     }
 
     jstring result = env->NewStringUTF(json);
-    free(json);
+    rac_free(json);
 
     return result;
 }
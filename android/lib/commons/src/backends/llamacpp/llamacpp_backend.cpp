@@ -1,13 +1,32 @@
 #include "llamacpp_backend.h"
 
 #include "common.h"
+#include "json-schema-to-grammar.h"
+#include "ggml-backend.h"
 
 #include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <string>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rac/core/capabilities/rac_lifecycle.h"
+#include "rac/core/rac_cpu_budget.h"
 #include "rac/core/rac_logger.h"
+#include "rac/core/rac_thermal_governor.h"
+#include "rac/core/rac_trace.h"
+#include "rac/features/llm/rac_llm_structured_output.h"
+#include "rac/infrastructure/device/rac_device_profile.h"
+#include "rac/infrastructure/model_management/rac_shared_weights.h"
 
 // Use the RAC logging system
 #define LOGI(...) RAC_LOG_INFO("LLM.LlamaCpp", __VA_ARGS__)
@@ -16,37 +35,75 @@
 namespace runanywhere {
 
 // =============================================================================
-// UTF-8 VALIDATION HELPER
+// UTF-8 STREAM DECODER
 // =============================================================================
 
-static bool is_valid_utf8(const char* string) {
-    if (!string)
-        return true;
+static const char kReplacementChar[] = "\xEF\xBF\xBD";
+
+void Utf8StreamDecoder::feed(const std::string& text, std::string& out) {
+    for (const char ch : text) {
+        const auto byte = static_cast<unsigned char>(ch);
+        if (need_ > 0) {
+            if ((byte & 0xC0) == 0x80) {
+                held_[held_len_++] = ch;
+                if (--need_ == 0) {
+                    out.append(held_, static_cast<size_t>(held_len_));
+                    held_len_ = 0;
+                }
+                continue;
+            }
+            // Truncated sequence; the current byte starts fresh
+            out += kReplacementChar;
+            held_len_ = 0;
+            need_ = 0;
+        }
 
-    const unsigned char* bytes = (const unsigned char*)string;
-    int num;
-
-    while (*bytes != 0x00) {
-        if ((*bytes & 0x80) == 0x00) {
-            num = 1;
-        } else if ((*bytes & 0xE0) == 0xC0) {
-            num = 2;
-        } else if ((*bytes & 0xF0) == 0xE0) {
-            num = 3;
-        } else if ((*bytes & 0xF8) == 0xF0) {
-            num = 4;
+        if (byte < 0x80) {
+            out += ch;
+        } else if (byte >= 0xC2 && byte <= 0xF4) {
+            need_ = byte >= 0xF0 ? 3 : (byte >= 0xE0 ? 2 : 1);
+            held_[0] = ch;
+            held_len_ = 1;
         } else {
-            return false;
+            // Stray continuation byte or a lead byte no valid sequence uses
+            out += kReplacementChar;
         }
+    }
+}
 
-        bytes += 1;
-        for (int i = 1; i < num; ++i) {
-            if ((*bytes & 0xC0) != 0x80)
-                return false;
-            bytes += 1;
-        }
+void Utf8StreamDecoder::flush(std::string& out) {
+    if (need_ > 0) {
+        out += kReplacementChar;
     }
-    return true;
+    reset();
+}
+
+// =============================================================================
+// SHARED WEIGHTS
+// =============================================================================
+
+// Every LlamaCppTextGeneration loading the same file with the same placement
+// shares one llama_model and creates its own llama_context on it
+static rac::SharedWeightsCache<llama_model>& shared_models() {
+    static rac::SharedWeightsCache<llama_model> cache(llama_model_free);
+    return cache;
+}
+
+static llama_model* acquire_model(const std::string& path, const llama_model_params& params) {
+    char variant[64];
+    snprintf(variant, sizeof(variant), "gpu=%d mmap=%d mlock=%d", params.n_gpu_layers,
+             params.use_mmap ? 1 : 0, params.use_mlock ? 1 : 0);
+    llama_model* model = shared_models().acquire(
+        path, variant, [&] { return llama_model_load_from_file(path.c_str(), params); });
+    if (model && shared_models().refs(model) > 1) {
+        LOGI("Sharing loaded weights of %s (%d users)", path.c_str(),
+             shared_models().refs(model));
+    }
+    return model;
+}
+
+static void release_model(llama_model* model) {
+    shared_models().release(model);
 }
 
 // =============================================================================
@@ -95,6 +152,9 @@ bool LlamaCppBackend::initialize(const nlohmann::json& config) {
 
     config_ = config;
 
+    if (!load_ggml_backends()) {
+        return false;
+    }
     llama_backend_init();
     llama_log_set(llama_log_callback, nullptr);
 
@@ -102,6 +162,14 @@ bool LlamaCppBackend::initialize(const nlohmann::json& config) {
         num_threads_ = config["num_threads"].get<int>();
     }
 
+    if (num_threads_ <= 0) {
+        // A calibrated device knows where its matmul throughput stops scaling
+        rac_device_recommendation_t recommendation;
+        if (rac_device_profile_recommend(&recommendation) == RAC_SUCCESS) {
+            num_threads_ = recommendation.llm_threads;
+        }
+    }
+
     if (num_threads_ <= 0) {
 #ifdef _SC_NPROCESSORS_ONLN
         num_threads_ = std::max(1, std::min(8, (int)sysconf(_SC_NPROCESSORS_ONLN) - 2));
@@ -142,12 +210,24 @@ DeviceType LlamaCppBackend::get_device_type() const {
 #elif defined(GGML_USE_CUDA)
     return DeviceType::CUDA;
 #else
+    // Android GPU builds fall back to CPU when the probe found no usable device
+    const bool offloaded = text_gen_ && text_gen_->gpu_layers() > 0;
+#if defined(GGML_USE_VULKAN)
+    return offloaded ? DeviceType::VULKAN : DeviceType::CPU;
+#elif defined(GGML_USE_OPENCL)
+    return offloaded ? DeviceType::OPENCL : DeviceType::CPU;
+#else
+    (void)offloaded;
     return DeviceType::CPU;
 #endif
+#endif
 }
 
 size_t LlamaCppBackend::get_memory_usage() const {
-    return 0;
+    if (!text_gen_ || !text_gen_->is_model_loaded()) {
+        return 0;
+    }
+    return text_gen_->get_memory_usage().total();
 }
 
 void LlamaCppBackend::create_text_generation() {
@@ -165,15 +245,33 @@ LlamaCppTextGeneration::LlamaCppTextGeneration(LlamaCppBackend* backend) : backe
 
 LlamaCppTextGeneration::~LlamaCppTextGeneration() {
     unload_model();
+    unload_embedding_model();
     LOGI("LlamaCppTextGeneration destroyed");
 }
 
+// KV cache types llama.cpp accepts, by config name
+static bool parse_kv_cache_type(const std::string& name, ggml_type* out_type) {
+    static const std::pair<const char*, ggml_type> kTypes[] = {
+        {"f32", GGML_TYPE_F32},   {"f16", GGML_TYPE_F16},   {"q8_0", GGML_TYPE_Q8_0},
+        {"q5_1", GGML_TYPE_Q5_1}, {"q5_0", GGML_TYPE_Q5_0}, {"q4_1", GGML_TYPE_Q4_1},
+        {"q4_0", GGML_TYPE_Q4_0},
+    };
+    for (const auto& [type_name, type] : kTypes) {
+        if (name == type_name) {
+            *out_type = type;
+            return true;
+        }
+    }
+    return false;
+}
+
 bool LlamaCppTextGeneration::is_ready() const {
     return model_loaded_ && model_ != nullptr && context_ != nullptr;
 }
 
 bool LlamaCppTextGeneration::load_model(const std::string& model_path,
                                         const nlohmann::json& config) {
+    RAC_TRACE_SCOPE("LLM.load_model");
     std::lock_guard<std::mutex> lock(mutex_);
 
     if (model_loaded_) {
@@ -182,6 +280,9 @@ bool LlamaCppTextGeneration::load_model(const std::string& model_path,
     }
 
     LOGI("Loading model from: %s", model_path.c_str());
+    lookup_drafted_ = 0;
+    lookup_accepted_ = 0;
+    lookup_decodes_ = 0;
 
     int user_context_size = 0;
     if (config.contains("context_size")) {
@@ -202,15 +303,75 @@ bool LlamaCppTextGeneration::load_model(const std::string& model_path,
     if (config.contains("top_k")) {
         top_k_ = config["top_k"].get<int>();
     }
+    if (config.contains("draft_tokens")) {
+        n_draft_ = std::max(1, config["draft_tokens"].get<int>());
+    }
+    if (config.contains("max_parallel_requests")) {
+        n_parallel_ = std::clamp(config["max_parallel_requests"].get<int>(), 1,
+                                 kMaxParallelSequences);
+    }
+
+    type_k_ = GGML_TYPE_F16;
+    type_v_ = GGML_TYPE_F16;
+    flash_attn_type_ = LLAMA_FLASH_ATTN_TYPE_AUTO;
+    if (config.contains("kv_cache_type_k") &&
+        !parse_kv_cache_type(config["kv_cache_type_k"].get<std::string>(), &type_k_)) {
+        LOGE("Unknown kv_cache_type_k, using f16");
+    }
+    if (config.contains("kv_cache_type_v") &&
+        !parse_kv_cache_type(config["kv_cache_type_v"].get<std::string>(), &type_v_)) {
+        LOGE("Unknown kv_cache_type_v, using f16");
+    }
+    if (config.contains("flash_attention")) {
+        const bool enabled = config["flash_attention"].get<bool>();
+        flash_attn_type_ = enabled ? LLAMA_FLASH_ATTN_TYPE_ENABLED : LLAMA_FLASH_ATTN_TYPE_DISABLED;
+    }
+    const bool v_quantized = type_v_ != GGML_TYPE_F16 && type_v_ != GGML_TYPE_F32;
+    if (v_quantized) {
+        if (flash_attn_type_ == LLAMA_FLASH_ATTN_TYPE_DISABLED) {
+            LOGE("Quantized V cache needs flash attention; keeping V cache at f16");
+            type_v_ = GGML_TYPE_F16;
+        } else {
+            flash_attn_type_ = LLAMA_FLASH_ATTN_TYPE_ENABLED;
+        }
+    }
+
+    // -1 (default) offloads as many layers as the GPU probe says fit
+    int requested_gpu_layers = -1;
+    if (config.contains("gpu_layers")) {
+        requested_gpu_layers = config["gpu_layers"].get<int>();
+    }
 
     model_config_ = config;
     model_path_ = model_path;
 
+    // Load modes follow rac_model_load_mode_t
+    enum { kLoadDefault = 0, kLoadPrefetch = 1, kLoadMlock = 2, kLoadNoMmap = 3 };
+    const int load_mode = config.contains("load_mode") ? config["load_mode"].get<int>() : 0;
+
     llama_model_params model_params = llama_model_default_params();
-    model_ = llama_model_load_from_file(model_path.c_str(), model_params);
+    if (load_mode == kLoadMlock) {
+        model_params.use_mmap = true;
+        model_params.use_mlock = true;
+    } else if (load_mode == kLoadNoMmap) {
+        model_params.use_mmap = false;
+    }
+    if (load_mode == kLoadPrefetch) {
+        // Started before the load so reading overlaps with tensor setup
+        start_prefetch(model_path);
+    }
+    const int n_ctx_hint = user_context_size > 0 ? user_context_size : max_default_context_;
+    n_gpu_layers_ = choose_gpu_layers(model_path, requested_gpu_layers, n_ctx_hint);
+    model_params.n_gpu_layers = n_gpu_layers_;
+    // Forwards progress to rac_lifecycle_load_async; returning false aborts the load
+    model_params.progress_callback = [](float progress, void*) {
+        return rac_lifecycle_report_load_progress(progress) == RAC_TRUE;
+    };
+    model_ = acquire_model(model_path, model_params);
 
     if (!model_) {
         LOGE("Failed to load model from: %s", model_path.c_str());
+        stop_prefetch();
         return false;
     }
 
@@ -225,51 +386,62 @@ bool LlamaCppTextGeneration::load_model(const std::string& model_path,
         context_size_ = std::min(model_train_ctx, max_default_context_);
         LOGI("Auto-detected context size: %d (model: %d, cap: %d)", context_size_, model_train_ctx,
              max_default_context_);
-    }
 
-    llama_context_params ctx_params = llama_context_default_params();
-    ctx_params.n_ctx = context_size_;
-    ctx_params.n_batch = std::min(context_size_, 512);
-    ctx_params.n_threads = backend_->get_num_threads();
-    ctx_params.n_threads_batch = backend_->get_num_threads();
-    ctx_params.no_perf = true;
+        if (config.contains("memory_budget_mb")) {
+            const size_t budget = static_cast<size_t>(config["memory_budget_mb"].get<int>()) *
+                                  1024 * 1024;
+            context_size_ = fit_context_to_budget(context_size_, budget);
+        }
+    }
 
-    context_ = llama_init_from_model(model_, ctx_params);
+    context_ = llama_init_from_model(model_, make_context_params(context_size_));
 
     if (!context_) {
         LOGE("Failed to create context");
-        llama_model_free(model_);
+        stop_prefetch();
+        release_model(model_);
         model_ = nullptr;
         return false;
     }
 
-    auto sparams = llama_sampler_chain_default_params();
-    sparams.no_perf = true;
-    sampler_ = llama_sampler_chain_init(sparams);
-
-    if (temperature_ > 0.0f) {
-        llama_sampler_chain_add(sampler_, llama_sampler_init_penalties(64, 1.2f, 0.0f, 0.0f));
-
-        if (top_k_ > 0) {
-            llama_sampler_chain_add(sampler_, llama_sampler_init_top_k(top_k_));
-        }
+    default_sampling_ = {temperature_, top_p_, top_k_, kDefaultRepetitionPenalty};
+    const char* model_template = llama_model_chat_template(model_, nullptr);
+    chat_template_ = model_template ? model_template : "";
+    collect_template_stop_sequences();
+    sampler_for(default_sampling_);
 
-        llama_sampler_chain_add(sampler_, llama_sampler_init_top_p(top_p_, 1));
-        llama_sampler_chain_add(sampler_, llama_sampler_init_temp(temperature_));
-        llama_sampler_chain_add(sampler_, llama_sampler_init_dist(LLAMA_DEFAULT_SEED));
-    } else {
-        llama_sampler_chain_add(sampler_, llama_sampler_init_greedy());
+    if (config.contains("draft_model_path")) {
+        // Optional: a failed draft load only disables speculative decoding
+        load_draft_model(config["draft_model_path"].get<std::string>());
     }
+    // Optional too: without a vision projector the model only takes text
+    load_vision_model(model_path, config);
 
-    LOGI("Sampler chain: penalties(64,1.2) -> top_k(%d) -> top_p(%.2f) -> temp(%.2f) -> dist",
-         top_k_, top_p_, temperature_);
+    start_scheduler();
 
     model_loaded_ = true;
-    LOGI("Model loaded successfully: context_size=%d, temp=%.2f", context_size_, temperature_);
+    LOGI("Model loaded successfully: context_size=%d, temp=%.2f, load_mode=%d", context_size_,
+         temperature_, load_mode);
 
     return true;
 }
 
+llama_context_params LlamaCppTextGeneration::make_context_params(int n_ctx) const {
+    llama_context_params ctx_params = llama_context_default_params();
+    ctx_params.n_ctx = n_ctx;
+    ctx_params.n_batch = std::min(n_ctx, 512);
+    // All sequences share one KV pool so a lone request can still use the full context
+    ctx_params.n_seq_max = n_parallel_;
+    ctx_params.kv_unified = true;
+    ctx_params.n_threads = backend_->get_num_threads();
+    ctx_params.n_threads_batch = backend_->get_num_threads();
+    ctx_params.type_k = type_k_;
+    ctx_params.type_v = type_v_;
+    ctx_params.flash_attn_type = flash_attn_type_;
+    ctx_params.no_perf = true;
+    return ctx_params;
+}
+
 bool LlamaCppTextGeneration::is_model_loaded() const {
     return model_loaded_;
 }
@@ -281,19 +453,33 @@ bool LlamaCppTextGeneration::unload_model_internal() {
 
     LOGI("Unloading model");
 
-    if (sampler_) {
-        llama_sampler_free(sampler_);
-        sampler_ = nullptr;
+    stop_prefetch();
+    stop_scheduler();
+    unload_draft_model();
+    unload_vision_model();
+    free_lora_adapters();
+
+    for (auto& entry : sampler_pool_) {
+        llama_sampler_free(entry.second);
     }
+    sampler_pool_.clear();
+    free_grammars();
+    std::vector<std::string>().swap(vocab_pieces_);
 
     if (context_) {
         llama_free(context_);
         context_ = nullptr;
     }
 
-    if (model_) {
-        llama_model_free(model_);
-        model_ = nullptr;
+    {
+        std::lock_guard<std::mutex> embed_lock(embed_mutex_);
+        if (!embed_model_) {
+            free_embedding_context_locked();
+        }
+        if (model_) {
+            release_model(model_);
+            model_ = nullptr;
+        }
     }
 
     model_loaded_ = false;
@@ -308,85 +494,331 @@ bool LlamaCppTextGeneration::unload_model() {
     return unload_model_internal();
 }
 
-std::string LlamaCppTextGeneration::build_prompt(const TextGenerationRequest& request) {
-    std::vector<std::pair<std::string, std::string>> messages;
+// =============================================================================
+// STOP SEQUENCES
+// =============================================================================
+
+StopSequenceMatcher::StopSequenceMatcher(const std::vector<std::string>& stop_sequences) {
+    Node root;
+    root.next.fill(-1);
+    nodes_.push_back(root);
+
+    for (const auto& stop : stop_sequences) {
+        if (stop.empty()) {
+            continue;
+        }
+        int32_t node = 0;
+        for (unsigned char c : stop) {
+            if (nodes_[node].next[c] < 0) {
+                Node child;
+                child.next.fill(-1);
+                child.depth = nodes_[node].depth + 1;
+                nodes_[node].next[c] = static_cast<int32_t>(nodes_.size());
+                nodes_.push_back(child);
+            }
+            node = nodes_[node].next[c];
+        }
+        nodes_[node].match = nodes_[node].depth;
+    }
+
+    // Breadth-first: fill failure links and complete the transition table
+    std::deque<int32_t> queue;
+    for (int c = 0; c < 256; c++) {
+        int32_t& child = nodes_[0].next[c];
+        if (child < 0) {
+            child = 0;
+        } else {
+            nodes_[child].fail = 0;
+            queue.push_back(child);
+        }
+    }
+    while (!queue.empty()) {
+        const int32_t node = queue.front();
+        queue.pop_front();
+        if (nodes_[node].match == 0) {
+            nodes_[node].match = nodes_[nodes_[node].fail].match;
+        }
+        for (int c = 0; c < 256; c++) {
+            const int32_t child = nodes_[node].next[c];
+            const int32_t via_fail = nodes_[nodes_[node].fail].next[c];
+            if (child < 0) {
+                nodes_[node].next[c] = via_fail;
+            } else {
+                nodes_[child].fail = via_fail;
+                queue.push_back(child);
+            }
+        }
+    }
+}
+
+std::string StopSequenceMatcher::feed(const std::string& text) {
+    if (stopped_) {
+        return {};
+    }
+    for (size_t i = 0; i < text.size(); i++) {
+        state_ = nodes_[state_].next[static_cast<unsigned char>(text[i])];
+        held_ += text[i];
+        if (nodes_[state_].match > 0) {
+            held_.resize(held_.size() - static_cast<size_t>(nodes_[state_].match));
+            stopped_ = true;
+            std::string out;
+            out.swap(held_);
+            return out;
+        }
+    }
+    // Only the current match depth can still turn into a stop sequence
+    const size_t keep = std::min(held_.size(), static_cast<size_t>(nodes_[state_].depth));
+    std::string out = held_.substr(0, held_.size() - keep);
+    held_.erase(0, held_.size() - keep);
+    return out;
+}
+
+std::string StopSequenceMatcher::flush() {
+    std::string out;
+    out.swap(held_);
+    state_ = 0;
+    return out;
+}
+
+void StopSequenceMatcher::reset() {
+    state_ = 0;
+    held_.clear();
+    stopped_ = false;
+}
+
+// The model's end-of-generation tokens normally stop decoding as tokens, but
+// the same markers can also be produced as plain text.
+void LlamaCppTextGeneration::collect_template_stop_sequences() {
+    stop_sequences_ = {
+        "<|im_end|>",
+        "<|eot_id|>",
+        "</s>",
+        "<|end|>",
+        "<|endoftext|>",
+        "\n\nUser:",
+        "\n\nHuman:",
+    };
+
+    const auto* vocab = llama_model_get_vocab(model_);
+    const int32_t n_vocab = llama_vocab_n_tokens(vocab);
+    for (llama_token token = 0; token < n_vocab; token++) {
+        if (!llama_vocab_is_eog(vocab, token)) {
+            continue;
+        }
+        const std::string piece = common_token_to_piece(context_, token, true);
+        // Single characters are too likely in ordinary text to act as stops
+        if (piece.size() > 1 &&
+            std::find(stop_sequences_.begin(), stop_sequences_.end(), piece) == stop_sequences_.end()) {
+            stop_sequences_.push_back(piece);
+        }
+    }
+    LOGI("Stop sequences: %zu (including model end-of-generation markers)", stop_sequences_.size());
+}
+
+// =============================================================================
+// SAMPLER POOL
+// =============================================================================
+
+static llama_sampler* build_sampler_chain(const SamplerParams& params) {
+    auto sparams = llama_sampler_chain_default_params();
+    sparams.no_perf = true;
+    llama_sampler* sampler = llama_sampler_chain_init(sparams);
+
+    if (params.temperature > 0.0f) {
+        if (params.repetition_penalty != 1.0f) {
+            llama_sampler_chain_add(
+                sampler, llama_sampler_init_penalties(64, params.repetition_penalty, 0.0f, 0.0f));
+        }
+
+        if (params.top_k > 0) {
+            llama_sampler_chain_add(sampler, llama_sampler_init_top_k(params.top_k));
+        }
+
+        llama_sampler_chain_add(sampler, llama_sampler_init_top_p(params.top_p, 1));
+        llama_sampler_chain_add(sampler, llama_sampler_init_temp(params.temperature));
+        llama_sampler_chain_add(sampler, llama_sampler_init_dist(LLAMA_DEFAULT_SEED));
+    } else {
+        llama_sampler_chain_add(sampler, llama_sampler_init_greedy());
+    }
+
+    LOGI("Sampler chain: penalties(64,%.2f) -> top_k(%d) -> top_p(%.2f) -> temp(%.2f) -> dist",
+         params.repetition_penalty, params.top_k, params.top_p, params.temperature);
+    return sampler;
+}
+
+// Returns the template chain for these parameters (most recently used first).
+// Requests sample with a clone, so templates never carry per-request state.
+// Caller must hold mutex_.
+llama_sampler* LlamaCppTextGeneration::sampler_for(const SamplerParams& params) {
+    auto it = std::find_if(sampler_pool_.begin(), sampler_pool_.end(),
+                           [&](const auto& entry) { return entry.first == params; });
+    if (it != sampler_pool_.end()) {
+        std::rotate(sampler_pool_.begin(), it, it + 1);
+        return sampler_pool_.front().second;
+    }
+
+    if (sampler_pool_.size() >= kSamplerPoolSize) {
+        llama_sampler_free(sampler_pool_.back().second);
+        sampler_pool_.pop_back();
+    }
+    sampler_pool_.insert(sampler_pool_.begin(), {params, build_sampler_chain(params)});
+    return sampler_pool_.front().second;
+}
+
+// Compiling a schema (schema -> GBNF -> parsed grammar) costs far more than a
+// clone, so compiled grammars are kept per schema and cloned per request. The
+// key is the one the compiled schema validators use.
+llama_sampler* LlamaCppTextGeneration::grammar_for(const std::string& json_schema) {
+    const uint64_t key = rac_structured_output_schema_hash(json_schema.c_str());
+    auto it = std::find_if(grammar_cache_.begin(), grammar_cache_.end(),
+                           [&](const auto& entry) { return entry.first == key; });
+    if (it != grammar_cache_.end()) {
+        std::rotate(grammar_cache_.begin(), it, it + 1);
+        return grammar_cache_.front().second;
+    }
+
+    std::string grammar;
+    try {
+        grammar = json_schema_to_grammar(nlohmann::ordered_json::parse(json_schema));
+    } catch (const std::exception& e) {
+        LOGE("Invalid JSON schema for constrained decoding: %s", e.what());
+        return nullptr;
+    }
+
+    llama_sampler* sampler =
+        llama_sampler_init_grammar(llama_model_get_vocab(model_), grammar.c_str(), "root");
+    if (!sampler) {
+        LOGE("Failed to parse grammar compiled from JSON schema");
+        return nullptr;
+    }
+    LOGI("Compiled JSON schema to grammar (%zu bytes)", grammar.size());
+
+    if (grammar_cache_.size() >= kGrammarCacheSize) {
+        llama_sampler_free(grammar_cache_.back().second);
+        grammar_cache_.pop_back();
+    }
+    grammar_cache_.insert(grammar_cache_.begin(), {key, sampler});
+    return sampler;
+}
+
+void LlamaCppTextGeneration::free_grammars() {
+    for (auto& entry : grammar_cache_) {
+        llama_sampler_free(entry.second);
+    }
+    grammar_cache_.clear();
+}
 
+// The returned prompt lives in prompt_text_ and stays valid until the next
+// call under mutex_.
+const std::string& LlamaCppTextGeneration::build_prompt(const TextGenerationRequest& request) {
     if (!request.messages.empty()) {
-        messages = request.messages;
+        apply_chat_template(request.messages, request.system_prompt, true);
     } else if (!request.prompt.empty()) {
-        messages.push_back({"user", request.prompt});
+        prompt_turn_.resize(1);
+        prompt_turn_[0].first = "user";
+        prompt_turn_[0].second = request.prompt;
         LOGI("Converted prompt to user message for chat template");
+        apply_chat_template(prompt_turn_, request.system_prompt, true);
     } else {
         LOGE("No prompt or messages provided");
-        return "";
+        prompt_text_.clear();
+        return prompt_text_;
     }
 
-    std::string formatted = apply_chat_template(messages, request.system_prompt, true);
-    LOGI("Applied chat template, formatted prompt length: %zu", formatted.length());
-
-    return formatted;
+    LOGI("Applied chat template, formatted prompt length: %zu", prompt_text_.length());
+    return prompt_text_;
 }
 
-std::string LlamaCppTextGeneration::apply_chat_template(
+const std::string& LlamaCppTextGeneration::apply_chat_template(
     const std::vector<std::pair<std::string, std::string>>& messages,
     const std::string& system_prompt, bool add_assistant_token) {
-    std::vector<llama_chat_message> chat_messages;
+    chat_messages_.clear();
 
-    std::vector<std::string> role_storage;
-    role_storage.reserve(messages.size());
+    // Sized up front so the c_str() pointers taken below stay valid
+    chat_roles_.resize(messages.size());
 
     if (!system_prompt.empty()) {
-        chat_messages.push_back({"system", system_prompt.c_str()});
+        chat_messages_.push_back({"system", system_prompt.c_str()});
     }
 
-    for (const auto& [role, content] : messages) {
-        std::string role_lower = role;
+    for (size_t i = 0; i < messages.size(); i++) {
+        std::string& role_lower = chat_roles_[i];
+        role_lower.assign(messages[i].first);
         std::transform(role_lower.begin(), role_lower.end(), role_lower.begin(), ::tolower);
-        role_storage.push_back(std::move(role_lower));
-        chat_messages.push_back({role_storage.back().c_str(), content.c_str()});
+        chat_messages_.push_back({role_lower.c_str(), messages[i].second.c_str()});
     }
 
-    std::string model_template;
-    model_template.resize(2048);
-    int32_t template_len = llama_model_meta_val_str(model_, "tokenizer.chat_template",
-                                                    model_template.data(), model_template.size());
+    const char* tmpl_to_use = chat_template_.empty() ? nullptr : chat_template_.c_str();
 
-    const char* tmpl_to_use = nullptr;
-    if (template_len > 0) {
-        model_template.resize(template_len);
-        tmpl_to_use = model_template.c_str();
+    if (prompt_text_.capacity() < 4096) {
+        prompt_text_.reserve(4096);
     }
-
-    std::string formatted;
-    formatted.resize(1024 * 256);
+    prompt_text_.resize(prompt_text_.capacity());
 
     int32_t result =
-        llama_chat_apply_template(tmpl_to_use, chat_messages.data(), chat_messages.size(),
-                                  add_assistant_token, formatted.data(), formatted.size());
+        llama_chat_apply_template(tmpl_to_use, chat_messages_.data(), chat_messages_.size(),
+                                  add_assistant_token, prompt_text_.data(), prompt_text_.size());
 
     if (result < 0) {
         LOGE("llama_chat_apply_template failed: %d", result);
-        std::string fallback;
-        for (const auto& msg : chat_messages) {
-            fallback += std::string(msg.role) + ": " + msg.content + "\n";
+        prompt_text_.clear();
+        for (const auto& msg : chat_messages_) {
+            prompt_text_.append(msg.role).append(": ").append(msg.content).append("\n");
         }
         if (add_assistant_token) {
-            fallback += "assistant: ";
+            prompt_text_ += "assistant: ";
         }
-        return fallback;
+        return prompt_text_;
+    }
+
+    if (result > (int32_t)prompt_text_.size()) {
+        prompt_text_.resize(result + 1024);
+        result = llama_chat_apply_template(tmpl_to_use, chat_messages_.data(), chat_messages_.size(),
+                                           add_assistant_token, prompt_text_.data(),
+                                           prompt_text_.size());
     }
 
-    if (result > (int32_t)formatted.size()) {
-        formatted.resize(result + 1024);
-        result = llama_chat_apply_template(tmpl_to_use, chat_messages.data(), chat_messages.size(),
-                                           add_assistant_token, formatted.data(), formatted.size());
+    prompt_text_.resize(result > 0 ? result : 0);
+    return prompt_text_;
+}
+
+// Tokenizes into a caller-owned buffer so its capacity carries over between
+// requests. Returns false if the text cannot be tokenized.
+bool LlamaCppTextGeneration::tokenize_into(const std::string& text,
+                                           std::vector<llama_token>& tokens) {
+    const auto* vocab = llama_model_get_vocab(model_);
+    // One token per byte plus BOS/EOS is an upper bound for any vocab
+    tokens.resize(text.size() + 2);
+    int32_t n = llama_tokenize(vocab, text.data(), static_cast<int32_t>(text.size()), tokens.data(),
+                               static_cast<int32_t>(tokens.size()), true, true);
+    if (n < 0) {
+        tokens.resize(static_cast<size_t>(-n));
+        n = llama_tokenize(vocab, text.data(), static_cast<int32_t>(text.size()), tokens.data(),
+                           static_cast<int32_t>(tokens.size()), true, true);
+    }
+    if (n < 0) {
+        tokens.clear();
+        return false;
     }
+    tokens.resize(static_cast<size_t>(n));
+    return true;
+}
+
+int LlamaCppTextGeneration::count_tokens(const std::string& text) {
+    std::lock_guard<std::mutex> lock(mutex_);
 
-    if (result > 0) {
-        formatted.resize(result);
+    if (!is_ready()) {
+        return -1;
+    }
+    if (text.empty()) {
+        return 0;
     }
 
-    return formatted;
+    // A zero-sized buffer makes llama_tokenize return the negated token count
+    const auto* vocab = llama_model_get_vocab(model_);
+    const int32_t n = llama_tokenize(vocab, text.data(), static_cast<int32_t>(text.size()), nullptr,
+                                     0, false, true);
+    return n < 0 ? -n : n;
 }
 
 TextGenerationResult LlamaCppTextGeneration::generate(const TextGenerationRequest& request) {
@@ -399,14 +831,15 @@ TextGenerationResult LlamaCppTextGeneration::generate(const TextGenerationReques
 
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    bool success = generate_stream(
+    std::string finish_reason;
+    generate_stream(
         request,
         [&](const std::string& token) -> bool {
             generated_text += token;
             tokens_generated++;
-            return !cancel_requested_.load();
+            return true;
         },
-        &prompt_tokens);
+        &prompt_tokens, nullptr, &finish_reason);
 
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -416,149 +849,1741 @@ TextGenerationResult LlamaCppTextGeneration::generate(const TextGenerationReques
     result.prompt_tokens = prompt_tokens;
     result.inference_time_ms = duration.count();
 
-    if (cancel_requested_.load()) {
-        result.finish_reason = "cancelled";
-    } else if (success) {
-        result.finish_reason = tokens_generated >= request.max_tokens ? "length" : "stop";
+    if (!finish_reason.empty()) {
+        result.finish_reason = finish_reason;
     }
 
     return result;
 }
 
-bool LlamaCppTextGeneration::generate_stream(const TextGenerationRequest& request,
-                                             TextStreamCallback callback,
-                                             int* out_prompt_tokens) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    if (!is_ready()) {
-        LOGE("Model not ready for generation");
+bool LlamaCppTextGeneration::generate_batch(
+    const std::vector<TextGenerationRequest>& requests,
+    const std::function<void(size_t, const TextGenerationResult&)>& on_result) {
+    if (!is_model_loaded()) {
+        LOGE("Model not ready for batch generation");
         return false;
     }
+    if (requests.empty()) {
+        return true;
+    }
 
-    cancel_requested_.store(false);
-
-    std::string prompt = build_prompt(request);
-    LOGI("Generating with prompt length: %zu", prompt.length());
+    const uint64_t epoch = cancel_epoch_.load();
+    std::mutex result_mutex;
+
+    // The first request runs alone until its prompt is decoded, so the others
+    // (typically sharing an instruction prefix) copy its cache instead of all
+    // prefilling the same tokens at once.
+    std::mutex primed_mutex;
+    std::condition_variable primed_cv;
+    bool primed = false;
+    auto mark_primed = [&] {
+        std::lock_guard<std::mutex> lock(primed_mutex);
+        if (!primed) {
+            primed = true;
+            primed_cv.notify_all();
+        }
+    };
 
-    const auto tokens_list = common_tokenize(context_, prompt, true, true);
+    auto run_one = [&](size_t index, bool primer) {
+        TextGenerationResult result;
+        if (cancel_epoch_.load() != epoch) {
+            result.finish_reason = "cancelled";
+        } else {
+            result.finish_reason = "error";
+            auto start_time = std::chrono::steady_clock::now();
+            generate_stream(
+                requests[index],
+                [&](const std::string& token) -> bool {
+                    if (primer) {
+                        mark_primed();
+                    }
+                    result.text += token;
+                    result.tokens_generated++;
+                    return true;
+                },
+                &result.prompt_tokens, nullptr, &result.finish_reason);
+            result.inference_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                           std::chrono::steady_clock::now() - start_time)
+                                           .count();
+        }
+        if (primer) {
+            mark_primed();
+        }
+        std::lock_guard<std::mutex> lock(result_mutex);
+        on_result(index, result);
+    };
+
+    std::atomic<size_t> next{1};
+    auto worker = [&] {
+        {
+            std::unique_lock<std::mutex> lock(primed_mutex);
+            primed_cv.wait(lock, [&] { return primed; });
+        }
+        for (size_t i = next.fetch_add(1); i < requests.size(); i = next.fetch_add(1)) {
+            run_one(i, false);
+        }
+    };
 
-    int n_ctx = llama_n_ctx(context_);
-    int prompt_tokens = static_cast<int>(tokens_list.size());
+    const size_t n_workers = std::min(requests.size(), static_cast<size_t>(n_parallel_));
+    std::vector<std::thread> workers;
+    workers.reserve(n_workers - 1);
+    for (size_t i = 1; i < n_workers; i++) {
+        workers.emplace_back(worker);
+    }
 
-    if (out_prompt_tokens) {
-        *out_prompt_tokens = prompt_tokens;
+    LOGI("Batch generation: %zu requests on %zu sequences", requests.size(), n_workers);
+    run_one(0, true);
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
     }
+    return true;
+}
 
-    int available_tokens = n_ctx - prompt_tokens - 4;
+// =============================================================================
+// EMBEDDINGS
+// =============================================================================
 
-    if (available_tokens <= 0) {
-        LOGE("Prompt too long: %d tokens, context size: %d", prompt_tokens, n_ctx);
+bool LlamaCppTextGeneration::load_embedding_model(const std::string& model_path) {
+    std::lock_guard<std::mutex> lock(embed_mutex_);
+
+    llama_model_params model_params = llama_model_default_params();
+    if (n_gpu_layers_ == 0) {
+        model_params.n_gpu_layers = 0;
+    }
+    llama_model* model = acquire_model(model_path, model_params);
+    if (!model) {
+        LOGE("Failed to load embedding model from: %s", model_path.c_str());
         return false;
     }
 
-    int effective_max_tokens = std::min(request.max_tokens, available_tokens);
-    if (effective_max_tokens < request.max_tokens) {
-        LOGI("Capping max_tokens: %d → %d (context=%d, prompt=%d tokens)", request.max_tokens,
-             effective_max_tokens, n_ctx, prompt_tokens);
+    free_embedding_context_locked();
+    if (embed_model_) {
+        release_model(embed_model_);
     }
-    LOGI("Generation: prompt_tokens=%d, max_tokens=%d, context=%d", prompt_tokens,
-         effective_max_tokens, n_ctx);
+    embed_model_ = model;
+    LOGI("Embedding model loaded: %s (dim=%d)", model_path.c_str(), llama_model_n_embd(model));
+    return true;
+}
 
-    llama_batch batch = llama_batch_init(n_ctx, 0, 1);
+void LlamaCppTextGeneration::unload_embedding_model() {
+    std::lock_guard<std::mutex> lock(embed_mutex_);
+    free_embedding_context_locked();
+    if (embed_model_) {
+        release_model(embed_model_);
+        embed_model_ = nullptr;
+    }
+}
 
-    batch.n_tokens = 0;
-    for (size_t i = 0; i < tokens_list.size(); i++) {
-        common_batch_add(batch, tokens_list[i], i, {0}, false);
+void LlamaCppTextGeneration::free_embedding_context_locked() {
+    if (embed_batch_.token) {
+        llama_batch_free(embed_batch_);
+        embed_batch_ = {};
+    }
+    if (embed_context_) {
+        llama_free(embed_context_);
+        embed_context_ = nullptr;
     }
-    batch.logits[batch.n_tokens - 1] = true;
+}
 
-    if (llama_decode(context_, batch) != 0) {
-        LOGE("llama_decode failed for prompt");
-        llama_batch_free(batch);
+bool LlamaCppTextGeneration::ensure_embedding_context_locked() {
+    if (embed_context_) {
+        return true;
+    }
+    llama_model* model = embed_model_ ? embed_model_ : (model_loaded_ ? model_ : nullptr);
+    if (!model) {
         return false;
     }
 
-    llama_sampler_reset(sampler_);
+    // Non-causal models need each input within one ubatch, so the whole
+    // context is a single ubatch
+    llama_context_params ctx_params = llama_context_default_params();
+    ctx_params.n_ctx = std::min(kEmbedContextSize, llama_model_n_ctx_train(model));
+    ctx_params.n_batch = ctx_params.n_ctx;
+    ctx_params.n_ubatch = ctx_params.n_ctx;
+    ctx_params.n_seq_max = kMaxEmbedSequences;
+    ctx_params.n_threads = backend_->get_num_threads();
+    ctx_params.n_threads_batch = backend_->get_num_threads();
+    ctx_params.embeddings = true;
+    ctx_params.no_perf = true;
+
+    embed_context_ = llama_init_from_model(model, ctx_params);
+    if (embed_context_ && llama_pooling_type(embed_context_) == LLAMA_POOLING_TYPE_NONE) {
+        // Generation models carry no pooling metadata; mean pooling is the
+        // usual choice for them
+        llama_free(embed_context_);
+        ctx_params.pooling_type = LLAMA_POOLING_TYPE_MEAN;
+        embed_context_ = llama_init_from_model(model, ctx_params);
+    }
+    if (!embed_context_) {
+        LOGE("Failed to create embedding context");
+        return false;
+    }
 
-    const auto vocab = llama_model_get_vocab(model_);
-    std::string cached_token_chars;
-    std::string accumulated_text;
-    int n_cur = batch.n_tokens;
-    int tokens_generated = 0;
+    embed_batch_ = llama_batch_init(static_cast<int32_t>(ctx_params.n_batch), 0, 1);
+    LOGI("Embedding context ready: n_ctx=%u, pooling=%d, %s model", ctx_params.n_ctx,
+         static_cast<int>(llama_pooling_type(embed_context_)),
+         embed_model_ ? "dedicated" : "generation");
+    return true;
+}
 
-    while (tokens_generated < effective_max_tokens && !cancel_requested_.load()) {
-        const llama_token new_token_id = llama_sampler_sample(sampler_, context_, -1);
+int LlamaCppTextGeneration::embedding_dim() {
+    std::lock_guard<std::mutex> lock(embed_mutex_);
+    if (embed_model_) {
+        return llama_model_n_embd(embed_model_);
+    }
+    return model_loaded_ ? llama_model_n_embd(model_) : 0;
+}
 
-        llama_sampler_accept(sampler_, new_token_id);
+bool LlamaCppTextGeneration::embed(const std::vector<std::string>& texts, bool normalize,
+                                   float* out) {
+    std::lock_guard<std::mutex> lock(embed_mutex_);
+    if (!ensure_embedding_context_locked()) {
+        LOGE("No model available for embeddings");
+        return false;
+    }
 
-        if (llama_vocab_is_eog(vocab, new_token_id)) {
-            LOGI("End of generation token received");
-            break;
+    const llama_model* model = llama_get_model(embed_context_);
+    const auto* vocab = llama_model_get_vocab(model);
+    const int n_embd = llama_model_n_embd(model);
+    const int32_t n_batch = static_cast<int32_t>(llama_n_batch(embed_context_));
+    const bool encoder_only = llama_model_has_encoder(model) && !llama_model_has_decoder(model);
+
+    // Decodes the sequences in the batch and copies their pooled vectors to
+    // rows first..first+n_seq-1
+    auto flush = [&](size_t first, int n_seq) -> bool {
+        if (n_seq == 0) {
+            return true;
         }
-
-        auto new_token_chars = common_token_to_piece(context_, new_token_id);
-        cached_token_chars += new_token_chars;
-        accumulated_text += new_token_chars;
-
-        static const std::vector<std::string> stop_sequences = {
-            "<|im_end|>",
-            "<|eot_id|>",
-            "</s>",
-            "<|end|>",
-            "<|endoftext|>",
-            "\n\nUser:",
-            "\n\nHuman:",
-        };
-
-        bool hit_stop_sequence = false;
-        for (const auto& stop_seq : stop_sequences) {
-            size_t pos = accumulated_text.find(stop_seq);
-            if (pos != std::string::npos) {
-                LOGI("Stop sequence detected: %s", stop_seq.c_str());
-                hit_stop_sequence = true;
-                break;
+        const int32_t rc = encoder_only ? llama_encode(embed_context_, embed_batch_)
+                                        : llama_decode(embed_context_, embed_batch_);
+        if (rc != 0) {
+            LOGE("Embedding decode failed for %d sequences", n_seq);
+            return false;
+        }
+        for (int seq = 0; seq < n_seq; seq++) {
+            const float* vec = llama_get_embeddings_seq(embed_context_, seq);
+            if (!vec) {
+                LOGE("No pooled embedding for sequence %d", seq);
+                return false;
+            }
+            float* row = out + (first + static_cast<size_t>(seq)) * static_cast<size_t>(n_embd);
+            float scale = 1.0f;
+            if (normalize) {
+                double sum = 0.0;
+                for (int i = 0; i < n_embd; i++) {
+                    sum += static_cast<double>(vec[i]) * vec[i];
+                }
+                scale = sum > 0.0 ? static_cast<float>(1.0 / std::sqrt(sum)) : 0.0f;
+            }
+            for (int i = 0; i < n_embd; i++) {
+                row[i] = vec[i] * scale;
             }
         }
-
-        if (hit_stop_sequence) {
-            break;
+        llama_memory_clear(llama_get_memory(embed_context_), true);
+        common_batch_clear(embed_batch_);
+        return true;
+    };
+
+    common_batch_clear(embed_batch_);
+    llama_memory_clear(llama_get_memory(embed_context_), true);
+    size_t first = 0;
+    int n_seq = 0;
+    for (size_t t = 0; t < texts.size(); t++) {
+        const std::string& text = texts[t];
+        embed_tokens_.resize(text.size() + 2);
+        int32_t n = llama_tokenize(vocab, text.data(), static_cast<int32_t>(text.size()),
+                                   embed_tokens_.data(), static_cast<int32_t>(embed_tokens_.size()),
+                                   true, false);
+        if (n < 0) {
+            embed_tokens_.resize(static_cast<size_t>(-n));
+            n = llama_tokenize(vocab, text.data(), static_cast<int32_t>(text.size()),
+                               embed_tokens_.data(), static_cast<int32_t>(embed_tokens_.size()),
+                               true, false);
+        }
+        if (n < 0) {
+            LOGE("Failed to tokenize embedding input %zu", t);
+            return false;
+        }
+        if (n > n_batch) {
+            LOGI("Embedding input %zu truncated from %d to %d tokens", t, n, n_batch);
+            n = n_batch;
         }
 
-        if (is_valid_utf8(cached_token_chars.c_str())) {
-            if (!callback(cached_token_chars)) {
-                LOGI("Generation cancelled by callback");
-                cancel_requested_.store(true);
-                break;
+        if (n_seq == kMaxEmbedSequences || embed_batch_.n_tokens + n > n_batch) {
+            if (!flush(first, n_seq)) {
+                return false;
             }
-            cached_token_chars.clear();
+            first = t;
+            n_seq = 0;
+        }
+        for (int32_t i = 0; i < n; i++) {
+            common_batch_add(embed_batch_, embed_tokens_[i], i, {n_seq}, true);
+        }
+        n_seq++;
+    }
+    return flush(first, n_seq);
+}
+
+// =============================================================================
+// CONTINUOUS BATCHING
+// =============================================================================
+
+// One in-flight request. Decoding and sampling happen on the scheduler thread;
+// text is handed back to the calling thread, which runs the user callback so
+// callers (JNI in particular) see callbacks on their own thread.
+struct GenerationSlot {
+    llama_seq_id seq_id = -1;
+    std::vector<llama_token> prompt;
+    size_t n_prompt_decoded = 0;
+    int max_tokens = 0;
+    int n_generated = 0;
+    llama_pos n_cur = 0;
+    int32_t i_batch = -1;  // index of this slot's logits in the current batch
+
+    // Image spans of the prompt in order, and the next one to decode. The
+    // chunk list owns the mtmd chunks the spans point to.
+    std::vector<PromptImage> images;
+    std::shared_ptr<mtmd_input_chunks> image_chunks;
+    size_t next_image = 0;
+
+    // Prompt lookup: tokens proposed this step, verified from i_lookup on
+    bool prompt_lookup = false;
+    std::vector<llama_token> lookup_draft;
+    int32_t i_lookup = -1;
+
+    // Parallel sampling: branches hold a sequence but wait here until this
+    // slot's prompt is decoded, then fork its cache (scheduler thread only)
+    std::vector<std::shared_ptr<GenerationSlot>> branches;
+    bool want_logprob = false;
+    double logprob = 0.0;  // sum over sampled tokens
+
+    llama_sampler* sampler = nullptr;
+    LoraSelection lora;
+    llama_token next_token = LLAMA_TOKEN_NULL;
+    Utf8StreamDecoder utf8;
+    std::unique_ptr<StopSequenceMatcher> stop_matcher;
+    std::vector<std::string> request_stops;  // request part of the matcher's stop list
+
+    // Token healing: text of the prompt token that was removed, and the tokens
+    // the first sample is restricted to (their text starts with heal_text)
+    std::string heal_text;
+    std::vector<llama_token> heal_candidates;
+
+    // Time budgets (0 = none); first_token_at is set with the first sample
+    std::chrono::steady_clock::time_point submitted;
+    std::chrono::steady_clock::time_point first_token_at;
+    int max_prefill_ms = 0;
+    int max_total_ms = 0;
+    float min_tokens_per_second = 0.0f;
+    const char* deadline_hit = nullptr;  // finish_reason once a budget ended it
+
+    // Guarded by scheduler_mutex_
+    std::string pending_text;
+    bool stop_requested = false;
+    bool finished = false;
+    bool failed = false;
+    // Held by the scheduler (pending, active or an unforked branch). A slot
+    // released while queued is recycled once the scheduler drops it.
+    bool queued = false;
+    bool released = false;
+    std::condition_variable cv;
+};
+
+// finish_reason of a finished slot (see TextGenerationResult)
+static const char* finish_reason_of(const GenerationSlot& slot) {
+    if (slot.stop_requested) {
+        return "cancelled";
+    }
+    if (slot.failed) {
+        return "error";
+    }
+    if (slot.deadline_hit) {
+        return slot.deadline_hit;
+    }
+    return slot.n_generated >= slot.max_tokens ? "length" : "stop";
+}
+
+bool LlamaCppTextGeneration::generate_stream(const TextGenerationRequest& request,
+                                             TextStreamCallback callback,
+                                             int* out_prompt_tokens, bool* out_cancelled,
+                                             std::string* out_finish_reason) {
+    std::shared_ptr<GenerationSlot> slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!is_ready()) {
+            LOGE("Model not ready for generation");
+            return false;
         }
 
-        batch.n_tokens = 0;
-        common_batch_add(batch, new_token_id, n_cur, {0}, true);
+        {
+            std::lock_guard<std::mutex> scheduler_lock(scheduler_mutex_);
+            slot = acquire_slot_locked();
+        }
 
-        n_cur++;
-        tokens_generated++;
+        if (!prepare_slot(request, *slot, out_prompt_tokens)) {
+            std::lock_guard<std::mutex> scheduler_lock(scheduler_mutex_);
+            release_slot_locked(slot);
+            return false;
+        }
 
-        if (llama_decode(context_, batch) != 0) {
-            LOGE("llama_decode failed during generation");
+        std::lock_guard<std::mutex> scheduler_lock(scheduler_mutex_);
+        slot->queued = true;
+        pending_slots_.push_back(slot);
+    }
+    scheduler_cv_.notify_one();
+
+    bool cancelled = false;
+    std::unique_lock<std::mutex> lock(scheduler_mutex_);
+    while (true) {
+        slot->cv.wait(lock, [&] { return slot->finished || !slot->pending_text.empty(); });
+        std::string text;
+        text.swap(slot->pending_text);
+        const bool finished = slot->finished;
+
+        if (!text.empty()) {
+            lock.unlock();
+            const bool keep_going = callback(text);
+            lock.lock();
+            if (!keep_going && !slot->stop_requested) {
+                LOGI("Generation cancelled by callback");
+                slot->stop_requested = true;
+            }
+        }
+        if (finished && slot->pending_text.empty()) {
             break;
         }
     }
-
-    if (!cached_token_chars.empty() && is_valid_utf8(cached_token_chars.c_str())) {
-        callback(cached_token_chars);
+    cancelled = slot->stop_requested;
+    const bool failed = slot->failed;
+    const int n_generated = slot->n_generated;
+    const char* finish_reason = finish_reason_of(*slot);
+    release_slot_locked(slot);
+    lock.unlock();
+
+    if (out_cancelled) {
+        *out_cancelled = cancelled;
     }
+    if (out_finish_reason) {
+        *out_finish_reason = finish_reason;
+    }
+    LOGI("Generation complete: %d tokens", n_generated);
+    return !cancelled && !failed;
+}
 
-    llama_memory_clear(llama_get_memory(context_), true);
+// The prompt is decoded once on the first slot; the other n - 1 sequences copy
+// its cache and sample their first token from the same logits, then all n
+// decode side by side in the step batch.
+bool LlamaCppTextGeneration::generate_samples(const TextGenerationRequest& request, int n_samples,
+                                              std::vector<TextGenerationResult>& out_results) {
+    out_results.clear();
+    const auto start_time = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<GenerationSlot>> slots;
+    int prompt_tokens = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
 
-    llama_batch_free(batch);
+        if (!is_ready()) {
+            LOGE("Model not ready for generation");
+            return false;
+        }
 
-    LOGI("Generation complete: %d tokens", tokens_generated);
-    return !cancel_requested_.load();
-}
+        const int n = std::max(1, std::min(n_samples, n_parallel_));
+        if (n < n_samples) {
+            LOGI("Capping n_samples: %d → %d (parallel sequences)", n_samples, n);
+        }
+        const float temperature =
+            request.temperature >= 0.0f ? request.temperature : default_sampling_.temperature;
+        if (n > 1 && temperature <= 0.0f) {
+            LOGI("Greedy sampling: all %d samples will be the same", n);
+        }
 
-void LlamaCppTextGeneration::cancel() {
-    cancel_requested_.store(true);
+        std::shared_ptr<GenerationSlot> primary;
+        {
+            std::lock_guard<std::mutex> scheduler_lock(scheduler_mutex_);
+            primary = acquire_slot_locked();
+        }
+        if (!prepare_slot(request, *primary, &prompt_tokens)) {
+            std::lock_guard<std::mutex> scheduler_lock(scheduler_mutex_);
+            release_slot_locked(primary);
+            return false;
+        }
+
+        // The shared prompt plus every branch's reply must fit in the context
+        const int n_ctx = static_cast<int>(llama_n_ctx(context_));
+        const int per_branch = (n_ctx - static_cast<int>(primary->prompt.size()) - 4) / n;
+        if (per_branch < primary->max_tokens) {
+            LOGI("Capping max_tokens: %d → %d (%d samples)", primary->max_tokens, per_branch, n);
+            primary->max_tokens = per_branch;
+        }
+        if (primary->max_tokens <= 0) {
+            LOGE("Prompt too long for %d samples: %zu tokens, context size: %d", n,
+                 primary->prompt.size(), n_ctx);
+            std::lock_guard<std::mutex> scheduler_lock(scheduler_mutex_);
+            release_slot_locked(primary);
+            return false;
+        }
+        primary->want_logprob = true;
+
+        std::lock_guard<std::mutex> scheduler_lock(scheduler_mutex_);
+        primary->queued = true;
+        pending_slots_.push_back(primary);
+        slots.push_back(primary);
+        const bool can_fork = !llama_model_is_recurrent(model_);
+        for (int i = 1; i < n; i++) {
+            auto branch = acquire_slot_locked();
+            branch->prompt = primary->prompt;
+            branch->images = primary->images;
+            branch->image_chunks = primary->image_chunks;
+            branch->max_tokens = primary->max_tokens;
+            branch->lora = primary->lora;
+            branch->prompt_lookup = primary->prompt_lookup;
+            branch->want_logprob = true;
+            branch->heal_text = primary->heal_text;
+            branch->heal_candidates = primary->heal_candidates;
+            branch->submitted = primary->submitted;
+            branch->max_prefill_ms = primary->max_prefill_ms;
+            branch->max_total_ms = primary->max_total_ms;
+            branch->min_tokens_per_second = primary->min_tokens_per_second;
+            // Reset reseeds the clone, so every branch draws its own samples
+            branch->sampler = llama_sampler_clone(primary->sampler);
+            llama_sampler_reset(branch->sampler);
+            reset_stop_matcher(*branch, request.stop_sequences);
+            branch->queued = true;
+            if (can_fork) {
+                primary->branches.push_back(branch);
+            } else {
+                // Recurrent state cannot be copied mid-sequence; prefill each
+                pending_slots_.push_back(branch);
+            }
+            slots.push_back(branch);
+        }
+        LOGI("Parallel sampling: %d samples of %d tokens", n, primary->max_tokens);
+    }
+    scheduler_cv_.notify_one();
+
+    bool success = true;
+    std::unique_lock<std::mutex> lock(scheduler_mutex_);
+    for (auto& slot : slots) {
+        slot->cv.wait(lock, [&] { return slot->finished; });
+        TextGenerationResult result;
+        result.text.swap(slot->pending_text);
+        result.tokens_generated = slot->n_generated;
+        result.prompt_tokens = prompt_tokens;
+        result.logprob = slot->logprob;
+        result.finish_reason = finish_reason_of(*slot);
+        success = success && !slot->stop_requested && !slot->failed;
+        release_slot_locked(slot);
+        out_results.push_back(std::move(result));
+    }
+    lock.unlock();
+
+    const double elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  std::chrono::steady_clock::now() - start_time)
+                                  .count();
+    for (auto& result : out_results) {
+        result.inference_time_ms = elapsed_ms;
+    }
+    LOGI("Parallel sampling complete: %zu samples in %.0f ms", out_results.size(), elapsed_ms);
+    return success;
+}
+
+// Tokenizes the request into the slot and sets up its sampler, adapter and
+// stop matcher. Caller must hold mutex_ and releases the slot on failure.
+bool LlamaCppTextGeneration::prepare_slot(const TextGenerationRequest& request,
+                                          GenerationSlot& slot, int* out_prompt_tokens) {
+    const bool with_images = !request.images.empty();
+    const std::string& prompt = with_images ? build_vision_prompt(request) : build_prompt(request);
+    LOGI("Generating with prompt length: %zu", prompt.length());
+
+    if (with_images) {
+        // Encodes images missing from the cache; running requests keep decoding
+        if (!tokenize_with_images(prompt, request.images, slot.prompt, slot.images,
+                                  slot.image_chunks)) {
+            return false;
+        }
+    } else if (!tokenize_into(prompt, slot.prompt)) {
+        LOGE("Failed to tokenize prompt");
+        return false;
+    }
+
+    int n_ctx = llama_n_ctx(context_);
+    int prompt_tokens = static_cast<int>(slot.prompt.size());
+
+    if (out_prompt_tokens) {
+        *out_prompt_tokens = prompt_tokens;
+    }
+
+    int available_tokens = n_ctx - prompt_tokens - 4;
+
+    if (available_tokens <= 0) {
+        LOGE("Prompt too long: %d tokens, context size: %d", prompt_tokens, n_ctx);
+        return false;
+    }
+
+    if (!resolve_lora(request, &slot.lora)) {
+        LOGE("LoRA adapter '%s' is not loaded",
+             (request.use_default_lora ? default_lora_ : request.lora_adapter).c_str());
+        return false;
+    }
+
+    // Healing drops the last token, which must leave text after the last image
+    if (request.token_healing &&
+        (slot.images.empty() ||
+         slot.prompt.size() > slot.images.back().start + slot.images.back().n_tokens + 1)) {
+        prepare_token_healing(slot);
+    }
+    // Rejected proposals are rolled back, which recurrent state cannot do;
+    // image placeholders have no text to propose from
+    slot.prompt_lookup =
+        request.prompt_lookup && !llama_model_is_recurrent(model_) && slot.images.empty();
+
+    slot.max_tokens = std::min(request.max_tokens, available_tokens);
+    if (slot.max_tokens < request.max_tokens) {
+        LOGI("Capping max_tokens: %d → %d (context=%d, prompt=%d tokens)", request.max_tokens,
+             slot.max_tokens, n_ctx, prompt_tokens);
+    }
+    LOGI("Generation: prompt_tokens=%d, max_tokens=%d, context=%d", prompt_tokens,
+         slot.max_tokens, n_ctx);
+
+    SamplerParams sampling = default_sampling_;
+    if (request.temperature >= 0.0f) {
+        sampling.temperature = request.temperature;
+    }
+    if (request.top_p >= 0.0f) {
+        sampling.top_p = request.top_p;
+    }
+    if (request.top_k >= 0) {
+        sampling.top_k = request.top_k;
+    }
+    if (request.repetition_penalty >= 0.0f) {
+        sampling.repetition_penalty = request.repetition_penalty;
+    }
+    slot.sampler = llama_sampler_clone(sampler_for(sampling));
+
+    // The grammar masks invalid tokens before the chain samples
+    if (!request.json_schema.empty()) {
+        llama_sampler* grammar = grammar_for(request.json_schema);
+        if (!grammar) {
+            return false;
+        }
+        llama_sampler* constrained =
+            llama_sampler_chain_init(llama_sampler_chain_default_params());
+        llama_sampler_chain_add(constrained, llama_sampler_clone(grammar));
+        llama_sampler_chain_add(constrained, slot.sampler);
+        slot.sampler = constrained;
+    }
+
+    reset_stop_matcher(slot, request.stop_sequences);
+    llama_sampler_reset(slot.sampler);
+
+    slot.submitted = std::chrono::steady_clock::now();
+    slot.max_prefill_ms = std::max(request.max_prefill_ms, 0);
+    slot.max_total_ms = std::max(request.max_total_ms, 0);
+    slot.min_tokens_per_second = std::max(request.min_tokens_per_second, 0.0f);
+    return true;
+}
+
+// Rebuilds the stop automaton only when the request's stop list changed
+void LlamaCppTextGeneration::reset_stop_matcher(GenerationSlot& slot,
+                                                const std::vector<std::string>& request_stops) {
+    if (slot.stop_matcher && slot.request_stops == request_stops) {
+        slot.stop_matcher->reset();
+        return;
+    }
+    std::vector<std::string> stop_sequences = stop_sequences_;
+    stop_sequences.insert(stop_sequences.end(), request_stops.begin(), request_stops.end());
+    slot.stop_matcher = std::make_unique<StopSequenceMatcher>(stop_sequences);
+    slot.request_stops = request_stops;
+}
+
+std::shared_ptr<GenerationSlot> LlamaCppTextGeneration::acquire_slot_locked() {
+    if (free_slots_.empty()) {
+        return std::make_shared<GenerationSlot>();
+    }
+    std::shared_ptr<GenerationSlot> slot = std::move(free_slots_.back());
+    free_slots_.pop_back();
+    return slot;
+}
+
+// Hands the slot back once the caller is done with it. A finished slot stays in
+// active_slots_ until the next step erases it, so recycling it here could admit
+// it twice; the scheduler recycles it when it drops the slot instead.
+void LlamaCppTextGeneration::release_slot_locked(const std::shared_ptr<GenerationSlot>& slot) {
+    if (slot->queued) {
+        slot->released = true;
+        return;
+    }
+    recycle_slot_locked(slot);
+}
+
+// The scheduler no longer references the slot
+void LlamaCppTextGeneration::drop_slot_locked(const std::shared_ptr<GenerationSlot>& slot) {
+    slot->queued = false;
+    if (slot->released) {
+        recycle_slot_locked(slot);
+    }
+}
+
+// Resets per-request state but keeps the buffers' capacity
+void LlamaCppTextGeneration::recycle_slot_locked(const std::shared_ptr<GenerationSlot>& slot) {
+    if (slot->sampler) {
+        llama_sampler_free(slot->sampler);
+        slot->sampler = nullptr;
+    }
+    slot->seq_id = -1;
+    slot->prompt.clear();
+    slot->images.clear();
+    slot->image_chunks.reset();
+    slot->next_image = 0;
+    slot->n_prompt_decoded = 0;
+    slot->max_tokens = 0;
+    slot->n_generated = 0;
+    slot->n_cur = 0;
+    slot->i_batch = -1;
+    slot->prompt_lookup = false;
+    slot->lookup_draft.clear();
+    slot->i_lookup = -1;
+    slot->branches.clear();
+    slot->want_logprob = false;
+    slot->logprob = 0.0;
+    slot->next_token = LLAMA_TOKEN_NULL;
+    slot->utf8.reset();
+    slot->heal_text.clear();
+    slot->heal_candidates.clear();
+    slot->max_prefill_ms = 0;
+    slot->max_total_ms = 0;
+    slot->min_tokens_per_second = 0.0f;
+    slot->deadline_hit = nullptr;
+    slot->pending_text.clear();
+    slot->stop_requested = false;
+    slot->finished = false;
+    slot->failed = false;
+    slot->queued = false;
+    slot->released = false;
+
+    if (free_slots_.size() < static_cast<size_t>(kMaxParallelSequences)) {
+        free_slots_.push_back(slot);
+    }
+}
+
+void LlamaCppTextGeneration::start_scheduler() {
+    n_parallel_ = static_cast<int>(llama_n_seq_max(context_));
+    batch_ = llama_batch_init(static_cast<int32_t>(llama_n_batch(context_)), 0, 1);
+    scheduler_stop_ = false;
+    applied_threads_ = 0;
+    prefill_ms_per_token_ = 0.0;
+    apply_lora_locked(LoraSelection());
+    scheduler_thread_ = std::thread(&LlamaCppTextGeneration::scheduler_loop, this);
+}
+
+void LlamaCppTextGeneration::stop_scheduler() {
+    if (!scheduler_thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        scheduler_stop_ = true;
+    }
+    scheduler_cv_.notify_one();
+    scheduler_thread_.join();
+
+    llama_batch_free(batch_);
+    batch_ = {};
+    for (auto& tokens : seq_tokens_) {
+        tokens.clear();
+    }
+    for (auto& lora : seq_lora_) {
+        lora = LoraSelection();
+    }
+    last_seq_ = -1;
+    // Pooled stop matchers were built from this model's stop list
+    free_slots_.clear();
+}
+
+void LlamaCppTextGeneration::scheduler_loop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(scheduler_mutex_);
+            if (pending_slots_.empty() && active_slots_.empty()) {
+                follow_cpu_budget(false);
+            }
+            scheduler_cv_.wait(lock, [&] {
+                return scheduler_stop_ || !pending_slots_.empty() || !active_slots_.empty();
+            });
+            if (scheduler_stop_) {
+                break;
+            }
+            admit_pending_locked();
+        }
+        follow_cpu_budget(true);
+        if (!decode_step()) {
+            // Nothing could be scheduled (e.g. all slots waiting on KV room)
+            std::unique_lock<std::mutex> lock(scheduler_mutex_);
+            scheduler_cv_.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(scheduler_mutex_);
+    for (auto& slot : active_slots_) {
+        finish_slot_locked(*slot, true);
+    }
+    for (auto& slot : pending_slots_) {
+        finish_slot_locked(*slot, true);
+    }
+    for (auto& slot : active_slots_) {
+        drop_slot_locked(slot);
+    }
+    for (auto& slot : pending_slots_) {
+        drop_slot_locked(slot);
+    }
+    active_slots_.clear();
+    pending_slots_.clear();
+    follow_cpu_budget(false);
+}
+
+// Decode threads follow the CPU budget, which shrinks the LLM share while TTS
+// or STT run; the change takes effect from the next step.
+void LlamaCppTextGeneration::follow_cpu_budget(bool busy) {
+    if (!busy) {
+        if (cpu_budget_held_) {
+            rac_cpu_budget_release(RAC_CPU_STAGE_LLM);
+            cpu_budget_held_ = false;
+        }
+        return;
+    }
+    if (!cpu_budget_held_) {
+        rac_cpu_budget_acquire(RAC_CPU_STAGE_LLM, backend_->get_num_threads());
+        cpu_budget_held_ = true;
+    }
+
+    const int threads = rac_cpu_budget_threads(RAC_CPU_STAGE_LLM);
+    if (threads <= 0 || threads == applied_threads_) {
+        return;
+    }
+    llama_set_n_threads(context_, threads, threads);
+    if (draft_context_) {
+        llama_set_n_threads(draft_context_, threads, threads);
+    }
+    rac_cpu_budget_bind_current_thread(RAC_CPU_STAGE_LLM);
+    applied_threads_ = threads;
+}
+
+// Picks the free sequence sharing the longest prefix with each pending prompt.
+// Requests wait while their worst-case KV footprint doesn't fit next to the
+// active ones.
+void LlamaCppTextGeneration::admit_pending_locked() {
+    const size_t n_ctx = llama_n_ctx(context_);
+    size_t reserved = 0;
+    for (const auto& slot : active_slots_) {
+        reserved += slot->prompt.size() + slot->max_tokens * (1 + slot->branches.size());
+    }
+
+    while (!pending_slots_.empty()) {
+        auto slot = pending_slots_.front();
+        if (slot->stop_requested) {
+            pending_slots_.pop_front();
+            finish_slot_locked(*slot, false);
+            drop_slot_locked(slot);
+            continue;
+        }
+        // The adapter applies to the whole context, so requests with another
+        // one wait for the running requests instead of joining their batch
+        if (slot->lora != applied_lora_) {
+            for (const auto& active : active_slots_) {
+                if (!active->finished) {
+                    return;
+                }
+            }
+            apply_lora_locked(slot->lora);
+            if (slot->lora != applied_lora_) {
+                pending_slots_.pop_front();
+                finish_slot_locked(*slot, true);
+                drop_slot_locked(slot);
+                continue;
+            }
+        }
+        const size_t n_branches = slot->branches.size();
+        const size_t needed = slot->prompt.size() + slot->max_tokens * (1 + n_branches);
+        if (!active_slots_.empty() && reserved + needed > n_ctx) {
+            return;
+        }
+
+        llama_seq_id best = -1;
+        size_t best_prefix = 0;
+        for (llama_seq_id seq = 0; seq < n_parallel_; seq++) {
+            if (seq_busy_[seq]) {
+                continue;
+            }
+            const auto& cached = seq_tokens_[seq];
+            size_t prefix = 0;
+            while (seq_lora_[seq] == slot->lora && prefix < cached.size() &&
+                   prefix < slot->prompt.size() && cached[prefix] == slot->prompt[prefix]) {
+                prefix++;
+            }
+            if (best < 0 || prefix > best_prefix ||
+                (prefix == best_prefix && cached.size() < seq_tokens_[best].size())) {
+                best = seq;
+                best_prefix = prefix;
+            }
+        }
+        if (best < 0) {
+            return;
+        }
+
+        // Branches take the free sequences with the least cache to lose
+        bool taken[kMaxParallelSequences] = {};
+        llama_seq_id branch_seqs[kMaxParallelSequences] = {};
+        taken[best] = true;
+        for (size_t i = 0; i < n_branches; i++) {
+            llama_seq_id pick = -1;
+            for (llama_seq_id seq = 0; seq < n_parallel_; seq++) {
+                if (!seq_busy_[seq] && !taken[seq] &&
+                    (pick < 0 || seq_tokens_[seq].size() < seq_tokens_[pick].size())) {
+                    pick = seq;
+                }
+            }
+            if (pick < 0) {
+                return;
+            }
+            taken[pick] = true;
+            branch_seqs[i] = pick;
+        }
+
+        // Idle caches share the KV cells with active requests; drop them if needed
+        size_t idle = 0;
+        for (llama_seq_id seq = 0; seq < n_parallel_; seq++) {
+            if (!seq_busy_[seq] && !taken[seq]) {
+                idle += seq_tokens_[seq].size();
+            }
+        }
+        if (reserved + needed + idle > n_ctx) {
+            for (llama_seq_id seq = 0; seq < n_parallel_; seq++) {
+                if (!seq_busy_[seq] && !taken[seq]) {
+                    clear_sequence(seq);
+                }
+            }
+        }
+
+        pending_slots_.pop_front();
+        slot->seq_id = best;
+        if (seq_lora_[best] != slot->lora) {
+            clear_sequence(best);
+            seq_lora_[best] = slot->lora;
+        }
+        slot->n_prompt_decoded = reuse_cached_prefix(best, slot->prompt);
+        resume_before_image(*slot);
+        slot->n_cur = static_cast<llama_pos>(slot->prompt.size());
+        seq_busy_[best] = true;
+        if (slot->max_prefill_ms > 0 && prefill_ms_per_token_ > 0.0) {
+            const auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    std::chrono::steady_clock::now() - slot->submitted)
+                                    .count();
+            const double projected =
+                static_cast<double>(waited) +
+                static_cast<double>(slot->prompt.size() - slot->n_prompt_decoded) *
+                    prefill_ms_per_token_;
+            if (projected > slot->max_prefill_ms) {
+                LOGI("Prefill projected at %.0f ms, budget %d ms: not starting", projected,
+                     slot->max_prefill_ms);
+                finish_at_deadline_locked(*slot, "prefill_deadline");
+                continue;
+            }
+        }
+        for (size_t i = 0; i < n_branches; i++) {
+            auto& branch = slot->branches[i];
+            branch->seq_id = branch_seqs[i];
+            clear_sequence(branch->seq_id);
+            seq_lora_[branch->seq_id] = slot->lora;
+            seq_busy_[branch->seq_id] = true;
+            branch->n_prompt_decoded = branch->prompt.size();
+            branch->n_cur = slot->n_cur;
+        }
+        reserved += needed;
+        active_slots_.push_back(slot);
+        LOGI("Request admitted on sequence %d (%zu active, %zu branches)", best,
+             active_slots_.size(), n_branches);
+    }
+}
+
+// Runs one llama_decode over all active slots. Returns false if nothing was decoded.
+// The thermal governor caps the batch and paces generation steps while the
+// device is hot; threads follow it through the CPU budget.
+bool LlamaCppTextGeneration::decode_step() {
+    rac_thermal_policy_t thermal = {};
+    rac_thermal_governor_get_policy(&thermal);
+    int32_t n_batch = static_cast<int32_t>(llama_n_batch(context_));
+    if (thermal.max_batch_tokens > 0) {
+        n_batch = std::min(n_batch, thermal.max_batch_tokens);
+    }
+    std::vector<std::shared_ptr<GenerationSlot>> slots;
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        const auto now = std::chrono::steady_clock::now();
+        for (auto& slot : active_slots_) {
+            if (slot->stop_requested) {
+                finish_slot_locked(*slot, false);
+            } else {
+                check_deadlines_locked(*slot, now);
+            }
+        }
+        auto done = std::stable_partition(active_slots_.begin(), active_slots_.end(),
+                                          [](const auto& slot) { return !slot->finished; });
+        for (auto it = done; it != active_slots_.end(); ++it) {
+            drop_slot_locked(*it);
+        }
+        active_slots_.erase(done, active_slots_.end());
+        slots = active_slots_;
+    }
+
+    // A lone generating request is latency-bound: let the draft model propose tokens
+    if (draft_context_ && slots.size() == 1 && slots[0]->next_token != LLAMA_TOKEN_NULL &&
+        !slots[0]->prompt_lookup && slots[0]->images.empty() && speculative_step(*slots[0])) {
+        return true;
+    }
+
+    // Images go through their embeddings in their own decodes once a slot's
+    // prompt reaches them; the step's batch then continues after them
+    bool image_failed = false;
+    for (auto& slot : slots) {
+        while (slot->next_image < slot->images.size() &&
+               slot->n_prompt_decoded == slot->images[slot->next_image].start) {
+            const PromptImage& image = slot->images[slot->next_image];
+            if (!decode_image(image, slot->seq_id)) {
+                std::lock_guard<std::mutex> lock(scheduler_mutex_);
+                finish_slot_locked(*slot, true);
+                image_failed = true;
+                break;
+            }
+            const auto first = slot->prompt.begin() + static_cast<std::ptrdiff_t>(image.start);
+            seq_tokens_[slot->seq_id].insert(seq_tokens_[slot->seq_id].end(), first,
+                                             first + static_cast<std::ptrdiff_t>(image.n_tokens));
+            slot->n_prompt_decoded += image.n_tokens;
+            slot->next_image++;
+        }
+    }
+    if (image_failed) {
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        slots.erase(std::remove_if(slots.begin(), slots.end(),
+                                   [](const auto& slot) { return slot->finished; }),
+                    slots.end());
+    }
+
+    // Pending sampled tokens go first so generation never starves behind a long prefill
+    batch_.n_tokens = 0;
+    int32_t n_prompt_tokens = 0;
+    for (auto& slot : slots) {
+        slot->i_batch = -1;
+        slot->lookup_draft.clear();
+        if (slot->next_token != LLAMA_TOKEN_NULL && batch_.n_tokens < n_batch) {
+            common_batch_add(batch_, slot->next_token, slot->n_cur, {slot->seq_id}, true);
+            slot->i_batch = batch_.n_tokens - 1;
+        }
+    }
+    // Prompt lookup proposals ride along and are verified from the same logits
+    for (auto& slot : slots) {
+        if (!slot->prompt_lookup || slot->i_batch < 0) {
+            continue;
+        }
+        propose_lookup_draft(*slot, n_batch - batch_.n_tokens);
+        slot->i_lookup = batch_.n_tokens;
+        for (size_t i = 0; i < slot->lookup_draft.size(); i++) {
+            common_batch_add(batch_, slot->lookup_draft[i],
+                             slot->n_cur + 1 + static_cast<llama_pos>(i), {slot->seq_id}, true);
+        }
+    }
+    for (auto& slot : slots) {
+        const size_t n_prompt = slot->prompt.size();
+        const size_t n_text = slot->next_image < slot->images.size()
+                                  ? slot->images[slot->next_image].start
+                                  : n_prompt;
+        while (slot->n_prompt_decoded < n_text && batch_.n_tokens < n_batch) {
+            const size_t i = slot->n_prompt_decoded++;
+            const bool last = i == n_prompt - 1;
+            common_batch_add(batch_, slot->prompt[i], static_cast<llama_pos>(i), {slot->seq_id}, last);
+            seq_tokens_[slot->seq_id].push_back(slot->prompt[i]);
+            n_prompt_tokens++;
+            if (last) {
+                slot->i_batch = batch_.n_tokens - 1;
+            }
+        }
+    }
+
+    if (batch_.n_tokens == 0) {
+        return false;
+    }
+
+    RAC_TRACE_COUNTER("LLM.batch_tokens", batch_.n_tokens);
+    RAC_TRACE_COUNTER("LLM.active_slots", slots.size());
+    RAC_TRACE_SCOPE(n_prompt_tokens > 0 ? "LLM.prefill" : "LLM.decode");
+    const auto step_start = std::chrono::steady_clock::now();
+    if (llama_decode(context_, batch_) != 0) {
+        LOGE("llama_decode failed for batch of %d tokens", batch_.n_tokens);
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        for (auto& slot : slots) {
+            finish_slot_locked(*slot, true);
+        }
+        return true;
+    }
+
+    for (auto& slot : slots) {
+        if (slot->next_token != LLAMA_TOKEN_NULL && slot->i_batch >= 0) {
+            seq_tokens_[slot->seq_id].push_back(slot->next_token);
+            slot->n_cur++;
+            slot->next_token = LLAMA_TOKEN_NULL;
+        }
+        if (slot->i_batch >= 0 && !slot->lookup_draft.empty()) {
+            verify_lookup_draft(*slot);
+        } else if (slot->i_batch >= 0) {
+            if (!slot->branches.empty()) {
+                fork_branches(*slot);
+            }
+            sample_slot(*slot);
+        }
+    }
+
+    if (n_prompt_tokens > 0) {
+        // Sampled tokens in the same batch cost about as much as prompt ones
+        const double step_ms = std::chrono::duration<double, std::milli>(
+                                   std::chrono::steady_clock::now() - step_start)
+                                   .count();
+        const double per_token = step_ms / batch_.n_tokens;
+        prefill_ms_per_token_ = prefill_ms_per_token_ > 0.0
+                                    ? 0.7 * prefill_ms_per_token_ + 0.3 * per_token
+                                    : per_token;
+    } else {
+        const int64_t step_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                    std::chrono::steady_clock::now() - step_start)
+                                    .count();
+        const int64_t pause_us = rac_thermal_governor_pace_decode(batch_.n_tokens, step_us);
+        if (pause_us > 0) {
+            RAC_TRACE_SCOPE("LLM.thermal_pace");
+            std::this_thread::sleep_for(std::chrono::microseconds(pause_us));
+        }
+    }
+    return true;
+}
+
+// Drops the prompt's last token and restricts the first sample to tokens that
+// start with its text, so e.g. a prompt ending in "http" can continue as
+// "https" in one token. Control tokens (chat template markers) are left alone.
+void LlamaCppTextGeneration::prepare_token_healing(GenerationSlot& slot) {
+    if (slot.prompt.size() < 2) {
+        return;
+    }
+    const llama_token last = slot.prompt.back();
+    const std::string text = common_token_to_piece(context_, last, false);
+    if (text.empty()) {
+        return;
+    }
+
+    if (vocab_pieces_.empty()) {
+        const int32_t n_vocab = llama_vocab_n_tokens(llama_model_get_vocab(model_));
+        vocab_pieces_.reserve(static_cast<size_t>(n_vocab));
+        for (llama_token id = 0; id < n_vocab; id++) {
+            vocab_pieces_.push_back(common_token_to_piece(context_, id, false));
+        }
+    }
+
+    slot.heal_candidates.clear();
+    for (size_t id = 0; id < vocab_pieces_.size(); id++) {
+        const std::string& piece = vocab_pieces_[id];
+        if (piece.size() >= text.size() && piece.compare(0, text.size(), text) == 0) {
+            slot.heal_candidates.push_back(static_cast<llama_token>(id));
+        }
+    }
+    slot.heal_text = text;
+    slot.prompt.pop_back();
+    LOGI("Token healing: regenerating \"%s\" (%zu candidates)", text.c_str(),
+         slot.heal_candidates.size());
+}
+
+void LlamaCppTextGeneration::sample_slot(GenerationSlot& slot) {
+    if (!slot.heal_candidates.empty()) {
+        // Mask every logit except the healing candidates for the first token
+        float* logits = llama_get_logits_ith(context_, slot.i_batch);
+        const int32_t n_vocab = llama_vocab_n_tokens(llama_model_get_vocab(model_));
+        std::vector<float> kept(slot.heal_candidates.size());
+        for (size_t i = 0; i < kept.size(); i++) {
+            kept[i] = logits[slot.heal_candidates[i]];
+        }
+        std::fill(logits, logits + n_vocab, -INFINITY);
+        for (size_t i = 0; i < kept.size(); i++) {
+            logits[slot.heal_candidates[i]] = kept[i];
+        }
+        slot.heal_candidates.clear();
+    }
+
+    const llama_token new_token_id = llama_sampler_sample(slot.sampler, context_, slot.i_batch);
+    llama_sampler_accept(slot.sampler, new_token_id);
+    if (slot.want_logprob) {
+        slot.logprob += token_logprob(slot.i_batch, new_token_id);
+    }
+    accept_token(slot, new_token_id);
+}
+
+// Log-probability of a token under the model's distribution at a logits row,
+// before sampler adjustments, so candidates can be compared
+double LlamaCppTextGeneration::token_logprob(int32_t i_logits, llama_token token) const {
+    const float* logits = llama_get_logits_ith(context_, i_logits);
+    const int32_t n_vocab = llama_vocab_n_tokens(llama_model_get_vocab(model_));
+    const float max_logit = *std::max_element(logits, logits + n_vocab);
+    double sum = 0.0;
+    for (int32_t i = 0; i < n_vocab; i++) {
+        sum += std::exp(static_cast<double>(logits[i] - max_logit));
+    }
+    return static_cast<double>(logits[token] - max_logit) - std::log(sum);
+}
+
+// Hands the decoded prompt to every branch: with the unified KV cache the copy
+// only shares cells. Each branch then samples its first token from the prompt's
+// logits with its own sampler. Runs before the slot samples, which may finish it.
+void LlamaCppTextGeneration::fork_branches(GenerationSlot& slot) {
+    std::vector<std::shared_ptr<GenerationSlot>> forked;
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        for (auto& branch : slot.branches) {
+            if (branch->stop_requested) {
+                finish_slot_locked(*branch, false);
+                drop_slot_locked(branch);
+                continue;
+            }
+            active_slots_.push_back(branch);
+            forked.push_back(branch);
+        }
+        slot.branches.clear();
+    }
+    for (auto& branch : forked) {
+        llama_memory_seq_cp(llama_get_memory(context_), slot.seq_id, branch->seq_id, -1, -1);
+        seq_tokens_[branch->seq_id] = seq_tokens_[slot.seq_id];
+        branch->i_batch = slot.i_batch;
+        sample_slot(*branch);
+    }
+}
+
+// Emits a sampled token. Returns false once the slot has finished.
+bool LlamaCppTextGeneration::accept_token(GenerationSlot& slot, llama_token new_token_id) {
+    const auto vocab = llama_model_get_vocab(model_);
+    bool done = false;
+    bool flush = false;
+    if (llama_vocab_is_eog(vocab, new_token_id)) {
+        LOGI("End of generation token received");
+        done = true;
+        flush = true;
+    }
+
+    std::string text;
+    if (!done) {
+        std::string piece = common_token_to_piece(context_, new_token_id);
+        if (!slot.heal_text.empty()) {
+            // The healed prefix is already part of the prompt
+            piece.erase(0, std::min(piece.size(), slot.heal_text.size()));
+            slot.heal_text.clear();
+        }
+        slot.utf8.feed(slot.stop_matcher->feed(piece), text);
+        if (slot.stop_matcher->stopped()) {
+            LOGI("Stop sequence detected");
+            done = true;
+        }
+    }
+
+    if (!done) {
+        if (slot.n_generated == 0) {
+            slot.first_token_at = std::chrono::steady_clock::now();
+        }
+        slot.next_token = new_token_id;
+        slot.n_generated++;
+        done = flush = slot.n_generated >= slot.max_tokens;
+    }
+    if (flush) {
+        slot.utf8.feed(slot.stop_matcher->flush(), text);
+    }
+    if (done) {
+        slot.utf8.flush(text);
+    }
+
+    std::lock_guard<std::mutex> lock(scheduler_mutex_);
+    slot.pending_text += text;
+    if (done) {
+        finish_slot_locked(slot, false);
+    } else if (!text.empty()) {
+        slot.cv.notify_one();
+    }
+    return !done;
+}
+
+// Releases the slot's sequence (its cache stays for prefix reuse) and wakes the caller.
+void LlamaCppTextGeneration::finish_slot_locked(GenerationSlot& slot, bool failed) {
+    if (slot.finished) {
+        return;
+    }
+    if (slot.seq_id >= 0) {
+        if (failed) {
+            clear_sequence(slot.seq_id);
+        } else if (!seq_tokens_[slot.seq_id].empty()) {
+            last_seq_ = slot.seq_id;
+        }
+        seq_busy_[slot.seq_id] = false;
+    }
+    // Branches that never forked end with their slot
+    for (auto& branch : slot.branches) {
+        branch->stop_requested = branch->stop_requested || slot.stop_requested;
+        if (!branch->deadline_hit) {
+            branch->deadline_hit = slot.deadline_hit;
+        }
+        finish_slot_locked(*branch, failed);
+        drop_slot_locked(branch);
+    }
+    slot.branches.clear();
+    if (slot.sampler) {
+        llama_sampler_free(slot.sampler);
+        slot.sampler = nullptr;
+    }
+    slot.failed = failed;
+    slot.finished = true;
+    slot.cv.notify_one();
+}
+
+// Ends the slot if one of its time budgets has run out. The prefill budget
+// covers the wait for admission too, up to the first sampled token.
+bool LlamaCppTextGeneration::check_deadlines_locked(GenerationSlot& slot,
+                                                   std::chrono::steady_clock::time_point now) {
+    if (slot.finished) {
+        return false;
+    }
+    const double elapsed_ms =
+        std::chrono::duration<double, std::milli>(now - slot.submitted).count();
+    const char* reason = nullptr;
+    if (slot.max_total_ms > 0 && elapsed_ms > slot.max_total_ms) {
+        reason = "deadline";
+    } else if (slot.max_prefill_ms > 0 && slot.n_generated == 0 &&
+               elapsed_ms > slot.max_prefill_ms) {
+        reason = "prefill_deadline";
+    } else if (slot.min_tokens_per_second > 0.0f && slot.n_generated >= kMinRateTokens) {
+        const double decode_s =
+            std::chrono::duration<double>(now - slot.first_token_at).count();
+        if (decode_s > 0.0 && slot.n_generated / decode_s < slot.min_tokens_per_second) {
+            reason = "too_slow";
+        }
+    }
+    if (reason == nullptr) {
+        return false;
+    }
+    finish_at_deadline_locked(slot, reason);
+    return true;
+}
+
+// Unlike a cancel, the text held back for stop sequences and partial UTF-8
+// is still delivered: the reply is cut short, not thrown away.
+void LlamaCppTextGeneration::finish_at_deadline_locked(GenerationSlot& slot, const char* reason) {
+    LOGI("Request stopped by its budget (%s) after %d tokens", reason, slot.n_generated);
+    std::string text;
+    if (slot.stop_matcher) {
+        slot.utf8.feed(slot.stop_matcher->flush(), text);
+    }
+    slot.utf8.flush(text);
+    slot.pending_text += text;
+    slot.deadline_hit = reason;
+    finish_slot_locked(slot, false);
+}
+
+// =============================================================================
+// SPECULATIVE DECODING
+// =============================================================================
+
+bool LlamaCppTextGeneration::load_draft_model(const std::string& draft_path) {
+    spec_drafted_ = 0;
+    spec_accepted_ = 0;
+    spec_target_decodes_ = 0;
+    spec_tokens_emitted_ = 0;
+
+    llama_model_params model_params = llama_model_default_params();
+    if (n_gpu_layers_ == 0) {
+        model_params.n_gpu_layers = 0;
+    }
+    draft_model_ = acquire_model(draft_path, model_params);
+    if (!draft_model_) {
+        LOGE("Failed to load draft model from: %s", draft_path.c_str());
+        return false;
+    }
+    draft_model_path_ = draft_path;
+
+    const auto* vocab = llama_model_get_vocab(model_);
+    const auto* draft_vocab = llama_model_get_vocab(draft_model_);
+    if (llama_vocab_n_tokens(vocab) != llama_vocab_n_tokens(draft_vocab) ||
+        llama_vocab_bos(vocab) != llama_vocab_bos(draft_vocab) ||
+        llama_vocab_eos(vocab) != llama_vocab_eos(draft_vocab)) {
+        LOGE("Draft model vocabulary does not match the main model; speculative decoding disabled");
+        unload_draft_model();
+        return false;
+    }
+
+    llama_context_params ctx_params = llama_context_default_params();
+    ctx_params.n_ctx = context_size_;
+    ctx_params.n_batch = std::min(context_size_, 512);
+    ctx_params.n_seq_max = 1;
+    ctx_params.n_threads = backend_->get_num_threads();
+    ctx_params.n_threads_batch = backend_->get_num_threads();
+    ctx_params.type_k = type_k_;
+    ctx_params.type_v = type_v_;
+    ctx_params.flash_attn_type = flash_attn_type_;
+    ctx_params.no_perf = true;
+
+    draft_context_ = llama_init_from_model(draft_model_, ctx_params);
+    if (!draft_context_) {
+        LOGE("Failed to create draft context");
+        unload_draft_model();
+        return false;
+    }
+
+    auto sparams = llama_sampler_chain_default_params();
+    sparams.no_perf = true;
+    draft_sampler_ = llama_sampler_chain_init(sparams);
+    llama_sampler_chain_add(draft_sampler_, llama_sampler_init_greedy());
+    draft_batch_ = llama_batch_init(static_cast<int32_t>(llama_n_batch(draft_context_)), 0, 1);
+
+    LOGI("Draft model loaded: %s (%d tokens per step)", draft_path.c_str(), n_draft_);
+    return true;
+}
+
+void LlamaCppTextGeneration::unload_draft_model() {
+    if (draft_sampler_) {
+        llama_sampler_free(draft_sampler_);
+        draft_sampler_ = nullptr;
+    }
+    if (draft_batch_.token) {
+        llama_batch_free(draft_batch_);
+        draft_batch_ = {};
+    }
+    if (draft_context_) {
+        llama_free(draft_context_);
+        draft_context_ = nullptr;
+    }
+    if (draft_model_) {
+        release_model(draft_model_);
+        draft_model_ = nullptr;
+    }
+    draft_model_path_.clear();
+    draft_tokens_.clear();
+}
+
+// Drafts up to n_draft_ tokens greedily, then verifies the pending token plus
+// the drafts in one target decode. Target-sampled tokens are emitted while they
+// agree with the drafts; the first disagreement (or the bonus token after a
+// full match) becomes the next pending token. Returns false to fall back to a
+// regular step.
+bool LlamaCppTextGeneration::speculative_step(GenerationSlot& slot) {
+    const int32_t n_batch = static_cast<int32_t>(llama_n_batch(context_));
+    const int n_ctx = static_cast<int>(llama_n_ctx(context_));
+    const int n_room = std::min({n_draft_, slot.max_tokens - slot.n_generated - 1,
+                                 n_ctx - static_cast<int>(slot.n_cur) - 2, n_batch - 1});
+    if (n_room <= 0) {
+        return false;
+    }
+
+    // Bring the draft cache up to the target history plus the pending token
+    const std::vector<llama_token>& cached = seq_tokens_[slot.seq_id];
+    const size_t n_history = cached.size() + 1;
+    auto history_at = [&](size_t i) { return i < cached.size() ? cached[i] : slot.next_token; };
+
+    size_t n_past = 0;
+    while (n_past < draft_tokens_.size() && n_past < n_history &&
+           draft_tokens_[n_past] == history_at(n_past)) {
+        n_past++;
+    }
+    if (n_past == n_history) {
+        n_past--;
+    }
+    if (!llama_memory_seq_rm(llama_get_memory(draft_context_), 0, static_cast<llama_pos>(n_past), -1)) {
+        llama_memory_clear(llama_get_memory(draft_context_), true);
+        n_past = 0;
+    }
+    draft_tokens_.resize(n_past);
+
+    const int32_t n_draft_batch = static_cast<int32_t>(llama_n_batch(draft_context_));
+    for (size_t start = n_past; start < n_history; start += n_draft_batch) {
+        const size_t end = std::min(start + n_draft_batch, n_history);
+        draft_batch_.n_tokens = 0;
+        for (size_t i = start; i < end; i++) {
+            common_batch_add(draft_batch_, history_at(i), static_cast<llama_pos>(i), {0},
+                             i == n_history - 1);
+        }
+        if (llama_decode(draft_context_, draft_batch_) != 0) {
+            LOGE("Draft decode failed; falling back to regular decoding");
+            llama_memory_clear(llama_get_memory(draft_context_), true);
+            draft_tokens_.clear();
+            return false;
+        }
+        for (size_t i = start; i < end; i++) {
+            draft_tokens_.push_back(history_at(i));
+        }
+    }
+
+    const auto* vocab = llama_model_get_vocab(model_);
+    std::vector<llama_token>& drafted = drafted_;
+    drafted.clear();
+    int32_t i_logits = draft_batch_.n_tokens - 1;
+    for (int k = 0; k < n_room; k++) {
+        const llama_token token = llama_sampler_sample(draft_sampler_, draft_context_, i_logits);
+        if (llama_vocab_is_eog(vocab, token)) {
+            break;
+        }
+        drafted.push_back(token);
+        if (k == n_room - 1) {
+            break;
+        }
+        draft_batch_.n_tokens = 0;
+        common_batch_add(draft_batch_, token, static_cast<llama_pos>(draft_tokens_.size()), {0}, true);
+        if (llama_decode(draft_context_, draft_batch_) != 0) {
+            break;
+        }
+        draft_tokens_.push_back(token);
+        i_logits = 0;
+    }
+    if (drafted.empty()) {
+        return false;
+    }
+
+    batch_.n_tokens = 0;
+    common_batch_add(batch_, slot.next_token, slot.n_cur, {slot.seq_id}, true);
+    for (size_t i = 0; i < drafted.size(); i++) {
+        common_batch_add(batch_, drafted[i], slot.n_cur + 1 + static_cast<llama_pos>(i),
+                         {slot.seq_id}, true);
+    }
+    if (llama_decode(context_, batch_) != 0) {
+        LOGE("llama_decode failed while verifying %zu draft tokens", drafted.size());
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        finish_slot_locked(slot, true);
+        return true;
+    }
+
+    // Nothing reads the slot's sequence after the last accept_token, which may
+    // finish it
+    const llama_seq_id seq_id = slot.seq_id;
+    llama_pos n_cur = slot.n_cur;
+    seq_tokens_[seq_id].push_back(slot.next_token);
+    slot.n_cur = ++n_cur;
+    slot.next_token = LLAMA_TOKEN_NULL;
+
+    size_t n_accepted = 0;
+    for (size_t i = 0; i <= drafted.size(); i++) {
+        const llama_token token = llama_sampler_sample(slot.sampler, context_, static_cast<int32_t>(i));
+        llama_sampler_accept(slot.sampler, token);
+        if (slot.want_logprob) {
+            slot.logprob += token_logprob(static_cast<int32_t>(i), token);
+        }
+        if (!accept_token(slot, token) || i == drafted.size() || token != drafted[i]) {
+            break;
+        }
+        // The matching draft is already in the target cache at this position
+        seq_tokens_[seq_id].push_back(token);
+        slot.n_cur = ++n_cur;
+        slot.next_token = LLAMA_TOKEN_NULL;
+        n_accepted++;
+    }
+    llama_memory_seq_rm(llama_get_memory(context_), seq_id, n_cur, -1);
+
+    spec_drafted_ += static_cast<int64_t>(drafted.size());
+    spec_accepted_ += static_cast<int64_t>(n_accepted);
+    spec_target_decodes_++;
+    spec_tokens_emitted_ += static_cast<int64_t>(n_accepted + 1);
+    return true;
+}
+
+// Prompt lookup: finds the latest earlier occurrence of the last n tokens
+// (longest n first) in the sequence's history and proposes what followed it.
+// Replies that copy from the prompt match often; a miss costs a few extra
+// tokens in the batch.
+void LlamaCppTextGeneration::propose_lookup_draft(GenerationSlot& slot, int max_draft) {
+    const int n_ctx = static_cast<int>(llama_n_ctx(context_));
+    const size_t n_room = static_cast<size_t>(std::max(
+        0, std::min({kLookupMaxDraft, max_draft, slot.max_tokens - slot.n_generated - 1,
+                     n_ctx - static_cast<int>(slot.n_cur) - 2})));
+    if (n_room == 0) {
+        return;
+    }
+
+    // History is the sequence's cache plus the pending token
+    const std::vector<llama_token>& cached = seq_tokens_[slot.seq_id];
+    const size_t n_history = cached.size() + 1;
+    auto history_at = [&](size_t i) { return i < cached.size() ? cached[i] : slot.next_token; };
+
+    for (size_t n = kLookupMaxNgram; n >= static_cast<size_t>(kLookupMinNgram); n--) {
+        if (n >= n_history) {
+            continue;
+        }
+        const size_t tail = n_history - n;
+        for (size_t start = tail; start-- > 0;) {
+            size_t k = 0;
+            while (k < n && history_at(start + k) == history_at(tail + k)) {
+                k++;
+            }
+            if (k < n) {
+                continue;
+            }
+            for (size_t i = start + n; i < n_history && slot.lookup_draft.size() < n_room; i++) {
+                slot.lookup_draft.push_back(history_at(i));
+            }
+            return;
+        }
+    }
+}
+
+// Samples the pending token's logits, then each proposal's while the samples
+// agree with the proposals, as speculative_step does for the draft model.
+// Matching proposals are already in the cache; the rest are removed.
+void LlamaCppTextGeneration::verify_lookup_draft(GenerationSlot& slot) {
+    // Nothing reads the slot's sequence after the last accept_token, which may
+    // finish it
+    const llama_seq_id seq_id = slot.seq_id;
+    const size_t n_drafted = slot.lookup_draft.size();
+    llama_pos n_cur = slot.n_cur;
+
+    size_t n_accepted = 0;
+    for (size_t i = 0; i <= n_drafted; i++) {
+        const int32_t i_logits =
+            i == 0 ? slot.i_batch : slot.i_lookup + static_cast<int32_t>(i) - 1;
+        const llama_token token = llama_sampler_sample(slot.sampler, context_, i_logits);
+        llama_sampler_accept(slot.sampler, token);
+        const llama_token proposed = i < n_drafted ? slot.lookup_draft[i] : LLAMA_TOKEN_NULL;
+        if (slot.want_logprob) {
+            slot.logprob += token_logprob(i_logits, token);
+        }
+        if (!accept_token(slot, token) || token != proposed) {
+            break;
+        }
+        seq_tokens_[seq_id].push_back(token);
+        slot.n_cur = ++n_cur;
+        slot.next_token = LLAMA_TOKEN_NULL;
+        n_accepted++;
+    }
+    llama_memory_seq_rm(llama_get_memory(context_), seq_id, n_cur, -1);
+
+    lookup_drafted_ += static_cast<int64_t>(n_drafted);
+    lookup_accepted_ += static_cast<int64_t>(n_accepted);
+    lookup_decodes_++;
+}
+
+SpeculativeStats LlamaCppTextGeneration::get_speculative_stats() const {
+    SpeculativeStats stats;
+    stats.enabled = draft_context_ != nullptr;
+    stats.drafted_tokens = spec_drafted_.load();
+    stats.accepted_tokens = spec_accepted_.load();
+    stats.target_decodes = spec_target_decodes_.load();
+    stats.generated_tokens = spec_tokens_emitted_.load();
+    stats.lookup_drafted_tokens = lookup_drafted_.load();
+    stats.lookup_accepted_tokens = lookup_accepted_.load();
+    stats.lookup_decodes = lookup_decodes_.load();
+    return stats;
+}
+
+int LlamaCppTextGeneration::reuse_cached_prefix(llama_seq_id seq_id,
+                                                const std::vector<llama_token>& tokens) {
+    auto& cached = seq_tokens_[seq_id];
+    size_t n_past = 0;
+    while (n_past < cached.size() && n_past < tokens.size() && cached[n_past] == tokens[n_past]) {
+        n_past++;
+    }
+
+    // Another sequence may hold a longer prefix (e.g. batch requests sharing an
+    // instruction). With the unified KV cache, copying it only shares cells.
+    // Recurrent state cannot be truncated to a prefix, so those models skip this.
+    llama_seq_id donor = -1;
+    size_t donor_prefix = n_past + kMinSharedPrefix;
+    if (!llama_model_is_recurrent(model_)) {
+        for (llama_seq_id seq = 0; seq < n_parallel_; seq++) {
+            if (seq == seq_id || seq_lora_[seq] != seq_lora_[seq_id]) {
+                continue;
+            }
+            const auto& other = seq_tokens_[seq];
+            size_t prefix = 0;
+            while (prefix < other.size() && prefix < tokens.size() && other[prefix] == tokens[prefix]) {
+                prefix++;
+            }
+            if (prefix > donor_prefix) {
+                donor = seq;
+                donor_prefix = prefix;
+            }
+        }
+    }
+    if (donor >= 0) {
+        if (donor_prefix == tokens.size()) {
+            donor_prefix--;
+        }
+        clear_sequence(seq_id);
+        llama_memory_seq_cp(llama_get_memory(context_), donor, seq_id, 0,
+                            static_cast<llama_pos>(donor_prefix));
+        cached.assign(tokens.begin(), tokens.begin() + static_cast<std::ptrdiff_t>(donor_prefix));
+        LOGI("Prefix cache: sharing %zu of %zu prompt tokens from sequence %d on sequence %d",
+             donor_prefix, tokens.size(), donor, seq_id);
+        return static_cast<int>(donor_prefix);
+    }
+
+    // The last prompt token is always re-decoded to get fresh logits
+    if (n_past == tokens.size() && n_past > 0) {
+        n_past--;
+    }
+
+    if (n_past < cached.size() &&
+        !llama_memory_seq_rm(llama_get_memory(context_), seq_id, static_cast<llama_pos>(n_past), -1)) {
+        // Partial removal isn't supported by every memory type (e.g. recurrent)
+        clear_sequence(seq_id);
+        return 0;
+    }
+    cached.resize(n_past);
+
+    LOGI("Prefix cache: reusing %zu of %zu prompt tokens on sequence %d", n_past, tokens.size(),
+         seq_id);
+    return static_cast<int>(n_past);
+}
+
+// Images decode whole: a reused prefix that ends inside one is cut back to the
+// image's start, and the ones it covers are skipped
+void LlamaCppTextGeneration::resume_before_image(GenerationSlot& slot) {
+    slot.next_image = 0;
+    while (slot.next_image < slot.images.size()) {
+        const PromptImage& image = slot.images[slot.next_image];
+        if (slot.n_prompt_decoded <= image.start) {
+            return;
+        }
+        if (slot.n_prompt_decoded >= image.start + image.n_tokens) {
+            slot.next_image++;
+            continue;
+        }
+        if (!llama_memory_seq_rm(llama_get_memory(context_), slot.seq_id,
+                                 static_cast<llama_pos>(image.start), -1)) {
+            clear_sequence(slot.seq_id);
+            slot.n_prompt_decoded = 0;
+            slot.next_image = 0;
+            return;
+        }
+        seq_tokens_[slot.seq_id].resize(image.start);
+        slot.n_prompt_decoded = image.start;
+        return;
+    }
+}
+
+void LlamaCppTextGeneration::clear_sequence(llama_seq_id seq_id) {
+    seq_tokens_[seq_id].clear();
+    llama_memory_seq_rm(llama_get_memory(context_), seq_id, -1, -1);
+}
+
+void LlamaCppTextGeneration::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex_);
+        for (auto& slot : pending_slots_) {
+            slot->stop_requested = true;
+        }
+        for (auto& slot : active_slots_) {
+            slot->stop_requested = true;
+            for (auto& branch : slot->branches) {
+                branch->stop_requested = true;
+            }
+        }
+    }
+    cancel_epoch_++;
+    scheduler_cv_.notify_one();
     LOGI("Generation cancel requested");
 }
 
@@ -576,6 +2601,20 @@ nlohmann::json LlamaCppTextGeneration::get_model_info() const {
     info["top_k"] = top_k_;
     info["top_p"] = top_p_;
     info["min_p"] = min_p_;
+    info["gpu_layers"] = n_gpu_layers_;
+    info["kv_cache_type_k"] = ggml_type_name(type_k_);
+    info["kv_cache_type_v"] = ggml_type_name(type_v_);
+    info["kv_cache_bytes"] = kv_cache_size(model_, context_size_);
+    info["cpu_variant"] = ggml_cpu_variant();
+    info["vision"] = mtmd_ != nullptr;
+    if (mtmd_) {
+        info["mmproj_path"] = mmproj_path_;
+        info["image_cache_hits"] = image_cache_hits_.load();
+        info["image_encodes"] = image_encodes_.load();
+    }
+    if (!gpu_device_name_.empty()) {
+        info["gpu_device"] = gpu_device_name_;
+    }
 
     char buf[256];
     if (llama_model_meta_val_str(model_, "general.name", buf, sizeof(buf)) > 0) {
@@ -588,4 +2627,712 @@ nlohmann::json LlamaCppTextGeneration::get_model_info() const {
     return info;
 }
 
+// =============================================================================
+// MEMORY ACCOUNTING
+// =============================================================================
+
+struct FileMappingUsage {
+    size_t mapped_bytes = 0;
+    size_t resident_bytes = 0;
+};
+
+// Sums the Size/Rss of every mapping of `path` in /proc/self/smaps. Returns
+// zeros where smaps is unavailable or the file is not mapped (use_mmap off).
+static FileMappingUsage file_mapping_usage(const std::string& path) {
+    FileMappingUsage usage;
+    if (path.empty()) {
+        return usage;
+    }
+    char resolved[PATH_MAX];
+    const std::string target = realpath(path.c_str(), resolved) ? resolved : path;
+
+    FILE* smaps = fopen("/proc/self/smaps", "r");
+    if (!smaps) {
+        return usage;
+    }
+    char line[PATH_MAX + 128];
+    bool in_target = false;
+    while (fgets(line, sizeof(line), smaps)) {
+        unsigned long long kb = 0;
+        if (sscanf(line, "Size: %llu kB", &kb) == 1) {
+            if (in_target) {
+                usage.mapped_bytes += static_cast<size_t>(kb) * 1024;
+            }
+        } else if (sscanf(line, "Rss: %llu kB", &kb) == 1) {
+            if (in_target) {
+                usage.resident_bytes += static_cast<size_t>(kb) * 1024;
+            }
+        } else if (const char* dash = strchr(line, '-');
+                   dash && dash < strchr(line, ' ')) {
+            // Mapping header: "start-end perms offset dev inode [path]"
+            const char* slash = strchr(line, '/');
+            std::string mapped_path = slash ? slash : "";
+            while (!mapped_path.empty() && (mapped_path.back() == '\n' || mapped_path.back() == ' ')) {
+                mapped_path.pop_back();
+            }
+            in_target = mapped_path == target;
+        }
+    }
+    fclose(smaps);
+    return usage;
+}
+
+// Bytes of K and V for every layer over n_ctx cells
+static size_t kv_cache_bytes(const llama_model* model, uint32_t n_ctx, ggml_type type_k,
+                             ggml_type type_v) {
+    const int32_t n_head = llama_model_n_head(model);
+    if (n_head <= 0) {
+        return 0;
+    }
+    const int64_t n_embd_gqa = static_cast<int64_t>(llama_model_n_embd(model)) / n_head *
+                               llama_model_n_head_kv(model);
+    const size_t per_cell =
+        ggml_row_size(type_k, n_embd_gqa) + ggml_row_size(type_v, n_embd_gqa);
+    return per_cell * static_cast<size_t>(llama_model_n_layer(model)) * n_ctx;
+}
+
+size_t LlamaCppTextGeneration::kv_cache_size(const llama_model* model, int n_ctx) const {
+    return kv_cache_bytes(model, static_cast<uint32_t>(std::max(n_ctx, 0)), type_k_, type_v_);
+}
+
+// Largest context (a multiple of 256, at least 512, at most n_ctx) whose KV
+// cache fits in the budget after the weights and output buffers.
+int LlamaCppTextGeneration::fit_context_to_budget(int n_ctx, size_t budget_bytes) const {
+    const size_t weights = static_cast<size_t>(llama_model_size(model_));
+    const size_t n_vocab = static_cast<size_t>(llama_vocab_n_tokens(llama_model_get_vocab(model_)));
+    const size_t outputs = static_cast<size_t>(std::min(n_ctx, 512)) * n_vocab * sizeof(float);
+    const size_t per_cell = kv_cache_size(model_, 1);
+    if (per_cell == 0 || budget_bytes <= weights + outputs) {
+        LOGE("Memory budget of %zu MB does not cover the model; keeping context %d",
+             budget_bytes / (1024 * 1024), n_ctx);
+        return n_ctx;
+    }
+
+    const size_t max_cells = (budget_bytes - weights - outputs) / per_cell;
+    const int fitted = std::max(512, std::min(n_ctx, static_cast<int>(max_cells / 256 * 256)));
+    LOGI("Context %d fits a %zu MB budget (KV %zu bytes/token)", fitted,
+         budget_bytes / (1024 * 1024), per_cell);
+    return fitted;
+}
+
+MemoryUsage LlamaCppTextGeneration::get_memory_usage() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    MemoryUsage usage;
+    if (!is_ready()) {
+        return usage;
+    }
+
+    const uint32_t n_ctx = llama_n_ctx(context_);
+    usage.context_size = static_cast<int>(n_ctx);
+    usage.model_bytes = static_cast<size_t>(llama_model_size(model_));
+
+    const FileMappingUsage mapping = file_mapping_usage(model_path_);
+    usage.model_mapped_bytes = mapping.mapped_bytes;
+    usage.model_resident_bytes = std::min(mapping.resident_bytes, usage.model_bytes);
+
+    usage.kv_cache_bytes = kv_cache_size(model_, static_cast<int>(n_ctx));
+
+    const int32_t n_vocab = llama_vocab_n_tokens(llama_model_get_vocab(model_));
+    const size_t n_embd = static_cast<size_t>(llama_model_n_embd(model_));
+    const size_t n_batch = llama_n_batch(context_);
+    const size_t n_ubatch = llama_n_ubatch(context_);
+    // Logits for a full batch, plus ubatch activations and the attention
+    // scores of one ubatch against the whole context.
+    usage.compute_bytes = n_batch * static_cast<size_t>(n_vocab) * sizeof(float) +
+                          n_ubatch * n_embd * sizeof(float) * 4 +
+                          n_ubatch * n_ctx * static_cast<size_t>(llama_model_n_head(model_)) *
+                              sizeof(float);
+
+    size_t n_chains = sampler_pool_.size();
+    {
+        std::lock_guard<std::mutex> scheduler_lock(scheduler_mutex_);
+        n_chains += active_slots_.size() + pending_slots_.size();
+
+        // The state walk touches the KV cache, so only run it while the
+        // scheduler is idle; otherwise estimate from the cached token counts.
+        if (active_slots_.empty() && pending_slots_.empty()) {
+            usage.kv_used_bytes = llama_state_get_size(context_);
+        } else if (n_ctx > 0) {
+            size_t n_cells = 0;
+            for (const auto& tokens : seq_tokens_) {
+                n_cells += tokens.size();
+            }
+            usage.kv_used_bytes = usage.kv_cache_bytes / n_ctx * std::min<size_t>(n_cells, n_ctx);
+        }
+    }
+    // Penalty history per chain plus one candidate array per sampling call
+    usage.sampler_bytes = n_chains * 64 * (sizeof(llama_token) + 2 * sizeof(int)) +
+                          static_cast<size_t>(n_vocab) * sizeof(llama_token_data);
+
+    if (draft_model_) {
+        const FileMappingUsage draft_mapping = file_mapping_usage(draft_model_path_);
+        const size_t draft_weights = draft_mapping.mapped_bytes > 0
+                                         ? draft_mapping.resident_bytes
+                                         : static_cast<size_t>(llama_model_size(draft_model_));
+        usage.draft_bytes =
+            draft_weights + kv_cache_size(draft_model_, static_cast<int>(llama_n_ctx(draft_context_)));
+    }
+
+    // The projector's weights are read into buffers, not mapped
+    if (mtmd_) {
+        struct stat st;
+        if (stat(mmproj_path_.c_str(), &st) == 0) {
+            usage.vision_bytes = static_cast<size_t>(st.st_size);
+        }
+        usage.vision_bytes += image_cache_bytes_;
+    }
+
+    return usage;
+}
+
+bool LlamaCppTextGeneration::trim_memory(MemoryPressure level) {
+    if (level == MemoryPressure::NONE) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_ready()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> scheduler_lock(scheduler_mutex_);
+        if (!active_slots_.empty() || !pending_slots_.empty()) {
+            LOGI("Skipping memory trim while generating");
+            return false;
+        }
+    }
+
+    // Cached prefixes, pooled slots and extra sampler chains are rebuilt on demand
+    stop_scheduler();
+    llama_memory_clear(llama_get_memory(context_), true);
+    for (size_t i = 1; i < sampler_pool_.size(); i++) {
+        llama_sampler_free(sampler_pool_[i].second);
+    }
+    sampler_pool_.resize(std::min<size_t>(sampler_pool_.size(), 1));
+    free_grammars();
+    std::vector<std::string>().swap(vocab_pieces_);
+
+    // Encoded images are costly to rebuild, so they go with the context
+    if (level >= MemoryPressure::LOW) {
+        clear_image_cache();
+    }
+
+    const int n_ctx = static_cast<int>(llama_n_ctx(context_));
+    if (level >= MemoryPressure::LOW && n_ctx > kMinTrimmedContext) {
+        const int trimmed = std::max(kMinTrimmedContext, n_ctx / 2);
+        llama_free(context_);
+        context_ = llama_init_from_model(model_, make_context_params(trimmed));
+        if (context_) {
+            context_size_ = trimmed;
+            LOGI("Context shrunk under memory pressure: %d -> %d", n_ctx, trimmed);
+        } else {
+            LOGE("Failed to recreate context at %d tokens; restoring %d", trimmed, n_ctx);
+            context_ = llama_init_from_model(model_, make_context_params(n_ctx));
+            if (!context_) {
+                LOGE("Failed to restore context; unloading model");
+                unload_model_internal();
+                return true;
+            }
+        }
+    }
+
+    start_scheduler();
+    LOGI("Released cached memory (pressure level %d)", static_cast<int>(level));
+    return true;
+}
+
+// =============================================================================
+// CONVERSATION STATE
+// =============================================================================
+
+namespace {
+
+constexpr char kStateMagic[8] = {'R', 'A', 'C', 'K', 'V', 'S', 'T', '1'};
+
+// Start of a state file; the tokens and then llama.cpp's sequence state follow
+struct StateFileHeader {
+    char magic[8];
+    uint64_t model_fingerprint;  // the state only fits the model it came from
+    int32_t type_k;
+    int32_t type_v;
+    uint32_t token_count;
+    uint32_t lora_hash;  // name of the LoRA adapter the cache was computed with, 0 for none
+    float lora_scale;
+    uint32_t reserved;
+    uint64_t token_hash;
+    uint64_t state_bytes;
+};
+static_assert(sizeof(StateFileHeader) == 56, "state file header layout");
+
+uint64_t fnv1a64(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint64_t model_fingerprint(const llama_model* model) {
+    char desc[128] = {};
+    llama_model_desc(model, desc, sizeof(desc));
+    const uint64_t shape[] = {
+        llama_model_n_params(model),
+        llama_model_size(model),
+        static_cast<uint64_t>(llama_model_n_embd(model)),
+        static_cast<uint64_t>(llama_model_n_layer(model)),
+        static_cast<uint64_t>(llama_vocab_n_tokens(llama_model_get_vocab(model))),
+    };
+    return fnv1a64(shape, sizeof(shape), fnv1a64(desc, strlen(desc)));
+}
+
+uint64_t token_hash(const llama_token* tokens, size_t count) {
+    return fnv1a64(tokens, count * sizeof(llama_token));
+}
+
+uint32_t lora_name_hash(const std::string& name) {
+    const uint64_t hash = fnv1a64(name.data(), name.size());
+    return static_cast<uint32_t>(hash ^ (hash >> 32)) | 1u;  // never 0
+}
+
+}  // namespace
+
+// Finished slots stay in active_slots_ until the next step erases them
+bool LlamaCppTextGeneration::generating_locked() const {
+    if (!pending_slots_.empty()) {
+        return true;
+    }
+    for (const auto& slot : active_slots_) {
+        if (!slot->finished) {
+            return true;
+        }
+    }
+    return false;
+}
+
+rac_result_t LlamaCppTextGeneration::save_state(const std::string& path, int* out_tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_ready()) {
+        return RAC_ERROR_MODEL_NOT_LOADED;
+    }
+
+    // Copied under the scheduler lock so requests can start during the write
+    std::vector<llama_token> tokens;
+    std::vector<uint8_t> state;
+    LoraSelection lora;
+    {
+        std::lock_guard<std::mutex> scheduler_lock(scheduler_mutex_);
+        if (generating_locked()) {
+            return RAC_ERROR_BACKEND_BUSY;
+        }
+        if (last_seq_ < 0 || seq_tokens_[last_seq_].empty()) {
+            LOGE("No conversation state to save");
+            return RAC_ERROR_INVALID_STATE;
+        }
+        tokens = seq_tokens_[last_seq_];
+        lora = seq_lora_[last_seq_];
+        state.resize(llama_state_seq_get_size(context_, last_seq_));
+        state.resize(llama_state_seq_get_data(context_, state.data(), state.size(), last_seq_));
+    }
+    if (state.empty()) {
+        return RAC_ERROR_INVALID_STATE;
+    }
+
+    StateFileHeader header = {};
+    memcpy(header.magic, kStateMagic, sizeof(kStateMagic));
+    header.model_fingerprint = model_fingerprint(model_);
+    header.type_k = static_cast<int32_t>(type_k_);
+    header.type_v = static_cast<int32_t>(type_v_);
+    header.token_count = static_cast<uint32_t>(tokens.size());
+    for (const auto& entry : lora_adapters_) {
+        if (entry.adapter == lora.adapter) {
+            header.lora_hash = lora_name_hash(entry.name);
+            header.lora_scale = lora.scale;
+        }
+    }
+    header.token_hash = token_hash(tokens.data(), tokens.size());
+    header.state_bytes = state.size();
+
+    // Written aside and renamed, so an interrupted save keeps the previous file
+    const std::string tmp_path = path + ".tmp";
+    FILE* file = fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        LOGE("Cannot write conversation state to %s", tmp_path.c_str());
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(tokens.data(), sizeof(llama_token), tokens.size(), file) == tokens.size() &&
+              fwrite(state.data(), 1, state.size(), file) == state.size() && fflush(file) == 0 &&
+              fsync(fileno(file)) == 0;
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(tmp_path.c_str(), path.c_str()) != 0) {
+        unlink(tmp_path.c_str());
+        LOGE("Failed to write conversation state to %s", path.c_str());
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+
+    LOGI("Saved conversation state: %zu tokens, %zu state bytes", tokens.size(), state.size());
+    if (out_tokens) {
+        *out_tokens = static_cast<int>(tokens.size());
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t LlamaCppTextGeneration::restore_state(const std::string& path, int* out_tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_ready()) {
+        return RAC_ERROR_MODEL_NOT_LOADED;
+    }
+
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return errno == ENOENT ? RAC_ERROR_FILE_NOT_FOUND : RAC_ERROR_FILE_READ_FAILED;
+    }
+    struct stat st = {};
+    const size_t size = fstat(fd, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+    // The state is handed to llama.cpp straight from the page cache
+    void* addr = size >= sizeof(StateFileHeader)
+                     ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)
+                     : MAP_FAILED;
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return size < sizeof(StateFileHeader) ? RAC_ERROR_INVALID_FORMAT
+                                              : RAC_ERROR_FILE_READ_FAILED;
+    }
+    const auto* base = static_cast<const uint8_t*>(addr);
+    StateFileHeader header;
+    memcpy(&header, base, sizeof(header));
+    const size_t tokens_bytes = static_cast<size_t>(header.token_count) * sizeof(llama_token);
+    const llama_token* tokens = reinterpret_cast<const llama_token*>(base + sizeof(header));
+
+    // The cache is only valid under the adapter it was computed with
+    LoraSelection lora;
+    for (const auto& entry : lora_adapters_) {
+        if (header.lora_hash != 0 && lora_name_hash(entry.name) == header.lora_hash) {
+            lora = {entry.adapter, header.lora_scale};
+        }
+    }
+
+    rac_result_t result = RAC_SUCCESS;
+    if (memcmp(header.magic, kStateMagic, sizeof(kStateMagic)) != 0 ||
+        size != sizeof(header) + tokens_bytes + header.state_bytes || header.token_count == 0 ||
+        token_hash(tokens, header.token_count) != header.token_hash) {
+        LOGE("Conversation state %s is not valid", path.c_str());
+        result = RAC_ERROR_INVALID_FORMAT;
+    } else if (header.model_fingerprint != model_fingerprint(model_) ||
+               header.type_k != static_cast<int32_t>(type_k_) ||
+               header.type_v != static_cast<int32_t>(type_v_) ||
+               (header.lora_hash != 0 && lora.adapter == nullptr)) {
+        LOGE("Conversation state %s was saved with another model, KV cache type or LoRA adapter",
+             path.c_str());
+        result = RAC_ERROR_MODEL_INCOMPATIBLE;
+    } else if (header.token_count >= llama_n_ctx(context_)) {
+        result = RAC_ERROR_CONTEXT_TOO_LONG;
+    }
+
+    if (result == RAC_SUCCESS) {
+        std::lock_guard<std::mutex> scheduler_lock(scheduler_mutex_);
+        llama_seq_id target = -1;
+        if (generating_locked()) {
+            result = RAC_ERROR_BACKEND_BUSY;
+        } else {
+            for (llama_seq_id seq = 0; seq < n_parallel_; seq++) {
+                if (target < 0 || seq_tokens_[seq].size() < seq_tokens_[target].size()) {
+                    target = seq;
+                }
+            }
+            const uint8_t* state = base + sizeof(header) + tokens_bytes;
+            clear_sequence(target);
+            size_t read = llama_state_seq_set_data(context_, state, header.state_bytes, target);
+            if (read == 0) {
+                // No room next to the other cached conversations; they are cheaper to lose
+                for (llama_seq_id seq = 0; seq < n_parallel_; seq++) {
+                    clear_sequence(seq);
+                }
+                read = llama_state_seq_set_data(context_, state, header.state_bytes, target);
+            }
+            if (read == 0) {
+                clear_sequence(target);
+                result = RAC_ERROR_INVALID_STATE;
+            } else {
+                seq_tokens_[target].assign(tokens, tokens + header.token_count);
+                seq_lora_[target] = lora;
+                last_seq_ = target;
+            }
+        }
+    }
+    munmap(addr, size);
+
+    if (result == RAC_SUCCESS) {
+        LOGI("Restored conversation state: %u tokens", header.token_count);
+        if (out_tokens) {
+            *out_tokens = static_cast<int>(header.token_count);
+        }
+    }
+    return result;
+}
+
+// =============================================================================
+// LORA ADAPTERS
+// =============================================================================
+
+rac_result_t LlamaCppTextGeneration::load_lora_adapter(const std::string& name,
+                                                       const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_ready()) {
+        return RAC_ERROR_MODEL_NOT_LOADED;
+    }
+    if (name.empty()) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    for (const auto& entry : lora_adapters_) {
+        if (entry.name == name) {
+            // Loaded once; a different file under the same name must be removed first
+            return entry.path == path ? RAC_SUCCESS : RAC_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    llama_adapter_lora* adapter = llama_adapter_lora_init(model_, path.c_str());
+    if (!adapter) {
+        LOGE("Failed to load LoRA adapter %s from %s", name.c_str(), path.c_str());
+        return RAC_ERROR_MODEL_LOAD_FAILED;
+    }
+    lora_adapters_.push_back({name, path, adapter});
+    LOGI("Loaded LoRA adapter %s in %lld ms", name.c_str(),
+         static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    std::chrono::steady_clock::now() - start)
+                                    .count()));
+    return RAC_SUCCESS;
+}
+
+rac_result_t LlamaCppTextGeneration::remove_lora_adapter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(lora_adapters_.begin(), lora_adapters_.end(),
+                           [&](const LoraAdapter& entry) { return entry.name == name; });
+    if (it == lora_adapters_.end()) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+
+    {
+        std::lock_guard<std::mutex> scheduler_lock(scheduler_mutex_);
+        for (const auto& slot : pending_slots_) {
+            if (slot->lora.adapter == it->adapter) {
+                return RAC_ERROR_BACKEND_BUSY;
+            }
+        }
+        for (const auto& slot : active_slots_) {
+            if (!slot->finished && slot->lora.adapter == it->adapter) {
+                return RAC_ERROR_BACKEND_BUSY;
+            }
+        }
+        // Running requests all use the applied adapter, so none is running here
+        if (applied_lora_.adapter == it->adapter) {
+            apply_lora_locked(LoraSelection());
+        }
+        for (llama_seq_id seq = 0; seq < n_parallel_; seq++) {
+            if (seq_lora_[seq].adapter == it->adapter) {
+                clear_sequence(seq);
+                seq_lora_[seq] = LoraSelection();
+            }
+        }
+    }
+
+    llama_adapter_lora_free(it->adapter);
+    if (default_lora_ == name) {
+        default_lora_.clear();
+    }
+    lora_adapters_.erase(it);
+    LOGI("Removed LoRA adapter %s", name.c_str());
+    return RAC_SUCCESS;
+}
+
+rac_result_t LlamaCppTextGeneration::set_lora_adapter(const std::string& name, float scale) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!name.empty() &&
+        std::none_of(lora_adapters_.begin(), lora_adapters_.end(),
+                     [&](const LoraAdapter& entry) { return entry.name == name; })) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+    default_lora_ = name;
+    default_lora_scale_ = scale;
+    return RAC_SUCCESS;
+}
+
+// Adapter a request runs with; false if it names one that is not loaded
+bool LlamaCppTextGeneration::resolve_lora(const TextGenerationRequest& request,
+                                          LoraSelection* out) const {
+    const std::string& name = request.use_default_lora ? default_lora_ : request.lora_adapter;
+    const float scale = request.use_default_lora ? default_lora_scale_ : request.lora_scale;
+    *out = LoraSelection();
+    if (name.empty()) {
+        return true;
+    }
+    for (const auto& entry : lora_adapters_) {
+        if (entry.name == name) {
+            out->adapter = entry.adapter;
+            out->scale = scale > 0.0f ? scale : 1.0f;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Switches the context's adapter; costs a graph rebuild, not a weight load
+void LlamaCppTextGeneration::apply_lora_locked(const LoraSelection& lora) {
+    llama_clear_adapter_lora(context_);
+    if (lora.adapter && llama_set_adapter_lora(context_, lora.adapter, lora.scale) != 0) {
+        LOGE("Failed to apply LoRA adapter");
+        applied_lora_ = LoraSelection();
+        return;
+    }
+    applied_lora_ = lora;
+}
+
+void LlamaCppTextGeneration::free_lora_adapters() {
+    if (context_) {
+        llama_clear_adapter_lora(context_);
+    }
+    for (auto& entry : lora_adapters_) {
+        llama_adapter_lora_free(entry.adapter);
+    }
+    lora_adapters_.clear();
+    default_lora_.clear();
+    applied_lora_ = LoraSelection();
+}
+
+// =============================================================================
+// GPU OFFLOAD
+// =============================================================================
+
+struct GpuDeviceInfo {
+    ggml_backend_dev_t device = nullptr;
+    size_t free_bytes = 0;
+    size_t total_bytes = 0;
+};
+
+// First GPU (discrete or integrated) registered by the ggml build, if any
+static GpuDeviceInfo probe_gpu_device() {
+    GpuDeviceInfo info;
+    for (size_t i = 0; i < ggml_backend_dev_count(); i++) {
+        ggml_backend_dev_t dev = ggml_backend_dev_get(i);
+        const auto type = ggml_backend_dev_type(dev);
+        if (type == GGML_BACKEND_DEVICE_TYPE_GPU || type == GGML_BACKEND_DEVICE_TYPE_IGPU) {
+            info.device = dev;
+            ggml_backend_dev_memory(dev, &info.free_bytes, &info.total_bytes);
+            break;
+        }
+    }
+    return info;
+}
+
+// Returns the layer count to offload: 0 without a GPU, the requested count
+// when given, otherwise as many layers (weights plus their KV) as fit in
+// 80% of the device's free memory.
+int LlamaCppTextGeneration::choose_gpu_layers(const std::string& model_path, int requested,
+                                              int n_ctx) {
+    gpu_device_name_.clear();
+    const GpuDeviceInfo gpu = probe_gpu_device();
+    if (!gpu.device) {
+        if (requested != 0) {
+            LOGI("No GPU device available; running on CPU");
+        }
+        return 0;
+    }
+    gpu_device_name_ = ggml_backend_dev_description(gpu.device);
+    if (requested >= 0) {
+        LOGI("GPU offload: %d layers on %s (configured)", requested, gpu_device_name_.c_str());
+        return requested;
+    }
+
+    // Metadata-only load for the layer count and attention shapes
+    llama_model_params probe_params = llama_model_default_params();
+    probe_params.vocab_only = true;
+    llama_model* probe = llama_model_load_from_file(model_path.c_str(), probe_params);
+    if (!probe) {
+        return 0;
+    }
+    const int n_layer = llama_model_n_layer(probe);
+    const size_t kv_bytes = kv_cache_size(probe, n_ctx);
+    llama_model_free(probe);
+
+    struct stat st;
+    if (n_layer <= 0 || stat(model_path.c_str(), &st) != 0) {
+        return 0;
+    }
+    // Repeating blocks plus the output layer, which llama.cpp counts as one more
+    const int n_offloadable = n_layer + 1;
+    if (gpu.free_bytes == 0) {
+        LOGI("GPU offload: all %d layers on %s (memory not reported)", n_offloadable,
+             gpu_device_name_.c_str());
+        return n_offloadable;
+    }
+
+    const size_t per_layer = static_cast<size_t>(st.st_size) / n_offloadable + kv_bytes / n_layer;
+    const size_t budget = gpu.free_bytes / 10 * 8;
+    const int layers =
+        static_cast<int>(std::min<size_t>(n_offloadable, per_layer > 0 ? budget / per_layer : 0));
+    LOGI("GPU offload: %d/%d layers on %s (free %zu MB, %zu MB per layer)", layers, n_offloadable,
+         gpu_device_name_.c_str(), gpu.free_bytes / (1024 * 1024), per_layer / (1024 * 1024));
+    return layers;
+}
+
+// =============================================================================
+// MODEL PREFETCH
+// =============================================================================
+
+// Maps the model file on its own and asks the kernel to read it ahead, then
+// touches one byte per page so it really lands in the page cache. llama.cpp's
+// mapping of the same file shares those pages, so the first decode does not
+// fault them in one by one.
+void LlamaCppTextGeneration::start_prefetch(const std::string& path) {
+    stop_prefetch();
+    prefetch_stop_ = false;
+    prefetch_thread_ = std::thread([this, path] {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            close(fd);
+            return;
+        }
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            return;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t chunk = 16 * 1024 * 1024;
+        const auto* bytes = static_cast<const volatile unsigned char*>(addr);
+        unsigned char sink = 0;
+        size_t offset = 0;
+        for (; offset < size && !prefetch_stop_; offset += chunk) {
+            const size_t len = std::min(chunk, size - offset);
+            madvise(static_cast<char*>(addr) + offset, len, MADV_WILLNEED);
+            for (size_t i = 0; i < len; i += page) {
+                sink ^= bytes[offset + i];
+            }
+        }
+        (void)sink;
+        munmap(addr, size);
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+        LOGI("Prefetched %zu MB of model in %lld ms%s", std::min(offset, size) / (1024 * 1024),
+             static_cast<long long>(elapsed.count()), prefetch_stop_ ? " (stopped)" : "");
+    });
+}
+
+void LlamaCppTextGeneration::stop_prefetch() {
+    if (prefetch_thread_.joinable()) {
+        prefetch_stop_ = true;
+        prefetch_thread_.join();
+    }
+}
+
 }  // namespace runanywhere
@@ -10,14 +10,27 @@
 
 #include <llama.h>
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "rac/core/rac_error.h"
+
+// llama.cpp multimodal (mtmd) types, defined in mtmd.h
+struct mtmd_context;
+struct mtmd_input_chunk;
+struct mtmd_input_chunks;
+
 namespace runanywhere {
 
 // =============================================================================
@@ -29,22 +42,55 @@ enum class DeviceType {
     GPU = 1,
     METAL = 3,
     CUDA = 4,
+    VULKAN = 5,
+    OPENCL = 6,
 };
 
 // =============================================================================
 // TEXT GENERATION TYPES (internal use only)
 // =============================================================================
 
+// Packed RGB8 pixels, already resized for the vision encoder
+struct ImageInput {
+    std::vector<uint8_t> rgb;
+    int width = 0;
+    int height = 0;
+};
+
 struct TextGenerationRequest {
     std::string prompt;
     std::string system_prompt;
     std::vector<std::pair<std::string, std::string>> messages;  // role, content pairs
     int max_tokens = 256;
-    float temperature = 0.7f;
-    float top_p = 0.9f;
-    int top_k = 40;
-    float repetition_penalty = 1.1f;
+    // Sampling overrides; negative values keep the model's load-time settings
+    float temperature = -1.0f;
+    float top_p = -1.0f;
+    int top_k = -1;
+    float repetition_penalty = -1.0f;
     std::vector<std::string> stop_sequences;
+    // JSON schema the output must match; compiled to a grammar applied while sampling
+    std::string json_schema;
+    // Re-generate the prompt's last token so a prompt ending mid-word does not
+    // force an unnatural tokenization of the reply
+    bool token_healing = false;
+    // LoRA adapter by name ("" = base model) when use_default_lora is false,
+    // else the one set with set_lora_adapter. A scale <= 0 means 1.0.
+    bool use_default_lora = true;
+    std::string lora_adapter;
+    float lora_scale = 0.0f;
+    // Propose continuations from n-gram matches in the prompt and reply, and
+    // verify them in the step's batch (no draft model needed)
+    bool prompt_lookup = false;
+    // Time budgets in ms from submission, 0 = none. A prompt whose prefill is
+    // projected, from the measured prefill speed, to miss max_prefill_ms stops
+    // before it is decoded, so the caller can fall back while it still has time.
+    int max_prefill_ms = 0;
+    int max_total_ms = 0;
+    // Stop once decoding runs slower than this, measured from the first token
+    float min_tokens_per_second = 0.0f;
+    // Images for the prompt's media markers, or ahead of the last user turn
+    // when it has none; needs a vision projector (supports_vision)
+    std::vector<ImageInput> images;
 };
 
 struct TextGenerationResult {
@@ -52,17 +98,163 @@ struct TextGenerationResult {
     int tokens_generated = 0;
     int prompt_tokens = 0;
     double inference_time_ms = 0.0;
-    std::string finish_reason;  // "stop", "length", "cancelled"
+    // "stop", "length", "cancelled", "error", or the budget that ended it:
+    // "prefill_deadline", "deadline", "too_slow"
+    std::string finish_reason;
+    double logprob = 0.0;       // sum of token log-probabilities (generate_samples only)
+};
+
+// Aho-Corasick matcher over streamed bytes. Each byte is examined once, and
+// bytes that could still be the start of a stop sequence are held back until
+// they either complete a match (and are dropped) or can no longer match.
+class StopSequenceMatcher {
+   public:
+    explicit StopSequenceMatcher(const std::vector<std::string>& stop_sequences);
+
+    // Appends text; returns the bytes that are now safe to emit. Sets stopped()
+    // once a stop sequence completes, after which input is ignored.
+    std::string feed(const std::string& text);
+    // Releases held-back bytes at the end of generation.
+    std::string flush();
+    // Rewinds to the initial state, keeping the built automaton
+    void reset();
+    bool stopped() const { return stopped_; }
+
+   private:
+    struct Node {
+        std::array<int32_t, 256> next;
+        int32_t fail = 0;
+        int32_t depth = 0;
+        int32_t match = 0;  // length of a stop sequence ending here, 0 if none
+    };
+
+    std::vector<Node> nodes_;
+    int32_t state_ = 0;
+    std::string held_;
+    bool stopped_ = false;
+};
+
+// Incremental UTF-8 decoder for streamed token pieces. Complete code points
+// are emitted as soon as their last byte arrives; only the trailing partial
+// sequence (at most 3 bytes) is held. Invalid bytes become U+FFFD so callers
+// (JNI's NewStringUTF in particular) always receive valid UTF-8.
+class Utf8StreamDecoder {
+   public:
+    // Appends the completed part of text to out
+    void feed(const std::string& text, std::string& out);
+    // Ends the stream; a dangling partial sequence becomes U+FFFD
+    void flush(std::string& out);
+    void reset() {
+        held_len_ = 0;
+        need_ = 0;
+    }
+
+   private:
+    char held_[4] = {};
+    int held_len_ = 0;
+    int need_ = 0;  // continuation bytes still expected
+};
+
+// Key of a pooled sampler chain
+struct SamplerParams {
+    float temperature = 0.8f;
+    float top_p = 0.95f;
+    int top_k = 40;
+    float repetition_penalty = 1.2f;
+
+    bool operator==(const SamplerParams& other) const {
+        return temperature == other.temperature && top_p == other.top_p &&
+               top_k == other.top_k && repetition_penalty == other.repetition_penalty;
+    }
+};
+
+// Speculative decoding counters since model load
+struct SpeculativeStats {
+    bool enabled = false;
+    int64_t drafted_tokens = 0;
+    int64_t accepted_tokens = 0;
+    int64_t target_decodes = 0;    // verification passes of the main model
+    int64_t generated_tokens = 0;  // tokens produced by those passes
+    // Prompt lookup, counted separately: it needs no draft model
+    int64_t lookup_drafted_tokens = 0;
+    int64_t lookup_accepted_tokens = 0;
+    int64_t lookup_decodes = 0;
+};
+
+// Memory held by a loaded model, in bytes. Weights come from the file
+// mapping when llama.cpp mmaps the model, so only the resident part costs RAM.
+struct MemoryUsage {
+    size_t model_bytes = 0;           // tensor data (llama_model_size)
+    size_t model_mapped_bytes = 0;    // size of the model file mapping, 0 if not mapped
+    size_t model_resident_bytes = 0;  // resident pages of that mapping
+    size_t kv_cache_bytes = 0;        // KV cells allocated for the full context
+    size_t kv_used_bytes = 0;         // KV state currently held (llama_state_get_size)
+    size_t compute_bytes = 0;         // estimated output and compute buffers
+    size_t sampler_bytes = 0;         // sampler chains and candidate arrays
+    size_t draft_bytes = 0;           // draft model weights and KV, if loaded
+    size_t vision_bytes = 0;          // vision projector and cached image embeddings
+    int context_size = 0;
+
+    // Bytes this model actually costs: resident weights (all weights when
+    // not mapped) plus everything allocated on the heap.
+    size_t total() const {
+        const size_t weights = model_mapped_bytes > 0 ? model_resident_bytes : model_bytes;
+        return weights + kv_cache_bytes + compute_bytes + sampler_bytes + draft_bytes +
+               vision_bytes;
+    }
+};
+
+// LoRA adapter and scale a KV cache was computed with; no adapter is the base model
+struct LoraSelection {
+    llama_adapter_lora* adapter = nullptr;
+    float scale = 0.0f;
+
+    bool operator==(const LoraSelection& other) const {
+        return adapter == other.adapter && (adapter == nullptr || scale == other.scale);
+    }
+    bool operator!=(const LoraSelection& other) const { return !(*this == other); }
+};
+
+// Image span of a prompt: n_tokens placeholder tokens from start stand for the
+// image's embeddings, so prefix caching treats the same image as the same tokens
+struct PromptImage {
+    size_t start = 0;
+    size_t n_tokens = 0;
+    const mtmd_input_chunk* chunk = nullptr;  // owned by the slot's chunk list
+    std::shared_ptr<const std::vector<float>> embeddings;
+};
+
+// Memory pressure levels, coarsest first (see LlamaCppTextGeneration::trim_memory)
+enum class MemoryPressure {
+    NONE = 0,
+    MODERATE = 1,  // drop caches that are cheap to rebuild
+    LOW = 2,       // also shrink the context
+    CRITICAL = 3,  // caller should unload the model
 };
 
 // Streaming callback: receives token, returns false to cancel
 using TextStreamCallback = std::function<bool(const std::string& token)>;
 
+// =============================================================================
+// GGML BACKEND LOADING
+// =============================================================================
+
+// Loads the ggml backend modules of a dynamic-backend build: the CPU variant
+// best suited to this device, then the GPU module if one was built. Runs
+// once; later calls return the first result. A no-op returning true when
+// the backends are linked in.
+bool load_ggml_backends();
+
+// CPU variant loaded by load_ggml_backends ("android_armv8.2_1", ...), or
+// "builtin" when the CPU backend is linked in
+const char* ggml_cpu_variant();
+
 // =============================================================================
 // FORWARD DECLARATIONS
 // =============================================================================
 
 class LlamaCppTextGeneration;
+struct GenerationSlot;
 
 // =============================================================================
 // LLAMACPP BACKEND
@@ -79,6 +271,7 @@ class LlamaCppBackend {
     void cleanup();
 
     DeviceType get_device_type() const;
+    // Total bytes held by the loaded model (see MemoryUsage::total)
     size_t get_memory_usage() const;
 
     // Get number of threads to use
@@ -115,30 +308,287 @@ class LlamaCppTextGeneration {
     bool generate_stream(const TextGenerationRequest& request, TextStreamCallback callback) {
         return generate_stream(request, callback, nullptr);
     }
+    // A request stopped by one of its time budgets still succeeds;
+    // out_finish_reason tells it apart (see TextGenerationResult)
     bool generate_stream(const TextGenerationRequest& request, TextStreamCallback callback,
-                         int* out_prompt_tokens);
+                         int* out_prompt_tokens, bool* out_cancelled = nullptr,
+                         std::string* out_finish_reason = nullptr);
+    // Runs the requests through the scheduler with up to max_parallel_requests
+    // in flight. on_result is called once per request (serialized, from worker
+    // threads) as each finishes; cancel() reports the rest as "cancelled".
+    bool generate_batch(const std::vector<TextGenerationRequest>& requests,
+                        const std::function<void(size_t, const TextGenerationResult&)>& on_result);
+    // Draws n_samples replies to one request (capped at max_parallel_requests).
+    // The prompt is prefilled once and shared by every sample's sequence;
+    // results carry their log-probability, in submission order.
+    bool generate_samples(const TextGenerationRequest& request, int n_samples,
+                          std::vector<TextGenerationResult>& out_results);
     void cancel();
     nlohmann::json get_model_info() const;
+    SpeculativeStats get_speculative_stats() const;
+    MemoryUsage get_memory_usage();
+    // Exact token count of text under the loaded vocab (no BOS/EOS added), -1 if not ready
+    int count_tokens(const std::string& text);
+    // Layers offloaded to the GPU for the loaded model (0 = CPU only)
+    int gpu_layers() const { return n_gpu_layers_; }
+    // Releases memory for the given pressure level; skipped while generating.
+    // Returns true if anything was released.
+    bool trim_memory(MemoryPressure level);
+
+    // Conversation state: save_state writes the KV cache of the sequence that
+    // last finished a request, with its tokens, to path. restore_state maps
+    // such a file into a free sequence, so a prompt that continues the
+    // conversation only decodes what is new. Both return
+    // RAC_ERROR_BACKEND_BUSY while requests run; out_tokens gets the count.
+    rac_result_t save_state(const std::string& path, int* out_tokens);
+    rac_result_t restore_state(const std::string& path, int* out_tokens);
+
+    // LoRA adapters stay loaded under a name until removed or the model is
+    // unloaded; each request picks one (or the base model), and switching
+    // only changes which adapter the context applies. Requests with
+    // different adapters take turns instead of sharing a batch.
+    rac_result_t load_lora_adapter(const std::string& name, const std::string& path);
+    // Fails with RAC_ERROR_BACKEND_BUSY while a request uses the adapter
+    rac_result_t remove_lora_adapter(const std::string& name);
+    // Adapter for requests that do not name one ("" = base model)
+    rac_result_t set_lora_adapter(const std::string& name, float scale);
+
+    // Pooled embeddings come from a dedicated embedding model when one is
+    // loaded, otherwise from the generation model.
+    bool load_embedding_model(const std::string& model_path);
+    void unload_embedding_model();
+    // Floats per vector written by embed(), 0 if no model is available
+    int embedding_dim();
+    // Writes texts.size() rows of embedding_dim() floats to out, in input order
+    bool embed(const std::vector<std::string>& texts, bool normalize, float* out);
+
+    // Image input needs the model's vision projector (config "mmproj_path",
+    // or an mmproj*.gguf next to the model). Encoded images are cached by
+    // content, so asking again about the same image skips the encoder.
+    bool supports_vision() const { return mtmd_ != nullptr; }
+    // Longer image side requests are resized to (0 = keep)
+    int image_max_edge() const { return image_max_edge_; }
 
    private:
     bool unload_model_internal();
-    std::string build_prompt(const TextGenerationRequest& request);
-    std::string apply_chat_template(const std::vector<std::pair<std::string, std::string>>& messages,
-                                    const std::string& system_prompt, bool add_assistant_token);
+    llama_context_params make_context_params(int n_ctx) const;
+    int choose_gpu_layers(const std::string& model_path, int requested, int n_ctx);
+    size_t kv_cache_size(const llama_model* model, int n_ctx) const;
+    void start_prefetch(const std::string& path);
+    void stop_prefetch();
+    int fit_context_to_budget(int n_ctx, size_t budget_bytes) const;
+    const std::string& build_prompt(const TextGenerationRequest& request);
+    bool tokenize_into(const std::string& text, std::vector<llama_token>& tokens);
+    llama_sampler* sampler_for(const SamplerParams& params);
+    llama_sampler* grammar_for(const std::string& json_schema);
+    void free_grammars();
+    void prepare_token_healing(GenerationSlot& slot);
+    bool ensure_embedding_context_locked();
+    void free_embedding_context_locked();
+
+    // Continuous batching: every request runs on its own sequence and one batch
+    // per step carries prompt chunks and sampled tokens for all of them.
+    void start_scheduler();
+    void stop_scheduler();
+    void scheduler_loop();
+    void admit_pending_locked();
+    bool decode_step();
+    void follow_cpu_budget(bool busy);
+    std::shared_ptr<GenerationSlot> acquire_slot_locked();
+    void release_slot_locked(const std::shared_ptr<GenerationSlot>& slot);
+    void drop_slot_locked(const std::shared_ptr<GenerationSlot>& slot);
+    void recycle_slot_locked(const std::shared_ptr<GenerationSlot>& slot);
+    void sample_slot(GenerationSlot& slot);
+    double token_logprob(int32_t i_logits, llama_token token) const;
+    void fork_branches(GenerationSlot& slot);
+    bool prepare_slot(const TextGenerationRequest& request, GenerationSlot& slot,
+                      int* out_prompt_tokens);
+    void reset_stop_matcher(GenerationSlot& slot, const std::vector<std::string>& request_stops);
+    bool accept_token(GenerationSlot& slot, llama_token token);
+    void finish_slot_locked(GenerationSlot& slot, bool failed);
+    bool check_deadlines_locked(GenerationSlot& slot,
+                                std::chrono::steady_clock::time_point now);
+    void finish_at_deadline_locked(GenerationSlot& slot, const char* reason);
+    int reuse_cached_prefix(llama_seq_id seq_id, const std::vector<llama_token>& tokens);
+    bool generating_locked() const;
+    bool resolve_lora(const TextGenerationRequest& request, LoraSelection* out) const;
+    void apply_lora_locked(const LoraSelection& lora);
+    void free_lora_adapters();
+    void clear_sequence(llama_seq_id seq_id);
+
+    bool load_vision_model(const std::string& model_path, const nlohmann::json& config);
+    void unload_vision_model();
+    void clear_image_cache();
+    const std::string& build_vision_prompt(const TextGenerationRequest& request);
+    bool tokenize_with_images(const std::string& text, const std::vector<ImageInput>& images,
+                              std::vector<llama_token>& tokens, std::vector<PromptImage>& spans,
+                              std::shared_ptr<mtmd_input_chunks>& chunks);
+    std::shared_ptr<const std::vector<float>> encode_image(const mtmd_input_chunk* chunk,
+                                                           const std::string& key);
+    bool decode_image(const PromptImage& image, llama_seq_id seq_id);
+    void resume_before_image(GenerationSlot& slot);
+
+    bool load_draft_model(const std::string& draft_path);
+    void unload_draft_model();
+    bool speculative_step(GenerationSlot& slot);
+    void propose_lookup_draft(GenerationSlot& slot, int max_draft);
+    void verify_lookup_draft(GenerationSlot& slot);
+    void collect_template_stop_sequences();
+    const std::string& apply_chat_template(
+        const std::vector<std::pair<std::string, std::string>>& messages,
+        const std::string& system_prompt, bool add_assistant_token);
 
     LlamaCppBackend* backend_;
     llama_model* model_ = nullptr;
     llama_context* context_ = nullptr;
-    llama_sampler* sampler_ = nullptr;
+
+    // Sampler chains keyed by sampling parameters, built on first use
+    static constexpr size_t kSamplerPoolSize = 4;
+    static constexpr float kDefaultRepetitionPenalty = 1.2f;
+    SamplerParams default_sampling_;
+
+    // Default stop list: generic chat markers plus the model's end-of-generation
+    // token texts; requests append their own.
+    std::vector<std::string> stop_sequences_;
+    std::vector<std::pair<SamplerParams, llama_sampler*>> sampler_pool_;
+
+    // Grammar samplers compiled from JSON schemas, keyed by schema hash, most
+    // recent first. Requests clone one so each sequence has its own parse state.
+    static constexpr size_t kGrammarCacheSize = 8;
+    std::vector<std::pair<uint64_t, llama_sampler*>> grammar_cache_;
+
+    // Token texts by id for token healing, built on first use
+    std::vector<std::string> vocab_pieces_;
+
+    // Prompt formatting buffers, guarded by mutex_ and reused across requests
+    std::string chat_template_;  // model template read at load, empty for the default
+    std::vector<llama_chat_message> chat_messages_;
+    std::vector<std::string> chat_roles_;
+    std::vector<std::pair<std::string, std::string>> prompt_turn_;
+    std::string prompt_text_;
+
+    static constexpr int kMaxParallelSequences = 4;
+    // Shortest prefix worth copying from another sequence's cache
+    static constexpr size_t kMinSharedPrefix = 16;
+    int n_parallel_ = kMaxParallelSequences;
+
+    // Tokens held in the KV cache per sequence, kept across requests so a new
+    // prompt only decodes the suffix that differs from its sequence's cache.
+    std::vector<llama_token> seq_tokens_[kMaxParallelSequences];
+    bool seq_busy_[kMaxParallelSequences] = {};
+    // Sequence of the last request that finished, -1 if none (saved by save_state)
+    llama_seq_id last_seq_ = -1;
+    // Adapter each sequence's cache was computed with; a cache only serves
+    // requests with the same one
+    LoraSelection seq_lora_[kMaxParallelSequences];
+
+    llama_batch batch_ = {};
+    std::thread scheduler_thread_;
+    std::mutex scheduler_mutex_;
+    std::condition_variable scheduler_cv_;
+    std::deque<std::shared_ptr<GenerationSlot>> pending_slots_;
+    std::vector<std::shared_ptr<GenerationSlot>> active_slots_;
+    // Finished slots keep their token and text buffers for the next request
+    std::vector<std::shared_ptr<GenerationSlot>> free_slots_;
+    bool scheduler_stop_ = false;
+
+    // Prefill cost per prompt token, averaged over recent prefill steps (0 =
+    // not measured yet), for projecting max_prefill_ms (scheduler thread only)
+    double prefill_ms_per_token_ = 0.0;
+    // Tokens to decode before min_tokens_per_second is judged
+    static constexpr int kMinRateTokens = 8;
+
+    // LLM stage of the shared CPU budget, held while requests are in flight
+    // (scheduler thread only)
+    bool cpu_budget_held_ = false;
+    int applied_threads_ = 0;
+
+    // LoRA adapters by name (mutex_) and the one the context applies now
+    // (scheduler_mutex_)
+    struct LoraAdapter {
+        std::string name;
+        std::string path;
+        llama_adapter_lora* adapter = nullptr;
+    };
+    std::vector<LoraAdapter> lora_adapters_;
+    std::string default_lora_;
+    float default_lora_scale_ = 0.0f;
+    LoraSelection applied_lora_;
+
+    // Optional draft model for speculative decoding (config "draft_model_path")
+    llama_model* draft_model_ = nullptr;
+    llama_context* draft_context_ = nullptr;
+    llama_sampler* draft_sampler_ = nullptr;
+    llama_batch draft_batch_ = {};
+    std::string draft_model_path_;
+    std::vector<llama_token> draft_tokens_;  // tokens held in the draft KV cache
+    std::vector<llama_token> drafted_;       // scratch for the current speculative step
+    int n_draft_ = 4;
+    std::atomic<int64_t> spec_drafted_{0};
+    std::atomic<int64_t> spec_accepted_{0};
+    std::atomic<int64_t> spec_target_decodes_{0};
+    std::atomic<int64_t> spec_tokens_emitted_{0};
+
+    // Prompt lookup: n-gram lengths matched, and tokens proposed per step
+    static constexpr int kLookupMaxNgram = 3;
+    static constexpr int kLookupMinNgram = 2;
+    static constexpr int kLookupMaxDraft = 8;
+    std::atomic<int64_t> lookup_drafted_{0};
+    std::atomic<int64_t> lookup_accepted_{0};
+    std::atomic<int64_t> lookup_decodes_{0};
+
+    // Background page-cache warm-up for load_mode 1 (mmap + prefetch)
+    std::thread prefetch_thread_;
+    std::atomic<bool> prefetch_stop_{false};
+
+    // Embedding context (embeddings on, pooled per sequence), created on first
+    // use. embed_model_ is null when it shares the generation model.
+    static constexpr int kEmbedContextSize = 2048;
+    static constexpr int kMaxEmbedSequences = 16;
+    llama_model* embed_model_ = nullptr;
+    llama_context* embed_context_ = nullptr;
+    llama_batch embed_batch_ = {};
+    std::vector<llama_token> embed_tokens_;
+    std::mutex embed_mutex_;
+
+    // Vision projector and encoded images by content key, most recent first,
+    // within image_cache_budget_ bytes. Images are encoded on the calling
+    // thread under mutex_; the scheduler only decodes the embeddings.
+    static constexpr size_t kDefaultImageCacheBytes = 64u * 1024 * 1024;
+    static constexpr int kDefaultImageMaxEdge = 1024;
+    struct CachedImage {
+        std::string key;
+        std::shared_ptr<const std::vector<float>> embeddings;
+    };
+    mtmd_context* mtmd_ = nullptr;
+    std::string mmproj_path_;
+    std::vector<CachedImage> image_cache_;
+    size_t image_cache_bytes_ = 0;
+    size_t image_cache_budget_ = kDefaultImageCacheBytes;
+    int image_max_edge_ = kDefaultImageMaxEdge;
+    std::atomic<int64_t> image_cache_hits_{0};
+    std::atomic<int64_t> image_encodes_{0};
+
+    // Bumped by cancel() so batch workers stop picking up new requests
+    std::atomic<uint64_t> cancel_epoch_{0};
 
     bool model_loaded_ = false;
-    std::atomic<bool> cancel_requested_{false};
 
     std::string model_path_;
     nlohmann::json model_config_;
 
     int context_size_ = 0;
+    int n_gpu_layers_ = 0;
+
+    // KV cache element types and flash attention ("kv_cache_type_k/v",
+    // "flash_attention"); a quantized V cache requires flash attention.
+    ggml_type type_k_ = GGML_TYPE_F16;
+    ggml_type type_v_ = GGML_TYPE_F16;
+    llama_flash_attn_type flash_attn_type_ = LLAMA_FLASH_ATTN_TYPE_AUTO;
+    std::string gpu_device_name_;
     int max_default_context_ = 8192;
+    // Smallest context trim_memory() shrinks to
+    static constexpr int kMinTrimmedContext = 1024;
 
     float temperature_ = 0.8f;
     float top_p_ = 0.95f;
@@ -0,0 +1,157 @@
+/**
+ * LlamaCPP Backend - CPU Variant Selection
+ *
+ * Android arm64 builds with RAC_LLAMACPP_CPU_VARIANTS compile ggml's CPU
+ * kernels once per feature level (GGML_CPU_ALL_VARIANTS) as modules named
+ * libggml-cpu-<variant>.so. The kernel's HWCAP bits rank the variants this
+ * device can run; each candidate's own ggml_backend_score confirms it
+ * before it is registered, so a variant missing from the build or
+ * mis-ranked here falls through to the next one instead of faulting on an
+ * unsupported instruction. Modules are opened by file name, which the
+ * dynamic linker resolves from the app's native library directory.
+ */
+
+#include "llamacpp_backend.h"
+
+#include "ggml-backend.h"
+
+#include <mutex>
+#include <string>
+
+#if defined(RAC_LLAMACPP_BACKEND_DL)
+#include <dlfcn.h>
+#include <sys/auxv.h>
+#endif
+
+#include "rac/core/rac_logger.h"
+
+#define LOGI(...) RAC_LOG_INFO("LLM.LlamaCpp", __VA_ARGS__)
+#define LOGE(...) RAC_LOG_ERROR("LLM.LlamaCpp", __VA_ARGS__)
+
+namespace runanywhere {
+
+namespace {
+
+const char* g_cpu_variant = "builtin";
+
+#if defined(RAC_LLAMACPP_BACKEND_DL)
+
+// HWCAP bits from <asm/hwcap.h>, spelled out for NDKs that predate them
+constexpr unsigned long kHwcapAsimdHp = 1UL << 10;
+constexpr unsigned long kHwcapAsimdDp = 1UL << 20;
+constexpr unsigned long kHwcapSve = 1UL << 22;
+constexpr unsigned long kHwcap2Sve2 = 1UL << 1;
+constexpr unsigned long kHwcap2I8mm = 1UL << 13;
+
+enum CpuFeature : unsigned {
+    kDotProd = 1 << 0,
+    kFp16 = 1 << 1,
+    kI8mm = 1 << 2,
+    kSve = 1 << 3,
+    kSve2 = 1 << 4,
+};
+
+struct CpuVariant {
+    const char* name;
+    unsigned required;
+};
+
+// ggml's arm64 variants, best first
+#if defined(__ANDROID__)
+constexpr CpuVariant kVariants[] = {
+    {"android_armv9.0_1", kDotProd | kFp16 | kI8mm | kSve | kSve2},
+    {"android_armv8.6_1", kDotProd | kFp16 | kI8mm},
+    {"android_armv8.2_2", kDotProd | kFp16},
+    {"android_armv8.2_1", kDotProd},
+    {"android_armv8.0_1", 0},
+};
+#else
+constexpr CpuVariant kVariants[] = {
+    {"armv8.6_2", kDotProd | kFp16 | kI8mm | kSve | kSve2},
+    {"armv8.6_1", kDotProd | kFp16 | kI8mm | kSve},
+    {"armv8.2_3", kDotProd | kFp16 | kSve},
+    {"armv8.2_2", kDotProd | kFp16},
+    {"armv8.2_1", kDotProd},
+    {"armv8.0_1", 0},
+};
+#endif
+
+unsigned detect_cpu_features() {
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    const unsigned long hwcap2 = getauxval(AT_HWCAP2);
+    unsigned features = 0;
+    features |= (hwcap & kHwcapAsimdDp) ? kDotProd : 0;
+    features |= (hwcap & kHwcapAsimdHp) ? kFp16 : 0;
+    features |= (hwcap & kHwcapSve) ? kSve : 0;
+    features |= (hwcap2 & kHwcap2I8mm) ? kI8mm : 0;
+    features |= (hwcap2 & kHwcap2Sve2) ? kSve2 : 0;
+    return features;
+}
+
+// Registers the variant if its module exists and reports this CPU as supported
+bool load_cpu_variant(const char* name) {
+    const std::string file = std::string("libggml-cpu-") + name + ".so";
+    void* module = dlopen(file.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!module) {
+        return false;
+    }
+    using ScoreFn = int (*)();
+    const auto score = reinterpret_cast<ScoreFn>(dlsym(module, "ggml_backend_score"));
+    const bool supported = !score || score() > 0;
+    dlclose(module);
+    return supported && ggml_backend_load(file.c_str()) != nullptr;
+}
+
+bool load_backends_once() {
+    const unsigned features = detect_cpu_features();
+    LOGI("CPU features: dotprod=%d fp16=%d i8mm=%d sve=%d sve2=%d", (features & kDotProd) != 0,
+         (features & kFp16) != 0, (features & kI8mm) != 0, (features & kSve) != 0,
+         (features & kSve2) != 0);
+
+    bool loaded = false;
+    for (const CpuVariant& variant : kVariants) {
+        if ((features & variant.required) == variant.required && load_cpu_variant(variant.name)) {
+            g_cpu_variant = variant.name;
+            loaded = true;
+            break;
+        }
+    }
+    if (!loaded) {
+        LOGE("No ggml CPU backend module could be loaded");
+        return false;
+    }
+    LOGI("Loaded ggml CPU variant %s", g_cpu_variant);
+
+#if defined(RAC_LLAMACPP_GPU_MODULE)
+    // Optional: without it the CPU variant still serves every request
+    if (ggml_backend_load(RAC_LLAMACPP_GPU_MODULE)) {
+        LOGI("Loaded ggml GPU module %s", RAC_LLAMACPP_GPU_MODULE);
+    } else {
+        LOGI("ggml GPU module %s not loadable; running on CPU", RAC_LLAMACPP_GPU_MODULE);
+    }
+#endif
+    return true;
+}
+
+#else
+
+bool load_backends_once() {
+    return true;
+}
+
+#endif  // RAC_LLAMACPP_BACKEND_DL
+
+}  // namespace
+
+bool load_ggml_backends() {
+    static std::once_flag once;
+    static bool loaded = false;
+    std::call_once(once, [] { loaded = load_backends_once(); });
+    return loaded;
+}
+
+const char* ggml_cpu_variant() {
+    return g_cpu_variant;
+}
+
+}  // namespace runanywhere
@@ -0,0 +1,401 @@
+/**
+ * LlamaCPP Backend - Image Input
+ *
+ * Multimodal GGUF models ship their vision encoder as a separate projector
+ * (mmproj) file that llama.cpp's mtmd library runs. An image in the prompt
+ * becomes a run of embeddings the language model reads in place of tokens.
+ *
+ * Encoding is the slow part, so embeddings are cached by the image's content
+ * hash. In the prompt, each image is a run of placeholder tokens derived from
+ * the same hash; the KV prefix cache then treats a repeated image like
+ * repeated text, and a follow-up question about it decodes only what is new.
+ */
+
+#include "llamacpp_backend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <string>
+
+#include <dirent.h>
+#include <strings.h>
+
+#if RAC_LLAMACPP_VISION
+#include "mtmd-helper.h"
+#include "mtmd.h"
+#endif
+
+#include "rac/core/rac_logger.h"
+#include "rac/core/rac_sha256.h"
+#include "rac/core/rac_trace.h"
+
+#define LOGI(...) RAC_LOG_INFO("LLM.LlamaCpp", __VA_ARGS__)
+#define LOGE(...) RAC_LOG_ERROR("LLM.LlamaCpp", __VA_ARGS__)
+
+namespace runanywhere {
+
+void LlamaCppTextGeneration::clear_image_cache() {
+    image_cache_.clear();
+    image_cache_bytes_ = 0;
+}
+
+#if RAC_LLAMACPP_VISION
+
+// =============================================================================
+// VISION PROJECTOR
+// =============================================================================
+
+// First mmproj*.gguf by name in the model's directory, "" if there is none
+static std::string find_mmproj(const std::string& model_path) {
+    const size_t slash = model_path.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : model_path.substr(0, slash);
+    DIR* listing = opendir(dir.c_str());
+    if (!listing) {
+        return "";
+    }
+    std::string found;
+    while (const dirent* entry = readdir(listing)) {
+        const std::string name = entry->d_name;
+        if (name.find("mmproj") != std::string::npos && name.size() > 5 &&
+            name.compare(name.size() - 5, 5, ".gguf") == 0 && (found.empty() || name < found)) {
+            found = name;
+        }
+    }
+    closedir(listing);
+    return found.empty() ? "" : dir + "/" + found;
+}
+
+// Called from load_model with mutex_ held, before the scheduler starts
+bool LlamaCppTextGeneration::load_vision_model(const std::string& model_path,
+                                               const nlohmann::json& config) {
+    image_cache_budget_ = kDefaultImageCacheBytes;
+    if (config.contains("image_cache_mb")) {
+        image_cache_budget_ =
+            static_cast<size_t>(std::max(0, config["image_cache_mb"].get<int>())) * 1024 * 1024;
+    }
+    image_max_edge_ = kDefaultImageMaxEdge;
+    if (config.contains("image_max_edge")) {
+        image_max_edge_ = std::max(0, config["image_max_edge"].get<int>());
+    }
+
+    const std::string path = config.contains("mmproj_path")
+                                 ? config["mmproj_path"].get<std::string>()
+                                 : find_mmproj(model_path);
+    if (path.empty()) {
+        return false;
+    }
+
+    mtmd_context_params params = mtmd_context_params_default();
+    params.use_gpu = n_gpu_layers_ != 0;
+    params.n_threads = backend_->get_num_threads();
+    params.print_timings = false;
+    mtmd_ = mtmd_init_from_file(path.c_str(), model_, params);
+    if (!mtmd_) {
+        LOGE("Failed to load vision projector: %s", path.c_str());
+        return false;
+    }
+    if (!mtmd_support_vision(mtmd_)) {
+        LOGE("Projector has no vision encoder, image input is off: %s", path.c_str());
+        unload_vision_model();
+        return false;
+    }
+    // Images with 2-D (M-RoPE) positions take fewer positions than tokens,
+    // while the scheduler places every prompt token at its index
+    if (mtmd_decode_use_mrope(mtmd_)) {
+        LOGE("Projectors with M-RoPE image positions are not supported: %s", path.c_str());
+        unload_vision_model();
+        return false;
+    }
+
+    mmproj_path_ = path;
+    image_cache_hits_ = 0;
+    image_encodes_ = 0;
+    LOGI("Vision projector loaded: %s (image cache %zu MB, max edge %d)", path.c_str(),
+         image_cache_budget_ / (1024 * 1024), image_max_edge_);
+    return true;
+}
+
+void LlamaCppTextGeneration::unload_vision_model() {
+    clear_image_cache();
+    if (mtmd_) {
+        mtmd_free(mtmd_);
+        mtmd_ = nullptr;
+    }
+    mmproj_path_.clear();
+}
+
+// =============================================================================
+// IMAGE PROMPTS
+// =============================================================================
+
+// Puts one media marker per image ahead of the last user turn when the
+// request has none of its own, then formats it like build_prompt
+const std::string& LlamaCppTextGeneration::build_vision_prompt(
+    const TextGenerationRequest& request) {
+    const std::string marker = mtmd_default_marker();
+    bool marked = request.prompt.find(marker) != std::string::npos ||
+                  request.system_prompt.find(marker) != std::string::npos;
+    for (const auto& message : request.messages) {
+        marked = marked || message.second.find(marker) != std::string::npos;
+    }
+    if (marked) {
+        return build_prompt(request);
+    }
+
+    std::string markers;
+    for (size_t i = 0; i < request.images.size(); i++) {
+        markers += marker;
+    }
+    markers += "\n";
+
+    std::vector<std::pair<std::string, std::string>> messages = request.messages;
+    if (messages.empty()) {
+        messages.emplace_back("user", request.prompt);
+    }
+    auto is_user = [](const std::pair<std::string, std::string>& message) {
+        return strcasecmp(message.first.c_str(), "user") == 0;
+    };
+    auto turn = std::find_if(messages.rbegin(), messages.rend(), is_user);
+    if (turn == messages.rend()) {
+        messages.emplace_back("user", "");
+        turn = messages.rbegin();
+    }
+    turn->second.insert(0, markers);
+    apply_chat_template(messages, request.system_prompt, true);
+    return prompt_text_;
+}
+
+// Image content key: dimensions plus the SHA-256 of the pixels
+static std::string image_key(const ImageInput& image) {
+    rac_sha256_t sha;
+    rac_sha256_init(&sha);
+    rac_sha256_update(&sha, image.rgb.data(), image.rgb.size());
+    uint8_t digest[RAC_SHA256_DIGEST_SIZE];
+    rac_sha256_final(&sha, digest);
+    char hex[RAC_SHA256_HEX_LENGTH + 1];
+    rac_sha256_to_hex(digest, hex);
+    return std::to_string(image.width) + "x" + std::to_string(image.height) + ":" + hex;
+}
+
+// Placeholder token for position i of an image chunk. Values sit far below
+// any vocab id and LLAMA_TOKEN_NULL, so they never match a text token.
+static llama_token placeholder_token(uint64_t seed, size_t i) {
+    uint64_t z = seed + (i + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return static_cast<llama_token>(INT32_MIN + static_cast<int32_t>(z >> 34));
+}
+
+static uint64_t fnv1a(const std::string& text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char ch : text) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Tokenizes text around its media markers. Text chunks are copied; each image
+// chunk becomes a span of placeholder tokens with its embeddings, from the
+// cache or the encoder. Caller holds mutex_.
+bool LlamaCppTextGeneration::tokenize_with_images(const std::string& text,
+                                                  const std::vector<ImageInput>& images,
+                                                  std::vector<llama_token>& tokens,
+                                                  std::vector<PromptImage>& spans,
+                                                  std::shared_ptr<mtmd_input_chunks>& chunks) {
+    tokens.clear();
+    spans.clear();
+    if (!mtmd_) {
+        LOGE("Image input needs a vision projector (mmproj_path)");
+        return false;
+    }
+
+    std::vector<std::unique_ptr<mtmd_bitmap, void (*)(mtmd_bitmap*)>> bitmaps;
+    std::vector<const mtmd_bitmap*> inputs;
+    for (const auto& image : images) {
+        if (image.width <= 0 || image.height <= 0 ||
+            image.rgb.size() != static_cast<size_t>(image.width) * image.height * 3) {
+            LOGE("Invalid image: %dx%d with %zu bytes", image.width, image.height,
+                 image.rgb.size());
+            return false;
+        }
+        mtmd_bitmap* bitmap = mtmd_bitmap_init(static_cast<uint32_t>(image.width),
+                                               static_cast<uint32_t>(image.height),
+                                               image.rgb.data());
+        if (!bitmap) {
+            return false;
+        }
+        bitmaps.emplace_back(bitmap, mtmd_bitmap_free);
+        mtmd_bitmap_set_id(bitmap, image_key(image).c_str());
+        inputs.push_back(bitmap);
+    }
+
+    chunks.reset(mtmd_input_chunks_init(), mtmd_input_chunks_free);
+    const mtmd_input_text input = {text.c_str(), true, true};
+    const int32_t status =
+        mtmd_tokenize(mtmd_, chunks.get(), &input, inputs.data(), inputs.size());
+    if (status == 1) {
+        LOGE("Prompt has %zu images but a different number of media markers", images.size());
+        return false;
+    }
+    if (status != 0) {
+        LOGE("Failed to tokenize image prompt: %d", status);
+        return false;
+    }
+
+    // The encoder may split a large image into several chunks (overview and
+    // tiles); each is keyed by its position within the image
+    std::string image_id;
+    int ordinal = 0;
+    const size_t n_chunks = mtmd_input_chunks_size(chunks.get());
+    for (size_t i = 0; i < n_chunks; i++) {
+        const mtmd_input_chunk* chunk = mtmd_input_chunks_get(chunks.get(), i);
+        const mtmd_input_chunk_type type = mtmd_input_chunk_get_type(chunk);
+        if (type == MTMD_INPUT_CHUNK_TYPE_TEXT) {
+            size_t n_text = 0;
+            const llama_token* text_tokens = mtmd_input_chunk_get_tokens_text(chunk, &n_text);
+            tokens.insert(tokens.end(), text_tokens, text_tokens + n_text);
+            continue;
+        }
+        if (type != MTMD_INPUT_CHUNK_TYPE_IMAGE) {
+            LOGE("Only image input is supported");
+            return false;
+        }
+
+        const char* id = mtmd_input_chunk_get_id(chunk);
+        ordinal = id && image_id == id ? ordinal + 1 : 0;
+        image_id = id ? id : "";
+        const std::string key = image_id + "#" + std::to_string(ordinal);
+
+        PromptImage span;
+        span.start = tokens.size();
+        span.n_tokens = mtmd_input_chunk_get_n_tokens(chunk);
+        span.chunk = chunk;
+        span.embeddings = encode_image(chunk, key);
+        if (!span.embeddings) {
+            return false;
+        }
+        const uint64_t seed = fnv1a(key);
+        for (size_t t = 0; t < span.n_tokens; t++) {
+            tokens.push_back(placeholder_token(seed, t));
+        }
+        spans.push_back(std::move(span));
+    }
+
+    // Sampling needs the logits of a text token
+    if (!spans.empty() && spans.back().start + spans.back().n_tokens == tokens.size()) {
+        LOGE("Prompt must not end with an image");
+        return false;
+    }
+    LOGI("Image prompt: %zu tokens, %zu image chunks", tokens.size(), spans.size());
+    return true;
+}
+
+// Embeddings of an image chunk, from the cache or the encoder. The encoder
+// runs on the calling thread while the scheduler keeps decoding.
+std::shared_ptr<const std::vector<float>> LlamaCppTextGeneration::encode_image(
+    const mtmd_input_chunk* chunk, const std::string& key) {
+    auto it = std::find_if(image_cache_.begin(), image_cache_.end(),
+                           [&](const CachedImage& entry) { return entry.key == key; });
+    if (it != image_cache_.end()) {
+        std::rotate(image_cache_.begin(), it, it + 1);
+        image_cache_hits_++;
+        return image_cache_.front().embeddings;
+    }
+
+    RAC_TRACE_SCOPE("LLM.encode_image");
+    const auto start = std::chrono::steady_clock::now();
+    if (mtmd_encode_chunk(mtmd_, chunk) != 0) {
+        LOGE("Image encoding failed");
+        return nullptr;
+    }
+    const size_t n_floats =
+        mtmd_input_chunk_get_n_tokens(chunk) * static_cast<size_t>(llama_model_n_embd(model_));
+    const float* output = mtmd_get_output_embd(mtmd_);
+    auto embeddings = std::make_shared<const std::vector<float>>(output, output + n_floats);
+    image_encodes_++;
+    LOGI("Encoded image: %zu tokens in %.0f ms", mtmd_input_chunk_get_n_tokens(chunk),
+         std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+             .count());
+
+    const size_t bytes = n_floats * sizeof(float);
+    if (bytes <= image_cache_budget_) {
+        image_cache_.insert(image_cache_.begin(), {key, embeddings});
+        image_cache_bytes_ += bytes;
+        while (image_cache_bytes_ > image_cache_budget_) {
+            image_cache_bytes_ -= image_cache_.back().embeddings->size() * sizeof(float);
+            image_cache_.pop_back();
+        }
+    }
+    return embeddings;
+}
+
+// Decodes an image's embeddings at its prompt positions (scheduler thread)
+bool LlamaCppTextGeneration::decode_image(const PromptImage& image, llama_seq_id seq_id) {
+    RAC_TRACE_SCOPE("LLM.decode_image");
+    llama_pos n_past = 0;
+    // The helper only reads the embeddings
+    const int32_t status = mtmd_helper_decode_image_chunk(
+        mtmd_, context_, image.chunk, const_cast<float*>(image.embeddings->data()),
+        static_cast<llama_pos>(image.start), seq_id,
+        static_cast<int32_t>(llama_n_batch(context_)), &n_past);
+    if (status != 0) {
+        LOGE("Failed to decode image of %zu tokens: %d", image.n_tokens, status);
+        return false;
+    }
+    return true;
+}
+
+#else  // !RAC_LLAMACPP_VISION
+
+bool LlamaCppTextGeneration::load_vision_model(const std::string& model_path,
+                                               const nlohmann::json& config) {
+    (void)model_path;
+    if (config.contains("mmproj_path") && !config["mmproj_path"].get<std::string>().empty()) {
+        LOGE("Built without RAC_LLAMACPP_VISION; ignoring mmproj_path");
+    }
+    return false;
+}
+
+void LlamaCppTextGeneration::unload_vision_model() {
+    clear_image_cache();
+}
+
+const std::string& LlamaCppTextGeneration::build_vision_prompt(
+    const TextGenerationRequest& request) {
+    return build_prompt(request);
+}
+
+bool LlamaCppTextGeneration::tokenize_with_images(const std::string& text,
+                                                  const std::vector<ImageInput>& images,
+                                                  std::vector<llama_token>& tokens,
+                                                  std::vector<PromptImage>& spans,
+                                                  std::shared_ptr<mtmd_input_chunks>& chunks) {
+    (void)text;
+    (void)images;
+    (void)tokens;
+    (void)spans;
+    (void)chunks;
+    LOGE("Built without RAC_LLAMACPP_VISION; image input is not available");
+    return false;
+}
+
+std::shared_ptr<const std::vector<float>> LlamaCppTextGeneration::encode_image(
+    const mtmd_input_chunk* chunk, const std::string& key) {
+    (void)chunk;
+    (void)key;
+    return nullptr;
+}
+
+bool LlamaCppTextGeneration::decode_image(const PromptImage& image, llama_seq_id seq_id) {
+    (void)image;
+    (void)seq_id;
+    return false;
+}
+
+#endif  // RAC_LLAMACPP_VISION
+
+}  // namespace runanywhere
@@ -8,12 +8,16 @@
 
 #include "rac_llm_llamacpp.h"
 
+#include "llamacpp_backend.h"
+
 #include <cstdlib>
 #include <cstring>
 #include <mutex>
+#include <string>
 
 #include <nlohmann/json.hpp>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_core.h"
 #include "rac/core/rac_error.h"
 #include "rac/core/rac_logger.h"
@@ -86,7 +90,7 @@ static rac_result_t llamacpp_vtable_get_info(void* impl, rac_llm_info_t* out_inf
             } catch (...) {
                 // JSON parse error - context_length remains 0
             }
-            free(json_str);
+            rac_free(json_str);
         }
     }
 
@@ -109,6 +113,68 @@ static void llamacpp_vtable_destroy(void* impl) {
     rac_llm_llamacpp_destroy(impl);
 }
 
+// Memory usage
+static rac_result_t llamacpp_vtable_get_memory_usage(void* impl,
+                                                     rac_llm_memory_usage_t* out_usage) {
+    return rac_llm_llamacpp_get_memory_usage(impl, out_usage);
+}
+
+// Trim memory
+static rac_result_t llamacpp_vtable_trim_memory(void* impl, rac_llm_memory_pressure_t level) {
+    return rac_llm_llamacpp_trim_memory(impl, level);
+}
+
+// Count tokens
+static rac_result_t llamacpp_vtable_count_tokens(void* impl, const char* text, int32_t* out_count) {
+    return rac_llm_llamacpp_count_tokens(impl, text, out_count);
+}
+
+// Conversation state
+static rac_result_t llamacpp_vtable_save_state(void* impl, const char* path,
+                                               int32_t* out_token_count) {
+    return rac_llm_llamacpp_save_state(impl, path, out_token_count);
+}
+
+static rac_result_t llamacpp_vtable_restore_state(void* impl, const char* path,
+                                                  int32_t* out_token_count) {
+    return rac_llm_llamacpp_restore_state(impl, path, out_token_count);
+}
+
+// LoRA adapters
+static rac_result_t llamacpp_vtable_load_lora(void* impl, const char* name, const char* path) {
+    return rac_llm_llamacpp_load_lora(impl, name, path);
+}
+
+static rac_result_t llamacpp_vtable_remove_lora(void* impl, const char* name) {
+    return rac_llm_llamacpp_remove_lora(impl, name);
+}
+
+static rac_result_t llamacpp_vtable_set_lora(void* impl, const char* name, float scale) {
+    return rac_llm_llamacpp_set_lora(impl, name, scale);
+}
+
+// Batch generate
+static rac_result_t llamacpp_vtable_generate_batch(void* impl, const char* const* prompts,
+                                                   size_t num_prompts,
+                                                   const rac_llm_options_t* options,
+                                                   rac_llm_batch_callback_fn callback,
+                                                   void* user_data) {
+    return rac_llm_llamacpp_generate_batch(impl, prompts, num_prompts, options, callback,
+                                           user_data);
+}
+
+// Parallel samples over one prefill
+static rac_result_t llamacpp_vtable_generate_samples(void* impl, const char* prompt,
+                                                     const rac_llm_options_t* options,
+                                                     rac_llm_samples_t* out_samples) {
+    return rac_llm_llamacpp_generate_samples(impl, prompt, options, out_samples);
+}
+
+static rac_result_t llamacpp_vtable_get_stop_reason(void* impl,
+                                                    rac_llm_stop_reason_t* out_reason) {
+    return rac_llm_llamacpp_get_stop_reason(impl, out_reason);
+}
+
 // Static vtable for LlamaCpp
 static const rac_llm_service_ops_t g_llamacpp_ops = {
     .initialize = llamacpp_vtable_initialize,
@@ -118,6 +184,17 @@ static const rac_llm_service_ops_t g_llamacpp_ops = {
     .cancel = llamacpp_vtable_cancel,
     .cleanup = llamacpp_vtable_cleanup,
     .destroy = llamacpp_vtable_destroy,
+    .get_memory_usage = llamacpp_vtable_get_memory_usage,
+    .trim_memory = llamacpp_vtable_trim_memory,
+    .count_tokens = llamacpp_vtable_count_tokens,
+    .generate_batch = llamacpp_vtable_generate_batch,
+    .save_state = llamacpp_vtable_save_state,
+    .restore_state = llamacpp_vtable_restore_state,
+    .load_lora = llamacpp_vtable_load_lora,
+    .remove_lora = llamacpp_vtable_remove_lora,
+    .set_lora = llamacpp_vtable_set_lora,
+    .generate_samples = llamacpp_vtable_generate_samples,
+    .get_stop_reason = llamacpp_vtable_get_stop_reason,
 };
 
 // =============================================================================
@@ -206,16 +283,58 @@ rac_handle_t llamacpp_create_service(const rac_service_request_t* request, void*
 
     RAC_LOG_INFO(LOG_CAT, "Creating LlamaCPP service for: %s", model_path);
 
+    // Backend options forwarded from the component (see rac_llm_create_with_config)
+    rac_llm_llamacpp_config_t config = RAC_LLM_LLAMACPP_CONFIG_DEFAULT;
+    const rac_llm_llamacpp_config_t* config_ptr = nullptr;
+    std::string kv_cache_type_k;
+    std::string kv_cache_type_v;
+    std::string mmproj_path;
+    if (request->config_json != nullptr) {
+        try {
+            auto json = nlohmann::json::parse(request->config_json);
+            auto read_int = [&json](const char* key, int32_t* out) {
+                if (json.contains(key) && json[key].is_number_integer()) {
+                    *out = json[key].get<int32_t>();
+                }
+            };
+            read_int("load_mode", &config.load_mode);
+            read_int("num_threads", &config.num_threads);
+            read_int("context_size", &config.context_size);
+            read_int("batch_size", &config.batch_size);
+            read_int("gpu_layers", &config.gpu_layers);
+            read_int("flash_attention", &config.flash_attention);
+            read_int("memory_budget_mb", &config.memory_budget_mb);
+            read_int("image_cache_mb", &config.image_cache_mb);
+            read_int("image_max_edge", &config.image_max_edge);
+            if (json.contains("kv_cache_type_k") && json["kv_cache_type_k"].is_string()) {
+                kv_cache_type_k = json["kv_cache_type_k"].get<std::string>();
+                config.kv_cache_type_k = kv_cache_type_k.c_str();
+            }
+            if (json.contains("kv_cache_type_v") && json["kv_cache_type_v"].is_string()) {
+                kv_cache_type_v = json["kv_cache_type_v"].get<std::string>();
+                config.kv_cache_type_v = kv_cache_type_v.c_str();
+            }
+            if (json.contains("mmproj_path") && json["mmproj_path"].is_string()) {
+                mmproj_path = json["mmproj_path"].get<std::string>();
+                config.mmproj_path = mmproj_path.c_str();
+            }
+            config_ptr = &config;
+        } catch (...) {
+            RAC_LOG_WARNING(LOG_CAT, "Ignoring invalid service config JSON");
+        }
+    }
+
     // Create backend-specific handle
     rac_handle_t backend_handle = nullptr;
-    rac_result_t result = rac_llm_llamacpp_create(model_path, nullptr, &backend_handle);
+    rac_result_t result = rac_llm_llamacpp_create(model_path, config_ptr, &backend_handle);
     if (result != RAC_SUCCESS) {
         RAC_LOG_ERROR(LOG_CAT, "Failed to create LlamaCPP backend: %d", result);
         return nullptr;
     }
 
     // Allocate service struct with vtable
-    auto* service = static_cast<rac_llm_service_t*>(malloc(sizeof(rac_llm_service_t)));
+    auto* service = static_cast<rac_llm_service_t*>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, sizeof(rac_llm_service_t)));
     if (!service) {
         rac_llm_llamacpp_destroy(backend_handle);
         return nullptr;
@@ -223,7 +342,9 @@ rac_handle_t llamacpp_create_service(const rac_service_request_t* request, void*
 
     service->ops = &g_llamacpp_ops;
     service->impl = backend_handle;
-    service->model_id = request->identifier ? strdup(request->identifier) : nullptr;
+    service->model_id =
+        request->identifier ? rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, request->identifier)
+                            : nullptr;
 
     RAC_LOG_INFO(LOG_CAT, "LlamaCPP service created successfully");
     return service;
@@ -245,6 +366,11 @@ rac_result_t rac_backend_llamacpp_register(void) {
         return RAC_ERROR_MODULE_ALREADY_REGISTERED;
     }
 
+    // Dynamic-backend builds have no CPU kernels until a variant is loaded
+    if (!runanywhere::load_ggml_backends()) {
+        return RAC_ERROR_BACKEND_INIT_FAILED;
+    }
+
     // Register module
     rac_module_info_t module_info = {};
     module_info.id = state.module_id;
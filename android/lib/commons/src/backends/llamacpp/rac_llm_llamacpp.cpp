@@ -12,10 +12,13 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "llamacpp_backend.h"
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_error.h"
+#include "rac/core/rac_image_kernels.h"
 #include "rac/infrastructure/events/rac_events.h"
 
 // =============================================================================
@@ -30,6 +33,98 @@ struct rac_llm_llamacpp_handle_impl {
     rac_llm_llamacpp_handle_impl() : backend(nullptr), text_gen(nullptr) {}
 };
 
+// Maps RAC options onto a backend request
+static runanywhere::TextGenerationRequest build_request(const char* prompt,
+                                                        const rac_llm_options_t* options) {
+    runanywhere::TextGenerationRequest request;
+    request.prompt = prompt;
+    if (options != nullptr) {
+        request.max_tokens = options->max_tokens;
+        request.temperature = options->temperature;
+        request.top_p = options->top_p;
+        if (options->json_schema != nullptr) {
+            request.json_schema = options->json_schema;
+        }
+        request.token_healing = options->token_healing == RAC_TRUE;
+        request.prompt_lookup = options->prompt_lookup == RAC_TRUE;
+        request.max_prefill_ms = options->max_prefill_ms;
+        request.max_total_ms = options->max_total_ms;
+        request.min_tokens_per_second = options->min_tokens_per_second;
+        if (options->lora_adapter != nullptr) {
+            request.use_default_lora = false;
+            request.lora_adapter = options->lora_adapter;
+            request.lora_scale = options->lora_scale;
+        }
+        // Handle stop sequences if available
+        if (options->stop_sequences != nullptr && options->num_stop_sequences > 0) {
+            for (int32_t i = 0; i < options->num_stop_sequences; i++) {
+                if (options->stop_sequences[i]) {
+                    request.stop_sequences.push_back(options->stop_sequences[i]);
+                }
+            }
+        }
+    }
+    return request;
+}
+
+// Converts the options' images to RGB for the vision encoder, shrunk to the
+// backend's max edge. Fails without a projector rather than ignoring them.
+static rac_result_t convert_images(rac_llm_llamacpp_handle_impl* h,
+                                   const rac_llm_options_t* options,
+                                   std::vector<runanywhere::ImageInput>& out_images) {
+    out_images.clear();
+    if (options == nullptr || options->images == nullptr || options->num_images == 0) {
+        return RAC_SUCCESS;
+    }
+    if (!h->text_gen->supports_vision()) {
+        rac_error_set_details("Model has no vision projector (mmproj) for image input");
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+    out_images.resize(options->num_images);
+    for (size_t i = 0; i < options->num_images; i++) {
+        const rac_image_t& image = options->images[i];
+        if (image.data == nullptr || image.width <= 0 || image.height <= 0) {
+            rac_error_set_details("Invalid image");
+            return RAC_ERROR_INVALID_ARGUMENT;
+        }
+        runanywhere::ImageInput& input = out_images[i];
+        rac_image_fit_size(image.width, image.height, h->text_gen->image_max_edge(), &input.width,
+                           &input.height);
+        input.rgb.resize(static_cast<size_t>(input.width) * input.height * 3);
+        const rac_result_t result =
+            rac_image_to_rgb(&image, input.width, input.height, input.rgb.data());
+        if (result != RAC_SUCCESS) {
+            rac_error_set_details("Invalid image");
+            return result;
+        }
+    }
+    return RAC_SUCCESS;
+}
+
+static rac_llm_stop_reason_t stop_reason_of(const std::string& finish_reason) {
+    if (finish_reason == "length") {
+        return RAC_LLM_STOP_REASON_MAX_TOKENS;
+    }
+    if (finish_reason == "prefill_deadline") {
+        return RAC_LLM_STOP_REASON_PREFILL_DEADLINE;
+    }
+    if (finish_reason == "deadline") {
+        return RAC_LLM_STOP_REASON_DEADLINE;
+    }
+    if (finish_reason == "too_slow") {
+        return RAC_LLM_STOP_REASON_TOO_SLOW;
+    }
+    return RAC_LLM_STOP_REASON_END;
+}
+
+// A stream's result has no struct to carry its stop reason, so it is kept for
+// the thread that ran it until rac_llm_llamacpp_get_stop_reason reads it
+struct LastStream {
+    rac_handle_t handle = nullptr;
+    rac_llm_stop_reason_t stop_reason = RAC_LLM_STOP_REASON_END;
+};
+static thread_local LastStream g_last_stream;
+
 // =============================================================================
 // LLAMACPP API IMPLEMENTATION
 // =============================================================================
@@ -79,12 +174,40 @@ rac_result_t rac_llm_llamacpp_create(const char* model_path,
         if (config->context_size > 0) {
             model_config["context_size"] = config->context_size;
         }
-        if (config->gpu_layers != 0) {
-            model_config["gpu_layers"] = config->gpu_layers;
-        }
+        model_config["gpu_layers"] = config->gpu_layers;
         if (config->batch_size > 0) {
             model_config["batch_size"] = config->batch_size;
         }
+        if (config->draft_model_path != nullptr) {
+            model_config["draft_model_path"] = config->draft_model_path;
+        }
+        if (config->draft_tokens > 0) {
+            model_config["draft_tokens"] = config->draft_tokens;
+        }
+        if (config->kv_cache_type_k != nullptr) {
+            model_config["kv_cache_type_k"] = config->kv_cache_type_k;
+        }
+        if (config->kv_cache_type_v != nullptr) {
+            model_config["kv_cache_type_v"] = config->kv_cache_type_v;
+        }
+        if (config->flash_attention >= 0) {
+            model_config["flash_attention"] = config->flash_attention != 0;
+        }
+        if (config->memory_budget_mb > 0) {
+            model_config["memory_budget_mb"] = config->memory_budget_mb;
+        }
+        if (config->load_mode > 0) {
+            model_config["load_mode"] = config->load_mode;
+        }
+        if (config->mmproj_path != nullptr) {
+            model_config["mmproj_path"] = config->mmproj_path;
+        }
+        if (config->image_cache_mb > 0) {
+            model_config["image_cache_mb"] = config->image_cache_mb;
+        }
+        if (config->image_max_edge != 0) {
+            model_config["image_max_edge"] = config->image_max_edge;
+        }
     }
 
     // Load model
@@ -146,27 +269,20 @@ rac_result_t rac_llm_llamacpp_generate(rac_handle_t handle, const char* prompt,
     }
 
     // Build request from RAC options
-    runanywhere::TextGenerationRequest request;
-    request.prompt = prompt;
-    if (options != nullptr) {
-        request.max_tokens = options->max_tokens;
-        request.temperature = options->temperature;
-        request.top_p = options->top_p;
-        // Handle stop sequences if available
-        if (options->stop_sequences != nullptr && options->num_stop_sequences > 0) {
-            for (int32_t i = 0; i < options->num_stop_sequences; i++) {
-                if (options->stop_sequences[i]) {
-                    request.stop_sequences.push_back(options->stop_sequences[i]);
-                }
-            }
-        }
+    runanywhere::TextGenerationRequest request = build_request(prompt, options);
+    const rac_result_t images_result = convert_images(h, options, request.images);
+    if (images_result != RAC_SUCCESS) {
+        return images_result;
     }
 
     // Generate using C++ class
     auto result = h->text_gen->generate(request);
 
     // Fill RAC result struct
-    out_result->text = result.text.empty() ? nullptr : strdup(result.text.c_str());
+    out_result->text =
+        result.text.empty()
+            ? nullptr
+            : rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, result.text.c_str());
     out_result->completion_tokens = result.tokens_generated;
     out_result->prompt_tokens = result.prompt_tokens;
     out_result->total_tokens = result.prompt_tokens + result.tokens_generated;
@@ -176,6 +292,7 @@ rac_result_t rac_llm_llamacpp_generate(rac_handle_t handle, const char* prompt,
                                         ? (float)result.tokens_generated /
                                               (result.inference_time_ms / 1000.0f)
                                         : 0.0f;
+    out_result->stop_reason = stop_reason_of(result.finish_reason);
 
     // Publish event
     rac_event_track("llm.generation.completed", RAC_EVENT_CATEGORY_LLM, RAC_EVENT_DESTINATION_ALL,
@@ -197,26 +314,22 @@ rac_result_t rac_llm_llamacpp_generate_stream(rac_handle_t handle, const char* p
         return RAC_ERROR_INVALID_HANDLE;
     }
 
-    runanywhere::TextGenerationRequest request;
-    request.prompt = prompt;
-    if (options != nullptr) {
-        request.max_tokens = options->max_tokens;
-        request.temperature = options->temperature;
-        request.top_p = options->top_p;
-        if (options->stop_sequences != nullptr && options->num_stop_sequences > 0) {
-            for (int32_t i = 0; i < options->num_stop_sequences; i++) {
-                if (options->stop_sequences[i]) {
-                    request.stop_sequences.push_back(options->stop_sequences[i]);
-                }
-            }
-        }
+    runanywhere::TextGenerationRequest request = build_request(prompt, options);
+    const rac_result_t images_result = convert_images(h, options, request.images);
+    if (images_result != RAC_SUCCESS) {
+        return images_result;
     }
 
     // Stream using C++ class
-    bool success =
-        h->text_gen->generate_stream(request, [callback, user_data](const std::string& token) -> bool {
+    std::string finish_reason;
+    bool success = h->text_gen->generate_stream(
+        request,
+        [callback, user_data](const std::string& token) -> bool {
             return callback(token.c_str(), RAC_FALSE, user_data) == RAC_TRUE;
-        });
+        },
+        nullptr, nullptr, &finish_reason);
+    g_last_stream.handle = handle;
+    g_last_stream.stop_reason = stop_reason_of(finish_reason);
 
     if (success) {
         callback("", RAC_TRUE, user_data);  // Final token
@@ -225,6 +338,139 @@ rac_result_t rac_llm_llamacpp_generate_stream(rac_handle_t handle, const char* p
     return success ? RAC_SUCCESS : RAC_ERROR_INFERENCE_FAILED;
 }
 
+rac_result_t rac_llm_llamacpp_get_stop_reason(rac_handle_t handle,
+                                              rac_llm_stop_reason_t* out_reason) {
+    if (handle == nullptr || out_reason == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    if (g_last_stream.handle != handle) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+    *out_reason = g_last_stream.stop_reason;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_llamacpp_generate_batch(rac_handle_t handle, const char* const* prompts,
+                                             size_t num_prompts, const rac_llm_options_t* options,
+                                             rac_llm_batch_callback_fn callback, void* user_data) {
+    if (handle == nullptr || prompts == nullptr || callback == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    // Every prompt asks about the same images
+    std::vector<runanywhere::ImageInput> images;
+    const rac_result_t images_result = convert_images(h, options, images);
+    if (images_result != RAC_SUCCESS) {
+        return images_result;
+    }
+
+    std::vector<runanywhere::TextGenerationRequest> requests;
+    requests.reserve(num_prompts);
+    for (size_t i = 0; i < num_prompts; i++) {
+        if (prompts[i] == nullptr) {
+            return RAC_ERROR_NULL_POINTER;
+        }
+        requests.push_back(build_request(prompts[i], options));
+        requests.back().images = images;
+    }
+
+    bool success = h->text_gen->generate_batch(
+        requests, [callback, user_data](size_t index, const runanywhere::TextGenerationResult& result) {
+            rac_result_t status = RAC_SUCCESS;
+            if (result.finish_reason == "cancelled") {
+                status = RAC_ERROR_CANCELLED;
+            } else if (result.finish_reason == "error") {
+                status = RAC_ERROR_GENERATION_FAILED;
+            }
+
+            rac_llm_result_t out = {};
+            out.text =
+                result.text.empty()
+                    ? nullptr
+                    : rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, result.text.c_str());
+            out.completion_tokens = result.tokens_generated;
+            out.prompt_tokens = result.prompt_tokens;
+            out.total_tokens = result.prompt_tokens + result.tokens_generated;
+            out.total_time_ms = result.inference_time_ms;
+            out.tokens_per_second = result.tokens_generated > 0 && result.inference_time_ms > 0
+                                        ? (float)result.tokens_generated /
+                                              (result.inference_time_ms / 1000.0f)
+                                        : 0.0f;
+            out.stop_reason = stop_reason_of(result.finish_reason);
+            callback(index, status, &out, user_data);
+            rac_free(out.text);
+        });
+
+    if (!success) {
+        return RAC_ERROR_BACKEND_NOT_READY;
+    }
+
+    rac_event_track("llm.generation.completed", RAC_EVENT_CATEGORY_LLM, RAC_EVENT_DESTINATION_ALL,
+                    nullptr);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_llamacpp_generate_samples(rac_handle_t handle, const char* prompt,
+                                               const rac_llm_options_t* options,
+                                               rac_llm_samples_t* out_samples) {
+    if (handle == nullptr || prompt == nullptr || out_samples == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    *out_samples = {};
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    runanywhere::TextGenerationRequest request = build_request(prompt, options);
+    const rac_result_t images_result = convert_images(h, options, request.images);
+    if (images_result != RAC_SUCCESS) {
+        return images_result;
+    }
+    const int n_samples = options && options->n_samples > 1 ? options->n_samples : 1;
+    std::vector<runanywhere::TextGenerationResult> results;
+    const bool success = h->text_gen->generate_samples(request, n_samples, results);
+    if (!success) {
+        for (const auto& result : results) {
+            if (result.finish_reason == "cancelled") {
+                return RAC_ERROR_CANCELLED;
+            }
+        }
+        return RAC_ERROR_GENERATION_FAILED;
+    }
+
+    auto* samples = static_cast<rac_llm_sample_t*>(
+        rac_calloc_tagged(RAC_ALLOC_TAG_RESULT, results.size(), sizeof(rac_llm_sample_t)));
+    if (!samples) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    out_samples->samples = samples;
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& result = results[i];
+        samples[i].text =
+            result.text.empty() ? nullptr
+                                : rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, result.text.c_str());
+        samples[i].completion_tokens = result.tokens_generated;
+        samples[i].logprob = result.logprob;
+        samples[i].mean_logprob =
+            result.tokens_generated > 0 ? result.logprob / result.tokens_generated : 0.0;
+        samples[i].truncated = result.finish_reason == "length" ? RAC_TRUE : RAC_FALSE;
+        out_samples->prompt_tokens = result.prompt_tokens;
+        out_samples->total_time_ms = static_cast<int64_t>(result.inference_time_ms);
+    }
+    out_samples->num_samples = static_cast<int32_t>(results.size());
+
+    rac_event_track("llm.generation.completed", RAC_EVENT_CATEGORY_LLM, RAC_EVENT_DESTINATION_ALL,
+                    nullptr);
+    return RAC_SUCCESS;
+}
+
 void rac_llm_llamacpp_cancel(rac_handle_t handle) {
     if (handle == nullptr) {
         return;
@@ -255,8 +501,252 @@ rac_result_t rac_llm_llamacpp_get_model_info(rac_handle_t handle, char** out_jso
     }
 
     std::string json_str = info.dump();
-    *out_json = strdup(json_str.c_str());
+    *out_json = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, json_str.c_str());
+
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_llamacpp_get_speculative_metrics(rac_handle_t handle,
+                                                     rac_speculative_metrics_t* out_metrics) {
+    if (handle == nullptr || out_metrics == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    const auto stats = h->text_gen->get_speculative_stats();
+    out_metrics->enabled = stats.enabled ? RAC_TRUE : RAC_FALSE;
+    out_metrics->drafted_tokens = stats.drafted_tokens;
+    out_metrics->accepted_tokens = stats.accepted_tokens;
+    out_metrics->target_decodes = stats.target_decodes;
+    out_metrics->generated_tokens = stats.generated_tokens;
+    out_metrics->acceptance_rate =
+        stats.drafted_tokens > 0
+            ? static_cast<double>(stats.accepted_tokens) / static_cast<double>(stats.drafted_tokens)
+            : 0.0;
+    out_metrics->tokens_per_target_decode =
+        stats.target_decodes > 0
+            ? static_cast<double>(stats.generated_tokens) / static_cast<double>(stats.target_decodes)
+            : 0.0;
+    out_metrics->lookup_drafted_tokens = stats.lookup_drafted_tokens;
+    out_metrics->lookup_accepted_tokens = stats.lookup_accepted_tokens;
+    out_metrics->lookup_decodes = stats.lookup_decodes;
+    out_metrics->lookup_acceptance_rate =
+        stats.lookup_drafted_tokens > 0 ? static_cast<double>(stats.lookup_accepted_tokens) /
+                                              static_cast<double>(stats.lookup_drafted_tokens)
+                                        : 0.0;
+
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_llamacpp_get_memory_usage(rac_handle_t handle,
+                                               rac_llm_memory_usage_t* out_usage) {
+    if (handle == nullptr || out_usage == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    const auto usage = h->text_gen->get_memory_usage();
+    out_usage->model_bytes = static_cast<int64_t>(usage.model_bytes);
+    out_usage->model_mapped_bytes = static_cast<int64_t>(usage.model_mapped_bytes);
+    out_usage->model_resident_bytes = static_cast<int64_t>(usage.model_resident_bytes);
+    out_usage->kv_cache_bytes = static_cast<int64_t>(usage.kv_cache_bytes);
+    out_usage->kv_used_bytes = static_cast<int64_t>(usage.kv_used_bytes);
+    out_usage->compute_bytes = static_cast<int64_t>(usage.compute_bytes);
+    out_usage->sampler_bytes = static_cast<int64_t>(usage.sampler_bytes);
+    out_usage->draft_bytes = static_cast<int64_t>(usage.draft_bytes);
+    out_usage->vision_bytes = static_cast<int64_t>(usage.vision_bytes);
+    out_usage->total_bytes = static_cast<int64_t>(usage.total());
+    out_usage->context_size = usage.context_size;
+
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_llamacpp_count_tokens(rac_handle_t handle, const char* text,
+                                           int32_t* out_count) {
+    if (handle == nullptr || text == nullptr || out_count == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    const int count = h->text_gen->count_tokens(text);
+    if (count < 0) {
+        return RAC_ERROR_MODEL_NOT_LOADED;
+    }
+
+    *out_count = count;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_llamacpp_save_state(rac_handle_t handle, const char* path,
+                                         int32_t* out_token_count) {
+    if (handle == nullptr || path == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    int tokens = 0;
+    const rac_result_t result = h->text_gen->save_state(path, &tokens);
+    if (out_token_count) {
+        *out_token_count = tokens;
+    }
+    return result;
+}
+
+rac_result_t rac_llm_llamacpp_restore_state(rac_handle_t handle, const char* path,
+                                            int32_t* out_token_count) {
+    if (handle == nullptr || path == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    int tokens = 0;
+    const rac_result_t result = h->text_gen->restore_state(path, &tokens);
+    if (out_token_count) {
+        *out_token_count = tokens;
+    }
+    return result;
+}
+
+rac_result_t rac_llm_llamacpp_load_lora(rac_handle_t handle, const char* name, const char* path) {
+    if (handle == nullptr || name == nullptr || path == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    return h->text_gen->load_lora_adapter(name, path);
+}
+
+rac_result_t rac_llm_llamacpp_remove_lora(rac_handle_t handle, const char* name) {
+    if (handle == nullptr || name == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    return h->text_gen->remove_lora_adapter(name);
+}
+
+rac_result_t rac_llm_llamacpp_set_lora(rac_handle_t handle, const char* name, float scale) {
+    if (handle == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    return h->text_gen->set_lora_adapter(name ? name : "", scale);
+}
+
+rac_result_t rac_llm_llamacpp_load_embedding_model(rac_handle_t handle, const char* model_path) {
+    if (handle == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    if (model_path == nullptr) {
+        h->text_gen->unload_embedding_model();
+        return RAC_SUCCESS;
+    }
+    return h->text_gen->load_embedding_model(model_path) ? RAC_SUCCESS
+                                                         : RAC_ERROR_MODEL_LOAD_FAILED;
+}
+
+rac_result_t rac_llm_llamacpp_get_embedding_dim(rac_handle_t handle, int32_t* out_dim) {
+    if (handle == nullptr || out_dim == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    const int dim = h->text_gen->embedding_dim();
+    if (dim <= 0) {
+        return RAC_ERROR_MODEL_NOT_LOADED;
+    }
+
+    *out_dim = dim;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_llamacpp_embed(rac_handle_t handle, const char* const* texts, size_t num_texts,
+                                    rac_bool_t normalize, float* out_embeddings, size_t capacity) {
+    if (handle == nullptr || texts == nullptr || out_embeddings == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    const int dim = h->text_gen->embedding_dim();
+    if (dim <= 0) {
+        return RAC_ERROR_MODEL_NOT_LOADED;
+    }
+    if (capacity < num_texts * static_cast<size_t>(dim)) {
+        return RAC_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    std::vector<std::string> inputs;
+    inputs.reserve(num_texts);
+    for (size_t i = 0; i < num_texts; i++) {
+        if (texts[i] == nullptr) {
+            return RAC_ERROR_NULL_POINTER;
+        }
+        inputs.emplace_back(texts[i]);
+    }
+
+    return h->text_gen->embed(inputs, normalize == RAC_TRUE, out_embeddings)
+               ? RAC_SUCCESS
+               : RAC_ERROR_INFERENCE_FAILED;
+}
+
+rac_result_t rac_llm_llamacpp_trim_memory(rac_handle_t handle, rac_llm_memory_pressure_t level) {
+    if (handle == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_llm_llamacpp_handle_impl*>(handle);
+    if (!h->text_gen) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
 
+    h->text_gen->trim_memory(static_cast<runanywhere::MemoryPressure>(level));
     return RAC_SUCCESS;
 }
 
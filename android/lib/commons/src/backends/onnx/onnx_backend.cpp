@@ -11,16 +11,90 @@
 #include <dirent.h>
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <set>
+#include <thread>
 
+#if defined(__ANDROID__) && __has_include(<nnapi_provider_factory.h>)
+#include <nnapi_provider_factory.h>
+#define RAC_ORT_HAS_NNAPI 1
+#else
+#define RAC_ORT_HAS_NNAPI 0
+#endif
+
+#include "rac/core/rac_cpu_budget.h"
 #include "rac/core/rac_logger.h"
+#include "rac/core/rac_trace.h"
 
 namespace runanywhere {
 
+static bool ort_ok(const OrtApi* api, OrtStatus* status, const char* what) {
+    if (!status) {
+        return true;
+    }
+    RAC_LOG_ERROR("ONNX", "%s failed: %s", what, api->GetErrorMessage(status));
+    api->ReleaseStatus(status);
+    return false;
+}
+
 // =============================================================================
 // ONNXBackendNew Implementation
 // =============================================================================
 
+// One OrtEnv with global thread pools serves every backend instance, so STT,
+// TTS and VAD sessions share threads instead of each spawning their own
+namespace {
+std::mutex g_runtime_mutex;
+ORTRuntimeConfig g_default_runtime_config;
+OrtEnv* g_shared_env = nullptr;
+int g_shared_env_refs = 0;
+std::set<std::string> g_models_being_optimized;
+}  // namespace
+
+static ORTRuntimeConfig parse_runtime_config(const nlohmann::json& config) {
+    ORTRuntimeConfig runtime;
+    {
+        std::lock_guard<std::mutex> lock(g_runtime_mutex);
+        runtime = g_default_runtime_config;
+    }
+    if (!config.is_object()) {
+        return runtime;
+    }
+
+    if (config.contains("num_threads")) {
+        runtime.intra_op_threads = config["num_threads"].get<int>();
+    }
+    if (config.contains("intra_op_threads")) {
+        runtime.intra_op_threads = config["intra_op_threads"].get<int>();
+    }
+    if (config.contains("inter_op_threads")) {
+        runtime.inter_op_threads = config["inter_op_threads"].get<int>();
+    }
+    if (config.contains("graph_optimization_level")) {
+        int level = config["graph_optimization_level"].get<int>();
+        runtime.graph_optimization_level =
+            level <= 0   ? ORT_DISABLE_ALL
+            : level == 1 ? ORT_ENABLE_BASIC
+            : level == 2 ? ORT_ENABLE_EXTENDED
+                         : ORT_ENABLE_ALL;
+    }
+    if (config.contains("execution_provider")) {
+        runtime.execution_provider = config["execution_provider"].get<std::string>();
+    }
+    if (config.contains("use_global_thread_pool")) {
+        runtime.use_global_thread_pool = config["use_global_thread_pool"].get<bool>();
+    }
+    if (config.contains("cache_optimized_models")) {
+        runtime.cache_optimized_models = config["cache_optimized_models"].get<bool>();
+    }
+    return runtime;
+}
+
 ONNXBackendNew::ONNXBackendNew() {}
 
 ONNXBackendNew::~ONNXBackendNew() {
@@ -35,6 +109,7 @@ bool ONNXBackendNew::initialize(const nlohmann::json& config) {
     }
 
     config_ = config;
+    runtime_config_ = parse_runtime_config(config);
 
     if (!initialize_ort()) {
         return false;
@@ -56,10 +131,27 @@ void ONNXBackendNew::cleanup() {
     stt_.reset();
     tts_.reset();
     vad_.reset();
+    kws_.reset();
+
+    for (auto& thread : optimize_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    optimize_threads_.clear();
 
     if (ort_env_) {
-        ort_api_->ReleaseEnv(ort_env_);
+        if (shared_env_) {
+            std::lock_guard<std::mutex> env_lock(g_runtime_mutex);
+            if (--g_shared_env_refs == 0) {
+                ort_api_->ReleaseEnv(g_shared_env);
+                g_shared_env = nullptr;
+            }
+        } else {
+            ort_api_->ReleaseEnv(ort_env_);
+        }
         ort_env_ = nullptr;
+        shared_env_ = false;
     }
 
     initialized_ = false;
@@ -84,23 +176,203 @@ bool ONNXBackendNew::initialize_ort() {
         return false;
     }
 
-    OrtStatus* status = ort_api_->CreateEnv(ORT_LOGGING_LEVEL_WARNING, "runanywhere", &ort_env_);
-    if (status) {
-        RAC_LOG_ERROR("ONNX", "Failed to create ONNX Runtime environment: %s",
-                     ort_api_->GetErrorMessage(status));
-        ort_api_->ReleaseStatus(status);
-        return false;
+    if (!runtime_config_.use_global_thread_pool) {
+        OrtStatus* status =
+            ort_api_->CreateEnv(ORT_LOGGING_LEVEL_WARNING, "runanywhere", &ort_env_);
+        if (status) {
+            RAC_LOG_ERROR("ONNX", "Failed to create ONNX Runtime environment: %s",
+                         ort_api_->GetErrorMessage(status));
+            ort_api_->ReleaseStatus(status);
+            return false;
+        }
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(g_runtime_mutex);
+    if (!g_shared_env) {
+        OrtThreadingOptions* threading = nullptr;
+        if (!ort_ok(ort_api_, ort_api_->CreateThreadingOptions(&threading),
+                    "CreateThreadingOptions")) {
+            return false;
+        }
+        ort_ok(ort_api_, ort_api_->SetGlobalIntraOpNumThreads(threading, get_num_threads()),
+               "SetGlobalIntraOpNumThreads");
+        ort_ok(ort_api_,
+               ort_api_->SetGlobalInterOpNumThreads(threading,
+                                                    std::max(1, runtime_config_.inter_op_threads)),
+               "SetGlobalInterOpNumThreads");
+        // Idle workers sleep rather than spin, so they don't steal cores from llama.cpp
+        ort_ok(ort_api_, ort_api_->SetGlobalSpinControl(threading, 0), "SetGlobalSpinControl");
+
+        bool created = ort_ok(ort_api_,
+                              ort_api_->CreateEnvWithGlobalThreadPools(
+                                  ORT_LOGGING_LEVEL_WARNING, "runanywhere", threading, &g_shared_env),
+                              "CreateEnvWithGlobalThreadPools");
+        ort_api_->ReleaseThreadingOptions(threading);
+        if (!created) {
+            g_shared_env = nullptr;
+            return false;
+        }
+        RAC_LOG_INFO("ONNX", "Created shared ONNX Runtime env: %d intra-op threads, provider %s",
+                     get_num_threads(), runtime_config_.execution_provider.c_str());
     }
+    g_shared_env_refs++;
+    ort_env_ = g_shared_env;
+    shared_env_ = true;
 
     return true;
 }
 
+void ONNXBackendNew::set_default_runtime_config(const ORTRuntimeConfig& config) {
+    std::lock_guard<std::mutex> lock(g_runtime_mutex);
+    g_default_runtime_config = config;
+}
+
+int ONNXBackendNew::get_num_threads() const {
+    if (runtime_config_.intra_op_threads > 0) {
+        return runtime_config_.intra_op_threads;
+    }
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(1, std::min(4, cores / 2));
+}
+
+const char* ONNXBackendNew::get_sherpa_provider() const {
+    // sherpa-onnx builds ship without the QNN execution provider
+    const std::string& provider = runtime_config_.execution_provider;
+    if (provider == "xnnpack" || provider == "nnapi") {
+        return provider.c_str();
+    }
+    return "cpu";
+}
+
+std::string ONNXBackendNew::optimized_model_path(const std::string& model_path) {
+    const std::string suffix = ".onnx";
+    if (!runtime_config_.cache_optimized_models || !ort_env_ ||
+        model_path.size() <= suffix.size() ||
+        model_path.compare(model_path.size() - suffix.size(), suffix.size(), suffix) != 0) {
+        return model_path;
+    }
+
+    // Optimised graphs are only valid for the runtime and provider that made them
+    std::string cache_path = model_path.substr(0, model_path.size() - suffix.size()) + "." +
+                             OrtGetApiBase()->GetVersionString() + "-" +
+                             runtime_config_.execution_provider + "-O" +
+                             std::to_string(static_cast<int>(runtime_config_.graph_optimization_level)) +
+                             ".ort";
+
+    struct stat model_stat;
+    struct stat cache_stat;
+    if (stat(model_path.c_str(), &model_stat) != 0) {
+        return model_path;
+    }
+    if (stat(cache_path.c_str(), &cache_stat) == 0 && cache_stat.st_size > 0 &&
+        cache_stat.st_mtime >= model_stat.st_mtime) {
+        RAC_LOG_INFO("ONNX", "Using optimized model: %s", cache_path.c_str());
+        return cache_path;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_runtime_mutex);
+        if (!g_models_being_optimized.insert(cache_path).second) {
+            return model_path;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    optimize_threads_.emplace_back(&ONNXBackendNew::build_optimized_model, this, model_path,
+                                   cache_path);
+    return model_path;
+}
+
+void ONNXBackendNew::build_optimized_model(const std::string& model_path,
+                                           const std::string& cache_path) {
+    auto start = std::chrono::steady_clock::now();
+    std::string temp_path = cache_path + ".tmp";
+
+    OrtSessionOptions* options = nullptr;
+    OrtSession* session = nullptr;
+    bool saved = false;
+    if (ort_ok(ort_api_, ort_api_->CreateSessionOptions(&options), "CreateSessionOptions")) {
+        apply_session_options(options);
+        saved = ort_ok(ort_api_,
+                       ort_api_->AddSessionConfigEntry(options, "session.save_model_format", "ORT"),
+                       "AddSessionConfigEntry") &&
+                ort_ok(ort_api_, ort_api_->SetOptimizedModelFilePath(options, temp_path.c_str()),
+                       "SetOptimizedModelFilePath") &&
+                ort_ok(ort_api_,
+                       ort_api_->CreateSession(ort_env_, model_path.c_str(), options, &session),
+                       "CreateSession");
+        if (session) {
+            ort_api_->ReleaseSession(session);
+        }
+        ort_api_->ReleaseSessionOptions(options);
+    }
+
+    // Publish atomically so a crash mid-write never leaves a truncated cache
+    if (saved && std::rename(temp_path.c_str(), cache_path.c_str()) == 0) {
+        RAC_LOG_INFO("ONNX", "Cached optimized model in %lld ms: %s",
+                     static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                std::chrono::steady_clock::now() - start)
+                                                .count()),
+                     cache_path.c_str());
+    } else {
+        RAC_LOG_WARNING("ONNX", "Could not cache optimized model for %s", model_path.c_str());
+        std::remove(temp_path.c_str());
+    }
+
+    std::lock_guard<std::mutex> lock(g_runtime_mutex);
+    g_models_being_optimized.erase(cache_path);
+}
+
+void ONNXBackendNew::apply_session_options(OrtSessionOptions* options) const {
+    if (shared_env_) {
+        ort_ok(ort_api_, ort_api_->DisablePerSessionThreads(options), "DisablePerSessionThreads");
+    } else {
+        ort_ok(ort_api_, ort_api_->SetIntraOpNumThreads(options, get_num_threads()),
+               "SetIntraOpNumThreads");
+        ort_ok(ort_api_,
+               ort_api_->SetInterOpNumThreads(options,
+                                              std::max(1, runtime_config_.inter_op_threads)),
+               "SetInterOpNumThreads");
+    }
+    ort_ok(ort_api_,
+           ort_api_->SetSessionGraphOptimizationLevel(options,
+                                                      runtime_config_.graph_optimization_level),
+           "SetSessionGraphOptimizationLevel");
+
+    const std::string& provider = runtime_config_.execution_provider;
+    OrtStatus* status = nullptr;
+    if (provider == "xnnpack") {
+        std::string threads = std::to_string(get_num_threads());
+        const char* keys[] = {"intra_op_num_threads"};
+        const char* values[] = {threads.c_str()};
+        status = ort_api_->SessionOptionsAppendExecutionProvider(options, "XNNPACK", keys, values, 1);
+    } else if (provider == "qnn") {
+        const char* keys[] = {"backend_path"};
+        const char* values[] = {"libQnnHtp.so"};
+        status = ort_api_->SessionOptionsAppendExecutionProvider(options, "QNN", keys, values, 1);
+    } else if (provider == "nnapi") {
+#if RAC_ORT_HAS_NNAPI
+        status = OrtSessionOptionsAppendExecutionProvider_Nnapi(options, 0);
+#else
+        RAC_LOG_WARNING("ONNX", "NNAPI execution provider not built in, using CPU");
+#endif
+    }
+    if (status) {
+        RAC_LOG_WARNING("ONNX", "%s execution provider unavailable, using CPU: %s",
+                        provider.c_str(), ort_api_->GetErrorMessage(status));
+        ort_api_->ReleaseStatus(status);
+    }
+}
+
 void ONNXBackendNew::create_capabilities() {
     stt_ = std::make_unique<ONNXSTT>(this);
 
+    // VAD runs on ONNX Runtime directly and does not need Sherpa
+    vad_ = std::make_unique<ONNXVAD>(this);
+
 #if SHERPA_ONNX_AVAILABLE
     tts_ = std::make_unique<ONNXTTS>(this);
-    vad_ = std::make_unique<ONNXVAD>(this);
+    kws_ = std::make_unique<ONNXKWS>(this);
 #endif
 }
 
@@ -116,7 +388,7 @@ ONNXSTT::~ONNXSTT() {
 
 bool ONNXSTT::is_ready() const {
 #if SHERPA_ONNX_AVAILABLE
-    return model_loaded_ && sherpa_recognizer_ != nullptr;
+    return model_loaded_ && (sherpa_recognizer_ != nullptr || online_recognizer_ != nullptr);
 #else
     return model_loaded_;
 #endif
@@ -124,9 +396,18 @@ bool ONNXSTT::is_ready() const {
 
 bool ONNXSTT::load_model(const std::string& model_path, STTModelType model_type,
                          const nlohmann::json& config) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    RAC_TRACE_SCOPE("STT.ONNX.load_model");
+    std::unique_lock<std::shared_mutex> lock(model_mutex_);
 
 #if SHERPA_ONNX_AVAILABLE
+    {
+        std::lock_guard<std::mutex> streams_lock(streams_mutex_);
+        sherpa_streams_.clear();
+    }
+    if (online_recognizer_) {
+        SherpaOnnxDestroyOnlineRecognizer(online_recognizer_);
+        online_recognizer_ = nullptr;
+    }
     if (sherpa_recognizer_) {
         SherpaOnnxDestroyOfflineRecognizer(sherpa_recognizer_);
         sherpa_recognizer_ = nullptr;
@@ -145,6 +426,7 @@ bool ONNXSTT::load_model(const std::string& model_path, STTModelType model_type,
 
     std::string encoder_path;
     std::string decoder_path;
+    std::string joiner_path;
     std::string tokens_path;
 
     if (S_ISDIR(path_stat.st_mode)) {
@@ -167,6 +449,10 @@ bool ONNXSTT::load_model(const std::string& model_path, STTModelType model_type,
                      filename.substr(filename.size() - 5) == ".onnx") {
                 decoder_path = full_path;
                 RAC_LOG_DEBUG("ONNX.STT", "Found decoder: %s", decoder_path.c_str());
+            } else if (filename.find("joiner") != std::string::npos && filename.size() > 5 &&
+                       filename.substr(filename.size() - 5) == ".onnx") {
+                joiner_path = full_path;
+                RAC_LOG_DEBUG("ONNX.STT", "Found joiner: %s", joiner_path.c_str());
             } else if (filename == "tokens.txt" || (filename.find("tokens") != std::string::npos &&
                                                   filename.find(".txt") != std::string::npos)) {
                 tokens_path = full_path;
@@ -201,6 +487,9 @@ bool ONNXSTT::load_model(const std::string& model_path, STTModelType model_type,
             model_dir_ = dir;
             decoder_path = dir + "/decoder.onnx";
             tokens_path = dir + "/tokens.txt";
+            if (stat((dir + "/joiner.onnx").c_str(), &path_stat) == 0) {
+                joiner_path = dir + "/joiner.onnx";
+            }
         }
     }
 
@@ -227,6 +516,21 @@ bool ONNXSTT::load_model(const std::string& model_path, STTModelType model_type,
         return false;
     }
 
+    // Skip graph optimisation on load when a cached optimised copy exists
+    encoder_path = backend_->optimized_model_path(encoder_path);
+    decoder_path = backend_->optimized_model_path(decoder_path);
+
+    // A joiner means a transducer; the supported ones are streaming zipformers
+    if (!joiner_path.empty() || model_type == STTModelType::ZIPFORMER ||
+        model_type == STTModelType::TRANSDUCER) {
+        if (joiner_path.empty()) {
+            RAC_LOG_ERROR("ONNX.STT", "Joiner file not found in: %s", model_dir_.c_str());
+            return false;
+        }
+        joiner_path = backend_->optimized_model_path(joiner_path);
+        return load_online_model(encoder_path, decoder_path, joiner_path, tokens_path, config);
+    }
+
     SherpaOnnxOfflineRecognizerConfig recognizer_config;
     memset(&recognizer_config, 0, sizeof(recognizer_config));
 
@@ -247,9 +551,9 @@ bool ONNXSTT::load_model(const std::string& model_path, STTModelType model_type,
     recognizer_config.model_config.whisper.tail_paddings = -1;
 
     recognizer_config.model_config.tokens = tokens_path.c_str();
-    recognizer_config.model_config.num_threads = 2;
+    recognizer_config.model_config.num_threads = backend_->get_num_threads();
     recognizer_config.model_config.debug = 1;
-    recognizer_config.model_config.provider = "cpu";
+    recognizer_config.model_config.provider = backend_->get_sherpa_provider();
     recognizer_config.model_config.model_type = "whisper";
 
     recognizer_config.model_config.modeling_unit = "cjkchar";
@@ -312,20 +616,116 @@ bool ONNXSTT::load_model(const std::string& model_path, STTModelType model_type,
 #endif
 }
 
+#if SHERPA_ONNX_AVAILABLE
+bool ONNXSTT::load_online_model(const std::string& encoder_path, const std::string& decoder_path,
+                                const std::string& joiner_path, const std::string& tokens_path,
+                                const nlohmann::json& config) {
+    SherpaOnnxOnlineRecognizerConfig recognizer_config;
+    memset(&recognizer_config, 0, sizeof(recognizer_config));
+
+    recognizer_config.feat_config.sample_rate = 16000;
+    recognizer_config.feat_config.feature_dim = 80;
+
+    recognizer_config.model_config.transducer.encoder = encoder_path.c_str();
+    recognizer_config.model_config.transducer.decoder = decoder_path.c_str();
+    recognizer_config.model_config.transducer.joiner = joiner_path.c_str();
+    recognizer_config.model_config.paraformer.encoder = "";
+    recognizer_config.model_config.paraformer.decoder = "";
+    recognizer_config.model_config.zipformer2_ctc.model = "";
+    recognizer_config.model_config.tokens = tokens_path.c_str();
+    recognizer_config.model_config.num_threads = backend_->get_num_threads();
+    recognizer_config.model_config.provider = backend_->get_sherpa_provider();
+    recognizer_config.model_config.debug = 0;
+    recognizer_config.model_config.model_type = "";
+    recognizer_config.model_config.modeling_unit = "cjkchar";
+    recognizer_config.model_config.bpe_vocab = "";
+
+    recognizer_config.decoding_method = "greedy_search";
+    recognizer_config.max_active_paths = 4;
+
+    // Endpoint rules (sherpa's defaults): 2.4 s of trailing silence before any
+    // speech, 1.2 s after speech, or 20 s of utterance
+    recognizer_config.enable_endpoint = 1;
+    recognizer_config.rule1_min_trailing_silence = 2.4f;
+    recognizer_config.rule2_min_trailing_silence =
+        config.contains("endpoint_silence_ms") ? config["endpoint_silence_ms"].get<float>() / 1000.0f
+                                               : 1.2f;
+    recognizer_config.rule3_min_utterance_length = 20.0f;
+
+    recognizer_config.hotwords_file = "";
+    recognizer_config.hotwords_score = 1.5f;
+    recognizer_config.ctc_fst_decoder_config.graph = "";
+    recognizer_config.rule_fsts = "";
+    recognizer_config.rule_fars = "";
+    recognizer_config.hotwords_buf = "";
+    recognizer_config.hr.dict_dir = "";
+    recognizer_config.hr.lexicon = "";
+    recognizer_config.hr.rule_fsts = "";
+
+    RAC_LOG_INFO("ONNX.STT", "Joiner: %s", joiner_path.c_str());
+    RAC_LOG_INFO("ONNX.STT", "Creating SherpaOnnxOnlineRecognizer...");
+
+    online_recognizer_ = SherpaOnnxCreateOnlineRecognizer(&recognizer_config);
+    if (!online_recognizer_) {
+        RAC_LOG_ERROR("ONNX.STT", "Failed to create SherpaOnnxOnlineRecognizer");
+        return false;
+    }
+
+    model_type_ = STTModelType::ZIPFORMER;
+    RAC_LOG_INFO("ONNX.STT", "Streaming STT model loaded successfully");
+    model_loaded_ = true;
+    return true;
+}
+
+std::string ONNXSTT::online_text(const SherpaOnnxOnlineStream* stream) const {
+    std::string text;
+    const SherpaOnnxOnlineRecognizerResult* recognizer_result =
+        SherpaOnnxGetOnlineStreamResult(online_recognizer_, stream);
+    if (recognizer_result) {
+        if (recognizer_result->text) {
+            text = recognizer_result->text;
+        }
+        SherpaOnnxDestroyOnlineRecognizerResult(recognizer_result);
+    }
+    return text;
+}
+#endif
+
 bool ONNXSTT::is_model_loaded() const {
     return model_loaded_;
 }
 
+#if SHERPA_ONNX_AVAILABLE
+ONNXSTT::StreamEntry::~StreamEntry() {
+    if (offline) {
+        SherpaOnnxDestroyOfflineStream(offline);
+    }
+    if (online) {
+        SherpaOnnxDestroyOnlineStream(online);
+    }
+}
+
+std::shared_ptr<ONNXSTT::StreamEntry> ONNXSTT::find_stream(const std::string& stream_id) {
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    auto it = sherpa_streams_.find(stream_id);
+    return it != sherpa_streams_.end() ? it->second : nullptr;
+}
+#endif
+
 bool ONNXSTT::unload_model() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::shared_mutex> lock(model_mutex_);
 
 #if SHERPA_ONNX_AVAILABLE
-    for (auto& pair : sherpa_streams_) {
-        if (pair.second) {
-            SherpaOnnxDestroyOfflineStream(pair.second);
-        }
+    {
+        // No stream call can be in flight: they all hold the model lock shared
+        std::lock_guard<std::mutex> streams_lock(streams_mutex_);
+        sherpa_streams_.clear();
+    }
+
+    if (online_recognizer_) {
+        SherpaOnnxDestroyOnlineRecognizer(online_recognizer_);
+        online_recognizer_ = nullptr;
     }
-    sherpa_streams_.clear();
 
     if (sherpa_recognizer_) {
         SherpaOnnxDestroyOfflineRecognizer(sherpa_recognizer_);
@@ -341,18 +741,38 @@ STTModelType ONNXSTT::get_model_type() const {
     return model_type_;
 }
 
-STTResult ONNXSTT::transcribe(const STTRequest& request) {
+STTResult ONNXSTT::transcribe(const float* samples, size_t num_samples,
+                              const STTRequest& request) {
     STTResult result;
 
 #if SHERPA_ONNX_AVAILABLE
+    std::shared_lock<std::shared_mutex> lock(model_mutex_);
+
+    if (online_recognizer_ && model_loaded_) {
+        const SherpaOnnxOnlineStream* stream = SherpaOnnxCreateOnlineStream(online_recognizer_);
+        if (!stream) {
+            result.text = "[Error: Failed to create stream]";
+            return result;
+        }
+        SherpaOnnxOnlineStreamAcceptWaveform(stream, request.sample_rate, samples,
+                                             static_cast<int32_t>(num_samples));
+        SherpaOnnxOnlineStreamInputFinished(stream);
+        while (SherpaOnnxIsOnlineStreamReady(online_recognizer_, stream)) {
+            SherpaOnnxDecodeOnlineStream(online_recognizer_, stream);
+        }
+        result.text = online_text(stream);
+        SherpaOnnxDestroyOnlineStream(stream);
+        return result;
+    }
+
     if (!sherpa_recognizer_ || !model_loaded_) {
         RAC_LOG_ERROR("ONNX.STT", "STT not ready for transcription");
         result.text = "[Error: STT model not loaded]";
         return result;
     }
 
-    RAC_LOG_INFO("ONNX.STT", "Transcribing %zu samples at %d Hz", request.audio_samples.size(),
-                request.sample_rate);
+    RAC_LOG_DEBUG("ONNX.STT", "Transcribing %zu samples at %d Hz", num_samples,
+                  request.sample_rate);
 
     const SherpaOnnxOfflineStream* stream = SherpaOnnxCreateOfflineStream(sherpa_recognizer_);
     if (!stream) {
@@ -361,18 +781,22 @@ STTResult ONNXSTT::transcribe(const STTRequest& request) {
         return result;
     }
 
-    SherpaOnnxAcceptWaveformOffline(stream, request.sample_rate, request.audio_samples.data(),
-                                    static_cast<int32_t>(request.audio_samples.size()));
+    SherpaOnnxAcceptWaveformOffline(stream, request.sample_rate, samples,
+                                    static_cast<int32_t>(num_samples));
 
     RAC_LOG_DEBUG("ONNX.STT", "Decoding audio...");
-    SherpaOnnxDecodeOfflineStream(sherpa_recognizer_, stream);
+    {
+        // Session pools are sized at load; holding the stage makes LLM decode yield cores
+        rac::ScopedCpuBudget cpu_budget(RAC_CPU_STAGE_STT, backend_->get_num_threads());
+        SherpaOnnxDecodeOfflineStream(sherpa_recognizer_, stream);
+    }
 
     const SherpaOnnxOfflineRecognizerResult* recognizer_result =
         SherpaOnnxGetOfflineStreamResult(stream);
 
     if (recognizer_result && recognizer_result->text) {
         result.text = recognizer_result->text;
-        RAC_LOG_INFO("ONNX.STT", "Transcription result: \"%s\"", result.text.c_str());
+        RAC_LOG_DEBUG("ONNX.STT", "Transcription result: \"%s\"", result.text.c_str());
 
         if (recognizer_result->lang) {
             result.detected_language = recognizer_result->lang;
@@ -397,7 +821,7 @@ STTResult ONNXSTT::transcribe(const STTRequest& request) {
 
 bool ONNXSTT::supports_streaming() const {
 #if SHERPA_ONNX_AVAILABLE
-    return false;
+    return online_recognizer_ != nullptr;
 #else
     return false;
 #endif
@@ -405,21 +829,29 @@ bool ONNXSTT::supports_streaming() const {
 
 std::string ONNXSTT::create_stream(const nlohmann::json& config) {
 #if SHERPA_ONNX_AVAILABLE
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    if (!sherpa_recognizer_) {
+    std::shared_lock<std::shared_mutex> lock(model_mutex_);
+
+    auto entry = std::make_shared<StreamEntry>();
+    if (online_recognizer_) {
+        entry->online = SherpaOnnxCreateOnlineStream(online_recognizer_);
+        if (!entry->online) {
+            RAC_LOG_ERROR("ONNX.STT", "Failed to create online stream");
+            return "";
+        }
+    } else if (sherpa_recognizer_) {
+        entry->offline = SherpaOnnxCreateOfflineStream(sherpa_recognizer_);
+        if (!entry->offline) {
+            RAC_LOG_ERROR("ONNX.STT", "Failed to create offline stream");
+            return "";
+        }
+    } else {
         RAC_LOG_ERROR("ONNX.STT", "Cannot create stream: recognizer not initialized");
         return "";
     }
 
-    const SherpaOnnxOfflineStream* stream = SherpaOnnxCreateOfflineStream(sherpa_recognizer_);
-    if (!stream) {
-        RAC_LOG_ERROR("ONNX.STT", "Failed to create offline stream");
-        return "";
-    }
-
+    std::lock_guard<std::mutex> streams_lock(streams_mutex_);
     std::string stream_id = "stt_stream_" + std::to_string(++stream_counter_);
-    sherpa_streams_[stream_id] = stream;
+    sherpa_streams_[stream_id] = std::move(entry);
 
     RAC_LOG_DEBUG("ONNX.STT", "Created stream: %s", stream_id.c_str());
     return stream_id;
@@ -428,19 +860,28 @@ std::string ONNXSTT::create_stream(const nlohmann::json& config) {
 #endif
 }
 
-bool ONNXSTT::feed_audio(const std::string& stream_id, const std::vector<float>& samples,
+bool ONNXSTT::feed_audio(const std::string& stream_id, const float* samples, size_t num_samples,
                          int sample_rate) {
 #if SHERPA_ONNX_AVAILABLE
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_lock<std::shared_mutex> lock(model_mutex_);
 
-    auto it = sherpa_streams_.find(stream_id);
-    if (it == sherpa_streams_.end() || !it->second) {
+    auto entry = find_stream(stream_id);
+    if (!entry) {
         RAC_LOG_ERROR("ONNX.STT", "Stream not found: %s", stream_id.c_str());
         return false;
     }
 
-    SherpaOnnxAcceptWaveformOffline(it->second, sample_rate, samples.data(),
-                                    static_cast<int32_t>(samples.size()));
+    std::lock_guard<std::mutex> stream_lock(entry->mutex);
+    if (entry->online) {
+        SherpaOnnxOnlineStreamAcceptWaveform(entry->online, sample_rate, samples,
+                                             static_cast<int32_t>(num_samples));
+    } else if (entry->offline) {
+        SherpaOnnxAcceptWaveformOffline(entry->offline, sample_rate, samples,
+                                        static_cast<int32_t>(num_samples));
+        entry->has_pending_audio = true;
+    } else {
+        return false;
+    }
 
     return true;
 #else
@@ -450,9 +891,16 @@ bool ONNXSTT::feed_audio(const std::string& stream_id, const std::vector<float>&
 
 bool ONNXSTT::is_stream_ready(const std::string& stream_id) {
 #if SHERPA_ONNX_AVAILABLE
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = sherpa_streams_.find(stream_id);
-    return it != sherpa_streams_.end() && it->second != nullptr;
+    std::shared_lock<std::shared_mutex> lock(model_mutex_);
+    auto entry = find_stream(stream_id);
+    if (!entry) {
+        return false;
+    }
+    std::lock_guard<std::mutex> stream_lock(entry->mutex);
+    if (entry->online) {
+        return SherpaOnnxIsOnlineStreamReady(online_recognizer_, entry->online) != 0;
+    }
+    return entry->offline != nullptr;
 #else
     return false;
 #endif
@@ -462,74 +910,227 @@ STTResult ONNXSTT::decode(const std::string& stream_id) {
     STTResult result;
 
 #if SHERPA_ONNX_AVAILABLE
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_lock<std::shared_mutex> lock(model_mutex_);
 
-    auto it = sherpa_streams_.find(stream_id);
-    if (it == sherpa_streams_.end() || !it->second) {
+    auto entry = find_stream(stream_id);
+    if (!entry) {
         RAC_LOG_ERROR("ONNX.STT", "Stream not found for decode: %s", stream_id.c_str());
         return result;
     }
+    std::lock_guard<std::mutex> stream_lock(entry->mutex);
 
-    if (!sherpa_recognizer_) {
+    // Online streams only decode the frames that arrived since the last call,
+    // so the cost per call stays flat however long the utterance gets
+    if (entry->online) {
+        while (SherpaOnnxIsOnlineStreamReady(online_recognizer_, entry->online)) {
+            SherpaOnnxDecodeOnlineStream(online_recognizer_, entry->online);
+        }
+        result.text = online_text(entry->online);
+        result.is_final = SherpaOnnxOnlineStreamIsEndpoint(online_recognizer_, entry->online) != 0;
+        return result;
+    }
+
+    if (!entry->offline || !sherpa_recognizer_) {
         RAC_LOG_ERROR("ONNX.STT", "Recognizer not available");
         return result;
     }
 
-    SherpaOnnxDecodeOfflineStream(sherpa_recognizer_, it->second);
+    {
+        rac::ScopedCpuBudget cpu_budget(RAC_CPU_STAGE_STT, backend_->get_num_threads());
+        SherpaOnnxDecodeOfflineStream(sherpa_recognizer_, entry->offline);
+    }
+    entry->has_pending_audio = false;
+
+    result = offline_result(entry->offline);
+    RAC_LOG_DEBUG("ONNX.STT", "Decode result: \"%s\"", result.text.c_str());
+#endif
+
+    return result;
+}
+
+std::vector<std::pair<std::string, STTResult>> ONNXSTT::decode_batch(
+    const std::vector<std::string>& stream_ids) {
+    std::vector<std::pair<std::string, STTResult>> results;
+
+#if SHERPA_ONNX_AVAILABLE
+    std::shared_lock<std::shared_mutex> lock(model_mutex_);
+
+    std::vector<std::pair<std::string, std::shared_ptr<StreamEntry>>> entries;
+    {
+        std::lock_guard<std::mutex> map_lock(streams_mutex_);
+        if (stream_ids.empty()) {
+            for (const auto& kv : sherpa_streams_) {
+                if (kv.second->offline) {
+                    entries.emplace_back(kv.first, kv.second);
+                }
+            }
+        } else {
+            for (const auto& id : stream_ids) {
+                auto it = sherpa_streams_.find(id);
+                if (it == sherpa_streams_.end()) {
+                    RAC_LOG_ERROR("ONNX.STT", "Stream not found for decode: %s", id.c_str());
+                    continue;
+                }
+                entries.emplace_back(id, it->second);
+            }
+        }
+    }
+
+    // Stream locks are always taken in id order so two overlapping batches
+    // cannot deadlock; duplicates would self-deadlock and are dropped
+    std::sort(entries.begin(), entries.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    entries.erase(std::unique(entries.begin(), entries.end(),
+                              [](const auto& a, const auto& b) { return a.first == b.first; }),
+                  entries.end());
+
+    std::vector<std::unique_lock<std::mutex>> stream_locks;
+    stream_locks.reserve(entries.size());
+    for (auto& entry : entries) {
+        stream_locks.emplace_back(entry.second->mutex);
+    }
+
+    std::vector<const SherpaOnnxOfflineStream*> batch;
+    std::vector<size_t> batch_index;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const auto& entry = entries[i].second;
+        if (entry->offline && (!stream_ids.empty() || entry->has_pending_audio)) {
+            batch.push_back(entry->offline);
+            batch_index.push_back(i);
+        }
+    }
+
+    std::vector<STTResult> decoded(entries.size());
+    std::vector<bool> has_result(entries.size(), !stream_ids.empty());
+    if (!batch.empty() && sherpa_recognizer_) {
+        auto start = std::chrono::steady_clock::now();
+        {
+            rac::ScopedCpuBudget cpu_budget(RAC_CPU_STAGE_STT, backend_->get_num_threads());
+            SherpaOnnxDecodeMultipleOfflineStreams(sherpa_recognizer_, batch.data(),
+                                                   static_cast<int32_t>(batch.size()));
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+        RAC_LOG_INFO("ONNX.STT", "Batch decoded %zu streams in %lld ms", batch.size(),
+                     static_cast<long long>(elapsed));
+
+        for (size_t i : batch_index) {
+            entries[i].second->has_pending_audio = false;
+            decoded[i] = offline_result(entries[i].second->offline);
+            has_result[i] = true;
+        }
+    }
+
+    // Online streams have no batched call that fits the per-stream state
+    // machine; drain them one by one like decode() does
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const auto& entry = entries[i].second;
+        if (entry->online) {
+            while (SherpaOnnxIsOnlineStreamReady(online_recognizer_, entry->online)) {
+                SherpaOnnxDecodeOnlineStream(online_recognizer_, entry->online);
+            }
+            decoded[i].text = online_text(entry->online);
+            decoded[i].is_final =
+                SherpaOnnxOnlineStreamIsEndpoint(online_recognizer_, entry->online) != 0;
+            has_result[i] = true;
+        }
+        if (has_result[i]) {
+            results.emplace_back(entries[i].first, std::move(decoded[i]));
+        }
+    }
+#endif
+
+    return results;
+}
 
+#if SHERPA_ONNX_AVAILABLE
+STTResult ONNXSTT::offline_result(const SherpaOnnxOfflineStream* stream) const {
+    STTResult result;
     const SherpaOnnxOfflineRecognizerResult* recognizer_result =
-        SherpaOnnxGetOfflineStreamResult(it->second);
+        SherpaOnnxGetOfflineStreamResult(stream);
 
     if (recognizer_result && recognizer_result->text) {
         result.text = recognizer_result->text;
-        RAC_LOG_INFO("ONNX.STT", "Decode result: \"%s\"", result.text.c_str());
 
         if (recognizer_result->lang) {
             result.detected_language = recognizer_result->lang;
         }
-
+    }
+    if (recognizer_result) {
         SherpaOnnxDestroyOfflineRecognizerResult(recognizer_result);
     }
-#endif
-
     return result;
 }
+#endif
 
 bool ONNXSTT::is_endpoint(const std::string& stream_id) {
+#if SHERPA_ONNX_AVAILABLE
+    std::shared_lock<std::shared_mutex> lock(model_mutex_);
+    auto entry = find_stream(stream_id);
+    if (entry) {
+        std::lock_guard<std::mutex> stream_lock(entry->mutex);
+        if (entry->online) {
+            return SherpaOnnxOnlineStreamIsEndpoint(online_recognizer_, entry->online) != 0;
+        }
+    }
+#endif
     return false;
 }
 
-void ONNXSTT::input_finished(const std::string& stream_id) {}
+void ONNXSTT::input_finished(const std::string& stream_id) {
+#if SHERPA_ONNX_AVAILABLE
+    std::shared_lock<std::shared_mutex> lock(model_mutex_);
+    auto entry = find_stream(stream_id);
+    if (entry) {
+        std::lock_guard<std::mutex> stream_lock(entry->mutex);
+        if (entry->online) {
+            SherpaOnnxOnlineStreamInputFinished(entry->online);
+        }
+    }
+#endif
+}
 
 void ONNXSTT::reset_stream(const std::string& stream_id) {
 #if SHERPA_ONNX_AVAILABLE
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_lock<std::shared_mutex> lock(model_mutex_);
+    auto entry = find_stream(stream_id);
+    if (!entry) {
+        return;
+    }
+    std::lock_guard<std::mutex> stream_lock(entry->mutex);
 
-    auto it = sherpa_streams_.find(stream_id);
-    if (it != sherpa_streams_.end() && it->second) {
-        SherpaOnnxDestroyOfflineStream(it->second);
+    // Starts the next utterance after an endpoint; the model keeps its context
+    if (entry->online) {
+        SherpaOnnxOnlineStreamReset(online_recognizer_, entry->online);
+        return;
+    }
 
-        if (sherpa_recognizer_) {
-            it->second = SherpaOnnxCreateOfflineStream(sherpa_recognizer_);
-        } else {
-            sherpa_streams_.erase(it);
-        }
+    if (entry->offline) {
+        SherpaOnnxDestroyOfflineStream(entry->offline);
+        entry->offline =
+            sherpa_recognizer_ ? SherpaOnnxCreateOfflineStream(sherpa_recognizer_) : nullptr;
+        entry->has_pending_audio = false;
     }
 #endif
 }
 
 void ONNXSTT::destroy_stream(const std::string& stream_id) {
 #if SHERPA_ONNX_AVAILABLE
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    auto it = sherpa_streams_.find(stream_id);
-    if (it != sherpa_streams_.end()) {
-        if (it->second) {
-            SherpaOnnxDestroyOfflineStream(it->second);
+    // The sherpa stream goes with the last reference, after any call still using it
+    std::shared_lock<std::shared_mutex> lock(model_mutex_);
+    std::shared_ptr<StreamEntry> entry;
+    {
+        std::lock_guard<std::mutex> streams_lock(streams_mutex_);
+        auto it = sherpa_streams_.find(stream_id);
+        if (it == sherpa_streams_.end()) {
+            return;
         }
+        entry = std::move(it->second);
         sherpa_streams_.erase(it);
-        RAC_LOG_DEBUG("ONNX.STT", "Destroyed stream: %s", stream_id.c_str());
     }
+    entry.reset();
+    RAC_LOG_DEBUG("ONNX.STT", "Destroyed stream: %s", stream_id.c_str());
 #endif
 }
 
@@ -567,13 +1168,11 @@ bool ONNXTTS::is_ready() const {
 
 bool ONNXTTS::load_model(const std::string& model_path, TTSModelType model_type,
                          const nlohmann::json& config) {
+    RAC_TRACE_SCOPE("TTS.ONNX.load_model");
     std::lock_guard<std::mutex> lock(mutex_);
 
 #if SHERPA_ONNX_AVAILABLE
-    if (sherpa_tts_) {
-        SherpaOnnxDestroyOfflineTts(sherpa_tts_);
-        sherpa_tts_ = nullptr;
-    }
+    sherpa_tts_.reset();
 
     model_type_ = model_type;
     model_dir_ = model_path;
@@ -652,6 +1251,9 @@ bool ONNXTTS::load_model(const std::string& model_path, TTSModelType model_type,
         return false;
     }
 
+    std::string model_json_path = model_onnx_path + ".json";
+    model_onnx_path = backend_->optimized_model_path(model_onnx_path);
+
     SherpaOnnxOfflineTtsConfig tts_config;
     memset(&tts_config, 0, sizeof(tts_config));
 
@@ -672,8 +1274,8 @@ bool ONNXTTS::load_model(const std::string& model_path, TTSModelType model_type,
     tts_config.model.vits.noise_scale_w = 0.8f;
     tts_config.model.vits.length_scale = 1.0f;
 
-    tts_config.model.provider = "cpu";
-    tts_config.model.num_threads = 2;
+    tts_config.model.provider = backend_->get_sherpa_provider();
+    tts_config.model.num_threads = backend_->get_num_threads();
     tts_config.model.debug = 1;
 
     RAC_LOG_INFO("ONNX.TTS", "Creating SherpaOnnxOfflineTts...");
@@ -694,22 +1296,42 @@ bool ONNXTTS::load_model(const std::string& model_path, TTSModelType model_type,
         return false;
     }
 
-    sherpa_tts_ = new_tts;
+    sherpa_tts_ = std::shared_ptr<const SherpaOnnxOfflineTts>(new_tts, SherpaOnnxDestroyOfflineTts);
 
-    sample_rate_ = SherpaOnnxOfflineTtsSampleRate(sherpa_tts_);
-    int num_speakers = SherpaOnnxOfflineTtsNumSpeakers(sherpa_tts_);
+    sample_rate_ = SherpaOnnxOfflineTtsSampleRate(new_tts);
+    int num_speakers = SherpaOnnxOfflineTtsNumSpeakers(new_tts);
 
     RAC_LOG_INFO("ONNX.TTS", "TTS model loaded successfully");
     RAC_LOG_INFO("ONNX.TTS", "Sample rate: %d, speakers: %d", sample_rate_, num_speakers);
 
+    // Piper exports name their speakers in <model>.onnx.json
+    std::unordered_map<int, std::string> speaker_names;
+    std::ifstream model_json(model_json_path);
+    if (model_json.is_open()) {
+        nlohmann::json meta = nlohmann::json::parse(model_json, nullptr, false);
+        if (meta.is_object() && meta.contains("speaker_id_map") &&
+            meta["speaker_id_map"].is_object()) {
+            for (const auto& [name, id] : meta["speaker_id_map"].items()) {
+                if (id.is_number_integer()) {
+                    speaker_names[id.get<int>()] = name;
+                }
+            }
+        }
+    }
+
+    num_speakers_ = num_speakers;
     voices_.clear();
     for (int i = 0; i < num_speakers; ++i) {
         VoiceInfo voice;
         voice.id = std::to_string(i);
-        voice.name = "Speaker " + std::to_string(i);
+        auto name = speaker_names.find(i);
+        voice.name = name != speaker_names.end() ? name->second : "Speaker " + std::to_string(i);
         voice.language = "en";
+        voice.sample_rate = sample_rate_;
+        voice.speaker_id = i;
         voices_.push_back(voice);
     }
+    rebuild_voice_index();
 
     model_loaded_ = true;
     return true;
@@ -730,21 +1352,16 @@ bool ONNXTTS::unload_model() {
 #if SHERPA_ONNX_AVAILABLE
     model_loaded_ = false;
 
-    if (active_synthesis_count_ > 0) {
-        RAC_LOG_WARNING("ONNX.TTS",
-                       "Unloading model while %d synthesis operation(s) may be in progress",
-                       active_synthesis_count_.load());
-    }
-
     voices_.clear();
+    voice_index_.clear();
+    num_speakers_ = 0;
 
-    if (sherpa_tts_) {
-        SherpaOnnxDestroyOfflineTts(sherpa_tts_);
-        sherpa_tts_ = nullptr;
-    }
+    // Syntheses in flight hold their own reference; the engine goes with the last
+    sherpa_tts_.reset();
 #else
     model_loaded_ = false;
     voices_.clear();
+    voice_index_.clear();
 #endif
 
     return true;
@@ -758,14 +1375,9 @@ TTSResult ONNXTTS::synthesize(const TTSRequest& request) {
     TTSResult result;
 
 #if SHERPA_ONNX_AVAILABLE
-    struct SynthesisGuard {
-        std::atomic<int>& count_;
-        SynthesisGuard(std::atomic<int>& count) : count_(count) { count_++; }
-        ~SynthesisGuard() { count_--; }
-    };
-    SynthesisGuard guard(active_synthesis_count_);
-
-    const SherpaOnnxOfflineTts* tts_ptr = nullptr;
+    std::shared_ptr<const SherpaOnnxOfflineTts> tts;
+    int speaker_id = 0;
+    float speed = 1.0f;
     {
         std::lock_guard<std::mutex> lock(mutex_);
 
@@ -774,40 +1386,39 @@ TTSResult ONNXTTS::synthesize(const TTSRequest& request) {
             return result;
         }
 
-        tts_ptr = sherpa_tts_;
+        tts = sherpa_tts_;
+        const VoiceInfo& voice = resolve_voice(request.voice_id);
+        speaker_id = voice.speaker_id;
+        speed = (request.speed_rate > 0 ? request.speed_rate : 1.0f) * voice.speed;
     }
 
-    RAC_LOG_INFO("ONNX.TTS", "Synthesizing: \"%s...\"", request.text.substr(0, 50).c_str());
+    RAC_LOG_DEBUG("ONNX.TTS", "Synthesizing: \"%.50s...\"", request.text.c_str());
 
-    int speaker_id = 0;
-    if (!request.voice_id.empty()) {
-        try {
-            speaker_id = std::stoi(request.voice_id);
-        } catch (...) {}
-    }
+    RAC_LOG_DEBUG("ONNX.TTS", "Speaker ID: %d, Speed: %.2f", speaker_id, speed);
 
-    float speed = request.speed_rate > 0 ? request.speed_rate : 1.0f;
-
-    RAC_LOG_DEBUG("ONNX.TTS", "Speaker ID: %d, Speed: %.2f", speaker_id, speed);
-
-    const SherpaOnnxGeneratedAudio* audio =
-        SherpaOnnxOfflineTtsGenerate(tts_ptr, request.text.c_str(), speaker_id, speed);
+    const SherpaOnnxGeneratedAudio* audio = nullptr;
+    {
+        // TTS has the audio deadline: lower stages give up cores while it runs
+        rac::ScopedCpuBudget cpu_budget(RAC_CPU_STAGE_TTS, backend_->get_num_threads());
+        RAC_TRACE_SCOPE("TTS.generate");
+        audio = SherpaOnnxOfflineTtsGenerate(tts.get(), request.text.c_str(), speaker_id, speed);
+    }
 
     if (!audio || audio->n <= 0) {
         RAC_LOG_ERROR("ONNX.TTS", "Failed to generate audio");
         return result;
     }
 
-    RAC_LOG_INFO("ONNX.TTS", "Generated %d samples at %d Hz", audio->n, audio->sample_rate);
+    RAC_LOG_DEBUG("ONNX.TTS", "Generated %d samples at %d Hz", audio->n, audio->sample_rate);
 
-    result.audio_samples.assign(audio->samples, audio->samples + audio->n);
+    result.samples = std::shared_ptr<const float>(
+        audio->samples, [audio](const float*) { SherpaOnnxDestroyOfflineTtsGeneratedAudio(audio); });
+    result.num_samples = static_cast<size_t>(audio->n);
     result.sample_rate = audio->sample_rate;
     result.duration_ms =
         (static_cast<double>(audio->n) / static_cast<double>(audio->sample_rate)) * 1000.0;
 
-    SherpaOnnxDestroyOfflineTtsGeneratedAudio(audio);
-
-    RAC_LOG_INFO("ONNX.TTS", "Synthesis complete. Duration: %.2fs", (result.duration_ms / 1000.0));
+    RAC_LOG_DEBUG("ONNX.TTS", "Synthesis complete. Duration: %.2fs", (result.duration_ms / 1000.0));
 
 #else
     RAC_LOG_ERROR("ONNX.TTS", "Sherpa-ONNX not available");
@@ -816,8 +1427,293 @@ TTSResult ONNXTTS::synthesize(const TTSRequest& request) {
     return result;
 }
 
+// Splits text after sentence-ending punctuation (ASCII .!? followed by
+// whitespace, CJK 。！？) and newlines. Fragments without any letters or
+// digits are folded into the previous sentence.
+static std::vector<std::string> split_sentences(const std::string& text) {
+    std::vector<std::string> sentences;
+    std::string current;
+
+    auto flush = [&]() {
+        bool has_content = std::any_of(current.begin(), current.end(), [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || (c & 0x80);
+        });
+        if (has_content) {
+            sentences.push_back(current);
+        } else if (!sentences.empty()) {
+            sentences.back() += current;
+        }
+        current.clear();
+    };
+
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        current += c;
+
+        if (c == '\n') {
+            flush();
+        } else if (c == '.' || c == '!' || c == '?') {
+            if (i + 1 == text.size() || std::isspace(static_cast<unsigned char>(text[i + 1]))) {
+                flush();
+            }
+        } else if (text.compare(i, 3, "\xE3\x80\x82") == 0 ||  // 。
+                   text.compare(i, 3, "\xEF\xBC\x81") == 0 ||  // ！
+                   text.compare(i, 3, "\xEF\xBC\x9F") == 0) {  // ？
+            current.append(text, i + 1, 2);
+            i += 2;
+            flush();
+        }
+    }
+    flush();
+
+    return sentences;
+}
+
+#if SHERPA_ONNX_AVAILABLE
+namespace {
+struct StreamCallbackContext {
+    const TTSChunkCallback* on_chunk;
+    const std::atomic<bool>* cancel_requested;
+    int sample_rate;
+    size_t total_samples = 0;
+    bool stopped = false;
+};
+
+int32_t on_generated_audio(const float* samples, int32_t n, void* arg) {
+    auto* ctx = static_cast<StreamCallbackContext*>(arg);
+    if (ctx->cancel_requested->load()) {
+        ctx->stopped = true;
+        return 0;
+    }
+    if (n > 0) {
+        ctx->total_samples += static_cast<size_t>(n);
+        if (!(*ctx->on_chunk)(samples, static_cast<size_t>(n), ctx->sample_rate)) {
+            ctx->stopped = true;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Upper bound on sentences synthesized ahead of the one being delivered.
+// Beyond a few, the extra callers only contend for the session's thread pool.
+constexpr size_t kMaxSentenceWorkers = 3;
+
+// Sentences after the first, synthesized ahead by workers and delivered in order
+struct SentencePipeline {
+    const std::vector<std::string>* sentences;
+    const SherpaOnnxOfflineTts* tts;
+    int speaker_id;
+    float speed;
+    const std::atomic<bool>* cancel_requested;
+
+    std::atomic<size_t> next{1};
+    std::atomic<bool> stopped{false};
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<const SherpaOnnxGeneratedAudio*> audio;  // nullptr until generated
+    std::vector<bool> done;
+};
+
+void run_sentence_worker(SentencePipeline* pipeline) {
+    rac_cpu_budget_bind_current_thread(RAC_CPU_STAGE_TTS);
+    const std::vector<std::string>& sentences = *pipeline->sentences;
+    for (;;) {
+        if (pipeline->stopped || pipeline->cancel_requested->load()) {
+            break;
+        }
+        size_t index = pipeline->next.fetch_add(1);
+        if (index >= sentences.size()) {
+            break;
+        }
+
+        const SherpaOnnxGeneratedAudio* audio = nullptr;
+        {
+            RAC_TRACE_SCOPE("TTS.generate_sentence");
+            audio = SherpaOnnxOfflineTtsGenerate(pipeline->tts, sentences[index].c_str(),
+                                                 pipeline->speaker_id, pipeline->speed);
+        }
+        if (!audio) {
+            RAC_LOG_WARNING("ONNX.TTS", "Failed to generate audio for sentence: \"%.50s\"",
+                            sentences[index].c_str());
+        }
+
+        std::lock_guard<std::mutex> lock(pipeline->mutex);
+        pipeline->audio[index] = audio;
+        pipeline->done[index] = true;
+        pipeline->cv.notify_all();
+    }
+    // Wake the consumer so a cancel is noticed even with sentences outstanding
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+    pipeline->cv.notify_all();
+}
+}  // namespace
+#endif
+
+bool ONNXTTS::synthesize_stream(const TTSRequest& request, const TTSChunkCallback& on_chunk,
+                                TTSResult* summary) {
+#if SHERPA_ONNX_AVAILABLE
+    std::shared_ptr<const SherpaOnnxOfflineTts> tts;
+    int sample_rate = 0;
+    int speaker_id = 0;
+    float speed = 1.0f;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!sherpa_tts_ || !model_loaded_) {
+            RAC_LOG_ERROR("ONNX.TTS", "TTS not ready for synthesis");
+            return false;
+        }
+
+        tts = sherpa_tts_;
+        sample_rate = sample_rate_;
+        const VoiceInfo& voice = resolve_voice(request.voice_id);
+        speaker_id = voice.speaker_id;
+        speed = (request.speed_rate > 0 ? request.speed_rate : 1.0f) * voice.speed;
+    }
+    cancel_requested_ = false;
+
+    std::vector<std::string> sentences = split_sentences(request.text);
+    RAC_LOG_INFO("ONNX.TTS", "Streaming synthesis of %zu sentence(s)", sentences.size());
+
+    StreamCallbackContext ctx{&on_chunk, &cancel_requested_, sample_rate};
+    auto start_time = std::chrono::steady_clock::now();
+    double first_audio_ms = -1.0;
+    auto note_first_audio = [&]() {
+        if (first_audio_ms < 0 && ctx.total_samples > 0) {
+            first_audio_ms = std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - start_time)
+                                 .count();
+            RAC_LOG_INFO("ONNX.TTS", "First audio after %.0f ms", first_audio_ms);
+        }
+    };
+
+    // The first sentence streams on this thread with the session's own pool.
+    // Concurrent generates share that pool and each add only their calling
+    // thread, so every thread granted beyond it runs one more sentence ahead.
+    const int32_t session_threads = backend_->get_num_threads();
+    rac::ScopedCpuBudget cpu_budget(RAC_CPU_STAGE_TTS,
+                                    session_threads + static_cast<int32_t>(kMaxSentenceWorkers));
+    size_t num_workers = 0;
+    if (sentences.size() > 1 && cpu_budget.threads() > session_threads) {
+        num_workers = std::min({kMaxSentenceWorkers, sentences.size() - 1,
+                                static_cast<size_t>(cpu_budget.threads() - session_threads)});
+    }
+
+    if (num_workers == 0) {
+        for (const auto& sentence : sentences) {
+            RAC_TRACE_SCOPE("TTS.generate_sentence");
+            const SherpaOnnxGeneratedAudio* audio = SherpaOnnxOfflineTtsGenerateWithCallbackWithArg(
+                tts.get(), sentence.c_str(), speaker_id, speed, on_generated_audio, &ctx);
+            if (audio) {
+                SherpaOnnxDestroyOfflineTtsGeneratedAudio(audio);
+            } else {
+                RAC_LOG_WARNING("ONNX.TTS", "Failed to generate audio for sentence: \"%.50s\"",
+                                sentence.c_str());
+            }
+
+            note_first_audio();
+            if (ctx.stopped || cancel_requested_) {
+                RAC_LOG_INFO("ONNX.TTS", "Streaming synthesis stopped");
+                break;
+            }
+        }
+    } else {
+        RAC_LOG_DEBUG("ONNX.TTS", "Synthesizing ahead with %zu worker(s)", num_workers);
+
+        SentencePipeline pipeline;
+        pipeline.sentences = &sentences;
+        pipeline.tts = tts.get();
+        pipeline.speaker_id = speaker_id;
+        pipeline.speed = speed;
+        pipeline.cancel_requested = &cancel_requested_;
+        pipeline.audio.assign(sentences.size(), nullptr);
+        pipeline.done.assign(sentences.size(), false);
+
+        std::vector<std::thread> workers;
+        workers.reserve(num_workers);
+        for (size_t i = 0; i < num_workers; ++i) {
+            workers.emplace_back(run_sentence_worker, &pipeline);
+        }
+
+        {
+            RAC_TRACE_SCOPE("TTS.generate_sentence");
+            const SherpaOnnxGeneratedAudio* audio = SherpaOnnxOfflineTtsGenerateWithCallbackWithArg(
+                tts.get(), sentences[0].c_str(), speaker_id, speed, on_generated_audio, &ctx);
+            if (audio) {
+                SherpaOnnxDestroyOfflineTtsGeneratedAudio(audio);
+            } else {
+                RAC_LOG_WARNING("ONNX.TTS", "Failed to generate audio for sentence: \"%.50s\"",
+                                sentences[0].c_str());
+            }
+        }
+        note_first_audio();
+
+        // Deliver the rest in order as each one is ready
+        for (size_t i = 1; i < sentences.size() && !ctx.stopped && !cancel_requested_; ++i) {
+            const SherpaOnnxGeneratedAudio* audio = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(pipeline.mutex);
+                pipeline.cv.wait(lock, [&] {
+                    return pipeline.done[i] || cancel_requested_.load();
+                });
+                if (!pipeline.done[i]) {
+                    break;
+                }
+                audio = pipeline.audio[i];
+                pipeline.audio[i] = nullptr;
+            }
+            if (audio) {
+                if (audio->n > 0) {
+                    on_generated_audio(audio->samples, audio->n, &ctx);
+                }
+                SherpaOnnxDestroyOfflineTtsGeneratedAudio(audio);
+            }
+            note_first_audio();
+        }
+        if (ctx.stopped || cancel_requested_) {
+            RAC_LOG_INFO("ONNX.TTS", "Streaming synthesis stopped");
+        }
+
+        pipeline.stopped = true;
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const SherpaOnnxGeneratedAudio* audio : pipeline.audio) {
+            if (audio) {
+                SherpaOnnxDestroyOfflineTtsGeneratedAudio(audio);
+            }
+        }
+    }
+
+    if (ctx.total_samples == 0 && !ctx.stopped) {
+        RAC_LOG_ERROR("ONNX.TTS", "Failed to generate audio");
+        return false;
+    }
+
+    if (summary) {
+        summary->samples.reset();
+        summary->num_samples = 0;
+        summary->sample_rate = sample_rate;
+        summary->duration_ms =
+            (static_cast<double>(ctx.total_samples) / static_cast<double>(sample_rate)) * 1000.0;
+        summary->inference_time_ms = std::chrono::duration<double, std::milli>(
+                                         std::chrono::steady_clock::now() - start_time)
+                                         .count();
+    }
+    return true;
+#else
+    RAC_LOG_ERROR("ONNX.TTS", "Sherpa-ONNX not available");
+    return false;
+#endif
+}
+
 bool ONNXTTS::supports_streaming() const {
+#if SHERPA_ONNX_AVAILABLE
+    return true;
+#else
     return false;
+#endif
 }
 
 void ONNXTTS::cancel() {
@@ -833,10 +1729,86 @@ std::string ONNXTTS::get_default_voice(const std::string& language) const {
     return "0";
 }
 
+bool ONNXTTS::add_voice(const VoiceInfo& voice) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!model_loaded_ || voice.id.empty()) {
+        return false;
+    }
+    if (voice.speaker_id < 0 || voice.speaker_id >= std::max(num_speakers_, 1)) {
+        RAC_LOG_ERROR("ONNX.TTS", "Voice %s: speaker %d out of range (model has %d)",
+                      voice.id.c_str(), voice.speaker_id, num_speakers_);
+        return false;
+    }
+
+    VoiceInfo entry = voice;
+    entry.sample_rate = sample_rate_;
+    if (entry.speed <= 0) {
+        entry.speed = 1.0f;
+    }
+
+    auto it = std::find_if(voices_.begin(), voices_.end(),
+                           [&](const VoiceInfo& v) { return v.id == voice.id; });
+    if (it != voices_.end()) {
+        *it = entry;
+    } else {
+        voices_.push_back(entry);
+    }
+    rebuild_voice_index();
+
+    RAC_LOG_INFO("ONNX.TTS", "Registered voice %s (speaker %d, speed %.2f)", entry.id.c_str(),
+                 entry.speaker_id, entry.speed);
+    return true;
+}
+
+bool ONNXTTS::remove_voice(const std::string& voice_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = std::find_if(voices_.begin(), voices_.end(),
+                           [&](const VoiceInfo& v) { return v.id == voice_id; });
+    if (it == voices_.end()) {
+        return false;
+    }
+    voices_.erase(it);
+    rebuild_voice_index();
+    return true;
+}
+
+const VoiceInfo& ONNXTTS::resolve_voice(const std::string& voice_id) const {
+    static const VoiceInfo kDefaultVoice;
+
+    auto it = voice_index_.find(voice_id);
+    if (it != voice_index_.end()) {
+        return voices_[it->second];
+    }
+    if (!voice_id.empty()) {
+        RAC_LOG_WARNING("ONNX.TTS", "Unknown voice %s, using speaker 0", voice_id.c_str());
+    }
+    return voices_.empty() ? kDefaultVoice : voices_.front();
+}
+
+void ONNXTTS::rebuild_voice_index() {
+    // Names go in first so an id always wins over a clashing name
+    voice_index_.clear();
+    for (size_t i = 0; i < voices_.size(); ++i) {
+        if (!voices_[i].name.empty()) {
+            voice_index_[voices_[i].name] = i;
+        }
+    }
+    for (size_t i = 0; i < voices_.size(); ++i) {
+        voice_index_[voices_[i].id] = i;
+    }
+}
+
 // =============================================================================
 // ONNXVAD Implementation
 // =============================================================================
 
+// Silero evaluates fixed 32 ms frames at 16 kHz
+static constexpr int kVADSampleRate = 16000;
+static constexpr int kVADFrameSamples = 512;
+static constexpr double kVADFrameMs = 1000.0 * kVADFrameSamples / kVADSampleRate;
+
 ONNXVAD::ONNXVAD(ONNXBackendNew* backend) : backend_(backend) {}
 
 ONNXVAD::~ONNXVAD() {
@@ -844,56 +1816,714 @@ ONNXVAD::~ONNXVAD() {
 }
 
 bool ONNXVAD::is_ready() const {
-    return model_loaded_;
+    return model_loaded_ && session_ != nullptr;
 }
 
 bool ONNXVAD::load_model(const std::string& model_path, VADModelType model_type,
                          const nlohmann::json& config) {
+    RAC_TRACE_SCOPE("VAD.ONNX.load_model");
     std::lock_guard<std::mutex> lock(mutex_);
+    release_session();
+
+    if (model_type != VADModelType::SILERO) {
+        RAC_LOG_ERROR("ONNX.VAD", "Only Silero VAD models are supported");
+        return false;
+    }
+
+    const OrtApi* api = backend_->get_ort_api();
+    if (!api || !backend_->get_ort_env()) {
+        RAC_LOG_ERROR("ONNX.VAD", "ONNX Runtime not initialized");
+        return false;
+    }
+
+    std::string path = model_path;
+    struct stat path_stat;
+    if (stat(path.c_str(), &path_stat) == 0 && S_ISDIR(path_stat.st_mode)) {
+        path += "/silero_vad.onnx";
+    }
+    path = backend_->optimized_model_path(path);
+
+    OrtSessionOptions* options = nullptr;
+    if (!ort_ok(api, api->CreateSessionOptions(&options), "CreateSessionOptions")) {
+        return false;
+    }
+    backend_->apply_session_options(options);
+    if (!backend_->get_runtime_config().use_global_thread_pool) {
+        // The network is tiny; more than one intra-op thread only adds overhead
+        const int num_threads =
+            config.contains("num_threads") ? config["num_threads"].get<int>() : 1;
+        ort_ok(api, api->SetIntraOpNumThreads(options, std::max(1, num_threads)),
+               "SetIntraOpNumThreads");
+    }
+    const bool created = ort_ok(
+        api, api->CreateSession(backend_->get_ort_env(), path.c_str(), options, &session_),
+        "CreateSession");
+    api->ReleaseSessionOptions(options);
+    if (!created) {
+        session_ = nullptr;
+        return false;
+    }
+
+    OrtAllocator* allocator = nullptr;
+    size_t input_count = 0;
+    size_t output_count = 0;
+    if (!ort_ok(api, api->GetAllocatorWithDefaultOptions(&allocator), "GetAllocator") ||
+        !ort_ok(api, api->SessionGetInputCount(session_, &input_count), "SessionGetInputCount") ||
+        !ort_ok(api, api->SessionGetOutputCount(session_, &output_count), "SessionGetOutputCount")) {
+        release_session();
+        return false;
+    }
+    for (size_t i = 0; i < input_count + output_count; ++i) {
+        char* name = nullptr;
+        OrtStatus* status = i < input_count
+                                ? api->SessionGetInputName(session_, i, allocator, &name)
+                                : api->SessionGetOutputName(session_, i - input_count, allocator,
+                                                            &name);
+        if (!ort_ok(api, status, "SessionGetName")) {
+            release_session();
+            return false;
+        }
+        (i < input_count ? input_names_ : output_names_).emplace_back(name);
+        api->AllocatorFree(allocator, name);
+    }
+
+    auto has_input = [this](const char* name) {
+        return std::find(input_names_.begin(), input_names_.end(), name) != input_names_.end();
+    };
+    if (has_input("state")) {
+        // v5: state [2, batch, 128], input carries 64 samples of context
+        state_tensors_ = 1;
+        state_dim_ = 128;
+        context_samples_ = 64;
+    } else if (has_input("h") && has_input("c")) {
+        // v4: h and c [2, batch, 64] each
+        state_tensors_ = 2;
+        state_dim_ = 64;
+        context_samples_ = 0;
+    } else {
+        RAC_LOG_ERROR("ONNX.VAD", "Unrecognized VAD model inputs: %s", path.c_str());
+        release_session();
+        return false;
+    }
+    if (!has_input("input") || output_names_.size() != static_cast<size_t>(1 + state_tensors_)) {
+        RAC_LOG_ERROR("ONNX.VAD", "Unexpected VAD model signature: %s", path.c_str());
+        release_session();
+        return false;
+    }
+
+    if (!ort_ok(api, api->CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &memory_info_),
+                "CreateCpuMemoryInfo")) {
+        release_session();
+        return false;
+    }
+
+    if (config.contains("threshold")) {
+        config_.threshold = config["threshold"].get<float>();
+    }
+
     model_loaded_ = true;
+    RAC_LOG_INFO("ONNX.VAD", "Silero VAD %s loaded: %s", state_tensors_ == 1 ? "v5" : "v4",
+                 path.c_str());
     return true;
 }
 
+void ONNXVAD::release_session() {
+    const OrtApi* api = backend_->get_ort_api();
+    streams_.clear();  // their state belongs to this model's layout
+    if (api && session_) {
+        api->ReleaseSession(session_);
+    }
+    if (api && memory_info_) {
+        api->ReleaseMemoryInfo(memory_info_);
+    }
+    session_ = nullptr;
+    memory_info_ = nullptr;
+    input_names_.clear();
+    output_names_.clear();
+    model_loaded_ = false;
+}
+
 bool ONNXVAD::is_model_loaded() const {
     return model_loaded_;
 }
 
 bool ONNXVAD::unload_model() {
     std::lock_guard<std::mutex> lock(mutex_);
-    model_loaded_ = false;
+    release_session();
     return true;
 }
 
 bool ONNXVAD::configure_vad(const VADConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
     config_ = config;
+    for (auto& pair : streams_) {
+        pair.second->config.threshold = config.threshold;
+    }
+    return true;
+}
+
+std::shared_ptr<VADStreamState> ONNXVAD::new_stream_state(const VADConfig& config) const {
+    auto stream = std::make_shared<VADStreamState>();
+    stream->config = config;
+    stream->model_state.assign(static_cast<size_t>(state_tensors_) * 2 * state_dim_, 0.0f);
+    stream->context.assign(context_samples_, 0.0f);
+    return stream;
+}
+
+bool ONNXVAD::append_audio(VADStreamState& stream, const float* samples, size_t num_samples,
+                           int sample_rate) {
+    if (sample_rate == kVADSampleRate || sample_rate <= 0) {
+        stream.pending.insert(stream.pending.end(), samples, samples + num_samples);
+        return true;
+    }
+
+    if (!stream.resampler || stream.resampler_rate != sample_rate) {
+        rac_audio_resampler_destroy(stream.resampler);
+        stream.resampler = nullptr;
+        if (rac_audio_resampler_create(sample_rate, kVADSampleRate, &stream.resampler) !=
+            RAC_SUCCESS) {
+            stream.resampler_rate = 0;
+            return false;
+        }
+        stream.resampler_rate = sample_rate;
+    }
+
+    const size_t offset = stream.pending.size();
+    stream.pending.resize(offset + rac_audio_resampler_max_output(stream.resampler, num_samples));
+    size_t written = 0;
+    const rac_result_t rc =
+        rac_audio_resampler_process(stream.resampler, samples, num_samples,
+                                    stream.pending.data() + offset, stream.pending.size() - offset,
+                                    &written);
+    stream.pending.resize(offset + written);
+    return rc == RAC_SUCCESS;
+}
+
+bool ONNXVAD::infer(const std::vector<VADStreamState*>& lanes, std::vector<float>& probabilities) {
+    const OrtApi* api = backend_->get_ort_api();
+    const int64_t batch = static_cast<int64_t>(lanes.size());
+    const int64_t width = context_samples_ + kVADFrameSamples;
+    const size_t lane_state = static_cast<size_t>(2) * state_dim_;
+
+    // Each lane's next frame sits at the front of its pending buffer
+    std::vector<float> input(static_cast<size_t>(batch * width));
+    std::vector<std::vector<float>> states(state_tensors_,
+                                           std::vector<float>(lane_state * lanes.size()));
+    for (size_t b = 0; b < lanes.size(); ++b) {
+        float* row = input.data() + b * width;
+        std::copy(lanes[b]->context.begin(), lanes[b]->context.end(), row);
+        std::copy(lanes[b]->pending.begin(), lanes[b]->pending.begin() + kVADFrameSamples,
+                  row + context_samples_);
+        // Stream state is [tensor][direction][dim]; the model wants [direction][batch][dim]
+        for (int t = 0; t < state_tensors_; ++t) {
+            for (int d = 0; d < 2; ++d) {
+                const float* src = lanes[b]->model_state.data() + t * lane_state + d * state_dim_;
+                std::copy(src, src + state_dim_,
+                          states[t].data() + (d * lanes.size() + b) * state_dim_);
+            }
+        }
+    }
+    int64_t sample_rate = kVADSampleRate;
+
+    const int64_t input_shape[2] = {batch, width};
+    const int64_t state_shape[3] = {2, batch, state_dim_};
+    std::vector<OrtValue*> inputs(input_names_.size(), nullptr);
+    std::vector<OrtValue*> outputs(output_names_.size(), nullptr);
+    auto release_all = [&]() {
+        for (OrtValue* value : inputs) {
+            if (value) {
+                api->ReleaseValue(value);
+            }
+        }
+        for (OrtValue* value : outputs) {
+            if (value) {
+                api->ReleaseValue(value);
+            }
+        }
+    };
+
+    bool ok = true;
+    for (size_t i = 0; i < input_names_.size() && ok; ++i) {
+        const std::string& name = input_names_[i];
+        if (name == "input") {
+            ok = ort_ok(api,
+                        api->CreateTensorWithDataAsOrtValue(
+                            memory_info_, input.data(), input.size() * sizeof(float), input_shape,
+                            2, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, &inputs[i]),
+                        "CreateTensor(input)");
+        } else if (name == "sr") {
+            ok = ort_ok(api,
+                        api->CreateTensorWithDataAsOrtValue(memory_info_, &sample_rate,
+                                                            sizeof(sample_rate), nullptr, 0,
+                                                            ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64,
+                                                            &inputs[i]),
+                        "CreateTensor(sr)");
+        } else {
+            std::vector<float>& state = states[name == "c" ? 1 : 0];
+            ok = ort_ok(api,
+                        api->CreateTensorWithDataAsOrtValue(
+                            memory_info_, state.data(), state.size() * sizeof(float), state_shape,
+                            3, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, &inputs[i]),
+                        "CreateTensor(state)");
+        }
+    }
+
+    std::vector<const char*> input_names;
+    std::vector<const char*> output_names;
+    for (const auto& name : input_names_) {
+        input_names.push_back(name.c_str());
+    }
+    for (const auto& name : output_names_) {
+        output_names.push_back(name.c_str());
+    }
+    ok = ok && ort_ok(api,
+                      api->Run(session_, nullptr, input_names.data(), inputs.data(), inputs.size(),
+                               output_names.data(), outputs.size(), outputs.data()),
+                      "Run");
+
+    // Outputs: probability [batch, 1], then the new state tensors
+    std::vector<float*> data(outputs.size(), nullptr);
+    for (size_t i = 0; i < outputs.size() && ok; ++i) {
+        ok = ort_ok(api, api->GetTensorMutableData(outputs[i], reinterpret_cast<void**>(&data[i])),
+                    "GetTensorMutableData");
+    }
+    if (ok) {
+        probabilities.assign(data[0], data[0] + lanes.size());
+        for (size_t b = 0; b < lanes.size(); ++b) {
+            for (int t = 0; t < state_tensors_; ++t) {
+                for (int d = 0; d < 2; ++d) {
+                    const float* src = data[1 + t] + (d * lanes.size() + b) * state_dim_;
+                    std::copy(src, src + state_dim_,
+                              lanes[b]->model_state.data() + t * lane_state + d * state_dim_);
+                }
+            }
+        }
+    }
+
+    release_all();
+    return ok;
+}
+
+bool ONNXVAD::run_frames(const std::vector<VADStreamState*>& lanes,
+                         std::vector<VADResult>& results) {
+    // Frames within a stream are sequential through its LSTM state, so
+    // each step batches the next frame of every stream that has one
+    std::vector<VADStreamState*> active;
+    std::vector<size_t> active_index;
+    std::vector<float> probabilities;
+    while (true) {
+        active.clear();
+        active_index.clear();
+        for (size_t i = 0; i < lanes.size(); ++i) {
+            if (lanes[i]->pending.size() >= static_cast<size_t>(kVADFrameSamples)) {
+                active.push_back(lanes[i]);
+                active_index.push_back(i);
+            }
+        }
+        if (active.empty()) {
+            break;
+        }
+        if (!infer(active, probabilities)) {
+            return false;
+        }
+        for (size_t a = 0; a < active.size(); ++a) {
+            VADStreamState& stream = *active[a];
+            if (context_samples_ > 0) {
+                std::copy(stream.pending.begin() + kVADFrameSamples - context_samples_,
+                          stream.pending.begin() + kVADFrameSamples, stream.context.begin());
+            }
+            stream.pending.erase(stream.pending.begin(),
+                                 stream.pending.begin() + kVADFrameSamples);
+            stream.frames++;
+            stream.last_probability = probabilities[a];
+            update_segments(stream, probabilities[a], results[active_index[a]]);
+        }
+    }
+
+    for (size_t i = 0; i < lanes.size(); ++i) {
+        results[i].is_speech = lanes[i]->triggered;
+        results[i].probability = lanes[i]->last_probability;
+        results[i].timestamp_ms = lanes[i]->frames * kVADFrameMs;
+    }
     return true;
 }
 
-VADResult ONNXVAD::process(const std::vector<float>& audio_samples, int sample_rate) {
+void ONNXVAD::update_segments(VADStreamState& stream, float probability, VADResult& result) const {
+    // Hysteresis as in the reference iterator: speech starts at threshold and
+    // ends after min_silence below threshold - 0.15
+    const VADConfig& config = stream.config;
+    const double frame_end_ms = stream.frames * kVADFrameMs;
+    const double frame_start_ms = frame_end_ms - kVADFrameMs;
+    const float end_threshold = std::max(config.threshold - 0.15f, 0.01f);
+
+    if (probability >= config.threshold) {
+        stream.silence_start_ms = -1.0;
+        if (!stream.triggered) {
+            stream.triggered = true;
+            stream.speech_start_ms = frame_start_ms;
+        }
+        return;
+    }
+    if (!stream.triggered || probability >= end_threshold) {
+        return;
+    }
+    if (stream.silence_start_ms < 0.0) {
+        stream.silence_start_ms = frame_start_ms;
+    }
+    if (frame_end_ms - stream.silence_start_ms < config.min_silence_duration_ms) {
+        return;
+    }
+
+    if (stream.silence_start_ms - stream.speech_start_ms >= config.min_speech_duration_ms) {
+        SpeechSegment segment;
+        segment.start_time_ms = std::max(0.0, stream.speech_start_ms - config.padding_ms);
+        segment.end_time_ms = stream.silence_start_ms + config.padding_ms;
+        segment.confidence = config.threshold;
+        result.segments.push_back(segment);
+    }
+    stream.triggered = false;
+    stream.silence_start_ms = -1.0;
+}
+
+VADResult ONNXVAD::process(const float* samples, size_t num_samples, int sample_rate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
     VADResult result;
+    if (!is_ready()) {
+        return result;
+    }
+
+    auto stream = new_stream_state(config_);
+    if (!append_audio(*stream, samples, num_samples, sample_rate)) {
+        return result;
+    }
+    std::vector<VADResult> results(1);
+    if (!run_frames({stream.get()}, results)) {
+        return result;
+    }
+    result = std::move(results[0]);
+
+    // Speech running to the end of the buffer closes there
+    if (stream->triggered) {
+        const double end_ms = stream->frames * kVADFrameMs;
+        if (end_ms - stream->speech_start_ms >= stream->config.min_speech_duration_ms) {
+            SpeechSegment segment;
+            segment.start_time_ms =
+                std::max(0.0, stream->speech_start_ms - stream->config.padding_ms);
+            segment.end_time_ms = end_ms;
+            segment.confidence = stream->config.threshold;
+            result.segments.push_back(segment);
+        }
+    }
+    result.is_speech = !result.segments.empty();
     return result;
 }
 
-std::vector<SpeechSegment> ONNXVAD::detect_segments(const std::vector<float>& audio_samples,
-                                                    int sample_rate) {
-    return {};
+std::string ONNXVAD::create_stream(const VADConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_ready()) {
+        return "";
+    }
+
+    const std::string stream_id = "vad_stream_" + std::to_string(++stream_counter_);
+    streams_[stream_id] = new_stream_state(config);
+    return stream_id;
 }
 
-std::string ONNXVAD::create_stream(const VADConfig& config) {
-    return "";
+VADResult ONNXVAD::feed_audio(const std::string& stream_id, const float* samples,
+                              size_t num_samples, int sample_rate) {
+    std::vector<VADResult> results = feed_audio_batch({{stream_id, samples, num_samples, sample_rate}});
+    return results.empty() ? VADResult{} : std::move(results[0]);
 }
 
-VADResult ONNXVAD::feed_audio(const std::string& stream_id, const std::vector<float>& samples,
-                              int sample_rate) {
-    return {};
+std::vector<VADResult> ONNXVAD::feed_audio_batch(const std::vector<VADStreamInput>& inputs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<VADResult> results(inputs.size());
+    if (!is_ready()) {
+        return results;
+    }
+
+    std::vector<VADStreamState*> lanes;
+    std::vector<size_t> lane_index;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        auto it = streams_.find(inputs[i].stream_id);
+        if (it == streams_.end()) {
+            RAC_LOG_WARNING("ONNX.VAD", "Unknown VAD stream: %s", inputs[i].stream_id.c_str());
+            continue;
+        }
+        // A stream listed twice gets its audio appended in order
+        if (!append_audio(*it->second, inputs[i].samples, inputs[i].num_samples,
+                          inputs[i].sample_rate)) {
+            RAC_LOG_ERROR("ONNX.VAD", "Failed to resample audio from %d Hz",
+                          inputs[i].sample_rate);
+            continue;
+        }
+        if (std::find(lanes.begin(), lanes.end(), it->second.get()) == lanes.end()) {
+            lanes.push_back(it->second.get());
+            lane_index.push_back(i);
+        }
+    }
+
+    std::vector<VADResult> lane_results(lanes.size());
+    run_frames(lanes, lane_results);
+    for (size_t l = 0; l < lanes.size(); ++l) {
+        results[lane_index[l]] = std::move(lane_results[l]);
+    }
+    return results;
 }
 
-void ONNXVAD::destroy_stream(const std::string& stream_id) {}
+void ONNXVAD::reset_stream(const std::string& stream_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(stream_id);
+    if (it != streams_.end()) {
+        it->second = new_stream_state(it->second->config);
+    }
+}
 
-void ONNXVAD::reset() {}
+void ONNXVAD::destroy_stream(const std::string& stream_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_.erase(stream_id);
+}
+
+void ONNXVAD::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& pair : streams_) {
+        pair.second = new_stream_state(pair.second->config);
+    }
+}
 
 VADConfig ONNXVAD::get_vad_config() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return config_;
 }
 
+// =============================================================================
+// ONNXKWS Implementation
+// =============================================================================
+
+ONNXKWS::ONNXKWS(ONNXBackendNew* backend) : backend_(backend) {}
+
+ONNXKWS::~ONNXKWS() {
+    unload_model();
+}
+
+bool ONNXKWS::is_ready() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+#if SHERPA_ONNX_AVAILABLE
+    return spotter_ != nullptr && stream_ != nullptr;
+#else
+    return false;
+#endif
+}
+
+bool ONNXKWS::load_model(const std::string& model_path, const nlohmann::json& config) {
+    RAC_TRACE_SCOPE("KWS.ONNX.load_model");
+#if SHERPA_ONNX_AVAILABLE
+    unload_model();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    RAC_LOG_INFO("ONNX.KWS", "Loading model from: %s", model_path.c_str());
+
+    DIR* dir = opendir(model_path.c_str());
+    if (!dir) {
+        RAC_LOG_ERROR("ONNX.KWS", "Cannot open model directory: %s", model_path.c_str());
+        return false;
+    }
+
+    // KWS releases ship fp32 and int8 copies side by side; int8 wins when present
+    std::string encoder_path;
+    std::string decoder_path;
+    std::string joiner_path;
+    std::string tokens_path;
+    std::string keywords_path;
+    auto pick = [](std::string& slot, const std::string& filename, const std::string& full_path) {
+        if (slot.empty() || filename.find(".int8.") != std::string::npos) {
+            slot = full_path;
+        }
+    };
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string filename = entry->d_name;
+        std::string full_path = model_path + "/" + filename;
+        bool is_onnx = filename.size() > 5 && filename.substr(filename.size() - 5) == ".onnx";
+
+        if (is_onnx && filename.find("encoder") != std::string::npos) {
+            pick(encoder_path, filename, full_path);
+        } else if (is_onnx && filename.find("decoder") != std::string::npos) {
+            pick(decoder_path, filename, full_path);
+        } else if (is_onnx && filename.find("joiner") != std::string::npos) {
+            pick(joiner_path, filename, full_path);
+        } else if (filename == "tokens.txt") {
+            tokens_path = full_path;
+        } else if (filename == "keywords.txt") {
+            keywords_path = full_path;
+        }
+    }
+    closedir(dir);
+
+    if (encoder_path.empty() || decoder_path.empty() || joiner_path.empty() ||
+        tokens_path.empty()) {
+        RAC_LOG_ERROR("ONNX.KWS", "Model needs encoder, decoder, joiner and tokens.txt: %s",
+                      model_path.c_str());
+        return false;
+    }
+
+    std::string keywords;
+    if (config.contains("keywords") && config["keywords"].is_string()) {
+        keywords = config["keywords"].get<std::string>();
+    }
+    if (keywords.empty() && keywords_path.empty()) {
+        RAC_LOG_ERROR("ONNX.KWS", "No keywords given and no keywords.txt in: %s",
+                      model_path.c_str());
+        return false;
+    }
+
+    encoder_path = backend_->optimized_model_path(encoder_path);
+    decoder_path = backend_->optimized_model_path(decoder_path);
+    joiner_path = backend_->optimized_model_path(joiner_path);
+
+    SherpaOnnxKeywordSpotterConfig kws_config;
+    memset(&kws_config, 0, sizeof(kws_config));
+
+    kws_config.feat_config.sample_rate = 16000;
+    kws_config.feat_config.feature_dim = 80;
+
+    kws_config.model_config.transducer.encoder = encoder_path.c_str();
+    kws_config.model_config.transducer.decoder = decoder_path.c_str();
+    kws_config.model_config.transducer.joiner = joiner_path.c_str();
+    kws_config.model_config.paraformer.encoder = "";
+    kws_config.model_config.paraformer.decoder = "";
+    kws_config.model_config.zipformer2_ctc.model = "";
+    kws_config.model_config.tokens = tokens_path.c_str();
+    // Spotting runs alongside everything else in a voice session; one thread
+    // keeps it well under real time on the models it is meant for
+    kws_config.model_config.num_threads = config.value("num_threads", 1);
+    kws_config.model_config.provider = backend_->get_sherpa_provider();
+    kws_config.model_config.debug = 0;
+    kws_config.model_config.model_type = "";
+    kws_config.model_config.modeling_unit = "cjkchar";
+    kws_config.model_config.bpe_vocab = "";
+
+    kws_config.max_active_paths = 4;
+    kws_config.num_trailing_blanks = 1;
+    kws_config.keywords_score = config.value("keywords_score", 1.0f);
+    kws_config.keywords_threshold = config.value("keywords_threshold", 0.25f);
+    if (!keywords.empty()) {
+        kws_config.keywords_file = "";
+        kws_config.keywords_buf = keywords.c_str();
+        kws_config.keywords_buf_size = static_cast<int32_t>(keywords.size());
+    } else {
+        kws_config.keywords_file = keywords_path.c_str();
+        kws_config.keywords_buf = "";
+        kws_config.keywords_buf_size = 0;
+    }
+
+    RAC_LOG_INFO("ONNX.KWS", "Creating SherpaOnnxKeywordSpotter (threshold %.2f)...",
+                 kws_config.keywords_threshold);
+
+    spotter_ = SherpaOnnxCreateKeywordSpotter(&kws_config);
+    if (!spotter_) {
+        RAC_LOG_ERROR("ONNX.KWS", "Failed to create SherpaOnnxKeywordSpotter");
+        return false;
+    }
+
+    stream_ = SherpaOnnxCreateKeywordStream(spotter_);
+    if (!stream_) {
+        RAC_LOG_ERROR("ONNX.KWS", "Failed to create keyword stream");
+        SherpaOnnxDestroyKeywordSpotter(spotter_);
+        spotter_ = nullptr;
+        return false;
+    }
+
+    RAC_LOG_INFO("ONNX.KWS", "Keyword spotter loaded");
+    return true;
+#else
+    (void)model_path;
+    (void)config;
+    RAC_LOG_ERROR("ONNX.KWS", "Keyword spotting requires Sherpa-ONNX");
+    return false;
+#endif
+}
+
+void ONNXKWS::unload_model() {
+    std::lock_guard<std::mutex> lock(mutex_);
+#if SHERPA_ONNX_AVAILABLE
+    if (stream_) {
+        SherpaOnnxDestroyOnlineStream(stream_);
+        stream_ = nullptr;
+    }
+    if (spotter_) {
+        SherpaOnnxDestroyKeywordSpotter(spotter_);
+        spotter_ = nullptr;
+    }
+#endif
+}
+
+std::string ONNXKWS::process(const float* samples, size_t num_samples, int sample_rate,
+                             double* out_start_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+#if SHERPA_ONNX_AVAILABLE
+    if (!spotter_ || !stream_ || !samples || num_samples == 0) {
+        return "";
+    }
+
+    // Sherpa resamples to the feature rate itself
+    SherpaOnnxOnlineStreamAcceptWaveform(stream_, sample_rate, samples,
+                                         static_cast<int32_t>(num_samples));
+
+    std::string keyword;
+    while (SherpaOnnxIsKeywordStreamReady(spotter_, stream_)) {
+        SherpaOnnxDecodeKeywordStream(spotter_, stream_);
+
+        const SherpaOnnxKeywordResult* result = SherpaOnnxGetKeywordResult(spotter_, stream_);
+        if (!result) {
+            continue;
+        }
+        if (result->keyword && result->keyword[0] != '\0') {
+            keyword = result->keyword;
+            double start_s = result->start_time;
+            if (result->count > 0 && result->timestamps) {
+                start_s += result->timestamps[0];
+            }
+            if (out_start_ms) {
+                *out_start_ms = start_s * 1000.0;
+            }
+            // Restart the search so the same utterance is not reported again;
+            // the stream's timeline keeps running
+            SherpaOnnxResetKeywordStream(spotter_, stream_);
+        }
+        SherpaOnnxDestroyKeywordResult(result);
+        if (!keyword.empty()) {
+            break;
+        }
+    }
+
+    if (!keyword.empty()) {
+        RAC_LOG_INFO("ONNX.KWS", "Detected keyword: %s", keyword.c_str());
+    }
+    return keyword;
+#else
+    (void)samples;
+    (void)num_samples;
+    (void)sample_rate;
+    (void)out_start_ms;
+    return "";
+#endif
+}
+
+void ONNXKWS::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+#if SHERPA_ONNX_AVAILABLE
+    if (!spotter_) {
+        return;
+    }
+    if (stream_) {
+        SherpaOnnxDestroyOnlineStream(stream_);
+    }
+    stream_ = SherpaOnnxCreateKeywordStream(spotter_);
+#endif
+}
+
 }  // namespace runanywhere
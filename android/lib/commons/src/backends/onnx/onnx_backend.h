@@ -2,10 +2,10 @@
 #define RUNANYWHERE_ONNX_BACKEND_H
 
 /**
- * ONNX Backend - Internal implementation for STT, TTS, VAD
+ * ONNX Backend - Internal implementation for STT, TTS, VAD, KWS
  *
  * This backend uses ONNX Runtime for general ML inference and
- * Sherpa-ONNX for speech-specific tasks (STT, TTS, VAD).
+ * Sherpa-ONNX for speech-specific tasks (STT, TTS, VAD, KWS).
  * Internal C++ implementation wrapped by RAC API (rac_onnx.cpp).
  */
 
@@ -14,13 +14,18 @@
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "rac/core/rac_audio_utils.h"
+
 // Sherpa-ONNX C API for TTS/STT
 #if SHERPA_ONNX_AVAILABLE
 #include <sherpa-onnx/c-api/c-api.h>
@@ -47,6 +52,17 @@ struct DeviceInfo {
     int cpu_cores = 0;
 };
 
+// ONNX Runtime session settings; the JSON backend config overrides the
+// process-wide defaults key by key
+struct ORTRuntimeConfig {
+    int intra_op_threads = 0;  // 0 = half the cores, at most 4
+    int inter_op_threads = 1;
+    GraphOptimizationLevel graph_optimization_level = ORT_ENABLE_ALL;
+    std::string execution_provider = "cpu";  // cpu, xnnpack, nnapi, qnn
+    bool use_global_thread_pool = true;
+    bool cache_optimized_models = true;  // keep ORT-format copies next to the models
+};
+
 // =============================================================================
 // STT TYPES
 // =============================================================================
@@ -104,6 +120,8 @@ struct VoiceInfo {
     std::string gender;
     std::string description;
     int sample_rate = 22050;
+    int speaker_id = 0;   // model speaker the voice renders with
+    float speed = 1.0f;   // multiplied into the request's speed rate
 };
 
 struct TTSRequest {
@@ -115,13 +133,20 @@ struct TTSRequest {
 };
 
 struct TTSResult {
-    std::vector<float> audio_samples;
+    // Points into the engine's output buffer, which stays alive while any copy
+    // of this pointer does (no sample copy on the way out)
+    std::shared_ptr<const float> samples;
+    size_t num_samples = 0;
     int sample_rate = 22050;
     int channels = 1;
     double duration_ms = 0.0;
     double inference_time_ms = 0.0;
 };
 
+// Receives samples as soon as a sentence has been synthesized; return false to stop
+using TTSChunkCallback =
+    std::function<bool(const float* samples, size_t num_samples, int sample_rate)>;
+
 // =============================================================================
 // VAD TYPES
 // =============================================================================
@@ -156,6 +181,13 @@ struct VADResult {
     std::vector<SpeechSegment> segments;
 };
 
+struct VADStreamInput {
+    std::string stream_id;
+    const float* samples = nullptr;
+    size_t num_samples = 0;
+    int sample_rate = 16000;
+};
+
 // =============================================================================
 // TELEMETRY (simple inline implementation)
 // =============================================================================
@@ -187,6 +219,7 @@ class TelemetryCollector {
 class ONNXSTT;
 class ONNXTTS;
 class ONNXVAD;
+class ONNXKWS;
 
 // =============================================================================
 // ONNX BACKEND
@@ -207,6 +240,22 @@ class ONNXBackendNew {
     const OrtApi* get_ort_api() const { return ort_api_; }
     OrtEnv* get_ort_env() const { return ort_env_; }
 
+    static void set_default_runtime_config(const ORTRuntimeConfig& config);
+    const ORTRuntimeConfig& get_runtime_config() const { return runtime_config_; }
+
+    // Applies threading, graph optimisation and execution provider to session
+    // options for a session created on get_ort_env()
+    void apply_session_options(OrtSessionOptions* options) const;
+
+    // The same settings for sherpa-onnx, which creates its own sessions
+    int get_num_threads() const;
+    const char* get_sherpa_provider() const;
+
+    // Returns an up-to-date ORT-format copy of model_path with graph
+    // optimisation already applied, or model_path itself while that copy is
+    // built in the background for the next load
+    std::string optimized_model_path(const std::string& model_path);
+
     const DeviceInfo& get_device_info() const { return device_info_; }
 
     void set_telemetry_callback(TelemetryCallback callback);
@@ -215,14 +264,19 @@ class ONNXBackendNew {
     ONNXSTT* get_stt() { return stt_.get(); }
     ONNXTTS* get_tts() { return tts_.get(); }
     ONNXVAD* get_vad() { return vad_.get(); }
+    ONNXKWS* get_kws() { return kws_.get(); }
 
    private:
     bool initialize_ort();
     void create_capabilities();
+    void build_optimized_model(const std::string& model_path, const std::string& cache_path);
 
     bool initialized_ = false;
     const OrtApi* ort_api_ = nullptr;
     OrtEnv* ort_env_ = nullptr;
+    bool shared_env_ = false;
+    ORTRuntimeConfig runtime_config_;
+    std::vector<std::thread> optimize_threads_;
     nlohmann::json config_;
     DeviceInfo device_info_;
     TelemetryCollector telemetry_;
@@ -230,6 +284,7 @@ class ONNXBackendNew {
     std::unique_ptr<ONNXSTT> stt_;
     std::unique_ptr<ONNXTTS> tts_;
     std::unique_ptr<ONNXVAD> vad_;
+    std::unique_ptr<ONNXKWS> kws_;
 
     mutable std::mutex mutex_;
 };
@@ -250,13 +305,26 @@ class ONNXSTT {
     bool unload_model();
     STTModelType get_model_type() const;
 
-    STTResult transcribe(const STTRequest& request);
+    STTResult transcribe(const STTRequest& request) {
+        return transcribe(request.audio_samples.data(), request.audio_samples.size(), request);
+    }
+    // Span overloads hand the caller's buffer straight to Sherpa without a copy;
+    // request.audio_samples is ignored
+    STTResult transcribe(const float* samples, size_t num_samples, const STTRequest& request);
     bool supports_streaming() const;
 
     std::string create_stream(const nlohmann::json& config = {});
-    bool feed_audio(const std::string& stream_id, const std::vector<float>& samples, int sample_rate);
+    bool feed_audio(const std::string& stream_id, const std::vector<float>& samples, int sample_rate) {
+        return feed_audio(stream_id, samples.data(), samples.size(), sample_rate);
+    }
+    bool feed_audio(const std::string& stream_id, const float* samples, size_t num_samples,
+                    int sample_rate);
     bool is_stream_ready(const std::string& stream_id);
     STTResult decode(const std::string& stream_id);
+    // Decodes several streams with one batched recognizer call; an empty list
+    // takes every offline stream holding audio that has not been decoded yet
+    std::vector<std::pair<std::string, STTResult>> decode_batch(
+        const std::vector<std::string>& stream_ids = {});
     bool is_endpoint(const std::string& stream_id);
     void input_finished(const std::string& stream_id);
     void reset_stream(const std::string& stream_id);
@@ -266,11 +334,32 @@ class ONNXSTT {
     std::vector<std::string> get_supported_languages() const;
 
    private:
+#if SHERPA_ONNX_AVAILABLE
+    // One recognizer stream; its mutex serialises calls on this stream only
+    struct StreamEntry {
+        std::mutex mutex;
+        const SherpaOnnxOfflineStream* offline = nullptr;
+        const SherpaOnnxOnlineStream* online = nullptr;
+        bool has_pending_audio = false;  // offline audio accepted since the last decode
+        ~StreamEntry();
+    };
+    std::shared_ptr<StreamEntry> find_stream(const std::string& stream_id);
+
+    bool load_online_model(const std::string& encoder_path, const std::string& decoder_path,
+                           const std::string& joiner_path, const std::string& tokens_path,
+                           const nlohmann::json& config);
+    std::string online_text(const SherpaOnnxOnlineStream* stream) const;
+    STTResult offline_result(const SherpaOnnxOfflineStream* stream) const;
+#endif
+
     ONNXBackendNew* backend_;
     OrtSession* whisper_session_ = nullptr;
 #if SHERPA_ONNX_AVAILABLE
     const SherpaOnnxOfflineRecognizer* sherpa_recognizer_ = nullptr;
-    std::unordered_map<std::string, const SherpaOnnxOfflineStream*> sherpa_streams_;
+    // Streaming transducers (zipformer): audio is decoded incrementally as it
+    // arrives and sherpa detects endpoints from trailing silence
+    const SherpaOnnxOnlineRecognizer* online_recognizer_ = nullptr;
+    std::unordered_map<std::string, std::shared_ptr<StreamEntry>> sherpa_streams_;
 #else
     void* sherpa_recognizer_ = nullptr;
 #endif
@@ -281,7 +370,9 @@ class ONNXSTT {
     int stream_counter_ = 0;
     std::string model_dir_;
     std::string language_;
-    mutable std::mutex mutex_;
+    // Held shared by transcription and stream calls, exclusively by load/unload
+    mutable std::shared_mutex model_mutex_;
+    std::mutex streams_mutex_;  // guards the stream map only
 };
 
 // =============================================================================
@@ -301,24 +392,43 @@ class ONNXTTS {
     TTSModelType get_model_type() const;
 
     TTSResult synthesize(const TTSRequest& request);
+    // Synthesizes sentence by sentence, handing each chunk to on_chunk as it is
+    // generated. Later sentences are synthesized ahead on a few workers when
+    // the CPU budget has room; chunks still arrive in order on the calling
+    // thread. summary (optional) receives totals only, no samples.
+    bool synthesize_stream(const TTSRequest& request, const TTSChunkCallback& on_chunk,
+                           TTSResult* summary = nullptr);
     bool supports_streaming() const;
 
     void cancel();
     std::vector<VoiceInfo> get_voices() const;
     std::string get_default_voice(const std::string& language) const;
 
+    // Registers (or replaces) a voice on the loaded model without reloading it.
+    // speaker_id must be one of the model's speakers.
+    bool add_voice(const VoiceInfo& voice);
+    bool remove_voice(const std::string& voice_id);
+
    private:
+    // Looks up a voice by id or name; unknown ids fall back to speaker 0.
+    // Caller holds mutex_.
+    const VoiceInfo& resolve_voice(const std::string& voice_id) const;
+    void rebuild_voice_index();
+
     ONNXBackendNew* backend_;
 #if SHERPA_ONNX_AVAILABLE
-    const SherpaOnnxOfflineTts* sherpa_tts_ = nullptr;
+    // Each synthesis holds a reference, so unload never frees an engine in use
+    std::shared_ptr<const SherpaOnnxOfflineTts> sherpa_tts_;
 #else
     void* sherpa_tts_ = nullptr;
 #endif
     TTSModelType model_type_ = TTSModelType::PIPER;
     bool model_loaded_ = false;
     std::atomic<bool> cancel_requested_{false};
-    std::atomic<int> active_synthesis_count_{0};
     std::vector<VoiceInfo> voices_;
+    // Resolved once at load: voice id and name -> index into voices_
+    std::unordered_map<std::string, size_t> voice_index_;
+    int num_speakers_ = 0;
     std::string model_dir_;
     int sample_rate_ = 22050;
     mutable std::mutex mutex_;
@@ -328,6 +438,27 @@ class ONNXTTS {
 // VAD IMPLEMENTATION
 // =============================================================================
 
+// Recurrent state and segmentation progress of one VAD stream
+struct VADStreamState {
+    VADConfig config;
+    std::vector<float> model_state;  // LSTM state, carried between frames
+    std::vector<float> context;      // tail of the previous frame (Silero v5)
+    std::vector<float> pending;      // 16 kHz samples short of a full frame
+    rac_audio_resampler_t resampler = nullptr;
+    int resampler_rate = 0;
+
+    int64_t frames = 0;
+    float last_probability = 0.0f;
+    bool triggered = false;
+    double speech_start_ms = 0.0;
+    double silence_start_ms = -1.0;  // first frame of the current pause, -1 = none
+
+    ~VADStreamState() { rac_audio_resampler_destroy(resampler); }
+};
+
+// Silero VAD (v4 h/c or v5 single-state export) run directly on ONNX Runtime.
+// Each stream keeps its own LSTM state; frames of different streams are
+// evaluated in one batched session run.
 class ONNXVAD {
    public:
     explicit ONNXVAD(ONNXBackendNew* backend);
@@ -340,21 +471,88 @@ class ONNXVAD {
     bool unload_model();
 
     bool configure_vad(const VADConfig& config);
-    VADResult process(const std::vector<float>& audio_samples, int sample_rate);
-    std::vector<SpeechSegment> detect_segments(const std::vector<float>& audio_samples, int sample_rate);
+    // Runs a whole buffer through a fresh state; segments cover all speech in it
+    VADResult process(const std::vector<float>& audio_samples, int sample_rate) {
+        return process(audio_samples.data(), audio_samples.size(), sample_rate);
+    }
+    VADResult process(const float* samples, size_t num_samples, int sample_rate);
+    std::vector<SpeechSegment> detect_segments(const std::vector<float>& audio_samples, int sample_rate) {
+        return process(audio_samples.data(), audio_samples.size(), sample_rate).segments;
+    }
+    std::vector<SpeechSegment> detect_segments(const float* samples, size_t num_samples,
+                                               int sample_rate) {
+        return process(samples, num_samples, sample_rate).segments;
+    }
 
     std::string create_stream(const VADConfig& config = {});
-    VADResult feed_audio(const std::string& stream_id, const std::vector<float>& samples, int sample_rate);
+    // Segments in the result are the ones that ended within this call
+    VADResult feed_audio(const std::string& stream_id, const std::vector<float>& samples, int sample_rate) {
+        return feed_audio(stream_id, samples.data(), samples.size(), sample_rate);
+    }
+    VADResult feed_audio(const std::string& stream_id, const float* samples, size_t num_samples,
+                         int sample_rate);
+    // Feeds several streams; results are in input order
+    std::vector<VADResult> feed_audio_batch(const std::vector<VADStreamInput>& inputs);
+    void reset_stream(const std::string& stream_id);
     void destroy_stream(const std::string& stream_id);
 
     void reset();
     VADConfig get_vad_config() const;
 
    private:
+    std::shared_ptr<VADStreamState> new_stream_state(const VADConfig& config) const;
+    bool append_audio(VADStreamState& stream, const float* samples, size_t num_samples,
+                      int sample_rate);
+    // Evaluates every buffered frame of the given streams, one batched run per step
+    bool run_frames(const std::vector<VADStreamState*>& lanes, std::vector<VADResult>& results);
+    bool infer(const std::vector<VADStreamState*>& lanes, std::vector<float>& probabilities);
+    void update_segments(VADStreamState& stream, float probability, VADResult& result) const;
+    void release_session();
+
     ONNXBackendNew* backend_;
-    void* sherpa_vad_ = nullptr;
+    OrtSession* session_ = nullptr;
+    OrtMemoryInfo* memory_info_ = nullptr;
+    std::vector<std::string> input_names_;
+    std::vector<std::string> output_names_;
+    int state_tensors_ = 1;      // v5: "state"; v4: "h" and "c"
+    int state_dim_ = 128;        // per LSTM direction
+    int context_samples_ = 64;   // v5 prepends the previous frame's tail
+
     VADConfig config_;
     bool model_loaded_ = false;
+
+    std::unordered_map<std::string, std::shared_ptr<VADStreamState>> streams_;
+    int stream_counter_ = 0;
+
+    mutable std::mutex mutex_;
+};
+
+// =============================================================================
+// KWS IMPLEMENTATION
+// =============================================================================
+
+// Keyword spotting with sherpa-onnx's KeywordSpotter over one audio stream
+class ONNXKWS {
+   public:
+    explicit ONNXKWS(ONNXBackendNew* backend);
+    ~ONNXKWS();
+
+    bool is_ready() const;
+    bool load_model(const std::string& model_path, const nlohmann::json& config = {});
+    void unload_model();
+
+    // Feeds audio and decodes what is ready. Returns the keyword that ended
+    // within it (and where it started, in ms of fed audio), or "" if none
+    std::string process(const float* samples, size_t num_samples, int sample_rate,
+                        double* out_start_ms);
+    void reset();
+
+   private:
+    ONNXBackendNew* backend_;
+#if SHERPA_ONNX_AVAILABLE
+    const SherpaOnnxKeywordSpotter* spotter_ = nullptr;
+    const SherpaOnnxOnlineStream* stream_ = nullptr;
+#endif
     mutable std::mutex mutex_;
 };
 
@@ -3,21 +3,30 @@
  * @brief RunAnywhere Core - ONNX Backend RAC Registration
  *
  * Registers the ONNX backend with the module and service registries.
- * Provides vtable implementations for STT, TTS, and VAD services.
+ * Provides vtable implementations for STT, TTS, VAD, and KWS services.
  */
 
+#include "rac_kws_onnx.h"
 #include "rac_stt_onnx.h"
 #include "rac_tts_onnx.h"
 #include "rac_vad_onnx.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <string>
 #include <vector>
 
+#include <nlohmann/json.hpp>
+
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_audio_frame.h"
+#include "rac/core/rac_audio_kernels.h"
 #include "rac/core/rac_core.h"
 #include "rac/core/rac_error.h"
 #include "rac/core/rac_logger.h"
+#include "rac/features/kws/rac_kws_service.h"
 #include "rac/features/stt/rac_stt_service.h"
 #include "rac/features/tts/rac_tts_service.h"
 #include "rac/infrastructure/model_management/rac_model_strategy.h"
@@ -32,20 +41,29 @@ namespace {
 const char* LOG_CAT = "ONNX";
 
 /**
- * Convert Int16 PCM audio to Float32 normalized to [-1.0, 1.0].
+ * Int16 PCM audio converted to Float32 normalized to [-1.0, 1.0].
  * SDKs may send Int16 audio but Sherpa-ONNX expects Float32.
+ * The samples live in a pooled buffer, so repeated calls do not allocate.
  */
-static std::vector<float> convert_int16_to_float32(const void* int16_data, size_t byte_count) {
-    const int16_t* samples = static_cast<const int16_t*>(int16_data);
-    size_t num_samples = byte_count / sizeof(int16_t);
-
-    std::vector<float> float_samples(num_samples);
-    for (size_t i = 0; i < num_samples; ++i) {
-        float_samples[i] = static_cast<float>(samples[i]) / 32768.0f;
+class Int16AsFloat32 {
+   public:
+    Int16AsFloat32(const void* int16_data, size_t byte_count) {
+        size_t num_samples = byte_count / sizeof(int16_t);
+        if (rac_audio_frame_acquire(num_samples, &buffer_) == RAC_SUCCESS) {
+            rac_audio_int16_to_float(static_cast<const int16_t*>(int16_data),
+                                     rac_audio_frame_data(buffer_), num_samples);
+        }
     }
+    ~Int16AsFloat32() { rac_audio_frame_release(buffer_); }
+    Int16AsFloat32(const Int16AsFloat32&) = delete;
+    Int16AsFloat32& operator=(const Int16AsFloat32&) = delete;
 
-    return float_samples;
-}
+    const float* data() const { return rac_audio_frame_data(buffer_); }
+    size_t size() const { return rac_audio_frame_size(buffer_); }
+
+   private:
+    rac_audio_frame_t buffer_ = nullptr;
+};
 
 // Initialize (no-op for ONNX - model loaded during create)
 static rac_result_t onnx_stt_vtable_initialize(void* impl, const char* model_path) {
@@ -58,7 +76,10 @@ static rac_result_t onnx_stt_vtable_initialize(void* impl, const char* model_pat
 static rac_result_t onnx_stt_vtable_transcribe(void* impl, const void* audio_data,
                                                size_t audio_size, const rac_stt_options_t* options,
                                                rac_stt_result_t* out_result) {
-    std::vector<float> float_samples = convert_int16_to_float32(audio_data, audio_size);
+    Int16AsFloat32 float_samples(audio_data, audio_size);
+    if (!float_samples.data()) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
     return rac_stt_onnx_transcribe(impl, float_samples.data(), float_samples.size(), options,
                                    out_result);
 }
@@ -71,18 +92,37 @@ static rac_result_t onnx_stt_vtable_transcribe_stream(void* impl, const void* au
                                                       void* user_data) {
     (void)options;
 
+    Int16AsFloat32 float_samples(audio_data, audio_size);
+    if (!float_samples.data()) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+
     rac_handle_t stream = nullptr;
     rac_result_t result = rac_stt_onnx_create_stream(impl, &stream);
     if (result != RAC_SUCCESS) {
         return result;
     }
 
-    std::vector<float> float_samples = convert_int16_to_float32(audio_data, audio_size);
-
-    result = rac_stt_onnx_feed_audio(impl, stream, float_samples.data(), float_samples.size());
-    if (result != RAC_SUCCESS) {
-        rac_stt_onnx_destroy_stream(impl, stream);
-        return result;
+    // Streaming models decode as audio arrives, so feeding in chunks yields
+    // partial results along the way; offline models take it all at once
+    const bool streaming = rac_stt_onnx_supports_streaming(impl) == RAC_TRUE;
+    const size_t chunk = streaming ? 16000 * 320 / 1000 : float_samples.size();
+    for (size_t offset = 0; offset < float_samples.size(); offset += chunk) {
+        const size_t count = std::min(chunk, float_samples.size() - offset);
+        result = rac_stt_onnx_feed_audio(impl, stream, float_samples.data() + offset, count);
+        if (result != RAC_SUCCESS) {
+            rac_stt_onnx_destroy_stream(impl, stream);
+            return result;
+        }
+        if (streaming && callback && rac_stt_onnx_stream_is_ready(impl, stream) == RAC_TRUE) {
+            char* partial = nullptr;
+            if (rac_stt_onnx_decode_stream(impl, stream, &partial) == RAC_SUCCESS && partial) {
+                if (partial[0] != '\0') {
+                    callback(partial, RAC_FALSE, user_data);
+                }
+                rac_free(partial);
+            }
+        }
     }
 
     rac_stt_onnx_input_finished(impl, stream);
@@ -94,7 +134,7 @@ static rac_result_t onnx_stt_vtable_transcribe_stream(void* impl, const void* au
     }
 
     rac_stt_onnx_destroy_stream(impl, stream);
-    if (text) free(text);
+    if (text) rac_free(text);
 
     return result;
 }
@@ -152,12 +192,7 @@ static rac_result_t onnx_tts_vtable_synthesize_stream(void* impl, const char* te
                                                       const rac_tts_options_t* options,
                                                       rac_tts_stream_callback_t callback,
                                                       void* user_data) {
-    rac_tts_result_t result = {};
-    rac_result_t status = rac_tts_onnx_synthesize(impl, text, options, &result);
-    if (status == RAC_SUCCESS && callback) {
-        callback(result.audio_data, result.audio_size, user_data);
-    }
-    return status;
+    return rac_tts_onnx_synthesize_stream(impl, text, options, callback, user_data);
 }
 
 static rac_result_t onnx_tts_vtable_stop(void* impl) {
@@ -198,6 +233,32 @@ static const rac_tts_service_ops_t g_onnx_tts_ops = {
     .destroy = onnx_tts_vtable_destroy,
 };
 
+// =============================================================================
+// KWS VTABLE IMPLEMENTATION
+// =============================================================================
+
+static rac_result_t onnx_kws_vtable_process(void* impl, const float* samples, size_t num_samples,
+                                            int32_t sample_rate,
+                                            rac_kws_detection_t* out_detection) {
+    return rac_kws_onnx_process(impl, samples, num_samples, sample_rate, out_detection);
+}
+
+static rac_result_t onnx_kws_vtable_reset(void* impl) {
+    return rac_kws_onnx_reset(impl);
+}
+
+static void onnx_kws_vtable_destroy(void* impl) {
+    if (impl) {
+        rac_kws_onnx_destroy(impl);
+    }
+}
+
+static const rac_kws_service_ops_t g_onnx_kws_ops = {
+    .process = onnx_kws_vtable_process,
+    .reset = onnx_kws_vtable_reset,
+    .destroy = onnx_kws_vtable_destroy,
+};
+
 // =============================================================================
 // SERVICE PROVIDERS
 // =============================================================================
@@ -206,6 +267,7 @@ const char* const MODULE_ID = "onnx";
 const char* const STT_PROVIDER_NAME = "ONNXSTTService";
 const char* const TTS_PROVIDER_NAME = "ONNXTTSService";
 const char* const VAD_PROVIDER_NAME = "ONNXVADService";
+const char* const KWS_PROVIDER_NAME = "ONNXKWSService";
 
 // STT can_handle
 rac_bool_t onnx_stt_can_handle(const rac_service_request_t* request, void* user_data) {
@@ -259,7 +321,8 @@ rac_handle_t onnx_stt_create(const rac_service_request_t* request, void* user_da
     }
     RAC_LOG_INFO(LOG_CAT, "rac_stt_onnx_create succeeded, backend_handle=%p", backend_handle);
 
-    auto* service = static_cast<rac_stt_service_t*>(malloc(sizeof(rac_stt_service_t)));
+    auto* service = static_cast<rac_stt_service_t*>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, sizeof(rac_stt_service_t)));
     if (!service) {
         RAC_LOG_ERROR(LOG_CAT, "Failed to allocate rac_stt_service_t");
         rac_stt_onnx_destroy(backend_handle);
@@ -268,7 +331,9 @@ rac_handle_t onnx_stt_create(const rac_service_request_t* request, void* user_da
 
     service->ops = &g_onnx_stt_ops;
     service->impl = backend_handle;
-    service->model_id = request->identifier ? strdup(request->identifier) : nullptr;
+    service->model_id =
+        request->identifier ? rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, request->identifier)
+                            : nullptr;
 
     RAC_LOG_INFO(LOG_CAT, "ONNX STT service created successfully, service=%p", service);
     return service;
@@ -313,7 +378,8 @@ rac_handle_t onnx_tts_create(const rac_service_request_t* request, void* user_da
         return nullptr;
     }
 
-    auto* service = static_cast<rac_tts_service_t*>(malloc(sizeof(rac_tts_service_t)));
+    auto* service = static_cast<rac_tts_service_t*>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, sizeof(rac_tts_service_t)));
     if (!service) {
         rac_tts_onnx_destroy(backend_handle);
         return nullptr;
@@ -321,7 +387,9 @@ rac_handle_t onnx_tts_create(const rac_service_request_t* request, void* user_da
 
     service->ops = &g_onnx_tts_ops;
     service->impl = backend_handle;
-    service->model_id = request->identifier ? strdup(request->identifier) : nullptr;
+    service->model_id =
+        request->identifier ? rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, request->identifier)
+                            : nullptr;
 
     RAC_LOG_INFO(LOG_CAT, "ONNX TTS service created successfully");
     return service;
@@ -348,6 +416,62 @@ rac_handle_t onnx_vad_create(const rac_service_request_t* request, void* user_da
     return (result == RAC_SUCCESS) ? handle : nullptr;
 }
 
+// KWS can_handle
+rac_bool_t onnx_kws_can_handle(const rac_service_request_t* request, void* user_data) {
+    (void)user_data;
+    return (request != nullptr && request->identifier != nullptr) ? RAC_TRUE : RAC_FALSE;
+}
+
+// KWS create with vtable
+rac_handle_t onnx_kws_create(const rac_service_request_t* request, void* user_data) {
+    (void)user_data;
+
+    if (request == nullptr || request->identifier == nullptr) {
+        return nullptr;
+    }
+
+    RAC_LOG_INFO(LOG_CAT, "Creating ONNX KWS service for: %s", request->identifier);
+
+    rac_kws_onnx_config_t config = RAC_KWS_ONNX_CONFIG_DEFAULT;
+    std::string keywords;
+    if (request->config_json != nullptr) {
+        nlohmann::json json = nlohmann::json::parse(request->config_json, nullptr, false);
+        if (json.is_object()) {
+            keywords = json.value("keywords", std::string());
+            config.keywords_threshold =
+                json.value("keywords_threshold", config.keywords_threshold);
+            config.keywords_score = json.value("keywords_score", config.keywords_score);
+            config.num_threads = json.value("num_threads", config.num_threads);
+        } else {
+            RAC_LOG_WARNING(LOG_CAT, "Ignoring malformed KWS config JSON");
+        }
+    }
+    if (!keywords.empty()) {
+        config.keywords = keywords.c_str();
+    }
+
+    rac_handle_t backend_handle = nullptr;
+    rac_result_t result = rac_kws_onnx_create(request->identifier, &config, &backend_handle);
+    if (result != RAC_SUCCESS) {
+        RAC_LOG_ERROR(LOG_CAT, "Failed to create ONNX KWS backend: %d", result);
+        return nullptr;
+    }
+
+    auto* service = static_cast<rac_kws_service_t*>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, sizeof(rac_kws_service_t)));
+    if (!service) {
+        rac_kws_onnx_destroy(backend_handle);
+        return nullptr;
+    }
+
+    service->ops = &g_onnx_kws_ops;
+    service->impl = backend_handle;
+    service->model_id = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, request->identifier);
+
+    RAC_LOG_INFO(LOG_CAT, "ONNX KWS service created successfully");
+    return service;
+}
+
 // =============================================================================
 // STORAGE AND DOWNLOAD STRATEGIES
 // =============================================================================
@@ -432,7 +556,7 @@ rac_result_t onnx_download_post_process(const rac_model_download_config_t* confi
     memset(out_result, 0, sizeof(rac_download_result_t));
     out_result->was_extracted =
         (config->archive_type != RAC_ARCHIVE_TYPE_NONE) ? RAC_TRUE : RAC_FALSE;
-    out_result->final_path = strdup(downloaded_path);
+    out_result->final_path = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, downloaded_path);
     out_result->file_count = 1;
 
     return RAC_SUCCESS;
@@ -477,11 +601,12 @@ rac_result_t rac_backend_onnx_register(void) {
     module_info.id = MODULE_ID;
     module_info.name = "ONNX Runtime";
     module_info.version = "1.0.0";
-    module_info.description = "STT/TTS/VAD backend using ONNX Runtime via Sherpa-ONNX";
+    module_info.description = "STT/TTS/VAD/KWS backend using ONNX Runtime via Sherpa-ONNX";
 
-    rac_capability_t capabilities[] = {RAC_CAPABILITY_STT, RAC_CAPABILITY_TTS, RAC_CAPABILITY_VAD};
+    rac_capability_t capabilities[] = {RAC_CAPABILITY_STT, RAC_CAPABILITY_TTS, RAC_CAPABILITY_VAD,
+                                       RAC_CAPABILITY_KEYWORD_SPOTTING};
     module_info.capabilities = capabilities;
-    module_info.num_capabilities = 3;
+    module_info.num_capabilities = 4;
 
     rac_result_t result = rac_module_register(&module_info);
     if (result != RAC_SUCCESS && result != RAC_ERROR_MODULE_ALREADY_REGISTERED) {
@@ -537,8 +662,25 @@ rac_result_t rac_backend_onnx_register(void) {
         return result;
     }
 
+    // Register KWS provider
+    rac_service_provider_t kws_provider = {};
+    kws_provider.name = KWS_PROVIDER_NAME;
+    kws_provider.capability = RAC_CAPABILITY_KEYWORD_SPOTTING;
+    kws_provider.priority = 100;
+    kws_provider.can_handle = onnx_kws_can_handle;
+    kws_provider.create = onnx_kws_create;
+
+    result = rac_service_register_provider(&kws_provider);
+    if (result != RAC_SUCCESS) {
+        rac_service_unregister_provider(VAD_PROVIDER_NAME, RAC_CAPABILITY_VAD);
+        rac_service_unregister_provider(TTS_PROVIDER_NAME, RAC_CAPABILITY_TTS);
+        rac_service_unregister_provider(STT_PROVIDER_NAME, RAC_CAPABILITY_STT);
+        rac_module_unregister(MODULE_ID);
+        return result;
+    }
+
     g_registered = true;
-    RAC_LOG_INFO(LOG_CAT, "ONNX backend registered (STT + TTS + VAD)");
+    RAC_LOG_INFO(LOG_CAT, "ONNX backend registered (STT + TTS + VAD + KWS)");
     return RAC_SUCCESS;
 }
 
@@ -548,6 +690,7 @@ rac_result_t rac_backend_onnx_unregister(void) {
     }
 
     rac_model_strategy_unregister(RAC_FRAMEWORK_ONNX);
+    rac_service_unregister_provider(KWS_PROVIDER_NAME, RAC_CAPABILITY_KEYWORD_SPOTTING);
     rac_service_unregister_provider(VAD_PROVIDER_NAME, RAC_CAPABILITY_VAD);
     rac_service_unregister_provider(TTS_PROVIDER_NAME, RAC_CAPABILITY_TTS);
     rac_service_unregister_provider(STT_PROVIDER_NAME, RAC_CAPABILITY_STT);
@@ -3,20 +3,24 @@
  * @brief RunAnywhere Core - ONNX Backend RAC API Implementation
  *
  * Direct RAC API implementation that calls C++ classes.
- * Includes STT, TTS, and VAD functionality.
+ * Includes STT, TTS, VAD, and keyword spotting functionality.
  */
 
+#include "rac_kws_onnx.h"
 #include "rac_stt_onnx.h"
 #include "rac_tts_onnx.h"
 #include "rac_vad_onnx.h"
 
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "onnx_backend.h"
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_error.h"
 #include "rac/infrastructure/events/rac_events.h"
 
@@ -37,8 +41,80 @@ struct rac_onnx_tts_handle_impl {
 struct rac_onnx_vad_handle_impl {
     std::unique_ptr<runanywhere::ONNXBackendNew> backend;
     runanywhere::ONNXVAD* vad;  // Owned by backend
+    // Stream behind rac_vad_onnx_process, so chunked calls keep model state
+    std::string default_stream;
+    int sample_rate = 16000;
+    bool speech_active = false;
 };
 
+struct rac_onnx_kws_handle_impl {
+    std::unique_ptr<runanywhere::ONNXBackendNew> backend;
+    runanywhere::ONNXKWS* kws;  // Owned by backend
+};
+
+static void to_stream_result(const runanywhere::VADResult& result,
+                             rac_vad_onnx_stream_result_t* out) {
+    out->is_speech = result.is_speech ? RAC_TRUE : RAC_FALSE;
+    out->probability = result.probability;
+    out->timestamp_ms = result.timestamp_ms;
+    out->segments_ended = static_cast<int32_t>(result.segments.size());
+    out->segment_start_ms = result.segments.empty() ? 0.0 : result.segments.back().start_time_ms;
+    out->segment_end_ms = result.segments.empty() ? 0.0 : result.segments.back().end_time_ms;
+}
+
+static void release_tts_audio(void* /*audio_data*/, void* release_context) {
+    delete static_cast<std::shared_ptr<const float>*>(release_context);
+}
+
+// =============================================================================
+// RUNTIME CONFIGURATION
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_backend_onnx_set_runtime_config(const rac_onnx_runtime_config_t* config) {
+    if (config == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    runanywhere::ORTRuntimeConfig runtime;
+    runtime.intra_op_threads = config->intra_op_threads;
+    runtime.inter_op_threads = config->inter_op_threads;
+    switch (config->graph_optimization_level) {
+        case 0:
+            runtime.graph_optimization_level = ORT_DISABLE_ALL;
+            break;
+        case 1:
+            runtime.graph_optimization_level = ORT_ENABLE_BASIC;
+            break;
+        case 2:
+            runtime.graph_optimization_level = ORT_ENABLE_EXTENDED;
+            break;
+        default:
+            runtime.graph_optimization_level = ORT_ENABLE_ALL;
+    }
+    switch (config->execution_provider) {
+        case RAC_ONNX_PROVIDER_XNNPACK:
+            runtime.execution_provider = "xnnpack";
+            break;
+        case RAC_ONNX_PROVIDER_NNAPI:
+            runtime.execution_provider = "nnapi";
+            break;
+        case RAC_ONNX_PROVIDER_QNN:
+            runtime.execution_provider = "qnn";
+            break;
+        default:
+            runtime.execution_provider = "cpu";
+    }
+    runtime.use_global_thread_pool = config->use_global_thread_pool == RAC_TRUE;
+    runtime.cache_optimized_models = config->cache_optimized_models == RAC_TRUE;
+
+    runanywhere::ONNXBackendNew::set_default_runtime_config(runtime);
+    return RAC_SUCCESS;
+}
+
+}  // extern "C"
+
 // =============================================================================
 // STT IMPLEMENTATION
 // =============================================================================
@@ -121,17 +197,21 @@ rac_result_t rac_stt_onnx_transcribe(rac_handle_t handle, const float* audio_sam
     }
 
     runanywhere::STTRequest request;
-    request.audio_samples.assign(audio_samples, audio_samples + num_samples);
     request.sample_rate = (options && options->sample_rate > 0) ? options->sample_rate : 16000;
     if (options && options->language) {
         request.language = options->language;
     }
 
-    auto result = h->stt->transcribe(request);
+    auto result = h->stt->transcribe(audio_samples, num_samples, request);
 
-    out_result->text = result.text.empty() ? nullptr : strdup(result.text.c_str());
+    out_result->text =
+        result.text.empty()
+            ? nullptr
+            : rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, result.text.c_str());
     out_result->detected_language =
-        result.detected_language.empty() ? nullptr : strdup(result.detected_language.c_str());
+        result.detected_language.empty()
+            ? nullptr
+            : rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, result.detected_language.c_str());
     out_result->words = nullptr;
     out_result->num_words = 0;
     out_result->confidence = 1.0f;
@@ -166,7 +246,8 @@ rac_result_t rac_stt_onnx_create_stream(rac_handle_t handle, rac_handle_t* out_s
         return RAC_ERROR_BACKEND_INIT_FAILED;
     }
 
-    *out_stream = static_cast<rac_handle_t>(strdup(stream_id.c_str()));
+    *out_stream =
+        static_cast<rac_handle_t>(rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, stream_id.c_str()));
     return RAC_SUCCESS;
 }
 
@@ -179,8 +260,7 @@ rac_result_t rac_stt_onnx_feed_audio(rac_handle_t handle, rac_handle_t stream,
     auto* h = static_cast<rac_onnx_stt_handle_impl*>(handle);
     auto* stream_id = static_cast<char*>(stream);
 
-    std::vector<float> samples(audio_samples, audio_samples + num_samples);
-    bool success = h->stt->feed_audio(stream_id, samples, 16000);
+    bool success = h->stt->feed_audio(stream_id, audio_samples, num_samples, 16000);
 
     return success ? RAC_SUCCESS : RAC_ERROR_INFERENCE_FAILED;
 }
@@ -205,7 +285,40 @@ rac_result_t rac_stt_onnx_decode_stream(rac_handle_t handle, rac_handle_t stream
     auto* stream_id = static_cast<char*>(stream);
 
     auto result = h->stt->decode(stream_id);
-    *out_text = strdup(result.text.c_str());
+    *out_text = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, result.text.c_str());
+
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_stt_onnx_decode_batch(rac_handle_t handle, const rac_handle_t* streams,
+                                       size_t num_streams, char** out_texts) {
+    if (handle == nullptr || streams == nullptr || out_texts == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_onnx_stt_handle_impl*>(handle);
+
+    std::vector<std::string> stream_ids;
+    stream_ids.reserve(num_streams);
+    for (size_t i = 0; i < num_streams; ++i) {
+        out_texts[i] = nullptr;
+        if (streams[i] == nullptr) {
+            return RAC_ERROR_NULL_POINTER;
+        }
+        stream_ids.emplace_back(static_cast<const char*>(streams[i]));
+    }
+    if (stream_ids.empty()) {
+        return RAC_SUCCESS;
+    }
+
+    auto results = h->stt->decode_batch(stream_ids);
+    for (const auto& [stream_id, result] : results) {
+        for (size_t i = 0; i < num_streams; ++i) {
+            if (out_texts[i] == nullptr && stream_ids[i] == stream_id) {
+                out_texts[i] = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, result.text.c_str());
+            }
+        }
+    }
 
     return RAC_SUCCESS;
 }
@@ -241,7 +354,7 @@ void rac_stt_onnx_destroy_stream(rac_handle_t handle, rac_handle_t stream) {
     auto* stream_id = static_cast<char*>(stream);
 
     h->stt->destroy_stream(stream_id);
-    free(stream_id);
+    rac_free(stream_id);
 }
 
 void rac_stt_onnx_destroy(rac_handle_t handle) {
@@ -335,19 +448,21 @@ rac_result_t rac_tts_onnx_synthesize(rac_handle_t handle, const char* text,
     }
 
     auto result = h->tts->synthesize(request);
-    if (result.audio_samples.empty()) {
+    if (!result.samples || result.num_samples == 0) {
         rac_error_set_details("TTS synthesis failed");
         return RAC_ERROR_INFERENCE_FAILED;
     }
 
-    float* audio_copy = static_cast<float*>(malloc(result.audio_samples.size() * sizeof(float)));
-    if (!audio_copy) {
+    // Hand sherpa's buffer to the caller instead of copying it
+    auto* owner = new (std::nothrow) std::shared_ptr<const float>(std::move(result.samples));
+    if (!owner) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
-    memcpy(audio_copy, result.audio_samples.data(), result.audio_samples.size() * sizeof(float));
 
-    out_result->audio_data = audio_copy;
-    out_result->audio_size = result.audio_samples.size() * sizeof(float);
+    out_result->audio_data = const_cast<float*>(owner->get());
+    out_result->audio_size = result.num_samples * sizeof(float);
+    out_result->release_audio = release_tts_audio;
+    out_result->release_context = owner;
     out_result->audio_format = RAC_AUDIO_FORMAT_PCM;
     out_result->sample_rate = result.sample_rate;
     out_result->duration_ms = result.duration_ms;
@@ -359,6 +474,53 @@ rac_result_t rac_tts_onnx_synthesize(rac_handle_t handle, const char* text,
     return RAC_SUCCESS;
 }
 
+rac_result_t rac_tts_onnx_synthesize_stream(rac_handle_t handle, const char* text,
+                                            const rac_tts_options_t* options,
+                                            rac_tts_stream_callback_t callback,
+                                            void* user_data) {
+    if (handle == nullptr || text == nullptr || callback == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_onnx_tts_handle_impl*>(handle);
+    if (!h->tts) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    runanywhere::TTSRequest request;
+    request.text = text;
+    if (options && options->voice) {
+        request.voice_id = options->voice;
+    }
+    if (options && options->rate > 0) {
+        request.speed_rate = options->rate;
+    }
+
+    runanywhere::TTSResult summary;
+    bool ok = h->tts->synthesize_stream(
+        request,
+        [callback, user_data](const float* samples, size_t num_samples, int /*sample_rate*/) {
+            callback(samples, num_samples * sizeof(float), user_data);
+            return true;
+        },
+        &summary);
+    if (!ok) {
+        rac_error_set_details("TTS streaming synthesis failed");
+        return RAC_ERROR_INFERENCE_FAILED;
+    }
+
+    if (rac_event_has_subscribers(RAC_EVENT_CATEGORY_TTS)) {
+        char event_json[128];
+        snprintf(event_json, sizeof(event_json),
+                 R"({"duration_ms":%.0f,"processing_time_ms":%.0f})", summary.duration_ms,
+                 summary.inference_time_ms);
+        rac_event_track("tts.synthesis.completed", RAC_EVENT_CATEGORY_TTS,
+                        RAC_EVENT_DESTINATION_ALL, event_json);
+    }
+
+    return RAC_SUCCESS;
+}
+
 rac_result_t rac_tts_onnx_get_voices(rac_handle_t handle, char*** out_voices, size_t* out_count) {
     if (handle == nullptr || out_voices == nullptr || out_count == nullptr) {
         return RAC_ERROR_NULL_POINTER;
@@ -377,14 +539,48 @@ rac_result_t rac_tts_onnx_get_voices(rac_handle_t handle, char*** out_voices, si
         return RAC_SUCCESS;
     }
 
-    *out_voices = static_cast<char**>(malloc(voices.size() * sizeof(char*)));
+    *out_voices = static_cast<char**>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, voices.size() * sizeof(char*)));
     for (size_t i = 0; i < voices.size(); i++) {
-        (*out_voices)[i] = strdup(voices[i].id.c_str());
+        (*out_voices)[i] = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, voices[i].id.c_str());
     }
 
     return RAC_SUCCESS;
 }
 
+rac_result_t rac_tts_onnx_add_voice(rac_handle_t handle, const char* voice_id, const char* name,
+                                    int32_t speaker_id, float speed) {
+    if (handle == nullptr || voice_id == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_onnx_tts_handle_impl*>(handle);
+    if (!h->tts) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    runanywhere::VoiceInfo voice;
+    voice.id = voice_id;
+    voice.name = name ? name : voice_id;
+    voice.speaker_id = speaker_id;
+    voice.speed = speed;
+
+    return h->tts->add_voice(voice) ? RAC_SUCCESS : RAC_ERROR_INVALID_ARGUMENT;
+}
+
+rac_result_t rac_tts_onnx_remove_voice(rac_handle_t handle, const char* voice_id) {
+    if (handle == nullptr || voice_id == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_onnx_tts_handle_impl*>(handle);
+    if (!h->tts) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    return h->tts->remove_voice(voice_id) ? RAC_SUCCESS : RAC_ERROR_NOT_FOUND;
+}
+
 void rac_tts_onnx_stop(rac_handle_t handle) {
     if (handle == nullptr) {
         return;
@@ -428,13 +624,9 @@ rac_result_t rac_vad_onnx_create(const char* model_path, const rac_vad_onnx_conf
         return RAC_ERROR_OUT_OF_MEMORY;
     }
 
+    // num_threads only sizes the VAD session; the shared runtime pool keeps its defaults
     handle->backend = std::make_unique<runanywhere::ONNXBackendNew>();
-    nlohmann::json init_config;
-    if (config != nullptr && config->num_threads > 0) {
-        init_config["num_threads"] = config->num_threads;
-    }
-
-    if (!handle->backend->initialize(init_config)) {
+    if (!handle->backend->initialize()) {
         delete handle;
         rac_error_set_details("Failed to initialize ONNX backend");
         return RAC_ERROR_BACKEND_INIT_FAILED;
@@ -451,13 +643,20 @@ rac_result_t rac_vad_onnx_create(const char* model_path, const rac_vad_onnx_conf
     if (model_path != nullptr) {
         nlohmann::json model_config;
         if (config != nullptr) {
-            model_config["energy_threshold"] = config->energy_threshold;
+            model_config["threshold"] = config->energy_threshold;
+            if (config->num_threads > 0) {
+                model_config["num_threads"] = config->num_threads;
+            }
+            if (config->sample_rate > 0) {
+                handle->sample_rate = config->sample_rate;
+            }
         }
         if (!handle->vad->load_model(model_path, runanywhere::VADModelType::SILERO, model_config)) {
             delete handle;
             rac_error_set_details("Failed to load VAD model");
             return RAC_ERROR_MODEL_LOAD_FAILED;
         }
+        handle->default_stream = handle->vad->create_stream(handle->vad->get_vad_config());
     }
 
     *out_handle = static_cast<rac_handle_t>(handle);
@@ -479,8 +678,12 @@ rac_result_t rac_vad_onnx_process(rac_handle_t handle, const float* samples, siz
         return RAC_ERROR_INVALID_HANDLE;
     }
 
-    std::vector<float> audio(samples, samples + num_samples);
-    auto result = h->vad->process(audio, 16000);
+    if (!h->vad->is_ready() || h->default_stream.empty()) {
+        return RAC_ERROR_BACKEND_NOT_READY;
+    }
+
+    auto result = h->vad->feed_audio(h->default_stream, samples, num_samples, h->sample_rate);
+    h->speech_active = result.is_speech;
 
     *out_is_speech = result.is_speech ? RAC_TRUE : RAC_FALSE;
 
@@ -506,6 +709,7 @@ rac_result_t rac_vad_onnx_reset(rac_handle_t handle) {
     if (h->vad) {
         h->vad->reset();
     }
+    h->speech_active = false;
 
     return RAC_SUCCESS;
 }
@@ -531,7 +735,7 @@ rac_bool_t rac_vad_onnx_is_speech_active(rac_handle_t handle) {
     }
 
     auto* h = static_cast<rac_onnx_vad_handle_impl*>(handle);
-    return (h->vad && h->vad->is_ready()) ? RAC_TRUE : RAC_FALSE;
+    return (h->vad && h->vad->is_ready() && h->speech_active) ? RAC_TRUE : RAC_FALSE;
 }
 
 void rac_vad_onnx_destroy(rac_handle_t handle) {
@@ -552,4 +756,234 @@ void rac_vad_onnx_destroy(rac_handle_t handle) {
                     R"({"backend":"onnx"})");
 }
 
+rac_result_t rac_vad_onnx_detect_segments(rac_handle_t handle, const float* samples,
+                                          size_t num_samples, int32_t sample_rate,
+                                          rac_vad_onnx_segment_t** out_segments,
+                                          size_t* out_count) {
+    if (handle == nullptr || samples == nullptr || out_segments == nullptr ||
+        out_count == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_onnx_vad_handle_impl*>(handle);
+    if (!h->vad || !h->vad->is_ready()) {
+        return RAC_ERROR_BACKEND_NOT_READY;
+    }
+
+    std::vector<runanywhere::SpeechSegment> segments =
+        h->vad->detect_segments(samples, num_samples, sample_rate);
+
+    *out_segments = nullptr;
+    *out_count = segments.size();
+    if (segments.empty()) {
+        return RAC_SUCCESS;
+    }
+    *out_segments = static_cast<rac_vad_onnx_segment_t*>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, segments.size() * sizeof(rac_vad_onnx_segment_t)));
+    if (!*out_segments) {
+        *out_count = 0;
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    for (size_t i = 0; i < segments.size(); ++i) {
+        (*out_segments)[i].start_ms = segments[i].start_time_ms;
+        (*out_segments)[i].end_ms = segments[i].end_time_ms;
+    }
+    return RAC_SUCCESS;
+}
+
+void rac_vad_onnx_segments_free(rac_vad_onnx_segment_t* segments) {
+    rac_free(segments);
+}
+
+rac_result_t rac_vad_onnx_stream_create(rac_handle_t handle, char** out_stream_id) {
+    if (handle == nullptr || out_stream_id == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_onnx_vad_handle_impl*>(handle);
+    if (!h->vad || !h->vad->is_ready()) {
+        return RAC_ERROR_BACKEND_NOT_READY;
+    }
+
+    std::string stream_id = h->vad->create_stream(h->vad->get_vad_config());
+    if (stream_id.empty()) {
+        return RAC_ERROR_BACKEND_NOT_READY;
+    }
+    *out_stream_id = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, stream_id.c_str());
+    return *out_stream_id ? RAC_SUCCESS : RAC_ERROR_OUT_OF_MEMORY;
+}
+
+rac_result_t rac_vad_onnx_stream_feed(rac_handle_t handle, const char* stream_id,
+                                      const float* samples, size_t num_samples,
+                                      int32_t sample_rate,
+                                      rac_vad_onnx_stream_result_t* out_result) {
+    rac_vad_onnx_stream_input_t input = {stream_id, samples, num_samples, sample_rate};
+    return rac_vad_onnx_stream_feed_batch(handle, &input, 1, out_result);
+}
+
+rac_result_t rac_vad_onnx_stream_feed_batch(rac_handle_t handle,
+                                            const rac_vad_onnx_stream_input_t* inputs,
+                                            size_t count,
+                                            rac_vad_onnx_stream_result_t* out_results) {
+    if (handle == nullptr || inputs == nullptr || out_results == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_onnx_vad_handle_impl*>(handle);
+    if (!h->vad || !h->vad->is_ready()) {
+        return RAC_ERROR_BACKEND_NOT_READY;
+    }
+
+    std::vector<runanywhere::VADStreamInput> batch(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (inputs[i].stream_id == nullptr || inputs[i].samples == nullptr) {
+            return RAC_ERROR_NULL_POINTER;
+        }
+        batch[i].stream_id = inputs[i].stream_id;
+        batch[i].samples = inputs[i].samples;
+        batch[i].num_samples = inputs[i].num_samples;
+        batch[i].sample_rate = inputs[i].sample_rate;
+    }
+
+    std::vector<runanywhere::VADResult> results = h->vad->feed_audio_batch(batch);
+    for (size_t i = 0; i < count; ++i) {
+        to_stream_result(results[i], &out_results[i]);
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_vad_onnx_stream_reset(rac_handle_t handle, const char* stream_id) {
+    if (handle == nullptr || stream_id == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_onnx_vad_handle_impl*>(handle);
+    if (h->vad) {
+        h->vad->reset_stream(stream_id);
+    }
+    return RAC_SUCCESS;
+}
+
+void rac_vad_onnx_stream_destroy(rac_handle_t handle, const char* stream_id) {
+    if (handle == nullptr || stream_id == nullptr) {
+        return;
+    }
+
+    auto* h = static_cast<rac_onnx_vad_handle_impl*>(handle);
+    if (h->vad) {
+        h->vad->destroy_stream(stream_id);
+    }
+}
+
+// =============================================================================
+// KWS IMPLEMENTATION
+// =============================================================================
+
+rac_result_t rac_kws_onnx_create(const char* model_path, const rac_kws_onnx_config_t* config,
+                                 rac_handle_t* out_handle) {
+    if (out_handle == nullptr || model_path == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* handle = new (std::nothrow) rac_onnx_kws_handle_impl();
+    if (!handle) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+
+    handle->backend = std::make_unique<runanywhere::ONNXBackendNew>();
+    if (!handle->backend->initialize()) {
+        delete handle;
+        rac_error_set_details("Failed to initialize ONNX backend");
+        return RAC_ERROR_BACKEND_INIT_FAILED;
+    }
+
+    handle->kws = handle->backend->get_kws();
+    if (!handle->kws) {
+        delete handle;
+        rac_error_set_details("Keyword spotting not available (requires Sherpa-ONNX)");
+        return RAC_ERROR_BACKEND_INIT_FAILED;
+    }
+
+    const rac_kws_onnx_config_t& cfg = config ? *config : RAC_KWS_ONNX_CONFIG_DEFAULT;
+    nlohmann::json model_config;
+    if (cfg.keywords != nullptr) {
+        model_config["keywords"] = cfg.keywords;
+    }
+    model_config["keywords_threshold"] = cfg.keywords_threshold;
+    model_config["keywords_score"] = cfg.keywords_score;
+    if (cfg.num_threads > 0) {
+        model_config["num_threads"] = cfg.num_threads;
+    }
+
+    if (!handle->kws->load_model(model_path, model_config)) {
+        delete handle;
+        rac_error_set_details("Failed to load KWS model");
+        return RAC_ERROR_MODEL_LOAD_FAILED;
+    }
+
+    *out_handle = static_cast<rac_handle_t>(handle);
+
+    rac_event_track("kws.backend.created", RAC_EVENT_CATEGORY_VOICE, RAC_EVENT_DESTINATION_ALL,
+                    R"({"backend":"onnx"})");
+
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_kws_onnx_process(rac_handle_t handle, const float* samples, size_t num_samples,
+                                  int32_t sample_rate, rac_kws_detection_t* out_detection) {
+    if (handle == nullptr || samples == nullptr || out_detection == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_onnx_kws_handle_impl*>(handle);
+    if (!h->kws) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+    if (!h->kws->is_ready()) {
+        return RAC_ERROR_BACKEND_NOT_READY;
+    }
+
+    double start_ms = 0.0;
+    std::string keyword = h->kws->process(samples, num_samples,
+                                          sample_rate > 0 ? sample_rate : RAC_KWS_DEFAULT_SAMPLE_RATE,
+                                          &start_ms);
+
+    out_detection->detected = keyword.empty() ? RAC_FALSE : RAC_TRUE;
+    snprintf(out_detection->keyword, sizeof(out_detection->keyword), "%s", keyword.c_str());
+    out_detection->start_ms = keyword.empty() ? 0.0 : start_ms;
+
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_kws_onnx_reset(rac_handle_t handle) {
+    if (handle == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_onnx_kws_handle_impl*>(handle);
+    if (h->kws) {
+        h->kws->reset();
+    }
+
+    return RAC_SUCCESS;
+}
+
+void rac_kws_onnx_destroy(rac_handle_t handle) {
+    if (handle == nullptr) {
+        return;
+    }
+
+    auto* h = static_cast<rac_onnx_kws_handle_impl*>(handle);
+    if (h->kws) {
+        h->kws->unload_model();
+    }
+    if (h->backend) {
+        h->backend->cleanup();
+    }
+    delete h;
+
+    rac_event_track("kws.backend.destroyed", RAC_EVENT_CATEGORY_VOICE, RAC_EVENT_DESTINATION_ALL,
+                    R"({"backend":"onnx"})");
+}
+
 }  // extern "C"
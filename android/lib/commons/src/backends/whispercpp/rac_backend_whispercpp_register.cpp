@@ -8,13 +8,19 @@
 #include "rac_stt_whispercpp.h"
 
 #include <cstdlib>
+#include <algorithm>
 #include <cstring>
+#include <string>
 #include <vector>
 
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_audio_frame.h"
+#include "rac/core/rac_audio_kernels.h"
 #include "rac/core/rac_core.h"
 #include "rac/core/rac_error.h"
 #include "rac/core/rac_logger.h"
 #include "rac/features/stt/rac_stt_service.h"
+#include "rac/infrastructure/model_management/rac_model_registry.h"
 
 // =============================================================================
 // STT VTABLE IMPLEMENTATION
@@ -25,19 +31,28 @@ namespace {
 const char* LOG_CAT = "WhisperCPP";
 
 /**
- * Convert Int16 PCM audio to Float32 normalized to [-1.0, 1.0].
+ * Int16 PCM audio converted to Float32 normalized to [-1.0, 1.0].
+ * The samples live in a pooled buffer, so repeated calls do not allocate.
  */
-static std::vector<float> convert_int16_to_float32(const void* int16_data, size_t byte_count) {
-    const int16_t* samples = static_cast<const int16_t*>(int16_data);
-    size_t num_samples = byte_count / sizeof(int16_t);
-
-    std::vector<float> float_samples(num_samples);
-    for (size_t i = 0; i < num_samples; ++i) {
-        float_samples[i] = static_cast<float>(samples[i]) / 32768.0f;
+class Int16AsFloat32 {
+   public:
+    Int16AsFloat32(const void* int16_data, size_t byte_count) {
+        size_t num_samples = byte_count / sizeof(int16_t);
+        if (rac_audio_frame_acquire(num_samples, &buffer_) == RAC_SUCCESS) {
+            rac_audio_int16_to_float(static_cast<const int16_t*>(int16_data),
+                                     rac_audio_frame_data(buffer_), num_samples);
+        }
     }
+    ~Int16AsFloat32() { rac_audio_frame_release(buffer_); }
+    Int16AsFloat32(const Int16AsFloat32&) = delete;
+    Int16AsFloat32& operator=(const Int16AsFloat32&) = delete;
 
-    return float_samples;
-}
+    const float* data() const { return rac_audio_frame_data(buffer_); }
+    size_t size() const { return rac_audio_frame_size(buffer_); }
+
+   private:
+    rac_audio_frame_t buffer_ = nullptr;
+};
 
 // Initialize
 static rac_result_t whispercpp_stt_vtable_initialize(void* impl, const char* model_path) {
@@ -51,26 +66,61 @@ static rac_result_t whispercpp_stt_vtable_transcribe(void* impl, const void* aud
                                                      size_t audio_size,
                                                      const rac_stt_options_t* options,
                                                      rac_stt_result_t* out_result) {
-    std::vector<float> float_samples = convert_int16_to_float32(audio_data, audio_size);
+    Int16AsFloat32 float_samples(audio_data, audio_size);
+    if (!float_samples.data()) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
     return rac_stt_whispercpp_transcribe(impl, float_samples.data(), float_samples.size(), options,
                                          out_result);
 }
 
-// Stream transcription (not implemented for WhisperCPP - use batch)
+// Stream transcription: the audio is fed through a stream one step at a time,
+// reporting committed + tentative text after each step
 static rac_result_t whispercpp_stt_vtable_transcribe_stream(void* impl, const void* audio_data,
                                                             size_t audio_size,
                                                             const rac_stt_options_t* options,
                                                             rac_stt_stream_callback_t callback,
                                                             void* user_data) {
-    // Fall back to batch transcription
-    rac_stt_result_t result = {};
-    std::vector<float> float_samples = convert_int16_to_float32(audio_data, audio_size);
-    rac_result_t status =
-        rac_stt_whispercpp_transcribe(impl, float_samples.data(), float_samples.size(), options,
-                                      &result);
-    if (status == RAC_SUCCESS && callback && result.text) {
-        callback(result.text, RAC_TRUE, user_data);
+    Int16AsFloat32 float_samples(audio_data, audio_size);
+    if (!float_samples.data()) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    const int32_t sample_rate = (options && options->sample_rate > 0) ? options->sample_rate : 16000;
+
+    char* stream_id = nullptr;
+    rac_result_t status = rac_stt_whispercpp_stream_create(
+        impl, options ? options->language : nullptr, 0, &stream_id);
+    if (status != RAC_SUCCESS) {
+        return status;
     }
+
+    const size_t step = static_cast<size_t>(sample_rate);  // 1 s
+    for (size_t offset = 0; offset < float_samples.size() && status == RAC_SUCCESS;
+         offset += step) {
+        const size_t n = std::min(step, float_samples.size() - offset);
+        status = rac_stt_whispercpp_stream_feed(impl, stream_id, float_samples.data() + offset, n,
+                                                sample_rate);
+        if (status != RAC_SUCCESS) {
+            break;
+        }
+        if (offset + n == float_samples.size()) {
+            rac_stt_whispercpp_stream_finish(impl, stream_id);
+        }
+
+        rac_stt_whispercpp_partial_t partial = {};
+        rac_result_t decoded = rac_stt_whispercpp_stream_decode(impl, stream_id, &partial);
+        if (decoded == RAC_SUCCESS && callback) {
+            std::string text = partial.committed_text ? partial.committed_text : "";
+            if (partial.tentative_text) {
+                text += partial.tentative_text;
+            }
+            callback(text.c_str(), partial.is_final, user_data);
+        }
+        rac_stt_whispercpp_partial_free(&partial);
+    }
+
+    rac_stt_whispercpp_stream_destroy(impl, stream_id);
+    rac_free(stream_id);
     return status;
 }
 
@@ -79,7 +129,7 @@ static rac_result_t whispercpp_stt_vtable_get_info(void* impl, rac_stt_info_t* o
     if (!out_info) return RAC_ERROR_NULL_POINTER;
 
     out_info->is_ready = rac_stt_whispercpp_is_ready(impl);
-    out_info->supports_streaming = RAC_FALSE;  // WhisperCPP streaming is limited
+    out_info->supports_streaming = RAC_TRUE;
     out_info->current_model = nullptr;
 
     return RAC_SUCCESS;
@@ -146,6 +196,63 @@ rac_bool_t whispercpp_stt_can_handle(const rac_service_request_t* request, void*
     return RAC_FALSE;
 }
 
+// When the model at path is registered with downloaded quantized variants,
+// returns the variant that meets the default target RTF on this device;
+// otherwise returns path unchanged
+static std::string select_model_variant(const char* path) {
+    rac_model_registry_handle_t registry = rac_get_model_registry();
+    if (!registry) {
+        return path;
+    }
+
+    rac_model_info_t** downloaded = nullptr;
+    size_t downloaded_count = 0;
+    if (rac_model_registry_get_downloaded(registry, &downloaded, &downloaded_count) != RAC_SUCCESS) {
+        return path;
+    }
+    std::string model_id;
+    for (size_t i = 0; i < downloaded_count; ++i) {
+        if (strcmp(downloaded[i]->local_path, path) == 0) {
+            model_id = downloaded[i]->id;
+            break;
+        }
+    }
+    rac_model_info_array_free(downloaded, downloaded_count);
+    if (model_id.empty()) {
+        return path;
+    }
+
+    rac_model_info_t** family = nullptr;
+    size_t family_count = 0;
+    if (rac_model_registry_get_variants(registry, model_id.c_str(), &family, &family_count) !=
+        RAC_SUCCESS) {
+        return path;
+    }
+    std::vector<rac_stt_whispercpp_variant_t> variants;
+    for (size_t i = 0; i < family_count; ++i) {
+        if (rac_model_info_is_downloaded(family[i]) == RAC_TRUE) {
+            variants.push_back({family[i]->local_path, family[i]->quantization,
+                                family[i]->expected_rtf});
+        }
+    }
+
+    std::string selected = path;
+    size_t index = 0;
+    if (variants.size() > 1 &&
+        rac_stt_whispercpp_select_variant(variants.data(), variants.size(),
+                                          RAC_STT_WHISPERCPP_DEFAULT_TARGET_RTF,
+                                          &index) == RAC_SUCCESS) {
+        selected = variants[index].model_path;
+        if (selected != path) {
+            RAC_LOG_INFO(LOG_CAT, "Using %s variant for real-time target: %s",
+                         variants[index].quantization ? variants[index].quantization : "faster",
+                         selected.c_str());
+        }
+    }
+    rac_model_info_array_free(family, family_count);
+    return selected;
+}
+
 // STT create with vtable
 rac_handle_t whispercpp_stt_create(const rac_service_request_t* request, void* user_data) {
     (void)user_data;
@@ -157,14 +264,19 @@ rac_handle_t whispercpp_stt_create(const rac_service_request_t* request, void* u
     RAC_LOG_INFO(LOG_CAT, "Creating WhisperCPP STT service for: %s",
                  request->identifier ? request->identifier : "(default)");
 
+    const std::string model_path =
+        request->identifier ? select_model_variant(request->identifier) : std::string();
+
     rac_handle_t backend_handle = nullptr;
-    rac_result_t result = rac_stt_whispercpp_create(request->identifier, nullptr, &backend_handle);
+    rac_result_t result = rac_stt_whispercpp_create(
+        request->identifier ? model_path.c_str() : nullptr, nullptr, &backend_handle);
     if (result != RAC_SUCCESS) {
         RAC_LOG_ERROR(LOG_CAT, "rac_stt_whispercpp_create failed with result: %d", result);
         return nullptr;
     }
 
-    auto* service = static_cast<rac_stt_service_t*>(malloc(sizeof(rac_stt_service_t)));
+    auto* service = static_cast<rac_stt_service_t*>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, sizeof(rac_stt_service_t)));
     if (!service) {
         RAC_LOG_ERROR(LOG_CAT, "Failed to allocate rac_stt_service_t");
         rac_stt_whispercpp_destroy(backend_handle);
@@ -173,7 +285,9 @@ rac_handle_t whispercpp_stt_create(const rac_service_request_t* request, void* u
 
     service->ops = &g_whispercpp_stt_ops;
     service->impl = backend_handle;
-    service->model_id = request->identifier ? strdup(request->identifier) : nullptr;
+    service->model_id =
+        request->identifier ? rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, request->identifier)
+                            : nullptr;
 
     RAC_LOG_INFO(LOG_CAT, "WhisperCPP STT service created successfully");
     return service;
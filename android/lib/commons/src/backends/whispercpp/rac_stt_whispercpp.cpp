@@ -7,13 +7,18 @@
 
 #include "rac_stt_whispercpp.h"
 
+#include <atomic>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "whispercpp_backend.h"
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_error.h"
 #include "rac/infrastructure/events/rac_events.h"
 
@@ -27,6 +32,42 @@ struct rac_whispercpp_handle_impl {
     std::string detected_language;
 };
 
+// Device speed relative to the reference device behind expected_rtf values;
+// measured once per process (0 = not yet)
+static std::atomic<float> g_device_speed{0.0f};
+static std::mutex g_benchmark_mutex;
+
+static float benchmark_device_speed(const rac_stt_whispercpp_variant_t& variant) {
+    std::lock_guard<std::mutex> lock(g_benchmark_mutex);
+    if (g_device_speed.load() > 0.0f) {
+        return g_device_speed.load();  // another caller finished first
+    }
+
+    runanywhere::WhisperCppBackend backend;
+    if (!backend.initialize({})) {
+        return 0.0f;
+    }
+    runanywhere::WhisperCppSTT* stt = backend.get_stt();
+    if (!stt || !stt->load_model(variant.model_path, runanywhere::STTModelType::WHISPER,
+                                 {{"warmup", false}})) {
+        return 0.0f;
+    }
+    const double rtf = stt->measure_rtf();
+    if (rtf <= 0.0) {
+        return 0.0f;
+    }
+
+    const float speed = static_cast<float>(rtf) / variant.expected_rtf;
+    g_device_speed.store(speed);
+
+    char props[128];
+    snprintf(props, sizeof(props), R"({"backend":"whispercpp","rtf":%.3f,"device_speed":%.3f})",
+             rtf, speed);
+    rac_event_track("stt.device.benchmark.completed", RAC_EVENT_CATEGORY_STT,
+                    RAC_EVENT_DESTINATION_ALL, props);
+    return speed;
+}
+
 // =============================================================================
 // RAC API IMPLEMENTATION
 // =============================================================================
@@ -76,6 +117,34 @@ rac_result_t rac_stt_whispercpp_create(const char* model_path,
         if (config != nullptr && config->translate == RAC_TRUE) {
             model_config["translate"] = true;
         }
+        model_config["warmup"] = config == nullptr || config->warmup == RAC_TRUE;
+        model_config["use_coreml"] = config == nullptr || config->use_coreml == RAC_TRUE;
+        if (config != nullptr) {
+            static const char* const kDecodingNames[] = {"greedy_fast", "greedy_fallback", "beam"};
+            if (config->decoding >= RAC_STT_WHISPERCPP_DECODING_GREEDY_FAST &&
+                config->decoding <= RAC_STT_WHISPERCPP_DECODING_BEAM) {
+                model_config["decoding"] = kDecodingNames[config->decoding];
+            }
+            if (config->beam_size > 0) {
+                model_config["beam_size"] = config->beam_size;
+            }
+            static const char* const kSilenceTrimNames[] = {"off", "energy", "vad"};
+            if (config->silence_trim >= RAC_STT_WHISPERCPP_SILENCE_TRIM_OFF &&
+                config->silence_trim <= RAC_STT_WHISPERCPP_SILENCE_TRIM_VAD) {
+                model_config["silence_trim"] = kSilenceTrimNames[config->silence_trim];
+            }
+            if (config->vad_model_path != nullptr) {
+                model_config["vad_model_path"] = config->vad_model_path;
+            }
+        }
+
+        handle->stt->set_warmup_callback([](double duration_ms) {
+            char props[96];
+            snprintf(props, sizeof(props), R"({"backend":"whispercpp","duration_ms":%.1f})",
+                     duration_ms);
+            rac_event_track("stt.model.warmup.completed", RAC_EVENT_CATEGORY_STT,
+                            RAC_EVENT_DESTINATION_ALL, props);
+        });
 
         if (!handle->stt->load_model(model_path, runanywhere::STTModelType::WHISPER, model_config)) {
             delete handle;
@@ -86,8 +155,13 @@ rac_result_t rac_stt_whispercpp_create(const char* model_path,
 
     *out_handle = static_cast<rac_handle_t>(handle);
 
-    rac_event_track("stt.backend.created", RAC_EVENT_CATEGORY_STT, RAC_EVENT_DESTINATION_ALL,
-                    R"({"backend":"whispercpp"})");
+    if (rac_event_has_subscribers(RAC_EVENT_CATEGORY_STT)) {
+        char props[96];
+        snprintf(props, sizeof(props), R"({"backend":"whispercpp","accelerator":"%s"})",
+                 handle->stt->accelerator_name());
+        rac_event_track("stt.backend.created", RAC_EVENT_CATEGORY_STT,
+                        RAC_EVENT_DESTINATION_ALL, props);
+    }
 
     return RAC_SUCCESS;
 }
@@ -106,23 +180,28 @@ rac_result_t rac_stt_whispercpp_transcribe(rac_handle_t handle, const float* aud
 
     // Prepare request
     runanywhere::STTRequest request;
-    request.audio_samples.assign(audio_samples, audio_samples + num_samples);
     request.sample_rate = (options && options->sample_rate > 0) ? options->sample_rate : 16000;
 
     if (options && options->language) {
         request.language = options->language;
     }
+    request.word_timestamps = options != nullptr && options->enable_timestamps == RAC_TRUE;
 
     // Perform transcription
-    auto result = h->stt->transcribe(request);
+    auto result = h->stt->transcribe(audio_samples, num_samples, request);
 
     // Store detected language for later retrieval
     h->detected_language = result.detected_language;
 
     // Fill output
-    out_result->text = result.text.empty() ? nullptr : strdup(result.text.c_str());
+    out_result->text =
+        result.text.empty()
+            ? nullptr
+            : rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, result.text.c_str());
     out_result->detected_language =
-        result.detected_language.empty() ? nullptr : strdup(result.detected_language.c_str());
+        result.detected_language.empty()
+            ? nullptr
+            : rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, result.detected_language.c_str());
     out_result->confidence = result.confidence;
     out_result->processing_time_ms = result.inference_time_ms;
 
@@ -132,10 +211,12 @@ rac_result_t rac_stt_whispercpp_transcribe(rac_handle_t handle, const float* aud
     if (!result.word_timings.empty()) {
         out_result->num_words = result.word_timings.size();
         out_result->words =
-            static_cast<rac_stt_word_t*>(malloc(result.word_timings.size() * sizeof(rac_stt_word_t)));
+            static_cast<rac_stt_word_t*>(rac_alloc_tagged(
+                RAC_ALLOC_TAG_RESULT, result.word_timings.size() * sizeof(rac_stt_word_t)));
         if (out_result->words) {
             for (size_t i = 0; i < result.word_timings.size(); i++) {
-                out_result->words[i].text = strdup(result.word_timings[i].word.c_str());
+                out_result->words[i].text = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT,
+                                                              result.word_timings[i].word.c_str());
                 out_result->words[i].start_ms =
                     static_cast<int64_t>(result.word_timings[i].start_time_ms);
                 out_result->words[i].end_ms =
@@ -145,8 +226,14 @@ rac_result_t rac_stt_whispercpp_transcribe(rac_handle_t handle, const float* aud
         }
     }
 
-    rac_event_track("stt.transcription.completed", RAC_EVENT_CATEGORY_STT,
-                    RAC_EVENT_DESTINATION_ALL, R"({"backend":"whispercpp"})");
+    if (rac_event_has_subscribers(RAC_EVENT_CATEGORY_STT)) {
+        char props[160];
+        snprintf(props, sizeof(props),
+                 R"({"backend":"whispercpp","accelerator":"%s","processing_time_ms":%.0f})",
+                 h->stt->accelerator_name(), result.inference_time_ms);
+        rac_event_track("stt.transcription.completed", RAC_EVENT_CATEGORY_STT,
+                        RAC_EVENT_DESTINATION_ALL, props);
+    }
 
     return RAC_SUCCESS;
 }
@@ -162,7 +249,151 @@ rac_result_t rac_stt_whispercpp_get_language(rac_handle_t handle, char** out_lan
         return RAC_ERROR_BACKEND_NOT_READY;
     }
 
-    *out_language = strdup(h->detected_language.c_str());
+    *out_language = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, h->detected_language.c_str());
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_stt_whispercpp_detect_language(rac_handle_t handle, const float* audio_samples,
+                                                size_t num_samples, int32_t sample_rate,
+                                                char** out_language, float* out_probability) {
+    if (handle == nullptr || audio_samples == nullptr || out_language == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_whispercpp_handle_impl*>(handle);
+    if (!h->stt) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    std::string language = h->stt->detect_language(audio_samples, num_samples,
+                                                   sample_rate > 0 ? sample_rate : 16000,
+                                                   out_probability);
+    if (language.empty()) {
+        return RAC_ERROR_INFERENCE_FAILED;
+    }
+
+    h->detected_language = language;
+    *out_language = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, language.c_str());
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_stt_whispercpp_stream_create(rac_handle_t handle, const char* language,
+                                              int32_t step_ms, char** out_stream_id) {
+    if (handle == nullptr || out_stream_id == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_whispercpp_handle_impl*>(handle);
+    if (!h->stt) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    nlohmann::json config;
+    if (language != nullptr && language[0] != '\0') {
+        config["language"] = language;
+    }
+    if (step_ms > 0) {
+        config["step_ms"] = step_ms;
+    }
+
+    std::string stream_id = h->stt->create_stream(config);
+    if (stream_id.empty()) {
+        return RAC_ERROR_BACKEND_NOT_READY;
+    }
+
+    *out_stream_id = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, stream_id.c_str());
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_stt_whispercpp_stream_feed(rac_handle_t handle, const char* stream_id,
+                                            const float* samples, size_t num_samples,
+                                            int32_t sample_rate) {
+    if (handle == nullptr || stream_id == nullptr || (samples == nullptr && num_samples > 0)) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_whispercpp_handle_impl*>(handle);
+    if (!h->stt) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    return h->stt->feed_audio(stream_id, samples, num_samples, sample_rate > 0 ? sample_rate : 16000)
+               ? RAC_SUCCESS
+               : RAC_ERROR_NOT_FOUND;
+}
+
+rac_result_t rac_stt_whispercpp_stream_decode(rac_handle_t handle, const char* stream_id,
+                                              rac_stt_whispercpp_partial_t* out_partial) {
+    if (handle == nullptr || stream_id == nullptr || out_partial == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_whispercpp_handle_impl*>(handle);
+    if (!h->stt) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    if (!h->stt->is_stream_ready(stream_id)) {
+        return RAC_ERROR_BACKEND_NOT_READY;
+    }
+
+    auto result = h->stt->decode(stream_id);
+    if (!result.detected_language.empty()) {
+        h->detected_language = result.detected_language;
+    }
+
+    out_partial->committed_text = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, result.text.c_str());
+    out_partial->tentative_text =
+        result.tentative_text.empty()
+            ? nullptr
+            : rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, result.tentative_text.c_str());
+    out_partial->is_final = result.is_final ? RAC_TRUE : RAC_FALSE;
+    return RAC_SUCCESS;
+}
+
+void rac_stt_whispercpp_stream_finish(rac_handle_t handle, const char* stream_id) {
+    if (handle == nullptr || stream_id == nullptr) {
+        return;
+    }
+
+    auto* h = static_cast<rac_whispercpp_handle_impl*>(handle);
+    if (h->stt) {
+        h->stt->input_finished(stream_id);
+    }
+}
+
+void rac_stt_whispercpp_stream_destroy(rac_handle_t handle, const char* stream_id) {
+    if (handle == nullptr || stream_id == nullptr) {
+        return;
+    }
+
+    auto* h = static_cast<rac_whispercpp_handle_impl*>(handle);
+    if (h->stt) {
+        h->stt->destroy_stream(stream_id);
+    }
+}
+
+void rac_stt_whispercpp_partial_free(rac_stt_whispercpp_partial_t* partial) {
+    if (partial == nullptr) {
+        return;
+    }
+    rac_free(partial->committed_text);
+    rac_free(partial->tentative_text);
+    partial->committed_text = nullptr;
+    partial->tentative_text = nullptr;
+}
+
+rac_result_t rac_stt_whispercpp_get_accelerator(rac_handle_t handle,
+                                                const char** out_accelerator) {
+    if (handle == nullptr || out_accelerator == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* h = static_cast<rac_whispercpp_handle_impl*>(handle);
+    if (!h->stt || !h->stt->is_ready()) {
+        return RAC_ERROR_MODEL_NOT_LOADED;
+    }
+    *out_accelerator = h->stt->accelerator_name();
     return RAC_SUCCESS;
 }
 
@@ -193,4 +424,63 @@ void rac_stt_whispercpp_destroy(rac_handle_t handle) {
                     R"({"backend":"whispercpp"})");
 }
 
+rac_result_t rac_stt_whispercpp_select_variant(const rac_stt_whispercpp_variant_t* variants,
+                                               size_t count, float target_rtf,
+                                               size_t* out_index) {
+    if (variants == nullptr || out_index == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    if (count == 0 || target_rtf <= 0.0f) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Fastest variant with a known cost: the fallback and the benchmark subject
+    size_t fastest = count;
+    for (size_t i = 0; i < count; ++i) {
+        if (variants[i].model_path != nullptr && variants[i].expected_rtf > 0.0f &&
+            (fastest == count || variants[i].expected_rtf < variants[fastest].expected_rtf)) {
+            fastest = i;
+        }
+    }
+    if (fastest == count) {
+        *out_index = 0;  // nothing to compare by
+        return RAC_SUCCESS;
+    }
+
+    float speed = g_device_speed.load();
+    if (speed <= 0.0f) {
+        speed = benchmark_device_speed(variants[fastest]);
+        if (speed <= 0.0f) {
+            rac_error_set_details("WhisperCPP device benchmark failed");
+            return RAC_ERROR_MODEL_LOAD_FAILED;
+        }
+    }
+
+    *out_index = fastest;
+    for (size_t i = 0; i < count; ++i) {
+        if (variants[i].model_path != nullptr && variants[i].expected_rtf > 0.0f &&
+            variants[i].expected_rtf * speed <= target_rtf) {
+            *out_index = i;
+            break;
+        }
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_stt_whispercpp_get_device_speed(float* out_scale) {
+    if (out_scale == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    *out_scale = g_device_speed.load();
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_stt_whispercpp_set_device_speed(float scale) {
+    if (scale <= 0.0f) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    g_device_speed.store(scale);
+    return RAC_SUCCESS;
+}
+
 }  // extern "C"
@@ -6,15 +6,26 @@
 
 #include "whispercpp_backend.h"
 
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdio>
 #include <iomanip>
 #include <sstream>
 
+#include "rac/core/rac_audio_kernels.h"
+#include "rac/core/rac_cpu_budget.h"
 #include "rac/core/rac_logger.h"
+#include "rac/core/rac_trace.h"
+#include "rac/infrastructure/model_management/rac_model_paths.h"
+#include "rac/infrastructure/model_management/rac_shared_weights.h"
 
 // Use the RAC logging system
+#define LOGD(...) RAC_LOG_DEBUG("STT.WhisperCpp", __VA_ARGS__)
 #define LOGI(...) RAC_LOG_INFO("STT.WhisperCpp", __VA_ARGS__)
 #define LOGE(...) RAC_LOG_ERROR("STT.WhisperCpp", __VA_ARGS__)
 #define LOGW(...) RAC_LOG_WARNING("STT.WhisperCpp", __VA_ARGS__)
@@ -24,8 +35,212 @@
 #define WHISPER_SAMPLE_RATE 16000
 #endif
 
+// Fallback decoding: a window is re-decoded at +0.2 temperature steps while
+// its average token entropy or logprob misses these thresholds (the values
+// from the reference implementation); sampled retries keep the best of two
+static constexpr float kEntropyThreshold = 2.4f;
+static constexpr float kLogprobThreshold = -1.0f;
+static constexpr float kTemperatureStep = 0.2f;
+static constexpr int kFallbackBestOf = 2;
+static constexpr int kMaxBeamSize = 8;
+
+// Audio a stream must have decoded before its detected language is locked;
+// detection on shorter windows is unreliable
+static constexpr double kLanguageLockMs = 3000.0;
+
+// Energy silence pre-pass: a 20 ms frame is speech when its RMS clears the
+// clip's noise floor (its 10th-percentile frame) three times over, with the
+// threshold kept between the two bounds; voiced runs under 100 ms are clicks
+static constexpr size_t kTrimFrameSamples = 320;
+static constexpr float kNoiseFloorPercentile = 0.1f;
+static constexpr float kNoiseFloorMultiplier = 3.0f;
+static constexpr float kMinSpeechRms = 0.005f;
+static constexpr float kMaxSpeechRms = 0.05f;
+static constexpr size_t kMinSpeechFrames = 5;
+// Trimming that would drop less than this share of a clip is not worth the copy
+static constexpr double kMinTrimShare = 0.1;
+
 namespace runanywhere {
 
+static WhisperDecodingPolicy parse_decoding_policy(const nlohmann::json& config,
+                                                   WhisperDecodingPolicy fallback) {
+    if (!config.contains("decoding") || !config["decoding"].is_string()) {
+        return fallback;
+    }
+    const std::string name = config["decoding"].get<std::string>();
+    if (name == "greedy_fast") {
+        return WhisperDecodingPolicy::GREEDY_FAST;
+    }
+    if (name == "greedy_fallback") {
+        return WhisperDecodingPolicy::GREEDY_FALLBACK;
+    }
+    if (name == "beam") {
+        return WhisperDecodingPolicy::BEAM;
+    }
+    LOGW("Unknown decoding policy '%s'", name.c_str());
+    return fallback;
+}
+
+static WhisperSilenceTrim parse_silence_trim(const nlohmann::json& config) {
+    if (!config.contains("silence_trim") || !config["silence_trim"].is_string()) {
+        return WhisperSilenceTrim::OFF;
+    }
+    const std::string name = config["silence_trim"].get<std::string>();
+    if (name == "energy") {
+        return WhisperSilenceTrim::ENERGY;
+    }
+    if (name == "vad") {
+        return WhisperSilenceTrim::VAD;
+    }
+    if (name != "off") {
+        LOGW("Unknown silence trim mode '%s'", name.c_str());
+    }
+    return WhisperSilenceTrim::OFF;
+}
+
+// Turns ordered raw speech regions into the spans that are transcribed:
+// regions closer than max_pause are joined, each span gets pad samples of
+// context, and compact_start is where it lands once spans are concatenated
+static void finish_speech_spans(std::vector<SpeechSpan>& spans, size_t num_samples, size_t pad,
+                                size_t max_pause) {
+    // Gaps the padding would close are joined too, so padded spans never overlap
+    const size_t join_gap = std::max(max_pause, 2 * pad);
+    size_t out = 0;
+    for (size_t i = 0; i < spans.size(); ++i) {
+        if (out > 0 && spans[i].start <= spans[out - 1].end + join_gap) {
+            spans[out - 1].end = spans[i].end;
+        } else {
+            spans[out++] = spans[i];
+        }
+    }
+    spans.resize(out);
+
+    size_t compact = 0;
+    for (SpeechSpan& span : spans) {
+        span.start = span.start > pad ? span.start - pad : 0;
+        span.end = std::min(num_samples, span.end + pad);
+        span.compact_start = compact;
+        compact += span.end - span.start;
+    }
+}
+
+// Maps a time of the concatenated spans back to the original audio
+static double to_original_ms(double ms, const std::vector<SpeechSpan>& spans) {
+    const double sample = ms * WHISPER_SAMPLE_RATE / 1000.0;
+    auto it = std::upper_bound(spans.begin(), spans.end(), sample,
+                               [](double value, const SpeechSpan& span) {
+                                   return value < static_cast<double>(span.compact_start);
+                               });
+    const SpeechSpan& span = it == spans.begin() ? spans.front() : *(it - 1);
+    const double original = static_cast<double>(span.start) + (sample - span.compact_start);
+    return original * 1000.0 / WHISPER_SAMPLE_RATE;
+}
+
+#if RAC_WHISPERCPP_COREML
+// Where whisper.cpp looks for the Core ML encoder of a GGML file: the
+// extension and a "-qX_Y" quantization suffix replaced by "-encoder.mlmodelc"
+// (whisper_get_coreml_path_encoder)
+static std::string coreml_encoder_path(std::string path) {
+    size_t pos = path.rfind('.');
+    if (pos != std::string::npos && path.find('/', pos) == std::string::npos) {
+        path.resize(pos);
+    }
+    pos = path.rfind('-');
+    if (pos != std::string::npos && path.size() - pos == 5 && path[pos + 1] == 'q' &&
+        path[pos + 3] == '_') {
+        path.resize(pos);
+    }
+    return path + "-encoder.mlmodelc";
+}
+
+static bool is_directory(const std::string& path) {
+    struct stat st = {};
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+// A Core ML encoder elsewhere in the model's folder (e.g. unpacked from its
+// own archive) is linked to where whisper.cpp looks for it
+static bool link_coreml_encoder(const std::string& model_path, const std::string& expected) {
+    char model_id[256];
+    rac_inference_framework_t framework = RAC_FRAMEWORK_UNKNOWN;
+    char folder[1024];
+    if (rac_model_paths_extract_model_id(model_path.c_str(), model_id, sizeof(model_id)) !=
+            RAC_SUCCESS ||
+        rac_model_paths_extract_framework(model_path.c_str(), &framework) != RAC_SUCCESS ||
+        rac_model_paths_get_model_folder(model_id, framework, folder, sizeof(folder)) !=
+            RAC_SUCCESS) {
+        return false;
+    }
+
+    DIR* dir = opendir(folder);
+    if (!dir) {
+        return false;
+    }
+    static const std::string kSuffix = "-encoder.mlmodelc";
+    std::string found;
+    while (dirent* entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name.size() > kSuffix.size() &&
+            name.compare(name.size() - kSuffix.size(), kSuffix.size(), kSuffix) == 0 &&
+            is_directory(std::string(folder) + "/" + name)) {
+            found = std::string(folder) + "/" + name;
+            break;
+        }
+    }
+    closedir(dir);
+    if (found.empty()) {
+        return false;
+    }
+    if (symlink(found.c_str(), expected.c_str()) != 0) {
+        LOGW("Could not link Core ML encoder %s to %s", found.c_str(), expected.c_str());
+        return false;
+    }
+    LOGI("Linked Core ML encoder %s", found.c_str());
+    return true;
+}
+#endif
+
+// Picks the DTW alignment heads for a GGML whisper model from its header
+// (the architecture is identified by layer counts and vocabulary size)
+static whisper_alignment_heads_preset detect_aheads_preset(const std::string& model_path) {
+    FILE* file = fopen(model_path.c_str(), "rb");
+    if (!file) {
+        return WHISPER_AHEADS_NONE;
+    }
+    uint32_t magic = 0;
+    // n_vocab, n_audio_ctx, n_audio_state, n_audio_head, n_audio_layer,
+    // n_text_ctx, n_text_state, n_text_head, n_text_layer
+    int32_t hparams[9] = {};
+    const bool ok = fread(&magic, sizeof(magic), 1, file) == 1 &&
+                    fread(hparams, sizeof(hparams), 1, file) == 1 && magic == 0x67676d6c;
+    fclose(file);
+    if (!ok) {
+        return WHISPER_AHEADS_NONE;
+    }
+
+    const bool english = hparams[0] == 51864;
+    const int32_t n_audio_layer = hparams[4];
+    const int32_t n_text_layer = hparams[8];
+    switch (n_audio_layer) {
+        case 4:
+            return english ? WHISPER_AHEADS_TINY_EN : WHISPER_AHEADS_TINY;
+        case 6:
+            return english ? WHISPER_AHEADS_BASE_EN : WHISPER_AHEADS_BASE;
+        case 12:
+            return english ? WHISPER_AHEADS_SMALL_EN : WHISPER_AHEADS_SMALL;
+        case 24:
+            return english ? WHISPER_AHEADS_MEDIUM_EN : WHISPER_AHEADS_MEDIUM;
+        case 32:
+            if (n_text_layer == 4) {
+                return WHISPER_AHEADS_LARGE_V3_TURBO;
+            }
+            // v3 added a language token; v1 and v2 share a shape, v2 is the common one
+            return hparams[0] == 51866 ? WHISPER_AHEADS_LARGE_V3 : WHISPER_AHEADS_LARGE_V2;
+        default:
+            return WHISPER_AHEADS_NONE;  // distilled and custom models
+    }
+}
+
 // =============================================================================
 // WHISPERCPP BACKEND IMPLEMENTATION
 // =============================================================================
@@ -109,6 +324,119 @@ size_t WhisperCppBackend::get_memory_usage() const {
     return 0;
 }
 
+// =============================================================================
+// SHARED WEIGHTS
+// =============================================================================
+
+// Decodes all run on pooled whisper_states, so the context only holds the
+// weights and every WhisperCppSTT loading the same file shares one
+static rac::SharedWeightsCache<whisper_context>& shared_contexts() {
+    static rac::SharedWeightsCache<whisper_context> cache(whisper_free);
+    return cache;
+}
+
+static whisper_context* acquire_context(const std::string& path,
+                                        const whisper_context_params& cparams) {
+    char variant[64];
+    snprintf(variant, sizeof(variant), "gpu=%d fa=%d dtw=%d", cparams.use_gpu ? 1 : 0,
+             cparams.flash_attn ? 1 : 0,
+             cparams.dtw_token_timestamps ? static_cast<int>(cparams.dtw_aheads_preset) : -1);
+    whisper_context* ctx = shared_contexts().acquire(path, variant, [&] {
+        return whisper_init_from_file_with_params_no_state(path.c_str(), cparams);
+    });
+    if (ctx && shared_contexts().refs(ctx) > 1) {
+        LOGI("Sharing loaded weights of %s (%d users)", path.c_str(),
+             shared_contexts().refs(ctx));
+    }
+    return ctx;
+}
+
+// =============================================================================
+// STATE POOL
+// =============================================================================
+
+WhisperPooledState::~WhisperPooledState() {
+    if (state) {
+        whisper_free_state(state);
+    }
+    rac_audio_resampler_destroy(resampler);
+}
+
+void WhisperStatePool::set_max_size(size_t max_size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_size_ = std::max<size_t>(1, max_size);
+}
+
+WhisperPooledState* WhisperStatePool::acquire(whisper_context* ctx) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    available_.wait(lock, [this] { return !idle_.empty() || created_ < max_size_; });
+
+    if (!idle_.empty()) {
+        WhisperPooledState* pooled = idle_.back().release();
+        idle_.pop_back();
+        return pooled;
+    }
+
+    // State creation allocates the KV and compute buffers; do it unlocked
+    created_++;
+    lock.unlock();
+
+    auto pooled = std::make_unique<WhisperPooledState>();
+    pooled->state = whisper_init_state(ctx);
+    if (!pooled->state) {
+        LOGE("Failed to create whisper state");
+        lock.lock();
+        created_--;
+        available_.notify_one();
+        return nullptr;
+    }
+    return pooled.release();
+}
+
+void WhisperStatePool::release(WhisperPooledState* state) {
+    if (!state) {
+        return;
+    }
+
+    std::unique_ptr<WhisperPooledState> pooled(state);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (created_ > max_size_) {
+            created_--;  // the pool was shrunk; drop the surplus state
+        } else {
+            idle_.push_back(std::move(pooled));
+        }
+    }
+    available_.notify_one();
+}
+
+void WhisperStatePool::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    created_ -= idle_.size();
+    idle_.clear();
+}
+
+namespace {
+
+// Checks a state out of the pool for the enclosing scope
+class PooledStateLease {
+   public:
+    PooledStateLease(WhisperStatePool& pool, whisper_context* ctx)
+        : pool_(pool), state_(pool.acquire(ctx)) {}
+    ~PooledStateLease() { pool_.release(state_); }
+
+    PooledStateLease(const PooledStateLease&) = delete;
+    PooledStateLease& operator=(const PooledStateLease&) = delete;
+
+    WhisperPooledState* get() const { return state_; }
+
+   private:
+    WhisperStatePool& pool_;
+    WhisperPooledState* state_;
+};
+
+}  // namespace
+
 // =============================================================================
 // WHISPERCPP STT IMPLEMENTATION
 // =============================================================================
@@ -119,12 +447,6 @@ WhisperCppSTT::WhisperCppSTT(WhisperCppBackend* backend) : backend_(backend) {
 
 WhisperCppSTT::~WhisperCppSTT() {
     unload_model();
-
-    for (auto& [id, state] : streams_) {
-        if (state && state->state) {
-            whisper_free_state(state->state);
-        }
-    }
     streams_.clear();
 
     LOGI("WhisperCppSTT destroyed");
@@ -136,79 +458,261 @@ bool WhisperCppSTT::is_ready() const {
 
 bool WhisperCppSTT::load_model(const std::string& model_path, STTModelType model_type,
                                const nlohmann::json& config) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    RAC_TRACE_SCOPE("STT.Whisper.load_model");
+    stop_warmup();
+    std::unique_lock<std::shared_mutex> lock(model_mutex_);
 
     if (model_loaded_ && ctx_) {
         LOGI("Unloading previous model");
-        whisper_free(ctx_);
+        state_pool_.clear();  // states belong to the old context
+        shared_contexts().release(ctx_);
         ctx_ = nullptr;
         model_loaded_ = false;
     }
+    if (vad_ctx_) {
+        whisper_vad_free(vad_ctx_);
+        vad_ctx_ = nullptr;
+    }
 
     LOGI("Loading whisper model from: %s", model_path.c_str());
 
     whisper_context_params cparams = whisper_context_default_params();
     cparams.use_gpu = backend_->is_gpu_enabled();
 
-    if (config.contains("word_timestamps") && config["word_timestamps"].get<bool>()) {
-        cparams.dtw_token_timestamps = true;
-        cparams.dtw_aheads_preset = WHISPER_AHEADS_LARGE_V3;
-    }
-
     if (config.contains("flash_attention")) {
         cparams.flash_attn = config["flash_attention"].get<bool>();
     }
 
-    ctx_ = whisper_init_from_file_with_params(model_path.c_str(), cparams);
+    // Word timestamps come from the cheap timestamp-token heuristic, computed
+    // only for requests that ask for them. DTW alignment is more precise but
+    // runs on every decode once built into the context, so it is opt-in and
+    // uses the alignment heads of the actual model size.
+    dtw_enabled_ = false;
+    if (config.value("dtw_timestamps", false)) {
+        const whisper_alignment_heads_preset preset = detect_aheads_preset(model_path);
+        if (preset == WHISPER_AHEADS_NONE) {
+            LOGW("No alignment heads known for this model; DTW timestamps disabled");
+        } else {
+            cparams.dtw_token_timestamps = true;
+            cparams.dtw_aheads_preset = preset;
+            cparams.flash_attn = false;  // DTW reads the attention weights
+            dtw_enabled_ = true;
+        }
+    }
+
+    // Each whisper_state loads the Core ML encoder found next to the model and
+    // runs encoder passes on the Neural Engine; without one (or if it fails to
+    // load) whisper.cpp falls back to the ggml encoder
+    accelerator_ = WhisperAccelerator::CPU;
+#if defined(__APPLE__)
+    if (cparams.use_gpu) {
+        accelerator_ = WhisperAccelerator::METAL;
+    }
+#endif
+#if RAC_WHISPERCPP_COREML
+    const std::string coreml_path = coreml_encoder_path(model_path);
+    if (is_directory(coreml_path) ||
+        (config.value("use_coreml", true) && link_coreml_encoder(model_path, coreml_path))) {
+        accelerator_ = WhisperAccelerator::COREML;
+        LOGI("Core ML encoder: %s", coreml_path.c_str());
+    } else {
+        LOGI("No Core ML encoder at %s; encoding with %s", coreml_path.c_str(),
+             accelerator_name());
+    }
+#endif
+
+    ctx_ = acquire_context(model_path, cparams);
 
     if (!ctx_) {
         LOGE("Failed to load whisper model from: %s", model_path.c_str());
         return false;
     }
 
+    decoding_ = parse_decoding_policy(config, WhisperDecodingPolicy::GREEDY_FALLBACK);
+    if (config.contains("beam_size")) {
+        beam_size_ = std::min(kMaxBeamSize, std::max(2, config["beam_size"].get<int>()));
+    }
+
+    silence_trim_ = parse_silence_trim(config);
+    silence_pad_ms_ = std::max(0, config.value("silence_pad_ms", 200));
+    silence_max_pause_ms_ = std::max(0, config.value("silence_max_pause_ms", 600));
+    if (silence_trim_ == WhisperSilenceTrim::VAD) {
+        const std::string vad_path = config.value("vad_model_path", std::string());
+        if (!vad_path.empty()) {
+            whisper_vad_context_params vparams = whisper_vad_default_context_params();
+            vparams.n_threads = 1;
+            vparams.use_gpu = false;
+            vad_ctx_ = whisper_vad_init_from_file_with_params(vad_path.c_str(), vparams);
+        }
+        if (!vad_ctx_) {
+            LOGW("No usable VAD model ('%s'); trimming silence by energy", vad_path.c_str());
+            silence_trim_ = WhisperSilenceTrim::ENERGY;
+        }
+    }
+
+    // States hold the KV and compute buffers (hundreds of MB for larger
+    // models), so the pool is what bounds concurrent transcriptions
+    state_pool_.set_max_size(
+        config.contains("state_pool_size") ? std::max(1, config["state_pool_size"].get<int>()) : 2);
+
     model_path_ = model_path;
     model_config_ = config;
     model_loaded_ = true;
+    warmed_up_.store(false);
 
     LOGI("Whisper model loaded successfully. Multilingual: %s",
          whisper_is_multilingual(ctx_) ? "yes" : "no");
 
+    // Starts once this load releases the model lock
+    if (config.value("warmup", false)) {
+        warmup_stop_.store(false);
+        warmup_thread_ = std::thread(&WhisperCppSTT::run_warmup, this);
+    }
+
     return true;
 }
 
+const char* WhisperCppSTT::accelerator_name() const {
+    switch (accelerator_) {
+        case WhisperAccelerator::COREML:
+            return "coreml";
+        case WhisperAccelerator::METAL:
+            return "metal";
+        case WhisperAccelerator::CPU:
+        default:
+            return "cpu";
+    }
+}
+
 bool WhisperCppSTT::is_model_loaded() const {
     return model_loaded_;
 }
 
 bool WhisperCppSTT::unload_model() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    stop_warmup();
+
+    // Waits for in-flight transcriptions, which hold the lock shared
+    std::unique_lock<std::shared_mutex> model_lock(model_mutex_);
 
     if (!model_loaded_ || !ctx_) {
         return true;
     }
 
-    for (auto& [id, state] : streams_) {
-        if (state && state->state) {
-            whisper_free_state(state->state);
-        }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        streams_.clear();
     }
-    streams_.clear();
+    state_pool_.clear();
 
-    whisper_free(ctx_);
+    shared_contexts().release(ctx_);
     ctx_ = nullptr;
     model_loaded_ = false;
     model_path_.clear();
+    if (vad_ctx_) {
+        whisper_vad_free(vad_ctx_);
+        vad_ctx_ = nullptr;
+    }
 
     LOGI("Whisper model unloaded");
     return true;
 }
 
+void WhisperCppSTT::run_warmup() {
+    std::shared_lock<std::shared_mutex> model_lock(model_mutex_);
+    if (!model_loaded_ || !ctx_ || warmup_stop_.load()) {
+        return;
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    // Checking out a state allocates it; it goes back to the pool warm
+    PooledStateLease lease(state_pool_, ctx_);
+    if (!lease.get()) {
+        return;
+    }
+
+    const int ret = decode_silence(lease.get()->state, &warmup_stop_);
+    if (ret != 0 || warmup_stop_.load()) {
+        LOGW("Warm-up did not complete (%d)", ret);
+        return;
+    }
+
+    const double duration_ms = std::chrono::duration<double, std::milli>(
+                                   std::chrono::steady_clock::now() - start_time)
+                                   .count();
+    warmed_up_.store(true);
+    LOGI("Warm-up completed in %.0fms", duration_ms);
+    if (warmup_callback_) {
+        warmup_callback_(duration_ms);
+    }
+}
+
+int WhisperCppSTT::decode_silence(whisper_state* state, std::atomic<bool>* abort_flag) {
+    // One second of silence runs a full-width encoder pass and a short decode
+    std::vector<float> silence(WHISPER_SAMPLE_RATE, 0.0f);
+    whisper_full_params wparams = make_params(WhisperDecodingPolicy::GREEDY_FAST);
+    wparams.language = "en";
+    wparams.no_timestamps = true;
+    wparams.single_segment = true;
+    wparams.max_tokens = 1;
+    if (abort_flag) {
+        wparams.abort_callback = [](void* user_data) -> bool {
+            return static_cast<std::atomic<bool>*>(user_data)->load();
+        };
+        wparams.abort_callback_user_data = abort_flag;
+    }
+
+    return whisper_full_with_state(ctx_, state, wparams, silence.data(),
+                                   static_cast<int>(silence.size()));
+}
+
+double WhisperCppSTT::measure_rtf() {
+    std::shared_lock<std::shared_mutex> model_lock(model_mutex_);
+    if (!model_loaded_ || !ctx_) {
+        return -1.0;
+    }
+
+    PooledStateLease lease(state_pool_, ctx_);
+    if (!lease.get()) {
+        return -1.0;
+    }
+
+    // The first pass allocates buffers; only the second is representative
+    if (decode_silence(lease.get()->state, nullptr) != 0) {
+        return -1.0;
+    }
+    const auto start_time = std::chrono::steady_clock::now();
+    if (decode_silence(lease.get()->state, nullptr) != 0) {
+        return -1.0;
+    }
+    const double elapsed_s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    // The encoder always processes a full 30 s window, which dominates the
+    // cost of decoding speech that fills it
+    const double rtf = elapsed_s / 30.0;
+    LOGI("Measured real-time factor %.3f", rtf);
+    return rtf;
+}
+
+void WhisperCppSTT::stop_warmup() {
+    if (warmup_thread_.joinable()) {
+        warmup_stop_.store(true);
+        warmup_thread_.join();
+    }
+}
+
 STTModelType WhisperCppSTT::get_model_type() const {
     return STTModelType::WHISPER;
 }
 
 STTResult WhisperCppSTT::transcribe(const STTRequest& request) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    return transcribe(request.audio_samples.data(), request.audio_samples.size(), request);
+}
+
+STTResult WhisperCppSTT::transcribe(const float* samples, size_t num_samples,
+                                    const STTRequest& request) {
+    std::shared_lock<std::shared_mutex> model_lock(model_mutex_);
 
     STTResult result;
     result.is_final = true;
@@ -218,36 +722,187 @@ STTResult WhisperCppSTT::transcribe(const STTRequest& request) {
         return result;
     }
 
+    PooledStateLease lease(state_pool_, ctx_);
+    WhisperPooledState* pooled = lease.get();
+    if (!pooled) {
+        return result;
+    }
+
     cancel_requested_.store(false);
 
-    std::vector<float> audio = request.audio_samples;
-    if (request.sample_rate != WHISPER_SAMPLE_RATE) {
-        audio = resample_to_16khz(request.audio_samples, request.sample_rate);
+    const float* audio = samples;
+    size_t audio_size = num_samples;
+    if (request.sample_rate != WHISPER_SAMPLE_RATE && request.sample_rate > 0) {
+        // Each file starts from a clean filter history
+        if (pooled->resampler) {
+            rac_audio_resampler_reset(pooled->resampler);
+        }
+        pooled->resample_buffer.clear();
+        if (!resample_to_16khz(&pooled->resampler, &pooled->resampler_rate, samples, num_samples,
+                               request.sample_rate, pooled->resample_buffer)) {
+            LOGE("Failed to resample audio from %d Hz", request.sample_rate);
+            return result;
+        }
+        audio = pooled->resample_buffer.data();
+        audio_size = pooled->resample_buffer.size();
+    }
+
+    const bool detect = request.detect_language || request.language.empty();
+    if (silence_trim_ == WhisperSilenceTrim::OFF) {
+        return transcribe_internal(audio, audio_size, request.language, detect,
+                                   request.translate_to_english, request.word_timestamps,
+                                   pooled->state);
+    }
+
+    // Dead air costs encoder and decoder time like speech does: transcribe
+    // only the speech and move the timestamps back onto the clip
+    const double audio_ms = audio_size * 1000.0 / WHISPER_SAMPLE_RATE;
+    std::vector<SpeechSpan>& spans = pooled->speech_spans;
+    if (!find_speech(audio, audio_size, spans)) {
+        LOGD("No speech in %.0f ms of audio, skipping decode", audio_ms);
+        result.audio_duration_ms = audio_ms;
+        return result;
+    }
+    const size_t kept = spans.back().compact_start + (spans.back().end - spans.back().start);
+    if (kept > audio_size * (1.0 - kMinTrimShare)) {
+        return transcribe_internal(audio, audio_size, request.language, detect,
+                                   request.translate_to_english, request.word_timestamps,
+                                   pooled->state);
+    }
+
+    std::vector<float>& trimmed = pooled->trim_buffer;
+    trimmed.resize(kept);
+    for (const SpeechSpan& span : spans) {
+        std::copy(audio + span.start, audio + span.end, trimmed.begin() + span.compact_start);
+    }
+    LOGD("Silence trim: %zu speech spans, %.0f of %.0f ms transcribed", spans.size(),
+         kept * 1000.0 / WHISPER_SAMPLE_RATE, audio_ms);
+
+    result = transcribe_internal(trimmed.data(), kept, request.language, detect,
+                                 request.translate_to_english, request.word_timestamps,
+                                 pooled->state);
+    for (AudioSegment& segment : result.segments) {
+        segment.start_time_ms = to_original_ms(segment.start_time_ms, spans);
+        segment.end_time_ms = to_original_ms(segment.end_time_ms, spans);
+    }
+    for (WordTiming& word : result.word_timings) {
+        word.start_time_ms = to_original_ms(word.start_time_ms, spans);
+        word.end_time_ms = to_original_ms(word.end_time_ms, spans);
+    }
+    result.audio_duration_ms = audio_ms;
+    return result;
+}
+
+bool WhisperCppSTT::find_speech(const float* audio, size_t num_samples,
+                                std::vector<SpeechSpan>& spans) {
+    spans.clear();
+    if (silence_trim_ == WhisperSilenceTrim::VAD && vad_ctx_) {
+        return find_speech_vad(audio, num_samples, spans);
+    }
+
+    const size_t n_frames = num_samples / kTrimFrameSamples;
+    if (n_frames < kMinSpeechFrames) {
+        spans.push_back({0, num_samples, 0});
+        return true;
+    }
+
+    std::vector<float> rms(n_frames);
+    for (size_t i = 0; i < n_frames; ++i) {
+        rms[i] = rac_audio_rms(audio + i * kTrimFrameSamples, kTrimFrameSamples);
+    }
+    std::vector<float> sorted = rms;
+    auto floor_it = sorted.begin() + static_cast<ptrdiff_t>(n_frames * kNoiseFloorPercentile);
+    std::nth_element(sorted.begin(), floor_it, sorted.end());
+    const float threshold =
+        std::min(kMaxSpeechRms, std::max(kMinSpeechRms, *floor_it * kNoiseFloorMultiplier));
+
+    size_t run_start = 0;
+    size_t run_length = 0;
+    for (size_t i = 0; i <= n_frames; ++i) {
+        if (i < n_frames && rms[i] >= threshold) {
+            if (run_length++ == 0) {
+                run_start = i;
+            }
+            continue;
+        }
+        if (run_length >= kMinSpeechFrames) {
+            spans.push_back({run_start * kTrimFrameSamples,
+                             (run_start + run_length) * kTrimFrameSamples, 0});
+        }
+        run_length = 0;
+    }
+    if (spans.empty()) {
+        return false;
+    }
+    // The partial frame at the end goes with speech that reaches it
+    if (spans.back().end == n_frames * kTrimFrameSamples) {
+        spans.back().end = num_samples;
+    }
+
+    const size_t samples_per_ms = WHISPER_SAMPLE_RATE / 1000;
+    finish_speech_spans(spans, num_samples, silence_pad_ms_ * samples_per_ms,
+                        silence_max_pause_ms_ * samples_per_ms);
+    return true;
+}
+
+bool WhisperCppSTT::find_speech_vad(const float* audio, size_t num_samples,
+                                    std::vector<SpeechSpan>& spans) {
+    whisper_vad_params params = whisper_vad_default_params();
+    params.min_silence_duration_ms = silence_max_pause_ms_;
+    params.speech_pad_ms = 0;  // padded below, as for the energy pass
+
+    std::lock_guard<std::mutex> lock(vad_mutex_);
+    whisper_vad_segments* segments =
+        whisper_vad_segments_from_samples(vad_ctx_, params, audio, static_cast<int>(num_samples));
+    if (!segments) {
+        LOGW("VAD failed; transcribing the whole clip");
+        spans.push_back({0, num_samples, 0});
+        return true;
     }
 
-    return transcribe_internal(audio, request.language,
-                               request.detect_language || request.language.empty(),
-                               request.translate_to_english, request.word_timestamps);
+    // Segment times are in centiseconds, like whisper's own timestamps
+    const int n_segments = whisper_vad_segments_n_segments(segments);
+    for (int i = 0; i < n_segments; ++i) {
+        const auto to_sample = [num_samples](float cs) {
+            const double sample = std::max(0.0, cs * (WHISPER_SAMPLE_RATE / 100.0));
+            return std::min(num_samples, static_cast<size_t>(sample));
+        };
+        const size_t start = to_sample(whisper_vad_segments_get_segment_t0(segments, i));
+        const size_t end = to_sample(whisper_vad_segments_get_segment_t1(segments, i));
+        if (end > start && (spans.empty() || start >= spans.back().end)) {
+            spans.push_back({start, end, 0});
+        }
+    }
+    whisper_vad_free_segments(segments);
+    if (spans.empty()) {
+        return false;
+    }
+
+    const size_t samples_per_ms = WHISPER_SAMPLE_RATE / 1000;
+    finish_speech_spans(spans, num_samples, silence_pad_ms_ * samples_per_ms,
+                        silence_max_pause_ms_ * samples_per_ms);
+    return true;
 }
 
-STTResult WhisperCppSTT::transcribe_internal(const std::vector<float>& audio,
+STTResult WhisperCppSTT::transcribe_internal(const float* audio, size_t num_samples,
                                              const std::string& language, bool detect_language,
-                                             bool translate, bool word_timestamps) {
+                                             bool translate, bool word_timestamps,
+                                             whisper_state* state) {
     STTResult result;
     result.is_final = true;
 
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    whisper_full_params wparams = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
-    wparams.n_threads = backend_->get_num_threads();
-    wparams.print_progress = false;
-    wparams.print_realtime = false;
-    wparams.print_special = false;
-    wparams.print_timestamps = false;
+    // Shares the cores with LLM and TTS when they overlap
+    rac::ScopedCpuBudget cpu_budget(RAC_CPU_STAGE_STT, backend_->get_num_threads());
+    whisper_full_params wparams = make_params(decoding_);
+    wparams.n_threads = cpu_budget.threads();
 
     if (detect_language || language.empty()) {
-        wparams.language = nullptr;
-        wparams.detect_language = true;
+        // "auto" detects on the mel computed for decoding and then transcribes;
+        // detect_language=true would stop after detection
+        wparams.language = "auto";
+        wparams.detect_language = false;
     } else {
         wparams.language = language.c_str();
         wparams.detect_language = false;
@@ -262,44 +917,72 @@ STTResult WhisperCppSTT::transcribe_internal(const std::vector<float>& audio,
     };
     wparams.abort_callback_user_data = &cancel_requested_;
 
-    int ret = whisper_full(ctx_, wparams, audio.data(), static_cast<int>(audio.size()));
+    // Each 30 s window starts with its encoder pass; a span per window covers
+    // encode and decode, inside the span of the whole call
+    bool window_open = false;
+#if RAC_TRACE_ENABLED
+    wparams.encoder_begin_callback = [](whisper_context*, whisper_state*, void* user_data) {
+        auto* open = static_cast<bool*>(user_data);
+        if (*open) {
+            rac_trace_end();
+        }
+        *open = rac_trace_is_enabled() == RAC_TRUE;
+        if (*open) {
+            rac_trace_begin("STT.Whisper.window");
+        }
+        return true;
+    };
+    wparams.encoder_begin_callback_user_data = &window_open;
+#endif
+
+    int ret;
+    {
+        RAC_TRACE_SCOPE("STT.Whisper.full");
+        ret = whisper_full_with_state(ctx_, state, wparams, audio, static_cast<int>(num_samples));
+        if (window_open) {
+            rac_trace_end();
+        }
+    }
 
     if (ret != 0) {
-        LOGE("whisper_full failed with code: %d", ret);
+        LOGE("whisper_full_with_state failed with code: %d", ret);
         return result;
     }
 
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-    const int n_segments = whisper_full_n_segments(ctx_);
+    const int n_segments = whisper_full_n_segments_from_state(state);
     std::string full_text;
 
     for (int i = 0; i < n_segments; ++i) {
-        const char* text = whisper_full_get_segment_text(ctx_, i);
+        const char* text = whisper_full_get_segment_text_from_state(state, i);
         if (text) {
             full_text += text;
 
             AudioSegment segment;
             segment.text = text;
-            segment.start_time_ms = whisper_full_get_segment_t0(ctx_, i) * 10.0;
-            segment.end_time_ms = whisper_full_get_segment_t1(ctx_, i) * 10.0;
+            segment.start_time_ms = whisper_full_get_segment_t0_from_state(state, i) * 10.0;
+            segment.end_time_ms = whisper_full_get_segment_t1_from_state(state, i) * 10.0;
 
-            float no_speech_prob = whisper_full_get_segment_no_speech_prob(ctx_, i);
+            float no_speech_prob = whisper_full_get_segment_no_speech_prob_from_state(state, i);
             segment.confidence = 1.0f - no_speech_prob;
 
             result.segments.push_back(segment);
 
             if (word_timestamps) {
-                const int n_tokens = whisper_full_n_tokens(ctx_, i);
+                const int n_tokens = whisper_full_n_tokens_from_state(state, i);
                 for (int j = 0; j < n_tokens; ++j) {
-                    whisper_token_data token_data = whisper_full_get_token_data(ctx_, i, j);
-                    const char* token_text = whisper_full_get_token_text(ctx_, i, j);
+                    whisper_token_data token_data = whisper_full_get_token_data_from_state(state, i, j);
+                    const char* token_text = whisper_full_get_token_text_from_state(ctx_, state, i, j);
 
                     if (token_text && token_text[0] != '\0' && token_text[0] != '<') {
                         WordTiming word;
                         word.word = token_text;
-                        word.start_time_ms = token_data.t0 * 10.0;
+                        word.start_time_ms =
+                            (dtw_enabled_ && token_data.t_dtw >= 0 ? token_data.t_dtw
+                                                                   : token_data.t0) *
+                            10.0;
                         word.end_time_ms = token_data.t1 * 10.0;
                         word.confidence = token_data.p;
                         result.word_timings.push_back(word);
@@ -310,10 +993,10 @@ STTResult WhisperCppSTT::transcribe_internal(const std::vector<float>& audio,
     }
 
     result.text = full_text;
-    result.audio_duration_ms = (audio.size() / static_cast<double>(WHISPER_SAMPLE_RATE)) * 1000.0;
+    result.audio_duration_ms = (num_samples / static_cast<double>(WHISPER_SAMPLE_RATE)) * 1000.0;
     result.inference_time_ms = static_cast<double>(duration.count());
 
-    int lang_id = whisper_full_lang_id(ctx_);
+    int lang_id = whisper_full_lang_id_from_state(state);
     if (lang_id >= 0) {
         result.detected_language = whisper_lang_str(lang_id);
     }
@@ -326,13 +1009,36 @@ STTResult WhisperCppSTT::transcribe_internal(const std::vector<float>& audio,
         result.confidence = total_conf / static_cast<float>(result.segments.size());
     }
 
-    LOGI("Transcription complete: %d segments, %.0fms inference, lang=%s", n_segments,
+    LOGD("Transcription complete: %d segments, %.0fms inference, lang=%s", n_segments,
          result.inference_time_ms,
          result.detected_language.empty() ? "unknown" : result.detected_language.c_str());
 
     return result;
 }
 
+whisper_full_params WhisperCppSTT::make_params(WhisperDecodingPolicy policy) const {
+    const bool beam = policy == WhisperDecodingPolicy::BEAM;
+    whisper_full_params wparams =
+        whisper_full_default_params(beam ? WHISPER_SAMPLING_BEAM_SEARCH : WHISPER_SAMPLING_GREEDY);
+    wparams.n_threads = backend_->get_num_threads();
+    wparams.print_progress = false;
+    wparams.print_realtime = false;
+    wparams.print_special = false;
+    wparams.print_timestamps = false;
+
+    // whisper.cpp evaluates the thresholds per 30 s window and retries only
+    // the windows that fail them
+    wparams.entropy_thold = kEntropyThreshold;
+    wparams.logprob_thold = kLogprobThreshold;
+    wparams.temperature = 0.0f;
+    wparams.temperature_inc = policy == WhisperDecodingPolicy::GREEDY_FAST ? 0.0f : kTemperatureStep;
+    wparams.greedy.best_of = kFallbackBestOf;
+    if (beam) {
+        wparams.beam_search.beam_size = beam_size_;
+    }
+    return wparams;
+}
+
 bool WhisperCppSTT::supports_streaming() const {
     return true;
 }
@@ -344,22 +1050,14 @@ std::string WhisperCppSTT::generate_stream_id() {
 }
 
 std::string WhisperCppSTT::create_stream(const nlohmann::json& config) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_lock<std::shared_mutex> model_lock(model_mutex_);
 
     if (!model_loaded_ || !ctx_) {
         LOGE("Cannot create stream: model not loaded");
         return "";
     }
 
-    std::string stream_id = generate_stream_id();
-
-    auto state = std::make_unique<WhisperStreamState>();
-    state->state = whisper_init_state(ctx_);
-
-    if (!state->state) {
-        LOGE("Failed to create whisper state for stream");
-        return "";
-    }
+    auto state = std::make_shared<WhisperStreamState>();
 
     if (config.contains("language")) {
         state->language = config["language"].get<std::string>();
@@ -369,146 +1067,316 @@ std::string WhisperCppSTT::create_stream(const nlohmann::json& config) {
         state->sample_rate = config["sample_rate"].get<int>();
     }
 
+    if (config.contains("step_ms")) {
+        state->step_ms = std::max(100, config["step_ms"].get<int>());
+    }
+
+    state->decoding = parse_decoding_policy(config, decoding_);
+
+    if (config.contains("max_window_ms")) {
+        // Whisper sees at most 30 s per pass
+        state->max_window_ms = std::min(25000, std::max(2000, config["max_window_ms"].get<int>()));
+    }
+
+    // Room for a full window plus the steps fed before it is trimmed
+    state->audio_buffer.reserve(static_cast<size_t>(state->max_window_ms + 2 * state->step_ms) *
+                                WHISPER_SAMPLE_RATE / 1000);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string stream_id = generate_stream_id();
     streams_[stream_id] = std::move(state);
 
     LOGI("Created stream: %s", stream_id.c_str());
     return stream_id;
 }
 
-bool WhisperCppSTT::feed_audio(const std::string& stream_id, const std::vector<float>& samples,
-                               int sample_rate) {
+std::shared_ptr<WhisperStreamState> WhisperCppSTT::find_stream(const std::string& stream_id) {
     std::lock_guard<std::mutex> lock(mutex_);
 
     auto it = streams_.find(stream_id);
-    if (it == streams_.end()) {
+    return it != streams_.end() ? it->second : nullptr;
+}
+
+bool WhisperCppSTT::feed_audio(const std::string& stream_id, const float* samples,
+                               size_t num_samples, int sample_rate) {
+    auto state = find_stream(stream_id);
+    if (!state) {
         LOGE("Stream not found: %s", stream_id.c_str());
         return false;
     }
-
-    auto& state = it->second;
-
-    std::vector<float> resampled = samples;
-    if (sample_rate != WHISPER_SAMPLE_RATE) {
-        resampled = resample_to_16khz(samples, sample_rate);
+    std::lock_guard<std::mutex> lock(state->mutex);
+
+    // Resample straight into the window's tail; its capacity is reserved at
+    // creation, so steady-state feeding does not allocate. The stream's
+    // resampler keeps its filter history, so chunk boundaries are seamless
+    auto& buffer = state->audio_buffer;
+    const size_t offset = buffer.size();
+    if (!resample_to_16khz(&state->resampler, &state->resampler_rate, samples, num_samples,
+                           sample_rate, buffer)) {
+        LOGE("Failed to resample audio from %d Hz", sample_rate);
+        return false;
     }
-
-    state->audio_buffer.insert(state->audio_buffer.end(), resampled.begin(), resampled.end());
+    state->samples_since_decode += buffer.size() - offset;
 
     return true;
 }
 
 bool WhisperCppSTT::is_stream_ready(const std::string& stream_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    auto it = streams_.find(stream_id);
-    if (it == streams_.end()) {
+    auto state = find_stream(stream_id);
+    if (!state) {
         return false;
     }
+    std::lock_guard<std::mutex> lock(state->mutex);
 
-    const size_t min_samples = WHISPER_SAMPLE_RATE;
-    return it->second->audio_buffer.size() >= min_samples || it->second->input_finished;
+    const auto& stream = *state;
+    const size_t step_samples = static_cast<size_t>(stream.step_ms) * WHISPER_SAMPLE_RATE / 1000;
+    return stream.samples_since_decode >= step_samples || stream.input_finished;
 }
 
 STTResult WhisperCppSTT::decode(const std::string& stream_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_lock<std::shared_mutex> model_lock(model_mutex_);
 
     STTResult result;
 
-    auto it = streams_.find(stream_id);
-    if (it == streams_.end()) {
+    auto state = find_stream(stream_id);
+    if (!state) {
         LOGE("Stream not found: %s", stream_id.c_str());
         return result;
     }
+    std::lock_guard<std::mutex> lock(state->mutex);
 
-    auto& stream_state = it->second;
-
-    if (stream_state->audio_buffer.empty()) {
-        result.is_final = stream_state->input_finished;
-        return result;
-    }
+    auto& stream = *state;
+    result.is_final = stream.input_finished;
 
-    whisper_full_params wparams = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
-    wparams.n_threads = backend_->get_num_threads();
-    wparams.single_segment = !stream_state->input_finished;
-    wparams.no_context = false;
-    wparams.print_progress = false;
-    wparams.print_realtime = false;
-    wparams.print_timestamps = false;
+    if (!stream.audio_buffer.empty() && ctx_) {
+        PooledStateLease lease(state_pool_, ctx_);
+        if (!lease.get()) {
+            return result;
+        }
+        whisper_state* wstate = lease.get()->state;
 
-    if (!stream_state->language.empty()) {
-        wparams.language = stream_state->language.c_str();
-    }
+        auto start_time = std::chrono::high_resolution_clock::now();
 
-    int ret = whisper_full_with_state(ctx_, stream_state->state, wparams,
-                                      stream_state->audio_buffer.data(),
-                                      static_cast<int>(stream_state->audio_buffer.size()));
+        // Interim decodes are thrown away a step later; only the final one
+        // may pay for beam search
+        WhisperDecodingPolicy policy = stream.decoding;
+        if (!stream.input_finished && policy == WhisperDecodingPolicy::BEAM) {
+            policy = WhisperDecodingPolicy::GREEDY_FALLBACK;
+        }
+        rac::ScopedCpuBudget cpu_budget(RAC_CPU_STAGE_STT, backend_->get_num_threads());
+        whisper_full_params wparams = make_params(policy);
+        wparams.n_threads = cpu_budget.threads();
+        wparams.no_context = true;  // context comes from the committed prompt
+        wparams.token_timestamps = true;
+        wparams.prompt_tokens = stream.prompt_tokens.empty() ? nullptr : stream.prompt_tokens.data();
+        wparams.prompt_n_tokens = static_cast<int>(stream.prompt_tokens.size());
+        // Detect only until a language has been locked for the stream; later
+        // windows skip the detection encoder pass
+        if (!stream.language.empty()) {
+            wparams.language = stream.language.c_str();
+        } else if (!stream.detected_language.empty()) {
+            wparams.language = stream.detected_language.c_str();
+        } else {
+            wparams.language = whisper_is_multilingual(ctx_) ? "auto" : "en";
+        }
 
-    if (ret != 0) {
-        LOGE("whisper_full_with_state failed: %d", ret);
-        return result;
-    }
+        int ret = whisper_full_with_state(ctx_, wstate, wparams, stream.audio_buffer.data(),
+                                          static_cast<int>(stream.audio_buffer.size()));
+        stream.samples_since_decode = 0;
+        if (ret != 0) {
+            LOGE("whisper_full_with_state failed: %d", ret);
+            return result;
+        }
 
-    const int n_segments = whisper_full_n_segments_from_state(stream_state->state);
-    std::string full_text;
+        std::vector<StreamWord> words = collect_stream_words(stream, wstate);
 
-    for (int i = 0; i < n_segments; ++i) {
-        const char* text = whisper_full_get_segment_text_from_state(stream_state->state, i);
-        if (text) {
-            full_text += text;
+        // LocalAgreement-2: the prefix both hypotheses agree on is stable
+        size_t agreed = 0;
+        if (stream.input_finished) {
+            agreed = words.size();
+        } else {
+            while (agreed < words.size() && agreed < stream.hypothesis.size() &&
+                   words[agreed].text == stream.hypothesis[agreed].text) {
+                agreed++;
+            }
+        }
+        commit_words(stream, words, agreed, result);
+        stream.hypothesis.assign(std::make_move_iterator(words.begin() + agreed),
+                                 std::make_move_iterator(words.end()));
+
+        const double window_ms = stream.audio_buffer.size() * 1000.0 / WHISPER_SAMPLE_RATE;
+        if (stream.input_finished) {
+            trim_stream_window(stream, stream.buffer_start_ms + window_ms);
+        } else if (window_ms > stream.max_window_ms) {
+            if (stream.committed_end_ms > stream.buffer_start_ms) {
+                trim_stream_window(stream, stream.committed_end_ms);
+            } else {
+                // Nothing agreed for a whole window: commit it rather than
+                // let it grow past what whisper can take
+                commit_words(stream, stream.hypothesis, stream.hypothesis.size(), result);
+                stream.hypothesis.clear();
+                trim_stream_window(stream, stream.buffer_start_ms + window_ms);
+            }
+        }
 
-            AudioSegment segment;
-            segment.text = text;
-            segment.start_time_ms =
-                whisper_full_get_segment_t0_from_state(stream_state->state, i) * 10.0;
-            segment.end_time_ms =
-                whisper_full_get_segment_t1_from_state(stream_state->state, i) * 10.0;
-            result.segments.push_back(segment);
+        int lang_id = whisper_full_lang_id_from_state(wstate);
+        if (lang_id >= 0) {
+            result.detected_language = whisper_lang_str(lang_id);
+            if (stream.language.empty() && stream.detected_language.empty() &&
+                window_ms >= kLanguageLockMs) {
+                stream.detected_language = result.detected_language;
+                LOGI("Stream %s language locked: %s", stream_id.c_str(),
+                     stream.detected_language.c_str());
+            }
         }
+        result.inference_time_ms = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::high_resolution_clock::now() - start_time)
+                .count());
     }
 
-    result.text = full_text;
-    result.is_final = stream_state->input_finished;
+    for (const auto& word : stream.hypothesis) {
+        result.tentative_text += word.text;
+    }
+    result.text = stream.committed_text;
     result.audio_duration_ms =
-        (stream_state->audio_buffer.size() / static_cast<double>(WHISPER_SAMPLE_RATE)) * 1000.0;
+        stream.buffer_start_ms + stream.audio_buffer.size() * 1000.0 / WHISPER_SAMPLE_RATE;
+    return result;
+}
 
-    int lang_id = whisper_full_lang_id_from_state(stream_state->state);
-    if (lang_id >= 0) {
-        result.detected_language = whisper_lang_str(lang_id);
+// Words of the last decode that lie after the committed point, in stream time
+std::vector<StreamWord> WhisperCppSTT::collect_stream_words(WhisperStreamState& stream,
+                                                           whisper_state* state) {
+    std::vector<StreamWord> words;
+    const whisper_token eot = whisper_token_eot(ctx_);
+
+    const int n_segments = whisper_full_n_segments_from_state(state);
+    for (int i = 0; i < n_segments; ++i) {
+        const int n_tokens = whisper_full_n_tokens_from_state(state, i);
+        for (int j = 0; j < n_tokens; ++j) {
+            const whisper_token_data data = whisper_full_get_token_data_from_state(state, i, j);
+            if (data.id >= eot) {
+                continue;  // special and timestamp tokens
+            }
+            const char* text = whisper_full_get_token_text_from_state(ctx_, state, i, j);
+            if (!text || text[0] == '\0') {
+                continue;
+            }
+            const double t0 =
+                stream.buffer_start_ms + (dtw_enabled_ && data.t_dtw >= 0 ? data.t_dtw : data.t0) * 10.0;
+            const double t1 = stream.buffer_start_ms + data.t1 * 10.0;
+            // A leading space starts a new word; BPE pieces without one continue it
+            if (words.empty() || text[0] == ' ') {
+                words.push_back({text, t0, t1, {}});
+            } else {
+                words.back().text += text;
+                words.back().end_ms = t1;
+            }
+            words.back().tokens.push_back(data.id);
+        }
     }
 
-    stream_state->audio_buffer.clear();
+    // Audio before committed_end_ms is only kept as context; drop the words
+    // it produces (with a little slack for timestamp jitter)
+    constexpr double kOverlapSlackMs = 100.0;
+    size_t first = 0;
+    while (first < words.size() && words[first].start_ms < stream.committed_end_ms - kOverlapSlackMs) {
+        first++;
+    }
+    words.erase(words.begin(), words.begin() + static_cast<std::ptrdiff_t>(first));
+
+    // Timestamps near the cut are loose, so also drop a repeat of the last
+    // committed words (up to 5)
+    const auto& tail = stream.committed_tail;
+    for (size_t n = std::min<size_t>({5, tail.size(), words.size()}); n > 0; n--) {
+        bool same = true;
+        for (size_t k = 0; k < n && same; k++) {
+            same = tail[tail.size() - n + k].text == words[k].text;
+        }
+        if (same) {
+            words.erase(words.begin(), words.begin() + static_cast<std::ptrdiff_t>(n));
+            break;
+        }
+    }
+    return words;
+}
 
-    return result;
+void WhisperCppSTT::commit_words(WhisperStreamState& stream, std::vector<StreamWord>& words,
+                                 size_t count, STTResult& result) {
+    constexpr size_t kMaxPromptTokens = 128;
+    constexpr size_t kTailWords = 5;
+
+    for (size_t i = 0; i < count; i++) {
+        StreamWord& word = words[i];
+        stream.committed_text += word.text;
+        stream.committed_end_ms = std::max(stream.committed_end_ms, word.end_ms);
+        stream.prompt_tokens.insert(stream.prompt_tokens.end(), word.tokens.begin(),
+                                    word.tokens.end());
+
+        WordTiming timing;
+        timing.word = word.text;
+        timing.start_time_ms = word.start_ms;
+        timing.end_time_ms = word.end_ms;
+        result.word_timings.push_back(timing);
+
+        stream.committed_tail.push_back(std::move(word));
+    }
+    if (stream.committed_tail.size() > kTailWords) {
+        stream.committed_tail.erase(stream.committed_tail.begin(),
+                                    stream.committed_tail.end() - kTailWords);
+    }
+    if (stream.prompt_tokens.size() > kMaxPromptTokens) {
+        stream.prompt_tokens.erase(stream.prompt_tokens.begin(),
+                                   stream.prompt_tokens.end() - kMaxPromptTokens);
+    }
 }
 
-bool WhisperCppSTT::is_endpoint(const std::string& stream_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
+// Drops window audio before until_ms
+void WhisperCppSTT::trim_stream_window(WhisperStreamState& stream, double until_ms) {
+    const size_t n = std::min(
+        stream.audio_buffer.size(),
+        static_cast<size_t>((until_ms - stream.buffer_start_ms) * WHISPER_SAMPLE_RATE / 1000.0));
+    stream.audio_buffer.erase(stream.audio_buffer.begin(),
+                              stream.audio_buffer.begin() + static_cast<std::ptrdiff_t>(n));
+    stream.buffer_start_ms += n * 1000.0 / WHISPER_SAMPLE_RATE;
+}
 
-    auto it = streams_.find(stream_id);
-    if (it == streams_.end()) {
+bool WhisperCppSTT::is_endpoint(const std::string& stream_id) {
+    auto state = find_stream(stream_id);
+    if (!state) {
         return false;
     }
 
-    return it->second->input_finished;
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->input_finished;
 }
 
 void WhisperCppSTT::input_finished(const std::string& stream_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    auto it = streams_.find(stream_id);
-    if (it != streams_.end()) {
-        it->second->input_finished = true;
+    auto state = find_stream(stream_id);
+    if (state) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->input_finished = true;
         LOGI("Input finished for stream: %s", stream_id.c_str());
     }
 }
 
 void WhisperCppSTT::reset_stream(const std::string& stream_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    auto it = streams_.find(stream_id);
-    if (it != streams_.end()) {
-        it->second->audio_buffer.clear();
-        it->second->input_finished = false;
+    auto state = find_stream(stream_id);
+    if (state) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        auto& stream = *state;
+        stream.audio_buffer.clear();
+        stream.buffer_start_ms = 0.0;
+        stream.samples_since_decode = 0;
+        stream.input_finished = false;
+        stream.committed_text.clear();
+        stream.committed_end_ms = 0.0;
+        stream.committed_tail.clear();
+        stream.hypothesis.clear();
+        stream.prompt_tokens.clear();
+        if (stream.resampler) {
+            rac_audio_resampler_reset(stream.resampler);
+        }
         LOGI("Reset stream: %s", stream_id.c_str());
     }
 }
@@ -516,16 +1384,75 @@ void WhisperCppSTT::reset_stream(const std::string& stream_id) {
 void WhisperCppSTT::destroy_stream(const std::string& stream_id) {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    auto it = streams_.find(stream_id);
-    if (it != streams_.end()) {
-        if (it->second && it->second->state) {
-            whisper_free_state(it->second->state);
-        }
-        streams_.erase(it);
+    // A decode in progress keeps its reference until it returns
+    if (streams_.erase(stream_id) > 0) {
         LOGI("Destroyed stream: %s", stream_id.c_str());
     }
 }
 
+std::string WhisperCppSTT::detect_language(const float* samples, size_t num_samples,
+                                           int sample_rate, float* out_probability) {
+    std::shared_lock<std::shared_mutex> model_lock(model_mutex_);
+
+    if (!model_loaded_ || !ctx_ || num_samples == 0) {
+        return "";
+    }
+
+    if (!whisper_is_multilingual(ctx_)) {
+        if (out_probability) {
+            *out_probability = 1.0f;
+        }
+        return "en";
+    }
+
+    PooledStateLease lease(state_pool_, ctx_);
+    WhisperPooledState* pooled = lease.get();
+    if (!pooled) {
+        return "";
+    }
+
+    // Only the first encoder window is looked at
+    const size_t max_samples =
+        sample_rate > 0 ? static_cast<size_t>(sample_rate) * 30 : num_samples;
+    const float* audio = samples;
+    size_t audio_size = std::min(num_samples, max_samples);
+    if (sample_rate != WHISPER_SAMPLE_RATE && sample_rate > 0) {
+        if (pooled->resampler) {
+            rac_audio_resampler_reset(pooled->resampler);
+        }
+        pooled->resample_buffer.clear();
+        if (!resample_to_16khz(&pooled->resampler, &pooled->resampler_rate, samples, audio_size,
+                               sample_rate, pooled->resample_buffer)) {
+            LOGE("Failed to resample audio from %d Hz", sample_rate);
+            return "";
+        }
+        audio = pooled->resample_buffer.data();
+        audio_size = pooled->resample_buffer.size();
+    }
+
+    rac::ScopedCpuBudget cpu_budget(RAC_CPU_STAGE_STT, backend_->get_num_threads());
+    const int n_threads = cpu_budget.threads();
+    if (whisper_pcm_to_mel_with_state(ctx_, pooled->state, audio, static_cast<int>(audio_size),
+                                      n_threads) != 0) {
+        LOGE("Failed to compute mel spectrogram");
+        return "";
+    }
+
+    std::vector<float> probs(whisper_lang_max_id() + 1, 0.0f);
+    const int lang_id =
+        whisper_lang_auto_detect_with_state(ctx_, pooled->state, 0, n_threads, probs.data());
+    if (lang_id < 0) {
+        LOGE("Language detection failed: %d", lang_id);
+        return "";
+    }
+
+    if (out_probability) {
+        *out_probability = probs[lang_id];
+    }
+    LOGI("Detected language: %s (p=%.2f)", whisper_lang_str(lang_id), probs[lang_id]);
+    return whisper_lang_str(lang_id);
+}
+
 void WhisperCppSTT::cancel() {
     cancel_requested_.store(true);
     LOGI("Cancellation requested");
@@ -545,30 +1472,32 @@ std::vector<std::string> WhisperCppSTT::get_supported_languages() const {
     return languages;
 }
 
-std::vector<float> WhisperCppSTT::resample_to_16khz(const std::vector<float>& samples,
-                                                    int source_rate) {
-    if (source_rate == WHISPER_SAMPLE_RATE) {
-        return samples;
+bool WhisperCppSTT::resample_to_16khz(rac_audio_resampler_t* resampler, int* resampler_rate,
+                                      const float* samples, size_t num_samples, int source_rate,
+                                      std::vector<float>& out) {
+    if (source_rate == WHISPER_SAMPLE_RATE || source_rate <= 0) {
+        out.insert(out.end(), samples, samples + num_samples);
+        return true;
     }
 
-    const double ratio = static_cast<double>(WHISPER_SAMPLE_RATE) / source_rate;
-    const size_t output_size = static_cast<size_t>(samples.size() * ratio);
-
-    std::vector<float> output(output_size);
-
-    for (size_t i = 0; i < output_size; ++i) {
-        const double src_idx = i / ratio;
-        const size_t idx0 = static_cast<size_t>(src_idx);
-        const size_t idx1 = std::min(idx0 + 1, samples.size() - 1);
-        const double frac = src_idx - idx0;
-
-        output[i] = static_cast<float>(samples[idx0] * (1.0 - frac) + samples[idx1] * frac);
+    if (!*resampler || *resampler_rate != source_rate) {
+        rac_audio_resampler_destroy(*resampler);
+        *resampler = nullptr;
+        if (rac_audio_resampler_create(source_rate, WHISPER_SAMPLE_RATE, resampler) != RAC_SUCCESS) {
+            *resampler_rate = 0;
+            return false;
+        }
+        *resampler_rate = source_rate;
     }
 
-    LOGI("Resampled audio from %d Hz to %d Hz (%zu -> %zu samples)", source_rate,
-         WHISPER_SAMPLE_RATE, samples.size(), output_size);
-
-    return output;
+    const size_t offset = out.size();
+    out.resize(offset + rac_audio_resampler_max_output(*resampler, num_samples));
+    size_t written = 0;
+    const rac_result_t rc = rac_audio_resampler_process(*resampler, samples, num_samples,
+                                                        out.data() + offset, out.size() - offset,
+                                                        &written);
+    out.resize(offset + written);
+    return rc == RAC_SUCCESS;
 }
 
 }  // namespace runanywhere
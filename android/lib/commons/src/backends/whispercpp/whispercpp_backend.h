@@ -11,15 +11,20 @@
 #include <whisper.h>
 
 #include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "rac/core/rac_audio_utils.h"
+
 namespace runanywhere {
 
 // =============================================================================
@@ -33,6 +38,28 @@ enum class DeviceType {
     CUDA = 4,
 };
 
+// Quality/latency trade-off for decoding
+enum class WhisperDecodingPolicy {
+    GREEDY_FAST,      // one greedy pass, no retries
+    GREEDY_FALLBACK,  // greedy; windows failing the entropy/logprob thresholds are
+                      // re-decoded at rising temperatures
+    BEAM,             // beam search, with the same fallback
+};
+
+// Where encoder passes run
+enum class WhisperAccelerator {
+    CPU,
+    METAL,   // ggml Metal backend
+    COREML,  // Core ML encoder (Apple Neural Engine); decoding stays on ggml
+};
+
+// Silence pre-pass of file transcriptions ("silence_trim")
+enum class WhisperSilenceTrim {
+    OFF,     // the whole buffer goes to whisper_full
+    ENERGY,  // frame RMS against the clip's own noise floor
+    VAD,     // whisper.cpp's Silero VAD ("vad_model_path")
+};
+
 enum class STTModelType {
     WHISPER,
     ZIPFORMER,
@@ -78,6 +105,9 @@ struct STTResult {
     double inference_time_ms = 0.0;
     float confidence = 0.0f;
     bool is_final = true;
+    // Streaming decodes: text is the committed transcript (it only grows) and
+    // this is the unconfirmed tail that may still change
+    std::string tentative_text;
 };
 
 // =============================================================================
@@ -118,16 +148,98 @@ class WhisperCppBackend {
     mutable std::mutex mutex_;
 };
 
+// =============================================================================
+// STATE POOL
+// =============================================================================
+
+// Speech kept by the silence pre-pass: samples [start, end) of the original
+// audio, copied to compact_start of the buffer that is transcribed
+struct SpeechSpan {
+    size_t start = 0;
+    size_t end = 0;
+    size_t compact_start = 0;
+};
+
+// A whisper_state plus the scratch a file transcription needs
+struct WhisperPooledState {
+    whisper_state* state = nullptr;
+    std::vector<float> resample_buffer;
+    std::vector<float> trim_buffer;
+    std::vector<SpeechSpan> speech_spans;
+    rac_audio_resampler_t resampler = nullptr;
+    int resampler_rate = 0;
+
+    ~WhisperPooledState();
+};
+
+// Bounded pool of whisper_state objects shared by every request on one
+// context. Each decode checks a state out for its duration, so up to
+// max_size transcriptions run in parallel; states are created on demand and
+// kept for reuse, since each one holds the model's KV and compute buffers.
+class WhisperStatePool {
+   public:
+    WhisperStatePool() = default;
+    ~WhisperStatePool() { clear(); }
+
+    void set_max_size(size_t max_size);
+    size_t max_size() const { return max_size_; }
+
+    // Blocks while every state is checked out; nullptr if a state could not be created
+    WhisperPooledState* acquire(whisper_context* ctx);
+    void release(WhisperPooledState* state);
+    // Frees idle states (none may be checked out)
+    void clear();
+
+   private:
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<std::unique_ptr<WhisperPooledState>> idle_;
+    size_t created_ = 0;
+    size_t max_size_ = 2;
+};
+
 // =============================================================================
 // STREAMING STATE
 // =============================================================================
 
+// A word of a streaming hypothesis, timed in stream milliseconds
+struct StreamWord {
+    std::string text;
+    double start_ms = 0.0;
+    double end_ms = 0.0;
+    std::vector<whisper_token> tokens;
+};
+
+// Streams are decoded LocalAgreement-style: every step re-transcribes the
+// window of uncommitted audio (which overlaps the previous step), and words on
+// which two consecutive hypotheses agree are committed. Committed tokens are
+// carried over as the decoder prompt, and the window is trimmed at the last
+// committed word.
+// Streams own no whisper_state; decodes borrow one from the pool.
 struct WhisperStreamState {
-    whisper_state* state = nullptr;
-    std::vector<float> audio_buffer;
+    std::mutex mutex;  // serializes feeding and decoding of this stream
+    std::vector<float> audio_buffer;  // window starting at buffer_start_ms
+    double buffer_start_ms = 0.0;
+    size_t samples_since_decode = 0;
     std::string language;
+    std::string detected_language;  // locked after the first confident detection
     bool input_finished = false;
     int sample_rate = 16000;
+    rac_audio_resampler_t resampler = nullptr;  // to 16 kHz, created for the feed rate
+    int resampler_rate = 0;
+    int step_ms = 1000;           // new audio between decodes ("step_ms")
+    int max_window_ms = 15000;    // window length that triggers a trim ("max_window_ms")
+    // Interim decodes use at most GREEDY_FALLBACK; the policy applies in full
+    // to the final one ("decoding")
+    WhisperDecodingPolicy decoding = WhisperDecodingPolicy::GREEDY_FALLBACK;
+
+    std::string committed_text;
+    double committed_end_ms = 0.0;
+    std::vector<StreamWord> committed_tail;  // last few committed words, for overlap removal
+    std::vector<StreamWord> hypothesis;      // tentative words of the last decode
+    std::vector<whisper_token> prompt_tokens;
+
+    ~WhisperStreamState() { rac_audio_resampler_destroy(resampler); }
 };
 
 // =============================================================================
@@ -150,7 +262,14 @@ class WhisperCppSTT {
 
     bool supports_streaming() const;
     std::string create_stream(const nlohmann::json& config = {});
-    bool feed_audio(const std::string& stream_id, const std::vector<float>& samples, int sample_rate);
+    // Span overloads write straight into the stream's window (resampling on the
+    // way) and transcribe from the caller's buffer, without intermediate copies
+    STTResult transcribe(const float* samples, size_t num_samples, const STTRequest& request);
+    bool feed_audio(const std::string& stream_id, const std::vector<float>& samples, int sample_rate) {
+        return feed_audio(stream_id, samples.data(), samples.size(), sample_rate);
+    }
+    bool feed_audio(const std::string& stream_id, const float* samples, size_t num_samples,
+                    int sample_rate);
     bool is_stream_ready(const std::string& stream_id);
     STTResult decode(const std::string& stream_id);
     bool is_endpoint(const std::string& stream_id);
@@ -158,14 +277,53 @@ class WhisperCppSTT {
     void reset_stream(const std::string& stream_id);
     void destroy_stream(const std::string& stream_id);
 
+    // Detects the spoken language of the first 30 s, running the encoder once
+    // and no decoder pass; returns an empty string on failure
+    std::string detect_language(const float* samples, size_t num_samples, int sample_rate,
+                                float* out_probability = nullptr);
+
     void cancel();
     std::vector<std::string> get_supported_languages() const;
 
+    // Called on the warm-up thread with the warm-up duration in ms
+    void set_warmup_callback(std::function<void(double)> callback) {
+        warmup_callback_ = std::move(callback);
+    }
+    bool is_warmed_up() const { return warmed_up_.load(); }
+
+    // Encoder accelerator of the loaded model: "coreml", "metal" or "cpu"
+    const char* accelerator_name() const;
+
+    // Times a decode of one 30 s window on a warm state and returns processing
+    // time over audio time (the device's real-time factor for this model), or
+    // a negative value on failure
+    double measure_rtf();
+
    private:
-    STTResult transcribe_internal(const std::vector<float>& audio, const std::string& language,
-                                  bool detect_language, bool translate, bool word_timestamps);
-    std::vector<float> resample_to_16khz(const std::vector<float>& samples, int source_rate);
+    STTResult transcribe_internal(const float* audio, size_t num_samples, const std::string& language,
+                                  bool detect_language, bool translate, bool word_timestamps,
+                                  whisper_state* state);
+    // Appends the 16 kHz version of samples to out through *resampler, which is
+    // (re)created whenever the source rate changes and carries filter history
+    // between calls
+    static bool resample_to_16khz(rac_audio_resampler_t* resampler, int* resampler_rate,
+                                  const float* samples, size_t num_samples, int source_rate,
+                                  std::vector<float>& out);
+    whisper_full_params make_params(WhisperDecodingPolicy policy) const;
+    // Fills spans with the speech of 16 kHz audio: leading and trailing
+    // silence dropped, pauses longer than silence_max_pause_ms_ shortened to
+    // the padding. False when no speech was found.
+    bool find_speech(const float* audio, size_t num_samples, std::vector<SpeechSpan>& spans);
+    bool find_speech_vad(const float* audio, size_t num_samples, std::vector<SpeechSpan>& spans);
+    void run_warmup();
+    void stop_warmup();
+    int decode_silence(whisper_state* state, std::atomic<bool>* abort_flag);
     std::string generate_stream_id();
+    std::shared_ptr<WhisperStreamState> find_stream(const std::string& stream_id);
+    std::vector<StreamWord> collect_stream_words(WhisperStreamState& stream, whisper_state* state);
+    void commit_words(WhisperStreamState& stream, std::vector<StreamWord>& words, size_t count,
+                      STTResult& result);
+    void trim_stream_window(WhisperStreamState& stream, double until_ms);
 
     WhisperCppBackend* backend_;
     whisper_context* ctx_ = nullptr;
@@ -173,12 +331,35 @@ class WhisperCppSTT {
     bool model_loaded_ = false;
     std::atomic<bool> cancel_requested_{false};
 
+    // Background warm-up after load ("warmup" config): one decode of silence,
+    // so the first real request does not pay for state and compute-buffer
+    // allocation and cold kernels
+    std::thread warmup_thread_;
+    std::atomic<bool> warmup_stop_{false};
+    std::atomic<bool> warmed_up_{false};
+    std::function<void(double)> warmup_callback_;
+
     std::string model_path_;
     nlohmann::json model_config_;
-
-    std::unordered_map<std::string, std::unique_ptr<WhisperStreamState>> streams_;
+    WhisperDecodingPolicy decoding_ = WhisperDecodingPolicy::GREEDY_FALLBACK;
+    bool dtw_enabled_ = false;  // "dtw_timestamps": word starts from DTW alignment
+    WhisperAccelerator accelerator_ = WhisperAccelerator::CPU;
+    int beam_size_ = 5;
+
+    WhisperSilenceTrim silence_trim_ = WhisperSilenceTrim::OFF;
+    int silence_pad_ms_ = 200;         // "silence_pad_ms": audio kept around speech
+    int silence_max_pause_ms_ = 600;   // "silence_max_pause_ms": longer pauses are shortened
+    whisper_vad_context* vad_ctx_ = nullptr;
+    std::mutex vad_mutex_;  // the VAD context carries LSTM state through a call
+
+    std::unordered_map<std::string, std::shared_ptr<WhisperStreamState>> streams_;
     int stream_counter_ = 0;
 
+    WhisperStatePool state_pool_;
+
+    // Shared by transcriptions, exclusive for load/unload
+    mutable std::shared_mutex model_mutex_;
+    // Guards streams_ and stream_counter_ only
     mutable std::mutex mutex_;
 };
 
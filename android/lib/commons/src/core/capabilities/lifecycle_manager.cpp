@@ -7,17 +7,33 @@
  *
  * IMPLEMENTATION NOTE: This is a direct 1:1 port of the Swift code.
  * Do not add, remove, or modify any behavior that isn't in the Swift source.
+ * The exceptions are the load mode and the process-wide residency of
+ * parked services, which have no Swift counterpart.
  */
 
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <iterator>
+#include <list>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "rac/core/capabilities/rac_lifecycle.h"
+#include "rac/core/rac_core.h"
 #include "rac/core/rac_logger.h"
 #include "rac/core/rac_platform_adapter.h"
+#include "rac/infrastructure/device/rac_device_manager.h"
 #include "rac/infrastructure/events/rac_events.h"
 
 // =============================================================================
@@ -26,6 +42,8 @@
 
 namespace {
 
+struct LoadOp;
+
 /**
  * Internal lifecycle manager state.
  * Mirrors Swift's ManagedLifecycle properties.
@@ -35,6 +53,8 @@ struct LifecycleManager {
     rac_resource_type_t resource_type{RAC_RESOURCE_TYPE_LLM_MODEL};
     std::string logger_category{};
     void* user_data{nullptr};
+    // Read from create_fn while mutex is held by load, hence atomic
+    std::atomic<rac_model_load_mode_t> load_mode{RAC_MODEL_LOAD_MODE_DEFAULT};
 
     // Callbacks
     rac_lifecycle_create_service_fn create_fn{nullptr};
@@ -46,7 +66,8 @@ struct LifecycleManager {
     std::string
         current_model_id{};  // Model identifier for telemetry (e.g., "sherpa-onnx-whisper-tiny.en")
     std::string current_model_name{};  // Human-readable name (e.g., "Sherpa Whisper Tiny (ONNX)")
-    rac_handle_t current_service{nullptr};
+    // Read without the mutex by rac_lifecycle_get_service, hence atomic
+    std::atomic<rac_handle_t> current_service{nullptr};
 
     // Metrics (mirrors Swift's ManagedLifecycle metrics)
     int32_t load_count{0};
@@ -56,8 +77,14 @@ struct LifecycleManager {
     int64_t start_time_ms{0};
     int64_t last_event_time_ms{0};
 
-    // Thread safety
+    // Thread safety: mutex serializes load, unload and reset for their whole
+    // duration; info_mutex guards the model strings and metrics for the short
+    // writes, so getters do not wait for a load to finish
     std::mutex mutex{};
+    std::mutex info_mutex{};
+
+    // In-flight rac_lifecycle_load_async operations (guarded by info_mutex)
+    std::vector<std::shared_ptr<LoadOp>> async_loads{};
 
     LifecycleManager() {
         // Set start time (mirrors Swift's startTime = Date())
@@ -67,6 +94,196 @@ struct LifecycleManager {
     }
 };
 
+// =============================================================================
+// RESIDENCY - Parked services shared by all lifecycles
+// =============================================================================
+
+/**
+ * A service a lifecycle replaced but kept loaded. It is destroyed with its
+ * owner's callback, so owners drop their entries before they are deleted.
+ */
+struct ParkedService {
+    LifecycleManager* owner;
+    std::string model_path;
+    std::string model_id;
+    std::string model_name;
+    rac_handle_t service;
+    int64_t bytes;
+};
+
+/**
+ * Process-wide residency state. Locked after a lifecycle's own mutex, never
+ * before it, and destroy callbacks run under it so an owner cannot be
+ * deleted while one of its services is being evicted.
+ */
+struct Residency {
+    std::mutex mutex;
+    rac_model_residency_config_t config = RAC_MODEL_RESIDENCY_CONFIG_DEFAULT;
+    std::list<ParkedService> parked;  // most recently used first
+    std::unordered_map<LifecycleManager*, int64_t> loaded_bytes;
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t evictions = 0;
+};
+
+Residency& residency() {
+    static Residency instance;
+    return instance;
+}
+
+// Model files are memory-mapped or read whole, so their size on disk is what
+// a loaded service keeps resident, give or take its working buffers
+int64_t model_bytes(const std::string& path) {
+    int64_t total = 0;
+    std::vector<std::pair<std::string, int>> pending = {{path, 0}};
+    while (!pending.empty()) {
+        auto [current, depth] = pending.back();
+        pending.pop_back();
+        struct stat st = {};
+        if (stat(current.c_str(), &st) != 0) {
+            continue;
+        }
+        if (S_ISREG(st.st_mode)) {
+            total += static_cast<int64_t>(st.st_size);
+            continue;
+        }
+        DIR* dir = S_ISDIR(st.st_mode) && depth < 4 ? opendir(current.c_str()) : nullptr;
+        if (!dir) {
+            continue;
+        }
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                pending.emplace_back(current + "/" + entry->d_name, depth + 1);
+            }
+        }
+        closedir(dir);
+    }
+    return total;
+}
+
+// Caller holds res.mutex
+int64_t residency_budget(const Residency& res) {
+    if (res.config.budget_bytes > 0) {
+        return res.config.budget_bytes;
+    }
+    int64_t total_memory = 0;
+    int64_t available_memory = 0;
+    if (rac_device_manager_get_memory(&total_memory, &available_memory) != RAC_SUCCESS) {
+        return 0;
+    }
+    return static_cast<int64_t>(static_cast<double>(total_memory) *
+                                res.config.max_memory_fraction);
+}
+
+// Caller holds res.mutex
+int64_t resident_bytes(const Residency& res) {
+    int64_t total = 0;
+    for (const auto& [owner, bytes] : res.loaded_bytes) {
+        total += bytes;
+    }
+    for (const auto& entry : res.parked) {
+        total += entry.bytes;
+    }
+    return total;
+}
+
+// Caller holds res.mutex
+void destroy_parked(Residency& res, std::list<ParkedService>::iterator it) {
+    LifecycleManager* owner = it->owner;
+    RAC_LOG_INFO(owner->logger_category.c_str(), "Destroying parked model: %s",
+                 it->model_id.c_str());
+    if (owner->destroy_fn != nullptr) {
+        owner->destroy_fn(it->service, owner->user_data);
+    }
+    res.parked.erase(it);
+}
+
+// Destroys least recently used parked services until incoming more bytes fit.
+// Caller holds res.mutex
+void evict_to_fit(Residency& res, int64_t incoming) {
+    const int64_t budget = residency_budget(res);
+    const auto max_parked = static_cast<size_t>(std::max(0, res.config.max_parked_services));
+    int64_t resident = resident_bytes(res);
+    while (!res.parked.empty() &&
+           (budget <= 0 || res.parked.size() > max_parked || resident + incoming > budget)) {
+        resident -= res.parked.back().bytes;
+        destroy_parked(res, std::prev(res.parked.end()));
+        res.evictions++;
+    }
+}
+
+// Parks a lifecycle's current service, or destroys it when parking is off.
+// Caller holds owner->mutex
+void park_current(LifecycleManager* owner) {
+    auto& res = residency();
+    std::lock_guard<std::mutex> lock(res.mutex);
+    const int64_t bytes = res.loaded_bytes[owner];
+    res.loaded_bytes.erase(owner);
+    res.parked.push_front(ParkedService{owner, owner->current_model_path, owner->current_model_id,
+                                        owner->current_model_name, owner->current_service,
+                                        bytes});
+    evict_to_fit(res, 0);
+}
+
+// Takes a parked service of owner for model_path out of the cache, or null.
+// Caller holds owner->mutex
+bool take_parked(LifecycleManager* owner, const char* model_path, ParkedService* out) {
+    auto& res = residency();
+    std::lock_guard<std::mutex> lock(res.mutex);
+    for (auto it = res.parked.begin(); it != res.parked.end(); ++it) {
+        if (it->owner == owner && it->model_path == model_path) {
+            *out = std::move(*it);
+            res.parked.erase(it);
+            res.loaded_bytes[owner] = out->bytes;
+            res.hits++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Counts a load that creates a service and makes room for it.
+// Caller holds owner->mutex
+void reserve_for(int64_t bytes) {
+    auto& res = residency();
+    std::lock_guard<std::mutex> lock(res.mutex);
+    res.misses++;
+    evict_to_fit(res, bytes);
+}
+
+// Caller holds owner->mutex
+void set_loaded(LifecycleManager* owner, int64_t bytes) {
+    auto& res = residency();
+    std::lock_guard<std::mutex> lock(res.mutex);
+    res.loaded_bytes[owner] = bytes;
+}
+
+// Caller holds owner->mutex
+void clear_loaded(LifecycleManager* owner) {
+    auto& res = residency();
+    std::lock_guard<std::mutex> lock(res.mutex);
+    res.loaded_bytes.erase(owner);
+}
+
+// Parked services are the cheapest memory to give back
+int64_t residency_pressure_handler(rac_memory_pressure_stage_t stage, void* /*user_data*/) {
+    return stage == RAC_MEMORY_PRESSURE_STAGE_DROP_CACHES ? rac_model_residency_trim() : 0;
+}
+
+// Caller holds owner->mutex
+void drop_parked(LifecycleManager* owner) {
+    auto& res = residency();
+    std::lock_guard<std::mutex> lock(res.mutex);
+    for (auto it = res.parked.begin(); it != res.parked.end();) {
+        auto next = std::next(it);
+        if (it->owner == owner) {
+            destroy_parked(res, it);
+        }
+        it = next;
+    }
+    res.loaded_bytes.erase(owner);
+}
+
 int64_t current_time_ms() {
     auto now = std::chrono::system_clock::now();
     auto duration = now.time_since_epoch();
@@ -99,58 +316,94 @@ void track_lifecycle_event(LifecycleManager* mgr, const char* event_type, const
             break;
     }
 
-    // Build properties JSON (simplified version)
-    char properties[512];
-    if (error_code != RAC_SUCCESS) {
-        snprintf(properties, sizeof(properties),
-                 R"({"modelId":"%s","durationMs":%.1f,"errorCode":%d})", model_id ? model_id : "",
-                 duration_ms, error_code);
-    } else if (duration_ms > 0) {
-        snprintf(properties, sizeof(properties), R"({"modelId":"%s","durationMs":%.1f})",
-                 model_id ? model_id : "", duration_ms);
-    } else {
-        snprintf(properties, sizeof(properties), R"({"modelId":"%s"})", model_id ? model_id : "");
-    }
+    if (rac_event_has_subscribers(category)) {
+        // Build properties JSON (simplified version)
+        char properties[512];
+        if (error_code != RAC_SUCCESS) {
+            snprintf(properties, sizeof(properties),
+                     R"({"modelId":"%s","durationMs":%.1f,"errorCode":%d})",
+                     model_id ? model_id : "", duration_ms, error_code);
+        } else if (duration_ms > 0) {
+            snprintf(properties, sizeof(properties), R"({"modelId":"%s","durationMs":%.1f})",
+                     model_id ? model_id : "", duration_ms);
+        } else {
+            snprintf(properties, sizeof(properties), R"({"modelId":"%s"})",
+                     model_id ? model_id : "");
+        }
 
-    // Track event (mirrors Swift's EventPublisher.shared.track(event))
-    rac_event_track(event_type, category, RAC_EVENT_DESTINATION_ALL, properties);
+        // Track event (mirrors Swift's EventPublisher.shared.track(event))
+        rac_event_track(event_type, category, RAC_EVENT_DESTINATION_ALL, properties);
+    }
 
+    std::lock_guard<std::mutex> lock(mgr->info_mutex);
     mgr->last_event_time_ms = current_time_ms();
 }
 
-}  // namespace
-
 // =============================================================================
-// PUBLIC API IMPLEMENTATION
+// ASYNC LOADS - Progress and cancellation for create callbacks
 // =============================================================================
 
-extern "C" {
+/**
+ * State of one rac_lifecycle_load_async, shared by the loader thread and the
+ * caller's handle.
+ */
+struct LoadOp {
+    std::string model_path;
+    std::string model_id;
+    std::string model_name;
+    rac_lifecycle_load_progress_fn progress_fn{nullptr};
+    rac_lifecycle_load_complete_fn complete_fn{nullptr};
+    void* user_data{nullptr};
 
-rac_result_t rac_lifecycle_create(const rac_lifecycle_config_t* config,
-                                  rac_lifecycle_create_service_fn create_fn,
-                                  rac_lifecycle_destroy_service_fn destroy_fn,
-                                  rac_handle_t* out_handle) {
-    if (config == nullptr || create_fn == nullptr || out_handle == nullptr) {
-        return RAC_ERROR_NULL_POINTER;
-    }
+    std::atomic<bool> cancelled{false};
+    std::atomic<float> progress{0.0f};
 
-    auto* mgr = new LifecycleManager();
-    mgr->resource_type = config->resource_type;
-    mgr->logger_category = config->logger_category ? config->logger_category : "Lifecycle";
-    mgr->user_data = config->user_data;
-    mgr->create_fn = create_fn;
-    mgr->destroy_fn = destroy_fn;
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    bool done{false};      // result is set (rac_lifecycle_load_wait)
+    bool finished{false};  // complete_fn returned (rac_lifecycle_destroy)
+    rac_result_t result{RAC_SUCCESS};
+    rac_handle_t service{nullptr};
+};
 
-    *out_handle = static_cast<rac_handle_t>(mgr);
-    return RAC_SUCCESS;
+// Load whose create callback runs on this thread; read by
+// rac_lifecycle_report_load_progress
+thread_local LoadOp* t_current_load = nullptr;
+
+struct CurrentLoadScope {
+    explicit CurrentLoadScope(LoadOp* op) : previous(t_current_load) { t_current_load = op; }
+    ~CurrentLoadScope() { t_current_load = previous; }
+    LoadOp* previous;
+};
+
+}  // namespace
+
+struct rac_lifecycle_load_op {
+    std::shared_ptr<LoadOp> op;
+};
+
+namespace {
+
+void set_model_info(LifecycleManager* mgr, const char* path, const char* id, const char* name) {
+    std::lock_guard<std::mutex> lock(mgr->info_mutex);
+    mgr->current_model_path = path;
+    mgr->current_model_id = id;
+    mgr->current_model_name = name;
 }
 
-rac_result_t rac_lifecycle_load(rac_handle_t handle, const char* model_path, const char* model_id,
-                                const char* model_name, rac_handle_t* out_service) {
-    if (handle == nullptr || model_path == nullptr || out_service == nullptr) {
-        return RAC_ERROR_NULL_POINTER;
-    }
+rac_result_t load_model(LifecycleManager* mgr, const char* model_path, const char* model_id,
+                        const char* model_name, LoadOp* op, rac_handle_t* out_service);
+
+}  // namespace
 
+// =============================================================================
+// LOAD IMPLEMENTATION
+// =============================================================================
+
+namespace {
+
+rac_result_t load_model(LifecycleManager* mgr, const char* model_path, const char* model_id,
+                        const char* model_name, LoadOp* op, rac_handle_t* out_service) {
     // If model_id is null, use model_path as model_id
     if (model_id == nullptr) {
         model_id = model_path;
@@ -160,9 +413,13 @@ rac_result_t rac_lifecycle_load(rac_handle_t handle, const char* model_path, con
         model_name = model_id;
     }
 
-    auto* mgr = static_cast<LifecycleManager*>(handle);
     std::lock_guard<std::mutex> lock(mgr->mutex);
 
+    // Cancelled while waiting for an earlier load
+    if (op != nullptr && op->cancelled.load()) {
+        return RAC_ERROR_CANCELLED;
+    }
+
     // Check if already loaded with same path - skip duplicate events
     // Mirrors Swift: if await lifecycle.currentResourceId == modelId
     if (mgr->state.load() == RAC_LIFECYCLE_STATE_LOADED && mgr->current_model_path == model_path &&
@@ -173,25 +430,57 @@ rac_result_t rac_lifecycle_load(rac_handle_t handle, const char* model_path, con
         return RAC_SUCCESS;
     }
 
+    // Keep the model being replaced loaded, within the residency budget
+    if (mgr->current_service != nullptr) {
+        park_current(mgr);
+        set_model_info(mgr, "", "", "");
+        mgr->current_service = nullptr;
+    }
+
     // Track load started (mirrors Swift: trackEvent(type: .loadStarted))
     int64_t start_time = current_time_ms();
     mgr->state.store(RAC_LIFECYCLE_STATE_LOADING);
     track_lifecycle_event(mgr, "load.started", model_id, 0.0, RAC_SUCCESS);
 
-    RAC_LOG_INFO(mgr->logger_category.c_str(), "Loading model: %s (path: %s)", model_id,
-                 model_path);
-
-    // Create service via callback - pass the PATH for loading
     rac_handle_t service = nullptr;
-    rac_result_t result = mgr->create_fn(model_path, mgr->user_data, &service);
+    rac_result_t result = RAC_SUCCESS;
+    ParkedService parked{};
+    if (take_parked(mgr, model_path, &parked)) {
+        RAC_LOG_INFO(mgr->logger_category.c_str(), "Switching to parked model: %s (path: %s)",
+                     model_id, model_path);
+        service = parked.service;
+    } else {
+        RAC_LOG_INFO(mgr->logger_category.c_str(), "Loading model: %s (path: %s)", model_id,
+                     model_path);
+
+        const int64_t bytes = model_bytes(model_path);
+        reserve_for(bytes);
+
+        // Create service via callback - pass the PATH for loading
+        {
+            CurrentLoadScope scope(op);
+            result = mgr->create_fn(model_path, mgr->user_data, &service);
+        }
+
+        // A backend stopped by cancellation fails with its own error, and one
+        // that ignores cancellation still loses its service
+        if (op != nullptr && op->cancelled.load()) {
+            if (service != nullptr && mgr->destroy_fn != nullptr) {
+                mgr->destroy_fn(service, mgr->user_data);
+            }
+            service = nullptr;
+            result = RAC_ERROR_CANCELLED;
+        }
+        if (result == RAC_SUCCESS && service != nullptr) {
+            set_loaded(mgr, bytes);
+        }
+    }
 
     auto load_time_ms = static_cast<double>(current_time_ms() - start_time);
 
     if (result == RAC_SUCCESS && service != nullptr) {
-        // Success - store path, model_id, and model_name separately
-        mgr->current_model_path = model_path;
-        mgr->current_model_id = model_id;      // Model identifier for telemetry
-        mgr->current_model_name = model_name;  // Human-readable name for telemetry
+        // Success - store path, model_id (for telemetry), and model_name separately
+        set_model_info(mgr, model_path, model_id, model_name);
         mgr->current_service = service;
         mgr->state.store(RAC_LIFECYCLE_STATE_LOADED);
 
@@ -199,8 +488,11 @@ rac_result_t rac_lifecycle_load(rac_handle_t handle, const char* model_path, con
         track_lifecycle_event(mgr, "load.completed", model_id, load_time_ms, RAC_SUCCESS);
 
         // Update metrics (mirrors Swift: loadCount += 1, totalLoadTime += loadTime)
-        mgr->load_count++;
-        mgr->total_load_time_ms += load_time_ms;
+        {
+            std::lock_guard<std::mutex> info_lock(mgr->info_mutex);
+            mgr->load_count++;
+            mgr->total_load_time_ms += load_time_ms;
+        }
 
         RAC_LOG_INFO(mgr->logger_category.c_str(), "Loaded model in %dms",
                      static_cast<int>(load_time_ms));
@@ -210,17 +502,175 @@ rac_result_t rac_lifecycle_load(rac_handle_t handle, const char* model_path, con
     }
 
     // Failure - mirrors Swift catch block
-    mgr->state.store(RAC_LIFECYCLE_STATE_FAILED);
-    mgr->failed_loads++;
+    mgr->state.store(result == RAC_ERROR_CANCELLED ? RAC_LIFECYCLE_STATE_IDLE
+                                                   : RAC_LIFECYCLE_STATE_FAILED);
+    if (result != RAC_ERROR_CANCELLED) {
+        std::lock_guard<std::mutex> info_lock(mgr->info_mutex);
+        mgr->failed_loads++;
+    }
 
     // Track load failed (mirrors Swift: trackEvent(type: .loadFailed))
     track_lifecycle_event(mgr, "load.failed", model_id, load_time_ms, result);
 
-    RAC_LOG_ERROR(mgr->logger_category.c_str(), "Failed to load model");
+    if (result == RAC_ERROR_CANCELLED) {
+        RAC_LOG_INFO(mgr->logger_category.c_str(), "Model load cancelled: %s", model_id);
+    } else {
+        RAC_LOG_ERROR(mgr->logger_category.c_str(), "Failed to load model");
+    }
 
     return result;
 }
 
+}  // namespace
+
+// =============================================================================
+// PUBLIC API IMPLEMENTATION
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_lifecycle_create(const rac_lifecycle_config_t* config,
+                                  rac_lifecycle_create_service_fn create_fn,
+                                  rac_lifecycle_destroy_service_fn destroy_fn,
+                                  rac_handle_t* out_handle) {
+    if (config == nullptr || create_fn == nullptr || out_handle == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* mgr = new LifecycleManager();
+    mgr->resource_type = config->resource_type;
+    mgr->logger_category = config->logger_category ? config->logger_category : "Lifecycle";
+    mgr->user_data = config->user_data;
+    mgr->load_mode = config->load_mode;
+    mgr->create_fn = create_fn;
+    mgr->destroy_fn = destroy_fn;
+
+    static std::once_flag pressure_once;
+    std::call_once(pressure_once, [] {
+        rac_memory_pressure_register("ModelResidency", residency_pressure_handler, nullptr);
+    });
+
+    *out_handle = static_cast<rac_handle_t>(mgr);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_lifecycle_load(rac_handle_t handle, const char* model_path, const char* model_id,
+                                const char* model_name, rac_handle_t* out_service) {
+    if (handle == nullptr || model_path == nullptr || out_service == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    return load_model(static_cast<LifecycleManager*>(handle), model_path, model_id, model_name,
+                      nullptr, out_service);
+}
+
+rac_result_t rac_lifecycle_load_async(rac_handle_t handle, const char* model_path,
+                                      const char* model_id, const char* model_name,
+                                      rac_lifecycle_load_progress_fn progress_fn,
+                                      rac_lifecycle_load_complete_fn complete_fn, void* user_data,
+                                      rac_lifecycle_load_handle_t* out_load) {
+    if (handle == nullptr || model_path == nullptr || out_load == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* mgr = static_cast<LifecycleManager*>(handle);
+    auto op = std::make_shared<LoadOp>();
+    op->model_path = model_path;
+    op->model_id = model_id ? model_id : model_path;
+    op->model_name = model_name ? model_name : op->model_id;
+    op->progress_fn = progress_fn;
+    op->complete_fn = complete_fn;
+    op->user_data = user_data;
+
+    {
+        std::lock_guard<std::mutex> lock(mgr->info_mutex);
+        mgr->async_loads.push_back(op);
+    }
+
+    std::thread([mgr, op]() {
+        rac_handle_t service = nullptr;
+        const rac_result_t result =
+            load_model(mgr, op->model_path.c_str(), op->model_id.c_str(),
+                       op->model_name.c_str(), op.get(), &service);
+
+        op->progress = 1.0f;
+        {
+            std::lock_guard<std::mutex> lock(op->mutex);
+            op->result = result;
+            op->service = service;
+            op->done = true;
+        }
+        op->done_cv.notify_all();
+
+        if (op->complete_fn != nullptr) {
+            op->complete_fn(result, service, op->user_data);
+        }
+
+        // Last use of mgr: rac_lifecycle_destroy waits for this
+        {
+            std::lock_guard<std::mutex> lock(mgr->info_mutex);
+            auto& loads = mgr->async_loads;
+            loads.erase(std::remove(loads.begin(), loads.end(), op), loads.end());
+        }
+        {
+            std::lock_guard<std::mutex> lock(op->mutex);
+            op->finished = true;
+        }
+        op->done_cv.notify_all();
+    }).detach();
+
+    *out_load = new rac_lifecycle_load_op{op};
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_lifecycle_load_cancel(rac_lifecycle_load_handle_t load) {
+    if (load == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    load->op->cancelled = true;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_lifecycle_load_wait(rac_lifecycle_load_handle_t load, rac_handle_t* out_service) {
+    if (load == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    LoadOp& op = *load->op;
+    std::unique_lock<std::mutex> lock(op.mutex);
+    op.done_cv.wait(lock, [&op] { return op.done; });
+    if (out_service != nullptr) {
+        *out_service = op.service;
+    }
+    return op.result;
+}
+
+float rac_lifecycle_load_get_progress(rac_lifecycle_load_handle_t load) {
+    if (load == nullptr) {
+        return 0.0f;
+    }
+
+    return load->op->progress.load();
+}
+
+void rac_lifecycle_load_release(rac_lifecycle_load_handle_t load) {
+    delete load;
+}
+
+rac_bool_t rac_lifecycle_report_load_progress(float progress) {
+    LoadOp* op = t_current_load;
+    if (op == nullptr) {
+        return RAC_TRUE;
+    }
+
+    op->progress = std::clamp(progress, 0.0f, 1.0f);
+    if (op->progress_fn != nullptr) {
+        op->progress_fn(op->progress.load(), op->user_data);
+    }
+    return op->cancelled.load() ? RAC_FALSE : RAC_TRUE;
+}
+
 rac_result_t rac_lifecycle_unload(rac_handle_t handle) {
     if (handle == nullptr) {
         return RAC_ERROR_NULL_POINTER;
@@ -242,13 +692,14 @@ rac_result_t rac_lifecycle_unload(rac_handle_t handle) {
         // Track unload event (mirrors Swift: trackEvent(type: .unloaded))
         track_lifecycle_event(mgr, "unloaded", mgr->current_model_id.c_str(), 0.0, RAC_SUCCESS);
 
+        std::lock_guard<std::mutex> info_lock(mgr->info_mutex);
         mgr->total_unloads++;
     }
 
+    clear_loaded(mgr);
+
     // Reset state
-    mgr->current_model_path.clear();
-    mgr->current_model_id.clear();
-    mgr->current_model_name.clear();
+    set_model_info(mgr, "", "", "");
     mgr->current_service = nullptr;
     mgr->state.store(RAC_LIFECYCLE_STATE_IDLE);
 
@@ -273,10 +724,10 @@ rac_result_t rac_lifecycle_reset(rac_handle_t handle) {
         }
     }
 
+    drop_parked(mgr);
+
     // Reset all state
-    mgr->current_model_path.clear();
-    mgr->current_model_id.clear();
-    mgr->current_model_name.clear();
+    set_model_info(mgr, "", "", "");
     mgr->current_service = nullptr;
     mgr->state.store(RAC_LIFECYCLE_STATE_IDLE);
 
@@ -307,7 +758,7 @@ const char* rac_lifecycle_get_model_id(rac_handle_t handle) {
     }
 
     auto* mgr = static_cast<LifecycleManager*>(handle);
-    std::lock_guard<std::mutex> lock(mgr->mutex);
+    std::lock_guard<std::mutex> lock(mgr->info_mutex);
 
     if (mgr->current_model_id.empty()) {
         return nullptr;
@@ -321,7 +772,7 @@ const char* rac_lifecycle_get_model_name(rac_handle_t handle) {
     }
 
     auto* mgr = static_cast<LifecycleManager*>(handle);
-    std::lock_guard<std::mutex> lock(mgr->mutex);
+    std::lock_guard<std::mutex> lock(mgr->info_mutex);
 
     if (mgr->current_model_name.empty()) {
         return nullptr;
@@ -329,6 +780,25 @@ const char* rac_lifecycle_get_model_name(rac_handle_t handle) {
     return mgr->current_model_name.c_str();
 }
 
+rac_model_load_mode_t rac_lifecycle_get_load_mode(rac_handle_t handle) {
+    if (handle == nullptr) {
+        return RAC_MODEL_LOAD_MODE_DEFAULT;
+    }
+
+    auto* mgr = static_cast<LifecycleManager*>(handle);
+    return mgr->load_mode.load();
+}
+
+rac_result_t rac_lifecycle_set_load_mode(rac_handle_t handle, rac_model_load_mode_t mode) {
+    if (handle == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* mgr = static_cast<LifecycleManager*>(handle);
+    mgr->load_mode = mode;
+    return RAC_SUCCESS;
+}
+
 rac_handle_t rac_lifecycle_get_service(rac_handle_t handle) {
     if (handle == nullptr) {
         return nullptr;
@@ -362,6 +832,9 @@ void rac_lifecycle_track_error(rac_handle_t handle, rac_result_t error_code,
 
     // Note: handle parameter reserved for future use (e.g., category from mgr->resource_type)
     (void)handle;
+    if (!rac_event_has_subscribers(RAC_EVENT_CATEGORY_ERROR)) {
+        return;
+    }
 
     // Build error event properties
     char properties[256];
@@ -380,7 +853,7 @@ rac_result_t rac_lifecycle_get_metrics(rac_handle_t handle, rac_lifecycle_metric
     }
 
     auto* mgr = static_cast<LifecycleManager*>(handle);
-    std::lock_guard<std::mutex> lock(mgr->mutex);
+    std::lock_guard<std::mutex> lock(mgr->info_mutex);
 
     // Mirrors Swift's getLifecycleMetrics()
     out_metrics->total_events = mgr->load_count + mgr->total_unloads + mgr->failed_loads;
@@ -403,12 +876,83 @@ void rac_lifecycle_destroy(rac_handle_t handle) {
 
     auto* mgr = static_cast<LifecycleManager*>(handle);
 
-    // Unload before destroy
+    // Cancel async loads and wait until their threads stop using mgr
+    std::vector<std::shared_ptr<LoadOp>> loads;
+    {
+        std::lock_guard<std::mutex> lock(mgr->info_mutex);
+        loads = mgr->async_loads;
+    }
+    for (const auto& op : loads) {
+        op->cancelled = true;
+    }
+    for (const auto& op : loads) {
+        std::unique_lock<std::mutex> lock(op->mutex);
+        op->done_cv.wait(lock, [&op] { return op->finished; });
+    }
+
+    // Unload before destroy, and destroy parked services while the callbacks
+    // and user data are still valid
     rac_lifecycle_unload(handle);
+    {
+        std::lock_guard<std::mutex> lock(mgr->mutex);
+        drop_parked(mgr);
+    }
 
     delete mgr;
 }
 
+// =============================================================================
+// RESIDENCY API
+// =============================================================================
+
+rac_result_t rac_model_residency_configure(const rac_model_residency_config_t* config) {
+    auto& res = residency();
+    std::lock_guard<std::mutex> lock(res.mutex);
+    res.config = config ? *config : RAC_MODEL_RESIDENCY_CONFIG_DEFAULT;
+    evict_to_fit(res, 0);
+    return RAC_SUCCESS;
+}
+
+int64_t rac_model_residency_trim(void) {
+    auto& res = residency();
+    std::lock_guard<std::mutex> lock(res.mutex);
+    int64_t released = 0;
+    while (!res.parked.empty()) {
+        released += res.parked.back().bytes;
+        destroy_parked(res, std::prev(res.parked.end()));
+        res.evictions++;
+    }
+    return released;
+}
+
+int64_t rac_lifecycle_get_resident_bytes(rac_handle_t handle) {
+    if (handle == nullptr) {
+        return 0;
+    }
+
+    auto& res = residency();
+    std::lock_guard<std::mutex> lock(res.mutex);
+    auto it = res.loaded_bytes.find(static_cast<LifecycleManager*>(handle));
+    return it == res.loaded_bytes.end() ? 0 : it->second;
+}
+
+rac_result_t rac_model_residency_get_stats(rac_model_residency_stats_t* out_stats) {
+    if (out_stats == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto& res = residency();
+    std::lock_guard<std::mutex> lock(res.mutex);
+    out_stats->resident_bytes = resident_bytes(res);
+    out_stats->budget_bytes = residency_budget(res);
+    out_stats->loaded_services = static_cast<int32_t>(res.loaded_bytes.size());
+    out_stats->parked_services = static_cast<int32_t>(res.parked.size());
+    out_stats->hits = res.hits;
+    out_stats->misses = res.misses;
+    out_stats->evictions = res.evictions;
+    return RAC_SUCCESS;
+}
+
 const char* rac_lifecycle_state_name(rac_lifecycle_state_t state) {
     switch (state) {
         case RAC_LIFECYCLE_STATE_IDLE:
@@ -6,10 +6,19 @@
  * Platform SDKs register callbacks to receive events.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 
 #include "rac/core/rac_analytics_events.h"
 #include "rac/core/rac_logger.h"
+#include "rac/infrastructure/network/rac_outbound_queue.h"
 
 // =============================================================================
 // INTERNAL STATE
@@ -17,13 +26,47 @@
 
 namespace {
 
+// Event types are grouped by hundreds (100 LLM ... 1200 framework) with fewer
+// than 64 types per group, so a bit per type fits one word per group
+constexpr int kInterestGroups = 13;
+
+// Bits of one group set for every type
+constexpr uint64_t kAllTypes = ~uint64_t{0};
+
+// Word and bit of an event type, false for types outside the groups
+bool interest_slot(rac_event_type_t type, int* group, uint64_t* bit) {
+    int value = static_cast<int>(type);
+    if (value < 0 || value >= kInterestGroups * 100 || value % 100 >= 64) {
+        return false;
+    }
+    *group = value / 100;
+    *bit = uint64_t{1} << (value % 100);
+    return true;
+}
+
+// Event types that would reach a callback, rebuilt whenever a callback or
+// filter changes. Emitters read them without the state mutex.
+std::atomic<uint64_t> g_interest[kInterestGroups];
+// Types outside the groups: observed by any callback without a filter
+std::atomic<bool> g_interest_ungrouped{false};
+
 // Thread-safe event callback storage
 struct EventCallbackState {
     rac_analytics_callback_fn analytics_callback = nullptr;
     void* analytics_user_data = nullptr;
     rac_public_event_callback_fn public_callback = nullptr;
     void* public_user_data = nullptr;
+    // Types each callback asked for (every type unless filtered)
+    uint64_t analytics_types[kInterestGroups];
+    uint64_t public_types[kInterestGroups];
+    bool analytics_filtered = false;
+    bool public_filtered = false;
     std::mutex mutex;
+
+    EventCallbackState() {
+        std::fill(analytics_types, analytics_types + kInterestGroups, kAllTypes);
+        std::fill(public_types, public_types + kInterestGroups, kAllTypes);
+    }
 };
 
 EventCallbackState& get_callback_state() {
@@ -31,6 +74,262 @@ EventCallbackState& get_callback_state() {
     return state;
 }
 
+// Whether a callback filter lets an event type through
+bool filter_allows(const uint64_t* types, bool filtered, rac_event_type_t type) {
+    int group = 0;
+    uint64_t bit = 0;
+    if (!interest_slot(type, &group, &bit)) {
+        return !filtered;
+    }
+    return (types[group] & bit) != 0;
+}
+
+// Caller holds state.mutex
+void publish_interest_locked(const EventCallbackState& state) {
+    bool analytics = state.analytics_callback != nullptr;
+    bool pub = state.public_callback != nullptr;
+    for (int group = 0; group < kInterestGroups; ++group) {
+        uint64_t mask = 0;
+        for (int offset = 0; offset < 64; ++offset) {
+            auto type = static_cast<rac_event_type_t>(group * 100 + offset);
+            uint64_t bit = uint64_t{1} << offset;
+            rac_event_destination_t dest = rac_event_get_destination(type);
+            if (analytics && (state.analytics_types[group] & bit) &&
+                dest != RAC_EVENT_DESTINATION_PUBLIC_ONLY) {
+                mask |= bit;
+            }
+            if (pub && (state.public_types[group] & bit) &&
+                dest != RAC_EVENT_DESTINATION_ANALYTICS_ONLY) {
+                mask |= bit;
+            }
+        }
+        g_interest[group].store(mask, std::memory_order_relaxed);
+    }
+    g_interest_ungrouped.store((analytics && !state.analytics_filtered) ||
+                                   (pub && !state.public_filtered),
+                               std::memory_order_relaxed);
+}
+
+// Replaces a callback filter; NULL types means every type
+rac_result_t set_filter(uint64_t* types, bool* filtered, const rac_event_type_t* list,
+                        size_t count) {
+    uint64_t next[kInterestGroups];
+    std::fill(next, next + kInterestGroups, list == nullptr ? kAllTypes : 0);
+    for (size_t i = 0; list != nullptr && i < count; ++i) {
+        int group = 0;
+        uint64_t bit = 0;
+        if (!interest_slot(list[i], &group, &bit)) {
+            return RAC_ERROR_INVALID_ARGUMENT;
+        }
+        next[group] |= bit;
+    }
+
+    auto& state = get_callback_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::copy(next, next + kInterestGroups, types);
+    *filtered = list != nullptr;
+    publish_interest_locked(state);
+    return RAC_SUCCESS;
+}
+
+// Routes an event to the registered callbacks, which run under the state mutex
+void dispatch_event(rac_event_type_t type, const rac_analytics_event_data_t* data) {
+    auto& state = get_callback_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    // Get the destination for this event type
+    rac_event_destination_t dest = rac_event_get_destination(type);
+
+    // Route to analytics callback (telemetry)
+    if (dest == RAC_EVENT_DESTINATION_ANALYTICS_ONLY || dest == RAC_EVENT_DESTINATION_ALL) {
+        if (state.analytics_callback != nullptr &&
+            filter_allows(state.analytics_types, state.analytics_filtered, type)) {
+            log_debug("Events", "Invoking analytics callback for event type %d", type);
+            state.analytics_callback(type, data, state.analytics_user_data);
+        }
+    }
+
+    // Route to public callback (app developers)
+    if (dest == RAC_EVENT_DESTINATION_PUBLIC_ONLY || dest == RAC_EVENT_DESTINATION_ALL) {
+        if (state.public_callback != nullptr &&
+            filter_allows(state.public_types, state.public_filtered, type)) {
+            state.public_callback(type, data, state.public_user_data);
+        }
+    }
+}
+
+// =============================================================================
+// COALESCING - Latest state of high-frequency progress events
+// =============================================================================
+
+// Idle coalescing entries are pruned once there are more than this many
+constexpr size_t kMaxIdleCoalescedIds = 64;
+
+// Latest update of one generation or model, with its strings owned
+struct CoalescedUpdate {
+    rac_event_type_t type = RAC_EVENT_LLM_STREAMING_UPDATE;
+    rac_analytics_event_data_t data = {};
+    std::string strings[4];
+    bool pending = false;
+    int64_t last_delivered_ms = 0;
+
+    void store(rac_event_type_t event_type, const rac_analytics_event_data_t& event) {
+        type = event_type;
+        data = event;
+        auto own = [this](const char* text, int slot) -> const char* {
+            if (text == nullptr) {
+                return nullptr;
+            }
+            strings[slot].assign(text);
+            return strings[slot].c_str();
+        };
+        if (event_type == RAC_EVENT_LLM_STREAMING_UPDATE) {
+            rac_analytics_llm_generation_t& gen = data.data.llm_generation;
+            gen.generation_id = own(gen.generation_id, 0);
+            gen.model_id = own(gen.model_id, 1);
+            gen.model_name = own(gen.model_name, 2);
+            gen.error_message = own(gen.error_message, 3);
+        } else {
+            rac_analytics_model_download_t& download = data.data.model_download;
+            download.model_id = own(download.model_id, 0);
+            download.archive_type = own(download.archive_type, 1);
+            download.error_message = own(download.error_message, 2);
+        }
+    }
+};
+
+struct Coalescer {
+    std::mutex mutex;  // held while coalesced updates are delivered, to keep their order
+    std::condition_variable cv;
+    std::unordered_map<std::string, CoalescedUpdate> updates;
+    int32_t window_ms = RAC_ANALYTICS_COALESCE_WINDOW_DEFAULT_MS;
+    bool flusher_started = false;
+};
+
+// Never destroyed: the detached flusher may run until process exit
+Coalescer& get_coalescer() {
+    static Coalescer* coalescer = new Coalescer();
+    return *coalescer;
+}
+
+int64_t steady_now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Progress event type coalesced under the ID of this event, or -1
+int coalesced_progress_type(rac_event_type_t type) {
+    switch (type) {
+        case RAC_EVENT_LLM_STREAMING_UPDATE:
+        case RAC_EVENT_LLM_GENERATION_COMPLETED:
+        case RAC_EVENT_LLM_GENERATION_FAILED:
+            return RAC_EVENT_LLM_STREAMING_UPDATE;
+        case RAC_EVENT_MODEL_DOWNLOAD_PROGRESS:
+        case RAC_EVENT_MODEL_DOWNLOAD_COMPLETED:
+        case RAC_EVENT_MODEL_DOWNLOAD_FAILED:
+        case RAC_EVENT_MODEL_DOWNLOAD_CANCELLED:
+            return RAC_EVENT_MODEL_DOWNLOAD_PROGRESS;
+        case RAC_EVENT_MODEL_EXTRACTION_PROGRESS:
+        case RAC_EVENT_MODEL_EXTRACTION_COMPLETED:
+        case RAC_EVENT_MODEL_EXTRACTION_FAILED:
+            return RAC_EVENT_MODEL_EXTRACTION_PROGRESS;
+        default:
+            return -1;
+    }
+}
+
+// Delivers held-back updates whose window has ended
+void flusher_loop() {
+    Coalescer& c = get_coalescer();
+    std::unique_lock<std::mutex> lock(c.mutex);
+    for (;;) {
+        int64_t now = steady_now_ms();
+        int64_t next_due = INT64_MAX;
+        for (auto it = c.updates.begin(); it != c.updates.end();) {
+            CoalescedUpdate& update = it->second;
+            if (update.pending) {
+                int64_t due = update.last_delivered_ms + c.window_ms;
+                if (due <= now) {
+                    update.pending = false;
+                    update.last_delivered_ms = now;
+                    dispatch_event(update.type, &update.data);
+                } else {
+                    next_due = std::min(next_due, due);
+                }
+            } else if (c.updates.size() > kMaxIdleCoalescedIds &&
+                       now - update.last_delivered_ms >= c.window_ms) {
+                it = c.updates.erase(it);
+                continue;
+            }
+            ++it;
+        }
+
+        if (next_due == INT64_MAX) {
+            c.cv.wait(lock);
+        } else {
+            c.cv.wait_for(lock, std::chrono::milliseconds(next_due - now));
+        }
+    }
+}
+
+/**
+ * @brief Emit through the coalescer
+ *
+ * @return false if the event is not coalesced and should be dispatched directly
+ */
+bool emit_coalesced(rac_event_type_t type, const rac_analytics_event_data_t* data) {
+    int progress_type = coalesced_progress_type(type);
+    if (progress_type < 0) {
+        return false;
+    }
+    const char* id = progress_type == RAC_EVENT_LLM_STREAMING_UPDATE
+                         ? data->data.llm_generation.generation_id
+                         : data->data.model_download.model_id;
+    if (id == nullptr) {
+        return false;
+    }
+
+    Coalescer& c = get_coalescer();
+    std::string key = std::to_string(progress_type) + ':' + id;
+    std::lock_guard<std::mutex> lock(c.mutex);
+
+    // Completed, failed or cancelled: the latest held update goes first
+    if (type != progress_type) {
+        auto it = c.updates.find(key);
+        if (it != c.updates.end()) {
+            if (it->second.pending) {
+                dispatch_event(it->second.type, &it->second.data);
+            }
+            c.updates.erase(it);
+        }
+        dispatch_event(type, data);
+        return true;
+    }
+
+    if (c.window_ms <= 0) {
+        dispatch_event(type, data);
+        return true;
+    }
+
+    int64_t now = steady_now_ms();
+    CoalescedUpdate& update = c.updates[key];
+    if (!update.pending && now - update.last_delivered_ms >= c.window_ms) {
+        update.last_delivered_ms = now;
+        dispatch_event(type, data);
+        return true;
+    }
+
+    update.store(type, *data);
+    update.pending = true;
+    if (!c.flusher_started) {
+        c.flusher_started = true;
+        std::thread(flusher_loop).detach();
+    }
+    c.cv.notify_one();
+    return true;
+}
+
 }  // namespace
 
 // =============================================================================
@@ -70,10 +369,17 @@ rac_result_t rac_analytics_events_set_callback(rac_analytics_callback_fn callbac
 
     state.analytics_callback = callback;
     state.analytics_user_data = user_data;
+    publish_interest_locked(state);
 
     return RAC_SUCCESS;
 }
 
+rac_result_t rac_analytics_events_set_callback_filter(const rac_event_type_t* types,
+                                                      size_t count) {
+    auto& state = get_callback_state();
+    return set_filter(state.analytics_types, &state.analytics_filtered, types, count);
+}
+
 rac_result_t rac_analytics_events_set_public_callback(rac_public_event_callback_fn callback,
                                                       void* user_data) {
     auto& state = get_callback_state();
@@ -81,35 +387,54 @@ rac_result_t rac_analytics_events_set_public_callback(rac_public_event_callback_
 
     state.public_callback = callback;
     state.public_user_data = user_data;
+    publish_interest_locked(state);
 
     return RAC_SUCCESS;
 }
 
+rac_result_t rac_analytics_events_set_public_callback_filter(const rac_event_type_t* types,
+                                                             size_t count) {
+    auto& state = get_callback_state();
+    return set_filter(state.public_types, &state.public_filtered, types, count);
+}
+
+rac_bool_t rac_analytics_event_is_observed(rac_event_type_t type) {
+    int group = 0;
+    uint64_t bit = 0;
+    if (!interest_slot(type, &group, &bit)) {
+        return g_interest_ungrouped.load(std::memory_order_relaxed) ? RAC_TRUE : RAC_FALSE;
+    }
+    return (g_interest[group].load(std::memory_order_relaxed) & bit) != 0 ? RAC_TRUE : RAC_FALSE;
+}
+
 void rac_analytics_event_emit(rac_event_type_t type, const rac_analytics_event_data_t* data) {
-    if (data == nullptr) {
+    if (data == nullptr || !rac_analytics_event_is_observed(type)) {
         return;
     }
 
-    auto& state = get_callback_state();
-    std::lock_guard<std::mutex> lock(state.mutex);
-
-    // Get the destination for this event type
-    rac_event_destination_t dest = rac_event_get_destination(type);
+    if (!emit_coalesced(type, data)) {
+        dispatch_event(type, data);
+    }
+}
 
-    // Route to analytics callback (telemetry)
-    if (dest == RAC_EVENT_DESTINATION_ANALYTICS_ONLY || dest == RAC_EVENT_DESTINATION_ALL) {
-        if (state.analytics_callback != nullptr) {
-            log_debug("Events", "Invoking analytics callback for event type %d", type);
-            state.analytics_callback(type, data, state.analytics_user_data);
-        }
+rac_result_t rac_analytics_events_set_coalesce_window(int32_t window_ms) {
+    if (window_ms < 0) {
+        return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    // Route to public callback (app developers)
-    if (dest == RAC_EVENT_DESTINATION_PUBLIC_ONLY || dest == RAC_EVENT_DESTINATION_ALL) {
-        if (state.public_callback != nullptr) {
-            state.public_callback(type, data, state.public_user_data);
+    Coalescer& c = get_coalescer();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    c.window_ms = window_ms;
+    if (window_ms == 0) {
+        for (auto& entry : c.updates) {
+            if (entry.second.pending) {
+                dispatch_event(entry.second.type, &entry.second.data);
+            }
         }
+        c.updates.clear();
     }
+    c.cv.notify_one();
+    return RAC_SUCCESS;
 }
 
 rac_bool_t rac_analytics_events_has_callback(void) {
@@ -137,6 +462,10 @@ namespace rac::events {
 void emit_llm_generation_started(const char* generation_id, const char* model_id, bool is_streaming,
                                  rac_inference_framework_t framework, float temperature,
                                  int32_t max_tokens, int32_t context_length) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_LLM_GENERATION_STARTED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_LLM_GENERATION_STARTED;
     event.data.llm_generation = RAC_ANALYTICS_LLM_GENERATION_DEFAULT;
@@ -157,6 +486,10 @@ void emit_llm_generation_completed(const char* generation_id, const char* model_
                                    double time_to_first_token_ms,
                                    rac_inference_framework_t framework, float temperature,
                                    int32_t max_tokens, int32_t context_length) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_LLM_GENERATION_COMPLETED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_LLM_GENERATION_COMPLETED;
     event.data.llm_generation.generation_id = generation_id;
@@ -179,6 +512,10 @@ void emit_llm_generation_completed(const char* generation_id, const char* model_
 
 void emit_llm_generation_failed(const char* generation_id, const char* model_id,
                                 rac_result_t error_code, const char* error_message) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_LLM_GENERATION_FAILED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_LLM_GENERATION_FAILED;
     event.data.llm_generation = RAC_ANALYTICS_LLM_GENERATION_DEFAULT;
@@ -192,6 +529,10 @@ void emit_llm_generation_failed(const char* generation_id, const char* model_id,
 
 void emit_llm_first_token(const char* generation_id, const char* model_id,
                           double time_to_first_token_ms, rac_inference_framework_t framework) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_LLM_FIRST_TOKEN)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_LLM_FIRST_TOKEN;
     event.data.llm_generation = RAC_ANALYTICS_LLM_GENERATION_DEFAULT;
@@ -204,6 +545,10 @@ void emit_llm_first_token(const char* generation_id, const char* model_id,
 }
 
 void emit_llm_streaming_update(const char* generation_id, int32_t tokens_generated) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_LLM_STREAMING_UPDATE)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_LLM_STREAMING_UPDATE;
     event.data.llm_generation = RAC_ANALYTICS_LLM_GENERATION_DEFAULT;
@@ -217,6 +562,10 @@ void emit_stt_transcription_started(const char* transcription_id, const char* mo
                                     double audio_length_ms, int32_t audio_size_bytes,
                                     const char* language, bool is_streaming, int32_t sample_rate,
                                     rac_inference_framework_t framework) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_STT_TRANSCRIPTION_STARTED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_STT_TRANSCRIPTION_STARTED;
     event.data.stt_transcription = RAC_ANALYTICS_STT_TRANSCRIPTION_DEFAULT;
@@ -238,6 +587,10 @@ void emit_stt_transcription_completed(const char* transcription_id, const char*
                                       int32_t word_count, double real_time_factor,
                                       const char* language, int32_t sample_rate,
                                       rac_inference_framework_t framework) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_STT_TRANSCRIPTION_COMPLETED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_STT_TRANSCRIPTION_COMPLETED;
     event.data.stt_transcription.transcription_id = transcription_id;
@@ -259,6 +612,10 @@ void emit_stt_transcription_completed(const char* transcription_id, const char*
 
 void emit_stt_transcription_failed(const char* transcription_id, const char* model_id,
                                    rac_result_t error_code, const char* error_message) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_STT_TRANSCRIPTION_FAILED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_STT_TRANSCRIPTION_FAILED;
     event.data.stt_transcription = RAC_ANALYTICS_STT_TRANSCRIPTION_DEFAULT;
@@ -273,6 +630,10 @@ void emit_stt_transcription_failed(const char* transcription_id, const char* mod
 void emit_tts_synthesis_started(const char* synthesis_id, const char* model_id,
                                 int32_t character_count, int32_t sample_rate,
                                 rac_inference_framework_t framework) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_TTS_SYNTHESIS_STARTED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_TTS_SYNTHESIS_STARTED;
     event.data.tts_synthesis = RAC_ANALYTICS_TTS_SYNTHESIS_DEFAULT;
@@ -290,6 +651,10 @@ void emit_tts_synthesis_completed(const char* synthesis_id, const char* model_id
                                   int32_t audio_size_bytes, double processing_duration_ms,
                                   double characters_per_second, int32_t sample_rate,
                                   rac_inference_framework_t framework) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_TTS_SYNTHESIS_COMPLETED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_TTS_SYNTHESIS_COMPLETED;
     event.data.tts_synthesis.synthesis_id = synthesis_id;
@@ -308,6 +673,10 @@ void emit_tts_synthesis_completed(const char* synthesis_id, const char* model_id
 
 void emit_tts_synthesis_failed(const char* synthesis_id, const char* model_id,
                                rac_result_t error_code, const char* error_message) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_TTS_SYNTHESIS_FAILED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_TTS_SYNTHESIS_FAILED;
     event.data.tts_synthesis = RAC_ANALYTICS_TTS_SYNTHESIS_DEFAULT;
@@ -320,6 +689,10 @@ void emit_tts_synthesis_failed(const char* synthesis_id, const char* model_id,
 }
 
 void emit_vad_started() {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_VAD_STARTED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_VAD_STARTED;
     event.data.vad = RAC_ANALYTICS_VAD_DEFAULT;
@@ -328,6 +701,10 @@ void emit_vad_started() {
 }
 
 void emit_vad_stopped() {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_VAD_STOPPED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_VAD_STOPPED;
     event.data.vad = RAC_ANALYTICS_VAD_DEFAULT;
@@ -336,6 +713,10 @@ void emit_vad_stopped() {
 }
 
 void emit_vad_speech_started(float energy_level) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_VAD_SPEECH_STARTED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_VAD_SPEECH_STARTED;
     event.data.vad.speech_duration_ms = 0.0;
@@ -345,6 +726,10 @@ void emit_vad_speech_started(float energy_level) {
 }
 
 void emit_vad_speech_ended(double speech_duration_ms, float energy_level) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_VAD_SPEECH_ENDED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_VAD_SPEECH_ENDED;
     event.data.vad.speech_duration_ms = speech_duration_ms;
@@ -358,6 +743,10 @@ void emit_vad_speech_ended(double speech_duration_ms, float energy_level) {
 // =============================================================================
 
 void emit_sdk_init_started() {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_SDK_INIT_STARTED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_SDK_INIT_STARTED;
     event.data.sdk_lifecycle = RAC_ANALYTICS_SDK_LIFECYCLE_DEFAULT;
@@ -365,26 +754,41 @@ void emit_sdk_init_started() {
     rac_analytics_event_emit(RAC_EVENT_SDK_INIT_STARTED, &event);
 }
 
-void emit_sdk_init_completed(double duration_ms) {
+void emit_sdk_init_completed(double duration_ms, const char* subsystem) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_SDK_INIT_COMPLETED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_SDK_INIT_COMPLETED;
     event.data.sdk_lifecycle = RAC_ANALYTICS_SDK_LIFECYCLE_DEFAULT;
     event.data.sdk_lifecycle.duration_ms = duration_ms;
+    event.data.sdk_lifecycle.subsystem = subsystem;
 
     rac_analytics_event_emit(RAC_EVENT_SDK_INIT_COMPLETED, &event);
 }
 
-void emit_sdk_init_failed(rac_result_t error_code, const char* error_message) {
+void emit_sdk_init_failed(rac_result_t error_code, const char* error_message,
+                          const char* subsystem) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_SDK_INIT_FAILED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_SDK_INIT_FAILED;
     event.data.sdk_lifecycle = RAC_ANALYTICS_SDK_LIFECYCLE_DEFAULT;
     event.data.sdk_lifecycle.error_code = error_code;
     event.data.sdk_lifecycle.error_message = error_message;
+    event.data.sdk_lifecycle.subsystem = subsystem;
 
     rac_analytics_event_emit(RAC_EVENT_SDK_INIT_FAILED, &event);
 }
 
 void emit_sdk_models_loaded(int32_t count, double duration_ms) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_SDK_MODELS_LOADED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_SDK_MODELS_LOADED;
     event.data.sdk_lifecycle = RAC_ANALYTICS_SDK_LIFECYCLE_DEFAULT;
@@ -400,6 +804,10 @@ void emit_sdk_models_loaded(int32_t count, double duration_ms) {
 
 void emit_model_download_started(const char* model_id, int64_t total_bytes,
                                  const char* archive_type) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_MODEL_DOWNLOAD_STARTED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_MODEL_DOWNLOAD_STARTED;
     event.data.model_download = RAC_ANALYTICS_MODEL_DOWNLOAD_DEFAULT;
@@ -412,6 +820,10 @@ void emit_model_download_started(const char* model_id, int64_t total_bytes,
 
 void emit_model_download_progress(const char* model_id, double progress, int64_t bytes_downloaded,
                                   int64_t total_bytes) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_MODEL_DOWNLOAD_PROGRESS)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_MODEL_DOWNLOAD_PROGRESS;
     event.data.model_download = RAC_ANALYTICS_MODEL_DOWNLOAD_DEFAULT;
@@ -425,6 +837,10 @@ void emit_model_download_progress(const char* model_id, double progress, int64_t
 
 void emit_model_download_completed(const char* model_id, int64_t size_bytes, double duration_ms,
                                    const char* archive_type) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_MODEL_DOWNLOAD_COMPLETED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_MODEL_DOWNLOAD_COMPLETED;
     event.data.model_download = RAC_ANALYTICS_MODEL_DOWNLOAD_DEFAULT;
@@ -439,6 +855,10 @@ void emit_model_download_completed(const char* model_id, int64_t size_bytes, dou
 
 void emit_model_download_failed(const char* model_id, rac_result_t error_code,
                                 const char* error_message) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_MODEL_DOWNLOAD_FAILED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_MODEL_DOWNLOAD_FAILED;
     event.data.model_download = RAC_ANALYTICS_MODEL_DOWNLOAD_DEFAULT;
@@ -450,6 +870,10 @@ void emit_model_download_failed(const char* model_id, rac_result_t error_code,
 }
 
 void emit_model_download_cancelled(const char* model_id) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_MODEL_DOWNLOAD_CANCELLED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_MODEL_DOWNLOAD_CANCELLED;
     event.data.model_download = RAC_ANALYTICS_MODEL_DOWNLOAD_DEFAULT;
@@ -463,6 +887,10 @@ void emit_model_download_cancelled(const char* model_id) {
 // =============================================================================
 
 void emit_model_extraction_started(const char* model_id, const char* archive_type) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_MODEL_EXTRACTION_STARTED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_MODEL_EXTRACTION_STARTED;
     event.data.model_download = RAC_ANALYTICS_MODEL_DOWNLOAD_DEFAULT;
@@ -473,6 +901,10 @@ void emit_model_extraction_started(const char* model_id, const char* archive_typ
 }
 
 void emit_model_extraction_progress(const char* model_id, double progress) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_MODEL_EXTRACTION_PROGRESS)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_MODEL_EXTRACTION_PROGRESS;
     event.data.model_download = RAC_ANALYTICS_MODEL_DOWNLOAD_DEFAULT;
@@ -483,6 +915,10 @@ void emit_model_extraction_progress(const char* model_id, double progress) {
 }
 
 void emit_model_extraction_completed(const char* model_id, int64_t size_bytes, double duration_ms) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_MODEL_EXTRACTION_COMPLETED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_MODEL_EXTRACTION_COMPLETED;
     event.data.model_download = RAC_ANALYTICS_MODEL_DOWNLOAD_DEFAULT;
@@ -495,6 +931,10 @@ void emit_model_extraction_completed(const char* model_id, int64_t size_bytes, d
 
 void emit_model_extraction_failed(const char* model_id, rac_result_t error_code,
                                   const char* error_message) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_MODEL_EXTRACTION_FAILED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_MODEL_EXTRACTION_FAILED;
     event.data.model_download = RAC_ANALYTICS_MODEL_DOWNLOAD_DEFAULT;
@@ -506,6 +946,10 @@ void emit_model_extraction_failed(const char* model_id, rac_result_t error_code,
 }
 
 void emit_model_deleted(const char* model_id, int64_t size_bytes) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_MODEL_DELETED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_MODEL_DELETED;
     event.data.model_download = RAC_ANALYTICS_MODEL_DOWNLOAD_DEFAULT;
@@ -520,6 +964,10 @@ void emit_model_deleted(const char* model_id, int64_t size_bytes) {
 // =============================================================================
 
 void emit_storage_cache_cleared(int64_t freed_bytes) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_STORAGE_CACHE_CLEARED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_STORAGE_CACHE_CLEARED;
     event.data.storage = RAC_ANALYTICS_STORAGE_DEFAULT;
@@ -529,6 +977,10 @@ void emit_storage_cache_cleared(int64_t freed_bytes) {
 }
 
 void emit_storage_cache_clear_failed(rac_result_t error_code, const char* error_message) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_STORAGE_CACHE_CLEAR_FAILED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_STORAGE_CACHE_CLEAR_FAILED;
     event.data.storage = RAC_ANALYTICS_STORAGE_DEFAULT;
@@ -539,6 +991,10 @@ void emit_storage_cache_clear_failed(rac_result_t error_code, const char* error_
 }
 
 void emit_storage_temp_cleaned(int64_t freed_bytes) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_STORAGE_TEMP_CLEANED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_STORAGE_TEMP_CLEANED;
     event.data.storage = RAC_ANALYTICS_STORAGE_DEFAULT;
@@ -552,6 +1008,10 @@ void emit_storage_temp_cleaned(int64_t freed_bytes) {
 // =============================================================================
 
 void emit_device_registered(const char* device_id) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_DEVICE_REGISTERED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_DEVICE_REGISTERED;
     event.data.device = RAC_ANALYTICS_DEVICE_DEFAULT;
@@ -561,6 +1021,10 @@ void emit_device_registered(const char* device_id) {
 }
 
 void emit_device_registration_failed(rac_result_t error_code, const char* error_message) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_DEVICE_REGISTRATION_FAILED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_DEVICE_REGISTRATION_FAILED;
     event.data.device = RAC_ANALYTICS_DEVICE_DEFAULT;
@@ -575,6 +1039,13 @@ void emit_device_registration_failed(rac_result_t error_code, const char* error_
 // =============================================================================
 
 void emit_network_connectivity_changed(bool is_online) {
+    // Outbound work waits for, and drains on, the same signal
+    rac_outbound_queue_set_online(is_online ? RAC_TRUE : RAC_FALSE);
+
+    if (!rac_analytics_event_is_observed(RAC_EVENT_NETWORK_CONNECTIVITY_CHANGED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_NETWORK_CONNECTIVITY_CHANGED;
     event.data.network = RAC_ANALYTICS_NETWORK_DEFAULT;
@@ -589,6 +1060,10 @@ void emit_network_connectivity_changed(bool is_online) {
 
 void emit_sdk_error(rac_result_t error_code, const char* error_message, const char* operation,
                     const char* context) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_SDK_ERROR)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_SDK_ERROR;
     event.data.sdk_error = RAC_ANALYTICS_SDK_ERROR_DEFAULT;
@@ -606,6 +1081,10 @@ void emit_sdk_error(rac_result_t error_code, const char* error_message, const ch
 
 void emit_voice_agent_stt_state_changed(rac_voice_agent_component_state_t state,
                                         const char* model_id, const char* error_message) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_VOICE_AGENT_STT_STATE_CHANGED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_VOICE_AGENT_STT_STATE_CHANGED;
     event.data.voice_agent_state.component = "stt";
@@ -618,6 +1097,10 @@ void emit_voice_agent_stt_state_changed(rac_voice_agent_component_state_t state,
 
 void emit_voice_agent_llm_state_changed(rac_voice_agent_component_state_t state,
                                         const char* model_id, const char* error_message) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_VOICE_AGENT_LLM_STATE_CHANGED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_VOICE_AGENT_LLM_STATE_CHANGED;
     event.data.voice_agent_state.component = "llm";
@@ -630,6 +1113,10 @@ void emit_voice_agent_llm_state_changed(rac_voice_agent_component_state_t state,
 
 void emit_voice_agent_tts_state_changed(rac_voice_agent_component_state_t state,
                                         const char* model_id, const char* error_message) {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_VOICE_AGENT_TTS_STATE_CHANGED)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_VOICE_AGENT_TTS_STATE_CHANGED;
     event.data.voice_agent_state.component = "tts";
@@ -641,6 +1128,10 @@ void emit_voice_agent_tts_state_changed(rac_voice_agent_component_state_t state,
 }
 
 void emit_voice_agent_all_ready() {
+    if (!rac_analytics_event_is_observed(RAC_EVENT_VOICE_AGENT_ALL_READY)) {
+        return;
+    }
+
     rac_analytics_event_data_t event = {};
     event.type = RAC_EVENT_VOICE_AGENT_ALL_READY;
     event.data.voice_agent_state.component = "all";
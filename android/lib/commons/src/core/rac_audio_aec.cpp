@@ -0,0 +1,197 @@
+/**
+ * @file rac_audio_aec.cpp
+ * @brief RunAnywhere Commons - Acoustic Echo Canceller Implementation
+ *
+ * Time-domain NLMS, one update per sample. The reference history is kept
+ * twice in a mirrored buffer so the newest filter-length window is always
+ * contiguous, and both the echo estimate and the weight update are single
+ * calls into the vectorised audio kernels.
+ */
+
+#include "rac/core/rac_audio_aec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "rac/core/rac_audio_kernels.h"
+#include "rac/core/rac_logger.h"
+
+namespace {
+
+// Regularisation of the NLMS normalisation, so silence does not blow up the step
+constexpr float kEnergyFloor = 1e-4f;
+
+// Adaptation stays frozen this long after near-end talk was last detected
+constexpr int32_t kDoubleTalkHangoverMs = 240;
+
+// Reference audio queued beyond this is dropped (playback far ahead of capture)
+constexpr int32_t kMaxQueuedReferenceMs = 2000;
+
+}  // namespace
+
+struct rac_audio_aec {
+    rac_audio_aec_config_t config;
+    size_t taps;
+
+    std::vector<float> weights;
+    // history[pos .. pos + taps) is the newest window, newest sample first
+    std::vector<float> history;
+    size_t pos = 0;
+    float energy = 0.0f;
+    size_t samples_since_refresh = 0;
+
+    int32_t hangover_samples = 0;
+    int32_t hangover_remaining = 0;
+    size_t echo_remaining = 0;  // samples until the last fed reference has died out
+
+    std::mutex reference_mtx;
+    std::deque<float> reference;
+    size_t max_reference = 0;
+
+    void push_history(float x) {
+        pos = (pos == 0 ? taps : pos) - 1;
+        float oldest = history[pos];
+        history[pos] = x;
+        history[pos + taps] = x;
+        energy += x * x - oldest * oldest;
+
+        // Recompute now and then so rounding in the running energy cannot drift
+        if (++samples_since_refresh >= taps) {
+            energy = rac_audio_sum_squares(&history[pos], taps);
+            samples_since_refresh = 0;
+        }
+    }
+};
+
+extern "C" {
+
+rac_result_t rac_audio_aec_create(const rac_audio_aec_config_t* config, rac_audio_aec_t* out_aec) {
+    if (!out_aec) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    const rac_audio_aec_config_t& cfg = config ? *config : RAC_AUDIO_AEC_CONFIG_DEFAULT;
+    if (cfg.sample_rate <= 0 || cfg.filter_length_ms <= 0 || cfg.step_size <= 0.0f ||
+        cfg.step_size > 1.0f) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto* aec = new (std::nothrow) rac_audio_aec();
+    if (!aec) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    aec->config = cfg;
+    aec->taps = std::max<size_t>(
+        1, static_cast<size_t>(cfg.sample_rate) * static_cast<size_t>(cfg.filter_length_ms) / 1000);
+    aec->weights.assign(aec->taps, 0.0f);
+    aec->history.assign(aec->taps * 2, 0.0f);
+    aec->hangover_samples = cfg.sample_rate * kDoubleTalkHangoverMs / 1000;
+    aec->max_reference = static_cast<size_t>(cfg.sample_rate) * kMaxQueuedReferenceMs / 1000;
+
+    RAC_LOG_DEBUG("AudioAEC", "Echo canceller created: %zu taps at %d Hz", aec->taps,
+                  cfg.sample_rate);
+    *out_aec = aec;
+    return RAC_SUCCESS;
+}
+
+void rac_audio_aec_feed_reference(rac_audio_aec_t aec, const float* samples, size_t num_samples) {
+    if (!aec || !samples || num_samples == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(aec->reference_mtx);
+    aec->reference.insert(aec->reference.end(), samples, samples + num_samples);
+    if (aec->reference.size() > aec->max_reference) {
+        aec->reference.erase(aec->reference.begin(),
+                             aec->reference.begin() + (aec->reference.size() - aec->max_reference));
+    }
+}
+
+rac_result_t rac_audio_aec_process(rac_audio_aec_t aec, const float* mic, float* out,
+                                   size_t num_samples) {
+    if (!aec || !mic || !out) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    // Take this call's reference in one go so the playback thread waits at most once
+    std::vector<float> far_end(num_samples, 0.0f);
+    {
+        std::lock_guard<std::mutex> lock(aec->reference_mtx);
+        size_t available = std::min(num_samples, aec->reference.size());
+        std::copy(aec->reference.begin(), aec->reference.begin() + available, far_end.begin());
+        aec->reference.erase(aec->reference.begin(), aec->reference.begin() + available);
+        if (available > 0) {
+            aec->echo_remaining = aec->taps + num_samples;
+        }
+    }
+
+    const size_t taps = aec->taps;
+    const float step = aec->config.step_size;
+    const float ratio = aec->config.double_talk_ratio;
+    float reference_peak = rac_audio_peak(&aec->history[aec->pos], taps);
+
+    for (size_t i = 0; i < num_samples; ++i) {
+        aec->push_history(far_end[i]);
+        reference_peak = std::max(reference_peak, std::fabs(far_end[i]));
+
+        const float* window = &aec->history[aec->pos];
+        float near = mic[i];
+        float error = near - rac_audio_dot(aec->weights.data(), window, taps);
+
+        // Geigel detector: a mic sample louder than the echo could be is the user
+        if (ratio > 0.0f && std::fabs(near) > ratio * reference_peak) {
+            aec->hangover_remaining = aec->hangover_samples;
+        }
+
+        if (aec->hangover_remaining > 0) {
+            aec->hangover_remaining--;
+        } else if (aec->energy > 0.0f) {
+            rac_audio_mix(aec->weights.data(), window, taps,
+                          step * error / (aec->energy + kEnergyFloor));
+        }
+
+        out[i] = error;
+
+        // The peak decays only when a full window has passed; refresh it per window
+        if (aec->samples_since_refresh == 0) {
+            reference_peak = rac_audio_peak(window, taps);
+        }
+    }
+
+    aec->echo_remaining = aec->echo_remaining > num_samples ? aec->echo_remaining - num_samples : 0;
+    return RAC_SUCCESS;
+}
+
+rac_bool_t rac_audio_aec_is_active(rac_audio_aec_t aec) {
+    if (!aec) {
+        return RAC_FALSE;
+    }
+    std::lock_guard<std::mutex> lock(aec->reference_mtx);
+    return !aec->reference.empty() || aec->echo_remaining > 0 ? RAC_TRUE : RAC_FALSE;
+}
+
+void rac_audio_aec_reset(rac_audio_aec_t aec) {
+    if (!aec) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(aec->reference_mtx);
+        aec->reference.clear();
+        aec->echo_remaining = 0;
+    }
+    std::fill(aec->weights.begin(), aec->weights.end(), 0.0f);
+    std::fill(aec->history.begin(), aec->history.end(), 0.0f);
+    aec->pos = 0;
+    aec->energy = 0.0f;
+    aec->samples_since_refresh = 0;
+    aec->hangover_remaining = 0;
+}
+
+void rac_audio_aec_destroy(rac_audio_aec_t aec) {
+    delete aec;
+}
+
+}  // extern "C"
@@ -0,0 +1,629 @@
+/**
+ * @file rac_audio_capture.cpp
+ * @brief RunAnywhere Commons - Native Microphone Capture Implementation
+ *
+ * AAudio is resolved with dlopen so the library still loads on Android 7,
+ * where capture falls back to the platform adapter (or NOT_SUPPORTED) and the
+ * app keeps its own recorder. Both backends end in deliver(), which converts
+ * to Float32 mono at the configured rate in scratch buffers sized at create
+ * time and calls back on the capture thread; nothing on that path locks or
+ * allocates.
+ *
+ * AAudio reports a disconnected device on its error callback, where the
+ * stream must not be closed, so a small service thread per capture reopens
+ * it.
+ */
+
+#include "rac/core/rac_audio_capture.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__ANDROID__)
+#include <dlfcn.h>
+#endif
+
+#include "rac/core/rac_audio_kernels.h"
+#include "rac/core/rac_logger.h"
+#include "rac/core/rac_platform_adapter.h"
+
+static const char* LOG_CAT = "AudioCapture";
+
+namespace {
+
+// Device frames converted per step, bounding the scratch buffers
+constexpr size_t kChunkFrames = 1024;
+// Device rates below this are dropped; sizes the resampler output
+constexpr int32_t kMinDeviceRate = 8000;
+
+/**
+ * Streaming linear interpolation between two rates. The read position is in
+ * source samples relative to the current block, with -1 standing for the last
+ * sample of the previous block, so consecutive blocks join seamlessly.
+ */
+class LinearResampler {
+   public:
+    void reset(int32_t in_rate, int32_t out_rate) {
+        in_rate_ = in_rate;
+        out_rate_ = out_rate;
+        step_ = static_cast<double>(in_rate) / out_rate;
+        pos_ = 0.0;
+        prev_ = 0.0f;
+    }
+
+    int32_t in_rate() const { return in_rate_; }
+    bool passthrough() const { return in_rate_ == out_rate_; }
+
+    // Output for count input samples is at most count / step + 2 samples
+    size_t process(const float* in, size_t count, float* out) {
+        if (count == 0) {
+            return 0;
+        }
+        size_t produced = 0;
+        const double end = static_cast<double>(count) - 1.0;
+        while (pos_ < end) {
+            const double base = std::floor(pos_);
+            const auto i = static_cast<ptrdiff_t>(base);
+            const float frac = static_cast<float>(pos_ - base);
+            const float a = i < 0 ? prev_ : in[i];
+            const float b = in[i + 1];
+            out[produced++] = a + (b - a) * frac;
+            pos_ += step_;
+        }
+        prev_ = in[count - 1];
+        pos_ -= static_cast<double>(count);
+        return produced;
+    }
+
+   private:
+    int32_t in_rate_ = 0;
+    int32_t out_rate_ = 0;
+    double step_ = 1.0;
+    double pos_ = 0.0;
+    float prev_ = 0.0f;
+};
+
+#if defined(__ANDROID__)
+// NDK AAudio API (API level 26), resolved at runtime so older releases load
+struct AAudioStreamBuilder;
+struct AAudioStream;
+using DataCallbackFn = int32_t (*)(AAudioStream*, void*, void*, int32_t);
+using ErrorCallbackFn = void (*)(AAudioStream*, void*, int32_t);
+
+// aaudio_* values from AAudio.h
+constexpr int32_t kAAudioOk = 0;
+constexpr int32_t kDirectionInput = 1;
+constexpr int32_t kFormatPcmI16 = 1;
+constexpr int32_t kFormatPcmFloat = 2;
+constexpr int32_t kSharingModeShared = 1;
+constexpr int32_t kPerformanceModeNone = 10;
+constexpr int32_t kPerformanceModeLowLatency = 12;
+constexpr int32_t kInputPresetVoiceRecognition = 6;
+constexpr int32_t kStreamStateStopping = 9;
+constexpr int32_t kCallbackResultContinue = 0;
+constexpr int32_t kCallbackResultStop = 1;
+constexpr int64_t kStopTimeoutNs = 200000000;
+
+struct AAudioApi {
+    bool loaded = false;
+    int32_t (*create_builder)(AAudioStreamBuilder**) = nullptr;
+    void (*set_direction)(AAudioStreamBuilder*, int32_t) = nullptr;
+    void (*set_sample_rate)(AAudioStreamBuilder*, int32_t) = nullptr;
+    void (*set_channel_count)(AAudioStreamBuilder*, int32_t) = nullptr;
+    void (*set_format)(AAudioStreamBuilder*, int32_t) = nullptr;
+    void (*set_sharing_mode)(AAudioStreamBuilder*, int32_t) = nullptr;
+    void (*set_performance_mode)(AAudioStreamBuilder*, int32_t) = nullptr;
+    void (*set_device_id)(AAudioStreamBuilder*, int32_t) = nullptr;
+    void (*set_frames_per_callback)(AAudioStreamBuilder*, int32_t) = nullptr;
+    void (*set_data_callback)(AAudioStreamBuilder*, DataCallbackFn, void*) = nullptr;
+    void (*set_error_callback)(AAudioStreamBuilder*, ErrorCallbackFn, void*) = nullptr;
+    // API level 28; NULL before
+    void (*set_input_preset)(AAudioStreamBuilder*, int32_t) = nullptr;
+    int32_t (*open_stream)(AAudioStreamBuilder*, AAudioStream**) = nullptr;
+    int32_t (*delete_builder)(AAudioStreamBuilder*) = nullptr;
+    int32_t (*request_start)(AAudioStream*) = nullptr;
+    int32_t (*request_stop)(AAudioStream*) = nullptr;
+    int32_t (*wait_for_state_change)(AAudioStream*, int32_t, int32_t*, int64_t) = nullptr;
+    int32_t (*close)(AAudioStream*) = nullptr;
+    int32_t (*get_sample_rate)(AAudioStream*) = nullptr;
+    int32_t (*get_channel_count)(AAudioStream*) = nullptr;
+    int32_t (*get_format)(AAudioStream*) = nullptr;
+    int32_t (*get_frames_per_burst)(AAudioStream*) = nullptr;
+    int32_t (*get_xrun_count)(AAudioStream*) = nullptr;
+    const char* (*result_to_text)(int32_t) = nullptr;
+};
+
+const AAudioApi& aaudio() {
+    static const AAudioApi api = [] {
+        AAudioApi a;
+        void* lib = dlopen("libaaudio.so", RTLD_NOW);
+        if (!lib) {
+            RAC_LOG_INFO(LOG_CAT, "AAudio unavailable");
+            return a;
+        }
+        bool complete = true;
+        auto bind = [&](auto& fn, const char* name, bool required) {
+            fn = reinterpret_cast<std::remove_reference_t<decltype(fn)>>(dlsym(lib, name));
+            complete = complete && (fn || !required);
+        };
+        bind(a.create_builder, "AAudio_createStreamBuilder", true);
+        bind(a.set_direction, "AAudioStreamBuilder_setDirection", true);
+        bind(a.set_sample_rate, "AAudioStreamBuilder_setSampleRate", true);
+        bind(a.set_channel_count, "AAudioStreamBuilder_setChannelCount", true);
+        bind(a.set_format, "AAudioStreamBuilder_setFormat", true);
+        bind(a.set_sharing_mode, "AAudioStreamBuilder_setSharingMode", true);
+        bind(a.set_performance_mode, "AAudioStreamBuilder_setPerformanceMode", true);
+        bind(a.set_device_id, "AAudioStreamBuilder_setDeviceId", true);
+        bind(a.set_frames_per_callback, "AAudioStreamBuilder_setFramesPerDataCallback", true);
+        bind(a.set_data_callback, "AAudioStreamBuilder_setDataCallback", true);
+        bind(a.set_error_callback, "AAudioStreamBuilder_setErrorCallback", true);
+        bind(a.set_input_preset, "AAudioStreamBuilder_setInputPreset", false);
+        bind(a.open_stream, "AAudioStreamBuilder_openStream", true);
+        bind(a.delete_builder, "AAudioStreamBuilder_delete", true);
+        bind(a.request_start, "AAudioStream_requestStart", true);
+        bind(a.request_stop, "AAudioStream_requestStop", true);
+        bind(a.wait_for_state_change, "AAudioStream_waitForStateChange", true);
+        bind(a.close, "AAudioStream_close", true);
+        bind(a.get_sample_rate, "AAudioStream_getSampleRate", true);
+        bind(a.get_channel_count, "AAudioStream_getChannelCount", true);
+        bind(a.get_format, "AAudioStream_getFormat", true);
+        bind(a.get_frames_per_burst, "AAudioStream_getFramesPerBurst", true);
+        bind(a.get_xrun_count, "AAudioStream_getXRunCount", true);
+        bind(a.result_to_text, "AAudio_convertResultToText", true);
+        a.loaded = complete;
+        RAC_LOG_INFO(LOG_CAT, "AAudio %s", complete ? "available" : "unavailable");
+        return a;
+    }();
+    return api;
+}
+#endif
+
+}  // namespace
+
+// =============================================================================
+// INTERNAL STRUCTURES
+// =============================================================================
+
+struct rac_audio_capture {
+    rac_audio_capture_config_t config = RAC_AUDIO_CAPTURE_CONFIG_DEFAULT;
+    rac_audio_capture_callback_fn callback = nullptr;
+    void* user_data = nullptr;
+
+    /** Start/stop and the open stream */
+    std::mutex mutex;
+    bool running = false;
+    rac_audio_capture_backend_t backend = RAC_AUDIO_CAPTURE_BACKEND_AUTO;
+
+    /** Whether device callbacks hand audio on; cleared before the device stops */
+    std::atomic<bool> delivering{false};
+
+    /** Conversion state, capture thread only */
+    LinearResampler resampler;
+    std::vector<float> mono;
+    std::vector<float> converted;
+
+    std::atomic<int32_t> device_sample_rate{0};
+    std::atomic<int32_t> burst_frames{0};
+    std::atomic<int64_t> samples_delivered{0};
+
+#if defined(__ANDROID__)
+    AAudioStream* stream = nullptr;
+    int32_t stream_rate = 0;
+    int32_t stream_channels = 1;
+    bool stream_int16 = false;
+    /** Overruns of streams closed by a reconnect */
+    int32_t xruns_before = 0;
+
+    /** Reopens the stream after a disconnect */
+    std::thread service;
+    std::mutex service_mtx;
+    std::condition_variable service_cv;
+    bool reopen_pending = false;
+    bool service_stop = false;
+#endif
+};
+
+// =============================================================================
+// CONVERSION
+// =============================================================================
+
+static void emit(rac_audio_capture* capture, const float* samples, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    capture->callback(samples, count, capture->user_data);
+    capture->samples_delivered.fetch_add(static_cast<int64_t>(count), std::memory_order_relaxed);
+}
+
+// Interleaved Float32 or Int16 device frames -> Float32 mono at the configured rate
+static void deliver(rac_audio_capture* capture, const void* data, size_t frames,
+                    int32_t channels, bool is_int16, int32_t rate) {
+    if (!data || frames == 0 || channels <= 0 || rate < kMinDeviceRate) {
+        return;
+    }
+    if (capture->resampler.in_rate() != rate) {
+        capture->resampler.reset(rate, capture->config.sample_rate);
+        capture->device_sample_rate.store(rate, std::memory_order_relaxed);
+    }
+
+    const auto stride = static_cast<size_t>(channels);
+    const float scale = 1.0f / static_cast<float>(channels);
+    for (size_t done = 0; done < frames;) {
+        const size_t n = std::min(kChunkFrames, frames - done);
+        const float* samples = nullptr;
+        if (channels == 1 && !is_int16) {
+            samples = static_cast<const float*>(data) + done;
+        } else if (channels == 1) {
+            rac_audio_int16_to_float(static_cast<const int16_t*>(data) + done,
+                                     capture->mono.data(), n);
+            samples = capture->mono.data();
+        } else {
+            float* out = capture->mono.data();
+            for (size_t i = 0; i < n; ++i) {
+                const size_t frame = (done + i) * stride;
+                float sum = 0.0f;
+                for (size_t c = 0; c < stride; ++c) {
+                    sum += is_int16
+                               ? static_cast<const int16_t*>(data)[frame + c] * (1.0f / 32768.0f)
+                               : static_cast<const float*>(data)[frame + c];
+                }
+                out[i] = sum * scale;
+            }
+            samples = out;
+        }
+
+        if (capture->resampler.passthrough()) {
+            emit(capture, samples, n);
+        } else {
+            emit(capture, capture->converted.data(),
+                 capture->resampler.process(samples, n, capture->converted.data()));
+        }
+        done += n;
+    }
+}
+
+// =============================================================================
+// AAUDIO BACKEND
+// =============================================================================
+
+#if defined(__ANDROID__)
+static int32_t aaudio_data_callback(AAudioStream* /*stream*/, void* user_data, void* audio,
+                                    int32_t num_frames) {
+    auto* capture = static_cast<rac_audio_capture*>(user_data);
+    if (!capture->delivering.load(std::memory_order_acquire)) {
+        return kCallbackResultStop;
+    }
+    deliver(capture, audio, static_cast<size_t>(std::max(num_frames, 0)),
+            capture->stream_channels, capture->stream_int16, capture->stream_rate);
+    return kCallbackResultContinue;
+}
+
+// The stream cannot be closed from here, so the service thread reopens it
+static void aaudio_error_callback(AAudioStream* /*stream*/, void* user_data, int32_t error) {
+    auto* capture = static_cast<rac_audio_capture*>(user_data);
+    RAC_LOG_WARNING(LOG_CAT, "AAudio input stream error: %s", aaudio().result_to_text(error));
+    {
+        std::lock_guard<std::mutex> lock(capture->service_mtx);
+        capture->reopen_pending = true;
+    }
+    capture->service_cv.notify_one();
+}
+
+// Called with capture->mutex held
+static rac_result_t aaudio_open_locked(rac_audio_capture* capture, bool reconnect) {
+    const AAudioApi& api = aaudio();
+    const rac_audio_capture_config_t& cfg = capture->config;
+
+    AAudioStreamBuilder* builder = nullptr;
+    if (api.create_builder(&builder) != kAAudioOk) {
+        return RAC_ERROR_AUDIO_SESSION_FAILED;
+    }
+    api.set_direction(builder, kDirectionInput);
+    api.set_sample_rate(builder, cfg.sample_rate);
+    api.set_channel_count(builder, 1);
+    api.set_format(builder, kFormatPcmFloat);
+    api.set_sharing_mode(builder, kSharingModeShared);
+    api.set_performance_mode(builder, cfg.low_latency == RAC_TRUE ? kPerformanceModeLowLatency
+                                                                  : kPerformanceModeNone);
+    // A reconnect follows the system default, the chosen device may be gone
+    if (cfg.device_id > 0 && !reconnect) {
+        api.set_device_id(builder, cfg.device_id);
+    }
+    if (cfg.frames_per_callback > 0) {
+        api.set_frames_per_callback(builder, cfg.frames_per_callback);
+    }
+    if (cfg.voice_recognition == RAC_TRUE && api.set_input_preset) {
+        api.set_input_preset(builder, kInputPresetVoiceRecognition);
+    }
+    api.set_data_callback(builder, aaudio_data_callback, capture);
+    api.set_error_callback(builder, aaudio_error_callback, capture);
+
+    AAudioStream* stream = nullptr;
+    int32_t result = api.open_stream(builder, &stream);
+    api.delete_builder(builder);
+    if (result != kAAudioOk) {
+        RAC_LOG_ERROR(LOG_CAT, "AAudio input stream failed to open: %s",
+                      api.result_to_text(result));
+        return RAC_ERROR_AUDIO_SESSION_FAILED;
+    }
+
+    const int32_t format = api.get_format(stream);
+    if (format != kFormatPcmFloat && format != kFormatPcmI16) {
+        RAC_LOG_ERROR(LOG_CAT, "AAudio input stream has unsupported format %d", format);
+        api.close(stream);
+        return RAC_ERROR_AUDIO_FORMAT_NOT_SUPPORTED;
+    }
+    // Read by the callback thread, which starts after this
+    capture->stream_rate = api.get_sample_rate(stream);
+    capture->stream_channels = api.get_channel_count(stream);
+    capture->stream_int16 = format == kFormatPcmI16;
+    capture->burst_frames.store(api.get_frames_per_burst(stream), std::memory_order_relaxed);
+
+    result = api.request_start(stream);
+    if (result != kAAudioOk) {
+        RAC_LOG_ERROR(LOG_CAT, "AAudio input stream failed to start: %s",
+                      api.result_to_text(result));
+        api.close(stream);
+        return RAC_ERROR_AUDIO_SESSION_FAILED;
+    }
+    capture->stream = stream;
+
+    RAC_LOG_INFO(LOG_CAT, "AAudio capture started: %d Hz, %d ch, %s, burst %d frames",
+                 capture->stream_rate, capture->stream_channels,
+                 capture->stream_int16 ? "i16" : "float", capture->burst_frames.load());
+    return RAC_SUCCESS;
+}
+
+// Called with capture->mutex held
+static void aaudio_close_locked(rac_audio_capture* capture) {
+    if (!capture->stream) {
+        return;
+    }
+    const AAudioApi& api = aaudio();
+    api.request_stop(capture->stream);
+    int32_t state = 0;
+    api.wait_for_state_change(capture->stream, kStreamStateStopping, &state, kStopTimeoutNs);
+    capture->xruns_before += std::max(api.get_xrun_count(capture->stream), 0);
+    api.close(capture->stream);
+    capture->stream = nullptr;
+}
+
+static void aaudio_service(rac_audio_capture* capture) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(capture->service_mtx);
+            capture->service_cv.wait(
+                lock, [capture] { return capture->service_stop || capture->reopen_pending; });
+            if (capture->service_stop) {
+                return;
+            }
+            capture->reopen_pending = false;
+        }
+
+        std::lock_guard<std::mutex> lock(capture->mutex);
+        if (!capture->running) {
+            continue;
+        }
+        aaudio_close_locked(capture);
+        if (aaudio_open_locked(capture, true) != RAC_SUCCESS) {
+            RAC_LOG_ERROR(LOG_CAT, "AAudio capture could not be reopened");
+        }
+    }
+}
+#endif
+
+// =============================================================================
+// PLATFORM ADAPTER BACKEND
+// =============================================================================
+
+static void platform_push(const float* samples, size_t num_samples, int32_t sample_rate,
+                          void* capture_context) {
+    auto* capture = static_cast<rac_audio_capture*>(capture_context);
+    if (!capture || !capture->delivering.load(std::memory_order_acquire)) {
+        return;
+    }
+    deliver(capture, samples, num_samples, 1, false, sample_rate);
+}
+
+static bool platform_capture_available(const rac_platform_adapter_t* adapter) {
+    return adapter && adapter->audio_capture_start && adapter->audio_capture_stop;
+}
+
+// =============================================================================
+// AUDIO CAPTURE API
+// =============================================================================
+
+extern "C" {
+
+rac_bool_t rac_audio_capture_is_available(void) {
+#if defined(__ANDROID__)
+    if (aaudio().loaded) {
+        return RAC_TRUE;
+    }
+#endif
+    return platform_capture_available(rac_get_platform_adapter()) ? RAC_TRUE : RAC_FALSE;
+}
+
+rac_result_t rac_audio_capture_create(const rac_audio_capture_config_t* config,
+                                      rac_audio_capture_callback_fn callback, void* user_data,
+                                      rac_audio_capture_handle_t* out_handle) {
+    if (!callback || !out_handle) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    const rac_audio_capture_config_t& cfg = config ? *config : RAC_AUDIO_CAPTURE_CONFIG_DEFAULT;
+    if (cfg.sample_rate < kMinDeviceRate || cfg.frames_per_callback < 0 || cfg.device_id < 0) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto* capture = new (std::nothrow) rac_audio_capture();
+    if (!capture) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    capture->config = cfg;
+    capture->callback = callback;
+    capture->user_data = user_data;
+    capture->mono.resize(kChunkFrames);
+    capture->converted.resize(kChunkFrames * static_cast<size_t>(cfg.sample_rate) /
+                                  static_cast<size_t>(kMinDeviceRate) +
+                              2);
+    *out_handle = capture;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_audio_capture_start(rac_audio_capture_handle_t handle) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    if (handle->running) {
+        return RAC_SUCCESS;
+    }
+
+    rac_audio_capture_backend_t backend = handle->config.backend;
+#if defined(__ANDROID__)
+    const bool have_aaudio = aaudio().loaded;
+#else
+    const bool have_aaudio = false;
+#endif
+    if (backend == RAC_AUDIO_CAPTURE_BACKEND_AUTO) {
+        backend = have_aaudio ? RAC_AUDIO_CAPTURE_BACKEND_AAUDIO
+                              : RAC_AUDIO_CAPTURE_BACKEND_PLATFORM;
+    }
+    const rac_platform_adapter_t* adapter = rac_get_platform_adapter();
+    if ((backend == RAC_AUDIO_CAPTURE_BACKEND_AAUDIO && !have_aaudio) ||
+        (backend == RAC_AUDIO_CAPTURE_BACKEND_PLATFORM && !platform_capture_available(adapter))) {
+        RAC_LOG_WARNING(LOG_CAT, "No native capture backend on this platform");
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+
+    handle->resampler = LinearResampler();
+    handle->device_sample_rate = 0;
+    handle->burst_frames = 0;
+    handle->samples_delivered = 0;
+    handle->delivering.store(true, std::memory_order_release);
+
+    rac_result_t result = RAC_ERROR_NOT_SUPPORTED;
+    if (backend == RAC_AUDIO_CAPTURE_BACKEND_PLATFORM) {
+        result = adapter->audio_capture_start(handle->config.sample_rate,
+                                              handle->config.frames_per_callback, platform_push,
+                                              handle, adapter->user_data);
+        if (result == RAC_SUCCESS) {
+            RAC_LOG_INFO(LOG_CAT, "Platform capture started");
+        } else {
+            RAC_LOG_ERROR(LOG_CAT, "Platform capture failed to start: %d", result);
+        }
+    }
+#if defined(__ANDROID__)
+    if (backend == RAC_AUDIO_CAPTURE_BACKEND_AAUDIO) {
+        handle->xruns_before = 0;
+        result = aaudio_open_locked(handle, false);
+        if (result == RAC_SUCCESS) {
+            handle->service_stop = false;
+            handle->reopen_pending = false;
+            handle->service = std::thread(aaudio_service, handle);
+        }
+    }
+#endif
+    if (result != RAC_SUCCESS) {
+        handle->delivering.store(false, std::memory_order_release);
+        return result;
+    }
+
+    handle->backend = backend;
+    handle->running = true;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_audio_capture_stop(rac_audio_capture_handle_t handle) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+
+#if defined(__ANDROID__)
+    // The service thread takes the capture mutex to reopen, so it is joined first
+    std::thread service;
+    {
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        if (!handle->running) {
+            return RAC_SUCCESS;
+        }
+        handle->running = false;
+        service = std::move(handle->service);
+    }
+    {
+        std::lock_guard<std::mutex> lock(handle->service_mtx);
+        handle->service_stop = true;
+    }
+    handle->service_cv.notify_one();
+    if (service.joinable()) {
+        service.join();
+    }
+    std::lock_guard<std::mutex> lock(handle->mutex);
+#else
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    if (!handle->running) {
+        return RAC_SUCCESS;
+    }
+    handle->running = false;
+#endif
+
+    handle->delivering.store(false, std::memory_order_release);
+    if (handle->backend == RAC_AUDIO_CAPTURE_BACKEND_PLATFORM) {
+        const rac_platform_adapter_t* adapter = rac_get_platform_adapter();
+        if (platform_capture_available(adapter)) {
+            adapter->audio_capture_stop(handle, adapter->user_data);
+        }
+    }
+#if defined(__ANDROID__)
+    if (handle->backend == RAC_AUDIO_CAPTURE_BACKEND_AAUDIO) {
+        aaudio_close_locked(handle);
+    }
+#endif
+
+    RAC_LOG_INFO(LOG_CAT, "Capture stopped after %lld samples",
+                 static_cast<long long>(handle->samples_delivered.load()));
+    handle->backend = RAC_AUDIO_CAPTURE_BACKEND_AUTO;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_audio_capture_get_stats(rac_audio_capture_handle_t handle,
+                                         rac_audio_capture_stats_t* out_stats) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_HANDLE;
+    }
+    if (!out_stats) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    out_stats->backend = handle->backend;
+    out_stats->device_sample_rate = handle->device_sample_rate.load(std::memory_order_relaxed);
+    out_stats->burst_frames = handle->burst_frames.load(std::memory_order_relaxed);
+    out_stats->samples_delivered = handle->samples_delivered.load(std::memory_order_relaxed);
+    out_stats->xruns = 0;
+#if defined(__ANDROID__)
+    out_stats->xruns = handle->xruns_before;
+    if (handle->stream) {
+        out_stats->xruns += std::max(aaudio().get_xrun_count(handle->stream), 0);
+    }
+#endif
+    return RAC_SUCCESS;
+}
+
+void rac_audio_capture_destroy(rac_audio_capture_handle_t handle) {
+    if (!handle) {
+        return;
+    }
+    rac_audio_capture_stop(handle);
+    delete handle;
+}
+
+}  // extern "C"
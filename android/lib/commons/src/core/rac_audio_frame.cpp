@@ -0,0 +1,200 @@
+/**
+ * @file rac_audio_frame.cpp
+ * @brief RunAnywhere Commons - Pooled Audio Frames Implementation
+ *
+ * Size classes are powers of two from 1024 samples. Each block is a 64-byte
+ * header followed by the samples; blocks of one class are cut from slabs of
+ * about 256 KB (one block per slab for the large classes) and recycled
+ * through a per-class intrusive free list.
+ */
+
+#include "rac/core/rac_audio_frame.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#include "rac/core/rac_logger.h"
+
+namespace {
+
+constexpr size_t kAlignment = 64;
+constexpr size_t kMinClassSamples = 1024;
+constexpr int32_t kNumClasses = 11;  // 1024 .. 1M samples
+constexpr int32_t kOversized = -1;
+constexpr size_t kSlabTargetBytes = 256 * 1024;
+
+}  // namespace
+
+struct alignas(kAlignment) rac_audio_frame {
+    std::atomic<int32_t> ref_count;
+    int32_t size_class;
+    size_t size;
+    rac_audio_frame* next_free;
+
+    float* data() { return reinterpret_cast<float*>(this + 1); }
+};
+static_assert(sizeof(rac_audio_frame) == kAlignment, "header must keep samples aligned");
+
+namespace {
+
+size_t class_samples(int32_t size_class) {
+    return kMinClassSamples << size_class;
+}
+
+size_t block_bytes(size_t samples) {
+    return sizeof(rac_audio_frame) + samples * sizeof(float);
+}
+
+int32_t class_for(size_t num_samples) {
+    for (int32_t c = 0; c < kNumClasses; ++c) {
+        if (num_samples <= class_samples(c)) {
+            return c;
+        }
+    }
+    return kOversized;
+}
+
+void* aligned_block(size_t bytes) {
+    void* memory = nullptr;
+    return posix_memalign(&memory, kAlignment, bytes) == 0 ? memory : nullptr;
+}
+
+class AudioFramePool {
+   public:
+    rac_audio_frame* acquire(size_t num_samples) {
+        int32_t size_class = class_for(num_samples);
+        rac_audio_frame* buffer = size_class == kOversized ? allocate_oversized(num_samples)
+                                                            : pop(size_class);
+        if (!buffer) {
+            return nullptr;
+        }
+        buffer->ref_count.store(1, std::memory_order_relaxed);
+        buffer->size = num_samples;
+        frames_in_use_.fetch_add(1, std::memory_order_relaxed);
+        return buffer;
+    }
+
+    void recycle(rac_audio_frame* buffer) {
+        frames_in_use_.fetch_sub(1, std::memory_order_relaxed);
+        if (buffer->size_class == kOversized) {
+            free(buffer);
+            return;
+        }
+        FreeList& list = lists_[buffer->size_class];
+        std::lock_guard<std::mutex> lock(list.mutex);
+        buffer->next_free = list.head;
+        list.head = buffer;
+    }
+
+    void get_stats(rac_audio_frame_pool_stats_t* out) {
+        out->slab_bytes = slab_bytes_.load(std::memory_order_relaxed);
+        out->frames_in_use = frames_in_use_.load(std::memory_order_relaxed);
+        out->slab_allocations = slab_allocations_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    struct FreeList {
+        std::mutex mutex;
+        rac_audio_frame* head = nullptr;
+    };
+
+    rac_audio_frame* pop(int32_t size_class) {
+        FreeList& list = lists_[size_class];
+        std::lock_guard<std::mutex> lock(list.mutex);
+        if (!list.head && !grow(size_class, list)) {
+            return nullptr;
+        }
+        rac_audio_frame* buffer = list.head;
+        list.head = buffer->next_free;
+        return buffer;
+    }
+
+    // Caller holds list.mutex
+    bool grow(int32_t size_class, FreeList& list) {
+        const size_t block = block_bytes(class_samples(size_class));
+        const size_t count = block >= kSlabTargetBytes ? 1 : kSlabTargetBytes / block;
+        auto* slab = static_cast<uint8_t*>(aligned_block(block * count));
+        if (!slab) {
+            RAC_LOG_ERROR("AudioFrame", "Failed to allocate %zu byte slab", block * count);
+            return false;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            auto* buffer = new (slab + i * block) rac_audio_frame();
+            buffer->size_class = size_class;
+            buffer->next_free = list.head;
+            list.head = buffer;
+        }
+        slab_bytes_.fetch_add(block * count, std::memory_order_relaxed);
+        slab_allocations_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    rac_audio_frame* allocate_oversized(size_t num_samples) {
+        void* memory = aligned_block(block_bytes(num_samples));
+        if (!memory) {
+            return nullptr;
+        }
+        auto* buffer = new (memory) rac_audio_frame();
+        buffer->size_class = kOversized;
+        buffer->next_free = nullptr;
+        return buffer;
+    }
+
+    FreeList lists_[kNumClasses];
+    std::atomic<size_t> slab_bytes_{0};
+    std::atomic<size_t> frames_in_use_{0};
+    std::atomic<size_t> slab_allocations_{0};
+};
+
+// Never destroyed, so buffers released during static destruction stay valid
+AudioFramePool& pool() {
+    static AudioFramePool* instance = new AudioFramePool();
+    return *instance;
+}
+
+}  // namespace
+
+extern "C" {
+
+rac_result_t rac_audio_frame_acquire(size_t num_samples, rac_audio_frame_t* out_buffer) {
+    if (!out_buffer) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    rac_audio_frame* buffer = pool().acquire(num_samples);
+    if (!buffer) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    *out_buffer = buffer;
+    return RAC_SUCCESS;
+}
+
+float* rac_audio_frame_data(rac_audio_frame_t buffer) {
+    return buffer ? buffer->data() : nullptr;
+}
+
+size_t rac_audio_frame_size(rac_audio_frame_t buffer) {
+    return buffer ? buffer->size : 0;
+}
+
+void rac_audio_frame_retain(rac_audio_frame_t buffer) {
+    if (buffer) {
+        buffer->ref_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void rac_audio_frame_release(rac_audio_frame_t buffer) {
+    if (buffer && buffer->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        pool().recycle(buffer);
+    }
+}
+
+void rac_audio_frame_pool_get_stats(rac_audio_frame_pool_stats_t* out_stats) {
+    if (out_stats) {
+        pool().get_stats(out_stats);
+    }
+}
+
+}  // extern "C"
@@ -0,0 +1,471 @@
+/**
+ * @file rac_audio_kernels.cpp
+ * @brief RunAnywhere Commons - Vectorised Audio Kernels Implementation
+ *
+ * NEON and SSE2 are part of the arm64 and x86-64 baselines, so they are
+ * selected at compile time. AVX2 is compiled with a target attribute and
+ * only used when the CPU reports it.
+ */
+
+#include "rac/core/rac_audio_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define RAC_KERNELS_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RAC_KERNELS_SSE2 1
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define RAC_KERNELS_AVX2 1
+#endif
+#endif
+
+#include "rac/core/rac_logger.h"
+
+namespace {
+
+struct KernelTable {
+    const char* isa;
+    float (*sum_squares)(const float*, size_t);
+    float (*dot)(const float*, const float*, size_t);
+    float (*peak)(const float*, size_t);
+    void (*float_to_int16)(const float*, int16_t*, size_t);
+    void (*int16_to_float)(const int16_t*, float*, size_t);
+    void (*apply_gain)(float*, size_t, float);
+    void (*mix)(float*, const float*, size_t, float);
+};
+
+constexpr float kInt16Scale = 32767.0f;
+constexpr float kInt16Inverse = 1.0f / 32768.0f;
+
+// =============================================================================
+// SCALAR REFERENCE
+// =============================================================================
+
+float scalar_sum_squares(const float* x, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        sum += x[i] * x[i];
+    }
+    return sum;
+}
+
+float scalar_dot(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+float scalar_peak(const float* x, size_t n) {
+    float peak = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        peak = std::max(peak, std::fabs(x[i]));
+    }
+    return peak;
+}
+
+void scalar_float_to_int16(const float* in, int16_t* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        float sample = std::max(-1.0f, std::min(1.0f, in[i]));
+        out[i] = static_cast<int16_t>(sample * kInt16Scale);
+    }
+}
+
+void scalar_int16_to_float(const int16_t* in, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<float>(in[i]) * kInt16Inverse;
+    }
+}
+
+void scalar_apply_gain(float* x, size_t n, float gain) {
+    for (size_t i = 0; i < n; ++i) {
+        x[i] *= gain;
+    }
+}
+
+void scalar_mix(float* dst, const float* src, size_t n, float gain) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+// =============================================================================
+// NEON
+// =============================================================================
+
+#if RAC_KERNELS_NEON
+
+float neon_sum_squares(const float* x, size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t a = vld1q_f32(x + i);
+        float32x4_t b = vld1q_f32(x + i + 4);
+        acc0 = vfmaq_f32(acc0, a, a);
+        acc1 = vfmaq_f32(acc1, b, b);
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1)) + scalar_sum_squares(x + i, n - i);
+}
+
+float neon_dot(const float* a, const float* b, size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1)) + scalar_dot(a + i, b + i, n - i);
+}
+
+float neon_peak(const float* x, size_t n) {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = vmaxq_f32(acc, vabsq_f32(vld1q_f32(x + i)));
+    }
+    return std::max(vmaxvq_f32(acc), scalar_peak(x + i, n - i));
+}
+
+void neon_float_to_int16(const float* in, int16_t* out, size_t n) {
+    const float32x4_t lo = vdupq_n_f32(-1.0f);
+    const float32x4_t hi = vdupq_n_f32(1.0f);
+    const float32x4_t scale = vdupq_n_f32(kInt16Scale);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t a = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(in + i), lo), hi), scale);
+        float32x4_t b = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(in + i + 4), lo), hi), scale);
+        int16x8_t packed = vcombine_s16(vqmovn_s32(vcvtq_s32_f32(a)), vqmovn_s32(vcvtq_s32_f32(b)));
+        vst1q_s16(out + i, packed);
+    }
+    scalar_float_to_int16(in + i, out + i, n - i);
+}
+
+void neon_int16_to_float(const int16_t* in, float* out, size_t n) {
+    const float32x4_t scale = vdupq_n_f32(kInt16Inverse);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t v = vld1q_s16(in + i);
+        vst1q_f32(out + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(out + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+    scalar_int16_to_float(in + i, out + i, n - i);
+}
+
+void neon_apply_gain(float* x, size_t n, float gain) {
+    const float32x4_t g = vdupq_n_f32(gain);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(x + i, vmulq_f32(vld1q_f32(x + i), g));
+    }
+    scalar_apply_gain(x + i, n - i, gain);
+}
+
+void neon_mix(float* dst, const float* src, size_t n, float gain) {
+    const float32x4_t g = vdupq_n_f32(gain);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        // Separate multiply and add (no fused vfmaq) to match the scalar rounding
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vmulq_f32(vld1q_f32(src + i), g)));
+    }
+    scalar_mix(dst + i, src + i, n - i, gain);
+}
+
+#endif  // RAC_KERNELS_NEON
+
+// =============================================================================
+// SSE2
+// =============================================================================
+
+#if RAC_KERNELS_SSE2
+
+float horizontal_sum(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+
+float horizontal_max(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 maxs = _mm_max_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, maxs);
+    return _mm_cvtss_f32(_mm_max_ss(maxs, shuf));
+}
+
+float sse2_sum_squares(const float* x, size_t n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_loadu_ps(x + i);
+        __m128 b = _mm_loadu_ps(x + i + 4);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+    }
+    return horizontal_sum(_mm_add_ps(acc0, acc1)) + scalar_sum_squares(x + i, n - i);
+}
+
+float sse2_dot(const float* a, const float* b, size_t n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    return horizontal_sum(_mm_add_ps(acc0, acc1)) + scalar_dot(a + i, b + i, n - i);
+}
+
+float sse2_peak(const float* x, size_t n) {
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 acc = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_max_ps(acc, _mm_and_ps(_mm_loadu_ps(x + i), abs_mask));
+    }
+    return std::max(horizontal_max(acc), scalar_peak(x + i, n - i));
+}
+
+void sse2_float_to_int16(const float* in, int16_t* out, size_t n) {
+    const __m128 lo = _mm_set1_ps(-1.0f);
+    const __m128 hi = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(kInt16Scale);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), lo), hi), scale);
+        __m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), lo), hi), scale);
+        __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+    scalar_float_to_int16(in + i, out + i, n - i);
+}
+
+void sse2_int16_to_float(const int16_t* in, float* out, size_t n) {
+    const __m128 scale = _mm_set1_ps(kInt16Inverse);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Sign-extend by placing each value in the high half and shifting down
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    scalar_int16_to_float(in + i, out + i, n - i);
+}
+
+void sse2_apply_gain(float* x, size_t n, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(x + i), g));
+    }
+    scalar_apply_gain(x + i, n - i, gain);
+}
+
+void sse2_mix(float* dst, const float* src, size_t n, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(dst + i,
+                      _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+    }
+    scalar_mix(dst + i, src + i, n - i, gain);
+}
+
+#endif  // RAC_KERNELS_SSE2
+
+// =============================================================================
+// AVX2
+// =============================================================================
+
+#if RAC_KERNELS_AVX2
+
+#define RAC_AVX2 __attribute__((target("avx2")))
+
+RAC_AVX2 float avx2_sum_squares(const float* x, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_loadu_ps(x + i);
+        __m256 b = _mm256_loadu_ps(x + i + 8);
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(a, a));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(b, b));
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    return horizontal_sum(half) + sse2_sum_squares(x + i, n - i);
+}
+
+RAC_AVX2 float avx2_dot(const float* a, const float* b, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        acc1 = _mm256_add_ps(acc1,
+                             _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    return horizontal_sum(half) + sse2_dot(a + i, b + i, n - i);
+}
+
+RAC_AVX2 float avx2_peak(const float* x, size_t n) {
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_max_ps(acc, _mm256_and_ps(_mm256_loadu_ps(x + i), abs_mask));
+    }
+    __m128 half = _mm_max_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    return std::max(horizontal_max(half), sse2_peak(x + i, n - i));
+}
+
+RAC_AVX2 void avx2_float_to_int16(const float* in, int16_t* out, size_t n) {
+    const __m256 lo = _mm256_set1_ps(-1.0f);
+    const __m256 hi = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(kInt16Scale);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + i), lo), hi), scale);
+        __m256 b =
+            _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + i + 8), lo), hi), scale);
+        // packs works per 128-bit lane; the permute restores sample order
+        __m256i packed = _mm256_packs_epi32(_mm256_cvttps_epi32(a), _mm256_cvttps_epi32(b));
+        packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+    sse2_float_to_int16(in + i, out + i, n - i);
+}
+
+RAC_AVX2 void avx2_int16_to_float(const int16_t* in, float* out, size_t n) {
+    const __m256 scale = _mm256_set1_ps(kInt16Inverse);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v)), scale));
+    }
+    scalar_int16_to_float(in + i, out + i, n - i);
+}
+
+RAC_AVX2 void avx2_apply_gain(float* x, size_t n, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), g));
+    }
+    scalar_apply_gain(x + i, n - i, gain);
+}
+
+RAC_AVX2 void avx2_mix(float* dst, const float* src, size_t n, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i),
+                                                _mm256_mul_ps(_mm256_loadu_ps(src + i), g)));
+    }
+    scalar_mix(dst + i, src + i, n - i, gain);
+}
+
+#undef RAC_AVX2
+
+#endif  // RAC_KERNELS_AVX2
+
+// =============================================================================
+// DISPATCH
+// =============================================================================
+
+KernelTable select_kernels() {
+#if RAC_KERNELS_NEON
+    KernelTable table = {"neon",          neon_sum_squares,    neon_dot,        neon_peak,
+                         neon_float_to_int16, neon_int16_to_float, neon_apply_gain, neon_mix};
+#elif RAC_KERNELS_SSE2
+    KernelTable table = {"sse2",          sse2_sum_squares,    sse2_dot,        sse2_peak,
+                         sse2_float_to_int16, sse2_int16_to_float, sse2_apply_gain, sse2_mix};
+#if RAC_KERNELS_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        table = {"avx2",          avx2_sum_squares,    avx2_dot,        avx2_peak,
+                 avx2_float_to_int16, avx2_int16_to_float, avx2_apply_gain, avx2_mix};
+    }
+#endif
+#else
+    KernelTable table = {"scalar",          scalar_sum_squares,    scalar_dot,
+                         scalar_peak,       scalar_float_to_int16, scalar_int16_to_float,
+                         scalar_apply_gain, scalar_mix};
+#endif
+    RAC_LOG_DEBUG("AudioKernels", "Using %s audio kernels", table.isa);
+    return table;
+}
+
+const KernelTable& kernels() {
+    static const KernelTable table = select_kernels();
+    return table;
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+float rac_audio_sum_squares(const float* samples, size_t count) {
+    return samples && count > 0 ? kernels().sum_squares(samples, count) : 0.0f;
+}
+
+float rac_audio_dot(const float* a, const float* b, size_t count) {
+    return a && b && count > 0 ? kernels().dot(a, b, count) : 0.0f;
+}
+
+float rac_audio_rms(const float* samples, size_t count) {
+    if (!samples || count == 0) {
+        return 0.0f;
+    }
+    return std::sqrt(kernels().sum_squares(samples, count) / static_cast<float>(count));
+}
+
+float rac_audio_peak(const float* samples, size_t count) {
+    return samples && count > 0 ? kernels().peak(samples, count) : 0.0f;
+}
+
+void rac_audio_float_to_int16(const float* input, int16_t* output, size_t count) {
+    if (input && output) {
+        kernels().float_to_int16(input, output, count);
+    }
+}
+
+void rac_audio_int16_to_float(const int16_t* input, float* output, size_t count) {
+    if (input && output) {
+        kernels().int16_to_float(input, output, count);
+    }
+}
+
+void rac_audio_apply_gain(float* samples, size_t count, float gain) {
+    if (samples) {
+        kernels().apply_gain(samples, count, gain);
+    }
+}
+
+void rac_audio_mix(float* dst, const float* src, size_t count, float gain) {
+    if (dst && src) {
+        kernels().mix(dst, src, count, gain);
+    }
+}
+
+const char* rac_audio_kernels_isa(void) {
+    return kernels().isa;
+}
+
+}  // extern "C"
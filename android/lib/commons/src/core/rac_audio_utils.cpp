@@ -8,10 +8,23 @@
 #include "rac/core/rac_audio_utils.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <cerrno>
 #include <cstring>
+#include <new>
+#include <numeric>
+#include <vector>
 
+#include <unistd.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_audio_kernels.h"
 #include "rac/core/rac_error.h"
 #include "rac/core/rac_logger.h"
 
@@ -20,6 +33,10 @@ static constexpr size_t WAV_HEADER_SIZE = 44;
 static constexpr uint16_t WAV_FORMAT_PCM = 1;
 static constexpr uint16_t WAV_CHANNELS_MONO = 1;
 static constexpr uint16_t WAV_BITS_PER_SAMPLE_16 = 16;
+// Largest data chunk whose RIFF size still fits in 32 bits
+static constexpr uint64_t WAV_MAX_DATA_SIZE = 0xFFFFFFFFull - (WAV_HEADER_SIZE - 8);
+// Data size written for streams whose length is not known yet
+static constexpr uint32_t WAV_STREAMING_DATA_SIZE = 0xFFFFFFFFu - (WAV_HEADER_SIZE - 8);
 
 /**
  * @brief Write a little-endian uint16_t to a buffer
@@ -131,7 +148,7 @@ rac_result_t rac_audio_float32_to_wav(const void* pcm_data, size_t pcm_size, int
     const size_t wav_size = WAV_HEADER_SIZE + int16_data_size;
 
     // Allocate output buffer
-    uint8_t* wav_data = static_cast<uint8_t*>(malloc(wav_size));
+    uint8_t* wav_data = static_cast<uint8_t*>(rac_alloc_tagged(RAC_ALLOC_TAG_AUDIO, wav_size));
     if (!wav_data) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
@@ -143,12 +160,8 @@ rac_result_t rac_audio_float32_to_wav(const void* pcm_data, size_t pcm_size, int
     const float* float_samples = static_cast<const float*>(pcm_data);
     int16_t* int16_samples = reinterpret_cast<int16_t*>(wav_data + WAV_HEADER_SIZE);
 
-    for (size_t i = 0; i < num_samples; ++i) {
-        // Clamp to [-1.0, 1.0] range
-        float sample = std::max(-1.0f, std::min(1.0f, float_samples[i]));
-        // Scale to Int16 range [-32768, 32767]
-        int16_samples[i] = static_cast<int16_t>(sample * 32767.0f);
-    }
+    // Clamps to [-1.0, 1.0] and scales to the Int16 range
+    rac_audio_float_to_int16(float_samples, int16_samples, num_samples);
 
     *out_wav_data = wav_data;
     *out_wav_size = wav_size;
@@ -178,7 +191,7 @@ rac_result_t rac_audio_int16_to_wav(const void* pcm_data, size_t pcm_size, int32
     const size_t wav_size = WAV_HEADER_SIZE + data_size;
 
     // Allocate output buffer
-    uint8_t* wav_data = static_cast<uint8_t*>(malloc(wav_size));
+    uint8_t* wav_data = static_cast<uint8_t*>(rac_alloc_tagged(RAC_ALLOC_TAG_AUDIO, wav_size));
     if (!wav_data) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
@@ -198,3 +211,497 @@ rac_result_t rac_audio_int16_to_wav(const void* pcm_data, size_t pcm_size, int32
 size_t rac_audio_wav_header_size(void) {
     return WAV_HEADER_SIZE;
 }
+
+// =============================================================================
+// STREAMING WAV WRITER
+// =============================================================================
+
+// Samples converted per write() on fd targets (buffer targets convert in place)
+static constexpr size_t WAV_WRITER_CHUNK_SAMPLES = 2048;
+
+struct rac_audio_wav_writer {
+    int32_t sample_rate;
+    uint64_t data_size;
+    bool finalized;
+
+    // Exactly one target: fd >= 0, or buffer
+    int fd;
+    off_t header_offset;  // -1 if the descriptor is not seekable
+    uint8_t* buffer;
+    size_t capacity;
+
+    int16_t scratch[WAV_WRITER_CHUNK_SAMPLES];
+};
+
+static bool write_all(int fd, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+static bool pwrite_all(int fd, const void* data, size_t size, off_t offset) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t written = pwrite(fd, bytes, size, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        offset += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+static rac_audio_wav_writer* new_wav_writer(int32_t sample_rate) {
+    auto* writer = new (std::nothrow) rac_audio_wav_writer();
+    if (writer) {
+        writer->sample_rate = sample_rate;
+        writer->data_size = 0;
+        writer->finalized = false;
+        writer->fd = -1;
+        writer->header_offset = -1;
+        writer->buffer = nullptr;
+        writer->capacity = 0;
+    }
+    return writer;
+}
+
+/**
+ * Check that num_samples more Int16 samples fit in the WAV and the target
+ */
+static rac_result_t reserve_wav_samples(const rac_audio_wav_writer* writer, size_t num_samples) {
+    if (writer->finalized) {
+        return RAC_ERROR_INVALID_STATE;
+    }
+    uint64_t new_size = writer->data_size + static_cast<uint64_t>(num_samples) * 2;
+    if (new_size > WAV_MAX_DATA_SIZE) {
+        return RAC_ERROR_BUFFER_TOO_SMALL;
+    }
+    if (writer->buffer && WAV_HEADER_SIZE + new_size > writer->capacity) {
+        return RAC_ERROR_BUFFER_TOO_SMALL;
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_audio_wav_writer_open_fd(int fd, int32_t sample_rate,
+                                          rac_audio_wav_writer_t* out_writer) {
+    if (fd < 0 || sample_rate <= 0 || !out_writer) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    rac_audio_wav_writer* writer = new_wav_writer(sample_rate);
+    if (!writer) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    writer->fd = fd;
+    writer->header_offset = lseek(fd, 0, SEEK_CUR);
+
+    uint8_t header[WAV_HEADER_SIZE];
+    build_wav_header(header, sample_rate, WAV_STREAMING_DATA_SIZE);
+    if (!write_all(fd, header, sizeof(header))) {
+        RAC_LOG_ERROR("AudioUtils", "Failed to write WAV header: %s", strerror(errno));
+        delete writer;
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+
+    *out_writer = writer;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_audio_wav_writer_open_buffer(void* buffer, size_t capacity, int32_t sample_rate,
+                                              rac_audio_wav_writer_t* out_writer) {
+    if (!buffer || capacity < WAV_HEADER_SIZE || sample_rate <= 0 || !out_writer) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    rac_audio_wav_writer* writer = new_wav_writer(sample_rate);
+    if (!writer) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    writer->buffer = static_cast<uint8_t*>(buffer);
+    writer->capacity = capacity;
+    build_wav_header(writer->buffer, sample_rate, WAV_STREAMING_DATA_SIZE);
+
+    *out_writer = writer;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_audio_wav_writer_append_float32(rac_audio_wav_writer_t writer,
+                                                 const float* samples, size_t num_samples) {
+    if (!writer || (!samples && num_samples > 0)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    rac_result_t result = reserve_wav_samples(writer, num_samples);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+
+    if (writer->buffer) {
+        int16_t* dst =
+            reinterpret_cast<int16_t*>(writer->buffer + WAV_HEADER_SIZE + writer->data_size);
+        rac_audio_float_to_int16(samples, dst, num_samples);
+    } else {
+        for (size_t done = 0; done < num_samples; done += WAV_WRITER_CHUNK_SAMPLES) {
+            size_t count = std::min(WAV_WRITER_CHUNK_SAMPLES, num_samples - done);
+            rac_audio_float_to_int16(samples + done, writer->scratch, count);
+            if (!write_all(writer->fd, writer->scratch, count * 2)) {
+                writer->data_size += done * 2;
+                return RAC_ERROR_FILE_WRITE_FAILED;
+            }
+        }
+    }
+
+    writer->data_size += static_cast<uint64_t>(num_samples) * 2;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_audio_wav_writer_append_int16(rac_audio_wav_writer_t writer,
+                                               const int16_t* samples, size_t num_samples) {
+    if (!writer || (!samples && num_samples > 0)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    rac_result_t result = reserve_wav_samples(writer, num_samples);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+
+    if (writer->buffer) {
+        memcpy(writer->buffer + WAV_HEADER_SIZE + writer->data_size, samples, num_samples * 2);
+    } else if (!write_all(writer->fd, samples, num_samples * 2)) {
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+
+    writer->data_size += static_cast<uint64_t>(num_samples) * 2;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_audio_wav_writer_finalize(rac_audio_wav_writer_t writer, size_t* out_wav_size) {
+    if (!writer) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!writer->finalized) {
+        uint8_t header[WAV_HEADER_SIZE];
+        build_wav_header(header, writer->sample_rate, static_cast<uint32_t>(writer->data_size));
+        if (writer->buffer) {
+            memcpy(writer->buffer, header, sizeof(header));
+        } else if (writer->header_offset >= 0 &&
+                   !pwrite_all(writer->fd, header, sizeof(header), writer->header_offset)) {
+            RAC_LOG_ERROR("AudioUtils", "Failed to update WAV header: %s", strerror(errno));
+            return RAC_ERROR_FILE_WRITE_FAILED;
+        }
+        writer->finalized = true;
+    }
+
+    if (out_wav_size) {
+        *out_wav_size = WAV_HEADER_SIZE + static_cast<size_t>(writer->data_size);
+    }
+    return RAC_SUCCESS;
+}
+
+void rac_audio_wav_writer_destroy(rac_audio_wav_writer_t writer) {
+    delete writer;
+}
+
+// =============================================================================
+// IMA-ADPCM CODEC
+// =============================================================================
+
+static constexpr int16_t ADPCM_STEP_TABLE[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,
+    25,    28,    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,
+    88,    97,    107,   118,   130,   143,   157,   173,   190,   209,   230,   253,   279,
+    307,   337,   371,   408,   449,   494,   544,   598,   658,   724,   796,   876,   963,
+    1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,  3327,
+    3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+static constexpr int8_t ADPCM_INDEX_TABLE[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+// Samples converted per pass through the Int16 kernels
+static constexpr size_t ADPCM_CHUNK_SAMPLES = 256;
+
+/**
+ * Apply a 4-bit code to the state; shared by encoder and decoder so both
+ * track exactly the same predictor
+ */
+static int16_t adpcm_step(rac_audio_adpcm_state_t* state, uint8_t code) {
+    int32_t step = ADPCM_STEP_TABLE[state->step_index];
+    int32_t delta = step >> 3;
+    if (code & 4) {
+        delta += step;
+    }
+    if (code & 2) {
+        delta += step >> 1;
+    }
+    if (code & 1) {
+        delta += step >> 2;
+    }
+    int32_t predictor = state->predictor + ((code & 8) ? -delta : delta);
+    state->predictor = std::max(-32768, std::min(32767, predictor));
+    state->step_index = std::max(0, std::min(88, state->step_index + ADPCM_INDEX_TABLE[code & 7]));
+    return static_cast<int16_t>(state->predictor);
+}
+
+static uint8_t adpcm_encode_sample(rac_audio_adpcm_state_t* state, int16_t sample) {
+    int32_t step = ADPCM_STEP_TABLE[state->step_index];
+    int32_t diff = sample - state->predictor;
+    uint8_t code = 0;
+    if (diff < 0) {
+        code = 8;
+        diff = -diff;
+    }
+    if (diff >= step) {
+        code |= 4;
+        diff -= step;
+    }
+    if (diff >= step >> 1) {
+        code |= 2;
+        diff -= step >> 1;
+    }
+    if (diff >= step >> 2) {
+        code |= 1;
+    }
+    adpcm_step(state, code);
+    return code;
+}
+
+size_t rac_audio_adpcm_encoded_size(size_t num_samples) {
+    return (num_samples + 1) / 2;
+}
+
+rac_result_t rac_audio_adpcm_encode(rac_audio_adpcm_state_t* state, const float* samples,
+                                    size_t num_samples, uint8_t* out_data) {
+    if (!state || (num_samples > 0 && (!samples || !out_data))) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    int16_t pcm[ADPCM_CHUNK_SAMPLES];
+    for (size_t done = 0; done < num_samples; done += ADPCM_CHUNK_SAMPLES) {
+        size_t count = std::min(ADPCM_CHUNK_SAMPLES, num_samples - done);
+        rac_audio_float_to_int16(samples + done, pcm, count);
+
+        // done is even, so every chunk starts on a byte boundary
+        uint8_t* out = out_data + done / 2;
+        for (size_t i = 0; i < count; i += 2) {
+            uint8_t low = adpcm_encode_sample(state, pcm[i]);
+            uint8_t high = i + 1 < count ? adpcm_encode_sample(state, pcm[i + 1]) : 0;
+            out[i / 2] = static_cast<uint8_t>(low | (high << 4));
+        }
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_audio_adpcm_decode(rac_audio_adpcm_state_t* state, const uint8_t* data,
+                                    size_t num_samples, float* out_samples) {
+    if (!state || (num_samples > 0 && (!data || !out_samples))) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    int16_t pcm[ADPCM_CHUNK_SAMPLES];
+    for (size_t done = 0; done < num_samples; done += ADPCM_CHUNK_SAMPLES) {
+        size_t count = std::min(ADPCM_CHUNK_SAMPLES, num_samples - done);
+        const uint8_t* in = data + done / 2;
+        for (size_t i = 0; i < count; i++) {
+            uint8_t byte = in[i / 2];
+            pcm[i] = adpcm_step(state, (i & 1) ? byte >> 4 : byte & 0x0F);
+        }
+        rac_audio_int16_to_float(pcm, out_samples + done, count);
+    }
+    return RAC_SUCCESS;
+}
+
+// =============================================================================
+// POLYPHASE RESAMPLER
+// =============================================================================
+
+// Filter length in samples of the lower rate; branches are longer when
+// downsampling so the transition band stays as narrow at the output
+static constexpr size_t RESAMPLER_TAPS = 72;
+static constexpr double RESAMPLER_KAISER_BETA = 7.0;
+// Cutoff as a fraction of the lower Nyquist: at 16 kHz the passband ends near
+// 7 kHz and the stopband starts at 8 kHz
+static constexpr double RESAMPLER_ROLLOFF = 0.94;
+
+/**
+ * Rational resampler by L/M. Output sample m sits at upsampled position
+ * j = m * M; it is the dot product of branch (j mod L) with the taps input
+ * samples ending at floor(j / L).
+ */
+struct rac_audio_resampler {
+    int32_t input_rate;
+    int32_t output_rate;
+    uint32_t up;    // L
+    uint32_t down;  // M
+    // Coefficients per branch (a multiple of 8 for the SIMD dot product)
+    size_t taps;
+    // up branches of taps coefficients, oldest sample first
+    std::vector<float> coeffs;
+    // Last taps-1 input samples followed by the current chunk
+    std::vector<float> work;
+    // Position of the next output: index into work, and branch
+    size_t pos;
+    uint32_t phase;
+};
+
+static double bessel_i0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+static float dot_taps(const float* a, const float* b, size_t taps) {
+#if defined(__ARM_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < taps; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1));
+#else
+    float acc[8] = {};
+    for (size_t i = 0; i < taps; i += 8) {
+        for (size_t j = 0; j < 8; j++) {
+            acc[j] += a[i + j] * b[i + j];
+        }
+    }
+    return ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+#endif
+}
+
+rac_result_t rac_audio_resampler_create(int32_t input_rate, int32_t output_rate,
+                                        rac_audio_resampler_t* out_resampler) {
+    if (input_rate <= 0 || output_rate <= 0 || !out_resampler) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto* r = new (std::nothrow) rac_audio_resampler();
+    if (!r) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    const int32_t g = std::gcd(input_rate, output_rate);
+    r->input_rate = input_rate;
+    r->output_rate = output_rate;
+    r->up = static_cast<uint32_t>(output_rate / g);
+    r->down = static_cast<uint32_t>(input_rate / g);
+
+    // Prototype low-pass at the upsampled rate, cut just below the lower Nyquist
+    const size_t taps = (RESAMPLER_TAPS * std::max(r->up, r->down) + r->up - 1) / r->up;
+    r->taps = (taps + 7) / 8 * 8;
+    const size_t n_total = r->taps * r->up;
+    const double cutoff = RESAMPLER_ROLLOFF * 0.5 / std::max(r->up, r->down);
+    const double center = (static_cast<double>(n_total) - 1.0) / 2.0;
+    const double i0_beta = bessel_i0(RESAMPLER_KAISER_BETA);
+    r->coeffs.resize(n_total);
+    for (uint32_t phase = 0; phase < r->up; phase++) {
+        double sum = 0.0;
+        float* branch = &r->coeffs[phase * r->taps];
+        for (size_t k = 0; k < r->taps; k++) {
+            const size_t n = phase + k * r->up;
+            const double t = static_cast<double>(n) - center;
+            const double sinc =
+                t == 0.0 ? 1.0 : std::sin(2.0 * M_PI * cutoff * t) / (2.0 * M_PI * cutoff * t);
+            const double ratio = t / (center + 1.0);
+            const double window = bessel_i0(RESAMPLER_KAISER_BETA * std::sqrt(1.0 - ratio * ratio)) / i0_beta;
+            const double h = sinc * window;
+            // Reversed so the branch lines up with input oldest-first
+            branch[r->taps - 1 - k] = static_cast<float>(h);
+            sum += h;
+        }
+        // Unity DC gain per branch
+        for (size_t k = 0; k < r->taps; k++) {
+            branch[k] = static_cast<float>(branch[k] / sum);
+        }
+    }
+
+    rac_audio_resampler_reset(r);
+    RAC_LOG_DEBUG("AudioUtils", "Resampler %d -> %d Hz (L=%u, M=%u)", input_rate, output_rate,
+                  r->up, r->down);
+    *out_resampler = r;
+    return RAC_SUCCESS;
+}
+
+size_t rac_audio_resampler_max_output(rac_audio_resampler_t resampler, size_t num_input) {
+    if (!resampler) {
+        return 0;
+    }
+    return (num_input + 1) * resampler->up / resampler->down + 1;
+}
+
+rac_result_t rac_audio_resampler_process(rac_audio_resampler_t resampler, const float* input,
+                                         size_t num_input, float* output, size_t output_capacity,
+                                         size_t* out_written) {
+    if (!resampler || (!input && num_input > 0) || !output || !out_written) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    auto* r = resampler;
+    *out_written = 0;
+
+    if (r->up == r->down) {
+        if (output_capacity < num_input) {
+            return RAC_ERROR_BUFFER_TOO_SMALL;
+        }
+        std::copy(input, input + num_input, output);
+        *out_written = num_input;
+        return RAC_SUCCESS;
+    }
+
+    // Capacity grows to the largest chunk once, then stays
+    const size_t history = r->taps - 1;
+    r->work.resize(history + num_input);
+    std::copy(input, input + num_input, r->work.begin() + static_cast<std::ptrdiff_t>(history));
+
+    size_t written = 0;
+    const float* work = r->work.data();
+    while (r->pos < r->work.size()) {
+        if (written == output_capacity) {
+            return RAC_ERROR_BUFFER_TOO_SMALL;
+        }
+        output[written++] =
+            dot_taps(&r->coeffs[r->phase * r->taps], work + r->pos - history, r->taps);
+        r->phase += r->down;
+        r->pos += r->phase / r->up;
+        r->phase %= r->up;
+    }
+
+    // Keep the tail as history for the next chunk
+    const size_t consumed = r->work.size() - history;
+    std::copy(r->work.end() - static_cast<std::ptrdiff_t>(history), r->work.end(), r->work.begin());
+    r->work.resize(history);
+    r->pos -= consumed;
+
+    *out_written = written;
+    return RAC_SUCCESS;
+}
+
+void rac_audio_resampler_reset(rac_audio_resampler_t resampler) {
+    if (!resampler) {
+        return;
+    }
+    resampler->work.assign(resampler->taps - 1, 0.0f);
+    resampler->pos = resampler->taps - 1;
+    resampler->phase = 0;
+}
+
+void rac_audio_resampler_destroy(rac_audio_resampler_t resampler) {
+    delete resampler;
+}
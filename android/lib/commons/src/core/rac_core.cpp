@@ -12,9 +12,11 @@
 #include <string>
 
 #include "rac/core/rac_error.h"
+#include "rac/core/rac_init_graph.h"
 #include "rac/core/rac_logger.h"
 #include "rac/core/rac_platform_adapter.h"
 #include "rac/core/rac_structured_error.h"
+#include "rac/core/rac_trace.h"
 #include "rac/infrastructure/device/rac_device_manager.h"
 #include "rac/infrastructure/model_management/rac_model_registry.h"
 
@@ -79,6 +81,19 @@ void rac_log(rac_log_level_t level, const char* category, const char* message) {
 // INITIALIZATION API
 // =============================================================================
 
+static rac_result_t init_model_registry(void* /*user_data*/) {
+    return rac_get_model_registry() != nullptr ? RAC_SUCCESS : RAC_ERROR_INITIALIZATION_FAILED;
+}
+
+// Built-in subsystems; rac_init itself only records configuration
+static void register_subsystems() {
+    rac_subsystem_desc_t registry = {};
+    registry.name = RAC_SUBSYSTEM_MODEL_REGISTRY;
+    registry.init = init_model_registry;
+    registry.start = RAC_SUBSYSTEM_START_BACKGROUND;
+    rac_init_graph_register(&registry);
+}
+
 rac_result_t rac_init(const rac_config_t* config) {
     std::lock_guard<std::mutex> lock(s_init_mutex);
 
@@ -102,6 +117,7 @@ rac_result_t rac_init(const rac_config_t* config) {
         s_log_tag = config->log_tag;
     }
 
+    register_subsystems();
     s_initialized.store(true);
 
     internal_log(RAC_LOG_INFO, "RunAnywhere Commons initialized");
@@ -216,6 +232,7 @@ rac_result_t rac_extract_archive(const char* archive_path, const char* destinati
         return RAC_ERROR_NOT_SUPPORTED;
     }
 
+    RAC_TRACE_SCOPE("Model.extract");
     return s_platform_adapter->extract_archive(archive_path, destination_dir, progress_callback,
                                                callback_user_data, s_platform_adapter->user_data);
 }
@@ -0,0 +1,321 @@
+/**
+ * @file rac_cpu_budget.cpp
+ * @brief RunAnywhere Commons - Shared CPU Budget Implementation
+ *
+ * Grants are recomputed under one mutex whenever a stage starts or stops and
+ * published through atomics, so backends can poll them per step. Cores are
+ * ordered fastest first (by cpufreq maximum, which separates big and little
+ * clusters) and handed out in priority order, so TTS lands on the big cores.
+ */
+
+#include "rac/core/rac_cpu_budget.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define RAC_CPU_BUDGET_HAS_AFFINITY 1
+#endif
+
+#include "rac/core/rac_logger.h"
+
+namespace {
+
+struct StageState {
+    int32_t holders = 0;
+    int32_t wanted = 0;  // largest request of the current holders, 0 = no limit
+    std::vector<int> cores;
+};
+
+struct CpuBudget {
+    std::mutex mtx;
+    rac_cpu_budget_config_t config = RAC_CPU_BUDGET_CONFIG_DEFAULT;
+    int32_t core_percent = 100;  // thermal limit (rac_thermal_governor.h)
+    std::vector<int> cores_by_speed;  // online cores, fastest first
+    StageState stages[RAC_CPU_STAGE_COUNT];
+    std::atomic<int32_t> threads[RAC_CPU_STAGE_COUNT] = {};
+};
+
+CpuBudget& budget() {
+    static CpuBudget instance;
+    return instance;
+}
+
+int online_cores() {
+#if defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n > 0) {
+        return static_cast<int>(n);
+    }
+#endif
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+long core_max_freq(int core) {
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", core);
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return 0;
+    }
+    long freq = 0;
+    if (fscanf(file, "%ld", &freq) != 1) {
+        freq = 0;
+    }
+    fclose(file);
+    return freq;
+}
+
+std::vector<int> detect_cores_by_speed() {
+    int count = online_cores();
+    std::vector<std::pair<long, int>> cores;
+    cores.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        cores.emplace_back(core_max_freq(i), i);
+    }
+    // Without cpufreq every core reads 0 and the index order is kept
+    std::stable_sort(cores.begin(), cores.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+    std::vector<int> ids;
+    ids.reserve(count);
+    for (const auto& core : cores) {
+        ids.push_back(core.second);
+    }
+    return ids;
+}
+
+// Caller holds b.mtx
+void rebalance_locked(CpuBudget& b) {
+    if (b.cores_by_speed.empty()) {
+        b.cores_by_speed = detect_cores_by_speed();
+    }
+    const size_t online = b.cores_by_speed.size();
+    int total = b.config.total_cores > 0 ? b.config.total_cores : static_cast<int>(online);
+    int available = std::max(1, total - std::max(0, b.config.reserved_cores));
+    available = std::max(1, (available * b.core_percent + 99) / 100);
+
+    int32_t grant[RAC_CPU_STAGE_COUNT] = {};
+    int remaining = available;
+
+    // Every active stage runs; one thread each comes first
+    for (int s = 0; s < RAC_CPU_STAGE_COUNT; ++s) {
+        if (b.stages[s].holders > 0) {
+            grant[s] = 1;
+            remaining--;
+        }
+    }
+    // Then the rest in priority order
+    for (int s = 0; s < RAC_CPU_STAGE_COUNT && remaining > 0; ++s) {
+        if (b.stages[s].holders == 0) {
+            continue;
+        }
+        int want = b.stages[s].wanted > 0 ? b.stages[s].wanted : available;
+        int extra = std::min(remaining, std::max(0, want - grant[s]));
+        grant[s] += extra;
+        remaining -= extra;
+    }
+
+    // Consecutive cores from the fastest; oversubscribed grants wrap around
+    const size_t pool = std::min(online, static_cast<size_t>(available));
+    size_t next = 0;
+    for (int s = 0; s < RAC_CPU_STAGE_COUNT; ++s) {
+        std::vector<int>& cores = b.stages[s].cores;
+        cores.clear();
+        for (int32_t i = 0; i < grant[s]; ++i) {
+            cores.push_back(b.cores_by_speed[next % pool]);
+            next++;
+        }
+        b.threads[s].store(grant[s]);
+    }
+
+    RAC_LOG_DEBUG("CpuBudget", "Rebalanced %d cores: tts=%d llm=%d stt=%d", available,
+                  grant[RAC_CPU_STAGE_TTS], grant[RAC_CPU_STAGE_LLM], grant[RAC_CPU_STAGE_STT]);
+}
+
+bool valid_stage(rac_cpu_stage_t stage) {
+    return stage >= 0 && stage < RAC_CPU_STAGE_COUNT;
+}
+
+#if defined(RAC_CPU_BUDGET_HAS_AFFINITY)
+// Nice value of ANDROID_PRIORITY_URGENT_AUDIO (system/core/libsystem)
+constexpr int kUrgentAudioNice = -19;
+
+bool set_realtime(int32_t fifo_priority) {
+    int lo = sched_get_priority_min(SCHED_FIFO);
+    int hi = sched_get_priority_max(SCHED_FIFO);
+    sched_param param = {};
+    param.sched_priority = std::min(std::max(static_cast<int>(fifo_priority), lo), hi);
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+}
+
+// Linux nice values are per thread when addressed by thread ID
+bool set_urgent_audio() {
+    const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    return setpriority(PRIO_PROCESS, tid, kUrgentAudioNice) == 0;
+}
+#endif
+
+}  // namespace
+
+extern "C" {
+
+rac_result_t rac_cpu_budget_configure(const rac_cpu_budget_config_t* config) {
+    const rac_cpu_budget_config_t& cfg = config ? *config : RAC_CPU_BUDGET_CONFIG_DEFAULT;
+    if (cfg.total_cores < 0 || cfg.reserved_cores < 0) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    CpuBudget& b = budget();
+    std::lock_guard<std::mutex> lock(b.mtx);
+    b.config = cfg;
+    rebalance_locked(b);
+    return RAC_SUCCESS;
+}
+
+int32_t rac_cpu_budget_acquire(rac_cpu_stage_t stage, int32_t wanted) {
+    if (!valid_stage(stage)) {
+        return std::max(1, wanted);
+    }
+
+    CpuBudget& b = budget();
+    std::lock_guard<std::mutex> lock(b.mtx);
+    StageState& state = b.stages[stage];
+    if (state.holders == 0 || wanted <= 0) {
+        state.wanted = std::max(0, wanted);
+    } else if (state.wanted > 0) {
+        state.wanted = std::max(state.wanted, wanted);
+    }
+    state.holders++;
+    rebalance_locked(b);
+    return b.threads[stage].load();
+}
+
+void rac_cpu_budget_release(rac_cpu_stage_t stage) {
+    if (!valid_stage(stage)) {
+        return;
+    }
+
+    CpuBudget& b = budget();
+    std::lock_guard<std::mutex> lock(b.mtx);
+    StageState& state = b.stages[stage];
+    if (state.holders == 0) {
+        RAC_LOG_WARNING("CpuBudget", "Release of inactive stage %d", static_cast<int>(stage));
+        return;
+    }
+    if (--state.holders == 0) {
+        state.wanted = 0;
+    }
+    rebalance_locked(b);
+}
+
+rac_result_t rac_cpu_budget_set_core_percent(int32_t percent) {
+    if (percent < 1 || percent > 100) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    CpuBudget& b = budget();
+    std::lock_guard<std::mutex> lock(b.mtx);
+    if (b.core_percent != percent) {
+        b.core_percent = percent;
+        rebalance_locked(b);
+    }
+    return RAC_SUCCESS;
+}
+
+int32_t rac_cpu_budget_threads(rac_cpu_stage_t stage) {
+    if (!valid_stage(stage)) {
+        return 0;
+    }
+    return budget().threads[stage].load(std::memory_order_relaxed);
+}
+
+rac_result_t rac_cpu_budget_bind_current_thread(rac_cpu_stage_t stage) {
+    if (!valid_stage(stage)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+#if defined(RAC_CPU_BUDGET_HAS_AFFINITY)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    {
+        CpuBudget& b = budget();
+        std::lock_guard<std::mutex> lock(b.mtx);
+        if (b.config.pin_threads != RAC_TRUE) {
+            return RAC_SUCCESS;
+        }
+        const std::vector<int>& cores = b.stages[stage].cores;
+        if (cores.empty()) {
+            return RAC_SUCCESS;
+        }
+        for (int core : cores) {
+            CPU_SET(core, &set);
+        }
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        RAC_LOG_WARNING("CpuBudget", "Could not bind thread to stage %d cores",
+                        static_cast<int>(stage));
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+    return RAC_SUCCESS;
+#else
+    return RAC_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+rac_result_t rac_cpu_budget_promote_audio_thread(const rac_audio_thread_config_t* config,
+                                                 rac_audio_thread_priority_t* out_applied) {
+    const rac_audio_thread_config_t& cfg = config ? *config : RAC_AUDIO_THREAD_CONFIG_DEFAULT;
+    if (out_applied) {
+        *out_applied = RAC_AUDIO_THREAD_PRIORITY_NORMAL;
+    }
+
+#if defined(RAC_CPU_BUDGET_HAS_AFFINITY)
+    if (cfg.pin_to_fast_core == RAC_TRUE) {
+        int core = 0;
+        {
+            CpuBudget& b = budget();
+            std::lock_guard<std::mutex> lock(b.mtx);
+            if (b.cores_by_speed.empty()) {
+                b.cores_by_speed = detect_cores_by_speed();
+            }
+            core = b.cores_by_speed.front();
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            RAC_LOG_WARNING("CpuBudget", "Could not bind audio thread to core %d", core);
+        }
+    }
+
+    // Apps usually lack the rights for SCHED_FIFO; fall back one level at a time
+    rac_audio_thread_priority_t applied = RAC_AUDIO_THREAD_PRIORITY_NORMAL;
+    if (cfg.priority >= RAC_AUDIO_THREAD_PRIORITY_REALTIME && set_realtime(cfg.fifo_priority)) {
+        applied = RAC_AUDIO_THREAD_PRIORITY_REALTIME;
+    } else if (cfg.priority >= RAC_AUDIO_THREAD_PRIORITY_URGENT_AUDIO && set_urgent_audio()) {
+        applied = RAC_AUDIO_THREAD_PRIORITY_URGENT_AUDIO;
+    }
+    if (out_applied) {
+        *out_applied = applied;
+    }
+    if (applied < cfg.priority) {
+        RAC_LOG_DEBUG("CpuBudget", "Audio thread priority %d requested, %d set",
+                      static_cast<int>(cfg.priority), static_cast<int>(applied));
+        return RAC_ERROR_PERMISSION_DENIED;
+    }
+    return RAC_SUCCESS;
+#else
+    return cfg.priority == RAC_AUDIO_THREAD_PRIORITY_NORMAL ? RAC_SUCCESS : RAC_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+}  // extern "C"
@@ -0,0 +1,189 @@
+/**
+ * @file rac_executor.cpp
+ * @brief RunAnywhere Commons - Native Request Executor
+ *
+ * The queue is a binary heap ordered by priority, then submission order.
+ * Workers are detached and start on demand up to the configured count; the
+ * executor itself is never destroyed, so workers can outlive static
+ * destruction at exit.
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "rac/core/rac_executor.h"
+#include "rac/core/rac_logger.h"
+
+static const char* LOG_CAT = "Executor";
+
+namespace {
+
+struct QueuedRequest {
+    rac_request_id_t id;
+    rac_request_t request;
+};
+
+// Heap order: higher priority first, then lower ID (= submitted earlier)
+bool runs_later(const QueuedRequest& a, const QueuedRequest& b) {
+    if (a.request.priority != b.request.priority) {
+        return a.request.priority < b.request.priority;
+    }
+    return a.id > b.id;
+}
+
+struct RunningRequest {
+    rac_request_t request;
+    bool cancelled;
+};
+
+struct Executor {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<QueuedRequest> queue;
+    std::unordered_map<rac_request_id_t, RunningRequest> running;
+    rac_request_id_t next_id = 1;
+    int32_t max_workers = RAC_EXECUTOR_DEFAULT_WORKERS;
+    int32_t workers = 0;
+    int32_t idle = 0;
+};
+
+Executor& executor() {
+    static Executor* instance = new Executor();
+    return *instance;
+}
+
+void worker_loop() {
+    auto& ex = executor();
+    std::unique_lock<std::mutex> lock(ex.mutex);
+    while (true) {
+        if (ex.queue.empty()) {
+            if (ex.workers > ex.max_workers) {
+                break;
+            }
+            ++ex.idle;
+            ex.cv.wait(lock);
+            --ex.idle;
+            continue;
+        }
+
+        std::pop_heap(ex.queue.begin(), ex.queue.end(), runs_later);
+        QueuedRequest next = ex.queue.back();
+        ex.queue.pop_back();
+        ex.running.emplace(next.id, RunningRequest{next.request, false});
+
+        lock.unlock();
+        next.request.run(next.id, next.request.user_data);
+        lock.lock();
+
+        // Once erased, cancel can no longer reach the hooks
+        ex.running.erase(next.id);
+        if (next.request.release != nullptr) {
+            lock.unlock();
+            next.request.release(next.id, RAC_TRUE, next.request.user_data);
+            lock.lock();
+        }
+    }
+    --ex.workers;
+}
+
+// Starts a worker unless an idle one can take the request about to be
+// queued; called with the lock held
+void ensure_worker(Executor& ex) {
+    if (ex.idle > static_cast<int32_t>(ex.queue.size()) || ex.workers >= ex.max_workers) {
+        return;
+    }
+    try {
+        std::thread(worker_loop).detach();
+        ++ex.workers;
+    } catch (const std::system_error& e) {
+        RAC_LOG_ERROR(LOG_CAT, "Failed to start executor worker: %s", e.what());
+    }
+}
+
+}  // namespace
+
+extern "C" {
+
+rac_result_t rac_executor_submit(const rac_request_t* request, rac_request_id_t* out_id) {
+    if (request == nullptr || request->run == nullptr || out_id == nullptr) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto& ex = executor();
+    std::lock_guard<std::mutex> lock(ex.mutex);
+    ensure_worker(ex);
+    if (ex.workers == 0) {
+        return RAC_ERROR_INITIALIZATION_FAILED;
+    }
+
+    const rac_request_id_t id = ex.next_id++;
+    ex.queue.push_back(QueuedRequest{id, *request});
+    std::push_heap(ex.queue.begin(), ex.queue.end(), runs_later);
+    ex.cv.notify_one();
+
+    *out_id = id;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_executor_cancel(rac_request_id_t id) {
+    auto& ex = executor();
+    std::unique_lock<std::mutex> lock(ex.mutex);
+
+    auto queued = std::find_if(ex.queue.begin(), ex.queue.end(),
+                               [id](const QueuedRequest& entry) { return entry.id == id; });
+    if (queued != ex.queue.end()) {
+        rac_request_t request = queued->request;
+        ex.queue.erase(queued);
+        std::make_heap(ex.queue.begin(), ex.queue.end(), runs_later);
+        lock.unlock();
+        if (request.release != nullptr) {
+            request.release(id, RAC_FALSE, request.user_data);
+        }
+        return RAC_SUCCESS;
+    }
+
+    auto running = ex.running.find(id);
+    if (running == ex.running.end()) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+    if (!running->second.cancelled) {
+        running->second.cancelled = true;
+        const rac_request_t& request = running->second.request;
+        if (request.cancel != nullptr) {
+            request.cancel(id, request.user_data);
+        }
+    }
+    return RAC_SUCCESS;
+}
+
+rac_bool_t rac_executor_is_cancelled(rac_request_id_t id) {
+    auto& ex = executor();
+    std::lock_guard<std::mutex> lock(ex.mutex);
+    auto running = ex.running.find(id);
+    return running != ex.running.end() && running->second.cancelled ? RAC_TRUE : RAC_FALSE;
+}
+
+rac_result_t rac_executor_set_workers(int32_t count) {
+    if (count < 1) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    auto& ex = executor();
+    std::lock_guard<std::mutex> lock(ex.mutex);
+    ex.max_workers = count;
+    // Idle surplus workers wake up and exit
+    ex.cv.notify_all();
+    return RAC_SUCCESS;
+}
+
+int32_t rac_executor_queued_count(void) {
+    auto& ex = executor();
+    std::lock_guard<std::mutex> lock(ex.mutex);
+    return static_cast<int32_t>(ex.queue.size());
+}
+
+}  // extern "C"
@@ -0,0 +1,357 @@
+/**
+ * @file rac_image_kernels.cpp
+ * @brief RunAnywhere Commons - Vectorised Image Kernels Implementation
+ *
+ * NEON and SSE2 are part of the arm64 and x86-64 baselines, so they are
+ * selected at compile time. The SSSE3 channel shuffles are compiled with a
+ * target attribute and only used when the CPU reports them.
+ */
+
+#include "rac/core/rac_image_kernels.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define RAC_KERNELS_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RAC_KERNELS_SSE2 1
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <tmmintrin.h>
+#define RAC_KERNELS_SSSE3 1
+#endif
+#endif
+
+#include "rac/core/rac_logger.h"
+
+namespace {
+
+struct KernelTable {
+    const char* isa;
+    // 4-byte pixels to packed RGB
+    void (*rgba_to_rgb)(const uint8_t*, size_t, uint8_t*);
+    void (*bgra_to_rgb)(const uint8_t*, size_t, uint8_t*);
+    // acc[i] += src[i]
+    void (*accumulate)(const uint8_t*, uint16_t*, size_t);
+};
+
+// Rows summed per block stay within uint16 (255 * 257 = 65535)
+constexpr int kMaxBoxRows = 257;
+
+// =============================================================================
+// SCALAR REFERENCE
+// =============================================================================
+
+void scalar_rgba_to_rgb(const uint8_t* src, size_t n, uint8_t* dst) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i * 3] = src[i * 4];
+        dst[i * 3 + 1] = src[i * 4 + 1];
+        dst[i * 3 + 2] = src[i * 4 + 2];
+    }
+}
+
+void scalar_bgra_to_rgb(const uint8_t* src, size_t n, uint8_t* dst) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i * 3] = src[i * 4 + 2];
+        dst[i * 3 + 1] = src[i * 4 + 1];
+        dst[i * 3 + 2] = src[i * 4];
+    }
+}
+
+void scalar_accumulate(const uint8_t* src, uint16_t* acc, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        acc[i] = static_cast<uint16_t>(acc[i] + src[i]);
+    }
+}
+
+// =============================================================================
+// NEON
+// =============================================================================
+
+#if RAC_KERNELS_NEON
+
+void neon_rgba_to_rgb(const uint8_t* src, size_t n, uint8_t* dst) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16x4_t px = vld4q_u8(src + i * 4);
+        uint8x16x3_t rgb = {{px.val[0], px.val[1], px.val[2]}};
+        vst3q_u8(dst + i * 3, rgb);
+    }
+    scalar_rgba_to_rgb(src + i * 4, n - i, dst + i * 3);
+}
+
+void neon_bgra_to_rgb(const uint8_t* src, size_t n, uint8_t* dst) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16x4_t px = vld4q_u8(src + i * 4);
+        uint8x16x3_t rgb = {{px.val[2], px.val[1], px.val[0]}};
+        vst3q_u8(dst + i * 3, rgb);
+    }
+    scalar_bgra_to_rgb(src + i * 4, n - i, dst + i * 3);
+}
+
+void neon_accumulate(const uint8_t* src, uint16_t* acc, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        vst1q_u16(acc + i, vaddw_u8(vld1q_u16(acc + i), vget_low_u8(v)));
+        vst1q_u16(acc + i + 8, vaddw_high_u8(vld1q_u16(acc + i + 8), v));
+    }
+    scalar_accumulate(src + i, acc + i, n - i);
+}
+
+#endif  // RAC_KERNELS_NEON
+
+// =============================================================================
+// SSE2
+// =============================================================================
+
+#if RAC_KERNELS_SSE2
+
+void sse2_accumulate(const uint8_t* src, uint16_t* acc, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i* lo = reinterpret_cast<__m128i*>(acc + i);
+        __m128i* hi = reinterpret_cast<__m128i*>(acc + i + 8);
+        _mm_storeu_si128(lo, _mm_add_epi16(_mm_loadu_si128(lo), _mm_unpacklo_epi8(v, zero)));
+        _mm_storeu_si128(hi, _mm_add_epi16(_mm_loadu_si128(hi), _mm_unpackhi_epi8(v, zero)));
+    }
+    scalar_accumulate(src + i, acc + i, n - i);
+}
+
+#endif  // RAC_KERNELS_SSE2
+
+// =============================================================================
+// SSSE3
+// =============================================================================
+
+#if RAC_KERNELS_SSSE3
+
+#define RAC_SSSE3 __attribute__((target("ssse3")))
+
+// Each step packs 4 pixels into the low 12 bytes of a 16-byte store; the
+// next step overwrites the 4 spare bytes, and the last pixels go scalar so
+// no store runs past the output.
+RAC_SSSE3 void shuffle_to_rgb(const uint8_t* src, size_t n, uint8_t* dst, __m128i mask,
+                              void (*tail)(const uint8_t*, size_t, uint8_t*)) {
+    size_t i = 0;
+    for (; i + 6 <= n; i += 4) {
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3), _mm_shuffle_epi8(px, mask));
+    }
+    tail(src + i * 4, n - i, dst + i * 3);
+}
+
+RAC_SSSE3 void ssse3_rgba_to_rgb(const uint8_t* src, size_t n, uint8_t* dst) {
+    const __m128i mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    shuffle_to_rgb(src, n, dst, mask, scalar_rgba_to_rgb);
+}
+
+RAC_SSSE3 void ssse3_bgra_to_rgb(const uint8_t* src, size_t n, uint8_t* dst) {
+    const __m128i mask = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    shuffle_to_rgb(src, n, dst, mask, scalar_bgra_to_rgb);
+}
+
+#undef RAC_SSSE3
+
+#endif  // RAC_KERNELS_SSSE3
+
+// =============================================================================
+// DISPATCH
+// =============================================================================
+
+KernelTable select_kernels() {
+#if RAC_KERNELS_NEON
+    KernelTable table = {"neon", neon_rgba_to_rgb, neon_bgra_to_rgb, neon_accumulate};
+#elif RAC_KERNELS_SSE2
+    KernelTable table = {"sse2", scalar_rgba_to_rgb, scalar_bgra_to_rgb, sse2_accumulate};
+#if RAC_KERNELS_SSSE3
+    if (__builtin_cpu_supports("ssse3")) {
+        table = {"ssse3", ssse3_rgba_to_rgb, ssse3_bgra_to_rgb, sse2_accumulate};
+    }
+#endif
+#else
+    KernelTable table = {"scalar", scalar_rgba_to_rgb, scalar_bgra_to_rgb, scalar_accumulate};
+#endif
+    RAC_LOG_DEBUG("ImageKernels", "Using %s image kernels", table.isa);
+    return table;
+}
+
+const KernelTable& kernels() {
+    static const KernelTable table = select_kernels();
+    return table;
+}
+
+// =============================================================================
+// RESAMPLING
+// =============================================================================
+
+// RGB of the first n pixels of a source row: the row itself for RGB8,
+// otherwise converted into scratch
+const uint8_t* rgb_row(const uint8_t* src, size_t n, rac_image_format_t format, uint8_t* scratch) {
+    switch (format) {
+        case RAC_IMAGE_FORMAT_RGBA8:
+            kernels().rgba_to_rgb(src, n, scratch);
+            return scratch;
+        case RAC_IMAGE_FORMAT_BGRA8:
+            kernels().bgra_to_rgb(src, n, scratch);
+            return scratch;
+        default:
+            return src;
+    }
+}
+
+// Source pixel pair and 8-bit weight of the second, per output coordinate
+struct Tap {
+    int32_t i0;
+    int32_t i1;
+    uint32_t w1;
+};
+
+std::vector<Tap> bilinear_taps(int32_t src_size, int32_t dst_size) {
+    std::vector<Tap> taps(static_cast<size_t>(dst_size));
+    const double scale = static_cast<double>(src_size) / dst_size;
+    for (int32_t i = 0; i < dst_size; ++i) {
+        double s = (i + 0.5) * scale - 0.5;
+        s = std::max(0.0, std::min(s, static_cast<double>(src_size - 1)));
+        const int32_t i0 = static_cast<int32_t>(s);
+        taps[static_cast<size_t>(i)] = {i0, std::min(i0 + 1, src_size - 1),
+                                        static_cast<uint32_t>((s - i0) * 256.0 + 0.5)};
+    }
+    return taps;
+}
+
+void bilinear_rgb(const uint8_t* src, int32_t sw, int32_t sh, uint8_t* dst, int32_t dw,
+                  int32_t dh) {
+    const std::vector<Tap> xs = bilinear_taps(sw, dw);
+    const std::vector<Tap> ys = bilinear_taps(sh, dh);
+    const size_t src_row = static_cast<size_t>(sw) * 3;
+    for (int32_t y = 0; y < dh; ++y) {
+        const Tap& ty = ys[static_cast<size_t>(y)];
+        const uint8_t* r0 = src + static_cast<size_t>(ty.i0) * src_row;
+        const uint8_t* r1 = src + static_cast<size_t>(ty.i1) * src_row;
+        uint8_t* out = dst + static_cast<size_t>(y) * dw * 3;
+        for (int32_t x = 0; x < dw; ++x) {
+            const Tap& tx = xs[static_cast<size_t>(x)];
+            const size_t a = static_cast<size_t>(tx.i0) * 3;
+            const size_t b = static_cast<size_t>(tx.i1) * 3;
+            for (int c = 0; c < 3; ++c) {
+                const uint32_t top = r0[a + c] * (256 - tx.w1) + r0[b + c] * tx.w1;
+                const uint32_t bottom = r1[a + c] * (256 - tx.w1) + r1[b + c] * tx.w1;
+                out[x * 3 + c] =
+                    static_cast<uint8_t>((top * (256 - ty.w1) + bottom * ty.w1 + 32768) >> 16);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+void rac_image_fit_size(int32_t width, int32_t height, int32_t max_edge, int32_t* out_width,
+                        int32_t* out_height) {
+    int32_t w = width;
+    int32_t h = height;
+    const int32_t edge = std::max(width, height);
+    if (max_edge > 0 && edge > max_edge) {
+        w = std::max(1, static_cast<int32_t>((static_cast<int64_t>(width) * max_edge + edge / 2) /
+                                             edge));
+        h = std::max(1, static_cast<int32_t>((static_cast<int64_t>(height) * max_edge + edge / 2) /
+                                             edge));
+    }
+    if (out_width) {
+        *out_width = w;
+    }
+    if (out_height) {
+        *out_height = h;
+    }
+}
+
+rac_result_t rac_image_to_rgb(const rac_image_t* image, int32_t out_width, int32_t out_height,
+                              uint8_t* out_rgb) {
+    if (!image || !image->data || !out_rgb) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    if (image->width <= 0 || image->height <= 0 || out_width <= 0 || out_height <= 0 ||
+        image->format < RAC_IMAGE_FORMAT_RGB8 || image->format > RAC_IMAGE_FORMAT_BGRA8) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    const size_t bpp = image->format == RAC_IMAGE_FORMAT_RGB8 ? 3 : 4;
+    const size_t packed = static_cast<size_t>(image->width) * bpp;
+    const size_t stride = image->stride > 0 ? static_cast<size_t>(image->stride) : packed;
+    if (stride < packed) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Whole kx * ky blocks average into one pixel; bilinear covers the rest
+    const int32_t kx = std::max(1, image->width / out_width);
+    const int32_t ky = std::max(1, std::min(image->height / out_height, kMaxBoxRows));
+    const int32_t rw = image->width / kx;
+    const int32_t rh = image->height / ky;
+    const size_t used = static_cast<size_t>(rw) * kx;  // source pixels per row that are read
+    const bool exact = rw == out_width && rh == out_height;
+
+    std::vector<uint8_t> reduced;
+    if (!exact) {
+        reduced.resize(static_cast<size_t>(rw) * rh * 3);
+    }
+    uint8_t* boxed = exact ? out_rgb : reduced.data();
+
+    std::vector<uint8_t> scratch(bpp == 4 ? used * 3 : 0);
+    std::vector<uint16_t> acc;
+    if (kx > 1 || ky > 1) {
+        acc.resize(used * 3);
+    }
+    const uint32_t area = static_cast<uint32_t>(kx) * static_cast<uint32_t>(ky);
+
+    for (int32_t ry = 0; ry < rh; ++ry) {
+        uint8_t* dst = boxed + static_cast<size_t>(ry) * rw * 3;
+        const uint8_t* first = image->data + static_cast<size_t>(ry) * ky * stride;
+        if (acc.empty()) {
+            const uint8_t* rgb = rgb_row(first, used, image->format, dst);
+            if (rgb != dst) {
+                memcpy(dst, rgb, used * 3);
+            }
+            continue;
+        }
+
+        std::fill(acc.begin(), acc.end(), 0);
+        for (int32_t k = 0; k < ky; ++k) {
+            const uint8_t* rgb = rgb_row(first + static_cast<size_t>(k) * stride, used,
+                                         image->format, scratch.data());
+            kernels().accumulate(rgb, acc.data(), used * 3);
+        }
+        for (int32_t x = 0; x < rw; ++x) {
+            const uint16_t* block = acc.data() + static_cast<size_t>(x) * kx * 3;
+            for (int c = 0; c < 3; ++c) {
+                uint32_t sum = 0;
+                for (int32_t j = 0; j < kx; ++j) {
+                    sum += block[j * 3 + c];
+                }
+                dst[x * 3 + c] = static_cast<uint8_t>((sum + area / 2) / area);
+            }
+        }
+    }
+
+    if (!exact) {
+        bilinear_rgb(reduced.data(), rw, rh, out_rgb, out_width, out_height);
+    }
+    return RAC_SUCCESS;
+}
+
+const char* rac_image_kernels_isa(void) {
+    return kernels().isa;
+}
+
+}  // extern "C"
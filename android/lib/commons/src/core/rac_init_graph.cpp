@@ -0,0 +1,283 @@
+/**
+ * @file rac_init_graph.cpp
+ * @brief RunAnywhere Commons - Lazy Initialization Graph Implementation
+ *
+ * Nodes are kept in registration order, which is a topological order since
+ * dependencies must exist before their dependents. Nodes are never removed,
+ * so indices stay valid without the lock. A node moves from pending to
+ * running to done under the graph mutex; its init function runs without it,
+ * and concurrent requirers wait on the condition variable.
+ */
+
+#include "rac/core/rac_init_graph.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rac/core/rac_executor.h"
+#include "rac/core/rac_logger.h"
+
+namespace rac::events {
+void emit_sdk_init_completed(double duration_ms, const char* subsystem);
+void emit_sdk_init_failed(rac_result_t error_code, const char* error_message,
+                          const char* subsystem);
+}  // namespace rac::events
+
+static const char* LOG_CAT = "InitGraph";
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum class NodeState { kPending, kRunning, kDone };
+
+struct Node {
+    std::string name;
+    std::vector<size_t> dependencies;
+    rac_subsystem_init_fn init = nullptr;
+    void* user_data = nullptr;
+    rac_subsystem_start_t start = RAC_SUBSYSTEM_START_ON_FIRST_USE;
+
+    NodeState state = NodeState::kPending;
+    std::thread::id runner;
+    rac_result_t result = RAC_SUCCESS;
+    double init_ms = 0.0;
+};
+
+struct Graph {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::unique_ptr<Node>> nodes;
+    Clock::time_point created = Clock::now();
+    bool background_queued = false;
+    bool background_reported = false;
+};
+
+Graph& graph() {
+    static Graph instance;
+    return instance;
+}
+
+double elapsed_ms(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+// Caller holds g.mutex
+int find_locked(const Graph& g, const char* name) {
+    for (size_t i = 0; i < g.nodes.size(); ++i) {
+        if (g.nodes[i]->name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+rac_result_t require_node(Graph& g, size_t index) {
+    Node* node;
+    std::vector<size_t> dependencies;
+    {
+        std::unique_lock<std::mutex> lock(g.mutex);
+        node = g.nodes[index].get();
+        if (node->state == NodeState::kDone) {
+            return node->result;
+        }
+        if (node->state == NodeState::kRunning && node->runner == std::this_thread::get_id()) {
+            RAC_LOG_ERROR(LOG_CAT, "%s requires itself while initializing", node->name.c_str());
+            return RAC_ERROR_INVALID_STATE;
+        }
+        dependencies = node->dependencies;
+    }
+
+    for (size_t dependency : dependencies) {
+        const rac_result_t result = require_node(g, dependency);
+        if (result != RAC_SUCCESS) {
+            return result;
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(g.mutex);
+        g.cv.wait(lock, [node] { return node->state != NodeState::kRunning; });
+        if (node->state == NodeState::kDone) {
+            return node->result;
+        }
+        node->state = NodeState::kRunning;
+        node->runner = std::this_thread::get_id();
+    }
+
+    const Clock::time_point start = Clock::now();
+    const rac_result_t result = node->init ? node->init(node->user_data) : RAC_SUCCESS;
+    const double init_ms = elapsed_ms(start);
+
+    {
+        std::lock_guard<std::mutex> lock(g.mutex);
+        node->state = NodeState::kDone;
+        node->result = result;
+        node->init_ms = init_ms;
+    }
+    g.cv.notify_all();
+
+    if (result == RAC_SUCCESS) {
+        RAC_LOG_DEBUG(LOG_CAT, "%s initialized in %.1f ms", node->name.c_str(), init_ms);
+        rac::events::emit_sdk_init_completed(init_ms, node->name.c_str());
+    } else {
+        RAC_LOG_ERROR(LOG_CAT, "%s failed to initialize (%d)", node->name.c_str(), result);
+        rac::events::emit_sdk_init_failed(result, "Subsystem initialization failed",
+                                          node->name.c_str());
+    }
+    return result;
+}
+
+void run_background(rac_request_id_t /*id*/, void* /*user_data*/) {
+    Graph& g = graph();
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(g.mutex);
+        g.background_queued = false;
+        count = g.nodes.size();
+    }
+
+    bool all_ready = true;
+    for (size_t i = 0; i < count; ++i) {
+        rac_subsystem_start_t start;
+        {
+            std::lock_guard<std::mutex> lock(g.mutex);
+            start = g.nodes[i]->start;
+        }
+        if (start == RAC_SUBSYSTEM_START_BACKGROUND) {
+            all_ready = require_node(g, i) == RAC_SUCCESS && all_ready;
+        }
+    }
+
+    bool report = false;
+    {
+        std::lock_guard<std::mutex> lock(g.mutex);
+        report = all_ready && !g.background_reported;
+        g.background_reported = g.background_reported || all_ready;
+    }
+    if (report) {
+        const double total_ms = elapsed_ms(g.created);
+        RAC_LOG_INFO(LOG_CAT, "Background initialization done %.1f ms after startup", total_ms);
+        rac::events::emit_sdk_init_completed(total_ms, nullptr);
+    }
+}
+
+void release_background(rac_request_id_t /*id*/, rac_bool_t ran, void* /*user_data*/) {
+    if (!ran) {
+        Graph& g = graph();
+        std::lock_guard<std::mutex> lock(g.mutex);
+        g.background_queued = false;
+    }
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_init_graph_register(const rac_subsystem_desc_t* desc) {
+    if (!desc || !desc->name || desc->name[0] == '\0' ||
+        (desc->dependency_count > 0 && !desc->dependencies)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto node = std::make_unique<Node>();
+    node->name = desc->name;
+    node->init = desc->init;
+    node->user_data = desc->user_data;
+    node->start = desc->start;
+
+    Graph& g = graph();
+    std::lock_guard<std::mutex> lock(g.mutex);
+    if (find_locked(g, desc->name) >= 0) {
+        return RAC_ERROR_ALREADY_INITIALIZED;
+    }
+    for (size_t i = 0; i < desc->dependency_count; ++i) {
+        const int dependency = desc->dependencies[i] ? find_locked(g, desc->dependencies[i]) : -1;
+        if (dependency < 0) {
+            RAC_LOG_ERROR(LOG_CAT, "%s depends on unregistered %s", desc->name,
+                          desc->dependencies[i] ? desc->dependencies[i] : "(null)");
+            return RAC_ERROR_NOT_FOUND;
+        }
+        node->dependencies.push_back(static_cast<size_t>(dependency));
+    }
+    if (node->start == RAC_SUBSYSTEM_START_BACKGROUND) {
+        g.background_reported = false;
+    }
+    g.nodes.push_back(std::move(node));
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_init_graph_require(const char* name) {
+    if (!name) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    Graph& g = graph();
+    int index;
+    {
+        std::lock_guard<std::mutex> lock(g.mutex);
+        index = find_locked(g, name);
+    }
+    if (index < 0) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+    return require_node(g, static_cast<size_t>(index));
+}
+
+rac_result_t rac_init_graph_start_background(void) {
+    Graph& g = graph();
+    {
+        std::lock_guard<std::mutex> lock(g.mutex);
+        if (g.background_queued) {
+            return RAC_SUCCESS;
+        }
+        g.background_queued = true;
+    }
+
+    rac_request_t request = {};
+    request.priority = RAC_REQUEST_PRIORITY_LOW;
+    request.run = run_background;
+    request.release = release_background;
+    rac_request_id_t id = 0;
+    const rac_result_t result = rac_executor_submit(&request, &id);
+    if (result != RAC_SUCCESS) {
+        std::lock_guard<std::mutex> lock(g.mutex);
+        g.background_queued = false;
+    }
+    return result;
+}
+
+rac_bool_t rac_init_graph_is_ready(const char* name) {
+    rac_subsystem_status_t status;
+    return rac_init_graph_get_status(name, &status) == RAC_SUCCESS && status.initialized &&
+                   status.result == RAC_SUCCESS
+               ? RAC_TRUE
+               : RAC_FALSE;
+}
+
+rac_result_t rac_init_graph_get_status(const char* name, rac_subsystem_status_t* out_status) {
+    if (!name || !out_status) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    Graph& g = graph();
+    std::lock_guard<std::mutex> lock(g.mutex);
+    const int index = find_locked(g, name);
+    if (index < 0) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+    const Node& node = *g.nodes[index];
+    out_status->initialized = node.state == NodeState::kDone ? RAC_TRUE : RAC_FALSE;
+    out_status->result = node.result;
+    out_status->init_ms = node.init_ms;
+    return RAC_SUCCESS;
+}
+
+}  // extern "C"
@@ -4,14 +4,25 @@
  *
  * Implements the structured logging system that routes through the platform
  * adapter to Swift/Kotlin for proper telemetry and error tracking.
+ *
+ * Lines are formatted straight into a slot of a fixed ring buffer and written
+ * out by a drain thread, so callers never block on the platform adapter (JNI
+ * on Android) or allocate. The level check is a relaxed atomic load done
+ * before any formatting. When the ring is full, lines below ERROR are dropped
+ * and counted; ERROR and FATAL are never dropped and wait for the drain, so
+ * they are out before a crash.
  */
 
 #include "rac/core/rac_logger.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <mutex>
+#include <thread>
 
 #include "rac/core/rac_platform_adapter.h"
 
@@ -21,20 +32,59 @@
 
 namespace {
 
+constexpr size_t kRingSlots = 256;  // power of two
+constexpr size_t kSlotCategorySize = 32;
+constexpr size_t kSlotTextSize = 1024;
+constexpr auto kDrainIdleWait = std::chrono::milliseconds(100);
+constexpr auto kFlushTimeout = std::chrono::seconds(1);
+
+// One queued line. seq follows the bounded MPMC queue scheme: seq == pos means
+// free for the producer claiming pos, seq == pos + 1 means ready to drain.
+struct LogSlot {
+    std::atomic<uint64_t> seq{0};
+    rac_log_level_t level = RAC_LOG_INFO;
+    char category[kSlotCategorySize];
+    char text[kSlotTextSize];
+};
+
 // Logger configuration
 struct LoggerState {
-    rac_log_level_t min_level = RAC_LOG_INFO;
-    rac_bool_t stderr_fallback = RAC_TRUE;
-    rac_bool_t stderr_always = RAC_TRUE;  // Always log to stderr (safe during static init)
-    rac_bool_t initialized = RAC_FALSE;
-    std::mutex mutex;
+    std::atomic<int> min_level{RAC_LOG_INFO};
+    std::atomic<rac_bool_t> stderr_fallback{RAC_TRUE};
+    std::atomic<rac_bool_t> stderr_always{RAC_TRUE};  // safe during static init
+    std::atomic<rac_bool_t> async{RAC_TRUE};
+    std::atomic<rac_bool_t> initialized{RAC_FALSE};
+
+    LogSlot ring[kRingSlots];
+    std::atomic<uint64_t> enqueue_pos{0};
+    std::atomic<uint64_t> dequeue_pos{0};  // written by the drain thread only
+    std::atomic<uint64_t> pending{0};      // claimed but not yet written
+    std::atomic<uint64_t> dropped{0};
+
+    std::once_flag drain_once;
+    std::atomic<bool> drain_running{false};
+    std::atomic<bool> sleeping{false};
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    std::atomic<int> flush_waiters{0};
+    std::mutex flush_mutex;
+    std::condition_variable flush_cv;
+
+    LoggerState() {
+        for (size_t i = 0; i < kRingSlots; ++i) {
+            ring[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
 };
 
 LoggerState& state() {
-    static LoggerState s;
-    return s;
+    // Never destroyed: the drain thread is detached and may run during exit
+    static LoggerState* s = new LoggerState();
+    return *s;
 }
 
+thread_local bool t_is_drain_thread = false;
+
 // Level to string
 const char* level_to_string(rac_log_level_t level) {
     switch (level) {
@@ -65,17 +115,13 @@ const char* filename_from_path(const char* path) {
     return last_sep ? last_sep + 1 : path;
 }
 
-// Format message with metadata for platform adapter
-void format_message_with_metadata(char* buffer, size_t buffer_size, const char* message,
-                                  const rac_log_metadata_t* metadata) {
+// Append metadata to a message already written at buffer[0..pos)
+void append_metadata(char* buffer, size_t buffer_size, size_t pos,
+                     const rac_log_metadata_t* metadata) {
     if (!metadata) {
-        snprintf(buffer, buffer_size, "%s", message);
         return;
     }
 
-    // Start with the message
-    size_t pos = snprintf(buffer, buffer_size, "%s", message);
-
     // Add metadata if present
     bool has_meta = false;
 
@@ -131,41 +177,173 @@ void format_message_with_metadata(char* buffer, size_t buffer_size, const char*
     }
 }
 
-// Fallback to stderr
-void log_to_stderr(rac_log_level_t level, const char* category, const char* message,
-                   const rac_log_metadata_t* metadata) {
-    const char* level_str = level_to_string(level);
+// Format a printf-style message followed by its metadata
+void format_line(char* buffer, size_t buffer_size, const rac_log_metadata_t* metadata,
+                 const char* format, va_list args) {
+    int written = vsnprintf(buffer, buffer_size, format, args);
+    if (written < 0) {
+        buffer[0] = '\0';
+        written = 0;
+    }
+    append_metadata(buffer, buffer_size, static_cast<size_t>(written), metadata);
+}
 
+void log_to_stderr(rac_log_level_t level, const char* category, const char* text) {
     // Determine output stream
     FILE* stream = (level >= RAC_LOG_ERROR) ? stderr : stdout;
+    fprintf(stream, "[RAC][%s][%s] %s\n", level_to_string(level), category, text);
+    fflush(stream);
+}
 
-    // Print base message
-    fprintf(stream, "[RAC][%s][%s] %s", level_str, category, message);
+// Write one formatted line to stderr and/or the platform adapter
+void emit_line(rac_log_level_t level, const char* category, const char* text) {
+    LoggerState& s = state();
+    const bool stderr_always = s.stderr_always.load(std::memory_order_relaxed) != 0;
 
-    // Print metadata if present
-    if (metadata) {
-        if (metadata->file) {
-            const char* filename = filename_from_path(metadata->file);
-            if (filename) {
-                fprintf(stream, " | file=%s:%d", filename, metadata->line);
+    // ALWAYS log to stderr first if enabled (safe during static initialization)
+    // This ensures we can debug crashes even before platform adapter is ready
+    if (stderr_always) {
+        log_to_stderr(level, category, text);
+    }
+
+    // Also forward to platform adapter if available
+    const rac_platform_adapter_t* adapter = rac_get_platform_adapter();
+    if (adapter && adapter->log) {
+        adapter->log(level, category, text, adapter->user_data);
+    } else if (!stderr_always && s.stderr_fallback.load(std::memory_order_relaxed) != 0) {
+        // Fallback to stderr only if we haven't already logged there
+        log_to_stderr(level, category, text);
+    }
+}
+
+// =============================================================================
+// RING BUFFER AND DRAIN THREAD
+// =============================================================================
+
+void drain_loop();
+
+void start_drain_thread() {
+    LoggerState& s = state();
+    std::call_once(s.drain_once, [&s] {
+        std::thread(drain_loop).detach();
+        s.drain_running.store(true);
+        // Write out what is still queued when the process exits normally
+        std::atexit([] { rac_logger_flush(); });
+    });
+}
+
+// Claims a free slot, or returns nullptr when the ring is full
+LogSlot* claim_slot(uint64_t* out_pos) {
+    LoggerState& s = state();
+    uint64_t pos = s.enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        LogSlot& slot = s.ring[pos & (kRingSlots - 1)];
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (s.enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                s.pending.fetch_add(1);
+                *out_pos = pos;
+                return &slot;
             }
+        } else if (diff < 0) {
+            return nullptr;
+        } else {
+            pos = s.enqueue_pos.load(std::memory_order_relaxed);
         }
-        if (metadata->function) {
-            fprintf(stream, ", func=%s", metadata->function);
+    }
+}
+
+void publish_slot(LogSlot* slot, uint64_t pos) {
+    LoggerState& s = state();
+    slot->seq.store(pos + 1, std::memory_order_release);
+
+    if (s.sleeping.load() && s.sleeping.exchange(false)) {
+        std::lock_guard<std::mutex> lock(s.wake_mutex);
+        s.wake_cv.notify_one();
+    }
+}
+
+void report_dropped(uint64_t* reported) {
+    uint64_t dropped = state().dropped.load(std::memory_order_relaxed);
+    if (dropped == *reported) {
+        return;
+    }
+    char text[96];
+    snprintf(text, sizeof(text), "Log buffer full, dropped %llu line(s)",
+             static_cast<unsigned long long>(dropped - *reported));
+    *reported = dropped;
+    emit_line(RAC_LOG_WARNING, "Logger", text);
+}
+
+void drain_loop() {
+    t_is_drain_thread = true;
+    LoggerState& s = state();
+    uint64_t reported_dropped = 0;
+
+    for (;;) {
+        const uint64_t pos = s.dequeue_pos.load(std::memory_order_relaxed);
+        LogSlot& slot = s.ring[pos & (kRingSlots - 1)];
+        if (slot.seq.load(std::memory_order_acquire) == pos + 1) {
+            emit_line(slot.level, slot.category, slot.text);
+            slot.seq.store(pos + kRingSlots, std::memory_order_release);
+            s.dequeue_pos.store(pos + 1);
+            s.pending.fetch_sub(1);
+            if (s.flush_waiters.load() > 0) {
+                std::lock_guard<std::mutex> lock(s.flush_mutex);
+                s.flush_cv.notify_all();
+            }
+            continue;
         }
-        if (metadata->error_code != 0) {
-            fprintf(stream, ", error_code=%d", metadata->error_code);
+
+        if (s.pending.load() > 0) {
+            // A producer has claimed the slot and is still formatting into it
+            std::this_thread::yield();
+            continue;
         }
-        if (metadata->model_id) {
-            fprintf(stream, ", model=%s", metadata->model_id);
+        report_dropped(&reported_dropped);
+
+        std::unique_lock<std::mutex> lock(s.wake_mutex);
+        s.sleeping.store(true);
+        if (s.pending.load() == 0) {
+            s.wake_cv.wait_for(lock, kDrainIdleWait, [&s] { return !s.sleeping.load(); });
+        }
+        s.sleeping.store(false);
+    }
+}
+
+// Queue a line when async mode is on, otherwise write it on the calling thread.
+// format_into fills the text buffer it is given.
+template <typename FormatInto>
+void dispatch(rac_log_level_t level, const char* category, FormatInto format_into) {
+    if (!category)
+        category = "RAC";
+
+    LoggerState& s = state();
+    if (s.async.load(std::memory_order_relaxed) != 0 && !t_is_drain_thread) {
+        start_drain_thread();
+
+        uint64_t pos = 0;
+        if (LogSlot* slot = claim_slot(&pos)) {
+            slot->level = level;
+            snprintf(slot->category, sizeof(slot->category), "%s", category);
+            format_into(slot->text, sizeof(slot->text));
+            publish_slot(slot, pos);
+            if (level >= RAC_LOG_ERROR) {
+                rac_logger_flush();
+            }
+            return;
         }
-        if (metadata->framework) {
-            fprintf(stream, ", framework=%s", metadata->framework);
+        if (level < RAC_LOG_ERROR) {
+            s.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
+        // Errors are never dropped; write this one directly
     }
 
-    fprintf(stream, "\n");
-    fflush(stream);
+    char buffer[2048];
+    format_into(buffer, sizeof(buffer));
+    emit_line(level, category, buffer);
 }
 
 }  // anonymous namespace
@@ -177,76 +355,75 @@ void log_to_stderr(rac_log_level_t level, const char* category, const char* mess
 extern "C" {
 
 rac_result_t rac_logger_init(rac_log_level_t min_level) {
-    std::lock_guard<std::mutex> lock(state().mutex);
-    state().min_level = min_level;
-    state().initialized = RAC_TRUE;
+    state().min_level.store(min_level);
+    state().initialized.store(RAC_TRUE);
     return RAC_SUCCESS;
 }
 
 void rac_logger_shutdown(void) {
-    std::lock_guard<std::mutex> lock(state().mutex);
-    state().initialized = RAC_FALSE;
+    rac_logger_flush();
+    state().initialized.store(RAC_FALSE);
 }
 
 void rac_logger_set_min_level(rac_log_level_t level) {
-    std::lock_guard<std::mutex> lock(state().mutex);
-    state().min_level = level;
+    state().min_level.store(level);
 }
 
 rac_log_level_t rac_logger_get_min_level(void) {
-    std::lock_guard<std::mutex> lock(state().mutex);
-    return state().min_level;
+    return static_cast<rac_log_level_t>(state().min_level.load());
+}
+
+rac_bool_t rac_logger_enabled(rac_log_level_t level) {
+    return level >= state().min_level.load(std::memory_order_relaxed) ? RAC_TRUE : RAC_FALSE;
 }
 
 void rac_logger_set_stderr_fallback(rac_bool_t enabled) {
-    std::lock_guard<std::mutex> lock(state().mutex);
-    state().stderr_fallback = enabled;
+    state().stderr_fallback.store(enabled);
 }
 
 void rac_logger_set_stderr_always(rac_bool_t enabled) {
-    std::lock_guard<std::mutex> lock(state().mutex);
-    state().stderr_always = enabled;
+    state().stderr_always.store(enabled);
 }
 
-void rac_logger_log(rac_log_level_t level, const char* category, const char* message,
-                    const rac_log_metadata_t* metadata) {
-    if (!message)
+void rac_logger_set_async(rac_bool_t enabled) {
+    if (enabled == 0) {
+        rac_logger_flush();
+    }
+    state().async.store(enabled);
+}
+
+void rac_logger_flush(void) {
+    LoggerState& s = state();
+    if (t_is_drain_thread || !s.drain_running.load()) {
         return;
-    if (!category)
-        category = "RAC";
+    }
 
-    // Get state configuration (with lock)
-    rac_log_level_t min_level;
-    rac_bool_t stderr_always;
-    rac_bool_t stderr_fallback;
+    // Wait for the lines queued so far, not for an idle ring
+    const uint64_t target = s.enqueue_pos.load();
+    s.flush_waiters.fetch_add(1);
+    if (s.sleeping.load() && s.sleeping.exchange(false)) {
+        std::lock_guard<std::mutex> lock(s.wake_mutex);
+        s.wake_cv.notify_one();
+    }
     {
-        std::lock_guard<std::mutex> lock(state().mutex);
-        min_level = state().min_level;
-        stderr_always = state().stderr_always;
-        stderr_fallback = state().stderr_fallback;
+        std::unique_lock<std::mutex> lock(s.flush_mutex);
+        s.flush_cv.wait_for(lock, kFlushTimeout,
+                            [&s, target] { return s.dequeue_pos.load() >= target; });
     }
+    s.flush_waiters.fetch_sub(1);
+}
 
-    // Check min level
-    if (level < min_level)
+void rac_logger_log(rac_log_level_t level, const char* category, const char* message,
+                    const rac_log_metadata_t* metadata) {
+    if (!message)
+        return;
+    if (rac_logger_enabled(level) == 0)
         return;
 
-    // ALWAYS log to stderr first if enabled (safe during static initialization)
-    // This ensures we can debug crashes even before platform adapter is ready
-    if (stderr_always != 0) {
-        log_to_stderr(level, category, message, metadata);
-    }
-
-    // Also forward to platform adapter if available
-    const rac_platform_adapter_t* adapter = rac_get_platform_adapter();
-    if (adapter && adapter->log) {
-        // Format message with metadata for the platform
-        char formatted[2048];
-        format_message_with_metadata(formatted, sizeof(formatted), message, metadata);
-        adapter->log(level, category, formatted, adapter->user_data);
-    } else if (stderr_always == 0 && stderr_fallback != 0) {
-        // Fallback to stderr only if we haven't already logged there
-        log_to_stderr(level, category, message, metadata);
-    }
+    dispatch(level, category, [message, metadata](char* buffer, size_t size) {
+        int written = snprintf(buffer, size, "%s", message);
+        append_metadata(buffer, size, written < 0 ? 0 : static_cast<size_t>(written), metadata);
+    });
 }
 
 void rac_logger_logf(rac_log_level_t level, const char* category,
@@ -264,12 +441,16 @@ void rac_logger_logv(rac_log_level_t level, const char* category,
                      const rac_log_metadata_t* metadata, const char* format, va_list args) {
     if (!format)
         return;
+    // Filter before formatting so disabled levels cost one atomic load
+    if (rac_logger_enabled(level) == 0)
+        return;
 
-    // Format the message
-    char buffer[2048];
-    vsnprintf(buffer, sizeof(buffer), format, args);
-
-    rac_logger_log(level, category, buffer, metadata);
+    dispatch(level, category, [&](char* buffer, size_t size) {
+        va_list copy;
+        va_copy(copy, args);
+        format_line(buffer, size, metadata, format, copy);
+        va_end(copy);
+    });
 }
 
 }  // extern "C"
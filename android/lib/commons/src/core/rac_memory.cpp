@@ -3,23 +3,227 @@
  * @brief RunAnywhere Commons - Memory Utilities
  *
  * Matches Swift's memory management patterns for C interop.
+ *
+ * Without tracking, an allocation is one call through the installed
+ * allocator plus a relaxed flag check. With tracking, each block is also
+ * recorded in a table sharded by address, so frees on different threads
+ * rarely share a lock, and its size is added to per-tag atomic counters.
  */
 
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_logger.h"
 #include "rac/core/rac_types.h"
 
+static const char* LOG_CAT = "Memory";
+
+namespace {
+
+// =============================================================================
+// ALLOCATOR
+// =============================================================================
+
+void* default_alloc(size_t size, void* /*user_data*/) {
+    return malloc(size);
+}
+
+void* default_realloc(void* ptr, size_t size, void* /*user_data*/) {
+    return realloc(ptr, size);
+}
+
+void default_free(void* ptr, void* /*user_data*/) {
+    free(ptr);
+}
+
+// Only replaced before the first allocation, so reads need no lock
+rac_allocator_t g_allocator = {default_alloc, default_realloc, default_free, nullptr};
+std::atomic<bool> g_allocated{false};
+
+void mark_allocated() {
+    if (!g_allocated.load(std::memory_order_relaxed)) {
+        g_allocated.store(true, std::memory_order_relaxed);
+    }
+}
+
+// =============================================================================
+// TRACKING
+// =============================================================================
+
+constexpr size_t kShards = 32;
+
+struct Block {
+    size_t size;
+    rac_alloc_tag_t tag;
+};
+
+struct alignas(64) Shard {
+    std::mutex mutex;
+    std::unordered_map<const void*, Block> blocks;
+};
+
+struct alignas(64) TagCounters {
+    std::atomic<int64_t> live_bytes{0};
+    std::atomic<int64_t> live_count{0};
+    std::atomic<int64_t> peak_bytes{0};
+    std::atomic<int64_t> total_count{0};
+    std::atomic<int64_t> total_bytes{0};
+};
+
+std::atomic<bool> g_tracking{false};
+// Blocks in the table; frees skip the lookup while tracking is off and it is 0
+std::atomic<int64_t> g_tracked_blocks{0};
+
+Shard* shards() {
+    static Shard instance[kShards];
+    return instance;
+}
+
+TagCounters* tag_counters() {
+    static TagCounters instance[RAC_ALLOC_TAG_COUNT];
+    return instance;
+}
+
+Shard& shard_for(const void* ptr) {
+    // Allocations are at least 16-byte aligned; mix the bits above that
+    uintptr_t key = reinterpret_cast<uintptr_t>(ptr) >> 4;
+    key ^= key >> 7;
+    return shards()[key % kShards];
+}
+
+void track(void* ptr, size_t size, rac_alloc_tag_t tag) {
+    {
+        Shard& shard = shard_for(ptr);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.blocks[ptr] = Block{size, tag};
+    }
+    g_tracked_blocks.fetch_add(1, std::memory_order_relaxed);
+
+    TagCounters& counters = tag_counters()[tag];
+    const int64_t bytes = static_cast<int64_t>(size);
+    const int64_t live = counters.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    counters.live_count.fetch_add(1, std::memory_order_relaxed);
+    counters.total_count.fetch_add(1, std::memory_order_relaxed);
+    counters.total_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    int64_t peak = counters.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !counters.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+// Removes ptr from the table; false if it was allocated while tracking was off
+bool untrack(const void* ptr, Block* out_block) {
+    if (!g_tracking.load(std::memory_order_relaxed) &&
+        g_tracked_blocks.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    {
+        Shard& shard = shard_for(ptr);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.blocks.find(ptr);
+        if (it == shard.blocks.end()) {
+            return false;
+        }
+        *out_block = it->second;
+        shard.blocks.erase(it);
+    }
+    g_tracked_blocks.fetch_sub(1, std::memory_order_relaxed);
+
+    TagCounters& counters = tag_counters()[out_block->tag];
+    counters.live_bytes.fetch_sub(static_cast<int64_t>(out_block->size),
+                                  std::memory_order_relaxed);
+    counters.live_count.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+rac_alloc_tag_t checked_tag(rac_alloc_tag_t tag) {
+    return tag >= 0 && tag < RAC_ALLOC_TAG_COUNT ? tag : RAC_ALLOC_TAG_GENERAL;
+}
+
+void* allocate(size_t size, rac_alloc_tag_t tag) {
+    if (size == 0) {
+        return nullptr;
+    }
+    mark_allocated();
+    void* ptr = g_allocator.alloc(size, g_allocator.user_data);
+    if (ptr != nullptr && g_tracking.load(std::memory_order_relaxed)) {
+        track(ptr, size, checked_tag(tag));
+    }
+    return ptr;
+}
+
+void* allocate_zeroed(size_t count, size_t size, rac_alloc_tag_t tag) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return nullptr;
+    }
+    void* ptr = allocate(count * size, tag);
+    if (ptr != nullptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+char* duplicate(const char* str, rac_alloc_tag_t tag) {
+    if (str == nullptr) {
+        return nullptr;
+    }
+
+    size_t len = strlen(str) + 1;
+    char* copy = static_cast<char*>(allocate(len, tag));
+    if (copy != nullptr) {
+        memcpy(copy, str, len);
+    }
+    return copy;
+}
+
+}  // namespace
+
 extern "C" {
 
+// =============================================================================
+// BASIC API
+// =============================================================================
+
 /**
  * Allocate memory using the RAC allocator.
  */
 void* rac_alloc(size_t size) {
+    return allocate(size, RAC_ALLOC_TAG_GENERAL);
+}
+
+void* rac_calloc(size_t count, size_t size) {
+    return allocate_zeroed(count, size, RAC_ALLOC_TAG_GENERAL);
+}
+
+void* rac_realloc(void* ptr, size_t size) {
+    if (ptr == nullptr) {
+        return allocate(size, RAC_ALLOC_TAG_GENERAL);
+    }
     if (size == 0) {
+        rac_free(ptr);
         return nullptr;
     }
-    return malloc(size);
+
+    Block block = {0, RAC_ALLOC_TAG_GENERAL};
+    const bool tracked = untrack(ptr, &block);
+    void* resized = g_allocator.realloc(ptr, size, g_allocator.user_data);
+    if (resized == nullptr) {
+        if (tracked) {
+            track(ptr, block.size, block.tag);
+        }
+        return nullptr;
+    }
+    if (tracked || g_tracking.load(std::memory_order_relaxed)) {
+        track(resized, size, block.tag);
+    }
+    return resized;
 }
 
 /**
@@ -28,7 +232,9 @@ void* rac_alloc(size_t size) {
  */
 void rac_free(void* ptr) {
     if (ptr != nullptr) {
-        free(ptr);
+        Block block;
+        untrack(ptr, &block);
+        g_allocator.free(ptr, g_allocator.user_data);
     }
 }
 
@@ -37,16 +243,124 @@ void rac_free(void* ptr) {
  * Matches Swift interop patterns.
  */
 char* rac_strdup(const char* str) {
-    if (str == nullptr) {
-        return nullptr;
+    return duplicate(str, RAC_ALLOC_TAG_GENERAL);
+}
+
+// =============================================================================
+// ALLOCATOR API
+// =============================================================================
+
+rac_result_t rac_set_allocator(const rac_allocator_t* allocator) {
+    if (allocator && (!allocator->alloc || !allocator->realloc || !allocator->free)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    if (g_allocated.load(std::memory_order_relaxed)) {
+        RAC_LOG_ERROR(LOG_CAT, "Allocator must be set before the first allocation");
+        return RAC_ERROR_INVALID_STATE;
+    }
+    g_allocator = allocator ? *allocator
+                            : rac_allocator_t{default_alloc, default_realloc, default_free,
+                                              nullptr};
+    return RAC_SUCCESS;
+}
+
+void* rac_alloc_tagged(rac_alloc_tag_t tag, size_t size) {
+    return allocate(size, tag);
+}
+
+void* rac_calloc_tagged(rac_alloc_tag_t tag, size_t count, size_t size) {
+    return allocate_zeroed(count, size, tag);
+}
+
+char* rac_strdup_tagged(rac_alloc_tag_t tag, const char* str) {
+    return duplicate(str, tag);
+}
+
+// =============================================================================
+// TRACKING API
+// =============================================================================
+
+void rac_alloc_set_tracking(rac_bool_t enabled) {
+    g_tracking.store(enabled == RAC_TRUE, std::memory_order_relaxed);
+}
+
+rac_bool_t rac_alloc_is_tracking(void) {
+    return g_tracking.load(std::memory_order_relaxed) ? RAC_TRUE : RAC_FALSE;
+}
+
+rac_result_t rac_alloc_get_stats(rac_alloc_tag_t tag, rac_alloc_stats_t* out_stats) {
+    if (!out_stats || tag < 0 || tag >= RAC_ALLOC_TAG_COUNT) {
+        return RAC_ERROR_INVALID_ARGUMENT;
     }
+    const TagCounters& counters = tag_counters()[tag];
+    out_stats->live_bytes = counters.live_bytes.load(std::memory_order_relaxed);
+    out_stats->live_count = counters.live_count.load(std::memory_order_relaxed);
+    out_stats->peak_bytes = counters.peak_bytes.load(std::memory_order_relaxed);
+    out_stats->total_count = counters.total_count.load(std::memory_order_relaxed);
+    out_stats->total_bytes = counters.total_bytes.load(std::memory_order_relaxed);
+    return RAC_SUCCESS;
+}
 
-    size_t len = strlen(str) + 1;
-    char* copy = static_cast<char*>(malloc(len));
-    if (copy != nullptr) {
-        memcpy(copy, str, len);
+rac_result_t rac_alloc_stats_json(char** out_json) {
+    if (!out_json) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::string json = "{\"tracking\":";
+    json += g_tracking.load(std::memory_order_relaxed) ? "true" : "false";
+    json += ",\"tags\":{";
+    char entry[256];
+    for (int tag = 0; tag < RAC_ALLOC_TAG_COUNT; ++tag) {
+        rac_alloc_stats_t stats;
+        rac_alloc_get_stats(static_cast<rac_alloc_tag_t>(tag), &stats);
+        snprintf(entry, sizeof(entry),
+                 "%s\"%s\":{\"live_bytes\":%lld,\"live_count\":%lld,\"peak_bytes\":%lld,"
+                 "\"total_count\":%lld,\"total_bytes\":%lld}",
+                 tag == 0 ? "" : ",", rac_alloc_tag_name(static_cast<rac_alloc_tag_t>(tag)),
+                 static_cast<long long>(stats.live_bytes),
+                 static_cast<long long>(stats.live_count),
+                 static_cast<long long>(stats.peak_bytes),
+                 static_cast<long long>(stats.total_count),
+                 static_cast<long long>(stats.total_bytes));
+        json += entry;
+    }
+    json += "}}";
+
+    *out_json = rac_strdup(json.c_str());
+    return *out_json ? RAC_SUCCESS : RAC_ERROR_OUT_OF_MEMORY;
+}
+
+void rac_alloc_reset_stats(void) {
+    for (int tag = 0; tag < RAC_ALLOC_TAG_COUNT; ++tag) {
+        TagCounters& counters = tag_counters()[tag];
+        counters.total_count.store(0, std::memory_order_relaxed);
+        counters.total_bytes.store(0, std::memory_order_relaxed);
+        counters.peak_bytes.store(counters.live_bytes.load(std::memory_order_relaxed),
+                                  std::memory_order_relaxed);
+    }
+}
+
+const char* rac_alloc_tag_name(rac_alloc_tag_t tag) {
+    switch (tag) {
+        case RAC_ALLOC_TAG_GENERAL:
+            return "general";
+        case RAC_ALLOC_TAG_RESULT:
+            return "result";
+        case RAC_ALLOC_TAG_EVENT:
+            return "event";
+        case RAC_ALLOC_TAG_TELEMETRY:
+            return "telemetry";
+        case RAC_ALLOC_TAG_MODEL:
+            return "model";
+        case RAC_ALLOC_TAG_NETWORK:
+            return "network";
+        case RAC_ALLOC_TAG_AUDIO:
+            return "audio";
+        case RAC_ALLOC_TAG_ERROR:
+            return "error";
+        default:
+            return "unknown";
     }
-    return copy;
 }
 
 }  // extern "C"
@@ -0,0 +1,149 @@
+/**
+ * @file rac_memory_pressure.cpp
+ * @brief RunAnywhere Commons - Memory Pressure Fan-out
+ *
+ * Handlers are copied out of the registry for each notification, and
+ * notifications hold their own mutex while handlers run, so handlers may
+ * take component locks and unregister waits until no handler can be running.
+ */
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rac/core/rac_core.h"
+#include "rac/core/rac_error.h"
+#include "rac/core/rac_logger.h"
+
+static const char* LOG_CAT = "MemoryPressure";
+
+namespace {
+
+struct PressureHandler {
+    std::string name;
+    rac_memory_pressure_handler_fn handler;
+    void* user_data;
+};
+
+struct PressureRegistry {
+    std::mutex mutex;         // guards handlers
+    std::mutex notify_mutex;  // held while handlers run
+    std::vector<PressureHandler> handlers;
+};
+
+PressureRegistry& registry() {
+    static PressureRegistry instance;
+    return instance;
+}
+
+const char* stage_name(rac_memory_pressure_stage_t stage) {
+    switch (stage) {
+        case RAC_MEMORY_PRESSURE_STAGE_DROP_CACHES:
+            return "drop caches";
+        case RAC_MEMORY_PRESSURE_STAGE_SHRINK_CONTEXT:
+            return "shrink context";
+        case RAC_MEMORY_PRESSURE_STAGE_RELEASE_BUFFERS:
+            return "release buffers";
+        case RAC_MEMORY_PRESSURE_STAGE_UNLOAD_IDLE:
+            return "unload idle";
+        default:
+            return "unknown";
+    }
+}
+
+// Stages a level runs, in order
+int stage_count(rac_memory_pressure_level_t level) {
+    switch (level) {
+        case RAC_MEMORY_PRESSURE_MODERATE:
+            return 1;
+        case RAC_MEMORY_PRESSURE_LOW:
+            return 3;
+        case RAC_MEMORY_PRESSURE_CRITICAL:
+            return RAC_MEMORY_PRESSURE_STAGE_COUNT;
+        case RAC_MEMORY_PRESSURE_NONE:
+        default:
+            return 0;
+    }
+}
+
+}  // namespace
+
+extern "C" {
+
+rac_result_t rac_memory_pressure_register(const char* name,
+                                          rac_memory_pressure_handler_fn handler,
+                                          void* user_data) {
+    if (handler == nullptr) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& entry : reg.handlers) {
+        if (entry.handler == handler && entry.user_data == user_data) {
+            return RAC_SUCCESS;
+        }
+    }
+    reg.handlers.push_back(PressureHandler{name ? name : "unnamed", handler, user_data});
+    RAC_LOG_DEBUG(LOG_CAT, "Registered memory pressure handler: %s", name ? name : "unnamed");
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_memory_pressure_unregister(rac_memory_pressure_handler_fn handler,
+                                            void* user_data) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> notify_lock(reg.notify_mutex);
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto it = reg.handlers.begin(); it != reg.handlers.end(); ++it) {
+        if (it->handler == handler && it->user_data == user_data) {
+            reg.handlers.erase(it);
+            return RAC_SUCCESS;
+        }
+    }
+    return RAC_ERROR_NOT_FOUND;
+}
+
+rac_result_t rac_memory_pressure_notify(rac_memory_pressure_level_t level,
+                                        rac_memory_pressure_report_t* out_report) {
+    rac_memory_pressure_report_t report = {};
+    const int stages = stage_count(level);
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> notify_lock(reg.notify_mutex);
+    std::vector<PressureHandler> handlers;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        handlers = reg.handlers;
+    }
+    report.handler_count = stages > 0 ? static_cast<int32_t>(handlers.size()) : 0;
+
+    if (stages > 0) {
+        RAC_LOG_INFO(LOG_CAT, "Memory pressure level %d: %zu handlers, %d stages",
+                     static_cast<int>(level), handlers.size(), stages);
+    }
+
+    for (int i = 0; i < stages; ++i) {
+        const auto stage = static_cast<rac_memory_pressure_stage_t>(i);
+        for (const auto& entry : handlers) {
+            const int64_t freed = entry.handler(stage, entry.user_data);
+            if (freed > 0) {
+                report.stage_bytes[i] += freed;
+                RAC_LOG_INFO(LOG_CAT, "%s: %s freed %lld bytes", stage_name(stage),
+                             entry.name.c_str(), static_cast<long long>(freed));
+            }
+        }
+        report.total_bytes += report.stage_bytes[i];
+    }
+
+    if (stages > 0) {
+        RAC_LOG_INFO(LOG_CAT, "Memory pressure level %d freed %lld bytes",
+                     static_cast<int>(level), static_cast<long long>(report.total_bytes));
+    }
+
+    if (out_report != nullptr) {
+        *out_report = report;
+    }
+    return RAC_SUCCESS;
+}
+
+}  // extern "C"
@@ -0,0 +1,212 @@
+/**
+ * @file rac_memory_watermark.cpp
+ * @brief RunAnywhere Commons - Per-Call Memory High-Water Marks Implementation
+ *
+ * A count of calls in flight decides who may reset the kernel high-water
+ * mark: only a call that starts while nothing else is measuring resets it,
+ * so a reset never hides the peak of a call already running. Calls that
+ * overlap read a mark that may include the other call's memory, which
+ * over-reports rather than under-reports.
+ */
+
+#include "rac/core/rac_memory_watermark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+#include "rac/core/rac_logger.h"
+
+static const char* LOG_CAT = "MemoryWatermark";
+
+namespace {
+
+std::atomic<int> g_in_flight{0};
+
+#if defined(__linux__) || defined(__ANDROID__)
+
+// Cleared on the first failure so unsupported kernels and SELinux denials
+// cost one attempt, not one per call
+std::atomic<bool> g_clear_refs_ok{true};
+std::atomic<bool> g_smaps_rollup_ok{true};
+
+// Value in bytes of a "<key>: <n> kB" line in a /proc file
+int64_t kb_field(const char* line, const char* key) {
+    const size_t len = strlen(key);
+    if (strncmp(line, key, len) != 0) {
+        return -1;
+    }
+    long long kb = 0;
+    if (sscanf(line + len, " %lld", &kb) != 1) {
+        return -1;
+    }
+    return static_cast<int64_t>(kb) * 1024;
+}
+
+bool read_status(rac_process_memory_t* out) {
+    FILE* file = fopen("/proc/self/status", "r");
+    if (!file) {
+        return false;
+    }
+    char line[256];
+    int found = 0;
+    while (found < 2 && fgets(line, sizeof(line), file)) {
+        int64_t value;
+        if ((value = kb_field(line, "VmRSS:")) >= 0) {
+            out->rss_bytes = value;
+            found++;
+        } else if ((value = kb_field(line, "VmHWM:")) >= 0) {
+            out->peak_rss_bytes = value;
+            found++;
+        }
+    }
+    fclose(file);
+    return found > 0;
+}
+
+void read_pss(rac_process_memory_t* out) {
+    if (!g_smaps_rollup_ok.load(std::memory_order_relaxed)) {
+        return;
+    }
+    FILE* file = fopen("/proc/self/smaps_rollup", "r");
+    if (!file) {
+        // Pre-4.14 kernel; summing every mapping in smaps is too slow per call
+        g_smaps_rollup_ok.store(false, std::memory_order_relaxed);
+        return;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        int64_t value = kb_field(line, "Pss:");
+        if (value >= 0) {
+            out->pss_bytes = value;
+            break;
+        }
+    }
+    fclose(file);
+}
+
+bool reset_peak() {
+    if (!g_clear_refs_ok.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    bool ok = file && fputs("5", file) >= 0;
+    if (file && fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        g_clear_refs_ok.store(false, std::memory_order_relaxed);
+        RAC_LOG_DEBUG(LOG_CAT, "Cannot reset VmHWM; per-call peaks are estimated");
+    }
+    return ok;
+}
+
+#elif defined(__APPLE__)
+
+bool read_task(rac_process_memory_t* out) {
+    task_vm_info_data_t info = {};
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, reinterpret_cast<task_info_t>(&info), &count) !=
+        KERN_SUCCESS) {
+        return false;
+    }
+    out->rss_bytes = static_cast<int64_t>(info.resident_size);
+    out->peak_rss_bytes = static_cast<int64_t>(info.resident_size_peak);
+    if (count >= TASK_VM_INFO_REV1_COUNT) {
+        out->pss_bytes = static_cast<int64_t>(info.phys_footprint);
+    }
+    return true;
+}
+
+#endif
+
+bool read_memory(rac_process_memory_t* out) {
+    *out = {};
+#if defined(__linux__) || defined(__ANDROID__)
+    if (!read_status(out)) {
+        return false;
+    }
+    read_pss(out);
+    return true;
+#elif defined(__APPLE__)
+    return read_task(out);
+#else
+    return false;
+#endif
+}
+
+bool try_reset_peak() {
+#if defined(__linux__) || defined(__ANDROID__)
+    return reset_peak();
+#else
+    // resident_size_peak cannot be reset; end() detects a new lifetime peak
+    return false;
+#endif
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_process_memory_read(rac_process_memory_t* out_memory) {
+    if (!out_memory) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    return read_memory(out_memory) ? RAC_SUCCESS : RAC_ERROR_NOT_SUPPORTED;
+}
+
+void rac_memory_watermark_begin(rac_memory_watermark_t* mark) {
+    if (!mark) {
+        return;
+    }
+    *mark = {};
+    const bool alone = g_in_flight.fetch_add(1, std::memory_order_acq_rel) == 0;
+    mark->hwm_reset = (alone && try_reset_peak()) ? RAC_TRUE : RAC_FALSE;
+    mark->valid = read_memory(&mark->start) ? RAC_TRUE : RAC_FALSE;
+}
+
+void rac_memory_watermark_end(const rac_memory_watermark_t* mark, int64_t backend_bytes,
+                              rac_inference_memory_t* out_memory) {
+    if (!mark) {
+        return;
+    }
+    g_in_flight.fetch_sub(1, std::memory_order_acq_rel);
+    if (!out_memory) {
+        return;
+    }
+    *out_memory = {};
+    out_memory->backend_bytes = backend_bytes;
+
+    rac_process_memory_t now;
+    if (!mark->valid || !read_memory(&now)) {
+        return;
+    }
+    const rac_process_memory_t& start = mark->start;
+    out_memory->rss_delta_bytes = now.rss_bytes - start.rss_bytes;
+    if (start.pss_bytes > 0 && now.pss_bytes > 0) {
+        out_memory->pss_delta_bytes = now.pss_bytes - start.pss_bytes;
+    }
+
+    // After a reset the mark covers this call; without one, a mark above the
+    // one at the start can only have been set during the call
+    if (mark->hwm_reset || now.peak_rss_bytes > start.peak_rss_bytes) {
+        out_memory->peak_rss_bytes = now.peak_rss_bytes;
+        out_memory->peak_is_exact = RAC_TRUE;
+    }
+    const int64_t bound = std::max(start.rss_bytes, now.rss_bytes);
+    if (out_memory->peak_rss_bytes < bound) {
+        out_memory->peak_rss_bytes = bound;
+        out_memory->peak_is_exact = RAC_FALSE;
+    }
+}
+
+}  // extern "C"
@@ -0,0 +1,314 @@
+/**
+ * @file rac_metrics.cpp
+ * @brief RunAnywhere Commons - In-Process Metrics Registry Implementation
+ *
+ * Metrics live in a fixed table that only grows and is never freed, so
+ * recording needs no lock and snapshot names stay valid. Each thread adds to
+ * its own cache-line sized counter shard, so hot counters do not bounce a
+ * line between cores.
+ */
+
+#include "rac/core/rac_metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+namespace {
+
+constexpr int kCounterShards = 8;
+
+// Values below 4 get a bucket each; above, 4 buckets per power of two
+constexpr int kHistogramBuckets = 252;
+
+struct alignas(64) CounterShard {
+    std::atomic<int64_t> value{0};
+};
+
+struct Histogram {
+    std::atomic<uint64_t> counts[kHistogramBuckets] = {};
+    std::atomic<int64_t> sum{0};
+    std::atomic<int64_t> min{INT64_MAX};
+    std::atomic<int64_t> max{0};
+};
+
+struct Metric {
+    std::string name;
+    rac_metric_type_t type = RAC_METRIC_COUNTER;
+    CounterShard shards[kCounterShards];
+    std::atomic<double> gauge{0.0};
+    Histogram* histogram = nullptr;
+};
+
+struct Registry {
+    std::mutex register_mutex;
+    std::atomic<Metric*> metrics[RAC_METRICS_MAX] = {};
+    std::atomic<int32_t> count{0};
+    std::atomic<int> next_shard{0};
+};
+
+Registry& registry() {
+    // Never destroyed: components may record from threads still running at exit
+    static Registry* r = new Registry();
+    return *r;
+}
+
+Metric* metric_for(rac_metric_id_t id, rac_metric_type_t type) {
+    Registry& r = registry();
+    if (id < 0 || id >= r.count.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    Metric* metric = r.metrics[id].load(std::memory_order_acquire);
+    return metric && metric->type == type ? metric : nullptr;
+}
+
+int thread_shard() {
+    thread_local int shard =
+        registry().next_shard.fetch_add(1, std::memory_order_relaxed) % kCounterShards;
+    return shard;
+}
+
+int histogram_bucket(int64_t value) {
+    if (value < 4) {
+        return static_cast<int>(std::max<int64_t>(value, 0));
+    }
+    const int msb = 63 - __builtin_clzll(static_cast<unsigned long long>(value));
+    const int sub = static_cast<int>((value >> (msb - 2)) & 3);
+    return (msb - 1) * 4 + sub;
+}
+
+// Exclusive upper bound of a bucket
+int64_t histogram_bucket_upper(int bucket) {
+    const int next = bucket + 1;
+    if (next < 4) {
+        return next;
+    }
+    if (next >= kHistogramBuckets) {
+        return INT64_MAX;
+    }
+    const int msb = next / 4 + 1;
+    const int sub = next % 4;
+    return static_cast<int64_t>(4 + sub) << (msb - 2);
+}
+
+template <typename Compare>
+void update_extreme(std::atomic<int64_t>& extreme, int64_t value, Compare better) {
+    int64_t current = extreme.load(std::memory_order_relaxed);
+    while (better(value, current) &&
+           !extreme.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void fill_snapshot(const Metric& metric, rac_metric_snapshot_t& out) {
+    out = {};
+    out.name = metric.name.c_str();
+    out.type = metric.type;
+
+    switch (metric.type) {
+        case RAC_METRIC_COUNTER:
+            for (const CounterShard& shard : metric.shards) {
+                out.count += shard.value.load(std::memory_order_relaxed);
+            }
+            break;
+        case RAC_METRIC_GAUGE:
+            out.value = metric.gauge.load(std::memory_order_relaxed);
+            break;
+        case RAC_METRIC_HISTOGRAM: {
+            const Histogram& h = *metric.histogram;
+            uint64_t counts[kHistogramBuckets];
+            uint64_t total = 0;
+            for (int i = 0; i < kHistogramBuckets; ++i) {
+                counts[i] = h.counts[i].load(std::memory_order_relaxed);
+                total += counts[i];
+            }
+            if (total == 0) {
+                break;
+            }
+            out.count = static_cast<int64_t>(total);
+            out.sum = h.sum.load(std::memory_order_relaxed);
+            out.min = h.min.load(std::memory_order_relaxed);
+            out.max = h.max.load(std::memory_order_relaxed);
+
+            const double percentiles[3] = {50.0, 90.0, 99.0};
+            int64_t* outputs[3] = {&out.p50, &out.p90, &out.p99};
+            for (int p = 0; p < 3; ++p) {
+                const auto rank = std::max<uint64_t>(
+                    1, static_cast<uint64_t>(percentiles[p] / 100.0 * static_cast<double>(total)));
+                uint64_t seen = 0;
+                for (int i = 0; i < kHistogramBuckets; ++i) {
+                    seen += counts[i];
+                    if (seen >= rank) {
+                        *outputs[p] = std::min(histogram_bucket_upper(i), out.max);
+                        break;
+                    }
+                }
+            }
+            break;
+        }
+    }
+}
+
+void append_json_string(std::string& out, const char* value) {
+    out += '"';
+    for (const char* c = value; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out += '\\';
+        }
+        if (static_cast<unsigned char>(*c) >= 0x20) {
+            out += *c;
+        }
+    }
+    out += '"';
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API IMPLEMENTATION
+// =============================================================================
+
+extern "C" {
+
+rac_metric_id_t rac_metrics_register(const char* name, rac_metric_type_t type) {
+    if (!name || !*name) {
+        return -1;
+    }
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.register_mutex);
+    const int32_t count = r.count.load(std::memory_order_relaxed);
+    for (int32_t i = 0; i < count; ++i) {
+        Metric* metric = r.metrics[i].load(std::memory_order_relaxed);
+        if (metric->name == name) {
+            return metric->type == type ? i : -1;
+        }
+    }
+    if (count >= RAC_METRICS_MAX) {
+        return -1;
+    }
+
+    Metric* metric = new Metric();
+    metric->name = name;
+    metric->type = type;
+    if (type == RAC_METRIC_HISTOGRAM) {
+        metric->histogram = new Histogram();
+    }
+    r.metrics[count].store(metric, std::memory_order_release);
+    r.count.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+void rac_metrics_counter_add(rac_metric_id_t id, int64_t delta) {
+    if (Metric* metric = metric_for(id, RAC_METRIC_COUNTER)) {
+        metric->shards[thread_shard()].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+}
+
+void rac_metrics_gauge_set(rac_metric_id_t id, double value) {
+    if (Metric* metric = metric_for(id, RAC_METRIC_GAUGE)) {
+        metric->gauge.store(value, std::memory_order_relaxed);
+    }
+}
+
+void rac_metrics_histogram_record(rac_metric_id_t id, int64_t value) {
+    Metric* metric = metric_for(id, RAC_METRIC_HISTOGRAM);
+    if (!metric) {
+        return;
+    }
+    value = std::max<int64_t>(value, 0);
+    Histogram& h = *metric->histogram;
+    h.counts[histogram_bucket(value)].fetch_add(1, std::memory_order_relaxed);
+    h.sum.fetch_add(value, std::memory_order_relaxed);
+    update_extreme(h.min, value, [](int64_t a, int64_t b) { return a < b; });
+    update_extreme(h.max, value, [](int64_t a, int64_t b) { return a > b; });
+}
+
+rac_result_t rac_metrics_snapshot(rac_metric_snapshot_t* out_metrics, size_t capacity,
+                                  size_t* out_count) {
+    if (!out_count || (capacity > 0 && !out_metrics)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    Registry& r = registry();
+    const int32_t count = r.count.load(std::memory_order_acquire);
+    for (int32_t i = 0; i < count && static_cast<size_t>(i) < capacity; ++i) {
+        fill_snapshot(*r.metrics[i].load(std::memory_order_acquire), out_metrics[i]);
+    }
+    *out_count = static_cast<size_t>(count);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_metrics_snapshot_json(char** out_json) {
+    if (!out_json) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    Registry& r = registry();
+    const int32_t count = r.count.load(std::memory_order_acquire);
+    std::string counters;
+    std::string gauges;
+    std::string histograms;
+    char number[256];
+
+    for (int32_t i = 0; i < count; ++i) {
+        rac_metric_snapshot_t m;
+        fill_snapshot(*r.metrics[i].load(std::memory_order_acquire), m);
+        switch (m.type) {
+            case RAC_METRIC_COUNTER:
+                counters += counters.empty() ? "" : ",";
+                append_json_string(counters, m.name);
+                snprintf(number, sizeof(number), ":%lld", static_cast<long long>(m.count));
+                counters += number;
+                break;
+            case RAC_METRIC_GAUGE:
+                gauges += gauges.empty() ? "" : ",";
+                append_json_string(gauges, m.name);
+                snprintf(number, sizeof(number), ":%.6g", m.value);
+                gauges += number;
+                break;
+            case RAC_METRIC_HISTOGRAM:
+                histograms += histograms.empty() ? "" : ",";
+                append_json_string(histograms, m.name);
+                snprintf(number, sizeof(number),
+                         ":{\"count\":%lld,\"sum\":%lld,\"min\":%lld,\"max\":%lld,"
+                         "\"p50\":%lld,\"p90\":%lld,\"p99\":%lld}",
+                         static_cast<long long>(m.count), static_cast<long long>(m.sum),
+                         static_cast<long long>(m.min), static_cast<long long>(m.max),
+                         static_cast<long long>(m.p50), static_cast<long long>(m.p90),
+                         static_cast<long long>(m.p99));
+                histograms += number;
+                break;
+        }
+    }
+
+    const std::string json = "{\"counters\":{" + counters + "},\"gauges\":{" + gauges +
+                             "},\"histograms\":{" + histograms + "}}";
+    *out_json = rac_strdup(json.c_str());
+    return *out_json ? RAC_SUCCESS : RAC_ERROR_OUT_OF_MEMORY;
+}
+
+void rac_metrics_reset(void) {
+    Registry& r = registry();
+    const int32_t count = r.count.load(std::memory_order_acquire);
+    for (int32_t i = 0; i < count; ++i) {
+        Metric& metric = *r.metrics[i].load(std::memory_order_acquire);
+        for (CounterShard& shard : metric.shards) {
+            shard.value.store(0, std::memory_order_relaxed);
+        }
+        metric.gauge.store(0.0, std::memory_order_relaxed);
+        if (Histogram* h = metric.histogram) {
+            for (auto& bucket : h->counts) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            h->sum.store(0, std::memory_order_relaxed);
+            h->min.store(INT64_MAX, std::memory_order_relaxed);
+            h->max.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+}  // extern "C"
@@ -0,0 +1,579 @@
+/**
+ * @file rac_perf_sampler.cpp
+ * @brief RunAnywhere Commons - Continuous On-Device Performance Sampling Implementation
+ *
+ * Each thread keeps a stack of its open spans and a small cache from span
+ * name pointers to stage slots, so timing a span normally takes no lock.
+ * Stage slots live in a fixed table that only grows and is never freed,
+ * like the metrics registry, because spans can end on threads still running
+ * at exit. The system sampling thread is detached and exits when the
+ * generation it was started for is over.
+ */
+
+#include "rac/core/rac_perf_sampler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_analytics_events.h"
+#include "rac/core/rac_logger.h"
+#include "rac/core/rac_thermal_governor.h"
+#include "rac_perf_sampler_internal.h"
+
+static const char* LOG_CAT = "PerfSampler";
+
+namespace {
+
+// =============================================================================
+// HISTOGRAMS
+// =============================================================================
+
+// Durations in microseconds; values below 4 get a bucket each, above, 4
+// buckets per power of two (the rac_metrics layout), up to ~2^41 us
+constexpr int kBuckets = 160;
+
+constexpr int kMaxOpenSpans = 32;
+constexpr int kNameCacheSize = 16;
+
+struct Histogram {
+    std::atomic<uint32_t> counts[kBuckets] = {};
+    std::atomic<int64_t> max_us{0};
+};
+
+struct Stage {
+    std::string name;
+    Histogram by_thermal[RAC_THERMAL_STATE_COUNT];
+};
+
+int bucket_for(int64_t us) {
+    if (us < 4) {
+        return static_cast<int>(std::max<int64_t>(us, 0));
+    }
+    const int msb = 63 - __builtin_clzll(static_cast<unsigned long long>(us));
+    const int sub = static_cast<int>((us >> (msb - 2)) & 3);
+    return std::min((msb - 1) * 4 + sub, kBuckets - 1);
+}
+
+int64_t bucket_lower(int bucket) {
+    if (bucket < 4) {
+        return bucket;
+    }
+    const int msb = bucket / 4 + 1;
+    const int sub = bucket % 4;
+    return static_cast<int64_t>(4 + sub) << (msb - 2);
+}
+
+const char* thermal_name(int state) {
+    switch (state) {
+        case RAC_THERMAL_STATE_FAIR:
+            return "fair";
+        case RAC_THERMAL_STATE_SERIOUS:
+            return "serious";
+        case RAC_THERMAL_STATE_CRITICAL:
+            return "critical";
+        default:
+            return "nominal";
+    }
+}
+
+// =============================================================================
+// STATE
+// =============================================================================
+
+struct Sampler {
+    // Stage table (append-only)
+    std::mutex register_mutex;
+    std::atomic<Stage*> stages[RAC_PERF_SAMPLER_MAX_STAGES] = {};
+    std::atomic<int32_t> stage_count{0};
+
+    std::atomic<int32_t> sample_every{1};
+    std::atomic<int> thermal{RAC_THERMAL_STATE_NOMINAL};
+
+    // Async spans by (name, cookie) -> start
+    std::mutex async_mutex;
+    std::map<std::pair<std::string, int32_t>, int64_t> async_starts;
+
+    // Control and the system sampling thread
+    std::mutex control_mutex;
+    std::condition_variable cv;
+    uint64_t generation = 0;
+    bool running = false;
+    rac_perf_sampler_config_t config = RAC_PERF_SAMPLER_CONFIG_DEFAULT;
+
+    // Current window, guarded by report_mutex
+    std::mutex report_mutex;
+    int64_t window_start_ms = 0;
+    double freq_sum_mhz = 0;
+    int64_t freq_samples = 0;
+};
+
+Sampler& sampler() {
+    // Never destroyed: spans may end on threads still running at exit
+    static Sampler* s = new Sampler();
+    return *s;
+}
+
+struct OpenSpan {
+    const char* name;
+    int64_t start_us;  // -1 if this span is not sampled
+};
+
+struct ThreadSpans {
+    OpenSpan open[kMaxOpenSpans];
+    int depth = 0;
+    uint32_t started = 0;
+    const char* cached_names[kNameCacheSize] = {};
+    Stage* cached_stages[kNameCacheSize] = {};
+    int next_cache_slot = 0;
+};
+
+thread_local ThreadSpans t_spans;
+
+int64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int64_t now_ms() {
+    return now_us() / 1000;
+}
+
+Stage* find_or_register(const char* name) {
+    Sampler& s = sampler();
+    int32_t count = s.stage_count.load(std::memory_order_acquire);
+    for (int32_t i = 0; i < count; ++i) {
+        Stage* stage = s.stages[i].load(std::memory_order_acquire);
+        if (stage->name == name) {
+            return stage;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(s.register_mutex);
+    count = s.stage_count.load(std::memory_order_acquire);
+    for (int32_t i = 0; i < count; ++i) {
+        Stage* stage = s.stages[i].load(std::memory_order_acquire);
+        if (stage->name == name) {
+            return stage;
+        }
+    }
+    if (count >= RAC_PERF_SAMPLER_MAX_STAGES) {
+        return nullptr;
+    }
+    Stage* stage = new (std::nothrow) Stage();
+    if (!stage) {
+        return nullptr;
+    }
+    stage->name = name;
+    s.stages[count].store(stage, std::memory_order_release);
+    s.stage_count.store(count + 1, std::memory_order_release);
+    return stage;
+}
+
+// Span names are nearly always literals; the name check covers reused buffers
+Stage* stage_for(const char* name) {
+    ThreadSpans& t = t_spans;
+    for (int i = 0; i < kNameCacheSize; ++i) {
+        if (t.cached_names[i] == name && t.cached_stages[i]->name == name) {
+            return t.cached_stages[i];
+        }
+    }
+    Stage* stage = find_or_register(name);
+    if (stage) {
+        t.cached_names[t.next_cache_slot] = name;
+        t.cached_stages[t.next_cache_slot] = stage;
+        t.next_cache_slot = (t.next_cache_slot + 1) % kNameCacheSize;
+    }
+    return stage;
+}
+
+void record(const char* name, int64_t duration_us) {
+    Stage* stage = stage_for(name);
+    if (!stage) {
+        return;
+    }
+    Histogram& h = stage->by_thermal[sampler().thermal.load(std::memory_order_relaxed)];
+    h.counts[bucket_for(duration_us)].fetch_add(1, std::memory_order_relaxed);
+    int64_t current = h.max_us.load(std::memory_order_relaxed);
+    while (duration_us > current &&
+           !h.max_us.compare_exchange_weak(current, duration_us, std::memory_order_relaxed)) {
+    }
+}
+
+// =============================================================================
+// SYSTEM SAMPLES
+// =============================================================================
+
+// Mean current frequency of the online cores in MHz (0 without cpufreq)
+double mean_cpu_freq_mhz() {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    double sum_khz = 0;
+    int readable = 0;
+    for (unsigned i = 0; i < cores; ++i) {
+        char path[96];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cpufreq/scaling_cur_freq", i);
+        FILE* file = fopen(path, "r");
+        if (!file) {
+            continue;
+        }
+        long khz = 0;
+        if (fscanf(file, "%ld", &khz) == 1 && khz > 0) {
+            sum_khz += static_cast<double>(khz);
+            readable++;
+        }
+        fclose(file);
+    }
+    return readable > 0 ? sum_khz / readable / 1000.0 : 0.0;
+}
+
+void sample_system() {
+    Sampler& s = sampler();
+    rac_thermal_policy_t policy;
+    rac_thermal_governor_get_policy(&policy);  // polls the thermal source if due
+    rac_power_state_t power;
+    if (rac_thermal_governor_get_state(&power) == RAC_SUCCESS) {
+        s.thermal.store(std::min(std::max(static_cast<int>(power.thermal_state), 0),
+                                 RAC_THERMAL_STATE_COUNT - 1),
+                        std::memory_order_relaxed);
+    }
+
+    const double freq = mean_cpu_freq_mhz();
+    std::lock_guard<std::mutex> lock(s.report_mutex);
+    if (freq > 0) {
+        s.freq_sum_mhz += freq;
+        s.freq_samples++;
+    }
+}
+
+// =============================================================================
+// REPORTS
+// =============================================================================
+
+struct StageReport {
+    const char* stage;
+    int thermal;
+    int64_t count = 0;
+    int64_t p50_us = 0;
+    int64_t p95_us = 0;
+    int64_t p99_us = 0;
+    int64_t max_us = 0;
+    std::string histogram;
+};
+
+// Reads every stage histogram; with reset, the counts are taken out of the window
+std::vector<StageReport> collect(bool reset) {
+    Sampler& s = sampler();
+    std::vector<StageReport> reports;
+    const int32_t count = s.stage_count.load(std::memory_order_acquire);
+    for (int32_t i = 0; i < count; ++i) {
+        Stage* stage = s.stages[i].load(std::memory_order_acquire);
+        for (int thermal = 0; thermal < RAC_THERMAL_STATE_COUNT; ++thermal) {
+            Histogram& h = stage->by_thermal[thermal];
+            uint32_t counts[kBuckets];
+            int64_t total = 0;
+            for (int b = 0; b < kBuckets; ++b) {
+                counts[b] = reset ? h.counts[b].exchange(0, std::memory_order_relaxed)
+                                  : h.counts[b].load(std::memory_order_relaxed);
+                total += counts[b];
+            }
+            const int64_t max_us = reset ? h.max_us.exchange(0, std::memory_order_relaxed)
+                                         : h.max_us.load(std::memory_order_relaxed);
+            if (total == 0) {
+                continue;
+            }
+
+            StageReport report;
+            report.stage = stage->name.c_str();
+            report.thermal = thermal;
+            report.count = total;
+            report.max_us = max_us;
+            const double quantiles[3] = {0.50, 0.95, 0.99};
+            int64_t* outputs[3] = {&report.p50_us, &report.p95_us, &report.p99_us};
+            for (int q = 0; q < 3; ++q) {
+                const int64_t rank =
+                    std::max<int64_t>(1, static_cast<int64_t>(quantiles[q] * total));
+                int64_t seen = 0;
+                for (int b = 0; b < kBuckets; ++b) {
+                    seen += counts[b];
+                    if (seen >= rank) {
+                        *outputs[q] = std::min(bucket_lower(b + 1), max_us);
+                        break;
+                    }
+                }
+            }
+            char pair[48];
+            for (int b = 0; b < kBuckets; ++b) {
+                if (counts[b] == 0) {
+                    continue;
+                }
+                snprintf(pair, sizeof(pair), "%s%lld:%u", report.histogram.empty() ? "" : ",",
+                         static_cast<long long>(bucket_lower(b)), counts[b]);
+                report.histogram += pair;
+            }
+            reports.push_back(std::move(report));
+        }
+    }
+    return reports;
+}
+
+void emit_reports() {
+    Sampler& s = sampler();
+    std::lock_guard<std::mutex> lock(s.report_mutex);
+    const int64_t now = now_ms();
+    const double window_ms = static_cast<double>(now - s.window_start_ms);
+    const double freq_mhz =
+        s.freq_samples > 0 ? s.freq_sum_mhz / static_cast<double>(s.freq_samples) : 0.0;
+
+    const std::vector<StageReport> reports = collect(true);
+    for (const StageReport& report : reports) {
+        rac_analytics_event_data_t event = {};
+        event.type = RAC_EVENT_DEVICE_PERF_SAMPLED;
+        event.data.perf_sample = RAC_ANALYTICS_PERF_SAMPLE_DEFAULT;
+        event.data.perf_sample.stage = report.stage;
+        event.data.perf_sample.thermal_state = thermal_name(report.thermal);
+        event.data.perf_sample.count = static_cast<int32_t>(report.count);
+        event.data.perf_sample.p50_ms = report.p50_us / 1000.0;
+        event.data.perf_sample.p95_ms = report.p95_us / 1000.0;
+        event.data.perf_sample.p99_ms = report.p99_us / 1000.0;
+        event.data.perf_sample.max_ms = report.max_us / 1000.0;
+        event.data.perf_sample.histogram = report.histogram.c_str();
+        event.data.perf_sample.cpu_freq_mhz = freq_mhz;
+        event.data.perf_sample.window_ms = window_ms;
+        rac_analytics_event_emit(RAC_EVENT_DEVICE_PERF_SAMPLED, &event);
+    }
+    if (!reports.empty()) {
+        RAC_LOG_DEBUG(LOG_CAT, "Reported %zu stage histograms over %.0f ms", reports.size(),
+                      window_ms);
+    }
+
+    s.window_start_ms = now;
+    s.freq_sum_mhz = 0;
+    s.freq_samples = 0;
+}
+
+void sampler_loop(uint64_t generation) {
+    Sampler& s = sampler();
+    int64_t last_report_ms = now_ms();
+    for (;;) {
+        std::unique_lock<std::mutex> lock(s.control_mutex);
+        s.cv.wait_for(lock, std::chrono::milliseconds(s.config.system_sample_interval_ms),
+                      [&] { return s.generation != generation; });
+        if (s.generation != generation) {
+            return;
+        }
+        const int32_t report_interval_ms = s.config.report_interval_ms;
+        lock.unlock();
+
+        sample_system();
+        const int64_t now = now_ms();
+        if (report_interval_ms > 0 && now - last_report_ms >= report_interval_ms) {
+            emit_reports();
+            last_report_ms = now;
+        }
+    }
+}
+
+}  // namespace
+
+// =============================================================================
+// TRACE HOOKS
+// =============================================================================
+
+namespace rac {
+namespace perf_sampler {
+
+void span_begin(const char* name) {
+    ThreadSpans& t = t_spans;
+    // Once a span is open, keep pushing so ends stay matched after a stop
+    if (!active() && t.depth == 0) {
+        return;
+    }
+    if (t.depth >= kMaxOpenSpans) {
+        t.depth++;
+        return;
+    }
+    const int32_t every = sampler().sample_every.load(std::memory_order_relaxed);
+    const bool sampled = active() && name && (every <= 1 || t.started++ % every == 0);
+    t.open[t.depth] = {name, sampled ? now_us() : -1};
+    t.depth++;
+}
+
+void span_end() {
+    ThreadSpans& t = t_spans;
+    if (t.depth == 0) {
+        return;
+    }
+    t.depth--;
+    if (t.depth >= kMaxOpenSpans) {
+        return;
+    }
+    const OpenSpan& span = t.open[t.depth];
+    if (span.start_us >= 0 && active()) {
+        record(span.name, now_us() - span.start_us);
+    }
+}
+
+void async_begin(const char* name, int32_t cookie) {
+    if (!active() || !name) {
+        return;
+    }
+    Sampler& s = sampler();
+    std::lock_guard<std::mutex> lock(s.async_mutex);
+    // Bounded in case ends get lost
+    if (s.async_starts.size() < 256) {
+        s.async_starts[{name, cookie}] = now_us();
+    }
+}
+
+void async_end(const char* name, int32_t cookie) {
+    if (!name) {
+        return;
+    }
+    Sampler& s = sampler();
+    int64_t start_us;
+    {
+        std::lock_guard<std::mutex> lock(s.async_mutex);
+        auto it = s.async_starts.find({name, cookie});
+        if (it == s.async_starts.end()) {
+            return;
+        }
+        start_us = it->second;
+        s.async_starts.erase(it);
+    }
+    if (active()) {
+        record(name, now_us() - start_us);
+    }
+}
+
+}  // namespace perf_sampler
+}  // namespace rac
+
+// =============================================================================
+// PUBLIC API IMPLEMENTATION
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_perf_sampler_start(const rac_perf_sampler_config_t* config) {
+    const rac_perf_sampler_config_t cfg = config ? *config : RAC_PERF_SAMPLER_CONFIG_DEFAULT;
+    if (cfg.span_sample_every <= 0 || cfg.system_sample_interval_ms <= 0 ||
+        cfg.report_interval_ms < 0) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    Sampler& s = sampler();
+    std::lock_guard<std::mutex> lock(s.control_mutex);
+    s.config = cfg;
+    s.sample_every.store(cfg.span_sample_every, std::memory_order_relaxed);
+    if (s.running) {
+        // The loop picks up the new intervals on its next wake
+        s.cv.notify_all();
+        return RAC_SUCCESS;
+    }
+
+    {
+        std::lock_guard<std::mutex> report_lock(s.report_mutex);
+        s.window_start_ms = now_ms();
+        s.freq_sum_mhz = 0;
+        s.freq_samples = 0;
+    }
+    const uint64_t generation = ++s.generation;
+    try {
+        std::thread(sampler_loop, generation).detach();
+    } catch (...) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    s.running = true;
+    rac::perf_sampler::g_active.store(true, std::memory_order_relaxed);
+    RAC_LOG_INFO(LOG_CAT, "Sampling started (1/%d spans, system every %d ms, report every %d ms)",
+                 cfg.span_sample_every, cfg.system_sample_interval_ms, cfg.report_interval_ms);
+    return RAC_SUCCESS;
+}
+
+void rac_perf_sampler_stop(void) {
+    Sampler& s = sampler();
+    {
+        std::lock_guard<std::mutex> lock(s.control_mutex);
+        if (!s.running) {
+            return;
+        }
+        s.running = false;
+        s.generation++;
+        rac::perf_sampler::g_active.store(false, std::memory_order_relaxed);
+    }
+    s.cv.notify_all();
+    emit_reports();
+    RAC_LOG_INFO(LOG_CAT, "Sampling stopped");
+}
+
+rac_bool_t rac_perf_sampler_is_running(void) {
+    return rac::perf_sampler::active() ? RAC_TRUE : RAC_FALSE;
+}
+
+rac_result_t rac_perf_sampler_report(void) {
+    if (!rac::perf_sampler::active()) {
+        return RAC_ERROR_INVALID_STATE;
+    }
+    emit_reports();
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_perf_sampler_snapshot_json(char** out_json) {
+    if (!out_json) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    Sampler& s = sampler();
+    std::string json;
+    char number[256];
+    {
+        std::lock_guard<std::mutex> lock(s.report_mutex);
+        const int64_t window_ms = s.window_start_ms > 0 ? now_ms() - s.window_start_ms : 0;
+        const double freq_mhz =
+            s.freq_samples > 0 ? s.freq_sum_mhz / static_cast<double>(s.freq_samples) : 0.0;
+        snprintf(number, sizeof(number),
+                 "{\"window_ms\":%lld,\"cpu_freq_mhz\":%.1f,\"thermal_state\":\"%s\",\"stages\":[",
+                 static_cast<long long>(window_ms), freq_mhz,
+                 thermal_name(s.thermal.load(std::memory_order_relaxed)));
+        json = number;
+
+        bool first = true;
+        for (const StageReport& report : collect(false)) {
+            json += first ? "{\"stage\":\"" : ",{\"stage\":\"";
+            first = false;
+            for (const char* c = report.stage; *c; ++c) {
+                if (*c == '"' || *c == '\\') {
+                    json += '\\';
+                }
+                if (static_cast<unsigned char>(*c) >= 0x20) {
+                    json += *c;
+                }
+            }
+            snprintf(number, sizeof(number),
+                     "\",\"thermal_state\":\"%s\",\"count\":%lld,\"p50_ms\":%.3f,"
+                     "\"p95_ms\":%.3f,\"p99_ms\":%.3f,\"max_ms\":%.3f,\"histogram\":\"",
+                     thermal_name(report.thermal), static_cast<long long>(report.count),
+                     report.p50_us / 1000.0, report.p95_us / 1000.0, report.p99_us / 1000.0,
+                     report.max_us / 1000.0);
+            json += number;
+            json += report.histogram;
+            json += "\"}";
+        }
+    }
+    json += "]}";
+
+    *out_json = rac_strdup_tagged(RAC_ALLOC_TAG_TELEMETRY, json.c_str());
+    return *out_json ? RAC_SUCCESS : RAC_ERROR_OUT_OF_MEMORY;
+}
+
+}  // extern "C"
@@ -0,0 +1,33 @@
+/**
+ * @file rac_perf_sampler_internal.h
+ * @brief RunAnywhere Commons - Perf Sampler Hooks for the Trace API
+ *
+ * rac_trace.cpp calls these on every span so the sampler can time spans
+ * without a profiler attached. Not part of the public API.
+ */
+
+#ifndef RAC_PERF_SAMPLER_INTERNAL_H
+#define RAC_PERF_SAMPLER_INTERNAL_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace rac {
+namespace perf_sampler {
+
+inline std::atomic<bool> g_active{false};
+
+/** Whether spans are being timed (one relaxed load) */
+inline bool active() {
+    return g_active.load(std::memory_order_relaxed);
+}
+
+void span_begin(const char* name);
+void span_end();
+void async_begin(const char* name, int32_t cookie);
+void async_end(const char* name, int32_t cookie);
+
+}  // namespace perf_sampler
+}  // namespace rac
+
+#endif /* RAC_PERF_SAMPLER_INTERNAL_H */
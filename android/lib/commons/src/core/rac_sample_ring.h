@@ -0,0 +1,72 @@
+/**
+ * @file rac_sample_ring.h
+ * @brief RunAnywhere Commons - Lock-free Sample Ring
+ *
+ * Hand-off of capture audio to a worker thread, shared by the VAD pipeline,
+ * voice sessions and native capture. Not part of the public API.
+ */
+
+#ifndef RAC_SAMPLE_RING_H
+#define RAC_SAMPLE_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace rac {
+
+/**
+ * Single-producer/single-consumer ring of samples. The producer (capture
+ * thread) and consumer (pipeline worker) each own one index, so neither side
+ * ever waits on the other.
+ */
+class SampleRing {
+   public:
+    explicit SampleRing(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        buffer_.resize(size);
+        mask_ = size - 1;
+    }
+
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    // Producer side; returns the number of samples that fitted
+    size_t write(const float* samples, size_t count) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t n = std::min(count, buffer_.size() - (head - tail));
+        for (size_t i = 0; i < n; ++i) {
+            buffer_[(head + i) & mask_] = samples[i];
+        }
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side
+    size_t read(float* out, size_t max_count) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t n = std::min(max_count, head - tail);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = buffer_[(tail + i) & mask_];
+        }
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+   private:
+    std::vector<float> buffer_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+}  // namespace rac
+
+#endif /* RAC_SAMPLE_RING_H */
@@ -0,0 +1,238 @@
+/**
+ * @file rac_sha256.cpp
+ * @brief RunAnywhere Commons - Incremental SHA-256 Implementation
+ *
+ * Apple arm64 CPUs all have the SHA-256 instructions, so they are selected
+ * at compile time there. Android and Linux arm64 CPUs may lack them: that
+ * path is compiled with a target attribute and only used when the kernel
+ * reports HWCAP_SHA2.
+ */
+
+#include "rac/core/rac_sha256.h"
+
+#include <cstring>
+
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#include <arm_neon.h>
+#define RAC_SHA256_ARMV8 1
+#elif defined(__aarch64__) && defined(__linux__) && \
+    ((defined(__clang__) && __clang_major__ >= 16) || (!defined(__clang__) && __GNUC__ >= 10))
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#define RAC_SHA256_ARMV8 1
+#define RAC_SHA256_ARMV8_RUNTIME 1
+#endif
+
+namespace {
+
+using CompressFn = void (*)(uint32_t*, const uint8_t*, size_t);
+
+constexpr uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+    0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+    0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+    0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2};
+
+// =============================================================================
+// SCALAR REFERENCE
+// =============================================================================
+
+inline uint32_t rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+void scalar_compress(uint32_t* state, const uint8_t* data, size_t blocks) {
+    for (; blocks > 0; --blocks, data += 64) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (static_cast<uint32_t>(data[4 * i]) << 24) |
+                   (static_cast<uint32_t>(data[4 * i + 1]) << 16) |
+                   (static_cast<uint32_t>(data[4 * i + 2]) << 8) | data[4 * i + 3];
+        }
+        for (int i = 16; i < 64; ++i) {
+            const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            const uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+            const uint32_t ch = (e & f) ^ (~e & g);
+            const uint32_t t1 = h + s1 + ch + kRoundConstants[i] + w[i];
+            const uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+            const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + s0 + maj;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+// =============================================================================
+// ARMV8 CRYPTO EXTENSIONS
+// =============================================================================
+
+#if RAC_SHA256_ARMV8
+
+#if !RAC_SHA256_ARMV8_RUNTIME
+#define RAC_SHA2
+#elif defined(__clang__)
+#define RAC_SHA2 __attribute__((target("sha2")))
+#else
+#define RAC_SHA2 __attribute__((target("+sha2")))
+#endif
+
+RAC_SHA2 void armv8_compress(uint32_t* state, const uint8_t* data, size_t blocks) {
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32x4_t efgh = vld1q_u32(state + 4);
+    for (; blocks > 0; --blocks, data += 64) {
+        const uint32x4_t abcd_start = abcd;
+        const uint32x4_t efgh_start = efgh;
+        uint32x4_t w[4];
+        for (int i = 0; i < 4; ++i) {
+            w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+        }
+        // Each step runs 4 rounds, then extends the schedule by the 4 words
+        // needed 4 steps later
+        for (int i = 0; i < 16; ++i) {
+            const uint32x4_t wk = vaddq_u32(w[i % 4], vld1q_u32(&kRoundConstants[4 * i]));
+            const uint32x4_t abcd_prev = abcd;
+            abcd = vsha256hq_u32(abcd, efgh, wk);
+            efgh = vsha256h2q_u32(efgh, abcd_prev, wk);
+            if (i < 12) {
+                w[i % 4] = vsha256su1q_u32(vsha256su0q_u32(w[i % 4], w[(i + 1) % 4]),
+                                           w[(i + 2) % 4], w[(i + 3) % 4]);
+            }
+        }
+        abcd = vaddq_u32(abcd, abcd_start);
+        efgh = vaddq_u32(efgh, efgh_start);
+    }
+    vst1q_u32(state, abcd);
+    vst1q_u32(state + 4, efgh);
+}
+
+#undef RAC_SHA2
+
+#endif  // RAC_SHA256_ARMV8
+
+// =============================================================================
+// DISPATCH
+// =============================================================================
+
+struct Implementation {
+    const char* isa;
+    CompressFn compress;
+};
+
+Implementation select_implementation() {
+#if RAC_SHA256_ARMV8_RUNTIME
+    if (getauxval(AT_HWCAP) & HWCAP_SHA2) {
+        return {"armv8", armv8_compress};
+    }
+    return {"scalar", scalar_compress};
+#elif RAC_SHA256_ARMV8
+    return {"armv8", armv8_compress};
+#else
+    return {"scalar", scalar_compress};
+#endif
+}
+
+const Implementation& implementation() {
+    static const Implementation impl = select_implementation();
+    return impl;
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+void rac_sha256_init(rac_sha256_t* ctx) {
+    static const uint32_t kInitialState[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                              0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    memcpy(ctx->state, kInitialState, sizeof(kInitialState));
+    ctx->length = 0;
+}
+
+void rac_sha256_update(rac_sha256_t* ctx, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const CompressFn compress = implementation().compress;
+    size_t buffered = static_cast<size_t>(ctx->length % 64);
+    ctx->length += size;
+
+    if (buffered > 0) {
+        const size_t take = size < 64 - buffered ? size : 64 - buffered;
+        memcpy(ctx->buffer + buffered, bytes, take);
+        bytes += take;
+        size -= take;
+        buffered += take;
+        if (buffered < 64) {
+            return;
+        }
+        compress(ctx->state, ctx->buffer, 1);
+    }
+    if (size >= 64) {
+        compress(ctx->state, bytes, size / 64);
+        bytes += size & ~static_cast<size_t>(63);
+        size %= 64;
+    }
+    memcpy(ctx->buffer, bytes, size);
+}
+
+void rac_sha256_final(rac_sha256_t* ctx, uint8_t out_digest[RAC_SHA256_DIGEST_SIZE]) {
+    const uint64_t bit_length = ctx->length * 8;
+    uint8_t padding[72] = {0x80};
+    // Pad to 56 bytes past a block boundary, then append the length in bits
+    const size_t pad = 64 - static_cast<size_t>((ctx->length + 8) % 64);
+    for (int i = 0; i < 8; ++i) {
+        padding[pad + i] = static_cast<uint8_t>(bit_length >> (56 - 8 * i));
+    }
+    rac_sha256_update(ctx, padding, pad + 8);
+
+    for (int i = 0; i < 8; ++i) {
+        out_digest[4 * i] = static_cast<uint8_t>(ctx->state[i] >> 24);
+        out_digest[4 * i + 1] = static_cast<uint8_t>(ctx->state[i] >> 16);
+        out_digest[4 * i + 2] = static_cast<uint8_t>(ctx->state[i] >> 8);
+        out_digest[4 * i + 3] = static_cast<uint8_t>(ctx->state[i]);
+    }
+}
+
+void rac_sha256_to_hex(const uint8_t digest[RAC_SHA256_DIGEST_SIZE], char* out_hex) {
+    static const char kDigits[] = "0123456789abcdef";
+    for (int i = 0; i < RAC_SHA256_DIGEST_SIZE; ++i) {
+        out_hex[2 * i] = kDigits[digest[i] >> 4];
+        out_hex[2 * i + 1] = kDigits[digest[i] & 0x0f];
+    }
+    out_hex[RAC_SHA256_HEX_LENGTH] = '\0';
+}
+
+const char* rac_sha256_isa(void) {
+    return implementation().isa;
+}
+
+}  // extern "C"
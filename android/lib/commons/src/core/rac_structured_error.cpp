@@ -1,6 +1,11 @@
 /**
  * @file rac_structured_error.cpp
  * @brief RunAnywhere Commons - Structured Error Implementation
+ *
+ * rac_set_error and rac_error_log_and_track build the error in the calling
+ * thread's last-error slot rather than allocating one, and only clear the
+ * fields they use. Expected errors (cancellations) stop there: the stack is
+ * captured and JSON is formatted only for errors that are logged and tracked.
  */
 
 #include "rac/core/rac_structured_error.h"
@@ -12,6 +17,7 @@
 #include <ctime>
 #include <mutex>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
 #include "rac/core/rac_platform_adapter.h"
 
@@ -53,6 +59,69 @@ int64_t current_timestamp_ms() {
     return static_cast<int64_t>(time(nullptr)) * 1000;
 }
 
+// Clears what a C reader of the error sees: scalars, counts and the first
+// byte of each string (the ~6 KB of string buffers are left as they are)
+void reset_error(rac_error_t* error) {
+    error->code = RAC_SUCCESS;
+    error->category = RAC_CATEGORY_GENERAL;
+    error->message[0] = '\0';
+    error->source_file[0] = '\0';
+    error->source_line = 0;
+    error->source_function[0] = '\0';
+    error->stack_frame_count = 0;
+    error->underlying_code = RAC_SUCCESS;
+    error->underlying_message[0] = '\0';
+    error->model_id[0] = '\0';
+    error->framework[0] = '\0';
+    error->session_id[0] = '\0';
+    error->timestamp_ms = 0;
+    error->custom_key1[0] = '\0';
+    error->custom_value1[0] = '\0';
+    error->custom_key2[0] = '\0';
+    error->custom_value2[0] = '\0';
+    error->custom_key3[0] = '\0';
+    error->custom_value3[0] = '\0';
+}
+
+// Starts a new last error for this thread in place
+rac_error_t* begin_last_error(rac_result_t code, rac_error_category_t category,
+                              const char* message) {
+    rac_error_t* error = &g_last_error;
+
+    // The message may be one of the previous error's strings
+    char saved[RAC_MAX_ERROR_MESSAGE];
+    const char* begin = reinterpret_cast<const char*>(error);
+    if (message && message >= begin && message < begin + sizeof(rac_error_t)) {
+        safe_strcpy(saved, sizeof(saved), message);
+        message = saved;
+    }
+
+    reset_error(error);
+    error->code = code;
+    error->category = category;
+    safe_strcpy(error->message, sizeof(error->message), message);
+    error->timestamp_ms = current_timestamp_ms();
+    g_has_last_error = true;
+    return error;
+}
+
+// Logs and tracks an error that is not expected; the stack is captured here
+void report_error(rac_error_t* error, const rac_log_metadata_t* meta) {
+    rac_error_capture_stack_trace(error);
+    rac_logger_log(RAC_LOG_ERROR, rac_error_category_name(error->category), error->message,
+                   meta);
+
+    // Track error via platform adapter (for Sentry)
+    const rac_platform_adapter_t* adapter = rac_get_platform_adapter();
+    if (adapter && adapter->track_error) {
+        char* json = rac_error_to_json(error);
+        if (json) {
+            adapter->track_error(json, adapter->user_data);
+            rac_free(json);
+        }
+    }
+}
+
 }  // anonymous namespace
 
 // =============================================================================
@@ -63,7 +132,8 @@ extern "C" {
 
 rac_error_t* rac_error_create(rac_result_t code, rac_error_category_t category,
                               const char* message) {
-    rac_error_t* error = static_cast<rac_error_t*>(calloc(1, sizeof(rac_error_t)));
+    rac_error_t* error = static_cast<rac_error_t*>(
+        rac_calloc_tagged(RAC_ALLOC_TAG_ERROR, 1, sizeof(rac_error_t)));
     if (!error)
         return nullptr;
 
@@ -97,14 +167,15 @@ rac_error_t* rac_error_createf(rac_result_t code, rac_error_category_t category,
 }
 
 void rac_error_destroy(rac_error_t* error) {
-    free(error);
+    rac_free(error);
 }
 
 rac_error_t* rac_error_copy(const rac_error_t* error) {
     if (!error)
         return nullptr;
 
-    rac_error_t* copy = static_cast<rac_error_t*>(malloc(sizeof(rac_error_t)));
+    rac_error_t* copy =
+        static_cast<rac_error_t*>(rac_alloc_tagged(RAC_ALLOC_TAG_ERROR, sizeof(rac_error_t)));
     if (copy) {
         memcpy(copy, error, sizeof(rac_error_t));
     }
@@ -604,7 +675,7 @@ char* rac_error_to_json(const rac_error_t* error) {
 
     // Allocate buffer for JSON
     size_t buffer_size = 4096;
-    char* json = static_cast<char*>(malloc(buffer_size));
+    char* json = static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_ERROR, buffer_size));
     if (!json)
         return nullptr;
 
@@ -710,18 +781,19 @@ int32_t rac_error_get_telemetry_properties(const rac_error_t* error, char** out_
     int32_t count = 0;
 
     // Error code
-    out_keys[count] = strdup("error_code");
-    out_values[count] = strdup(rac_error_code_name(error->code));
+    out_keys[count] = rac_strdup_tagged(RAC_ALLOC_TAG_ERROR, "error_code");
+    out_values[count] = rac_strdup_tagged(RAC_ALLOC_TAG_ERROR, rac_error_code_name(error->code));
     count++;
 
     // Error category
-    out_keys[count] = strdup("error_category");
-    out_values[count] = strdup(rac_error_category_name(error->category));
+    out_keys[count] = rac_strdup_tagged(RAC_ALLOC_TAG_ERROR, "error_category");
+    out_values[count] =
+        rac_strdup_tagged(RAC_ALLOC_TAG_ERROR, rac_error_category_name(error->category));
     count++;
 
     // Error message
-    out_keys[count] = strdup("error_message");
-    out_values[count] = strdup(error->message);
+    out_keys[count] = rac_strdup_tagged(RAC_ALLOC_TAG_ERROR, "error_message");
+    out_values[count] = rac_strdup_tagged(RAC_ALLOC_TAG_ERROR, error->message);
     count++;
 
     return count;
@@ -732,7 +804,7 @@ char* rac_error_to_string(const rac_error_t* error) {
         return nullptr;
 
     size_t size = 512;
-    char* str = static_cast<char*>(malloc(size));
+    char* str = static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_ERROR, size));
     if (!str)
         return nullptr;
 
@@ -747,7 +819,7 @@ char* rac_error_to_debug_string(const rac_error_t* error) {
         return nullptr;
 
     size_t size = 2048;
-    char* str = static_cast<char*>(malloc(size));
+    char* str = static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_ERROR, size));
     if (!str)
         return nullptr;
 
@@ -807,20 +879,16 @@ const rac_error_t* rac_get_last_error(void) {
 }
 
 void rac_clear_last_error(void) {
-    memset(&g_last_error, 0, sizeof(rac_error_t));
+    reset_error(&g_last_error);
     g_has_last_error = false;
 }
 
 rac_result_t rac_set_error(rac_result_t code, rac_error_category_t category, const char* message) {
-    rac_error_t* error = rac_error_create(code, category, message);
-    if (error) {
-        // Log the error
-        if (rac_error_is_expected(code) == 0) {
-            RAC_LOG_ERROR(rac_error_category_name(category), "%s (code: %d)", message, code);
-        }
+    begin_last_error(code, category, message);
 
-        rac_set_last_error(error);
-        rac_error_destroy(error);
+    // Log the error
+    if (rac_error_is_expected(code) == 0) {
+        RAC_LOG_ERROR(rac_error_category_name(category), "%s (code: %d)", message, code);
     }
     return code;
 }
@@ -832,43 +900,22 @@ rac_result_t rac_set_error(rac_result_t code, rac_error_category_t category, con
 rac_result_t rac_error_log_and_track(rac_result_t code, rac_error_category_t category,
                                      const char* message, const char* file, int32_t line,
                                      const char* function) {
-    // Create structured error with source location
-    rac_error_t* error = rac_error_create_at(code, category, message, file, line, function);
-    if (!error) {
-        return code;
-    }
-
-    // Capture stack trace
-    rac_error_capture_stack_trace(error);
-
-    // Set as last error
-    rac_set_last_error(error);
+    // Build the structured error with source location as the last error
+    rac_error_t* error = begin_last_error(code, category, message);
+    rac_error_set_source(error, file, line, function);
 
     // Skip logging and tracking for expected errors (cancellation, etc.)
     if (rac_error_is_expected(code) != 0) {
-        rac_error_destroy(error);
         return code;
     }
 
-    // Log the error
+    // Log and track the error
     rac_log_metadata_t meta = RAC_LOG_METADATA_EMPTY;
     meta.file = file;
     meta.line = line;
     meta.function = function;
     meta.error_code = code;
-    rac_logger_log(RAC_LOG_ERROR, rac_error_category_name(category), message, &meta);
-
-    // Track error via platform adapter (for Sentry)
-    const rac_platform_adapter_t* adapter = rac_get_platform_adapter();
-    if (adapter && adapter->track_error) {
-        char* json = rac_error_to_json(error);
-        if (json) {
-            adapter->track_error(json, adapter->user_data);
-            rac_free(json);
-        }
-    }
-
-    rac_error_destroy(error);
+    report_error(error, &meta);
     return code;
 }
 
@@ -876,28 +923,17 @@ rac_result_t rac_error_log_and_track_model(rac_result_t code, rac_error_category
                                            const char* message, const char* model_id,
                                            const char* framework, const char* file, int32_t line,
                                            const char* function) {
-    // Create structured error with source location
-    rac_error_t* error = rac_error_create_at(code, category, message, file, line, function);
-    if (!error) {
-        return code;
-    }
-
-    // Add model context
+    // Build the structured error with source location and model context
+    rac_error_t* error = begin_last_error(code, category, message);
+    rac_error_set_source(error, file, line, function);
     rac_error_set_model_context(error, model_id, framework);
 
-    // Capture stack trace
-    rac_error_capture_stack_trace(error);
-
-    // Set as last error
-    rac_set_last_error(error);
-
     // Skip logging and tracking for expected errors
     if (rac_error_is_expected(code) != 0) {
-        rac_error_destroy(error);
         return code;
     }
 
-    // Log the error with model context
+    // Log and track the error with model context
     rac_log_metadata_t meta = RAC_LOG_METADATA_EMPTY;
     meta.file = file;
     meta.line = line;
@@ -905,19 +941,7 @@ rac_result_t rac_error_log_and_track_model(rac_result_t code, rac_error_category
     meta.error_code = code;
     meta.model_id = model_id;
     meta.framework = framework;
-    rac_logger_log(RAC_LOG_ERROR, rac_error_category_name(category), message, &meta);
-
-    // Track error via platform adapter (for Sentry)
-    const rac_platform_adapter_t* adapter = rac_get_platform_adapter();
-    if (adapter && adapter->track_error) {
-        char* json = rac_error_to_json(error);
-        if (json) {
-            adapter->track_error(json, adapter->user_data);
-            rac_free(json);
-        }
-    }
-
-    rac_error_destroy(error);
+    report_error(error, &meta);
     return code;
 }
 
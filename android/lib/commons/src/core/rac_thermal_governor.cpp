@@ -0,0 +1,250 @@
+/**
+ * @file rac_thermal_governor.cpp
+ * @brief RunAnywhere Commons - Thermal and Battery Governor Implementation
+ *
+ * State lives under one mutex; backends take it once per decode step, which
+ * is negligible next to the step itself. The thermal source is polled lazily
+ * from rac_thermal_governor_get_policy, so nothing runs while no model is
+ * generating. The thread share is pushed to the CPU budget when the level
+ * changes, and the budget's grants reach the backends from there.
+ */
+
+#include "rac/core/rac_thermal_governor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+#if defined(__ANDROID__)
+#include <dlfcn.h>
+#endif
+
+#include "rac/core/rac_cpu_budget.h"
+#include "rac/core/rac_logger.h"
+#include "rac/core/rac_platform_adapter.h"
+
+static const char* LOG_CAT = "ThermalGovernor";
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr float kSmoothing = 0.2f;
+// Longest pause per step, so a stale measurement cannot stall generation
+constexpr int64_t kMaxPauseUs = 250000;
+
+const rac_thermal_policy_t kUnrestricted = {100, 0, 0.0f};
+
+#if defined(__ANDROID__)
+// NDK thermal API (API level 30), resolved at runtime so older releases load
+struct AThermalManager;
+using AcquireManagerFn = AThermalManager* (*)();
+using GetStatusFn = int (*)(AThermalManager*);
+
+// AThermalStatus values
+constexpr int kThermalStatusLight = 1;
+constexpr int kThermalStatusModerate = 2;
+constexpr int kThermalStatusSevere = 3;
+#endif
+
+struct Governor {
+    std::mutex mutex;
+    rac_thermal_governor_config_t config = RAC_THERMAL_GOVERNOR_CONFIG_DEFAULT;
+    rac_power_state_t state = {RAC_THERMAL_STATE_NOMINAL, -1.0f, RAC_FALSE, RAC_FALSE};
+    rac_thermal_state_t level = RAC_THERMAL_STATE_NOMINAL;
+    Clock::time_point next_poll;
+    int32_t applied_core_percent = 100;
+    // Decode speed at the nominal level, tokens per second
+    float nominal_rate = 0.0f;
+#if defined(__ANDROID__)
+    bool ndk_resolved = false;
+    AThermalManager* thermal_manager = nullptr;
+    GetStatusFn get_status = nullptr;
+#endif
+};
+
+Governor& governor() {
+    static Governor instance;
+    return instance;
+}
+
+#if defined(__ANDROID__)
+bool poll_ndk_locked(Governor& g, rac_thermal_state_t* out_state) {
+    if (!g.ndk_resolved) {
+        g.ndk_resolved = true;
+        void* android = dlopen("libandroid.so", RTLD_NOW);
+        auto acquire = android ? reinterpret_cast<AcquireManagerFn>(
+                                     dlsym(android, "AThermal_acquireManager"))
+                               : nullptr;
+        g.get_status = android ? reinterpret_cast<GetStatusFn>(
+                                     dlsym(android, "AThermal_getCurrentThermalStatus"))
+                               : nullptr;
+        g.thermal_manager = acquire && g.get_status ? acquire() : nullptr;
+        RAC_LOG_INFO(LOG_CAT, "AThermal %s", g.thermal_manager ? "available" : "unavailable");
+    }
+    if (!g.thermal_manager) {
+        return false;
+    }
+    const int status = g.get_status(g.thermal_manager);
+    if (status < 0) {
+        return false;
+    }
+    *out_state = status >= kThermalStatusSevere     ? RAC_THERMAL_STATE_CRITICAL
+                 : status >= kThermalStatusModerate ? RAC_THERMAL_STATE_SERIOUS
+                 : status >= kThermalStatusLight    ? RAC_THERMAL_STATE_FAIR
+                                                    : RAC_THERMAL_STATE_NOMINAL;
+    return true;
+}
+#endif
+
+// Caller holds g.mutex
+void poll_locked(Governor& g) {
+    const Clock::time_point now = Clock::now();
+    if (now < g.next_poll) {
+        return;
+    }
+    g.next_poll = now + std::chrono::milliseconds(std::max(0, g.config.poll_interval_ms));
+
+    rac_thermal_state_t polled = g.state.thermal_state;
+#if defined(__ANDROID__)
+    if (poll_ndk_locked(g, &polled)) {
+        g.state.thermal_state = polled;
+        return;
+    }
+#endif
+    const rac_platform_adapter_t* adapter = rac_get_platform_adapter();
+    if (adapter && adapter->get_thermal_state &&
+        adapter->get_thermal_state(&polled, adapter->user_data) == RAC_SUCCESS) {
+        g.state.thermal_state = polled;
+    }
+}
+
+// Caller holds g.mutex; returns the core share to push to the CPU budget,
+// or 0 if it has not changed
+int32_t update_level_locked(Governor& g) {
+    rac_thermal_state_t level = RAC_THERMAL_STATE_NOMINAL;
+    if (g.config.enabled) {
+        level = std::min(std::max(g.state.thermal_state, RAC_THERMAL_STATE_NOMINAL),
+                         RAC_THERMAL_STATE_CRITICAL);
+        const bool low_battery = g.config.low_battery_level > 0.0f &&
+                                 g.state.battery_level >= 0.0f &&
+                                 g.state.battery_level < g.config.low_battery_level &&
+                                 !g.state.is_charging;
+        if ((low_battery || g.state.power_save_mode) && level < RAC_THERMAL_STATE_FAIR) {
+            level = RAC_THERMAL_STATE_FAIR;
+        }
+    }
+    if (level != g.level) {
+        RAC_LOG_INFO(LOG_CAT, "Thermal level %d -> %d", static_cast<int>(g.level),
+                     static_cast<int>(level));
+        g.level = level;
+    }
+
+    const int32_t percent =
+        g.config.enabled ? std::min(std::max(g.config.policies[level].core_percent, 1), 100) : 100;
+    if (percent == g.applied_core_percent) {
+        return 0;
+    }
+    g.applied_core_percent = percent;
+    return percent;
+}
+
+void apply_core_percent(int32_t percent) {
+    if (percent > 0) {
+        rac_cpu_budget_set_core_percent(percent);
+    }
+}
+
+}  // namespace
+
+extern "C" {
+
+rac_result_t rac_thermal_governor_configure(const rac_thermal_governor_config_t* config) {
+    const rac_thermal_governor_config_t& cfg = config ? *config
+                                                      : RAC_THERMAL_GOVERNOR_CONFIG_DEFAULT;
+    for (const rac_thermal_policy_t& policy : cfg.policies) {
+        if (policy.core_percent < 1 || policy.core_percent > 100 || policy.max_batch_tokens < 0 ||
+            policy.pace_fraction < 0.0f || policy.pace_fraction > 1.0f) {
+            return RAC_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    Governor& g = governor();
+    int32_t percent;
+    {
+        std::lock_guard<std::mutex> lock(g.mutex);
+        g.config = cfg;
+        g.next_poll = Clock::time_point();
+        percent = update_level_locked(g);
+    }
+    apply_core_percent(percent);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_thermal_governor_report(const rac_power_state_t* state) {
+    if (!state) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    Governor& g = governor();
+    int32_t percent;
+    {
+        std::lock_guard<std::mutex> lock(g.mutex);
+        g.state = *state;
+        percent = update_level_locked(g);
+    }
+    apply_core_percent(percent);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_thermal_governor_get_state(rac_power_state_t* out_state) {
+    if (!out_state) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    Governor& g = governor();
+    std::lock_guard<std::mutex> lock(g.mutex);
+    *out_state = g.state;
+    return RAC_SUCCESS;
+}
+
+rac_thermal_state_t rac_thermal_governor_get_policy(rac_thermal_policy_t* out_policy) {
+    Governor& g = governor();
+    int32_t percent;
+    rac_thermal_state_t level;
+    {
+        std::lock_guard<std::mutex> lock(g.mutex);
+        poll_locked(g);
+        percent = update_level_locked(g);
+        level = g.level;
+        if (out_policy) {
+            *out_policy = g.config.enabled ? g.config.policies[level] : kUnrestricted;
+        }
+    }
+    apply_core_percent(percent);
+    return level;
+}
+
+int64_t rac_thermal_governor_pace_decode(int32_t tokens, int64_t step_us) {
+    if (tokens <= 0 || step_us <= 0) {
+        return 0;
+    }
+
+    Governor& g = governor();
+    std::lock_guard<std::mutex> lock(g.mutex);
+    const float rate = tokens * 1e6f / static_cast<float>(step_us);
+    if (g.level == RAC_THERMAL_STATE_NOMINAL) {
+        g.nominal_rate =
+            g.nominal_rate > 0.0f ? g.nominal_rate + kSmoothing * (rate - g.nominal_rate) : rate;
+        return 0;
+    }
+
+    const float fraction = g.config.enabled ? g.config.policies[g.level].pace_fraction : 0.0f;
+    if (fraction <= 0.0f || g.nominal_rate <= 0.0f) {
+        return 0;
+    }
+    // Stretch the step to the paced rate; slower steps pass unpaced
+    const auto paced_us = static_cast<int64_t>(tokens * 1e6f / (g.nominal_rate * fraction));
+    return std::min(std::max<int64_t>(paced_us - step_us, 0), kMaxPauseUs);
+}
+
+}  // extern "C"
@@ -0,0 +1,214 @@
+/**
+ * @file rac_trace.cpp
+ * @brief RunAnywhere Commons - Trace Spans and Counters Implementation
+ *
+ * The ATrace functions are looked up in libandroid.so at runtime: the library
+ * supports API levels older than the NDK headers require (sections need 23,
+ * async sections and counters 29). On Apple platforms each thread keeps the
+ * signpost ids of its open spans so rac_trace_end can close the innermost one.
+ * While the perf sampler runs (rac_perf_sampler.h), spans are also timed and
+ * reported as enabled, so RAC_TRACE_SCOPE opens them with no profiler attached.
+ */
+
+#include "rac/core/rac_trace.h"
+
+#include "rac_perf_sampler_internal.h"
+
+#if RAC_TRACE_ENABLED && defined(__ANDROID__)
+#include <dlfcn.h>
+#define RAC_TRACE_ATRACE 1
+#elif RAC_TRACE_ENABLED && defined(__APPLE__)
+#include <os/log.h>
+#include <os/signpost.h>
+#define RAC_TRACE_SIGNPOST 1
+#endif
+
+namespace {
+
+#if defined(RAC_TRACE_ATRACE)
+
+struct ATraceApi {
+    bool (*is_enabled)() = nullptr;
+    void (*begin_section)(const char*) = nullptr;
+    void (*end_section)() = nullptr;
+    void (*begin_async_section)(const char*, int32_t) = nullptr;
+    void (*end_async_section)(const char*, int32_t) = nullptr;
+    void (*set_counter)(const char*, int64_t) = nullptr;
+};
+
+template <typename Fn>
+void resolve(void* lib, const char* symbol, Fn* out) {
+    *out = reinterpret_cast<Fn>(dlsym(lib, symbol));
+}
+
+const ATraceApi& atrace() {
+    static const ATraceApi api = [] {
+        ATraceApi loaded;
+        void* lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+        if (!lib) {
+            return loaded;
+        }
+        resolve(lib, "ATrace_isEnabled", &loaded.is_enabled);
+        resolve(lib, "ATrace_beginSection", &loaded.begin_section);
+        resolve(lib, "ATrace_endSection", &loaded.end_section);
+        resolve(lib, "ATrace_beginAsyncSection", &loaded.begin_async_section);
+        resolve(lib, "ATrace_endAsyncSection", &loaded.end_async_section);
+        resolve(lib, "ATrace_setCounter", &loaded.set_counter);
+        if (!loaded.begin_section || !loaded.end_section) {
+            loaded.is_enabled = nullptr;
+        }
+        return loaded;
+    }();
+    return api;
+}
+
+#elif defined(RAC_TRACE_SIGNPOST)
+
+constexpr int kMaxOpenSpans = 64;
+
+struct OpenSpans {
+    os_signpost_id_t ids[kMaxOpenSpans];
+    int depth = 0;
+};
+
+thread_local OpenSpans t_open_spans;
+
+os_log_t signpost_log() {
+    static os_log_t log =
+        os_log_create("ai.runanywhere.commons", OS_LOG_CATEGORY_POINTS_OF_INTEREST);
+    return log;
+}
+
+// Async spans use the cookie as their id; 0 and ~0 are reserved by os_signpost
+os_signpost_id_t async_id(int32_t cookie) {
+    return (static_cast<os_signpost_id_t>(1) << 32) | static_cast<uint32_t>(cookie);
+}
+
+#endif
+
+}  // namespace
+
+extern "C" {
+
+rac_bool_t rac_trace_is_enabled(void) {
+    if (rac::perf_sampler::active()) {
+        return RAC_TRUE;
+    }
+#if defined(RAC_TRACE_ATRACE)
+    const ATraceApi& api = atrace();
+    return api.is_enabled && api.is_enabled() ? RAC_TRUE : RAC_FALSE;
+#elif defined(RAC_TRACE_SIGNPOST)
+    if (__builtin_available(iOS 12.0, macOS 10.14, *)) {
+        return os_signpost_enabled(signpost_log()) ? RAC_TRUE : RAC_FALSE;
+    }
+    return RAC_FALSE;
+#else
+    return RAC_FALSE;
+#endif
+}
+
+void rac_trace_begin(const char* name) {
+    rac::perf_sampler::span_begin(name);
+#if defined(RAC_TRACE_ATRACE)
+    const ATraceApi& api = atrace();
+    if (api.begin_section) {
+        api.begin_section(name ? name : "");
+    }
+#elif defined(RAC_TRACE_SIGNPOST)
+    OpenSpans& spans = t_open_spans;
+    if (spans.depth >= kMaxOpenSpans) {
+        spans.depth++;
+        return;
+    }
+    if (__builtin_available(iOS 12.0, macOS 10.14, *)) {
+        os_signpost_id_t id = os_signpost_id_generate(signpost_log());
+        spans.ids[spans.depth] = id;
+        os_signpost_interval_begin(signpost_log(), id, "RAC", "%{public}s", name ? name : "");
+    } else {
+        spans.ids[spans.depth] = OS_SIGNPOST_ID_NULL;
+    }
+    spans.depth++;
+#else
+    (void)name;
+#endif
+}
+
+void rac_trace_end(void) {
+    rac::perf_sampler::span_end();
+#if defined(RAC_TRACE_ATRACE)
+    const ATraceApi& api = atrace();
+    if (api.end_section) {
+        api.end_section();
+    }
+#elif defined(RAC_TRACE_SIGNPOST)
+    OpenSpans& spans = t_open_spans;
+    if (spans.depth == 0) {
+        return;
+    }
+    spans.depth--;
+    if (spans.depth >= kMaxOpenSpans || spans.ids[spans.depth] == OS_SIGNPOST_ID_NULL) {
+        return;
+    }
+    if (__builtin_available(iOS 12.0, macOS 10.14, *)) {
+        os_signpost_interval_end(signpost_log(), spans.ids[spans.depth], "RAC");
+    }
+#endif
+}
+
+void rac_trace_async_begin(const char* name, int32_t cookie) {
+    rac::perf_sampler::async_begin(name, cookie);
+#if defined(RAC_TRACE_ATRACE)
+    const ATraceApi& api = atrace();
+    if (api.begin_async_section) {
+        api.begin_async_section(name ? name : "", cookie);
+    }
+#elif defined(RAC_TRACE_SIGNPOST)
+    if (__builtin_available(iOS 12.0, macOS 10.14, *)) {
+        os_signpost_interval_begin(signpost_log(), async_id(cookie), "RAC.async", "%{public}s",
+                                   name ? name : "");
+    }
+#else
+    (void)name;
+    (void)cookie;
+#endif
+}
+
+void rac_trace_async_end(const char* name, int32_t cookie) {
+    rac::perf_sampler::async_end(name, cookie);
+#if defined(RAC_TRACE_ATRACE)
+    const ATraceApi& api = atrace();
+    if (api.end_async_section) {
+        api.end_async_section(name ? name : "", cookie);
+    }
+#elif defined(RAC_TRACE_SIGNPOST)
+    if (__builtin_available(iOS 12.0, macOS 10.14, *)) {
+        os_signpost_interval_end(signpost_log(), async_id(cookie), "RAC.async", "%{public}s",
+                                 name ? name : "");
+    }
+#else
+    (void)name;
+    (void)cookie;
+#endif
+}
+
+void rac_trace_counter(const char* name, int64_t value) {
+#if defined(RAC_TRACE_ATRACE)
+    const ATraceApi& api = atrace();
+    if (api.set_counter && name) {
+        api.set_counter(name, value);
+    }
+#elif defined(RAC_TRACE_SIGNPOST)
+    if (!name) {
+        return;
+    }
+    if (__builtin_available(iOS 12.0, macOS 10.14, *)) {
+        os_signpost_event_emit(signpost_log(), OS_SIGNPOST_ID_EXCLUSIVE, "RAC.counter",
+                               "%{public}s=%lld", name, static_cast<long long>(value));
+    }
+#else
+    (void)name;
+    (void)value;
+#endif
+}
+
+}  // extern "C"
@@ -4,16 +4,24 @@
  *
  * C++ implementation using:
  * - Meyer's Singleton for thread-safe lazy initialization
- * - std::mutex for thread-safe state access
- * - std::string for automatic memory management
+ * - Immutable snapshots published through an atomic pointer, so the getters
+ *   the HTTP and telemetry paths call per request are wait-free
+ * - std::mutex serializing writers and guarding the callbacks
  * - std::optional for nullable values
+ *
+ * Replaced snapshots are retired, not freed: getters hand out pointers into
+ * them, and writes (init, auth refresh, registration) are rare enough that
+ * keeping them costs a few hundred bytes per write.
  */
 
+#include <atomic>
 #include <cstring>
 #include <ctime>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "rac/core/rac_error.h"
 #include "rac/core/rac_logger.h"
@@ -41,62 +49,42 @@ class SDKState {
 
     rac_result_t initialize(rac_environment_t env, const char* api_key, const char* base_url,
                             const char* device_id) {
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        environment_ = env;
-        api_key_ = api_key ? api_key : "";
-        base_url_ = base_url ? base_url : "";
-        device_id_ = device_id ? device_id : "";
-        is_initialized_ = true;
+        update([&](Snapshot& s) {
+            s.environment = env;
+            s.api_key = api_key ? api_key : "";
+            s.base_url = base_url ? base_url : "";
+            s.device_id = device_id ? device_id : "";
+            s.is_initialized = true;
+        });
 
         return RAC_SUCCESS;
     }
 
-    bool isInitialized() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return is_initialized_;
-    }
+    bool isInitialized() const { return current().is_initialized; }
 
     void reset() {
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        // Clear auth state
-        access_token_.reset();
-        refresh_token_.reset();
-        token_expires_at_ = 0;
-        user_id_.reset();
-        organization_id_.reset();
-        is_authenticated_ = false;
-
-        // Clear device state
-        is_device_registered_ = false;
-
-        // Keep environment config (or clear it too for full reset)
-        // is_initialized_ = false;
-        // environment_ = RAC_ENV_DEVELOPMENT;
-        // api_key_.clear();
-        // base_url_.clear();
-        // device_id_.clear();
+        update([](Snapshot& s) {
+            // Clear auth state
+            clearAuthFields(s);
+
+            // Clear device state
+            s.is_device_registered = false;
+
+            // Keep environment config (or clear it too for full reset)
+            // s.is_initialized = false;
+            // s.environment = RAC_ENV_DEVELOPMENT;
+            // s.api_key.clear();
+            // s.base_url.clear();
+            // s.device_id.clear();
+        });
     }
 
     void shutdown() {
-        std::lock_guard<std::mutex> lock(mutex_);
-
         // Clear everything
-        access_token_.reset();
-        refresh_token_.reset();
-        token_expires_at_ = 0;
-        user_id_.reset();
-        organization_id_.reset();
-        is_authenticated_ = false;
-        is_device_registered_ = false;
-        is_initialized_ = false;
-        environment_ = RAC_ENV_DEVELOPMENT;
-        api_key_.clear();
-        base_url_.clear();
-        device_id_.clear();
+        update([](Snapshot& s) { s = Snapshot(); });
 
         // Clear callbacks
+        std::lock_guard<std::mutex> lock(mutex_);
         auth_changed_callback_ = nullptr;
         auth_changed_user_data_ = nullptr;
         persist_callback_ = nullptr;
@@ -108,25 +96,13 @@ class SDKState {
     // Environment Queries
     // ==========================================================================
 
-    rac_environment_t getEnvironment() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return environment_;
-    }
+    rac_environment_t getEnvironment() const { return current().environment; }
 
-    const char* getBaseUrl() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return base_url_.c_str();
-    }
+    const char* getBaseUrl() const { return current().base_url.c_str(); }
 
-    const char* getApiKey() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return api_key_.c_str();
-    }
+    const char* getApiKey() const { return current().api_key.c_str(); }
 
-    const char* getDeviceId() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return device_id_.c_str();
-    }
+    const char* getDeviceId() const { return current().device_id.c_str(); }
 
     // ==========================================================================
     // Auth State
@@ -136,26 +112,23 @@ class SDKState {
         if (!auth)
             return RAC_ERROR_INVALID_ARGUMENT;
 
-        bool was_authenticated;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            was_authenticated = is_authenticated_;
-
-            access_token_ = auth->access_token ? auth->access_token : "";
-            refresh_token_ = auth->refresh_token ? std::optional<std::string>(auth->refresh_token)
-                                                 : std::nullopt;
-            token_expires_at_ = auth->expires_at_unix;
-            user_id_ = auth->user_id ? std::optional<std::string>(auth->user_id) : std::nullopt;
-            organization_id_ = auth->organization_id
-                                   ? std::optional<std::string>(auth->organization_id)
-                                   : std::nullopt;
+        update([auth](Snapshot& s) {
+            s.access_token = auth->access_token ? auth->access_token : "";
+            s.refresh_token = auth->refresh_token
+                                  ? std::optional<std::string>(auth->refresh_token)
+                                  : std::nullopt;
+            s.token_expires_at = auth->expires_at_unix;
+            s.user_id = auth->user_id ? std::optional<std::string>(auth->user_id) : std::nullopt;
+            s.organization_id = auth->organization_id
+                                    ? std::optional<std::string>(auth->organization_id)
+                                    : std::nullopt;
 
             if (auth->device_id && strlen(auth->device_id) > 0) {
-                device_id_ = auth->device_id;
+                s.device_id = auth->device_id;
             }
 
-            is_authenticated_ = true;
-        }
+            s.is_authenticated = true;
+        });
 
         // Notify callback outside of lock
         notifyAuthChanged(true);
@@ -167,30 +140,30 @@ class SDKState {
     }
 
     const char* getAccessToken() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (!access_token_.has_value() || access_token_->empty()) {
+        const Snapshot& s = current();
+        if (!s.access_token.has_value() || s.access_token->empty()) {
             return nullptr;
         }
-        return access_token_->c_str();
+        return s.access_token->c_str();
     }
 
     const char* getRefreshToken() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (!refresh_token_.has_value()) {
+        const Snapshot& s = current();
+        if (!s.refresh_token.has_value()) {
             return nullptr;
         }
-        return refresh_token_->c_str();
+        return s.refresh_token->c_str();
     }
 
     bool isAuthenticated() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (!is_authenticated_ || !access_token_.has_value()) {
+        const Snapshot& s = current();
+        if (!s.is_authenticated || !s.access_token.has_value()) {
             return false;
         }
         // Check if token is expired
-        if (token_expires_at_ > 0) {
+        if (s.token_expires_at > 0) {
             int64_t now = static_cast<int64_t>(std::time(nullptr));
-            if (now >= token_expires_at_) {
+            if (now >= s.token_expires_at) {
                 return false;
             }
         }
@@ -198,53 +171,49 @@ class SDKState {
     }
 
     bool tokenNeedsRefresh() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (!is_authenticated_ || token_expires_at_ == 0) {
+        const Snapshot& s = current();
+        if (!s.is_authenticated || s.token_expires_at == 0) {
             return false;
         }
         int64_t now = static_cast<int64_t>(std::time(nullptr));
         // Refresh if expires within 60 seconds
-        return (token_expires_at_ - now) <= 60;
+        return (s.token_expires_at - now) <= 60;
     }
 
-    int64_t getTokenExpiresAt() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return token_expires_at_;
-    }
+    int64_t getTokenExpiresAt() const { return current().token_expires_at; }
 
     const char* getUserId() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (!user_id_.has_value()) {
+        const Snapshot& s = current();
+        if (!s.user_id.has_value()) {
             return nullptr;
         }
-        return user_id_->c_str();
+        return s.user_id->c_str();
     }
 
     const char* getOrganizationId() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (!organization_id_.has_value()) {
+        const Snapshot& s = current();
+        if (!s.organization_id.has_value()) {
             return nullptr;
         }
-        return organization_id_->c_str();
+        return s.organization_id->c_str();
     }
 
     void clearAuth() {
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            access_token_.reset();
-            refresh_token_.reset();
-            token_expires_at_ = 0;
-            user_id_.reset();
-            organization_id_.reset();
-            is_authenticated_ = false;
-        }
+        update(clearAuthFields);
 
         notifyAuthChanged(false);
 
         // Clear from secure storage
-        if (persist_callback_) {
-            persist_callback_("access_token", nullptr, persistence_user_data_);
-            persist_callback_("refresh_token", nullptr, persistence_user_data_);
+        rac_persist_callback_t callback;
+        void* user_data;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            callback = persist_callback_;
+            user_data = persistence_user_data_;
+        }
+        if (callback) {
+            callback("access_token", nullptr, user_data);
+            callback("refresh_token", nullptr, user_data);
         }
     }
 
@@ -253,14 +222,13 @@ class SDKState {
     // ==========================================================================
 
     void setDeviceRegistered(bool registered) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        is_device_registered_ = registered;
+        if (current().is_device_registered == registered) {
+            return;
+        }
+        update([registered](Snapshot& s) { s.is_device_registered = registered; });
     }
 
-    bool isDeviceRegistered() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return is_device_registered_;
-    }
+    bool isDeviceRegistered() const { return current().is_device_registered; }
 
     // ==========================================================================
     // Callbacks
@@ -280,9 +248,80 @@ class SDKState {
         persistence_user_data_ = user_data;
     }
 
+    bool persistValue(const char* key, const char* value) {
+        rac_persist_callback_t callback;
+        void* user_data;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            callback = persist_callback_;
+            user_data = persistence_user_data_;
+        }
+        if (!callback) {
+            return false;
+        }
+        callback(key, value, user_data);
+        return true;
+    }
+
+    char* loadValue(const char* key) {
+        rac_load_callback_t callback;
+        void* user_data;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            callback = load_callback_;
+            user_data = persistence_user_data_;
+        }
+        const char* value = callback ? callback(key, user_data) : nullptr;
+        return value ? rac_strdup(value) : nullptr;
+    }
+
    private:
-    SDKState() = default;
-    ~SDKState() = default;
+    // Everything the getters read. Never changed once published.
+    struct Snapshot {
+        bool is_initialized = false;
+
+        // Environment
+        rac_environment_t environment = RAC_ENV_DEVELOPMENT;
+        std::string api_key;
+        std::string base_url;
+        std::string device_id;
+
+        // Auth
+        std::optional<std::string> access_token;
+        std::optional<std::string> refresh_token;
+        int64_t token_expires_at = 0;
+        std::optional<std::string> user_id;
+        std::optional<std::string> organization_id;
+        bool is_authenticated = false;
+
+        // Device
+        bool is_device_registered = false;
+    };
+
+    SDKState() : current_(new Snapshot()) {}
+    ~SDKState() { delete current_.load(); }
+
+    static void clearAuthFields(Snapshot& s) {
+        s.access_token.reset();
+        s.refresh_token.reset();
+        s.token_expires_at = 0;
+        s.user_id.reset();
+        s.organization_id.reset();
+        s.is_authenticated = false;
+    }
+
+    const Snapshot& current() const { return *current_.load(std::memory_order_acquire); }
+
+    // Publishes a copy of the current snapshot changed by change
+    template <typename Change>
+    void update(Change&& change) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Snapshot* previous = current_.load(std::memory_order_relaxed);
+        auto next = std::make_unique<Snapshot>(*previous);
+        change(*next);
+        current_.store(next.release(), std::memory_order_release);
+        retired_.emplace_back(previous);
+    }
 
     void notifyAuthChanged(bool is_authenticated) {
         rac_auth_changed_callback_t callback;
@@ -300,46 +339,26 @@ class SDKState {
     void persistAuth() {
         rac_persist_callback_t callback;
         void* user_data;
-        std::string access, refresh;
         {
             std::lock_guard<std::mutex> lock(mutex_);
             callback = persist_callback_;
             user_data = persistence_user_data_;
-            if (access_token_.has_value())
-                access = *access_token_;
-            if (refresh_token_.has_value())
-                refresh = *refresh_token_;
         }
+        const Snapshot& s = current();
         if (callback) {
-            if (!access.empty()) {
-                callback("access_token", access.c_str(), user_data);
+            if (s.access_token.has_value() && !s.access_token->empty()) {
+                callback("access_token", s.access_token->c_str(), user_data);
             }
-            if (!refresh.empty()) {
-                callback("refresh_token", refresh.c_str(), user_data);
+            if (s.refresh_token.has_value() && !s.refresh_token->empty()) {
+                callback("refresh_token", s.refresh_token->c_str(), user_data);
             }
         }
     }
 
     // State
-    mutable std::mutex mutex_;
-    bool is_initialized_ = false;
-
-    // Environment
-    rac_environment_t environment_ = RAC_ENV_DEVELOPMENT;
-    std::string api_key_;
-    std::string base_url_;
-    std::string device_id_;
-
-    // Auth
-    std::optional<std::string> access_token_;
-    std::optional<std::string> refresh_token_;
-    int64_t token_expires_at_ = 0;
-    std::optional<std::string> user_id_;
-    std::optional<std::string> organization_id_;
-    bool is_authenticated_ = false;
-
-    // Device
-    bool is_device_registered_ = false;
+    std::atomic<const Snapshot*> current_;
+    std::vector<std::unique_ptr<const Snapshot>> retired_;  // Still readable; see file comment
+    std::mutex mutex_;  // Serializes writers; guards retired_ and the callbacks
 
     // Callbacks
     rac_auth_changed_callback_t auth_changed_callback_ = nullptr;
@@ -445,4 +464,18 @@ void rac_state_set_persistence_callbacks(rac_persist_callback_t persist, rac_loa
     SDKState::instance().setPersistenceCallbacks(persist, load, user_data);
 }
 
+bool rac_state_persist_value(const char* key, const char* value) {
+    if (!key) {
+        return false;
+    }
+    return SDKState::instance().persistValue(key, value);
+}
+
+char* rac_state_load_value(const char* key) {
+    if (!key) {
+        return nullptr;
+    }
+    return SDKState::instance().loadValue(key);
+}
+
 }  // extern "C"
@@ -0,0 +1,438 @@
+/**
+ * @file async_stream.cpp
+ * @brief Asynchronous streaming for FFI listeners
+ *
+ * Each stream runs on its own detached worker thread. The stream object is
+ * shared by the worker and the caller and freed when both have released it.
+ * Events are single allocations with their payload stored after the struct.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_logger.h"
+#include "rac/features/llm/rac_llm_component.h"
+#include "rac/features/llm/rac_llm_tools.h"
+#include "rac/features/rac_async_stream.h"
+#include "rac/features/stt/rac_stt_component.h"
+#include "rac/features/tts/rac_tts_component.h"
+
+static const char* LOG_CAT = "AsyncStream";
+
+struct rac_async_stream {
+    std::atomic<int> refs{2};  // caller + worker
+    std::atomic<bool> cancelled{false};
+    rac_async_listener_fn listener = nullptr;
+    void* user_data = nullptr;
+
+    // Worker thread only
+    bool finished = false;
+    rac_result_t outcome = RAC_SUCCESS;
+    std::string outcome_message;
+    rac_llm_result_t metrics = {};
+};
+
+namespace {
+
+void release_stream(rac_async_stream* stream) {
+    if (stream->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete stream;
+    }
+}
+
+// Event with `size` payload bytes stored after it, plus a terminator so text
+// payloads are C strings
+rac_async_event_t* make_event(rac_async_event_type_t type, const void* payload, size_t size) {
+    auto* event = static_cast<rac_async_event_t*>(
+        rac_calloc_tagged(RAC_ALLOC_TAG_EVENT, 1, sizeof(rac_async_event_t) + size + 1));
+    if (event == nullptr) {
+        return nullptr;
+    }
+    event->type = type;
+    char* data = reinterpret_cast<char*>(event + 1);
+    if (size > 0) {
+        memcpy(data, payload, size);
+    }
+    if (type == RAC_ASYNC_EVENT_AUDIO_CHUNK) {
+        event->audio_data = data;
+        event->audio_size = size;
+    } else {
+        event->text = data;
+    }
+    return event;
+}
+
+void post(rac_async_stream* stream, rac_async_event_t* event) {
+    if (event == nullptr) {
+        RAC_LOG_ERROR(LOG_CAT, "Dropped stream event: out of memory");
+        return;
+    }
+    stream->listener(event, stream->user_data);
+}
+
+// Token, transcript or audio; dropped once the stream is cancelled or over
+void post_data(rac_async_stream* stream, rac_async_event_type_t type, const void* payload,
+               size_t size) {
+    if (stream->finished || stream->cancelled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    post(stream, make_event(type, payload, size));
+}
+
+void post_text(rac_async_stream* stream, rac_async_event_type_t type, const char* text) {
+    post_data(stream, type, text, text != nullptr ? strlen(text) : 0);
+}
+
+// The stream ends only after the component call has returned, so by the time
+// the receiver sees the final event the worker no longer touches the
+// component. Completion and error callbacks just record their outcome here.
+void record_error(rac_async_stream* stream, rac_result_t code, const char* message) {
+    if (stream->outcome == RAC_SUCCESS) {
+        stream->outcome = code;
+        stream->outcome_message = message != nullptr ? message : "";
+    }
+}
+
+void record_metrics(rac_async_stream* stream, const rac_llm_result_t* result) {
+    if (result != nullptr) {
+        stream->metrics = *result;
+        stream->metrics.text = nullptr;
+    }
+}
+
+// Posts the single final event; a cancel turns success into
+// RAC_ERROR_CANCELLED
+void finish(rac_async_stream* stream, rac_result_t status) {
+    record_error(stream, status, nullptr);
+    status = stream->outcome;
+    if (status == RAC_SUCCESS && stream->cancelled.load(std::memory_order_relaxed)) {
+        status = RAC_ERROR_CANCELLED;
+    }
+    stream->finished = true;
+
+    if (status != RAC_SUCCESS) {
+        const char* message = !stream->outcome_message.empty() ? stream->outcome_message.c_str()
+                                                               : rac_error_message(status);
+        rac_async_event_t* event =
+            make_event(RAC_ASYNC_EVENT_ERROR, message, message != nullptr ? strlen(message) : 0);
+        if (event != nullptr) {
+            event->error_code = status;
+        }
+        post(stream, event);
+        return;
+    }
+
+    rac_async_event_t* event = make_event(RAC_ASYNC_EVENT_COMPLETE, nullptr, 0);
+    if (event != nullptr) {
+        event->prompt_tokens = stream->metrics.prompt_tokens;
+        event->completion_tokens = stream->metrics.completion_tokens;
+        event->time_to_first_token_ms = stream->metrics.time_to_first_token_ms;
+        event->total_time_ms = stream->metrics.total_time_ms;
+        event->tokens_per_second = stream->metrics.tokens_per_second;
+        event->stop_reason = stream->metrics.stop_reason;
+    }
+    post(stream, event);
+}
+
+std::string copy_string(const char* value) {
+    return value != nullptr ? std::string(value) : std::string();
+}
+
+const char* nullable(const std::string& value, const char* original) {
+    return original != nullptr ? value.c_str() : nullptr;
+}
+
+// Pixels of an image, up to the end of its last row; empty if it has none
+std::vector<uint8_t> copy_image(const rac_image_t& image) {
+    if (image.data == nullptr || image.width <= 0 || image.height <= 0) {
+        return {};
+    }
+    const size_t row = static_cast<size_t>(image.width) *
+                       (image.format == RAC_IMAGE_FORMAT_RGB8 ? 3 : 4);
+    const size_t stride = image.stride > 0 ? static_cast<size_t>(image.stride) : row;
+    const size_t size = stride * static_cast<size_t>(image.height - 1) + row;
+    return std::vector<uint8_t>(image.data, image.data + size);
+}
+
+// Starts `job` on a detached worker that owns one stream reference
+template <typename Job>
+rac_result_t start_stream(rac_async_listener_fn listener, void* user_data,
+                          rac_async_stream_t** out_stream, Job job) {
+    auto* stream = new rac_async_stream();
+    stream->listener = listener;
+    stream->user_data = user_data;
+    try {
+        std::thread([stream, job = std::move(job)]() mutable {
+            job(stream);
+            release_stream(stream);
+        }).detach();
+    } catch (const std::system_error& e) {
+        RAC_LOG_ERROR(LOG_CAT, "Failed to start stream worker: %s", e.what());
+        delete stream;
+        return RAC_ERROR_INITIALIZATION_FAILED;
+    }
+    *out_stream = stream;
+    return RAC_SUCCESS;
+}
+
+// =============================================================================
+// LLM
+// =============================================================================
+
+struct LlmJob {
+    rac_handle_t handle;
+    std::string prompt;
+    bool has_options = false;
+    rac_llm_options_t options = {};
+    std::string system_prompt;
+    std::string json_schema;
+    std::string lora_adapter;
+    std::vector<std::string> stop_storage;
+    std::vector<const char*> stop_sequences;
+    std::vector<std::vector<uint8_t>> image_storage;
+    std::vector<rac_image_t> images;
+
+    // Points the copied options at this job's own strings; called once the
+    // job has reached its final address on the worker
+    void bind() {
+        options.system_prompt = nullable(system_prompt, options.system_prompt);
+        options.json_schema = nullable(json_schema, options.json_schema);
+        options.lora_adapter = nullable(lora_adapter, options.lora_adapter);
+        stop_sequences.clear();
+        for (const auto& stop : stop_storage) {
+            stop_sequences.push_back(stop.c_str());
+        }
+        options.stop_sequences = stop_sequences.empty() ? nullptr : stop_sequences.data();
+        options.num_stop_sequences = stop_sequences.size();
+        for (size_t i = 0; i < images.size(); ++i) {
+            images[i].data = image_storage[i].empty() ? nullptr : image_storage[i].data();
+        }
+        options.images = images.empty() ? nullptr : images.data();
+        options.num_images = images.size();
+    }
+
+    void operator()(rac_async_stream* stream) {
+        bind();
+        rac_result_t status = rac_llm_component_generate_stream(
+            handle, prompt.c_str(), has_options ? &options : nullptr, on_token, on_complete,
+            on_error, stream);
+        finish(stream, status);
+    }
+
+    static rac_bool_t on_token(const char* token, void* user_data) {
+        auto* stream = static_cast<rac_async_stream*>(user_data);
+        post_text(stream, RAC_ASYNC_EVENT_TOKEN, token);
+        return stream->cancelled.load(std::memory_order_relaxed) ? RAC_FALSE : RAC_TRUE;
+    }
+
+    static void on_complete(const rac_llm_result_t* result, void* user_data) {
+        record_metrics(static_cast<rac_async_stream*>(user_data), result);
+    }
+
+    static void on_error(rac_result_t code, const char* message, void* user_data) {
+        record_error(static_cast<rac_async_stream*>(user_data), code, message);
+    }
+};
+
+LlmJob make_llm_job(rac_handle_t handle, const char* prompt, const rac_llm_options_t* options) {
+    LlmJob job;
+    job.handle = handle;
+    job.prompt = prompt;
+    if (options != nullptr) {
+        job.has_options = true;
+        job.options = *options;
+        job.system_prompt = copy_string(options->system_prompt);
+        job.json_schema = copy_string(options->json_schema);
+        job.lora_adapter = copy_string(options->lora_adapter);
+        for (size_t i = 0; options->stop_sequences != nullptr && i < options->num_stop_sequences;
+             ++i) {
+            job.stop_storage.push_back(copy_string(options->stop_sequences[i]));
+        }
+        for (size_t i = 0; options->images != nullptr && i < options->num_images; ++i) {
+            job.images.push_back(options->images[i]);
+            job.image_storage.push_back(copy_image(options->images[i]));
+        }
+    }
+    return job;
+}
+
+struct ToolJob {
+    LlmJob llm;
+    rac_llm_toolset_t toolset;
+    rac_llm_tool_choice_t choice;
+
+    void operator()(rac_async_stream* stream) {
+        llm.bind();
+        rac_result_t status = rac_llm_component_generate_with_tools(
+            llm.handle, toolset, llm.prompt.c_str(), llm.has_options ? &llm.options : nullptr,
+            choice, LlmJob::on_token, on_tool_call, LlmJob::on_complete, LlmJob::on_error,
+            stream);
+        finish(stream, status);
+    }
+
+    // The name arrives as generated between its quotes, so it is already
+    // escaped for JSON
+    static void on_tool_call(const char* name, const char* arguments_json, void* user_data) {
+        std::string call = "{\"name\": \"";
+        call += name;
+        call += "\", \"arguments\": ";
+        call += arguments_json;
+        call += "}";
+        post_text(static_cast<rac_async_stream*>(user_data), RAC_ASYNC_EVENT_TOOL_CALL,
+                  call.c_str());
+    }
+};
+
+// =============================================================================
+// STT
+// =============================================================================
+
+struct SttJob {
+    rac_handle_t handle;
+    std::vector<uint8_t> audio;
+    bool has_options = false;
+    rac_stt_options_t options = {};
+    std::string language;
+
+    void operator()(rac_async_stream* stream) {
+        options.language = nullable(language, options.language);
+        rac_result_t status = rac_stt_component_transcribe_stream(
+            handle, audio.data(), audio.size(), has_options ? &options : nullptr, on_partial,
+            stream);
+        finish(stream, status);
+    }
+
+    static void on_partial(const char* text, rac_bool_t is_final, void* user_data) {
+        post_text(static_cast<rac_async_stream*>(user_data),
+                  is_final ? RAC_ASYNC_EVENT_FINAL_TRANSCRIPT
+                           : RAC_ASYNC_EVENT_PARTIAL_TRANSCRIPT,
+                  text);
+    }
+};
+
+// =============================================================================
+// TTS
+// =============================================================================
+
+struct TtsJob {
+    rac_handle_t handle;
+    std::string text;
+    bool has_options = false;
+    rac_tts_options_t options = {};
+    std::string voice;
+    std::string language;
+
+    void operator()(rac_async_stream* stream) {
+        options.voice = nullable(voice, options.voice);
+        options.language = nullable(language, options.language);
+        rac_result_t status = rac_tts_component_synthesize_stream(
+            handle, text.c_str(), has_options ? &options : nullptr, on_audio, stream);
+        finish(stream, status);
+    }
+
+    static void on_audio(const void* audio_data, size_t audio_size, void* user_data) {
+        post_data(static_cast<rac_async_stream*>(user_data), RAC_ASYNC_EVENT_AUDIO_CHUNK,
+                  audio_data, audio_size);
+    }
+};
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_llm_component_generate_async(rac_handle_t handle, const char* prompt,
+                                              const rac_llm_options_t* options,
+                                              rac_async_listener_fn listener, void* user_data,
+                                              rac_async_stream_t** out_stream) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!prompt || !listener || !out_stream)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    return start_stream(listener, user_data, out_stream, make_llm_job(handle, prompt, options));
+}
+
+rac_result_t rac_llm_component_generate_with_tools_async(
+    rac_handle_t handle, rac_llm_toolset_t toolset, const char* prompt,
+    const rac_llm_options_t* options, rac_llm_tool_choice_t choice,
+    rac_async_listener_fn listener, void* user_data, rac_async_stream_t** out_stream) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!toolset || !prompt || !listener || !out_stream)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    ToolJob job{make_llm_job(handle, prompt, options), toolset, choice};
+    return start_stream(listener, user_data, out_stream, std::move(job));
+}
+
+rac_result_t rac_stt_component_transcribe_async(rac_handle_t handle, const void* audio_data,
+                                                size_t audio_size,
+                                                const rac_stt_options_t* options,
+                                                rac_async_listener_fn listener, void* user_data,
+                                                rac_async_stream_t** out_stream) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!audio_data || audio_size == 0 || !listener || !out_stream)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    SttJob job;
+    job.handle = handle;
+    const auto* bytes = static_cast<const uint8_t*>(audio_data);
+    job.audio.assign(bytes, bytes + audio_size);
+    if (options != nullptr) {
+        job.has_options = true;
+        job.options = *options;
+        job.language = copy_string(options->language);
+    }
+    return start_stream(listener, user_data, out_stream, std::move(job));
+}
+
+rac_result_t rac_tts_component_synthesize_async(rac_handle_t handle, const char* text,
+                                                const rac_tts_options_t* options,
+                                                rac_async_listener_fn listener, void* user_data,
+                                                rac_async_stream_t** out_stream) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!text || !listener || !out_stream)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    TtsJob job;
+    job.handle = handle;
+    job.text = text;
+    if (options != nullptr) {
+        job.has_options = true;
+        job.options = *options;
+        job.voice = copy_string(options->voice);
+        job.language = copy_string(options->language);
+    }
+    return start_stream(listener, user_data, out_stream, std::move(job));
+}
+
+void rac_async_stream_cancel(rac_async_stream_t* stream) {
+    if (stream != nullptr) {
+        stream->cancelled.store(true, std::memory_order_relaxed);
+    }
+}
+
+void rac_async_stream_release(rac_async_stream_t* stream) {
+    if (stream != nullptr) {
+        release_stream(stream);
+    }
+}
+
+void rac_async_event_free(rac_async_event_t* event) {
+    rac_free(event);
+}
+
+}  // extern "C"
@@ -0,0 +1,92 @@
+/**
+ * @file rac_kws_service.cpp
+ * @brief Keyword Spotting Service - Generic API with VTable Dispatch
+ *
+ * Simple dispatch layer that routes calls through the service vtable.
+ * Each backend provides its own vtable when creating a service.
+ */
+
+#include "rac/features/kws/rac_kws_service.h"
+
+#include "rac/core/rac_core.h"
+#include "rac/core/rac_logger.h"
+
+static const char* LOG_CAT = "KWS.Service";
+
+extern "C" {
+
+// =============================================================================
+// SERVICE CREATION - Routes through Service Registry
+// =============================================================================
+
+rac_result_t rac_kws_create(const char* model_path, const char* config_json,
+                            rac_handle_t* out_handle) {
+    if (!out_handle) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    *out_handle = nullptr;
+
+    rac_service_request_t request = {};
+    request.identifier = model_path;
+    request.config_json = config_json;
+    request.capability = RAC_CAPABILITY_KEYWORD_SPOTTING;
+    request.framework = RAC_FRAMEWORK_ONNX;
+    request.model_path = model_path;
+
+    // Service registry returns an rac_kws_service_t* with vtable already set
+    rac_result_t result =
+        rac_service_create(RAC_CAPABILITY_KEYWORD_SPOTTING, &request, out_handle);
+    if (result != RAC_SUCCESS) {
+        RAC_LOG_ERROR(LOG_CAT, "Failed to create keyword spotter via registry");
+        return result;
+    }
+
+    RAC_LOG_INFO(LOG_CAT, "Keyword spotter created");
+    return RAC_SUCCESS;
+}
+
+// =============================================================================
+// GENERIC API - Simple vtable dispatch
+// =============================================================================
+
+rac_result_t rac_kws_process(rac_handle_t handle, const float* samples, size_t num_samples,
+                             int32_t sample_rate, rac_kws_detection_t* out_detection) {
+    if (!handle || !samples || !out_detection)
+        return RAC_ERROR_NULL_POINTER;
+
+    auto* service = static_cast<rac_kws_service_t*>(handle);
+    if (!service->ops || !service->ops->process) {
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+
+    return service->ops->process(service->impl, samples, num_samples, sample_rate, out_detection);
+}
+
+rac_result_t rac_kws_reset(rac_handle_t handle) {
+    if (!handle)
+        return RAC_ERROR_NULL_POINTER;
+
+    auto* service = static_cast<rac_kws_service_t*>(handle);
+    if (!service->ops || !service->ops->reset) {
+        return RAC_SUCCESS;
+    }
+
+    return service->ops->reset(service->impl);
+}
+
+void rac_kws_destroy(rac_handle_t handle) {
+    if (!handle)
+        return;
+
+    auto* service = static_cast<rac_kws_service_t*>(handle);
+    if (service->ops && service->ops->destroy) {
+        service->ops->destroy(service->impl);
+    }
+    if (service->model_id) {
+        rac_free(const_cast<char*>(service->model_id));
+    }
+    rac_free(service);
+}
+
+}  // extern "C"
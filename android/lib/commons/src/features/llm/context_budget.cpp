@@ -0,0 +1,272 @@
+/**
+ * @file context_budget.cpp
+ * @brief RunAnywhere Commons - LLM Conversation Context Budget Implementation
+ *
+ * Turns are kept with their token counts so the budget check never has to
+ * retokenize the history. Summaries are generated with the same service the
+ * conversation runs on, capped at summary_max_tokens.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "rac/core/rac_logger.h"
+#include "rac/features/llm/rac_llm_context.h"
+#include "rac/features/llm/rac_llm_service.h"
+
+static const char* LOG_CAT = "LLM.Context";
+
+// =============================================================================
+// INTERNAL STRUCTURE
+// =============================================================================
+
+struct rac_llm_context_turn {
+    std::string role;
+    std::string text;
+    int32_t tokens{0};
+};
+
+struct rac_llm_context {
+    rac_llm_context_config_t config{};
+
+    std::deque<rac_llm_context_turn> turns{};
+    int32_t turn_tokens{0};
+
+    // Rolling summary of evicted turns
+    std::string summary{};
+    int32_t summary_tokens{0};
+
+    std::mutex mutex{};
+};
+
+// =============================================================================
+// HELPERS
+// =============================================================================
+
+static int32_t count_tokens(rac_handle_t service, const std::string& text) {
+    int32_t count = 0;
+    if (service && rac_llm_count_tokens(service, text.c_str(), &count) == RAC_SUCCESS) {
+        return count;
+    }
+    return static_cast<int32_t>((text.size() + 3) / 4);
+}
+
+static const char* role_label(const std::string& role) {
+    return role == "assistant" ? "Assistant" : "User";
+}
+
+static void append_transcript(std::string& out, const std::deque<rac_llm_context_turn>& turns,
+                              size_t count) {
+    for (size_t i = 0; i < count && i < turns.size(); i++) {
+        out += role_label(turns[i].role);
+        out += ": ";
+        out += turns[i].text;
+        out += "\n\n";
+    }
+}
+
+static void normalize_config(rac_llm_context_config_t& config) {
+    config.keep_recent_turns = std::max(1, config.keep_recent_turns);
+    if (config.summary_max_tokens <= 0) {
+        config.summary_max_tokens = RAC_LLM_CONTEXT_CONFIG_DEFAULT.summary_max_tokens;
+    }
+}
+
+static void evict_front(rac_llm_context* ctx, size_t count) {
+    for (size_t i = 0; i < count && !ctx->turns.empty(); i++) {
+        ctx->turn_tokens -= ctx->turns.front().tokens;
+        ctx->turns.pop_front();
+    }
+}
+
+/**
+ * Fold the oldest `count` turns (and any previous summary) into a new summary.
+ * Returns false if the service could not produce one.
+ */
+static bool summarize_front(rac_llm_context* ctx, rac_handle_t service, size_t count) {
+    std::string request =
+        "Summarize the conversation below in a few sentences. Keep names, facts, numbers and "
+        "decisions; drop pleasantries.\n\n";
+    if (!ctx->summary.empty()) {
+        request += "Earlier summary: ";
+        request += ctx->summary;
+        request += "\n\n";
+    }
+    append_transcript(request, ctx->turns, count);
+
+    rac_llm_options_t options = RAC_LLM_OPTIONS_DEFAULT;
+    options.max_tokens = ctx->config.summary_max_tokens;
+    options.temperature = 0.2f;
+
+    rac_llm_result_t result = {};
+    if (rac_llm_generate(service, request.c_str(), &options, &result) != RAC_SUCCESS ||
+        !result.text || result.text[0] == '\0') {
+        rac_llm_result_free(&result);
+        return false;
+    }
+
+    ctx->summary = result.text;
+    rac_llm_result_free(&result);
+    ctx->summary_tokens = count_tokens(service, ctx->summary);
+    evict_front(ctx, count);
+    return true;
+}
+
+// =============================================================================
+// CONTEXT API
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_llm_context_create(const rac_llm_context_config_t* config,
+                                    rac_llm_context_handle_t* out_handle) {
+    if (!out_handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto* ctx = new rac_llm_context();
+    ctx->config = config ? *config : RAC_LLM_CONTEXT_CONFIG_DEFAULT;
+    normalize_config(ctx->config);
+
+    *out_handle = ctx;
+    return RAC_SUCCESS;
+}
+
+void rac_llm_context_destroy(rac_llm_context_handle_t handle) {
+    delete handle;
+}
+
+rac_result_t rac_llm_context_set_config(rac_llm_context_handle_t handle,
+                                        const rac_llm_context_config_t* config) {
+    if (!handle || !config) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    handle->config = *config;
+    normalize_config(handle->config);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_context_get_config(rac_llm_context_handle_t handle,
+                                        rac_llm_context_config_t* out_config) {
+    if (!handle || !out_config) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    *out_config = handle->config;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_context_add_turn(rac_llm_context_handle_t handle, const char* role,
+                                      const char* text, int32_t token_count) {
+    if (!handle || !role || !text) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    rac_llm_context_turn turn;
+    turn.role = role;
+    turn.text = text;
+    turn.tokens = token_count > 0 ? token_count : count_tokens(nullptr, turn.text);
+    handle->turn_tokens += turn.tokens;
+    handle->turns.push_back(std::move(turn));
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_context_clear(rac_llm_context_handle_t handle) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    handle->turns.clear();
+    handle->turn_tokens = 0;
+    handle->summary.clear();
+    handle->summary_tokens = 0;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_context_get_token_count(rac_llm_context_handle_t handle,
+                                             int32_t* out_tokens) {
+    if (!handle || !out_tokens) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    *out_tokens = handle->summary_tokens + handle->turn_tokens;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_context_fit(rac_llm_context_handle_t handle, rac_handle_t service,
+                                 int32_t budget_tokens) {
+    if (!handle || budget_tokens <= 0) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    auto* ctx = handle;
+    const size_t keep = static_cast<size_t>(ctx->config.keep_recent_turns);
+    bool summarize = ctx->config.strategy == RAC_LLM_CONTEXT_SUMMARIZE && service != nullptr;
+
+    while (ctx->summary_tokens + ctx->turn_tokens > budget_tokens && ctx->turns.size() > keep) {
+        const size_t older = ctx->turns.size() - keep;
+
+        if (summarize) {
+            // One pass over every evictable turn keeps the number of extra
+            // generations to one per overflow
+            const int32_t before = ctx->summary_tokens + ctx->turn_tokens;
+            if (summarize_front(ctx, service, older)) {
+                RAC_LOG_INFO(LOG_CAT, "Summarised %zu turns: %d -> %d tokens (budget %d)", older,
+                             before, ctx->summary_tokens + ctx->turn_tokens, budget_tokens);
+                continue;
+            }
+            RAC_LOG_WARNING(LOG_CAT, "Summary generation failed, evicting oldest turns");
+            summarize = false;
+        }
+
+        evict_front(ctx, 1);
+    }
+
+    // A summary that alone breaks the budget is worth less than the recent turns
+    if (ctx->summary_tokens + ctx->turn_tokens > budget_tokens && ctx->summary_tokens > 0) {
+        ctx->summary.clear();
+        ctx->summary_tokens = 0;
+    }
+
+    if (ctx->summary_tokens + ctx->turn_tokens > budget_tokens) {
+        RAC_LOG_WARNING(LOG_CAT, "Recent turns hold %d tokens, over the %d token budget",
+                        ctx->turn_tokens, budget_tokens);
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_context_build_prompt(rac_llm_context_handle_t handle, char** out_prompt) {
+    if (!handle || !out_prompt) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+
+    std::string prompt;
+    if (handle->summary.empty() && handle->turns.size() == 1) {
+        prompt = handle->turns.front().text;
+    } else {
+        if (!handle->summary.empty()) {
+            prompt += "Summary of the earlier conversation: ";
+            prompt += handle->summary;
+            prompt += "\n\n";
+        }
+        append_transcript(prompt, handle->turns, handle->turns.size());
+        prompt += "Assistant:";
+    }
+
+    *out_prompt = rac_strdup(prompt.c_str());
+    return *out_prompt ? RAC_SUCCESS : RAC_ERROR_OUT_OF_MEMORY;
+}
+
+}  // extern "C"
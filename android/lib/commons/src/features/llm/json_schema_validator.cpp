@@ -0,0 +1,1289 @@
+/**
+ * @file json_schema_validator.cpp
+ * @brief LLM Structured Output - Compiled JSON Schema Validation
+ *
+ * A schema is parsed and compiled once into a flat program of nodes (type
+ * masks, bounds, sorted property tables, required-property indices, resolved
+ * local $refs, canonical enum values) and kept in a small LRU cache keyed by
+ * rac_structured_output_schema_hash, the same key the llama.cpp grammar cache
+ * uses. Validating a response then parses the JSON once and walks it against
+ * the program in a single pass; the schema text is not looked at again.
+ *
+ * Supported keywords: type, enum, const, minimum, maximum, exclusiveMinimum,
+ * exclusiveMaximum (number or draft-4 boolean), multipleOf, minLength,
+ * maxLength, items (schema or tuple), prefixItems, additionalItems, minItems,
+ * maxItems, uniqueItems, properties, required, additionalProperties,
+ * minProperties, maxProperties, allOf, anyOf, oneOf, not and $ref to "#",
+ * "#/$defs/..." or "#/definitions/...". pattern and format are accepted but
+ * not enforced. patternProperties and propertyNames are not enforced either;
+ * an object with patternProperties accepts any property properties does not
+ * list, whatever its additionalProperties says.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rac/core/rac_logger.h"
+#include "rac/core/rac_types.h"
+#include "rac/features/llm/rac_llm_structured_output.h"
+
+static const char* LOG_CAT = "StructuredOutput.Schema";
+
+namespace {
+
+// =============================================================================
+// JSON VALUES
+// =============================================================================
+
+struct Value {
+    enum Kind : uint8_t { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+    Kind kind{NUL};
+    bool boolean{false};
+    double number{0.0};
+    std::string str{};
+    std::vector<Value> items{};
+    std::vector<std::pair<std::string, Value>> members{};
+
+    const Value* find(const char* key) const {
+        for (const auto& member : members) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+constexpr int kMaxDepth = 128;
+
+class Parser {
+   public:
+    Parser(const char* text, size_t length) : p_(text), begin_(text), end_(text + length) {}
+
+    bool parse(Value* out, std::string* error) {
+        skip_ws();
+        if (!value(out, 0)) {
+            *error = error_;
+            return false;
+        }
+        skip_ws();
+        if (p_ != end_) {
+            fail("trailing characters after JSON value");
+            *error = error_;
+            return false;
+        }
+        return true;
+    }
+
+   private:
+    bool fail(const char* what) {
+        if (error_.empty()) {
+            char buf[96];
+            snprintf(buf, sizeof(buf), "%s at offset %zu", what,
+                     static_cast<size_t>(p_ - begin_));
+            error_ = buf;
+        }
+        return false;
+    }
+
+    void skip_ws() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+            ++p_;
+        }
+    }
+
+    bool literal(const char* word) {
+        size_t n = strlen(word);
+        if (static_cast<size_t>(end_ - p_) < n || memcmp(p_, word, n) != 0) {
+            return fail("invalid literal");
+        }
+        p_ += n;
+        return true;
+    }
+
+    bool value(Value* out, int depth) {
+        if (depth > kMaxDepth) {
+            return fail("nesting too deep");
+        }
+        if (p_ == end_) {
+            return fail("unexpected end of input");
+        }
+        switch (*p_) {
+            case '{':
+                return object(out, depth);
+            case '[':
+                return array(out, depth);
+            case '"':
+                out->kind = Value::STRING;
+                return string(&out->str);
+            case 't':
+                out->kind = Value::BOOL;
+                out->boolean = true;
+                return literal("true");
+            case 'f':
+                out->kind = Value::BOOL;
+                out->boolean = false;
+                return literal("false");
+            case 'n':
+                out->kind = Value::NUL;
+                return literal("null");
+            default:
+                return number(out);
+        }
+    }
+
+    bool object(Value* out, int depth) {
+        out->kind = Value::OBJECT;
+        ++p_;
+        skip_ws();
+        if (p_ < end_ && *p_ == '}') {
+            ++p_;
+            return true;
+        }
+        while (true) {
+            skip_ws();
+            if (p_ == end_ || *p_ != '"') {
+                return fail("expected property name");
+            }
+            out->members.emplace_back();
+            auto& member = out->members.back();
+            if (!string(&member.first)) {
+                return false;
+            }
+            skip_ws();
+            if (p_ == end_ || *p_ != ':') {
+                return fail("expected ':'");
+            }
+            ++p_;
+            skip_ws();
+            if (!value(&member.second, depth + 1)) {
+                return false;
+            }
+            skip_ws();
+            if (p_ < end_ && *p_ == ',') {
+                ++p_;
+                continue;
+            }
+            if (p_ < end_ && *p_ == '}') {
+                ++p_;
+                return true;
+            }
+            return fail("expected ',' or '}'");
+        }
+    }
+
+    bool array(Value* out, int depth) {
+        out->kind = Value::ARRAY;
+        ++p_;
+        skip_ws();
+        if (p_ < end_ && *p_ == ']') {
+            ++p_;
+            return true;
+        }
+        while (true) {
+            skip_ws();
+            out->items.emplace_back();
+            if (!value(&out->items.back(), depth + 1)) {
+                return false;
+            }
+            skip_ws();
+            if (p_ < end_ && *p_ == ',') {
+                ++p_;
+                continue;
+            }
+            if (p_ < end_ && *p_ == ']') {
+                ++p_;
+                return true;
+            }
+            return fail("expected ',' or ']'");
+        }
+    }
+
+    bool hex4(uint32_t* out) {
+        if (end_ - p_ < 4) {
+            return fail("truncated \\u escape");
+        }
+        uint32_t cp = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *p_++;
+            cp <<= 4;
+            if (c >= '0' && c <= '9') {
+                cp |= static_cast<uint32_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                cp |= static_cast<uint32_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                cp |= static_cast<uint32_t>(c - 'A' + 10);
+            } else {
+                return fail("invalid \\u escape");
+            }
+        }
+        *out = cp;
+        return true;
+    }
+
+    static void append_utf8(std::string* out, uint32_t cp) {
+        if (cp < 0x80) {
+            out->push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out->push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out->push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out->push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out->push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    bool string(std::string* out) {
+        ++p_;
+        while (true) {
+            const char* run = p_;
+            while (p_ < end_ && *p_ != '"' && *p_ != '\\' &&
+                   static_cast<unsigned char>(*p_) >= 0x20) {
+                ++p_;
+            }
+            out->append(run, static_cast<size_t>(p_ - run));
+            if (p_ == end_) {
+                return fail("unterminated string");
+            }
+            if (*p_ == '"') {
+                ++p_;
+                return true;
+            }
+            if (*p_ != '\\') {
+                return fail("control character in string");
+            }
+            if (++p_ == end_) {
+                return fail("unterminated string");
+            }
+            char esc = *p_++;
+            switch (esc) {
+                case '"':
+                case '\\':
+                case '/':
+                    out->push_back(esc);
+                    break;
+                case 'b':
+                    out->push_back('\b');
+                    break;
+                case 'f':
+                    out->push_back('\f');
+                    break;
+                case 'n':
+                    out->push_back('\n');
+                    break;
+                case 'r':
+                    out->push_back('\r');
+                    break;
+                case 't':
+                    out->push_back('\t');
+                    break;
+                case 'u': {
+                    uint32_t cp = 0;
+                    if (!hex4(&cp)) {
+                        return false;
+                    }
+                    if (cp >= 0xD800 && cp <= 0xDBFF && end_ - p_ >= 6 && p_[0] == '\\' &&
+                        p_[1] == 'u') {
+                        p_ += 2;
+                        uint32_t low = 0;
+                        if (!hex4(&low)) {
+                            return false;
+                        }
+                        if (low >= 0xDC00 && low <= 0xDFFF) {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        } else {
+                            append_utf8(out, 0xFFFD);
+                            cp = low >= 0xD800 && low <= 0xDFFF ? 0xFFFD : low;
+                        }
+                    } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+                        cp = 0xFFFD;
+                    }
+                    append_utf8(out, cp);
+                    break;
+                }
+                default:
+                    return fail("invalid escape");
+            }
+        }
+    }
+
+    bool number(Value* out) {
+        const char* start = p_;
+        if (p_ < end_ && *p_ == '-') {
+            ++p_;
+        }
+        if (p_ == end_ || *p_ < '0' || *p_ > '9') {
+            return fail("unexpected character");
+        }
+        if (*p_ == '0') {
+            ++p_;
+        } else {
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') {
+                ++p_;
+            }
+        }
+        if (p_ < end_ && *p_ == '.') {
+            ++p_;
+            if (p_ == end_ || *p_ < '0' || *p_ > '9') {
+                return fail("invalid number");
+            }
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') {
+                ++p_;
+            }
+        }
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+            ++p_;
+            if (p_ < end_ && (*p_ == '+' || *p_ == '-')) {
+                ++p_;
+            }
+            if (p_ == end_ || *p_ < '0' || *p_ > '9') {
+                return fail("invalid number");
+            }
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') {
+                ++p_;
+            }
+        }
+        // The span is validated above; copy it so strtod cannot read past it
+        std::string digits(start, static_cast<size_t>(p_ - start));
+        out->kind = Value::NUMBER;
+        out->number = strtod(digits.c_str(), nullptr);
+        return true;
+    }
+
+    const char* p_;
+    const char* begin_;
+    const char* end_;
+    std::string error_{};
+};
+
+bool is_integral(double d) {
+    return std::isfinite(d) && std::floor(d) == d;
+}
+
+// Canonical text of a value (object keys sorted) for enum, const and
+// uniqueItems comparisons
+void canonical(const Value& v, std::string* out) {
+    switch (v.kind) {
+        case Value::NUL:
+            out->append("null");
+            break;
+        case Value::BOOL:
+            out->append(v.boolean ? "true" : "false");
+            break;
+        case Value::NUMBER: {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%.17g", v.number);
+            out->append(buf);
+            break;
+        }
+        case Value::STRING:
+            out->push_back('"');
+            for (char c : v.str) {
+                if (c == '"' || c == '\\') {
+                    out->push_back('\\');
+                }
+                out->push_back(c);
+            }
+            out->push_back('"');
+            break;
+        case Value::ARRAY:
+            out->push_back('[');
+            for (size_t i = 0; i < v.items.size(); ++i) {
+                if (i) {
+                    out->push_back(',');
+                }
+                canonical(v.items[i], out);
+            }
+            out->push_back(']');
+            break;
+        case Value::OBJECT: {
+            std::vector<const std::pair<std::string, Value>*> sorted;
+            sorted.reserve(v.members.size());
+            for (const auto& member : v.members) {
+                sorted.push_back(&member);
+            }
+            std::sort(sorted.begin(), sorted.end(),
+                      [](const auto* a, const auto* b) { return a->first < b->first; });
+            out->push_back('{');
+            for (size_t i = 0; i < sorted.size(); ++i) {
+                if (i) {
+                    out->push_back(',');
+                }
+                Value key;
+                key.kind = Value::STRING;
+                key.str = sorted[i]->first;
+                canonical(key, out);
+                out->push_back(':');
+                canonical(sorted[i]->second, out);
+            }
+            out->push_back('}');
+            break;
+        }
+    }
+}
+
+std::string canonical(const Value& v) {
+    std::string out;
+    canonical(v, &out);
+    return out;
+}
+
+// =============================================================================
+// SCHEMA PROGRAM
+// =============================================================================
+
+enum TypeBit : uint8_t {
+    T_NULL = 1 << 0,
+    T_BOOLEAN = 1 << 1,
+    T_INTEGER = 1 << 2,
+    T_NUMBER = 1 << 3,
+    T_STRING = 1 << 4,
+    T_ARRAY = 1 << 5,
+    T_OBJECT = 1 << 6,
+};
+
+constexpr int32_t kAny = -1;   // no constraint
+constexpr int32_t kNone = -2;  // nothing allowed
+
+struct Property {
+    std::string name;
+    int32_t node;
+};
+
+struct Node {
+    bool never{false};  // the `false` schema
+    uint8_t types{0};   // 0 = any type
+
+    bool has_minimum{false}, has_maximum{false};
+    bool exclusive_minimum{false}, exclusive_maximum{false};
+    double minimum{0.0}, maximum{0.0};
+    double multiple_of{0.0};
+
+    int64_t min_length{0}, max_length{-1};
+
+    int32_t items{kAny};  // schema for items past prefix_items
+    std::vector<int32_t> prefix_items{};
+    int64_t min_items{0}, max_items{-1};
+    bool unique_items{false};
+
+    std::vector<Property> properties{};  // sorted by name
+    std::vector<uint32_t> required{};    // indices into properties
+    int32_t additional{kAny};
+    int64_t min_properties{0}, max_properties{-1};
+
+    bool has_enum{false};
+    std::vector<std::string> enum_values{};  // canonical text
+
+    std::vector<int32_t> all_of{}, any_of{}, one_of{};
+    int32_t not_of{kAny};
+    int32_t ref{kAny};
+
+    const Property* property(const std::string& name) const {
+        auto it = std::lower_bound(
+            properties.begin(), properties.end(), name,
+            [](const Property& p, const std::string& key) { return p.name < key; });
+        return it != properties.end() && it->name == name ? &*it : nullptr;
+    }
+};
+
+struct Program {
+    std::vector<Node> nodes;
+};
+
+class Compiler {
+   public:
+    explicit Compiler(const Value& root) : root_(root) {}
+
+    bool compile(Program* program, std::string* error) {
+        program_ = program;
+        refs_["#"] = 0;
+        if (node(root_, 0) < 0 && error_.empty()) {
+            error_ = "schema must be an object or a boolean";
+        }
+        if (!error_.empty()) {
+            *error = error_;
+            return false;
+        }
+        return true;
+    }
+
+   private:
+    bool fail(const std::string& what) {
+        if (error_.empty()) {
+            error_ = what;
+        }
+        return false;
+    }
+
+    static bool read_count(const Value* v, int64_t* out) {
+        if (!v) {
+            return true;
+        }
+        if (v->kind != Value::NUMBER || !is_integral(v->number) || v->number < 0) {
+            return false;
+        }
+        *out = static_cast<int64_t>(v->number);
+        return true;
+    }
+
+    static bool type_bit(const std::string& name, uint8_t* bits) {
+        static const std::pair<const char*, uint8_t> kTypes[] = {
+            {"null", T_NULL},     {"boolean", T_BOOLEAN}, {"integer", T_INTEGER},
+            {"number", T_NUMBER}, {"string", T_STRING},   {"array", T_ARRAY},
+            {"object", T_OBJECT},
+        };
+        for (const auto& t : kTypes) {
+            if (name == t.first) {
+                *bits |= t.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Resolves "#", "#/$defs/x", "#/definitions/x" and deeper JSON pointers
+    const Value* resolve(const std::string& ref) const {
+        if (ref.empty() || ref[0] != '#') {
+            return nullptr;
+        }
+        const Value* v = &root_;
+        size_t pos = 1;
+        while (pos < ref.size()) {
+            if (ref[pos] != '/') {
+                return nullptr;
+            }
+            size_t next = ref.find('/', pos + 1);
+            std::string token = ref.substr(pos + 1, next == std::string::npos ? std::string::npos
+                                                                              : next - pos - 1);
+            std::string key;
+            for (size_t i = 0; i < token.size(); ++i) {
+                if (token[i] == '~' && i + 1 < token.size()) {
+                    key.push_back(token[i + 1] == '1' ? '/' : '~');
+                    ++i;
+                } else {
+                    key.push_back(token[i]);
+                }
+            }
+            if (v->kind == Value::OBJECT) {
+                v = v->find(key.c_str());
+            } else if (v->kind == Value::ARRAY && !key.empty() &&
+                       key.find_first_not_of("0123456789") == std::string::npos &&
+                       strtoul(key.c_str(), nullptr, 10) < v->items.size()) {
+                v = &v->items[strtoul(key.c_str(), nullptr, 10)];
+            } else {
+                return nullptr;
+            }
+            if (!v) {
+                return nullptr;
+            }
+            pos = next == std::string::npos ? ref.size() : next;
+        }
+        return v;
+    }
+
+    int32_t ref_node(const std::string& ref, int depth) {
+        auto it = refs_.find(ref);
+        if (it != refs_.end()) {
+            return it->second;
+        }
+        const Value* target = resolve(ref);
+        if (!target) {
+            fail("unsupported or unresolved $ref " + ref);
+            return kAny;
+        }
+        // Register the slot before filling it so recursive schemas point back at it
+        int32_t index = static_cast<int32_t>(program_->nodes.size());
+        program_->nodes.emplace_back();
+        refs_[ref] = index;
+        return fill(target, index, depth + 1) ? index : kAny;
+    }
+
+    int32_t node(const Value& schema, int depth) {
+        int32_t index = static_cast<int32_t>(program_->nodes.size());
+        program_->nodes.emplace_back();
+        return fill(&schema, index, depth) ? index : kAny;
+    }
+
+    int32_t child(const Value* schema, int depth) {
+        return schema ? node(*schema, depth + 1) : kAny;
+    }
+
+    bool schema_list(const Value* list, const char* keyword, int depth,
+                     std::vector<int32_t>* out) {
+        if (!list) {
+            return true;
+        }
+        if (list->kind != Value::ARRAY || list->items.empty()) {
+            return fail(std::string(keyword) + " must be a non-empty array");
+        }
+        for (const auto& item : list->items) {
+            int32_t sub = node(item, depth + 1);
+            if (sub < 0) {
+                return false;
+            }
+            out->push_back(sub);
+        }
+        return true;
+    }
+
+    bool fill(const Value* schema, int32_t index, int depth) {
+        if (depth > kMaxDepth) {
+            return fail("schema nesting too deep");
+        }
+        if (schema->kind == Value::BOOL) {
+            program_->nodes[static_cast<size_t>(index)].never = !schema->boolean;
+            return true;
+        }
+        if (schema->kind != Value::OBJECT) {
+            return fail("schema must be an object or a boolean");
+        }
+        // Build into a local node: children append to program_->nodes, which
+        // would invalidate a reference into it
+        Node n;
+
+        if (const Value* type = schema->find("type")) {
+            if (type->kind == Value::STRING) {
+                if (!type_bit(type->str, &n.types)) {
+                    return fail("unknown type \"" + type->str + "\"");
+                }
+            } else if (type->kind == Value::ARRAY) {
+                for (const auto& t : type->items) {
+                    if (t.kind != Value::STRING || !type_bit(t.str, &n.types)) {
+                        return fail("invalid entry in type array");
+                    }
+                }
+            } else {
+                return fail("type must be a string or an array");
+            }
+            // "number" admits integers
+            if (n.types & T_NUMBER) {
+                n.types |= T_INTEGER;
+            }
+        }
+
+        if (const Value* values = schema->find("enum")) {
+            if (values->kind != Value::ARRAY) {
+                return fail("enum must be an array");
+            }
+            n.has_enum = true;
+            for (const auto& v : values->items) {
+                n.enum_values.push_back(canonical(v));
+            }
+        }
+        if (const Value* constant = schema->find("const")) {
+            n.has_enum = true;
+            n.enum_values.assign(1, canonical(*constant));
+        }
+
+        auto number_of = [&](const char* key, double* out) -> int {
+            const Value* v = schema->find(key);
+            if (!v) {
+                return 0;
+            }
+            if (v->kind != Value::NUMBER) {
+                return -1;
+            }
+            *out = v->number;
+            return 1;
+        };
+        int found_minimum = number_of("minimum", &n.minimum);
+        int found_maximum = number_of("maximum", &n.maximum);
+        if (found_minimum < 0 || found_maximum < 0) {
+            return fail("minimum and maximum must be numbers");
+        }
+        n.has_minimum = found_minimum > 0;
+        n.has_maximum = found_maximum > 0;
+        for (int upper = 0; upper < 2; ++upper) {
+            const char* key = upper ? "exclusiveMaximum" : "exclusiveMinimum";
+            const Value* v = schema->find(key);
+            if (!v) {
+                continue;
+            }
+            bool& has = upper ? n.has_maximum : n.has_minimum;
+            bool& exclusive = upper ? n.exclusive_maximum : n.exclusive_minimum;
+            double& bound = upper ? n.maximum : n.minimum;
+            if (v->kind == Value::BOOL) {  // draft 4
+                exclusive = v->boolean && has;
+            } else if (v->kind == Value::NUMBER) {
+                if (!has || (upper ? v->number <= bound : v->number >= bound)) {
+                    has = true;
+                    exclusive = true;
+                    bound = v->number;
+                }
+            } else {
+                return fail(std::string(key) + " must be a number");
+            }
+        }
+        int found_multiple = number_of("multipleOf", &n.multiple_of);
+        if (found_multiple < 0 || (found_multiple > 0 && n.multiple_of <= 0)) {
+            return fail("multipleOf must be a positive number");
+        }
+
+        if (!read_count(schema->find("minLength"), &n.min_length) ||
+            !read_count(schema->find("maxLength"), &n.max_length) ||
+            !read_count(schema->find("minItems"), &n.min_items) ||
+            !read_count(schema->find("maxItems"), &n.max_items) ||
+            !read_count(schema->find("minProperties"), &n.min_properties) ||
+            !read_count(schema->find("maxProperties"), &n.max_properties)) {
+            return fail("length and count limits must be non-negative integers");
+        }
+        if (const Value* unique = schema->find("uniqueItems")) {
+            n.unique_items = unique->kind == Value::BOOL && unique->boolean;
+        }
+
+        const Value* items = schema->find("items");
+        const Value* prefix = schema->find("prefixItems");
+        if (items && items->kind == Value::ARRAY) {  // tuple form, before 2020-12
+            prefix = items;
+            items = schema->find("additionalItems");
+        }
+        if (prefix) {
+            if (prefix->kind != Value::ARRAY) {
+                return fail("prefixItems must be an array");
+            }
+            for (const auto& item : prefix->items) {
+                int32_t sub = node(item, depth + 1);
+                if (sub < 0) {
+                    return false;
+                }
+                n.prefix_items.push_back(sub);
+            }
+        }
+        if (items) {
+            if (items->kind == Value::BOOL && !items->boolean) {
+                n.items = kNone;
+            } else if ((n.items = child(items, depth)) < 0) {
+                return false;
+            }
+        }
+
+        if (const Value* properties = schema->find("properties")) {
+            if (properties->kind != Value::OBJECT) {
+                return fail("properties must be an object");
+            }
+            for (const auto& member : properties->members) {
+                int32_t sub = node(member.second, depth + 1);
+                if (sub < 0) {
+                    return false;
+                }
+                n.properties.push_back({member.first, sub});
+            }
+        }
+        std::vector<std::string> required;
+        if (const Value* list = schema->find("required")) {
+            if (list->kind != Value::ARRAY) {
+                return fail("required must be an array");
+            }
+            for (const auto& name : list->items) {
+                if (name.kind != Value::STRING) {
+                    return fail("required entries must be strings");
+                }
+                required.push_back(name.str);
+                // Required names without a schema still need a table slot
+                if (std::none_of(n.properties.begin(), n.properties.end(),
+                                 [&](const Property& p) { return p.name == name.str; })) {
+                    n.properties.push_back({name.str, kAny});
+                }
+            }
+        }
+        std::sort(n.properties.begin(), n.properties.end(),
+                  [](const Property& a, const Property& b) { return a.name < b.name; });
+        for (const auto& name : required) {
+            uint32_t slot = static_cast<uint32_t>(n.property(name) - n.properties.data());
+            if (std::find(n.required.begin(), n.required.end(), slot) == n.required.end()) {
+                n.required.push_back(slot);
+            }
+        }
+        // Names patternProperties matches are not additional, and patterns are
+        // not evaluated, so additionalProperties only applies without them
+        const Value* additional = schema->find("additionalProperties");
+        if (additional && !schema->find("patternProperties")) {
+            if (additional->kind == Value::BOOL) {
+                n.additional = additional->boolean ? kAny : kNone;
+            } else if ((n.additional = child(additional, depth)) < 0) {
+                return false;
+            }
+        }
+
+        if (!schema_list(schema->find("allOf"), "allOf", depth, &n.all_of) ||
+            !schema_list(schema->find("anyOf"), "anyOf", depth, &n.any_of) ||
+            !schema_list(schema->find("oneOf"), "oneOf", depth, &n.one_of)) {
+            return false;
+        }
+        if (const Value* negated = schema->find("not")) {
+            if ((n.not_of = child(negated, depth)) < 0) {
+                return false;
+            }
+        }
+        if (const Value* ref = schema->find("$ref")) {
+            if (ref->kind != Value::STRING) {
+                return fail("$ref must be a string");
+            }
+            if ((n.ref = ref_node(ref->str, depth)) < 0) {
+                return false;
+            }
+        }
+
+        program_->nodes[static_cast<size_t>(index)] = std::move(n);
+        return true;
+    }
+
+    const Value& root_;
+    Program* program_{nullptr};
+    std::map<std::string, int32_t> refs_{};  // $ref -> node
+    std::string error_{};
+};
+
+// =============================================================================
+// VALIDATION
+// =============================================================================
+
+/** Location in the instance, linked from the innermost segment outwards */
+struct Path {
+    const Path* parent;
+    const std::string* key;
+    size_t index;
+};
+
+std::string format_path(const Path* path) {
+    std::vector<const Path*> chain;
+    for (const Path* p = path; p; p = p->parent) {
+        chain.push_back(p);
+    }
+    std::string out = "$";
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        if ((*it)->key) {
+            out.push_back('.');
+            out.append(*(*it)->key);
+        } else {
+            out.append("[" + std::to_string((*it)->index) + "]");
+        }
+    }
+    return out;
+}
+
+const char* type_name(const Value& v) {
+    switch (v.kind) {
+        case Value::NUL:
+            return "null";
+        case Value::BOOL:
+            return "boolean";
+        case Value::NUMBER:
+            return is_integral(v.number) ? "integer" : "number";
+        case Value::STRING:
+            return "string";
+        case Value::ARRAY:
+            return "array";
+        case Value::OBJECT:
+            return "object";
+    }
+    return "value";
+}
+
+std::string expected_types(uint8_t types) {
+    static const char* const kNames[] = {"null",   "boolean", "integer", "number",
+                                         "string", "array",   "object"};
+    if (types & T_NUMBER) {
+        types &= static_cast<uint8_t>(~T_INTEGER);
+    }
+    std::string out;
+    for (int bit = 0; bit < 7; ++bit) {
+        if (types & (1 << bit)) {
+            if (!out.empty()) {
+                out.append(" or ");
+            }
+            out.append(kNames[bit]);
+        }
+    }
+    return out;
+}
+
+size_t utf8_length(const std::string& s) {
+    size_t n = 0;
+    for (unsigned char c : s) {
+        n += (c & 0xC0) != 0x80;
+    }
+    return n;
+}
+
+class Validator {
+   public:
+    explicit Validator(const Program& program) : nodes_(program.nodes) {}
+
+    // Messages are only built when error is non-null; anyOf/oneOf/not probe
+    // their branches without one
+    bool check(int32_t index, const Value& v, const Path* path, std::string* error) const {
+        if (index == kAny) {
+            return true;
+        }
+        // $ref cycles that never descend into the value would not terminate
+        struct Depth {
+            int& d;
+            explicit Depth(int& depth) : d(++depth) {}
+            ~Depth() { --d; }
+        } guard(depth_);
+        if (depth_ > kMaxCheckDepth) {
+            return fail(error, path, "schema recursion too deep");
+        }
+        const Node& n = nodes_[static_cast<size_t>(index)];
+        if (n.never) {
+            return fail(error, path, "value not allowed");
+        }
+
+        if (n.types) {
+            uint8_t bit = 0;
+            switch (v.kind) {
+                case Value::NUL:
+                    bit = T_NULL;
+                    break;
+                case Value::BOOL:
+                    bit = T_BOOLEAN;
+                    break;
+                case Value::NUMBER:
+                    bit = is_integral(v.number) ? T_INTEGER : T_NUMBER;
+                    break;
+                case Value::STRING:
+                    bit = T_STRING;
+                    break;
+                case Value::ARRAY:
+                    bit = T_ARRAY;
+                    break;
+                case Value::OBJECT:
+                    bit = T_OBJECT;
+                    break;
+            }
+            if (!(n.types & bit)) {
+                return fail(error, path,
+                            "expected " + expected_types(n.types) + ", got " + type_name(v));
+            }
+        }
+
+        if (n.has_enum) {
+            std::string text = canonical(v);
+            if (std::find(n.enum_values.begin(), n.enum_values.end(), text) ==
+                n.enum_values.end()) {
+                return fail(error, path, "value not in enum");
+            }
+        }
+
+        switch (v.kind) {
+            case Value::NUMBER:
+                if (!check_number(n, v.number, path, error)) {
+                    return false;
+                }
+                break;
+            case Value::STRING:
+                if (n.min_length > 0 || n.max_length >= 0) {
+                    size_t length = utf8_length(v.str);
+                    if (length < static_cast<size_t>(n.min_length)) {
+                        return fail(error, path,
+                                    "string shorter than minLength " +
+                                        std::to_string(n.min_length));
+                    }
+                    if (n.max_length >= 0 && length > static_cast<size_t>(n.max_length)) {
+                        return fail(error, path,
+                                    "string longer than maxLength " +
+                                        std::to_string(n.max_length));
+                    }
+                }
+                break;
+            case Value::ARRAY:
+                if (!check_array(n, v, path, error)) {
+                    return false;
+                }
+                break;
+            case Value::OBJECT:
+                if (!check_object(n, v, path, error)) {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+
+        for (int32_t sub : n.all_of) {
+            if (!check(sub, v, path, error)) {
+                return false;
+            }
+        }
+        if (!n.any_of.empty() &&
+            std::none_of(n.any_of.begin(), n.any_of.end(),
+                         [&](int32_t sub) { return check(sub, v, path, nullptr); })) {
+            return fail(error, path, "value matches none of anyOf");
+        }
+        if (!n.one_of.empty()) {
+            size_t matches = static_cast<size_t>(
+                std::count_if(n.one_of.begin(), n.one_of.end(),
+                              [&](int32_t sub) { return check(sub, v, path, nullptr); }));
+            if (matches != 1) {
+                return fail(error, path,
+                            "value matches " + std::to_string(matches) +
+                                " of oneOf, expected exactly one");
+            }
+        }
+        if (n.not_of != kAny && check(n.not_of, v, path, nullptr)) {
+            return fail(error, path, "value matches a schema under not");
+        }
+        if (n.ref != kAny && !check(n.ref, v, path, error)) {
+            return false;
+        }
+        return true;
+    }
+
+   private:
+    static bool fail(std::string* error, const Path* path, const std::string& what) {
+        if (error) {
+            *error = format_path(path) + ": " + what;
+        }
+        return false;
+    }
+
+    static std::string number_text(double d) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.15g", d);
+        return buf;
+    }
+
+    static bool check_number(const Node& n, double d, const Path* path, std::string* error) {
+        if (n.has_minimum && (n.exclusive_minimum ? d <= n.minimum : d < n.minimum)) {
+            return fail(error, path,
+                        number_text(d) + " is below " +
+                            (n.exclusive_minimum ? "exclusiveMinimum " : "minimum ") +
+                            number_text(n.minimum));
+        }
+        if (n.has_maximum && (n.exclusive_maximum ? d >= n.maximum : d > n.maximum)) {
+            return fail(error, path,
+                        number_text(d) + " is above " +
+                            (n.exclusive_maximum ? "exclusiveMaximum " : "maximum ") +
+                            number_text(n.maximum));
+        }
+        if (n.multiple_of > 0) {
+            double quotient = d / n.multiple_of;
+            if (std::fabs(quotient - std::round(quotient)) > 1e-9 * std::max(1.0, quotient)) {
+                return fail(error, path,
+                            number_text(d) + " is not a multiple of " +
+                                number_text(n.multiple_of));
+            }
+        }
+        return true;
+    }
+
+    bool check_array(const Node& n, const Value& v, const Path* path, std::string* error) const {
+        size_t count = v.items.size();
+        if (count < static_cast<size_t>(n.min_items)) {
+            return fail(error, path,
+                        "array has " + std::to_string(count) + " items, minItems is " +
+                            std::to_string(n.min_items));
+        }
+        if (n.max_items >= 0 && count > static_cast<size_t>(n.max_items)) {
+            return fail(error, path,
+                        "array has " + std::to_string(count) + " items, maxItems is " +
+                            std::to_string(n.max_items));
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Path item_path{path, nullptr, i};
+            int32_t sub = i < n.prefix_items.size() ? n.prefix_items[i] : n.items;
+            if (sub == kNone) {
+                return fail(error, &item_path, "additional item not allowed");
+            }
+            if (!check(sub, v.items[i], &item_path, error)) {
+                return false;
+            }
+        }
+        if (n.unique_items && count > 1) {
+            std::vector<std::string> seen;
+            seen.reserve(count);
+            for (const auto& item : v.items) {
+                seen.push_back(canonical(item));
+            }
+            std::sort(seen.begin(), seen.end());
+            if (std::adjacent_find(seen.begin(), seen.end()) != seen.end()) {
+                return fail(error, path, "array items are not unique");
+            }
+        }
+        return true;
+    }
+
+    bool check_object(const Node& n, const Value& v, const Path* path, std::string* error) const {
+        size_t count = v.members.size();
+        if (count < static_cast<size_t>(n.min_properties)) {
+            return fail(error, path,
+                        "object has " + std::to_string(count) + " properties, minProperties is " +
+                            std::to_string(n.min_properties));
+        }
+        if (n.max_properties >= 0 && count > static_cast<size_t>(n.max_properties)) {
+            return fail(error, path,
+                        "object has " + std::to_string(count) + " properties, maxProperties is " +
+                            std::to_string(n.max_properties));
+        }
+
+        // One bit per property slot; most schemas have fewer than 64
+        uint64_t seen_small = 0;
+        std::vector<bool> seen_large;
+        bool small = n.properties.size() <= 64;
+        if (!small) {
+            seen_large.assign(n.properties.size(), false);
+        }
+
+        for (const auto& member : v.members) {
+            Path member_path{path, &member.first, 0};
+            const Property* prop = n.properties.empty() ? nullptr : n.property(member.first);
+            int32_t sub = n.additional;
+            if (prop) {
+                size_t slot = static_cast<size_t>(prop - n.properties.data());
+                if (small) {
+                    seen_small |= uint64_t{1} << slot;
+                } else {
+                    seen_large[slot] = true;
+                }
+                sub = prop->node;
+            } else if (sub == kNone) {
+                return fail(error, path, "unexpected property \"" + member.first + "\"");
+            }
+            if (!check(sub, member.second, &member_path, error)) {
+                return false;
+            }
+        }
+
+        for (uint32_t slot : n.required) {
+            bool present = small ? (seen_small >> slot) & 1 : seen_large[slot];
+            if (!present) {
+                return fail(error, path,
+                            "missing required property \"" + n.properties[slot].name + "\"");
+            }
+        }
+        return true;
+    }
+
+    static constexpr int kMaxCheckDepth = 4 * kMaxDepth;
+
+    const std::vector<Node>& nodes_;
+    mutable int depth_{0};
+};
+
+// =============================================================================
+// PROGRAM CACHE
+// =============================================================================
+
+struct CacheEntry {
+    uint64_t hash;
+    std::string schema;
+    std::shared_ptr<const Program> program;  // null if the schema is invalid
+    std::string error;
+};
+
+constexpr size_t kSchemaCacheSize = 16;
+
+std::mutex g_cache_mutex;
+std::vector<CacheEntry> g_cache;  // most recently used first
+
+// Returns the compiled program for a schema, compiling it on first use.
+// Invalid schemas are cached too so they are not re-parsed on every call.
+std::shared_ptr<const Program> program_for(const char* json_schema, std::string* error) {
+    const uint64_t hash = rac_structured_output_schema_hash(json_schema);
+    {
+        std::lock_guard<std::mutex> lock(g_cache_mutex);
+        auto it = std::find_if(g_cache.begin(), g_cache.end(), [&](const CacheEntry& e) {
+            return e.hash == hash && e.schema == json_schema;
+        });
+        if (it != g_cache.end()) {
+            std::rotate(g_cache.begin(), it, it + 1);
+            *error = g_cache.front().error;
+            return g_cache.front().program;
+        }
+    }
+
+    // Compile outside the lock; two threads racing on a new schema just both
+    // compile it
+    Value schema;
+    auto program = std::make_shared<Program>();
+    std::string reason;
+    if (!Parser(json_schema, strlen(json_schema)).parse(&schema, &reason)) {
+        reason = "schema is not valid JSON: " + reason;
+        program.reset();
+    } else if (!Compiler(schema).compile(program.get(), &reason)) {
+        program.reset();
+    }
+    if (program) {
+        RAC_LOG_DEBUG(LOG_CAT, "Compiled JSON schema %016llx (%zu nodes)",
+                      static_cast<unsigned long long>(hash), program->nodes.size());
+    } else {
+        RAC_LOG_WARNING(LOG_CAT, "Invalid JSON schema: %s", reason.c_str());
+    }
+
+    std::lock_guard<std::mutex> lock(g_cache_mutex);
+    if (g_cache.size() >= kSchemaCacheSize) {
+        g_cache.pop_back();
+    }
+    g_cache.insert(g_cache.begin(), {hash, json_schema, program, reason});
+    *error = reason;
+    return program;
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" uint64_t rac_structured_output_schema_hash(const char* json_schema) {
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (const char* p = json_schema; p && *p; ++p) {
+        hash = (hash ^ static_cast<unsigned char>(*p)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+extern "C" rac_result_t rac_structured_output_validate_json(const char* json, size_t length,
+                                                            const char* json_schema,
+                                                            rac_bool_t* out_valid,
+                                                            char** out_error) {
+    if (!json || !json_schema || !out_valid) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    *out_valid = RAC_FALSE;
+    if (out_error) {
+        *out_error = nullptr;
+    }
+
+    std::string error;
+    std::shared_ptr<const Program> program = program_for(json_schema, &error);
+    if (!program) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    Value instance;
+    if (!Parser(json, length).parse(&instance, &error)) {
+        error = "invalid JSON: " + error;
+    } else if (Validator(*program).check(0, instance, nullptr, out_error ? &error : nullptr)) {
+        *out_valid = RAC_TRUE;
+        return RAC_SUCCESS;
+    }
+
+    if (out_error) {
+        *out_error = rac_strdup(error.c_str());
+    }
+    return RAC_SUCCESS;
+}
+
+extern "C" void rac_structured_output_schema_cache_clear(void) {
+    std::lock_guard<std::mutex> lock(g_cache_mutex);
+    g_cache.clear();
+}
@@ -15,6 +15,7 @@
 #include <sstream>
 #include <string>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
 #include "rac/features/llm/rac_llm_analytics.h"
 
@@ -167,7 +168,8 @@ rac_result_t rac_llm_analytics_start_generation(rac_llm_analytics_handle_t handl
     handle->active_generations[id] = tracker;
 
     // Allocate and copy the ID for the caller
-    *out_generation_id = static_cast<char*>(malloc(id.size() + 1));
+    *out_generation_id =
+        static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_TELEMETRY, id.size() + 1));
     if (!*out_generation_id) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
@@ -206,7 +208,8 @@ rac_result_t rac_llm_analytics_start_streaming_generation(
     handle->active_generations[id] = tracker;
 
     // Allocate and copy the ID for the caller
-    *out_generation_id = static_cast<char*>(malloc(id.size() + 1));
+    *out_generation_id =
+        static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_TELEMETRY, id.size() + 1));
     if (!*out_generation_id) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
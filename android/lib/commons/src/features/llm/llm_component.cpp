@@ -9,18 +9,27 @@
  * Do NOT add features not present in the Swift code.
  */
 
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
 #include <cstring>
+#include <list>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "rac/core/capabilities/rac_lifecycle.h"
 #include "rac/core/rac_analytics_events.h"
+#include "rac/core/rac_core.h"
 #include "rac/core/rac_logger.h"
+#include "rac/core/rac_memory_watermark.h"
+#include "rac/core/rac_metrics.h"
 #include "rac/core/rac_platform_adapter.h"
 #include "rac/core/rac_structured_error.h"
 #include "rac/features/llm/rac_llm_component.h"
+#include "rac/features/llm/rac_llm_metrics.h"
 #include "rac/features/llm/rac_llm_service.h"
 #include "rac/infrastructure/events/rac_events.h"
 
@@ -28,6 +37,67 @@
 // INTERNAL STRUCTURES
 // =============================================================================
 
+namespace {
+
+/**
+ * LRU of tokenizer counts, keyed by model and a hash of the text. Prompt
+ * budget checks count the same system prompt and history turns over and
+ * over; only text not seen before reaches the tokenizer.
+ */
+class TokenCountCache {
+   public:
+    static constexpr size_t kCapacity = 512;
+
+    bool get(const std::string& model_id, const char* text, size_t length, int32_t* out_count) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto it = index_.find(key_of(model_id, text, length));
+        if (it == index_.end()) {
+            return false;
+        }
+        entries_.splice(entries_.begin(), entries_, it->second);
+        *out_count = it->second->second;
+        return true;
+    }
+
+    void put(const std::string& model_id, const char* text, size_t length, int32_t count) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        std::string key = key_of(model_id, text, length);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            it->second->second = count;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        entries_.emplace_front(key, count);
+        index_.emplace(std::move(key), entries_.begin());
+        if (entries_.size() > kCapacity) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+   private:
+    // 64-bit FNV-1a of the text plus its length; a collision would need both
+    // to match for the same model
+    static std::string key_of(const std::string& model_id, const char* text, size_t length) {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(text[i])) * 1099511628211ull;
+        }
+        std::string key = model_id;
+        key.push_back('\0');
+        key.append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+        key.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        return key;
+    }
+
+    std::mutex mtx_;
+    std::list<std::pair<std::string, int32_t>> entries_;  // most recent first
+    std::unordered_map<std::string, std::list<std::pair<std::string, int32_t>>::iterator> index_;
+};
+
+}  // namespace
+
 /**
  * Internal LLM component state.
  * Mirrors Swift's LLMCapability actor state.
@@ -42,10 +112,29 @@ struct rac_llm_component {
     /** Default generation options based on config */
     rac_llm_options_t default_options;
 
+    /** Conversation history for chat_stream */
+    rac_llm_context_handle_t conversation;
+
     /** Mutex for thread safety */
     std::mutex mtx;
 
-    rac_llm_component() : lifecycle(nullptr) {
+    /** Tokenizer counts (rac_llm_component_count_tokens) */
+    TokenCountCache token_cache;
+
+    /** Backend options for the next load (rac_llm_component_set_backend_config).
+        Guarded by its own mutex: services are created during a load, which
+        holds mtx. */
+    std::string backend_config;
+    std::mutex backend_config_mtx;
+
+    /** LoRA adapters (name, path) and the selected one, loaded into every
+        service the component creates. Own mutex for the same reason. */
+    std::vector<std::pair<std::string, std::string>> lora_adapters;
+    std::string lora_selected;
+    float lora_scale = 0.0f;
+    std::mutex lora_mtx;
+
+    rac_llm_component() : lifecycle(nullptr), conversation(nullptr) {
         // Initialize with defaults - matches rac_llm_types.h rac_llm_config_t
         config = RAC_LLM_CONFIG_DEFAULT;
 
@@ -69,6 +158,42 @@ static int32_t estimate_tokens(const char* text) {
     return tokens > 0 ? tokens : 1;  // Minimum 1 token
 }
 
+/**
+ * Count tokens with the service's tokenizer, falling back to the estimate
+ * when the backend cannot tokenize.
+ */
+static int32_t count_tokens(rac_handle_t service, const char* text) {
+    int32_t count = 0;
+    if (text && rac_llm_count_tokens(service, text, &count) == RAC_SUCCESS) {
+        return count;
+    }
+    return estimate_tokens(text);
+}
+
+/**
+ * Count tokens like count_tokens, going through the component's cache.
+ * Fallback estimates are not cached.
+ */
+static int32_t cached_count_tokens(rac_llm_component* component, rac_handle_t service,
+                                   const char* text) {
+    if (!text) {
+        return estimate_tokens(text);
+    }
+    const char* model = rac_lifecycle_get_model_id(component->lifecycle);
+    const std::string model_id = model ? model : "";
+    const size_t length = strlen(text);
+
+    int32_t count = 0;
+    if (component->token_cache.get(model_id, text, length, &count)) {
+        return count;
+    }
+    if (rac_llm_count_tokens(service, text, &count) == RAC_SUCCESS) {
+        component->token_cache.put(model_id, text, length, count);
+        return count;
+    }
+    return estimate_tokens(text);
+}
+
 /**
  * Generate a unique ID for generation tracking.
  */
@@ -91,12 +216,34 @@ static std::string generate_unique_id() {
  */
 static rac_result_t llm_create_service(const char* model_id, void* user_data,
                                        rac_handle_t* out_service) {
-    (void)user_data;
+    auto* component = static_cast<rac_llm_component*>(user_data);
 
     RAC_LOG_INFO("LLM.Component", "Creating LLM service for model: %s", model_id ? model_id : "");
 
+    // Forward the lifecycle's load mode and the backend options to the backend.
+    // The options object is appended after load_mode, so its keys win.
+    std::string config_json;
+    const rac_model_load_mode_t load_mode =
+        component ? rac_lifecycle_get_load_mode(component->lifecycle) : RAC_MODEL_LOAD_MODE_DEFAULT;
+    if (load_mode != RAC_MODEL_LOAD_MODE_DEFAULT) {
+        config_json = "{\"load_mode\":" + std::to_string(static_cast<int>(load_mode)) + "}";
+    }
+    if (component) {
+        std::lock_guard<std::mutex> lock(component->backend_config_mtx);
+        const std::string& options = component->backend_config;
+        const size_t body = options.find_first_not_of(" \t\r\n", 1);
+        const bool has_options = body != std::string::npos && options[body] != '}';
+        if (has_options && config_json.empty()) {
+            config_json = options;
+        } else if (has_options) {
+            config_json.back() = ',';
+            config_json.append(options, 1, std::string::npos);
+        }
+    }
+
     // Create LLM service
-    rac_result_t result = rac_llm_create(model_id, out_service);
+    rac_result_t result = rac_llm_create_with_config(
+        model_id, config_json.empty() ? nullptr : config_json.c_str(), out_service);
     if (result != RAC_SUCCESS) {
         RAC_LOG_ERROR("LLM.Component", "Failed to create LLM service: %d", result);
         return result;
@@ -111,6 +258,30 @@ static rac_result_t llm_create_service(const char* model_id, void* user_data,
         return result;
     }
 
+    // Adapters follow the component across reloads; ones that do not fit
+    // this model are dropped
+    if (component) {
+        std::lock_guard<std::mutex> lock(component->lora_mtx);
+        auto& adapters = component->lora_adapters;
+        for (auto it = adapters.begin(); it != adapters.end();) {
+            if (rac_llm_load_lora(*out_service, it->first.c_str(), it->second.c_str()) ==
+                RAC_SUCCESS) {
+                ++it;
+                continue;
+            }
+            RAC_LOG_WARNING("LLM.Component", "Dropping LoRA adapter %s: it does not load on %s",
+                            it->first.c_str(), model_id ? model_id : "");
+            if (component->lora_selected == it->first) {
+                component->lora_selected.clear();
+            }
+            it = adapters.erase(it);
+        }
+        if (!component->lora_selected.empty()) {
+            rac_llm_set_lora(*out_service, component->lora_selected.c_str(),
+                             component->lora_scale);
+        }
+    }
+
     RAC_LOG_INFO("LLM.Component", "LLM service created successfully");
     return RAC_SUCCESS;
 }
@@ -129,6 +300,66 @@ static void llm_destroy_service(rac_handle_t service, void* user_data) {
     }
 }
 
+static int64_t llm_memory_bytes(rac_handle_t service) {
+    rac_llm_memory_usage_t usage = {};
+    if (!service || rac_llm_get_memory_usage(service, &usage) != RAC_SUCCESS) {
+        return 0;
+    }
+    return usage.total_bytes;
+}
+
+// Publish one generation's memory use to rac_metrics and its completed event
+static void record_memory(const rac_inference_memory_t& memory,
+                          rac_analytics_llm_generation_t& event) {
+    static const rac::MetricHistogram peak_rss_mb("llm.peak_rss_mb");
+    static const rac::MetricGauge rss_delta_mb("llm.rss_delta_mb");
+    static const rac::MetricGauge backend_mb("llm.backend_mb");
+    if (memory.peak_rss_bytes > 0) {
+        peak_rss_mb.record(memory.peak_rss_bytes >> 20);
+        rss_delta_mb.set(static_cast<double>(memory.rss_delta_bytes) / (1024.0 * 1024.0));
+    }
+    if (memory.backend_bytes > 0) {
+        backend_mb.set(static_cast<double>(memory.backend_bytes) / (1024.0 * 1024.0));
+    }
+    event.peak_rss_bytes = memory.peak_rss_bytes;
+    event.rss_delta_bytes = memory.rss_delta_bytes;
+    event.backend_memory_bytes = memory.backend_bytes;
+}
+
+/**
+ * Memory pressure stages for the LLM: drop the prefix cache, then shrink the
+ * context, then unload the model if no generation holds the component.
+ */
+static int64_t llm_memory_pressure_handler(rac_memory_pressure_stage_t stage, void* user_data) {
+    auto* component = static_cast<rac_llm_component*>(user_data);
+    rac_handle_t service = rac_lifecycle_get_service(component->lifecycle);
+    if (!service) {
+        return 0;
+    }
+
+    const int64_t before = llm_memory_bytes(service);
+    switch (stage) {
+        case RAC_MEMORY_PRESSURE_STAGE_DROP_CACHES:
+            rac_llm_trim_memory(service, RAC_LLM_MEMORY_PRESSURE_MODERATE);
+            break;
+        case RAC_MEMORY_PRESSURE_STAGE_SHRINK_CONTEXT:
+            rac_llm_trim_memory(service, RAC_LLM_MEMORY_PRESSURE_LOW);
+            break;
+        case RAC_MEMORY_PRESSURE_STAGE_UNLOAD_IDLE: {
+            std::unique_lock<std::mutex> lock(component->mtx, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                return 0;
+            }
+            log_info("LLM.Component", "Unloading idle LLM under memory pressure");
+            rac_lifecycle_unload(component->lifecycle);
+            return before;
+        }
+        default:
+            return 0;
+    }
+    return std::max<int64_t>(0, before - llm_memory_bytes(service));
+}
+
 // =============================================================================
 // LIFECYCLE API
 // =============================================================================
@@ -157,6 +388,8 @@ extern "C" rac_result_t rac_llm_component_create(rac_handle_t* out_handle) {
         return result;
     }
 
+    rac_memory_pressure_register("LLM.Component", llm_memory_pressure_handler, component);
+
     *out_handle = reinterpret_cast<rac_handle_t>(component);
 
     RAC_LOG_INFO("LLM.Component", "LLM component created");
@@ -212,11 +445,13 @@ extern "C" void rac_llm_component_destroy(rac_handle_t handle) {
         return;
 
     auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    rac_memory_pressure_unregister(llm_memory_pressure_handler, component);
 
     // Destroy lifecycle manager (will cleanup service if loaded)
     if (component->lifecycle) {
         rac_lifecycle_destroy(component->lifecycle);
     }
+    rac_llm_context_destroy(component->conversation);
 
     log_info("LLM.Component", "LLM component destroyed");
 
@@ -240,6 +475,45 @@ extern "C" rac_result_t rac_llm_component_load_model(rac_handle_t handle, const
     return rac_lifecycle_load(component->lifecycle, model_path, model_id, model_name, &service);
 }
 
+extern "C" rac_result_t rac_llm_component_load_model_async(
+    rac_handle_t handle, const char* model_path, const char* model_id, const char* model_name,
+    rac_lifecycle_load_progress_fn progress_fn, rac_lifecycle_load_complete_fn complete_fn,
+    void* user_data, rac_lifecycle_load_handle_t* out_load) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    // No component lock: the lifecycle serializes loads, and holding the lock
+    // for the whole load would block every other component call
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    return rac_lifecycle_load_async(component->lifecycle, model_path, model_id, model_name,
+                                    progress_fn, complete_fn, user_data, out_load);
+}
+
+extern "C" rac_result_t rac_llm_component_set_load_mode(rac_handle_t handle,
+                                                        rac_model_load_mode_t mode) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    return rac_lifecycle_set_load_mode(component->lifecycle, mode);
+}
+
+extern "C" rac_result_t rac_llm_component_set_backend_config(rac_handle_t handle,
+                                                             const char* config_json) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    const size_t start = config_json ? strspn(config_json, " \t\r\n") : 0;
+    if (config_json && config_json[start] != '\0' && config_json[start] != '{') {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->backend_config_mtx);
+    component->backend_config = config_json ? config_json + start : "";
+    return RAC_SUCCESS;
+}
+
 extern "C" rac_result_t rac_llm_component_unload(rac_handle_t handle) {
     if (!handle)
         return RAC_ERROR_INVALID_HANDLE;
@@ -335,7 +609,12 @@ extern "C" rac_result_t rac_llm_component_generate(rac_handle_t handle, const ch
     auto start_time = std::chrono::steady_clock::now();
 
     // Perform generation
+    rac_memory_watermark_t watermark;
+    rac_memory_watermark_begin(&watermark);
     result = rac_llm_generate(service, prompt, effective_options, out_result);
+    rac_inference_memory_t memory;
+    rac_memory_watermark_end(&watermark, result == RAC_SUCCESS ? llm_memory_bytes(service) : 0,
+                             &memory);
 
     if (result != RAC_SUCCESS) {
         log_error("LLM.Component", "Generation failed");
@@ -360,22 +639,23 @@ extern "C" rac_result_t rac_llm_component_generate(rac_handle_t handle, const ch
     int64_t total_time_ms = duration.count();
 
     // Update result metrics
-    // Use actual token counts from backend if available, otherwise estimate
+    // Use actual token counts from backend if available, otherwise count with its tokenizer
     log_debug("LLM.Component", "Backend returned prompt_tokens=%d, completion_tokens=%d",
               out_result->prompt_tokens, out_result->completion_tokens);
 
     if (out_result->prompt_tokens <= 0) {
-        out_result->prompt_tokens = estimate_tokens(prompt);
-        log_debug("LLM.Component", "Using estimated prompt_tokens=%d", out_result->prompt_tokens);
+        out_result->prompt_tokens = cached_count_tokens(component, service, prompt);
+        log_debug("LLM.Component", "Counted prompt_tokens=%d", out_result->prompt_tokens);
     }
     if (out_result->completion_tokens <= 0) {
-        out_result->completion_tokens = estimate_tokens(out_result->text);
-        log_debug("LLM.Component", "Using estimated completion_tokens=%d",
+        out_result->completion_tokens = count_tokens(service, out_result->text);
+        log_debug("LLM.Component", "Counted completion_tokens=%d",
                   out_result->completion_tokens);
     }
     out_result->total_tokens = out_result->prompt_tokens + out_result->completion_tokens;
     out_result->total_time_ms = total_time_ms;
     out_result->time_to_first_token_ms = 0;  // Non-streaming: no TTFT
+    out_result->memory = memory;
 
     double tokens_per_second = 0.0;
     if (total_time_ms > 0) {
@@ -396,7 +676,7 @@ extern "C" rac_result_t rac_llm_component_generate(rac_handle_t handle, const ch
         event.data.llm_generation.generation_id = generation_id.c_str();
         event.data.llm_generation.model_id = model_id;
         event.data.llm_generation.model_name = model_name;
-        event.data.llm_generation.input_tokens = estimate_tokens(prompt);
+        event.data.llm_generation.input_tokens = out_result->prompt_tokens;
         event.data.llm_generation.output_tokens = out_result->completion_tokens;
         event.data.llm_generation.duration_ms = static_cast<double>(total_time_ms);
         event.data.llm_generation.tokens_per_second = tokens_per_second;
@@ -408,12 +688,64 @@ extern "C" rac_result_t rac_llm_component_generate(rac_handle_t handle, const ch
         event.data.llm_generation.max_tokens = effective_options->max_tokens;
         event.data.llm_generation.context_length = context_length;
         event.data.llm_generation.error_code = RAC_SUCCESS;
+        record_memory(memory, event.data.llm_generation);
         rac_analytics_event_emit(RAC_EVENT_LLM_GENERATION_COMPLETED, &event);
     }
 
     return RAC_SUCCESS;
 }
 
+extern "C" rac_result_t rac_llm_component_generate_batch(rac_handle_t handle,
+                                                         const char* const* prompts,
+                                                         size_t num_prompts,
+                                                         const rac_llm_options_t* options,
+                                                         rac_llm_batch_callback_fn callback,
+                                                         void* user_data) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!prompts || !callback)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->mtx);
+
+    rac_handle_t service = nullptr;
+    rac_result_t result = rac_lifecycle_require_service(component->lifecycle, &service);
+    if (result != RAC_SUCCESS) {
+        log_error("LLM.Component", "No model loaded - cannot generate batch");
+        return result;
+    }
+
+    const rac_llm_options_t* effective_options = options ? options : &component->default_options;
+    log_info("LLM.Component", "Batch generation of %zu prompts", num_prompts);
+    return rac_llm_generate_batch(service, prompts, num_prompts, effective_options, callback,
+                                  user_data);
+}
+
+extern "C" rac_result_t rac_llm_component_generate_samples(rac_handle_t handle, const char* prompt,
+                                                           const rac_llm_options_t* options,
+                                                           rac_llm_samples_t* out_samples) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!prompt || !out_samples)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->mtx);
+
+    rac_handle_t service = nullptr;
+    rac_result_t result = rac_lifecycle_require_service(component->lifecycle, &service);
+    if (result != RAC_SUCCESS) {
+        log_error("LLM.Component", "No model loaded - cannot generate samples");
+        return result;
+    }
+
+    const rac_llm_options_t* effective_options = options ? options : &component->default_options;
+    log_info("LLM.Component", "Generating %d samples",
+             effective_options->n_samples > 1 ? effective_options->n_samples : 1);
+    return rac_llm_generate_samples(service, prompt, effective_options, out_samples);
+}
+
 extern "C" rac_bool_t rac_llm_component_supports_streaming(rac_handle_t handle) {
     if (!handle)
         return RAC_FALSE;
@@ -444,12 +776,9 @@ struct llm_stream_context {
     rac_llm_component_error_callback_fn error_callback;
     void* user_data;
 
-    // Metrics tracking
-    std::chrono::steady_clock::time_point start_time;
-    std::chrono::steady_clock::time_point first_token_time;
+    // Metrics tracking (timing and text; token counts come from the tokenizer)
+    rac_streaming_metrics_handle_t metrics;
     bool first_token_recorded;
-    std::string full_text;
-    int32_t prompt_tokens;
 
     // Analytics event data
     std::string generation_id;
@@ -467,15 +796,18 @@ struct llm_stream_context {
 static rac_bool_t llm_stream_token_callback(const char* token, void* user_data) {
     auto* ctx = reinterpret_cast<llm_stream_context*>(user_data);
 
-    // Track first token time and emit first token event
-    if (!ctx->first_token_recorded) {
+    // Accumulate text and track token count
+    if (token) {
+        rac_streaming_metrics_record_token(ctx->metrics, token);
+        ctx->token_count++;
+    }
+
+    // Emit first token event
+    if (token && !ctx->first_token_recorded) {
         ctx->first_token_recorded = true;
-        ctx->first_token_time = std::chrono::steady_clock::now();
 
-        // Calculate TTFT
-        auto ttft_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-            ctx->first_token_time - ctx->start_time);
-        double ttft_ms = static_cast<double>(ttft_duration.count());
+        double ttft_ms = 0.0;
+        rac_streaming_metrics_get_ttft(ctx->metrics, &ttft_ms);
 
         // Emit first token event
         rac_analytics_event_data_t event = {};
@@ -489,13 +821,10 @@ static rac_bool_t llm_stream_token_callback(const char* token, void* user_data)
         rac_analytics_event_emit(RAC_EVENT_LLM_FIRST_TOKEN, &event);
     }
 
-    // Accumulate text and track token count
+    // Emit streaming update event (every 10 tokens to avoid spam)
     if (token) {
-        ctx->full_text += token;
-        ctx->token_count++;
-
-        // Emit streaming update event (every 10 tokens to avoid spam)
-        if (ctx->token_count % 10 == 0) {
+        if (ctx->token_count % 10 == 0 &&
+            rac_analytics_event_is_observed(RAC_EVENT_LLM_STREAMING_UPDATE)) {
             rac_analytics_event_data_t event = {};
             event.type = RAC_EVENT_LLM_STREAMING_UPDATE;
             event.data.llm_generation = RAC_ANALYTICS_LLM_GENERATION_DEFAULT;
@@ -603,14 +932,23 @@ extern "C" rac_result_t rac_llm_component_generate_stream(
     }
 
     // Setup streaming context
+    rac_streaming_metrics_handle_t metrics = nullptr;
+    result = rac_streaming_metrics_create(model_id ? model_id : "", generation_id.c_str(),
+                                          static_cast<int32_t>(strlen(prompt)), &metrics);
+    if (result != RAC_SUCCESS) {
+        if (error_callback) {
+            error_callback(result, "Failed to create streaming metrics", user_data);
+        }
+        return result;
+    }
+
     llm_stream_context ctx;
     ctx.token_callback = token_callback;
     ctx.complete_callback = complete_callback;
     ctx.error_callback = error_callback;
     ctx.user_data = user_data;
-    ctx.start_time = std::chrono::steady_clock::now();
+    ctx.metrics = metrics;
     ctx.first_token_recorded = false;
-    ctx.prompt_tokens = estimate_tokens(prompt);
     ctx.generation_id = generation_id;
     ctx.model_id = model_id;
     ctx.model_name = model_name;
@@ -619,13 +957,24 @@ extern "C" rac_result_t rac_llm_component_generate_stream(
     ctx.max_tokens = effective_options->max_tokens;
     ctx.token_count = 0;
 
+    // Count the prompt before generating so the backend is idle
+    const int32_t prompt_tokens = cached_count_tokens(component, service, prompt);
+
     // Perform streaming generation
+    rac_streaming_metrics_mark_start(metrics);
+    rac_memory_watermark_t watermark;
+    rac_memory_watermark_begin(&watermark);
     result = rac_llm_generate_stream(service, prompt, effective_options, llm_stream_token_callback,
                                      &ctx);
+    rac_inference_memory_t memory;
+    rac_memory_watermark_end(&watermark, result == RAC_SUCCESS ? llm_memory_bytes(service) : 0,
+                             &memory);
 
     if (result != RAC_SUCCESS) {
         log_error("LLM.Component", "Streaming generation failed");
         rac_lifecycle_track_error(component->lifecycle, result, "generateStream");
+        rac_streaming_metrics_mark_failed(metrics, result);
+        rac_streaming_metrics_destroy(metrics);
 
         // Emit generation failed event
         rac_analytics_event_data_t event = {};
@@ -644,35 +993,34 @@ extern "C" rac_result_t rac_llm_component_generate_stream(
         return result;
     }
 
-    // Build final result for completion callback
-    auto end_time = std::chrono::steady_clock::now();
-    auto total_duration =
-        std::chrono::duration_cast<std::chrono::milliseconds>(end_time - ctx.start_time);
-    int64_t total_time_ms = total_duration.count();
+    // Build final result for completion callback from the collector, with
+    // tokenizer counts so throughput reflects real tokens
+    rac_streaming_metrics_mark_complete(metrics);
+
+    char* full_text = nullptr;
+    rac_streaming_metrics_get_text(metrics, &full_text);
+    rac_streaming_metrics_set_token_counts(metrics, prompt_tokens,
+                                           count_tokens(service, full_text ? full_text : ""));
+
+    rac_streaming_result_t stream_result = {};
+    rac_streaming_metrics_get_result(metrics, &stream_result);
+    rac_streaming_metrics_destroy(metrics);
+    rac_free(full_text);
+
+    int64_t total_time_ms = static_cast<int64_t>(stream_result.latency_ms);
+    double ttft_ms = stream_result.ttft_ms;
+    double tokens_per_second = stream_result.tokens_per_second;
 
     rac_llm_result_t final_result = {};
-    final_result.text = strdup(ctx.full_text.c_str());
-    final_result.prompt_tokens = ctx.prompt_tokens;
-    final_result.completion_tokens = estimate_tokens(ctx.full_text.c_str());
+    final_result.text = stream_result.text;
+    final_result.prompt_tokens = stream_result.input_tokens;
+    final_result.completion_tokens = stream_result.output_tokens;
     final_result.total_tokens = final_result.prompt_tokens + final_result.completion_tokens;
     final_result.total_time_ms = total_time_ms;
-
-    double ttft_ms = 0.0;
-    // Calculate TTFT
-    if (ctx.first_token_recorded) {
-        auto ttft_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-            ctx.first_token_time - ctx.start_time);
-        final_result.time_to_first_token_ms = ttft_duration.count();
-        ttft_ms = static_cast<double>(ttft_duration.count());
-    }
-
-    // Calculate tokens per second
-    double tokens_per_second = 0.0;
-    if (final_result.total_time_ms > 0) {
-        tokens_per_second = static_cast<double>(final_result.completion_tokens) /
-                            (static_cast<double>(final_result.total_time_ms) / 1000.0);
-        final_result.tokens_per_second = static_cast<float>(tokens_per_second);
-    }
+    final_result.time_to_first_token_ms = static_cast<int64_t>(ttft_ms);
+    final_result.tokens_per_second = static_cast<float>(tokens_per_second);
+    final_result.memory = memory;
+    rac_llm_get_stop_reason(service, &final_result.stop_reason);
 
     if (complete_callback) {
         complete_callback(&final_result, user_data);
@@ -697,24 +1045,198 @@ extern "C" rac_result_t rac_llm_component_generate_stream(
         event.data.llm_generation.max_tokens = effective_options->max_tokens;
         event.data.llm_generation.context_length = context_length;
         event.data.llm_generation.error_code = RAC_SUCCESS;
+        record_memory(memory, event.data.llm_generation);
         rac_analytics_event_emit(RAC_EVENT_LLM_GENERATION_COMPLETED, &event);
     }
 
-    // Free the duplicated text
-    free(final_result.text);
+    // Frees the text final_result borrowed
+    rac_streaming_result_free(&stream_result);
 
     log_info("LLM.Component", "Streaming generation completed");
 
     return RAC_SUCCESS;
 }
 
-extern "C" rac_result_t rac_llm_component_cancel(rac_handle_t handle) {
+extern "C" rac_result_t rac_llm_component_prefill(rac_handle_t handle, const char* prompt) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!prompt)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->mtx);
+
+    rac_handle_t service = nullptr;
+    rac_result_t result = rac_lifecycle_require_service(component->lifecycle, &service);
+    if (result != RAC_SUCCESS) {
+        log_error("LLM.Component", "No model loaded - cannot prefill");
+        return result;
+    }
+
+    // A one-token generation decodes the whole prompt; the cache keeps it
+    rac_llm_options_t options = component->default_options;
+    options.max_tokens = 1;
+
+    rac_llm_result_t llm_result = {};
+    result = rac_llm_generate(service, prompt, &options, &llm_result);
+    if (result == RAC_SUCCESS) {
+        log_debug("LLM.Component", "Prefilled %d prompt tokens", llm_result.prompt_tokens);
+        rac_llm_result_free(&llm_result);
+    }
+    return result;
+}
+
+// =============================================================================
+// CONVERSATION API
+// =============================================================================
+
+/** Tokens held back for the chat template around the rendered history */
+static constexpr int32_t kChatTemplateReserve = 64;
+
+/**
+ * Forwards the caller's callbacks and records the reply as an assistant turn.
+ */
+struct llm_chat_context {
+    rac_llm_context_handle_t conversation;
+    rac_llm_component_token_callback_fn token_callback;
+    rac_llm_component_complete_callback_fn complete_callback;
+    rac_llm_component_error_callback_fn error_callback;
+    void* user_data;
+};
+
+static rac_bool_t llm_chat_token_callback(const char* token, void* user_data) {
+    auto* chat = reinterpret_cast<llm_chat_context*>(user_data);
+    return chat->token_callback ? chat->token_callback(token, chat->user_data) : RAC_TRUE;
+}
+
+static void llm_chat_complete_callback(const rac_llm_result_t* result, void* user_data) {
+    auto* chat = reinterpret_cast<llm_chat_context*>(user_data);
+    if (result && result->text) {
+        rac_llm_context_add_turn(chat->conversation, "assistant", result->text,
+                                 result->completion_tokens);
+    }
+    if (chat->complete_callback) {
+        chat->complete_callback(result, chat->user_data);
+    }
+}
+
+static void llm_chat_error_callback(rac_result_t error_code, const char* error_message,
+                                    void* user_data) {
+    auto* chat = reinterpret_cast<llm_chat_context*>(user_data);
+    if (chat->error_callback) {
+        chat->error_callback(error_code, error_message, chat->user_data);
+    }
+}
+
+static rac_llm_context_handle_t ensure_conversation(rac_llm_component* component) {
+    if (!component->conversation) {
+        rac_llm_context_create(nullptr, &component->conversation);
+    }
+    return component->conversation;
+}
+
+extern "C" rac_result_t rac_llm_component_set_context_config(
+    rac_handle_t handle, const rac_llm_context_config_t* config) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->mtx);
+
+    rac_llm_context_handle_t conversation = ensure_conversation(component);
+    if (!conversation)
+        return RAC_ERROR_OUT_OF_MEMORY;
+
+    return rac_llm_context_set_config(conversation,
+                                      config ? config : &RAC_LLM_CONTEXT_CONFIG_DEFAULT);
+}
+
+extern "C" rac_result_t rac_llm_component_clear_conversation(rac_handle_t handle) {
     if (!handle)
         return RAC_ERROR_INVALID_HANDLE;
 
     auto* component = reinterpret_cast<rac_llm_component*>(handle);
     std::lock_guard<std::mutex> lock(component->mtx);
 
+    if (component->conversation) {
+        rac_llm_context_clear(component->conversation);
+    }
+    return RAC_SUCCESS;
+}
+
+extern "C" rac_result_t rac_llm_component_chat_stream(
+    rac_handle_t handle, const char* message, const rac_llm_options_t* options,
+    rac_llm_component_token_callback_fn token_callback,
+    rac_llm_component_complete_callback_fn complete_callback,
+    rac_llm_component_error_callback_fn error_callback, void* user_data) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!message)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    llm_chat_context chat = {nullptr, token_callback, complete_callback, error_callback,
+                             user_data};
+    char* prompt = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(component->mtx);
+
+        rac_handle_t service = nullptr;
+        rac_result_t result = rac_lifecycle_require_service(component->lifecycle, &service);
+        if (result != RAC_SUCCESS) {
+            log_error("LLM.Component", "No model loaded - cannot chat");
+            if (error_callback) {
+                error_callback(result, "No model loaded", user_data);
+            }
+            return result;
+        }
+
+        chat.conversation = ensure_conversation(component);
+        if (!chat.conversation)
+            return RAC_ERROR_OUT_OF_MEMORY;
+
+        rac_llm_context_add_turn(chat.conversation, "user", message,
+                                 count_tokens(service, message));
+
+        // Budget: explicit, or whatever the context leaves after the reply
+        rac_llm_context_config_t context_config = RAC_LLM_CONTEXT_CONFIG_DEFAULT;
+        rac_llm_context_get_config(chat.conversation, &context_config);
+        int32_t budget = context_config.budget_tokens;
+        if (budget <= 0) {
+            rac_llm_info_t info = {};
+            int32_t context_length = component->config.context_length;
+            if (rac_llm_get_info(service, &info) == RAC_SUCCESS && info.context_length > 0) {
+                context_length = info.context_length;
+            }
+            const int32_t max_tokens =
+                options ? options->max_tokens : component->default_options.max_tokens;
+            budget = context_length - max_tokens - kChatTemplateReserve;
+        }
+        if (budget > 0) {
+            rac_llm_context_fit(chat.conversation, service, budget);
+        }
+
+        result = rac_llm_context_build_prompt(chat.conversation, &prompt);
+        if (result != RAC_SUCCESS) {
+            return result;
+        }
+    }
+
+    rac_result_t result = rac_llm_component_generate_stream(
+        handle, prompt, options, llm_chat_token_callback, llm_chat_complete_callback,
+        llm_chat_error_callback, &chat);
+    rac_free(prompt);
+    return result;
+}
+
+extern "C" rac_result_t rac_llm_component_cancel(rac_handle_t handle) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    // No component lock: an in-flight generation holds it until it finishes,
+    // and cancel must be able to interrupt it (backends only set a flag)
     rac_handle_t service = rac_lifecycle_get_service(component->lifecycle);
     if (service) {
         rac_llm_cancel(service);
@@ -747,3 +1269,225 @@ extern "C" rac_result_t rac_llm_component_get_metrics(rac_handle_t handle,
     auto* component = reinterpret_cast<rac_llm_component*>(handle);
     return rac_lifecycle_get_metrics(component->lifecycle, out_metrics);
 }
+
+extern "C" rac_result_t rac_llm_component_get_memory_usage(rac_handle_t handle,
+                                                           rac_llm_memory_usage_t* out_usage) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!out_usage)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    *out_usage = {};
+
+    // Like cancel, this must not wait for an in-flight generation; the
+    // backend takes its own locks.
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    rac_handle_t service = rac_lifecycle_get_service(component->lifecycle);
+    if (!service) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    return rac_llm_get_memory_usage(service, out_usage);
+}
+
+extern "C" rac_result_t rac_llm_component_count_tokens(rac_handle_t handle, const char* text,
+                                                       int32_t* out_count) {
+    return rac_llm_component_count_tokens_batch(handle, &text, 1, out_count, nullptr);
+}
+
+extern "C" rac_result_t rac_llm_component_count_tokens_batch(rac_handle_t handle,
+                                                             const char* const* texts,
+                                                             size_t count, int32_t* out_counts,
+                                                             int64_t* out_total) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!texts || (count > 0 && !out_counts))
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    // Like get_memory_usage, this must not wait for an in-flight generation;
+    // the backend tokenizer takes its own lock
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    rac_handle_t service = rac_lifecycle_get_service(component->lifecycle);
+    if (!service) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    int64_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        out_counts[i] = texts[i] ? cached_count_tokens(component, service, texts[i]) : 0;
+        total += out_counts[i];
+    }
+    if (out_total) {
+        *out_total = total;
+    }
+    return RAC_SUCCESS;
+}
+
+extern "C" rac_result_t rac_llm_component_get_context_size(rac_handle_t handle,
+                                                           int32_t* out_context_size) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!out_context_size)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    rac_handle_t service = rac_lifecycle_get_service(component->lifecycle);
+    if (!service) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    rac_llm_info_t info = {};
+    if (rac_llm_get_info(service, &info) == RAC_SUCCESS && info.context_length > 0) {
+        *out_context_size = info.context_length;
+    } else {
+        *out_context_size = component->config.context_length;
+    }
+    return RAC_SUCCESS;
+}
+
+extern "C" rac_result_t rac_llm_component_save_state(rac_handle_t handle, const char* path,
+                                                     int32_t* out_token_count) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!path)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    // The backend refuses while a generation runs instead of waiting for it
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    rac_handle_t service = rac_lifecycle_get_service(component->lifecycle);
+    if (!service) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    return rac_llm_save_state(service, path, out_token_count);
+}
+
+extern "C" rac_result_t rac_llm_component_restore_state(rac_handle_t handle, const char* path,
+                                                        int32_t* out_token_count) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!path)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    rac_handle_t service = rac_lifecycle_get_service(component->lifecycle);
+    if (!service) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    return rac_llm_restore_state(service, path, out_token_count);
+}
+
+extern "C" rac_result_t rac_llm_component_load_lora(rac_handle_t handle, const char* name,
+                                                    const char* path) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!name || name[0] == '\0' || !path)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->lora_mtx);
+    for (const auto& adapter : component->lora_adapters) {
+        if (adapter.first == name) {
+            return adapter.second == path ? RAC_SUCCESS : RAC_ERROR_INVALID_ARGUMENT;
+        }
+    }
+    // Without a model the adapter is loaded with the next one
+    rac_handle_t service = rac_lifecycle_get_service(component->lifecycle);
+    if (service) {
+        const rac_result_t result = rac_llm_load_lora(service, name, path);
+        if (result != RAC_SUCCESS) {
+            return result;
+        }
+    }
+    component->lora_adapters.emplace_back(name, path);
+    return RAC_SUCCESS;
+}
+
+extern "C" rac_result_t rac_llm_component_remove_lora(rac_handle_t handle, const char* name) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!name)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->lora_mtx);
+    auto& adapters = component->lora_adapters;
+    auto it = std::find_if(adapters.begin(), adapters.end(),
+                           [&](const auto& adapter) { return adapter.first == name; });
+    if (it == adapters.end()) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+    rac_handle_t service = rac_lifecycle_get_service(component->lifecycle);
+    if (service) {
+        const rac_result_t result = rac_llm_remove_lora(service, name);
+        if (result != RAC_SUCCESS && result != RAC_ERROR_NOT_FOUND) {
+            return result;
+        }
+    }
+    if (component->lora_selected == name) {
+        component->lora_selected.clear();
+    }
+    adapters.erase(it);
+    return RAC_SUCCESS;
+}
+
+extern "C" rac_result_t rac_llm_component_set_lora(rac_handle_t handle, const char* name,
+                                                   float scale) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    const std::string selected = name ? name : "";
+    std::lock_guard<std::mutex> lock(component->lora_mtx);
+    if (!selected.empty() &&
+        std::none_of(component->lora_adapters.begin(), component->lora_adapters.end(),
+                     [&](const auto& adapter) { return adapter.first == selected; })) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+    rac_handle_t service = rac_lifecycle_get_service(component->lifecycle);
+    if (service) {
+        const rac_result_t result = rac_llm_set_lora(service, selected.c_str(), scale);
+        if (result != RAC_SUCCESS) {
+            return result;
+        }
+    }
+    component->lora_selected = selected;
+    component->lora_scale = scale;
+    return RAC_SUCCESS;
+}
+
+extern "C" rac_result_t rac_llm_component_handle_memory_pressure(rac_handle_t handle,
+                                                                 rac_llm_memory_pressure_t level) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_llm_component*>(handle);
+    if (level == RAC_LLM_MEMORY_PRESSURE_NONE) {
+        return RAC_SUCCESS;
+    }
+
+    // Parked models are the cheapest memory to give back
+    const int64_t released = rac_model_residency_trim();
+    if (released > 0) {
+        RAC_LOG_INFO("LLM.Component", "Released %lld bytes of parked models under pressure",
+                     static_cast<long long>(released));
+    }
+
+    rac_handle_t service = rac_lifecycle_get_service(component->lifecycle);
+    if (!service) {
+        return RAC_SUCCESS;
+    }
+
+    if (level < RAC_LLM_MEMORY_PRESSURE_CRITICAL) {
+        log_info("LLM.Component", "Trimming LLM memory under pressure");
+        return rac_llm_trim_memory(service, level);
+    }
+
+    // Cancel first so the unload does not wait for a full generation
+    log_info("LLM.Component", "Unloading LLM under critical memory pressure");
+    rac_llm_cancel(service);
+
+    std::lock_guard<std::mutex> lock(component->mtx);
+    return rac_lifecycle_unload(component->lifecycle);
+}
@@ -0,0 +1,461 @@
+/**
+ * @file llm_remote.cpp
+ * @brief RunAnywhere Commons - Remote LLM Service
+ *
+ * Builds an OpenAI-compatible chat completions request per generation and
+ * waits for the platform HTTP executor to deliver the response. Only the
+ * few response fields the result needs are parsed: the first choice's
+ * message content and the usage token counts.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_logger.h"
+#include "rac/features/llm/rac_llm_remote.h"
+#include "rac/features/llm/rac_llm_service.h"
+#include "rac/infrastructure/network/rac_http_client.h"
+
+static const char* LOG_CAT = "LLM.Remote";
+
+namespace {
+
+constexpr int32_t kDefaultTimeoutMs = 60000;
+
+struct RemoteLLM {
+    std::string endpoint_url;
+    std::string api_key;
+    std::string model;
+    int32_t timeout_ms;
+    // Set by cancel; the HTTP request cannot be aborted, so its reply is dropped
+    std::atomic<bool> cancelled{false};
+};
+
+// =============================================================================
+// JSON
+// =============================================================================
+
+void append_json_string(std::string& out, const char* value) {
+    out += '"';
+    for (const char* p = value; *p; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+    out += '"';
+}
+
+void append_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+bool parse_hex4(const char* p, uint32_t* out) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        const char c = p[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value |= static_cast<uint32_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            value |= static_cast<uint32_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            value |= static_cast<uint32_t>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+    }
+    *out = value;
+    return true;
+}
+
+// Position just past `"key":` at or after from, or npos
+size_t find_value(const std::string& json, const char* key, size_t from) {
+    const std::string quoted = std::string("\"") + key + "\"";
+    size_t pos = json.find(quoted, from);
+    if (pos == std::string::npos) {
+        return pos;
+    }
+    pos += quoted.size();
+    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\n' || json[pos] == '\t' ||
+                                 json[pos] == '\r' || json[pos] == ':')) {
+        ++pos;
+    }
+    return pos < json.size() ? pos : std::string::npos;
+}
+
+// Decodes the JSON string starting at pos (the opening quote)
+bool parse_string_at(const std::string& json, size_t pos, std::string* out) {
+    if (pos == std::string::npos || json[pos] != '"') {
+        return false;
+    }
+    out->clear();
+    for (size_t i = pos + 1; i < json.size(); ++i) {
+        const char c = json[i];
+        if (c == '"') {
+            return true;
+        }
+        if (c != '\\') {
+            *out += c;
+            continue;
+        }
+        if (++i >= json.size()) {
+            return false;
+        }
+        switch (json[i]) {
+            case 'n':
+                *out += '\n';
+                break;
+            case 't':
+                *out += '\t';
+                break;
+            case 'r':
+                *out += '\r';
+                break;
+            case 'b':
+                *out += '\b';
+                break;
+            case 'f':
+                *out += '\f';
+                break;
+            case 'u': {
+                uint32_t cp = 0;
+                if (i + 4 >= json.size() || !parse_hex4(json.c_str() + i + 1, &cp)) {
+                    return false;
+                }
+                i += 4;
+                // Surrogate pair for characters outside the BMP
+                uint32_t low = 0;
+                if (cp >= 0xD800 && cp < 0xDC00 && i + 6 < json.size() && json[i + 1] == '\\' &&
+                    json[i + 2] == 'u' && parse_hex4(json.c_str() + i + 3, &low) &&
+                    low >= 0xDC00 && low < 0xE000) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                append_utf8(*out, cp);
+                break;
+            }
+            default:
+                *out += json[i];
+        }
+    }
+    return false;
+}
+
+int32_t parse_int_field(const std::string& json, const char* key, size_t from) {
+    const size_t pos = find_value(json, key, from);
+    return pos == std::string::npos ? 0 : static_cast<int32_t>(atoi(json.c_str() + pos));
+}
+
+std::string build_request_body(const RemoteLLM& remote, const char* prompt,
+                               const rac_llm_options_t& options) {
+    std::string body = "{\"model\":";
+    append_json_string(body, remote.model.c_str());
+    body += ",\"messages\":[";
+    if (options.system_prompt && options.system_prompt[0] != '\0') {
+        body += "{\"role\":\"system\",\"content\":";
+        append_json_string(body, options.system_prompt);
+        body += "},";
+    }
+    body += "{\"role\":\"user\",\"content\":";
+    append_json_string(body, prompt);
+    body += "}]";
+
+    char numbers[128];
+    snprintf(numbers, sizeof(numbers), ",\"max_tokens\":%d,\"temperature\":%.3f,\"top_p\":%.3f",
+             options.max_tokens, options.temperature, options.top_p);
+    body += numbers;
+
+    if (options.stop_sequences && options.num_stop_sequences > 0) {
+        body += ",\"stop\":[";
+        for (size_t i = 0; i < options.num_stop_sequences; ++i) {
+            if (i > 0) {
+                body += ',';
+            }
+            append_json_string(body, options.stop_sequences[i] ? options.stop_sequences[i] : "");
+        }
+        body += ']';
+    }
+    if (options.json_schema && options.json_schema[0] != '\0') {
+        // The schema is already JSON, so it is embedded as is
+        body += ",\"response_format\":{\"type\":\"json_schema\",\"json_schema\":"
+                "{\"name\":\"output\",\"schema\":";
+        body += options.json_schema;
+        body += "}}";
+    }
+    body += ",\"stream\":false}";
+    return body;
+}
+
+// =============================================================================
+// HTTP
+// =============================================================================
+
+struct PendingRequest {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    int32_t status_code = 0;
+    std::string body;
+    std::string error;
+};
+
+void on_http_response(const rac_http_response_t* response, void* user_data) {
+    auto* pending = static_cast<PendingRequest*>(user_data);
+    std::lock_guard<std::mutex> lock(pending->mutex);
+    if (response) {
+        pending->status_code = response->status_code;
+        if (response->body) {
+            pending->body.assign(response->body, response->body_length);
+        }
+        if (response->error_message) {
+            pending->error = response->error_message;
+        }
+    }
+    pending->done = true;
+    pending->cv.notify_one();
+}
+
+rac_result_t post_completion(const RemoteLLM& remote, const std::string& body,
+                             PendingRequest* pending) {
+    rac_http_request_t* request =
+        rac_http_request_create(RAC_HTTP_POST, remote.endpoint_url.c_str());
+    if (!request) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    rac_http_request_set_body(request, body.c_str());
+    rac_http_request_add_header(request, "Content-Type", "application/json");
+    if (!remote.api_key.empty()) {
+        rac_http_add_auth_header(request, remote.api_key.c_str());
+    }
+    rac_http_request_set_timeout(request, remote.timeout_ms);
+
+    const bool started = rac_http_execute_raw(request, on_http_response, pending);
+    if (started) {
+        std::unique_lock<std::mutex> lock(pending->mutex);
+        pending->cv.wait(lock, [&] { return pending->done; });
+    }
+    rac_http_request_free(request);
+    return started ? RAC_SUCCESS : RAC_ERROR_HTTP_NOT_SUPPORTED;
+}
+
+// =============================================================================
+// VTABLE
+// =============================================================================
+
+rac_result_t remote_initialize(void* impl, const char* model_path) {
+    (void)impl;
+    (void)model_path;
+    return RAC_SUCCESS;
+}
+
+rac_result_t remote_generate(void* impl, const char* prompt, const rac_llm_options_t* options,
+                             rac_llm_result_t* out_result) {
+    if (!impl || !prompt || !out_result) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    auto* remote = static_cast<RemoteLLM*>(impl);
+    remote->cancelled = false;
+
+    const rac_llm_options_t& opts = options ? *options : RAC_LLM_OPTIONS_DEFAULT;
+    const std::string body = build_request_body(*remote, prompt, opts);
+
+    const auto start = std::chrono::steady_clock::now();
+    PendingRequest pending;
+    rac_result_t result = post_completion(*remote, body, &pending);
+    const int64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+    if (remote->cancelled) {
+        return RAC_ERROR_CANCELLED;
+    }
+    if (pending.status_code == 0) {
+        RAC_LOG_ERROR(LOG_CAT, "Request failed: %s",
+                      pending.error.empty() ? "no response" : pending.error.c_str());
+        return RAC_ERROR_NETWORK_ERROR;
+    }
+    if (pending.status_code < 200 || pending.status_code >= 300) {
+        RAC_LOG_ERROR(LOG_CAT, "Endpoint returned HTTP %d: %.200s", pending.status_code,
+                      pending.body.c_str());
+        return RAC_ERROR_HTTP_ERROR;
+    }
+
+    std::string text;
+    const size_t choices = pending.body.find("\"choices\"");
+    if (choices == std::string::npos ||
+        !parse_string_at(pending.body, find_value(pending.body, "content", choices), &text)) {
+        RAC_LOG_ERROR(LOG_CAT, "Response has no message content");
+        return RAC_ERROR_INVALID_RESPONSE;
+    }
+
+    const size_t usage = pending.body.find("\"usage\"");
+    out_result->text = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, text.c_str());
+    if (!out_result->text) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    if (usage != std::string::npos) {
+        out_result->prompt_tokens = parse_int_field(pending.body, "prompt_tokens", usage);
+        out_result->completion_tokens = parse_int_field(pending.body, "completion_tokens", usage);
+    }
+    out_result->total_tokens = out_result->prompt_tokens + out_result->completion_tokens;
+    // The whole reply arrives at once, so the first token comes with the last
+    out_result->time_to_first_token_ms = elapsed_ms;
+    out_result->total_time_ms = elapsed_ms;
+    out_result->tokens_per_second =
+        elapsed_ms > 0 ? out_result->completion_tokens * 1000.0f / elapsed_ms : 0.0f;
+    return RAC_SUCCESS;
+}
+
+rac_result_t remote_generate_stream(void* impl, const char* prompt,
+                                    const rac_llm_options_t* options,
+                                    rac_llm_stream_callback_fn callback, void* user_data) {
+    if (!callback) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    rac_llm_result_t result = {};
+    const rac_result_t status = remote_generate(impl, prompt, options, &result);
+    if (status == RAC_SUCCESS && result.text && result.text[0] != '\0') {
+        callback(result.text, user_data);
+    }
+    rac_llm_result_free(&result);
+    return status;
+}
+
+rac_result_t remote_get_info(void* impl, rac_llm_info_t* out_info) {
+    if (!impl || !out_info) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    auto* remote = static_cast<RemoteLLM*>(impl);
+    out_info->is_ready = rac_http_has_executor() ? RAC_TRUE : RAC_FALSE;
+    out_info->current_model = remote->model.c_str();
+    out_info->context_length = 0;
+    out_info->supports_streaming = RAC_TRUE;
+    return RAC_SUCCESS;
+}
+
+rac_result_t remote_cancel(void* impl) {
+    if (!impl) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    static_cast<RemoteLLM*>(impl)->cancelled = true;
+    return RAC_SUCCESS;
+}
+
+rac_result_t remote_cleanup(void* impl) {
+    (void)impl;
+    return RAC_SUCCESS;
+}
+
+void remote_destroy(void* impl) {
+    delete static_cast<RemoteLLM*>(impl);
+}
+
+// Positional: designated initializers are C++20
+const rac_llm_service_ops_t g_remote_ops = {
+    remote_initialize,
+    remote_generate,
+    remote_generate_stream,
+    remote_get_info,
+    remote_cancel,
+    remote_cleanup,
+    remote_destroy,
+    nullptr,  // get_memory_usage
+    nullptr,  // trim_memory
+    nullptr,  // count_tokens
+    nullptr,  // generate_batch
+    nullptr,  // save_state
+    nullptr,  // restore_state
+    nullptr,  // load_lora
+    nullptr,  // remove_lora
+    nullptr,  // set_lora
+    nullptr,  // generate_samples
+    nullptr,  // get_stop_reason
+};
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_llm_remote_create(const rac_llm_remote_config_t* config,
+                                   rac_handle_t* out_handle) {
+    if (!config || !out_handle) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    *out_handle = nullptr;
+    if (!config->endpoint_url || config->endpoint_url[0] == '\0' || !config->model ||
+        config->model[0] == '\0') {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto* remote = new RemoteLLM();
+    remote->endpoint_url = config->endpoint_url;
+    remote->api_key = config->api_key ? config->api_key : "";
+    remote->model = config->model;
+    remote->timeout_ms = config->timeout_ms > 0 ? config->timeout_ms : kDefaultTimeoutMs;
+
+    auto* service = static_cast<rac_llm_service_t*>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, sizeof(rac_llm_service_t)));
+    if (!service) {
+        delete remote;
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    service->ops = &g_remote_ops;
+    service->impl = remote;
+    service->model_id = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, config->model);
+
+    RAC_LOG_INFO(LOG_CAT, "Remote LLM service created for %s", config->model);
+    *out_handle = service;
+    return RAC_SUCCESS;
+}
+
+}  // extern "C"
@@ -0,0 +1,458 @@
+/**
+ * @file llm_router.cpp
+ * @brief RunAnywhere Commons - Latency-Aware LLM Routing
+ *
+ * Each request plans an ordered list of candidate routes under the router
+ * lock, then runs them without it, one after another until one succeeds.
+ * Measurements are exponential moving averages of what each finished
+ * request observed; a route whose service was replaced meanwhile discards
+ * the sample.
+ *
+ * Prediction for a route with measurements:
+ *   single = ttft + max_tokens / tokens_per_second
+ *   wait   = in_flight * single   (on-device routes run one at a time)
+ *   ttft'  = wait + ttft,  total' = wait + single
+ * A route without measurements is assumed to meet the targets, so a new
+ * route is tried and measured once before the others are preferred over it.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "rac/core/rac_logger.h"
+#include "rac/features/llm/rac_llm_router.h"
+#include "rac/features/llm/rac_llm_service.h"
+
+static const char* LOG_CAT = "LLM.Router";
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr float kSmoothing = 0.3f;
+constexpr int32_t kCooldownFailures = 3;
+constexpr std::chrono::seconds kCooldown(30);
+// Chunks longer than this (platform and remote deliver whole replies) are
+// counted at this many bytes per token
+constexpr size_t kBytesPerToken = 4;
+constexpr size_t kMaxSingleTokenBytes = 16;
+
+struct RouteState {
+    rac_handle_t service = nullptr;
+    // Bumped when the service changes, so late samples are ignored
+    uint64_t generation = 0;
+    float tokens_per_second = 0.0f;
+    float ttft_ms = 0.0f;
+    int32_t in_flight = 0;
+    int64_t successes = 0;
+    int64_t failures = 0;
+    int32_t consecutive_failures = 0;
+    Clock::time_point cooldown_until;
+};
+
+struct Candidate {
+    rac_llm_route_t route;
+    rac_handle_t service;
+    uint64_t generation;
+    int tier;  // 0 = preferred, 1 = only if nothing else is usable
+    bool meets_targets;
+    int64_t predicted_ms;  // -1 if unmeasured
+};
+
+// One finished attempt
+struct Sample {
+    rac_result_t status;
+    int64_t wall_ms;
+    int64_t ttft_ms;  // 0 if unknown
+    int64_t tokens;
+};
+
+bool is_on_device(rac_llm_route_t route) {
+    return route != RAC_LLM_ROUTE_REMOTE;
+}
+
+// Errors caused by the request itself, which another route would repeat
+bool should_fall_back(rac_result_t status) {
+    return status != RAC_ERROR_CANCELLED && status != RAC_ERROR_STREAM_CANCELLED &&
+           status != RAC_ERROR_INVALID_ARGUMENT && status != RAC_ERROR_NULL_POINTER;
+}
+
+float smooth(float current, float sample) {
+    return current > 0.0f ? current + kSmoothing * (sample - current) : sample;
+}
+
+int64_t elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+struct rac_llm_router {
+    std::mutex mutex;
+    rac_llm_router_config_t config;
+    rac_llm_router_device_state_t device;
+    RouteState routes[RAC_LLM_ROUTE_COUNT];
+    // Bumped by cancel, so requests in progress stop falling back
+    uint64_t cancel_epoch = 0;
+};
+
+namespace {
+
+bool valid_route(rac_llm_route_t route) {
+    return static_cast<int>(route) >= 0 && static_cast<int>(route) < RAC_LLM_ROUTE_COUNT;
+}
+
+// Candidates in the order they should be tried; called with the lock held
+std::vector<Candidate> plan(rac_llm_router* router, int32_t max_tokens) {
+    const rac_llm_router_config_t& config = router->config;
+    const rac_llm_router_device_state_t& device = router->device;
+    const Clock::time_point now = Clock::now();
+
+    const bool device_constrained =
+        device.thermal_state > config.max_on_device_thermal ||
+        (config.min_on_device_battery > 0.0f && device.battery_level >= 0.0f &&
+         device.battery_level < config.min_on_device_battery && !device.is_charging);
+
+    std::vector<Candidate> candidates;
+    for (int i = 0; i < RAC_LLM_ROUTE_COUNT; ++i) {
+        const auto route = static_cast<rac_llm_route_t>(i);
+        const RouteState& state = router->routes[i];
+        if (!state.service) {
+            continue;
+        }
+        if (route == RAC_LLM_ROUTE_REMOTE &&
+            (!config.remote_enabled || !device.network_available)) {
+            continue;
+        }
+
+        Candidate candidate = {route, state.service, state.generation, 0, true, -1};
+        if ((is_on_device(route) && device_constrained) ||
+            (state.consecutive_failures >= kCooldownFailures && now < state.cooldown_until)) {
+            candidate.tier = 1;
+        }
+
+        if (state.tokens_per_second > 0.0f) {
+            const double single = state.ttft_ms + max_tokens * 1000.0 / state.tokens_per_second;
+            const double wait = is_on_device(route) ? state.in_flight * single : 0.0;
+            const double ttft = wait + state.ttft_ms;
+            const double total = wait + single;
+            candidate.predicted_ms = static_cast<int64_t>(total);
+            candidate.meets_targets = (config.target_total_ms <= 0 ||
+                                       total <= config.target_total_ms) &&
+                                      (config.target_ttft_ms <= 0 || ttft <= config.target_ttft_ms);
+        }
+        candidates.push_back(candidate);
+    }
+
+    // Tier first; within a tier, routes meeting the targets in preference
+    // order, then the rest fastest first
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate& a, const Candidate& b) {
+                         if (a.tier != b.tier) {
+                             return a.tier < b.tier;
+                         }
+                         if (a.meets_targets != b.meets_targets) {
+                             return a.meets_targets;
+                         }
+                         if (a.meets_targets) {
+                             return a.route < b.route;
+                         }
+                         return a.predicted_ms < b.predicted_ms;
+                     });
+
+    if (!config.fallback_enabled && candidates.size() > 1) {
+        candidates.erase(candidates.begin() + 1, candidates.end());
+    }
+    return candidates;
+}
+
+void begin_attempt(rac_llm_router* router, const Candidate& candidate) {
+    std::lock_guard<std::mutex> lock(router->mutex);
+    RouteState& state = router->routes[candidate.route];
+    if (state.generation == candidate.generation) {
+        ++state.in_flight;
+    }
+}
+
+void finish_attempt(rac_llm_router* router, const Candidate& candidate, const Sample& sample) {
+    std::lock_guard<std::mutex> lock(router->mutex);
+    RouteState& state = router->routes[candidate.route];
+    if (state.generation != candidate.generation) {
+        return;
+    }
+    --state.in_flight;
+
+    if (sample.status == RAC_SUCCESS) {
+        ++state.successes;
+        state.consecutive_failures = 0;
+        if (sample.ttft_ms > 0) {
+            state.ttft_ms = smooth(state.ttft_ms, static_cast<float>(sample.ttft_ms));
+        }
+        const int64_t decode_ms = sample.ttft_ms > 0 && sample.ttft_ms < sample.wall_ms
+                                      ? sample.wall_ms - sample.ttft_ms
+                                      : sample.wall_ms;
+        if (sample.tokens > 0 && decode_ms > 0) {
+            state.tokens_per_second =
+                smooth(state.tokens_per_second, sample.tokens * 1000.0f / decode_ms);
+        }
+    } else if (should_fall_back(sample.status)) {
+        ++state.failures;
+        if (++state.consecutive_failures >= kCooldownFailures) {
+            state.cooldown_until = Clock::now() + kCooldown;
+        }
+    }
+}
+
+bool cancelled_since(rac_llm_router* router, uint64_t epoch) {
+    std::lock_guard<std::mutex> lock(router->mutex);
+    return router->cancel_epoch != epoch;
+}
+
+int64_t estimate_tokens(const char* text) {
+    const size_t length = text ? strlen(text) : 0;
+    return static_cast<int64_t>((length + kBytesPerToken - 1) / kBytesPerToken);
+}
+
+// Wraps the caller's stream callback to time the first token and count tokens
+struct StreamProbe {
+    rac_llm_stream_callback_fn callback;
+    void* user_data;
+    Clock::time_point start;
+    int64_t ttft_ms = 0;
+    int64_t tokens = 0;
+    bool started = false;
+};
+
+rac_bool_t probe_token(const char* token, void* user_data) {
+    auto* probe = static_cast<StreamProbe*>(user_data);
+    if (!probe->started) {
+        probe->started = true;
+        probe->ttft_ms = std::max<int64_t>(elapsed_ms(probe->start), 1);
+    }
+    const size_t length = token ? strlen(token) : 0;
+    probe->tokens += length > kMaxSingleTokenBytes ? estimate_tokens(token) : 1;
+    return probe->callback(token, probe->user_data);
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_llm_router_create(const rac_llm_router_config_t* config,
+                                   rac_llm_router_handle_t* out_handle) {
+    if (!out_handle) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    auto* router = new rac_llm_router();
+    router->config = config ? *config : RAC_LLM_ROUTER_CONFIG_DEFAULT;
+    router->device = RAC_LLM_ROUTER_DEVICE_STATE_DEFAULT;
+    *out_handle = router;
+    return RAC_SUCCESS;
+}
+
+void rac_llm_router_destroy(rac_llm_router_handle_t handle) {
+    delete handle;
+}
+
+rac_result_t rac_llm_router_configure(rac_llm_router_handle_t handle,
+                                      const rac_llm_router_config_t* config) {
+    if (!handle || !config) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    handle->config = *config;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_router_set_route(rac_llm_router_handle_t handle, rac_llm_route_t route,
+                                      rac_handle_t service) {
+    if (!handle) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    if (!valid_route(route)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    RouteState& state = handle->routes[route];
+    if (state.service == service) {
+        return RAC_SUCCESS;
+    }
+    const uint64_t generation = state.generation + 1;
+    state = RouteState();
+    state.service = service;
+    state.generation = generation;
+    RAC_LOG_INFO(LOG_CAT, "Route %s %s", rac_llm_route_name(route), service ? "set" : "removed");
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_router_set_device_state(rac_llm_router_handle_t handle,
+                                             const rac_llm_router_device_state_t* state) {
+    if (!handle || !state) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    handle->device = *state;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_router_select(rac_llm_router_handle_t handle,
+                                   const rac_llm_options_t* options, rac_llm_route_t* out_route,
+                                   int64_t* out_predicted_ms) {
+    if (!handle || !out_route) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    const int32_t max_tokens = (options ? *options : RAC_LLM_OPTIONS_DEFAULT).max_tokens;
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    const std::vector<Candidate> candidates = plan(handle, max_tokens);
+    if (candidates.empty()) {
+        return RAC_ERROR_SERVICE_NOT_AVAILABLE;
+    }
+    *out_route = candidates.front().route;
+    if (out_predicted_ms) {
+        *out_predicted_ms = candidates.front().predicted_ms;
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_router_generate(rac_llm_router_handle_t handle, const char* prompt,
+                                     const rac_llm_options_t* options,
+                                     rac_llm_result_t* out_result, rac_llm_route_t* out_route) {
+    if (!handle || !prompt || !out_result) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    const int32_t max_tokens = (options ? *options : RAC_LLM_OPTIONS_DEFAULT).max_tokens;
+    std::vector<Candidate> candidates;
+    uint64_t epoch;
+    {
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        candidates = plan(handle, max_tokens);
+        epoch = handle->cancel_epoch;
+    }
+
+    rac_result_t status = RAC_ERROR_SERVICE_NOT_AVAILABLE;
+    for (const Candidate& candidate : candidates) {
+        rac_llm_result_t result = {};
+        begin_attempt(handle, candidate);
+        const Clock::time_point start = Clock::now();
+        status = rac_llm_generate(candidate.service, prompt, options, &result);
+
+        Sample sample = {status, elapsed_ms(start), 0, 0};
+        if (status == RAC_SUCCESS) {
+            sample.ttft_ms = result.time_to_first_token_ms;
+            sample.tokens = result.completion_tokens > 0 ? result.completion_tokens
+                                                         : estimate_tokens(result.text);
+        }
+        finish_attempt(handle, candidate, sample);
+
+        if (status == RAC_SUCCESS) {
+            *out_result = result;
+            if (out_route) {
+                *out_route = candidate.route;
+            }
+            return RAC_SUCCESS;
+        }
+        rac_llm_result_free(&result);
+        if (!should_fall_back(status) || cancelled_since(handle, epoch)) {
+            return status;
+        }
+        RAC_LOG_WARNING(LOG_CAT, "Route %s failed (%d), falling back",
+                        rac_llm_route_name(candidate.route), status);
+    }
+    return status;
+}
+
+rac_result_t rac_llm_router_generate_stream(rac_llm_router_handle_t handle, const char* prompt,
+                                            const rac_llm_options_t* options,
+                                            rac_llm_stream_callback_fn callback, void* user_data,
+                                            rac_llm_route_t* out_route) {
+    if (!handle || !prompt || !callback) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    const int32_t max_tokens = (options ? *options : RAC_LLM_OPTIONS_DEFAULT).max_tokens;
+    std::vector<Candidate> candidates;
+    uint64_t epoch;
+    {
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        candidates = plan(handle, max_tokens);
+        epoch = handle->cancel_epoch;
+    }
+
+    rac_result_t status = RAC_ERROR_SERVICE_NOT_AVAILABLE;
+    for (const Candidate& candidate : candidates) {
+        StreamProbe probe = {callback, user_data, Clock::now()};
+        begin_attempt(handle, candidate);
+        status = rac_llm_generate_stream(candidate.service, prompt, options, probe_token, &probe);
+        finish_attempt(handle, candidate,
+                       Sample{status, elapsed_ms(probe.start), probe.ttft_ms, probe.tokens});
+
+        // Tokens already reached the caller, so another route cannot take over
+        if (status == RAC_SUCCESS || probe.started) {
+            if (out_route) {
+                *out_route = candidate.route;
+            }
+            return status;
+        }
+        if (!should_fall_back(status) || cancelled_since(handle, epoch)) {
+            return status;
+        }
+        RAC_LOG_WARNING(LOG_CAT, "Route %s failed before streaming (%d), falling back",
+                        rac_llm_route_name(candidate.route), status);
+    }
+    return status;
+}
+
+rac_result_t rac_llm_router_cancel(rac_llm_router_handle_t handle) {
+    if (!handle) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    ++handle->cancel_epoch;
+    for (const RouteState& state : handle->routes) {
+        if (state.service && state.in_flight > 0) {
+            rac_llm_cancel(state.service);
+        }
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_router_get_stats(rac_llm_router_handle_t handle, rac_llm_route_t route,
+                                      rac_llm_route_stats_t* out_stats) {
+    if (!handle || !out_stats) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    if (!valid_route(route)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    const RouteState& state = handle->routes[route];
+    out_stats->available = state.service ? RAC_TRUE : RAC_FALSE;
+    out_stats->tokens_per_second = state.tokens_per_second;
+    out_stats->ttft_ms = state.ttft_ms;
+    out_stats->in_flight = state.in_flight;
+    out_stats->successes = state.successes;
+    out_stats->failures = state.failures;
+    out_stats->consecutive_failures = state.consecutive_failures;
+    return RAC_SUCCESS;
+}
+
+const char* rac_llm_route_name(rac_llm_route_t route) {
+    switch (route) {
+        case RAC_LLM_ROUTE_LOCAL:
+            return "local";
+        case RAC_LLM_ROUTE_PLATFORM:
+            return "platform";
+        case RAC_LLM_ROUTE_REMOTE:
+            return "remote";
+        default:
+            return "unknown";
+    }
+}
+
+}  // extern "C"
@@ -26,6 +26,11 @@ static const char* LOG_CAT = "LLM.Service";
 extern "C" {
 
 rac_result_t rac_llm_create(const char* model_id, rac_handle_t* out_handle) {
+    return rac_llm_create_with_config(model_id, nullptr, out_handle);
+}
+
+rac_result_t rac_llm_create_with_config(const char* model_id, const char* config_json,
+                                        rac_handle_t* out_handle) {
     if (!model_id || !out_handle) {
         return RAC_ERROR_NULL_POINTER;
     }
@@ -55,6 +60,7 @@ rac_result_t rac_llm_create(const char* model_id, rac_handle_t* out_handle) {
     // Build service request
     rac_service_request_t request = {};
     request.identifier = model_id;
+    request.config_json = config_json;
     request.capability = RAC_CAPABILITY_TEXT_GENERATION;
     request.framework = framework;
     request.model_path = model_path;
@@ -122,6 +128,77 @@ rac_result_t rac_llm_generate_stream(rac_handle_t handle, const char* prompt,
     return service->ops->generate_stream(service->impl, prompt, options, callback, user_data);
 }
 
+rac_result_t rac_llm_generate_batch(rac_handle_t handle, const char* const* prompts,
+                                    size_t num_prompts, const rac_llm_options_t* options,
+                                    rac_llm_batch_callback_fn callback, void* user_data) {
+    if (!handle || (!prompts && num_prompts > 0) || !callback)
+        return RAC_ERROR_NULL_POINTER;
+
+    auto* service = static_cast<rac_llm_service_t*>(handle);
+    if (service->ops && service->ops->generate_batch) {
+        return service->ops->generate_batch(service->impl, prompts, num_prompts, options, callback,
+                                            user_data);
+    }
+    if (!service->ops || !service->ops->generate) {
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+
+    // No batched path in this backend: run the prompts one by one
+    for (size_t i = 0; i < num_prompts; i++) {
+        rac_llm_result_t result = {};
+        rac_result_t status = prompts[i]
+                                  ? service->ops->generate(service->impl, prompts[i], options,
+                                                           &result)
+                                  : RAC_ERROR_INVALID_ARGUMENT;
+        callback(i, status, status == RAC_SUCCESS ? &result : nullptr, user_data);
+        rac_llm_result_free(&result);
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_llm_generate_samples(rac_handle_t handle, const char* prompt,
+                                      const rac_llm_options_t* options,
+                                      rac_llm_samples_t* out_samples) {
+    if (!handle || !prompt || !out_samples)
+        return RAC_ERROR_NULL_POINTER;
+    *out_samples = {};
+
+    auto* service = static_cast<rac_llm_service_t*>(handle);
+    if (service->ops && service->ops->generate_samples) {
+        return service->ops->generate_samples(service->impl, prompt, options, out_samples);
+    }
+    if (!service->ops || !service->ops->generate) {
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+
+    // No shared prefill in this backend: generate the replies one by one
+    const int32_t n = options && options->n_samples > 1 ? options->n_samples : 1;
+    auto* samples = static_cast<rac_llm_sample_t*>(
+        rac_calloc(static_cast<size_t>(n), sizeof(rac_llm_sample_t)));
+    if (!samples) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    out_samples->samples = samples;
+    const int32_t max_tokens = options ? options->max_tokens : 0;
+    for (int32_t i = 0; i < n; i++) {
+        rac_llm_result_t result = {};
+        const rac_result_t status = service->ops->generate(service->impl, prompt, options, &result);
+        if (status != RAC_SUCCESS) {
+            rac_llm_result_free(&result);
+            rac_llm_samples_free(out_samples);
+            return status;
+        }
+        samples[i].text = result.text;
+        samples[i].completion_tokens = result.completion_tokens;
+        samples[i].truncated =
+            max_tokens > 0 && result.completion_tokens >= max_tokens ? RAC_TRUE : RAC_FALSE;
+        out_samples->num_samples = i + 1;
+        out_samples->prompt_tokens = result.prompt_tokens;
+        out_samples->total_time_ms += result.total_time_ms;
+    }
+    return RAC_SUCCESS;
+}
+
 rac_result_t rac_llm_get_info(rac_handle_t handle, rac_llm_info_t* out_info) {
     if (!handle || !out_info)
         return RAC_ERROR_NULL_POINTER;
@@ -158,6 +235,119 @@ rac_result_t rac_llm_cleanup(rac_handle_t handle) {
     return service->ops->cleanup(service->impl);
 }
 
+rac_result_t rac_llm_get_memory_usage(rac_handle_t handle, rac_llm_memory_usage_t* out_usage) {
+    if (!handle || !out_usage)
+        return RAC_ERROR_NULL_POINTER;
+
+    auto* service = static_cast<rac_llm_service_t*>(handle);
+    if (!service->ops || !service->ops->get_memory_usage) {
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+
+    return service->ops->get_memory_usage(service->impl, out_usage);
+}
+
+rac_result_t rac_llm_trim_memory(rac_handle_t handle, rac_llm_memory_pressure_t level) {
+    if (!handle)
+        return RAC_ERROR_NULL_POINTER;
+
+    auto* service = static_cast<rac_llm_service_t*>(handle);
+    if (!service->ops || !service->ops->trim_memory) {
+        return RAC_SUCCESS;  // No-op if not supported
+    }
+
+    return service->ops->trim_memory(service->impl, level);
+}
+
+rac_result_t rac_llm_count_tokens(rac_handle_t handle, const char* text, int32_t* out_count) {
+    if (!handle || !text || !out_count)
+        return RAC_ERROR_NULL_POINTER;
+
+    auto* service = static_cast<rac_llm_service_t*>(handle);
+    if (!service->ops || !service->ops->count_tokens) {
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+
+    return service->ops->count_tokens(service->impl, text, out_count);
+}
+
+rac_result_t rac_llm_save_state(rac_handle_t handle, const char* path, int32_t* out_token_count) {
+    if (!handle || !path)
+        return RAC_ERROR_NULL_POINTER;
+
+    auto* service = static_cast<rac_llm_service_t*>(handle);
+    if (!service->ops || !service->ops->save_state) {
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+
+    return service->ops->save_state(service->impl, path, out_token_count);
+}
+
+rac_result_t rac_llm_restore_state(rac_handle_t handle, const char* path,
+                                   int32_t* out_token_count) {
+    if (!handle || !path)
+        return RAC_ERROR_NULL_POINTER;
+
+    auto* service = static_cast<rac_llm_service_t*>(handle);
+    if (!service->ops || !service->ops->restore_state) {
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+
+    return service->ops->restore_state(service->impl, path, out_token_count);
+}
+
+rac_result_t rac_llm_load_lora(rac_handle_t handle, const char* name, const char* path) {
+    if (!handle || !name || !path)
+        return RAC_ERROR_NULL_POINTER;
+
+    auto* service = static_cast<rac_llm_service_t*>(handle);
+    if (!service->ops || !service->ops->load_lora) {
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+
+    return service->ops->load_lora(service->impl, name, path);
+}
+
+rac_result_t rac_llm_remove_lora(rac_handle_t handle, const char* name) {
+    if (!handle || !name)
+        return RAC_ERROR_NULL_POINTER;
+
+    auto* service = static_cast<rac_llm_service_t*>(handle);
+    if (!service->ops || !service->ops->remove_lora) {
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+
+    return service->ops->remove_lora(service->impl, name);
+}
+
+rac_result_t rac_llm_set_lora(rac_handle_t handle, const char* name, float scale) {
+    if (!handle)
+        return RAC_ERROR_NULL_POINTER;
+
+    auto* service = static_cast<rac_llm_service_t*>(handle);
+    if (!service->ops || !service->ops->set_lora) {
+        // Selecting the base model needs no support
+        return (name && name[0] != '\0') ? RAC_ERROR_NOT_SUPPORTED : RAC_SUCCESS;
+    }
+
+    return service->ops->set_lora(service->impl, name, scale);
+}
+
+rac_result_t rac_llm_get_stop_reason(rac_handle_t handle, rac_llm_stop_reason_t* out_reason) {
+    if (!handle || !out_reason)
+        return RAC_ERROR_NULL_POINTER;
+
+    *out_reason = RAC_LLM_STOP_REASON_END;
+    auto* service = static_cast<rac_llm_service_t*>(handle);
+    if (service->ops && service->ops->get_stop_reason) {
+        rac_llm_stop_reason_t reason = RAC_LLM_STOP_REASON_END;
+        if (service->ops->get_stop_reason(service->impl, &reason) == RAC_SUCCESS) {
+            *out_reason = reason;
+        }
+    }
+    return RAC_SUCCESS;
+}
+
 void rac_llm_destroy(rac_handle_t handle) {
     if (!handle)
         return;
@@ -171,20 +361,30 @@ void rac_llm_destroy(rac_handle_t handle) {
 
     // Free model_id if allocated
     if (service->model_id) {
-        free(const_cast<char*>(service->model_id));
+        rac_free(const_cast<char*>(service->model_id));
     }
 
     // Free service struct
-    free(service);
+    rac_free(service);
 }
 
 void rac_llm_result_free(rac_llm_result_t* result) {
     if (!result)
         return;
     if (result->text) {
-        free(result->text);
+        rac_free(result->text);
         result->text = nullptr;
     }
 }
 
+void rac_llm_samples_free(rac_llm_samples_t* samples) {
+    if (!samples)
+        return;
+    for (int32_t i = 0; samples->samples && i < samples->num_samples; i++) {
+        rac_free(samples->samples[i].text);
+    }
+    rac_free(samples->samples);
+    *samples = {};
+}
+
 }  // extern "C"
@@ -9,6 +9,11 @@
  * CRITICAL: This is a direct port of Swift implementation - do NOT add custom logic!
  */
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <map>
@@ -16,6 +21,7 @@
 #include <string>
 
 #include "rac/core/rac_logger.h"
+#include "rac/core/rac_metrics.h"
 #include "rac/core/rac_platform_adapter.h"
 #include "rac/core/rac_structured_error.h"
 #include "rac/features/llm/rac_llm_metrics.h"
@@ -26,34 +32,104 @@
 // STREAMING METRICS COLLECTOR INTERNAL STRUCTURE
 // =============================================================================
 
+/** Token arrival times kept for the recent-rate window */
+static constexpr int32_t kTokenTimeRingSize = 256;
+
+/**
+ * Single-writer collector: record_token runs on the decode thread without
+ * locks or clock callbacks into the platform adapter. State is published
+ * through atomics so readers on other threads (UI, analytics) never block
+ * the writer; derived values are computed on read.
+ */
 struct rac_streaming_metrics_collector {
     // Configuration
     std::string model_id{};
     std::string generation_id{};
     int32_t prompt_length{0};
+    bool capture_text{true};
 
-    // Timing
-    int64_t start_time_ms{0};
-    int64_t first_token_time_ms{0};
-    int64_t end_time_ms{0};
+    // Timing (steady clock, microseconds; 0 = not reached)
+    std::atomic<int64_t> start_time_us{0};
+    std::atomic<int64_t> first_token_time_us{0};
+    std::atomic<int64_t> end_time_us{0};
+
+    // Arrival time of token i lives in token_times_us[i % kTokenTimeRingSize]
+    std::array<std::atomic<int64_t>, kTokenTimeRingSize> token_times_us{};
+
+    // Inter-token gap histogram, written only by the recording thread
+    std::array<std::atomic<uint32_t>, RAC_LATENCY_HISTOGRAM_BUCKETS> gap_counts{};
+    std::atomic<int64_t> gap_sum_us{0};
+    std::atomic<int64_t> gap_max_us{0};
 
-    // State
+    // State; token_count is the publication point for the ring
+    std::atomic<int32_t> token_count{0};
+    std::atomic<bool> is_complete{false};
+    std::atomic<rac_result_t> error_code{RAC_SUCCESS};
+
+    // Writer-owned; readers may only touch it after mark_complete/mark_failed
     std::string full_text{};
-    int32_t token_count{0};
-    bool first_token_recorded{false};
-    bool is_complete{false};
-    rac_result_t error_code{RAC_SUCCESS};
 
     // Actual token counts from backend (0 = use estimation)
-    int32_t actual_input_tokens{0};
-    int32_t actual_output_tokens{0};
-
-    // Thread safety
-    std::mutex mutex{};
+    std::atomic<int32_t> actual_input_tokens{0};
+    std::atomic<int32_t> actual_output_tokens{0};
 
     rac_streaming_metrics_collector() = default;
 };
 
+static int64_t steady_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static double us_to_ms(int64_t us) {
+    return static_cast<double>(us) / 1000.0;
+}
+
+// =============================================================================
+// LATENCY HISTOGRAM HELPERS
+// =============================================================================
+
+/** Smallest bucketed latency: 64 us; bucket i spans a quarter octave above it */
+static constexpr int kHistogramMinShift = 6;
+
+static int32_t latency_bucket(int64_t us) {
+    if (us < (int64_t{1} << kHistogramMinShift)) {
+        return 0;
+    }
+    const int msb = 63 - __builtin_clzll(static_cast<unsigned long long>(us));
+    const int octave = msb - kHistogramMinShift;
+    const int sub = static_cast<int>((us >> (msb - 2)) & 3);
+    return std::min(octave * 4 + sub, RAC_LATENCY_HISTOGRAM_BUCKETS - 1);
+}
+
+static void histogram_add(rac_latency_histogram_t& histogram, int64_t us) {
+    histogram.counts[latency_bucket(us)]++;
+    histogram.total_count++;
+    histogram.sum_ms += us_to_ms(us);
+    histogram.max_ms = std::max(histogram.max_ms, us_to_ms(us));
+}
+
+static void histogram_merge(rac_latency_histogram_t& into, const rac_latency_histogram_t& from) {
+    for (int32_t i = 0; i < RAC_LATENCY_HISTOGRAM_BUCKETS; i++) {
+        into.counts[i] += from.counts[i];
+    }
+    into.total_count += from.total_count;
+    into.sum_ms += from.sum_ms;
+    into.max_ms = std::max(into.max_ms, from.max_ms);
+}
+
+static void snapshot_gaps(const rac_streaming_metrics_collector* collector,
+                          rac_latency_histogram_t& out) {
+    out = {};
+    for (int32_t i = 0; i < RAC_LATENCY_HISTOGRAM_BUCKETS; i++) {
+        out.counts[i] = collector->gap_counts[i].load(std::memory_order_relaxed);
+        out.total_count += out.counts[i];
+    }
+    out.sum_ms = us_to_ms(collector->gap_sum_us.load(std::memory_order_relaxed));
+    out.max_ms = us_to_ms(collector->gap_max_us.load(std::memory_order_relaxed));
+}
+
 // =============================================================================
 // GENERATION TRACKER (Internal)
 // =============================================================================
@@ -88,6 +164,10 @@ struct rac_generation_analytics {
     int64_t start_time_ms{0};
     int64_t last_event_time_ms{0};
 
+    // Tail latency across merged streams
+    rac_latency_histogram_t inter_token{};
+    rac_latency_histogram_t prefill{};
+
     // Thread safety
     std::mutex mutex{};
 
@@ -120,13 +200,22 @@ void rac_streaming_metrics_destroy(rac_streaming_metrics_handle_t handle) {
     }
 }
 
+rac_result_t rac_streaming_metrics_set_capture_text(rac_streaming_metrics_handle_t handle,
+                                                    rac_bool_t capture) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    handle->capture_text = capture == RAC_TRUE;
+    return RAC_SUCCESS;
+}
+
 rac_result_t rac_streaming_metrics_mark_start(rac_streaming_metrics_handle_t handle) {
     if (!handle) {
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
-    handle->start_time_ms = rac_get_current_time_ms();
+    handle->start_time_us.store(steady_now_us(), std::memory_order_release);
     return RAC_SUCCESS;
 }
 
@@ -136,18 +225,35 @@ rac_result_t rac_streaming_metrics_record_token(rac_streaming_metrics_handle_t h
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
-
-    // Record first token time
-    if (!handle->first_token_recorded) {
-        handle->first_token_time_ms = rac_get_current_time_ms();
-        handle->first_token_recorded = true;
-    }
-
-    // Accumulate text and count
-    handle->full_text += token;
-    handle->token_count++;
+    // Single writer: the relaxed load of our own counter is always current
+    const int32_t index = handle->token_count.load(std::memory_order_relaxed);
+    const int64_t now = steady_now_us();
 
+    if (index == 0) {
+        handle->first_token_time_us.store(now, std::memory_order_relaxed);
+    } else {
+        // Only this thread writes the gap counters, so load+store needs no RMW
+        const int64_t gap =
+            now - handle->token_times_us[(index - 1) % kTokenTimeRingSize].load(
+                      std::memory_order_relaxed);
+        auto& bucket = handle->gap_counts[latency_bucket(gap)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        handle->gap_sum_us.store(handle->gap_sum_us.load(std::memory_order_relaxed) + gap,
+                                 std::memory_order_relaxed);
+        if (gap > handle->gap_max_us.load(std::memory_order_relaxed)) {
+            handle->gap_max_us.store(gap, std::memory_order_relaxed);
+        }
+        static const rac::MetricHistogram inter_token_us("llm.inter_token_us");
+        inter_token_us.record(gap);
+    }
+    static const rac::MetricCounter output_tokens("llm.output_tokens");
+    output_tokens.add();
+    handle->token_times_us[index % kTokenTimeRingSize].store(now, std::memory_order_relaxed);
+    if (handle->capture_text) {
+        handle->full_text += token;
+    }
+
+    handle->token_count.store(index + 1, std::memory_order_release);
     return RAC_SUCCESS;
 }
 
@@ -156,9 +262,8 @@ rac_result_t rac_streaming_metrics_mark_complete(rac_streaming_metrics_handle_t
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
-    handle->end_time_ms = rac_get_current_time_ms();
-    handle->is_complete = true;
+    handle->end_time_us.store(steady_now_us(), std::memory_order_relaxed);
+    handle->is_complete.store(true, std::memory_order_release);
     return RAC_SUCCESS;
 }
 
@@ -168,10 +273,9 @@ rac_result_t rac_streaming_metrics_mark_failed(rac_streaming_metrics_handle_t ha
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
-    handle->end_time_ms = rac_get_current_time_ms();
-    handle->is_complete = true;
-    handle->error_code = error_code;
+    handle->end_time_us.store(steady_now_us(), std::memory_order_relaxed);
+    handle->error_code.store(error_code, std::memory_order_relaxed);
+    handle->is_complete.store(true, std::memory_order_release);
     return RAC_SUCCESS;
 }
 
@@ -181,36 +285,43 @@ rac_result_t rac_streaming_metrics_get_result(rac_streaming_metrics_handle_t han
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    const bool complete = handle->is_complete.load(std::memory_order_acquire);
+    const int32_t token_count = handle->token_count.load(std::memory_order_acquire);
+    const int64_t start_time = handle->start_time_us.load(std::memory_order_acquire);
 
     // Calculate latency
-    int64_t end_time = handle->end_time_ms > 0 ? handle->end_time_ms : rac_get_current_time_ms();
-    double latency_ms = static_cast<double>(end_time - handle->start_time_ms);
+    int64_t end_time = complete ? handle->end_time_us.load(std::memory_order_relaxed) : 0;
+    if (end_time == 0) {
+        end_time = steady_now_us();
+    }
+    double latency_ms = start_time > 0 ? us_to_ms(end_time - start_time) : 0.0;
 
     // Calculate TTFT
     double ttft_ms = 0.0;
-    if (handle->first_token_recorded && handle->start_time_ms > 0) {
-        ttft_ms = static_cast<double>(handle->first_token_time_ms - handle->start_time_ms);
+    if (token_count > 0 && start_time > 0) {
+        ttft_ms =
+            us_to_ms(handle->first_token_time_us.load(std::memory_order_relaxed) - start_time);
     }
 
+    // Text is only safe to read once the writer is done
+    const std::string* text = complete ? &handle->full_text : nullptr;
+
     // Use actual token counts from backend if available, otherwise estimate
-    int32_t input_tokens;
-    int32_t output_tokens;
+    int32_t input_tokens = handle->actual_input_tokens.load(std::memory_order_relaxed);
+    int32_t output_tokens = handle->actual_output_tokens.load(std::memory_order_relaxed);
 
-    if (handle->actual_input_tokens > 0) {
-        input_tokens = handle->actual_input_tokens;
-    } else {
+    if (input_tokens <= 0) {
         // Fallback: estimate ~4 chars per token
         input_tokens = handle->prompt_length > 0 ? (handle->prompt_length / 4) : 1;
         if (input_tokens < 1)
             input_tokens = 1;
     }
 
-    if (handle->actual_output_tokens > 0) {
-        output_tokens = handle->actual_output_tokens;
-    } else {
-        // Fallback: estimate ~4 chars per token
-        output_tokens = static_cast<int32_t>(handle->full_text.length() / 4);
+    if (output_tokens <= 0) {
+        // Fallback: estimate ~4 chars per token, or the recorded chunk count
+        // when text is not captured
+        output_tokens = text && handle->capture_text ? static_cast<int32_t>(text->length() / 4)
+                                                     : token_count;
         if (output_tokens < 1)
             output_tokens = 1;
     }
@@ -222,7 +333,7 @@ rac_result_t rac_streaming_metrics_get_result(rac_streaming_metrics_handle_t han
     }
 
     // Populate result
-    out_result->text = rac_strdup(handle->full_text.c_str());
+    out_result->text = rac_strdup(text ? text->c_str() : "");
     out_result->thinking_content = nullptr;
     out_result->input_tokens = input_tokens;
     out_result->output_tokens = output_tokens;
@@ -233,6 +344,13 @@ rac_result_t rac_streaming_metrics_get_result(rac_streaming_metrics_handle_t han
     out_result->thinking_tokens = 0;
     out_result->response_tokens = output_tokens;
 
+    rac_latency_histogram_t gaps;
+    snapshot_gaps(handle, gaps);
+    out_result->inter_token_p50_ms = rac_latency_histogram_percentile(&gaps, 50.0);
+    out_result->inter_token_p95_ms = rac_latency_histogram_percentile(&gaps, 95.0);
+    out_result->inter_token_p99_ms = rac_latency_histogram_percentile(&gaps, 99.0);
+    out_result->inter_token_max_ms = gaps.max_ms;
+
     return RAC_SUCCESS;
 }
 
@@ -242,12 +360,14 @@ rac_result_t rac_streaming_metrics_get_ttft(rac_streaming_metrics_handle_t handl
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    const int32_t token_count = handle->token_count.load(std::memory_order_acquire);
+    const int64_t start_time = handle->start_time_us.load(std::memory_order_acquire);
 
-    if (!handle->first_token_recorded || handle->start_time_ms == 0) {
+    if (token_count == 0 || start_time == 0) {
         *out_ttft_ms = 0.0;
     } else {
-        *out_ttft_ms = static_cast<double>(handle->first_token_time_ms - handle->start_time_ms);
+        *out_ttft_ms =
+            us_to_ms(handle->first_token_time_us.load(std::memory_order_relaxed) - start_time);
     }
 
     return RAC_SUCCESS;
@@ -259,8 +379,46 @@ rac_result_t rac_streaming_metrics_get_token_count(rac_streaming_metrics_handle_
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
-    *out_token_count = handle->token_count;
+    *out_token_count = handle->token_count.load(std::memory_order_acquire);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_streaming_metrics_get_recent_rate(rac_streaming_metrics_handle_t handle,
+                                                   double* out_tokens_per_second) {
+    if (!handle || !out_tokens_per_second) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    *out_tokens_per_second = 0.0;
+    const int32_t token_count = handle->token_count.load(std::memory_order_acquire);
+    if (token_count < 2) {
+        return RAC_SUCCESS;
+    }
+
+    // Oldest slot still inside the ring; the writer may overwrite it while we
+    // read, which only shortens the window by one token
+    const int32_t window = std::min(token_count, kTokenTimeRingSize - 1);
+    const int64_t newest =
+        handle->token_times_us[(token_count - 1) % kTokenTimeRingSize].load(
+            std::memory_order_relaxed);
+    const int64_t oldest =
+        handle->token_times_us[(token_count - window) % kTokenTimeRingSize].load(
+            std::memory_order_relaxed);
+
+    if (newest > oldest) {
+        *out_tokens_per_second =
+            static_cast<double>(window - 1) / (static_cast<double>(newest - oldest) / 1e6);
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_streaming_metrics_get_inter_token_histogram(
+    rac_streaming_metrics_handle_t handle, rac_latency_histogram_t* out_histogram) {
+    if (!handle || !out_histogram) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    snapshot_gaps(handle, *out_histogram);
     return RAC_SUCCESS;
 }
 
@@ -270,7 +428,6 @@ rac_result_t rac_streaming_metrics_get_text(rac_streaming_metrics_handle_t handl
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
     *out_text = rac_strdup(handle->full_text.c_str());
     return *out_text ? RAC_SUCCESS : RAC_ERROR_OUT_OF_MEMORY;
 }
@@ -281,9 +438,8 @@ rac_result_t rac_streaming_metrics_set_token_counts(rac_streaming_metrics_handle
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
-    handle->actual_input_tokens = input_tokens;
-    handle->actual_output_tokens = output_tokens;
+    handle->actual_input_tokens.store(input_tokens, std::memory_order_relaxed);
+    handle->actual_output_tokens.store(output_tokens, std::memory_order_relaxed);
     return RAC_SUCCESS;
 }
 
@@ -420,12 +576,21 @@ rac_result_t rac_generation_analytics_complete(rac_generation_analytics_handle_t
     double tokens_per_second =
         total_time_seconds > 0 ? static_cast<double>(output_tokens) / total_time_seconds : 0.0;
 
+    static const rac::MetricCounter generations("llm.generations");
+    static const rac::MetricHistogram generation_ms("llm.generation_ms");
+    static const rac::MetricGauge tokens_per_second_gauge("llm.tokens_per_second");
+    generations.add();
+    generation_ms.record(end_time - tracker.start_time_ms);
+    tokens_per_second_gauge.set(tokens_per_second);
+
     // Calculate TTFT for streaming generations
     if (tracker.is_streaming && tracker.first_token_recorded) {
         double ttft_seconds =
             static_cast<double>(tracker.first_token_time_ms - tracker.start_time_ms) / 1000.0;
         handle->total_ttft_seconds += ttft_seconds;
         handle->ttft_count++;
+        static const rac::MetricHistogram ttft_ms("llm.ttft_ms");
+        ttft_ms.record(tracker.first_token_time_ms - tracker.start_time_ms);
     }
 
     // Update aggregated metrics
@@ -512,10 +677,83 @@ rac_result_t rac_generation_analytics_reset(rac_generation_analytics_handle_t ha
     handle->total_output_tokens = 0;
     handle->start_time_ms = rac_get_current_time_ms();
     handle->last_event_time_ms = 0;
+    handle->inter_token = {};
+    handle->prefill = {};
 
     return RAC_SUCCESS;
 }
 
+rac_result_t rac_generation_analytics_merge_streaming(rac_generation_analytics_handle_t handle,
+                                                      rac_streaming_metrics_handle_t metrics) {
+    if (!handle || !metrics) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    rac_latency_histogram_t gaps;
+    snapshot_gaps(metrics, gaps);
+
+    const int64_t start_time = metrics->start_time_us.load(std::memory_order_acquire);
+    const bool has_first_token = metrics->token_count.load(std::memory_order_acquire) > 0;
+    const int64_t first_token_time = metrics->first_token_time_us.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    histogram_merge(handle->inter_token, gaps);
+    if (start_time > 0 && has_first_token) {
+        histogram_add(handle->prefill, first_token_time - start_time);
+    }
+
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_generation_analytics_get_latency_histograms(
+    rac_generation_analytics_handle_t handle, rac_latency_histogram_t* out_inter_token,
+    rac_latency_histogram_t* out_prefill) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    if (out_inter_token) {
+        *out_inter_token = handle->inter_token;
+    }
+    if (out_prefill) {
+        *out_prefill = handle->prefill;
+    }
+
+    return RAC_SUCCESS;
+}
+
+// =============================================================================
+// LATENCY HISTOGRAM API
+// =============================================================================
+
+double rac_latency_histogram_bucket_upper_ms(int32_t bucket) {
+    bucket = std::max(0, std::min(bucket, RAC_LATENCY_HISTOGRAM_BUCKETS - 1)) + 1;
+    const int octave = bucket / 4;
+    const int sub = bucket % 4;
+    return us_to_ms(static_cast<int64_t>(4 + sub) << (octave + kHistogramMinShift - 2));
+}
+
+double rac_latency_histogram_percentile(const rac_latency_histogram_t* histogram,
+                                        double percentile) {
+    if (!histogram || histogram->total_count <= 0) {
+        return 0.0;
+    }
+
+    const double clamped = std::max(0.0, std::min(percentile, 100.0));
+    const auto rank = std::max<int64_t>(
+        1, static_cast<int64_t>(std::ceil(clamped / 100.0 * histogram->total_count)));
+
+    int64_t seen = 0;
+    for (int32_t i = 0; i < RAC_LATENCY_HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if (seen >= rank) {
+            return std::min(rac_latency_histogram_bucket_upper_ms(i), histogram->max_ms);
+        }
+    }
+    return histogram->max_ms;
+}
+
 // =============================================================================
 // MEMORY MANAGEMENT
 // =============================================================================
@@ -526,15 +764,15 @@ void rac_streaming_result_free(rac_streaming_result_t* result) {
     }
 
     if (result->text) {
-        free(result->text);
+        rac_free(result->text);
         result->text = nullptr;
     }
     if (result->thinking_content) {
-        free(result->thinking_content);
+        rac_free(result->thinking_content);
         result->thinking_content = nullptr;
     }
     if (result->model_id) {
-        free(result->model_id);
+        rac_free(result->model_id);
         result->model_id = nullptr;
     }
 }
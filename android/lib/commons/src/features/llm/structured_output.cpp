@@ -13,6 +13,7 @@
 #include <cstdlib>
 #include <cstring>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
 #include "rac/core/rac_platform_adapter.h"
 #include "rac/features/llm/rac_llm_structured_output.h"
@@ -270,7 +271,7 @@ extern "C" rac_result_t rac_structured_output_extract_json(const char* text, cha
     size_t json_start, json_end;
     if (rac_structured_output_find_complete_json(trimmed, &json_start, &json_end) != 0) {
         size_t json_len = json_end - json_start;
-        char* result = static_cast<char*>(malloc(json_len + 1));
+        char* result = static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, json_len + 1));
         if (!result) {
             return RAC_ERROR_OUT_OF_MEMORY;
         }
@@ -289,7 +290,7 @@ extern "C" rac_result_t rac_structured_output_extract_json(const char* text, cha
         size_t brace_end;
         if (rac_structured_output_find_matching_brace(trimmed, brace_start, &brace_end) != 0) {
             size_t json_len = brace_end - brace_start + 1;
-            char* result = static_cast<char*>(malloc(json_len + 1));
+            char* result = static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, json_len + 1));
             if (!result) {
                 return RAC_ERROR_OUT_OF_MEMORY;
             }
@@ -310,7 +311,7 @@ extern "C" rac_result_t rac_structured_output_extract_json(const char* text, cha
         if (rac_structured_output_find_matching_bracket(trimmed, bracket_start, &bracket_end) !=
             0) {
             size_t json_len = bracket_end - bracket_start + 1;
-            char* result = static_cast<char*>(malloc(json_len + 1));
+            char* result = static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, json_len + 1));
             if (!result) {
                 return RAC_ERROR_OUT_OF_MEMORY;
             }
@@ -326,7 +327,7 @@ extern "C" rac_result_t rac_structured_output_extract_json(const char* text, cha
 
     // If no clear JSON boundaries, check if the entire text might be JSON
     if (trimmed[0] == '{' || trimmed[0] == '[') {
-        char* result = static_cast<char*>(malloc(trimmed_len + 1));
+        char* result = static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, trimmed_len + 1));
         if (!result) {
             return RAC_ERROR_OUT_OF_MEMORY;
         }
@@ -375,7 +376,7 @@ extern "C" rac_result_t rac_structured_output_get_system_prompt(const char* json
         "Remember: Output ONLY the JSON object, nothing else.";
 
     size_t needed = snprintf(NULL, 0, format, schema) + 1;
-    char* result = static_cast<char*>(malloc(needed));
+    char* result = static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, needed));
     if (!result) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
@@ -399,7 +400,7 @@ extern "C" rac_result_t rac_structured_output_prepare_prompt(
     // If no config or schema not included in prompt, return original
     if (config == nullptr || config->include_schema_in_prompt == 0) {
         size_t len = strlen(original_prompt);
-        char* result = static_cast<char*>(malloc(len + 1));
+        char* result = static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, len + 1));
         if (!result) {
             return RAC_ERROR_OUT_OF_MEMORY;
         }
@@ -437,7 +438,7 @@ extern "C" rac_result_t rac_structured_output_prepare_prompt(
         "Remember: Output ONLY the JSON object, nothing else.";
 
     size_t needed = snprintf(NULL, 0, format, original_prompt, schema) + 1;
-    char* result = static_cast<char*>(malloc(needed));
+    char* result = static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, needed));
     if (!result) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
@@ -455,8 +456,6 @@ extern "C" rac_result_t rac_structured_output_prepare_prompt(
 extern "C" rac_result_t
 rac_structured_output_validate(const char* text, const rac_structured_output_config_t* config,
                                rac_structured_output_validation_t* out_validation) {
-    (void)config;  // Currently unused, reserved for future schema validation
-
     if (!text || !out_validation) {
         return RAC_ERROR_INVALID_ARGUMENT;
     }
@@ -468,19 +467,34 @@ rac_structured_output_validate(const char* text, const rac_structured_output_con
 
     // Try to extract JSON
     char* extracted = nullptr;
-    rac_result_t result = rac_structured_output_extract_json(text, &extracted, nullptr);
+    size_t extracted_length = 0;
+    rac_result_t result = rac_structured_output_extract_json(text, &extracted, &extracted_length);
+
+    if (result != RAC_SUCCESS || !extracted) {
+        // Extraction failed
+        out_validation->error_message = rac_strdup("No valid JSON found in the response");
+        return RAC_SUCCESS;  // Function succeeded, validation just returned false
+    }
+
+    out_validation->extracted_json = extracted;
 
-    if (result == RAC_SUCCESS && extracted) {
+    if (!config || !config->json_schema || config->json_schema[0] == '\0') {
         out_validation->is_valid = RAC_TRUE;
-        out_validation->extracted_json = extracted;
         return RAC_SUCCESS;
     }
 
-    // Extraction failed
-    out_validation->is_valid = RAC_FALSE;
-    out_validation->error_message = "No valid JSON found in the response";
+    // Schema check (not in the Swift source); the compiled schema is cached
+    char* error = nullptr;
+    result = rac_structured_output_validate_json(extracted, extracted_length, config->json_schema,
+                                                 &out_validation->is_valid, &error);
+    if (result != RAC_SUCCESS) {
+        rac_free(extracted);
+        out_validation->extracted_json = nullptr;
+        return result;
+    }
+    out_validation->error_message = error;
 
-    return RAC_SUCCESS;  // Function succeeded, validation just returned false
+    return RAC_SUCCESS;
 }
 
 // =============================================================================
@@ -494,11 +508,13 @@ rac_structured_output_validation_free(rac_structured_output_validation_t* valida
     }
 
     if (validation->extracted_json) {
-        free(validation->extracted_json);
+        rac_free(validation->extracted_json);
         validation->extracted_json = nullptr;
     }
 
-    // error_message is static, don't free it
-    validation->error_message = nullptr;
+    if (validation->error_message) {
+        rac_free(const_cast<char*>(validation->error_message));
+        validation->error_message = nullptr;
+    }
     validation->is_valid = RAC_FALSE;
 }
@@ -0,0 +1,215 @@
+/**
+ * @file structured_output_stream.cpp
+ * @brief LLM Structured Output - Incremental JSON Parser
+ *
+ * Push-style companion to structured_output.cpp: instead of rescanning the
+ * whole response after generation, tokens are fed as they stream and each byte
+ * is examined once. The parser tracks bracket depth and string state, reports
+ * when the top-level value closes, and emits top-level object members as soon
+ * as their value is complete.
+ */
+
+#include <cctype>
+#include <string>
+
+#include "rac/core/rac_types.h"
+#include "rac/features/llm/rac_llm_structured_output.h"
+
+// =============================================================================
+// INTERNAL STRUCTURE
+// =============================================================================
+
+namespace {
+
+/** Where the parser is inside a top-level object member */
+enum class MemberPhase { NONE, KEY, COLON, VALUE_START, VALUE };
+
+}  // namespace
+
+struct rac_structured_output_stream {
+    rac_structured_output_field_fn on_field{nullptr};
+    void* user_data{nullptr};
+
+    rac_structured_output_stream_state_t state{RAC_STRUCTURED_OUTPUT_STREAM_SEARCHING};
+
+    // JSON text from the opening bracket
+    std::string json{};
+    // Open brackets, innermost last
+    std::string stack{};
+    bool in_string{false};
+    bool escaped{false};
+
+    // Top-level member tracking (objects only)
+    MemberPhase phase{MemberPhase::NONE};
+    size_t key_begin{0};
+    size_t value_begin{0};
+    std::string key{};
+
+    void reset() {
+        state = RAC_STRUCTURED_OUTPUT_STREAM_SEARCHING;
+        json.clear();
+        stack.clear();
+        in_string = false;
+        escaped = false;
+        phase = MemberPhase::NONE;
+        key.clear();
+    }
+
+    void emit_member(size_t end) {
+        while (end > value_begin && isspace(static_cast<unsigned char>(json[end - 1]))) {
+            end--;
+        }
+        if (on_field) {
+            const std::string value = json.substr(value_begin, end - value_begin);
+            on_field(key.c_str(), value.c_str(), user_data);
+        }
+    }
+
+    void begin_value(size_t pos) {
+        value_begin = pos;
+        phase = MemberPhase::VALUE;
+    }
+
+    void feed(char ch);
+};
+
+void rac_structured_output_stream::feed(char ch) {
+    if (state == RAC_STRUCTURED_OUTPUT_STREAM_SEARCHING) {
+        if (ch == '{' || ch == '[') {
+            state = RAC_STRUCTURED_OUTPUT_STREAM_PARSING;
+            json.push_back(ch);
+            stack.push_back(ch);
+            phase = ch == '{' ? MemberPhase::KEY : MemberPhase::NONE;
+        }
+        return;
+    }
+
+    json.push_back(ch);
+    const size_t pos = json.size() - 1;
+    const bool top = stack.size() == 1;
+
+    if (in_string) {
+        if (escaped) {
+            escaped = false;
+        } else if (ch == '\\') {
+            escaped = true;
+        } else if (ch == '"') {
+            in_string = false;
+            if (top && phase == MemberPhase::KEY) {
+                key.assign(json, key_begin, pos - key_begin);
+                phase = MemberPhase::COLON;
+            }
+        }
+        return;
+    }
+
+    switch (ch) {
+        case '"':
+            in_string = true;
+            if (top && phase == MemberPhase::KEY) {
+                key_begin = pos + 1;
+            } else if (top && phase == MemberPhase::VALUE_START) {
+                begin_value(pos);
+            }
+            break;
+        case '{':
+        case '[':
+            if (top && phase == MemberPhase::VALUE_START) {
+                begin_value(pos);
+            }
+            stack.push_back(ch);
+            break;
+        case '}':
+        case ']':
+            if (stack.back() != (ch == '}' ? '{' : '[')) {
+                state = RAC_STRUCTURED_OUTPUT_STREAM_ERROR;
+                return;
+            }
+            stack.pop_back();
+            if (stack.empty()) {
+                if (phase == MemberPhase::VALUE) {
+                    emit_member(pos);
+                }
+                phase = MemberPhase::NONE;
+                state = RAC_STRUCTURED_OUTPUT_STREAM_COMPLETE;
+            }
+            break;
+        case ',':
+            if (top && phase == MemberPhase::VALUE) {
+                emit_member(pos);
+                phase = MemberPhase::KEY;
+            }
+            break;
+        case ':':
+            if (top && phase == MemberPhase::COLON) {
+                phase = MemberPhase::VALUE_START;
+            }
+            break;
+        default:
+            if (top && phase == MemberPhase::VALUE_START &&
+                !isspace(static_cast<unsigned char>(ch))) {
+                begin_value(pos);
+            }
+            break;
+    }
+}
+
+// =============================================================================
+// INCREMENTAL JSON PARSER API
+// =============================================================================
+
+extern "C" rac_result_t rac_structured_output_stream_create(
+    rac_structured_output_field_fn on_field, void* user_data,
+    rac_structured_output_stream_t* out_stream) {
+    if (!out_stream) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto* stream = new rac_structured_output_stream();
+    stream->on_field = on_field;
+    stream->user_data = user_data;
+
+    *out_stream = stream;
+    return RAC_SUCCESS;
+}
+
+extern "C" rac_result_t rac_structured_output_stream_feed(
+    rac_structured_output_stream_t stream, const char* text, size_t length,
+    rac_structured_output_stream_state_t* out_state) {
+    if (!stream || (!text && length > 0)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        if (stream->state == RAC_STRUCTURED_OUTPUT_STREAM_COMPLETE ||
+            stream->state == RAC_STRUCTURED_OUTPUT_STREAM_ERROR) {
+            break;
+        }
+        stream->feed(text[i]);
+    }
+
+    if (out_state) {
+        *out_state = stream->state;
+    }
+    return RAC_SUCCESS;
+}
+
+extern "C" rac_result_t rac_structured_output_stream_get_json(rac_structured_output_stream_t stream,
+                                                              char** out_json) {
+    if (!stream || !out_json) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    *out_json = rac_strdup(stream->json.c_str());
+    return *out_json ? RAC_SUCCESS : RAC_ERROR_OUT_OF_MEMORY;
+}
+
+extern "C" void rac_structured_output_stream_reset(rac_structured_output_stream_t stream) {
+    if (stream) {
+        stream->reset();
+    }
+}
+
+extern "C" void rac_structured_output_stream_destroy(rac_structured_output_stream_t stream) {
+    delete stream;
+}
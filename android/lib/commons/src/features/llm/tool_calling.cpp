@@ -0,0 +1,431 @@
+/**
+ * @file tool_calling.cpp
+ * @brief LLM tool calling
+ *
+ * The detector sits between the component's token stream and the caller's
+ * callbacks. Prose passes through, except for a tail that could still turn
+ * into the opening tag, which is held back until the next token decides it.
+ * After the tag every byte goes to the incremental JSON parser, whose
+ * per-member callback sees "name" and then "arguments" complete; the call is
+ * dispatched right there and the token callback returns RAC_FALSE.
+ */
+
+#include "rac/features/llm/rac_llm_tools.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "rac/core/rac_logger.h"
+#include "rac/features/llm/rac_llm_structured_output.h"
+
+static const char* LOG_CAT = "LLM.Tools";
+
+static const char kCallOpen[] = "<tool_call>";
+static const size_t kCallOpenLength = sizeof(kCallOpen) - 1;
+
+struct rac_llm_toolset {
+    std::vector<std::string> names;
+    std::string auto_prompt;
+    std::string required_prompt;
+    std::string schema;
+};
+
+namespace {
+
+void append_json_string(std::string& out, const char* value) {
+    out += '"';
+    for (const char* p = value; *p != '\0'; ++p) {
+        const char c = *p;
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+const char* arguments_schema(const rac_llm_tool_t& tool) {
+    return tool.parameters_schema != nullptr && tool.parameters_schema[0] != '\0'
+               ? tool.parameters_schema
+               : "{\"type\": \"object\"}";
+}
+
+// Length of the longest tail of `text` that is a proper prefix of the tag
+size_t partial_tag_length(const std::string& text) {
+    const size_t max = std::min(text.size(), kCallOpenLength - 1);
+    for (size_t n = max; n > 0; --n) {
+        if (text.compare(text.size() - n, n, kCallOpen, n) == 0) {
+            return n;
+        }
+    }
+    return 0;
+}
+
+// =============================================================================
+// DETECTOR
+// =============================================================================
+
+struct ToolCallContext {
+    const rac_llm_toolset* toolset = nullptr;
+    rac_llm_component_token_callback_fn token_callback = nullptr;
+    rac_llm_tool_call_fn tool_call_callback = nullptr;
+    rac_llm_component_complete_callback_fn complete_callback = nullptr;
+    rac_llm_component_error_callback_fn error_callback = nullptr;
+    void* user_data = nullptr;
+
+    rac_structured_output_stream_t parser = nullptr;
+    bool in_call = false;
+    bool called = false;
+    bool stopped = false;  // caller's token callback returned RAC_FALSE
+    std::string held;      // prose that may be the start of the tag
+    std::string name;
+    std::string arguments;
+    rac_result_t failure = RAC_SUCCESS;
+    std::string failure_message;
+
+    int32_t prompt_tokens = 0;
+    int32_t tokens = 0;
+    std::chrono::steady_clock::time_point start;
+    int64_t first_token_ms = 0;
+
+    void fail(rac_result_t code, const char* message) {
+        if (failure == RAC_SUCCESS) {
+            failure = code;
+            failure_message = message;
+            RAC_LOG_ERROR(LOG_CAT, "%s", message);
+        }
+    }
+
+    void emit_prose(const char* text, size_t length) {
+        if (length == 0 || stopped || token_callback == nullptr) {
+            return;
+        }
+        const std::string chunk(text, length);
+        if (token_callback(chunk.c_str(), user_data) != RAC_TRUE) {
+            stopped = true;
+        }
+    }
+
+    bool known_tool(const std::string& candidate) const {
+        for (const auto& tool : toolset->names) {
+            if (tool == candidate) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void dispatch() {
+        called = true;
+        if (!known_tool(name)) {
+            fail(RAC_ERROR_INVALID_FORMAT, ("Call to unknown tool: " + name).c_str());
+            return;
+        }
+        RAC_LOG_INFO(LOG_CAT, "Tool call: %s", name.c_str());
+        if (tool_call_callback) {
+            tool_call_callback(name.c_str(), arguments.c_str(), user_data);
+        }
+    }
+
+    void feed_call(const char* text, size_t length) {
+        rac_structured_output_stream_state_t state = RAC_STRUCTURED_OUTPUT_STREAM_SEARCHING;
+        rac_structured_output_stream_feed(parser, text, length, &state);
+        if (called) {
+            return;
+        }
+        if (state == RAC_STRUCTURED_OUTPUT_STREAM_ERROR) {
+            fail(RAC_ERROR_INVALID_FORMAT, "Tool call is not valid JSON");
+        } else if (state == RAC_STRUCTURED_OUTPUT_STREAM_COMPLETE) {
+            fail(RAC_ERROR_INVALID_FORMAT, "Tool call without a name and arguments");
+        }
+    }
+
+    // Returns whether generation should continue
+    bool feed(const char* token) {
+        if (called || failure != RAC_SUCCESS || token == nullptr) {
+            return false;
+        }
+        if (in_call) {
+            feed_call(token, strlen(token));
+        } else {
+            held += token;
+            const size_t tag = held.find(kCallOpen);
+            if (tag != std::string::npos) {
+                emit_prose(held.data(), tag);
+                in_call = true;
+                const std::string rest = held.substr(tag + kCallOpenLength);
+                held.clear();
+                feed_call(rest.data(), rest.size());
+            } else {
+                const size_t keep = partial_tag_length(held);
+                emit_prose(held.data(), held.size() - keep);
+                held.erase(0, held.size() - keep);
+            }
+        }
+        return !called && failure == RAC_SUCCESS && !stopped;
+    }
+
+    static void on_field(const char* key, const char* value_json, void* user_data) {
+        auto* ctx = static_cast<ToolCallContext*>(user_data);
+        if (ctx->called) {
+            return;
+        }
+        if (strcmp(key, "name") == 0) {
+            const size_t length = strlen(value_json);
+            if (length < 2 || value_json[0] != '"' || value_json[length - 1] != '"') {
+                ctx->fail(RAC_ERROR_INVALID_FORMAT, "Tool name is not a string");
+                return;
+            }
+            ctx->name.assign(value_json + 1, length - 2);
+        } else if (strcmp(key, "arguments") == 0 || strcmp(key, "parameters") == 0) {
+            ctx->arguments = value_json;
+        } else {
+            return;
+        }
+        if (!ctx->name.empty() && !ctx->arguments.empty() && ctx->failure == RAC_SUCCESS) {
+            ctx->dispatch();
+        }
+    }
+
+    // Metrics up to the tool call; the component reports a stop requested by
+    // the token callback as a failed generation, so the call path builds its
+    // own result
+    void complete() {
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        rac_llm_result_t result = {};
+        result.prompt_tokens = prompt_tokens;
+        result.completion_tokens = tokens;
+        result.total_tokens = prompt_tokens + tokens;
+        result.time_to_first_token_ms = first_token_ms;
+        result.total_time_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+        if (result.total_time_ms > 0) {
+            result.tokens_per_second =
+                static_cast<float>(tokens) * 1000.0f / static_cast<float>(result.total_time_ms);
+        }
+        if (complete_callback) {
+            complete_callback(&result, user_data);
+        }
+    }
+};
+
+rac_bool_t tools_token_callback(const char* token, void* user_data) {
+    auto* ctx = static_cast<ToolCallContext*>(user_data);
+    if (ctx->called || ctx->failure != RAC_SUCCESS) {
+        return RAC_FALSE;
+    }
+    if (ctx->tokens++ == 0) {
+        ctx->first_token_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  std::chrono::steady_clock::now() - ctx->start)
+                                  .count();
+    }
+    return ctx->feed(token) ? RAC_TRUE : RAC_FALSE;
+}
+
+void tools_complete_callback(const rac_llm_result_t* result, void* user_data) {
+    auto* ctx = static_cast<ToolCallContext*>(user_data);
+    if (ctx->called || ctx->failure != RAC_SUCCESS) {
+        return;
+    }
+    if (ctx->in_call) {
+        ctx->fail(RAC_ERROR_INVALID_FORMAT, "Generation ended inside a tool call");
+        return;
+    }
+    ctx->emit_prose(ctx->held.data(), ctx->held.size());
+    ctx->held.clear();
+    if (ctx->complete_callback) {
+        ctx->complete_callback(result, ctx->user_data);
+    }
+}
+
+void tools_error_callback(rac_result_t error_code, const char* error_message, void* user_data) {
+    auto* ctx = static_cast<ToolCallContext*>(user_data);
+    // The stop that follows a tool call or a detector failure is not an error
+    if (ctx->called || ctx->failure != RAC_SUCCESS) {
+        return;
+    }
+    if (ctx->error_callback) {
+        ctx->error_callback(error_code, error_message, ctx->user_data);
+    }
+}
+
+}  // namespace
+
+// =============================================================================
+// TOOLSET API
+// =============================================================================
+
+extern "C" rac_result_t rac_llm_toolset_create(const rac_llm_tool_t* tools, size_t num_tools,
+                                               rac_llm_toolset_t* out_toolset) {
+    if (!tools || num_tools == 0 || !out_toolset) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto* toolset = new (std::nothrow) rac_llm_toolset();
+    if (!toolset) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+
+    std::string listing = "You can call these tools:\n";
+    std::string alternatives;
+    for (size_t i = 0; i < num_tools; ++i) {
+        const rac_llm_tool_t& tool = tools[i];
+        if (tool.name == nullptr || tool.name[0] == '\0') {
+            delete toolset;
+            return RAC_ERROR_INVALID_ARGUMENT;
+        }
+        for (const auto& name : toolset->names) {
+            if (name == tool.name) {
+                RAC_LOG_ERROR(LOG_CAT, "Tool registered twice: %s", tool.name);
+                delete toolset;
+                return RAC_ERROR_INVALID_ARGUMENT;
+            }
+        }
+        toolset->names.push_back(tool.name);
+
+        listing += "{\"name\": ";
+        append_json_string(listing, tool.name);
+        if (tool.description != nullptr && tool.description[0] != '\0') {
+            listing += ", \"description\": ";
+            append_json_string(listing, tool.description);
+        }
+        listing += ", \"parameters\": ";
+        listing += arguments_schema(tool);
+        listing += "}\n";
+
+        if (!alternatives.empty()) {
+            alternatives += ", ";
+        }
+        alternatives += "{\"type\": \"object\", \"properties\": {\"name\": {\"const\": ";
+        append_json_string(alternatives, tool.name);
+        alternatives += "}, \"arguments\": ";
+        alternatives += arguments_schema(tool);
+        alternatives += "}, \"required\": [\"name\", \"arguments\"], "
+                        "\"additionalProperties\": false}";
+    }
+
+    toolset->auto_prompt = listing +
+                           "\nTo call a tool, reply with only:\n"
+                           "<tool_call>{\"name\": \"<tool name>\", \"arguments\": "
+                           "<arguments object>}</tool_call>\n"
+                           "If no tool is needed, reply normally.\n\n";
+    toolset->required_prompt = listing +
+                               "\nReply with only a JSON object naming the tool to call:\n"
+                               "{\"name\": \"<tool name>\", \"arguments\": "
+                               "<arguments object>}\n\n";
+    toolset->schema = num_tools == 1 ? alternatives : "{\"oneOf\": [" + alternatives + "]}";
+
+    RAC_LOG_DEBUG(LOG_CAT, "Registered %zu tools", num_tools);
+    *out_toolset = toolset;
+    return RAC_SUCCESS;
+}
+
+extern "C" const char* rac_llm_toolset_get_prompt(rac_llm_toolset_t toolset,
+                                                  rac_llm_tool_choice_t choice) {
+    if (!toolset) {
+        return nullptr;
+    }
+    return choice == RAC_LLM_TOOL_CHOICE_REQUIRED ? toolset->required_prompt.c_str()
+                                                  : toolset->auto_prompt.c_str();
+}
+
+extern "C" const char* rac_llm_toolset_get_schema(rac_llm_toolset_t toolset) {
+    return toolset ? toolset->schema.c_str() : nullptr;
+}
+
+extern "C" void rac_llm_toolset_destroy(rac_llm_toolset_t toolset) {
+    delete toolset;
+}
+
+// =============================================================================
+// GENERATION API
+// =============================================================================
+
+extern "C" rac_result_t rac_llm_component_generate_with_tools(
+    rac_handle_t handle, rac_llm_toolset_t toolset, const char* prompt,
+    const rac_llm_options_t* options, rac_llm_tool_choice_t choice,
+    rac_llm_component_token_callback_fn token_callback,
+    rac_llm_tool_call_fn tool_call_callback,
+    rac_llm_component_complete_callback_fn complete_callback,
+    rac_llm_component_error_callback_fn error_callback, void* user_data) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!toolset || !prompt)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    ToolCallContext ctx;
+    ctx.toolset = toolset;
+    ctx.token_callback = token_callback;
+    ctx.tool_call_callback = tool_call_callback;
+    ctx.complete_callback = complete_callback;
+    ctx.error_callback = error_callback;
+    ctx.user_data = user_data;
+    // A required call has no tag: the constrained output is the JSON itself
+    ctx.in_call = choice == RAC_LLM_TOOL_CHOICE_REQUIRED;
+
+    rac_result_t result =
+        rac_structured_output_stream_create(ToolCallContext::on_field, &ctx, &ctx.parser);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+
+    const std::string full_prompt = rac_llm_toolset_get_prompt(toolset, choice) +
+                                    std::string(prompt);
+
+    // NULL options keep the component defaults; only a required call needs
+    // its own copy, to carry the schema
+    rac_llm_options_t required_options = RAC_LLM_OPTIONS_DEFAULT;
+    const rac_llm_options_t* effective_options = options;
+    if (choice == RAC_LLM_TOOL_CHOICE_REQUIRED) {
+        if (options) {
+            required_options = *options;
+        }
+        required_options.json_schema = toolset->schema.c_str();
+        effective_options = &required_options;
+    }
+
+    rac_llm_component_count_tokens(handle, full_prompt.c_str(), &ctx.prompt_tokens);
+    ctx.start = std::chrono::steady_clock::now();
+    result = rac_llm_component_generate_stream(handle, full_prompt.c_str(), effective_options,
+                                               tools_token_callback, tools_complete_callback,
+                                               tools_error_callback, &ctx);
+    rac_structured_output_stream_destroy(ctx.parser);
+
+    if (ctx.failure != RAC_SUCCESS) {
+        if (error_callback) {
+            error_callback(ctx.failure, ctx.failure_message.c_str(), user_data);
+        }
+        return ctx.failure;
+    }
+    if (ctx.called) {
+        ctx.complete();
+        return RAC_SUCCESS;
+    }
+    return result;
+}
@@ -0,0 +1,526 @@
+/**
+ * @file vector_index.cpp
+ * @brief RunAnywhere Commons - On-Device Vector Index Implementation
+ *
+ * File layout: a 64-byte header followed by fixed-size records of a 64-bit id
+ * and `dimension` floats. The file grows in doubling steps so appends write
+ * straight into the mapping; the header count is updated after the records,
+ * so an interrupted append is dropped on the next open.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "rac/core/rac_logger.h"
+#include "rac/features/llm/rac_llm_vector_index.h"
+#include "rac/infrastructure/model_management/rac_model_paths.h"
+
+static const char* LOG_CAT = "VectorIndex";
+
+// =============================================================================
+// FILE FORMAT
+// =============================================================================
+
+namespace {
+
+constexpr char kMagic[8] = {'R', 'A', 'C', 'V', 'I', 'D', 'X', '1'};
+constexpr uint32_t kVersion = 1;
+constexpr uint64_t kInitialCapacity = 1024;
+
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t dimension;
+    uint64_t count;
+    uint64_t capacity;
+    uint8_t reserved[32];
+};
+static_assert(sizeof(IndexHeader) == 64, "index header must stay 64 bytes");
+
+// IVF sizing: about sqrt(n) lists, trained on a sample of this many points per list
+constexpr size_t kMinLists = 16;
+constexpr size_t kMaxLists = 1024;
+constexpr size_t kTrainPointsPerList = 64;
+constexpr int kTrainIterations = 8;
+
+float dot(const float* a, const float* b, size_t n) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+#else
+    // Independent accumulators let the compiler vectorize the loop
+    float acc[8] = {};
+    for (; i + 8 <= n; i += 8) {
+        for (size_t j = 0; j < 8; j++) {
+            acc[j] += a[i + j] * b[i + j];
+        }
+    }
+    float sum = ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+#endif
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void normalize(float* v, size_t n) {
+    const float norm = std::sqrt(dot(v, v, n));
+    if (norm > 0.0f) {
+        for (size_t i = 0; i < n; i++) {
+            v[i] /= norm;
+        }
+    }
+}
+
+// Keeps the k best matches seen so far; the worst sits at the heap top
+class TopK {
+   public:
+    explicit TopK(size_t k) : k_(k) { heap_.reserve(k); }
+
+    void push(uint64_t id, float score) {
+        if (heap_.size() < k_) {
+            heap_.push_back({id, score});
+            std::push_heap(heap_.begin(), heap_.end(), worse_first);
+        } else if (k_ > 0 && score > heap_.front().score) {
+            std::pop_heap(heap_.begin(), heap_.end(), worse_first);
+            heap_.back() = {id, score};
+            std::push_heap(heap_.begin(), heap_.end(), worse_first);
+        }
+    }
+
+    size_t write(rac_vector_match_t* out) {
+        std::sort_heap(heap_.begin(), heap_.end(), worse_first);
+        std::copy(heap_.begin(), heap_.end(), out);
+        return heap_.size();
+    }
+
+   private:
+    static bool worse_first(const rac_vector_match_t& a, const rac_vector_match_t& b) {
+        return a.score > b.score;
+    }
+
+    size_t k_;
+    std::vector<rac_vector_match_t> heap_;
+};
+
+}  // namespace
+
+// =============================================================================
+// INTERNAL STRUCTURE
+// =============================================================================
+
+struct rac_vector_index {
+    rac_vector_index_config_t config{};
+    std::string path{};
+    int fd{-1};
+    uint8_t* map{nullptr};
+    size_t map_size{0};
+    size_t dim{0};
+    size_t record_size{0};
+
+    // IVF partition over records [0, ivf_trained), plus records added since
+    std::vector<float> centroids{};
+    std::vector<std::vector<uint32_t>> lists{};
+    size_t ivf_trained{0};
+
+    std::mutex mutex{};
+
+    IndexHeader* header() const { return reinterpret_cast<IndexHeader*>(map); }
+    size_t count() const { return static_cast<size_t>(header()->count); }
+    uint8_t* record(size_t i) const { return map + sizeof(IndexHeader) + i * record_size; }
+    uint64_t id_at(size_t i) const {
+        uint64_t id;
+        memcpy(&id, record(i), sizeof(id));
+        return id;
+    }
+    const float* vector_at(size_t i) const {
+        return reinterpret_cast<const float*>(record(i) + sizeof(uint64_t));
+    }
+
+    size_t file_size(uint64_t capacity) const {
+        return sizeof(IndexHeader) + static_cast<size_t>(capacity) * record_size;
+    }
+
+    // Most records a file can hold before its size overflows size_t or off_t
+    uint64_t max_capacity() const {
+        const uint64_t max_size = std::min<uint64_t>(
+            std::numeric_limits<size_t>::max(),
+            static_cast<uint64_t>(std::numeric_limits<off_t>::max()));
+        return (max_size - sizeof(IndexHeader)) / record_size;
+    }
+
+    bool map_file(size_t size) {
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            RAC_LOG_ERROR(LOG_CAT, "mmap of %zu bytes failed for %s: %s", size, path.c_str(),
+                          strerror(errno));
+            return false;
+        }
+        map = static_cast<uint8_t*>(addr);
+        map_size = size;
+        return true;
+    }
+
+    void unmap() {
+        if (map) {
+            munmap(map, map_size);
+            map = nullptr;
+            map_size = 0;
+        }
+    }
+
+    bool grow(size_t needed) {
+        uint64_t capacity = header()->capacity;
+        while (capacity < needed) {
+            if (capacity > max_capacity() / 2) {
+                RAC_LOG_ERROR(LOG_CAT, "%s cannot hold %zu records", path.c_str(), needed);
+                return false;
+            }
+            capacity *= 2;
+        }
+        const size_t size = file_size(capacity);
+        unmap();
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0 || !map_file(size)) {
+            RAC_LOG_ERROR(LOG_CAT, "Failed to grow %s to %llu records", path.c_str(),
+                          static_cast<unsigned long long>(capacity));
+            return false;
+        }
+        header()->capacity = capacity;
+        return true;
+    }
+
+    size_t nearest_list(const float* v) const {
+        size_t best = 0;
+        float best_score = -INFINITY;
+        for (size_t c = 0; c < lists.size(); c++) {
+            const float score = dot(v, centroids.data() + c * dim, dim);
+            if (score > best_score) {
+                best_score = score;
+                best = c;
+            }
+        }
+        return best;
+    }
+
+    void train_ivf();
+};
+
+// Spherical k-means on a strided sample, then every record is assigned to its
+// closest centroid
+void rac_vector_index::train_ivf() {
+    const size_t n = count();
+    const size_t n_lists =
+        std::min(std::max(static_cast<size_t>(std::sqrt(static_cast<double>(n))), kMinLists),
+                 std::min(kMaxLists, n));
+    const size_t n_train = std::min(n, n_lists * kTrainPointsPerList);
+    const size_t stride = n / n_train;
+
+    lists.assign(n_lists, {});
+    centroids.resize(n_lists * dim);
+    for (size_t c = 0; c < n_lists; c++) {
+        memcpy(&centroids[c * dim], vector_at(c * (n / n_lists)), dim * sizeof(float));
+    }
+
+    std::vector<float> sums(n_lists * dim);
+    std::vector<size_t> sizes(n_lists);
+    for (int iter = 0; iter < kTrainIterations; iter++) {
+        std::fill(sums.begin(), sums.end(), 0.0f);
+        std::fill(sizes.begin(), sizes.end(), 0);
+        for (size_t t = 0; t < n_train; t++) {
+            const float* v = vector_at(t * stride);
+            const size_t c = nearest_list(v);
+            float* sum = &sums[c * dim];
+            for (size_t i = 0; i < dim; i++) {
+                sum[i] += v[i];
+            }
+            sizes[c]++;
+        }
+        for (size_t c = 0; c < n_lists; c++) {
+            // Empty lists keep their previous centroid
+            if (sizes[c] > 0) {
+                memcpy(&centroids[c * dim], &sums[c * dim], dim * sizeof(float));
+                normalize(&centroids[c * dim], dim);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        lists[nearest_list(vector_at(i))].push_back(static_cast<uint32_t>(i));
+    }
+    ivf_trained = n;
+    RAC_LOG_INFO(LOG_CAT, "Trained IVF over %zu vectors: %zu lists", n, n_lists);
+}
+
+// =============================================================================
+// HELPERS
+// =============================================================================
+
+static rac_result_t resolve_path(const char* name, std::string& out_path) {
+    if (name[0] == '/') {
+        out_path = name;
+        return RAC_SUCCESS;
+    }
+
+    char base[1024];
+    rac_result_t result = rac_model_paths_get_base_directory(base, sizeof(base));
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+    std::string dir = std::string(base) + "/Indexes";
+    mkdir(base, 0755);
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        RAC_LOG_ERROR(LOG_CAT, "Cannot create %s: %s", dir.c_str(), strerror(errno));
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+    out_path = dir + "/" + name + ".rvi";
+    return RAC_SUCCESS;
+}
+
+static void close_index(rac_vector_index* index) {
+    if (index->map) {
+        msync(index->map, index->map_size, MS_SYNC);
+    }
+    index->unmap();
+    if (index->fd >= 0) {
+        close(index->fd);
+    }
+    delete index;
+}
+
+// =============================================================================
+// VECTOR INDEX API
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_vector_index_open(const char* name, const rac_vector_index_config_t* config,
+                                   rac_vector_index_handle_t* out_handle) {
+    if (!name || name[0] == '\0' || !out_handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto* index = new rac_vector_index();
+    index->config = config ? *config : RAC_VECTOR_INDEX_CONFIG_DEFAULT;
+
+    rac_result_t result = resolve_path(name, index->path);
+    if (result != RAC_SUCCESS) {
+        delete index;
+        return result;
+    }
+
+    index->fd = open(index->path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (index->fd < 0) {
+        RAC_LOG_ERROR(LOG_CAT, "Cannot open %s: %s", index->path.c_str(), strerror(errno));
+        delete index;
+        return RAC_ERROR_FILE_READ_FAILED;
+    }
+
+    struct stat st = {};
+    fstat(index->fd, &st);
+    if (st.st_size == 0) {
+        // New index
+        if (index->config.dimension <= 0) {
+            close_index(index);
+            return RAC_ERROR_INVALID_ARGUMENT;
+        }
+        index->dim = static_cast<size_t>(index->config.dimension);
+        index->record_size = sizeof(uint64_t) + index->dim * sizeof(float);
+        const size_t size = index->file_size(kInitialCapacity);
+        if (ftruncate(index->fd, static_cast<off_t>(size)) != 0 || !index->map_file(size)) {
+            close_index(index);
+            return RAC_ERROR_FILE_WRITE_FAILED;
+        }
+        IndexHeader* header = index->header();
+        memcpy(header->magic, kMagic, sizeof(kMagic));
+        header->version = kVersion;
+        header->dimension = static_cast<uint32_t>(index->dim);
+        header->count = 0;
+        header->capacity = kInitialCapacity;
+    } else {
+        IndexHeader header = {};
+        if (static_cast<size_t>(st.st_size) < sizeof(header) ||
+            pread(index->fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+            RAC_LOG_ERROR(LOG_CAT, "%s is not a vector index", index->path.c_str());
+            close_index(index);
+            return RAC_ERROR_INVALID_FORMAT;
+        }
+        if (index->config.dimension > 0 &&
+            static_cast<uint32_t>(index->config.dimension) != header.dimension) {
+            RAC_LOG_ERROR(LOG_CAT, "%s holds %u-dim vectors, %d requested", index->path.c_str(),
+                          header.dimension, index->config.dimension);
+            close_index(index);
+            return RAC_ERROR_INVALID_ARGUMENT;
+        }
+        // Every size below derives from the header, so it is checked first
+        const size_t max_dim =
+            (std::numeric_limits<size_t>::max() - sizeof(uint64_t)) / sizeof(float);
+        if (header.dimension == 0 || header.dimension > max_dim) {
+            RAC_LOG_ERROR(LOG_CAT, "%s has an invalid dimension %u", index->path.c_str(),
+                          header.dimension);
+            close_index(index);
+            return RAC_ERROR_INVALID_FORMAT;
+        }
+        index->dim = header.dimension;
+        index->record_size = sizeof(uint64_t) + index->dim * sizeof(float);
+        if (header.capacity == 0 || header.capacity > index->max_capacity() ||
+            static_cast<size_t>(st.st_size) < index->file_size(header.capacity) ||
+            header.count > header.capacity) {
+            RAC_LOG_ERROR(LOG_CAT, "%s is truncated or corrupt", index->path.c_str());
+            close_index(index);
+            return RAC_ERROR_INVALID_FORMAT;
+        }
+        if (!index->map_file(index->file_size(header.capacity))) {
+            close_index(index);
+            return RAC_ERROR_FILE_READ_FAILED;
+        }
+    }
+
+    index->config.dimension = static_cast<int32_t>(index->dim);
+    index->config.ivf_nprobe = std::max(1, index->config.ivf_nprobe);
+    if (index->config.ivf_threshold > 0 &&
+        index->count() >= static_cast<size_t>(index->config.ivf_threshold)) {
+        index->train_ivf();
+    }
+
+    RAC_LOG_INFO(LOG_CAT, "Opened %s: %zu vectors of dim %zu", index->path.c_str(),
+                 index->count(), index->dim);
+    *out_handle = index;
+    return RAC_SUCCESS;
+}
+
+void rac_vector_index_close(rac_vector_index_handle_t handle) {
+    if (handle) {
+        close_index(handle);
+    }
+}
+
+rac_result_t rac_vector_index_add(rac_vector_index_handle_t handle, const uint64_t* ids,
+                                  const float* vectors, size_t count) {
+    if (!handle || (count > 0 && (!ids || !vectors))) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    const size_t first = handle->count();
+    if (first + count > handle->header()->capacity && !handle->grow(first + count)) {
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t* record = handle->record(first + i);
+        memcpy(record, &ids[i], sizeof(uint64_t));
+        memcpy(record + sizeof(uint64_t), vectors + i * handle->dim, handle->dim * sizeof(float));
+    }
+    // Publish the records only once they are written
+    handle->header()->count = first + count;
+
+    const size_t n = first + count;
+    const size_t threshold = static_cast<size_t>(std::max(0, handle->config.ivf_threshold));
+    if (threshold > 0 && n >= threshold &&
+        (handle->ivf_trained == 0 || n >= 2 * handle->ivf_trained)) {
+        handle->train_ivf();
+    } else if (handle->ivf_trained > 0) {
+        for (size_t i = first; i < n; i++) {
+            handle->lists[handle->nearest_list(handle->vector_at(i))].push_back(
+                static_cast<uint32_t>(i));
+        }
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_vector_index_search(rac_vector_index_handle_t handle, const float* query,
+                                     size_t k, rac_vector_match_t* out_matches,
+                                     size_t* out_count) {
+    if (!handle || !query || !out_count || (k > 0 && !out_matches)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    const size_t dim = handle->dim;
+    TopK top(k);
+
+    if (handle->ivf_trained == 0) {
+        const size_t n = handle->count();
+        for (size_t i = 0; i < n; i++) {
+            top.push(handle->id_at(i), dot(query, handle->vector_at(i), dim));
+        }
+    } else {
+        // Rank the lists by centroid score and scan the best nprobe
+        const size_t n_lists = handle->lists.size();
+        std::vector<std::pair<float, size_t>> ranked(n_lists);
+        for (size_t c = 0; c < n_lists; c++) {
+            ranked[c] = {dot(query, handle->centroids.data() + c * dim, dim), c};
+        }
+        const size_t n_probe = std::min(n_lists, static_cast<size_t>(handle->config.ivf_nprobe));
+        std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(n_probe),
+                          ranked.end(),
+                          [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (size_t p = 0; p < n_probe; p++) {
+            for (uint32_t i : handle->lists[ranked[p].second]) {
+                top.push(handle->id_at(i), dot(query, handle->vector_at(i), dim));
+            }
+        }
+    }
+
+    *out_count = top.write(out_matches);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_vector_index_get_count(rac_vector_index_handle_t handle, size_t* out_count) {
+    if (!handle || !out_count) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    *out_count = handle->count();
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_vector_index_get_dimension(rac_vector_index_handle_t handle,
+                                            int32_t* out_dimension) {
+    if (!handle || !out_dimension) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    *out_dimension = static_cast<int32_t>(handle->dim);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_vector_index_flush(rac_vector_index_handle_t handle) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    if (msync(handle->map, handle->map_size, MS_SYNC) != 0) {
+        RAC_LOG_ERROR(LOG_CAT, "msync failed for %s: %s", handle->path.c_str(), strerror(errno));
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+    return RAC_SUCCESS;
+}
+
+}  // extern "C"
@@ -11,6 +11,7 @@
 #include <cstring>
 #include <mutex>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_core.h"
 #include "rac/core/rac_error.h"
 #include "rac/core/rac_logger.h"
@@ -88,18 +89,10 @@ static rac_result_t platform_llm_vtable_generate_stream(void* impl, const char*
         platform_options.max_tokens = 1000;
     }
 
-    // For Foundation Models, streaming is handled at Swift level
-    // We call generate and emit the response
+    // Swift calls the stream callback directly for each chunk
     auto handle = static_cast<rac_llm_platform_handle_t>(impl);
-    char* response = nullptr;
-    rac_result_t result = rac_llm_platform_generate(handle, prompt, &platform_options, &response);
-
-    if (result == RAC_SUCCESS && response) {
-        callback(response, user_data);
-        free(response);
-    }
-
-    return result;
+    return rac_llm_platform_generate_stream(handle, prompt, &platform_options, callback,
+                                            user_data);
 }
 
 // Get info
@@ -197,18 +190,36 @@ static rac_result_t platform_tts_vtable_synthesize(void* impl, const char* text,
     return result;
 }
 
-// Stream synthesis (System TTS handles streaming internally)
+// Stream synthesis (buffers from AVSpeechSynthesizer.write)
 static rac_result_t platform_tts_vtable_synthesize_stream(void* impl, const char* text,
                                                           const rac_tts_options_t* options,
                                                           rac_tts_stream_callback_t callback,
                                                           void* user_data) {
-    (void)callback;
-    (void)user_data;
+    if (!impl || !text || !callback)
+        return RAC_ERROR_NULL_POINTER;
+
+    RAC_LOG_DEBUG(LOG_CAT, "TTS synthesize_stream via Swift");
+
+    // Convert options
+    rac_tts_platform_options_t platform_options = {};
+    int32_t sample_rate = RAC_TTS_DEFAULT_SAMPLE_RATE;
+    if (options) {
+        platform_options.rate = options->rate;
+        platform_options.pitch = options->pitch;
+        platform_options.volume = options->volume;
+        platform_options.voice_id = options->voice;
+        sample_rate = options->sample_rate;
+    } else {
+        platform_options.rate = 1.0f;
+        platform_options.pitch = 1.0f;
+        platform_options.volume = 1.0f;
+    }
 
-    // System TTS doesn't support streaming to a callback - it plays directly
-    // Fall back to regular synthesis
-    rac_tts_result_t result = {};
-    return platform_tts_vtable_synthesize(impl, text, options, &result);
+    // Swift hands over each buffer AVSpeechSynthesizer renders, so the first
+    // chunk arrives as soon as the first one is ready
+    return rac_tts_platform_synthesize_stream(static_cast<rac_tts_platform_handle_t>(impl), text,
+                                              &platform_options, sample_rate, callback,
+                                              user_data);
 }
 
 // Stop
@@ -348,7 +359,8 @@ rac_handle_t platform_llm_create(const rac_service_request_t* request, void* use
     }
 
     // Allocate service struct with vtable
-    auto* service = static_cast<rac_llm_service_t*>(malloc(sizeof(rac_llm_service_t)));
+    auto* service = static_cast<rac_llm_service_t*>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, sizeof(rac_llm_service_t)));
     if (!service) {
         rac_llm_platform_destroy(static_cast<rac_llm_platform_handle_t>(backend_handle));
         return nullptr;
@@ -356,7 +368,9 @@ rac_handle_t platform_llm_create(const rac_service_request_t* request, void* use
 
     service->ops = &g_platform_llm_ops;
     service->impl = backend_handle;
-    service->model_id = request->identifier ? strdup(request->identifier) : nullptr;
+    service->model_id =
+        request->identifier ? rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, request->identifier)
+                            : nullptr;
 
     RAC_LOG_INFO(LOG_CAT, "Foundation Models LLM service created successfully");
     return service;
@@ -422,7 +436,8 @@ rac_handle_t platform_tts_create(const rac_service_request_t* request, void* use
     }
 
     // Allocate service struct with vtable
-    auto* service = static_cast<rac_tts_service_t*>(malloc(sizeof(rac_tts_service_t)));
+    auto* service = static_cast<rac_tts_service_t*>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, sizeof(rac_tts_service_t)));
     if (!service) {
         if (callbacks->destroy) {
             callbacks->destroy(backend_handle, callbacks->user_data);
@@ -432,7 +447,9 @@ rac_handle_t platform_tts_create(const rac_service_request_t* request, void* use
 
     service->ops = &g_platform_tts_ops;
     service->impl = backend_handle;
-    service->model_id = (request && request->identifier) ? strdup(request->identifier) : nullptr;
+    service->model_id = (request && request->identifier)
+                            ? rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, request->identifier)
+                            : nullptr;
 
     RAC_LOG_INFO(LOG_CAT, "System TTS service created successfully");
     return service;
@@ -450,13 +467,13 @@ void register_foundation_models_entry() {
     }
 
     rac_model_info_t model = {};
-    model.id = strdup("foundation-models-default");
-    model.name = strdup("Platform LLM");
+    model.id = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, "foundation-models-default");
+    model.name = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, "Platform LLM");
     model.category = RAC_MODEL_CATEGORY_LANGUAGE;
     model.format = RAC_MODEL_FORMAT_UNKNOWN;
     model.framework = RAC_FRAMEWORK_FOUNDATION_MODELS;
     model.download_url = nullptr;
-    model.local_path = strdup("builtin://foundation-models");
+    model.local_path = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, "builtin://foundation-models");
     model.artifact_info.kind = RAC_ARTIFACT_KIND_BUILT_IN;
     model.download_size = 0;
     model.memory_required = 0;
@@ -464,7 +481,7 @@ void register_foundation_models_entry() {
     model.supports_thinking = RAC_FALSE;
     model.tags = nullptr;
     model.tag_count = 0;
-    model.description = strdup(
+    model.description = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, 
         "Platform's built-in language model. "
         "Uses the device's native AI capabilities when available.");
     model.source = RAC_MODEL_SOURCE_LOCAL;
@@ -474,10 +491,10 @@ void register_foundation_models_entry() {
         RAC_LOG_INFO(LOG_CAT, "Registered built-in model: %s", model.id);
     }
 
-    free(model.id);
-    free(model.name);
-    free(model.local_path);
-    free(model.description);
+    rac_free(model.id);
+    rac_free(model.name);
+    rac_free(model.local_path);
+    rac_free(model.description);
 }
 
 void register_system_tts_entry() {
@@ -487,13 +504,13 @@ void register_system_tts_entry() {
     }
 
     rac_model_info_t model = {};
-    model.id = strdup("system-tts");
-    model.name = strdup("Platform TTS");
+    model.id = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, "system-tts");
+    model.name = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, "Platform TTS");
     model.category = RAC_MODEL_CATEGORY_SPEECH_SYNTHESIS;
     model.format = RAC_MODEL_FORMAT_UNKNOWN;
     model.framework = RAC_FRAMEWORK_SYSTEM_TTS;
     model.download_url = nullptr;
-    model.local_path = strdup("builtin://system-tts");
+    model.local_path = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, "builtin://system-tts");
     model.artifact_info.kind = RAC_ARTIFACT_KIND_BUILT_IN;
     model.download_size = 0;
     model.memory_required = 0;
@@ -501,7 +518,8 @@ void register_system_tts_entry() {
     model.supports_thinking = RAC_FALSE;
     model.tags = nullptr;
     model.tag_count = 0;
-    model.description = strdup("Platform's built-in Text-to-Speech using native synthesis.");
+    model.description = rac_strdup_tagged(
+        RAC_ALLOC_TAG_RESULT, "Platform's built-in Text-to-Speech using native synthesis.");
     model.source = RAC_MODEL_SOURCE_LOCAL;
 
     rac_result_t result = rac_model_registry_save(registry, &model);
@@ -509,10 +527,10 @@ void register_system_tts_entry() {
         RAC_LOG_INFO(LOG_CAT, "Registered built-in model: %s", model.id);
     }
 
-    free(model.id);
-    free(model.name);
-    free(model.local_path);
-    free(model.description);
+    rac_free(model.id);
+    rac_free(model.name);
+    rac_free(model.local_path);
+    rac_free(model.description);
 }
 
 }  // namespace
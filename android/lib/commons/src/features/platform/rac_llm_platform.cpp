@@ -4,13 +4,21 @@
  *
  * C++ implementation of platform LLM API. This is a thin wrapper that
  * delegates all operations to Swift via registered callbacks.
+ *
+ * The callback table is immutable once published and read with one acquire
+ * load, so generation, and streaming in particular, never waits on a lock.
+ * Replaced tables are retired rather than freed: rac_platform_llm_get_callbacks
+ * hands out raw pointers, and a registration happens once or twice per process.
  */
 
 #include "rac/features/platform/rac_llm_platform.h"
 
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "rac/core/rac_error.h"
 #include "rac/core/rac_logger.h"
@@ -23,9 +31,22 @@ static const char* LOG_CAT = "Platform.LLM";
 
 namespace {
 
-std::mutex g_callbacks_mutex;
-rac_platform_llm_callbacks_t g_callbacks = {};
-bool g_callbacks_set = false;
+std::atomic<const rac_platform_llm_callbacks_t*> g_callbacks{nullptr};
+
+// Serializes registration only; owns every table ever published
+std::mutex g_registration_mutex;
+std::vector<std::unique_ptr<const rac_platform_llm_callbacks_t>> g_tables;
+
+const rac_platform_llm_callbacks_t* callbacks() {
+    return g_callbacks.load(std::memory_order_acquire);
+}
+
+rac_llm_platform_options_t default_options() {
+    rac_llm_platform_options_t options = {};
+    options.temperature = 0.7f;
+    options.max_tokens = 1000;
+    return options;
+}
 
 }  // namespace
 
@@ -40,27 +61,22 @@ rac_result_t rac_platform_llm_set_callbacks(const rac_platform_llm_callbacks_t*
         return RAC_ERROR_INVALID_PARAMETER;
     }
 
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    g_callbacks = *callbacks;
-    g_callbacks_set = true;
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
+    g_tables.emplace_back(new rac_platform_llm_callbacks_t(*callbacks));
+    g_callbacks.store(g_tables.back().get(), std::memory_order_release);
 
     RAC_LOG_INFO(LOG_CAT, "Swift callbacks registered for platform LLM");
     return RAC_SUCCESS;
 }
 
 const rac_platform_llm_callbacks_t* rac_platform_llm_get_callbacks(void) {
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    if (!g_callbacks_set) {
-        return nullptr;
-    }
-    return &g_callbacks;
+    return callbacks();
 }
 
 rac_bool_t rac_platform_llm_is_available(void) {
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    return g_callbacks_set && g_callbacks.can_handle != nullptr && g_callbacks.create != nullptr
-               ? RAC_TRUE
-               : RAC_FALSE;
+    const rac_platform_llm_callbacks_t* cb = callbacks();
+    return cb != nullptr && cb->can_handle != nullptr && cb->create != nullptr ? RAC_TRUE
+                                                                               : RAC_FALSE;
 }
 
 // =============================================================================
@@ -76,15 +92,15 @@ rac_result_t rac_llm_platform_create(const char* model_path,
 
     *out_handle = nullptr;
 
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    if (!g_callbacks_set || g_callbacks.create == nullptr) {
+    const rac_platform_llm_callbacks_t* cb = callbacks();
+    if (cb == nullptr || cb->create == nullptr) {
         RAC_LOG_ERROR(LOG_CAT, "Swift callbacks not registered");
         return RAC_ERROR_NOT_INITIALIZED;
     }
 
     RAC_LOG_DEBUG(LOG_CAT, "Creating platform LLM via Swift");
 
-    rac_handle_t handle = g_callbacks.create(model_path, config, g_callbacks.user_data);
+    rac_handle_t handle = cb->create(model_path, config, cb->user_data);
     if (handle == nullptr) {
         RAC_LOG_ERROR(LOG_CAT, "Swift create callback returned null");
         return RAC_ERROR_INTERNAL;
@@ -100,14 +116,14 @@ void rac_llm_platform_destroy(rac_llm_platform_handle_t handle) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    if (!g_callbacks_set || g_callbacks.destroy == nullptr) {
+    const rac_platform_llm_callbacks_t* cb = callbacks();
+    if (cb == nullptr || cb->destroy == nullptr) {
         RAC_LOG_WARNING(LOG_CAT, "Cannot destroy: Swift callbacks not registered");
         return;
     }
 
     RAC_LOG_DEBUG(LOG_CAT, "Destroying platform LLM via Swift");
-    g_callbacks.destroy(handle, g_callbacks.user_data);
+    cb->destroy(handle, cb->user_data);
 }
 
 rac_result_t rac_llm_platform_generate(rac_llm_platform_handle_t handle, const char* prompt,
@@ -119,14 +135,52 @@ rac_result_t rac_llm_platform_generate(rac_llm_platform_handle_t handle, const c
 
     *out_response = nullptr;
 
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    if (!g_callbacks_set || g_callbacks.generate == nullptr) {
+    const rac_platform_llm_callbacks_t* cb = callbacks();
+    if (cb == nullptr || cb->generate == nullptr) {
         RAC_LOG_ERROR(LOG_CAT, "Swift callbacks not registered");
         return RAC_ERROR_NOT_INITIALIZED;
     }
 
     RAC_LOG_DEBUG(LOG_CAT, "Generating via platform LLM");
-    return g_callbacks.generate(handle, prompt, options, out_response, g_callbacks.user_data);
+    const rac_llm_platform_options_t defaults = default_options();
+    return cb->generate(handle, prompt, options ? options : &defaults, out_response,
+                        cb->user_data);
+}
+
+rac_result_t rac_llm_platform_generate_stream(rac_llm_platform_handle_t handle,
+                                              const char* prompt,
+                                              const rac_llm_platform_options_t* options,
+                                              rac_platform_llm_chunk_fn callback,
+                                              void* user_data) {
+    if (handle == nullptr || prompt == nullptr || callback == nullptr) {
+        return RAC_ERROR_INVALID_PARAMETER;
+    }
+
+    const rac_platform_llm_callbacks_t* cb = callbacks();
+    if (cb == nullptr || (cb->generate_stream == nullptr && cb->generate == nullptr)) {
+        RAC_LOG_ERROR(LOG_CAT, "Swift callbacks not registered");
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    const rac_llm_platform_options_t defaults = default_options();
+    if (options == nullptr) {
+        options = &defaults;
+    }
+
+    if (cb->generate_stream != nullptr) {
+        RAC_LOG_DEBUG(LOG_CAT, "Streaming via platform LLM");
+        return cb->generate_stream(handle, prompt, options, callback, user_data, cb->user_data);
+    }
+
+    // No streaming in Swift: deliver the whole response as one chunk
+    RAC_LOG_DEBUG(LOG_CAT, "Generating via platform LLM (single-chunk stream)");
+    char* response = nullptr;
+    rac_result_t result = cb->generate(handle, prompt, options, &response, cb->user_data);
+    if (result == RAC_SUCCESS && response != nullptr) {
+        callback(response, user_data);
+    }
+    free(response);
+    return result;
 }
 
 }  // extern "C"
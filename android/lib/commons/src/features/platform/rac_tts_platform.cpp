@@ -4,14 +4,22 @@
  *
  * C++ implementation of platform TTS API. This is a thin wrapper that
  * delegates all operations to Swift via registered callbacks.
+ *
+ * As with platform LLM, the callback table is immutable once published and
+ * read with one acquire load. No lock is held across a call into Swift, so
+ * rac_tts_platform_stop reaches the synthesizer while a stream is running.
  */
 
 #include "rac/features/platform/rac_tts_platform.h"
 
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <mutex>
+#include <vector>
 
+#include "rac/core/rac_audio_utils.h"
 #include "rac/core/rac_error.h"
 #include "rac/core/rac_logger.h"
 
@@ -23,9 +31,79 @@ static const char* LOG_CAT = "Platform.TTS";
 
 namespace {
 
-std::mutex g_callbacks_mutex;
-rac_platform_tts_callbacks_t g_callbacks = {};
-bool g_callbacks_set = false;
+std::atomic<const rac_platform_tts_callbacks_t*> g_callbacks{nullptr};
+
+// Serializes registration only; owns every table ever published
+std::mutex g_registration_mutex;
+std::vector<std::unique_ptr<const rac_platform_tts_callbacks_t>> g_tables;
+
+const rac_platform_tts_callbacks_t* callbacks() {
+    return g_callbacks.load(std::memory_order_acquire);
+}
+
+// =============================================================================
+// STREAM BRIDGE
+// =============================================================================
+
+// Forwards Swift audio buffers to a rac_tts_stream_callback_t. Buffers at
+// the output rate pass through untouched; others go through a resampler
+// created for the rate the voice actually renders at.
+struct StreamBridge {
+    rac_tts_stream_callback_t callback = nullptr;
+    void* user_data = nullptr;
+    int32_t output_rate = 0;
+    int32_t input_rate = 0;
+    rac_audio_resampler_t resampler = nullptr;
+    std::vector<float> scratch;
+
+    ~StreamBridge() {
+        if (resampler) {
+            rac_audio_resampler_destroy(resampler);
+        }
+    }
+};
+
+void bridge_audio(const float* samples, size_t sample_count, int32_t sample_rate, void* context) {
+    auto* bridge = static_cast<StreamBridge*>(context);
+    if (samples == nullptr || sample_count == 0) {
+        return;
+    }
+
+    if (bridge->output_rate <= 0 || sample_rate <= 0 || sample_rate == bridge->output_rate) {
+        bridge->callback(samples, sample_count * sizeof(float), bridge->user_data);
+        return;
+    }
+
+    if (sample_rate != bridge->input_rate) {
+        if (bridge->resampler) {
+            rac_audio_resampler_destroy(bridge->resampler);
+            bridge->resampler = nullptr;
+        }
+        bridge->input_rate = sample_rate;
+        if (rac_audio_resampler_create(sample_rate, bridge->output_rate, &bridge->resampler) !=
+            RAC_SUCCESS) {
+            RAC_LOG_WARNING(LOG_CAT, "Cannot resample %d Hz voice audio; passing it through",
+                            sample_rate);
+            bridge->resampler = nullptr;
+        } else {
+            RAC_LOG_DEBUG(LOG_CAT, "Resampling voice audio %d -> %d Hz", sample_rate,
+                          bridge->output_rate);
+        }
+    }
+    if (!bridge->resampler) {
+        bridge->callback(samples, sample_count * sizeof(float), bridge->user_data);
+        return;
+    }
+
+    bridge->scratch.resize(rac_audio_resampler_max_output(bridge->resampler, sample_count));
+    size_t written = 0;
+    if (rac_audio_resampler_process(bridge->resampler, samples, sample_count,
+                                    bridge->scratch.data(), bridge->scratch.size(),
+                                    &written) == RAC_SUCCESS &&
+        written > 0) {
+        bridge->callback(bridge->scratch.data(), written * sizeof(float), bridge->user_data);
+    }
+}
 
 }  // namespace
 
@@ -40,27 +118,22 @@ rac_result_t rac_platform_tts_set_callbacks(const rac_platform_tts_callbacks_t*
         return RAC_ERROR_INVALID_PARAMETER;
     }
 
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    g_callbacks = *callbacks;
-    g_callbacks_set = true;
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
+    g_tables.emplace_back(new rac_platform_tts_callbacks_t(*callbacks));
+    g_callbacks.store(g_tables.back().get(), std::memory_order_release);
 
     RAC_LOG_INFO(LOG_CAT, "Swift callbacks registered for platform TTS");
     return RAC_SUCCESS;
 }
 
 const rac_platform_tts_callbacks_t* rac_platform_tts_get_callbacks(void) {
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    if (!g_callbacks_set) {
-        return nullptr;
-    }
-    return &g_callbacks;
+    return callbacks();
 }
 
 rac_bool_t rac_platform_tts_is_available(void) {
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    return g_callbacks_set && g_callbacks.can_handle != nullptr && g_callbacks.create != nullptr
-               ? RAC_TRUE
-               : RAC_FALSE;
+    const rac_platform_tts_callbacks_t* cb = callbacks();
+    return cb != nullptr && cb->can_handle != nullptr && cb->create != nullptr ? RAC_TRUE
+                                                                               : RAC_FALSE;
 }
 
 // =============================================================================
@@ -75,15 +148,15 @@ rac_result_t rac_tts_platform_create(const rac_tts_platform_config_t* config,
 
     *out_handle = nullptr;
 
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    if (!g_callbacks_set || g_callbacks.create == nullptr) {
+    const rac_platform_tts_callbacks_t* cb = callbacks();
+    if (cb == nullptr || cb->create == nullptr) {
         RAC_LOG_ERROR(LOG_CAT, "Swift callbacks not registered");
         return RAC_ERROR_NOT_INITIALIZED;
     }
 
     RAC_LOG_DEBUG(LOG_CAT, "Creating platform TTS via Swift");
 
-    rac_handle_t handle = g_callbacks.create(config, g_callbacks.user_data);
+    rac_handle_t handle = cb->create(config, cb->user_data);
     if (handle == nullptr) {
         RAC_LOG_ERROR(LOG_CAT, "Swift create callback returned null");
         return RAC_ERROR_INTERNAL;
@@ -99,14 +172,14 @@ void rac_tts_platform_destroy(rac_tts_platform_handle_t handle) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    if (!g_callbacks_set || g_callbacks.destroy == nullptr) {
+    const rac_platform_tts_callbacks_t* cb = callbacks();
+    if (cb == nullptr || cb->destroy == nullptr) {
         RAC_LOG_WARNING(LOG_CAT, "Cannot destroy: Swift callbacks not registered");
         return;
     }
 
     RAC_LOG_DEBUG(LOG_CAT, "Destroying platform TTS via Swift");
-    g_callbacks.destroy(handle, g_callbacks.user_data);
+    cb->destroy(handle, cb->user_data);
 }
 
 rac_result_t rac_tts_platform_synthesize(rac_tts_platform_handle_t handle, const char* text,
@@ -115,14 +188,44 @@ rac_result_t rac_tts_platform_synthesize(rac_tts_platform_handle_t handle, const
         return RAC_ERROR_INVALID_PARAMETER;
     }
 
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    if (!g_callbacks_set || g_callbacks.synthesize == nullptr) {
+    const rac_platform_tts_callbacks_t* cb = callbacks();
+    if (cb == nullptr || cb->synthesize == nullptr) {
         RAC_LOG_ERROR(LOG_CAT, "Swift callbacks not registered");
         return RAC_ERROR_NOT_INITIALIZED;
     }
 
     RAC_LOG_DEBUG(LOG_CAT, "Synthesizing via platform TTS");
-    return g_callbacks.synthesize(handle, text, options, g_callbacks.user_data);
+    return cb->synthesize(handle, text, options, cb->user_data);
+}
+
+rac_result_t rac_tts_platform_synthesize_stream(rac_tts_platform_handle_t handle,
+                                                const char* text,
+                                                const rac_tts_platform_options_t* options,
+                                                int32_t sample_rate,
+                                                rac_tts_stream_callback_t callback,
+                                                void* user_data) {
+    if (handle == nullptr || text == nullptr || callback == nullptr) {
+        return RAC_ERROR_INVALID_PARAMETER;
+    }
+
+    const rac_platform_tts_callbacks_t* cb = callbacks();
+    if (cb == nullptr || (cb->synthesize_stream == nullptr && cb->synthesize == nullptr)) {
+        RAC_LOG_ERROR(LOG_CAT, "Swift callbacks not registered");
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    if (cb->synthesize_stream == nullptr) {
+        // No buffer access in Swift: speak it, as before streaming existed
+        RAC_LOG_DEBUG(LOG_CAT, "Streaming not supported by Swift; speaking directly");
+        return cb->synthesize(handle, text, options, cb->user_data);
+    }
+
+    RAC_LOG_DEBUG(LOG_CAT, "Streaming synthesis via platform TTS");
+    StreamBridge bridge;
+    bridge.callback = callback;
+    bridge.user_data = user_data;
+    bridge.output_rate = sample_rate;
+    return cb->synthesize_stream(handle, text, options, bridge_audio, &bridge, cb->user_data);
 }
 
 void rac_tts_platform_stop(rac_tts_platform_handle_t handle) {
@@ -130,14 +233,14 @@ void rac_tts_platform_stop(rac_tts_platform_handle_t handle) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(g_callbacks_mutex);
-    if (!g_callbacks_set || g_callbacks.stop == nullptr) {
+    const rac_platform_tts_callbacks_t* cb = callbacks();
+    if (cb == nullptr || cb->stop == nullptr) {
         RAC_LOG_WARNING(LOG_CAT, "Cannot stop: Swift callbacks not registered");
         return;
     }
 
     RAC_LOG_DEBUG(LOG_CAT, "Stopping platform TTS via Swift");
-    g_callbacks.stop(handle, g_callbacks.user_data);
+    cb->stop(handle, cb->user_data);
 }
 
 }  // extern "C"
@@ -17,7 +17,7 @@ extern "C" {
 __attribute__((weak)) void rac_llm_result_free(rac_llm_result_t* result) {
     if (result) {
         if (result->text) {
-            free(const_cast<char*>(result->text));
+            rac_free(const_cast<char*>(result->text));
             result->text = nullptr;
         }
     }
@@ -26,21 +26,21 @@ __attribute__((weak)) void rac_llm_result_free(rac_llm_result_t* result) {
 __attribute__((weak)) void rac_stt_result_free(rac_stt_result_t* result) {
     if (result) {
         if (result->text) {
-            free(const_cast<char*>(result->text));
+            rac_free(const_cast<char*>(result->text));
             result->text = nullptr;
         }
         if (result->detected_language) {
-            free(result->detected_language);
+            rac_free(result->detected_language);
             result->detected_language = nullptr;
         }
         if (result->words) {
             // Free individual word allocations
             for (size_t i = 0; i < result->num_words; i++) {
                 if (result->words[i].text) {
-                    free(const_cast<char*>(result->words[i].text));
+                    rac_free(const_cast<char*>(result->words[i].text));
                 }
             }
-            free(result->words);
+            rac_free(result->words);
             result->words = nullptr;
             result->num_words = 0;
         }
@@ -50,10 +50,16 @@ __attribute__((weak)) void rac_stt_result_free(rac_stt_result_t* result) {
 __attribute__((weak)) void rac_tts_result_free(rac_tts_result_t* result) {
     if (result) {
         if (result->audio_data) {
-            free(result->audio_data);
+            if (result->release_audio) {
+                result->release_audio(result->audio_data, result->release_context);
+            } else {
+                rac_free(result->audio_data);
+            }
             result->audio_data = nullptr;
         }
         result->audio_size = 0;
+        result->release_audio = nullptr;
+        result->release_context = nullptr;
     }
 }
 
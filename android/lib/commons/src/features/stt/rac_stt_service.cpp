@@ -132,20 +132,32 @@ void rac_stt_destroy(rac_handle_t handle) {
 
     // Free model_id if allocated
     if (service->model_id) {
-        free(const_cast<char*>(service->model_id));
+        rac_free(const_cast<char*>(service->model_id));
     }
 
     // Free service struct
-    free(service);
+    rac_free(service);
 }
 
 void rac_stt_result_free(rac_stt_result_t* result) {
     if (!result)
         return;
     if (result->text) {
-        free(result->text);
+        rac_free(result->text);
         result->text = nullptr;
     }
+    if (result->detected_language) {
+        rac_free(result->detected_language);
+        result->detected_language = nullptr;
+    }
+    if (result->words) {
+        for (size_t i = 0; i < result->num_words; i++) {
+            rac_free(const_cast<char*>(result->words[i].text));
+        }
+        rac_free(result->words);
+        result->words = nullptr;
+        result->num_words = 0;
+    }
 }
 
 }  // extern "C"
@@ -15,7 +15,9 @@
 #include <sstream>
 #include <string>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
+#include "rac/core/rac_metrics.h"
 #include "rac/features/stt/rac_stt_analytics.h"
 
 // =============================================================================
@@ -152,7 +154,8 @@ rac_result_t rac_stt_analytics_start_transcription(rac_stt_analytics_handle_t ha
 
     handle->active_transcriptions[id] = tracker;
 
-    *out_transcription_id = static_cast<char*>(malloc(id.size() + 1));
+    *out_transcription_id =
+        static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_TELEMETRY, id.size() + 1));
     if (!*out_transcription_id) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
@@ -219,6 +222,13 @@ rac_result_t rac_stt_analytics_complete_transcription(rac_stt_analytics_handle_t
     handle->last_event_time_ms = end_time_ms;
     handle->has_last_event_time = true;
 
+    static const rac::MetricCounter transcriptions("stt.transcriptions");
+    static const rac::MetricHistogram latency_ms("stt.latency_ms");
+    static const rac::MetricGauge real_time_factor_gauge("stt.real_time_factor");
+    transcriptions.add();
+    latency_ms.record(static_cast<int64_t>(processing_time_ms));
+    real_time_factor_gauge.set(real_time_factor);
+
     log_debug("STT.Analytics", "Transcription completed: %s, model: %s, RTF: %.3f",
               transcription_id, tracker.model_id.c_str(), real_time_factor);
 
@@ -17,7 +17,10 @@
 
 #include "rac/core/capabilities/rac_lifecycle.h"
 #include "rac/core/rac_analytics_events.h"
+#include "rac/core/rac_core.h"
 #include "rac/core/rac_logger.h"
+#include "rac/core/rac_memory_watermark.h"
+#include "rac/core/rac_metrics.h"
 #include "rac/core/rac_platform_adapter.h"
 #include "rac/core/rac_structured_error.h"
 #include "rac/features/stt/rac_stt_component.h"
@@ -88,6 +91,28 @@ static int32_t count_words(const char* text) {
     return count;
 }
 
+/**
+ * Publish one call's memory use to rac_metrics.
+ */
+static void record_memory(const rac_inference_memory_t& memory) {
+    static const rac::MetricHistogram peak_rss_mb("stt.peak_rss_mb");
+    static const rac::MetricGauge rss_delta_mb("stt.rss_delta_mb");
+    if (memory.peak_rss_bytes > 0) {
+        peak_rss_mb.record(memory.peak_rss_bytes >> 20);
+        rss_delta_mb.set(static_cast<double>(memory.rss_delta_bytes) / (1024.0 * 1024.0));
+    }
+}
+
+/**
+ * Copy a call's memory use into a completed transcription event.
+ */
+static void set_event_memory(rac_analytics_stt_transcription_t& event,
+                             const rac_inference_memory_t& memory) {
+    event.peak_rss_bytes = memory.peak_rss_bytes;
+    event.rss_delta_bytes = memory.rss_delta_bytes;
+    event.backend_memory_bytes = memory.backend_bytes;
+}
+
 // =============================================================================
 // LIFECYCLE CALLBACKS
 // =============================================================================
@@ -128,6 +153,26 @@ static void stt_destroy_service(rac_handle_t service, void* user_data) {
     }
 }
 
+/**
+ * Memory pressure stage for STT: unload the model if no transcription holds
+ * the component.
+ */
+static int64_t stt_memory_pressure_handler(rac_memory_pressure_stage_t stage, void* user_data) {
+    auto* component = static_cast<rac_stt_component*>(user_data);
+    if (stage != RAC_MEMORY_PRESSURE_STAGE_UNLOAD_IDLE) {
+        return 0;
+    }
+
+    std::unique_lock<std::mutex> lock(component->mtx, std::try_to_lock);
+    if (!lock.owns_lock() || !rac_lifecycle_is_loaded(component->lifecycle)) {
+        return 0;
+    }
+    const int64_t bytes = rac_lifecycle_get_resident_bytes(component->lifecycle);
+    log_info("STT.Component", "Unloading idle STT model under memory pressure");
+    rac_lifecycle_unload(component->lifecycle);
+    return bytes;
+}
+
 // =============================================================================
 // LIFECYCLE API
 // =============================================================================
@@ -155,6 +200,8 @@ extern "C" rac_result_t rac_stt_component_create(rac_handle_t* out_handle) {
         return result;
     }
 
+    rac_memory_pressure_register("STT.Component", stt_memory_pressure_handler, component);
+
     *out_handle = reinterpret_cast<rac_handle_t>(component);
 
     log_info("STT.Component", "STT component created");
@@ -208,6 +255,7 @@ extern "C" void rac_stt_component_destroy(rac_handle_t handle) {
         return;
 
     auto* component = reinterpret_cast<rac_stt_component*>(handle);
+    rac_memory_pressure_unregister(stt_memory_pressure_handler, component);
 
     if (component->lifecycle) {
         rac_lifecycle_destroy(component->lifecycle);
@@ -332,7 +380,11 @@ extern "C" rac_result_t rac_stt_component_transcribe(rac_handle_t handle, const
 
     auto start_time = std::chrono::steady_clock::now();
 
+    rac_memory_watermark_t watermark;
+    rac_memory_watermark_begin(&watermark);
     result = rac_stt_transcribe(service, audio_data, audio_size, effective_options, out_result);
+    rac_inference_memory_t memory;
+    rac_memory_watermark_end(&watermark, 0, &memory);
 
     if (result != RAC_SUCCESS) {
         log_error("STT.Component", "Transcription failed");
@@ -360,6 +412,8 @@ extern "C" rac_result_t rac_stt_component_transcribe(rac_handle_t handle, const
     if (out_result->processing_time_ms == 0) {
         out_result->processing_time_ms = duration.count();
     }
+    out_result->memory = memory;
+    record_memory(memory);
 
     // Calculate word count and real-time factor
     int32_t word_count = count_words(out_result->text);
@@ -387,12 +441,83 @@ extern "C" rac_result_t rac_stt_component_transcribe(rac_handle_t handle, const
         event.data.stt_transcription.framework =
             static_cast<rac_inference_framework_t>(component->config.preferred_framework);
         event.data.stt_transcription.error_code = RAC_SUCCESS;
+        set_event_memory(event.data.stt_transcription, memory);
         rac_analytics_event_emit(RAC_EVENT_STT_TRANSCRIPTION_COMPLETED, &event);
     }
 
     return RAC_SUCCESS;
 }
 
+extern "C" rac_result_t rac_stt_component_transcribe_file(rac_handle_t handle,
+                                                          const char* file_path,
+                                                          const rac_stt_options_t* options,
+                                                          rac_stt_result_t* out_result) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!file_path || !out_result)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* component = reinterpret_cast<rac_stt_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->mtx);
+
+    std::string transcription_id = generate_unique_id();
+    const char* model_id = rac_lifecycle_get_model_id(component->lifecycle);
+    const char* model_name = rac_lifecycle_get_model_name(component->lifecycle);
+
+    rac_handle_t service = nullptr;
+    rac_result_t result = rac_lifecycle_require_service(component->lifecycle, &service);
+    if (result != RAC_SUCCESS) {
+        log_error("STT.Component", "No model loaded - cannot transcribe file");
+        return result;
+    }
+
+    const rac_stt_options_t* effective_options = options ? options : &component->default_options;
+
+    log_info("STT.Component", "Transcribing file");
+
+    rac_memory_watermark_t watermark;
+    rac_memory_watermark_begin(&watermark);
+    result = rac_stt_transcribe_file(service, file_path, effective_options, 0, out_result);
+    rac_inference_memory_t memory;
+    rac_memory_watermark_end(&watermark, 0, &memory);
+
+    rac_analytics_event_data_t event = {};
+    event.data.stt_transcription = RAC_ANALYTICS_STT_TRANSCRIPTION_DEFAULT;
+    event.data.stt_transcription.transcription_id = transcription_id.c_str();
+    event.data.stt_transcription.model_id = model_id;
+    event.data.stt_transcription.model_name = model_name;
+    event.data.stt_transcription.language = effective_options->language;
+    event.data.stt_transcription.is_streaming = RAC_FALSE;
+    event.data.stt_transcription.framework =
+        static_cast<rac_inference_framework_t>(component->config.preferred_framework);
+
+    if (result != RAC_SUCCESS) {
+        log_error("STT.Component", "File transcription failed");
+        rac_lifecycle_track_error(component->lifecycle, result, "transcribe_file");
+
+        event.type = RAC_EVENT_STT_TRANSCRIPTION_FAILED;
+        event.data.stt_transcription.error_code = result;
+        event.data.stt_transcription.error_message = "File transcription failed";
+        rac_analytics_event_emit(RAC_EVENT_STT_TRANSCRIPTION_FAILED, &event);
+        return result;
+    }
+
+    out_result->memory = memory;
+    record_memory(memory);
+
+    event.type = RAC_EVENT_STT_TRANSCRIPTION_COMPLETED;
+    event.data.stt_transcription.text = out_result->text;
+    event.data.stt_transcription.confidence = out_result->confidence;
+    event.data.stt_transcription.duration_ms = static_cast<double>(out_result->processing_time_ms);
+    event.data.stt_transcription.word_count = count_words(out_result->text);
+    event.data.stt_transcription.error_code = RAC_SUCCESS;
+    set_event_memory(event.data.stt_transcription, memory);
+    rac_analytics_event_emit(RAC_EVENT_STT_TRANSCRIPTION_COMPLETED, &event);
+
+    log_info("STT.Component", "File transcription completed");
+    return RAC_SUCCESS;
+}
+
 extern "C" rac_bool_t rac_stt_component_supports_streaming(rac_handle_t handle) {
     if (!handle)
         return RAC_FALSE;
@@ -484,8 +609,12 @@ rac_stt_component_transcribe_stream(rac_handle_t handle, const void* audio_data,
 
     auto start_time = std::chrono::steady_clock::now();
 
+    rac_memory_watermark_t watermark;
+    rac_memory_watermark_begin(&watermark);
     result = rac_stt_transcribe_stream(service, audio_data, audio_size, effective_options, callback,
                                        user_data);
+    rac_inference_memory_t memory;
+    rac_memory_watermark_end(&watermark, 0, &memory);
 
     auto end_time = std::chrono::steady_clock::now();
     double duration_ms =
@@ -530,7 +659,9 @@ rac_stt_component_transcribe_stream(rac_handle_t handle, const void* audio_data,
         event.data.stt_transcription.framework =
             static_cast<rac_inference_framework_t>(component->config.preferred_framework);
         event.data.stt_transcription.error_code = RAC_SUCCESS;
+        set_event_memory(event.data.stt_transcription, memory);
         rac_analytics_event_emit(RAC_EVENT_STT_TRANSCRIPTION_COMPLETED, &event);
+        record_memory(memory);
     }
 
     return result;
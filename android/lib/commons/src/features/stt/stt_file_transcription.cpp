@@ -0,0 +1,451 @@
+/**
+ * @file stt_file_transcription.cpp
+ * @brief STT Service - Chunked file transcription
+ *
+ * Reads a WAV or raw PCM16 file from disk a frame at a time and cuts it into
+ * chunks that fit one whisper window, preferring quiet frames as cut points so
+ * words are not split. Chunks are transcribed by a few workers in parallel
+ * (the whisper.cpp backend serves them from its state pool) while the reader
+ * continues, with at most max_parallel chunks buffered, so memory stays
+ * bounded however long the file is. Results are merged in order with word
+ * timestamps shifted to file time.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_logger.h"
+#include "rac/features/stt/rac_stt_service.h"
+
+static const char* LOG_CAT = "STT.File";
+
+namespace {
+
+// Chunking (in seconds of audio); whisper takes at most 30 s per pass
+constexpr double kFrameSec = 0.03;
+constexpr double kMinChunkSec = 15.0;
+constexpr double kMaxChunkSec = 28.0;
+
+// Frame RMS (full scale = 1) below which a frame counts as silence; raised
+// to twice the quietest frame seen so far for noisy recordings
+constexpr float kSilenceRms = 0.01f;
+
+constexpr int32_t kDefaultParallel = 2;
+
+uint16_t read_u16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/**
+ * Sequential reader producing mono Int16 frames from a WAV (PCM16 or Float32,
+ * any channel count) or headerless PCM16 file.
+ */
+class AudioFileReader {
+   public:
+    ~AudioFileReader() {
+        if (file_) {
+            fclose(file_);
+        }
+    }
+
+    rac_result_t open(const char* path, int32_t raw_sample_rate) {
+        file_ = fopen(path, "rb");
+        if (!file_) {
+            RAC_LOG_ERROR(LOG_CAT, "Failed to open audio file: %s", path);
+            return RAC_ERROR_FILE_READ_FAILED;
+        }
+
+        uint8_t riff[12];
+        if (fread(riff, 1, sizeof(riff), file_) != sizeof(riff) || memcmp(riff, "RIFF", 4) != 0 ||
+            memcmp(riff + 8, "WAVE", 4) != 0) {
+            // Headerless: mono PCM16 at the requested rate
+            fseek(file_, 0, SEEK_SET);
+            sample_rate_ = raw_sample_rate;
+            remaining_ = SIZE_MAX;
+            return RAC_SUCCESS;
+        }
+
+        bool have_format = false;
+        uint8_t header[8];
+        while (fread(header, 1, sizeof(header), file_) == sizeof(header)) {
+            const uint32_t size = read_u32(header + 4);
+            if (memcmp(header, "fmt ", 4) == 0) {
+                uint8_t fmt[40] = {};
+                const size_t n = std::min<size_t>(size, sizeof(fmt));
+                if (size < 16 || fread(fmt, 1, n, file_) != n) {
+                    return RAC_ERROR_INVALID_FORMAT;
+                }
+                uint16_t format = read_u16(fmt);
+                if (format == 0xFFFE && size >= 26) {
+                    format = read_u16(fmt + 24);  // WAVE_FORMAT_EXTENSIBLE sub-format
+                }
+                channels_ = read_u16(fmt + 2);
+                sample_rate_ = static_cast<int32_t>(read_u32(fmt + 4));
+                bits_ = read_u16(fmt + 14);
+                is_float_ = format == 3;
+                if (channels_ == 0 || sample_rate_ <= 0 || !(format == 1 || format == 3) ||
+                    (is_float_ ? bits_ != 32 : bits_ != 16)) {
+                    RAC_LOG_ERROR(LOG_CAT, "Unsupported WAV format %u (%u bits)", format, bits_);
+                    return RAC_ERROR_INVALID_FORMAT;
+                }
+                fseek(file_, static_cast<long>(size - n + (size & 1)), SEEK_CUR);
+                have_format = true;
+            } else if (memcmp(header, "data", 4) == 0) {
+                if (!have_format) {
+                    return RAC_ERROR_INVALID_FORMAT;
+                }
+                // Streamed WAVs leave the size at 0 or 0xFFFFFFFF: read to EOF
+                remaining_ = (size == 0 || size == 0xFFFFFFFFu) ? SIZE_MAX : size;
+                return RAC_SUCCESS;
+            } else {
+                fseek(file_, static_cast<long>(size + (size & 1)), SEEK_CUR);
+            }
+        }
+
+        RAC_LOG_ERROR(LOG_CAT, "WAV file has no data chunk: %s", path);
+        return RAC_ERROR_INVALID_FORMAT;
+    }
+
+    int32_t sample_rate() const { return sample_rate_; }
+
+    // Appends up to num_frames mono samples to out; returns the number read
+    size_t read(size_t num_frames, std::vector<int16_t>& out) {
+        const size_t frame_bytes = static_cast<size_t>(channels_) * (bits_ / 8);
+        const size_t bytes = std::min(num_frames * frame_bytes, remaining_ - remaining_ % frame_bytes);
+        raw_.resize(bytes);
+        const size_t got = fread(raw_.data(), 1, bytes, file_) / frame_bytes;
+        if (remaining_ != SIZE_MAX) {
+            remaining_ -= got * frame_bytes;
+        }
+
+        const uint8_t* p = raw_.data();
+        for (size_t i = 0; i < got; i++) {
+            float sum = 0.0f;
+            for (uint16_t c = 0; c < channels_; c++) {
+                if (is_float_) {
+                    float v;
+                    memcpy(&v, p, sizeof(v));
+                    sum += v;
+                    p += 4;
+                } else {
+                    sum += static_cast<int16_t>(read_u16(p)) / 32768.0f;
+                    p += 2;
+                }
+            }
+            const float mono = std::max(-1.0f, std::min(1.0f, sum / channels_));
+            out.push_back(static_cast<int16_t>(mono * 32767.0f));
+        }
+        return got;
+    }
+
+   private:
+    FILE* file_ = nullptr;
+    int32_t sample_rate_ = 16000;
+    uint16_t channels_ = 1;
+    uint16_t bits_ = 16;
+    bool is_float_ = false;
+    size_t remaining_ = 0;  // bytes left in the data chunk
+    std::vector<uint8_t> raw_;
+};
+
+struct AudioChunk {
+    size_t index = 0;
+    size_t start_sample = 0;
+    std::vector<int16_t> samples;
+};
+
+struct ChunkResult {
+    rac_result_t status = RAC_ERROR_NOT_INITIALIZED;
+    size_t start_sample = 0;
+    size_t num_samples = 0;
+    rac_stt_result_t result = {};
+};
+
+/**
+ * Bounded queue between the reader and the transcription workers.
+ */
+class ChunkQueue {
+   public:
+    explicit ChunkQueue(size_t capacity) : capacity_(capacity) {}
+
+    bool push(AudioChunk&& chunk) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return queue_.size() < capacity_ || aborted_; });
+        if (aborted_) {
+            return false;
+        }
+        queue_.push_back(std::move(chunk));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    bool pop(AudioChunk& chunk) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return !queue_.empty() || closed_ || aborted_; });
+        if (queue_.empty() || aborted_) {
+            return false;
+        }
+        chunk = std::move(queue_.front());
+        queue_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+    void abort() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborted_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+   private:
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<AudioChunk> queue_;
+    size_t capacity_;
+    bool closed_ = false;
+    bool aborted_ = false;
+};
+
+float frame_rms(const int16_t* samples, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double v = samples[i] / 32768.0;
+        sum += v * v;
+    }
+    return n > 0 ? static_cast<float>(std::sqrt(sum / n)) : 0.0f;
+}
+
+char* dup_string(const std::string& s) {
+    char* out = static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, s.size() + 1));
+    if (out) {
+        memcpy(out, s.c_str(), s.size() + 1);
+    }
+    return out;
+}
+
+// Concatenates chunk results in order into out
+rac_result_t merge_results(std::vector<ChunkResult>& chunks, int32_t sample_rate,
+                           rac_stt_result_t* out) {
+    std::string text;
+    size_t num_words = 0;
+    double weighted_confidence = 0.0;
+    size_t total_samples = 0;
+    for (const auto& chunk : chunks) {
+        const char* chunk_text = chunk.result.text ? chunk.result.text : "";
+        while (*chunk_text == ' ') {
+            chunk_text++;
+        }
+        if (*chunk_text != '\0') {
+            if (!text.empty()) {
+                text += ' ';
+            }
+            text += chunk_text;
+        }
+        num_words += chunk.result.num_words;
+        weighted_confidence += static_cast<double>(chunk.result.confidence) * chunk.num_samples;
+        total_samples += chunk.num_samples;
+        if (!out->detected_language && chunk.result.detected_language) {
+            out->detected_language = dup_string(chunk.result.detected_language);
+        }
+    }
+
+    out->text = dup_string(text);
+    out->confidence =
+        total_samples > 0 ? static_cast<float>(weighted_confidence / total_samples) : 0.0f;
+
+    if (num_words > 0) {
+        out->words = static_cast<rac_stt_word_t*>(
+            rac_calloc_tagged(RAC_ALLOC_TAG_RESULT, num_words, sizeof(rac_stt_word_t)));
+        if (!out->words) {
+            return RAC_ERROR_OUT_OF_MEMORY;
+        }
+        size_t w = 0;
+        for (auto& chunk : chunks) {
+            const int64_t offset_ms =
+                static_cast<int64_t>(chunk.start_sample * 1000 / static_cast<size_t>(sample_rate));
+            for (size_t i = 0; i < chunk.result.num_words; i++) {
+                rac_stt_word_t& word = out->words[w++];
+                word = chunk.result.words[i];
+                word.start_ms += offset_ms;
+                word.end_ms += offset_ms;
+                chunk.result.words[i].text = nullptr;  // ownership moved
+            }
+        }
+        out->num_words = num_words;
+    }
+
+    return out->text ? RAC_SUCCESS : RAC_ERROR_OUT_OF_MEMORY;
+}
+
+}  // namespace
+
+// =============================================================================
+// FILE TRANSCRIPTION API
+// =============================================================================
+
+extern "C" rac_result_t rac_stt_transcribe_file(rac_handle_t handle, const char* file_path,
+                                                const rac_stt_options_t* options,
+                                                int32_t max_parallel,
+                                                rac_stt_result_t* out_result) {
+    if (!handle || !file_path || !out_result) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    *out_result = {};
+
+    rac_stt_options_t chunk_options = options ? *options : RAC_STT_OPTIONS_DEFAULT;
+    const int32_t raw_rate =
+        chunk_options.sample_rate > 0 ? chunk_options.sample_rate : RAC_STT_DEFAULT_SAMPLE_RATE;
+
+    AudioFileReader reader;
+    rac_result_t status = reader.open(file_path, raw_rate);
+    if (status != RAC_SUCCESS) {
+        return status;
+    }
+    const int32_t sample_rate = reader.sample_rate();
+    chunk_options.sample_rate = sample_rate;
+    chunk_options.audio_format = RAC_AUDIO_FORMAT_PCM;
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const size_t workers = static_cast<size_t>(max_parallel > 0 ? max_parallel : kDefaultParallel);
+
+    ChunkQueue queue(workers);
+    std::mutex results_mutex;
+    std::vector<ChunkResult> results;
+    rac_result_t first_error = RAC_SUCCESS;
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (size_t t = 0; t < workers; t++) {
+        threads.emplace_back([&]() {
+            AudioChunk chunk;
+            while (queue.pop(chunk)) {
+                ChunkResult chunk_result;
+                chunk_result.start_sample = chunk.start_sample;
+                chunk_result.num_samples = chunk.samples.size();
+                chunk_result.status =
+                    rac_stt_transcribe(handle, chunk.samples.data(),
+                                       chunk.samples.size() * sizeof(int16_t), &chunk_options,
+                                       &chunk_result.result);
+
+                std::lock_guard<std::mutex> lock(results_mutex);
+                if (chunk_result.status != RAC_SUCCESS && first_error == RAC_SUCCESS) {
+                    first_error = chunk_result.status;
+                    queue.abort();
+                }
+                if (results.size() <= chunk.index) {
+                    results.resize(chunk.index + 1);
+                }
+                results[chunk.index] = chunk_result;
+            }
+        });
+    }
+
+    // Read and cut: once a chunk is kMinChunkSec long it ends at the next
+    // silent frame, and at kMaxChunkSec it ends at its quietest frame
+    const size_t frame = std::max<size_t>(1, static_cast<size_t>(sample_rate * kFrameSec));
+    const size_t min_frames = static_cast<size_t>(kMinChunkSec / kFrameSec);
+    const size_t max_frames = static_cast<size_t>(kMaxChunkSec / kFrameSec);
+
+    AudioChunk chunk;
+    std::vector<float> rms;
+    float noise_floor = 1.0f;
+    size_t next_index = 0;
+    size_t position = 0;
+    bool ok = true;
+
+    auto emit = [&](size_t cut_frames) {
+        const size_t cut = std::min(chunk.samples.size(), cut_frames * frame);
+        AudioChunk next;
+        next.start_sample = chunk.start_sample + cut;
+        next.samples.assign(chunk.samples.begin() + static_cast<std::ptrdiff_t>(cut),
+                            chunk.samples.end());
+        chunk.samples.resize(cut);
+        chunk.index = next_index++;
+        ok = queue.push(std::move(chunk));
+        chunk = std::move(next);
+        rms.erase(rms.begin(), rms.begin() + static_cast<std::ptrdiff_t>(std::min(cut_frames, rms.size())));
+    };
+
+    chunk.samples.reserve((max_frames + 1) * frame);
+    while (ok) {
+        const size_t before = chunk.samples.size();
+        const size_t got = reader.read(frame, chunk.samples);
+        if (got == 0) {
+            break;
+        }
+        position += got;
+
+        const float level = frame_rms(chunk.samples.data() + before, got);
+        rms.push_back(level);
+        noise_floor = std::min(noise_floor, level);
+        const float threshold = std::max(kSilenceRms, 2.0f * noise_floor);
+
+        if (rms.size() >= max_frames) {
+            const auto quietest =
+                std::min_element(rms.begin() + static_cast<std::ptrdiff_t>(min_frames), rms.end());
+            emit(static_cast<size_t>(quietest - rms.begin()) + 1);
+        } else if (rms.size() >= min_frames && level < threshold) {
+            emit(rms.size());
+        }
+    }
+    if (ok && !chunk.samples.empty()) {
+        emit(rms.size());
+    }
+
+    queue.close();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (first_error == RAC_SUCCESS && !ok) {
+        first_error = RAC_ERROR_CANCELLED;
+    }
+    if (first_error == RAC_SUCCESS) {
+        if (results.empty()) {
+            RAC_LOG_ERROR(LOG_CAT, "Audio file is empty: %s", file_path);
+            first_error = RAC_ERROR_INVALID_ARGUMENT;
+        } else {
+            first_error = merge_results(results, sample_rate, out_result);
+        }
+    }
+
+    for (auto& chunk_result : results) {
+        rac_stt_result_free(&chunk_result.result);
+    }
+    if (first_error != RAC_SUCCESS) {
+        rac_stt_result_free(out_result);
+        return first_error;
+    }
+
+    out_result->processing_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::steady_clock::now() - start_time)
+                                         .count();
+    RAC_LOG_INFO(LOG_CAT, "Transcribed %.1f s of audio in %zu chunks (%lld ms, %zu workers)",
+                 position / static_cast<double>(sample_rate), results.size(),
+                 static_cast<long long>(out_result->processing_time_ms), workers);
+    return RAC_SUCCESS;
+}
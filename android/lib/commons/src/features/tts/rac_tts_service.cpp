@@ -158,19 +158,25 @@ void rac_tts_destroy(rac_handle_t handle) {
     }
 
     if (service->model_id) {
-        free(const_cast<char*>(service->model_id));
+        rac_free(const_cast<char*>(service->model_id));
     }
 
-    free(service);
+    rac_free(service);
 }
 
 void rac_tts_result_free(rac_tts_result_t* result) {
     if (!result)
         return;
     if (result->audio_data) {
-        free(result->audio_data);
+        if (result->release_audio) {
+            result->release_audio(result->audio_data, result->release_context);
+        } else {
+            rac_free(result->audio_data);
+        }
         result->audio_data = nullptr;
     }
+    result->release_audio = nullptr;
+    result->release_context = nullptr;
 }
 
 }  // extern "C"
@@ -15,7 +15,9 @@
 #include <sstream>
 #include <string>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
+#include "rac/core/rac_metrics.h"
 #include "rac/features/tts/rac_tts_analytics.h"
 
 // =============================================================================
@@ -147,7 +149,8 @@ rac_result_t rac_tts_analytics_start_synthesis(rac_tts_analytics_handle_t handle
 
     handle->active_syntheses[id] = tracker;
 
-    *out_synthesis_id = static_cast<char*>(malloc(id.size() + 1));
+    *out_synthesis_id =
+        static_cast<char*>(rac_alloc_tagged(RAC_ALLOC_TAG_TELEMETRY, id.size() + 1));
     if (!*out_synthesis_id) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
@@ -207,6 +210,13 @@ rac_result_t rac_tts_analytics_complete_synthesis(rac_tts_analytics_handle_t han
     handle->last_event_time_ms = end_time_ms;
     handle->has_last_event_time = true;
 
+    static const rac::MetricCounter syntheses("tts.syntheses");
+    static const rac::MetricHistogram latency_ms("tts.latency_ms");
+    static const rac::MetricGauge chars_per_second_gauge("tts.chars_per_second");
+    syntheses.add();
+    latency_ms.record(static_cast<int64_t>(processing_time_ms));
+    chars_per_second_gauge.set(chars_per_second);
+
     log_debug("TTS.Analytics", "Synthesis completed: %s, voice: %s, audio: %.1fms, %d bytes",
               synthesis_id, tracker.model_id.c_str(), audio_duration_ms, audio_size_bytes);
 
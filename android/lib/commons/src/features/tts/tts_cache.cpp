@@ -0,0 +1,367 @@
+/**
+ * @file tts_cache.cpp
+ * @brief RunAnywhere Commons - Synthesized Phrase Cache Implementation
+ *
+ * Disk entries are `{fnv1a64(key)}.ttsc` files: a 24-byte header, the key
+ * (checked on load to rule out hash collisions) and the stored audio, raw or
+ * IMA-ADPCM. They are written to a temporary name and renamed, so readers
+ * never see a partial file.
+ */
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_audio_utils.h"
+#include "rac/core/rac_logger.h"
+#include "rac/features/tts/rac_tts_cache.h"
+
+static const char* LOG_CAT = "TTS.Cache";
+
+namespace {
+
+constexpr char kMagic[4] = {'R', 'T', 'C', '2'};
+constexpr const char* kExtension = ".ttsc";
+
+struct DiskHeader {
+    char magic[4];
+    int32_t sample_rate;
+    int32_t audio_format;
+    uint32_t key_length;
+    uint32_t adpcm;         // 1 if the audio is IMA-ADPCM encoded Float32 PCM
+    uint32_t sample_count;  // decoded samples when adpcm is set
+};
+static_assert(sizeof(DiskHeader) == 24, "disk header must stay 24 bytes");
+
+struct CacheEntry {
+    std::string key;
+    std::vector<uint8_t> audio;  // as stored, see adpcm
+    bool adpcm = false;
+    size_t sample_count = 0;
+    int32_t sample_rate = 0;
+    rac_audio_format_enum_t audio_format = RAC_AUDIO_FORMAT_PCM;
+    int64_t duration_ms = 0;
+};
+
+std::string normalize_text(const char* text) {
+    std::string normalized;
+    bool pending_space = false;
+    for (const char* p = text; *p; ++p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (std::isspace(c)) {
+            pending_space = !normalized.empty();
+            continue;
+        }
+        if (pending_space) {
+            normalized += ' ';
+            pending_space = false;
+        }
+        normalized += static_cast<char>(c);
+    }
+    return normalized;
+}
+
+std::string make_key(const char* voice, float rate, const char* text) {
+    char rate_str[16];
+    snprintf(rate_str, sizeof(rate_str), "%.2f", rate > 0 ? rate : 1.0f);
+    return std::string(voice ? voice : "") + '\x1f' + rate_str + '\x1f' + normalize_text(text);
+}
+
+std::string hash_name(const std::string& key) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : key) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+    return name;
+}
+
+}  // namespace
+
+struct rac_tts_cache {
+    rac_tts_cache_config_t config;
+    std::string disk_directory;
+
+    std::list<CacheEntry> entries;  // most recently used first
+    std::unordered_map<std::string, std::list<CacheEntry>::iterator> index;
+    size_t memory_bytes = 0;
+    std::mutex mtx;
+
+    std::string disk_path(const std::string& key) const {
+        return disk_directory + "/" + hash_name(key) + kExtension;
+    }
+
+    void evict_to(size_t budget) {
+        while (memory_bytes > budget && !entries.empty()) {
+            memory_bytes -= entries.back().audio.size();
+            index.erase(entries.back().key);
+            entries.pop_back();
+        }
+    }
+
+    void insert(CacheEntry entry) {
+        memory_bytes += entry.audio.size();
+        entries.push_front(std::move(entry));
+        index[entries.front().key] = entries.begin();
+        evict_to(config.max_memory_bytes);
+    }
+
+    bool load_from_disk(const std::string& key, CacheEntry* out) const {
+        FILE* file = fopen(disk_path(key).c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+
+        DiskHeader header;
+        std::string stored_key;
+        bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+                  std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+                  header.key_length == key.size();
+        if (ok) {
+            stored_key.resize(header.key_length);
+            ok = fread(&stored_key[0], 1, stored_key.size(), file) == stored_key.size() &&
+                 stored_key == key;
+        }
+        if (ok) {
+            long audio_start = ftell(file);
+            fseek(file, 0, SEEK_END);
+            long audio_end = ftell(file);
+            fseek(file, audio_start, SEEK_SET);
+            ok = audio_end > audio_start;
+            if (ok) {
+                out->audio.resize(static_cast<size_t>(audio_end - audio_start));
+                ok = fread(out->audio.data(), 1, out->audio.size(), file) == out->audio.size();
+            }
+        }
+        fclose(file);
+
+        if (!ok) {
+            return false;
+        }
+        out->key = key;
+        out->sample_rate = header.sample_rate;
+        out->audio_format = static_cast<rac_audio_format_enum_t>(header.audio_format);
+        out->adpcm = header.adpcm != 0;
+        if (out->adpcm) {
+            out->sample_count = header.sample_count;
+            if (rac_audio_adpcm_encoded_size(out->sample_count) != out->audio.size()) {
+                return false;
+            }
+        } else if (out->audio_format == RAC_AUDIO_FORMAT_PCM) {
+            out->sample_count = out->audio.size() / sizeof(float);
+        }
+        out->duration_ms = out->sample_rate > 0 ? static_cast<int64_t>(out->sample_count) * 1000 /
+                                                      out->sample_rate
+                                                : 0;
+        return true;
+    }
+
+    void save_to_disk(const CacheEntry& entry) const {
+        std::string path = disk_path(entry.key);
+        std::string temp_path = path + ".tmp";
+        FILE* file = fopen(temp_path.c_str(), "wb");
+        if (!file) {
+            RAC_LOG_WARNING(LOG_CAT, "Cannot write cache entry: %s", temp_path.c_str());
+            return;
+        }
+
+        DiskHeader header;
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.sample_rate = entry.sample_rate;
+        header.audio_format = static_cast<int32_t>(entry.audio_format);
+        header.key_length = static_cast<uint32_t>(entry.key.size());
+        header.adpcm = entry.adpcm ? 1 : 0;
+        header.sample_count = static_cast<uint32_t>(entry.sample_count);
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(entry.key.data(), 1, entry.key.size(), file) == entry.key.size() &&
+                  fwrite(entry.audio.data(), 1, entry.audio.size(), file) == entry.audio.size();
+        ok = fclose(file) == 0 && ok;
+
+        if (!ok || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+            RAC_LOG_WARNING(LOG_CAT, "Failed to persist cache entry: %s", path.c_str());
+            std::remove(temp_path.c_str());
+        }
+    }
+};
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_tts_cache_create(const rac_tts_cache_config_t* config,
+                                  rac_tts_cache_handle_t* out_handle) {
+    if (!out_handle) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+
+    auto* cache = new (std::nothrow) rac_tts_cache();
+    if (!cache) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    cache->config = config ? *config : RAC_TTS_CACHE_CONFIG_DEFAULT;
+    if (cache->config.disk_directory && cache->config.disk_directory[0]) {
+        cache->disk_directory = cache->config.disk_directory;
+        while (cache->disk_directory.size() > 1 && cache->disk_directory.back() == '/') {
+            cache->disk_directory.pop_back();
+        }
+        mkdir(cache->disk_directory.c_str(), 0755);
+    }
+    cache->config.disk_directory = nullptr;  // not owned; the copy above is used
+
+    *out_handle = cache;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_tts_cache_lookup(rac_tts_cache_handle_t handle, const char* voice, float rate,
+                                  const char* text, rac_tts_result_t* out_result) {
+    if (!handle || !text || !out_result) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    if (handle->config.max_memory_bytes == 0 ||
+        std::strlen(text) > static_cast<size_t>(handle->config.max_text_length)) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+
+    std::string key = make_key(voice, rate, text);
+    std::lock_guard<std::mutex> lock(handle->mtx);
+
+    auto it = handle->index.find(key);
+    if (it != handle->index.end()) {
+        handle->entries.splice(handle->entries.begin(), handle->entries, it->second);
+    } else {
+        CacheEntry entry;
+        if (handle->disk_directory.empty() || !handle->load_from_disk(key, &entry)) {
+            return RAC_ERROR_NOT_FOUND;
+        }
+        handle->insert(std::move(entry));
+        if (handle->index.find(key) == handle->index.end()) {
+            return RAC_ERROR_NOT_FOUND;  // larger than the whole budget
+        }
+    }
+
+    const CacheEntry& entry = handle->entries.front();
+    size_t audio_size = entry.adpcm ? entry.sample_count * sizeof(float) : entry.audio.size();
+    void* audio = rac_alloc_tagged(RAC_ALLOC_TAG_AUDIO, audio_size);
+    if (!audio) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    if (entry.adpcm) {
+        rac_audio_adpcm_state_t state = {};
+        rac_audio_adpcm_decode(&state, entry.audio.data(), entry.sample_count,
+                               static_cast<float*>(audio));
+    } else {
+        std::memcpy(audio, entry.audio.data(), entry.audio.size());
+    }
+
+    *out_result = rac_tts_result_t{};
+    out_result->audio_data = audio;
+    out_result->audio_size = audio_size;
+    out_result->audio_format = entry.audio_format;
+    out_result->sample_rate = entry.sample_rate;
+    out_result->duration_ms = entry.duration_ms;
+    out_result->processing_time_ms = 0;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_tts_cache_store(rac_tts_cache_handle_t handle, const char* voice, float rate,
+                                 const char* text, const rac_tts_result_t* result) {
+    if (!handle || !text || !result) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    if (!result->audio_data || result->audio_size == 0 ||
+        std::strlen(text) > static_cast<size_t>(handle->config.max_text_length)) {
+        return RAC_SUCCESS;
+    }
+
+    CacheEntry entry;
+    entry.key = make_key(voice, rate, text);
+    entry.adpcm = handle->config.compress_audio == RAC_TRUE &&
+                  result->audio_format == RAC_AUDIO_FORMAT_PCM &&
+                  result->audio_size % sizeof(float) == 0;
+    if (entry.adpcm) {
+        entry.sample_count = result->audio_size / sizeof(float);
+        entry.audio.resize(rac_audio_adpcm_encoded_size(entry.sample_count));
+        rac_audio_adpcm_state_t state = {};
+        rac_audio_adpcm_encode(&state, static_cast<const float*>(result->audio_data),
+                               entry.sample_count, entry.audio.data());
+    } else {
+        const auto* audio = static_cast<const uint8_t*>(result->audio_data);
+        entry.audio.assign(audio, audio + result->audio_size);
+    }
+    if (entry.audio.size() > handle->config.max_memory_bytes) {
+        return RAC_SUCCESS;
+    }
+    entry.sample_rate = result->sample_rate;
+    entry.audio_format = result->audio_format;
+    entry.duration_ms = result->duration_ms;
+
+    std::lock_guard<std::mutex> lock(handle->mtx);
+    auto it = handle->index.find(entry.key);
+    if (it != handle->index.end()) {
+        handle->memory_bytes -= it->second->audio.size();
+        handle->entries.erase(it->second);
+        handle->index.erase(it);
+    }
+    if (!handle->disk_directory.empty()) {
+        handle->save_to_disk(entry);
+    }
+    handle->insert(std::move(entry));
+    return RAC_SUCCESS;
+}
+
+int64_t rac_tts_cache_trim_memory(rac_tts_cache_handle_t handle) {
+    if (!handle) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mtx);
+    const auto released = static_cast<int64_t>(handle->memory_bytes);
+    handle->evict_to(0);
+    return released;
+}
+
+void rac_tts_cache_clear(rac_tts_cache_handle_t handle) {
+    if (!handle) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mtx);
+    handle->entries.clear();
+    handle->index.clear();
+    handle->memory_bytes = 0;
+
+    if (handle->disk_directory.empty()) {
+        return;
+    }
+    DIR* dir = opendir(handle->disk_directory.c_str());
+    if (!dir) {
+        return;
+    }
+    const size_t ext_len = std::strlen(kExtension);
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() > ext_len && name.compare(name.size() - ext_len, ext_len, kExtension) == 0) {
+            std::remove((handle->disk_directory + "/" + name).c_str());
+        }
+    }
+    closedir(dir);
+}
+
+void rac_tts_cache_destroy(rac_tts_cache_handle_t handle) {
+    delete handle;
+}
+
+}  // extern "C"
@@ -10,6 +10,7 @@
  */
 
 #include <chrono>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <mutex>
@@ -17,9 +18,13 @@
 
 #include "rac/core/capabilities/rac_lifecycle.h"
 #include "rac/core/rac_analytics_events.h"
+#include "rac/core/rac_core.h"
 #include "rac/core/rac_logger.h"
+#include "rac/core/rac_memory_watermark.h"
+#include "rac/core/rac_metrics.h"
 #include "rac/core/rac_platform_adapter.h"
 #include "rac/core/rac_structured_error.h"
+#include "rac/features/tts/rac_tts_cache.h"
 #include "rac/features/tts/rac_tts_component.h"
 #include "rac/features/tts/rac_tts_service.h"
 
@@ -31,9 +36,10 @@ struct rac_tts_component {
     rac_handle_t lifecycle;
     rac_tts_config_t config;
     rac_tts_options_t default_options;
+    rac_tts_cache_handle_t cache;  // repeated short phrases, keyed per voice
     std::mutex mtx;
 
-    rac_tts_component() : lifecycle(nullptr) {
+    rac_tts_component() : lifecycle(nullptr), cache(nullptr) {
         // Initialize with defaults - matches rac_tts_types.h rac_tts_config_t
         config = RAC_TTS_CONFIG_DEFAULT;
 
@@ -45,6 +51,26 @@ struct rac_tts_component {
 // HELPER FUNCTIONS
 // =============================================================================
 
+// Phrase cache key for the loaded voice and every option that changes the
+// audio besides the rate, which the cache keys itself
+static std::string cache_voice_key(rac_tts_component* component,
+                                   const rac_tts_options_t* options) {
+    const char* model_id = rac_lifecycle_get_model_id(component->lifecycle);
+    std::string key = model_id ? model_id : "";
+    if (options) {
+        char params[96];
+        snprintf(params, sizeof(params), ":%.2f:%.2f:%d:%d:%d", options->pitch, options->volume,
+                 static_cast<int>(options->sample_rate), static_cast<int>(options->audio_format),
+                 options->use_ssml == RAC_TRUE ? 1 : 0);
+        key += ':';
+        key += options->voice ? options->voice : "";
+        key += ':';
+        key += options->language ? options->language : "";
+        key += params;
+    }
+    return key;
+}
+
 // Generate a simple UUID v4-like string for event tracking
 static std::string generate_uuid_v4() {
     static const char* hex = "0123456789abcdef";
@@ -59,6 +85,20 @@ static std::string generate_uuid_v4() {
     return uuid;
 }
 
+// Publish one synthesis' memory use to rac_metrics and its completed event
+static void record_memory(const rac_inference_memory_t& memory,
+                          rac_analytics_tts_synthesis_t& event) {
+    static const rac::MetricHistogram peak_rss_mb("tts.peak_rss_mb");
+    static const rac::MetricGauge rss_delta_mb("tts.rss_delta_mb");
+    if (memory.peak_rss_bytes > 0) {
+        peak_rss_mb.record(memory.peak_rss_bytes >> 20);
+        rss_delta_mb.set(static_cast<double>(memory.rss_delta_bytes) / (1024.0 * 1024.0));
+    }
+    event.peak_rss_bytes = memory.peak_rss_bytes;
+    event.rss_delta_bytes = memory.rss_delta_bytes;
+    event.backend_memory_bytes = memory.backend_bytes;
+}
+
 // =============================================================================
 // LIFECYCLE CALLBACKS
 // =============================================================================
@@ -97,6 +137,31 @@ static void tts_destroy_service(rac_handle_t service, void* user_data) {
     }
 }
 
+/**
+ * Memory pressure stages for TTS: drop the in-memory phrase cache, then unload
+ * the voice if no synthesis holds the component.
+ */
+static int64_t tts_memory_pressure_handler(rac_memory_pressure_stage_t stage, void* user_data) {
+    auto* component = static_cast<rac_tts_component*>(user_data);
+    switch (stage) {
+        case RAC_MEMORY_PRESSURE_STAGE_DROP_CACHES:
+            return rac_tts_cache_trim_memory(component->cache);
+        case RAC_MEMORY_PRESSURE_STAGE_UNLOAD_IDLE:
+            break;
+        default:
+            return 0;
+    }
+
+    std::unique_lock<std::mutex> lock(component->mtx, std::try_to_lock);
+    if (!lock.owns_lock() || !rac_lifecycle_is_loaded(component->lifecycle)) {
+        return 0;
+    }
+    const int64_t bytes = rac_lifecycle_get_resident_bytes(component->lifecycle);
+    log_info("TTS.Component", "Unloading idle TTS model under memory pressure");
+    rac_lifecycle_unload(component->lifecycle);
+    return bytes;
+}
+
 // =============================================================================
 // LIFECYCLE API
 // =============================================================================
@@ -124,6 +189,14 @@ extern "C" rac_result_t rac_tts_component_create(rac_handle_t* out_handle) {
         return result;
     }
 
+    // A missing cache only costs speed, so creation failures are not fatal
+    if (rac_tts_cache_create(&RAC_TTS_CACHE_CONFIG_DEFAULT, &component->cache) != RAC_SUCCESS) {
+        log_warning("TTS.Component", "Phrase cache unavailable");
+        component->cache = nullptr;
+    }
+
+    rac_memory_pressure_register("TTS.Component", tts_memory_pressure_handler, component);
+
     *out_handle = reinterpret_cast<rac_handle_t>(component);
 
     log_info("TTS.Component", "TTS component created");
@@ -166,6 +239,36 @@ extern "C" rac_result_t rac_tts_component_configure(rac_handle_t handle,
     return RAC_SUCCESS;
 }
 
+extern "C" rac_result_t rac_tts_component_configure_cache(rac_handle_t handle,
+                                                          const rac_tts_cache_config_t* config) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_tts_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->mtx);
+
+    rac_tts_cache_handle_t cache = nullptr;
+    if (config && config->max_memory_bytes > 0) {
+        rac_result_t result = rac_tts_cache_create(config, &cache);
+        if (result != RAC_SUCCESS)
+            return result;
+    }
+    rac_tts_cache_destroy(component->cache);
+    component->cache = cache;
+
+    log_info("TTS.Component", cache ? "Phrase cache configured" : "Phrase cache disabled");
+    return RAC_SUCCESS;
+}
+
+extern "C" void rac_tts_component_clear_cache(rac_handle_t handle) {
+    if (!handle)
+        return;
+
+    auto* component = reinterpret_cast<rac_tts_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->mtx);
+    rac_tts_cache_clear(component->cache);
+}
+
 extern "C" rac_bool_t rac_tts_component_is_loaded(rac_handle_t handle) {
     if (!handle)
         return RAC_FALSE;
@@ -187,10 +290,12 @@ extern "C" void rac_tts_component_destroy(rac_handle_t handle) {
         return;
 
     auto* component = reinterpret_cast<rac_tts_component*>(handle);
+    rac_memory_pressure_unregister(tts_memory_pressure_handler, component);
 
     if (component->lifecycle) {
         rac_lifecycle_destroy(component->lifecycle);
     }
+    rac_tts_cache_destroy(component->cache);
 
     log_info("TTS.Component", "TTS component destroyed");
 
@@ -238,8 +343,8 @@ extern "C" rac_result_t rac_tts_component_stop(rac_handle_t handle) {
         return RAC_ERROR_INVALID_HANDLE;
 
     auto* component = reinterpret_cast<rac_tts_component*>(handle);
-    std::lock_guard<std::mutex> lock(component->mtx);
-
+    // No component lock: an in-flight synthesize_stream holds it for the whole
+    // utterance, and stop must be able to interrupt it (backends only set a flag)
     rac_handle_t service = rac_lifecycle_get_service(component->lifecycle);
     if (service) {
         rac_tts_stop(service);
@@ -313,7 +418,29 @@ extern "C" rac_result_t rac_tts_component_synthesize(rac_handle_t handle, const
 
     auto start_time = std::chrono::steady_clock::now();
 
-    result = rac_tts_synthesize(service, text, effective_options, out_result);
+    std::string voice_key = cache_voice_key(component, effective_options);
+    bool cache_hit = component->cache &&
+                     rac_tts_cache_lookup(component->cache, voice_key.c_str(),
+                                          effective_options->rate, text,
+                                          out_result) == RAC_SUCCESS;
+    if (cache_hit) {
+        log_debug("TTS.Component", "Serving synthesis from phrase cache");
+        result = RAC_SUCCESS;
+    } else {
+        // Cache hits allocate nothing worth measuring and keep memory zeroed
+        rac_memory_watermark_t watermark;
+        rac_memory_watermark_begin(&watermark);
+        result = rac_tts_synthesize(service, text, effective_options, out_result);
+        rac_inference_memory_t memory;
+        rac_memory_watermark_end(&watermark, 0, &memory);
+        if (result == RAC_SUCCESS) {
+            out_result->memory = memory;
+        }
+        if (result == RAC_SUCCESS && component->cache) {
+            rac_tts_cache_store(component->cache, voice_key.c_str(), effective_options->rate, text,
+                                out_result);
+        }
+    }
 
     auto end_time = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -358,6 +485,9 @@ extern "C" rac_result_t rac_tts_component_synthesize(rac_handle_t handle, const
         event_data.data.tts_synthesis.processing_duration_ms = processing_ms;
         event_data.data.tts_synthesis.characters_per_second = chars_per_sec;
         event_data.data.tts_synthesis.sample_rate = static_cast<int32_t>(out_result->sample_rate);
+        if (!cache_hit) {
+            record_memory(out_result->memory, event_data.data.tts_synthesis);
+        }
         rac_analytics_event_emit(RAC_EVENT_TTS_SYNTHESIS_COMPLETED, &event_data);
     }
 
@@ -366,6 +496,36 @@ extern "C" rac_result_t rac_tts_component_synthesize(rac_handle_t handle, const
     return RAC_SUCCESS;
 }
 
+extern "C" rac_result_t rac_tts_component_synthesize_into(rac_handle_t handle, const char* text,
+                                                          const rac_tts_options_t* options,
+                                                          void* buffer, size_t buffer_size,
+                                                          size_t* out_audio_size,
+                                                          int32_t* out_sample_rate) {
+    if (!buffer || !out_audio_size)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    rac_tts_result_t tts_result = {};
+    rac_result_t result = rac_tts_component_synthesize(handle, text, options, &tts_result);
+    if (result != RAC_SUCCESS)
+        return result;
+
+    *out_audio_size = tts_result.audio_size;
+    if (out_sample_rate)
+        *out_sample_rate = tts_result.sample_rate;
+
+    if (tts_result.audio_size > buffer_size) {
+        log_error("TTS.Component", "Output buffer too small for synthesized audio");
+        rac_tts_result_free(&tts_result);
+        return RAC_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    if (tts_result.audio_data && tts_result.audio_size > 0) {
+        std::memcpy(buffer, tts_result.audio_data, tts_result.audio_size);
+    }
+    rac_tts_result_free(&tts_result);
+    return RAC_SUCCESS;
+}
+
 extern "C" rac_result_t rac_tts_component_synthesize_stream(rac_handle_t handle, const char* text,
                                                             const rac_tts_options_t* options,
                                                             rac_tts_stream_callback_t callback,
@@ -417,7 +577,11 @@ extern "C" rac_result_t rac_tts_component_synthesize_stream(rac_handle_t handle,
 
     auto start_time = std::chrono::steady_clock::now();
 
+    rac_memory_watermark_t watermark;
+    rac_memory_watermark_begin(&watermark);
     result = rac_tts_synthesize_stream(service, text, effective_options, callback, user_data);
+    rac_inference_memory_t memory;
+    rac_memory_watermark_end(&watermark, 0, &memory);
 
     auto end_time = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -449,6 +613,7 @@ extern "C" rac_result_t rac_tts_component_synthesize_stream(rac_handle_t handle,
         event_data.data.tts_synthesis.character_count = char_count;
         event_data.data.tts_synthesis.processing_duration_ms = processing_ms;
         event_data.data.tts_synthesis.characters_per_second = chars_per_sec;
+        record_memory(memory, event_data.data.tts_synthesis);
         rac_analytics_event_emit(RAC_EVENT_TTS_SYNTHESIS_COMPLETED, &event_data);
     }
 
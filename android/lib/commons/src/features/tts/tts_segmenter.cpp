@@ -0,0 +1,859 @@
+/**
+ * @file tts_segmenter.cpp
+ * @brief RunAnywhere Commons - Streaming TTS Text Segmenter and Normalizer
+ *
+ * Segmentation scans only the bytes added since the last call; a trailing
+ * '.', '!' or '?' is looked at again once the byte after it arrives.
+ * Normalization is a single left-to-right pass over a finished sentence
+ * into a buffer that is reused for the next one.
+ */
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include "rac/core/rac_allocator.h"
+#include "rac/features/tts/rac_tts_segmenter.h"
+
+namespace {
+
+// =============================================================================
+// CHARACTER CLASSES
+// =============================================================================
+
+bool is_space(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool is_alpha(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) != 0;
+}
+
+bool is_sentence_end(char c) {
+    return c == '.' || c == '!' || c == '?';
+}
+
+// Letters and digits, counting any non-ASCII UTF-8 byte as a letter
+bool is_speakable(char c) {
+    unsigned char byte = static_cast<unsigned char>(c);
+    return std::isalnum(byte) != 0 || byte >= 0x80;
+}
+
+bool is_utf8_continuation(char c) {
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+// Length of the closing quote, bracket or emphasis marker ending at text[last]
+// (0 if there is none); these may follow a sentence's final punctuation
+size_t closer_length(const std::string& text, size_t last) {
+    char c = text[last];
+    if (c == '"' || c == '\'' || c == ')' || c == ']' || c == '*' || c == '_' || c == '`') {
+        return 1;
+    }
+    if (last >= 2 && (text.compare(last - 2, 3, "\xE2\x80\x9D") == 0 ||  // ”
+                      text.compare(last - 2, 3, "\xE2\x80\x99") == 0)) {  // ’
+        return 3;
+    }
+    if (last >= 1 && text.compare(last - 1, 2, "\xC2\xBB") == 0) {  // »
+        return 2;
+    }
+    return 0;
+}
+
+// Moves a cut at `end` back so no UTF-8 sequence is split, including one at the
+// end of the text whose remaining bytes have not arrived yet
+size_t utf8_cut(const std::string& text, size_t begin, size_t end) {
+    while (end > begin && end < text.size() && is_utf8_continuation(text[end])) {
+        end--;
+    }
+    size_t lead = end;
+    while (lead > begin && end - lead < 4 && is_utf8_continuation(text[lead - 1])) {
+        lead--;
+    }
+    if (lead > begin) {
+        unsigned char c = static_cast<unsigned char>(text[lead - 1]);
+        size_t length = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+        if (lead - 1 + length > end) {
+            end = lead - 1;
+        }
+    }
+    return end;
+}
+
+// CJK full stop, exclamation and question marks end a sentence on their own
+bool is_cjk_sentence_end(const std::string& text, size_t last) {
+    if (last < 2) {
+        return false;
+    }
+    return text.compare(last - 2, 3, "\xE3\x80\x82") == 0 ||  // 。
+           text.compare(last - 2, 3, "\xEF\xBC\x81") == 0 ||  // ！
+           text.compare(last - 2, 3, "\xEF\xBC\x9F") == 0;    // ？
+}
+
+// Decodes one UTF-8 sequence; returns its length (1 for invalid bytes)
+size_t decode_utf8(const char* p, size_t available, uint32_t* out) {
+    unsigned char c = static_cast<unsigned char>(p[0]);
+    size_t length = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+    if (length > available) {
+        *out = c;
+        return 1;
+    }
+    uint32_t code = length == 1 ? c : c & (0x7F >> length);
+    for (size_t i = 1; i < length; ++i) {
+        code = (code << 6) | (static_cast<unsigned char>(p[i]) & 0x3F);
+    }
+    *out = code;
+    return length;
+}
+
+// Pictographs, symbols and the joiners and selectors that combine them
+bool is_emoji(uint32_t code) {
+    return (code >= 0x1F000 && code <= 0x1FAFF) || (code >= 0x2600 && code <= 0x27BF) ||
+           (code >= 0x2300 && code <= 0x23FF) || (code >= 0x2B00 && code <= 0x2BFF) ||
+           (code >= 0xE0020 && code <= 0xE007F) || code == 0x200D || code == 0xFE0F ||
+           code == 0x20E3;
+}
+
+// =============================================================================
+// ABBREVIATIONS
+// =============================================================================
+
+struct Replacement {
+    const char* text;
+    const char* spoken;
+};
+
+// Case-sensitive; each one ends in '.' and never ends a sentence
+constexpr Replacement kAbbreviations[] = {
+    {"Dr.", "Doctor"},        {"Mr.", "Mister"},     {"Mrs.", "Missus"},
+    {"Ms.", "Miz"},           {"Prof.", "Professor"}, {"Jr.", "Junior"},
+    {"Sr.", "Senior"},        {"Mt.", "Mount"},      {"vs.", "versus"},
+    {"e.g.", "for example"},  {"i.e.", "that is"},   {"approx.", "approximately"},
+    {"No.", "number"},
+};
+
+// Spelled out, but may also end a sentence
+constexpr Replacement kTerminalAbbreviations[] = {
+    {"etc.", "et cetera"},
+};
+
+const Replacement* match_abbreviation(const char* p, size_t available, bool include_terminal) {
+    for (const Replacement& abbreviation : kAbbreviations) {
+        size_t length = std::strlen(abbreviation.text);
+        if (length <= available && std::memcmp(p, abbreviation.text, length) == 0) {
+            return &abbreviation;
+        }
+    }
+    if (include_terminal) {
+        for (const Replacement& abbreviation : kTerminalAbbreviations) {
+            size_t length = std::strlen(abbreviation.text);
+            if (length <= available && std::memcmp(p, abbreviation.text, length) == 0) {
+                return &abbreviation;
+            }
+        }
+    }
+    return nullptr;
+}
+
+// =============================================================================
+// NUMBERS
+// =============================================================================
+
+constexpr const char* kOnes[] = {"zero",    "one",     "two",       "three",    "four",
+                                 "five",    "six",     "seven",     "eight",    "nine",
+                                 "ten",     "eleven",  "twelve",    "thirteen", "fourteen",
+                                 "fifteen", "sixteen", "seventeen", "eighteen", "nineteen"};
+constexpr const char* kTens[] = {"",      "",      "twenty",  "thirty", "forty",
+                                 "fifty", "sixty", "seventy", "eighty", "ninety"};
+constexpr const char* kScales[] = {"", " thousand", " million", " billion", " trillion"};
+
+// Longest digit run read as a number; longer ones are read digit by digit
+constexpr size_t kMaxCardinalDigits = 15;
+
+void append_below_thousand(unsigned n, std::string& out) {
+    if (n >= 100) {
+        out += kOnes[n / 100];
+        out += " hundred";
+        n %= 100;
+        if (n == 0) {
+            return;
+        }
+        out += ' ';
+    }
+    if (n < 20) {
+        out += kOnes[n];
+    } else {
+        out += kTens[n / 10];
+        if (n % 10 != 0) {
+            out += '-';
+            out += kOnes[n % 10];
+        }
+    }
+}
+
+void append_cardinal(uint64_t n, std::string& out) {
+    if (n == 0) {
+        out += kOnes[0];
+        return;
+    }
+    unsigned groups[5] = {};
+    int top = 0;
+    for (int i = 0; i < 5 && n > 0; ++i, n /= 1000) {
+        groups[i] = static_cast<unsigned>(n % 1000);
+        top = i;
+    }
+    bool first = true;
+    for (int i = top; i >= 0; --i) {
+        if (groups[i] == 0) {
+            continue;
+        }
+        if (!first) {
+            out += ' ';
+        }
+        append_below_thousand(groups[i], out);
+        out += kScales[i];
+        first = false;
+    }
+}
+
+// "1990" -> "nineteen ninety", "2005" -> "two thousand five"
+void append_year(unsigned year, std::string& out) {
+    if (year >= 2000 && year < 2010) {
+        append_cardinal(year, out);
+        return;
+    }
+    append_below_thousand(year / 100, out);
+    unsigned rest = year % 100;
+    if (rest == 0) {
+        out += " hundred";
+    } else {
+        out += rest < 10 ? " oh " : " ";
+        append_below_thousand(rest, out);
+    }
+}
+
+void append_digits(const char* p, size_t count, std::string& out) {
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            out += ' ';
+        }
+        out += kOnes[p[i] - '0'];
+    }
+}
+
+uint64_t parse_digits(const char* p, size_t count) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        value = value * 10 + static_cast<uint64_t>(p[i] - '0');
+    }
+    return value;
+}
+
+constexpr Replacement kIrregularOrdinals[] = {
+    {"one", "first"},   {"two", "second"}, {"three", "third"},  {"five", "fifth"},
+    {"eight", "eighth"}, {"nine", "ninth"}, {"twelve", "twelfth"}};
+
+// Rewrites the last number word of out as an ordinal ("twenty-one" -> "twenty-first")
+void make_ordinal(std::string& out, size_t word_start) {
+    size_t start = out.find_last_of(" -");
+    start = start == std::string::npos || start < word_start ? word_start : start + 1;
+    for (const Replacement& irregular : kIrregularOrdinals) {
+        if (out.compare(start, std::string::npos, irregular.text) == 0) {
+            out.replace(start, std::string::npos, irregular.spoken);
+            return;
+        }
+    }
+    if (out.back() == 'y') {
+        out.pop_back();
+        out += "ieth";
+    } else {
+        out += "th";
+    }
+}
+
+// =============================================================================
+// NORMALIZER
+// =============================================================================
+
+class Normalizer {
+   public:
+    Normalizer(const char* text, size_t length, std::string& out)
+        : p_(text), end_(text + length), out_(out) {}
+
+    void run() {
+        bool line_start = true;
+        while (p_ < end_) {
+            if (line_start) {
+                skip_line_markup();
+                line_start = false;
+                continue;
+            }
+            char c = *p_;
+            if (c == '\n') {
+                space();
+                ++p_;
+                line_start = true;
+            } else if (c == '*' || c == '`' || c == '~' || c == '#' || c == '\\') {
+                ++p_;
+            } else if (c == '_' || c == '|') {
+                space();
+                ++p_;
+            } else if (c == '!' && p_ + 1 < end_ && p_[1] == '[' && link_end(p_ + 1)) {
+                ++p_;
+            } else if (c == '[') {
+                link();
+            } else if (c == ']' && p_ == skip_from_) {
+                p_ = skip_to_;
+            } else if (c == '&') {
+                word("and");
+                ++p_;
+            } else if (c == '@') {
+                word("at");
+                ++p_;
+            } else if (c == '=') {
+                word("equals");
+                ++p_;
+            } else if (c == '-' && p_ + 1 < end_ && is_digit(p_[1])) {
+                // "-5" is negative; "GPT-4" and "3-4" are read with a pause
+                if (at_word_start()) {
+                    word("minus");
+                } else {
+                    space();
+                }
+                ++p_;
+            } else if (c == '$' && p_ + 1 < end_ && is_digit(p_[1])) {
+                ++p_;
+                number(Currency::kDollar);
+            } else if (is_digit(c)) {
+                number(Currency::kNone);
+            } else if (is_alpha(c) && at_word_start()) {
+                letters();
+            } else if (static_cast<unsigned char>(c) >= 0x80) {
+                non_ascii();
+            } else {
+                out_ += c;
+                ++p_;
+            }
+        }
+        tidy();
+    }
+
+   private:
+    enum class Currency { kNone, kDollar, kEuro, kPound };
+
+    bool at_word_start() const {
+        return out_.empty() || is_space(out_.back()) || out_.back() == '(' || out_.back() == '"';
+    }
+
+    void space() {
+        if (!out_.empty() && out_.back() != ' ' && out_.back() != '(' && out_.back() != '"') {
+            out_ += ' ';
+        }
+    }
+
+    void word(const char* text) {
+        space();
+        out_ += text;
+        out_ += ' ';
+    }
+
+    // Headings, quotes, bullets and list numbers at the start of a line
+    void skip_line_markup() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t')) {
+            ++p_;
+        }
+        while (p_ < end_ && (*p_ == '#' || *p_ == '>')) {
+            ++p_;
+        }
+        if (p_ + 1 < end_ && (*p_ == '-' || *p_ == '*' || *p_ == '+') && p_[1] == ' ') {
+            p_ += 2;
+            return;
+        }
+        const char* q = p_;
+        while (q < end_ && is_digit(*q)) {
+            ++q;
+        }
+        if (q > p_ && q - p_ <= 3 && q + 1 < end_ && (*q == '.' || *q == ')') && q[1] == ' ') {
+            space();
+            append_cardinal(parse_digits(p_, static_cast<size_t>(q - p_)), out_);
+            out_ += ',';
+            p_ = q + 1;
+        }
+    }
+
+    // Returns the ')' closing "[text](target)" starting at open, or nullptr
+    const char* link_end(const char* open) const {
+        const char* close = static_cast<const char*>(std::memchr(open, ']', end_ - open));
+        if (!close || close + 1 >= end_ || close[1] != '(') {
+            return nullptr;
+        }
+        return static_cast<const char*>(std::memchr(close + 1, ')', end_ - close - 1));
+    }
+
+    // Keeps the text of a link and drops its target
+    void link() {
+        const char* paren = link_end(p_);
+        if (paren) {
+            skip_from_ = static_cast<const char*>(std::memchr(p_, ']', end_ - p_));
+            skip_to_ = paren + 1;
+        }
+        ++p_;
+    }
+
+    void letters() {
+        const Replacement* abbreviation =
+            match_abbreviation(p_, static_cast<size_t>(end_ - p_), true);
+        if (abbreviation) {
+            size_t length = std::strlen(abbreviation->text);
+            // Only whole words: "Dr." but not "Drum."
+            if (p_ + length == end_ || !is_alpha(p_[length])) {
+                // "No." only means number in front of one
+                bool number_sign = std::strcmp(abbreviation->text, "No.") == 0;
+                const char* next = p_ + length;
+                while (next < end_ && *next == ' ') {
+                    ++next;
+                }
+                if (!number_sign || (next < end_ && is_digit(*next))) {
+                    out_ += abbreviation->spoken;
+                    // The period still ends the sentence when nothing follows
+                    if (p_ + length == end_) {
+                        out_ += '.';
+                    }
+                    p_ += length;
+                    return;
+                }
+            }
+        }
+        while (p_ < end_ && is_alpha(*p_)) {
+            out_ += *p_++;
+        }
+    }
+
+    void non_ascii() {
+        uint32_t code = 0;
+        size_t length = decode_utf8(p_, static_cast<size_t>(end_ - p_), &code);
+        if (is_emoji(code)) {
+            space();
+        } else if ((code == 0x20AC || code == 0x00A3) && p_ + length < end_ &&
+                   is_digit(p_[length])) {
+            p_ += length;
+            number(code == 0x20AC ? Currency::kEuro : Currency::kPound);
+            return;
+        } else if (code == 0x00B0) {
+            word("degrees");
+        } else if (code == 0x2014 || code == 0x2013) {
+            out_ += ",";
+            space();
+        } else {
+            out_.append(p_, length);
+        }
+        p_ += length;
+    }
+
+    void number(Currency currency) {
+        // Integer part, with optional thousands separators
+        std::string& digits = digits_;
+        digits.clear();
+        const char* q = p_;
+        while (q < end_) {
+            if (is_digit(*q)) {
+                digits += *q++;
+            } else if (*q == ',' && !digits.empty() && end_ - q >= 4 && is_digit(q[1]) &&
+                       is_digit(q[2]) && is_digit(q[3]) && (end_ - q == 4 || !is_digit(q[4]))) {
+                ++q;  // thousands separator
+            } else {
+                break;
+            }
+        }
+        bool grouped = static_cast<size_t>(q - p_) != digits.size();
+
+        // Clock time: "9:30", "14:05"
+        if (!grouped && currency == Currency::kNone && digits.size() <= 2 && end_ - q >= 3 &&
+            *q == ':' && is_digit(q[1]) && is_digit(q[2]) && (end_ - q == 3 || !is_digit(q[3]))) {
+            space();
+            append_cardinal(parse_digits(digits.data(), digits.size()), out_);
+            unsigned minutes = static_cast<unsigned>((q[1] - '0') * 10 + (q[2] - '0'));
+            if (minutes == 0) {
+                out_ += " o'clock";
+            } else {
+                out_ += minutes < 10 ? " oh " : " ";
+                append_below_thousand(minutes, out_);
+            }
+            p_ = q + 3;
+            return;
+        }
+
+        // Fraction: digits after a '.' are read one by one
+        const char* fraction = nullptr;
+        size_t fraction_length = 0;
+        if (q + 1 < end_ && *q == '.' && is_digit(q[1])) {
+            fraction = q + 1;
+            q = fraction;
+            while (q < end_ && is_digit(*q)) {
+                ++q;
+            }
+            fraction_length = static_cast<size_t>(q - fraction);
+        }
+
+        space();
+        size_t word_start = out_.size();
+        bool digit_by_digit =
+            digits.size() > kMaxCardinalDigits || (digits.size() > 1 && digits[0] == '0');
+        uint64_t value = digit_by_digit ? 0 : parse_digits(digits.data(), digits.size());
+
+        // Ordinal suffix: "1st", "22nd", "3rd", "4th"
+        bool ordinal = false;
+        if (!fraction && !digit_by_digit && end_ - q >= 2) {
+            char a = static_cast<char>(std::tolower(static_cast<unsigned char>(q[0])));
+            char b = static_cast<char>(std::tolower(static_cast<unsigned char>(q[1])));
+            bool suffix = (a == 's' && b == 't') || (a == 'n' && b == 'd') ||
+                          (a == 'r' && b == 'd') || (a == 't' && b == 'h');
+            ordinal = suffix && (q + 2 == end_ || !is_alpha(q[2]));
+        }
+
+        if (digit_by_digit) {
+            append_digits(digits.data(), digits.size(), out_);
+        } else if (!grouped && !fraction && !ordinal && currency == Currency::kNone &&
+                   digits.size() == 4 && value >= 1100 && value < 2100 &&
+                   (q == end_ || *q != '%')) {
+            append_year(static_cast<unsigned>(value), out_);
+        } else {
+            append_cardinal(value, out_);
+        }
+        if (ordinal) {
+            make_ordinal(out_, word_start);
+            q += 2;
+        }
+
+        if (currency != Currency::kNone) {
+            static const char* const kUnits[][2] = {
+                {"", ""}, {"dollar", "dollars"}, {"euro", "euros"}, {"pound", "pounds"}};
+            const char* const* unit = kUnits[static_cast<int>(currency)];
+            // Other decimals come before the unit: "$3.5" -> "three point five dollars"
+            bool point = fraction && fraction_length != 2;
+            if (point) {
+                out_ += " point ";
+                append_digits(fraction, fraction_length, out_);
+                fraction = nullptr;
+            }
+            out_ += ' ';
+            out_ += value == 1 && !point ? unit[0] : unit[1];
+            // Two decimals are the minor unit: "$3.50" -> "three dollars and fifty cents"
+            if (fraction) {
+                unsigned minor = static_cast<unsigned>(parse_digits(fraction, 2));
+                if (minor > 0) {
+                    out_ += " and ";
+                    append_below_thousand(minor, out_);
+                    out_ += currency == Currency::kPound ? " pence"
+                            : minor == 1                 ? " cent"
+                                                         : " cents";
+                }
+                fraction = nullptr;
+            }
+        }
+        if (fraction) {
+            out_ += " point ";
+            append_digits(fraction, fraction_length, out_);
+        }
+        if (q < end_ && *q == '%') {
+            out_ += " percent";
+            ++q;
+        } else if (q < end_ && *q == 's' && currency == Currency::kNone && !fraction &&
+                   !ordinal && (q + 1 == end_ || !is_alpha(q[1]))) {
+            // Plural: "the 1990s" -> "the nineteen nineties"
+            if (out_.back() == 'y') {
+                out_.back() = 'i';
+                out_ += "es";
+            } else {
+                out_ += 's';
+            }
+            ++q;
+        } else if (q < end_ && is_alpha(*q)) {
+            // Units and suffixes are their own word: "16GB", "3D"
+            out_ += ' ';
+        }
+        p_ = q;
+    }
+
+    // Collapses whitespace and drops spaces before punctuation
+    void tidy() {
+        size_t write = 0;
+        for (size_t read = 0; read < out_.size(); ++read) {
+            char c = out_[read];
+            if (is_space(c)) {
+                if (write > 0 && out_[write - 1] != ' ') {
+                    out_[write++] = ' ';
+                }
+                continue;
+            }
+            if ((c == ',' || c == '.' || c == '!' || c == '?' || c == ';' || c == ':') &&
+                write > 0 && out_[write - 1] == ' ') {
+                write--;
+            }
+            if (c == ',' && write > 0 && out_[write - 1] == ',') {
+                continue;
+            }
+            out_[write++] = c;
+        }
+        while (write > 0 && (out_[write - 1] == ' ' || out_[write - 1] == ',')) {
+            write--;
+        }
+        size_t begin = 0;
+        while (begin < write && (out_[begin] == ',' || out_[begin] == ' ')) {
+            begin++;
+        }
+        out_.resize(write);
+        out_.erase(0, begin);
+    }
+
+    const char* p_;
+    const char* end_;
+    std::string& out_;
+    std::string digits_;
+    const char* skip_from_ = nullptr;
+    const char* skip_to_ = nullptr;
+};
+
+}  // namespace
+
+// =============================================================================
+// SEGMENTER
+// =============================================================================
+
+struct rac_tts_segmenter {
+    rac_tts_segmenter_config_t config;
+    std::string pending;
+    size_t scan = 0;
+    bool in_code_block = false;
+    std::string sentence;
+    std::string normalized;
+
+    // Whether the boundary candidate at pending[i] really ends a sentence
+    bool ends_sentence(size_t start, size_t i) const {
+        char c = pending[i];
+        if (c == '\n') {
+            return true;
+        }
+        // The punctuation may be followed by closers: `."`, `.)`, `.**`
+        size_t mark = i;
+        for (size_t n; (n = closer_length(pending, mark)) > 0 && mark - start >= n;) {
+            mark -= n;
+        }
+        c = pending[mark];
+        if (is_utf8_continuation(c)) {
+            return is_cjk_sentence_end(pending, mark);
+        }
+        if (!is_sentence_end(c) || i + 1 >= pending.size() || !is_space(pending[i + 1])) {
+            return false;
+        }
+        if (c != '.') {
+            return true;
+        }
+
+        size_t word = mark;
+        while (word > start && !is_space(pending[word - 1])) {
+            word--;
+        }
+        size_t length = mark + 1 - word;
+        // Initials: "J. R. R. Tolkien"
+        if (length == 2 && std::isupper(static_cast<unsigned char>(pending[word]))) {
+            return false;
+        }
+        const Replacement* abbreviation = match_abbreviation(pending.data() + word, length, false);
+        if (abbreviation && std::strlen(abbreviation->text) == length) {
+            return false;
+        }
+        // A list number at the start of a line: "12. Preheat the oven"
+        bool line_start = word == start || pending[word - 1] == '\n';
+        if (line_start && length <= 4) {
+            bool all_digits = true;
+            for (size_t k = word; k < mark; ++k) {
+                all_digits = all_digits && is_digit(pending[k]);
+            }
+            if (all_digits) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Emits pending[begin, end) unless it is too short to stand alone
+    bool take(size_t begin, size_t end, bool force, rac_tts_sentence_callback_fn callback,
+              void* user_data) {
+        while (begin < end && is_space(pending[begin])) {
+            begin++;
+        }
+        while (end > begin && is_space(pending[end - 1])) {
+            end--;
+        }
+        if (!force && end - begin < static_cast<size_t>(config.min_sentence_chars)) {
+            return false;
+        }
+
+        const std::string* text = &sentence;
+        sentence.clear();
+        if (config.normalize == RAC_TRUE) {
+            // Fenced code blocks are not read out
+            for (size_t line = begin; line < end;) {
+                size_t line_end = pending.find('\n', line);
+                line_end = line_end == std::string::npos || line_end > end ? end : line_end;
+                size_t first = line;
+                while (first < line_end && is_space(pending[first])) {
+                    first++;
+                }
+                if (line_end - first >= 3 && pending.compare(first, 3, "```") == 0) {
+                    in_code_block = !in_code_block;
+                } else if (!in_code_block) {
+                    if (!sentence.empty()) {
+                        sentence += '\n';
+                    }
+                    sentence.append(pending, line, line_end - line);
+                }
+                line = line_end + 1;
+            }
+        } else {
+            sentence.assign(pending, begin, end - begin);
+        }
+        if (config.normalize == RAC_TRUE) {
+            normalized.clear();
+            Normalizer(sentence.data(), sentence.size(), normalized).run();
+            text = &normalized;
+        }
+
+        // Nothing speakable (bare punctuation, emoji, markup) is dropped
+        bool speakable = false;
+        for (size_t k = 0; k < text->size() && !speakable; ++k) {
+            speakable = is_speakable((*text)[k]);
+        }
+        if (speakable && callback) {
+            callback(text->c_str(), user_data);
+        }
+        return true;
+    }
+
+    void feed(const char* text, rac_tts_sentence_callback_fn callback, void* user_data) {
+        pending += text;
+        const size_t max_chars = static_cast<size_t>(config.max_sentence_chars);
+        size_t start = 0;
+        for (size_t i = scan; i < pending.size(); ++i) {
+            if (ends_sentence(start, i) && take(start, i + 1, false, callback, user_data)) {
+                start = i + 1;
+            } else if (max_chars > 0 && i + 1 - start >= max_chars) {
+                size_t space = pending.rfind(' ', i);
+                size_t end = space != std::string::npos && space > start ? space : i + 1;
+                // Never cut a UTF-8 sequence in two; an incomplete one waits
+                // for its remaining bytes
+                end = utf8_cut(pending, start, end);
+                if (end > start) {
+                    take(start, end, true, callback, user_data);
+                    start = end;
+                }
+            }
+        }
+        pending.erase(0, start);
+        // Punctuation (or a closer after it) at the very end is re-examined once
+        // the next character arrives
+        scan = pending.size();
+        if (scan > 0 && (is_sentence_end(pending.back()) || closer_length(pending, scan - 1) > 0)) {
+            scan--;
+        }
+    }
+
+    void flush(rac_tts_sentence_callback_fn callback, void* user_data) {
+        take(0, pending.size(), true, callback, user_data);
+        reset();
+    }
+
+    void reset() {
+        pending.clear();
+        scan = 0;
+        in_code_block = false;
+    }
+};
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_tts_segmenter_create(const rac_tts_segmenter_config_t* config,
+                                      rac_tts_segmenter_handle_t* out_handle) {
+    if (!out_handle) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    const rac_tts_segmenter_config_t& cfg = config ? *config : RAC_TTS_SEGMENTER_CONFIG_DEFAULT;
+    if (cfg.min_sentence_chars < 0 || cfg.max_sentence_chars < 0) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto* segmenter = new (std::nothrow) rac_tts_segmenter();
+    if (!segmenter) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    segmenter->config = cfg;
+    segmenter->pending.reserve(static_cast<size_t>(cfg.max_sentence_chars) * 2);
+
+    *out_handle = segmenter;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_tts_segmenter_feed(rac_tts_segmenter_handle_t handle, const char* text,
+                                    rac_tts_sentence_callback_fn callback, void* user_data) {
+    if (!handle || !text) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    handle->feed(text, callback, user_data);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_tts_segmenter_flush(rac_tts_segmenter_handle_t handle,
+                                     rac_tts_sentence_callback_fn callback, void* user_data) {
+    if (!handle) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    handle->flush(callback, user_data);
+    return RAC_SUCCESS;
+}
+
+void rac_tts_segmenter_reset(rac_tts_segmenter_handle_t handle) {
+    if (handle) {
+        handle->reset();
+    }
+}
+
+void rac_tts_segmenter_destroy(rac_tts_segmenter_handle_t handle) {
+    delete handle;
+}
+
+rac_result_t rac_tts_normalize_text(const char* text, char** out_text) {
+    if (!text || !out_text) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    *out_text = nullptr;
+
+    rac_tts_segmenter segmenter;
+    segmenter.config = RAC_TTS_SEGMENTER_CONFIG_DEFAULT;
+    segmenter.config.max_sentence_chars = 0;
+    std::string joined;
+    auto append = [](const char* sentence, void* user_data) {
+        auto* out = static_cast<std::string*>(user_data);
+        if (!out->empty()) {
+            *out += ' ';
+        }
+        *out += sentence;
+    };
+    segmenter.feed(text, append, &joined);
+    segmenter.flush(append, &joined);
+
+    *out_text = rac_strdup_tagged(RAC_ALLOC_TAG_RESULT, joined.c_str());
+    return *out_text ? RAC_SUCCESS : RAC_ERROR_OUT_OF_MEMORY;
+}
+
+}  // extern "C"
@@ -9,13 +9,18 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <complex>
 #include <cstdio>
 #include <cstring>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
 
+#include "rac/core/rac_audio_aec.h"
+#include "rac/core/rac_audio_kernels.h"
 #include "rac/core/rac_logger.h"
 #include "rac/core/rac_platform_adapter.h"
 #include "rac/core/rac_structured_error.h"
@@ -25,18 +30,290 @@
 // INTERNAL STRUCTURE - Mirrors Swift's SimpleEnergyVADService properties
 // =============================================================================
 
+// Fixed window of the most recent frame energies. Pushing, average and max are
+// all O(1): the sum is kept running and max_ holds the window's decreasing
+// maxima (a monotonic queue), so nothing is shifted or rescanned per frame.
+class EnergyWindow {
+   public:
+    explicit EnergyWindow(size_t capacity)
+        : values_(std::max<size_t>(capacity, 1)), max_(values_.size()) {}
+
+    void push(float energy) {
+        if (count_ == values_.size()) {
+            float oldest = values_[start_];
+            sum_ -= oldest;
+            if (max_count_ > 0 && max_[max_start_].sequence == first_sequence_) {
+                max_start_ = (max_start_ + 1) % max_.size();
+                max_count_--;
+            }
+            start_ = (start_ + 1) % values_.size();
+            first_sequence_++;
+            count_--;
+        }
+
+        uint64_t sequence = first_sequence_ + count_;
+        values_[(start_ + count_) % values_.size()] = energy;
+        count_++;
+        sum_ += energy;
+
+        while (max_count_ > 0 && max_[(max_start_ + max_count_ - 1) % max_.size()].value <= energy) {
+            max_count_--;
+        }
+        max_[(max_start_ + max_count_) % max_.size()] = {sequence, energy};
+        max_count_++;
+    }
+
+    void clear() {
+        start_ = count_ = max_start_ = max_count_ = 0;
+        first_sequence_ = 0;
+        sum_ = 0.0;
+    }
+
+    bool empty() const { return count_ == 0; }
+    float latest() const { return count_ ? values_[(start_ + count_ - 1) % values_.size()] : 0.0f; }
+    float average() const { return count_ ? static_cast<float>(sum_ / count_) : 0.0f; }
+    float max() const { return max_count_ ? max_[max_start_].value : 0.0f; }
+
+   private:
+    struct MaxEntry {
+        uint64_t sequence;
+        float value;
+    };
+
+    std::vector<float> values_;
+    size_t start_ = 0;
+    size_t count_ = 0;
+    uint64_t first_sequence_ = 0;  // sequence number of values_[start_]
+    double sum_ = 0.0;             // double so the running sum does not drift
+
+    std::vector<MaxEntry> max_;
+    size_t max_start_ = 0;
+    size_t max_count_ = 0;
+};
+
+// P-squared streaming quantile estimator (Jain & Chlamtac, 1985). Tracks one
+// quantile of a stream with five markers: constant memory, O(1) per sample and
+// no sorting. Exact while fewer than five samples have been seen.
+class P2Quantile {
+   public:
+    explicit P2Quantile(double p) : p_(p) {}
+
+    void reset() { count_ = 0; }
+    size_t count() const { return count_; }
+
+    void push(float x) {
+        if (count_ < 5) {
+            q_[count_++] = x;
+            std::sort(q_, q_ + count_);
+            if (count_ == 5) {
+                for (int i = 0; i < 5; ++i) {
+                    n_[i] = i;
+                }
+                desired_[0] = 0.0;
+                desired_[1] = 2.0 * p_;
+                desired_[2] = 4.0 * p_;
+                desired_[3] = 2.0 + 2.0 * p_;
+                desired_[4] = 4.0;
+            }
+            return;
+        }
+        count_++;
+
+        int k;
+        if (x < q_[0]) {
+            q_[0] = x;
+            k = 0;
+        } else if (x >= q_[4]) {
+            q_[4] = x;
+            k = 3;
+        } else {
+            k = 0;
+            while (x >= q_[k + 1]) {
+                k++;
+            }
+        }
+
+        const double increments[5] = {0.0, p_ / 2.0, p_, (1.0 + p_) / 2.0, 1.0};
+        for (int i = k + 1; i < 5; ++i) {
+            n_[i]++;
+        }
+        for (int i = 0; i < 5; ++i) {
+            desired_[i] += increments[i];
+        }
+
+        // Move the middle markers toward their desired positions
+        for (int i = 1; i < 4; ++i) {
+            double d = desired_[i] - n_[i];
+            if ((d >= 1.0 && n_[i + 1] - n_[i] > 1) || (d <= -1.0 && n_[i - 1] - n_[i] < -1)) {
+                int step = d > 0 ? 1 : -1;
+                double candidate = parabolic(i, step);
+                if (q_[i - 1] < candidate && candidate < q_[i + 1]) {
+                    q_[i] = candidate;
+                } else {
+                    q_[i] += step * (q_[i + step] - q_[i]) / (n_[i + step] - n_[i]);
+                }
+                n_[i] += step;
+            }
+        }
+    }
+
+    float estimate() const {
+        if (count_ == 0) {
+            return 0.0f;
+        }
+        if (count_ < 5) {
+            return static_cast<float>(
+                q_[std::min(count_ - 1, static_cast<size_t>(count_ * p_))]);
+        }
+        return static_cast<float>(q_[2]);
+    }
+
+   private:
+    double parabolic(int i, int step) const {
+        double span = n_[i + 1] - n_[i - 1];
+        return q_[i] + step / span *
+                           ((n_[i] - n_[i - 1] + step) * (q_[i + 1] - q_[i]) / (n_[i + 1] - n_[i]) +
+                            (n_[i + 1] - n_[i] - step) * (q_[i] - q_[i - 1]) / (n_[i] - n_[i - 1]));
+    }
+
+    double p_;
+    size_t count_ = 0;
+    double q_[5] = {};         // marker heights
+    int64_t n_[5] = {};        // marker positions
+    double desired_[5] = {};   // desired marker positions
+};
+
+// Statistics published by the processing thread after every frame. Readers take
+// a consistent copy without the VAD mutex (seqlock: an odd sequence number means
+// an update is in progress).
+struct StatsSnapshot {
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<float> current{0.0f};
+    std::atomic<float> ambient{0.0f};
+    std::atomic<float> recent_avg{0.0f};
+    std::atomic<float> recent_max{0.0f};
+};
+
+struct SpectralFeatures {
+    float band_ratio = 0.0f;  // share of energy in 200-4000 Hz
+    float flatness = 1.0f;    // geometric / arithmetic mean power in that band
+    float zcr = 0.0f;         // zero crossings per sample
+};
+
+// Cheap spectral features for RAC_ENERGY_VAD_MODE_SPECTRAL: power spectra of
+// 512-sample Hann-windowed blocks, averaged over the frame. About 2.3k
+// butterflies per block, a small fraction of a neural VAD pass.
+class SpectralAnalyzer {
+   public:
+    static constexpr size_t kSize = 512;
+
+    SpectralAnalyzer() : twiddles_(kSize / 2), window_(kSize), buffer_(kSize), power_(kSize / 2 + 1) {
+        const double pi = std::acos(-1.0);
+        for (size_t i = 0; i < kSize / 2; ++i) {
+            twiddles_[i] = std::polar(1.0f, static_cast<float>(-2.0 * pi * i / kSize));
+        }
+        for (size_t i = 0; i < kSize; ++i) {
+            window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * pi * i / (kSize - 1)));
+        }
+    }
+
+    SpectralFeatures analyze(const float* samples, size_t count, int32_t sample_rate) {
+        SpectralFeatures features;
+        if (count < 2 || sample_rate <= 0) {
+            return features;
+        }
+
+        size_t crossings = 0;
+        for (size_t i = 1; i < count; ++i) {
+            crossings += (samples[i - 1] < 0.0f) != (samples[i] < 0.0f);
+        }
+        features.zcr = static_cast<float>(crossings) / static_cast<float>(count - 1);
+
+        std::fill(power_.begin(), power_.end(), 0.0f);
+        for (size_t offset = 0; offset < count; offset += kSize) {
+            size_t n = std::min(kSize, count - offset);
+            if (n < kSize / 2 && offset > 0) {
+                break;  // a short tail adds little beyond the blocks before it
+            }
+            for (size_t i = 0; i < kSize; ++i) {
+                buffer_[i] = i < n ? samples[offset + i] * window_[i] : 0.0f;
+            }
+            transform();
+            for (size_t k = 0; k <= kSize / 2; ++k) {
+                power_[k] += std::norm(buffer_[k]);
+            }
+        }
+
+        const float bin_hz = static_cast<float>(sample_rate) / kSize;
+        size_t band_lo = std::max<size_t>(1, static_cast<size_t>(200.0f / bin_hz));
+        size_t band_hi = std::min(kSize / 2, static_cast<size_t>(4000.0f / bin_hz));
+
+        double total = 0.0;
+        for (size_t k = 1; k <= kSize / 2; ++k) {
+            total += power_[k];
+        }
+        double band = 0.0;
+        double log_sum = 0.0;
+        for (size_t k = band_lo; k <= band_hi; ++k) {
+            band += power_[k];
+            log_sum += std::log(power_[k] + 1e-12);
+        }
+        if (total <= 0.0 || band_hi < band_lo) {
+            return features;
+        }
+
+        size_t bins = band_hi - band_lo + 1;
+        features.band_ratio = static_cast<float>(band / total);
+        features.flatness = static_cast<float>(std::exp(log_sum / bins) / (band / bins + 1e-12));
+        return features;
+    }
+
+   private:
+    // In-place iterative radix-2 FFT of buffer_
+    void transform() {
+        for (size_t i = 1, j = 0; i < kSize; ++i) {
+            size_t bit = kSize >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(buffer_[i], buffer_[j]);
+            }
+        }
+        for (size_t len = 2; len <= kSize; len <<= 1) {
+            size_t stride = kSize / len;
+            for (size_t i = 0; i < kSize; i += len) {
+                for (size_t k = 0; k < len / 2; ++k) {
+                    std::complex<float> t = twiddles_[k * stride] * buffer_[i + k + len / 2];
+                    buffer_[i + k + len / 2] = buffer_[i + k] - t;
+                    buffer_[i + k] += t;
+                }
+            }
+        }
+    }
+
+    std::vector<std::complex<float>> twiddles_;
+    std::vector<float> window_;
+    std::vector<std::complex<float>> buffer_;
+    std::vector<float> power_;
+};
+
 struct rac_energy_vad {
-    // Configuration
+    // Configuration. Thresholds are atomic so control calls never wait on the
+    // audio path; the mutex still serialises everything that processes frames.
     int32_t sample_rate;
     int32_t frame_length_samples;
-    float energy_threshold;
-    float base_energy_threshold;
+    std::atomic<float> energy_threshold;
+    std::atomic<float> base_energy_threshold;
     float tts_threshold_multiplier;
     float calibration_multiplier;
+    rac_energy_vad_mode_t mode;
+    std::unique_ptr<SpectralAnalyzer> spectral;  // only in spectral mode
 
     // State tracking (mirrors Swift's state properties)
     bool is_active;
-    bool is_currently_speaking;
+    std::atomic<bool> is_currently_speaking;
     int32_t consecutive_silent_frames;
     int32_t consecutive_voice_frames;
     bool is_paused;
@@ -48,17 +325,27 @@ struct rac_energy_vad {
     int32_t tts_voice_start_threshold;  // more frames needed during TTS
     int32_t tts_voice_end_threshold;    // quicker end during TTS
 
+    // Echo cancellation: when set, TTS frames are cleaned instead of blocked.
+    // Set once and freed in destroy, so playback threads may read it unlocked.
+    std::atomic<rac_audio_aec_t> aec{nullptr};
+    std::vector<float> aec_output;
+
     // Calibration (mirrors Swift calibration properties)
     bool is_calibrating;
-    std::vector<float> calibration_samples;
+    P2Quantile calibration_quantile{0.90};
     int32_t calibration_frame_count;
     int32_t calibration_frames_needed;
     float ambient_noise_level;
 
+    // Background recalibration: 90th percentile of non-speech frames, applied
+    // every RAC_VAD_RECALIBRATION_FRAMES so the threshold follows the room
+    bool background_recalibration;
+    P2Quantile background_quantile{0.90};
+
     // Debug statistics (mirrors Swift debug properties)
-    std::vector<float> recent_energy_values;
-    int32_t max_recent_values;
+    EnergyWindow recent_energy_values{RAC_VAD_MAX_RECENT_VALUES};
     int32_t debug_frame_count;
+    StatsSnapshot stats;
 
     // Callbacks
     rac_speech_activity_callback_fn speech_callback;
@@ -79,11 +366,12 @@ struct rac_energy_vad {
  * Mirrors Swift's updateVoiceActivityState(hasVoice:)
  */
 static void update_voice_activity_state(rac_energy_vad* vad, bool has_voice) {
-    // Use different thresholds based on TTS state (mirrors Swift logic)
+    // Use different thresholds based on TTS state (mirrors Swift logic). With
+    // echo cancellation the frames are already clean, so normal rules apply.
+    bool tts_guard = vad->is_tts_active && !vad->aec.load();
     int32_t start_threshold =
-        vad->is_tts_active ? vad->tts_voice_start_threshold : vad->voice_start_threshold;
-    int32_t end_threshold =
-        vad->is_tts_active ? vad->tts_voice_end_threshold : vad->voice_end_threshold;
+        tts_guard ? vad->tts_voice_start_threshold : vad->voice_start_threshold;
+    int32_t end_threshold = tts_guard ? vad->tts_voice_end_threshold : vad->voice_end_threshold;
 
     if (has_voice) {
         vad->consecutive_voice_frames++;
@@ -92,7 +380,7 @@ static void update_voice_activity_state(rac_energy_vad* vad, bool has_voice) {
         // Start speaking if we have enough consecutive voice frames
         if (!vad->is_currently_speaking && vad->consecutive_voice_frames >= start_threshold) {
             // Extra validation during TTS to prevent false positives (mirrors Swift)
-            if (vad->is_tts_active) {
+            if (tts_guard) {
                 RAC_LOG_WARNING("EnergyVAD",
                                 "Voice detected during TTS playback - likely feedback! Ignoring.");
                 return;
@@ -123,6 +411,29 @@ static void update_voice_activity_state(rac_energy_vad* vad, bool has_voice) {
     }
 }
 
+/**
+ * Set the ambient noise level and derive the detection threshold from it
+ */
+static void apply_ambient_level(rac_energy_vad* vad, float ambient) {
+    vad->ambient_noise_level = ambient;
+
+    // Calculate dynamic threshold (mirrors Swift logic)
+    float minimum_threshold = std::max(vad->ambient_noise_level * 2.0f, RAC_VAD_MIN_THRESHOLD);
+    float calculated_threshold = vad->ambient_noise_level * vad->calibration_multiplier;
+
+    // Apply threshold with sensible bounds
+    float threshold = std::max(calculated_threshold, minimum_threshold);
+
+    // Cap at reasonable maximum (mirrors Swift cap)
+    if (threshold > RAC_VAD_MAX_THRESHOLD) {
+        threshold = RAC_VAD_MAX_THRESHOLD;
+        RAC_LOG_WARNING("EnergyVAD", "Calibration detected high ambient noise. Capping threshold.");
+    }
+
+    vad->energy_threshold = threshold;
+    vad->base_energy_threshold = threshold;
+}
+
 /**
  * Handle a frame during calibration
  * Mirrors Swift's handleCalibrationFrame(energy:)
@@ -132,57 +443,70 @@ static void handle_calibration_frame(rac_energy_vad* vad, float energy) {
         return;
     }
 
-    vad->calibration_samples.push_back(energy);
+    vad->calibration_quantile.push(energy);
     vad->calibration_frame_count++;
 
     if (vad->calibration_frame_count >= vad->calibration_frames_needed) {
         // Complete calibration - mirrors Swift's completeCalibration()
-        if (vad->calibration_samples.empty()) {
+        if (vad->calibration_quantile.count() == 0) {
             vad->is_calibrating = false;
             return;
         }
 
-        // Calculate statistics (mirrors Swift logic)
-        std::vector<float> sorted_samples = vad->calibration_samples;
-        std::sort(sorted_samples.begin(), sorted_samples.end());
-
-        size_t count = sorted_samples.size();
-        float percentile_90 =
-            sorted_samples[std::min(count - 1, static_cast<size_t>(count * 0.90f))];
-
         // Use 90th percentile as ambient noise level (mirrors Swift)
-        vad->ambient_noise_level = percentile_90;
-
-        // Calculate dynamic threshold (mirrors Swift logic)
-        float minimum_threshold = std::max(vad->ambient_noise_level * 2.0f, RAC_VAD_MIN_THRESHOLD);
-        float calculated_threshold = vad->ambient_noise_level * vad->calibration_multiplier;
-
-        // Apply threshold with sensible bounds
-        vad->energy_threshold = std::max(calculated_threshold, minimum_threshold);
-
-        // Cap at reasonable maximum (mirrors Swift cap)
-        if (vad->energy_threshold > RAC_VAD_MAX_THRESHOLD) {
-            vad->energy_threshold = RAC_VAD_MAX_THRESHOLD;
-            RAC_LOG_WARNING("EnergyVAD",
-                            "Calibration detected high ambient noise. Capping threshold.");
-        }
+        apply_ambient_level(vad, vad->calibration_quantile.estimate());
 
         RAC_LOG_INFO("EnergyVAD", "VAD Calibration Complete");
 
         vad->is_calibrating = false;
-        vad->calibration_samples.clear();
+        vad->calibration_quantile.reset();
     }
 }
 
+/**
+ * Feed a non-speech frame to background recalibration
+ */
+static void handle_background_frame(rac_energy_vad* vad, float energy) {
+    vad->background_quantile.push(energy);
+    if (vad->background_quantile.count() < RAC_VAD_RECALIBRATION_FRAMES) {
+        return;
+    }
+
+    float previous = vad->energy_threshold;
+    apply_ambient_level(vad, vad->background_quantile.estimate());
+    vad->background_quantile.reset();
+
+    RAC_LOG_DEBUG("EnergyVAD", "Background recalibration: threshold %.4f -> %.4f", previous,
+                  vad->energy_threshold.load());
+}
+
+/**
+ * Publish the statistics snapshot read by rac_energy_vad_get_statistics.
+ * Called with the VAD mutex held, so there is only ever one writer.
+ */
+static void publish_statistics(rac_energy_vad* vad) {
+    const EnergyWindow& recent = vad->recent_energy_values;
+    float current = recent.latest();
+    float recent_avg = recent.average();
+    float recent_max = recent.max();
+
+    StatsSnapshot& stats = vad->stats;
+    uint32_t seq = stats.sequence.load(std::memory_order_relaxed);
+    stats.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    stats.current.store(current, std::memory_order_relaxed);
+    stats.ambient.store(vad->ambient_noise_level, std::memory_order_relaxed);
+    stats.recent_avg.store(recent_avg, std::memory_order_relaxed);
+    stats.recent_max.store(recent_max, std::memory_order_relaxed);
+    stats.sequence.store(seq + 2, std::memory_order_release);
+}
+
 /**
  * Update debug statistics
  * Mirrors Swift's updateDebugStatistics(energy:)
  */
 static void update_debug_statistics(rac_energy_vad* vad, float energy) {
-    vad->recent_energy_values.push_back(energy);
-    if (static_cast<int32_t>(vad->recent_energy_values.size()) > vad->max_recent_values) {
-        vad->recent_energy_values.erase(vad->recent_energy_values.begin());
-    }
+    vad->recent_energy_values.push(energy);
 }
 
 // =============================================================================
@@ -207,6 +531,10 @@ rac_result_t rac_energy_vad_create(const rac_energy_vad_config_t* config,
     vad->base_energy_threshold = cfg->energy_threshold;
     vad->calibration_multiplier = RAC_VAD_DEFAULT_CALIBRATION_MULTIPLIER;
     vad->tts_threshold_multiplier = RAC_VAD_DEFAULT_TTS_THRESHOLD_MULTIPLIER;
+    vad->mode = cfg->mode;
+    if (vad->mode == RAC_ENERGY_VAD_MODE_SPECTRAL) {
+        vad->spectral = std::make_unique<SpectralAnalyzer>();
+    }
 
     // State tracking (mirrors Swift defaults)
     vad->is_active = false;
@@ -227,9 +555,9 @@ rac_result_t rac_energy_vad_create(const rac_energy_vad_config_t* config,
     vad->calibration_frame_count = 0;
     vad->calibration_frames_needed = RAC_VAD_CALIBRATION_FRAMES_NEEDED;
     vad->ambient_noise_level = 0.0f;
+    vad->background_recalibration = false;
 
     // Debug (mirrors Swift defaults)
-    vad->max_recent_values = RAC_VAD_MAX_RECENT_VALUES;
     vad->debug_frame_count = 0;
 
     // Callbacks
@@ -249,6 +577,7 @@ void rac_energy_vad_destroy(rac_energy_vad_handle_t handle) {
         return;
     }
 
+    rac_audio_aec_destroy(handle->aec.load());
     delete handle;
     RAC_LOG_DEBUG("EnergyVAD", "SimpleEnergyVADService destroyed");
 }
@@ -270,7 +599,7 @@ rac_result_t rac_energy_vad_initialize(rac_energy_vad_handle_t handle) {
     RAC_LOG_INFO("EnergyVAD", "Starting VAD calibration - measuring ambient noise");
 
     handle->is_calibrating = true;
-    handle->calibration_samples.clear();
+    handle->calibration_quantile.reset();
     handle->calibration_frame_count = 0;
 
     return RAC_SUCCESS;
@@ -358,8 +687,9 @@ rac_result_t rac_energy_vad_process_audio(rac_energy_vad_handle_t handle, const
         return RAC_SUCCESS;
     }
 
-    // Complete audio blocking during TTS (mirrors Swift)
-    if (handle->is_tts_active) {
+    // Complete audio blocking during TTS (mirrors Swift), unless echo is cancelled
+    rac_audio_aec_t aec = handle->aec.load();
+    if (handle->is_tts_active && !aec) {
         if (out_has_voice)
             *out_has_voice = RAC_FALSE;
         return RAC_SUCCESS;
@@ -371,6 +701,13 @@ rac_result_t rac_energy_vad_process_audio(rac_energy_vad_handle_t handle, const
         return RAC_SUCCESS;
     }
 
+    // Remove the playback echo while TTS plays and until its tail has died out
+    if (aec && (handle->is_tts_active || rac_audio_aec_is_active(aec))) {
+        handle->aec_output.resize(sample_count);
+        rac_audio_aec_process(aec, audio_data, handle->aec_output.data(), sample_count);
+        audio_data = handle->aec_output.data();
+    }
+
     // Calculate energy using RMS
     float energy = rac_energy_vad_calculate_rms(audio_data, sample_count);
 
@@ -380,13 +717,34 @@ rac_result_t rac_energy_vad_process_audio(rac_energy_vad_handle_t handle, const
     // Handle calibration if active (mirrors Swift)
     if (handle->is_calibrating) {
         handle_calibration_frame(handle, energy);
+        publish_statistics(handle);
         if (out_has_voice)
             *out_has_voice = RAC_FALSE;
         return RAC_SUCCESS;
     }
 
+    if (handle->background_recalibration && !handle->is_currently_speaking) {
+        handle_background_frame(handle, energy);
+    }
+
+    publish_statistics(handle);
+
     bool has_voice = energy > handle->energy_threshold;
 
+    // Loud enough; in spectral mode also require a speech-like spectrum
+    if (has_voice && handle->spectral) {
+        SpectralFeatures features =
+            handle->spectral->analyze(audio_data, sample_count, handle->sample_rate);
+        has_voice = features.band_ratio >= RAC_VAD_SPECTRAL_MIN_BAND_RATIO &&
+                    features.flatness <= RAC_VAD_SPECTRAL_MAX_FLATNESS &&
+                    features.zcr <= RAC_VAD_SPECTRAL_MAX_ZCR;
+        if (!has_voice) {
+            RAC_LOG_DEBUG("EnergyVAD",
+                          "Rejected loud frame: band ratio %.2f, flatness %.2f, zcr %.2f",
+                          features.band_ratio, features.flatness, features.zcr);
+        }
+    }
+
     // Update state (mirrors Swift's updateVoiceActivityState)
     update_voice_activity_state(handle, has_voice);
 
@@ -409,11 +767,7 @@ float rac_energy_vad_calculate_rms(const float* audio_data, size_t sample_count)
 
     // RMS calculation: sqrt(sum(x^2) / N)
     // Mirrors Swift's calculateAverageEnergy using vDSP_rmsqv
-    float sum_squares = 0.0f;
-    for (size_t i = 0; i < sample_count; ++i) {
-        sum_squares += audio_data[i] * audio_data[i];
-    }
-    return std::sqrt(sum_squares / static_cast<float>(sample_count));
+    return rac_audio_rms(audio_data, sample_count);
 }
 
 rac_result_t rac_energy_vad_pause(rac_energy_vad_handle_t handle) {
@@ -441,6 +795,7 @@ rac_result_t rac_energy_vad_pause(rac_energy_vad_handle_t handle) {
 
     // Clear recent energy values
     handle->recent_energy_values.clear();
+    publish_statistics(handle);
     handle->consecutive_silent_frames = 0;
     handle->consecutive_voice_frames = 0;
 
@@ -467,6 +822,7 @@ rac_result_t rac_energy_vad_resume(rac_energy_vad_handle_t handle) {
     handle->consecutive_voice_frames = 0;
     handle->recent_energy_values.clear();
     handle->debug_frame_count = 0;
+    publish_statistics(handle);
 
     RAC_LOG_INFO("EnergyVAD", "VAD resumed");
     return RAC_SUCCESS;
@@ -482,7 +838,7 @@ rac_result_t rac_energy_vad_start_calibration(rac_energy_vad_handle_t handle) {
     RAC_LOG_INFO("EnergyVAD", "Starting VAD calibration");
 
     handle->is_calibrating = true;
-    handle->calibration_samples.clear();
+    handle->calibration_quantile.reset();
     handle->calibration_frame_count = 0;
 
     return RAC_SUCCESS;
@@ -514,6 +870,20 @@ rac_result_t rac_energy_vad_set_calibration_multiplier(rac_energy_vad_handle_t h
     return RAC_SUCCESS;
 }
 
+rac_result_t rac_energy_vad_set_background_recalibration(rac_energy_vad_handle_t handle,
+                                                        rac_bool_t enabled) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+
+    handle->background_recalibration = enabled == RAC_TRUE;
+    handle->background_quantile.reset();
+
+    return RAC_SUCCESS;
+}
+
 rac_result_t rac_energy_vad_notify_tts_start(rac_energy_vad_handle_t handle) {
     if (!handle) {
         return RAC_ERROR_INVALID_ARGUMENT;
@@ -525,7 +895,7 @@ rac_result_t rac_energy_vad_notify_tts_start(rac_energy_vad_handle_t handle) {
     handle->is_tts_active = true;
 
     // Save base threshold
-    handle->base_energy_threshold = handle->energy_threshold;
+    handle->base_energy_threshold = handle->energy_threshold.load();
 
     // Increase threshold significantly to prevent TTS audio from triggering VAD
     float new_threshold = handle->energy_threshold * handle->tts_threshold_multiplier;
@@ -559,7 +929,7 @@ rac_result_t rac_energy_vad_notify_tts_finish(rac_energy_vad_handle_t handle) {
     handle->is_tts_active = false;
 
     // Immediately restore threshold
-    handle->energy_threshold = handle->base_energy_threshold;
+    handle->energy_threshold = handle->base_energy_threshold.load();
 
     RAC_LOG_INFO("EnergyVAD", "TTS finished - VAD threshold restored");
 
@@ -569,6 +939,7 @@ rac_result_t rac_energy_vad_notify_tts_finish(rac_energy_vad_handle_t handle) {
     handle->consecutive_voice_frames = 0;
     handle->is_currently_speaking = false;
     handle->debug_frame_count = 0;
+    publish_statistics(handle);
 
     return RAC_SUCCESS;
 }
@@ -586,14 +957,51 @@ rac_result_t rac_energy_vad_set_tts_multiplier(rac_energy_vad_handle_t handle, f
     return RAC_SUCCESS;
 }
 
+rac_result_t rac_energy_vad_enable_echo_cancellation(rac_energy_vad_handle_t handle,
+                                                     const rac_audio_aec_config_t* config) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+
+    if (handle->aec.load()) {
+        return RAC_ERROR_ALREADY_INITIALIZED;
+    }
+
+    rac_audio_aec_config_t aec_config = RAC_AUDIO_AEC_CONFIG_DEFAULT;
+    aec_config.sample_rate = handle->sample_rate;
+    if (config) {
+        aec_config = *config;
+    }
+
+    rac_audio_aec_t aec = nullptr;
+    rac_result_t result = rac_audio_aec_create(&aec_config, &aec);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+    handle->aec = aec;
+
+    RAC_LOG_INFO("EnergyVAD", "Echo cancellation enabled - TTS audio no longer blocked");
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_energy_vad_feed_playback(rac_energy_vad_handle_t handle, const float* samples,
+                                          size_t num_samples) {
+    if (!handle || !samples) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    rac_audio_aec_feed_reference(handle->aec.load(), samples, num_samples);
+    return RAC_SUCCESS;
+}
+
 rac_result_t rac_energy_vad_is_speech_active(rac_energy_vad_handle_t handle,
                                              rac_bool_t* out_is_active) {
     if (!handle || !out_is_active) {
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
-
     // Mirrors Swift's isSpeechActive
     *out_is_active = handle->is_currently_speaking ? RAC_TRUE : RAC_FALSE;
 
@@ -605,7 +1013,6 @@ rac_result_t rac_energy_vad_get_threshold(rac_energy_vad_handle_t handle, float*
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
     *out_threshold = handle->energy_threshold;
 
     return RAC_SUCCESS;
@@ -616,7 +1023,7 @@ rac_result_t rac_energy_vad_set_threshold(rac_energy_vad_handle_t handle, float
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    // Takes effect from the next frame; never waits for the one in flight
     handle->energy_threshold = threshold;
     handle->base_energy_threshold = threshold;
 
@@ -629,27 +1036,19 @@ rac_result_t rac_energy_vad_get_statistics(rac_energy_vad_handle_t handle,
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
-
-    // Mirrors Swift's getStatistics()
-    float recent_avg = 0.0f;
-    float recent_max = 0.0f;
-    float current = 0.0f;
-
-    if (!handle->recent_energy_values.empty()) {
-        for (float val : handle->recent_energy_values) {
-            recent_avg += val;
-            recent_max = std::max(recent_max, val);
-        }
-        recent_avg /= static_cast<float>(handle->recent_energy_values.size());
-        current = handle->recent_energy_values.back();
-    }
+    // Mirrors Swift's getStatistics(), reading the last published snapshot
+    const StatsSnapshot& stats = handle->stats;
+    uint32_t seq;
+    do {
+        seq = stats.sequence.load(std::memory_order_acquire);
+        out_stats->current = stats.current.load(std::memory_order_relaxed);
+        out_stats->ambient = stats.ambient.load(std::memory_order_relaxed);
+        out_stats->recent_avg = stats.recent_avg.load(std::memory_order_relaxed);
+        out_stats->recent_max = stats.recent_max.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) != 0 || seq != stats.sequence.load(std::memory_order_relaxed));
 
-    out_stats->current = current;
     out_stats->threshold = handle->energy_threshold;
-    out_stats->ambient = handle->ambient_noise_level;
-    out_stats->recent_avg = recent_avg;
-    out_stats->recent_max = recent_max;
 
     return RAC_SUCCESS;
 }
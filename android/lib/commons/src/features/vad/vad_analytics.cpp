@@ -11,6 +11,7 @@
 #include <mutex>
 
 #include "rac/core/rac_logger.h"
+#include "rac/core/rac_metrics.h"
 #include "rac/features/vad/rac_vad_analytics.h"
 
 // =============================================================================
@@ -200,6 +201,11 @@ rac_result_t rac_vad_analytics_track_speech_end(rac_vad_analytics_handle_t handl
     handle->last_event_time_ms = end_time_ms;
     handle->has_last_event_time = true;
 
+    static const rac::MetricCounter speech_segments("vad.speech_segments");
+    static const rac::MetricHistogram speech_ms("vad.speech_ms");
+    speech_segments.add();
+    speech_ms.record(static_cast<int64_t>(duration_ms));
+
     log_debug("VAD.Analytics", "Speech ended: %.1fms", duration_ms);
     return RAC_SUCCESS;
 }
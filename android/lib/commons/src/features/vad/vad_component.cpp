@@ -9,13 +9,23 @@
  * Do NOT add features not present in the Swift code.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
+#include "core/rac_sample_ring.h"
 #include "rac/core/capabilities/rac_lifecycle.h"
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_analytics_events.h"
+#include "rac/core/rac_audio_kernels.h"
+#include "rac/core/rac_cpu_budget.h"
 #include "rac/core/rac_logger.h"
 #include "rac/core/rac_platform_adapter.h"
 #include "rac/core/rac_structured_error.h"
@@ -27,6 +37,8 @@
 // INTERNAL STRUCTURES
 // =============================================================================
 
+using rac::SampleRing;
+
 struct rac_vad_component {
     /** Energy VAD service handle */
     rac_energy_vad_handle_t vad_service;
@@ -48,6 +60,14 @@ struct rac_vad_component {
     /** Mutex for thread safety */
     std::mutex mtx;
 
+    /** Asynchronous pipeline (rac_vad_component_start_pipeline) */
+    std::unique_ptr<SampleRing> ring;
+    std::thread worker;
+    std::atomic<bool> pipeline_running{false};
+    std::mutex wake_mtx;
+    std::condition_variable wake_cv;
+    rac_audio_thread_config_t pipeline_thread = RAC_AUDIO_THREAD_CONFIG_DEFAULT;
+
     rac_vad_component()
         : vad_service(nullptr),
           activity_callback(nullptr),
@@ -238,6 +258,9 @@ extern "C" rac_result_t rac_vad_component_cleanup(rac_handle_t handle) {
     if (!handle)
         return RAC_ERROR_INVALID_HANDLE;
 
+    // The worker takes the component lock, so it has to be joined first
+    rac_vad_component_stop_pipeline(handle);
+
     auto* component = reinterpret_cast<rac_vad_component*>(handle);
     std::lock_guard<std::mutex> lock(component->mtx);
 
@@ -366,6 +389,65 @@ extern "C" rac_result_t rac_vad_component_reset(rac_handle_t handle) {
     return rac_energy_vad_reset(component->vad_service);
 }
 
+extern "C" rac_result_t rac_vad_component_notify_tts_start(rac_handle_t handle) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_vad_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->mtx);
+
+    if (!component->vad_service) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    return rac_energy_vad_notify_tts_start(component->vad_service);
+}
+
+extern "C" rac_result_t rac_vad_component_notify_tts_finish(rac_handle_t handle) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_vad_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->mtx);
+
+    if (!component->vad_service) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    return rac_energy_vad_notify_tts_finish(component->vad_service);
+}
+
+extern "C" rac_result_t rac_vad_component_enable_echo_cancellation(
+    rac_handle_t handle, const rac_audio_aec_config_t* config) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_vad_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->mtx);
+
+    if (!component->vad_service) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    return rac_energy_vad_enable_echo_cancellation(component->vad_service, config);
+}
+
+extern "C" rac_result_t rac_vad_component_feed_playback(rac_handle_t handle, const float* samples,
+                                                        size_t num_samples) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_vad_component*>(handle);
+    // No component lock: playback must not wait for a frame being processed,
+    // and the energy VAD only queues the samples under its own lock
+    rac_energy_vad_handle_t service = component->vad_service;
+    if (!service) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    return rac_energy_vad_feed_playback(service, samples, num_samples);
+}
+
 // =============================================================================
 // PROCESSING API
 // =============================================================================
@@ -405,6 +487,259 @@ extern "C" rac_result_t rac_vad_component_process(rac_handle_t handle, const flo
     return RAC_SUCCESS;
 }
 
+extern "C" rac_result_t rac_vad_component_process_frames(rac_handle_t handle, const float* samples,
+                                                         size_t num_samples,
+                                                         size_t frame_length_samples,
+                                                         rac_bool_t* out_decisions,
+                                                         size_t max_decisions, size_t* out_frames) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!samples || !out_decisions || !out_frames)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    *out_frames = 0;
+    auto* component = reinterpret_cast<rac_vad_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->mtx);
+
+    if (!component->is_initialized || !component->vad_service) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+    if (frame_length_samples == 0) {
+        frame_length_samples = static_cast<size_t>(component->config.frame_length *
+                                                   component->config.sample_rate);
+    }
+    if (frame_length_samples == 0) {
+        return RAC_ERROR_INVALID_PARAMETER;
+    }
+
+    size_t frames = 0;
+    for (size_t offset = 0; frames < max_decisions && offset + frame_length_samples <= num_samples;
+         offset += frame_length_samples) {
+        rac_bool_t has_voice = RAC_FALSE;
+        rac_result_t result = rac_energy_vad_process_audio(
+            component->vad_service, samples + offset, frame_length_samples, &has_voice);
+        if (result != RAC_SUCCESS) {
+            *out_frames = frames;
+            return result;
+        }
+        out_decisions[frames++] = has_voice;
+
+        if (component->audio_callback) {
+            component->audio_callback(samples + offset, frame_length_samples * sizeof(float),
+                                      component->audio_user_data);
+        }
+    }
+
+    *out_frames = frames;
+    return RAC_SUCCESS;
+}
+
+extern "C" rac_result_t rac_vad_component_process_buffer(rac_handle_t handle, const float* samples,
+                                                         size_t num_samples,
+                                                         size_t frame_length_samples,
+                                                         rac_vad_segment_t** out_segments,
+                                                         size_t* out_count) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!samples || !out_segments || !out_count)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* component = reinterpret_cast<rac_vad_component*>(handle);
+    int32_t sample_rate = 0;
+    float threshold = 0.0f;
+    {
+        std::lock_guard<std::mutex> lock(component->mtx);
+        sample_rate = component->config.sample_rate;
+        threshold = component->config.energy_threshold;
+        if (component->vad_service) {
+            rac_energy_vad_get_threshold(component->vad_service, &threshold);
+        }
+        if (frame_length_samples == 0) {
+            frame_length_samples =
+                static_cast<size_t>(component->config.frame_length * sample_rate);
+        }
+    }
+    if (sample_rate <= 0 || frame_length_samples == 0) {
+        return RAC_ERROR_INVALID_PARAMETER;
+    }
+
+    // Same hysteresis as rac_energy_vad_process_audio, compared on squared
+    // energy so each frame costs one vectorised sum of squares
+    const float frame_threshold = threshold * threshold * static_cast<float>(frame_length_samples);
+    const double ms_per_sample = 1000.0 / sample_rate;
+    std::vector<rac_vad_segment_t> segments;
+    bool speaking = false;
+    int32_t voice_frames = 0;
+    int32_t silent_frames = 0;
+    size_t segment_start = 0;
+    size_t last_voice_end = 0;
+
+    for (size_t offset = 0; offset + frame_length_samples <= num_samples;
+         offset += frame_length_samples) {
+        bool has_voice =
+            rac_audio_sum_squares(samples + offset, frame_length_samples) > frame_threshold;
+
+        if (has_voice) {
+            silent_frames = 0;
+            if (++voice_frames == 1 && !speaking) {
+                segment_start = offset;
+            }
+            last_voice_end = offset + frame_length_samples;
+            if (!speaking && voice_frames >= RAC_VAD_VOICE_START_THRESHOLD) {
+                speaking = true;
+            }
+        } else {
+            voice_frames = 0;
+            if (speaking && ++silent_frames >= RAC_VAD_VOICE_END_THRESHOLD) {
+                speaking = false;
+                segments.push_back({segment_start * ms_per_sample, last_voice_end * ms_per_sample});
+            }
+        }
+    }
+    if (speaking) {
+        segments.push_back({segment_start * ms_per_sample, last_voice_end * ms_per_sample});
+    }
+
+    *out_segments = nullptr;
+    *out_count = 0;
+    if (segments.empty()) {
+        return RAC_SUCCESS;
+    }
+    *out_segments =
+        static_cast<rac_vad_segment_t*>(rac_alloc_tagged(
+            RAC_ALLOC_TAG_RESULT, segments.size() * sizeof(rac_vad_segment_t)));
+    if (!*out_segments) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    memcpy(*out_segments, segments.data(), segments.size() * sizeof(rac_vad_segment_t));
+    *out_count = segments.size();
+
+    return RAC_SUCCESS;
+}
+
+extern "C" void rac_vad_segments_free(rac_vad_segment_t* segments) {
+    rac_free(segments);
+}
+
+// =============================================================================
+// PIPELINE API
+// =============================================================================
+
+static void vad_pipeline_worker(rac_vad_component* component, size_t frame_samples,
+                                rac_audio_thread_config_t thread_config) {
+    rac_audio_thread_priority_t priority = RAC_AUDIO_THREAD_PRIORITY_NORMAL;
+    rac_cpu_budget_promote_audio_thread(&thread_config, &priority);
+    log_debug("VAD.Component", "Pipeline worker running at audio priority %d",
+              static_cast<int>(priority));
+
+    std::vector<float> frame(frame_samples);
+
+    while (true) {
+        bool running = component->pipeline_running.load(std::memory_order_acquire);
+        size_t available = component->ring->size();
+
+        if (available >= frame_samples || (!running && available > 0)) {
+            size_t n = component->ring->read(frame.data(), frame_samples);
+            rac_vad_component_process(reinterpret_cast<rac_handle_t>(component), frame.data(), n,
+                                      nullptr);
+            continue;
+        }
+        if (!running) {
+            break;
+        }
+
+        // The producer notifies without the lock, so a wakeup can be missed;
+        // the timeout bounds the extra latency to a fraction of a frame
+        std::unique_lock<std::mutex> lock(component->wake_mtx);
+        component->wake_cv.wait_for(lock, std::chrono::milliseconds(5));
+    }
+}
+
+extern "C" rac_result_t rac_vad_component_start_pipeline(rac_handle_t handle,
+                                                         size_t capacity_samples) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_vad_component*>(handle);
+    size_t frame_samples = 0;
+    rac_audio_thread_config_t thread_config;
+    {
+        std::lock_guard<std::mutex> lock(component->mtx);
+
+        if (!component->is_initialized || !component->vad_service) {
+            return RAC_ERROR_NOT_INITIALIZED;
+        }
+        if (component->pipeline_running) {
+            return RAC_SUCCESS;
+        }
+
+        int32_t sample_rate = component->config.sample_rate;
+        frame_samples = static_cast<size_t>(component->config.frame_length * sample_rate);
+        if (frame_samples == 0) {
+            frame_samples = 1;
+        }
+        if (capacity_samples == 0) {
+            capacity_samples = static_cast<size_t>(sample_rate);
+        }
+        component->ring = std::make_unique<SampleRing>(std::max(capacity_samples, frame_samples));
+        component->pipeline_running = true;
+        thread_config = component->pipeline_thread;
+    }
+
+    component->worker = std::thread(vad_pipeline_worker, component, frame_samples, thread_config);
+
+    log_info("VAD.Component", "VAD pipeline started");
+    return RAC_SUCCESS;
+}
+
+extern "C" rac_result_t
+rac_vad_component_set_pipeline_thread(rac_handle_t handle,
+                                      const rac_audio_thread_config_t* config) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_vad_component*>(handle);
+    std::lock_guard<std::mutex> lock(component->mtx);
+    component->pipeline_thread = config ? *config : RAC_AUDIO_THREAD_CONFIG_DEFAULT;
+    return RAC_SUCCESS;
+}
+
+extern "C" rac_result_t rac_vad_component_push_audio(rac_handle_t handle, const float* samples,
+                                                     size_t num_samples) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+    if (!samples || num_samples == 0)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* component = reinterpret_cast<rac_vad_component*>(handle);
+    if (!component->pipeline_running.load(std::memory_order_acquire)) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    size_t written = component->ring->write(samples, num_samples);
+    component->wake_cv.notify_one();
+
+    return written == num_samples ? RAC_SUCCESS : RAC_ERROR_BUFFER_TOO_SMALL;
+}
+
+extern "C" rac_result_t rac_vad_component_stop_pipeline(rac_handle_t handle) {
+    if (!handle)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    auto* component = reinterpret_cast<rac_vad_component*>(handle);
+    if (!component->pipeline_running.exchange(false)) {
+        return RAC_SUCCESS;
+    }
+
+    component->wake_cv.notify_one();
+    if (component->worker.joinable()) {
+        component->worker.join();
+    }
+
+    log_info("VAD.Component", "VAD pipeline stopped");
+    return RAC_SUCCESS;
+}
+
 // =============================================================================
 // STATE QUERY API
 // =============================================================================
@@ -8,20 +8,43 @@
  * CRITICAL: This is a direct port of Swift implementation - do NOT add custom logic!
  */
 
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <future>
+#include <memory>
 #include <mutex>
-
+#include <new>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/rac_sample_ring.h"
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_analytics_events.h"
+#include "rac/core/rac_audio_capture.h"
+#include "rac/core/rac_audio_kernels.h"
 #include "rac/core/rac_audio_utils.h"
 #include "rac/core/rac_logger.h"
 #include "rac/core/rac_platform_adapter.h"
 #include "rac/core/rac_structured_error.h"
+#include "rac/features/kws/rac_kws_service.h"
 #include "rac/features/llm/rac_llm_component.h"
 #include "rac/features/llm/rac_llm_types.h"
 #include "rac/features/stt/rac_stt_component.h"
 #include "rac/features/stt/rac_stt_types.h"
 #include "rac/features/tts/rac_tts_component.h"
+#include "rac/features/tts/rac_tts_segmenter.h"
 #include "rac/features/tts/rac_tts_types.h"
 #include "rac/features/vad/rac_vad_component.h"
 #include "rac/features/vad/rac_vad_types.h"
@@ -55,8 +78,18 @@ struct rac_voice_agent {
     rac_handle_t tts_handle;
     rac_handle_t vad_handle;
 
-    // Thread safety
-    std::mutex mutex;
+    // TTS voice loading in the background (load_config.defer_tts); written
+    // under the exclusive lifecycle lock, awaited before the voice is used
+    std::shared_future<rac_result_t> deferred_tts;
+
+    // How synthesized speech is handed out; written under the exclusive
+    // lifecycle lock, read by processing calls under the shared one
+    rac_voice_output_config_t output = RAC_VOICE_OUTPUT_CONFIG_DEFAULT;
+
+    // Held exclusively while models load or unload and shared by every
+    // processing call. Each component serializes its own calls, so VAD and
+    // STT keep running while another thread generates or synthesizes.
+    std::shared_mutex lifecycle_mutex;
 
     rac_voice_agent()
         : is_configured(false),
@@ -105,6 +138,18 @@ static rac_result_t validate_component_ready(const char* component_name, rac_han
     return RAC_SUCCESS;
 }
 
+/**
+ * @brief Wait for a TTS voice loading in the background (defer_tts)
+ *
+ * Called with the lifecycle lock held, shared or exclusive.
+ */
+static rac_result_t await_deferred_tts(rac_voice_agent_handle_t handle) {
+    if (!handle->deferred_tts.valid()) {
+        return RAC_SUCCESS;
+    }
+    return handle->deferred_tts.get();
+}
+
 /**
  * @brief Validate all voice agent components are ready for processing
  *
@@ -130,7 +175,8 @@ static rac_result_t validate_all_components_ready(rac_voice_agent_handle_t handl
         return result;
     }
 
-    // Validate TTS component
+    // Validate TTS component, once a deferred voice has finished loading
+    await_deferred_tts(handle);
     result = validate_component_ready("TTS", handle->tts_handle, rac_tts_component_get_state);
     if (result != RAC_SUCCESS) {
         return result;
@@ -139,6 +185,242 @@ static rac_result_t validate_all_components_ready(rac_voice_agent_handle_t handl
     return RAC_SUCCESS;
 }
 
+// =============================================================================
+// TURN TRACING
+// =============================================================================
+
+static int64_t monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief Reset a trace and start its TURN and FIRST_AUDIO spans
+ */
+static void trace_start_turn(rac_voice_turn_trace_t* trace, int64_t at_ns) {
+    // Parent of each stage, indexed by rac_voice_turn_stage_t
+    static const int32_t kParents[RAC_VOICE_TURN_STAGE_COUNT] = {
+        -1,
+        RAC_VOICE_TURN_STAGE_TURN,
+        RAC_VOICE_TURN_STAGE_TURN,
+        RAC_VOICE_TURN_STAGE_TURN,
+        RAC_VOICE_TURN_STAGE_LLM,
+        RAC_VOICE_TURN_STAGE_TURN,
+        RAC_VOICE_TURN_STAGE_TTS,
+        RAC_VOICE_TURN_STAGE_TURN};
+
+    for (int32_t i = 0; i < RAC_VOICE_TURN_STAGE_COUNT; ++i) {
+        trace->spans[i].stage = static_cast<rac_voice_turn_stage_t>(i);
+        trace->spans[i].parent = kParents[i];
+        trace->spans[i].start_ns = 0;
+        trace->spans[i].end_ns = 0;
+    }
+    trace->spans[RAC_VOICE_TURN_STAGE_TURN].start_ns = at_ns;
+    trace->spans[RAC_VOICE_TURN_STAGE_FIRST_AUDIO].start_ns = at_ns;
+}
+
+static void trace_begin(rac_voice_turn_trace_t* trace, rac_voice_turn_stage_t stage) {
+    if (trace && trace->spans[stage].start_ns == 0) {
+        trace->spans[stage].start_ns = monotonic_ns();
+    }
+}
+
+// Ends a started span; later calls move the end (e.g. TTS after each sentence)
+static void trace_end(rac_voice_turn_trace_t* trace, rac_voice_turn_stage_t stage,
+                      bool first_only = false) {
+    if (!trace || trace->spans[stage].start_ns == 0 ||
+        (first_only && trace->spans[stage].end_ns != 0)) {
+        return;
+    }
+    trace->spans[stage].end_ns = monotonic_ns();
+}
+
+/**
+ * @brief Close the turn and emit it as a VOICE_AGENT_TURN_* analytics event
+ */
+static void trace_report_turn(rac_voice_turn_trace_t* trace, rac_result_t result) {
+    trace_end(trace, RAC_VOICE_TURN_STAGE_TURN, true);
+
+    rac_event_type_t type = result == RAC_SUCCESS ? RAC_EVENT_VOICE_AGENT_TURN_COMPLETED
+                                                  : RAC_EVENT_VOICE_AGENT_TURN_FAILED;
+    rac_analytics_event_data_t event = {};
+    event.type = type;
+    rac_analytics_voice_agent_turn_t& turn = event.data.voice_agent_turn;
+    turn.total_ms = rac_voice_turn_trace_stage_ms(trace, RAC_VOICE_TURN_STAGE_TURN);
+    turn.endpoint_ms = rac_voice_turn_trace_stage_ms(trace, RAC_VOICE_TURN_STAGE_ENDPOINT);
+    turn.stt_ms = rac_voice_turn_trace_stage_ms(trace, RAC_VOICE_TURN_STAGE_STT);
+    turn.llm_ms = rac_voice_turn_trace_stage_ms(trace, RAC_VOICE_TURN_STAGE_LLM);
+    turn.llm_first_token_ms =
+        rac_voice_turn_trace_stage_ms(trace, RAC_VOICE_TURN_STAGE_LLM_FIRST_TOKEN);
+    turn.tts_ms = rac_voice_turn_trace_stage_ms(trace, RAC_VOICE_TURN_STAGE_TTS);
+    turn.tts_first_chunk_ms =
+        rac_voice_turn_trace_stage_ms(trace, RAC_VOICE_TURN_STAGE_TTS_FIRST_CHUNK);
+    turn.first_audio_ms = rac_voice_turn_trace_stage_ms(trace, RAC_VOICE_TURN_STAGE_FIRST_AUDIO);
+    turn.error_code = result;
+    rac_analytics_event_emit(type, &event);
+
+    RAC_LOG_DEBUG("VoiceAgent",
+                  "Turn trace: total %.0f ms, stt %.0f, first token %.0f, llm %.0f, "
+                  "first chunk %.0f, first audio %.0f",
+                  turn.total_ms, turn.stt_ms, turn.llm_first_token_ms, turn.llm_ms,
+                  turn.tts_first_chunk_ms, turn.first_audio_ms);
+}
+
+double rac_voice_turn_trace_stage_ms(const rac_voice_turn_trace_t* trace,
+                                     rac_voice_turn_stage_t stage) {
+    if (!trace || stage < 0 || stage >= RAC_VOICE_TURN_STAGE_COUNT) {
+        return -1.0;
+    }
+    const rac_voice_turn_span_t& span = trace->spans[stage];
+    if (span.start_ns == 0 || span.end_ns == 0) {
+        return -1.0;
+    }
+    return static_cast<double>(span.end_ns - span.start_ns) / 1e6;
+}
+
+// =============================================================================
+// AUDIO OUTPUT
+// =============================================================================
+
+static int32_t tts_sample_rate(const rac_tts_result_t& tts) {
+    return tts.sample_rate > 0 ? tts.sample_rate : RAC_TTS_DEFAULT_SAMPLE_RATE;
+}
+
+/**
+ * @brief Encode a synthesis result in the configured output format
+ *
+ * Raw PCM reuses the synthesizer's buffer when it is plain malloc'd memory:
+ * Float32 is handed over as is and Int16 is narrowed in place. Otherwise the
+ * samples are copied once.
+ *
+ * @param format Output format
+ * @param tts Synthesis result (its buffer may be taken over)
+ * @param out_audio Output: Encoded audio (owned, free with rac_free)
+ * @param out_size Output: Size of out_audio in bytes
+ */
+static rac_result_t encode_tts_audio(rac_voice_audio_format_t format, rac_tts_result_t* tts,
+                                     void** out_audio, size_t* out_size) {
+    if (format == RAC_VOICE_AUDIO_FORMAT_WAV) {
+        return rac_audio_float32_to_wav(tts->audio_data, tts->audio_size, tts_sample_rate(*tts),
+                                        out_audio, out_size);
+    }
+
+    const size_t count = tts->audio_size / sizeof(float);
+    const bool narrow = format == RAC_VOICE_AUDIO_FORMAT_PCM_S16;
+    const size_t size = count * (narrow ? sizeof(int16_t) : sizeof(float));
+    const float* samples = static_cast<const float*>(tts->audio_data);
+
+    void* audio = nullptr;
+    if (tts->audio_data && !tts->release_audio) {
+        audio = tts->audio_data;
+        tts->audio_data = nullptr;
+    } else {
+        audio = rac_alloc_tagged(RAC_ALLOC_TAG_RESULT, std::max<size_t>(size, 1));
+        if (!audio) {
+            return RAC_ERROR_OUT_OF_MEMORY;
+        }
+        if (!narrow && size > 0) {
+            memcpy(audio, samples, size);
+        }
+    }
+    if (narrow) {
+        rac_audio_float_to_int16(samples, static_cast<int16_t*>(audio), count);
+    }
+
+    *out_audio = audio;
+    *out_size = size;
+    return RAC_SUCCESS;
+}
+
+// Forwards streamed synthesis to the app's chunk callback
+struct ChunkForwarder {
+    const rac_voice_output_config_t* output;
+    rac_voice_turn_trace_t* trace;
+    std::vector<int16_t> scratch;
+    bool started = false;
+};
+
+static void forward_tts_chunk(const void* audio_data, size_t audio_size, void* user_data) {
+    auto* forwarder = static_cast<ChunkForwarder*>(user_data);
+    if (!forwarder->started) {
+        forwarder->started = true;
+        trace_end(forwarder->trace, RAC_VOICE_TURN_STAGE_TTS_FIRST_CHUNK);
+        trace_end(forwarder->trace, RAC_VOICE_TURN_STAGE_FIRST_AUDIO);
+    }
+
+    const rac_voice_output_config_t& output = *forwarder->output;
+    if (output.format == RAC_VOICE_AUDIO_FORMAT_PCM_F32) {
+        output.chunk_callback(audio_data, audio_size, RAC_VOICE_AUDIO_FORMAT_PCM_F32,
+                              output.chunk_user_data);
+        return;
+    }
+
+    // WAV has no streaming form; its chunks are the Int16 samples it would hold
+    const size_t count = audio_size / sizeof(float);
+    forwarder->scratch.resize(count);
+    rac_audio_float_to_int16(static_cast<const float*>(audio_data), forwarder->scratch.data(),
+                             count);
+    output.chunk_callback(forwarder->scratch.data(), count * sizeof(int16_t),
+                          RAC_VOICE_AUDIO_FORMAT_PCM_S16, output.chunk_user_data);
+}
+
+/**
+ * @brief Synthesize a whole response in the agent's output format
+ *
+ * With a chunk callback configured the audio is streamed to it and
+ * *out_audio stays NULL.
+ *
+ * @param handle Voice agent handle (lifecycle lock must be held shared)
+ * @param text Text to speak
+ * @param trace Turn trace (TTS, TTS_FIRST_CHUNK and FIRST_AUDIO are marked)
+ * @param out_audio Output: Encoded audio (owned, free with rac_free)
+ * @param out_size Output: Size of out_audio in bytes
+ * @param out_sample_rate Output: Sample rate of out_audio in Hz
+ */
+static rac_result_t synthesize_output(rac_voice_agent_handle_t handle, const char* text,
+                                      rac_voice_turn_trace_t* trace, void** out_audio,
+                                      size_t* out_size, int32_t* out_sample_rate) {
+    const rac_voice_output_config_t& output = handle->output;
+    *out_audio = nullptr;
+    *out_size = 0;
+    *out_sample_rate = 0;
+
+    trace_begin(trace, RAC_VOICE_TURN_STAGE_TTS);
+    trace_begin(trace, RAC_VOICE_TURN_STAGE_TTS_FIRST_CHUNK);
+
+    if (output.chunk_callback) {
+        ChunkForwarder forwarder;
+        forwarder.output = &output;
+        forwarder.trace = trace;
+        rac_result_t result = rac_tts_component_synthesize_stream(
+            handle->tts_handle, text, nullptr, forward_tts_chunk, &forwarder);
+        trace_end(trace, RAC_VOICE_TURN_STAGE_TTS);
+        return result;
+    }
+
+    rac_tts_result_t tts_result = {};
+    rac_result_t result =
+        rac_tts_component_synthesize(handle->tts_handle, text, nullptr, &tts_result);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+
+    *out_sample_rate = tts_sample_rate(tts_result);
+    result = encode_tts_audio(output.format, &tts_result, out_audio, out_size);
+    rac_tts_result_free(&tts_result);
+    if (result != RAC_SUCCESS) {
+        RAC_LOG_ERROR("VoiceAgent", "Failed to encode synthesized audio");
+        return result;
+    }
+
+    // The whole utterance is one chunk, handed over with the result
+    trace_end(trace, RAC_VOICE_TURN_STAGE_TTS);
+    trace_end(trace, RAC_VOICE_TURN_STAGE_TTS_FIRST_CHUNK);
+    trace_end(trace, RAC_VOICE_TURN_STAGE_FIRST_AUDIO);
+    return RAC_SUCCESS;
+}
+
 // =============================================================================
 // LIFECYCLE API
 // =============================================================================
@@ -230,6 +512,8 @@ void rac_voice_agent_destroy(rac_voice_agent_handle_t handle) {
         return;
     }
 
+    await_deferred_tts(handle);
+
     // If we own the components, destroy them
     if (handle->owns_components) {
         RAC_LOG_DEBUG("VoiceAgent", "Destroying owned component handles");
@@ -251,17 +535,12 @@ void rac_voice_agent_destroy(rac_voice_agent_handle_t handle) {
 // MODEL LOADING API
 // =============================================================================
 
-rac_result_t rac_voice_agent_load_stt_model(rac_voice_agent_handle_t handle, const char* model_path,
-                                            const char* model_id, const char* model_name) {
-    if (!handle || !model_path) {
-        return RAC_ERROR_INVALID_ARGUMENT;
-    }
-
-    std::lock_guard<std::mutex> lock(handle->mutex);
+// Each loader reports LOADING, then LOADED or ERROR for its component. They
+// touch only their own component, so initialize runs them on parallel threads.
 
+static rac_result_t load_stt_model(rac_voice_agent_handle_t handle, const char* model_path,
+                                   const char* model_id, const char* model_name) {
     RAC_LOG_INFO("VoiceAgent", "Loading STT model");
-
-    // Emit loading state
     rac::events::emit_voice_agent_stt_state_changed(RAC_VOICE_AGENT_STATE_LOADING, model_id,
                                                     nullptr);
 
@@ -271,31 +550,16 @@ rac_result_t rac_voice_agent_load_stt_model(rac_voice_agent_handle_t handle, con
     if (result == RAC_SUCCESS) {
         rac::events::emit_voice_agent_stt_state_changed(RAC_VOICE_AGENT_STATE_LOADED, model_id,
                                                         nullptr);
-        // Check if all components are now ready
-        if (rac_stt_component_is_loaded(handle->stt_handle) == RAC_TRUE &&
-            rac_llm_component_is_loaded(handle->llm_handle) == RAC_TRUE &&
-            rac_tts_component_is_loaded(handle->tts_handle) == RAC_TRUE) {
-            rac::events::emit_voice_agent_all_ready();
-        }
     } else {
         rac::events::emit_voice_agent_stt_state_changed(RAC_VOICE_AGENT_STATE_ERROR, model_id,
                                                         "Failed to load STT model");
     }
-
     return result;
 }
 
-rac_result_t rac_voice_agent_load_llm_model(rac_voice_agent_handle_t handle, const char* model_path,
-                                            const char* model_id, const char* model_name) {
-    if (!handle || !model_path) {
-        return RAC_ERROR_INVALID_ARGUMENT;
-    }
-
-    std::lock_guard<std::mutex> lock(handle->mutex);
-
+static rac_result_t load_llm_model(rac_voice_agent_handle_t handle, const char* model_path,
+                                   const char* model_id, const char* model_name) {
     RAC_LOG_INFO("VoiceAgent", "Loading LLM model");
-
-    // Emit loading state
     rac::events::emit_voice_agent_llm_state_changed(RAC_VOICE_AGENT_STATE_LOADING, model_id,
                                                     nullptr);
 
@@ -305,31 +569,16 @@ rac_result_t rac_voice_agent_load_llm_model(rac_voice_agent_handle_t handle, con
     if (result == RAC_SUCCESS) {
         rac::events::emit_voice_agent_llm_state_changed(RAC_VOICE_AGENT_STATE_LOADED, model_id,
                                                         nullptr);
-        // Check if all components are now ready
-        if (rac_stt_component_is_loaded(handle->stt_handle) == RAC_TRUE &&
-            rac_llm_component_is_loaded(handle->llm_handle) == RAC_TRUE &&
-            rac_tts_component_is_loaded(handle->tts_handle) == RAC_TRUE) {
-            rac::events::emit_voice_agent_all_ready();
-        }
     } else {
         rac::events::emit_voice_agent_llm_state_changed(RAC_VOICE_AGENT_STATE_ERROR, model_id,
                                                         "Failed to load LLM model");
     }
-
     return result;
 }
 
-rac_result_t rac_voice_agent_load_tts_voice(rac_voice_agent_handle_t handle, const char* voice_path,
-                                            const char* voice_id, const char* voice_name) {
-    if (!handle || !voice_path) {
-        return RAC_ERROR_INVALID_ARGUMENT;
-    }
-
-    std::lock_guard<std::mutex> lock(handle->mutex);
-
+static rac_result_t load_tts_voice(rac_voice_agent_handle_t handle, const char* voice_path,
+                                   const char* voice_id, const char* voice_name) {
     RAC_LOG_INFO("VoiceAgent", "Loading TTS voice");
-
-    // Emit loading state
     rac::events::emit_voice_agent_tts_state_changed(RAC_VOICE_AGENT_STATE_LOADING, voice_id,
                                                     nullptr);
 
@@ -339,17 +588,67 @@ rac_result_t rac_voice_agent_load_tts_voice(rac_voice_agent_handle_t handle, con
     if (result == RAC_SUCCESS) {
         rac::events::emit_voice_agent_tts_state_changed(RAC_VOICE_AGENT_STATE_LOADED, voice_id,
                                                         nullptr);
-        // Check if all components are now ready
-        if (rac_stt_component_is_loaded(handle->stt_handle) == RAC_TRUE &&
-            rac_llm_component_is_loaded(handle->llm_handle) == RAC_TRUE &&
-            rac_tts_component_is_loaded(handle->tts_handle) == RAC_TRUE) {
-            rac::events::emit_voice_agent_all_ready();
-        }
     } else {
         rac::events::emit_voice_agent_tts_state_changed(RAC_VOICE_AGENT_STATE_ERROR, voice_id,
                                                         "Failed to load TTS voice");
     }
+    return result;
+}
+
+static void emit_all_ready_if_loaded(rac_voice_agent_handle_t handle) {
+    if (rac_stt_component_is_loaded(handle->stt_handle) == RAC_TRUE &&
+        rac_llm_component_is_loaded(handle->llm_handle) == RAC_TRUE &&
+        rac_tts_component_is_loaded(handle->tts_handle) == RAC_TRUE) {
+        rac::events::emit_voice_agent_all_ready();
+    }
+}
+
+rac_result_t rac_voice_agent_load_stt_model(rac_voice_agent_handle_t handle, const char* model_path,
+                                            const char* model_id, const char* model_name) {
+    if (!handle || !model_path) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::shared_mutex> lock(handle->lifecycle_mutex);
+
+    rac_result_t result = load_stt_model(handle, model_path, model_id, model_name);
+    if (result == RAC_SUCCESS) {
+        emit_all_ready_if_loaded(handle);
+    }
+    return result;
+}
+
+rac_result_t rac_voice_agent_load_llm_model(rac_voice_agent_handle_t handle, const char* model_path,
+                                            const char* model_id, const char* model_name) {
+    if (!handle || !model_path) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::shared_mutex> lock(handle->lifecycle_mutex);
+
+    rac_result_t result = load_llm_model(handle, model_path, model_id, model_name);
+    if (result == RAC_SUCCESS) {
+        emit_all_ready_if_loaded(handle);
+    }
+    return result;
+}
+
+rac_result_t rac_voice_agent_load_tts_voice(rac_voice_agent_handle_t handle, const char* voice_path,
+                                            const char* voice_id, const char* voice_name) {
+    if (!handle || !voice_path) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::shared_mutex> lock(handle->lifecycle_mutex);
+
+    // A deferred load would race this one on the component
+    await_deferred_tts(handle);
+    handle->deferred_tts = {};
 
+    rac_result_t result = load_tts_voice(handle, voice_path, voice_id, voice_name);
+    if (result == RAC_SUCCESS) {
+        emit_all_ready_if_loaded(handle);
+    }
     return result;
 }
 
@@ -401,17 +700,78 @@ const char* rac_voice_agent_get_tts_voice_id(rac_voice_agent_handle_t handle) {
     return rac_tts_component_get_voice_id(handle->tts_handle);
 }
 
+// Bytes of a model file, or of every file under a model directory
+static uint64_t model_footprint_bytes(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return 0;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        return static_cast<uint64_t>(st.st_size);
+    }
+
+    uint64_t total = 0;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return 0;
+    }
+    while (struct dirent* entry = readdir(dir)) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        total += model_footprint_bytes(path + "/" + entry->d_name);
+    }
+    closedir(dir);
+    return total;
+}
+
+// Available RAM from the platform adapter, else /proc/meminfo; 0 if unknown
+static uint64_t available_memory_bytes() {
+    const rac_platform_adapter_t* adapter = rac_get_platform_adapter();
+    if (adapter && adapter->get_memory_info) {
+        rac_memory_info_t info = {};
+        if (adapter->get_memory_info(&info, adapter->user_data) == RAC_SUCCESS &&
+            info.available_bytes > 0) {
+            return info.available_bytes;
+        }
+    }
+
+    uint64_t available = 0;
+    FILE* meminfo = fopen("/proc/meminfo", "r");
+    if (meminfo) {
+        char line[128];
+        unsigned long long kb = 0;
+        while (fgets(line, sizeof(line), meminfo)) {
+            if (sscanf(line, "MemAvailable: %llu kB", &kb) == 1) {
+                available = static_cast<uint64_t>(kb) * 1024;
+                break;
+            }
+        }
+        fclose(meminfo);
+    }
+    return available;
+}
+
+static bool has_path(const char* path) {
+    return path && strlen(path) > 0;
+}
+
 rac_result_t rac_voice_agent_initialize(rac_voice_agent_handle_t handle,
                                         const rac_voice_agent_config_t* config) {
     if (!handle) {
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    std::lock_guard<std::shared_mutex> lock(handle->lifecycle_mutex);
 
     RAC_LOG_INFO("VoiceAgent", "Initializing Voice Agent");
 
     const rac_voice_agent_config_t* cfg = config ? config : &RAC_VOICE_AGENT_CONFIG_DEFAULT;
+    const rac_voice_agent_load_config_t& load = cfg->load_config;
+
+    // A voice still loading from an earlier initialize must not race this one
+    await_deferred_tts(handle);
+    handle->deferred_tts = {};
 
     // Step 1: Initialize VAD (mirrors Swift's initializeVAD)
     rac_result_t result = rac_vad_component_initialize(handle->vad_handle);
@@ -420,46 +780,114 @@ rac_result_t rac_voice_agent_initialize(rac_voice_agent_handle_t handle,
         return result;
     }
 
-    // Step 2: Initialize STT model (mirrors Swift's initializeSTTModel)
-    if (cfg->stt_config.model_path && strlen(cfg->stt_config.model_path) > 0) {
-        // Load the specified model
-        RAC_LOG_INFO("VoiceAgent", "Loading STT model");
-        result = rac_stt_component_load_model(handle->stt_handle, cfg->stt_config.model_path,
-                                              cfg->stt_config.model_id, cfg->stt_config.model_name);
-        if (result != RAC_SUCCESS) {
-            RAC_LOG_ERROR("VoiceAgent", "STT component failed to initialize");
-            return result;
+    // Steps 2-4: Load the STT, LLM and TTS models that were given (mirrors
+    // Swift's initializeSTTModel, initializeLLMModel and initializeTTSVoice).
+    // If a path is missing, we trust that one is already loaded.
+    const rac_voice_agent_stt_config_t& stt = cfg->stt_config;
+    const rac_voice_agent_llm_config_t& llm = cfg->llm_config;
+    const rac_voice_agent_tts_config_t& tts = cfg->tts_config;
+    const bool load_stt = has_path(stt.model_path);
+    const bool load_llm = has_path(llm.model_path);
+    const bool load_tts = has_path(tts.voice_path);
+    const bool defer_tts = load_tts && load.defer_tts == RAC_TRUE;
+
+    int concurrent = (load_stt ? 1 : 0) + (load_llm ? 1 : 0) + (load_tts ? 1 : 0);
+    bool parallel = load.parallel == RAC_TRUE && concurrent > 1;
+    if (parallel) {
+        // Peak memory is all models at once plus their load-time buffers
+        uint64_t footprint = (load_stt ? model_footprint_bytes(stt.model_path) : 0) +
+                             (load_llm ? model_footprint_bytes(llm.model_path) : 0) +
+                             (load_tts ? model_footprint_bytes(tts.voice_path) : 0);
+        double needed = static_cast<double>(footprint) * (1.0 + std::max(0.0f, load.memory_margin));
+        uint64_t available = available_memory_bytes();
+        if (available > 0 && needed > static_cast<double>(available)) {
+            RAC_LOG_WARNING("VoiceAgent",
+                            "Models need ~%llu MB, %llu MB available - loading sequentially",
+                            static_cast<unsigned long long>(needed / (1024 * 1024)),
+                            static_cast<unsigned long long>(available / (1024 * 1024)));
+            parallel = false;
         }
     }
-    // If no model specified, we trust that one is already loaded (mirrors Swift)
 
-    // Step 3: Initialize LLM model (mirrors Swift's initializeLLMModel)
-    if (cfg->llm_config.model_path && strlen(cfg->llm_config.model_path) > 0) {
-        RAC_LOG_INFO("VoiceAgent", "Loading LLM model");
-        result = rac_llm_component_load_model(handle->llm_handle, cfg->llm_config.model_path,
-                                              cfg->llm_config.model_id, cfg->llm_config.model_name);
-        if (result != RAC_SUCCESS) {
-            RAC_LOG_ERROR("VoiceAgent", "LLM component failed to initialize");
-            return result;
+    // The LLM loads on the calling thread; STT and TTS on their own when parallel
+    rac_result_t stt_result = RAC_SUCCESS;
+    rac_result_t tts_result = RAC_SUCCESS;
+    std::thread stt_loader;
+    std::thread tts_loader;
+    auto run_stt = [&] {
+        stt_result = load_stt_model(handle, stt.model_path, stt.model_id, stt.model_name);
+    };
+    auto run_tts = [&] {
+        tts_result = load_tts_voice(handle, tts.voice_path, tts.voice_id, tts.voice_name);
+    };
+
+    if (load_stt) {
+        if (parallel) {
+            stt_loader = std::thread(run_stt);
+        } else {
+            run_stt();
         }
     }
+    if (load_tts && !defer_tts && parallel) {
+        tts_loader = std::thread(run_tts);
+    }
+    rac_result_t llm_result = RAC_SUCCESS;
+    if (load_llm && stt_result == RAC_SUCCESS) {
+        llm_result = load_llm_model(handle, llm.model_path, llm.model_id, llm.model_name);
+    }
+    if (stt_loader.joinable()) {
+        stt_loader.join();
+    }
+    if (load_tts && !defer_tts && !parallel && stt_result == RAC_SUCCESS &&
+        llm_result == RAC_SUCCESS) {
+        run_tts();
+    }
+    if (tts_loader.joinable()) {
+        tts_loader.join();
+    }
 
-    // Step 4: Initialize TTS (mirrors Swift's initializeTTSVoice)
-    if (cfg->tts_config.voice_path && strlen(cfg->tts_config.voice_path) > 0) {
-        RAC_LOG_INFO("VoiceAgent", "Initializing TTS");
-        result = rac_tts_component_load_voice(handle->tts_handle, cfg->tts_config.voice_path,
-                                              cfg->tts_config.voice_id, cfg->tts_config.voice_name);
-        if (result != RAC_SUCCESS) {
-            RAC_LOG_ERROR("VoiceAgent", "TTS component failed to initialize");
-            return result;
-        }
+    if (stt_result != RAC_SUCCESS) {
+        RAC_LOG_ERROR("VoiceAgent", "STT component failed to initialize");
+        return stt_result;
+    }
+    if (llm_result != RAC_SUCCESS) {
+        RAC_LOG_ERROR("VoiceAgent", "LLM component failed to initialize");
+        return llm_result;
+    }
+    if (tts_result != RAC_SUCCESS) {
+        RAC_LOG_ERROR("VoiceAgent", "TTS component failed to initialize");
+        return tts_result;
+    }
+
+    if (defer_tts) {
+        // Owned copies: the config only lives for this call
+        std::string path = tts.voice_path;
+        std::string id = tts.voice_id ? tts.voice_id : "";
+        std::string name = tts.voice_name ? tts.voice_name : "";
+        bool has_id = tts.voice_id != nullptr;
+        bool has_name = tts.voice_name != nullptr;
+        handle->deferred_tts =
+            std::async(std::launch::async, [handle, path, id, name, has_id, has_name] {
+                rac_result_t deferred =
+                    load_tts_voice(handle, path.c_str(), has_id ? id.c_str() : nullptr,
+                                   has_name ? name.c_str() : nullptr);
+                if (deferred == RAC_SUCCESS) {
+                    emit_all_ready_if_loaded(handle);
+                }
+                return deferred;
+            }).share();
+        RAC_LOG_INFO("VoiceAgent", "TTS voice loading in the background");
     }
 
     // Step 5: Verify all components ready (mirrors Swift's verifyAllComponentsReady)
     // Note: In the C API, we trust initialization succeeded
 
     handle->is_configured = true;
-    RAC_LOG_INFO("VoiceAgent", "Voice Agent initialized successfully");
+    RAC_LOG_INFO("VoiceAgent", "Voice Agent initialized successfully (%s load)",
+                 parallel ? "parallel" : "sequential");
+    if (!defer_tts && concurrent > 0) {
+        emit_all_ready_if_loaded(handle);
+    }
 
     return RAC_SUCCESS;
 }
@@ -469,7 +897,7 @@ rac_result_t rac_voice_agent_initialize_with_loaded_models(rac_voice_agent_handl
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    std::lock_guard<std::shared_mutex> lock(handle->lifecycle_mutex);
 
     RAC_LOG_INFO("VoiceAgent", "Initializing Voice Agent with already-loaded models");
 
@@ -494,10 +922,13 @@ rac_result_t rac_voice_agent_cleanup(rac_voice_agent_handle_t handle) {
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    std::lock_guard<std::shared_mutex> lock(handle->lifecycle_mutex);
 
     RAC_LOG_INFO("VoiceAgent", "Cleaning up Voice Agent");
 
+    await_deferred_tts(handle);
+    handle->deferred_tts = {};
+
     // Cleanup all components (mirrors Swift's cleanup)
     rac_llm_component_cleanup(handle->llm_handle);
     rac_stt_component_cleanup(handle->stt_handle);
@@ -516,7 +947,7 @@ rac_result_t rac_voice_agent_is_ready(rac_voice_agent_handle_t handle, rac_bool_
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    std::shared_lock<std::shared_mutex> lock(handle->lifecycle_mutex);
     *out_is_ready = handle->is_configured ? RAC_TRUE : RAC_FALSE;
 
     return RAC_SUCCESS;
@@ -526,15 +957,25 @@ rac_result_t rac_voice_agent_is_ready(rac_voice_agent_handle_t handle, rac_bool_
 // VOICE PROCESSING API
 // =============================================================================
 
-rac_result_t rac_voice_agent_process_voice_turn(rac_voice_agent_handle_t handle,
-                                                const void* audio_data, size_t audio_size,
-                                                rac_voice_agent_result_t* out_result) {
-    if (!handle || !audio_data || audio_size == 0 || !out_result) {
+rac_result_t rac_voice_agent_set_output_config(rac_voice_agent_handle_t handle,
+                                               const rac_voice_output_config_t* config) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    const rac_voice_output_config_t& cfg = config ? *config : RAC_VOICE_OUTPUT_CONFIG_DEFAULT;
+    if (cfg.format < RAC_VOICE_AUDIO_FORMAT_WAV || cfg.format > RAC_VOICE_AUDIO_FORMAT_PCM_S16) {
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    std::lock_guard<std::shared_mutex> lock(handle->lifecycle_mutex);
+    handle->output = cfg;
+    return RAC_SUCCESS;
+}
 
+static rac_result_t process_voice_turn_locked(rac_voice_agent_handle_t handle,
+                                              const void* audio_data, size_t audio_size,
+                                              rac_voice_agent_result_t* out_result,
+                                              rac_voice_turn_trace_t* trace) {
     // Mirrors Swift's guard isConfigured
     if (!handle->is_configured) {
         RAC_LOG_ERROR("VoiceAgent", "Voice Agent is not initialized");
@@ -557,10 +998,12 @@ rac_result_t rac_voice_agent_process_voice_turn(rac_voice_agent_handle_t handle,
     // Step 1: Transcribe audio (mirrors Swift's Step 1)
     RAC_LOG_DEBUG("VoiceAgent", "Step 1: Transcribing audio");
 
+    trace_begin(trace, RAC_VOICE_TURN_STAGE_STT);
     rac_stt_result_t stt_result = {};
     rac_result_t result = rac_stt_component_transcribe(handle->stt_handle, audio_data, audio_size,
                                                        nullptr,  // default options
                                                        &stt_result);
+    trace_end(trace, RAC_VOICE_TURN_STAGE_STT);
 
     if (result != RAC_SUCCESS) {
         RAC_LOG_ERROR("VoiceAgent", "STT transcription failed");
@@ -579,10 +1022,12 @@ rac_result_t rac_voice_agent_process_voice_turn(rac_voice_agent_handle_t handle,
     // Step 2: Generate LLM response (mirrors Swift's Step 2)
     RAC_LOG_DEBUG("VoiceAgent", "Step 2: Generating LLM response");
 
+    trace_begin(trace, RAC_VOICE_TURN_STAGE_LLM);
     rac_llm_result_t llm_result = {};
     result = rac_llm_component_generate(handle->llm_handle, stt_result.text,
                                         nullptr,  // default options
                                         &llm_result);
+    trace_end(trace, RAC_VOICE_TURN_STAGE_LLM);
 
     if (result != RAC_SUCCESS) {
         RAC_LOG_ERROR("VoiceAgent", "LLM generation failed");
@@ -595,10 +1040,10 @@ rac_result_t rac_voice_agent_process_voice_turn(rac_voice_agent_handle_t handle,
     // Step 3: Synthesize speech (mirrors Swift's Step 3)
     RAC_LOG_DEBUG("VoiceAgent", "Step 3: Synthesizing speech");
 
-    rac_tts_result_t tts_result = {};
-    result = rac_tts_component_synthesize(handle->tts_handle, llm_result.text,
-                                          nullptr,  // default options
-                                          &tts_result);
+    void* speech = nullptr;
+    size_t speech_size = 0;
+    int32_t sample_rate = 0;
+    result = synthesize_output(handle, llm_result.text, trace, &speech, &speech_size, &sample_rate);
 
     if (result != RAC_SUCCESS) {
         RAC_LOG_ERROR("VoiceAgent", "TTS synthesis failed");
@@ -607,52 +1052,48 @@ rac_result_t rac_voice_agent_process_voice_turn(rac_voice_agent_handle_t handle,
         return result;
     }
 
-    // Step 4: Convert Float32 PCM to WAV format for playback
-    // TTS returns raw Float32 samples, but audio players need WAV format
-    void* wav_data = nullptr;
-    size_t wav_size = 0;
-    result = rac_audio_float32_to_wav(tts_result.audio_data, tts_result.audio_size,
-                                      tts_result.sample_rate > 0 ? tts_result.sample_rate
-                                                                 : RAC_TTS_DEFAULT_SAMPLE_RATE,
-                                      &wav_data, &wav_size);
-
-    if (result != RAC_SUCCESS) {
-        RAC_LOG_ERROR("VoiceAgent", "Failed to convert audio to WAV format");
-        rac_stt_result_free(&stt_result);
-        rac_llm_result_free(&llm_result);
-        rac_tts_result_free(&tts_result);
-        return result;
-    }
-
-    RAC_LOG_DEBUG("VoiceAgent", "Converted PCM to WAV format");
+    trace_end(trace, RAC_VOICE_TURN_STAGE_TURN);
 
     // Build result (mirrors Swift's VoiceAgentResult)
     out_result->speech_detected = RAC_TRUE;
     out_result->transcription = rac_strdup(stt_result.text);
     out_result->response = rac_strdup(llm_result.text);
-    out_result->synthesized_audio = wav_data;
-    out_result->synthesized_audio_size = wav_size;
+    out_result->synthesized_audio = speech;
+    out_result->synthesized_audio_size = speech_size;
+    out_result->trace = *trace;
+    out_result->audio_format = handle->output.format;
+    out_result->audio_sample_rate = sample_rate;
 
-    // Free intermediate results (tts_result audio data is no longer needed since we have WAV)
+    // Free intermediate results
     rac_stt_result_free(&stt_result);
     rac_llm_result_free(&llm_result);
-    rac_tts_result_free(&tts_result);
 
     RAC_LOG_INFO("VoiceAgent", "Voice turn completed");
 
     return RAC_SUCCESS;
 }
 
-rac_result_t rac_voice_agent_process_stream(rac_voice_agent_handle_t handle, const void* audio_data,
-                                            size_t audio_size,
-                                            rac_voice_agent_event_callback_fn callback,
-                                            void* user_data) {
-    if (!handle || !audio_data || audio_size == 0 || !callback) {
+rac_result_t rac_voice_agent_process_voice_turn(rac_voice_agent_handle_t handle,
+                                                const void* audio_data, size_t audio_size,
+                                                rac_voice_agent_result_t* out_result) {
+    if (!handle || !audio_data || audio_size == 0 || !out_result) {
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    std::shared_lock<std::shared_mutex> lock(handle->lifecycle_mutex);
+
+    rac_voice_turn_trace_t trace;
+    trace_start_turn(&trace, monotonic_ns());
+    rac_result_t result =
+        process_voice_turn_locked(handle, audio_data, audio_size, out_result, &trace);
+    trace_report_turn(&trace, result);
+    return result;
+}
 
+static rac_result_t process_stream_locked(rac_voice_agent_handle_t handle, const void* audio_data,
+                                          size_t audio_size,
+                                          rac_voice_agent_event_callback_fn callback,
+                                          void* user_data, rac_voice_turn_trace_t* trace) {
     if (!handle->is_configured) {
         rac_voice_agent_event_t error_event = {};
         error_event.type = RAC_VOICE_AGENT_EVENT_ERROR;
@@ -673,9 +1114,11 @@ rac_result_t rac_voice_agent_process_stream(rac_voice_agent_handle_t handle, con
     }
 
     // Step 1: Transcribe
+    trace_begin(trace, RAC_VOICE_TURN_STAGE_STT);
     rac_stt_result_t stt_result = {};
     rac_result_t result = rac_stt_component_transcribe(handle->stt_handle, audio_data, audio_size,
                                                        nullptr, &stt_result);
+    trace_end(trace, RAC_VOICE_TURN_STAGE_STT);
 
     if (result != RAC_SUCCESS) {
         rac_voice_agent_event_t error_event = {};
@@ -692,8 +1135,10 @@ rac_result_t rac_voice_agent_process_stream(rac_voice_agent_handle_t handle, con
     callback(&transcription_event, user_data);
 
     // Step 2: Generate response
+    trace_begin(trace, RAC_VOICE_TURN_STAGE_LLM);
     rac_llm_result_t llm_result = {};
     result = rac_llm_component_generate(handle->llm_handle, stt_result.text, nullptr, &llm_result);
+    trace_end(trace, RAC_VOICE_TURN_STAGE_LLM);
 
     if (result != RAC_SUCCESS) {
         rac_stt_result_free(&stt_result);
@@ -711,32 +1156,14 @@ rac_result_t rac_voice_agent_process_stream(rac_voice_agent_handle_t handle, con
     callback(&response_event, user_data);
 
     // Step 3: Synthesize
-    rac_tts_result_t tts_result = {};
-    result =
-        rac_tts_component_synthesize(handle->tts_handle, llm_result.text, nullptr, &tts_result);
-
-    if (result != RAC_SUCCESS) {
-        rac_stt_result_free(&stt_result);
-        rac_llm_result_free(&llm_result);
-        rac_voice_agent_event_t error_event = {};
-        error_event.type = RAC_VOICE_AGENT_EVENT_ERROR;
-        error_event.data.error_code = result;
-        callback(&error_event, user_data);
-        return result;
-    }
-
-    // Step 4: Convert Float32 PCM to WAV format for playback
-    void* wav_data = nullptr;
-    size_t wav_size = 0;
-    result = rac_audio_float32_to_wav(tts_result.audio_data, tts_result.audio_size,
-                                      tts_result.sample_rate > 0 ? tts_result.sample_rate
-                                                                 : RAC_TTS_DEFAULT_SAMPLE_RATE,
-                                      &wav_data, &wav_size);
+    void* speech = nullptr;
+    size_t speech_size = 0;
+    int32_t sample_rate = 0;
+    result = synthesize_output(handle, llm_result.text, trace, &speech, &speech_size, &sample_rate);
 
     if (result != RAC_SUCCESS) {
         rac_stt_result_free(&stt_result);
         rac_llm_result_free(&llm_result);
-        rac_tts_result_free(&tts_result);
         rac_voice_agent_event_t error_event = {};
         error_event.type = RAC_VOICE_AGENT_EVENT_ERROR;
         error_event.data.error_code = result;
@@ -744,31 +1171,1026 @@ rac_result_t rac_voice_agent_process_stream(rac_voice_agent_handle_t handle, con
         return result;
     }
 
-    // Emit audio synthesized event (with WAV data)
+    // Emit audio synthesized event (no audio when it was streamed to the chunk callback)
     rac_voice_agent_event_t audio_event = {};
     audio_event.type = RAC_VOICE_AGENT_EVENT_AUDIO_SYNTHESIZED;
-    audio_event.data.audio.audio_data = wav_data;
-    audio_event.data.audio.audio_size = wav_size;
+    audio_event.data.audio.audio_data = speech;
+    audio_event.data.audio.audio_size = speech_size;
+    audio_event.data.audio.format = handle->output.format;
+    audio_event.data.audio.sample_rate = sample_rate;
     callback(&audio_event, user_data);
 
     // Emit final processed event
+    trace_end(trace, RAC_VOICE_TURN_STAGE_TURN);
     rac_voice_agent_event_t processed_event = {};
     processed_event.type = RAC_VOICE_AGENT_EVENT_PROCESSED;
     processed_event.data.result.speech_detected = RAC_TRUE;
     processed_event.data.result.transcription = rac_strdup(stt_result.text);
     processed_event.data.result.response = rac_strdup(llm_result.text);
-    processed_event.data.result.synthesized_audio = wav_data;
-    processed_event.data.result.synthesized_audio_size = wav_size;
+    processed_event.data.result.synthesized_audio = speech;
+    processed_event.data.result.synthesized_audio_size = speech_size;
+    processed_event.data.result.trace = *trace;
+    processed_event.data.result.audio_format = handle->output.format;
+    processed_event.data.result.audio_sample_rate = sample_rate;
     callback(&processed_event, user_data);
 
-    // Free intermediate results (WAV data ownership transferred to processed_event)
+    // Free intermediate results (audio ownership transferred to processed_event)
     rac_stt_result_free(&stt_result);
     rac_llm_result_free(&llm_result);
-    rac_tts_result_free(&tts_result);
 
     return RAC_SUCCESS;
 }
 
+rac_result_t rac_voice_agent_process_stream(rac_voice_agent_handle_t handle, const void* audio_data,
+                                            size_t audio_size,
+                                            rac_voice_agent_event_callback_fn callback,
+                                            void* user_data) {
+    if (!handle || !audio_data || audio_size == 0 || !callback) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(handle->lifecycle_mutex);
+
+    rac_voice_turn_trace_t trace;
+    trace_start_turn(&trace, monotonic_ns());
+    rac_result_t result =
+        process_stream_locked(handle, audio_data, audio_size, callback, user_data, &trace);
+    trace_report_turn(&trace, result);
+    return result;
+}
+
+// =============================================================================
+// PIPELINED RESPONSE - LLM tokens -> sentences -> TTS worker
+// =============================================================================
+
+namespace {
+
+// Letters and digits, counting any non-ASCII UTF-8 byte as a letter
+bool is_speakable(char c) {
+    unsigned char byte = static_cast<unsigned char>(c);
+    return std::isalnum(byte) != 0 || byte >= 0x80;
+}
+
+bool has_speakable_text(const char* text) {
+    for (; text && *text; ++text) {
+        if (is_speakable(*text)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * State shared by the LLM side (caller's thread) and the TTS worker
+ */
+struct ResponsePipeline {
+    rac_voice_agent_handle_t agent = nullptr;
+    rac_voice_agent_event_callback_fn callback = nullptr;
+    void* user_data = nullptr;
+
+    // Events are delivered one at a time, in order per stage
+    std::mutex callback_mtx;
+
+    std::mutex queue_mtx;
+    std::condition_variable queue_cv;
+    std::deque<std::string> sentences;
+    bool input_done = false;
+
+    // First failure of either stage; later sentences are skipped
+    std::atomic<bool> failed{false};
+    rac_result_t error = RAC_SUCCESS;
+
+    // Set by the owner to abandon the response (barge-in); may be NULL
+    const std::atomic<bool>* cancel = nullptr;
+
+    // LLM spans are written by the caller's thread, TTS spans by the worker
+    rac_voice_turn_trace_t* trace = nullptr;
+
+    // Cuts the streamed response into normalized sentences
+    rac_tts_segmenter_handle_t segmenter = nullptr;
+    std::string response;
+    int64_t start_ms = 0;
+    bool audio_started = false;
+
+    void emit(const rac_voice_agent_event_t& event) {
+        std::lock_guard<std::mutex> lock(callback_mtx);
+        callback(&event, user_data);
+    }
+
+    bool stopped() const { return failed.load() || (cancel && cancel->load()); }
+
+    void fail(rac_result_t code) {
+        bool expected = false;
+        if (failed.compare_exchange_strong(expected, true)) {
+            error = code;
+        }
+    }
+
+    void submit(const char* sentence) {
+        rac_voice_agent_event_t event = {};
+        event.type = RAC_VOICE_AGENT_EVENT_RESPONSE_CHUNK;
+        event.data.response = sentence;
+        emit(event);
+
+        std::lock_guard<std::mutex> lock(queue_mtx);
+        sentences.emplace_back(sentence);
+        queue_cv.notify_one();
+    }
+
+    void finish_input() {
+        std::lock_guard<std::mutex> lock(queue_mtx);
+        input_done = true;
+        queue_cv.notify_one();
+    }
+};
+
+void synthesize_sentences(ResponsePipeline* pipeline) {
+    for (;;) {
+        std::string sentence;
+        {
+            std::unique_lock<std::mutex> lock(pipeline->queue_mtx);
+            pipeline->queue_cv.wait(
+                lock, [pipeline] { return !pipeline->sentences.empty() || pipeline->input_done; });
+            if (pipeline->sentences.empty()) {
+                return;
+            }
+            sentence = std::move(pipeline->sentences.front());
+            pipeline->sentences.pop_front();
+        }
+        if (pipeline->stopped()) {
+            continue;
+        }
+
+        trace_begin(pipeline->trace, RAC_VOICE_TURN_STAGE_TTS);
+        trace_begin(pipeline->trace, RAC_VOICE_TURN_STAGE_TTS_FIRST_CHUNK);
+        rac_tts_result_t tts_result = {};
+        rac_result_t result = rac_tts_component_synthesize(
+            pipeline->agent->tts_handle, sentence.c_str(), nullptr, &tts_result);
+        trace_end(pipeline->trace, RAC_VOICE_TURN_STAGE_TTS);
+        if (result != RAC_SUCCESS) {
+            pipeline->fail(result);
+            continue;
+        }
+
+        const rac_voice_audio_format_t format = pipeline->agent->output.format;
+        const int32_t sample_rate = tts_sample_rate(tts_result);
+        void* audio = nullptr;
+        size_t audio_size = 0;
+        result = encode_tts_audio(format, &tts_result, &audio, &audio_size);
+        rac_tts_result_free(&tts_result);
+        if (result != RAC_SUCCESS) {
+            pipeline->fail(result);
+            continue;
+        }
+
+        if (!pipeline->audio_started) {
+            pipeline->audio_started = true;
+            trace_end(pipeline->trace, RAC_VOICE_TURN_STAGE_TTS_FIRST_CHUNK);
+            trace_end(pipeline->trace, RAC_VOICE_TURN_STAGE_FIRST_AUDIO);
+            RAC_LOG_INFO("VoiceAgent", "First audio chunk ready after %lld ms",
+                         static_cast<long long>(rac_get_current_time_ms() - pipeline->start_ms));
+        }
+
+        rac_voice_agent_event_t event = {};
+        event.type = RAC_VOICE_AGENT_EVENT_AUDIO_CHUNK;
+        event.data.audio.audio_data = audio;
+        event.data.audio.audio_size = audio_size;
+        event.data.audio.format = format;
+        event.data.audio.sample_rate = sample_rate;
+        pipeline->emit(event);
+        rac_free(audio);
+    }
+}
+
+void pipeline_sentence_callback(const char* sentence, void* user_data) {
+    static_cast<ResponsePipeline*>(user_data)->submit(sentence);
+}
+
+rac_bool_t pipeline_token_callback(const char* token, void* user_data) {
+    auto* pipeline = static_cast<ResponsePipeline*>(user_data);
+    if (pipeline->stopped()) {
+        return RAC_FALSE;
+    }
+    if (!token) {
+        return RAC_TRUE;
+    }
+    trace_end(pipeline->trace, RAC_VOICE_TURN_STAGE_LLM_FIRST_TOKEN, true);
+    pipeline->response += token;
+
+    rac_tts_segmenter_feed(pipeline->segmenter, token, pipeline_sentence_callback, pipeline);
+    return RAC_TRUE;
+}
+
+void pipeline_error_callback(rac_result_t error_code, const char* error_message,
+                             void* user_data) {
+    RAC_LOG_ERROR("VoiceAgent", "Streaming generation failed: %s",
+                  error_message ? error_message : "unknown error");
+    static_cast<ResponsePipeline*>(user_data)->fail(error_code);
+}
+
+}  // namespace
+
+/**
+ * @brief Generate a response and speak it sentence by sentence
+ *
+ * Emits RESPONSE_CHUNK and AUDIO_CHUNK events; the caller emits RESPONSE,
+ * PROCESSED or ERROR afterwards. The lifecycle lock must be held shared. Once *cancel
+ * is set no further events are emitted; setting it does not interrupt a
+ * generation or synthesis already running, which the owner stops through
+ * the components.
+ *
+ * @param handle Voice agent handle
+ * @param prompt User prompt
+ * @param callback Event callback
+ * @param user_data User context passed to callback
+ * @param cancel Cancellation flag (can be NULL)
+ * @param trace Turn trace receiving the LLM and TTS spans
+ * @param out_response Output: Full response text
+ * @return RAC_SUCCESS, RAC_ERROR_CANCELLED, or the first error of the LLM or TTS stage
+ */
+static rac_result_t respond_pipelined(rac_voice_agent_handle_t handle, const char* prompt,
+                                      rac_voice_agent_event_callback_fn callback, void* user_data,
+                                      const std::atomic<bool>* cancel,
+                                      rac_voice_turn_trace_t* trace, std::string* out_response) {
+    ResponsePipeline pipeline;
+    pipeline.agent = handle;
+    pipeline.callback = callback;
+    pipeline.user_data = user_data;
+    pipeline.cancel = cancel;
+    pipeline.trace = trace;
+    pipeline.start_ms = rac_get_current_time_ms();
+    rac_result_t segmenter_result = rac_tts_segmenter_create(nullptr, &pipeline.segmenter);
+    if (segmenter_result != RAC_SUCCESS) {
+        return segmenter_result;
+    }
+
+    std::thread tts_worker(synthesize_sentences, &pipeline);
+
+    trace_begin(trace, RAC_VOICE_TURN_STAGE_LLM);
+    trace_begin(trace, RAC_VOICE_TURN_STAGE_LLM_FIRST_TOKEN);
+    if (rac_llm_component_supports_streaming(handle->llm_handle) == RAC_TRUE) {
+        rac_result_t result = rac_llm_component_generate_stream(
+            handle->llm_handle, prompt, nullptr, pipeline_token_callback, nullptr,
+            pipeline_error_callback, &pipeline);
+        if (result != RAC_SUCCESS) {
+            pipeline.fail(result);
+        }
+    } else {
+        rac_llm_result_t llm_result = {};
+        rac_result_t result =
+            rac_llm_component_generate(handle->llm_handle, prompt, nullptr, &llm_result);
+        if (result == RAC_SUCCESS) {
+            pipeline.response = llm_result.text ? llm_result.text : "";
+            rac_tts_segmenter_feed(pipeline.segmenter, pipeline.response.c_str(),
+                                   pipeline_sentence_callback, &pipeline);
+            rac_llm_result_free(&llm_result);
+        } else {
+            pipeline.fail(result);
+        }
+    }
+    // A blocking generation delivers its first token with the last
+    trace_end(trace, RAC_VOICE_TURN_STAGE_LLM_FIRST_TOKEN, true);
+    trace_end(trace, RAC_VOICE_TURN_STAGE_LLM);
+
+    if (!pipeline.stopped()) {
+        rac_tts_segmenter_flush(pipeline.segmenter, pipeline_sentence_callback, &pipeline);
+    }
+    pipeline.finish_input();
+    tts_worker.join();
+    rac_tts_segmenter_destroy(pipeline.segmenter);
+
+    // Cancelled stages report errors of their own; the cancellation explains them
+    if (cancel && cancel->load()) {
+        return RAC_ERROR_CANCELLED;
+    }
+    if (pipeline.failed.load()) {
+        return pipeline.error;
+    }
+    *out_response = std::move(pipeline.response);
+    return RAC_SUCCESS;
+}
+
+/**
+ * @brief Transcribe a turn and answer it with respond_pipelined
+ *
+ * Emits all events of rac_voice_agent_process_stream_pipelined. The
+ * lifecycle lock must be held shared. A cancelled turn returns RAC_ERROR_CANCELLED without
+ * an ERROR event. The caller starts the trace and reports it afterwards.
+ */
+static rac_result_t run_pipelined_turn(rac_voice_agent_handle_t handle, const void* audio_data,
+                                       size_t audio_size,
+                                       rac_voice_agent_event_callback_fn callback, void* user_data,
+                                       const std::atomic<bool>* cancel,
+                                       rac_voice_turn_trace_t* trace) {
+    rac_result_t result = handle->is_configured ? validate_all_components_ready(handle)
+                                                : RAC_ERROR_NOT_INITIALIZED;
+    if (result != RAC_SUCCESS) {
+        RAC_LOG_ERROR("VoiceAgent", "Voice agent not ready - cannot process stream");
+        rac_voice_agent_event_t error_event = {};
+        error_event.type = RAC_VOICE_AGENT_EVENT_ERROR;
+        error_event.data.error_code = result;
+        callback(&error_event, user_data);
+        return result;
+    }
+
+    // Step 1: Transcribe
+    trace_begin(trace, RAC_VOICE_TURN_STAGE_STT);
+    rac_stt_result_t stt_result = {};
+    result = rac_stt_component_transcribe(handle->stt_handle, audio_data, audio_size, nullptr,
+                                          &stt_result);
+    trace_end(trace, RAC_VOICE_TURN_STAGE_STT);
+    if (result != RAC_SUCCESS) {
+        rac_voice_agent_event_t error_event = {};
+        error_event.type = RAC_VOICE_AGENT_EVENT_ERROR;
+        error_event.data.error_code = result;
+        callback(&error_event, user_data);
+        return result;
+    }
+
+    rac_voice_agent_event_t transcription_event = {};
+    transcription_event.type = RAC_VOICE_AGENT_EVENT_TRANSCRIPTION;
+    transcription_event.data.transcription = stt_result.text;
+    callback(&transcription_event, user_data);
+
+    // Noise that transcribed to nothing gets no response
+    if (!has_speakable_text(stt_result.text)) {
+        trace_end(trace, RAC_VOICE_TURN_STAGE_TURN);
+        rac_voice_agent_event_t processed_event = {};
+        processed_event.type = RAC_VOICE_AGENT_EVENT_PROCESSED;
+        processed_event.data.result.speech_detected = RAC_FALSE;
+        processed_event.data.result.trace = *trace;
+        callback(&processed_event, user_data);
+        rac_stt_result_free(&stt_result);
+        return RAC_SUCCESS;
+    }
+
+    // Step 2: Generate and synthesize, overlapped per sentence
+    std::string response;
+    result = respond_pipelined(handle, stt_result.text ? stt_result.text : "", callback,
+                               user_data, cancel, trace, &response);
+    if (result == RAC_ERROR_CANCELLED) {
+        rac_stt_result_free(&stt_result);
+        return result;
+    }
+    if (result != RAC_SUCCESS) {
+        rac_stt_result_free(&stt_result);
+        rac_voice_agent_event_t error_event = {};
+        error_event.type = RAC_VOICE_AGENT_EVENT_ERROR;
+        error_event.data.error_code = result;
+        callback(&error_event, user_data);
+        return result;
+    }
+
+    rac_voice_agent_event_t response_event = {};
+    response_event.type = RAC_VOICE_AGENT_EVENT_RESPONSE;
+    response_event.data.response = response.c_str();
+    callback(&response_event, user_data);
+
+    // Audio was delivered in chunks, so the final result carries text only
+    trace_end(trace, RAC_VOICE_TURN_STAGE_TURN);
+    rac_voice_agent_event_t processed_event = {};
+    processed_event.type = RAC_VOICE_AGENT_EVENT_PROCESSED;
+    processed_event.data.result.speech_detected = RAC_TRUE;
+    processed_event.data.result.transcription = rac_strdup(stt_result.text);
+    processed_event.data.result.response = rac_strdup(response.c_str());
+    processed_event.data.result.trace = *trace;
+    callback(&processed_event, user_data);
+
+    rac_stt_result_free(&stt_result);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_voice_agent_process_stream_pipelined(rac_voice_agent_handle_t handle,
+                                                      const void* audio_data, size_t audio_size,
+                                                      rac_voice_agent_event_callback_fn callback,
+                                                      void* user_data) {
+    if (!handle || !audio_data || audio_size == 0 || !callback) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(handle->lifecycle_mutex);
+
+    rac_voice_turn_trace_t trace;
+    trace_start_turn(&trace, monotonic_ns());
+    rac_result_t result =
+        run_pipelined_turn(handle, audio_data, audio_size, callback, user_data, nullptr, &trace);
+    trace_report_turn(&trace, result);
+    return result;
+}
+
+// =============================================================================
+// VOICE SESSION - Continuous input, VAD endpointing, automatic responses
+// =============================================================================
+
+namespace {
+
+// Microphone audio is run through the VAD in frames of this length
+constexpr int32_t kSessionFrameMs = 20;
+
+// Microphone audio beyond this much queued is dropped (worker far behind capture)
+constexpr int32_t kMaxQueuedAudioMs = 10000;
+
+// How often an idle worker wakes up to check the playback and cooldown timers
+constexpr int32_t kTimerPollMs = 20;
+
+}  // namespace
+
+struct rac_voice_session {
+    rac_voice_agent_handle_t agent = nullptr;
+    rac_voice_session_config_t config = {};
+    rac_voice_agent_event_callback_fn callback = nullptr;
+    void* user_data = nullptr;
+    bool partials_enabled = false;
+
+    std::mutex state_mtx;
+    std::atomic<rac_audio_pipeline_state_t> state{RAC_AUDIO_PIPELINE_IDLE};
+    std::atomic<bool> playback_finished{false};
+    std::atomic<int64_t> playback_started_ms{0};
+    std::atomic<int64_t> last_tts_end_ms{0};
+
+    // Events come from the worker and the turn; one at a time
+    std::mutex event_mtx;
+
+    // Capture thread -> worker; the ring is lock-free so the capture callback never waits
+    std::unique_ptr<rac::SampleRing> queued;
+    std::mutex queue_mtx;
+    std::condition_variable queue_cv;
+    bool stopping = false;
+
+    // Native microphone (rac_voice_session_start_capture)
+    std::mutex capture_mtx;
+    rac_audio_capture_handle_t capture = nullptr;
+
+    // Endpointing state, worker thread only
+    std::vector<float> frame;
+    std::vector<int16_t> turn;  // Int16 PCM of the turn, or the pre-roll between turns
+    size_t pre_roll_samples = 0;
+    size_t last_partial_samples = 0;
+    bool in_turn = false;
+    int32_t voiced_ms = 0;
+    int32_t silence_ms = 0;
+    int64_t last_voiced_ns = 0;  // end of the last voiced frame, where endpointing starts
+    std::string partial;
+    bool speculated = false;  // prefill already started for this pause
+    bool awake = false;       // wake word heard; always true without a spotter
+    int64_t awake_until_ms = 0;
+
+    // Speculative STT + LLM prefill, off the endpointing thread
+    std::thread speculation;
+    std::atomic<bool> speculating{false};
+
+    // Transcription and response of the last turn, while the worker keeps listening
+    std::thread turn_thread;
+    std::atomic<bool> interrupted{false};
+
+    std::thread worker;
+
+    size_t samples_to_ms(size_t samples) const {
+        return samples * 1000 / static_cast<size_t>(config.sample_rate);
+    }
+};
+
+static void session_emit(rac_voice_session* session, const rac_voice_agent_event_t& event) {
+    std::lock_guard<std::mutex> lock(session->event_mtx);
+    session->callback(&event, session->user_data);
+}
+
+// Whether microphone frames are analysed in this state
+static bool session_is_listening(const rac_voice_session* session,
+                                 rac_audio_pipeline_state_t state) {
+    if (state == RAC_AUDIO_PIPELINE_LISTENING) {
+        return true;
+    }
+    return session->config.barge_in == RAC_TRUE &&
+           (state == RAC_AUDIO_PIPELINE_GENERATING_RESPONSE ||
+            state == RAC_AUDIO_PIPELINE_PLAYING_TTS);
+}
+
+static bool session_set_state(rac_voice_session* session, rac_audio_pipeline_state_t to) {
+    rac_audio_pipeline_state_t from;
+    {
+        std::lock_guard<std::mutex> lock(session->state_mtx);
+        from = session->state.load();
+        if (from == to) {
+            return true;
+        }
+        if (session->config.pipeline.strict_transitions == RAC_TRUE &&
+            rac_audio_pipeline_is_valid_transition(from, to) != RAC_TRUE) {
+            RAC_LOG_WARNING("VoiceAgent", "Rejected pipeline transition %s -> %s",
+                            rac_audio_pipeline_state_name(from),
+                            rac_audio_pipeline_state_name(to));
+            return false;
+        }
+        session->state = to;
+    }
+
+    // The VAD raises its threshold (and cancels echo, if enabled) during playback
+    if (to == RAC_AUDIO_PIPELINE_PLAYING_TTS) {
+        rac_vad_component_notify_tts_start(session->agent->vad_handle);
+    } else if (from == RAC_AUDIO_PIPELINE_PLAYING_TTS) {
+        rac_vad_component_notify_tts_finish(session->agent->vad_handle);
+    }
+
+    RAC_LOG_DEBUG("VoiceAgent", "Pipeline state %s -> %s", rac_audio_pipeline_state_name(from),
+                  rac_audio_pipeline_state_name(to));
+
+    rac_voice_agent_event_t event = {};
+    event.type = RAC_VOICE_AGENT_EVENT_STATE_CHANGED;
+    event.data.pipeline_state = to;
+    session_emit(session, event);
+    return true;
+}
+
+// Turn events pass through here to drive the state machine
+static void session_forward_event(const rac_voice_agent_event_t* event, void* user_data) {
+    auto* session = static_cast<rac_voice_session*>(user_data);
+    if (event->type == RAC_VOICE_AGENT_EVENT_TRANSCRIPTION &&
+        has_speakable_text(event->data.transcription)) {
+        session_set_state(session, RAC_AUDIO_PIPELINE_GENERATING_RESPONSE);
+    } else if (event->type == RAC_VOICE_AGENT_EVENT_AUDIO_CHUNK &&
+               session->state.load() == RAC_AUDIO_PIPELINE_GENERATING_RESPONSE) {
+        session->playback_finished = false;
+        session->playback_started_ms = rac_get_current_time_ms();
+        session_set_state(session, RAC_AUDIO_PIPELINE_PLAYING_TTS);
+    }
+    session_emit(session, *event);
+}
+
+static void session_partial_callback(const char* partial_text, rac_bool_t is_final,
+                                     void* user_data) {
+    (void)is_final;
+    if (partial_text) {
+        static_cast<rac_voice_session*>(user_data)->partial = partial_text;
+    }
+}
+
+static void session_emit_partial(rac_voice_session* session) {
+    session->last_partial_samples = session->turn.size();
+    session->partial.clear();
+    {
+        std::shared_lock<std::shared_mutex> lock(session->agent->lifecycle_mutex);
+        rac_stt_component_transcribe_stream(
+            session->agent->stt_handle, session->turn.data(),
+            session->turn.size() * sizeof(int16_t), nullptr, session_partial_callback, session);
+    }
+    if (has_speakable_text(session->partial.c_str())) {
+        rac_voice_agent_event_t event = {};
+        event.type = RAC_VOICE_AGENT_EVENT_PARTIAL_TRANSCRIPTION;
+        event.data.transcription = session->partial.c_str();
+        session_emit(session, event);
+    }
+}
+
+static void session_run_speculation(rac_voice_session* session, std::vector<int16_t> audio) {
+    std::shared_lock<std::shared_mutex> lock(session->agent->lifecycle_mutex);
+    rac_stt_result_t stt_result = {};
+    if (rac_stt_component_transcribe(session->agent->stt_handle, audio.data(),
+                                     audio.size() * sizeof(int16_t), nullptr,
+                                     &stt_result) == RAC_SUCCESS) {
+        if (has_speakable_text(stt_result.text)) {
+            int64_t start_ms = rac_get_current_time_ms();
+            rac_llm_component_prefill(session->agent->llm_handle, stt_result.text);
+            RAC_LOG_DEBUG("VoiceAgent", "Speculative prefill took %lld ms",
+                          static_cast<long long>(rac_get_current_time_ms() - start_ms));
+        }
+        rac_stt_result_free(&stt_result);
+    }
+    session->speculating = false;
+}
+
+// Prefill the LLM with the transcript so far while waiting for end of turn
+static void session_speculate(rac_voice_session* session) {
+    session->speculated = true;
+    if (session->speculating.load()) {
+        return;
+    }
+    if (session->speculation.joinable()) {
+        session->speculation.join();
+    }
+    session->speculating = true;
+    session->speculation = std::thread(session_run_speculation, session, session->turn);
+}
+
+static void session_run_turn(rac_voice_session* session, std::vector<int16_t> audio,
+                             rac_voice_turn_trace_t trace) {
+    rac_result_t result;
+    {
+        std::shared_lock<std::shared_mutex> lock(session->agent->lifecycle_mutex);
+        result = run_pipelined_turn(session->agent, audio.data(), audio.size() * sizeof(int16_t),
+                                    session_forward_event, session, &session->interrupted, &trace);
+    }
+    trace_report_turn(&trace, result);
+
+    // An interrupting worker moves the state on itself
+    if (session->interrupted.load()) {
+        return;
+    }
+    if (result != RAC_SUCCESS) {
+        session_set_state(session, RAC_AUDIO_PIPELINE_ERROR);
+        session_set_state(session, RAC_AUDIO_PIPELINE_IDLE);
+        return;
+    }
+    switch (session->state.load()) {
+        case RAC_AUDIO_PIPELINE_PROCESSING_SPEECH:
+            // Nothing was said, keep listening
+            session_set_state(session, RAC_AUDIO_PIPELINE_LISTENING);
+            break;
+        case RAC_AUDIO_PIPELINE_GENERATING_RESPONSE:
+            // Empty response, nothing to play
+            session->last_tts_end_ms = rac_get_current_time_ms();
+            session_set_state(session, RAC_AUDIO_PIPELINE_COOLDOWN);
+            break;
+        default:
+            // PLAYING_TTS until the app reports playback finished
+            break;
+    }
+}
+
+// Abandon the response in progress; stops it within one frame of speech
+static void session_interrupt_turn(rac_voice_session* session) {
+    session->interrupted = true;
+    rac_llm_component_cancel(session->agent->llm_handle);
+    rac_tts_component_stop(session->agent->tts_handle);
+    if (session->turn_thread.joinable()) {
+        session->turn_thread.join();
+    }
+    session->interrupted = false;
+}
+
+static void session_barge_in(rac_voice_session* session) {
+    int64_t start_ms = rac_get_current_time_ms();
+
+    // Tell the app first so it flushes queued playback while the response stops
+    rac_voice_agent_event_t event = {};
+    event.type = RAC_VOICE_AGENT_EVENT_INTERRUPTED;
+    session_emit(session, event);
+
+    session_interrupt_turn(session);
+    RAC_LOG_INFO("VoiceAgent", "Barge-in: response stopped after %lld ms",
+                 static_cast<long long>(rac_get_current_time_ms() - start_ms));
+
+    session_set_state(session, RAC_AUDIO_PIPELINE_IDLE);
+    session_set_state(session, RAC_AUDIO_PIPELINE_LISTENING);
+}
+
+static void session_end_turn(rac_voice_session* session) {
+    std::vector<int16_t> audio;
+    audio.swap(session->turn);
+    session->in_turn = false;
+    session->voiced_ms = 0;
+    session->silence_ms = 0;
+
+    rac_voice_agent_event_t vad_event = {};
+    vad_event.type = RAC_VOICE_AGENT_EVENT_VAD_TRIGGERED;
+    vad_event.data.vad_speech_active = RAC_FALSE;
+    session_emit(session, vad_event);
+
+    // The previous turn has ended unless its playback timed out
+    if (session->turn_thread.joinable()) {
+        session->turn_thread.join();
+    }
+    if (!session_set_state(session, RAC_AUDIO_PIPELINE_PROCESSING_SPEECH)) {
+        return;
+    }
+    RAC_LOG_INFO("VoiceAgent", "End of turn after %zu ms of audio",
+                 session->samples_to_ms(audio.size()));
+
+    // The user stopped talking at the last voiced frame; the turn runs from there
+    rac_voice_turn_trace_t trace;
+    trace_start_turn(&trace, session->last_voiced_ns);
+    trace.spans[RAC_VOICE_TURN_STAGE_ENDPOINT].start_ns = session->last_voiced_ns;
+    trace.spans[RAC_VOICE_TURN_STAGE_ENDPOINT].end_ns = monotonic_ns();
+    session->turn_thread = std::thread(session_run_turn, session, std::move(audio), trace);
+}
+
+// Asleep, only the spotter sees audio; a detection opens the session for turns
+static void session_spot_wake_word(rac_voice_session* session) {
+    const rac_voice_session_config_t& config = session->config;
+    std::vector<float>& frame = session->frame;
+
+    rac_kws_detection_t detection = {};
+    if (rac_kws_process(config.wake_word, frame.data(), frame.size(), config.sample_rate,
+                        &detection) != RAC_SUCCESS ||
+        detection.detected != RAC_TRUE) {
+        return;
+    }
+
+    RAC_LOG_INFO("VoiceAgent", "Wake word \"%s\" detected", detection.keyword);
+    session->awake = true;
+    session->awake_until_ms = rac_get_current_time_ms() + config.wake_window_ms;
+    session->turn.clear();
+    session->voiced_ms = 0;
+    // The VAD saw none of the audio while asleep; start it from a clean state
+    rac_vad_component_reset(session->agent->vad_handle);
+
+    rac_voice_agent_event_t event = {};
+    event.type = RAC_VOICE_AGENT_EVENT_WAKE_WORD;
+    event.data.keyword = detection.keyword;
+    session_emit(session, event);
+}
+
+static void session_process_frame(rac_voice_session* session) {
+    const rac_voice_session_config_t& config = session->config;
+    std::vector<float>& frame = session->frame;
+
+    if (!session->awake) {
+        session_spot_wake_word(session);
+        return;
+    }
+
+    rac_bool_t voiced = RAC_FALSE;
+    if (rac_vad_component_process(session->agent->vad_handle, frame.data(), frame.size(),
+                                  &voiced) != RAC_SUCCESS) {
+        voiced = RAC_FALSE;
+    }
+
+    size_t offset = session->turn.size();
+    session->turn.resize(offset + frame.size());
+    rac_audio_float_to_int16(frame.data(), session->turn.data() + offset, frame.size());
+
+    if (!session->in_turn) {
+        session->voiced_ms = voiced == RAC_TRUE ? session->voiced_ms + kSessionFrameMs : 0;
+        if (session->voiced_ms < config.min_speech_ms) {
+            if (session->turn.size() > session->pre_roll_samples) {
+                session->turn.erase(session->turn.begin(),
+                                    session->turn.end() - session->pre_roll_samples);
+            }
+            return;
+        }
+
+        if (session->state.load() != RAC_AUDIO_PIPELINE_LISTENING) {
+            session_barge_in(session);
+        }
+
+        session->in_turn = true;
+        session->silence_ms = 0;
+        session->last_voiced_ns = monotonic_ns();
+        session->last_partial_samples = 0;
+        rac_voice_agent_event_t event = {};
+        event.type = RAC_VOICE_AGENT_EVENT_VAD_TRIGGERED;
+        event.data.vad_speech_active = RAC_TRUE;
+        session_emit(session, event);
+        return;
+    }
+
+    session->silence_ms = voiced == RAC_TRUE ? 0 : session->silence_ms + kSessionFrameMs;
+    if (session->silence_ms == 0) {
+        session->speculated = false;
+        session->last_voiced_ns = monotonic_ns();
+    }
+    if (session->silence_ms >= config.end_of_turn_ms ||
+        session->samples_to_ms(session->turn.size()) >=
+            static_cast<size_t>(config.max_turn_ms)) {
+        session_end_turn(session);
+        return;
+    }
+
+    if (config.speculative_prefill_ms > 0 && !session->speculated &&
+        session->silence_ms >= config.speculative_prefill_ms) {
+        session_speculate(session);
+        return;
+    }
+
+    if (session->partials_enabled &&
+        session->samples_to_ms(session->turn.size() - session->last_partial_samples) >=
+            static_cast<size_t>(config.partial_interval_ms)) {
+        session_emit_partial(session);
+    }
+}
+
+// Leaves PLAYING_TTS and COOLDOWN once their time is up
+static void session_update_timers(rac_voice_session* session) {
+    const rac_audio_pipeline_config_t& pipeline = session->config.pipeline;
+    int64_t now = rac_get_current_time_ms();
+    int64_t cooldown_ms = static_cast<int64_t>(pipeline.cooldown_duration * 1000.0f);
+
+    if (session->state.load() == RAC_AUDIO_PIPELINE_PLAYING_TTS) {
+        bool timed_out = now - session->playback_started_ms >=
+                         static_cast<int64_t>(pipeline.max_tts_duration * 1000.0f);
+        if (session->playback_finished.exchange(false) || timed_out) {
+            if (timed_out) {
+                RAC_LOG_WARNING("VoiceAgent", "Playback not reported finished, timing out");
+            }
+            session->last_tts_end_ms = now;
+            session_set_state(session, RAC_AUDIO_PIPELINE_COOLDOWN);
+        }
+    }
+    if (session->state.load() == RAC_AUDIO_PIPELINE_COOLDOWN &&
+        now - session->last_tts_end_ms >= cooldown_ms) {
+        session_set_state(session, RAC_AUDIO_PIPELINE_IDLE);
+    }
+    if (session->state.load() == RAC_AUDIO_PIPELINE_IDLE &&
+        rac_audio_pipeline_can_activate_microphone(RAC_AUDIO_PIPELINE_IDLE,
+                                                   session->last_tts_end_ms,
+                                                   cooldown_ms) == RAC_TRUE) {
+        session_set_state(session, RAC_AUDIO_PIPELINE_LISTENING);
+    }
+
+    // The wake window runs from the end of the last turn or response
+    if (session->config.wake_word && session->awake) {
+        if (session->in_turn || session->state.load() != RAC_AUDIO_PIPELINE_LISTENING) {
+            session->awake_until_ms = now + session->config.wake_window_ms;
+        } else if (now >= session->awake_until_ms) {
+            RAC_LOG_INFO("VoiceAgent", "No speech for %d ms, waiting for the wake word",
+                         session->config.wake_window_ms);
+            session->awake = false;
+            session->turn.clear();
+            session->voiced_ms = 0;
+            rac_kws_reset(session->config.wake_word);
+        }
+    }
+}
+
+static void session_worker(rac_voice_session* session) {
+    const size_t frame_samples = session->frame.size();
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(session->queue_mtx);
+            session->queue_cv.wait_for(lock, std::chrono::milliseconds(kTimerPollMs), [session,
+                                                                                 frame_samples] {
+                return session->stopping || session->queued->size() >= frame_samples;
+            });
+            if (session->stopping) {
+                return;
+            }
+        }
+        bool have_frame = false;
+        if (session->queued->size() >= frame_samples) {
+            session->queued->read(session->frame.data(), frame_samples);
+            have_frame = true;
+        }
+
+        session_update_timers(session);
+        if (have_frame && session_is_listening(session, session->state.load())) {
+            session_process_frame(session);
+        }
+    }
+}
+
+rac_result_t rac_voice_session_create(rac_voice_agent_handle_t agent,
+                                      const rac_voice_session_config_t* config,
+                                      rac_voice_agent_event_callback_fn callback, void* user_data,
+                                      rac_voice_session_handle_t* out_session) {
+    if (!agent || !callback || !out_session) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    const rac_voice_session_config_t& cfg = config ? *config : RAC_VOICE_SESSION_CONFIG_DEFAULT;
+    if (cfg.sample_rate <= 0 || cfg.min_speech_ms <= 0 || cfg.end_of_turn_ms <= 0 ||
+        cfg.pre_roll_ms < 0 || cfg.max_turn_ms <= 0 || cfg.partial_interval_ms < 0 ||
+        cfg.speculative_prefill_ms < 0 || (cfg.wake_word && cfg.wake_window_ms <= 0)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(agent->lifecycle_mutex);
+        if (!agent->is_configured) {
+            RAC_LOG_ERROR("VoiceAgent", "Voice agent not initialized - cannot start session");
+            return RAC_ERROR_NOT_INITIALIZED;
+        }
+    }
+
+    rac_result_t result = rac_vad_component_start(agent->vad_handle);
+    if (result != RAC_SUCCESS) {
+        RAC_LOG_ERROR("VoiceAgent", "Failed to start VAD for voice session");
+        return result;
+    }
+    if (cfg.barge_in == RAC_TRUE) {
+        result = rac_vad_component_enable_echo_cancellation(agent->vad_handle, nullptr);
+        if (result != RAC_SUCCESS && result != RAC_ERROR_ALREADY_INITIALIZED) {
+            RAC_LOG_ERROR("VoiceAgent", "Failed to enable echo cancellation for barge-in");
+            rac_vad_component_stop(agent->vad_handle);
+            return result;
+        }
+    }
+
+    auto* session = new (std::nothrow) rac_voice_session();
+    if (!session) {
+        rac_vad_component_stop(agent->vad_handle);
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    session->agent = agent;
+    session->config = cfg;
+    session->callback = callback;
+    session->user_data = user_data;
+    session->awake = cfg.wake_word == nullptr;
+    session->partials_enabled = cfg.partial_interval_ms > 0 &&
+                                rac_stt_component_supports_streaming(agent->stt_handle) == RAC_TRUE;
+    session->frame.assign(static_cast<size_t>(cfg.sample_rate) * kSessionFrameMs / 1000, 0.0f);
+    session->pre_roll_samples =
+        static_cast<size_t>(cfg.sample_rate) * (cfg.pre_roll_ms + cfg.min_speech_ms) / 1000;
+    session->queued = std::make_unique<rac::SampleRing>(static_cast<size_t>(cfg.sample_rate) *
+                                                        kMaxQueuedAudioMs / 1000);
+    session->worker = std::thread(session_worker, session);
+
+    RAC_LOG_INFO("VoiceAgent", "Voice session started (end of turn after %d ms of silence)",
+                 cfg.end_of_turn_ms);
+    *out_session = session;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_voice_session_feed_audio(rac_voice_session_handle_t session,
+                                          const float* samples, size_t num_samples) {
+    if (!session || !samples) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    // The microphone is only live while listening (and during responses with barge-in)
+    if (num_samples == 0 || !session_is_listening(session, session->state.load())) {
+        return RAC_SUCCESS;
+    }
+
+    size_t written = session->queued->write(samples, num_samples);
+    session->queue_cv.notify_one();
+    return written == num_samples ? RAC_SUCCESS : RAC_ERROR_BUFFER_TOO_SMALL;
+}
+
+static void session_capture_callback(const float* samples, size_t num_samples, void* user_data) {
+    rac_voice_session_feed_audio(static_cast<rac_voice_session*>(user_data), samples,
+                                 num_samples);
+}
+
+rac_result_t rac_voice_session_start_capture(rac_voice_session_handle_t session,
+                                             const rac_audio_capture_config_t* config) {
+    if (!session) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(session->capture_mtx);
+    if (session->capture) {
+        return RAC_SUCCESS;
+    }
+    rac_audio_capture_config_t capture_config = config ? *config : RAC_AUDIO_CAPTURE_CONFIG_DEFAULT;
+    capture_config.sample_rate = session->config.sample_rate;
+
+    rac_audio_capture_handle_t capture = nullptr;
+    rac_result_t result =
+        rac_audio_capture_create(&capture_config, session_capture_callback, session, &capture);
+    if (result == RAC_SUCCESS) {
+        result = rac_audio_capture_start(capture);
+    }
+    if (result != RAC_SUCCESS) {
+        RAC_LOG_ERROR("VoiceAgent", "Native capture unavailable for voice session: %d", result);
+        rac_audio_capture_destroy(capture);
+        return result;
+    }
+    session->capture = capture;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_voice_session_stop_capture(rac_voice_session_handle_t session) {
+    if (!session) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(session->capture_mtx);
+    rac_audio_capture_destroy(session->capture);
+    session->capture = nullptr;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_voice_session_feed_playback(rac_voice_session_handle_t session,
+                                             const float* samples, size_t num_samples) {
+    if (!session || !samples) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    if (num_samples == 0) {
+        return RAC_SUCCESS;
+    }
+    return rac_vad_component_feed_playback(session->agent->vad_handle, samples, num_samples);
+}
+
+rac_result_t rac_voice_session_notify_playback_finished(rac_voice_session_handle_t session) {
+    if (!session) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    session->playback_finished = true;
+    session->queue_cv.notify_one();
+    return RAC_SUCCESS;
+}
+
+rac_audio_pipeline_state_t rac_voice_session_get_state(rac_voice_session_handle_t session) {
+    return session ? session->state.load() : RAC_AUDIO_PIPELINE_IDLE;
+}
+
+void rac_voice_session_destroy(rac_voice_session_handle_t session) {
+    if (!session) {
+        return;
+    }
+    rac_voice_session_stop_capture(session);
+    {
+        std::lock_guard<std::mutex> lock(session->queue_mtx);
+        session->stopping = true;
+    }
+    session->queue_cv.notify_one();
+    if (session->worker.joinable()) {
+        session->worker.join();
+    }
+    session_interrupt_turn(session);
+    if (session->speculation.joinable()) {
+        session->speculation.join();
+    }
+    rac_vad_component_stop(session->agent->vad_handle);
+    delete session;
+}
+
 // =============================================================================
 // INDIVIDUAL COMPONENT ACCESS API
 // =============================================================================
@@ -779,7 +2201,7 @@ rac_result_t rac_voice_agent_transcribe(rac_voice_agent_handle_t handle, const v
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    std::shared_lock<std::shared_mutex> lock(handle->lifecycle_mutex);
 
     if (!handle->is_configured) {
         return RAC_ERROR_NOT_INITIALIZED;
@@ -805,7 +2227,7 @@ rac_result_t rac_voice_agent_generate_response(rac_voice_agent_handle_t handle,
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    std::shared_lock<std::shared_mutex> lock(handle->lifecycle_mutex);
 
     if (!handle->is_configured) {
         return RAC_ERROR_NOT_INITIALIZED;
@@ -831,11 +2253,12 @@ rac_result_t rac_voice_agent_synthesize_speech(rac_voice_agent_handle_t handle,
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    std::shared_lock<std::shared_mutex> lock(handle->lifecycle_mutex);
 
     if (!handle->is_configured) {
         return RAC_ERROR_NOT_INITIALIZED;
     }
+    await_deferred_tts(handle);
 
     rac_tts_result_t tts_result = {};
     rac_result_t result =
@@ -890,17 +2313,17 @@ void rac_voice_agent_result_free(rac_voice_agent_result_t* result) {
     }
 
     if (result->transcription) {
-        free(result->transcription);
+        rac_free(result->transcription);
         result->transcription = nullptr;
     }
 
     if (result->response) {
-        free(result->response);
+        rac_free(result->response);
         result->response = nullptr;
     }
 
     if (result->synthesized_audio) {
-        free(result->synthesized_audio);
+        rac_free(result->synthesized_audio);
         result->synthesized_audio = nullptr;
     }
 
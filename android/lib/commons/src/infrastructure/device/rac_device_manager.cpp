@@ -8,6 +8,7 @@
 
 #include "rac/infrastructure/device/rac_device_manager.h"
 
+#include <cstdlib>
 #include <cstring>
 #include <mutex>
 #include <string>
@@ -17,6 +18,7 @@
 #include "rac/core/rac_platform_adapter.h"
 #include "rac/core/rac_types.h"
 #include "rac/infrastructure/network/rac_endpoints.h"
+#include "rac/infrastructure/network/rac_outbound_queue.h"
 #include "rac/infrastructure/telemetry/rac_telemetry_manager.h"
 
 // =============================================================================
@@ -30,6 +32,10 @@ struct DeviceManagerState {
     rac_device_callbacks_t callbacks = {};
     bool callbacks_set = false;
     std::mutex mutex;
+
+    // Build token for the queued registration (rac_device_manager_register_deferred)
+    std::mutex deferred_mutex;
+    std::string deferred_build_token;
 };
 
 DeviceManagerState& get_state() {
@@ -203,6 +209,35 @@ rac_result_t rac_device_manager_register_if_needed(rac_environment_t env, const
     return RAC_SUCCESS;
 }
 
+// Outbound queue handler; the payload is the environment
+static rac_result_t send_deferred_registration(const rac_outbound_item_t* items, size_t count,
+                                               void* /*user_data*/) {
+    auto& state = get_state();
+    std::string build_token;
+    {
+        std::lock_guard<std::mutex> lock(state.deferred_mutex);
+        build_token = state.deferred_build_token;
+    }
+    const std::string payload(items[count - 1].payload, items[count - 1].payload_length);
+    const auto env = static_cast<rac_environment_t>(std::atoi(payload.c_str()));
+    return rac_device_manager_register_if_needed(
+        env, build_token.empty() ? nullptr : build_token.c_str());
+}
+
+rac_result_t rac_device_manager_register_deferred(rac_environment_t env, const char* build_token) {
+    auto& state = get_state();
+    {
+        std::lock_guard<std::mutex> lock(state.deferred_mutex);
+        state.deferred_build_token = build_token ? build_token : "";
+    }
+    rac_outbound_queue_set_handler(RAC_OUTBOUND_KIND_DEVICE_REGISTRATION,
+                                   send_deferred_registration, 1, nullptr);
+    const std::string payload = std::to_string(static_cast<int>(env));
+    RAC_LOG_DEBUG(LOG_CAT, "Device registration queued");
+    return rac_outbound_queue_enqueue(RAC_OUTBOUND_KIND_DEVICE_REGISTRATION, "device",
+                                      payload.data(), payload.size(), RAC_REQUEST_PRIORITY_HIGH);
+}
+
 rac_bool_t rac_device_manager_is_registered(void) {
     auto& state = get_state();
     std::lock_guard<std::mutex> lock(state.mutex);
@@ -237,4 +272,25 @@ const char* rac_device_manager_get_device_id(void) {
     return state.callbacks.get_device_id(state.callbacks.user_data);
 }
 
+rac_result_t rac_device_manager_get_memory(int64_t* out_total_memory,
+                                           int64_t* out_available_memory) {
+    if (!out_total_memory || !out_available_memory) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto& state = get_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    if (!state.callbacks_set) {
+        return RAC_ERROR_INVALID_STATE;
+    }
+
+    rac_device_registration_info_t device_info = {};
+    state.callbacks.get_device_info(&device_info, state.callbacks.user_data);
+
+    *out_total_memory = device_info.total_memory;
+    *out_available_memory = device_info.available_memory > 0 ? device_info.available_memory : 0;
+    return RAC_SUCCESS;
+}
+
 }  // extern "C"
@@ -0,0 +1,569 @@
+/**
+ * @file rac_device_profile.cpp
+ * @brief Device Performance Profile Implementation
+ *
+ * The kernels are plain C++ written so the compiler vectorizes them, not
+ * tuned assembly: the numbers rank devices against each other and find
+ * where threading stops paying, they are not a GEMM library benchmark.
+ * Each measurement keeps the best of several short runs, which filters out
+ * a preempted run without holding the cores for long.
+ *
+ * The profile is stored as a small flat JSON object under
+ * RAC_DEVICE_PROFILE_STORAGE_KEY and loaded lazily on first use.
+ */
+
+#include "rac/infrastructure/device/rac_device_profile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rac/core/rac_analytics_events.h"
+#include "rac/core/rac_executor.h"
+#include "rac/core/rac_logger.h"
+#include "rac/core/rac_platform_adapter.h"
+#include "rac/core/rac_sdk_state.h"
+#include "rac/features/llm/rac_llm_service.h"
+
+static const char* LOG_CAT = "DeviceProfile";
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Matmul: square matrices of this order per thread, fit in L2 on most SoCs
+constexpr int kMatmulSize = 128;
+constexpr int kMatmulRuns = 5;
+// Triad: three arrays of this many floats, well past any last-level cache
+constexpr size_t kTriadFloats = 4u * 1024u * 1024u;
+constexpr int kTriadRuns = 5;
+// Fraction of peak throughput that counts as "stopped scaling"
+constexpr double kScalingThreshold = 0.9;
+constexpr int kMaxThreads = 16;
+
+constexpr int32_t kReferenceMaxTokens = 32;
+const char* const kReferencePrompt =
+    "Summarize the following in one sentence. The quick brown fox jumps over the lazy dog "
+    "while the farmer watches from the porch, wondering why the dog never seems to mind the "
+    "fox, and whether the two of them have come to some kind of arrangement over the years.";
+
+// Device class thresholds for this file's kernels
+constexpr double kHighGflops = 60.0;
+constexpr double kHighBandwidthGbps = 25.0;
+constexpr double kLowGflops = 15.0;
+constexpr double kLowBandwidthGbps = 8.0;
+
+struct ProfileState {
+    std::mutex mutex;
+    bool loaded = false;
+    bool has_profile = false;
+    rac_device_profile_t profile = {};
+    std::atomic<bool> calibrating{false};
+};
+
+ProfileState& profile_state() {
+    static ProfileState state;
+    return state;
+}
+
+struct EnsureRequest {
+    rac_handle_t reference_llm;
+    rac_device_profile_callback_fn callback;
+    void* user_data;
+    std::atomic<bool> cancelled{false};
+};
+
+double elapsed_seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int online_cores() {
+    const unsigned hw = std::thread::hardware_concurrency();
+    return std::max(1, std::min(kMaxThreads, static_cast<int>(hw)));
+}
+
+// Runs fn(index) on count threads, the calling thread taking index 0
+template <typename Fn>
+void run_parallel(int count, Fn fn) {
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<size_t>(count - 1));
+    for (int i = 1; i < count; i++) {
+        threads.emplace_back(fn, i);
+    }
+    fn(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+// c += a * b for row-major n x n matrices; the unit-stride inner loop vectorizes
+void matmul(const float* a, const float* b, float* c, int n) {
+    for (int i = 0; i < n; i++) {
+        float* c_row = c + static_cast<size_t>(i) * n;
+        for (int k = 0; k < n; k++) {
+            const float a_ik = a[static_cast<size_t>(i) * n + k];
+            const float* b_row = b + static_cast<size_t>(k) * n;
+            for (int j = 0; j < n; j++) {
+                c_row[j] += a_ik * b_row[j];
+            }
+        }
+    }
+}
+
+// Aggregate GFLOPS of `threads` independent matmuls, best of kMatmulRuns
+double measure_matmul(int threads) {
+    const size_t elems = static_cast<size_t>(kMatmulSize) * kMatmulSize;
+    std::vector<std::vector<float>> buffers(static_cast<size_t>(threads) * 3);
+    for (size_t i = 0; i < buffers.size(); i++) {
+        buffers[i].assign(elems, i % 3 == 2 ? 0.0f : 1.0f / static_cast<float>(i % 7 + 1));
+    }
+
+    const double flops = 2.0 * kMatmulSize * kMatmulSize * kMatmulSize * threads;
+    double best = 0.0;
+    for (int run = 0; run < kMatmulRuns; run++) {
+        const Clock::time_point start = Clock::now();
+        run_parallel(threads, [&](int t) {
+            const size_t base = static_cast<size_t>(t) * 3;
+            matmul(buffers[base].data(), buffers[base + 1].data(), buffers[base + 2].data(),
+                   kMatmulSize);
+        });
+        const double seconds = elapsed_seconds(start);
+        if (seconds > 0.0) {
+            best = std::max(best, flops / seconds / 1e9);
+        }
+    }
+    return best;
+}
+
+// STREAM triad a = b + s * c over `threads` slices, GB/s, best of kTriadRuns
+double measure_bandwidth(int threads) {
+    std::vector<float> a(kTriadFloats, 0.0f);
+    std::vector<float> b(kTriadFloats, 1.0f);
+    std::vector<float> c(kTriadFloats, 2.0f);
+    const size_t slice = (kTriadFloats + threads - 1) / threads;
+
+    const double bytes = 3.0 * sizeof(float) * kTriadFloats;
+    double best = 0.0;
+    for (int run = 0; run < kTriadRuns; run++) {
+        const float scalar = 0.5f + static_cast<float>(run);
+        const Clock::time_point start = Clock::now();
+        run_parallel(threads, [&](int t) {
+            const size_t begin = std::min(kTriadFloats, slice * t);
+            const size_t end = std::min(kTriadFloats, begin + slice);
+            float* out = a.data();
+            const float* lhs = b.data();
+            const float* rhs = c.data();
+            for (size_t i = begin; i < end; i++) {
+                out[i] = lhs[i] + scalar * rhs[i];
+            }
+        });
+        const double seconds = elapsed_seconds(start);
+        if (seconds > 0.0) {
+            best = std::max(best, bytes / seconds / 1e9);
+        }
+    }
+    // Keep the stores observable so the loop is not dropped
+    volatile float sink = a[kTriadFloats / 2];
+    (void)sink;
+    return best;
+}
+
+// Times one short generation; leaves the speeds at 0 if it fails
+void measure_reference(rac_handle_t llm, rac_device_profile_t* profile) {
+    rac_llm_info_t info = {};
+    if (rac_llm_get_info(llm, &info) == RAC_SUCCESS && info.current_model) {
+        snprintf(profile->reference_model_id, sizeof(profile->reference_model_id), "%s",
+                 info.current_model);
+    }
+
+    rac_llm_options_t options = RAC_LLM_OPTIONS_DEFAULT;
+    options.max_tokens = kReferenceMaxTokens;
+    options.temperature = 0.0f;
+    rac_llm_result_t result = {};
+    const rac_result_t status = rac_llm_generate(llm, kReferencePrompt, &options, &result);
+    if (status != RAC_SUCCESS) {
+        RAC_LOG_WARNING(LOG_CAT, "Reference generation failed: %d", status);
+        profile->reference_model_id[0] = '\0';
+        return;
+    }
+
+    if (result.prompt_tokens > 0 && result.time_to_first_token_ms > 0) {
+        profile->prefill_tokens_per_second =
+            result.prompt_tokens * 1000.0 / static_cast<double>(result.time_to_first_token_ms);
+    }
+    // The first token belongs to prefill
+    const int64_t decode_ms = result.total_time_ms - result.time_to_first_token_ms;
+    if (result.completion_tokens > 1 && decode_ms > 0) {
+        profile->decode_tokens_per_second =
+            (result.completion_tokens - 1) * 1000.0 / static_cast<double>(decode_ms);
+    } else if (result.tokens_per_second > 0.0f) {
+        profile->decode_tokens_per_second = result.tokens_per_second;
+    }
+    rac_llm_result_free(&result);
+}
+
+rac_device_class_t classify(const rac_device_profile_t& profile) {
+    if (profile.matmul_gflops <= 0.0 || profile.memory_bandwidth_gbps <= 0.0) {
+        return RAC_DEVICE_CLASS_UNKNOWN;
+    }
+    if (profile.matmul_gflops < kLowGflops || profile.memory_bandwidth_gbps < kLowBandwidthGbps) {
+        return RAC_DEVICE_CLASS_LOW;
+    }
+    if (profile.matmul_gflops >= kHighGflops &&
+        profile.memory_bandwidth_gbps >= kHighBandwidthGbps) {
+        return RAC_DEVICE_CLASS_HIGH;
+    }
+    return RAC_DEVICE_CLASS_MID;
+}
+
+// =============================================================================
+// PERSISTENCE
+// =============================================================================
+
+std::string to_json(const rac_device_profile_t& profile) {
+    // Model IDs are slugs; drop anything that would need escaping
+    std::string model_id;
+    for (const char* p = profile.reference_model_id; *p; p++) {
+        if (*p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20) {
+            model_id += *p;
+        }
+    }
+
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer),
+             "{\"version\":%d,\"matmul_gflops\":%.3f,\"matmul_gflops_single\":%.3f,"
+             "\"memory_bandwidth_gbps\":%.3f,\"best_threads\":%d,\"core_count\":%d,"
+             "\"prefill_tokens_per_second\":%.3f,\"decode_tokens_per_second\":%.3f,"
+             "\"device_class\":%d,\"measured_at_ms\":%lld,\"reference_model_id\":\"",
+             profile.version, profile.matmul_gflops, profile.matmul_gflops_single,
+             profile.memory_bandwidth_gbps, profile.best_threads, profile.core_count,
+             profile.prefill_tokens_per_second, profile.decode_tokens_per_second,
+             static_cast<int>(profile.device_class),
+             static_cast<long long>(profile.measured_at_ms));
+    return std::string(buffer) + model_id + "\"}";
+}
+
+// Number after "key": in a flat object, or false if absent
+bool json_number(const char* json, const char* key, double* out) {
+    const std::string needle = std::string("\"") + key + "\":";
+    const char* at = strstr(json, needle.c_str());
+    if (!at) {
+        return false;
+    }
+    char* end = nullptr;
+    *out = strtod(at + needle.size(), &end);
+    return end != at + needle.size();
+}
+
+bool from_json(const char* json, rac_device_profile_t* out) {
+    rac_device_profile_t profile = {};
+    double version = 0, gflops = 0, single = 0, bandwidth = 0, threads = 0, cores = 0;
+    double prefill = 0, decode = 0, device_class = 0, measured_at = 0;
+    if (!json_number(json, "version", &version) ||
+        static_cast<int>(version) != RAC_DEVICE_PROFILE_VERSION ||
+        !json_number(json, "matmul_gflops", &gflops) ||
+        !json_number(json, "memory_bandwidth_gbps", &bandwidth) ||
+        !json_number(json, "device_class", &device_class)) {
+        return false;
+    }
+    json_number(json, "matmul_gflops_single", &single);
+    json_number(json, "best_threads", &threads);
+    json_number(json, "core_count", &cores);
+    json_number(json, "prefill_tokens_per_second", &prefill);
+    json_number(json, "decode_tokens_per_second", &decode);
+    json_number(json, "measured_at_ms", &measured_at);
+
+    profile.version = RAC_DEVICE_PROFILE_VERSION;
+    profile.matmul_gflops = gflops;
+    profile.matmul_gflops_single = single;
+    profile.memory_bandwidth_gbps = bandwidth;
+    profile.best_threads = static_cast<int32_t>(threads);
+    profile.core_count = static_cast<int32_t>(cores);
+    profile.prefill_tokens_per_second = prefill;
+    profile.decode_tokens_per_second = decode;
+    profile.device_class = static_cast<rac_device_class_t>(
+        std::min(std::max(static_cast<int>(device_class), 0), 3));
+    profile.measured_at_ms = static_cast<int64_t>(measured_at);
+
+    const char* const model_key = "\"reference_model_id\":\"";
+    const char* model = strstr(json, model_key);
+    if (model) {
+        model += strlen(model_key);
+        const char* end = strchr(model, '"');
+        const size_t len = end ? static_cast<size_t>(end - model) : 0;
+        const size_t kept = std::min(len, sizeof(profile.reference_model_id) - 1);
+        memcpy(profile.reference_model_id, model, kept);
+        profile.reference_model_id[kept] = '\0';
+    }
+    *out = profile;
+    return true;
+}
+
+// Caller holds state.mutex
+void load_locked(ProfileState& state) {
+    if (state.loaded) {
+        return;
+    }
+    state.loaded = true;
+    char* stored = rac_state_load_value(RAC_DEVICE_PROFILE_STORAGE_KEY);
+    if (stored) {
+        state.has_profile = from_json(stored, &state.profile);
+        if (!state.has_profile) {
+            RAC_LOG_INFO(LOG_CAT, "Stored profile is outdated or unreadable; will recalibrate");
+        }
+        rac_free(stored);
+    }
+}
+
+void emit_device_profiled(const rac_device_profile_t& profile, double duration_ms) {
+    rac_analytics_event_data_t event = {};
+    event.type = RAC_EVENT_DEVICE_PROFILED;
+    event.data.device_profile = RAC_ANALYTICS_DEVICE_PROFILE_DEFAULT;
+    event.data.device_profile.device_class = rac_device_class_name(profile.device_class);
+    event.data.device_profile.matmul_gflops = profile.matmul_gflops;
+    event.data.device_profile.memory_bandwidth_gbps = profile.memory_bandwidth_gbps;
+    event.data.device_profile.prefill_tokens_per_second = profile.prefill_tokens_per_second;
+    event.data.device_profile.decode_tokens_per_second = profile.decode_tokens_per_second;
+    event.data.device_profile.reference_model_id =
+        profile.reference_model_id[0] ? profile.reference_model_id : nullptr;
+    event.data.device_profile.best_threads = profile.best_threads;
+    event.data.device_profile.duration_ms = duration_ms;
+
+    rac_analytics_event_emit(RAC_EVENT_DEVICE_PROFILED, &event);
+}
+
+rac_result_t calibrate(rac_handle_t reference_llm, const std::atomic<bool>* cancelled,
+                       rac_device_profile_t* out_profile) {
+    const Clock::time_point start = Clock::now();
+    rac_device_profile_t profile = {};
+    profile.version = RAC_DEVICE_PROFILE_VERSION;
+    profile.core_count = online_cores();
+
+    // Compute scaling: 1, 2, 4, ... threads, then all cores
+    std::vector<std::pair<int, double>> samples;
+    for (int threads = 1;; threads = std::min(threads * 2, profile.core_count)) {
+        if (cancelled && cancelled->load()) {
+            return RAC_ERROR_CANCELLED;
+        }
+        samples.emplace_back(threads, measure_matmul(threads));
+        if (threads == profile.core_count) {
+            break;
+        }
+    }
+    profile.matmul_gflops_single = samples.front().second;
+    for (const auto& sample : samples) {
+        profile.matmul_gflops = std::max(profile.matmul_gflops, sample.second);
+    }
+    for (const auto& sample : samples) {
+        if (sample.second >= kScalingThreshold * profile.matmul_gflops) {
+            profile.best_threads = sample.first;
+            break;
+        }
+    }
+
+    if (cancelled && cancelled->load()) {
+        return RAC_ERROR_CANCELLED;
+    }
+    profile.memory_bandwidth_gbps = measure_bandwidth(profile.best_threads);
+
+    if (reference_llm) {
+        if (cancelled && cancelled->load()) {
+            return RAC_ERROR_CANCELLED;
+        }
+        measure_reference(reference_llm, &profile);
+    }
+
+    profile.device_class = classify(profile);
+    profile.measured_at_ms = rac_get_current_time_ms();
+    const double duration_ms = elapsed_seconds(start) * 1000.0;
+
+    RAC_LOG_INFO(LOG_CAT,
+                 "Calibrated in %.0f ms: %s, %.1f GFLOPS (%.1f single, peak at %d/%d threads), "
+                 "%.1f GB/s, prefill %.1f tok/s, decode %.1f tok/s",
+                 duration_ms, rac_device_class_name(profile.device_class), profile.matmul_gflops,
+                 profile.matmul_gflops_single, profile.best_threads, profile.core_count,
+                 profile.memory_bandwidth_gbps, profile.prefill_tokens_per_second,
+                 profile.decode_tokens_per_second);
+
+    {
+        ProfileState& state = profile_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.loaded = true;
+        state.has_profile = true;
+        state.profile = profile;
+    }
+    if (!rac_state_persist_value(RAC_DEVICE_PROFILE_STORAGE_KEY, to_json(profile).c_str())) {
+        RAC_LOG_DEBUG(LOG_CAT, "No persistence callback; profile kept for this session only");
+    }
+    emit_device_profiled(profile, duration_ms);
+
+    if (out_profile) {
+        *out_profile = profile;
+    }
+    return RAC_SUCCESS;
+}
+
+void ensure_run(rac_request_id_t /*id*/, void* user_data) {
+    auto* request = static_cast<EnsureRequest*>(user_data);
+    rac_device_profile_t profile;
+    const rac_result_t result = calibrate(request->reference_llm, &request->cancelled, &profile);
+    if (result != RAC_SUCCESS) {
+        RAC_LOG_WARNING(LOG_CAT, "Background calibration stopped: %d", result);
+    }
+    if (request->callback) {
+        request->callback(result, result == RAC_SUCCESS ? &profile : nullptr, request->user_data);
+    }
+}
+
+void ensure_cancel(rac_request_id_t /*id*/, void* user_data) {
+    static_cast<EnsureRequest*>(user_data)->cancelled.store(true);
+}
+
+void ensure_release(rac_request_id_t /*id*/, rac_bool_t ran, void* user_data) {
+    auto* request = static_cast<EnsureRequest*>(user_data);
+    if (!ran && request->callback) {
+        request->callback(RAC_ERROR_CANCELLED, nullptr, request->user_data);
+    }
+    profile_state().calibrating.store(false);
+    delete request;
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_device_profile_calibrate(rac_handle_t reference_llm,
+                                          rac_device_profile_t* out_profile) {
+    return calibrate(reference_llm, nullptr, out_profile);
+}
+
+rac_result_t rac_device_profile_ensure(rac_handle_t reference_llm,
+                                       rac_device_profile_callback_fn callback,
+                                       void* user_data) {
+    ProfileState& state = profile_state();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        load_locked(state);
+        if (state.has_profile) {
+            return RAC_SUCCESS;
+        }
+    }
+    if (state.calibrating.exchange(true)) {
+        RAC_LOG_DEBUG(LOG_CAT, "Calibration already queued");
+        return RAC_SUCCESS;
+    }
+
+    auto* request = new EnsureRequest();
+    request->reference_llm = reference_llm;
+    request->callback = callback;
+    request->user_data = user_data;
+
+    rac_request_t desc = {};
+    desc.priority = RAC_REQUEST_PRIORITY_LOW;
+    desc.run = ensure_run;
+    desc.cancel = ensure_cancel;
+    desc.release = ensure_release;
+    desc.user_data = request;
+    rac_request_id_t id = 0;
+    const rac_result_t result = rac_executor_submit(&desc, &id);
+    if (result != RAC_SUCCESS) {
+        state.calibrating.store(false);
+        delete request;
+        return result;
+    }
+    RAC_LOG_INFO(LOG_CAT, "Device calibration queued");
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_device_profile_get(rac_device_profile_t* out_profile) {
+    if (!out_profile) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    ProfileState& state = profile_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    load_locked(state);
+    if (!state.has_profile) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+    *out_profile = state.profile;
+    return RAC_SUCCESS;
+}
+
+void rac_device_profile_clear(void) {
+    ProfileState& state = profile_state();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.loaded = true;
+        state.has_profile = false;
+        state.profile = {};
+    }
+    rac_state_persist_value(RAC_DEVICE_PROFILE_STORAGE_KEY, nullptr);
+}
+
+rac_device_class_t rac_device_profile_get_class(void) {
+    rac_device_profile_t profile;
+    return rac_device_profile_get(&profile) == RAC_SUCCESS ? profile.device_class
+                                                           : RAC_DEVICE_CLASS_UNKNOWN;
+}
+
+rac_result_t rac_device_profile_recommend(rac_device_recommendation_t* out_recommendation) {
+    if (!out_recommendation) {
+        return RAC_ERROR_NULL_POINTER;
+    }
+    *out_recommendation = {};
+    rac_device_profile_t profile;
+    const rac_result_t result = rac_device_profile_get(&profile);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+
+    // Decode is bandwidth-bound, so threads past the compute knee only add heat
+    out_recommendation->llm_threads = std::max(1, std::min(profile.best_threads, 8));
+    switch (profile.device_class) {
+        case RAC_DEVICE_CLASS_LOW:
+            out_recommendation->llm_batch_tokens = 128;
+            out_recommendation->llm_context_length = 2048;
+            out_recommendation->max_model_bytes = 1LL << 30;
+            break;
+        case RAC_DEVICE_CLASS_HIGH:
+            out_recommendation->llm_batch_tokens = 512;
+            out_recommendation->llm_context_length = 8192;
+            out_recommendation->max_model_bytes = 0;
+            break;
+        case RAC_DEVICE_CLASS_MID:
+        case RAC_DEVICE_CLASS_UNKNOWN:
+        default:
+            out_recommendation->llm_batch_tokens = 256;
+            out_recommendation->llm_context_length = 4096;
+            out_recommendation->max_model_bytes = 3LL << 30;
+            break;
+    }
+    return RAC_SUCCESS;
+}
+
+const char* rac_device_class_name(rac_device_class_t device_class) {
+    switch (device_class) {
+        case RAC_DEVICE_CLASS_LOW:
+            return "low";
+        case RAC_DEVICE_CLASS_MID:
+            return "mid";
+        case RAC_DEVICE_CLASS_HIGH:
+            return "high";
+        case RAC_DEVICE_CLASS_UNKNOWN:
+        default:
+            return "unknown";
+    }
+}
+
+}  // extern "C"
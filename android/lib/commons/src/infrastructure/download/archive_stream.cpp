@@ -0,0 +1,936 @@
+/**
+ * @file archive_stream.cpp
+ * @brief RunAnywhere Commons - Streaming Archive Extraction
+ *
+ * Layers, each fed by the one before it:
+ *   codec (gzip / bzip2 / xz, or none for zip)
+ *   -> container parser (tar headers, zip local file headers)
+ *   -> EntryWriter (sanitized paths under the destination directory)
+ *
+ * Parsers are push state machines: they accept any chunk size and keep only
+ * the current header in memory. Zip is read through its local file headers,
+ * so the central directory at the end of the file is never needed.
+ */
+
+#include "rac/infrastructure/download/rac_archive_stream.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(RAC_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(RAC_HAVE_BZIP2)
+#include <bzlib.h>
+#endif
+#if defined(RAC_HAVE_LZMA)
+#include <lzma.h>
+#endif
+
+#include "rac/core/rac_logger.h"
+#include "rac/core/rac_trace.h"
+
+namespace {
+
+constexpr size_t kOutputChunk = 64 * 1024;
+
+// =============================================================================
+// ENTRY WRITER
+// =============================================================================
+
+bool make_directories(const std::string& path) {
+    for (size_t pos = 1; pos <= path.size(); ++pos) {
+        if (pos == path.size() || path[pos] == '/') {
+            const std::string prefix = path.substr(0, pos);
+            if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+class EntryWriter {
+   public:
+    explicit EntryWriter(std::string root) : root_(std::move(root)) {}
+    ~EntryWriter() { close_file(); }
+
+    bool init() { return make_directories(root_); }
+
+    int32_t file_count() const { return file_count_; }
+
+    // Joins a path from the archive onto the root; empty if it would escape it
+    std::string resolve(const std::string& name) const {
+        if (name.empty() || name[0] == '/') {
+            return {};
+        }
+        std::string out = root_;
+        size_t start = 0;
+        while (start <= name.size()) {
+            size_t end = name.find('/', start);
+            if (end == std::string::npos) {
+                end = name.size();
+            }
+            const std::string part = name.substr(start, end - start);
+            if (part == "..") {
+                return {};
+            }
+            if (!part.empty() && part != ".") {
+                out += '/';
+                out += part;
+            }
+            start = end + 1;
+        }
+        return out == root_ ? std::string() : out;
+    }
+
+    // false on I/O failure; unsafe names are skipped and reported via skipped()
+    bool open_file(const std::string& name) {
+        close_file();
+        skipped_ = false;
+        const std::string path = resolve(name);
+        if (path.empty()) {
+            RAC_LOG_WARNING("ArchiveStream", "Skipping unsafe entry %s", name.c_str());
+            skipped_ = true;
+            return true;
+        }
+        const size_t slash = path.rfind('/');
+        if (!make_directories(path.substr(0, slash))) {
+            return false;
+        }
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            return false;
+        }
+        file_count_++;
+        return true;
+    }
+
+    bool make_dir(const std::string& name) {
+        const std::string path = resolve(name);
+        return path.empty() || make_directories(path);
+    }
+
+    bool write(const uint8_t* data, size_t size) {
+        while (fd_ >= 0 && size > 0) {
+            ssize_t written = ::write(fd_, data, size);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool close_file() {
+        if (fd_ < 0) {
+            return true;
+        }
+        const bool ok = ::close(fd_) == 0;
+        fd_ = -1;
+        return ok;
+    }
+
+    bool skipped() const { return skipped_; }
+
+   private:
+    std::string root_;
+    int fd_ = -1;
+    bool skipped_ = false;
+    int32_t file_count_ = 0;
+};
+
+rac_result_t write_error() {
+    return errno == ENOSPC ? RAC_ERROR_STORAGE_FULL : RAC_ERROR_FILE_WRITE_FAILED;
+}
+
+// =============================================================================
+// TAR PARSER
+// =============================================================================
+
+uint64_t parse_tar_number(const uint8_t* field, size_t size) {
+    // GNU base-256 for sizes of 8 GB and more
+    if (field[0] & 0x80) {
+        uint64_t value = field[0] & 0x7f;
+        for (size_t i = 1; i < size; ++i) {
+            value = (value << 8) | field[i];
+        }
+        return value;
+    }
+    uint64_t value = 0;
+    for (size_t i = 0; i < size && field[i]; ++i) {
+        if (field[i] >= '0' && field[i] <= '7') {
+            value = (value << 3) | static_cast<uint64_t>(field[i] - '0');
+        }
+    }
+    return value;
+}
+
+std::string tar_field(const uint8_t* field, size_t size) {
+    const void* nul = memchr(field, 0, size);
+    const size_t len = nul ? static_cast<size_t>(static_cast<const uint8_t*>(nul) - field) : size;
+    return std::string(reinterpret_cast<const char*>(field), len);
+}
+
+class TarParser {
+   public:
+    explicit TarParser(EntryWriter& writer) : writer_(writer) {}
+
+    // An archive may end at a block boundary without the two zero blocks
+    bool complete() const {
+        return state_ == State::End || (state_ == State::Header && header_fill_ == 0);
+    }
+
+    bool ended() const { return state_ == State::End; }
+
+    rac_result_t consume(const uint8_t* data, size_t size) {
+        while (size > 0 && state_ != State::End) {
+            size_t used = 0;
+            rac_result_t result = RAC_SUCCESS;
+            switch (state_) {
+                case State::Header:
+                    used = std::min(size, sizeof(header_) - header_fill_);
+                    memcpy(header_ + header_fill_, data, used);
+                    header_fill_ += used;
+                    if (header_fill_ == sizeof(header_)) {
+                        header_fill_ = 0;
+                        result = begin_entry();
+                    }
+                    break;
+                case State::Data:
+                    used = static_cast<size_t>(std::min<uint64_t>(size, remaining_));
+                    result = entry_data(data, used);
+                    remaining_ -= used;
+                    if (result == RAC_SUCCESS && remaining_ == 0) {
+                        result = end_entry();
+                    }
+                    break;
+                case State::Padding:
+                    used = static_cast<size_t>(std::min<uint64_t>(size, remaining_));
+                    remaining_ -= used;
+                    if (remaining_ == 0) {
+                        state_ = State::Header;
+                    }
+                    break;
+                case State::End:
+                    break;
+            }
+            if (result != RAC_SUCCESS) {
+                return result;
+            }
+            data += used;
+            size -= used;
+        }
+        return RAC_SUCCESS;
+    }
+
+   private:
+    enum class State { Header, Data, Padding, End };
+    enum class Target { File, Skip, LongName, Pax };
+
+    rac_result_t begin_entry() {
+        bool all_zero = true;
+        unsigned int sum = 0;
+        for (size_t i = 0; i < sizeof(header_); ++i) {
+            all_zero = all_zero && header_[i] == 0;
+            sum += (i >= 148 && i < 156) ? ' ' : header_[i];
+        }
+        if (all_zero) {
+            state_ = State::End;
+            return RAC_SUCCESS;
+        }
+        if (sum != parse_tar_number(header_ + 148, 8)) {
+            RAC_LOG_ERROR("ArchiveStream", "Corrupt tar header");
+            return RAC_ERROR_EXTRACTION_FAILED;
+        }
+
+        std::string name = next_name_;
+        if (name.empty()) {
+            name = tar_field(header_, 100);
+            if (memcmp(header_ + 257, "ustar", 5) == 0 && header_[345]) {
+                name = tar_field(header_ + 345, 155) + "/" + name;
+            }
+        }
+        remaining_ = parse_tar_number(header_ + 124, 12);
+        padding_ = (512 - remaining_ % 512) % 512;
+
+        const char type = static_cast<char>(header_[156]);
+        if (type == 'L' || type == 'x') {
+            target_ = type == 'L' ? Target::LongName : Target::Pax;
+            meta_.clear();
+        } else {
+            next_name_.clear();
+            if (type == '0' || type == '\0' || type == '7') {
+                if (!writer_.open_file(name)) {
+                    return write_error();
+                }
+                target_ = writer_.skipped() ? Target::Skip : Target::File;
+            } else {
+                // Directories carry no data; links and device nodes are skipped
+                if (type == '5' && !writer_.make_dir(name)) {
+                    return write_error();
+                }
+                target_ = Target::Skip;
+            }
+        }
+
+        state_ = State::Data;
+        return remaining_ == 0 ? end_entry() : RAC_SUCCESS;
+    }
+
+    rac_result_t entry_data(const uint8_t* data, size_t size) {
+        switch (target_) {
+            case Target::File:
+                return writer_.write(data, size) ? RAC_SUCCESS : write_error();
+            case Target::LongName:
+            case Target::Pax:
+                if (meta_.size() + size > kMaxMetaSize) {
+                    return RAC_ERROR_EXTRACTION_FAILED;
+                }
+                meta_.append(reinterpret_cast<const char*>(data), size);
+                return RAC_SUCCESS;
+            case Target::Skip:
+                return RAC_SUCCESS;
+        }
+        return RAC_SUCCESS;
+    }
+
+    rac_result_t end_entry() {
+        if (target_ == Target::File && !writer_.close_file()) {
+            return write_error();
+        }
+        if (target_ == Target::LongName) {
+            next_name_ = meta_.substr(0, meta_.find('\0'));
+        } else if (target_ == Target::Pax) {
+            parse_pax();
+        }
+        remaining_ = padding_;
+        state_ = remaining_ > 0 ? State::Padding : State::Header;
+        return RAC_SUCCESS;
+    }
+
+    // Records are "<length> <key>=<value>\n"; only the path matters here
+    void parse_pax() {
+        size_t pos = 0;
+        while (pos < meta_.size()) {
+            const size_t length = strtoul(meta_.c_str() + pos, nullptr, 10);
+            const size_t space = meta_.find(' ', pos);
+            if (length == 0 || space == std::string::npos || pos + length > meta_.size()) {
+                return;
+            }
+            const std::string record = meta_.substr(space + 1, pos + length - space - 2);
+            if (record.compare(0, 5, "path=") == 0) {
+                next_name_ = record.substr(5);
+            }
+            pos += length;
+        }
+    }
+
+    static constexpr size_t kMaxMetaSize = 64 * 1024;
+
+    EntryWriter& writer_;
+    State state_ = State::Header;
+    Target target_ = Target::Skip;
+    uint8_t header_[512];
+    size_t header_fill_ = 0;
+    uint64_t remaining_ = 0;
+    uint64_t padding_ = 0;
+    std::string meta_;
+    std::string next_name_;
+};
+
+// =============================================================================
+// ZIP PARSER
+// =============================================================================
+
+uint16_t le16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t le32(const uint8_t* p) {
+    return static_cast<uint32_t>(le16(p)) | (static_cast<uint32_t>(le16(p + 2)) << 16);
+}
+
+uint64_t le64(const uint8_t* p) {
+    return static_cast<uint64_t>(le32(p)) | (static_cast<uint64_t>(le32(p + 4)) << 32);
+}
+
+constexpr uint32_t kZipLocalHeader = 0x04034b50;
+constexpr uint32_t kZipCentralHeader = 0x02014b50;
+constexpr uint32_t kZipEndOfCentral = 0x06054b50;
+constexpr uint32_t kZipDescriptor = 0x08074b50;
+constexpr uint16_t kZipFlagDescriptor = 0x0008;
+
+class ZipParser {
+   public:
+    explicit ZipParser(EntryWriter& writer) : writer_(writer) {}
+
+    ~ZipParser() {
+#if defined(RAC_HAVE_ZLIB)
+        if (inflating_) {
+            inflateEnd(&inflater_);
+        }
+#endif
+    }
+
+    bool complete() const {
+        return state_ == State::End || (state_ == State::Signature && buffer_.empty());
+    }
+
+    bool ended() const { return state_ == State::End; }
+
+    rac_result_t consume(const uint8_t* data, size_t size) {
+        while (size > 0 && state_ != State::End) {
+            size_t used = 0;
+            rac_result_t result = RAC_SUCCESS;
+            if (state_ == State::Stored) {
+                used = static_cast<size_t>(std::min<uint64_t>(size, remaining_));
+                if (!skip_entry_ && !writer_.write(data, used)) {
+                    return write_error();
+                }
+                remaining_ -= used;
+                if (remaining_ == 0) {
+                    result = end_entry();
+                }
+            } else if (state_ == State::Deflated) {
+                result = inflate_entry(data, size, &used);
+            } else {
+                used = std::min(size, need_ - buffer_.size());
+                buffer_.insert(buffer_.end(), data, data + used);
+                if (buffer_.size() == need_) {
+                    result = parse_buffer();
+                }
+            }
+            if (result != RAC_SUCCESS) {
+                return result;
+            }
+            data += used;
+            size -= used;
+        }
+        return RAC_SUCCESS;
+    }
+
+   private:
+    enum class State { Signature, LocalHeader, NameExtra, Stored, Deflated, Descriptor, End };
+
+    void expect(State state, size_t bytes) {
+        state_ = state;
+        need_ = bytes;
+        buffer_.clear();
+    }
+
+    rac_result_t parse_buffer() {
+        const uint8_t* b = buffer_.data();
+        switch (state_) {
+            case State::Signature: {
+                const uint32_t signature = le32(b);
+                if (signature == kZipLocalHeader) {
+                    expect(State::LocalHeader, 26);
+                } else if (signature == kZipCentralHeader || signature == kZipEndOfCentral) {
+                    state_ = State::End;  // Every entry has been seen
+                } else {
+                    RAC_LOG_ERROR("ArchiveStream", "Unexpected zip record 0x%08x", signature);
+                    return RAC_ERROR_EXTRACTION_FAILED;
+                }
+                return RAC_SUCCESS;
+            }
+            case State::LocalHeader:
+                flags_ = le16(b + 2);
+                method_ = le16(b + 4);
+                compressed_size_ = le32(b + 14);
+                name_length_ = le16(b + 22);
+                expect(State::NameExtra, name_length_ + le16(b + 24));
+                return need_ == 0 ? begin_entry() : RAC_SUCCESS;
+            case State::NameExtra:
+                return begin_entry();
+            case State::Descriptor:
+                // The optional signature is followed by crc and both sizes
+                if (need_ == 4 && le32(b) == kZipDescriptor) {
+                    expect(State::Descriptor, zip64_ ? 20 : 12);
+                } else if (need_ == 4) {
+                    expect(State::Descriptor, zip64_ ? 16 : 8);
+                } else {
+                    expect(State::Signature, 4);
+                }
+                return RAC_SUCCESS;
+            default:
+                return RAC_SUCCESS;
+        }
+    }
+
+    rac_result_t begin_entry() {
+        const std::string name(buffer_.begin(), buffer_.begin() + name_length_);
+        zip64_ = false;
+        for (size_t pos = name_length_; pos + 4 <= buffer_.size();) {
+            const uint16_t id = le16(&buffer_[pos]);
+            const uint16_t length = le16(&buffer_[pos + 2]);
+            // Zip64 sizes replace the 32-bit fields that are 0xFFFFFFFF
+            if (id == 0x0001 && length >= 16 && pos + 4 + length <= buffer_.size()) {
+                zip64_ = true;
+                compressed_size_ = le64(&buffer_[pos + 12]);
+            }
+            pos += 4 + length;
+        }
+
+        const bool descriptor = (flags_ & kZipFlagDescriptor) != 0;
+        const bool is_dir = !name.empty() && name.back() == '/';
+        skip_entry_ = is_dir;
+        if (is_dir) {
+            if (!writer_.make_dir(name)) {
+                return write_error();
+            }
+        } else if (method_ == 0 || method_ == 8) {
+            if (!writer_.open_file(name)) {
+                return write_error();
+            }
+            skip_entry_ = writer_.skipped();
+        }
+
+        if (method_ == 8) {
+#if defined(RAC_HAVE_ZLIB)
+            memset(&inflater_, 0, sizeof(inflater_));
+            if (inflateInit2(&inflater_, -MAX_WBITS) != Z_OK) {
+                return RAC_ERROR_OUT_OF_MEMORY;
+            }
+            inflating_ = true;
+            state_ = State::Deflated;
+            buffer_.clear();
+            return RAC_SUCCESS;
+#else
+            RAC_LOG_ERROR("ArchiveStream", "Deflate entries need zlib");
+            return RAC_ERROR_UNSUPPORTED_ARCHIVE;
+#endif
+        }
+        // With a descriptor the length is only known after the data, so an entry in an
+        // unknown method cannot be skipped. Stored entries are taken at their header size:
+        // writers only stream empty ones that way, and anything else fails on the next
+        // record.
+        if (descriptor && method_ != 0 && !is_dir) {
+            RAC_LOG_ERROR("ArchiveStream", "Cannot stream zip entry %s (method %u)",
+                          name.c_str(), method_);
+            return RAC_ERROR_UNSUPPORTED_ARCHIVE;
+        }
+        if (method_ != 0 && !is_dir) {
+            RAC_LOG_WARNING("ArchiveStream", "Skipping zip entry %s (method %u)", name.c_str(),
+                            method_);
+            skip_entry_ = true;
+        }
+        remaining_ = compressed_size_;
+        state_ = State::Stored;
+        buffer_.clear();
+        return remaining_ == 0 ? end_entry() : RAC_SUCCESS;
+    }
+
+    rac_result_t inflate_entry(const uint8_t* data, size_t size, size_t* used) {
+#if defined(RAC_HAVE_ZLIB)
+        uint8_t out[kOutputChunk];
+        // Never hand zlib more than 4 GB at a time (avail_in is 32-bit)
+        const size_t in_size = std::min<size_t>(size, UINT32_MAX);
+        inflater_.next_in = const_cast<Bytef*>(data);
+        inflater_.avail_in = static_cast<uInt>(in_size);
+        int ret = Z_OK;
+        do {
+            inflater_.next_out = out;
+            inflater_.avail_out = sizeof(out);
+            ret = inflate(&inflater_, Z_NO_FLUSH);
+            if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+                RAC_LOG_ERROR("ArchiveStream", "Corrupt zip entry (zlib %d)", ret);
+                return RAC_ERROR_EXTRACTION_FAILED;
+            }
+            const size_t produced = sizeof(out) - inflater_.avail_out;
+            if (!skip_entry_ && produced > 0 && !writer_.write(out, produced)) {
+                return write_error();
+            }
+        } while (ret != Z_STREAM_END && inflater_.avail_out == 0);
+        *used = in_size - inflater_.avail_in;
+
+        if (ret == Z_STREAM_END) {
+            inflateEnd(&inflater_);
+            inflating_ = false;
+            return end_entry();
+        }
+        return RAC_SUCCESS;
+#else
+        (void)data;
+        (void)size;
+        (void)used;
+        return RAC_ERROR_UNSUPPORTED_ARCHIVE;
+#endif
+    }
+
+    rac_result_t end_entry() {
+        if (!skip_entry_ && !writer_.close_file()) {
+            return write_error();
+        }
+        if (flags_ & kZipFlagDescriptor) {
+            expect(State::Descriptor, 4);
+        } else {
+            expect(State::Signature, 4);
+        }
+        return RAC_SUCCESS;
+    }
+
+    EntryWriter& writer_;
+    State state_ = State::Signature;
+    std::vector<uint8_t> buffer_;
+    size_t need_ = 4;
+    uint16_t flags_ = 0;
+    uint16_t method_ = 0;
+    size_t name_length_ = 0;
+    uint64_t compressed_size_ = 0;
+    uint64_t remaining_ = 0;
+    bool zip64_ = false;
+    bool skip_entry_ = false;
+#if defined(RAC_HAVE_ZLIB)
+    z_stream inflater_;
+    bool inflating_ = false;
+#endif
+};
+
+}  // namespace
+
+// =============================================================================
+// STREAM
+// =============================================================================
+
+struct rac_archive_stream {
+    explicit rac_archive_stream(rac_archive_type_t archive_type, const char* destination)
+        : type(archive_type), writer(destination), tar(writer), zip(writer) {}
+
+    ~rac_archive_stream() {
+#if defined(RAC_HAVE_ZLIB)
+        if (type == RAC_ARCHIVE_TYPE_TAR_GZ) {
+            inflateEnd(&gz);
+        }
+#endif
+#if defined(RAC_HAVE_BZIP2)
+        if (type == RAC_ARCHIVE_TYPE_TAR_BZ2) {
+            BZ2_bzDecompressEnd(&bz);
+        }
+#endif
+#if defined(RAC_HAVE_LZMA)
+        if (type == RAC_ARCHIVE_TYPE_TAR_XZ) {
+            lzma_end(&xz);
+        }
+#endif
+    }
+
+    rac_archive_type_t type;
+    EntryWriter writer;
+    TarParser tar;
+    ZipParser zip;
+    rac_result_t failure = RAC_SUCCESS;
+    bool codec_ended = false;  // The compressed stream reached its end marker
+
+#if defined(RAC_HAVE_ZLIB)
+    z_stream gz = {};
+#endif
+#if defined(RAC_HAVE_BZIP2)
+    bz_stream bz = {};
+#endif
+#if defined(RAC_HAVE_LZMA)
+    lzma_stream xz = LZMA_STREAM_INIT;
+#endif
+};
+
+namespace {
+
+rac_result_t init_codec(rac_archive_stream* s) {
+    switch (s->type) {
+        case RAC_ARCHIVE_TYPE_ZIP:
+            return RAC_SUCCESS;
+#if defined(RAC_HAVE_ZLIB)
+        case RAC_ARCHIVE_TYPE_TAR_GZ:
+            // 32: detect gzip or zlib headers
+            return inflateInit2(&s->gz, MAX_WBITS + 32) == Z_OK ? RAC_SUCCESS
+                                                               : RAC_ERROR_OUT_OF_MEMORY;
+#endif
+#if defined(RAC_HAVE_BZIP2)
+        case RAC_ARCHIVE_TYPE_TAR_BZ2:
+            return BZ2_bzDecompressInit(&s->bz, 0, 0) == BZ_OK ? RAC_SUCCESS
+                                                               : RAC_ERROR_OUT_OF_MEMORY;
+#endif
+#if defined(RAC_HAVE_LZMA)
+        case RAC_ARCHIVE_TYPE_TAR_XZ:
+            return lzma_stream_decoder(&s->xz, UINT64_MAX, LZMA_CONCATENATED) == LZMA_OK
+                       ? RAC_SUCCESS
+                       : RAC_ERROR_OUT_OF_MEMORY;
+#endif
+        default:
+            return RAC_ERROR_UNSUPPORTED_ARCHIVE;
+    }
+}
+
+// Decompresses one chunk into the tar parser. Concatenated members (pigz,
+// pbzip2) restart the decoder; bytes after the tar end marker are ignored.
+rac_result_t decode_chunk(rac_archive_stream* s, const uint8_t* data, size_t size) {
+    uint8_t out[kOutputChunk];
+    switch (s->type) {
+#if defined(RAC_HAVE_ZLIB)
+        case RAC_ARCHIVE_TYPE_TAR_GZ: {
+            z_stream& z = s->gz;
+            z.next_in = const_cast<Bytef*>(data);
+            z.avail_in = static_cast<uInt>(size);
+            while (!s->tar.ended()) {
+                if (s->codec_ended) {
+                    if (z.avail_in == 0) {
+                        break;
+                    }
+                    inflateReset(&z);
+                    s->codec_ended = false;
+                }
+                z.next_out = out;
+                z.avail_out = sizeof(out);
+                const int ret = inflate(&z, Z_NO_FLUSH);
+                if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+                    RAC_LOG_ERROR("ArchiveStream", "Corrupt gzip stream (zlib %d)", ret);
+                    return RAC_ERROR_EXTRACTION_FAILED;
+                }
+                s->codec_ended = ret == Z_STREAM_END;
+                const rac_result_t result = s->tar.consume(out, sizeof(out) - z.avail_out);
+                if (result != RAC_SUCCESS) {
+                    return result;
+                }
+                // Stop once the input is used up and zlib holds no more output
+                if (ret == Z_BUF_ERROR || (z.avail_in == 0 && z.avail_out > 0)) {
+                    break;
+                }
+            }
+            return RAC_SUCCESS;
+        }
+#endif
+#if defined(RAC_HAVE_BZIP2)
+        case RAC_ARCHIVE_TYPE_TAR_BZ2: {
+            bz_stream& bz = s->bz;
+            bz.next_in = reinterpret_cast<char*>(const_cast<uint8_t*>(data));
+            bz.avail_in = static_cast<unsigned int>(size);
+            while (!s->tar.ended()) {
+                if (s->codec_ended) {
+                    if (bz.avail_in == 0) {
+                        break;
+                    }
+                    char* next_in = bz.next_in;
+                    const unsigned int avail_in = bz.avail_in;
+                    BZ2_bzDecompressEnd(&bz);
+                    bz = {};
+                    if (BZ2_bzDecompressInit(&bz, 0, 0) != BZ_OK) {
+                        return RAC_ERROR_OUT_OF_MEMORY;
+                    }
+                    bz.next_in = next_in;
+                    bz.avail_in = avail_in;
+                    s->codec_ended = false;
+                }
+                bz.next_out = reinterpret_cast<char*>(out);
+                bz.avail_out = sizeof(out);
+                const int ret = BZ2_bzDecompress(&bz);
+                if (ret != BZ_OK && ret != BZ_STREAM_END) {
+                    RAC_LOG_ERROR("ArchiveStream", "Corrupt bzip2 stream (%d)", ret);
+                    return RAC_ERROR_EXTRACTION_FAILED;
+                }
+                s->codec_ended = ret == BZ_STREAM_END;
+                const rac_result_t result = s->tar.consume(out, sizeof(out) - bz.avail_out);
+                if (result != RAC_SUCCESS) {
+                    return result;
+                }
+                if (bz.avail_in == 0 && bz.avail_out > 0) {
+                    break;
+                }
+            }
+            return RAC_SUCCESS;
+        }
+#endif
+#if defined(RAC_HAVE_LZMA)
+        case RAC_ARCHIVE_TYPE_TAR_XZ: {
+            lzma_stream& xz = s->xz;
+            xz.next_in = data;
+            xz.avail_in = size;
+            // An empty chunk flushes the decoder at the end of the input
+            const lzma_action action = size == 0 ? LZMA_FINISH : LZMA_RUN;
+            while (!s->tar.ended()) {
+                xz.next_out = out;
+                xz.avail_out = sizeof(out);
+                const lzma_ret ret = lzma_code(&xz, action);
+                if (ret != LZMA_OK && ret != LZMA_STREAM_END) {
+                    RAC_LOG_ERROR("ArchiveStream", "Corrupt xz stream (%d)", ret);
+                    return RAC_ERROR_EXTRACTION_FAILED;
+                }
+                s->codec_ended = ret == LZMA_STREAM_END;
+                const rac_result_t result = s->tar.consume(out, sizeof(out) - xz.avail_out);
+                if (result != RAC_SUCCESS) {
+                    return result;
+                }
+                if (s->codec_ended || (xz.avail_in == 0 && xz.avail_out > 0)) {
+                    break;
+                }
+            }
+            return RAC_SUCCESS;
+        }
+#endif
+        default:
+            (void)out;
+            (void)data;
+            (void)size;
+            return RAC_ERROR_UNSUPPORTED_ARCHIVE;
+    }
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+rac_bool_t rac_archive_stream_supported(rac_archive_type_t type) {
+    switch (type) {
+        case RAC_ARCHIVE_TYPE_ZIP:
+            return RAC_TRUE;  // Deflate entries additionally need zlib
+#if defined(RAC_HAVE_ZLIB)
+        case RAC_ARCHIVE_TYPE_TAR_GZ:
+            return RAC_TRUE;
+#endif
+#if defined(RAC_HAVE_BZIP2)
+        case RAC_ARCHIVE_TYPE_TAR_BZ2:
+            return RAC_TRUE;
+#endif
+#if defined(RAC_HAVE_LZMA)
+        case RAC_ARCHIVE_TYPE_TAR_XZ:
+            return RAC_TRUE;
+#endif
+        default:
+            return RAC_FALSE;
+    }
+}
+
+rac_result_t rac_archive_stream_create(rac_archive_type_t type, const char* destination_dir,
+                                       rac_archive_stream_handle_t* out_handle) {
+    if (!destination_dir || !*destination_dir || !out_handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    if (rac_archive_stream_supported(type) != RAC_TRUE) {
+        return RAC_ERROR_UNSUPPORTED_ARCHIVE;
+    }
+
+    auto* stream = new rac_archive_stream(type, destination_dir);
+    rac_result_t result = init_codec(stream);
+    if (result == RAC_SUCCESS && !stream->writer.init()) {
+        RAC_LOG_ERROR("ArchiveStream", "Cannot create %s: %s", destination_dir, strerror(errno));
+        result = RAC_ERROR_DIRECTORY_CREATION_FAILED;
+    }
+    if (result != RAC_SUCCESS) {
+        delete stream;
+        return result;
+    }
+    *out_handle = stream;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_archive_stream_write(rac_archive_stream_handle_t handle, const void* data,
+                                      size_t size) {
+    if (!handle || (!data && size > 0)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    if (handle->failure != RAC_SUCCESS || size == 0) {
+        return handle->failure;
+    }
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    handle->failure = handle->type == RAC_ARCHIVE_TYPE_ZIP ? handle->zip.consume(bytes, size)
+                                                           : decode_chunk(handle, bytes, size);
+    return handle->failure;
+}
+
+rac_result_t rac_archive_stream_finish(rac_archive_stream_handle_t handle,
+                                       int32_t* out_file_count) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    if (handle->failure != RAC_SUCCESS) {
+        return handle->failure;
+    }
+
+    bool complete = false;
+    if (handle->type == RAC_ARCHIVE_TYPE_ZIP) {
+        complete = handle->zip.complete();
+    } else {
+#if defined(RAC_HAVE_LZMA)
+        if (handle->type == RAC_ARCHIVE_TYPE_TAR_XZ && !handle->codec_ended &&
+            !handle->tar.ended()) {
+            handle->failure = decode_chunk(handle, nullptr, 0);
+            if (handle->failure != RAC_SUCCESS) {
+                return handle->failure;
+            }
+        }
+#endif
+        complete = handle->tar.ended() || (handle->codec_ended && handle->tar.complete());
+    }
+    if (!complete) {
+        RAC_LOG_ERROR("ArchiveStream", "Archive ended early");
+        handle->failure = RAC_ERROR_EXTRACTION_FAILED;
+        return handle->failure;
+    }
+
+    if (out_file_count) {
+        *out_file_count = handle->writer.file_count();
+    }
+    return RAC_SUCCESS;
+}
+
+void rac_archive_stream_destroy(rac_archive_stream_handle_t handle) {
+    delete handle;
+}
+
+rac_result_t rac_archive_extract_file(const char* archive_path, rac_archive_type_t type,
+                                      const char* destination_dir, int32_t* out_file_count) {
+    if (!archive_path) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    RAC_TRACE_SCOPE("Model.extract");
+    rac_archive_stream_handle_t stream = nullptr;
+    rac_result_t result = rac_archive_stream_create(type, destination_dir, &stream);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+
+    const int fd = ::open(archive_path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        rac_archive_stream_destroy(stream);
+        return RAC_ERROR_FILE_NOT_FOUND;
+    }
+    std::vector<uint8_t> buffer(256 * 1024);
+    while (result == RAC_SUCCESS) {
+        const ssize_t n = ::read(fd, buffer.data(), buffer.size());
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            result = RAC_ERROR_FILE_READ_FAILED;
+        } else if (n == 0) {
+            result = rac_archive_stream_finish(stream, out_file_count);
+            break;
+        } else {
+            result = rac_archive_stream_write(stream, buffer.data(), static_cast<size_t>(n));
+        }
+    }
+    ::close(fd);
+    rac_archive_stream_destroy(stream);
+    return result;
+}
+
+}  // extern "C"
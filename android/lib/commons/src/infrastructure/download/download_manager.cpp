@@ -11,18 +11,44 @@
  * This C layer handles orchestration: progress tracking, state management, retry logic.
  */
 
+#include <algorithm>
 #include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_core.h"
 #include "rac/core/rac_logger.h"
+#include "rac/core/rac_metrics.h"
 #include "rac/core/rac_platform_adapter.h"
+#include "rac/core/rac_sha256.h"
 #include "rac/core/rac_structured_error.h"
+#include "rac/core/rac_trace.h"
+#include "rac/infrastructure/download/rac_archive_stream.h"
 #include "rac/infrastructure/download/rac_download.h"
+#include "rac/infrastructure/model_management/rac_model_store.h"
+#include "rac/infrastructure/model_management/rac_model_types.h"
+#include "rac/infrastructure/network/rac_http_client.h"
+
+// Forward declare event helpers from events.cpp
+namespace rac::events {
+void emit_network_connectivity_changed(bool is_online);
+}  // namespace rac::events
 
 // =============================================================================
 // INTERNAL STRUCTURES
@@ -45,6 +71,15 @@ struct download_task_internal {
     std::string downloaded_file_path;
     std::string error_message;
     int64_t start_time_ms;
+    bool trace_open = false;  // "Model.download" span still open
+
+    // Scheduling
+    rac_download_priority_t priority = RAC_DOWNLOAD_PRIORITY_NORMAL;
+    uint64_t sequence = 0;         // Start order, breaks priority ties
+    int64_t expected_bytes = 0;    // From the registry until the transfer learns the size
+    bool admitted = false;         // Holds one of the max_concurrent_downloads slots
+    bool parked = false;           // Its native transfer is waiting for a slot
+    int64_t rate_limit = 0;        // Bytes per second, 0 = unlimited
 };
 
 struct rac_download_manager {
@@ -63,6 +98,11 @@ struct rac_download_manager {
     // Health state
     bool is_healthy;
     bool is_paused;
+
+    // Scheduling: native transfers wait on schedule_cv (with mutex) for a slot
+    rac_download_network_t network = RAC_DOWNLOAD_NETWORK_UNMETERED;
+    std::condition_variable schedule_cv;
+    uint64_t sequence_counter = 0;
 };
 
 // Note: rac_strdup is declared in rac_types.h and implemented in rac_memory.cpp
@@ -110,6 +150,89 @@ static void notify_complete(download_task_internal& task, rac_result_t result,
     }
 }
 
+// Download spans begin and end on whichever threads report them
+static int32_t trace_cookie(const download_task_internal& task) {
+    return static_cast<int32_t>(std::hash<std::string>{}(task.task_id));
+}
+
+static void end_download_trace(download_task_internal& task) {
+    if (task.trace_open) {
+        RAC_TRACE_ASYNC_END("Model.download", trace_cookie(task));
+        task.trace_open = false;
+    }
+}
+
+// =============================================================================
+// SCHEDULING
+// =============================================================================
+
+static bool needs_slot(const download_task_internal& task) {
+    return task.progress.state == RAC_DOWNLOAD_STATE_PENDING ||
+           task.progress.state == RAC_DOWNLOAD_STATE_DOWNLOADING ||
+           task.progress.state == RAC_DOWNLOAD_STATE_RETRYING;
+}
+
+static bool network_allows(const rac_download_manager& mgr, const download_task_internal& task) {
+    const rac_download_config_t& config = mgr.config;
+    switch (mgr.network) {
+        case RAC_DOWNLOAD_NETWORK_OFFLINE:
+            return false;
+        case RAC_DOWNLOAD_NETWORK_UNMETERED:
+            return true;
+        case RAC_DOWNLOAD_NETWORK_CELLULAR:
+            if (config.allow_cellular != RAC_TRUE) {
+                return false;
+            }
+            break;
+        case RAC_DOWNLOAD_NETWORK_CONSTRAINED:
+            if (config.allow_constrained_network != RAC_TRUE) {
+                return false;
+            }
+            break;
+    }
+    // Large prefetches wait for Wi-Fi
+    const int64_t size =
+        task.progress.total_bytes > 0 ? task.progress.total_bytes : task.expected_bytes;
+    return task.priority != RAC_DOWNLOAD_PRIORITY_BACKGROUND ||
+           config.background_unmetered_only_bytes <= 0 ||
+           size <= config.background_unmetered_only_bytes;
+}
+
+// Hands the slots to the highest-priority tasks the network allows (mutex held)
+static void reschedule(rac_download_manager* mgr) {
+    std::vector<download_task_internal*> queue;
+    for (auto& pair : mgr->tasks) {
+        download_task_internal& task = pair.second;
+        if (needs_slot(task)) {
+            queue.push_back(&task);
+        } else {
+            task.admitted = false;
+        }
+    }
+    std::sort(queue.begin(), queue.end(),
+              [](const download_task_internal* a, const download_task_internal* b) {
+                  return a->priority != b->priority ? a->priority > b->priority
+                                                    : a->sequence < b->sequence;
+              });
+
+    const bool metered = mgr->network == RAC_DOWNLOAD_NETWORK_CELLULAR ||
+                         mgr->network == RAC_DOWNLOAD_NETWORK_CONSTRAINED;
+    const int64_t background_cap =
+        metered ? std::max<int64_t>(mgr->config.background_metered_bytes_per_second, 0) : 0;
+    int32_t free_slots = std::max(mgr->config.max_concurrent_downloads, 1);
+    for (download_task_internal* task : queue) {
+        const bool admit = !mgr->is_paused && free_slots > 0 && network_allows(*mgr, *task);
+        if (admit) {
+            --free_slots;
+        } else if (task->admitted) {
+            RAC_LOG_INFO("DownloadManager", "Preempted %s", task->task_id.c_str());
+        }
+        task->admitted = admit;
+        task->rate_limit = task->priority == RAC_DOWNLOAD_PRIORITY_BACKGROUND ? background_cap : 0;
+    }
+    mgr->schedule_cv.notify_all();
+}
+
 // =============================================================================
 // PUBLIC API - LIFECYCLE
 // =============================================================================
@@ -175,6 +298,14 @@ rac_result_t rac_download_manager_start(rac_download_manager_handle_t handle, co
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
+    // The size decides whether a background task may use a metered network
+    int64_t expected_bytes = 0;
+    rac_model_info_t* model = nullptr;
+    if (rac_get_model(model_id, &model) == RAC_SUCCESS) {
+        expected_bytes = model->download_size;
+        rac_model_info_free(model);
+    }
+
     std::lock_guard<std::mutex> lock(handle->mutex);
 
     if (handle->is_paused) {
@@ -197,8 +328,11 @@ rac_result_t rac_download_manager_start(rac_download_manager_handle_t handle, co
     task.complete_callback = complete_callback;
     task.user_data = user_data;
     task.start_time_ms = rac_get_current_time_ms();
+    task.sequence = handle->sequence_counter++;
+    task.expected_bytes = expected_bytes;
 
     handle->tasks[task_id] = std::move(task);
+    reschedule(handle);
 
     *out_task_id = rac_strdup(task_id.c_str());
 
@@ -206,6 +340,12 @@ rac_result_t rac_download_manager_start(rac_download_manager_handle_t handle, co
 
     // Notify initial progress
     download_task_internal& stored_task = handle->tasks[task_id];
+#if RAC_TRACE_ENABLED
+    stored_task.trace_open = rac_trace_is_enabled() == RAC_TRUE;
+    if (stored_task.trace_open) {
+        rac_trace_async_begin("Model.download", trace_cookie(stored_task));
+    }
+#endif
     notify_progress(stored_task);
 
     // Note: Actual HTTP download is triggered by platform adapter
@@ -237,6 +377,8 @@ rac_result_t rac_download_manager_cancel(rac_download_manager_handle_t handle,
     }
 
     task.progress.state = RAC_DOWNLOAD_STATE_CANCELLED;
+    end_download_trace(task);
+    reschedule(handle);
     notify_progress(task);
     notify_complete(task, RAC_ERROR_CANCELLED, nullptr);
 
@@ -252,6 +394,7 @@ rac_result_t rac_download_manager_pause_all(rac_download_manager_handle_t handle
 
     std::lock_guard<std::mutex> lock(handle->mutex);
     handle->is_paused = true;
+    reschedule(handle);
 
     RAC_LOG_INFO("DownloadManager", "Paused all downloads");
 
@@ -265,12 +408,81 @@ rac_result_t rac_download_manager_resume_all(rac_download_manager_handle_t handl
 
     std::lock_guard<std::mutex> lock(handle->mutex);
     handle->is_paused = false;
+    reschedule(handle);
 
     RAC_LOG_INFO("DownloadManager", "Resumed all downloads");
 
     return RAC_SUCCESS;
 }
 
+// =============================================================================
+// PUBLIC API - SCHEDULING
+// =============================================================================
+
+rac_result_t rac_download_manager_set_priority(rac_download_manager_handle_t handle,
+                                               const char* task_id,
+                                               rac_download_priority_t priority) {
+    if (!handle || !task_id) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+
+    auto it = handle->tasks.find(task_id);
+    if (it == handle->tasks.end()) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+
+    it->second.priority = priority;
+    reschedule(handle);
+
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_download_manager_set_network(rac_download_manager_handle_t handle,
+                                              rac_download_network_t network) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    bool online_changed = false;
+    {
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        if (handle->network == network) {
+            return RAC_SUCCESS;
+        }
+        online_changed = (handle->network == RAC_DOWNLOAD_NETWORK_OFFLINE) !=
+                         (network == RAC_DOWNLOAD_NETWORK_OFFLINE);
+        handle->network = network;
+        reschedule(handle);
+    }
+
+    RAC_LOG_INFO("DownloadManager", "Network changed to %d", static_cast<int>(network));
+    if (online_changed) {
+        rac::events::emit_network_connectivity_changed(network != RAC_DOWNLOAD_NETWORK_OFFLINE);
+    }
+
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_download_manager_may_transfer(rac_download_manager_handle_t handle,
+                                               const char* task_id,
+                                               rac_bool_t* out_may_transfer) {
+    if (!handle || !task_id || !out_may_transfer) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+
+    auto it = handle->tasks.find(task_id);
+    if (it == handle->tasks.end()) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+
+    *out_may_transfer = it->second.admitted ? RAC_TRUE : RAC_FALSE;
+    return RAC_SUCCESS;
+}
+
 // =============================================================================
 // PUBLIC API - STATUS
 // =============================================================================
@@ -318,7 +530,8 @@ rac_result_t rac_download_manager_get_active_tasks(rac_download_manager_handle_t
         return RAC_SUCCESS;
     }
 
-    *out_task_ids = static_cast<char**>(malloc(sizeof(char*) * active_ids.size()));
+    *out_task_ids = static_cast<char**>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_MODEL, sizeof(char*) * active_ids.size()));
     for (size_t i = 0; i < active_ids.size(); ++i) {
         (*out_task_ids)[i] = rac_strdup(active_ids[i].c_str());
     }
@@ -357,12 +570,19 @@ rac_result_t rac_download_manager_update_progress(rac_download_manager_handle_t
     }
 
     download_task_internal& task = it->second;
+    if (task.progress.state == RAC_DOWNLOAD_STATE_CANCELLED) {
+        return RAC_SUCCESS;  // Late report from a transfer still winding down
+    }
 
     // Update progress
-    task.progress.state = RAC_DOWNLOAD_STATE_DOWNLOADING;
+    const bool size_changed = task.progress.total_bytes != total_bytes;
+    task.progress.state = task.parked ? RAC_DOWNLOAD_STATE_PENDING : RAC_DOWNLOAD_STATE_DOWNLOADING;
     task.progress.stage = RAC_DOWNLOAD_STAGE_DOWNLOADING;
     task.progress.bytes_downloaded = bytes_downloaded;
     task.progress.total_bytes = total_bytes;
+    if (size_changed) {
+        reschedule(handle);
+    }
 
     if (total_bytes > 0) {
         task.progress.stage_progress =
@@ -408,6 +628,7 @@ rac_result_t rac_download_manager_mark_complete(rac_download_manager_handle_t ha
 
     download_task_internal& task = it->second;
     task.downloaded_file_path = downloaded_path;
+    end_download_trace(task);
 
     if (task.requires_extraction) {
         // Move to extraction stage
@@ -429,6 +650,7 @@ rac_result_t rac_download_manager_mark_complete(rac_download_manager_handle_t ha
         notify_progress(task);
         notify_complete(task, RAC_SUCCESS, downloaded_path);
     }
+    reschedule(handle);
 
     RAC_LOG_INFO("DownloadManager", "Download completed");
 
@@ -468,6 +690,7 @@ rac_result_t rac_download_manager_mark_failed(rac_download_manager_handle_t hand
     } else {
         // Max retries reached, mark as failed
         task.progress.state = RAC_DOWNLOAD_STATE_FAILED;
+        end_download_trace(task);
         task.progress.error_code = error_code;
         if (error_message) {
             task.error_message = error_message;
@@ -478,10 +701,834 @@ rac_result_t rac_download_manager_mark_failed(rac_download_manager_handle_t hand
 
         RAC_LOG_ERROR("DownloadManager", "Download failed after all retries");
     }
+    reschedule(handle);
+
+    return RAC_SUCCESS;
+}
+
+// =============================================================================
+// NATIVE TRANSFER - parallel Range segments over the platform HTTP executor
+// =============================================================================
+
+namespace {
+
+// 32-bit Android has a 32-bit off_t; model files are often larger than 2 GB
+#if defined(__ANDROID__) && !defined(__LP64__)
+ssize_t file_pwrite(int fd, const void* data, size_t size, int64_t offset) {
+    return pwrite64(fd, data, size, offset);
+}
+int file_truncate(int fd, int64_t size) {
+    return ftruncate64(fd, size);
+}
+int file_fallocate(int fd, int64_t size) {
+    return posix_fallocate64(fd, 0, size);
+}
+#else
+ssize_t file_pwrite(int fd, const void* data, size_t size, int64_t offset) {
+    return pwrite(fd, data, size, static_cast<off_t>(offset));
+}
+int file_truncate(int fd, int64_t size) {
+    return ftruncate(fd, static_cast<off_t>(size));
+}
+#if !defined(__APPLE__)
+int file_fallocate(int fd, int64_t size) {
+    return posix_fallocate(fd, 0, static_cast<off_t>(size));
+}
+#endif
+#endif
+
+bool write_fully(int fd, const void* data, size_t size, int64_t offset) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = file_pwrite(fd, bytes, size, offset);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+        offset += written;
+    }
+    return true;
+}
+
+// Reserves the blocks up front so a full disk fails before the download starts
+bool preallocate(int fd, int64_t size) {
+#if defined(__APPLE__)
+    fstore_t store = {F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, static_cast<off_t>(size), 0};
+    if (fcntl(fd, F_PREALLOCATE, &store) == -1) {
+        store.fst_flags = F_ALLOCATEALL;
+        fcntl(fd, F_PREALLOCATE, &store);
+    }
+    return file_truncate(fd, size) == 0;
+#else
+    const int err = file_fallocate(fd, size);
+    if (err == EINVAL || err == EOPNOTSUPP) {
+        return file_truncate(fd, size) == 0;  // Filesystem without fallocate
+    }
+    errno = err;
+    return err == 0;
+#endif
+}
+
+bool sync_file(int fd) {
+#if defined(__APPLE__)
+    return fsync(fd) == 0;
+#else
+    return fdatasync(fd) == 0;
+#endif
+}
+
+uint64_t fnv1a64(const std::string& value) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : value) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+const char* find_header(const rac_http_response_t& response, const char* key) {
+    for (size_t i = 0; i < response.header_count; ++i) {
+        const rac_http_header_t& header = response.headers[i];
+        if (header.key && header.value && strcasecmp(header.key, key) == 0) {
+            return header.value;
+        }
+    }
+    return nullptr;
+}
+
+// Total size from "Content-Range: bytes 0-0/12345"; -1 if absent or "*"
+int64_t content_range_total(const rac_http_response_t& response) {
+    const char* value = find_header(response, "Content-Range");
+    const char* slash = value ? strchr(value, '/') : nullptr;
+    if (!slash || slash[1] < '0' || slash[1] > '9') {
+        return -1;
+    }
+    return strtoll(slash + 1, nullptr, 10);
+}
+
+// Start offset from "Content-Range: bytes 100-199/12345"; -1 if absent
+int64_t content_range_start(const rac_http_response_t& response) {
+    const char* value = find_header(response, "Content-Range");
+    const char* digits = value ? strpbrk(value, "0123456789") : nullptr;
+    return digits ? strtoll(digits, nullptr, 10) : -1;
+}
+
+/**
+ * One request to the platform executor, waited on synchronously. The
+ * response is only valid inside the callback, so on_response consumes it
+ * there (segment bodies are written straight to the file, never copied).
+ */
+struct PendingRequest {
+    std::function<void(const rac_http_response_t&)> on_response;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+};
+
+void on_http_response(const rac_http_response_t* response, void* user_data) {
+    auto* pending = static_cast<PendingRequest*>(user_data);
+    if (response) {
+        pending->on_response(*response);
+    }
+    std::lock_guard<std::mutex> lock(pending->mutex);
+    pending->done = true;
+    pending->cv.notify_one();
+}
+
+bool execute_request(const std::string& url, const char* range, int32_t timeout_ms,
+                     std::function<void(const rac_http_response_t&)> on_response) {
+    rac_http_request_t* request = rac_http_request_create(RAC_HTTP_GET, url.c_str());
+    if (!request) {
+        return false;
+    }
+    if (range) {
+        rac_http_request_add_header(request, "Range", range);
+    }
+    // Byte offsets must refer to the stored file, not a compressed stream
+    rac_http_request_add_header(request, "Accept-Encoding", "identity");
+    rac_http_request_set_timeout(request, timeout_ms);
+
+    PendingRequest pending;
+    pending.on_response = std::move(on_response);
+    const bool started = rac_http_execute_raw(request, on_http_response, &pending);
+    if (started) {
+        std::unique_lock<std::mutex> lock(pending.mutex);
+        pending.cv.wait(lock, [&] { return pending.done; });
+    }
+    rac_http_request_free(request);
+    return started;
+}
+
+constexpr char kStateMagic[8] = {'R', 'A', 'C', 'D', 'L', 'S', 'G', '1'};
+constexpr int64_t kCheckpointIntervalMs = 1000;
+
+struct StateHeader {
+    char magic[8];
+    int64_t total_bytes;
+    int64_t segment_size;
+    uint64_t source_hash;  // URL plus the server's validator (ETag/Last-Modified)
+};
+
+struct Transfer {
+    rac_download_manager* manager = nullptr;
+    std::string task_id;
+    std::string url;
+    int32_t timeout_ms = 0;
+    int32_t max_attempts = 1;
+    int32_t retry_delay_ms = 0;
+
+    int data_fd = -1;
+    int state_fd = -1;
+    int64_t total_bytes = 0;
+    int64_t segment_size = 0;
+    int64_t segment_count = 0;
+
+    std::vector<int64_t> missing;   // Segments still to fetch, in file order
+    std::atomic<size_t> next_missing{0};
+
+    std::mutex state_mutex;         // Guards bitmap, done_bytes, failure, stop
+    std::condition_variable stop_cv;
+    std::vector<uint8_t> bitmap;    // Bit set once a segment is written
+    int64_t done_bytes = 0;
+    bool stop = false;
+    rac_result_t failure = RAC_SUCCESS;
+    std::string failure_message;
+
+    std::mutex checkpoint_mutex;
+    int64_t last_checkpoint_ms = 0;
+    size_t worker_count = 1;
+
+    // Streaming extraction: segments go to the extractor in order instead of a file
+    rac_archive_stream_handle_t archive = nullptr;
+    int64_t window = 0;             // Segments fetched ahead of next_feed
+    int64_t next_feed = 0;          // First segment not yet extracted (state_mutex)
+    std::map<int64_t, std::vector<uint8_t>> fetched;  // Waiting for next_feed (state_mutex)
+    std::mutex feed_mutex;          // One thread feeds the extractor at a time
+
+    // SHA-256 of the file, computed in file order as segments land
+    std::string expected_sha256;    // Empty when the model has no checksum
+    std::mutex hash_mutex;          // Guards sha and hashed_segments
+    rac_sha256_t sha = {};
+    int64_t hashed_segments = 0;
+
+    int64_t segment_offset(int64_t index) const { return index * segment_size; }
+    int64_t segment_length(int64_t index) const {
+        return std::min(segment_size, total_bytes - segment_offset(index));
+    }
+};
+
+bool is_cancelled(Transfer& t) {
+    std::lock_guard<std::mutex> lock(t.manager->mutex);
+    auto it = t.manager->tasks.find(t.task_id);
+    return it == t.manager->tasks.end() ||
+           it->second.progress.state == RAC_DOWNLOAD_STATE_CANCELLED ||
+           it->second.progress.state == RAC_DOWNLOAD_STATE_FAILED;
+}
+
+void fail_transfer(Transfer& t, rac_result_t code, const std::string& message) {
+    {
+        std::lock_guard<std::mutex> lock(t.state_mutex);
+        if (!t.stop) {
+            t.failure = code;
+            t.failure_message = message;
+        }
+        t.stop = true;
+        t.stop_cv.notify_all();
+    }
+    // Wakes workers waiting for a slot; taking the mutex orders this after their check
+    { std::lock_guard<std::mutex> lock(t.manager->mutex); }
+    t.manager->schedule_cv.notify_all();
+}
+
+// Waits while the task has no slot; false once it is cancelled or the transfer stopped
+bool wait_for_turn(Transfer& t, int64_t* out_rate_limit) {
+    std::unique_lock<std::mutex> lock(t.manager->mutex);
+    while (true) {
+        auto it = t.manager->tasks.find(t.task_id);
+        if (it == t.manager->tasks.end() ||
+            it->second.progress.state == RAC_DOWNLOAD_STATE_CANCELLED ||
+            it->second.progress.state == RAC_DOWNLOAD_STATE_FAILED) {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> state_lock(t.state_mutex);
+            if (t.stop) {
+                return false;
+            }
+        }
+        download_task_internal& task = it->second;
+        if (task.admitted) {
+            task.parked = false;
+            *out_rate_limit = task.rate_limit;
+            return true;
+        }
+        if (!task.parked) {
+            task.parked = true;
+            if (task.progress.state == RAC_DOWNLOAD_STATE_DOWNLOADING) {
+                task.progress.state = RAC_DOWNLOAD_STATE_PENDING;
+                notify_progress(task);
+            }
+        }
+        t.manager->schedule_cv.wait(lock);
+    }
+}
+
+// Flushes written segments to disk, then records them; a crash can lose
+// segments but never mark unwritten ones as done
+void checkpoint(Transfer& t, bool force) {
+    std::lock_guard<std::mutex> checkpoint_lock(t.checkpoint_mutex);
+    const int64_t now = rac_get_current_time_ms();
+    if (t.state_fd < 0 || (!force && now - t.last_checkpoint_ms < kCheckpointIntervalMs)) {
+        return;
+    }
+    t.last_checkpoint_ms = now;
+
+    std::vector<uint8_t> bitmap;
+    {
+        std::lock_guard<std::mutex> lock(t.state_mutex);
+        bitmap = t.bitmap;
+    }
+    if (!sync_file(t.data_fd) ||
+        !write_fully(t.state_fd, bitmap.data(), bitmap.size(), sizeof(StateHeader))) {
+        RAC_LOG_WARNING("DownloadManager", "Cannot save download state: %s",
+                        strerror(errno));
+    }
+}
+
+// Hashes a segment straight from the response when it is next in file order;
+// otherwise catch_up_hash reads it back once the segments before it are in
+void hash_in_order(Transfer& t, int64_t index, const void* data, size_t size) {
+    std::lock_guard<std::mutex> lock(t.hash_mutex);
+    if (index == t.hashed_segments) {
+        rac_sha256_update(&t.sha, data, size);
+        t.hashed_segments++;
+    }
+}
+
+rac_result_t catch_up_hash(Transfer& t) {
+    std::lock_guard<std::mutex> hash_lock(t.hash_mutex);
+    std::vector<uint8_t> buffer;
+    while (t.hashed_segments < t.segment_count) {
+        const int64_t index = t.hashed_segments;
+        {
+            std::lock_guard<std::mutex> lock(t.state_mutex);
+            if (!(t.bitmap[index / 8] & (1u << (index % 8)))) {
+                return RAC_SUCCESS;
+            }
+        }
+        // Written moments ago (or resumed), so normally still in the page cache
+        buffer.resize(static_cast<size_t>(t.segment_length(index)));
+        if (pread(t.data_fd, buffer.data(), buffer.size(), t.segment_offset(index)) !=
+            static_cast<ssize_t>(buffer.size())) {
+            return RAC_ERROR_FILE_READ_FAILED;
+        }
+        rac_sha256_update(&t.sha, buffer.data(), buffer.size());
+        t.hashed_segments++;
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t fetch_segment(Transfer& t, int64_t index, std::vector<uint8_t>* body,
+                           std::string* error) {
+    RAC_TRACE_SCOPE("Model.download.segment");
+    const int64_t offset = t.segment_offset(index);
+    const int64_t length = t.segment_length(index);
+    char range[64];
+    snprintf(range, sizeof(range), "bytes=%lld-%lld", static_cast<long long>(offset),
+             static_cast<long long>(offset + length - 1));
+
+    rac_result_t result = RAC_ERROR_DOWNLOAD_FAILED;
+    const bool started =
+        execute_request(t.url, range, t.timeout_ms, [&](const rac_http_response_t& response) {
+            if (response.status_code != 206) {
+                result = response.status_code > 0 ? RAC_ERROR_HTTP_ERROR : RAC_ERROR_NETWORK_ERROR;
+                *error = response.error_message ? response.error_message
+                                                : "HTTP " + std::to_string(response.status_code);
+                return;
+            }
+            const int64_t start = content_range_start(response);
+            if (static_cast<int64_t>(response.body_length) != length ||
+                (start >= 0 && start != offset)) {
+                result = RAC_ERROR_PARTIAL_DOWNLOAD;
+                *error = "Range response does not match the request";
+                return;
+            }
+            if (t.archive) {
+                const auto* bytes = reinterpret_cast<const uint8_t*>(response.body);
+                body->assign(bytes, bytes + response.body_length);
+            } else if (!write_fully(t.data_fd, response.body, response.body_length, offset)) {
+                result = errno == ENOSPC ? RAC_ERROR_STORAGE_FULL : RAC_ERROR_FILE_WRITE_FAILED;
+                *error = strerror(errno);
+                return;
+            } else if (!t.expected_sha256.empty()) {
+                hash_in_order(t, index, response.body, response.body_length);
+            }
+            result = RAC_SUCCESS;
+        });
+    if (!started) {
+        *error = "HTTP executor not registered";
+        return RAC_ERROR_HTTP_NOT_SUPPORTED;
+    }
+    return result;
+}
+
+// Hands fetched segments to the extractor once every earlier segment is in
+rac_result_t feed_segments(Transfer& t, int64_t index, std::vector<uint8_t> body) {
+    {
+        std::lock_guard<std::mutex> lock(t.state_mutex);
+        t.fetched[index] = std::move(body);
+    }
+    std::lock_guard<std::mutex> feed_lock(t.feed_mutex);
+    while (true) {
+        std::vector<uint8_t> next;
+        {
+            std::lock_guard<std::mutex> lock(t.state_mutex);
+            auto it = t.fetched.find(t.next_feed);
+            if (it == t.fetched.end()) {
+                return RAC_SUCCESS;
+            }
+            next = std::move(it->second);
+            t.fetched.erase(it);
+        }
+        if (!t.expected_sha256.empty()) {
+            hash_in_order(t, t.next_feed, next.data(), next.size());
+        }
+        const rac_result_t result = rac_archive_stream_write(t.archive, next.data(), next.size());
+        if (result != RAC_SUCCESS) {
+            return result;
+        }
+        std::lock_guard<std::mutex> lock(t.state_mutex);
+        t.next_feed++;
+        t.stop_cv.notify_all();
+    }
+}
+
+void run_worker(Transfer& t) {
+    static const rac::MetricCounter downloaded_bytes("download.bytes");
+    static const rac::MetricHistogram segment_ms("download.segment_ms");
+
+    while (true) {
+        const size_t slot = t.next_missing.fetch_add(1);
+        if (slot >= t.missing.size()) {
+            return;
+        }
+        // A preempted task stops here, between segments
+        int64_t rate_limit = 0;
+        if (!wait_for_turn(t, &rate_limit)) {
+            fail_transfer(t, RAC_ERROR_CANCELLED, "Cancelled");
+            return;
+        }
+        const int64_t index = t.missing[slot];
+        if (t.archive) {
+            // Bounds the segments held in memory while an earlier one is slow
+            std::unique_lock<std::mutex> lock(t.state_mutex);
+            t.stop_cv.wait(lock, [&] { return t.stop || index < t.next_feed + t.window; });
+        }
+
+        rac_result_t result = RAC_ERROR_DOWNLOAD_FAILED;
+        std::vector<uint8_t> body;
+        std::string error;
+        const int64_t segment_started_ms = rac_get_current_time_ms();
+        for (int32_t attempt = 1; attempt <= t.max_attempts; ++attempt) {
+            {
+                std::lock_guard<std::mutex> lock(t.state_mutex);
+                if (t.stop) {
+                    return;
+                }
+            }
+            const int64_t started_ms = rac_get_current_time_ms();
+            result = fetch_segment(t, index, &body, &error);
+            if (result == RAC_SUCCESS) {
+                segment_ms.record(rac_get_current_time_ms() - started_ms);
+                break;
+            }
+            // Storage errors and a missing executor do not get better with retries
+            if (result == RAC_ERROR_STORAGE_FULL || result == RAC_ERROR_FILE_WRITE_FAILED ||
+                result == RAC_ERROR_HTTP_NOT_SUPPORTED || attempt == t.max_attempts) {
+                break;
+            }
+            RAC_LOG_WARNING("DownloadManager", "Segment %lld failed (%s), retry %d",
+                            static_cast<long long>(index), error.c_str(), attempt);
+            std::unique_lock<std::mutex> lock(t.state_mutex);
+            t.stop_cv.wait_for(lock, std::chrono::milliseconds(t.retry_delay_ms),
+                               [&] { return t.stop; });
+        }
+        if (result != RAC_SUCCESS) {
+            fail_transfer(t, result, error);
+            return;
+        }
+
+        const int64_t length = t.segment_length(index);
+        downloaded_bytes.add(length);
+        if (t.archive) {
+            result = feed_segments(t, index, std::move(body));
+            if (result != RAC_SUCCESS) {
+                fail_transfer(t, result, "Extraction failed");
+                return;
+            }
+        }
+        int64_t done_bytes = 0;
+        {
+            std::lock_guard<std::mutex> lock(t.state_mutex);
+            t.bitmap[index / 8] |= static_cast<uint8_t>(1u << (index % 8));
+            t.done_bytes += length;
+            done_bytes = t.done_bytes;
+        }
+        if (!t.archive && !t.expected_sha256.empty()) {
+            result = catch_up_hash(t);
+            if (result != RAC_SUCCESS) {
+                fail_transfer(t, result, strerror(errno));
+                return;
+            }
+        }
+        checkpoint(t, false);
+        rac_download_manager_update_progress(t.manager, t.task_id.c_str(), done_bytes,
+                                             t.total_bytes);
+
+        if (rate_limit > 0) {
+            // Each worker keeps to its share of the cap
+            const int64_t budget_ms =
+                length * 1000 * static_cast<int64_t>(t.worker_count) / rate_limit;
+            const int64_t elapsed_ms = rac_get_current_time_ms() - segment_started_ms;
+            if (budget_ms > elapsed_ms) {
+                std::unique_lock<std::mutex> lock(t.state_mutex);
+                t.stop_cv.wait_for(lock, std::chrono::milliseconds(budget_ms - elapsed_ms),
+                                   [&] { return t.stop; });
+            }
+        }
+    }
+}
+
+// Loads the segment bitmap when it describes this source; starts over otherwise
+bool load_state(Transfer& t, const StateHeader& expected) {
+    StateHeader stored = {};
+    struct stat st = {};
+    if (pread(t.state_fd, &stored, sizeof(stored), 0) != static_cast<ssize_t>(sizeof(stored)) ||
+        memcmp(stored.magic, kStateMagic, sizeof(kStateMagic)) != 0 ||
+        stored.total_bytes != expected.total_bytes ||
+        stored.source_hash != expected.source_hash || stored.segment_size <= 0 ||
+        fstat(t.data_fd, &st) != 0 || static_cast<int64_t>(st.st_size) != expected.total_bytes) {
+        return false;
+    }
+    t.segment_size = stored.segment_size;
+    t.segment_count = (t.total_bytes + t.segment_size - 1) / t.segment_size;
+    t.bitmap.assign(static_cast<size_t>((t.segment_count + 7) / 8), 0);
+    return pread(t.state_fd, t.bitmap.data(), t.bitmap.size(), sizeof(StateHeader)) ==
+           static_cast<ssize_t>(t.bitmap.size());
+}
+
+rac_result_t prepare_files(Transfer& t, const std::string& part_path,
+                           const std::string& state_path, uint64_t source_hash,
+                           int64_t configured_segment_size, int64_t* out_resumed_bytes) {
+    t.data_fd = ::open(part_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    t.state_fd = ::open(state_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (t.data_fd < 0 || t.state_fd < 0) {
+        RAC_LOG_ERROR("DownloadManager", "Cannot open %s: %s", part_path.c_str(),
+                      strerror(errno));
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+
+    StateHeader header = {};
+    memcpy(header.magic, kStateMagic, sizeof(kStateMagic));
+    header.total_bytes = t.total_bytes;
+    header.source_hash = source_hash;
+
+    if (!load_state(t, header)) {
+        t.segment_size = configured_segment_size;
+        t.segment_count = (t.total_bytes + t.segment_size - 1) / t.segment_size;
+        t.bitmap.assign(static_cast<size_t>((t.segment_count + 7) / 8), 0);
+        header.segment_size = t.segment_size;
+        if (file_truncate(t.data_fd, 0) != 0 || !preallocate(t.data_fd, t.total_bytes)) {
+            const bool full = errno == ENOSPC;
+            RAC_LOG_ERROR("DownloadManager", "Cannot allocate %lld bytes: %s",
+                          static_cast<long long>(t.total_bytes), strerror(errno));
+            return full ? RAC_ERROR_INSUFFICIENT_STORAGE : RAC_ERROR_FILE_WRITE_FAILED;
+        }
+        if (file_truncate(t.state_fd, 0) != 0 ||
+            !write_fully(t.state_fd, &header, sizeof(header), 0) ||
+            !write_fully(t.state_fd, t.bitmap.data(), t.bitmap.size(), sizeof(header))) {
+            return RAC_ERROR_FILE_WRITE_FAILED;
+        }
+    }
+
+    int64_t resumed = 0;
+    for (int64_t i = 0; i < t.segment_count; ++i) {
+        if (t.bitmap[i / 8] & (1u << (i % 8))) {
+            resumed += t.segment_length(i);
+        } else {
+            t.missing.push_back(i);
+        }
+    }
+    t.done_bytes = resumed;
+    *out_resumed_bytes = resumed;
+    return RAC_SUCCESS;
+}
 
+rac_result_t verify_sha256(Transfer& t, std::string* error) {
+    if (!t.archive && t.segment_count > 0 && catch_up_hash(t) != RAC_SUCCESS) {
+        *error = strerror(errno);
+        return RAC_ERROR_FILE_READ_FAILED;
+    }
+    uint8_t digest[RAC_SHA256_DIGEST_SIZE];
+    char hex[RAC_SHA256_HEX_LENGTH + 1];
+    rac_sha256_final(&t.sha, digest);
+    rac_sha256_to_hex(digest, hex);
+    if (t.hashed_segments != t.segment_count || strcasecmp(hex, t.expected_sha256.c_str()) != 0) {
+        *error = std::string("SHA-256 mismatch: got ") + hex;
+        return RAC_ERROR_CHECKSUM_MISMATCH;
+    }
+    RAC_LOG_DEBUG("DownloadManager", "SHA-256 verified (%s)", rac_sha256_isa());
     return RAC_SUCCESS;
 }
 
+// Streaming mode keeps only the extracted files on disk, so it always starts over
+void prepare_stream(Transfer& t, int64_t segment_size, int32_t connections) {
+    t.segment_size = segment_size;
+    t.segment_count = (t.total_bytes + t.segment_size - 1) / t.segment_size;
+    t.bitmap.assign(static_cast<size_t>((t.segment_count + 7) / 8), 0);
+    t.window = 2 * static_cast<int64_t>(connections);
+    for (int64_t i = 0; i < t.segment_count; ++i) {
+        t.missing.push_back(i);
+    }
+}
+
+void close_files(Transfer& t) {
+    if (t.data_fd >= 0) {
+        ::close(t.data_fd);
+        t.data_fd = -1;
+    }
+    if (t.state_fd >= 0) {
+        ::close(t.state_fd);
+        t.state_fd = -1;
+    }
+}
+
+// Whole-file fallback for servers that answer the probe without Range support
+rac_result_t write_whole_body(const rac_http_response_t& response, const std::string& part_path,
+                              std::string* error) {
+    int fd = ::open(part_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        *error = strerror(errno);
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+    rac_result_t result = RAC_SUCCESS;
+    if (!write_fully(fd, response.body, response.body_length, 0) || !sync_file(fd)) {
+        result = errno == ENOSPC ? RAC_ERROR_STORAGE_FULL : RAC_ERROR_FILE_WRITE_FAILED;
+        *error = strerror(errno);
+    }
+    ::close(fd);
+    return result;
+}
+
+}  // namespace
+
+rac_result_t rac_download_manager_transfer(rac_download_manager_handle_t handle,
+                                           const char* task_id) {
+    if (!handle || !task_id) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    Transfer t;
+    t.manager = handle;
+    t.task_id = task_id;
+    std::string destination;
+    std::string model_id;
+    rac_archive_type_t archive_type = RAC_ARCHIVE_TYPE_NONE;
+    int32_t connections = 1;
+    int64_t segment_size = 0;
+    {
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        auto it = handle->tasks.find(task_id);
+        if (it == handle->tasks.end()) {
+            return RAC_ERROR_NOT_FOUND;
+        }
+        t.url = it->second.url;
+        destination = it->second.destination_path;
+        model_id = it->second.model_id;
+        if (!it->second.requires_extraction ||
+            rac_archive_type_from_path(t.url.c_str(), &archive_type) != RAC_TRUE ||
+            rac_archive_stream_supported(archive_type) != RAC_TRUE) {
+            archive_type = RAC_ARCHIVE_TYPE_NONE;
+        }
+        const rac_download_config_t& config = handle->config;
+        t.timeout_ms = std::max(config.request_timeout_seconds, 1) * 1000;
+        t.max_attempts = std::max(config.max_retry_attempts, 0) + 1;
+        t.retry_delay_ms = std::max(config.retry_delay_seconds, 0) * 1000;
+        connections = std::max(config.connections_per_download, 1);
+        segment_size = config.segment_size_bytes > 0
+                           ? config.segment_size_bytes
+                           : RAC_DOWNLOAD_CONFIG_DEFAULT.segment_size_bytes;
+    }
+    const std::string part_path = destination + ".part";
+    const std::string state_path = part_path + ".state";
+
+    // Nothing is requested before the task gets a slot
+    int64_t rate_limit = 0;
+    if (!wait_for_turn(t, &rate_limit)) {
+        return RAC_ERROR_CANCELLED;
+    }
+
+    // The hash is checked as the file is written, so completion needs no read-back
+    rac_model_info_t* model = nullptr;
+    if (rac_get_model(model_id.c_str(), &model) == RAC_SUCCESS) {
+        if (model->sha256 && model->sha256[0] != '\0') {
+            t.expected_sha256 = model->sha256;
+            rac_sha256_init(&t.sha);
+        }
+        rac_model_info_free(model);
+    }
+
+    // Archives are unpacked as they arrive, into the directory they were to be stored in
+    const size_t slash = destination.find_last_of('/');
+    const std::string extract_dir = slash == std::string::npos ? "." : destination.substr(0, slash);
+    if (archive_type != RAC_ARCHIVE_TYPE_NONE) {
+        const rac_result_t created =
+            rac_archive_stream_create(archive_type, extract_dir.c_str(), &t.archive);
+        if (created != RAC_SUCCESS) {
+            rac_download_manager_mark_failed(handle, task_id, created, "Cannot start extraction");
+            return created;
+        }
+    }
+
+    // Probe with a one-byte range: gives the size and whether ranges work
+    int32_t probe_status = 0;
+    std::string error;
+    std::string validator;
+    rac_result_t whole_result = RAC_ERROR_DOWNLOAD_FAILED;
+    const bool started = execute_request(
+        t.url, "bytes=0-0", t.timeout_ms, [&](const rac_http_response_t& response) {
+            probe_status = response.status_code;
+            if (response.status_code == 206) {
+                t.total_bytes = content_range_total(response);
+                const char* etag = find_header(response, "ETag");
+                const char* modified = find_header(response, "Last-Modified");
+                validator = etag ? etag : (modified ? modified : "");
+            } else if (response.status_code == 200) {
+                whole_result =
+                    t.archive
+                        ? rac_archive_stream_write(t.archive, response.body, response.body_length)
+                        : write_whole_body(response, part_path, &error);
+                if (!t.expected_sha256.empty()) {
+                    rac_sha256_update(&t.sha, response.body, response.body_length);
+                }
+            } else {
+                error = response.error_message ? response.error_message
+                                               : "HTTP " + std::to_string(response.status_code);
+            }
+        });
+
+    rac_result_t result = RAC_SUCCESS;
+    if (!started) {
+        result = RAC_ERROR_HTTP_NOT_SUPPORTED;
+        error = "HTTP executor not registered";
+    } else if (probe_status == 200) {
+        result = whole_result;
+        if (result == RAC_SUCCESS && !t.expected_sha256.empty()) {
+            result = verify_sha256(t, &error);
+        }
+    } else if (probe_status != 206) {
+        result = probe_status > 0 ? RAC_ERROR_HTTP_ERROR : RAC_ERROR_NETWORK_ERROR;
+    } else if (t.total_bytes <= 0) {
+        result = RAC_ERROR_DOWNLOAD_FAILED;
+        error = "Server did not report the file size";
+    } else {
+        int64_t resumed_bytes = 0;
+        if (t.archive) {
+            prepare_stream(t, segment_size, connections);
+        } else {
+            result = prepare_files(t, part_path, state_path, fnv1a64(t.url + '\n' + validator),
+                                   segment_size, &resumed_bytes);
+        }
+        if (result == RAC_SUCCESS) {
+            RAC_LOG_INFO("DownloadManager",
+                         "Transferring %lld bytes in %zu segments over %d connections "
+                         "(%lld bytes resumed)",
+                         static_cast<long long>(t.total_bytes), t.missing.size(), connections,
+                         static_cast<long long>(resumed_bytes));
+            rac_download_manager_update_progress(handle, task_id, resumed_bytes, t.total_bytes);
+
+            // The calling thread is one of the workers
+            t.worker_count = std::max<size_t>(std::min<size_t>(connections, t.missing.size()), 1);
+            std::vector<std::thread> workers;
+            for (size_t i = 1; i < t.worker_count; ++i) {
+                workers.emplace_back([&t] { run_worker(t); });
+            }
+            run_worker(t);
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+
+            checkpoint(t, true);
+            result = t.failure;
+            error = t.failure_message;
+            if (result == RAC_SUCCESS && (t.done_bytes != t.total_bytes || is_cancelled(t))) {
+                result = RAC_ERROR_CANCELLED;
+            }
+            if (result == RAC_SUCCESS && !t.archive && !sync_file(t.data_fd)) {
+                result = RAC_ERROR_FILE_WRITE_FAILED;
+                error = strerror(errno);
+            }
+            if (result == RAC_SUCCESS && !t.expected_sha256.empty()) {
+                result = verify_sha256(t, &error);
+            }
+        }
+        close_files(t);
+    }
+
+    if (t.archive) {
+        int32_t file_count = 0;
+        if (result == RAC_SUCCESS) {
+            result = rac_archive_stream_finish(t.archive, &file_count);
+            error = result == RAC_SUCCESS ? "" : "Archive is incomplete";
+        }
+        rac_archive_stream_destroy(t.archive);
+        t.archive = nullptr;
+        if (result == RAC_SUCCESS) {
+            RAC_LOG_INFO("DownloadManager", "Extracted %d files while downloading", file_count);
+            rac_model_store_add_folder(extract_dir.c_str(), nullptr);
+            {
+                std::lock_guard<std::mutex> lock(handle->mutex);
+                auto it = handle->tasks.find(task_id);
+                if (it != handle->tasks.end()) {
+                    it->second.requires_extraction = false;
+                }
+            }
+            return rac_download_manager_mark_complete(handle, task_id, extract_dir.c_str());
+        }
+    } else if (result == RAC_SUCCESS) {
+        if (rename(part_path.c_str(), destination.c_str()) != 0) {
+            result = RAC_ERROR_FILE_WRITE_FAILED;
+            error = strerror(errno);
+        } else {
+            unlink(state_path.c_str());
+            // Already verified, so sharing a copy another model has costs no read
+            if (!t.expected_sha256.empty()) {
+                rac_model_store_add_file(destination.c_str(), t.expected_sha256.c_str(), nullptr);
+            }
+            return rac_download_manager_mark_complete(handle, task_id, destination.c_str());
+        }
+    }
+    if (result == RAC_ERROR_CHECKSUM_MISMATCH) {
+        // Corrupt data must not be resumed from
+        unlink(part_path.c_str());
+        unlink(state_path.c_str());
+    }
+    if (result == RAC_ERROR_CANCELLED) {
+        RAC_LOG_INFO("DownloadManager", archive_type != RAC_ARCHIVE_TYPE_NONE
+                                            ? "Transfer stopped"
+                                            : "Transfer stopped; finished segments are kept");
+        return result;
+    }
+
+    RAC_LOG_ERROR("DownloadManager", "Transfer failed: %s", error.c_str());
+    rac_download_manager_mark_failed(handle, task_id, result,
+                                     error.empty() ? nullptr : error.c_str());
+    return result;
+}
+
 // =============================================================================
 // PUBLIC API - STAGE INFO
 // =============================================================================
@@ -541,19 +1588,19 @@ void rac_download_task_free(rac_download_task_t* task) {
     }
 
     if (task->task_id) {
-        free(task->task_id);
+        rac_free(task->task_id);
         task->task_id = nullptr;
     }
     if (task->model_id) {
-        free(task->model_id);
+        rac_free(task->model_id);
         task->model_id = nullptr;
     }
     if (task->url) {
-        free(task->url);
+        rac_free(task->url);
         task->url = nullptr;
     }
     if (task->destination_path) {
-        free(task->destination_path);
+        rac_free(task->destination_path);
         task->destination_path = nullptr;
     }
 }
@@ -565,8 +1612,8 @@ void rac_download_task_ids_free(char** task_ids, size_t count) {
 
     for (size_t i = 0; i < count; ++i) {
         if (task_ids[i]) {
-            free(task_ids[i]);
+            rac_free(task_ids[i]);
         }
     }
-    free(task_ids);
+    rac_free(task_ids);
 }
@@ -4,15 +4,28 @@
  *
  * C++ port of Swift's EventPublisher.swift
  * Provides category-based event subscription matching Swift's pattern.
+ *
+ * Publishers push a copy of the event onto an intrusive MPSC queue (one
+ * atomic exchange, no lock) and wake the dispatcher thread only when it is
+ * asleep. The dispatcher drains the queue in batches and delivers each batch
+ * to an immutable snapshot of the subscriber list; subscribe and unsubscribe
+ * replace the snapshot (copy-on-write), so dispatch never takes their lock.
+ * The batch size is the backlog the backpressure policies act on.
+ * Events of a category nobody subscribed to are dropped at publish after one
+ * load of the subscribed-category mask.
  */
 
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <string>
-#include <unordered_map>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include "rac/core/rac_error.h"
@@ -26,23 +39,134 @@
 
 namespace {
 
+// Events queued beyond this are rejected (dispatcher stuck in a subscriber)
+constexpr size_t kMaxQueuedEvents = 8192;
+
+// Upper bound on a dispatcher sleep, in case a wakeup is ever missed
+constexpr auto kDispatcherIdleWait = std::chrono::milliseconds(100);
+
 struct Subscription {
     uint64_t id;
+    rac_event_category_t category;
     rac_event_callback_fn callback;
     void* user_data;
+    rac_event_subscription_options_t options;
+
+    // Cleared by unsubscribe; checked by the dispatcher before each delivery
+    std::atomic<bool> active{true};
+    std::atomic<int> in_callback{0};
 };
 
-std::mutex g_event_mutex;
-std::atomic<uint64_t> g_next_subscription_id{1};
+using SubscriptionList = std::vector<std::shared_ptr<Subscription>>;
+
+// A published event with its strings owned
+struct QueuedEvent {
+    std::atomic<QueuedEvent*> next{nullptr};
+    rac_event_t event = {};
+    std::string id;
+    std::string type;
+    std::string session_id;
+    std::string properties_json;
+
+    void assign(const rac_event_t& source) {
+        event = source;
+        auto own = [](const char* text, std::string* storage) -> const char* {
+            if (text == nullptr) {
+                return nullptr;
+            }
+            storage->assign(text);
+            return storage->c_str();
+        };
+        event.id = own(source.id, &id);
+        event.type = own(source.type, &type);
+        event.session_id = own(source.session_id, &session_id);
+        event.properties_json = own(source.properties_json, &properties_json);
+    }
+};
+
+/**
+ * Vyukov intrusive multi-producer single-consumer queue. push is wait-free;
+ * pop (dispatcher only) returns nullptr while a producer is between its two
+ * stores, which the pending counter tells apart from an empty queue.
+ */
+class EventQueue {
+   public:
+    EventQueue() : head_(&stub_), tail_(&stub_) {}
+
+    void push(QueuedEvent* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        QueuedEvent* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    QueuedEvent* pop() {
+        QueuedEvent* tail = tail_;
+        QueuedEvent* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            tail_ = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail_ = next;
+            return tail;
+        }
+        if (tail != head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        push(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail_ = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+   private:
+    std::atomic<QueuedEvent*> head_;
+    QueuedEvent* tail_;
+    QueuedEvent stub_;
+};
+
+struct EventBus {
+    EventQueue queue;
+    std::atomic<size_t> pending{0};
+    std::atomic<uint64_t> published{0};
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<bool> overflowing{false};
+
+    // Dispatcher sleep/wake; publishers touch the mutex only to wake it
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    std::atomic<bool> sleeping{false};
+
+    // rac_event_flush waiters
+    std::mutex flush_mutex;
+    std::condition_variable flush_cv;
+    std::atomic<int> flush_waiters{0};
+
+    std::once_flag started;
+
+    // Snapshot read by the dispatcher with std::atomic_load
+    std::shared_ptr<const SubscriptionList> subscriptions = std::make_shared<SubscriptionList>();
+    // Bit per category with at least one subscriber, read without the lock
+    std::atomic<uint32_t> category_mask{0};
+    std::mutex subscribe_mutex;  // serializes writers of the snapshot
+};
 
-// Subscriptions per category
-std::unordered_map<rac_event_category_t, std::vector<Subscription>> g_subscriptions;
+// Never destroyed: the detached dispatcher may run until process exit
+EventBus& bus() {
+    static EventBus* instance = new EventBus();
+    return *instance;
+}
 
-// All-events subscriptions
-std::vector<Subscription> g_all_subscriptions;
+thread_local bool t_is_dispatcher = false;
 
-// Sentinel category for "all events"
-const rac_event_category_t CATEGORY_ALL_SENTINEL = static_cast<rac_event_category_t>(-1);
+std::atomic<uint64_t> g_next_subscription_id{1};
 
 uint64_t current_time_ms() {
     using namespace std::chrono;
@@ -60,47 +184,177 @@ std::string generate_event_id() {
     return buffer;
 }
 
-}  // namespace
+bool matches(const Subscription& sub, const rac_event_t& event) {
+    return sub.options.all_categories == RAC_TRUE || sub.category == event.category;
+}
 
-// =============================================================================
-// EVENT SUBSCRIPTION API
-// =============================================================================
+void deliver(Subscription& sub, const rac_event_t& event) {
+    sub.in_callback.store(1);
+    if (sub.active.load()) {
+        sub.callback(&event, sub.user_data);
+    }
+    sub.in_callback.store(0);
+}
 
-extern "C" {
+// Marks events that a later event of the same category and type replaces
+void mark_superseded(const std::vector<QueuedEvent*>& batch, std::vector<bool>* superseded) {
+    superseded->assign(batch.size(), false);
+    std::unordered_set<std::string> seen;
+    for (size_t i = batch.size(); i-- > 0;) {
+        const rac_event_t& event = batch[i]->event;
+        std::string key = std::to_string(static_cast<int>(event.category)) + ':' +
+                          (event.type ? event.type : "");
+        (*superseded)[i] = !seen.insert(std::move(key)).second;
+    }
+}
 
-uint64_t rac_event_subscribe(rac_event_category_t category, rac_event_callback_fn callback,
-                             void* user_data) {
-    if (callback == nullptr) {
-        return 0;
+void dispatch_batch(const std::vector<QueuedEvent*>& batch, const SubscriptionList& subs,
+                    std::vector<bool>* superseded) {
+    bool superseded_ready = false;
+    for (const auto& sub : subs) {
+        const rac_event_subscription_options_t& options = sub->options;
+        size_t backlog = 0;
+        if (options.backpressure != RAC_EVENT_BACKPRESSURE_NONE) {
+            for (const QueuedEvent* node : batch) {
+                backlog += matches(*sub, node->event) ? 1 : 0;
+            }
+        }
+        const bool backlogged = backlog > options.max_pending;
+        const bool coalesce =
+            backlogged && options.backpressure == RAC_EVENT_BACKPRESSURE_COALESCE;
+        if (coalesce && !superseded_ready) {
+            mark_superseded(batch, superseded);
+            superseded_ready = true;
+        }
+        // DROP skips the oldest matching events and keeps the newest max_pending
+        size_t to_drop = backlogged && options.backpressure == RAC_EVENT_BACKPRESSURE_DROP
+                             ? backlog - options.max_pending
+                             : 0;
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const rac_event_t& event = batch[i]->event;
+            if (!matches(*sub, event)) {
+                continue;
+            }
+            if (to_drop > 0) {
+                to_drop--;
+                continue;
+            }
+            if (coalesce && (*superseded)[i]) {
+                continue;
+            }
+            deliver(*sub, event);
+        }
     }
+}
 
-    std::lock_guard<std::mutex> lock(g_event_mutex);
+void dispatcher_loop() {
+    EventBus& b = bus();
+    t_is_dispatcher = true;
+    std::vector<QueuedEvent*> batch;
+    std::vector<bool> superseded;
 
-    Subscription sub;
-    sub.id = g_next_subscription_id.fetch_add(1);
-    sub.callback = callback;
-    sub.user_data = user_data;
+    for (;;) {
+        batch.clear();
+        while (QueuedEvent* node = b.queue.pop()) {
+            batch.push_back(node);
+        }
+
+        if (batch.empty()) {
+            if (b.pending.load() > 0) {
+                // A producer is between its two stores
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(b.wake_mutex);
+            b.sleeping.store(true);
+            if (b.pending.load() == 0) {
+                b.wake_cv.wait_for(lock, kDispatcherIdleWait, [&b] { return !b.sleeping.load(); });
+            }
+            b.sleeping.store(false);
+            continue;
+        }
 
-    g_subscriptions[category].push_back(sub);
+        std::shared_ptr<const SubscriptionList> subs = std::atomic_load(&b.subscriptions);
+        dispatch_batch(batch, *subs, &superseded);
 
-    return sub.id;
+        for (QueuedEvent* node : batch) {
+            delete node;
+        }
+        b.pending.fetch_sub(batch.size());
+        b.delivered.fetch_add(batch.size());
+        if (b.flush_waiters.load() > 0) {
+            std::lock_guard<std::mutex> lock(b.flush_mutex);
+            b.flush_cv.notify_all();
+        }
+    }
 }
 
-uint64_t rac_event_subscribe_all(rac_event_callback_fn callback, void* user_data) {
+void start_dispatcher() {
+    EventBus& b = bus();
+    std::call_once(b.started, [] { std::thread(dispatcher_loop).detach(); });
+}
+
+uint32_t category_bit(rac_event_category_t category) {
+    return static_cast<uint32_t>(category) < 32 ? uint32_t{1} << category : 0;
+}
+
+// Caller holds b.subscribe_mutex
+void publish_subscriptions_locked(EventBus& b, SubscriptionList list) {
+    uint32_t mask = 0;
+    for (const auto& sub : list) {
+        mask |= sub->options.all_categories ? ~uint32_t{0} : category_bit(sub->category);
+    }
+    std::atomic_store(&b.subscriptions,
+                      std::shared_ptr<const SubscriptionList>(
+                          std::make_shared<SubscriptionList>(std::move(list))));
+    b.category_mask.store(mask);
+}
+
+}  // namespace
+
+// =============================================================================
+// EVENT SUBSCRIPTION API
+// =============================================================================
+
+extern "C" {
+
+uint64_t rac_event_subscribe_with_options(rac_event_category_t category,
+                                          rac_event_callback_fn callback, void* user_data,
+                                          const rac_event_subscription_options_t* options) {
     if (callback == nullptr) {
         return 0;
     }
 
-    std::lock_guard<std::mutex> lock(g_event_mutex);
+    auto sub = std::make_shared<Subscription>();
+    sub->id = g_next_subscription_id.fetch_add(1);
+    sub->category = category;
+    sub->callback = callback;
+    sub->user_data = user_data;
+    sub->options = options ? *options : RAC_EVENT_SUBSCRIPTION_OPTIONS_DEFAULT;
+
+    EventBus& b = bus();
+    {
+        std::lock_guard<std::mutex> lock(b.subscribe_mutex);
+        SubscriptionList list = *std::atomic_load(&b.subscriptions);
+        list.push_back(sub);
+        publish_subscriptions_locked(b, std::move(list));
+    }
+    start_dispatcher();
 
-    Subscription sub;
-    sub.id = g_next_subscription_id.fetch_add(1);
-    sub.callback = callback;
-    sub.user_data = user_data;
+    return sub->id;
+}
 
-    g_all_subscriptions.push_back(sub);
+uint64_t rac_event_subscribe(rac_event_category_t category, rac_event_callback_fn callback,
+                             void* user_data) {
+    return rac_event_subscribe_with_options(category, callback, user_data, nullptr);
+}
 
-    return sub.id;
+uint64_t rac_event_subscribe_all(rac_event_callback_fn callback, void* user_data) {
+    rac_event_subscription_options_t options = RAC_EVENT_SUBSCRIPTION_OPTIONS_DEFAULT;
+    options.all_categories = RAC_TRUE;
+    return rac_event_subscribe_with_options(RAC_EVENT_CATEGORY_SDK, callback, user_data,
+                                            &options);
 }
 
 void rac_event_unsubscribe(uint64_t subscription_id) {
@@ -108,29 +362,28 @@ void rac_event_unsubscribe(uint64_t subscription_id) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(g_event_mutex);
-
-    auto remove_from = [subscription_id](std::vector<Subscription>& subs) {
-        auto it =
-            std::remove_if(subs.begin(), subs.end(), [subscription_id](const Subscription& s) {
-                return s.id == subscription_id;
-            });
-        if (it != subs.end()) {
-            subs.erase(it, subs.end());
-            return true;
+    EventBus& b = bus();
+    std::shared_ptr<Subscription> removed;
+    {
+        std::lock_guard<std::mutex> lock(b.subscribe_mutex);
+        SubscriptionList list = *std::atomic_load(&b.subscriptions);
+        auto it = std::find_if(list.begin(), list.end(),
+                               [subscription_id](const std::shared_ptr<Subscription>& s) {
+                                   return s->id == subscription_id;
+                               });
+        if (it == list.end()) {
+            return;
         }
-        return false;
-    };
-
-    // Check all-events subscriptions
-    if (remove_from(g_all_subscriptions)) {
-        return;
+        removed = *it;
+        list.erase(it);
+        publish_subscriptions_locked(b, std::move(list));
     }
 
-    // Check category-specific subscriptions
-    for (auto& pair : g_subscriptions) {
-        if (remove_from(pair.second)) {
-            return;
+    // The dispatcher may still hold the old snapshot; stop it calling back
+    removed->active.store(false);
+    if (!t_is_dispatcher) {
+        while (removed->in_callback.load() != 0) {
+            std::this_thread::yield();
         }
     }
 }
@@ -140,35 +393,84 @@ rac_result_t rac_event_publish(const rac_event_t* event) {
         return RAC_ERROR_NULL_POINTER;
     }
 
-    // Create a copy with timestamp if not set
-    rac_event_t event_copy = *event;
-    if (event_copy.timestamp_ms == 0) {
-        event_copy.timestamp_ms = static_cast<int64_t>(current_time_ms());
+    if (!rac_event_has_subscribers(event->category)) {
+        return RAC_SUCCESS;
     }
 
-    std::lock_guard<std::mutex> lock(g_event_mutex);
+    EventBus& b = bus();
 
-    // Notify category-specific subscribers
-    auto it = g_subscriptions.find(event_copy.category);
-    if (it != g_subscriptions.end()) {
-        for (const auto& sub : it->second) {
-            sub.callback(&event_copy, sub.user_data);
+    // Counted before the push so the dispatcher never subtracts an event it
+    // has already popped from a count that does not include it yet
+    if (b.pending.fetch_add(1) >= kMaxQueuedEvents) {
+        b.pending.fetch_sub(1);
+        if (!b.overflowing.exchange(true)) {
+            RAC_LOG_WARNING("EventPublisher", "Event queue full, dropping events");
         }
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    if (b.overflowing.load(std::memory_order_relaxed)) {
+        b.overflowing.store(false, std::memory_order_relaxed);
+    }
+
+    auto* node = new (std::nothrow) QueuedEvent();
+    if (node == nullptr) {
+        b.pending.fetch_sub(1);
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    node->assign(*event);
+    if (node->event.timestamp_ms == 0) {
+        node->event.timestamp_ms = static_cast<int64_t>(current_time_ms());
     }
 
-    // Notify all-events subscribers
-    for (const auto& sub : g_all_subscriptions) {
-        sub.callback(&event_copy, sub.user_data);
+    b.published.fetch_add(1);
+    b.queue.push(node);
+
+    if (b.sleeping.load() && b.sleeping.exchange(false)) {
+        std::lock_guard<std::mutex> lock(b.wake_mutex);
+        b.wake_cv.notify_one();
     }
 
     return RAC_SUCCESS;
 }
 
+rac_result_t rac_event_flush(int32_t timeout_ms) {
+    if (t_is_dispatcher) {
+        return RAC_ERROR_INVALID_STATE;
+    }
+
+    EventBus& b = bus();
+    const uint64_t target = b.published.load();
+    auto flushed = [&b, target] { return b.delivered.load() >= target; };
+    if (flushed()) {
+        return RAC_SUCCESS;
+    }
+
+    b.flush_waiters.fetch_add(1);
+    std::unique_lock<std::mutex> lock(b.flush_mutex);
+    bool done = true;
+    if (timeout_ms < 0) {
+        b.flush_cv.wait(lock, flushed);
+    } else {
+        done = b.flush_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), flushed);
+    }
+    lock.unlock();
+    b.flush_waiters.fetch_sub(1);
+    return done ? RAC_SUCCESS : RAC_ERROR_TIMEOUT;
+}
+
+rac_bool_t rac_event_has_subscribers(rac_event_category_t category) {
+    uint32_t mask = bus().category_mask.load(std::memory_order_relaxed);
+    return (mask & category_bit(category)) != 0 ? RAC_TRUE : RAC_FALSE;
+}
+
 rac_result_t rac_event_track(const char* type, rac_event_category_t category,
                              rac_event_destination_t destination, const char* properties_json) {
     if (type == nullptr) {
         return RAC_ERROR_NULL_POINTER;
     }
+    if (!rac_event_has_subscribers(category)) {
+        return RAC_SUCCESS;
+    }
 
     // Generate event ID
     static thread_local std::string s_event_id;
@@ -222,9 +524,9 @@ const char* rac_event_category_name(rac_event_category_t category) {
 namespace rac_internal {
 
 void reset_event_publisher() {
-    std::lock_guard<std::mutex> lock(g_event_mutex);
-    g_subscriptions.clear();
-    g_all_subscriptions.clear();
+    EventBus& b = bus();
+    std::lock_guard<std::mutex> lock(b.subscribe_mutex);
+    publish_subscriptions_locked(b, SubscriptionList());
     g_next_subscription_id.store(1);
 }
 
@@ -0,0 +1,125 @@
+/**
+ * @file gguf_metadata.cpp
+ * @brief GGUF Model Metadata Implementation
+ */
+
+#include "rac/infrastructure/model_management/rac_gguf_metadata.h"
+
+#include <string>
+
+#include <sys/stat.h>
+
+#include "rac/core/rac_logger.h"
+
+#include "gguf_reader.h"
+
+namespace {
+
+const char* LOG_CAT = "GGUFMetadata";
+
+// Owned copy of a header string; NULL for empty ones
+char* copy_string(const std::string& value, bool* failed) {
+    if (value.empty()) {
+        return nullptr;
+    }
+    char* copy = rac_strdup(value.c_str());
+    if (!copy) {
+        *failed = true;
+    }
+    return copy;
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+rac_result_t rac_gguf_metadata_read(const char* path, rac_gguf_metadata_t* out_metadata) {
+    if (!path || !out_metadata) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    *out_metadata = {};
+
+    std::string file = path;
+    struct stat st = {};
+    if (stat(file.c_str(), &st) != 0) {
+        return RAC_ERROR_FILE_NOT_FOUND;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        file = rac::gguf::find_model_file(file);
+        if (file.empty() || stat(file.c_str(), &st) != 0) {
+            return RAC_ERROR_FILE_NOT_FOUND;
+        }
+    }
+
+    rac::gguf::Metadata meta;
+    const rac_result_t result = rac::gguf::read_file(file.c_str(), &meta);
+    if (result != RAC_SUCCESS) {
+        RAC_LOG_DEBUG(LOG_CAT, "No GGUF header in %s", file.c_str());
+        return result;
+    }
+
+    rac_gguf_metadata_t metadata = {};
+    bool failed = false;
+    metadata.version = meta.version;
+    metadata.architecture = copy_string(meta.architecture, &failed);
+    metadata.name = copy_string(meta.name, &failed);
+    metadata.chat_template = copy_string(meta.chat_template, &failed);
+    const int64_t file_type = meta.file_type();
+    metadata.file_type = static_cast<int32_t>(file_type);
+    if (const char* quantization = rac::gguf::file_type_name(file_type)) {
+        metadata.quantization = copy_string(quantization, &failed);
+    }
+    metadata.tensor_count = static_cast<int64_t>(meta.tensor_count);
+    metadata.supports_thinking =
+        meta.chat_template.find("<think>") != std::string::npos ? RAC_TRUE : RAC_FALSE;
+
+    rac::gguf::to_memory_profile(meta, static_cast<int64_t>(st.st_size), &metadata.profile);
+
+    if (failed) {
+        rac_gguf_metadata_free(&metadata);
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    *out_metadata = metadata;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_gguf_metadata_apply(const rac_gguf_metadata_t* metadata,
+                                     rac_model_info_t* model) {
+    if (!metadata || !model) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    model->format = RAC_MODEL_FORMAT_GGUF;
+    if (model->context_length == 0) {
+        model->context_length = metadata->profile.trained_context_length;
+    }
+    if (!model->quantization && metadata->quantization) {
+        model->quantization = rac_strdup(metadata->quantization);
+        if (!model->quantization) {
+            return RAC_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    if (!model->supports_thinking) {
+        model->supports_thinking = metadata->supports_thinking;
+    }
+    if (model->memory_required == 0) {
+        rac_model_fit_result_t fit = {};
+        if (rac_model_fit_estimate(&metadata->profile, nullptr, 0, 0, &fit) == RAC_SUCCESS) {
+            model->memory_required = fit.total_bytes;
+        }
+    }
+    return RAC_SUCCESS;
+}
+
+void rac_gguf_metadata_free(rac_gguf_metadata_t* metadata) {
+    if (!metadata) {
+        return;
+    }
+    rac_free(metadata->architecture);
+    rac_free(metadata->name);
+    rac_free(metadata->quantization);
+    rac_free(metadata->chat_template);
+    *metadata = {};
+}
@@ -0,0 +1,604 @@
+/**
+ * @file gguf_reader.h
+ * @brief RunAnywhere Commons - GGUF Header and Metadata Reader
+ *
+ * Decodes the header, key/value metadata and tensor infos at the start of a
+ * GGUF file without llama.cpp and without touching the tensor data. Files
+ * are mapped read-only and only the pages the header spans are faulted in,
+ * so reading a multi-GB model takes milliseconds. Used by the fit
+ * predictor (model_fit.cpp) and rac_gguf_metadata.h. Not part of the public
+ * API.
+ */
+
+#ifndef RAC_GGUF_READER_H
+#define RAC_GGUF_READER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rac/core/rac_error.h"
+#include "rac/infrastructure/model_management/rac_model_fit.h"
+
+namespace rac {
+namespace gguf {
+
+constexpr uint32_t kMagic = 0x46554747;  // "GGUF"
+constexpr uint32_t kMaxDims = 4;
+constexpr uint64_t kMaxTensors = 1 << 20;
+constexpr uint64_t kMaxString = 1 << 24;
+
+enum ValueType : uint32_t {
+    kUint8 = 0,
+    kInt8 = 1,
+    kUint16 = 2,
+    kInt16 = 3,
+    kUint32 = 4,
+    kInt32 = 5,
+    kFloat32 = 6,
+    kBool = 7,
+    kString = 8,
+    kArray = 9,
+    kUint64 = 10,
+    kInt64 = 11,
+    kFloat64 = 12
+};
+
+inline size_t scalar_size(uint32_t type) {
+    switch (type) {
+        case kUint8:
+        case kInt8:
+        case kBool:
+            return 1;
+        case kUint16:
+        case kInt16:
+            return 2;
+        case kUint32:
+        case kInt32:
+        case kFloat32:
+            return 4;
+        case kUint64:
+        case kInt64:
+        case kFloat64:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
+inline bool is_integer(uint32_t type) {
+    return type != kFloat32 && type != kFloat64 && type != kBool && scalar_size(type) > 0;
+}
+
+// Bytes per block of ggml tensor types (ggml.c type_traits); {0, 0} = unknown
+struct BlockSize {
+    uint32_t elements;
+    uint32_t bytes;
+};
+
+inline BlockSize ggml_block_size(uint32_t type) {
+    switch (type) {
+        case 0:  // F32
+        case 26:  // I32
+            return {1, 4};
+        case 1:  // F16
+        case 25:  // I16
+        case 30:  // BF16
+            return {1, 2};
+        case 24:  // I8
+            return {1, 1};
+        case 27:  // I64
+        case 28:  // F64
+            return {1, 8};
+        case 2:  // Q4_0
+        case 20:  // IQ4_NL
+            return {32, 18};
+        case 3:  // Q4_1
+            return {32, 20};
+        case 6:  // Q5_0
+            return {32, 22};
+        case 7:  // Q5_1
+            return {32, 24};
+        case 8:  // Q8_0
+            return {32, 34};
+        case 9:  // Q8_1
+            return {32, 36};
+        case 10:  // Q2_K
+            return {256, 84};
+        case 11:  // Q3_K
+        case 21:  // IQ3_S
+            return {256, 110};
+        case 12:  // Q4_K
+            return {256, 144};
+        case 13:  // Q5_K
+            return {256, 176};
+        case 14:  // Q6_K
+            return {256, 210};
+        case 15:  // Q8_K
+            return {256, 292};
+        case 16:  // IQ2_XXS
+        case 35:  // TQ2_0
+            return {256, 66};
+        case 17:  // IQ2_XS
+            return {256, 74};
+        case 18:  // IQ3_XXS
+            return {256, 98};
+        case 19:  // IQ1_S
+            return {256, 50};
+        case 22:  // IQ2_S
+            return {256, 82};
+        case 23:  // IQ4_XS
+            return {256, 136};
+        case 29:  // IQ1_M
+            return {256, 56};
+        case 34:  // TQ1_0
+            return {256, 54};
+        default:
+            return {0, 0};
+    }
+}
+
+// Registry-style name of a general.file_type (llama_ftype), NULL if unknown
+inline const char* file_type_name(int64_t file_type) {
+    switch (file_type) {
+        case 0:
+            return "f32";
+        case 1:
+            return "f16";
+        case 2:
+            return "q4_0";
+        case 3:
+            return "q4_1";
+        case 7:
+            return "q8_0";
+        case 8:
+            return "q5_0";
+        case 9:
+            return "q5_1";
+        case 10:
+            return "q2_k";
+        case 11:
+            return "q3_k_s";
+        case 12:
+            return "q3_k_m";
+        case 13:
+            return "q3_k_l";
+        case 14:
+            return "q4_k_s";
+        case 15:
+            return "q4_k_m";
+        case 16:
+            return "q5_k_s";
+        case 17:
+            return "q5_k_m";
+        case 18:
+            return "q6_k";
+        case 19:
+            return "iq2_xxs";
+        case 20:
+            return "iq2_xs";
+        case 21:
+            return "q2_k_s";
+        case 22:
+            return "iq3_xs";
+        case 23:
+            return "iq3_xxs";
+        case 24:
+            return "iq1_s";
+        case 25:
+            return "iq4_nl";
+        case 26:
+            return "iq3_s";
+        case 27:
+            return "iq3_m";
+        case 28:
+            return "iq2_s";
+        case 29:
+            return "iq2_m";
+        case 30:
+            return "iq4_xs";
+        case 31:
+            return "iq1_m";
+        case 32:
+            return "bf16";
+        case 36:
+            return "tq1_0";
+        case 37:
+            return "tq2_0";
+        default:
+            return nullptr;
+    }
+}
+
+// Little-endian reads from a header prefix that may end early
+class Reader {
+   public:
+    Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    bool ok() const { return !truncated_ && !invalid_; }
+    bool truncated() const { return truncated_; }
+    size_t position() const { return pos_; }
+    void fail() { invalid_ = true; }
+
+    bool skip(uint64_t bytes) {
+        if (!ok()) {
+            return false;
+        }
+        if (bytes > size_ - pos_) {
+            truncated_ = true;
+            return false;
+        }
+        pos_ += static_cast<size_t>(bytes);
+        return true;
+    }
+
+    template <typename T>
+    bool read(T* out) {
+        const size_t start = pos_;
+        if (!skip(sizeof(T))) {
+            return false;
+        }
+        memcpy(out, data_ + start, sizeof(T));
+        return true;
+    }
+
+    bool read_string(std::string* out) {
+        uint64_t length = 0;
+        if (!read(&length)) {
+            return false;
+        }
+        if (length > kMaxString) {
+            fail();
+            return false;
+        }
+        const size_t start = pos_;
+        if (!skip(length) || !out) {
+            return ok();
+        }
+        out->assign(reinterpret_cast<const char*>(data_ + start), static_cast<size_t>(length));
+        return true;
+    }
+
+    // An integer scalar of any width, widened to 64 bits
+    bool read_integer(uint32_t type, uint64_t* out) {
+        switch (type) {
+            case kUint8:
+            case kInt8:
+                return read_widened<uint8_t>(out);
+            case kUint16:
+            case kInt16:
+                return read_widened<uint16_t>(out);
+            case kUint32:
+            case kInt32:
+                return read_widened<uint32_t>(out);
+            default:
+                return read(out);
+        }
+    }
+
+    bool skip_value(uint32_t type) {
+        if (type == kString) {
+            return read_string(nullptr);
+        }
+        const size_t size = scalar_size(type);
+        if (size == 0) {
+            fail();
+            return false;
+        }
+        return skip(size);
+    }
+
+   private:
+    template <typename T>
+    bool read_widened(uint64_t* out) {
+        T value = 0;
+        if (!read(&value)) {
+            return false;
+        }
+        *out = value;
+        return true;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    bool truncated_ = false;
+    bool invalid_ = false;
+};
+
+// =============================================================================
+// METADATA
+// =============================================================================
+
+/**
+ * What the header says about a model. Integer keys (and the largest element
+ * of integer arrays, e.g. per-layer head counts) are kept in numbers.
+ */
+struct Metadata {
+    uint32_t version = 0;
+    std::string architecture;
+    std::string name;
+    std::string chat_template;
+    std::map<std::string, uint64_t> numbers;
+    uint64_t vocab_size = 0;
+    uint64_t tensor_count = 0;
+    int64_t parameter_count = 0;
+    int64_t weights_bytes = 0;
+
+    uint64_t number(const std::string& key, uint64_t fallback = 0) const {
+        auto it = numbers.find(key);
+        return it != numbers.end() ? it->second : fallback;
+    }
+
+    /** "<architecture>.<name>", e.g. arch_value("context_length") */
+    uint64_t arch_value(const char* key) const { return number(architecture + "." + key); }
+
+    /** general.file_type, -1 if absent */
+    int64_t file_type() const {
+        auto it = numbers.find("general.file_type");
+        return it != numbers.end() ? static_cast<int64_t>(it->second) : -1;
+    }
+};
+
+/**
+ * Parse the header from the start of a file.
+ *
+ * @param file_size Size of the whole file (0 if unknown); sizes the weights
+ *        when a tensor type is newer than ggml_block_size knows
+ * @return RAC_SUCCESS, RAC_ERROR_INVALID_FORMAT, or RAC_ERROR_BUFFER_TOO_SMALL
+ *         if the header continues past size
+ */
+inline rac_result_t parse(const uint8_t* data, size_t size, int64_t file_size, Metadata* out) {
+    Reader in(data, size);
+    uint32_t magic = 0;
+    uint64_t kv_count = 0;
+    Metadata meta;
+    if (in.read(&magic) && magic != kMagic) {
+        return RAC_ERROR_INVALID_FORMAT;
+    }
+    // Version 1 used 32-bit counts and lengths
+    if (in.read(&meta.version) && (meta.version < 2 || meta.version > 3)) {
+        return RAC_ERROR_INVALID_FORMAT;
+    }
+    in.read(&meta.tensor_count);
+    in.read(&kv_count);
+
+    std::string key;
+    for (uint64_t i = 0; i < kv_count && in.ok(); ++i) {
+        uint32_t type = 0;
+        if (!in.read_string(&key) || !in.read(&type)) {
+            break;
+        }
+        if (type == kString) {
+            std::string* target = key == "general.architecture"      ? &meta.architecture
+                                  : key == "general.name"            ? &meta.name
+                                  : key == "tokenizer.chat_template" ? &meta.chat_template
+                                                                     : nullptr;
+            in.read_string(target);
+        } else if (type == kArray) {
+            uint32_t element_type = 0;
+            uint64_t count = 0;
+            if (!in.read(&element_type) || !in.read(&count)) {
+                break;
+            }
+            if (key == "tokenizer.ggml.tokens") {
+                meta.vocab_size = count;
+            }
+            // Per-layer head counts: the largest layer sizes the cache
+            uint64_t largest = 0;
+            for (uint64_t j = 0; j < count && in.ok(); ++j) {
+                uint64_t value = 0;
+                if (is_integer(element_type) && in.read_integer(element_type, &value)) {
+                    largest = std::max(largest, value);
+                } else if (!is_integer(element_type)) {
+                    in.skip_value(element_type);
+                }
+            }
+            if (is_integer(element_type) && count > 0) {
+                meta.numbers[key] = largest;
+            }
+        } else if (is_integer(type)) {
+            uint64_t value = 0;
+            if (in.read_integer(type, &value)) {
+                meta.numbers[key] = value;
+            }
+        } else {
+            in.skip_value(type);
+        }
+    }
+
+    bool sized = true;
+    if (in.ok() && meta.tensor_count > kMaxTensors) {
+        in.fail();
+    }
+    for (uint64_t i = 0; i < meta.tensor_count && in.ok(); ++i) {
+        uint32_t dims = 0;
+        if (!in.read_string(nullptr) || !in.read(&dims)) {
+            break;
+        }
+        if (dims == 0 || dims > kMaxDims) {
+            in.fail();
+            break;
+        }
+        uint64_t elements = 1;
+        for (uint32_t d = 0; d < dims; ++d) {
+            uint64_t extent = 0;
+            in.read(&extent);
+            elements *= extent;
+        }
+        uint32_t type = 0;
+        uint64_t offset = 0;
+        if (!in.read(&type) || !in.read(&offset)) {
+            break;
+        }
+        const BlockSize block = ggml_block_size(type);
+        meta.parameter_count += static_cast<int64_t>(elements);
+        if (block.elements == 0) {
+            sized = false;
+        } else {
+            meta.weights_bytes += static_cast<int64_t>(
+                (elements + block.elements - 1) / block.elements * block.bytes);
+        }
+    }
+
+    if (in.truncated()) {
+        return RAC_ERROR_BUFFER_TOO_SMALL;
+    }
+    if (!in.ok()) {
+        return RAC_ERROR_INVALID_FORMAT;
+    }
+    if (!sized) {
+        // A tensor type newer than this table: the data section is the rest of the file
+        const uint64_t alignment = std::max<uint64_t>(meta.number("general.alignment", 32), 1);
+        const int64_t data_start =
+            static_cast<int64_t>((in.position() + alignment - 1) / alignment * alignment);
+        if (file_size <= data_start) {
+            return RAC_ERROR_INVALID_FORMAT;
+        }
+        meta.weights_bytes = file_size - data_start;
+    }
+
+    *out = std::move(meta);
+    return RAC_SUCCESS;
+}
+
+inline int32_t clamp_int32(uint64_t value) {
+    return value > INT32_MAX ? INT32_MAX : static_cast<int32_t>(value);
+}
+
+/** Memory profile for the fit predictor (rac_model_fit.h) */
+inline void to_memory_profile(const Metadata& meta, int64_t file_size,
+                              rac_model_memory_profile_t* out_profile) {
+    rac_model_memory_profile_t profile = {};
+    profile.format = RAC_MODEL_FORMAT_GGUF;
+    profile.file_size = file_size;
+    profile.parameter_count = meta.parameter_count;
+    profile.weights_bytes = meta.weights_bytes;
+    profile.trained_context_length = clamp_int32(meta.arch_value("context_length"));
+    profile.layer_count = clamp_int32(meta.arch_value("block_count"));
+    profile.embedding_length = clamp_int32(meta.arch_value("embedding_length"));
+    profile.head_count = clamp_int32(meta.arch_value("attention.head_count"));
+    profile.head_count_kv = clamp_int32(meta.arch_value("attention.head_count_kv"));
+    profile.key_length = clamp_int32(meta.arch_value("attention.key_length"));
+    profile.value_length = clamp_int32(meta.arch_value("attention.value_length"));
+    profile.vocab_size = clamp_int32(meta.vocab_size > 0 ? meta.vocab_size
+                                                       : meta.arch_value("vocab_size"));
+
+    if (profile.head_count_kv == 0) {
+        profile.head_count_kv = profile.head_count;
+    }
+    if (profile.head_count > 0 && profile.key_length == 0) {
+        profile.key_length = profile.embedding_length / profile.head_count;
+    }
+    if (profile.value_length == 0) {
+        profile.value_length = profile.key_length;
+    }
+
+    *out_profile = profile;
+}
+
+// =============================================================================
+// FILES
+// =============================================================================
+
+inline bool ends_with(const std::string& value, const char* suffix) {
+    const size_t length = strlen(suffix);
+    return value.size() >= length && strcasecmp(value.c_str() + value.size() - length, suffix) == 0;
+}
+
+// The model file inside a model folder: the first .gguf (projectors aside),
+// else the first .onnx
+inline std::string find_model_file(const std::string& folder) {
+    DIR* dir = opendir(folder.c_str());
+    if (!dir) {
+        return {};
+    }
+    std::string gguf;
+    std::string onnx;
+    while (dirent* entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name.empty() || name[0] == '.') {
+            continue;
+        }
+        if (gguf.empty() && ends_with(name, ".gguf") && name.find("mmproj") == std::string::npos) {
+            gguf = name;
+        } else if (onnx.empty() && ends_with(name, ".onnx")) {
+            onnx = name;
+        }
+    }
+    closedir(dir);
+    const std::string& file = gguf.empty() ? onnx : gguf;
+    return file.empty() ? std::string() : folder + "/" + file;
+}
+
+/**
+ * Read-only mapping of a whole file. Mapping reads nothing; parse() then
+ * faults in only the header pages, and the weights stay on disk.
+ */
+class MappedFile {
+   public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() {
+        if (data_) {
+            munmap(data_, size_);
+        }
+    }
+
+    /** RAC_SUCCESS, RAC_ERROR_FILE_NOT_FOUND or RAC_ERROR_FILE_READ_FAILED */
+    rac_result_t open(const char* path) {
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return errno == ENOENT ? RAC_ERROR_FILE_NOT_FOUND : RAC_ERROR_FILE_READ_FAILED;
+        }
+        struct stat st = {};
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return RAC_ERROR_FILE_READ_FAILED;
+        }
+        void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            return RAC_ERROR_FILE_READ_FAILED;
+        }
+        data_ = data;
+        size_ = static_cast<size_t>(st.st_size);
+        return RAC_SUCCESS;
+    }
+
+    const uint8_t* data() const { return static_cast<const uint8_t*>(data_); }
+    size_t size() const { return size_; }
+
+   private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/** Map path and parse its header */
+inline rac_result_t read_file(const char* path, Metadata* out) {
+    MappedFile file;
+    rac_result_t result = file.open(path);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+    result = parse(file.data(), file.size(), static_cast<int64_t>(file.size()), out);
+    // The whole file is mapped, so running out of bytes means it is cut short
+    return result == RAC_ERROR_BUFFER_TOO_SMALL ? RAC_ERROR_INVALID_FORMAT : result;
+}
+
+}  // namespace gguf
+}  // namespace rac
+
+#endif /* RAC_GGUF_READER_H */
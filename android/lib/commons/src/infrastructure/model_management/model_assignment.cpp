@@ -1,25 +1,36 @@
 /**
  * @file model_assignment.cpp
  * @brief Model Assignment Manager Implementation
+ *
+ * With a cache path set, the raw response body is kept in that file and its
+ * validators (ETag, Last-Modified) and fetch time in "<path>.meta". The body
+ * is parsed straight from disk on launch; a cache older than the timeout is
+ * still served while a conditional GET revalidates it on the request
+ * executor, and a 304 only rewrites the meta file.
  */
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <mutex>
+#include <string>
 #include <vector>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_core.h"
+#include "rac/core/rac_executor.h"
 #include "rac/core/rac_logger.h"
 #include "rac/core/rac_platform_adapter.h"
+#include "rac/infrastructure/device/rac_device_profile.h"
 #include "rac/infrastructure/model_management/rac_model_assignment.h"
 #include "rac/infrastructure/model_management/rac_model_registry.h"
 #include "rac/infrastructure/network/rac_endpoints.h"
-
-// Simple JSON parsing (we don't want heavy dependencies)
-#include <sstream>
-#include <string>
+#include "rac/infrastructure/network/rac_outbound_queue.h"
 
 static const char* LOG_CAT = "ModelAssignment";
 
@@ -36,6 +47,12 @@ static std::chrono::steady_clock::time_point g_last_fetch_time;
 static uint32_t g_cache_timeout_seconds = 3600;  // 1 hour default
 static bool g_cache_valid = false;
 
+// Disk cache (rac_model_assignment_set_cache_path)
+static std::string g_cache_path;
+static std::string g_etag;
+static std::string g_last_modified;
+static bool g_revalidation_queued = false;
+
 // =============================================================================
 // HELPER FUNCTIONS
 // =============================================================================
@@ -46,6 +63,8 @@ static void clear_cache_internal() {
     }
     g_cached_models.clear();
     g_cache_valid = false;
+    g_etag.clear();
+    g_last_modified.clear();
 }
 
 static bool is_cache_valid() {
@@ -58,188 +77,383 @@ static bool is_cache_valid() {
     return elapsed < g_cache_timeout_seconds;
 }
 
-// Simple JSON string extraction (finds "key": "value" or "key": number)
-static std::string json_get_string(const std::string& json, const std::string& key) {
-    std::string search = "\"" + key + "\"";
-    size_t pos = json.find(search);
-    if (pos == std::string::npos)
-        return "";
-
-    pos = json.find(":", pos);
-    if (pos == std::string::npos)
-        return "";
-
-    // Skip whitespace
-    pos++;
-    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t'))
-        pos++;
-
-    if (pos >= json.size())
-        return "";
-
-    // Check for string value
-    if (json[pos] == '"') {
-        size_t start = pos + 1;
-        size_t end = json.find('"', start);
-        if (end == std::string::npos)
-            return "";
-        return json.substr(start, end - start);
-    }
-
-    // Check for null
-    if (json.substr(pos, 4) == "null")
-        return "";
-
-    // Number or boolean
-    size_t end = json.find_first_of(",}]", pos);
-    if (end == std::string::npos)
-        return "";
-    std::string val = json.substr(pos, end - pos);
-    // Trim whitespace
-    while (!val.empty() && (val.back() == ' ' || val.back() == '\t' || val.back() == '\n')) {
-        val.pop_back();
-    }
-    return val;
-}
+// =============================================================================
+// RESPONSE PARSING
+// =============================================================================
 
-static int64_t json_get_int(const std::string& json, const std::string& key,
-                            int64_t default_val = 0) {
-    std::string val = json_get_string(json, key);
-    if (val.empty())
-        return default_val;
-    return std::strtoll(val.c_str(), nullptr, 10);
-}
+namespace {
 
-static bool json_get_bool(const std::string& json, const std::string& key,
-                          bool default_val = false) {
-    std::string val = json_get_string(json, key);
-    if (val.empty())
-        return default_val;
-    return val == "true";
-}
+// Pull parser over the response body: every byte is read once and nothing is
+// copied except decoded string values
+class JsonReader {
+   public:
+    JsonReader(const char* data, size_t size) : p_(data), end_(data + size) {}
 
-// Parse models array from JSON response
-static std::vector<rac_model_info_t*> parse_models_json(const char* json_str, size_t len) {
-    std::vector<rac_model_info_t*> models;
-    if (!json_str || len == 0)
-        return models;
+    bool ok() const { return ok_; }
+    const char* position() const { return p_; }
 
-    std::string json(json_str, len);
+    // Next non-space character, or '\0' at the end
+    char peek() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r'))
+            p_++;
+        return p_ < end_ ? *p_ : '\0';
+    }
 
-    // Find "models" array
-    size_t models_pos = json.find("\"models\"");
-    if (models_pos == std::string::npos) {
-        RAC_LOG_WARNING(LOG_CAT, "No 'models' array in response");
-        return models;
+    bool enter(char open) {
+        if (peek() != open)
+            return fail();
+        p_++;
+        first_ = true;
+        return true;
     }
 
-    // Find array start
-    size_t arr_start = json.find('[', models_pos);
-    if (arr_start == std::string::npos)
-        return models;
+    // Advances to the next member of the object just entered; false at its end
+    bool next_member(std::string* key) {
+        if (!next_item('}'))
+            return false;
+        if (peek() != '"' || !read_string(key) || peek() != ':')
+            return fail();
+        p_++;
+        return true;
+    }
 
-    // Find each object in array
-    size_t pos = arr_start + 1;
-    while (pos < json.size()) {
-        // Find next object start
-        size_t obj_start = json.find('{', pos);
-        if (obj_start == std::string::npos)
-            break;
+    // Advances to the next element of the array just entered; false at its end
+    bool next_element() { return next_item(']'); }
+
+    // Scalar as text: strings decoded, numbers and booleans as written, null
+    // and containers (skipped) as empty
+    bool read_text(std::string* out) {
+        out->clear();
+        const char c = peek();
+        if (c == '"')
+            return read_string(out);
+        if (c == '{' || c == '[')
+            return skip_value();
+        const char* start = p_;
+        while (p_ < end_ && *p_ != ',' && *p_ != '}' && *p_ != ']' && *p_ != ' ' &&
+               *p_ != '\t' && *p_ != '\n' && *p_ != '\r')
+            p_++;
+        if (p_ == start)
+            return fail();
+        if (static_cast<size_t>(p_ - start) != 4 || memcmp(start, "null", 4) != 0)
+            out->assign(start, p_);
+        return true;
+    }
 
-        // Find matching close brace (simple approach, may fail on nested objects)
-        int depth = 1;
-        size_t obj_end = obj_start + 1;
-        while (obj_end < json.size() && depth > 0) {
-            if (json[obj_end] == '{')
+    bool skip_value() {
+        int depth = 0;
+        do {
+            const char c = peek();
+            if (c == '"') {
+                if (!skip_string())
+                    return false;
+            } else if (c == '{' || c == '[') {
                 depth++;
-            else if (json[obj_end] == '}')
-                depth--;
-            obj_end++;
+                p_++;
+            } else if (c == '}' || c == ']') {
+                if (--depth < 0)
+                    return fail();
+                p_++;
+            } else if (c == ',' || c == ':') {
+                if (depth == 0)
+                    return fail();
+                p_++;
+            } else if (c == '\0') {
+                return fail();
+            } else {
+                while (p_ < end_ && strchr(",:{}[]\" \t\n\r", *p_) == nullptr)
+                    p_++;
+            }
+        } while (depth > 0);
+        return true;
+    }
+
+   private:
+    bool fail() {
+        ok_ = false;
+        return false;
+    }
+
+    bool next_item(char close) {
+        if (!ok_)
+            return false;
+        const char c = peek();
+        if (c == close) {
+            p_++;
+            first_ = false;
+            return false;
         }
+        if (!first_) {
+            if (c != ',')
+                return fail();
+            p_++;
+        }
+        first_ = false;
+        return true;
+    }
 
-        if (depth != 0)
-            break;
+    bool skip_string() {
+        for (p_++; p_ < end_; p_++) {
+            if (*p_ == '\\') {
+                p_++;
+            } else if (*p_ == '"') {
+                p_++;
+                return true;
+            }
+        }
+        return fail();
+    }
 
-        std::string obj = json.substr(obj_start, obj_end - obj_start);
-
-        // Parse model fields
-        std::string id = json_get_string(obj, "id");
-        std::string name = json_get_string(obj, "name");
-        std::string category = json_get_string(obj, "category");
-        std::string format = json_get_string(obj, "format");
-        std::string framework = json_get_string(obj, "preferred_framework");
-        std::string download_url = json_get_string(obj, "download_url");
-        std::string description = json_get_string(obj, "description");
-        int64_t size = json_get_int(obj, "size", 0);
-        int context_length = static_cast<int>(json_get_int(obj, "context_length", 0));
-        bool supports_thinking = json_get_bool(obj, "supports_thinking", false);
-
-        if (id.empty()) {
-            pos = obj_end;
-            continue;
+    bool read_hex4(uint32_t* out) {
+        if (end_ - p_ < 4)
+            return false;
+        *out = 0;
+        for (int i = 0; i < 4; i++) {
+            const char c = *p_++;
+            *out <<= 4;
+            if (c >= '0' && c <= '9')
+                *out |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f')
+                *out |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                *out |= static_cast<uint32_t>(c - 'A' + 10);
+            else
+                return false;
         }
+        return true;
+    }
 
-        // Create model info
-        rac_model_info_t* model = rac_model_info_alloc();
-        if (!model)
-            continue;
+    static void append_utf8(std::string* out, uint32_t cp) {
+        if (cp < 0x80) {
+            out->push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out->push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out->push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out->push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out->push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
 
-        model->id = strdup(id.c_str());
-        model->name = strdup(name.c_str());
-        model->download_url = download_url.empty() ? nullptr : strdup(download_url.c_str());
-        model->description = description.empty() ? nullptr : strdup(description.c_str());
-        model->download_size = size;
-        model->context_length = context_length;
-        model->supports_thinking = supports_thinking ? RAC_TRUE : RAC_FALSE;
-        model->source = RAC_MODEL_SOURCE_REMOTE;
-
-        // Parse category
-        if (category == "language")
-            model->category = RAC_MODEL_CATEGORY_LANGUAGE;
-        else if (category == "speech" || category == "stt")
-            model->category = RAC_MODEL_CATEGORY_SPEECH_RECOGNITION;
-        else if (category == "tts")
-            model->category = RAC_MODEL_CATEGORY_SPEECH_SYNTHESIS;
-        else if (category == "vision")
-            model->category = RAC_MODEL_CATEGORY_VISION;
-        else if (category == "audio")
-            model->category = RAC_MODEL_CATEGORY_AUDIO;
-        else if (category == "multimodal")
-            model->category = RAC_MODEL_CATEGORY_MULTIMODAL;
-        else
-            model->category = RAC_MODEL_CATEGORY_LANGUAGE;
-
-        // Parse format
-        if (format == "gguf")
-            model->format = RAC_MODEL_FORMAT_GGUF;
-        else if (format == "onnx")
-            model->format = RAC_MODEL_FORMAT_ONNX;
-        else if (format == "ort")
-            model->format = RAC_MODEL_FORMAT_ORT;
-        else if (format == "bin")
-            model->format = RAC_MODEL_FORMAT_BIN;
-        else
-            model->format = RAC_MODEL_FORMAT_UNKNOWN;
-
-        // Parse framework
-        if (framework == "llama.cpp" || framework == "llamacpp")
-            model->framework = RAC_FRAMEWORK_LLAMACPP;
-        else if (framework == "onnx" || framework == "onnxruntime")
-            model->framework = RAC_FRAMEWORK_ONNX;
-        else if (framework == "foundation_models" || framework == "platform-llm-default")
-            model->framework = RAC_FRAMEWORK_FOUNDATION_MODELS;
-        else if (framework == "system_tts" || framework == "platform-tts")
-            model->framework = RAC_FRAMEWORK_SYSTEM_TTS;
-        else
-            model->framework = RAC_FRAMEWORK_UNKNOWN;
+    bool read_string(std::string* out) {
+        out->clear();
+        p_++;
+        while (p_ < end_) {
+            // Copy the run up to the next quote or escape in one go
+            const char* run = p_;
+            while (p_ < end_ && *p_ != '"' && *p_ != '\\')
+                p_++;
+            out->append(run, p_);
+            if (p_ >= end_)
+                break;
+            if (*p_++ == '"')
+                return true;
+            if (p_ >= end_)
+                break;
+            const char e = *p_++;
+            switch (e) {
+                case 'b':
+                    out->push_back('\b');
+                    break;
+                case 'f':
+                    out->push_back('\f');
+                    break;
+                case 'n':
+                    out->push_back('\n');
+                    break;
+                case 'r':
+                    out->push_back('\r');
+                    break;
+                case 't':
+                    out->push_back('\t');
+                    break;
+                case 'u': {
+                    uint32_t cp = 0;
+                    if (!read_hex4(&cp))
+                        return fail();
+                    if (cp >= 0xD800 && cp < 0xDC00) {
+                        uint32_t low = 0;
+                        if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u')
+                            return fail();
+                        p_ += 2;
+                        if (!read_hex4(&low) || low < 0xDC00 || low >= 0xE000)
+                            return fail();
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    append_utf8(out, cp);
+                    break;
+                }
+                default:
+                    out->push_back(e);  // \" \\ \/
+                    break;
+            }
+        }
+        return fail();
+    }
+
+    const char* p_;
+    const char* end_;
+    bool first_ = true;  // No comma expected before the next item
+    bool ok_ = true;
+};
+
+// Replaces a string field; empty values leave it NULL
+void set_field(char** field, const std::string& value) {
+    rac_free(*field);
+    *field = value.empty() ? nullptr : rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, value.c_str());
+}
+
+rac_model_category_t parse_category(const std::string& category) {
+    if (category == "language")
+        return RAC_MODEL_CATEGORY_LANGUAGE;
+    if (category == "speech" || category == "stt")
+        return RAC_MODEL_CATEGORY_SPEECH_RECOGNITION;
+    if (category == "tts")
+        return RAC_MODEL_CATEGORY_SPEECH_SYNTHESIS;
+    if (category == "vision")
+        return RAC_MODEL_CATEGORY_VISION;
+    if (category == "audio")
+        return RAC_MODEL_CATEGORY_AUDIO;
+    if (category == "multimodal")
+        return RAC_MODEL_CATEGORY_MULTIMODAL;
+    return RAC_MODEL_CATEGORY_LANGUAGE;
+}
+
+rac_model_format_t parse_format(const std::string& format) {
+    if (format == "gguf")
+        return RAC_MODEL_FORMAT_GGUF;
+    if (format == "onnx")
+        return RAC_MODEL_FORMAT_ONNX;
+    if (format == "ort")
+        return RAC_MODEL_FORMAT_ORT;
+    if (format == "bin")
+        return RAC_MODEL_FORMAT_BIN;
+    return RAC_MODEL_FORMAT_UNKNOWN;
+}
 
-        models.push_back(model);
-        pos = obj_end;
+rac_inference_framework_t parse_framework(const std::string& framework) {
+    if (framework == "llama.cpp" || framework == "llamacpp")
+        return RAC_FRAMEWORK_LLAMACPP;
+    if (framework == "onnx" || framework == "onnxruntime")
+        return RAC_FRAMEWORK_ONNX;
+    if (framework == "foundation_models" || framework == "platform-llm-default")
+        return RAC_FRAMEWORK_FOUNDATION_MODELS;
+    if (framework == "system_tts" || framework == "platform-tts")
+        return RAC_FRAMEWORK_SYSTEM_TTS;
+    return RAC_FRAMEWORK_UNKNOWN;
+}
+
+// Reads one model object straight into a rac_model_info_t; NULL if it has no id
+rac_model_info_t* parse_model(JsonReader& reader) {
+    rac_model_info_t* model = rac_model_info_alloc();
+    if (!model || !reader.enter('{')) {
+        rac_model_info_free(model);
+        return nullptr;
+    }
+    model->source = RAC_MODEL_SOURCE_REMOTE;
+    model->category = RAC_MODEL_CATEGORY_LANGUAGE;
+    model->format = RAC_MODEL_FORMAT_UNKNOWN;
+    model->framework = RAC_FRAMEWORK_UNKNOWN;
+
+    std::string key;
+    std::string value;
+    while (reader.next_member(&key)) {
+        if (!reader.read_text(&value))
+            break;
+        if (key == "id")
+            set_field(&model->id, value);
+        else if (key == "name")
+            set_field(&model->name, value);
+        else if (key == "category")
+            model->category = parse_category(value);
+        else if (key == "format")
+            model->format = parse_format(value);
+        else if (key == "preferred_framework")
+            model->framework = parse_framework(value);
+        else if (key == "download_url")
+            set_field(&model->download_url, value);
+        else if (key == "description")
+            set_field(&model->description, value);
+        else if (key == "size")
+            model->download_size = std::strtoll(value.c_str(), nullptr, 10);
+        else if (key == "context_length")
+            model->context_length = static_cast<int>(std::strtoll(value.c_str(), nullptr, 10));
+        else if (key == "supports_thinking")
+            model->supports_thinking = value == "true" ? RAC_TRUE : RAC_FALSE;
+        else if (key == "variant_of")
+            set_field(&model->variant_of, value);
+        else if (key == "quantization")
+            set_field(&model->quantization, value);
+        else if (key == "expected_rtf")
+            model->expected_rtf = value.empty() ? 0.0f : strtof(value.c_str(), nullptr);
+        else if (key == "sha256")
+            set_field(&model->sha256, value);
+        else if (key == "delta_manifest_url")
+            set_field(&model->delta_manifest_url, value);
     }
 
-    return models;
+    if (!reader.ok() || !model->id) {
+        rac_model_info_free(model);
+        return nullptr;
+    }
+    if (!model->name)
+        model->name = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, "");
+    return model;
+}
+
+struct AssignmentResponse {
+    std::vector<rac_model_info_t*> models;
+    std::string telemetry_policy;  // Raw object text, empty when absent
+};
+
+// Parses {"models": [...], "telemetry_policy": {...}} in one pass. Models read
+// before a syntax error are kept.
+AssignmentResponse parse_assignment_response(const char* json, size_t len) {
+    AssignmentResponse response;
+    if (!json || len == 0)
+        return response;
+
+    JsonReader reader(json, len);
+    bool found_models = false;
+    std::string key;
+    if (reader.enter('{')) {
+        while (reader.next_member(&key)) {
+            if (key == "models" && reader.peek() == '[') {
+                found_models = true;
+                reader.enter('[');
+                while (reader.next_element()) {
+                    if (reader.peek() != '{') {
+                        reader.skip_value();
+                        continue;
+                    }
+                    if (rac_model_info_t* model = parse_model(reader))
+                        response.models.push_back(model);
+                }
+            } else if (key == "telemetry_policy" && reader.peek() == '{') {
+                const char* start = reader.position();
+                if (reader.skip_value())
+                    response.telemetry_policy.assign(start, reader.position());
+            } else {
+                reader.skip_value();
+            }
+        }
+    }
+
+    if (!reader.ok())
+        RAC_LOG_WARNING(LOG_CAT, "Malformed model assignment response");
+    else if (!found_models)
+        RAC_LOG_WARNING(LOG_CAT, "No 'models' array in response");
+    return response;
 }
 
+}  // namespace
+
 // Copy models array for output
 static rac_result_t copy_models_to_output(const std::vector<rac_model_info_t*>& models,
                                           rac_model_info_t*** out_models, size_t* out_count) {
@@ -253,7 +467,8 @@ static rac_result_t copy_models_to_output(const std::vector<rac_model_info_t*>&
     }
 
     *out_models =
-        static_cast<rac_model_info_t**>(malloc(models.size() * sizeof(rac_model_info_t*)));
+        static_cast<rac_model_info_t**>(rac_alloc_tagged(
+            RAC_ALLOC_TAG_MODEL, models.size() * sizeof(rac_model_info_t*)));
     if (!*out_models) {
         *out_count = 0;
         return RAC_ERROR_OUT_OF_MEMORY;
@@ -266,7 +481,7 @@ static rac_result_t copy_models_to_output(const std::vector<rac_model_info_t*>&
             for (size_t j = 0; j < i; j++) {
                 rac_model_info_free((*out_models)[j]);
             }
-            free(*out_models);
+            rac_free(*out_models);
             *out_models = nullptr;
             *out_count = 0;
             return RAC_ERROR_OUT_OF_MEMORY;
@@ -276,10 +491,278 @@ static rac_result_t copy_models_to_output(const std::vector<rac_model_info_t*>&
     return RAC_SUCCESS;
 }
 
+// =============================================================================
+// DISK CACHE
+// =============================================================================
+
+namespace {
+
+bool read_file(const std::string& path, std::string* out) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    out->clear();
+    char buffer[16384];
+    ssize_t n;
+    while ((n = ::read(fd, buffer, sizeof(buffer))) > 0) {
+        out->append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return n == 0;
+}
+
+// Replaces path atomically
+bool write_file(const std::string& path, const char* data, size_t size) {
+    const std::string tmp_path = path + ".tmp";
+    const int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+    bool written = true;
+    for (size_t offset = 0; written && offset < size;) {
+        const ssize_t n = ::write(fd, data + offset, size - offset);
+        written = n > 0;
+        offset += written ? static_cast<size_t>(n) : 0;
+    }
+    written = written && fsync(fd) == 0;
+    ::close(fd);
+    if (!written || rename(tmp_path.c_str(), path.c_str()) != 0) {
+        unlink(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+int64_t unix_time_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// Meta file: "etag: ...", "last-modified: ..." and "fetched-at: <unix ms>" lines
+void write_meta_locked(int64_t fetched_at_ms) {
+    std::string meta = "etag: " + g_etag + "\nlast-modified: " + g_last_modified +
+                       "\nfetched-at: " + std::to_string(fetched_at_ms) + "\n";
+    if (!write_file(g_cache_path + ".meta", meta.data(), meta.size()))
+        RAC_LOG_WARNING(LOG_CAT, "Cannot write model assignment cache metadata");
+}
+
+int64_t read_meta_locked() {
+    std::string meta;
+    if (!read_file(g_cache_path + ".meta", &meta))
+        return 0;
+    int64_t fetched_at_ms = 0;
+    size_t line_start = 0;
+    while (line_start < meta.size()) {
+        size_t line_end = meta.find('\n', line_start);
+        if (line_end == std::string::npos)
+            line_end = meta.size();
+        const std::string line = meta.substr(line_start, line_end - line_start);
+        line_start = line_end + 1;
+        const size_t colon = line.find(": ");
+        if (colon == std::string::npos)
+            continue;
+        const std::string key = line.substr(0, colon);
+        const std::string value = line.substr(colon + 2);
+        if (key == "etag")
+            g_etag = value;
+        else if (key == "last-modified")
+            g_last_modified = value;
+        else if (key == "fetched-at")
+            fetched_at_ms = std::strtoll(value.c_str(), nullptr, 10);
+    }
+    return fetched_at_ms;
+}
+
+}  // namespace
+
+// Parses a response body, applies its telemetry policy, saves the models to
+// the registry and makes them the cache. Caller holds g_mutex.
+static size_t apply_response_locked(const char* body, size_t length) {
+    AssignmentResponse parsed = parse_assignment_response(body, length);
+    std::vector<rac_model_info_t*>& models = parsed.models;
+
+    // The backend may ship telemetry sampling settings with the assignments
+    if (g_callbacks.on_telemetry_policy) {
+        const std::string& policy = parsed.telemetry_policy;
+        if (!policy.empty()) {
+            RAC_LOG_DEBUG(LOG_CAT, "Applying telemetry policy from model assignments");
+            g_callbacks.on_telemetry_policy(policy.c_str(), policy.size(), g_callbacks.user_data);
+        }
+    }
+
+    // Save to registry
+    rac_model_registry_handle_t registry = rac_get_model_registry();
+    if (registry) {
+        for (auto* model : models) {
+            rac_model_registry_save(registry, model);
+        }
+        rac_model_registry_flush_index(registry);
+        RAC_LOG_DEBUG(LOG_CAT, "Saved models to registry");
+    }
+
+    // Update cache; the models move into it
+    const std::string etag = g_etag;
+    const std::string last_modified = g_last_modified;
+    clear_cache_internal();
+    g_etag = etag;
+    g_last_modified = last_modified;
+    g_cached_models = std::move(models);
+    return g_cached_models.size();
+}
+
+// Loads the disk cache; fresh if younger than the cache timeout. Caller holds g_mutex.
+static void load_disk_cache_locked() {
+    std::string body;
+    if (!read_file(g_cache_path, &body) || body.empty())
+        return;
+    const int64_t fetched_at_ms = read_meta_locked();
+    const size_t count = apply_response_locked(body.data(), body.size());
+
+    const int64_t age_ms = fetched_at_ms > 0 ? unix_time_ms() - fetched_at_ms : -1;
+    if (age_ms >= 0 && age_ms < static_cast<int64_t>(g_cache_timeout_seconds) * 1000) {
+        g_last_fetch_time = std::chrono::steady_clock::now() - std::chrono::milliseconds(age_ms);
+        g_cache_valid = true;
+    }
+    char msg[160];
+    snprintf(msg, sizeof(msg), "Loaded %zu model assignments from disk (%s)", count,
+             g_cache_valid ? "fresh" : "stale, will revalidate");
+    RAC_LOG_INFO(LOG_CAT, msg);
+}
+
+// Fetches from the backend, conditionally when validators are known, and
+// updates the cache. Caller holds g_mutex.
+static rac_result_t fetch_from_backend_locked() {
+    char msg[256];
+
+    // Need to fetch from backend
+    if (!g_callbacks.http_get) {
+        RAC_LOG_ERROR(LOG_CAT, "HTTP callback not set - cannot fetch models");
+        return RAC_ERROR_INVALID_STATE;
+    }
+
+    // The backend filters by JWT; a calibrated device also sends its class so
+    // assignments can be sized to it
+    std::string endpoint_path = rac_endpoint_model_assignments();
+    const rac_device_class_t device_class = rac_device_profile_get_class();
+    if (device_class != RAC_DEVICE_CLASS_UNKNOWN) {
+        endpoint_path += "?device_class=";
+        endpoint_path += rac_device_class_name(device_class);
+    }
+    const char* endpoint = endpoint_path.c_str();
+
+    // Revalidate what we have instead of downloading it again
+    const bool conditional = g_callbacks.http_get_conditional && !g_cached_models.empty() &&
+                             (!g_etag.empty() || !g_last_modified.empty());
+
+    snprintf(msg, sizeof(msg), ">>> Making %sHTTP GET to: %s", conditional ? "conditional " : "",
+             endpoint);
+    RAC_LOG_INFO(LOG_CAT, msg);
+
+    // Make HTTP request
+    rac_assignment_http_response_t response = {};
+    rac_result_t result =
+        conditional
+            ? g_callbacks.http_get_conditional(endpoint, RAC_TRUE,
+                                               g_etag.empty() ? nullptr : g_etag.c_str(),
+                                               g_last_modified.empty() ? nullptr
+                                                                       : g_last_modified.c_str(),
+                                               &response, g_callbacks.user_data)
+            : g_callbacks.http_get(endpoint, RAC_TRUE, &response, g_callbacks.user_data);
+
+    snprintf(msg, sizeof(msg), "<<< http_get returned: result=%d, response.result=%d, status=%d, body_len=%zu",
+             result, response.result, response.status_code, response.response_length);
+    RAC_LOG_INFO(LOG_CAT, msg);
+
+    if (result != RAC_SUCCESS || response.result != RAC_SUCCESS) {
+        snprintf(msg, sizeof(msg), "HTTP request failed: result=%d, response.result=%d, error=%s",
+                 result, response.result,
+                 response.error_message ? response.error_message : "unknown error");
+        RAC_LOG_ERROR(LOG_CAT, msg);
+        return result != RAC_SUCCESS ? result : response.result;
+    }
+
+    if (conditional && response.status_code == 304) {
+        RAC_LOG_INFO(LOG_CAT, "Model assignments unchanged (304)");
+        g_last_fetch_time = std::chrono::steady_clock::now();
+        g_cache_valid = true;
+        if (!g_cache_path.empty())
+            write_meta_locked(unix_time_ms());
+        return RAC_SUCCESS;
+    }
+
+    if (response.status_code != 200) {
+        snprintf(msg, sizeof(msg), "HTTP %d: %s", response.status_code,
+                 response.error_message ? response.error_message : "request failed");
+        RAC_LOG_ERROR(LOG_CAT, msg);
+        return RAC_ERROR_HTTP_REQUEST_FAILED;
+    }
+
+    // Parse response
+    g_etag = response.etag ? response.etag : "";
+    g_last_modified = response.last_modified ? response.last_modified : "";
+    const size_t count = apply_response_locked(response.response_body, response.response_length);
+    snprintf(msg, sizeof(msg), "Parsed %zu model assignments", count);
+    RAC_LOG_INFO(LOG_CAT, msg);
+    g_last_fetch_time = std::chrono::steady_clock::now();
+    g_cache_valid = true;
+
+    if (!g_cache_path.empty() && response.response_body) {
+        if (write_file(g_cache_path, response.response_body, response.response_length))
+            write_meta_locked(unix_time_ms());
+        else
+            RAC_LOG_WARNING(LOG_CAT, "Cannot write model assignment cache");
+    }
+    return RAC_SUCCESS;
+}
+
+static void run_revalidation(rac_request_id_t /*id*/, void* /*user_data*/) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!is_cache_valid())
+        fetch_from_backend_locked();
+}
+
+static void release_revalidation(rac_request_id_t /*id*/, rac_bool_t /*ran*/, void* /*user_data*/) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_revalidation_queued = false;
+}
+
+// Stale-while-revalidate: the caller gets the stale models, the refresh
+// happens on the request executor. Caller holds g_mutex.
+static void queue_revalidation_locked() {
+    if (g_revalidation_queued)
+        return;
+    rac_request_t request = {};
+    request.priority = RAC_REQUEST_PRIORITY_LOW;
+    request.run = run_revalidation;
+    request.release = release_revalidation;
+    rac_request_id_t id = 0;
+    g_revalidation_queued = rac_executor_submit(&request, &id) == RAC_SUCCESS;
+}
+
 // =============================================================================
 // PUBLIC API IMPLEMENTATION
 // =============================================================================
 
+// Outbound queue handler for the auto-fetch
+static rac_result_t send_queued_fetch(const rac_outbound_item_t* /*items*/, size_t /*count*/,
+                                      void* /*user_data*/) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (is_cache_valid()) {
+        return RAC_SUCCESS;
+    }
+    const rac_result_t result = fetch_from_backend_locked();
+    if (result == RAC_SUCCESS) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "Auto-fetch completed: %zu models", g_cached_models.size());
+        RAC_LOG_INFO(LOG_CAT, msg);
+    } else {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "Auto-fetch failed with code: %d", result);
+        RAC_LOG_WARNING(LOG_CAT, msg);
+    }
+    return result;
+}
+
 rac_result_t rac_model_assignment_set_callbacks(const rac_assignment_callbacks_t* callbacks) {
     RAC_LOG_INFO(LOG_CAT, "rac_model_assignment_set_callbacks called");
 
@@ -301,27 +784,13 @@ rac_result_t rac_model_assignment_set_callbacks(const rac_assignment_callbacks_t
         RAC_LOG_INFO(LOG_CAT, msg);
     }
 
-    // Auto-fetch if requested (outside lock to avoid deadlock with fetch)
+    // Auto-fetch through the outbound queue, so startup does not wait on the network
     if (should_auto_fetch == RAC_TRUE) {
-        RAC_LOG_INFO(LOG_CAT, "Auto-fetching model assignments...");
-        rac_model_info_t** models = nullptr;
-        size_t count = 0;
-        rac_result_t fetch_result = rac_model_assignment_fetch(RAC_FALSE, &models, &count);
-
-        if (fetch_result == RAC_SUCCESS) {
-            char msg[128];
-            snprintf(msg, sizeof(msg), "Auto-fetch completed: %zu models", count);
-            RAC_LOG_INFO(LOG_CAT, msg);
-        } else {
-            char msg[128];
-            snprintf(msg, sizeof(msg), "Auto-fetch failed with code: %d", fetch_result);
-            RAC_LOG_WARNING(LOG_CAT, msg);
-        }
-
-        // Free the returned models array (data is already cached internally)
-        if (models) {
-            rac_model_info_array_free(models, count);
-        }
+        RAC_LOG_INFO(LOG_CAT, "Queueing model assignment auto-fetch");
+        rac_outbound_queue_set_handler(RAC_OUTBOUND_KIND_MODEL_ASSIGNMENTS, send_queued_fetch, 1,
+                                       nullptr);
+        rac_outbound_queue_enqueue(RAC_OUTBOUND_KIND_MODEL_ASSIGNMENTS, "fetch", nullptr, 0,
+                                   RAC_REQUEST_PRIORITY_NORMAL);
     } else {
         RAC_LOG_INFO(LOG_CAT, "Auto-fetch disabled, models will be fetched on demand");
     }
@@ -353,94 +822,39 @@ rac_result_t rac_model_assignment_fetch(rac_bool_t force_refresh, rac_model_info
         return copy_models_to_output(g_cached_models, out_models, out_count);
     }
 
-    // Need to fetch from backend
-    if (!g_callbacks.http_get) {
-        RAC_LOG_ERROR(LOG_CAT, "HTTP callback not set - cannot fetch models");
-        return RAC_ERROR_INVALID_STATE;
-    }
-
-    // Get endpoint path (no query params - backend uses JWT token for filtering)
-    const char* endpoint = rac_endpoint_model_assignments();
-
-    snprintf(msg, sizeof(msg), ">>> Making HTTP GET to: %s", endpoint);
-    RAC_LOG_INFO(LOG_CAT, msg);
-
-    // Make HTTP request
-    RAC_LOG_INFO(LOG_CAT, ">>> Calling http_get callback...");
-    rac_assignment_http_response_t response = {};
-    rac_result_t result =
-        g_callbacks.http_get(endpoint, RAC_TRUE, &response, g_callbacks.user_data);
-
-    snprintf(msg, sizeof(msg), "<<< http_get returned: result=%d, response.result=%d, status=%d, body_len=%zu",
-             result, response.result, response.status_code, response.response_length);
-    RAC_LOG_INFO(LOG_CAT, msg);
-
-    if (result != RAC_SUCCESS || response.result != RAC_SUCCESS) {
-        snprintf(msg, sizeof(msg), "HTTP request failed: result=%d, response.result=%d, error=%s",
-                 result, response.result,
-                 response.error_message ? response.error_message : "unknown error");
-        RAC_LOG_ERROR(LOG_CAT, msg);
-
-        // Return cached data as fallback
-        if (!g_cached_models.empty()) {
-            RAC_LOG_INFO(LOG_CAT, "Using cached models as fallback");
-            return copy_models_to_output(g_cached_models, out_models, out_count);
-        }
-
-        return result != RAC_SUCCESS ? result : response.result;
+    // A stale disk cache is served right away and revalidated in the background
+    if (!force_refresh && !g_cache_path.empty() && !g_cached_models.empty() &&
+        g_callbacks.http_get) {
+        queue_revalidation_locked();
+        snprintf(msg, sizeof(msg), "Returning stale model assignments (%zu models), revalidating",
+                 g_cached_models.size());
+        RAC_LOG_INFO(LOG_CAT, msg);
+        return copy_models_to_output(g_cached_models, out_models, out_count);
     }
 
-    if (response.status_code != 200) {
-        snprintf(msg, sizeof(msg), "HTTP %d: %s", response.status_code,
-                 response.error_message ? response.error_message : "request failed");
-        RAC_LOG_ERROR(LOG_CAT, msg);
-
+    rac_result_t result = fetch_from_backend_locked();
+    if (result != RAC_SUCCESS) {
         // Return cached data as fallback
         if (!g_cached_models.empty()) {
             RAC_LOG_INFO(LOG_CAT, "Using cached models as fallback");
             return copy_models_to_output(g_cached_models, out_models, out_count);
         }
-
-        return RAC_ERROR_HTTP_REQUEST_FAILED;
-    }
-
-    // Parse response
-    std::vector<rac_model_info_t*> models =
-        parse_models_json(response.response_body, response.response_length);
-    snprintf(msg, sizeof(msg), "Parsed %zu model assignments", models.size());
-    RAC_LOG_INFO(LOG_CAT, msg);
-
-    // Save to registry
-    rac_model_registry_handle_t registry = rac_get_model_registry();
-    if (registry) {
-        for (auto* model : models) {
-            rac_model_registry_save(registry, model);
-        }
-        RAC_LOG_DEBUG(LOG_CAT, "Saved models to registry");
-    }
-
-    // Update cache
-    clear_cache_internal();
-    for (auto* model : models) {
-        g_cached_models.push_back(rac_model_info_copy(model));
+        return result;
     }
-    g_last_fetch_time = std::chrono::steady_clock::now();
-    g_cache_valid = true;
 
-    // Copy to output (models vector will be freed, so we use cached copies)
     result = copy_models_to_output(g_cached_models, out_models, out_count);
 
-    // Cleanup temporary models
-    for (auto* model : models) {
-        rac_model_info_free(model);
-    }
-
     snprintf(msg, sizeof(msg), "Successfully fetched %zu model assignments", *out_count);
     RAC_LOG_INFO(LOG_CAT, msg);
 
     return result;
 }
 
+rac_result_t rac_model_assignment_get_cached(rac_model_info_t*** out_models, size_t* out_count) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return copy_models_to_output(g_cached_models, out_models, out_count);
+}
+
 rac_result_t rac_model_assignment_get_by_framework(rac_inference_framework_t framework,
                                                    rac_model_info_t*** out_models,
                                                    size_t* out_count) {
@@ -480,9 +894,22 @@ rac_result_t rac_model_assignment_get_by_category(rac_model_category_t category,
 void rac_model_assignment_clear_cache(void) {
     std::lock_guard<std::mutex> lock(g_mutex);
     clear_cache_internal();
+    if (!g_cache_path.empty()) {
+        unlink(g_cache_path.c_str());
+        unlink((g_cache_path + ".meta").c_str());
+    }
     RAC_LOG_DEBUG(LOG_CAT, "Model assignment cache cleared");
 }
 
+rac_result_t rac_model_assignment_set_cache_path(const char* path) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_cache_path = path ? path : "";
+    if (!g_cache_path.empty() && g_cached_models.empty()) {
+        load_disk_cache_locked();
+    }
+    return RAC_SUCCESS;
+}
+
 void rac_model_assignment_set_cache_timeout(uint32_t timeout_seconds) {
     std::lock_guard<std::mutex> lock(g_mutex);
     g_cache_timeout_seconds = timeout_seconds;
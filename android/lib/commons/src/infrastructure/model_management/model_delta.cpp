@@ -0,0 +1,602 @@
+/**
+ * @file model_delta.cpp
+ * @brief Delta Updates Between Model Revisions Implementation
+ *
+ * Chunking follows FastCDC: a gear hash over the bytes after the minimum
+ * size, a stricter cut mask before the average size and a looser one after
+ * it, so chunk sizes cluster around the average. The gear table comes from
+ * a fixed seed; manifests are only comparable between builds with the same
+ * chunking constants, which the manifest magic versions.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_logger.h"
+#include "rac/infrastructure/model_management/rac_model_delta.h"
+#include "rac/infrastructure/network/rac_http_client.h"
+
+namespace {
+
+const char* LOG_CAT = "ModelDelta";
+
+constexpr size_t kMinChunk = 16 * 1024;
+constexpr size_t kAverageChunk = 64 * 1024;
+constexpr size_t kMaxChunk = 256 * 1024;
+constexpr uint64_t kMaskStrict = 0xFFFFC00000000000ull;  // 18 bits: cuts are rarer
+constexpr uint64_t kMaskLoose = 0xFFFC000000000000ull;   // 14 bits: cuts are likelier
+
+// Adjacent missing chunks are fetched together, up to this many bytes
+constexpr int64_t kMaxRangeBytes = 8 * 1024 * 1024;
+constexpr int kRangeAttempts = 3;
+constexpr int32_t kRequestTimeoutMs = 60000;
+
+constexpr char kManifestMagic[8] = {'R', 'A', 'C', 'D', 'M', 'F', 'T', '1'};
+constexpr size_t kManifestHeaderSize = 8 + 8 + RAC_SHA256_DIGEST_SIZE + 8;
+constexpr size_t kManifestChunkSize = 4 + RAC_SHA256_DIGEST_SIZE;
+
+struct GearTable {
+    uint64_t values[256];
+    GearTable() {
+        uint64_t seed = 0x52414344454c5441ull;  // splitmix64
+        for (uint64_t& value : values) {
+            uint64_t z = (seed += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            value = z ^ (z >> 31);
+        }
+    }
+};
+
+const GearTable& gear() {
+    static const GearTable table;
+    return table;
+}
+
+// Length of the next chunk; size must be at least kMaxChunk unless at end of file
+size_t cut_point(const uint8_t* data, size_t size) {
+    if (size <= kMinChunk) {
+        return size;
+    }
+    const uint64_t* table = gear().values;
+    const size_t limit = std::min(size, kMaxChunk);
+    const size_t normal = std::min(limit, kAverageChunk);
+    uint64_t hash = 0;
+    size_t i = kMinChunk;
+    for (; i < normal; ++i) {
+        hash = (hash << 1) + table[data[i]];
+        if ((hash & kMaskStrict) == 0) {
+            return i + 1;
+        }
+    }
+    for (; i < limit; ++i) {
+        hash = (hash << 1) + table[data[i]];
+        if ((hash & kMaskLoose) == 0) {
+            return i + 1;
+        }
+    }
+    return limit;
+}
+
+bool read_fully(int fd, void* data, size_t size, int64_t offset, size_t* out_read) {
+    auto* bytes = static_cast<uint8_t*>(data);
+    size_t total = 0;
+    while (total < size) {
+        const ssize_t n =
+            pread(fd, bytes + total, size - total, static_cast<off_t>(offset + total));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        total += static_cast<size_t>(n);
+    }
+    *out_read = total;
+    return true;
+}
+
+bool write_all(int fd, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        const ssize_t n = ::write(fd, bytes, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        bytes += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void put_u64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t get_u64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+void sha256_of(const void* data, size_t size, uint8_t* out_digest) {
+    rac_sha256_t sha;
+    rac_sha256_init(&sha);
+    rac_sha256_update(&sha, data, size);
+    rac_sha256_final(&sha, out_digest);
+}
+
+rac_model_delta_manifest_t* new_manifest(size_t chunk_count) {
+    auto* manifest =
+        static_cast<rac_model_delta_manifest_t*>(rac_calloc_tagged(
+            RAC_ALLOC_TAG_MODEL, 1, sizeof(rac_model_delta_manifest_t)));
+    if (manifest && chunk_count > 0) {
+        manifest->chunks = static_cast<rac_model_delta_chunk_t*>(
+            rac_calloc_tagged(RAC_ALLOC_TAG_MODEL, chunk_count, sizeof(rac_model_delta_chunk_t)));
+        if (!manifest->chunks) {
+            rac_free(manifest);
+            return nullptr;
+        }
+    }
+    return manifest;
+}
+
+// =============================================================================
+// HTTP
+// =============================================================================
+
+/**
+ * Waits for one request to the platform executor. The response is only
+ * valid inside the callback, so on_response consumes it there.
+ */
+struct PendingRequest {
+    std::function<void(const rac_http_response_t&)> on_response;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+};
+
+void on_http_response(const rac_http_response_t* response, void* user_data) {
+    auto* pending = static_cast<PendingRequest*>(user_data);
+    if (response) {
+        pending->on_response(*response);
+    }
+    std::lock_guard<std::mutex> lock(pending->mutex);
+    pending->done = true;
+    pending->cv.notify_one();
+}
+
+rac_result_t http_get(const std::string& url, const char* range,
+                      std::function<rac_result_t(const rac_http_response_t&)> on_response) {
+    rac_http_request_t* request = rac_http_request_create(RAC_HTTP_GET, url.c_str());
+    if (!request) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    if (range) {
+        rac_http_request_add_header(request, "Range", range);
+        rac_http_request_add_header(request, "Accept-Encoding", "identity");
+    }
+    rac_http_request_set_timeout(request, kRequestTimeoutMs);
+
+    rac_result_t result = RAC_ERROR_NETWORK_ERROR;
+    PendingRequest pending;
+    pending.on_response = [&](const rac_http_response_t& response) {
+        result = on_response(response);
+    };
+    const bool started = rac_http_execute_raw(request, on_http_response, &pending);
+    if (started) {
+        std::unique_lock<std::mutex> lock(pending.mutex);
+        pending.cv.wait(lock, [&] { return pending.done; });
+    }
+    rac_http_request_free(request);
+    return started ? result : RAC_ERROR_HTTP_NOT_SUPPORTED;
+}
+
+rac_result_t status_error(const rac_http_response_t& response) {
+    if (response.status_code <= 0) {
+        RAC_LOG_ERROR(LOG_CAT, "Request failed: %s",
+                      response.error_message ? response.error_message : "no response");
+        return RAC_ERROR_NETWORK_ERROR;
+    }
+    RAC_LOG_ERROR(LOG_CAT, "Request failed: HTTP %d", response.status_code);
+    return RAC_ERROR_HTTP_ERROR;
+}
+
+// =============================================================================
+// ASSEMBLY
+// =============================================================================
+
+struct Assembly {
+    int old_fd = -1;
+    int out_fd = -1;
+    rac_sha256_t sha = {};
+    int64_t written = 0;
+    const rac_model_delta_manifest_t* manifest = nullptr;
+    rac_model_delta_progress_fn progress_callback = nullptr;
+    void* user_data = nullptr;
+    rac_model_delta_stats_t stats = {};
+
+    ~Assembly() {
+        if (old_fd >= 0) {
+            ::close(old_fd);
+        }
+        if (out_fd >= 0) {
+            ::close(out_fd);
+        }
+    }
+
+    rac_result_t append(const uint8_t* data, size_t size) {
+        if (!write_all(out_fd, data, size)) {
+            return errno == ENOSPC ? RAC_ERROR_STORAGE_FULL : RAC_ERROR_FILE_WRITE_FAILED;
+        }
+        rac_sha256_update(&sha, data, size);
+        written += static_cast<int64_t>(size);
+        if (progress_callback) {
+            progress_callback(written, manifest->file_size, user_data);
+        }
+        return RAC_SUCCESS;
+    }
+};
+
+// Fetches chunks [first, last] of the new file with one Range request
+rac_result_t fetch_chunks(Assembly& a, const std::string& url, size_t first, size_t last) {
+    const rac_model_delta_chunk_t* chunks = a.manifest->chunks;
+    const int64_t start = chunks[first].offset;
+    const int64_t length = chunks[last].offset + chunks[last].length - start;
+    char range[64];
+    snprintf(range, sizeof(range), "bytes=%lld-%lld", static_cast<long long>(start),
+             static_cast<long long>(start + length - 1));
+
+    rac_result_t result = RAC_ERROR_DOWNLOAD_FAILED;
+    for (int attempt = 1; attempt <= kRangeAttempts; ++attempt) {
+        result = http_get(url, range, [&](const rac_http_response_t& response) {
+            if (response.status_code != 206) {
+                return status_error(response);
+            }
+            if (static_cast<int64_t>(response.body_length) != length) {
+                RAC_LOG_ERROR(LOG_CAT, "Range %s returned %zu bytes", range, response.body_length);
+                return RAC_ERROR_PARTIAL_DOWNLOAD;
+            }
+            // Check every chunk before writing any of them
+            const auto* body = reinterpret_cast<const uint8_t*>(response.body);
+            uint8_t digest[RAC_SHA256_DIGEST_SIZE];
+            for (size_t i = first; i <= last; ++i) {
+                sha256_of(body + (chunks[i].offset - start), chunks[i].length, digest);
+                if (memcmp(digest, chunks[i].sha256, sizeof(digest)) != 0) {
+                    RAC_LOG_ERROR(LOG_CAT, "Chunk at %lld does not match the manifest",
+                                  static_cast<long long>(chunks[i].offset));
+                    return RAC_ERROR_CHECKSUM_MISMATCH;
+                }
+            }
+            return a.append(body, response.body_length);
+        });
+        // A bad write or a missing executor will not get better with a retry
+        if (result == RAC_SUCCESS || result == RAC_ERROR_STORAGE_FULL ||
+            result == RAC_ERROR_FILE_WRITE_FAILED || result == RAC_ERROR_HTTP_NOT_SUPPORTED) {
+            break;
+        }
+        RAC_LOG_WARNING(LOG_CAT, "Range %s failed, attempt %d of %d", range, attempt,
+                        kRangeAttempts);
+    }
+    if (result == RAC_SUCCESS) {
+        a.stats.fetched_bytes += length;
+        a.stats.fetched_chunks += static_cast<int32_t>(last - first + 1);
+    }
+    return result;
+}
+
+rac_result_t copy_chunk(Assembly& a, int64_t old_offset, const rac_model_delta_chunk_t& chunk,
+                        std::vector<uint8_t>& buffer) {
+    buffer.resize(static_cast<size_t>(chunk.length));
+    size_t got = 0;
+    if (!read_fully(a.old_fd, buffer.data(), buffer.size(), old_offset, &got) ||
+        got != buffer.size()) {
+        return RAC_ERROR_FILE_READ_FAILED;
+    }
+    a.stats.reused_bytes += chunk.length;
+    a.stats.reused_chunks++;
+    return a.append(buffer.data(), buffer.size());
+}
+
+}  // namespace
+
+// =============================================================================
+// MANIFEST API
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_model_delta_manifest_create(const char* file_path,
+                                             rac_model_delta_manifest_t** out_manifest) {
+    if (!file_path || !out_manifest) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    const int fd = ::open(file_path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        RAC_LOG_ERROR(LOG_CAT, "Cannot open %s: %s", file_path, strerror(errno));
+        return RAC_ERROR_FILE_NOT_FOUND;
+    }
+
+    std::vector<rac_model_delta_chunk_t> chunks;
+    std::vector<uint8_t> buffer(4 * kMaxChunk);
+    rac_sha256_t file_sha;
+    rac_sha256_init(&file_sha);
+    int64_t file_offset = 0;  // Offset of buffer[start]
+    size_t start = 0;
+    size_t end = 0;
+    bool eof = false;
+    rac_result_t result = RAC_SUCCESS;
+
+    while (true) {
+        // Keep a full maximum-size chunk in view so cut points do not depend on reads
+        if (!eof && end - start < kMaxChunk) {
+            memmove(buffer.data(), buffer.data() + start, end - start);
+            end -= start;
+            start = 0;
+            size_t got = 0;
+            if (!read_fully(fd, buffer.data() + end, buffer.size() - end, file_offset + end,
+                            &got)) {
+                result = RAC_ERROR_FILE_READ_FAILED;
+                break;
+            }
+            eof = got < buffer.size() - end;
+            end += got;
+        }
+        if (start == end) {
+            break;
+        }
+        const size_t length = cut_point(buffer.data() + start, end - start);
+        rac_model_delta_chunk_t chunk = {};
+        chunk.offset = file_offset;
+        chunk.length = static_cast<int32_t>(length);
+        sha256_of(buffer.data() + start, length, chunk.sha256);
+        rac_sha256_update(&file_sha, buffer.data() + start, length);
+        chunks.push_back(chunk);
+        start += length;
+        file_offset += static_cast<int64_t>(length);
+    }
+    ::close(fd);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+
+    rac_model_delta_manifest_t* manifest = new_manifest(chunks.size());
+    if (!manifest) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    manifest->file_size = file_offset;
+    rac_sha256_final(&file_sha, manifest->sha256);
+    if (!chunks.empty()) {
+        memcpy(manifest->chunks, chunks.data(), chunks.size() * sizeof(chunks[0]));
+    }
+    manifest->chunk_count = chunks.size();
+    *out_manifest = manifest;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_model_delta_manifest_save(const rac_model_delta_manifest_t* manifest,
+                                           const char* path) {
+    if (!manifest || !path) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    // Little-endian: magic, file size, file SHA-256, chunk count, then per
+    // chunk its length and SHA-256 (offsets follow from the lengths)
+    std::vector<uint8_t> data(kManifestHeaderSize + manifest->chunk_count * kManifestChunkSize);
+    uint8_t* out = data.data();
+    memcpy(out, kManifestMagic, sizeof(kManifestMagic));
+    put_u64(out + 8, static_cast<uint64_t>(manifest->file_size));
+    memcpy(out + 16, manifest->sha256, RAC_SHA256_DIGEST_SIZE);
+    put_u64(out + 16 + RAC_SHA256_DIGEST_SIZE, manifest->chunk_count);
+    out += kManifestHeaderSize;
+    for (size_t i = 0; i < manifest->chunk_count; ++i, out += kManifestChunkSize) {
+        const uint32_t length = static_cast<uint32_t>(manifest->chunks[i].length);
+        for (int b = 0; b < 4; ++b) {
+            out[b] = static_cast<uint8_t>(length >> (8 * b));
+        }
+        memcpy(out + 4, manifest->chunks[i].sha256, RAC_SHA256_DIGEST_SIZE);
+    }
+
+    const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+    const bool ok = write_all(fd, data.data(), data.size());
+    ::close(fd);
+    return ok ? RAC_SUCCESS : RAC_ERROR_FILE_WRITE_FAILED;
+}
+
+rac_result_t rac_model_delta_manifest_parse(const void* data, size_t size,
+                                            rac_model_delta_manifest_t** out_manifest) {
+    if (!data || !out_manifest) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    const auto* in = static_cast<const uint8_t*>(data);
+    if (size < kManifestHeaderSize || memcmp(in, kManifestMagic, sizeof(kManifestMagic)) != 0) {
+        RAC_LOG_ERROR(LOG_CAT, "Not a delta manifest");
+        return RAC_ERROR_INVALID_FORMAT;
+    }
+    const uint64_t file_size = get_u64(in + 8);
+    const uint64_t chunk_count = get_u64(in + 16 + RAC_SHA256_DIGEST_SIZE);
+    if (chunk_count > (size - kManifestHeaderSize) / kManifestChunkSize ||
+        size != kManifestHeaderSize + chunk_count * kManifestChunkSize) {
+        RAC_LOG_ERROR(LOG_CAT, "Delta manifest is truncated");
+        return RAC_ERROR_INVALID_FORMAT;
+    }
+
+    rac_model_delta_manifest_t* manifest = new_manifest(static_cast<size_t>(chunk_count));
+    if (!manifest) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    memcpy(manifest->sha256, in + 16, RAC_SHA256_DIGEST_SIZE);
+    manifest->file_size = static_cast<int64_t>(file_size);
+    manifest->chunk_count = static_cast<size_t>(chunk_count);
+
+    int64_t offset = 0;
+    const uint8_t* record = in + kManifestHeaderSize;
+    for (size_t i = 0; i < manifest->chunk_count; ++i, record += kManifestChunkSize) {
+        const uint32_t length = static_cast<uint32_t>(record[0]) |
+                                (static_cast<uint32_t>(record[1]) << 8) |
+                                (static_cast<uint32_t>(record[2]) << 16) |
+                                (static_cast<uint32_t>(record[3]) << 24);
+        if (length == 0 || length > kMaxChunk) {
+            rac_model_delta_manifest_free(manifest);
+            return RAC_ERROR_INVALID_FORMAT;
+        }
+        manifest->chunks[i].offset = offset;
+        manifest->chunks[i].length = static_cast<int32_t>(length);
+        memcpy(manifest->chunks[i].sha256, record + 4, RAC_SHA256_DIGEST_SIZE);
+        offset += length;
+    }
+    if (offset != manifest->file_size) {
+        RAC_LOG_ERROR(LOG_CAT, "Delta manifest chunks do not add up to the file size");
+        rac_model_delta_manifest_free(manifest);
+        return RAC_ERROR_INVALID_FORMAT;
+    }
+    *out_manifest = manifest;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_model_delta_manifest_fetch(const char* url,
+                                            rac_model_delta_manifest_t** out_manifest) {
+    if (!url || !out_manifest) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    return http_get(url, nullptr, [&](const rac_http_response_t& response) {
+        if (response.status_code != 200) {
+            return status_error(response);
+        }
+        return rac_model_delta_manifest_parse(response.body, response.body_length, out_manifest);
+    });
+}
+
+void rac_model_delta_manifest_free(rac_model_delta_manifest_t* manifest) {
+    if (!manifest) {
+        return;
+    }
+    rac_free(manifest->chunks);
+    rac_free(manifest);
+}
+
+// =============================================================================
+// UPDATE API
+// =============================================================================
+
+rac_result_t rac_model_delta_update(const char* old_path,
+                                    const rac_model_delta_manifest_t* manifest,
+                                    const char* new_url, const char* destination_path,
+                                    rac_model_delta_progress_fn progress_callback,
+                                    void* user_data, rac_model_delta_stats_t* out_stats) {
+    if (!old_path || !manifest || !new_url || !destination_path) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Index the chunks of the old revision by digest
+    rac_model_delta_manifest_t* old_manifest = nullptr;
+    rac_result_t result = rac_model_delta_manifest_create(old_path, &old_manifest);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+    std::unordered_map<std::string, int64_t> old_chunks;
+    for (size_t i = 0; i < old_manifest->chunk_count; ++i) {
+        const rac_model_delta_chunk_t& chunk = old_manifest->chunks[i];
+        old_chunks.emplace(std::string(reinterpret_cast<const char*>(chunk.sha256),
+                                       RAC_SHA256_DIGEST_SIZE),
+                           chunk.offset);
+    }
+    rac_model_delta_manifest_free(old_manifest);
+
+    const std::string part_path = std::string(destination_path) + ".part";
+    Assembly a;
+    a.manifest = manifest;
+    a.progress_callback = progress_callback;
+    a.user_data = user_data;
+    rac_sha256_init(&a.sha);
+    a.old_fd = ::open(old_path, O_RDONLY | O_CLOEXEC);
+    a.out_fd = ::open(part_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (a.old_fd < 0 || a.out_fd < 0) {
+        RAC_LOG_ERROR(LOG_CAT, "Cannot open %s: %s", part_path.c_str(), strerror(errno));
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+
+    auto find_old = [&](size_t index) {
+        return old_chunks.find(std::string(
+            reinterpret_cast<const char*>(manifest->chunks[index].sha256), RAC_SHA256_DIGEST_SIZE));
+    };
+    std::vector<uint8_t> buffer;
+    const std::string url = new_url;
+    for (size_t i = 0; i < manifest->chunk_count && result == RAC_SUCCESS;) {
+        auto it = find_old(i);
+        if (it != old_chunks.end()) {
+            result = copy_chunk(a, it->second, manifest->chunks[i], buffer);
+            ++i;
+            continue;
+        }
+        // Extend the request over the following missing chunks
+        const int64_t start = manifest->chunks[i].offset;
+        size_t last = i;
+        while (last + 1 < manifest->chunk_count &&
+               manifest->chunks[last + 1].offset + manifest->chunks[last + 1].length - start <=
+                   kMaxRangeBytes &&
+               find_old(last + 1) == old_chunks.end()) {
+            ++last;
+        }
+        result = fetch_chunks(a, url, i, last);
+        i = last + 1;
+    }
+
+    if (result == RAC_SUCCESS) {
+        uint8_t digest[RAC_SHA256_DIGEST_SIZE];
+        rac_sha256_final(&a.sha, digest);
+        if (a.written != manifest->file_size ||
+            memcmp(digest, manifest->sha256, sizeof(digest)) != 0) {
+            RAC_LOG_ERROR(LOG_CAT, "Assembled file does not match the manifest");
+            result = RAC_ERROR_CHECKSUM_MISMATCH;
+        } else if (fsync(a.out_fd) != 0) {
+            result = RAC_ERROR_FILE_WRITE_FAILED;
+        }
+    }
+    ::close(a.out_fd);
+    a.out_fd = -1;
+
+    if (result == RAC_SUCCESS && rename(part_path.c_str(), destination_path) != 0) {
+        result = RAC_ERROR_FILE_WRITE_FAILED;
+    }
+    if (result != RAC_SUCCESS) {
+        unlink(part_path.c_str());
+        return result;
+    }
+
+    RAC_LOG_INFO(LOG_CAT, "Delta update reused %lld bytes, fetched %lld of %lld",
+                 static_cast<long long>(a.stats.reused_bytes),
+                 static_cast<long long>(a.stats.fetched_bytes),
+                 static_cast<long long>(manifest->file_size));
+    if (out_stats) {
+        *out_stats = a.stats;
+    }
+    return RAC_SUCCESS;
+}
+
+}  // extern "C"
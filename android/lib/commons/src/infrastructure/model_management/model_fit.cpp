@@ -0,0 +1,468 @@
+/**
+ * @file model_fit.cpp
+ * @brief Memory Fit Prediction Implementation
+ *
+ * The estimate mirrors what llama.cpp allocates for a context: the weights
+ * (mapped, so they count against the working set), a K and a V row per layer
+ * and token, compute buffers sized by the batch (logits plus the attention
+ * scores of one batch against the whole context), and a fixed runtime
+ * overhead. Everything but the weights grows linearly with the context,
+ * which gives the longest context that fits in closed form.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rac/core/rac_logger.h"
+#include "rac/core/rac_platform_adapter.h"
+#include "rac/infrastructure/device/rac_device_manager.h"
+#include "rac/infrastructure/model_management/rac_model_fit.h"
+#include "rac/infrastructure/network/rac_http_client.h"
+
+#include "gguf_reader.h"
+
+namespace {
+
+const char* LOG_CAT = "ModelFit";
+
+// Headers are read in growing prefixes; vocabularies make them a few MB
+constexpr size_t kFirstHeaderBytes = 2 * 1024 * 1024;
+constexpr size_t kMaxHeaderBytes = 64 * 1024 * 1024;
+constexpr int32_t kRequestTimeoutMs = 60000;
+
+constexpr int32_t kDefaultContext = 4096;
+constexpr int32_t kContextStep = 256;
+constexpr int64_t kRuntimeOverheadBytes = 64 * 1024 * 1024;
+
+// ONNX Runtime arenas and activations, as a share of the weights
+constexpr double kOnnxWorkspaceFactor = 0.25;
+
+
+// =============================================================================
+// FILES
+// =============================================================================
+
+
+bool read_at(int fd, uint8_t* data, size_t size, off_t offset) {
+    while (size > 0) {
+        const ssize_t n = pread(fd, data, size, offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+        offset += n;
+    }
+    return true;
+}
+
+// Models that are not GGUF are estimated from their size
+void size_only_profile(const std::string& path, int64_t file_size,
+                       rac_model_memory_profile_t* out_profile) {
+    *out_profile = {};
+    out_profile->format = rac::gguf::ends_with(path, ".onnx")  ? RAC_MODEL_FORMAT_ONNX
+                          : rac::gguf::ends_with(path, ".ort") ? RAC_MODEL_FORMAT_ORT
+                                                               : RAC_MODEL_FORMAT_UNKNOWN;
+    out_profile->file_size = file_size;
+    out_profile->weights_bytes = file_size;
+}
+
+// =============================================================================
+// HTTP
+// =============================================================================
+
+/**
+ * Waits for one request to the platform executor. The response is only
+ * valid inside the callback, so on_response consumes it there.
+ */
+struct PendingRequest {
+    std::function<void(const rac_http_response_t&)> on_response;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+};
+
+void on_http_response(const rac_http_response_t* response, void* user_data) {
+    auto* pending = static_cast<PendingRequest*>(user_data);
+    if (response) {
+        pending->on_response(*response);
+    }
+    std::lock_guard<std::mutex> lock(pending->mutex);
+    pending->done = true;
+    pending->cv.notify_one();
+}
+
+rac_result_t http_get_range(const char* url, size_t first, size_t last,
+                            std::function<rac_result_t(const rac_http_response_t&)> on_response) {
+    rac_http_request_t* request = rac_http_request_create(RAC_HTTP_GET, url);
+    if (!request) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    char range[64];
+    snprintf(range, sizeof(range), "bytes=%zu-%zu", first, last);
+    rac_http_request_add_header(request, "Range", range);
+    rac_http_request_add_header(request, "Accept-Encoding", "identity");
+    rac_http_request_set_timeout(request, kRequestTimeoutMs);
+
+    rac_result_t result = RAC_ERROR_NETWORK_ERROR;
+    PendingRequest pending;
+    pending.on_response = [&](const rac_http_response_t& response) {
+        result = on_response(response);
+    };
+    const bool started = rac_http_execute_raw(request, on_http_response, &pending);
+    if (started) {
+        std::unique_lock<std::mutex> lock(pending.mutex);
+        pending.cv.wait(lock, [&] { return pending.done; });
+    }
+    rac_http_request_free(request);
+    return started ? result : RAC_ERROR_HTTP_NOT_SUPPORTED;
+}
+
+// Total size from "Content-Range: bytes 0-99/12345"; 0 if absent or "*"
+int64_t content_range_total(const rac_http_response_t& response) {
+    for (size_t i = 0; i < response.header_count; ++i) {
+        const rac_http_header_t& header = response.headers[i];
+        if (header.key && header.value && strcasecmp(header.key, "Content-Range") == 0) {
+            const char* slash = strchr(header.value, '/');
+            return slash && slash[1] >= '0' && slash[1] <= '9' ? strtoll(slash + 1, nullptr, 10)
+                                                               : 0;
+        }
+    }
+    return 0;
+}
+
+// =============================================================================
+// ESTIMATE
+// =============================================================================
+
+double kv_element_bytes(rac_kv_cache_type_t type) {
+    switch (type) {
+        case RAC_KV_CACHE_F32:
+            return 4.0;
+        case RAC_KV_CACHE_Q8_0:
+            return 34.0 / 32.0;
+        case RAC_KV_CACHE_Q4_0:
+            return 18.0 / 32.0;
+        case RAC_KV_CACHE_F16:
+        default:
+            return 2.0;
+    }
+}
+
+const char* fit_name(rac_model_fit_t fit) {
+    switch (fit) {
+        case RAC_MODEL_FIT_OK:
+            return "fits";
+        case RAC_MODEL_FIT_TIGHT:
+            return "tight";
+        case RAC_MODEL_FIT_TOO_LARGE:
+            return "too large";
+        default:
+            return "unknown";
+    }
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API - PROFILES
+// =============================================================================
+
+rac_result_t rac_model_memory_profile_parse_gguf(const void* data, size_t size,
+                                                 int64_t file_size,
+                                                 rac_model_memory_profile_t* out_profile) {
+    if (!data || !out_profile) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    rac::gguf::Metadata meta;
+    const rac_result_t result =
+        rac::gguf::parse(static_cast<const uint8_t*>(data), size, file_size, &meta);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+    rac::gguf::to_memory_profile(meta, file_size, out_profile);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_model_memory_profile_read_file(const char* path,
+                                                rac_model_memory_profile_t* out_profile) {
+    if (!path || !out_profile) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::string file = path;
+    struct stat st = {};
+    if (stat(file.c_str(), &st) != 0) {
+        return RAC_ERROR_FILE_NOT_FOUND;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        file = rac::gguf::find_model_file(file);
+        if (file.empty() || stat(file.c_str(), &st) != 0) {
+            return RAC_ERROR_FILE_NOT_FOUND;
+        }
+    }
+
+    const int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return RAC_ERROR_FILE_READ_FAILED;
+    }
+    const auto file_size = static_cast<int64_t>(st.st_size);
+
+    uint32_t magic = 0;
+    const bool is_gguf = file_size >= 4 &&
+                         read_at(fd, reinterpret_cast<uint8_t*>(&magic), 4, 0) &&
+                         magic == rac::gguf::kMagic;
+    ::close(fd);
+    if (!is_gguf) {
+        size_only_profile(file, file_size, out_profile);
+        return RAC_SUCCESS;
+    }
+
+    // Mapped rather than read so only the header pages come off disk
+    rac::gguf::Metadata meta;
+    const rac_result_t result = rac::gguf::read_file(file.c_str(), &meta);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+    rac::gguf::to_memory_profile(meta, file_size, out_profile);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_model_memory_profile_fetch(const char* url,
+                                            rac_model_memory_profile_t* out_profile) {
+    if (!url || !out_profile) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::vector<uint8_t> header;
+    int64_t file_size = 0;
+    bool complete = false;
+    rac_result_t result = RAC_ERROR_BUFFER_TOO_SMALL;
+    size_t want = kFirstHeaderBytes;
+    while (result == RAC_ERROR_BUFFER_TOO_SMALL && !complete && want <= kMaxHeaderBytes) {
+        const size_t have = header.size();
+        result = http_get_range(url, have, want - 1, [&](const rac_http_response_t& response) {
+            if (response.status_code == 200) {
+                // Range ignored: the body is the whole file
+                header.assign(response.body, response.body + response.body_length);
+                file_size = static_cast<int64_t>(response.body_length);
+                complete = true;
+            } else if (response.status_code == 206) {
+                header.insert(header.end(), response.body, response.body + response.body_length);
+                file_size = content_range_total(response);
+                complete = response.body_length < want - have;
+            } else if (response.status_code == 416) {
+                complete = true;  // The file ends before the requested range
+            } else {
+                RAC_LOG_ERROR(LOG_CAT, "Header request failed: HTTP %d", response.status_code);
+                return response.status_code > 0 ? RAC_ERROR_HTTP_ERROR : RAC_ERROR_NETWORK_ERROR;
+            }
+            return RAC_SUCCESS;
+        });
+        if (result != RAC_SUCCESS) {
+            return result;
+        }
+        result = rac_model_memory_profile_parse_gguf(header.data(), header.size(), file_size,
+                                                     out_profile);
+        want *= 4;
+    }
+    return result == RAC_ERROR_BUFFER_TOO_SMALL ? RAC_ERROR_INVALID_FORMAT : result;
+}
+
+rac_result_t rac_model_memory_profile_from_info(const rac_model_info_t* model,
+                                                rac_model_memory_profile_t* out_profile) {
+    if (!model || !out_profile) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    // memory_required, when published, already includes the runtime's own needs
+    const int64_t weights = std::max(model->download_size, model->memory_required);
+    if (weights <= 0) {
+        return RAC_ERROR_NOT_SUPPORTED;
+    }
+
+    *out_profile = {};
+    out_profile->format = model->format;
+    out_profile->file_size = model->download_size;
+    out_profile->weights_bytes = weights;
+    out_profile->trained_context_length = model->context_length;
+    return RAC_SUCCESS;
+}
+
+// =============================================================================
+// PUBLIC API - FIT
+// =============================================================================
+
+rac_result_t rac_model_fit_estimate(const rac_model_memory_profile_t* profile,
+                                    const rac_model_fit_config_t* config, int64_t total_memory,
+                                    int64_t available_memory, rac_model_fit_result_t* out_result) {
+    if (!profile || !out_result) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    rac_model_fit_config_t cfg = config ? *config : RAC_MODEL_FIT_CONFIG_DEFAULT;
+    if (cfg.batch_size <= 0) {
+        cfg.batch_size = RAC_MODEL_FIT_CONFIG_DEFAULT.batch_size;
+    }
+    if (cfg.max_memory_fraction <= 0.0f || cfg.max_memory_fraction > 1.0f) {
+        cfg.max_memory_fraction = RAC_MODEL_FIT_CONFIG_DEFAULT.max_memory_fraction;
+    }
+    const int32_t trained = profile->trained_context_length;
+    const int32_t context = cfg.context_length > 0 ? cfg.context_length
+                            : trained > 0          ? std::min(trained, kDefaultContext)
+                                                   : kDefaultContext;
+
+    // Memory that does not depend on the context, and what each token of it adds
+    double fixed = static_cast<double>(profile->weights_bytes + kRuntimeOverheadBytes);
+    double kv_per_token = 0.0;
+    double scores_per_token = 0.0;
+    if (profile->format != RAC_MODEL_FORMAT_GGUF) {
+        fixed += static_cast<double>(profile->weights_bytes) * kOnnxWorkspaceFactor;
+    } else if (profile->layer_count > 0) {
+        const double batch = cfg.batch_size;
+        fixed += batch * (profile->vocab_size + 4.0 * profile->embedding_length) * 4.0;
+        kv_per_token = static_cast<double>(profile->layer_count) * profile->head_count_kv *
+                       (profile->key_length + profile->value_length) *
+                       kv_element_bytes(cfg.kv_type);
+        // F32 attention scores of one batch against the context
+        scores_per_token = batch * profile->head_count * 4.0;
+    }
+    const double per_token = kv_per_token + scores_per_token;
+
+    rac_model_fit_result_t result = {};
+    result.context_length = context;
+    result.weights_bytes = profile->weights_bytes;
+    result.kv_cache_bytes = static_cast<int64_t>(kv_per_token * context);
+    result.total_bytes = static_cast<int64_t>(fixed + per_token * context);
+    result.compute_bytes = result.total_bytes - result.weights_bytes - result.kv_cache_bytes;
+    result.budget_bytes =
+        total_memory > 0 ? static_cast<int64_t>(total_memory * cfg.max_memory_fraction) : 0;
+    result.available_bytes = available_memory > 0 ? available_memory : 0;
+
+    if (result.budget_bytes == 0) {
+        result.fit = RAC_MODEL_FIT_UNKNOWN;
+    } else if (result.total_bytes > result.budget_bytes) {
+        result.fit = RAC_MODEL_FIT_TOO_LARGE;
+    } else if (result.available_bytes > 0 && result.total_bytes > result.available_bytes) {
+        result.fit = RAC_MODEL_FIT_TIGHT;
+    } else {
+        result.fit = RAC_MODEL_FIT_OK;
+    }
+
+    if (result.budget_bytes > 0) {
+        const double limit = static_cast<double>(
+            result.available_bytes > 0 ? std::min(result.budget_bytes, result.available_bytes)
+                                       : result.budget_bytes);
+        double longest = 0.0;
+        if (limit >= fixed) {
+            longest = per_token > 0.0 ? (limit - fixed) / per_token : INT32_MAX;
+        }
+        if (trained > 0) {
+            longest = std::min(longest, static_cast<double>(trained));
+        } else if (per_token == 0.0 && longest > 0.0) {
+            longest = context;
+        }
+        const auto steps = static_cast<int64_t>(longest) / kContextStep;
+        result.max_context_length = static_cast<int32_t>(steps * kContextStep);
+    }
+
+    *out_result = result;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_model_fit_check(const rac_model_info_t* model,
+                                 const rac_model_fit_config_t* config,
+                                 rac_model_fit_result_t* out_result) {
+    if (!model || !out_result) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    rac_model_memory_profile_t profile = {};
+    rac_result_t result = RAC_ERROR_NOT_FOUND;
+    if (model->local_path && model->local_path[0] != '\0') {
+        result = rac_model_memory_profile_read_file(model->local_path, &profile);
+    }
+    if (result != RAC_SUCCESS && model->format == RAC_MODEL_FORMAT_GGUF && model->download_url) {
+        result = rac_model_memory_profile_fetch(model->download_url, &profile);
+    }
+    if (result != RAC_SUCCESS) {
+        RAC_LOG_DEBUG(LOG_CAT, "No header for %s, estimating from metadata", model->id);
+        result = rac_model_memory_profile_from_info(model, &profile);
+        if (result != RAC_SUCCESS) {
+            return result;
+        }
+    }
+    if (profile.trained_context_length == 0) {
+        profile.trained_context_length = model->context_length;
+    }
+
+    int64_t total_memory = 0;
+    int64_t available_memory = 0;
+    if (rac_device_manager_get_memory(&total_memory, &available_memory) != RAC_SUCCESS) {
+        total_memory = 0;
+        available_memory = 0;
+    }
+
+    result = rac_model_fit_estimate(&profile, config, total_memory, available_memory, out_result);
+    if (result == RAC_SUCCESS) {
+        RAC_LOG_INFO(LOG_CAT, "%s needs %lld MB at %d tokens: %s", model->id,
+                     static_cast<long long>(out_result->total_bytes / (1024 * 1024)),
+                     out_result->context_length, fit_name(out_result->fit));
+    }
+    return result;
+}
+
+rac_result_t rac_model_fit_select_variant(rac_model_registry_handle_t registry,
+                                          const char* model_id,
+                                          const rac_model_fit_config_t* config,
+                                          char** out_model_id, rac_model_fit_result_t* out_result) {
+    if (!registry || !model_id || !out_model_id) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    *out_model_id = nullptr;
+
+    rac_model_info_t** variants = nullptr;
+    size_t count = 0;
+    rac_result_t result = rac_model_registry_get_variants(registry, model_id, &variants, &count);
+    if (result != RAC_SUCCESS) {
+        return result;
+    }
+
+    result = RAC_ERROR_INSUFFICIENT_MEMORY;
+    for (size_t i = 0; i < count; ++i) {
+        rac_model_fit_result_t fit = {};
+        if (rac_model_fit_check(variants[i], config, &fit) != RAC_SUCCESS) {
+            continue;
+        }
+        if (fit.fit == RAC_MODEL_FIT_OK || fit.fit == RAC_MODEL_FIT_UNKNOWN) {
+            *out_model_id = rac_strdup(variants[i]->id);
+            if (out_result) {
+                *out_result = fit;
+            }
+            result = *out_model_id ? RAC_SUCCESS : RAC_ERROR_OUT_OF_MEMORY;
+            break;
+        }
+    }
+    rac_model_info_array_free(variants, count);
+
+    if (result == RAC_ERROR_INSUFFICIENT_MEMORY) {
+        RAC_LOG_WARNING(LOG_CAT, "No variant of %s fits this device", model_id);
+    }
+    return result;
+}
@@ -7,13 +7,19 @@
  *
  * IMPORTANT: This is a direct translation of the Swift implementation.
  * Do NOT add features not present in the Swift code.
+ *
+ * Paths are resolved per inference (telemetry, loading), so they are composed
+ * straight into the caller's buffer from prefixes built once in
+ * rac_model_paths_set_base_dir, and paths are analyzed in place; lookups do
+ * not allocate.
  */
 
 #include <cstdio>
 #include <cstring>
+#include <initializer_list>
 #include <mutex>
 #include <string>
-#include <vector>
+#include <string_view>
 
 #include "rac/core/rac_logger.h"
 #include "rac/infrastructure/model_management/rac_model_paths.h"
@@ -24,6 +30,8 @@
 
 static std::mutex g_paths_mutex{};
 static std::string g_base_dir{};
+static std::string g_root_dir{};    // {base_dir}/RunAnywhere
+static std::string g_models_dir{};  // {base_dir}/RunAnywhere/Models/
 
 // =============================================================================
 // CONFIGURATION
@@ -41,6 +49,8 @@ rac_result_t rac_model_paths_set_base_dir(const char* base_dir) {
     while (!g_base_dir.empty() && (g_base_dir.back() == '/' || g_base_dir.back() == '\\')) {
         g_base_dir.pop_back();
     }
+    g_root_dir = g_base_dir + "/RunAnywhere";
+    g_models_dir = g_root_dir + "/Models/";
 
     return RAC_SUCCESS;
 }
@@ -54,38 +64,58 @@ const char* rac_model_paths_get_base_dir(void) {
 // HELPER FUNCTIONS
 // =============================================================================
 
-static rac_result_t copy_string_to_buffer(const std::string& src, char* out_path,
-                                          size_t path_size) {
+// Writes the concatenation of parts to out_path, or nothing if it does not fit
+static rac_result_t join_to_buffer(std::initializer_list<std::string_view> parts, char* out_path,
+                                   size_t path_size) {
     if (!out_path || path_size == 0) {
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    if (src.length() >= path_size) {
+    size_t length = 0;
+    for (std::string_view part : parts) {
+        length += part.size();
+    }
+    if (length >= path_size) {
         return RAC_ERROR_BUFFER_TOO_SMALL;
     }
 
-    strncpy(out_path, src.c_str(), path_size - 1);
-    out_path[path_size - 1] = '\0';
+    char* p = out_path;
+    for (std::string_view part : parts) {
+        memcpy(p, part.data(), part.size());
+        p += part.size();
+    }
+    *p = '\0';
     return RAC_SUCCESS;
 }
 
-static std::vector<std::string> split_path(const std::string& path) {
-    std::vector<std::string> components;
+// Finds the components after the first "Models" component of path (after is
+// empty if there is only one). Separators are '/' or '\\'.
+static bool find_models_components(std::string_view path, std::string_view* out_next,
+                                   std::string_view* out_after) {
+    *out_next = std::string_view();
+    *out_after = std::string_view();
+    int seen = -1;  // Components seen after "Models"; -1 until it is found
     size_t start = 0;
-    size_t end = 0;
-
-    while ((end = path.find_first_of("/\\", start)) != std::string::npos) {
+    while (start < path.size()) {
+        size_t end = path.find_first_of("/\\", start);
+        if (end == std::string_view::npos) {
+            end = path.size();
+        }
         if (end > start) {
-            components.push_back(path.substr(start, end - start));
+            const std::string_view component = path.substr(start, end - start);
+            if (seen < 0) {
+                seen = component == "Models" ? 0 : -1;
+            } else if (seen == 0) {
+                *out_next = component;
+                seen = 1;
+            } else {
+                *out_after = component;
+                return true;
+            }
         }
         start = end + 1;
     }
-
-    if (start < path.length()) {
-        components.push_back(path.substr(start));
-    }
-
-    return components;
+    return seen > 0;
 }
 
 // =============================================================================
@@ -130,8 +160,7 @@ rac_result_t rac_model_paths_get_base_directory(char* out_path, size_t path_size
         return RAC_ERROR_NOT_INITIALIZED;
     }
 
-    std::string path = g_base_dir + "/RunAnywhere";
-    return copy_string_to_buffer(path, out_path, path_size);
+    return join_to_buffer({g_root_dir}, out_path, path_size);
 }
 
 rac_result_t rac_model_paths_get_models_directory(char* out_path, size_t path_size) {
@@ -144,8 +173,8 @@ rac_result_t rac_model_paths_get_models_directory(char* out_path, size_t path_si
         return RAC_ERROR_NOT_INITIALIZED;
     }
 
-    std::string path = g_base_dir + "/RunAnywhere/Models";
-    return copy_string_to_buffer(path, out_path, path_size);
+    const std::string_view models_dir = g_models_dir;
+    return join_to_buffer({models_dir.substr(0, models_dir.size() - 1)}, out_path, path_size);
 }
 
 // =============================================================================
@@ -163,8 +192,7 @@ rac_result_t rac_model_paths_get_framework_directory(rac_inference_framework_t f
         return RAC_ERROR_NOT_INITIALIZED;
     }
 
-    std::string path = g_base_dir + "/RunAnywhere/Models/" + rac_framework_raw_value(framework);
-    return copy_string_to_buffer(path, out_path, path_size);
+    return join_to_buffer({g_models_dir, rac_framework_raw_value(framework)}, out_path, path_size);
 }
 
 rac_result_t rac_model_paths_get_model_folder(const char* model_id,
@@ -183,9 +211,8 @@ rac_result_t rac_model_paths_get_model_folder(const char* model_id,
         return RAC_ERROR_NOT_INITIALIZED;
     }
 
-    std::string path =
-        g_base_dir + "/RunAnywhere/Models/" + rac_framework_raw_value(framework) + "/" + model_id;
-    return copy_string_to_buffer(path, out_path, path_size);
+    return join_to_buffer({g_models_dir, rac_framework_raw_value(framework), "/", model_id},
+                          out_path, path_size);
 }
 
 // =============================================================================
@@ -210,9 +237,9 @@ rac_result_t rac_model_paths_get_model_file_path(const char* model_id,
         return RAC_ERROR_NOT_INITIALIZED;
     }
 
-    std::string path = g_base_dir + "/RunAnywhere/Models/" + rac_framework_raw_value(framework) +
-                       "/" + model_id + "/" + model_id + "." + rac_model_format_extension(format);
-    return copy_string_to_buffer(path, out_path, path_size);
+    return join_to_buffer({g_models_dir, rac_framework_raw_value(framework), "/", model_id, "/",
+                           model_id, ".", rac_model_format_extension(format)},
+                          out_path, path_size);
 }
 
 rac_result_t rac_model_paths_get_expected_model_path(const char* model_id,
@@ -262,8 +289,7 @@ rac_result_t rac_model_paths_get_cache_directory(char* out_path, size_t path_siz
         return RAC_ERROR_NOT_INITIALIZED;
     }
 
-    std::string path = g_base_dir + "/RunAnywhere/Cache";
-    return copy_string_to_buffer(path, out_path, path_size);
+    return join_to_buffer({g_root_dir, "/Cache"}, out_path, path_size);
 }
 
 rac_result_t rac_model_paths_get_temp_directory(char* out_path, size_t path_size) {
@@ -276,8 +302,7 @@ rac_result_t rac_model_paths_get_temp_directory(char* out_path, size_t path_size
         return RAC_ERROR_NOT_INITIALIZED;
     }
 
-    std::string path = g_base_dir + "/RunAnywhere/Temp";
-    return copy_string_to_buffer(path, out_path, path_size);
+    return join_to_buffer({g_root_dir, "/Temp"}, out_path, path_size);
 }
 
 rac_result_t rac_model_paths_get_downloads_directory(char* out_path, size_t path_size) {
@@ -290,8 +315,7 @@ rac_result_t rac_model_paths_get_downloads_directory(char* out_path, size_t path
         return RAC_ERROR_NOT_INITIALIZED;
     }
 
-    std::string path = g_base_dir + "/RunAnywhere/Downloads";
-    return copy_string_to_buffer(path, out_path, path_size);
+    return join_to_buffer({g_root_dir, "/Downloads"}, out_path, path_size);
 }
 
 // =============================================================================
@@ -306,46 +330,29 @@ rac_result_t rac_model_paths_extract_model_id(const char* path, char* out_model_
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::vector<std::string> components = split_path(path);
-
-    // Find "Models" component
-    auto it = std::find(components.begin(), components.end(), "Models");
-    if (it == components.end()) {
+    std::string_view next;
+    std::string_view after;
+    if (!find_models_components(path, &next, &after)) {
         return RAC_ERROR_NOT_FOUND;
     }
 
-    auto modelsIndex = static_cast<size_t>(std::distance(components.begin(), it));
-
-    // Check if there's a component after "Models"
-    if (modelsIndex + 1 >= components.size()) {
-        return RAC_ERROR_NOT_FOUND;
-    }
-
-    std::string nextComponent = components[modelsIndex + 1];
-
     // Check if next component is a framework name
     bool isFramework = false;
     const char* frameworks[] = {"ONNX",      "LlamaCpp",   "FoundationModels",
                                 "SystemTTS", "FluidAudio", "BuiltIn",
                                 "None",      "Unknown"};
     for (const char* fw : frameworks) {
-        if (nextComponent == fw) {
+        if (next == fw) {
             isFramework = true;
             break;
         }
     }
 
-    std::string modelId;
-    if (isFramework && modelsIndex + 2 < components.size()) {
-        // Framework structure: Models/framework/modelId
-        modelId = components[modelsIndex + 2];
-    } else {
-        // Direct model folder structure: Models/modelId
-        modelId = nextComponent;
-    }
+    // Framework structure: Models/framework/modelId; otherwise Models/modelId
+    const std::string_view modelId = isFramework && !after.empty() ? after : next;
 
     if (out_model_id && model_id_size > 0) {
-        return copy_string_to_buffer(modelId, out_model_id, model_id_size);
+        return join_to_buffer({modelId}, out_model_id, model_id_size);
     }
 
     return RAC_SUCCESS;
@@ -359,23 +366,12 @@ rac_result_t rac_model_paths_extract_framework(const char* path,
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::vector<std::string> components = split_path(path);
-
-    // Find "Models" component
-    auto it = std::find(components.begin(), components.end(), "Models");
-    if (it == components.end()) {
-        return RAC_ERROR_NOT_FOUND;
-    }
-
-    auto modelsIndex = static_cast<size_t>(std::distance(components.begin(), it));
-
-    // Check if there's a component after "Models"
-    if (modelsIndex + 1 >= components.size()) {
+    std::string_view nextComponent;
+    std::string_view after;
+    if (!find_models_components(path, &nextComponent, &after)) {
         return RAC_ERROR_NOT_FOUND;
     }
 
-    std::string nextComponent = components[modelsIndex + 1];
-
     // Map to framework enum
     if (nextComponent == "ONNX") {
         *out_framework = RAC_FRAMEWORK_ONNX;
@@ -0,0 +1,509 @@
+/**
+ * @file model_prefetch.cpp
+ * @brief Model Prefetch and Warm Cache Policy Implementation
+ *
+ * Scores are frecency: every model's uses decay exponentially with age,
+ * weighted up logarithmically by how often it was used. The registry keeps
+ * only the last use and a count, so the count is treated as if every use
+ * happened at the last one. Assignments add a bonus that shrinks with their
+ * position in the backend's list.
+ *
+ * Locking: the download manager calls completion callbacks with its own
+ * mutex held, and those take the policy's mutex, so the policy never calls
+ * into the download manager while holding it.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_logger.h"
+#include "rac/core/rac_platform_adapter.h"
+#include "rac/infrastructure/device/rac_device_manager.h"
+#include "rac/infrastructure/model_management/rac_model_assignment.h"
+#include "rac/infrastructure/model_management/rac_model_fit.h"
+#include "rac/infrastructure/model_management/rac_model_paths.h"
+#include "rac/infrastructure/model_management/rac_model_prefetch.h"
+
+namespace {
+
+const char* LOG_CAT = "ModelPrefetch";
+
+// Bonus of the first assigned model; one recent use outweighs it
+constexpr double kAssignmentWeight = 0.5;
+
+// Read-ahead requests are issued in pieces (F_RDADVISE takes an int count)
+constexpr int64_t kAdviseChunkBytes = 256 * 1024 * 1024;
+constexpr int kWarmMaxDepth = 3;
+
+struct Candidate {
+    const rac_model_info_t* model;
+    double score;
+};
+
+bool is_downloaded(const rac_model_info_t* model) {
+    return model->local_path && model->local_path[0] != '\0';
+}
+
+// Models with a score, most likely first; the pointers live as long as snapshot
+std::vector<Candidate> rank(rac_model_registry_handle_t registry, float half_life_hours,
+                            rac_model_snapshot_handle_t* snapshot) {
+    const rac_model_info_t* const* models = nullptr;
+    size_t count = 0;
+    std::vector<Candidate> ranked;
+    if (rac_model_registry_snapshot(registry, snapshot, &models, &count) != RAC_SUCCESS) {
+        *snapshot = nullptr;
+        return ranked;
+    }
+
+    std::map<std::string, size_t> assigned;
+    rac_model_info_t** assignments = nullptr;
+    size_t assignment_count = 0;
+    if (rac_model_assignment_get_cached(&assignments, &assignment_count) == RAC_SUCCESS) {
+        for (size_t i = 0; i < assignment_count; ++i) {
+            if (assignments[i]->id) {
+                assigned.emplace(assignments[i]->id, i);
+            }
+        }
+        rac_model_info_array_free(assignments, assignment_count);
+    }
+
+    const double now = static_cast<double>(rac_get_current_time_ms()) / 1000.0;
+    const double half_life = std::max(half_life_hours, 0.01f) * 3600.0;
+    for (size_t i = 0; i < count; ++i) {
+        const rac_model_info_t* model = models[i];
+        double score = 0.0;
+        if (model->last_used > 0) {
+            const double age = std::max(0.0, now - static_cast<double>(model->last_used));
+            score += (1.0 + std::log2(1.0 + std::max(model->usage_count, 0))) *
+                     std::exp2(-age / half_life);
+        }
+        auto it = assigned.find(model->id);
+        if (it != assigned.end()) {
+            score += kAssignmentWeight / static_cast<double>(1 + it->second);
+        }
+        if (score > 0.0) {
+            ranked.push_back({model, score});
+        }
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const Candidate& a, const Candidate& b) {
+        return a.score != b.score ? a.score > b.score : strcmp(a.model->id, b.model->id) < 0;
+    });
+    return ranked;
+}
+
+// Metadata-only check, so ranking never waits on the network
+bool may_fit(const rac_model_info_t* model, int64_t total_memory, int64_t available_memory) {
+    rac_model_memory_profile_t profile = {};
+    rac_model_fit_result_t fit = {};
+    if (rac_model_memory_profile_from_info(model, &profile) != RAC_SUCCESS ||
+        rac_model_fit_estimate(&profile, nullptr, total_memory, available_memory, &fit) !=
+            RAC_SUCCESS) {
+        return true;
+    }
+    return fit.fit != RAC_MODEL_FIT_TOO_LARGE;
+}
+
+bool make_directories(const std::string& path) {
+    for (size_t pos = 1; pos <= path.size(); ++pos) {
+        if (pos == path.size() || path[pos] == '/') {
+            const std::string prefix = path.substr(0, pos);
+            if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Where a model is downloaded to: its file, or for archives an archive file
+// in its folder that is unpacked next to it
+bool download_destination(const rac_model_info_t* model, std::string* out_path) {
+    char folder[1024];
+    if (rac_model_paths_get_model_folder(model->id, model->framework, folder, sizeof(folder)) !=
+            RAC_SUCCESS ||
+        !make_directories(folder)) {
+        return false;
+    }
+    if (rac_artifact_requires_extraction(&model->artifact_info)) {
+        *out_path = std::string(folder) + "/" + model->id + "." +
+                    rac_archive_type_extension(model->artifact_info.archive_type);
+        return true;
+    }
+    char path[1024];
+    if (rac_model_paths_get_model_path(model, path, sizeof(path)) != RAC_SUCCESS) {
+        return false;
+    }
+    *out_path = path;
+    return true;
+}
+
+// Asks the kernel to read a file ahead without waiting for it
+void advise_will_need(int fd, int64_t length) {
+#if defined(POSIX_FADV_WILLNEED)
+    posix_fadvise(fd, 0, static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+#elif defined(F_RDADVISE)
+    for (int64_t offset = 0; offset < length; offset += kAdviseChunkBytes) {
+        struct radvisory advice = {};
+        advice.ra_offset = static_cast<off_t>(offset);
+        advice.ra_count = static_cast<int>(std::min(kAdviseChunkBytes, length - offset));
+        fcntl(fd, F_RDADVISE, &advice);
+    }
+#else
+    (void)fd;
+    (void)length;
+#endif
+}
+
+// Reads files under path ahead, largest first, until budget bytes
+int64_t warm_path(const std::string& path, int64_t budget) {
+    std::vector<std::pair<int64_t, std::string>> files;
+    std::vector<std::pair<std::string, int>> pending = {{path, 0}};
+    while (!pending.empty()) {
+        auto [current, depth] = pending.back();
+        pending.pop_back();
+        struct stat st = {};
+        if (stat(current.c_str(), &st) != 0) {
+            continue;
+        }
+        if (S_ISREG(st.st_mode)) {
+            files.emplace_back(static_cast<int64_t>(st.st_size), current);
+            continue;
+        }
+        DIR* dir = S_ISDIR(st.st_mode) && depth < kWarmMaxDepth ? opendir(current.c_str())
+                                                                 : nullptr;
+        if (!dir) {
+            continue;
+        }
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                pending.emplace_back(current + "/" + entry->d_name, depth + 1);
+            }
+        }
+        closedir(dir);
+    }
+
+    // The weights are the largest file and what the first inference touches
+    std::sort(files.begin(), files.end(), std::greater<>());
+    int64_t warmed = 0;
+    for (const auto& [size, file] : files) {
+        const int64_t length = std::min(size, budget - warmed);
+        if (length <= 0) {
+            break;
+        }
+        const int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        advise_will_need(fd, length);
+        ::close(fd);
+        warmed += length;
+    }
+    return warmed;
+}
+
+}  // namespace
+
+struct rac_model_prefetch {
+    rac_model_registry_handle_t registry = nullptr;
+    rac_download_manager_handle_t download_manager = nullptr;
+    rac_model_prefetch_config_t config = RAC_MODEL_PREFETCH_CONFIG_DEFAULT;
+
+    bool idle = false;
+    bool charging = false;
+
+    // Queued downloads (task id -> model id)
+    std::map<std::string, std::string> tasks;
+
+    std::mutex mutex;
+};
+
+static bool window_open(const rac_model_prefetch* handle) {
+    return (handle->idle && handle->config.download_when_idle) ||
+           (handle->charging && handle->config.download_when_charging);
+}
+
+// Cancels queued downloads; call without the mutex
+static void cancel_tasks(rac_model_prefetch* handle) {
+    std::vector<std::string> task_ids;
+    {
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        for (const auto& pair : handle->tasks) {
+            task_ids.push_back(pair.first);
+        }
+    }
+    for (const std::string& task_id : task_ids) {
+        rac_download_manager_cancel(handle->download_manager, task_id.c_str());
+    }
+}
+
+static void on_download_complete(const char* task_id, rac_result_t result, const char* final_path,
+                                 void* user_data) {
+    auto* handle = static_cast<rac_model_prefetch*>(user_data);
+    std::string model_id;
+    {
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        auto it = handle->tasks.find(task_id);
+        if (it == handle->tasks.end()) {
+            return;
+        }
+        model_id = std::move(it->second);
+        handle->tasks.erase(it);
+    }
+    if (result == RAC_SUCCESS && final_path) {
+        rac_model_registry_update_download_status(handle->registry, model_id.c_str(), final_path);
+        RAC_LOG_INFO(LOG_CAT, "Prefetched %s", model_id.c_str());
+    } else if (result != RAC_ERROR_CANCELLED) {
+        RAC_LOG_WARNING(LOG_CAT, "Prefetch of %s failed: %d", model_id.c_str(), result);
+    }
+}
+
+// =============================================================================
+// PUBLIC API - LIFECYCLE
+// =============================================================================
+
+rac_result_t rac_model_prefetch_create(rac_model_registry_handle_t registry,
+                                       rac_download_manager_handle_t download_manager,
+                                       const rac_model_prefetch_config_t* config,
+                                       rac_model_prefetch_handle_t* out_handle) {
+    if (!registry || !download_manager || !out_handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto* handle = new rac_model_prefetch();
+    handle->registry = registry;
+    handle->download_manager = download_manager;
+    if (config) {
+        handle->config = *config;
+    }
+
+    *out_handle = handle;
+    return RAC_SUCCESS;
+}
+
+void rac_model_prefetch_destroy(rac_model_prefetch_handle_t handle) {
+    if (!handle) {
+        return;
+    }
+    cancel_tasks(handle);
+    delete handle;
+}
+
+// =============================================================================
+// PUBLIC API - PREDICTION
+// =============================================================================
+
+rac_result_t rac_model_prefetch_predict(rac_model_prefetch_handle_t handle,
+                                        rac_model_prefetch_candidate_t** out_candidates,
+                                        size_t* out_count) {
+    if (!handle || !out_candidates || !out_count) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    rac_model_snapshot_handle_t snapshot = nullptr;
+    const std::vector<Candidate> ranked =
+        rank(handle->registry, handle->config.half_life_hours, &snapshot);
+
+    *out_count = ranked.size();
+    *out_candidates = nullptr;
+    if (!ranked.empty()) {
+        *out_candidates = static_cast<rac_model_prefetch_candidate_t*>(
+            rac_calloc_tagged(RAC_ALLOC_TAG_MODEL,
+                              ranked.size(), sizeof(rac_model_prefetch_candidate_t)));
+        if (!*out_candidates) {
+            *out_count = 0;
+            rac_model_snapshot_release(snapshot);
+            return RAC_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    for (size_t i = 0; i < ranked.size(); ++i) {
+        (*out_candidates)[i].model_id = rac_strdup(ranked[i].model->id);
+        (*out_candidates)[i].score = ranked[i].score;
+        (*out_candidates)[i].is_downloaded = is_downloaded(ranked[i].model) ? RAC_TRUE : RAC_FALSE;
+    }
+    rac_model_snapshot_release(snapshot);
+    return RAC_SUCCESS;
+}
+
+void rac_model_prefetch_candidates_free(rac_model_prefetch_candidate_t* candidates,
+                                        size_t count) {
+    if (!candidates) {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        rac_free(candidates[i].model_id);
+    }
+    rac_free(candidates);
+}
+
+// =============================================================================
+// PUBLIC API - DOWNLOADS
+// =============================================================================
+
+rac_result_t rac_model_prefetch_set_device_state(rac_model_prefetch_handle_t handle,
+                                                 rac_bool_t idle, rac_bool_t charging) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    bool closed = false;
+    {
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        const bool was_open = window_open(handle);
+        handle->idle = idle == RAC_TRUE;
+        handle->charging = charging == RAC_TRUE;
+        closed = was_open && !window_open(handle);
+    }
+    if (closed) {
+        RAC_LOG_DEBUG(LOG_CAT, "Download window closed");
+        cancel_tasks(handle);
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_model_prefetch_run(rac_model_prefetch_handle_t handle, char*** out_task_ids,
+                                    size_t* out_count) {
+    if (!handle || !out_task_ids || !out_count) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    *out_task_ids = nullptr;
+    *out_count = 0;
+
+    std::vector<std::string> queued_models;
+    {
+        std::lock_guard<std::mutex> lock(handle->mutex);
+        if (!window_open(handle)) {
+            return RAC_SUCCESS;
+        }
+        for (const auto& pair : handle->tasks) {
+            queued_models.push_back(pair.second);
+        }
+    }
+
+    int64_t total_memory = 0;
+    int64_t available_memory = 0;
+    rac_device_manager_get_memory(&total_memory, &available_memory);
+
+    rac_model_snapshot_handle_t snapshot = nullptr;
+    const std::vector<Candidate> ranked =
+        rank(handle->registry, handle->config.half_life_hours, &snapshot);
+
+    std::vector<std::string> started;
+    int64_t queued_bytes = 0;
+    int32_t kept = 0;
+    for (const Candidate& candidate : ranked) {
+        if (kept >= handle->config.max_models) {
+            break;
+        }
+        const rac_model_info_t* model = candidate.model;
+        const bool queued = std::find(queued_models.begin(), queued_models.end(), model->id) !=
+                            queued_models.end();
+        if (is_downloaded(model) || queued) {
+            kept++;
+            continue;
+        }
+        if (!model->download_url || !may_fit(model, total_memory, available_memory)) {
+            continue;
+        }
+        if (queued_bytes + model->download_size > handle->config.max_download_bytes) {
+            continue;
+        }
+        std::string destination;
+        if (!download_destination(model, &destination)) {
+            RAC_LOG_WARNING(LOG_CAT, "No download path for %s", model->id);
+            continue;
+        }
+
+        char* task_id = nullptr;
+        const rac_result_t result = rac_download_manager_start(
+            handle->download_manager, model->id, model->download_url, destination.c_str(),
+            rac_artifact_requires_extraction(&model->artifact_info), nullptr,
+            on_download_complete, handle, &task_id);
+        if (result != RAC_SUCCESS) {
+            RAC_LOG_WARNING(LOG_CAT, "Could not queue %s: %d", model->id, result);
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(handle->mutex);
+            handle->tasks[task_id] = model->id;
+        }
+        rac_download_manager_set_priority(handle->download_manager, task_id,
+                                          RAC_DOWNLOAD_PRIORITY_BACKGROUND);
+        RAC_LOG_INFO(LOG_CAT, "Prefetching %s (score %.3f)", model->id, candidate.score);
+        started.emplace_back(task_id);
+        rac_free(task_id);
+        queued_bytes += model->download_size;
+        kept++;
+    }
+    rac_model_snapshot_release(snapshot);
+
+    if (started.empty()) {
+        return RAC_SUCCESS;
+    }
+    *out_task_ids = static_cast<char**>(
+        rac_calloc_tagged(RAC_ALLOC_TAG_MODEL, started.size(), sizeof(char*)));
+    if (!*out_task_ids) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    for (size_t i = 0; i < started.size(); ++i) {
+        (*out_task_ids)[i] = rac_strdup(started[i].c_str());
+    }
+    *out_count = started.size();
+    return RAC_SUCCESS;
+}
+
+// =============================================================================
+// PUBLIC API - WARM CACHE
+// =============================================================================
+
+rac_result_t rac_model_prefetch_warm(rac_model_prefetch_handle_t handle, char** out_model_id) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    if (out_model_id) {
+        *out_model_id = nullptr;
+    }
+
+    int64_t budget = handle->config.warm_max_bytes;
+    int64_t total_memory = 0;
+    int64_t available_memory = 0;
+    if (rac_device_manager_get_memory(&total_memory, &available_memory) == RAC_SUCCESS &&
+        available_memory > 0) {
+        budget = std::min(budget, available_memory / 2);
+    }
+
+    rac_model_snapshot_handle_t snapshot = nullptr;
+    const std::vector<Candidate> ranked =
+        rank(handle->registry, handle->config.half_life_hours, &snapshot);
+
+    rac_result_t result = RAC_ERROR_NOT_FOUND;
+    for (const Candidate& candidate : ranked) {
+        if (!is_downloaded(candidate.model)) {
+            continue;
+        }
+        const int64_t warmed = warm_path(candidate.model->local_path, budget);
+        RAC_LOG_INFO(LOG_CAT, "Reading %lld MB of %s ahead",
+                     static_cast<long long>(warmed / (1024 * 1024)), candidate.model->id);
+        if (out_model_id) {
+            *out_model_id = rac_strdup(candidate.model->id);
+        }
+        result = RAC_SUCCESS;
+        break;
+    }
+    rac_model_snapshot_release(snapshot);
+    return result;
+}
@@ -7,20 +7,34 @@
  *
  * CRITICAL: This is a direct port of Swift implementation - do NOT add custom logic!
  *
- * This is an in-memory model metadata store.
+ * This is an in-memory model metadata store, optionally persisted to an index
+ * file that is memory-mapped on the next start (see rac_model_registry_open_index).
  */
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
 #include "rac/core/rac_platform_adapter.h"
 #include "rac/core/rac_structured_error.h"
+#include "rac/infrastructure/model_management/rac_gguf_metadata.h"
 #include "rac/infrastructure/model_management/rac_model_paths.h"
 #include "rac/infrastructure/model_management/rac_model_registry.h"
 
@@ -28,21 +42,14 @@
 // INTERNAL STRUCTURES
 // =============================================================================
 
-struct rac_model_registry {
-    // Model storage (model_id -> model_info)
-    std::map<std::string, rac_model_info_t*> models;
-
-    // Thread safety
-    std::mutex mutex;
-};
-
 // Note: rac_strdup is declared in rac_types.h and implemented in rac_memory.cpp
 
 static rac_model_info_t* deep_copy_model(const rac_model_info_t* src) {
     if (!src)
         return nullptr;
 
-    rac_model_info_t* copy = static_cast<rac_model_info_t*>(calloc(1, sizeof(rac_model_info_t)));
+    rac_model_info_t* copy = static_cast<rac_model_info_t*>(
+        rac_calloc_tagged(RAC_ALLOC_TAG_MODEL, 1, sizeof(rac_model_info_t)));
     if (!copy)
         return nullptr;
 
@@ -68,7 +75,8 @@ static rac_model_info_t* deep_copy_model(const rac_model_info_t* src) {
 
     // Copy tags
     if (src->tags && src->tag_count > 0) {
-        copy->tags = static_cast<char**>(malloc(sizeof(char*) * src->tag_count));
+        copy->tags = static_cast<char**>(
+            rac_alloc_tagged(RAC_ALLOC_TAG_MODEL, sizeof(char*) * src->tag_count));
         if (copy->tags) {
             for (size_t i = 0; i < src->tag_count; ++i) {
                 copy->tags[i] = rac_strdup(src->tags[i]);
@@ -83,6 +91,11 @@ static rac_model_info_t* deep_copy_model(const rac_model_info_t* src) {
     copy->updated_at = src->updated_at;
     copy->last_used = src->last_used;
     copy->usage_count = src->usage_count;
+    copy->variant_of = rac_strdup(src->variant_of);
+    copy->quantization = rac_strdup(src->quantization);
+    copy->expected_rtf = src->expected_rtf;
+    copy->sha256 = rac_strdup(src->sha256);
+    copy->delta_manifest_url = rac_strdup(src->delta_manifest_url);
 
     return copy;
 }
@@ -92,30 +105,756 @@ static void free_model_info(rac_model_info_t* model) {
         return;
 
     if (model->id)
-        free(model->id);
+        rac_free(model->id);
     if (model->name)
-        free(model->name);
+        rac_free(model->name);
     if (model->download_url)
-        free(model->download_url);
+        rac_free(model->download_url);
     if (model->local_path)
-        free(model->local_path);
+        rac_free(model->local_path);
     if (model->description)
-        free(model->description);
+        rac_free(model->description);
+    if (model->variant_of)
+        rac_free(model->variant_of);
+    if (model->quantization)
+        rac_free(model->quantization);
+    if (model->sha256)
+        rac_free(model->sha256);
+    if (model->delta_manifest_url)
+        rac_free(model->delta_manifest_url);
 
     // Free artifact info strings
     if (model->artifact_info.strategy_id) {
-        free(const_cast<char*>(model->artifact_info.strategy_id));
+        rac_free(const_cast<char*>(model->artifact_info.strategy_id));
     }
 
     if (model->tags) {
         for (size_t i = 0; i < model->tag_count; ++i) {
             if (model->tags[i])
-                free(model->tags[i]);
+                rac_free(model->tags[i]);
+        }
+        rac_free(model->tags);
+    }
+
+    rac_free(model);
+}
+
+namespace {
+
+// Index file mapped by rac_model_registry_open_index
+struct IndexMapping {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    ~IndexMapping() {
+        if (data) {
+            munmap(const_cast<char*>(data), size);
+        }
+    }
+};
+
+// A stored model. Entries are never changed while a view or the index shares
+// them: writers replace them with an owned copy (see writable_model).
+struct ModelEntry {
+    rac_model_info_t* info = nullptr;
+
+    // Set when info's strings point into the index mapping
+    std::shared_ptr<IndexMapping> mapping;
+
+    // local_path as last seen on disk
+    int64_t local_mtime_ns = 0;
+    int64_t local_size = 0;
+    bool verified = true;  // False until local_path is checked after loading the index
+
+    ~ModelEntry() {
+        if (!mapping) {
+            free_model_info(info);
+        } else if (info) {
+            rac_free(info->tags);
+            rac_free(info);
+        }
+    }
+};
+
+using EntryPtr = std::shared_ptr<ModelEntry>;
+
+// Outcome of is_valid_model_folder for a folder as it was at mtime_ns
+struct FolderCheck {
+    int64_t mtime_ns = 0;
+    rac_inference_framework_t framework = RAC_FRAMEWORK_UNKNOWN;
+    bool valid = false;
+};
+
+// A directory's size as it was at mtime_ns
+struct DirSize {
+    int64_t mtime_ns = 0;
+    int64_t size = 0;
+};
+
+struct View {
+    EntryPtr entry;
+    int32_t count = 0;
+};
+
+// Positions in RegistrySnapshot::models, ascending, by framework or category
+using PositionIndex = std::unordered_map<int32_t, std::vector<uint32_t>>;
+
+// The models at one point in time. Never changed once published; holding the
+// entries keeps every model alive and unchanged for as long as a reader needs it.
+struct RegistrySnapshot {
+    std::vector<EntryPtr> entries;             // In model id order
+    std::vector<const rac_model_info_t*> models;  // entries[i]->info
+
+    // Secondary indexes, built with the snapshot so filters only visit matches
+    PositionIndex by_framework;
+    PositionIndex by_category;
+    std::vector<uint32_t> downloaded;
+};
+
+using SnapshotPtr = std::shared_ptr<const RegistrySnapshot>;
+
+}  // namespace
+
+struct rac_model_snapshot {
+    SnapshotPtr data;
+
+    // Models returned by rac_model_registry_snapshot_query
+    std::vector<const rac_model_info_t*> matches;
+};
+
+struct rac_model_registry {
+    // Model storage (model_id -> model entry)
+    std::map<std::string, EntryPtr> models;
+
+    // Outstanding rac_model_registry_acquire views
+    std::map<const rac_model_info_t*, View> views;
+
+    // Persistent index (empty path = in-memory only)
+    std::string index_path;
+    bool index_dirty = false;
+    std::map<std::string, FolderCheck> folder_checks;  // By folder path
+    std::map<std::string, DirSize> dir_sizes;          // By directory path
+
+    // Published with std::atomic_store; rebuilt by the first reader after a change
+    SnapshotPtr snapshot;
+    std::atomic<bool> snapshot_stale{true};
+
+    // Thread safety
+    std::mutex mutex;
+};
+
+// Records a change to the stored models: the index has to be rewritten and
+// readers need a new snapshot. Called with the mutex held.
+static void mark_changed(rac_model_registry* registry) {
+    registry->index_dirty = true;
+    registry->snapshot_stale.store(true, std::memory_order_release);
+}
+
+// =============================================================================
+// PERSISTENT INDEX
+// =============================================================================
+//
+// Layout (host byte order, every section 8-byte aligned):
+//   IndexHeader | IndexModel[model_count] | uint32 tag string offsets |
+//   IndexFolder[folder_count] | IndexDirSize[dir_size_count] |
+//   string pool (NUL-terminated strings)
+
+namespace {
+
+constexpr char kIndexMagic[8] = {'R', 'A', 'C', 'M', 'R', 'E', 'G', '1'};
+constexpr uint32_t kIndexVersion = 2;
+constexpr uint32_t kNoString = 0xFFFFFFFFu;
+
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t model_count;
+    uint32_t tag_count;
+    uint32_t folder_count;
+    uint32_t dir_size_count;
+    uint32_t reserved;
+    uint64_t models_offset;
+    uint64_t tags_offset;
+    uint64_t folders_offset;
+    uint64_t dir_sizes_offset;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+};
+
+struct IndexModel {
+    // String pool offsets (kNoString = NULL)
+    uint32_t id, name, download_url, local_path, description, variant_of, quantization, sha256,
+        delta_manifest_url, strategy_id;
+    uint32_t first_tag, tag_count;
+    int32_t category, format, framework, kind, archive_type, archive_structure;
+    int32_t context_length, supports_thinking, source, usage_count;
+    float expected_rtf;
+    uint32_t reserved;
+    int64_t download_size, memory_required, created_at, updated_at, last_used;
+    int64_t local_mtime_ns, local_size;
+};
+
+struct IndexFolder {
+    uint32_t path;
+    int32_t framework;
+    int32_t valid;
+    uint32_t reserved;
+    int64_t mtime_ns;
+};
+
+struct IndexDirSize {
+    uint32_t path;
+    uint32_t reserved;
+    int64_t mtime_ns;
+    int64_t size;
+};
+
+static_assert(sizeof(IndexHeader) == 80, "index layout");
+static_assert(sizeof(IndexModel) == 152, "index layout");
+static_assert(sizeof(IndexFolder) == 24, "index layout");
+static_assert(sizeof(IndexDirSize) == 24, "index layout");
+
+uint64_t align8(uint64_t value) {
+    return (value + 7) & ~static_cast<uint64_t>(7);
+}
+
+bool stat_path(const char* path, int64_t* mtime_ns, int64_t* size) {
+    struct stat st = {};
+    if (!path || stat(path, &st) != 0) {
+        return false;
+    }
+#if defined(__APPLE__)
+    *mtime_ns = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 +
+                st.st_mtimespec.tv_nsec;
+#else
+    *mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    *size = static_cast<int64_t>(st.st_size);
+    return true;
+}
+
+// Records what local_path looks like now, so a later start can tell it changed
+void record_local_path(ModelEntry& entry) {
+    entry.local_mtime_ns = 0;
+    entry.local_size = 0;
+    if (entry.info->local_path && entry.info->local_path[0] != '\0') {
+        stat_path(entry.info->local_path, &entry.local_mtime_ns, &entry.local_size);
+    }
+    entry.verified = true;
+}
+
+// Drops the cached sizes that include path: its own, its ancestors' and its
+// subdirectories'
+void invalidate_dir_sizes(rac_model_registry* registry, const char* path) {
+    if (!path || path[0] == '\0' || registry->dir_sizes.empty()) {
+        return;
+    }
+    const std::string changed = path;
+    auto contains = [](const std::string& dir, const std::string& p) {
+        return p.size() > dir.size() && p.compare(0, dir.size(), dir) == 0 &&
+               (dir.back() == '/' || p[dir.size()] == '/');
+    };
+    for (auto it = registry->dir_sizes.begin(); it != registry->dir_sizes.end();) {
+        if (it->first == changed || contains(it->first, changed) || contains(changed, it->first)) {
+            it = registry->dir_sizes.erase(it);
+            registry->index_dirty = true;
+        } else {
+            ++it;
+        }
+    }
+}
+
+class StringPool {
+   public:
+    uint32_t add(const char* value) {
+        if (!value) {
+            return kNoString;
+        }
+        const uint32_t offset = static_cast<uint32_t>(data_.size());
+        data_.append(value, strlen(value) + 1);
+        return offset;
+    }
+    const std::string& data() const { return data_; }
+
+   private:
+    std::string data_;
+};
+
+bool write_file_fully(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t n = write(fd, p, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Writes the index to a temporary file and renames it over the old one, so
+// a mapping of the previous index stays valid
+rac_result_t write_index(rac_model_registry* registry) {
+    StringPool pool;
+    std::vector<IndexModel> models;
+    std::vector<uint32_t> tags;
+    std::vector<IndexFolder> folders;
+    std::vector<IndexDirSize> dir_sizes;
+
+    models.reserve(registry->models.size());
+    for (const auto& pair : registry->models) {
+        const ModelEntry& entry = *pair.second;
+        const rac_model_info_t* m = entry.info;
+        IndexModel r = {};
+        r.id = pool.add(m->id);
+        r.name = pool.add(m->name);
+        r.download_url = pool.add(m->download_url);
+        r.local_path = pool.add(m->local_path);
+        r.description = pool.add(m->description);
+        r.variant_of = pool.add(m->variant_of);
+        r.quantization = pool.add(m->quantization);
+        r.sha256 = pool.add(m->sha256);
+        r.delta_manifest_url = pool.add(m->delta_manifest_url);
+        r.strategy_id = pool.add(m->artifact_info.strategy_id);
+        r.first_tag = static_cast<uint32_t>(tags.size());
+        r.tag_count = m->tags ? static_cast<uint32_t>(m->tag_count) : 0;
+        for (uint32_t i = 0; i < r.tag_count; ++i) {
+            tags.push_back(pool.add(m->tags[i] ? m->tags[i] : ""));
+        }
+        r.category = m->category;
+        r.format = m->format;
+        r.framework = m->framework;
+        r.kind = m->artifact_info.kind;
+        r.archive_type = m->artifact_info.archive_type;
+        r.archive_structure = m->artifact_info.archive_structure;
+        r.context_length = m->context_length;
+        r.supports_thinking = m->supports_thinking;
+        r.source = m->source;
+        r.usage_count = m->usage_count;
+        r.expected_rtf = m->expected_rtf;
+        r.download_size = m->download_size;
+        r.memory_required = m->memory_required;
+        r.created_at = m->created_at;
+        r.updated_at = m->updated_at;
+        r.last_used = m->last_used;
+        r.local_mtime_ns = entry.local_mtime_ns;
+        r.local_size = entry.local_size;
+        models.push_back(r);
+    }
+    for (const auto& pair : registry->folder_checks) {
+        IndexFolder r = {};
+        r.path = pool.add(pair.first.c_str());
+        r.framework = pair.second.framework;
+        r.valid = pair.second.valid ? 1 : 0;
+        r.mtime_ns = pair.second.mtime_ns;
+        folders.push_back(r);
+    }
+    for (const auto& pair : registry->dir_sizes) {
+        IndexDirSize r = {};
+        r.path = pool.add(pair.first.c_str());
+        r.mtime_ns = pair.second.mtime_ns;
+        r.size = pair.second.size;
+        dir_sizes.push_back(r);
+    }
+
+    IndexHeader header = {};
+    memcpy(header.magic, kIndexMagic, sizeof(kIndexMagic));
+    header.version = kIndexVersion;
+    header.model_count = static_cast<uint32_t>(models.size());
+    header.tag_count = static_cast<uint32_t>(tags.size());
+    header.folder_count = static_cast<uint32_t>(folders.size());
+    header.dir_size_count = static_cast<uint32_t>(dir_sizes.size());
+    header.models_offset = sizeof(IndexHeader);
+    header.tags_offset = header.models_offset + models.size() * sizeof(IndexModel);
+    header.folders_offset = align8(header.tags_offset + tags.size() * sizeof(uint32_t));
+    header.dir_sizes_offset = header.folders_offset + folders.size() * sizeof(IndexFolder);
+    header.strings_offset = header.dir_sizes_offset + dir_sizes.size() * sizeof(IndexDirSize);
+    header.strings_size = pool.data().size();
+
+    std::string image(static_cast<size_t>(header.strings_offset + header.strings_size), '\0');
+    memcpy(&image[0], &header, sizeof(header));
+    if (!models.empty()) {
+        memcpy(&image[header.models_offset], models.data(), models.size() * sizeof(IndexModel));
+    }
+    if (!tags.empty()) {
+        memcpy(&image[header.tags_offset], tags.data(), tags.size() * sizeof(uint32_t));
+    }
+    if (!folders.empty()) {
+        memcpy(&image[header.folders_offset], folders.data(),
+               folders.size() * sizeof(IndexFolder));
+    }
+    if (!dir_sizes.empty()) {
+        memcpy(&image[header.dir_sizes_offset], dir_sizes.data(),
+               dir_sizes.size() * sizeof(IndexDirSize));
+    }
+    if (!pool.data().empty()) {
+        memcpy(&image[header.strings_offset], pool.data().data(), pool.data().size());
+    }
+
+    const std::string tmp_path = registry->index_path + ".tmp";
+    const int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+    const bool written = write_file_fully(fd, image.data(), image.size()) && fsync(fd) == 0;
+    ::close(fd);
+    if (!written || rename(tmp_path.c_str(), registry->index_path.c_str()) != 0) {
+        unlink(tmp_path.c_str());
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+    return RAC_SUCCESS;
+}
+
+// Adds the index's models (strings borrowed from the mapping), folder checks
+// and directory sizes
+rac_result_t load_index(rac_model_registry* registry, const std::shared_ptr<IndexMapping>& map,
+                        size_t* out_loaded) {
+    *out_loaded = 0;
+    if (map->size < sizeof(IndexHeader)) {
+        return RAC_ERROR_INVALID_FORMAT;
+    }
+    IndexHeader h;
+    memcpy(&h, map->data, sizeof(h));
+    const uint64_t size = map->size;
+    if (memcmp(h.magic, kIndexMagic, sizeof(kIndexMagic)) != 0 || h.version != kIndexVersion ||
+        h.models_offset % 8 != 0 || h.tags_offset % 4 != 0 || h.folders_offset % 8 != 0 ||
+        h.models_offset + static_cast<uint64_t>(h.model_count) * sizeof(IndexModel) > size ||
+        h.tags_offset + static_cast<uint64_t>(h.tag_count) * sizeof(uint32_t) > size ||
+        h.folders_offset + static_cast<uint64_t>(h.folder_count) * sizeof(IndexFolder) > size ||
+        h.dir_sizes_offset % 8 != 0 ||
+        h.dir_sizes_offset + static_cast<uint64_t>(h.dir_size_count) * sizeof(IndexDirSize) >
+            size ||
+        h.strings_offset > size || h.strings_size > size - h.strings_offset ||
+        h.strings_size >= kNoString ||
+        (h.strings_size > 0 && map->data[h.strings_offset + h.strings_size - 1] != '\0')) {
+        return RAC_ERROR_INVALID_FORMAT;
+    }
+
+    // Every string ends inside the pool because its last byte is a terminator
+    const char* pool = map->data + h.strings_offset;
+    auto str = [&](uint32_t offset, bool* ok) -> char* {
+        if (offset == kNoString) {
+            return nullptr;
+        }
+        if (offset >= h.strings_size) {
+            *ok = false;
+            return nullptr;
+        }
+        return const_cast<char*>(pool + offset);
+    };
+    const auto* records = reinterpret_cast<const IndexModel*>(map->data + h.models_offset);
+    const auto* tag_offsets = reinterpret_cast<const uint32_t*>(map->data + h.tags_offset);
+    const auto* folders = reinterpret_cast<const IndexFolder*>(map->data + h.folders_offset);
+
+    std::vector<EntryPtr> loaded;
+    loaded.reserve(h.model_count);
+    for (uint32_t i = 0; i < h.model_count; ++i) {
+        const IndexModel& r = records[i];
+        if (static_cast<uint64_t>(r.first_tag) + r.tag_count > h.tag_count) {
+            return RAC_ERROR_INVALID_FORMAT;
+        }
+        auto entry = std::make_shared<ModelEntry>();
+        entry->mapping = map;
+        entry->info = static_cast<rac_model_info_t*>(
+            rac_calloc_tagged(RAC_ALLOC_TAG_MODEL, 1, sizeof(rac_model_info_t)));
+        if (!entry->info) {
+            return RAC_ERROR_OUT_OF_MEMORY;
+        }
+        rac_model_info_t* m = entry->info;
+        bool ok = true;
+        m->id = str(r.id, &ok);
+        m->name = str(r.name, &ok);
+        m->download_url = str(r.download_url, &ok);
+        m->local_path = str(r.local_path, &ok);
+        m->description = str(r.description, &ok);
+        m->variant_of = str(r.variant_of, &ok);
+        m->quantization = str(r.quantization, &ok);
+        m->sha256 = str(r.sha256, &ok);
+        m->delta_manifest_url = str(r.delta_manifest_url, &ok);
+        m->artifact_info.strategy_id = str(r.strategy_id, &ok);
+        if (r.tag_count > 0) {
+            m->tags = static_cast<char**>(
+                rac_alloc_tagged(RAC_ALLOC_TAG_MODEL, sizeof(char*) * r.tag_count));
+            if (!m->tags) {
+                return RAC_ERROR_OUT_OF_MEMORY;
+            }
+            m->tag_count = r.tag_count;
+            for (uint32_t t = 0; t < r.tag_count; ++t) {
+                m->tags[t] = str(tag_offsets[r.first_tag + t], &ok);
+            }
+        }
+        if (!ok || !m->id) {
+            return RAC_ERROR_INVALID_FORMAT;
+        }
+        m->category = static_cast<rac_model_category_t>(r.category);
+        m->format = static_cast<rac_model_format_t>(r.format);
+        m->framework = static_cast<rac_inference_framework_t>(r.framework);
+        m->artifact_info.kind = static_cast<rac_artifact_type_kind_t>(r.kind);
+        m->artifact_info.archive_type = static_cast<rac_archive_type_t>(r.archive_type);
+        m->artifact_info.archive_structure =
+            static_cast<rac_archive_structure_t>(r.archive_structure);
+        m->context_length = r.context_length;
+        m->supports_thinking = r.supports_thinking;
+        m->source = static_cast<rac_model_source_t>(r.source);
+        m->usage_count = r.usage_count;
+        m->expected_rtf = r.expected_rtf;
+        m->download_size = r.download_size;
+        m->memory_required = r.memory_required;
+        m->created_at = r.created_at;
+        m->updated_at = r.updated_at;
+        m->last_used = r.last_used;
+        entry->local_mtime_ns = r.local_mtime_ns;
+        entry->local_size = r.local_size;
+        entry->verified = !m->local_path;
+        loaded.push_back(std::move(entry));
+    }
+    std::vector<std::pair<std::string, FolderCheck>> checks;
+    for (uint32_t i = 0; i < h.folder_count; ++i) {
+        bool ok = true;
+        const char* path = str(folders[i].path, &ok);
+        if (!ok || !path) {
+            return RAC_ERROR_INVALID_FORMAT;
+        }
+        FolderCheck check;
+        check.mtime_ns = folders[i].mtime_ns;
+        check.framework = static_cast<rac_inference_framework_t>(folders[i].framework);
+        check.valid = folders[i].valid != 0;
+        checks.emplace_back(path, check);
+    }
+    const auto* sizes = reinterpret_cast<const IndexDirSize*>(map->data + h.dir_sizes_offset);
+    std::vector<std::pair<std::string, DirSize>> dir_sizes;
+    for (uint32_t i = 0; i < h.dir_size_count; ++i) {
+        bool ok = true;
+        const char* path = str(sizes[i].path, &ok);
+        if (!ok || !path) {
+            return RAC_ERROR_INVALID_FORMAT;
+        }
+        DirSize dir_size;
+        dir_size.mtime_ns = sizes[i].mtime_ns;
+        dir_size.size = sizes[i].size;
+        dir_sizes.emplace_back(path, dir_size);
+    }
+
+    // Models saved before the index was opened are newer than its copies
+    for (EntryPtr& entry : loaded) {
+        if (registry->models.emplace(entry->info->id, entry).second) {
+            ++*out_loaded;
+        }
+    }
+    for (auto& check : checks) {
+        registry->folder_checks.insert(std::move(check));
+    }
+    for (auto& dir_size : dir_sizes) {
+        registry->dir_sizes.insert(std::move(dir_size));
+    }
+    return RAC_SUCCESS;
+}
+
+// Entries shared with views or snapshots, or borrowing the mapping, are copied
+// before a write
+rac_model_info_t* writable_model(EntryPtr& slot) {
+    const bool shared = slot.use_count() > 1;
+    // Pairs with the release of the last snapshot reader that dropped the entry
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (shared || slot->mapping) {
+        auto copy = std::make_shared<ModelEntry>();
+        copy->info = deep_copy_model(slot->info);
+        if (!copy->info) {
+            return nullptr;
+        }
+        copy->local_mtime_ns = slot->local_mtime_ns;
+        copy->local_size = slot->local_size;
+        copy->verified = slot->verified;
+        slot = std::move(copy);
+    }
+    return slot->info;
+}
+
+// Checks a model loaded from the index against the disk on first use: a
+// local_path that is gone means the model is no longer downloaded
+void verify_entry(rac_model_registry* registry, EntryPtr& slot) {
+    if (slot->verified) {
+        return;
+    }
+    int64_t mtime_ns = 0;
+    int64_t size = 0;
+    if (stat_path(slot->info->local_path, &mtime_ns, &size)) {
+        if (mtime_ns != slot->local_mtime_ns || size != slot->local_size) {
+            slot->local_mtime_ns = mtime_ns;
+            slot->local_size = size;
+            registry->index_dirty = true;
+        }
+        slot->verified = true;
+        return;
+    }
+    rac_model_info_t* model = writable_model(slot);
+    if (!model) {
+        return;
+    }
+    RAC_LOG_INFO("ModelRegistry", "Downloaded files of %s are gone", model->id);
+    rac_free(model->local_path);
+    model->local_path = nullptr;
+    record_local_path(*slot);
+    mark_changed(registry);
+}
+
+}  // namespace
+
+// =============================================================================
+// SNAPSHOTS
+// =============================================================================
+
+// The current snapshot. Readers take it without the mutex; the first reader
+// after a change verifies the entries and publishes the next one.
+static SnapshotPtr current_snapshot(rac_model_registry* registry) {
+    if (registry->snapshot_stale.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(registry->mutex);
+        if (registry->snapshot_stale.load(std::memory_order_relaxed)) {
+            auto next = std::make_shared<RegistrySnapshot>();
+            next->entries.reserve(registry->models.size());
+            next->models.reserve(registry->models.size());
+            for (auto& pair : registry->models) {
+                verify_entry(registry, pair.second);
+                const rac_model_info_t* model = pair.second->info;
+                const auto position = static_cast<uint32_t>(next->models.size());
+                next->by_framework[model->framework].push_back(position);
+                next->by_category[model->category].push_back(position);
+                if (rac_model_info_is_downloaded(model)) {
+                    next->downloaded.push_back(position);
+                }
+                next->entries.push_back(pair.second);
+                next->models.push_back(model);
+            }
+            std::atomic_store(&registry->snapshot, SnapshotPtr(std::move(next)));
+            registry->snapshot_stale.store(false, std::memory_order_release);
+        }
+    }
+    return std::atomic_load(&registry->snapshot);
+}
+
+// Positions listed under any of keys, ascending; sets *total to their count
+template <typename Key>
+static std::vector<const std::vector<uint32_t>*> index_lists(const PositionIndex& index,
+                                                             const Key* keys, size_t count,
+                                                             size_t* total) {
+    std::vector<const std::vector<uint32_t>*> lists;
+    *total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        // Repeated keys would return their models twice
+        if (std::find(keys, keys + i, keys[i]) != keys + i) {
+            continue;
+        }
+        auto it = index.find(static_cast<int32_t>(keys[i]));
+        if (it != index.end()) {
+            lists.push_back(&it->second);
+            *total += it->second.size();
+        }
+    }
+    return lists;
+}
+
+template <typename Key>
+static bool key_in(Key key, const Key* keys, size_t count) {
+    return !keys || std::find(keys, keys + count, key) != keys + count;
+}
+
+// The snapshot models matching query, in id order. The smallest index that
+// applies yields the candidates; only those are checked against the rest.
+static void query_models(const RegistrySnapshot& snapshot, const rac_model_query_t& query,
+                         std::vector<const rac_model_info_t*>* out) {
+    const bool by_download = query.downloaded_only == RAC_TRUE;
+    if (!query.frameworks && !query.categories && !by_download) {
+        *out = snapshot.models;
+        return;
+    }
+
+    std::vector<const std::vector<uint32_t>*> candidates;
+    size_t best = SIZE_MAX;
+    if (by_download) {
+        candidates = {&snapshot.downloaded};
+        best = snapshot.downloaded.size();
+    }
+    size_t total = 0;
+    if (query.frameworks) {
+        auto lists =
+            index_lists(snapshot.by_framework, query.frameworks, query.framework_count, &total);
+        if (total < best) {
+            candidates = std::move(lists);
+            best = total;
+        }
+    }
+    if (query.categories) {
+        auto lists =
+            index_lists(snapshot.by_category, query.categories, query.category_count, &total);
+        if (total < best) {
+            candidates = std::move(lists);
+            best = total;
+        }
+    }
+
+    std::vector<uint32_t> merged;
+    const std::vector<uint32_t>* positions = candidates.empty() ? &merged : candidates[0];
+    if (candidates.size() > 1) {
+        merged.reserve(best);
+        for (const auto* list : candidates) {
+            merged.insert(merged.end(), list->begin(), list->end());
+        }
+        std::sort(merged.begin(), merged.end());
+        positions = &merged;
+    }
+
+    out->clear();
+    out->reserve(positions->size());
+    for (uint32_t position : *positions) {
+        const rac_model_info_t* model = snapshot.models[position];
+        if (key_in(model->framework, query.frameworks, query.framework_count) &&
+            key_in(model->category, query.categories, query.category_count) &&
+            (!by_download || rac_model_info_is_downloaded(model))) {
+            out->push_back(model);
+        }
+    }
+}
+
+// Deep copies of the snapshot models matching query, made without the mutex
+static rac_result_t copy_models(rac_model_registry* registry, const rac_model_query_t& query,
+                                rac_model_info_t*** out_models, size_t* out_count) {
+    const SnapshotPtr snapshot = current_snapshot(registry);
+
+    std::vector<const rac_model_info_t*> matches;
+    query_models(*snapshot, query, &matches);
+
+    *out_count = matches.size();
+    if (*out_count == 0) {
+        *out_models = nullptr;
+        return RAC_SUCCESS;
+    }
+
+    *out_models = static_cast<rac_model_info_t**>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_MODEL, sizeof(rac_model_info_t*) * *out_count));
+    if (!*out_models) {
+        *out_count = 0;
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+
+    for (size_t i = 0; i < matches.size(); ++i) {
+        (*out_models)[i] = deep_copy_model(matches[i]);
+        if (!(*out_models)[i]) {
+            // Cleanup on error
+            for (size_t j = 0; j < i; ++j) {
+                free_model_info((*out_models)[j]);
+            }
+            rac_free(*out_models);
+            *out_models = nullptr;
+            *out_count = 0;
+            return RAC_ERROR_OUT_OF_MEMORY;
         }
-        free(model->tags);
     }
 
-    free(model);
+    return RAC_SUCCESS;
 }
 
 // =============================================================================
@@ -140,16 +879,79 @@ void rac_model_registry_destroy(rac_model_registry_handle_t handle) {
         return;
     }
 
-    // Free all stored models
-    for (auto& pair : handle->models) {
-        free_model_info(pair.second);
+    if (!handle->index_path.empty() && handle->index_dirty &&
+        write_index(handle) != RAC_SUCCESS) {
+        RAC_LOG_WARNING("ModelRegistry", "Could not write the registry index");
     }
-    handle->models.clear();
 
+    // Stored models are freed with their entries
     delete handle;
     RAC_LOG_DEBUG("ModelRegistry", "Model registry destroyed");
 }
 
+// =============================================================================
+// PUBLIC API - PERSISTENT INDEX
+// =============================================================================
+
+rac_result_t rac_model_registry_open_index(rac_model_registry_handle_t handle,
+                                           const char* index_path) {
+    if (!handle || !index_path || index_path[0] == '\0') {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    handle->index_path = index_path;
+
+    const int fd = ::open(index_path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        // First start: the index is written on the next flush
+        handle->index_dirty = true;
+        RAC_LOG_DEBUG("ModelRegistry", "No registry index yet at %s", index_path);
+        return RAC_SUCCESS;
+    }
+    struct stat st = {};
+    auto mapping = std::make_shared<IndexMapping>();
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            mapping->data = static_cast<const char*>(data);
+            mapping->size = static_cast<size_t>(st.st_size);
+        }
+    }
+    ::close(fd);
+
+    size_t loaded = 0;
+    const rac_result_t result =
+        mapping->data ? load_index(handle, mapping, &loaded) : RAC_ERROR_INVALID_FORMAT;
+    if (result != RAC_SUCCESS) {
+        // A damaged index is rebuilt from what the app registers
+        RAC_LOG_WARNING("ModelRegistry", "Ignoring unreadable registry index %s", index_path);
+        handle->index_dirty = true;
+        return RAC_SUCCESS;
+    }
+
+    handle->snapshot_stale.store(true, std::memory_order_release);
+    RAC_LOG_INFO("ModelRegistry", "Loaded %zu models from the registry index", loaded);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_model_registry_flush_index(rac_model_registry_handle_t handle) {
+    if (!handle) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    if (handle->index_path.empty() || !handle->index_dirty) {
+        return RAC_SUCCESS;
+    }
+
+    const rac_result_t result = write_index(handle);
+    if (result == RAC_SUCCESS) {
+        handle->index_dirty = false;
+    }
+    return result;
+}
+
 // =============================================================================
 // PUBLIC API - MODEL INFO
 // =============================================================================
@@ -164,19 +966,21 @@ rac_result_t rac_model_registry_save(rac_model_registry_handle_t handle,
 
     std::string model_id = model->id;
 
-    // If model already exists, free the old one
-    auto it = handle->models.find(model_id);
-    if (it != handle->models.end()) {
-        free_model_info(it->second);
-    }
-
-    // Store a deep copy
-    rac_model_info_t* copy = deep_copy_model(model);
-    if (!copy) {
+    // Store a deep copy; views of the old entry keep it alive
+    auto entry = std::make_shared<ModelEntry>();
+    entry->info = deep_copy_model(model);
+    if (!entry->info) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
+    record_local_path(*entry);
 
-    handle->models[model_id] = copy;
+    auto old = handle->models.find(model_id);
+    if (old != handle->models.end()) {
+        invalidate_dir_sizes(handle, old->second->info->local_path);
+    }
+    invalidate_dir_sizes(handle, entry->info->local_path);
+    handle->models[model_id] = std::move(entry);
+    mark_changed(handle);
 
     RAC_LOG_DEBUG("ModelRegistry", "Model saved");
 
@@ -196,7 +1000,8 @@ rac_result_t rac_model_registry_get(rac_model_registry_handle_t handle, const ch
         return RAC_ERROR_NOT_FOUND;
     }
 
-    *out_model = deep_copy_model(it->second);
+    verify_entry(handle, it->second);
+    *out_model = deep_copy_model(it->second->info);
     if (!*out_model) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
@@ -204,93 +1009,65 @@ rac_result_t rac_model_registry_get(rac_model_registry_handle_t handle, const ch
     return RAC_SUCCESS;
 }
 
-rac_result_t rac_model_registry_get_all(rac_model_registry_handle_t handle,
-                                        rac_model_info_t*** out_models, size_t* out_count) {
-    if (!handle || !out_models || !out_count) {
+rac_result_t rac_model_registry_acquire(rac_model_registry_handle_t handle, const char* model_id,
+                                        const rac_model_info_t** out_model) {
+    if (!handle || !model_id || !out_model) {
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
     std::lock_guard<std::mutex> lock(handle->mutex);
 
-    *out_count = handle->models.size();
-    if (*out_count == 0) {
-        *out_models = nullptr;
-        return RAC_SUCCESS;
-    }
-
-    *out_models = static_cast<rac_model_info_t**>(malloc(sizeof(rac_model_info_t*) * *out_count));
-    if (!*out_models) {
-        return RAC_ERROR_OUT_OF_MEMORY;
+    auto it = handle->models.find(model_id);
+    if (it == handle->models.end()) {
+        return RAC_ERROR_NOT_FOUND;
     }
 
-    size_t i = 0;
-    for (const auto& pair : handle->models) {
-        (*out_models)[i] = deep_copy_model(pair.second);
-        if (!(*out_models)[i]) {
-            // Cleanup on error
-            for (size_t j = 0; j < i; ++j) {
-                free_model_info((*out_models)[j]);
-            }
-            free(*out_models);
-            *out_models = nullptr;
-            *out_count = 0;
-            return RAC_ERROR_OUT_OF_MEMORY;
-        }
-        ++i;
-    }
+    verify_entry(handle, it->second);
+    View& view = handle->views[it->second->info];
+    view.entry = it->second;
+    view.count++;
+    *out_model = it->second->info;
 
     return RAC_SUCCESS;
 }
 
-rac_result_t rac_model_registry_get_by_frameworks(rac_model_registry_handle_t handle,
-                                                  const rac_inference_framework_t* frameworks,
-                                                  size_t framework_count,
-                                                  rac_model_info_t*** out_models,
-                                                  size_t* out_count) {
-    if (!handle || !frameworks || framework_count == 0 || !out_models || !out_count) {
-        return RAC_ERROR_INVALID_ARGUMENT;
+void rac_model_registry_release(rac_model_registry_handle_t handle,
+                                const rac_model_info_t* model) {
+    if (!handle || !model) {
+        return;
     }
 
     std::lock_guard<std::mutex> lock(handle->mutex);
 
-    // Collect matching models
-    std::vector<rac_model_info_t*> matches;
-
-    for (const auto& pair : handle->models) {
-        for (size_t i = 0; i < framework_count; ++i) {
-            if (pair.second->framework == frameworks[i]) {
-                matches.push_back(pair.second);
-                break;
-            }
-        }
+    auto it = handle->views.find(model);
+    if (it != handle->views.end() && --it->second.count == 0) {
+        handle->views.erase(it);
     }
+}
 
-    *out_count = matches.size();
-    if (*out_count == 0) {
-        *out_models = nullptr;
-        return RAC_SUCCESS;
+rac_result_t rac_model_registry_get_all(rac_model_registry_handle_t handle,
+                                        rac_model_info_t*** out_models, size_t* out_count) {
+    if (!handle || !out_models || !out_count) {
+        return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    *out_models = static_cast<rac_model_info_t**>(malloc(sizeof(rac_model_info_t*) * *out_count));
-    if (!*out_models) {
-        return RAC_ERROR_OUT_OF_MEMORY;
-    }
+    const rac_model_query_t all = {};
+    return copy_models(handle, all, out_models, out_count);
+}
 
-    for (size_t i = 0; i < matches.size(); ++i) {
-        (*out_models)[i] = deep_copy_model(matches[i]);
-        if (!(*out_models)[i]) {
-            // Cleanup on error
-            for (size_t j = 0; j < i; ++j) {
-                free_model_info((*out_models)[j]);
-            }
-            free(*out_models);
-            *out_models = nullptr;
-            *out_count = 0;
-            return RAC_ERROR_OUT_OF_MEMORY;
-        }
+rac_result_t rac_model_registry_get_by_frameworks(rac_model_registry_handle_t handle,
+                                                  const rac_inference_framework_t* frameworks,
+                                                  size_t framework_count,
+                                                  rac_model_info_t*** out_models,
+                                                  size_t* out_count) {
+    if (!handle || !frameworks || framework_count == 0 || !out_models || !out_count) {
+        return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    return RAC_SUCCESS;
+    rac_model_query_t query = {};
+    query.frameworks = frameworks;
+    query.framework_count = framework_count;
+    return copy_models(handle, query, out_models, out_count);
 }
 
 rac_result_t rac_model_registry_update_last_used(rac_model_registry_handle_t handle,
@@ -306,9 +1083,13 @@ rac_result_t rac_model_registry_update_last_used(rac_model_registry_handle_t han
         return RAC_ERROR_NOT_FOUND;
     }
 
-    rac_model_info_t* model = it->second;
+    rac_model_info_t* model = writable_model(it->second);
+    if (!model) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
     model->last_used = rac_get_current_time_ms() / 1000;  // Convert to seconds
     model->usage_count++;
+    mark_changed(handle);
 
     return RAC_SUCCESS;
 }
@@ -325,8 +1106,9 @@ rac_result_t rac_model_registry_remove(rac_model_registry_handle_t handle, const
         return RAC_ERROR_NOT_FOUND;
     }
 
-    free_model_info(it->second);
+    invalidate_dir_sizes(handle, it->second->info->local_path);
     handle->models.erase(it);
+    mark_changed(handle);
 
     RAC_LOG_DEBUG("ModelRegistry", "Model removed");
 
@@ -339,36 +1121,131 @@ rac_result_t rac_model_registry_get_downloaded(rac_model_registry_handle_t handl
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    std::lock_guard<std::mutex> lock(handle->mutex);
+    rac_model_query_t query = {};
+    query.downloaded_only = RAC_TRUE;
+    return copy_models(handle, query, out_models, out_count);
+}
 
-    // Collect downloaded models
-    std::vector<rac_model_info_t*> downloaded;
+// =============================================================================
+// PUBLIC API - SNAPSHOTS
+// =============================================================================
 
-    for (const auto& pair : handle->models) {
-        if (pair.second->local_path && strlen(pair.second->local_path) > 0) {
-            downloaded.push_back(pair.second);
-        }
+rac_result_t rac_model_registry_snapshot(rac_model_registry_handle_t handle,
+                                         rac_model_snapshot_handle_t* out_snapshot,
+                                         const rac_model_info_t* const** out_models,
+                                         size_t* out_count) {
+    if (!handle || !out_snapshot || !out_models || !out_count) {
+        return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    *out_count = downloaded.size();
-    if (*out_count == 0) {
-        *out_models = nullptr;
-        return RAC_SUCCESS;
+    auto* snapshot = new rac_model_snapshot();
+    snapshot->data = current_snapshot(handle);
+
+    *out_snapshot = snapshot;
+    *out_models = snapshot->data->models.empty() ? nullptr : snapshot->data->models.data();
+    *out_count = snapshot->data->models.size();
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_model_registry_snapshot_query(rac_model_registry_handle_t handle,
+                                               const rac_model_query_t* query,
+                                               rac_model_snapshot_handle_t* out_snapshot,
+                                               const rac_model_info_t* const** out_models,
+                                               size_t* out_count) {
+    if (!handle || !out_snapshot || !out_models || !out_count ||
+        (query && ((!query->frameworks && query->framework_count > 0) ||
+                   (!query->categories && query->category_count > 0)))) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    auto* snapshot = new rac_model_snapshot();
+    snapshot->data = current_snapshot(handle);
+    const rac_model_query_t all = {};
+    query_models(*snapshot->data, query ? *query : all, &snapshot->matches);
+
+    *out_snapshot = snapshot;
+    *out_models = snapshot->matches.empty() ? nullptr : snapshot->matches.data();
+    *out_count = snapshot->matches.size();
+    return RAC_SUCCESS;
+}
+
+void rac_model_snapshot_release(rac_model_snapshot_handle_t snapshot) {
+    delete snapshot;
+}
+
+// Approximate bits per weight of a GGML quantization name, used to order
+// variants by quality; unquantized models default to f16
+static float quantization_bits(const char* quantization) {
+    if (!quantization || quantization[0] == '\0') {
+        return 16.0f;
+    }
+    std::string q = quantization;
+    std::transform(q.begin(), q.end(), q.begin(), ::tolower);
+    if (q == "f32") {
+        return 32.0f;
+    }
+    if (q == "f16" || q == "bf16") {
+        return 16.0f;
+    }
+    if (q.size() >= 2 && q[0] == 'q' && q[1] >= '1' && q[1] <= '9') {
+        // q5_1 and q4_1 also store a per-block minimum
+        return static_cast<float>(q[1] - '0') + (q.size() > 3 && q[3] == '1' ? 0.5f : 0.0f);
+    }
+    return 16.0f;
+}
+
+rac_result_t rac_model_registry_get_variants(rac_model_registry_handle_t handle,
+                                             const char* model_id, rac_model_info_t*** out_models,
+                                             size_t* out_count) {
+    if (!handle || !model_id || !out_models || !out_count) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+
+    auto it = handle->models.find(model_id);
+    if (it == handle->models.end()) {
+        return RAC_ERROR_NOT_FOUND;
     }
+    const rac_model_info_t* base = it->second->info;
+    const std::string base_id = base->variant_of ? base->variant_of : model_id;
 
-    *out_models = static_cast<rac_model_info_t**>(malloc(sizeof(rac_model_info_t*) * *out_count));
+    std::vector<rac_model_info_t*> family;
+    for (auto& pair : handle->models) {
+        const rac_model_info_t* model = pair.second->info;
+        if (pair.first == base_id || (model->variant_of && base_id == model->variant_of)) {
+            verify_entry(handle, pair.second);
+            family.push_back(pair.second->info);
+        }
+    }
+
+    // Best quality first: more bits per weight, then the costlier variant
+    std::stable_sort(family.begin(), family.end(),
+                     [](const rac_model_info_t* a, const rac_model_info_t* b) {
+                         const float bits_a = quantization_bits(a->quantization);
+                         const float bits_b = quantization_bits(b->quantization);
+                         if (bits_a != bits_b) {
+                             return bits_a > bits_b;
+                         }
+                         return a->expected_rtf > b->expected_rtf;
+                     });
+
+    *out_count = family.size();
+    *out_models = static_cast<rac_model_info_t**>(
+        rac_alloc_tagged(RAC_ALLOC_TAG_MODEL, sizeof(rac_model_info_t*) * *out_count));
     if (!*out_models) {
+        *out_count = 0;
         return RAC_ERROR_OUT_OF_MEMORY;
     }
 
-    for (size_t i = 0; i < downloaded.size(); ++i) {
-        (*out_models)[i] = deep_copy_model(downloaded[i]);
+    for (size_t i = 0; i < family.size(); ++i) {
+        (*out_models)[i] = deep_copy_model(family[i]);
         if (!(*out_models)[i]) {
             // Cleanup on error
             for (size_t j = 0; j < i; ++j) {
                 free_model_info((*out_models)[j]);
             }
-            free(*out_models);
+            rac_free(*out_models);
             *out_models = nullptr;
             *out_count = 0;
             return RAC_ERROR_OUT_OF_MEMORY;
@@ -385,27 +1262,106 @@ rac_result_t rac_model_registry_update_download_status(rac_model_registry_handle
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
+    // Header metadata fills in what the catalog left out; read it before
+    // locking (a few pages of the file, not the weights)
+    rac_gguf_metadata_t metadata = {};
+    const bool has_metadata =
+        local_path && rac_gguf_metadata_read(local_path, &metadata) == RAC_SUCCESS;
+
     std::lock_guard<std::mutex> lock(handle->mutex);
 
     auto it = handle->models.find(model_id);
+    rac_model_info_t* model = it != handle->models.end() ? writable_model(it->second) : nullptr;
+    if (model && has_metadata &&
+        (model->format == RAC_MODEL_FORMAT_GGUF || model->format == RAC_MODEL_FORMAT_UNKNOWN)) {
+        rac_gguf_metadata_apply(&metadata, model);
+    }
+    rac_gguf_metadata_free(&metadata);
     if (it == handle->models.end()) {
         return RAC_ERROR_NOT_FOUND;
     }
-
-    rac_model_info_t* model = it->second;
+    if (!model) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
 
     // Free old local path
     if (model->local_path) {
-        free(model->local_path);
+        invalidate_dir_sizes(handle, model->local_path);
+        rac_free(model->local_path);
     }
+    invalidate_dir_sizes(handle, local_path);
 
     // Set new local path
     model->local_path = rac_strdup(local_path);
     model->updated_at = rac_get_current_time_ms() / 1000;
+    record_local_path(*it->second);
+    mark_changed(handle);
+
+    return RAC_SUCCESS;
+}
+
+// =============================================================================
+// PUBLIC API - DIRECTORY SIZES
+// =============================================================================
+
+rac_result_t rac_model_registry_get_dir_size(rac_model_registry_handle_t handle, const char* path,
+                                             int64_t* out_size, int64_t* out_mtime_ns) {
+    if (!handle || !path || !out_size || !out_mtime_ns) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    int64_t mtime_ns = 0;
+    int64_t size = 0;
+    if (!stat_path(path, &mtime_ns, &size)) {
+        mtime_ns = 0;
+    }
+    *out_mtime_ns = mtime_ns;
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    auto it = handle->dir_sizes.find(path);
+    if (it == handle->dir_sizes.end()) {
+        return RAC_ERROR_NOT_FOUND;
+    }
+    if (mtime_ns == 0 || mtime_ns != it->second.mtime_ns) {
+        handle->dir_sizes.erase(it);
+        handle->index_dirty = true;
+        return RAC_ERROR_NOT_FOUND;
+    }
+    *out_size = it->second.size;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_model_registry_set_dir_size(rac_model_registry_handle_t handle, const char* path,
+                                             int64_t mtime_ns, int64_t size) {
+    if (!handle || !path || path[0] == '\0' || mtime_ns == 0 || size < 0) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
 
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    DirSize& entry = handle->dir_sizes[path];
+    if (entry.mtime_ns != mtime_ns || entry.size != size) {
+        entry.mtime_ns = mtime_ns;
+        entry.size = size;
+        handle->index_dirty = true;
+    }
     return RAC_SUCCESS;
 }
 
+void rac_model_registry_invalidate_dir_size(rac_model_registry_handle_t handle,
+                                            const char* path) {
+    if (!handle) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(handle->mutex);
+    if (!path) {
+        handle->index_dirty = handle->index_dirty || !handle->dir_sizes.empty();
+        handle->dir_sizes.clear();
+        return;
+    }
+    invalidate_dir_sizes(handle, path);
+}
+
 // =============================================================================
 // PUBLIC API - QUERY HELPERS
 // =============================================================================
@@ -513,6 +1469,32 @@ static bool is_valid_model_folder(const rac_discovery_callbacks_t* callbacks,
     return found_model_file;
 }
 
+// is_valid_model_folder, skipped while the folder's mtime matches the last check
+static bool check_model_folder(rac_model_registry* registry,
+                               const rac_discovery_callbacks_t* callbacks,
+                               const std::string& folder_path,
+                               rac_inference_framework_t framework) {
+    int64_t mtime_ns = 0;
+    int64_t size = 0;
+    if (registry->index_path.empty() || !stat_path(folder_path.c_str(), &mtime_ns, &size)) {
+        return is_valid_model_folder(callbacks, folder_path.c_str(), framework);
+    }
+
+    auto it = registry->folder_checks.find(folder_path);
+    if (it != registry->folder_checks.end() && it->second.mtime_ns == mtime_ns &&
+        it->second.framework == framework) {
+        return it->second.valid;
+    }
+
+    FolderCheck check;
+    check.mtime_ns = mtime_ns;
+    check.framework = framework;
+    check.valid = is_valid_model_folder(callbacks, folder_path.c_str(), framework);
+    registry->folder_checks[folder_path] = check;
+    registry->index_dirty = true;
+    return check.valid;
+}
+
 rac_result_t rac_model_registry_discover_downloaded(rac_model_registry_handle_t handle,
                                                     const rac_discovery_callbacks_t* callbacks,
                                                     rac_discovery_result_t* out_result) {
@@ -601,7 +1583,7 @@ rac_result_t rac_model_registry_discover_downloaded(rac_model_registry_handle_t
             }
 
             // Check if it contains valid model files
-            if (!is_valid_model_folder(callbacks, model_path.c_str(), framework)) {
+            if (!check_model_folder(handle, callbacks, model_path, framework)) {
                 continue;
             }
 
@@ -609,15 +1591,19 @@ rac_result_t rac_model_registry_discover_downloaded(rac_model_registry_handle_t
             auto it = handle->models.find(model_id);
             if (it != handle->models.end()) {
                 // Model is registered - check if it needs update
-                rac_model_info_t* model = it->second;
+                const rac_model_info_t* current = it->second->info;
+                rac_model_info_t* model = nullptr;
 
-                if (!model->local_path || strlen(model->local_path) == 0) {
+                if ((!current->local_path || strlen(current->local_path) == 0) &&
+                    (model = writable_model(it->second)) != nullptr) {
                     // Update the local path
                     if (model->local_path) {
-                        free(model->local_path);
+                        rac_free(model->local_path);
                     }
                     model->local_path = rac_strdup(model_path.c_str());
                     model->updated_at = rac_get_current_time_ms() / 1000;
+                    record_local_path(*it->second);
+                    mark_changed(handle);
 
                     // Add to discovered list
                     rac_discovered_model_t disc;
@@ -646,7 +1632,8 @@ rac_result_t rac_model_registry_discover_downloaded(rac_model_registry_handle_t
 
     if (!discovered.empty()) {
         out_result->discovered_models = static_cast<rac_discovered_model_t*>(
-            malloc(sizeof(rac_discovered_model_t) * discovered.size()));
+            rac_alloc_tagged(RAC_ALLOC_TAG_MODEL,
+                             sizeof(rac_discovered_model_t) * discovered.size()));
         if (out_result->discovered_models) {
             for (size_t i = 0; i < discovered.size(); i++) {
                 out_result->discovered_models[i] = discovered[i];
@@ -666,13 +1653,13 @@ void rac_discovery_result_free(rac_discovery_result_t* result) {
     if (result->discovered_models) {
         for (size_t i = 0; i < result->discovered_count; i++) {
             if (result->discovered_models[i].model_id) {
-                free(const_cast<char*>(result->discovered_models[i].model_id));
+                rac_free(const_cast<char*>(result->discovered_models[i].model_id));
             }
             if (result->discovered_models[i].local_path) {
-                free(const_cast<char*>(result->discovered_models[i].local_path));
+                rac_free(const_cast<char*>(result->discovered_models[i].local_path));
             }
         }
-        free(result->discovered_models);
+        rac_free(result->discovered_models);
     }
 
     result->discovered_models = nullptr;
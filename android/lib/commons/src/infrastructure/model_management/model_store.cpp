@@ -0,0 +1,362 @@
+/**
+ * @file model_store.cpp
+ * @brief Content-Addressed Model Storage Implementation
+ *
+ * Files are hashed without holding the lock. The lock then covers each
+ * check-and-link step, so two models with the same file that finish at the
+ * same time end up linked to one stored copy. A model file is replaced by
+ * linking the stored copy to a temporary name and renaming that over the
+ * file, so a reader never finds the path missing.
+ */
+
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rac/core/rac_logger.h"
+#include "rac/core/rac_sha256.h"
+#include "rac/infrastructure/model_management/rac_model_paths.h"
+#include "rac/infrastructure/model_management/rac_model_store.h"
+
+namespace {
+
+const char* LOG_CAT = "ModelStore";
+
+constexpr size_t kHashBufferSize = 1024 * 1024;
+constexpr int kMaxFolderDepth = 8;
+constexpr const char* kTempSuffix = ".store-tmp";
+
+std::mutex g_store_mutex;
+
+std::string store_directory() {
+    char base[PATH_MAX];
+    if (rac_model_paths_get_base_directory(base, sizeof(base)) != RAC_SUCCESS) {
+        return {};
+    }
+    return std::string(base) + "/Store";
+}
+
+// Canonical models directory with a trailing slash, or "" if unset
+std::string models_prefix() {
+    char models[PATH_MAX];
+    char resolved[PATH_MAX];
+    if (rac_model_paths_get_models_directory(models, sizeof(models)) != RAC_SUCCESS ||
+        realpath(models, resolved) == nullptr) {
+        return {};
+    }
+    return std::string(resolved) + "/";
+}
+
+bool in_models_directory(const char* path, const std::string& prefix) {
+    char resolved[PATH_MAX];
+    return realpath(path, resolved) != nullptr &&
+           strncmp(resolved, prefix.c_str(), prefix.size()) == 0;
+}
+
+// Lowercase copy of a 64-digit hex digest, or "" if it is not one
+std::string normalize_hex(const char* hex) {
+    std::string out;
+    if (!hex || strlen(hex) != RAC_SHA256_HEX_LENGTH) {
+        return out;
+    }
+    for (const char* c = hex; *c; ++c) {
+        if (!isxdigit(static_cast<unsigned char>(*c))) {
+            return {};
+        }
+        out += static_cast<char>(tolower(static_cast<unsigned char>(*c)));
+    }
+    return out;
+}
+
+bool hash_file(const std::string& path, std::string* out_hex) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    std::vector<uint8_t> buffer(kHashBufferSize);
+    rac_sha256_t sha;
+    rac_sha256_init(&sha);
+    ssize_t got;
+    while ((got = read(fd, buffer.data(), buffer.size())) > 0) {
+        rac_sha256_update(&sha, buffer.data(), static_cast<size_t>(got));
+    }
+    close(fd);
+    if (got < 0) {
+        return false;
+    }
+    uint8_t digest[RAC_SHA256_DIGEST_SIZE];
+    char hex[RAC_SHA256_HEX_LENGTH + 1];
+    rac_sha256_final(&sha, digest);
+    rac_sha256_to_hex(digest, hex);
+    *out_hex = hex;
+    return true;
+}
+
+bool make_directory(const std::string& path) {
+    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool is_link_unsupported(int error) {
+    return error == EXDEV || error == EPERM || error == ENOTSUP || error == EMLINK;
+}
+
+// Shares path through the store entry for hex; the caller holds g_store_mutex
+rac_result_t link_locked(const std::string& path, const struct stat& st,
+                         const std::string& store, const std::string& hex,
+                         rac_model_store_stats_t* stats) {
+    const std::string shard = store + "/sha256/" + hex.substr(0, 2);
+    const std::string blob = shard + "/" + hex;
+
+    struct stat blob_st = {};
+    if (stat(blob.c_str(), &blob_st) == 0) {
+        if (blob_st.st_dev == st.st_dev && blob_st.st_ino == st.st_ino) {
+            return RAC_SUCCESS;
+        }
+        if (blob_st.st_size != st.st_size) {
+            RAC_LOG_WARNING(LOG_CAT, "Stored %s has the wrong size; not linking %s", hex.c_str(),
+                            path.c_str());
+            return RAC_ERROR_CHECKSUM_MISMATCH;
+        }
+        const std::string temp = path + kTempSuffix;
+        unlink(temp.c_str());
+        if (link(blob.c_str(), temp.c_str()) != 0) {
+            return is_link_unsupported(errno) ? RAC_ERROR_NOT_SUPPORTED
+                                              : RAC_ERROR_FILE_WRITE_FAILED;
+        }
+        if (rename(temp.c_str(), path.c_str()) != 0) {
+            unlink(temp.c_str());
+            return RAC_ERROR_FILE_WRITE_FAILED;
+        }
+        stats->files_linked++;
+        stats->bytes_saved += static_cast<int64_t>(st.st_size);
+        RAC_LOG_INFO(LOG_CAT, "Linked %s to stored %s (%lld bytes saved)", path.c_str(),
+                     hex.c_str(), static_cast<long long>(st.st_size));
+        return RAC_SUCCESS;
+    }
+
+    if (!make_directory(store) || !make_directory(store + "/sha256") || !make_directory(shard)) {
+        return RAC_ERROR_FILE_WRITE_FAILED;
+    }
+    if (link(path.c_str(), blob.c_str()) != 0) {
+        return is_link_unsupported(errno) ? RAC_ERROR_NOT_SUPPORTED : RAC_ERROR_FILE_WRITE_FAILED;
+    }
+    // Shared by every link: an in-place write would change all the models
+    chmod(blob.c_str(), 0444);
+    stats->files_added++;
+    return RAC_SUCCESS;
+}
+
+rac_result_t add_file(const std::string& path, const std::string& known_hex,
+                      const std::string& store, rac_model_store_stats_t* stats) {
+    struct stat st = {};
+    if (lstat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::string hex = known_hex;
+    if (hex.empty() && !hash_file(path, &hex)) {
+        return RAC_ERROR_FILE_READ_FAILED;
+    }
+
+    std::lock_guard<std::mutex> lock(g_store_mutex);
+    // The file may have been replaced while it was hashed
+    struct stat now = {};
+    if (lstat(path.c_str(), &now) != 0 || now.st_ino != st.st_ino || now.st_size != st.st_size ||
+        now.st_mtime != st.st_mtime) {
+        return RAC_ERROR_FILE_READ_FAILED;
+    }
+    return link_locked(path, now, store, hex, stats);
+}
+
+void add_folder(const std::string& folder, const std::string& store, int depth,
+                rac_model_store_stats_t* stats) {
+    DIR* dir = opendir(folder.c_str());
+    if (!dir) {
+        return;
+    }
+    std::vector<std::string> files;
+    std::vector<std::string> folders;
+    while (dirent* entry = readdir(dir)) {
+        const char* name = entry->d_name;
+        if (name[0] == '.') {
+            continue;
+        }
+        const std::string path = folder + "/" + name;
+        struct stat st = {};
+        if (lstat(path.c_str(), &st) != 0) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            folders.push_back(path);
+        } else if (S_ISREG(st.st_mode) && st.st_size >= RAC_MODEL_STORE_MIN_FILE_SIZE &&
+                   st.st_nlink == 1) {
+            files.push_back(path);
+        }
+    }
+    closedir(dir);
+
+    for (const std::string& file : files) {
+        const rac_result_t result = add_file(file, std::string(), store, stats);
+        if (result == RAC_ERROR_NOT_SUPPORTED) {
+            RAC_LOG_DEBUG(LOG_CAT, "No hard links under %s; keeping copies", folder.c_str());
+            return;
+        }
+    }
+    if (depth < kMaxFolderDepth) {
+        for (const std::string& child : folders) {
+            add_folder(child, store, depth + 1, stats);
+        }
+    }
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+rac_result_t rac_model_store_get_directory(char* out_path, size_t path_size) {
+    if (!out_path || path_size == 0) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    const std::string store = store_directory();
+    if (store.empty()) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+    if (store.size() >= path_size) {
+        return RAC_ERROR_BUFFER_TOO_SMALL;
+    }
+    memcpy(out_path, store.c_str(), store.size() + 1);
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_model_store_add_file(const char* path, const char* sha256_hex,
+                                      rac_model_store_stats_t* out_stats) {
+    rac_model_store_stats_t stats = {};
+    if (out_stats) {
+        *out_stats = stats;
+    }
+    if (!path) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    const std::string store = store_directory();
+    const std::string prefix = models_prefix();
+    if (store.empty() || prefix.empty()) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+    if (!in_models_directory(path, prefix)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    const std::string hex = normalize_hex(sha256_hex);
+    if (sha256_hex && hex.empty()) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    const rac_result_t result = add_file(path, hex, store, &stats);
+    if (out_stats) {
+        *out_stats = stats;
+    }
+    return result;
+}
+
+rac_result_t rac_model_store_add_folder(const char* folder, rac_model_store_stats_t* out_stats) {
+    rac_model_store_stats_t stats = {};
+    if (out_stats) {
+        *out_stats = stats;
+    }
+    if (!folder) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    const std::string store = store_directory();
+    const std::string prefix = models_prefix();
+    if (store.empty() || prefix.empty()) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+    char resolved[PATH_MAX];
+    if (realpath(folder, resolved) == nullptr) {
+        return RAC_ERROR_FILE_NOT_FOUND;
+    }
+    const std::string root = resolved;
+    if ((root + "/").compare(0, prefix.size(), prefix) != 0) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    add_folder(root, store, 0, &stats);
+    if (stats.files_linked > 0) {
+        RAC_LOG_INFO(LOG_CAT, "%s: linked %d files to stored copies, %lld bytes saved",
+                     root.c_str(), stats.files_linked, static_cast<long long>(stats.bytes_saved));
+    }
+    if (out_stats) {
+        *out_stats = stats;
+    }
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_model_store_prune(int32_t* out_removed, int64_t* out_bytes_freed) {
+    if (out_removed) {
+        *out_removed = 0;
+    }
+    if (out_bytes_freed) {
+        *out_bytes_freed = 0;
+    }
+    const std::string store = store_directory();
+    if (store.empty()) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    int32_t removed = 0;
+    int64_t freed = 0;
+    std::lock_guard<std::mutex> lock(g_store_mutex);
+    const std::string root = store + "/sha256";
+    DIR* shards = opendir(root.c_str());
+    if (!shards) {
+        return RAC_SUCCESS;
+    }
+    while (dirent* shard = readdir(shards)) {
+        if (shard->d_name[0] == '.') {
+            continue;
+        }
+        const std::string shard_path = root + "/" + shard->d_name;
+        DIR* blobs = opendir(shard_path.c_str());
+        if (!blobs) {
+            continue;
+        }
+        while (dirent* blob = readdir(blobs)) {
+            if (blob->d_name[0] == '.') {
+                continue;
+            }
+            const std::string blob_path = shard_path + "/" + blob->d_name;
+            struct stat st = {};
+            if (lstat(blob_path.c_str(), &st) == 0 && S_ISREG(st.st_mode) && st.st_nlink <= 1 &&
+                unlink(blob_path.c_str()) == 0) {
+                removed++;
+                freed += static_cast<int64_t>(st.st_size);
+            }
+        }
+        closedir(blobs);
+        rmdir(shard_path.c_str());  // Only succeeds once empty
+    }
+    closedir(shards);
+
+    if (removed > 0) {
+        RAC_LOG_INFO(LOG_CAT, "Pruned %d unreferenced files (%lld bytes)", removed,
+                     static_cast<long long>(freed));
+    }
+    if (out_removed) {
+        *out_removed = removed;
+    }
+    if (out_bytes_freed) {
+        *out_bytes_freed = freed;
+    }
+    return RAC_SUCCESS;
+}
@@ -11,7 +11,12 @@
 #include <mutex>
 #include <unordered_map>
 
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
+#include "rac/infrastructure/download/rac_archive_stream.h"
 #include "rac/infrastructure/model_management/rac_model_strategy.h"
 
 namespace {
@@ -30,6 +35,37 @@ StrategyRegistry& get_registry() {
     return registry;
 }
 
+// Archives from a native transfer arrive already extracted (downloaded_path is
+// their directory); others are extracted here when this build has the codec
+rac_result_t extract_downloaded_archive(const rac_model_download_config_t* config,
+                                        const char* downloaded_path,
+                                        rac_download_result_t* out_result) {
+    struct stat st = {};
+    if (stat(downloaded_path, &st) == 0 && S_ISDIR(st.st_mode)) {
+        out_result->was_extracted = RAC_TRUE;
+        return RAC_SUCCESS;
+    }
+    if (!config->destination_folder ||
+        rac_archive_stream_supported(config->archive_type) != RAC_TRUE) {
+        return RAC_SUCCESS;  // Left to the platform extractor
+    }
+
+    int32_t file_count = 0;
+    rac_result_t result = rac_archive_extract_file(downloaded_path, config->archive_type,
+                                                   config->destination_folder, &file_count);
+    if (result != RAC_SUCCESS) {
+        RAC_LOG_ERROR(LOG_CAT, "Failed to extract %s", downloaded_path);
+        return result;
+    }
+    unlink(downloaded_path);
+
+    rac_free(out_result->final_path);
+    out_result->final_path = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, config->destination_folder);
+    out_result->was_extracted = RAC_TRUE;
+    out_result->file_count = file_count;
+    return RAC_SUCCESS;
+}
+
 }  // namespace
 
 // =============================================================================
@@ -38,14 +74,14 @@ StrategyRegistry& get_registry() {
 
 void rac_model_storage_details_free(rac_model_storage_details_t* details) {
     if (details && details->primary_file) {
-        free(details->primary_file);
+        rac_free(details->primary_file);
         details->primary_file = nullptr;
     }
 }
 
 void rac_download_result_free(rac_download_result_t* result) {
     if (result && result->final_path) {
-        free(result->final_path);
+        rac_free(result->final_path);
         result->final_path = nullptr;
     }
 }
@@ -237,10 +273,13 @@ rac_result_t rac_model_strategy_post_process(rac_inference_framework_t framework
     const rac_download_strategy_t* strategy = rac_download_strategy_get(framework);
     if (!strategy || !strategy->post_process) {
         // No custom strategy - set basic result
-        out_result->final_path = strdup(downloaded_path);
+        out_result->final_path = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, downloaded_path);
         out_result->downloaded_size = 0;  // Unknown
         out_result->was_extracted = RAC_FALSE;
         out_result->file_count = 1;
+        if (config->archive_type != RAC_ARCHIVE_TYPE_NONE) {
+            return extract_downloaded_archive(config, downloaded_path, out_result);
+        }
         return RAC_SUCCESS;
     }
 
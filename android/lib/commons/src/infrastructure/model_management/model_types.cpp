@@ -16,6 +16,7 @@
 #include <cstring>
 #include <string>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
 #include "rac/infrastructure/model_management/rac_model_types.h"
 
@@ -126,7 +127,8 @@ rac_result_t rac_framework_get_supported_formats(rac_inference_framework_t frame
     switch (framework) {
         case RAC_FRAMEWORK_ONNX: {
             *out_count = 2;
-            *out_formats = (rac_model_format_t*)malloc(2 * sizeof(rac_model_format_t));
+            *out_formats = (rac_model_format_t*)rac_alloc_tagged(RAC_ALLOC_TAG_MODEL,
+                                                                 2 * sizeof(rac_model_format_t));
             if (!*out_formats)
                 return RAC_ERROR_OUT_OF_MEMORY;
             (*out_formats)[0] = RAC_MODEL_FORMAT_ONNX;
@@ -135,7 +137,8 @@ rac_result_t rac_framework_get_supported_formats(rac_inference_framework_t frame
         }
         case RAC_FRAMEWORK_LLAMACPP: {
             *out_count = 1;
-            *out_formats = (rac_model_format_t*)malloc(sizeof(rac_model_format_t));
+            *out_formats = (rac_model_format_t*)rac_alloc_tagged(RAC_ALLOC_TAG_MODEL,
+                                                                 sizeof(rac_model_format_t));
             if (!*out_formats)
                 return RAC_ERROR_OUT_OF_MEMORY;
             (*out_formats)[0] = RAC_MODEL_FORMAT_GGUF;
@@ -143,7 +146,8 @@ rac_result_t rac_framework_get_supported_formats(rac_inference_framework_t frame
         }
         case RAC_FRAMEWORK_FLUID_AUDIO: {
             *out_count = 1;
-            *out_formats = (rac_model_format_t*)malloc(sizeof(rac_model_format_t));
+            *out_formats = (rac_model_format_t*)rac_alloc_tagged(RAC_ALLOC_TAG_MODEL,
+                                                                 sizeof(rac_model_format_t));
             if (!*out_formats)
                 return RAC_ERROR_OUT_OF_MEMORY;
             (*out_formats)[0] = RAC_MODEL_FORMAT_BIN;
@@ -561,7 +565,8 @@ size_t rac_model_filter_models(const rac_model_info_t* models, size_t models_cou
 // Note: rac_strdup is declared in rac_types.h and implemented in rac_memory.cpp
 
 rac_expected_model_files_t* rac_expected_model_files_alloc(void) {
-    auto* files = (rac_expected_model_files_t*)calloc(1, sizeof(rac_expected_model_files_t));
+    auto* files = (rac_expected_model_files_t*)rac_calloc_tagged(
+        RAC_ALLOC_TAG_MODEL, 1, sizeof(rac_expected_model_files_t));
     return files;
 }
 
@@ -571,51 +576,56 @@ void rac_expected_model_files_free(rac_expected_model_files_t* files) {
 
     if (files->required_patterns) {
         for (size_t i = 0; i < files->required_pattern_count; i++) {
-            free((void*)files->required_patterns[i]);
+            rac_free((void*)files->required_patterns[i]);
         }
-        free((void*)files->required_patterns);
+        rac_free((void*)files->required_patterns);
     }
 
     if (files->optional_patterns) {
         for (size_t i = 0; i < files->optional_pattern_count; i++) {
-            free((void*)files->optional_patterns[i]);
+            rac_free((void*)files->optional_patterns[i]);
         }
-        free((void*)files->optional_patterns);
+        rac_free((void*)files->optional_patterns);
     }
 
-    free((void*)files->description);
-    free(files);
+    rac_free((void*)files->description);
+    rac_free(files);
 }
 
 rac_model_file_descriptor_t* rac_model_file_descriptors_alloc(size_t count) {
     if (count == 0)
         return nullptr;
-    return (rac_model_file_descriptor_t*)calloc(count, sizeof(rac_model_file_descriptor_t));
+    return (rac_model_file_descriptor_t*)rac_calloc_tagged(
+        RAC_ALLOC_TAG_MODEL, count, sizeof(rac_model_file_descriptor_t));
 }
 
 void rac_model_file_descriptors_free(rac_model_file_descriptor_t* descriptors, size_t count) {
     if (!descriptors)
         return;
     for (size_t i = 0; i < count; i++) {
-        free((void*)descriptors[i].relative_path);
-        free((void*)descriptors[i].destination_path);
+        rac_free((void*)descriptors[i].relative_path);
+        rac_free((void*)descriptors[i].destination_path);
     }
-    free(descriptors);
+    rac_free(descriptors);
 }
 
 rac_model_info_t* rac_model_info_alloc(void) {
-    return (rac_model_info_t*)calloc(1, sizeof(rac_model_info_t));
+    return (rac_model_info_t*)rac_calloc_tagged(RAC_ALLOC_TAG_MODEL, 1, sizeof(rac_model_info_t));
 }
 
 void rac_model_info_free(rac_model_info_t* model) {
     if (!model)
         return;
 
-    free(model->id);
-    free(model->name);
-    free(model->download_url);
-    free(model->local_path);
-    free(model->description);
+    rac_free(model->id);
+    rac_free(model->name);
+    rac_free(model->download_url);
+    rac_free(model->local_path);
+    rac_free(model->description);
+    rac_free(model->variant_of);
+    rac_free(model->quantization);
+    rac_free(model->sha256);
+    rac_free(model->delta_manifest_url);
 
     // Free artifact info
     if (model->artifact_info.expected_files) {
@@ -625,17 +635,17 @@ void rac_model_info_free(rac_model_info_t* model) {
         rac_model_file_descriptors_free(model->artifact_info.file_descriptors,
                                         model->artifact_info.file_descriptor_count);
     }
-    free((void*)model->artifact_info.strategy_id);
+    rac_free((void*)model->artifact_info.strategy_id);
 
     // Free tags
     if (model->tags) {
         for (size_t i = 0; i < model->tag_count; i++) {
-            free(model->tags[i]);
+            rac_free(model->tags[i]);
         }
-        free(model->tags);
+        rac_free(model->tags);
     }
 
-    free(model);
+    rac_free(model);
 }
 
 void rac_model_info_array_free(rac_model_info_t** models, size_t count) {
@@ -644,7 +654,7 @@ void rac_model_info_array_free(rac_model_info_t** models, size_t count) {
     for (size_t i = 0; i < count; i++) {
         rac_model_info_free(models[i]);
     }
-    free(models);
+    rac_free(models);
 }
 
 rac_model_info_t* rac_model_info_copy(const rac_model_info_t* model) {
@@ -668,6 +678,7 @@ rac_model_info_t* rac_model_info_copy(const rac_model_info_t* model) {
     copy->updated_at = model->updated_at;
     copy->last_used = model->last_used;
     copy->usage_count = model->usage_count;
+    copy->expected_rtf = model->expected_rtf;
 
     // Copy strings
     copy->id = rac_strdup(model->id);
@@ -675,6 +686,10 @@ rac_model_info_t* rac_model_info_copy(const rac_model_info_t* model) {
     copy->download_url = rac_strdup(model->download_url);
     copy->local_path = rac_strdup(model->local_path);
     copy->description = rac_strdup(model->description);
+    copy->variant_of = rac_strdup(model->variant_of);
+    copy->quantization = rac_strdup(model->quantization);
+    copy->sha256 = rac_strdup(model->sha256);
+    copy->delta_manifest_url = rac_strdup(model->delta_manifest_url);
 
     // Copy artifact info (shallow for now - TODO: deep copy if needed)
     copy->artifact_info = model->artifact_info;
@@ -684,7 +699,8 @@ rac_model_info_t* rac_model_info_copy(const rac_model_info_t* model) {
 
     // Copy tags
     if (model->tags && model->tag_count > 0) {
-        copy->tags = (char**)malloc(model->tag_count * sizeof(char*));
+        copy->tags =
+            (char**)rac_alloc_tagged(RAC_ALLOC_TAG_MODEL, model->tag_count * sizeof(char*));
         if (copy->tags) {
             copy->tag_count = model->tag_count;
             for (size_t i = 0; i < model->tag_count; i++) {
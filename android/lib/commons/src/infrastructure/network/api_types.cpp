@@ -7,6 +7,7 @@
 #include <cstdlib>
 #include <cstring>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
 #include "rac/infrastructure/network/rac_api_types.h"
 
@@ -21,7 +22,7 @@ static char* str_dup(const char* src) {
     if (!src)
         return nullptr;
     size_t len = strlen(src);
-    char* dst = (char*)malloc(len + 1);
+    char* dst = (char*)rac_alloc_tagged(RAC_ALLOC_TAG_NETWORK, len + 1);
     if (dst) {
         memcpy(dst, src, len + 1);
     }
@@ -31,28 +32,28 @@ static char* str_dup(const char* src) {
 void rac_auth_response_free(rac_auth_response_t* response) {
     if (!response)
         return;
-    free(response->access_token);
-    free(response->refresh_token);
-    free(response->device_id);
-    free(response->user_id);
-    free(response->organization_id);
-    free(response->token_type);
+    rac_free(response->access_token);
+    rac_free(response->refresh_token);
+    rac_free(response->device_id);
+    rac_free(response->user_id);
+    rac_free(response->organization_id);
+    rac_free(response->token_type);
     memset(response, 0, sizeof(*response));
 }
 
 void rac_health_response_free(rac_health_response_t* response) {
     if (!response)
         return;
-    free(response->version);
+    rac_free(response->version);
     memset(response, 0, sizeof(*response));
 }
 
 void rac_device_reg_response_free(rac_device_reg_response_t* response) {
     if (!response)
         return;
-    free(response->device_id);
-    free(response->status);
-    free(response->sync_status);
+    rac_free(response->device_id);
+    rac_free(response->status);
+    rac_free(response->sync_status);
     memset(response, 0, sizeof(*response));
 }
 
@@ -61,21 +62,21 @@ void rac_telemetry_response_free(rac_telemetry_response_t* response) {
         return;
     if (response->errors) {
         for (size_t i = 0; i < response->error_count; i++) {
-            free(response->errors[i]);
+            rac_free(response->errors[i]);
         }
-        free(response->errors);
+        rac_free(response->errors);
     }
-    free(response->storage_version);
+    rac_free(response->storage_version);
     memset(response, 0, sizeof(*response));
 }
 
 void rac_api_error_free(rac_api_error_t* error) {
     if (!error)
         return;
-    free(error->message);
-    free(error->code);
-    free(error->raw_body);
-    free(error->request_url);
+    rac_free(error->message);
+    rac_free(error->code);
+    rac_free(error->raw_body);
+    rac_free(error->request_url);
     memset(error, 0, sizeof(*error));
 }
 
@@ -218,7 +219,7 @@ static char* json_extract_string(const char* json, const char* key) {
     }
 
     size_t len = end - value;
-    char* result = (char*)malloc(len + 1);
+    char* result = (char*)rac_alloc_tagged(RAC_ALLOC_TAG_NETWORK, len + 1);
     if (result) {
         // Simple unescape
         size_t di = 0;
@@ -532,7 +533,7 @@ char* rac_telemetry_batch_to_json(const rac_telemetry_batch_t* batch) {
 
     // Estimate size needed
     size_t buf_size = 1024 + (batch->event_count * 8192);
-    char* buf = (char*)malloc(buf_size);
+    char* buf = (char*)rac_alloc_tagged(RAC_ALLOC_TAG_NETWORK, buf_size);
     if (!buf)
         return nullptr;
 
@@ -543,7 +544,7 @@ char* rac_telemetry_batch_to_json(const rac_telemetry_batch_t* batch) {
     // Events array
     int written = snprintf(buf + pos, buf_size - pos, "\"events\":[");
     if (written < 0) {
-        free(buf);
+        rac_free(buf);
         return nullptr;
     }
     pos += written;
@@ -554,35 +555,35 @@ char* rac_telemetry_batch_to_json(const rac_telemetry_batch_t* batch) {
 
         char* event_json = rac_telemetry_event_to_json(&batch->events[i]);
         if (!event_json) {
-            free(buf);
+            rac_free(buf);
             return nullptr;
         }
 
         size_t event_len = strlen(event_json);
         if (pos + event_len >= buf_size - 100) {
-            free(event_json);
-            free(buf);
+            rac_free(event_json);
+            rac_free(buf);
             return nullptr;
         }
         memcpy(buf + pos, event_json, event_len);
         pos += event_len;
-        free(event_json);
+        rac_free(event_json);
     }
 
     buf[pos++] = ']';  // Close events array
 
     // Other batch fields
     if (json_add_string(buf, buf_size, &pos, "device_id", batch->device_id, true) < 0) {
-        free(buf);
+        rac_free(buf);
         return nullptr;
     }
     if (json_add_int(buf, buf_size, &pos, "timestamp", batch->timestamp, true) < 0) {
-        free(buf);
+        rac_free(buf);
         return nullptr;
     }
     if (batch->modality)
         if (json_add_string(buf, buf_size, &pos, "modality", batch->modality, true) < 0) {
-            free(buf);
+            rac_free(buf);
             return nullptr;
         }
 
@@ -1,15 +1,32 @@
 /**
  * @file auth_manager.cpp
  * @brief Authentication state management implementation
+ *
+ * g_auth_mutex guards the state. Token strings replaced by a refresh are
+ * retired rather than freed, because callers hold the pointers returned by
+ * the getters while the scheduler refreshes on its own thread; they are
+ * freed on rac_auth_reset.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
 #include "rac/infrastructure/network/rac_api_types.h"
 #include "rac/infrastructure/network/rac_auth_manager.h"
+#include "rac/infrastructure/network/rac_endpoints.h"
+#include "rac/infrastructure/network/rac_http_client.h"
+
+static const char* LOG_CAT = "AuthManager";
 
 // =============================================================================
 // Global State
@@ -18,6 +35,11 @@
 static rac_auth_state_t g_auth_state = {};
 static rac_secure_storage_t g_storage = {};
 static bool g_storage_available = false;
+static std::mutex g_auth_mutex;
+static std::vector<char*> g_retired_strings;  // Guarded by g_auth_mutex
+static int64_t g_token_issued_at = 0;        // Guarded by g_auth_mutex
+
+static void notify_scheduler();
 
 // =============================================================================
 // Helpers
@@ -27,20 +49,42 @@ static char* str_dup(const char* src) {
     if (!src)
         return nullptr;
     size_t len = strlen(src);
-    char* dst = (char*)malloc(len + 1);
+    char* dst = (char*)rac_alloc_tagged(RAC_ALLOC_TAG_NETWORK, len + 1);
     if (dst) {
         memcpy(dst, src, len + 1);
     }
     return dst;
 }
 
+// Caller holds g_auth_mutex
 static void free_auth_state_strings() {
-    free(g_auth_state.access_token);
-    free(g_auth_state.refresh_token);
-    free(g_auth_state.device_id);
-    free(g_auth_state.user_id);
-    free(g_auth_state.organization_id);
+    rac_free(g_auth_state.access_token);
+    rac_free(g_auth_state.refresh_token);
+    rac_free(g_auth_state.device_id);
+    rac_free(g_auth_state.user_id);
+    rac_free(g_auth_state.organization_id);
+    for (char* retired : g_retired_strings) {
+        rac_free(retired);
+    }
+    g_retired_strings.clear();
+
+    g_auth_state.access_token = nullptr;
+    g_auth_state.refresh_token = nullptr;
+    g_auth_state.device_id = nullptr;
+    g_auth_state.user_id = nullptr;
+    g_auth_state.organization_id = nullptr;
+}
 
+// Caller holds g_auth_mutex; keeps the old strings readable
+static void retire_auth_state_strings() {
+    char* strings[] = {g_auth_state.access_token, g_auth_state.refresh_token,
+                       g_auth_state.device_id, g_auth_state.user_id,
+                       g_auth_state.organization_id};
+    for (char* str : strings) {
+        if (str) {
+            g_retired_strings.push_back(str);
+        }
+    }
     g_auth_state.access_token = nullptr;
     g_auth_state.refresh_token = nullptr;
     g_auth_state.device_id = nullptr;
@@ -52,6 +96,25 @@ static int64_t current_time_seconds() {
     return (int64_t)time(nullptr);
 }
 
+// Caller holds g_auth_mutex
+static bool is_authenticated_locked() {
+    return g_auth_state.is_authenticated && g_auth_state.access_token != nullptr &&
+           g_auth_state.access_token[0] != '\0';
+}
+
+// Caller holds g_auth_mutex
+static bool expires_within_locked(int64_t seconds) {
+    if (!g_auth_state.refresh_token || g_auth_state.refresh_token[0] == '\0') {
+        return false;  // Can't refresh without refresh token
+    }
+
+    if (g_auth_state.token_expires_at <= 0) {
+        return true;  // Unknown expiry, assume needs refresh
+    }
+
+    return (g_auth_state.token_expires_at - current_time_seconds()) < seconds;
+}
+
 // =============================================================================
 // Initialization
 // =============================================================================
@@ -59,6 +122,7 @@ static int64_t current_time_seconds() {
 void rac_auth_init(const rac_secure_storage_t* storage) {
     rac_auth_reset();
 
+    std::lock_guard<std::mutex> lock(g_auth_mutex);
     if (storage && storage->store && storage->retrieve && storage->delete_key) {
         g_storage = *storage;
         g_storage_available = true;
@@ -69,8 +133,13 @@ void rac_auth_init(const rac_secure_storage_t* storage) {
 }
 
 void rac_auth_reset(void) {
-    free_auth_state_strings();
-    memset(&g_auth_state, 0, sizeof(g_auth_state));
+    {
+        std::lock_guard<std::mutex> lock(g_auth_mutex);
+        free_auth_state_strings();
+        memset(&g_auth_state, 0, sizeof(g_auth_state));
+        g_token_issued_at = 0;
+    }
+    notify_scheduler();
 }
 
 // =============================================================================
@@ -78,40 +147,36 @@ void rac_auth_reset(void) {
 // =============================================================================
 
 bool rac_auth_is_authenticated(void) {
-    return g_auth_state.is_authenticated && g_auth_state.access_token != nullptr &&
-           g_auth_state.access_token[0] != '\0';
+    std::lock_guard<std::mutex> lock(g_auth_mutex);
+    return is_authenticated_locked();
 }
 
 bool rac_auth_needs_refresh(void) {
-    if (!g_auth_state.refresh_token || g_auth_state.refresh_token[0] == '\0') {
-        return false;  // Can't refresh without refresh token
-    }
-
-    if (g_auth_state.token_expires_at <= 0) {
-        return true;  // Unknown expiry, assume needs refresh
-    }
-
+    std::lock_guard<std::mutex> lock(g_auth_mutex);
     // Check if token expires within 60 seconds
-    int64_t now = current_time_seconds();
-    return (g_auth_state.token_expires_at - now) < 60;
+    return expires_within_locked(60);
 }
 
 const char* rac_auth_get_access_token(void) {
-    if (!rac_auth_is_authenticated()) {
+    std::lock_guard<std::mutex> lock(g_auth_mutex);
+    if (!is_authenticated_locked()) {
         return nullptr;
     }
     return g_auth_state.access_token;
 }
 
 const char* rac_auth_get_device_id(void) {
+    std::lock_guard<std::mutex> lock(g_auth_mutex);
     return g_auth_state.device_id;
 }
 
 const char* rac_auth_get_user_id(void) {
+    std::lock_guard<std::mutex> lock(g_auth_mutex);
     return g_auth_state.user_id;
 }
 
 const char* rac_auth_get_organization_id(void) {
+    std::lock_guard<std::mutex> lock(g_auth_mutex);
     return g_auth_state.organization_id;
 }
 
@@ -133,6 +198,7 @@ char* rac_auth_build_authenticate_request(const rac_sdk_config_t* config) {
 }
 
 char* rac_auth_build_refresh_request(void) {
+    std::lock_guard<std::mutex> lock(g_auth_mutex);
     if (!g_auth_state.refresh_token || !g_auth_state.device_id) {
         return nullptr;
     }
@@ -153,8 +219,10 @@ static int update_auth_state_from_response(const rac_auth_response_t* response)
         return -1;
     }
 
-    // Free old strings
-    free_auth_state_strings();
+    std::lock_guard<std::mutex> lock(g_auth_mutex);
+
+    // Old strings may still be held by callers
+    retire_auth_state_strings();
 
     // Copy new values
     g_auth_state.access_token = str_dup(response->access_token);
@@ -164,7 +232,8 @@ static int update_auth_state_from_response(const rac_auth_response_t* response)
     g_auth_state.organization_id = str_dup(response->organization_id);
 
     // Calculate expiry timestamp
-    g_auth_state.token_expires_at = current_time_seconds() + response->expires_in;
+    g_token_issued_at = current_time_seconds();
+    g_auth_state.token_expires_at = g_token_issued_at + response->expires_in;
     g_auth_state.is_authenticated = true;
 
     return 0;
@@ -184,6 +253,7 @@ int rac_auth_handle_authenticate_response(const char* json) {
     // Save to secure storage if available and successful
     if (result == 0) {
         rac_auth_save_tokens();
+        notify_scheduler();
     }
 
     rac_auth_response_free(&response);
@@ -206,20 +276,31 @@ int rac_auth_get_valid_token(const char** out_token, bool* out_needs_refresh) {
     *out_token = nullptr;
     *out_needs_refresh = false;
 
-    // Not authenticated at all
-    if (!rac_auth_is_authenticated()) {
-        return -1;
+    {
+        std::lock_guard<std::mutex> lock(g_auth_mutex);
+
+        // Not authenticated at all
+        if (!is_authenticated_locked()) {
+            return -1;
+        }
+
+        // Token is valid
+        if (!expires_within_locked(60)) {
+            *out_token = g_auth_state.access_token;
+            return 0;
+        }
     }
+    const bool scheduled = rac_auth_refresh_scheduler_is_running();
 
-    // Check if refresh is needed
-    if (rac_auth_needs_refresh()) {
-        *out_needs_refresh = true;
-        return 1;  // Caller should refresh
+    // The scheduler refreshes here, joining a refresh already in flight
+    if (scheduled && rac_auth_refresh() == 0) {
+        std::lock_guard<std::mutex> lock(g_auth_mutex);
+        *out_token = g_auth_state.access_token;
+        return 0;
     }
 
-    // Token is valid
-    *out_token = g_auth_state.access_token;
-    return 0;
+    *out_needs_refresh = true;
+    return 1;  // Caller should refresh
 }
 
 void rac_auth_clear(void) {
@@ -227,6 +308,7 @@ void rac_auth_clear(void) {
     rac_auth_reset();
 
     // Clear secure storage
+    std::lock_guard<std::mutex> lock(g_auth_mutex);
     if (g_storage_available) {
         g_storage.delete_key(RAC_KEY_ACCESS_TOKEN, g_storage.context);
         g_storage.delete_key(RAC_KEY_REFRESH_TOKEN, g_storage.context);
@@ -241,6 +323,7 @@ void rac_auth_clear(void) {
 // =============================================================================
 
 int rac_auth_load_stored_tokens(void) {
+    std::unique_lock<std::mutex> lock(g_auth_mutex);
     if (!g_storage_available) {
         return -1;
     }
@@ -249,7 +332,7 @@ int rac_auth_load_stored_tokens(void) {
 
     // Load access token
     if (g_storage.retrieve(RAC_KEY_ACCESS_TOKEN, buffer, sizeof(buffer), g_storage.context) > 0) {
-        free(g_auth_state.access_token);
+        rac_free(g_auth_state.access_token);
         g_auth_state.access_token = str_dup(buffer);
     } else {
         return -1;  // No stored token
@@ -257,26 +340,26 @@ int rac_auth_load_stored_tokens(void) {
 
     // Load refresh token
     if (g_storage.retrieve(RAC_KEY_REFRESH_TOKEN, buffer, sizeof(buffer), g_storage.context) > 0) {
-        free(g_auth_state.refresh_token);
+        rac_free(g_auth_state.refresh_token);
         g_auth_state.refresh_token = str_dup(buffer);
     }
 
     // Load device ID
     if (g_storage.retrieve(RAC_KEY_DEVICE_ID, buffer, sizeof(buffer), g_storage.context) > 0) {
-        free(g_auth_state.device_id);
+        rac_free(g_auth_state.device_id);
         g_auth_state.device_id = str_dup(buffer);
     }
 
     // Load user ID (optional)
     if (g_storage.retrieve(RAC_KEY_USER_ID, buffer, sizeof(buffer), g_storage.context) > 0) {
-        free(g_auth_state.user_id);
+        rac_free(g_auth_state.user_id);
         g_auth_state.user_id = str_dup(buffer);
     }
 
     // Load organization ID
     if (g_storage.retrieve(RAC_KEY_ORGANIZATION_ID, buffer, sizeof(buffer), g_storage.context) >
         0) {
-        free(g_auth_state.organization_id);
+        rac_free(g_auth_state.organization_id);
         g_auth_state.organization_id = str_dup(buffer);
     }
 
@@ -287,10 +370,13 @@ int rac_auth_load_stored_tokens(void) {
         g_auth_state.token_expires_at = 0;
     }
 
+    lock.unlock();
+    notify_scheduler();
     return 0;
 }
 
 int rac_auth_save_tokens(void) {
+    std::lock_guard<std::mutex> lock(g_auth_mutex);
     if (!g_storage_available) {
         return 0;  // Not an error, just no-op
     }
@@ -332,3 +418,237 @@ int rac_auth_save_tokens(void) {
 
     return result;
 }
+
+// =============================================================================
+// Refresh Scheduling
+// =============================================================================
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int32_t kDefaultLeadSeconds = 300;
+constexpr int32_t kRefreshTimeoutMs = 15000;
+constexpr int64_t kMinRetrySeconds = 5;
+constexpr int64_t kMaxRetrySeconds = 300;
+
+struct RefreshScheduler {
+    std::mutex mutex;
+    std::condition_variable wake_cv;
+    std::condition_variable done_cv;
+    std::thread thread;
+    bool running = false;
+    bool wake = false;
+    std::string base_url;
+    int32_t lead_seconds = kDefaultLeadSeconds;
+
+    // Single flight: callers that find a refresh in flight wait for its result
+    bool in_flight = false;
+    uint64_t completed = 0;
+    int last_result = -1;
+
+    ~RefreshScheduler() { rac_auth_stop_refresh_scheduler(); }
+};
+
+RefreshScheduler& scheduler() {
+    static RefreshScheduler instance;
+    return instance;
+}
+
+struct PendingRefresh {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    int result = -1;
+};
+
+void on_refresh_response(const rac_http_response_t* response, void* user_data) {
+    auto* pending = static_cast<PendingRefresh*>(user_data);
+    int result = -1;
+    if (response && response->status_code >= 200 && response->status_code < 300 &&
+        response->body) {
+        result = rac_auth_handle_refresh_response(response->body);
+    } else {
+        RAC_LOG_WARNING(LOG_CAT, "Token refresh failed: status %d, %s",
+                        response ? response->status_code : 0,
+                        response && response->error_message ? response->error_message : "");
+    }
+    std::lock_guard<std::mutex> lock(pending->mutex);
+    pending->result = result;
+    pending->done = true;
+    pending->cv.notify_one();
+}
+
+// One refresh round-trip through the HTTP client
+int perform_refresh(const std::string& base_url) {
+    char* body = rac_auth_build_refresh_request();
+    if (!body) {
+        return -1;
+    }
+    char url[1024];
+    if (rac_build_url(base_url.c_str(), RAC_ENDPOINT_REFRESH, url, sizeof(url)) < 0) {
+        rac_free(body);
+        return -1;
+    }
+
+    rac_http_request_t* request = rac_http_request_create(RAC_HTTP_POST, url);
+    if (!request) {
+        rac_free(body);
+        return -1;
+    }
+    rac_http_request_set_body(request, body);
+    rac_http_request_add_header(request, "Content-Type", "application/json");
+    rac_http_request_set_timeout(request, kRefreshTimeoutMs);
+    rac_free(body);
+
+    PendingRefresh pending;
+    const bool started = rac_http_execute_raw(request, on_refresh_response, &pending);
+    if (started) {
+        std::unique_lock<std::mutex> lock(pending.mutex);
+        pending.cv.wait(lock, [&] { return pending.done; });
+    }
+    rac_http_request_free(request);
+    return started ? pending.result : -1;
+}
+
+// Seconds until the token should be refreshed, or -1 if it cannot be
+int64_t seconds_until_refresh(int32_t lead_seconds) {
+    std::lock_guard<std::mutex> lock(g_auth_mutex);
+    if (!g_auth_state.refresh_token || g_auth_state.refresh_token[0] == '\0') {
+        return -1;
+    }
+    if (g_auth_state.token_expires_at <= 0) {
+        return 0;
+    }
+    // Short-lived tokens are refreshed halfway through instead
+    int64_t lead = lead_seconds;
+    if (g_token_issued_at > 0) {
+        lead = std::min(lead, (g_auth_state.token_expires_at - g_token_issued_at) / 2);
+    }
+    return std::max<int64_t>(0, g_auth_state.token_expires_at - lead - current_time_seconds());
+}
+
+void scheduler_loop() {
+    RefreshScheduler& sched = scheduler();
+    int64_t retry_seconds = kMinRetrySeconds;
+    Clock::time_point next_allowed;
+    std::unique_lock<std::mutex> lock(sched.mutex);
+    while (sched.running) {
+        const int32_t lead_seconds = sched.lead_seconds;
+        lock.unlock();
+        int64_t wait_seconds = seconds_until_refresh(lead_seconds);
+        lock.lock();
+        // A token that is due again right after a refresh is not retried in a loop
+        if (wait_seconds == 0 && Clock::now() < next_allowed) {
+            wait_seconds = std::max<int64_t>(
+                1, std::chrono::duration_cast<std::chrono::seconds>(next_allowed - Clock::now())
+                       .count());
+        }
+        if (!sched.running) {
+            break;
+        }
+
+        if (wait_seconds != 0) {
+            sched.wake = false;
+            auto woken = [&] { return sched.wake || !sched.running; };
+            if (wait_seconds < 0) {
+                sched.wake_cv.wait(lock, woken);
+            } else {
+                sched.wake_cv.wait_for(lock, std::chrono::seconds(wait_seconds), woken);
+            }
+            continue;
+        }
+
+        lock.unlock();
+        const int result = rac_auth_refresh();
+        lock.lock();
+        next_allowed = Clock::now() + std::chrono::seconds(kMinRetrySeconds);
+        if (result == 0) {
+            retry_seconds = kMinRetrySeconds;
+            continue;
+        }
+        // Back off, still waking early if new tokens arrive
+        RAC_LOG_DEBUG(LOG_CAT, "Scheduled refresh failed; retrying in %lld s",
+                      static_cast<long long>(retry_seconds));
+        sched.wake = false;
+        sched.wake_cv.wait_for(lock, std::chrono::seconds(retry_seconds),
+                               [&] { return sched.wake || !sched.running; });
+        retry_seconds = std::min(retry_seconds * 2, kMaxRetrySeconds);
+    }
+}
+
+}  // namespace
+
+static void notify_scheduler() {
+    RefreshScheduler& sched = scheduler();
+    std::lock_guard<std::mutex> lock(sched.mutex);
+    sched.wake = true;
+    sched.wake_cv.notify_all();
+}
+
+int rac_auth_refresh(void) {
+    RefreshScheduler& sched = scheduler();
+    std::unique_lock<std::mutex> lock(sched.mutex);
+    if (sched.in_flight) {
+        const uint64_t target = sched.completed + 1;
+        sched.done_cv.wait(lock, [&] { return sched.completed >= target; });
+        return sched.last_result;
+    }
+    if (sched.base_url.empty()) {
+        return -1;
+    }
+    sched.in_flight = true;
+    const std::string base_url = sched.base_url;
+    lock.unlock();
+
+    const int result = perform_refresh(base_url);
+    if (result == 0) {
+        RAC_LOG_INFO(LOG_CAT, "Access token refreshed");
+    }
+
+    lock.lock();
+    sched.in_flight = false;
+    sched.last_result = result;
+    sched.completed++;
+    sched.done_cv.notify_all();
+    return result;
+}
+
+int rac_auth_start_refresh_scheduler(const char* base_url, int32_t lead_seconds) {
+    if (!base_url || base_url[0] == '\0') {
+        return -1;
+    }
+    RefreshScheduler& sched = scheduler();
+    std::lock_guard<std::mutex> lock(sched.mutex);
+    sched.base_url = base_url;
+    sched.lead_seconds = lead_seconds > 0 ? lead_seconds : kDefaultLeadSeconds;
+    if (sched.running) {
+        sched.wake = true;
+        sched.wake_cv.notify_all();
+        return 0;
+    }
+    sched.running = true;
+    sched.wake = false;
+    sched.thread = std::thread(scheduler_loop);
+    return 0;
+}
+
+void rac_auth_stop_refresh_scheduler(void) {
+    RefreshScheduler& sched = scheduler();
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(sched.mutex);
+        sched.running = false;
+        sched.wake_cv.notify_all();
+        thread = std::move(sched.thread);
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool rac_auth_refresh_scheduler_is_running(void) {
+    RefreshScheduler& sched = scheduler();
+    std::lock_guard<std::mutex> lock(sched.mutex);
+    return sched.running;
+}
@@ -31,6 +31,22 @@ const char* rac_endpoint_telemetry(rac_environment_t env) {
     }
 }
 
+const char* rac_endpoint_telemetry_for_encoding(rac_environment_t env,
+                                                rac_telemetry_encoding_t encoding) {
+    if (env == RAC_ENV_DEVELOPMENT) {
+        return RAC_ENDPOINT_DEV_TELEMETRY;
+    }
+    switch (encoding) {
+        case RAC_TELEMETRY_ENCODING_JSON_MERGED:
+            return RAC_ENDPOINT_TELEMETRY_BATCH;
+        case RAC_TELEMETRY_ENCODING_CBOR:
+            return RAC_ENDPOINT_TELEMETRY_BATCH_CBOR;
+        case RAC_TELEMETRY_ENCODING_JSON:
+        default:
+            return RAC_ENDPOINT_TELEMETRY;
+    }
+}
+
 const char* rac_endpoint_model_assignments(void) {
     return "/api/v1/model-assignments/for-sdk";
 }
@@ -1,21 +1,74 @@
 /**
  * @file http_client.cpp
  * @brief HTTP client implementation
+ *
+ * Every submitted request becomes a Call that owns a deep copy of the
+ * request, since callers free theirs as soon as execute returns but a retry
+ * needs it later. A coalesced GET is a Call with several waiters; the
+ * response fans out to all of them from the platform's callback thread.
+ * The client mutex is never held while calling into the platform, so an
+ * executor may invoke its callback synchronously.
  */
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
 #include "rac/infrastructure/network/rac_http_client.h"
 
+static const char* LOG_CAT = "HTTP";
+
 // =============================================================================
 // Global State
 // =============================================================================
 
-static rac_http_executor_t g_http_executor = nullptr;
+namespace {
+
+struct Waiter {
+    rac_http_callback_t callback;
+    void* user_data;
+};
+
+struct Call {
+    // Owned copy of the caller's request; request.headers points into headers
+    std::string url;
+    std::string body;
+    std::vector<std::pair<std::string, std::string>> header_strings;
+    std::vector<rac_http_header_t> headers;
+    rac_http_request_t request = {};
+
+    std::string coalesce_key;  // Empty if the call is not shared
+    std::string origin;
+    rac_http_session_t session = {};
+    std::vector<Waiter> waiters;  // Guarded by Client::mutex
+    int32_t retries = 0;
+};
+
+struct Client {
+    std::mutex mutex;
+    rac_http_executor_t executor = nullptr;
+    rac_http_session_executor_t session_executor = nullptr;
+    rac_http_client_config_t config = RAC_HTTP_CLIENT_CONFIG_DEFAULT;
+    float retry_tokens = RAC_HTTP_CLIENT_CONFIG_DEFAULT.retry_budget_max;
+    std::unordered_map<std::string, Call*> in_flight;  // By coalesce key
+    std::unordered_map<std::string, uint32_t> session_ids;  // By origin
+    rac_http_client_stats_t stats = {};
+};
+
+Client& client() {
+    static Client instance;
+    return instance;
+}
+
+}  // namespace
 
 // =============================================================================
 // Response Management
@@ -25,15 +78,15 @@ void rac_http_response_free(rac_http_response_t* response) {
     if (!response)
         return;
 
-    free(response->body);
-    free(response->error_message);
+    rac_free(response->body);
+    rac_free(response->error_message);
 
     if (response->headers) {
         for (size_t i = 0; i < response->header_count; i++) {
-            free((void*)response->headers[i].key);
-            free((void*)response->headers[i].value);
+            rac_free((void*)response->headers[i].key);
+            rac_free((void*)response->headers[i].value);
         }
-        free(response->headers);
+        rac_free(response->headers);
     }
 
     memset(response, 0, sizeof(*response));
@@ -44,11 +97,21 @@ void rac_http_response_free(rac_http_response_t* response) {
 // =============================================================================
 
 void rac_http_set_executor(rac_http_executor_t executor) {
-    g_http_executor = executor;
+    Client& c = client();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    c.executor = executor;
+}
+
+void rac_http_set_session_executor(rac_http_session_executor_t executor) {
+    Client& c = client();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    c.session_executor = executor;
 }
 
 bool rac_http_has_executor(void) {
-    return g_http_executor != nullptr;
+    Client& c = client();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    return c.executor != nullptr || c.session_executor != nullptr;
 }
 
 // =============================================================================
@@ -59,7 +122,7 @@ static char* str_dup(const char* src) {
     if (!src)
         return nullptr;
     size_t len = strlen(src);
-    char* dst = (char*)malloc(len + 1);
+    char* dst = (char*)rac_alloc_tagged(RAC_ALLOC_TAG_NETWORK, len + 1);
     if (dst) {
         memcpy(dst, src, len + 1);
     }
@@ -67,7 +130,8 @@ static char* str_dup(const char* src) {
 }
 
 rac_http_request_t* rac_http_request_create(rac_http_method_t method, const char* url) {
-    rac_http_request_t* request = (rac_http_request_t*)calloc(1, sizeof(rac_http_request_t));
+    rac_http_request_t* request = (rac_http_request_t*)rac_calloc_tagged(
+        RAC_ALLOC_TAG_NETWORK, 1, sizeof(rac_http_request_t));
     if (!request)
         return nullptr;
 
@@ -82,7 +146,7 @@ void rac_http_request_set_body(rac_http_request_t* request, const char* body) {
     if (!request)
         return;
 
-    free((void*)request->body);
+    rac_free((void*)request->body);
     request->body = str_dup(body);
     request->body_length = body ? strlen(body) : 0;
 }
@@ -94,7 +158,7 @@ void rac_http_request_add_header(rac_http_request_t* request, const char* key, c
     // Reallocate headers array
     size_t new_count = request->header_count + 1;
     rac_http_header_t* new_headers =
-        (rac_http_header_t*)realloc(request->headers, new_count * sizeof(rac_http_header_t));
+        (rac_http_header_t*)rac_realloc(request->headers, new_count * sizeof(rac_http_header_t));
 
     if (!new_headers)
         return;
@@ -115,18 +179,18 @@ void rac_http_request_free(rac_http_request_t* request) {
     if (!request)
         return;
 
-    free((void*)request->url);
-    free((void*)request->body);
+    rac_free((void*)request->url);
+    rac_free((void*)request->body);
 
     if (request->headers) {
         for (size_t i = 0; i < request->header_count; i++) {
-            free((void*)request->headers[i].key);
-            free((void*)request->headers[i].value);
+            rac_free((void*)request->headers[i].key);
+            rac_free((void*)request->headers[i].value);
         }
-        free(request->headers);
+        rac_free(request->headers);
     }
 
-    free(request);
+    rac_free(request);
 }
 
 // =============================================================================
@@ -169,6 +233,200 @@ void rac_http_add_api_key_header(rac_http_request_t* request, const char* api_ke
     rac_http_request_add_header(request, "apikey", api_key);
 }
 
+// =============================================================================
+// Dispatch
+// =============================================================================
+
+namespace {
+
+// "scheme://host[:port]" of a URL, or the whole URL if it has no path
+std::string url_origin(const char* url) {
+    const char* host = strstr(url, "://");
+    host = host ? host + 3 : url;
+    const char* path = strchr(host, '/');
+    return path ? std::string(url, static_cast<size_t>(path - url)) : std::string(url);
+}
+
+bool is_idempotent(rac_http_method_t method) {
+    return method == RAC_HTTP_GET || method == RAC_HTTP_PUT || method == RAC_HTTP_DELETE;
+}
+
+// Transport failures and gateway errors are worth another attempt
+bool is_retryable(const rac_http_response_t* response) {
+    if (!response || response->status_code <= 0) {
+        return true;
+    }
+    return response->status_code == 502 || response->status_code == 503 ||
+           response->status_code == 504;
+}
+
+Call* make_call(const rac_http_request_t* request) {
+    Call* call = new Call();
+    call->url = request->url ? request->url : "";
+    if (request->body) {
+        call->body.assign(request->body, request->body_length);
+    }
+    for (size_t i = 0; i < request->header_count; i++) {
+        const rac_http_header_t& header = request->headers[i];
+        if (header.key && header.value) {
+            call->header_strings.emplace_back(header.key, header.value);
+        }
+    }
+    for (const auto& header : call->header_strings) {
+        call->headers.push_back({header.first.c_str(), header.second.c_str()});
+    }
+
+    call->request = *request;
+    call->request.url = call->url.c_str();
+    call->request.body = request->body ? call->body.c_str() : nullptr;
+    call->request.body_length = call->body.size();
+    call->request.headers = call->headers.empty() ? nullptr : call->headers.data();
+    call->request.header_count = call->headers.size();
+    call->origin = url_origin(call->url.c_str());
+    return call;
+}
+
+// Method, URL and headers; GETs with the same key get the same response
+std::string coalesce_key(const Call& call) {
+    std::string key = call.url;
+    for (const auto& header : call.header_strings) {
+        key += '\n';
+        key += header.first;
+        key += ':';
+        key += header.second;
+    }
+    return key;
+}
+
+void on_call_response(const rac_http_response_t* response, void* user_data);
+
+void dispatch(Call* call) {
+    Client& c = client();
+    rac_http_executor_t executor;
+    rac_http_session_executor_t session_executor;
+    {
+        std::lock_guard<std::mutex> lock(c.mutex);
+        executor = c.executor;
+        session_executor = c.session_executor;
+        c.stats.dispatched++;
+    }
+
+    if (session_executor) {
+        session_executor(&call->session, &call->request, on_call_response, call);
+    } else if (executor) {
+        executor(&call->request, on_call_response, call);
+    } else {
+        // Unregistered while the call was retrying
+        char message[] = "HTTP executor not registered";
+        rac_http_response_t response = {};
+        response.error_message = message;
+        on_call_response(&response, call);
+    }
+}
+
+void on_call_response(const rac_http_response_t* response, void* user_data) {
+    Call* call = static_cast<Call*>(user_data);
+    Client& c = client();
+
+    std::vector<Waiter> waiters;
+    bool retry = false;
+    {
+        std::lock_guard<std::mutex> lock(c.mutex);
+        if (is_idempotent(call->request.method) && is_retryable(response) &&
+            call->retries < c.config.max_retries) {
+            if (c.retry_tokens >= 1.0f) {
+                c.retry_tokens -= 1.0f;
+                c.stats.retries++;
+                retry = true;
+            } else {
+                c.stats.retries_denied++;
+            }
+        }
+        if (!retry) {
+            if (!call->coalesce_key.empty()) {
+                c.in_flight.erase(call->coalesce_key);
+            }
+            waiters.swap(call->waiters);
+        }
+    }
+
+    if (retry) {
+        call->retries++;
+        RAC_LOG_DEBUG(LOG_CAT, "Retrying %s (attempt %d, status %d)", call->url.c_str(),
+                      call->retries + 1, response ? response->status_code : 0);
+        dispatch(call);
+        return;
+    }
+
+    for (const Waiter& waiter : waiters) {
+        waiter.callback(response, waiter.user_data);
+    }
+    delete call;
+}
+
+// Queues a request, or joins an identical GET in flight
+bool submit(const rac_http_request_t* request, rac_http_callback_t callback, void* user_data) {
+    Call* call = make_call(request);
+    Client& c = client();
+    {
+        std::lock_guard<std::mutex> lock(c.mutex);
+        if (!c.executor && !c.session_executor) {
+            delete call;
+            return false;
+        }
+        c.stats.requests++;
+        c.retry_tokens =
+            std::min(c.retry_tokens + c.config.retry_budget, c.config.retry_budget_max);
+
+        if (c.config.coalesce_gets && request->method == RAC_HTTP_GET) {
+            std::string key = coalesce_key(*call);
+            auto existing = c.in_flight.find(key);
+            if (existing != c.in_flight.end()) {
+                existing->second->waiters.push_back({callback, user_data});
+                c.stats.coalesced++;
+                delete call;
+                return true;
+            }
+            call->coalesce_key = std::move(key);
+            c.in_flight.emplace(call->coalesce_key, call);
+        }
+
+        auto session = c.session_ids.emplace(call->origin, 0u);
+        if (session.second) {
+            session.first->second = static_cast<uint32_t>(c.session_ids.size());
+            c.stats.sessions = session.first->second;
+        }
+        call->session.id = session.first->second;
+        call->session.origin = call->origin.c_str();
+        call->session.keep_alive_ms = c.config.keep_alive_ms;
+        call->waiters.push_back({callback, user_data});
+    }
+
+    dispatch(call);
+    return true;
+}
+
+}  // namespace
+
+void rac_http_client_configure(const rac_http_client_config_t* config) {
+    const rac_http_client_config_t& cfg = config ? *config : RAC_HTTP_CLIENT_CONFIG_DEFAULT;
+    Client& c = client();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    c.config = cfg;
+    c.config.max_retries = std::max(0, c.config.max_retries);
+    c.config.retry_budget = std::max(0.0f, c.config.retry_budget);
+    c.config.retry_budget_max = std::max(0.0f, c.config.retry_budget_max);
+    c.retry_tokens = std::min(c.retry_tokens, c.config.retry_budget_max);
+}
+
+void rac_http_client_get_stats(rac_http_client_stats_t* out_stats) {
+    if (!out_stats)
+        return;
+    Client& c = client();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    *out_stats = c.stats;
+}
+
 // =============================================================================
 // High-Level Request Functions
 // =============================================================================
@@ -197,14 +455,19 @@ void rac_http_execute(const rac_http_request_t* request, rac_http_context_t* con
     if (!request || !context)
         return;
 
-    if (!g_http_executor) {
+    if (!submit(request, internal_callback, context)) {
         if (context->on_error) {
             context->on_error(-1, "HTTP executor not registered", context->user_data);
         }
-        return;
     }
+}
+
+bool rac_http_execute_raw(const rac_http_request_t* request, rac_http_callback_t callback,
+                          void* user_data) {
+    if (!request || !callback)
+        return false;
 
-    g_http_executor(request, internal_callback, context);
+    return submit(request, callback, user_data);
 }
 
 void rac_http_post_json(const char* url, const char* json_body, const char* auth_token,
@@ -0,0 +1,494 @@
+/**
+ * @file outbound_queue.cpp
+ * @brief RunAnywhere Commons - Offline-First Outbound Queue Implementation
+ *
+ * Items live in one vector in enqueue order, small enough that linear scans
+ * beat any index. One worker thread, started with the first item or handler,
+ * picks the highest-priority item that has a handler, gathers the oldest
+ * items of its kind into a batch, and calls the handler without the lock.
+ * The persisted file is rewritten atomically whenever the set of items
+ * changes; it holds one tab-separated, escaped line per item.
+ */
+
+#include "rac/infrastructure/network/rac_outbound_queue.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rac/core/rac_logger.h"
+
+static const char* LOG_CAT = "OutboundQueue";
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Item {
+    std::string kind;
+    std::string key;
+    std::string payload;
+    rac_request_priority_t priority = RAC_REQUEST_PRIORITY_NORMAL;
+    int32_t attempts = 0;
+    int64_t enqueued_at_ms = 0;
+    uint64_t seq = 0;
+};
+
+struct Handler {
+    rac_outbound_handler_fn fn = nullptr;
+    int32_t max_batch = 1;
+    void* user_data = nullptr;
+};
+
+struct Queue {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread worker;
+    bool running = false;
+    bool stopping = false;
+
+    rac_outbound_queue_config_t config = RAC_OUTBOUND_QUEUE_CONFIG_DEFAULT;
+    std::string storage_path;
+    std::vector<Item> items;
+    std::map<std::string, Handler> handlers;
+    uint64_t next_seq = 1;
+
+    bool online = true;
+    uint32_t epoch = 0;
+    int32_t consecutive_failures = 0;
+    Clock::time_point not_before;
+    std::minstd_rand rng{static_cast<uint32_t>(Clock::now().time_since_epoch().count())};
+
+    ~Queue() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+};
+
+Queue& queue() {
+    static Queue instance;
+    return instance;
+}
+
+int64_t unix_time_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+bool is_network_error(rac_result_t result) {
+    return result <= RAC_ERROR_NETWORK_UNAVAILABLE && result > RAC_ERROR_NETWORK_UNAVAILABLE - 30;
+}
+
+// =============================================================================
+// PERSISTENCE
+// =============================================================================
+
+void append_escaped(std::string* out, const std::string& value) {
+    for (char c : value) {
+        switch (c) {
+            case '\\':
+                out->append("\\\\");
+                break;
+            case '\t':
+                out->append("\\t");
+                break;
+            case '\n':
+                out->append("\\n");
+                break;
+            case '\r':
+                out->append("\\r");
+                break;
+            default:
+                out->push_back(c);
+        }
+    }
+}
+
+std::string unescape(const std::string& value) {
+    std::string out;
+    out.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] != '\\' || i + 1 == value.size()) {
+            out.push_back(value[i]);
+            continue;
+        }
+        const char c = value[++i];
+        out.push_back(c == 't' ? '\t' : c == 'n' ? '\n' : c == 'r' ? '\r' : c);
+    }
+    return out;
+}
+
+// Caller holds q.mutex
+void persist_locked(const Queue& q) {
+    if (q.storage_path.empty()) {
+        return;
+    }
+    std::string data;
+    for (const Item& item : q.items) {
+        append_escaped(&data, item.kind);
+        data.push_back('\t');
+        append_escaped(&data, item.key);
+        data.append("\t" + std::to_string(static_cast<int>(item.priority)) + "\t" +
+                    std::to_string(item.attempts) + "\t" + std::to_string(item.enqueued_at_ms) +
+                    "\t");
+        append_escaped(&data, item.payload);
+        data.push_back('\n');
+    }
+
+    const std::string tmp_path = q.storage_path + ".tmp";
+    const int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    bool written = fd >= 0;
+    for (size_t offset = 0; written && offset < data.size();) {
+        const ssize_t n = ::write(fd, data.data() + offset, data.size() - offset);
+        written = n > 0;
+        offset += written ? static_cast<size_t>(n) : 0;
+    }
+    if (fd >= 0) {
+        written = fsync(fd) == 0 && written;
+        ::close(fd);
+    }
+    if (!written || rename(tmp_path.c_str(), q.storage_path.c_str()) != 0) {
+        unlink(tmp_path.c_str());
+        RAC_LOG_WARNING(LOG_CAT, "Cannot persist outbound queue to %s", q.storage_path.c_str());
+    }
+}
+
+// Caller holds q.mutex; returns the number of items read
+size_t load_locked(Queue& q) {
+    FILE* file = fopen(q.storage_path.c_str(), "rb");
+    if (!file) {
+        return 0;
+    }
+    std::string data;
+    char buffer[8192];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, n);
+    }
+    fclose(file);
+
+    size_t loaded = 0;
+    size_t line_start = 0;
+    while (line_start < data.size()) {
+        size_t line_end = data.find('\n', line_start);
+        if (line_end == std::string::npos) {
+            line_end = data.size();
+        }
+        std::vector<std::string> fields;
+        size_t field_start = line_start;
+        while (fields.size() < 5) {
+            const size_t tab = data.find('\t', field_start);
+            if (tab == std::string::npos || tab > line_end) {
+                break;
+            }
+            fields.push_back(data.substr(field_start, tab - field_start));
+            field_start = tab + 1;
+        }
+        if (fields.size() == 5) {
+            Item item;
+            item.kind = unescape(fields[0]);
+            item.key = unescape(fields[1]);
+            item.priority = static_cast<rac_request_priority_t>(
+                std::min(std::max(std::atoi(fields[2].c_str()), 0), 2));
+            item.attempts = std::atoi(fields[3].c_str());
+            item.enqueued_at_ms = std::strtoll(fields[4].c_str(), nullptr, 10);
+            item.payload = unescape(data.substr(field_start, line_end - field_start));
+            item.seq = q.next_seq++;
+            q.items.push_back(std::move(item));
+            loaded++;
+        }
+        line_start = line_end + 1;
+    }
+    return loaded;
+}
+
+// =============================================================================
+// WORKER
+// =============================================================================
+
+// Caller holds q.mutex: index of the next item to send, or -1
+int next_item_locked(const Queue& q) {
+    int best = -1;
+    for (size_t i = 0; i < q.items.size(); ++i) {
+        const Item& item = q.items[i];
+        if (q.handlers.count(item.kind) == 0) {
+            continue;
+        }
+        if (best < 0 || item.priority > q.items[best].priority) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+void backoff_locked(Queue& q) {
+    q.consecutive_failures++;
+    const int shift = std::min(q.consecutive_failures - 1, 16);
+    const int64_t delay =
+        std::min<int64_t>(q.config.max_backoff_ms,
+                          static_cast<int64_t>(std::max(q.config.initial_backoff_ms, 1)) << shift);
+    q.not_before = Clock::now() + std::chrono::milliseconds(delay);
+    RAC_LOG_INFO(LOG_CAT, "Batch failed (%d in a row), retrying in %lld ms",
+                 q.consecutive_failures, static_cast<long long>(delay));
+}
+
+void worker_loop() {
+    Queue& q = queue();
+    std::unique_lock<std::mutex> lock(q.mutex);
+    while (!q.stopping) {
+        if (!q.online) {
+            q.cv.wait(lock);
+            continue;
+        }
+        if (Clock::now() < q.not_before) {
+            q.cv.wait_until(lock, q.not_before);
+            continue;
+        }
+        const int next = next_item_locked(q);
+        if (next < 0) {
+            q.cv.wait(lock);
+            continue;
+        }
+
+        // The oldest items of the chosen kind, the chosen one included
+        const std::string kind = q.items[next].kind;
+        const Handler handler = q.handlers[kind];
+        std::vector<Item> batch;
+        for (const Item& item : q.items) {
+            if (item.kind == kind && static_cast<int32_t>(batch.size()) < handler.max_batch) {
+                batch.push_back(item);
+            }
+        }
+        std::vector<rac_outbound_item_t> views(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            views[i] = {batch[i].kind.c_str(),    batch[i].key.c_str(),
+                        batch[i].payload.data(),  batch[i].payload.size(),
+                        batch[i].priority,        batch[i].attempts,
+                        batch[i].enqueued_at_ms};
+        }
+
+        lock.unlock();
+        const rac_result_t result = handler.fn(views.data(), views.size(), handler.user_data);
+        lock.lock();
+
+        // Items replaced while the batch was out have a new seq and stay
+        auto in_batch = [&batch](const Item& item) {
+            return std::any_of(batch.begin(), batch.end(),
+                               [&item](const Item& sent) { return sent.seq == item.seq; });
+        };
+        if (result == RAC_SUCCESS) {
+            q.items.erase(std::remove_if(q.items.begin(), q.items.end(), in_batch),
+                          q.items.end());
+            q.consecutive_failures = 0;
+            RAC_LOG_DEBUG(LOG_CAT, "Sent %zu %s item(s)", batch.size(), kind.c_str());
+        } else {
+            if (!is_network_error(result)) {
+                const int32_t max_attempts = std::max(q.config.max_attempts, 1);
+                for (Item& item : q.items) {
+                    if (in_batch(item)) {
+                        item.attempts++;
+                    }
+                }
+                const size_t before = q.items.size();
+                q.items.erase(std::remove_if(q.items.begin(), q.items.end(),
+                                             [&](const Item& item) {
+                                                 return in_batch(item) &&
+                                                        item.attempts >= max_attempts;
+                                             }),
+                              q.items.end());
+                if (q.items.size() != before) {
+                    RAC_LOG_WARNING(LOG_CAT, "Dropped %zu %s item(s) after %d attempts (%d)",
+                                    before - q.items.size(), kind.c_str(), max_attempts, result);
+                }
+            }
+            backoff_locked(q);
+        }
+        persist_locked(q);
+    }
+}
+
+// Caller holds q.mutex
+void ensure_worker_locked(Queue& q) {
+    if (!q.running && !q.stopping) {
+        q.running = true;
+        q.worker = std::thread(worker_loop);
+    }
+}
+
+}  // namespace
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+extern "C" {
+
+rac_result_t rac_outbound_queue_configure(const rac_outbound_queue_config_t* config) {
+    const rac_outbound_queue_config_t& cfg = config ? *config : RAC_OUTBOUND_QUEUE_CONFIG_DEFAULT;
+    if (cfg.max_items < 1 || cfg.max_attempts < 1 || cfg.initial_backoff_ms < 0 ||
+        cfg.max_backoff_ms < cfg.initial_backoff_ms || cfg.reconnect_jitter_ms < 0) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    Queue& q = queue();
+    std::lock_guard<std::mutex> lock(q.mutex);
+    q.config = cfg;
+    const std::string path = cfg.storage_path ? cfg.storage_path : "";
+    q.config.storage_path = nullptr;
+    if (path != q.storage_path) {
+        q.storage_path = path;
+        if (!path.empty()) {
+            const size_t loaded = load_locked(q);
+            if (loaded > 0) {
+                RAC_LOG_INFO(LOG_CAT, "Loaded %zu queued item(s) from %s", loaded, path.c_str());
+            }
+            persist_locked(q);
+        }
+    }
+    q.cv.notify_all();
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_outbound_queue_set_handler(const char* kind, rac_outbound_handler_fn handler,
+                                            int32_t max_batch, void* user_data) {
+    if (!kind || kind[0] == '\0') {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    Queue& q = queue();
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (!handler) {
+        q.handlers.erase(kind);
+        return RAC_SUCCESS;
+    }
+    Handler& entry = q.handlers[kind];
+    entry.fn = handler;
+    entry.max_batch = std::max(max_batch, 1);
+    entry.user_data = user_data;
+    ensure_worker_locked(q);
+    q.cv.notify_all();
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_outbound_queue_enqueue(const char* kind, const char* key, const void* payload,
+                                        size_t payload_length, rac_request_priority_t priority) {
+    if (!kind || kind[0] == '\0' || (!payload && payload_length > 0)) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    Item item;
+    item.kind = kind;
+    item.key = key ? key : "";
+    if (payload_length > 0) {
+        item.payload.assign(static_cast<const char*>(payload), payload_length);
+    }
+    item.priority = priority;
+    item.enqueued_at_ms = unix_time_ms();
+
+    Queue& q = queue();
+    std::lock_guard<std::mutex> lock(q.mutex);
+    item.seq = q.next_seq++;
+    if (!item.key.empty()) {
+        auto existing = std::find_if(q.items.begin(), q.items.end(), [&item](const Item& queued) {
+            return queued.kind == item.kind && queued.key == item.key;
+        });
+        if (existing != q.items.end()) {
+            item.priority = std::max(item.priority, existing->priority);
+            item.enqueued_at_ms = existing->enqueued_at_ms;
+            q.items.erase(existing);
+        }
+    }
+
+    if (static_cast<int32_t>(q.items.size()) >= q.config.max_items) {
+        auto victim = std::min_element(q.items.begin(), q.items.end(),
+                                       [](const Item& a, const Item& b) {
+                                           return a.priority != b.priority
+                                                      ? a.priority < b.priority
+                                                      : a.seq < b.seq;
+                                       });
+        RAC_LOG_WARNING(LOG_CAT, "Queue full; dropping a %s item", victim->kind.c_str());
+        q.items.erase(victim);
+    }
+    q.items.push_back(std::move(item));
+    persist_locked(q);
+    ensure_worker_locked(q);
+    q.cv.notify_all();
+    return RAC_SUCCESS;
+}
+
+void rac_outbound_queue_set_online(rac_bool_t online) {
+    Queue& q = queue();
+    std::lock_guard<std::mutex> lock(q.mutex);
+    const bool now_online = online == RAC_TRUE;
+    if (now_online == q.online) {
+        return;
+    }
+    q.online = now_online;
+    if (now_online) {
+        q.epoch++;
+        q.consecutive_failures = 0;
+        const int32_t jitter = q.config.reconnect_jitter_ms;
+        const int32_t delay =
+            jitter > 0 ? static_cast<int32_t>(q.rng() % static_cast<uint32_t>(jitter + 1)) : 0;
+        q.not_before = Clock::now() + std::chrono::milliseconds(delay);
+        RAC_LOG_INFO(LOG_CAT, "Online; draining %zu item(s) in %d ms", q.items.size(), delay);
+    } else {
+        RAC_LOG_INFO(LOG_CAT, "Offline; holding outbound work");
+    }
+    q.cv.notify_all();
+}
+
+rac_bool_t rac_outbound_queue_is_online(void) {
+    Queue& q = queue();
+    std::lock_guard<std::mutex> lock(q.mutex);
+    return q.online ? RAC_TRUE : RAC_FALSE;
+}
+
+rac_bool_t rac_outbound_queue_may_send(rac_request_priority_t priority) {
+    Queue& q = queue();
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (!q.online || Clock::now() < q.not_before) {
+        return RAC_FALSE;
+    }
+    const int next = next_item_locked(q);
+    return next < 0 || q.items[next].priority <= priority ? RAC_TRUE : RAC_FALSE;
+}
+
+uint32_t rac_outbound_queue_online_epoch(void) {
+    Queue& q = queue();
+    std::lock_guard<std::mutex> lock(q.mutex);
+    return q.epoch;
+}
+
+int32_t rac_outbound_queue_pending_count(void) {
+    Queue& q = queue();
+    std::lock_guard<std::mutex> lock(q.mutex);
+    return static_cast<int32_t>(q.items.size());
+}
+
+void rac_outbound_queue_flush(void) {
+    Queue& q = queue();
+    std::lock_guard<std::mutex> lock(q.mutex);
+    q.not_before = Clock::time_point();
+    q.cv.notify_all();
+}
+
+}  // extern "C"
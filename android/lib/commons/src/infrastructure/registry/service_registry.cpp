@@ -7,12 +7,14 @@
  * - Service provider registration with priority
  * - canHandle-style service creation (matches Swift pattern)
  * - Priority-based provider selection
+ * - Resolution cache so repeated requests skip the can_handle probes
  *
  * Uses function-local statics to avoid static initialization order issues
  * when called from Swift.
  */
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <mutex>
 #include <string>
@@ -52,8 +54,40 @@ struct ServiceRegistryState {
     std::mutex mutex;
     // Providers grouped by capability
     std::unordered_map<rac_capability_t, std::vector<ProviderEntry>> providers;
+
+    // Provider chosen for each (capability, identifier, framework, model path).
+    // can_handle often opens the model file, so repeated creates for the same
+    // model (per session or per stream) reuse the first answer. Cleared on
+    // register/unregister; generation keeps a resolution that raced with a
+    // change from being cached.
+    std::unordered_map<std::string, std::string> resolutions;
+    uint64_t generation = 0;
 };
 
+// Bound on cached resolutions; the cache is simply cleared when full
+constexpr size_t MAX_RESOLUTIONS = 256;
+
+std::string resolution_key(rac_capability_t capability, const rac_service_request_t* request) {
+    std::string key = std::to_string(static_cast<int>(capability));
+    key += '|';
+    key += std::to_string(static_cast<int>(request->framework));
+    key += '|';
+    if (request->identifier != nullptr) {
+        key += request->identifier;
+    }
+    key += '|';
+    if (request->model_path != nullptr) {
+        key += request->model_path;
+    }
+    return key;
+}
+
+// Caller holds state.mutex
+void invalidate_resolutions(ServiceRegistryState& state) {
+    state.resolutions.clear();
+    state.generation++;
+}
+
 /**
  * Get the service registry state singleton using Meyers' singleton pattern.
  * Function-local static guarantees thread-safe initialization on first use.
@@ -107,6 +141,9 @@ rac_result_t rac_service_register_provider(const rac_service_provider_t* provide
         providers.begin(), providers.end(),
         [](const ProviderEntry& a, const ProviderEntry& b) { return a.priority > b.priority; });
 
+    // A new provider may outrank the cached choices
+    invalidate_resolutions(state);
+
     RAC_LOG_INFO(LOG_CAT, "Registered provider: %s for capability %d", provider->name,
                  static_cast<int>(provider->capability));
     return RAC_SUCCESS;
@@ -144,55 +181,101 @@ rac_result_t rac_service_unregister_provider(const char* name, rac_capability_t
         state.providers.erase(it);
     }
 
+    invalidate_resolutions(state);
+
     RAC_LOG_INFO(LOG_CAT, "Provider unregistered: %s", name);
     return RAC_SUCCESS;
 }
 
 rac_result_t rac_service_create(rac_capability_t capability, const rac_service_request_t* request,
                                 rac_handle_t* out_handle) {
-    RAC_LOG_INFO(LOG_CAT, "rac_service_create called for capability=%d, identifier=%s",
-                 static_cast<int>(capability),
-                 request ? (request->identifier ? request->identifier : "(null)")
-                         : "(null request)");
+    RAC_LOG_DEBUG(LOG_CAT, "rac_service_create called for capability=%d, identifier=%s",
+                  static_cast<int>(capability),
+                  request ? (request->identifier ? request->identifier : "(null)")
+                          : "(null request)");
 
     if (request == nullptr || out_handle == nullptr) {
         RAC_LOG_ERROR(LOG_CAT, "rac_service_create: null pointer");
         return RAC_ERROR_NULL_POINTER;
     }
 
-    auto& state = get_state();
-    std::lock_guard<std::mutex> lock(state.mutex);
+    const std::string key = resolution_key(capability, request);
+
+    // Copy the providers and release the lock: create loads the model, which can
+    // take seconds, and other services must be able to load meanwhile
+    std::vector<ProviderEntry> providers;
+    std::string cached;
+    uint64_t generation = 0;
+    {
+        auto& state = get_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto it = state.providers.find(capability);
+        if (it != state.providers.end()) {
+            providers = it->second;
+        }
+        auto cached_it = state.resolutions.find(key);
+        if (cached_it != state.resolutions.end()) {
+            cached = cached_it->second;
+        }
+        generation = state.generation;
+    }
 
-    auto it = state.providers.find(capability);
-    if (it == state.providers.end() || it->second.empty()) {
+    if (providers.empty()) {
         RAC_LOG_ERROR(LOG_CAT, "rac_service_create: No providers registered for capability %d",
                       static_cast<int>(capability));
         rac_error_set_details("No providers registered for capability");
         return RAC_ERROR_NO_CAPABLE_PROVIDER;
     }
 
-    RAC_LOG_INFO(LOG_CAT, "rac_service_create: Found %zu providers for capability %d",
-                 it->second.size(), static_cast<int>(capability));
+    // Cached resolution: create directly without probing
+    if (!cached.empty()) {
+        for (const auto& provider : providers) {
+            if (provider.name != cached) {
+                continue;
+            }
+            rac_handle_t handle = provider.create(request, provider.user_data);
+            if (handle != nullptr) {
+                *out_handle = handle;
+                RAC_LOG_INFO(LOG_CAT,
+                             "rac_service_create: Service created by provider '%s' (cached), "
+                             "handle=%p",
+                             provider.name.c_str(), handle);
+                return RAC_SUCCESS;
+            }
+            RAC_LOG_WARNING(LOG_CAT,
+                            "rac_service_create: Cached provider '%s' create returned nullptr, "
+                            "probing all providers",
+                            provider.name.c_str());
+            break;
+        }
+    }
+
+    RAC_LOG_DEBUG(LOG_CAT, "rac_service_create: Found %zu providers for capability %d",
+                  providers.size(), static_cast<int>(capability));
 
     // Find first provider that can handle the request (already sorted by priority)
     // This matches Swift's pattern: registrations.sorted(by:).first(where: canHandle)
-    for (const auto& provider : it->second) {
-        RAC_LOG_INFO(LOG_CAT, "rac_service_create: Checking provider '%s' (priority=%d)",
-                     provider.name.c_str(), provider.priority);
-
+    for (const auto& provider : providers) {
         bool can_handle = provider.can_handle(request, provider.user_data);
-        RAC_LOG_INFO(LOG_CAT, "rac_service_create: Provider '%s' can_handle=%s",
-                     provider.name.c_str(), can_handle ? "TRUE" : "FALSE");
+        RAC_LOG_DEBUG(LOG_CAT, "rac_service_create: Provider '%s' (priority=%d) can_handle=%s",
+                      provider.name.c_str(), provider.priority, can_handle ? "TRUE" : "FALSE");
 
         if (can_handle) {
-            RAC_LOG_INFO(LOG_CAT, "rac_service_create: Calling create for provider '%s'",
-                         provider.name.c_str());
             rac_handle_t handle = provider.create(request, provider.user_data);
             if (handle != nullptr) {
                 *out_handle = handle;
                 RAC_LOG_INFO(LOG_CAT,
                              "rac_service_create: Service created by provider '%s', handle=%p",
                              provider.name.c_str(), handle);
+
+                auto& state = get_state();
+                std::lock_guard<std::mutex> lock(state.mutex);
+                if (state.generation == generation) {
+                    if (state.resolutions.size() >= MAX_RESOLUTIONS) {
+                        state.resolutions.clear();
+                    }
+                    state.resolutions[key] = provider.name;
+                }
                 return RAC_SUCCESS;
             } else {
                 RAC_LOG_ERROR(LOG_CAT, "rac_service_create: Provider '%s' create returned nullptr",
@@ -201,6 +284,15 @@ rac_result_t rac_service_create(rac_capability_t capability, const rac_service_r
         }
     }
 
+    {
+        // Drop a cached resolution that no longer works
+        auto& state = get_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.generation == generation) {
+            state.resolutions.erase(key);
+        }
+    }
+
     RAC_LOG_ERROR(LOG_CAT, "rac_service_create: No provider could handle the request");
     rac_error_set_details("No provider could handle the request");
     return RAC_ERROR_NO_CAPABLE_PROVIDER;
@@ -253,6 +345,7 @@ void reset_service_registry() {
     auto& state = get_state();
     std::lock_guard<std::mutex> lock(state.mutex);
     state.providers.clear();
+    invalidate_resolutions(state);
 }
 
 }  // namespace rac_internal
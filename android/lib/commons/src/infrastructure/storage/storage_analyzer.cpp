@@ -6,13 +6,18 @@
  * - Uses rac_model_registry for model listing
  * - Uses rac_model_paths for path calculations
  * - Calls platform callbacks for file operations
+ * - Caches directory sizes in the registry index and sizes the rest in parallel
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
 #include "rac/infrastructure/model_management/rac_model_paths.h"
 #include "rac/infrastructure/model_management/rac_model_registry.h"
@@ -26,6 +31,64 @@ struct rac_storage_analyzer {
     rac_storage_callbacks_t callbacks;
 };
 
+namespace {
+
+// Directory sizing is I/O bound; a few walkers overlap the disk latency
+constexpr size_t kMaxSizeWorkers = 4;
+
+struct SizeJob {
+    std::string path;
+    int64_t* out_size;
+    int64_t mtime_ns;
+};
+
+// Fills each job's size from the registry cache, or measures it and caches it
+void size_directories(rac_storage_analyzer_handle_t handle,
+                      rac_model_registry_handle_t registry_handle, std::vector<SizeJob>& jobs) {
+    std::vector<SizeJob*> pending;
+    for (SizeJob& job : jobs) {
+        if (rac_model_registry_get_dir_size(registry_handle, job.path.c_str(), job.out_size,
+                                            &job.mtime_ns) != RAC_SUCCESS) {
+            pending.push_back(&job);
+        }
+    }
+    if (pending.empty()) {
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    auto run_worker = [&] {
+        for (size_t i = next.fetch_add(1); i < pending.size(); i = next.fetch_add(1)) {
+            *pending[i]->out_size = handle->callbacks.calculate_dir_size(
+                pending[i]->path.c_str(), handle->callbacks.user_data);
+        }
+    };
+
+    // The calling thread is one of the workers
+    const size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    const size_t worker_count = std::min({kMaxSizeWorkers, hardware, pending.size()});
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < worker_count; ++i) {
+        workers.emplace_back(run_worker);
+    }
+    run_worker();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (SizeJob* job : pending) {
+        if (job->mtime_ns != 0 && *job->out_size >= 0) {
+            rac_model_registry_set_dir_size(registry_handle, job->path.c_str(), job->mtime_ns,
+                                            *job->out_size);
+        }
+    }
+    rac_model_registry_flush_index(registry_handle);
+    RAC_LOG_DEBUG("StorageAnalyzer", "Sized %zu of %zu directories on %zu workers",
+                  pending.size(), jobs.size(), worker_count);
+}
+
+}  // namespace
+
 // =============================================================================
 // LIFECYCLE
 // =============================================================================
@@ -78,12 +141,13 @@ rac_result_t rac_storage_analyzer_analyze(rac_storage_analyzer_handle_t handle,
     out_info->device_storage.used_space =
         out_info->device_storage.total_space - out_info->device_storage.free_space;
 
+    // Directories are sized together once the models are listed
+    std::vector<SizeJob> jobs;
+
     // Get app storage - calculate base directory size
     char base_dir[1024];
     if (rac_model_paths_get_base_directory(base_dir, sizeof(base_dir)) == RAC_SUCCESS) {
-        out_info->app_storage.documents_size =
-            handle->callbacks.calculate_dir_size(base_dir, handle->callbacks.user_data);
-        out_info->app_storage.total_size = out_info->app_storage.documents_size;
+        jobs.push_back(SizeJob{base_dir, &out_info->app_storage.documents_size, 0});
     }
 
     // Get downloaded models from registry
@@ -95,13 +159,16 @@ rac_result_t rac_storage_analyzer_analyze(rac_storage_analyzer_handle_t handle,
         // No models is okay, just return empty
         out_info->models = nullptr;
         out_info->model_count = 0;
+        size_directories(handle, registry_handle, jobs);
+        out_info->app_storage.total_size = out_info->app_storage.documents_size;
         return RAC_SUCCESS;
     }
 
     // Allocate model metrics array
     if (model_count > 0) {
         out_info->models = static_cast<rac_model_storage_metrics_t*>(
-            calloc(model_count, sizeof(rac_model_storage_metrics_t)));
+            rac_calloc_tagged(RAC_ALLOC_TAG_MODEL,
+                              model_count, sizeof(rac_model_storage_metrics_t)));
         if (!out_info->models) {
             rac_model_info_array_free(models, model_count);
             return RAC_ERROR_OUT_OF_MEMORY;
@@ -117,8 +184,9 @@ rac_result_t rac_storage_analyzer_analyze(rac_storage_analyzer_handle_t handle,
         rac_model_storage_metrics_t* metrics = &out_info->models[i];
 
         // Copy model info
-        metrics->model_id = model->id ? strdup(model->id) : nullptr;
-        metrics->model_name = model->name ? strdup(model->name) : nullptr;
+        metrics->model_id = model->id ? rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, model->id) : nullptr;
+        metrics->model_name =
+            model->name ? rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, model->name) : nullptr;
         metrics->framework = model->framework;
         metrics->format = model->format;
         metrics->artifact_info = model->artifact_info;
@@ -129,31 +197,34 @@ rac_result_t rac_storage_analyzer_analyze(rac_storage_analyzer_handle_t handle,
 
         if (model->local_path && strlen(model->local_path) > 0) {
             path_to_use = model->local_path;
-            metrics->local_path = strdup(model->local_path);
+            metrics->local_path = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, model->local_path);
         } else if (model->id) {
             // Calculate path using rac_model_paths
             if (rac_model_paths_get_model_folder(model->id, model->framework, path_buffer,
                                                  sizeof(path_buffer)) == RAC_SUCCESS) {
                 path_to_use = path_buffer;
-                metrics->local_path = strdup(path_buffer);
+                metrics->local_path = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, path_buffer);
             }
         }
 
         // Calculate size via callback
         if (path_to_use) {
-            metrics->size_on_disk =
-                handle->callbacks.calculate_dir_size(path_to_use, handle->callbacks.user_data);
+            jobs.push_back(SizeJob{path_to_use, &metrics->size_on_disk, 0});
         } else {
             // Fallback to download size if we can't calculate
             metrics->size_on_disk = model->download_size;
         }
-
-        out_info->total_models_size += metrics->size_on_disk;
     }
 
     // Free the models array from registry
     rac_model_info_array_free(models, model_count);
 
+    size_directories(handle, registry_handle, jobs);
+    out_info->app_storage.total_size = out_info->app_storage.documents_size;
+    for (size_t i = 0; i < model_count; i++) {
+        out_info->total_models_size += out_info->models[i].size_on_disk;
+    }
+
     return RAC_SUCCESS;
 }
 
@@ -177,8 +248,9 @@ rac_result_t rac_storage_analyzer_get_model_metrics(rac_storage_analyzer_handle_
     memset(out_metrics, 0, sizeof(rac_model_storage_metrics_t));
 
     // Copy model info
-    out_metrics->model_id = model->id ? strdup(model->id) : nullptr;
-    out_metrics->model_name = model->name ? strdup(model->name) : nullptr;
+    out_metrics->model_id = model->id ? rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, model->id) : nullptr;
+    out_metrics->model_name =
+        model->name ? rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, model->name) : nullptr;
     out_metrics->framework = model->framework;
     out_metrics->format = model->format;
     out_metrics->artifact_info = model->artifact_info;
@@ -189,19 +261,19 @@ rac_result_t rac_storage_analyzer_get_model_metrics(rac_storage_analyzer_handle_
 
     if (model->local_path && strlen(model->local_path) > 0) {
         path_to_use = model->local_path;
-        out_metrics->local_path = strdup(model->local_path);
+        out_metrics->local_path = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, model->local_path);
     } else {
         if (rac_model_paths_get_model_folder(model_id, framework, path_buffer,
                                              sizeof(path_buffer)) == RAC_SUCCESS) {
             path_to_use = path_buffer;
-            out_metrics->local_path = strdup(path_buffer);
+            out_metrics->local_path = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, path_buffer);
         }
     }
 
     // Calculate size
     if (path_to_use) {
-        out_metrics->size_on_disk =
-            handle->callbacks.calculate_dir_size(path_to_use, handle->callbacks.user_data);
+        std::vector<SizeJob> jobs{SizeJob{path_to_use, &out_metrics->size_on_disk, 0}};
+        size_directories(handle, registry_handle, jobs);
     } else {
         out_metrics->size_on_disk = model->download_size;
     }
@@ -236,9 +308,10 @@ rac_result_t rac_storage_analyzer_check_available(rac_storage_analyzer_handle_t
         // Simple message - platform can format with locale-specific formatter
         char msg[256];
         snprintf(msg, sizeof(msg), "Need %lld more bytes of space.", (long long)shortfall);
-        out_availability->recommendation = strdup(msg);
+        out_availability->recommendation = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, msg);
     } else if (out_availability->has_warning == RAC_TRUE) {
-        out_availability->recommendation = strdup("Storage space is getting low.");
+        out_availability->recommendation =
+            rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, "Storage space is getting low.");
     }
 
     return RAC_SUCCESS;
@@ -283,11 +356,11 @@ void rac_storage_info_free(rac_storage_info_t* info) {
 
     if (info->models) {
         for (size_t i = 0; i < info->model_count; i++) {
-            free(const_cast<char*>(info->models[i].model_id));
-            free(const_cast<char*>(info->models[i].model_name));
-            free(const_cast<char*>(info->models[i].local_path));
+            rac_free(const_cast<char*>(info->models[i].model_id));
+            rac_free(const_cast<char*>(info->models[i].model_name));
+            rac_free(const_cast<char*>(info->models[i].local_path));
         }
-        free(info->models);
+        rac_free(info->models);
     }
 
     memset(info, 0, sizeof(rac_storage_info_t));
@@ -297,6 +370,6 @@ void rac_storage_availability_free(rac_storage_availability_t* availability) {
     if (!availability)
         return;
 
-    free(const_cast<char*>(availability->recommendation));
+    rac_free(const_cast<char*>(availability->recommendation));
     memset(availability, 0, sizeof(rac_storage_availability_t));
 }
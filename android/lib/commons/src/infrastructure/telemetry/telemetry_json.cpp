@@ -5,6 +5,9 @@
  * Environment-aware encoding:
  * - Development (Supabase): Uses sdk_event_id, event_timestamp, includes all fields
  * - Production (FastAPI): Uses id, timestamp, skips modality/device_id (batch level)
+ *
+ * Merged batches (all modalities in one request) can also be written as
+ * CBOR: the same document, with binary numbers and epoch timestamps.
  */
 
 #include <cstdio>
@@ -14,6 +17,7 @@
 #include <sstream>
 #include <string>
 
+#include "rac/core/rac_allocator.h"
 #include "rac/core/rac_logger.h"
 #include "rac/infrastructure/network/rac_endpoints.h"
 #include "rac/infrastructure/telemetry/rac_telemetry_manager.h"
@@ -179,21 +183,126 @@ class JsonBuilder {
     bool first_ = true;
 };
 
+// Same interface as JsonBuilder, writing CBOR (RFC 8949). Maps and arrays
+// use indefinite lengths so they can be written in one pass.
+class CborBuilder {
+   public:
+    void start_object() { out_.push_back(static_cast<char>(0xBF)); }
+    void end_object() { out_.push_back(static_cast<char>(0xFF)); }
+    void start_array() { out_.push_back(static_cast<char>(0x9F)); }
+    void end_array() { out_.push_back(static_cast<char>(0xFF)); }
+
+    // Key of the map, array or raw value written next
+    void add_key(const char* key) { text(key); }
+
+    void add_string(const char* key, const char* value) {
+        if (!value)
+            return;
+        text(key);
+        text(value);
+    }
+
+    void add_int(const char* key, int64_t value) {
+        if (value == 0)
+            return;  // Skip zero values
+        text(key);
+        integer(value);
+    }
+
+    void add_double(const char* key, double value) {
+        if (value == 0.0)
+            return;  // Skip zero values
+        text(key);
+        real(value);
+    }
+
+    void add_bool(const char* key, rac_bool_t value, rac_bool_t has_value) {
+        if (!has_value)
+            return;
+        text(key);
+        out_.push_back(static_cast<char>(value ? 0xF5 : 0xF4));
+    }
+
+    // Tag 1: seconds since the epoch
+    void add_timestamp(const char* key, int64_t ms) {
+        text(key);
+        head(6, 1);
+        real(static_cast<double>(ms) / 1000.0);
+    }
+
+    const std::string& str() const { return out_; }
+
+   private:
+    void head(uint8_t major, uint64_t value) {
+        const char type = static_cast<char>(major << 5);
+        if (value < 24) {
+            out_.push_back(static_cast<char>(type | value));
+        } else if (value <= 0xFF) {
+            out_.push_back(static_cast<char>(type | 24));
+            big_endian(value, 1);
+        } else if (value <= 0xFFFF) {
+            out_.push_back(static_cast<char>(type | 25));
+            big_endian(value, 2);
+        } else if (value <= 0xFFFFFFFFu) {
+            out_.push_back(static_cast<char>(type | 26));
+            big_endian(value, 4);
+        } else {
+            out_.push_back(static_cast<char>(type | 27));
+            big_endian(value, 8);
+        }
+    }
+
+    void big_endian(uint64_t value, int bytes) {
+        for (int i = bytes - 1; i >= 0; i--) {
+            out_.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+        }
+    }
+
+    void text(const char* s) {
+        size_t len = strlen(s);
+        head(3, len);
+        out_.append(s, len);
+    }
+
+    void integer(int64_t value) {
+        if (value >= 0) {
+            head(0, static_cast<uint64_t>(value));
+        } else {
+            head(1, static_cast<uint64_t>(-1 - value));
+        }
+    }
+
+    // Single precision when it is exact, double otherwise
+    void real(double value) {
+        float narrow = static_cast<float>(value);
+        if (static_cast<double>(narrow) == value) {
+            uint32_t bits;
+            memcpy(&bits, &narrow, sizeof(bits));
+            out_.push_back(static_cast<char>(0xFA));
+            big_endian(bits, 4);
+        } else {
+            uint64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            out_.push_back(static_cast<char>(0xFB));
+            big_endian(bits, 8);
+        }
+    }
+
+    std::string out_;
+};
+
 }  // namespace
 
 // =============================================================================
 // PAYLOAD JSON SERIALIZATION
 // =============================================================================
 
-rac_result_t rac_telemetry_manager_payload_to_json(const rac_telemetry_payload_t* payload,
-                                                   rac_environment_t env, char** out_json,
-                                                   size_t* out_length) {
-    if (!payload || !out_json || !out_length) {
-        return RAC_ERROR_INVALID_ARGUMENT;
-    }
+namespace {
 
+// Writes one payload as an object; Builder is JsonBuilder or CborBuilder
+template <typename Builder>
+void write_payload(Builder& json, const rac_telemetry_payload_t* payload, rac_environment_t env) {
     bool is_production = (env != RAC_ENV_DEVELOPMENT);
-    JsonBuilder json;
     json.start_object();
 
     // Required fields - different key names based on environment
@@ -281,11 +390,50 @@ rac_result_t rac_telemetry_manager_payload_to_json(const rac_telemetry_payload_t
     // Network
     json.add_bool("is_online", payload->is_online, payload->has_is_online);
 
+    // Device profile
+    json.add_string("device_class", payload->device_class);
+    json.add_double("matmul_gflops", payload->matmul_gflops);
+    json.add_double("memory_bandwidth_gbps", payload->memory_bandwidth_gbps);
+    json.add_double("prefill_tokens_per_second", payload->prefill_tokens_per_second);
+    json.add_int("best_threads", payload->best_threads);
+
+    // SDK lifecycle
+    json.add_string("subsystem", payload->subsystem);
+
+    // Field performance samples
+    json.add_string("stage", payload->stage);
+    json.add_string("thermal_state", payload->thermal_state);
+    json.add_double("p50_ms", payload->p50_ms);
+    json.add_double("p95_ms", payload->p95_ms);
+    json.add_double("p99_ms", payload->p99_ms);
+    json.add_double("max_ms", payload->max_ms);
+    json.add_string("histogram", payload->histogram);
+    json.add_double("cpu_freq_mhz", payload->cpu_freq_mhz);
+    json.add_double("window_ms", payload->window_ms);
+
+    // Per-call memory
+    json.add_int("peak_rss_bytes", payload->peak_rss_bytes);
+    json.add_int("rss_delta_bytes", payload->rss_delta_bytes);
+    json.add_int("backend_memory_bytes", payload->backend_memory_bytes);
+
     json.end_object();
+}
+
+}  // namespace
+
+rac_result_t rac_telemetry_manager_payload_to_json(const rac_telemetry_payload_t* payload,
+                                                   rac_environment_t env, char** out_json,
+                                                   size_t* out_length) {
+    if (!payload || !out_json || !out_length) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    JsonBuilder json;
+    write_payload(json, payload, env);
 
     std::string result = json.str();
     *out_length = result.size();
-    *out_json = (char*)malloc(*out_length + 1);
+    *out_json = (char*)rac_alloc_tagged(RAC_ALLOC_TAG_TELEMETRY, *out_length + 1);
     if (!*out_json) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
@@ -322,7 +470,7 @@ rac_result_t rac_telemetry_manager_batch_to_json(const rac_telemetry_batch_reque
                     // Need to add comma manually since we're adding raw JSON
                 }
                 json.add_raw(event_json);
-                free(event_json);
+                rac_free(event_json);
             }
         }
 
@@ -330,7 +478,7 @@ rac_result_t rac_telemetry_manager_batch_to_json(const rac_telemetry_batch_reque
 
         std::string result = json.str();
         *out_length = result.size();
-        *out_json = (char*)malloc(*out_length + 1);
+        *out_json = (char*)rac_alloc_tagged(RAC_ALLOC_TAG_TELEMETRY, *out_length + 1);
         if (!*out_json) {
             return RAC_ERROR_OUT_OF_MEMORY;
         }
@@ -353,7 +501,7 @@ rac_result_t rac_telemetry_manager_batch_to_json(const rac_telemetry_batch_reque
                                                                         &event_json, &event_len);
             if (result == RAC_SUCCESS && event_json) {
                 events_ss << event_json;
-                free(event_json);
+                rac_free(event_json);
             }
         }
         events_ss << "]";
@@ -367,7 +515,7 @@ rac_result_t rac_telemetry_manager_batch_to_json(const rac_telemetry_batch_reque
 
         std::string result = json.str();
         *out_length = result.size();
-        *out_json = (char*)malloc(*out_length + 1);
+        *out_json = (char*)rac_alloc_tagged(RAC_ALLOC_TAG_TELEMETRY, *out_length + 1);
         if (!*out_json) {
             return RAC_ERROR_OUT_OF_MEMORY;
         }
@@ -377,6 +525,84 @@ rac_result_t rac_telemetry_manager_batch_to_json(const rac_telemetry_batch_reque
     return RAC_SUCCESS;
 }
 
+// =============================================================================
+// MERGED BATCH ENCODING
+// =============================================================================
+
+rac_result_t rac_telemetry_manager_encode_batches(const rac_telemetry_batch_request_t* batches,
+                                                  size_t batch_count, const char* device_id,
+                                                  int64_t timestamp_ms,
+                                                  rac_telemetry_encoding_t encoding,
+                                                  char** out_body, size_t* out_length) {
+    if ((!batches && batch_count > 0) || !out_body || !out_length) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    // {"device_id": "...", "timestamp": ..., "batches": [<batch request>, ...]}
+    std::string body;
+    if (encoding == RAC_TELEMETRY_ENCODING_CBOR) {
+        CborBuilder cbor;
+        cbor.start_object();
+        cbor.add_string("device_id", device_id);
+        cbor.add_timestamp("timestamp", timestamp_ms);
+        cbor.add_key("batches");
+        cbor.start_array();
+        for (size_t b = 0; b < batch_count; b++) {
+            const rac_telemetry_batch_request_t& batch = batches[b];
+            cbor.start_object();
+            cbor.add_key("events");
+            cbor.start_array();
+            for (size_t i = 0; i < batch.events_count; i++) {
+                write_payload(cbor, &batch.events[i], RAC_ENV_PRODUCTION);
+            }
+            cbor.end_array();
+            cbor.add_string("device_id", batch.device_id);
+            cbor.add_timestamp("timestamp", batch.timestamp_ms);
+            cbor.add_string("modality", batch.modality);
+            cbor.end_object();
+        }
+        cbor.end_array();
+        cbor.end_object();
+        body = cbor.str();
+    } else {
+        // Each element is the batch object the per-modality endpoint takes
+        std::stringstream batches_ss;
+        batches_ss << "\"batches\":[";
+        for (size_t b = 0; b < batch_count; b++) {
+            char* batch_json = nullptr;
+            size_t batch_len = 0;
+            rac_result_t result = rac_telemetry_manager_batch_to_json(
+                &batches[b], RAC_ENV_PRODUCTION, &batch_json, &batch_len);
+            if (result != RAC_SUCCESS) {
+                return result;
+            }
+            if (b > 0)
+                batches_ss << ",";
+            batches_ss << batch_json;
+            rac_free(batch_json);
+        }
+        batches_ss << "]";
+
+        JsonBuilder json;
+        json.start_object();
+        json.add_string("device_id", device_id);
+        json.add_timestamp("timestamp", timestamp_ms);
+        json.add_raw(batches_ss.str().c_str());
+        json.end_object();
+        body = json.str();
+    }
+
+    *out_length = body.size();
+    *out_body = (char*)rac_alloc_tagged(RAC_ALLOC_TAG_TELEMETRY, *out_length + 1);
+    if (!*out_body) {
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+    memcpy(*out_body, body.data(), *out_length);
+    (*out_body)[*out_length] = '\0';
+
+    return RAC_SUCCESS;
+}
+
 // =============================================================================
 // DEVICE REGISTRATION JSON
 // =============================================================================
@@ -495,7 +721,7 @@ rac_result_t rac_device_registration_to_json(const rac_device_registration_reque
 
     std::string result = json.str();
     *out_length = result.size();
-    *out_json = (char*)malloc(*out_length + 1);
+    *out_json = (char*)rac_alloc_tagged(RAC_ALLOC_TAG_TELEMETRY, *out_length + 1);
     if (!*out_json) {
         return RAC_ERROR_OUT_OF_MEMORY;
     }
@@ -3,25 +3,503 @@
  * @brief Telemetry manager implementation
  *
  * Handles event queuing, batching by modality, and HTTP callbacks.
+ *
+ * Queued payloads own no heap strings of their own: device constants point
+ * at interned copies held by the manager, and per-event strings are bumped
+ * into an arena that belongs to the queued batch and is released in one go
+ * once the batch has been sent.
+ *
+ * Sending happens on a background flusher thread, never inside track. With a
+ * spool path set, every queued event is also appended to a memory-mapped
+ * file and stays there until its batch is acknowledged, so events survive a
+ * crash and are sent on the next run. Failed batches are retried from the
+ * spool with exponential backoff.
  */
 
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "rac/core/rac_logger.h"
+#include "rac/core/rac_metrics.h"
 #include "rac/infrastructure/network/rac_endpoints.h"
+#include "rac/infrastructure/network/rac_outbound_queue.h"
 #include "rac/infrastructure/telemetry/rac_telemetry_manager.h"
 
 // =============================================================================
 // INTERNAL STRUCTURES
 // =============================================================================
 
+namespace {
+
+/**
+ * Bump allocator for the strings of one batch. reset() keeps the chunks, so
+ * a recycled arena serves the next batch without touching the heap.
+ */
+class StringArena {
+   public:
+    const char* copy(const char* s) { return s ? copy(s, strlen(s)) : nullptr; }
+
+    const char* copy(const char* s, size_t len) {
+        char* dst = allocate(len + 1);
+        if (dst) {
+            memcpy(dst, s, len);
+            dst[len] = '\0';
+        }
+        return dst;
+    }
+
+    void reset() {
+        current_ = 0;
+        used_ = 0;
+    }
+
+   private:
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    char* allocate(size_t len) {
+        while (current_ < chunks_.size()) {
+            Chunk& chunk = chunks_[current_];
+            if (chunk.size - used_ >= len) {
+                char* p = chunk.data.get() + used_;
+                used_ += len;
+                return p;
+            }
+            current_++;
+            used_ = 0;
+        }
+        size_t size = len > CHUNK_SIZE ? len : CHUNK_SIZE;
+        Chunk chunk{std::unique_ptr<char[]>(new (std::nothrow) char[size]), size};
+        if (!chunk.data) {
+            return nullptr;
+        }
+        chunks_.push_back(std::move(chunk));
+        current_ = chunks_.size() - 1;
+        used_ = len;
+        return chunks_.back().data.get();
+    }
+
+    std::vector<Chunk> chunks_;
+    size_t current_ = 0;
+    size_t used_ = 0;
+};
+
+// Spool file: a SpoolHeader, then records in [head, tail). Each record is a
+// RecordHeader and a body holding the payload struct (pointers zeroed) and
+// the payload's strings, each as a u32 length (kNullString for NULL) and its
+// bytes. A record only counts once tail has been moved past it.
+constexpr char kSpoolMagic[8] = {'R', 'A', 'C', 'T', 'S', 'P', 'L', '1'};
+constexpr uint32_t kSpoolVersion = 1;
+constexpr uint32_t kNullString = 0xFFFFFFFFu;
+constexpr size_t kSpoolInitialSize = 64 * 1024;
+constexpr size_t kSpoolMaxSize = 1024 * 1024;
+
+struct SpoolHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t payload_size;  // sizeof(rac_telemetry_payload_t) of the writer
+    uint64_t head;          // oldest unacknowledged record
+    uint64_t tail;          // end of the last committed record
+    uint8_t reserved[32];
+};
+static_assert(sizeof(SpoolHeader) == 64, "spool header must stay 64 bytes");
+
+struct RecordHeader {
+    uint32_t size;      // body bytes
+    uint32_t checksum;  // FNV-1a of the body
+};
+
+const char* rac_telemetry_payload_t::* const kStringFields[] = {
+    &rac_telemetry_payload_t::id,
+    &rac_telemetry_payload_t::event_type,
+    &rac_telemetry_payload_t::modality,
+    &rac_telemetry_payload_t::device_id,
+    &rac_telemetry_payload_t::session_id,
+    &rac_telemetry_payload_t::model_id,
+    &rac_telemetry_payload_t::model_name,
+    &rac_telemetry_payload_t::framework,
+    &rac_telemetry_payload_t::device,
+    &rac_telemetry_payload_t::os_version,
+    &rac_telemetry_payload_t::platform,
+    &rac_telemetry_payload_t::sdk_version,
+    &rac_telemetry_payload_t::error_message,
+    &rac_telemetry_payload_t::error_code,
+    &rac_telemetry_payload_t::language,
+    &rac_telemetry_payload_t::voice,
+    &rac_telemetry_payload_t::archive_type,
+    &rac_telemetry_payload_t::device_class,
+    &rac_telemetry_payload_t::subsystem,
+    &rac_telemetry_payload_t::stage,
+    &rac_telemetry_payload_t::thermal_state,
+    &rac_telemetry_payload_t::histogram,
+};
+
+uint32_t fnv1a(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Append-only, memory-mapped copy of the event queue. The file grows up to
+ * kSpoolMaxSize; past that the oldest records are dropped. Acknowledged
+ * records are reclaimed by moving the live range back to the start.
+ */
+class TelemetrySpool {
+   public:
+    ~TelemetrySpool() { close(); }
+
+    bool is_open() const { return map_ != nullptr; }
+
+    bool open(const std::string& path) {
+        close();
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (fd_ < 0) {
+            log_warning("Telemetry", "Cannot open telemetry spool %s: %s", path.c_str(),
+                        strerror(errno));
+            return false;
+        }
+
+        struct stat st = {};
+        size_t size = fstat(fd_, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+        bool valid = size >= sizeof(SpoolHeader) && size <= kSpoolMaxSize && map(size) &&
+                     header_valid();
+        if (!valid) {
+            if (size > 0) {
+                log_warning("Telemetry", "Discarding unreadable telemetry spool %s", path.c_str());
+            }
+            unmap();
+            if (ftruncate(fd_, 0) != 0 ||
+                ftruncate(fd_, static_cast<off_t>(kSpoolInitialSize)) != 0 ||
+                !map(kSpoolInitialSize)) {
+                log_warning("Telemetry", "Cannot size telemetry spool %s: %s", path.c_str(),
+                            strerror(errno));
+                close();
+                return false;
+            }
+            SpoolHeader* h = header();
+            memcpy(h->magic, kSpoolMagic, sizeof(kSpoolMagic));
+            h->version = kSpoolVersion;
+            h->payload_size = sizeof(rac_telemetry_payload_t);
+            h->head = sizeof(SpoolHeader);
+            h->tail = sizeof(SpoolHeader);
+        }
+        sent_ = header()->head;
+        return true;
+    }
+
+    void close() {
+        unmap();
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    void append(const rac_telemetry_payload_t& payload) {
+        if (!is_open()) {
+            return;
+        }
+
+        rac_telemetry_payload_t fixed = payload;
+        for (auto field : kStringFields) {
+            fixed.*field = nullptr;
+        }
+        scratch_.assign(reinterpret_cast<const uint8_t*>(&fixed),
+                        reinterpret_cast<const uint8_t*>(&fixed) + sizeof(fixed));
+        for (auto field : kStringFields) {
+            const char* value = payload.*field;
+            uint32_t len = value ? static_cast<uint32_t>(strlen(value)) : kNullString;
+            const uint8_t* len_bytes = reinterpret_cast<const uint8_t*>(&len);
+            scratch_.insert(scratch_.end(), len_bytes, len_bytes + sizeof(len));
+            if (value) {
+                scratch_.insert(scratch_.end(), value, value + len);
+            }
+        }
+
+        const size_t needed = sizeof(RecordHeader) + scratch_.size();
+        if (!reserve(needed)) {
+            log_warning("Telemetry", "Telemetry event of %zu bytes does not fit the spool", needed);
+            return;
+        }
+        RecordHeader record = {static_cast<uint32_t>(scratch_.size()),
+                               fnv1a(scratch_.data(), scratch_.size())};
+        uint8_t* dst = map_ + header()->tail;
+        memcpy(dst, &record, sizeof(record));
+        memcpy(dst + sizeof(record), scratch_.data(), scratch_.size());
+        header()->tail += needed;
+    }
+
+    // Queues every unacknowledged record; strings are copied into arena
+    void load(std::vector<rac_telemetry_payload_t>* out, StringArena* arena) {
+        if (!is_open()) {
+            return;
+        }
+        SpoolHeader* h = header();
+        uint64_t pos = h->head;
+        while (pos + sizeof(RecordHeader) <= h->tail) {
+            RecordHeader record;
+            memcpy(&record, map_ + pos, sizeof(record));
+            const uint8_t* body = map_ + pos + sizeof(record);
+            rac_telemetry_payload_t payload;
+            if (pos + sizeof(record) + record.size > h->tail ||
+                fnv1a(body, record.size) != record.checksum ||
+                !decode(body, record.size, arena, &payload)) {
+                log_warning("Telemetry",
+                            "Telemetry spool is damaged at offset %llu, dropping %llu bytes",
+                            static_cast<unsigned long long>(pos),
+                            static_cast<unsigned long long>(h->tail - pos));
+                h->tail = pos;
+                break;
+            }
+            out->push_back(payload);
+            pos += sizeof(record) + record.size;
+        }
+        sent_ = std::max(sent_, h->head);
+    }
+
+    // Records written so far make up the batch being sent
+    void mark_sent() {
+        if (is_open()) {
+            sent_ = header()->tail;
+        }
+    }
+
+    // The batch marked by mark_sent() was delivered
+    void acknowledge() {
+        if (!is_open()) {
+            return;
+        }
+        SpoolHeader* h = header();
+        h->head = std::min(std::max(h->head, sent_), h->tail);
+        if (h->head == h->tail) {
+            h->head = sizeof(SpoolHeader);
+            h->tail = sizeof(SpoolHeader);
+        }
+        sent_ = h->head;
+    }
+
+   private:
+    SpoolHeader* header() const { return reinterpret_cast<SpoolHeader*>(map_); }
+
+    bool header_valid() const {
+        const SpoolHeader* h = header();
+        return memcmp(h->magic, kSpoolMagic, sizeof(kSpoolMagic)) == 0 &&
+               h->version == kSpoolVersion &&
+               h->payload_size == sizeof(rac_telemetry_payload_t) &&
+               h->head >= sizeof(SpoolHeader) && h->head <= h->tail && h->tail <= map_size_;
+    }
+
+    bool map(size_t size) {
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+        map_ = static_cast<uint8_t*>(addr);
+        map_size_ = size;
+        return true;
+    }
+
+    void unmap() {
+        if (map_) {
+            munmap(map_, map_size_);
+            map_ = nullptr;
+            map_size_ = 0;
+        }
+    }
+
+    // Makes room for needed bytes at tail: reclaim, grow, then drop the oldest
+    bool reserve(size_t needed) {
+        if (needed > kSpoolMaxSize - sizeof(SpoolHeader)) {
+            return false;
+        }
+        if (header()->tail + needed <= map_size_) {
+            return true;
+        }
+        compact();
+        if (header()->tail + needed <= map_size_) {
+            return true;
+        }
+        if (map_size_ < kSpoolMaxSize) {
+            size_t size = map_size_;
+            while (size < header()->tail + needed && size < kSpoolMaxSize) {
+                size *= 2;
+            }
+            size = std::min(size, kSpoolMaxSize);
+            const size_t old_size = map_size_;
+            unmap();
+            if (ftruncate(fd_, static_cast<off_t>(size)) != 0 || !map(size)) {
+                log_warning("Telemetry", "Cannot grow telemetry spool: %s", strerror(errno));
+                if (!map(old_size)) {
+                    return false;
+                }
+            }
+            if (header()->tail + needed <= map_size_) {
+                return true;
+            }
+        }
+
+        // Free a quarter of the file at once so a full spool is not
+        // compacted on every append
+        SpoolHeader* h = header();
+        const size_t keep = map_size_ - sizeof(SpoolHeader) - map_size_ / 4;
+        size_t dropped = 0;
+        while (h->head < h->tail && h->tail - h->head + needed > keep) {
+            RecordHeader record;
+            memcpy(&record, map_ + h->head, sizeof(record));
+            h->head += sizeof(record) + record.size;
+            dropped++;
+        }
+        log_warning("Telemetry", "Telemetry spool full, dropped %zu oldest events", dropped);
+        compact();
+        return h->tail + needed <= map_size_;
+    }
+
+    // Moves the live records to the start of the file
+    void compact() {
+        SpoolHeader* h = header();
+        const uint64_t start = sizeof(SpoolHeader);
+        if (h->head == start) {
+            return;
+        }
+        const uint64_t shift = h->head - start;
+        memmove(map_ + start, map_ + h->head, static_cast<size_t>(h->tail - h->head));
+        sent_ = sent_ > h->head ? sent_ - shift : start;
+        h->tail -= shift;
+        h->head = start;
+    }
+
+    static bool decode(const uint8_t* body, size_t size, StringArena* arena,
+                       rac_telemetry_payload_t* out) {
+        if (size < sizeof(*out)) {
+            return false;
+        }
+        memcpy(out, body, sizeof(*out));
+        size_t pos = sizeof(*out);
+        for (auto field : kStringFields) {
+            uint32_t len;
+            if (pos + sizeof(len) > size) {
+                return false;
+            }
+            memcpy(&len, body + pos, sizeof(len));
+            pos += sizeof(len);
+            if (len == kNullString) {
+                out->*field = nullptr;
+                continue;
+            }
+            if (len > size - pos) {
+                return false;
+            }
+            out->*field = arena->copy(reinterpret_cast<const char*>(body + pos), len);
+            pos += len;
+        }
+        return true;
+    }
+
+    int fd_ = -1;
+    uint8_t* map_ = nullptr;
+    size_t map_size_ = 0;
+    uint64_t sent_ = 0;  // end of the batch in flight
+    std::vector<uint8_t> scratch_;
+};
+
+// One rule of the sampling policy with its token bucket
+struct SamplingRule {
+    std::string pattern;  // type, prefix when it ends in '*', or "*"
+    float sample_rate = 1.0f;
+    float rate_per_second = 0.0f;
+    double burst = 1.0;
+    double tokens = 1.0;
+    int64_t refilled_ms = 0;
+
+    bool matches(const char* type) const {
+        if (!pattern.empty() && pattern.back() == '*') {
+            return strncmp(type, pattern.c_str(), pattern.size() - 1) == 0;
+        }
+        return pattern == type;
+    }
+};
+
+bool is_failure(const rac_telemetry_payload_t& payload) {
+    if ((payload.has_success && !payload.success) || payload.error_message ||
+        payload.error_code) {
+        return true;
+    }
+    size_t len = payload.event_type ? strlen(payload.event_type) : 0;
+    return len >= 7 && strcmp(payload.event_type + len - 7, ".failed") == 0;
+}
+
+// Raw text of the value following "key": in json (strings unquoted), or empty
+std::string json_value(const std::string& json, const char* key) {
+    std::string search = std::string("\"") + key + "\"";
+    size_t pos = json.find(search);
+    if (pos == std::string::npos) {
+        return "";
+    }
+    pos = json.find(':', pos + search.size());
+    if (pos == std::string::npos) {
+        return "";
+    }
+    pos = json.find_first_not_of(" \t\r\n", pos + 1);
+    if (pos == std::string::npos) {
+        return "";
+    }
+    if (json[pos] == '"') {
+        size_t end = json.find('"', pos + 1);
+        return end == std::string::npos ? "" : json.substr(pos + 1, end - pos - 1);
+    }
+    size_t end = json.find_first_of(",}] \t\r\n", pos);
+    return json.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+}
+
+double json_number(const std::string& json, const char* key, double fallback) {
+    std::string value = json_value(json, key);
+    if (value.empty()) {
+        return fallback;
+    }
+    char* end = nullptr;
+    double number = strtod(value.c_str(), &end);
+    return end && *end == '\0' ? number : fallback;
+}
+
+// Appends a rule with a full bucket
+void add_rule(std::vector<SamplingRule>* rules, const char* pattern, float sample_rate,
+              float rate_per_second, int32_t burst) {
+    SamplingRule rule;
+    rule.pattern = pattern;
+    rule.sample_rate = std::min(1.0f, std::max(0.0f, sample_rate));
+    rule.rate_per_second = std::max(0.0f, rate_per_second);
+    rule.burst = std::max(1.0, burst > 0 ? static_cast<double>(burst)
+                                         : std::ceil(static_cast<double>(rule.rate_per_second)));
+    rule.tokens = rule.burst;
+    rules->push_back(rule);
+}
+
+}  // namespace
+
 struct rac_telemetry_manager {
     // Configuration
     rac_environment_t environment;
@@ -31,14 +509,60 @@ struct rac_telemetry_manager {
     std::string device_model;
     std::string os_version;
 
+    // Every device constant ever configured; queued payloads point into it,
+    // so set_device_info never invalidates a queued event
+    std::set<std::string> interned;
+    const char* interned_device_id = nullptr;
+    const char* interned_platform = nullptr;
+    const char* interned_sdk_version = nullptr;
+    const char* interned_device_model = nullptr;
+    const char* interned_os_version = nullptr;
+
     // HTTP callback
     rac_telemetry_http_callback_t http_callback;
     void* http_user_data;
+    rac_telemetry_encoding_t encoding = RAC_TELEMETRY_ENCODING_JSON;
+
+    // Sampling policy (rac_telemetry_manager_set_policy), applied in track
+    std::vector<SamplingRule> sampling_rules;
+    bool keep_errors = true;
+    int64_t min_flush_interval_ms = 0;
+    uint64_t sampled_out = 0;
+    uint64_t random_state = 0x9E3779B97F4A7C15ull;
 
-    // Event queue
+    // Event queue; its strings live in queue_arena. The spares are the last
+    // sent batch's buffers, reset and kept for the next one.
     std::vector<rac_telemetry_payload_t> queue;
+    StringArena queue_arena;
+    std::vector<rac_telemetry_payload_t> spare_queue;
+    StringArena spare_arena;
     std::mutex queue_mutex;
 
+    // On-disk copy of the queue (rac_telemetry_manager_set_spool_path); a
+    // failed batch sets reload_from_spool so the retry rebuilds the queue
+    TelemetrySpool spool;
+    bool reload_from_spool = false;
+
+    // Background flusher; sleeps on queue_cv under queue_mutex
+    std::thread flusher;
+    std::condition_variable queue_cv;
+    bool flush_requested = false;
+    bool stopping = false;
+
+    // Requests of the last batch not yet reported by http_complete. Until a
+    // platform reports a result, batches count as delivered once sent.
+    int32_t pending_requests = 0;
+    bool pending_failed = false;
+    int64_t pending_since_ms = 0;
+    bool acks_seen = false;
+    int32_t consecutive_failures = 0;
+    int64_t retry_after_ms = 0;
+    uint32_t retry_epoch = 0;  // Outbound queue online epoch of the last failure
+
+    const char* intern(const std::string& value) {
+        return interned.insert(value).first->c_str();
+    }
+
     // V2 modalities for grouping
     std::set<std::string> v2_modalities = {"llm", "stt", "tts", "model"};
 
@@ -46,6 +570,12 @@ struct rac_telemetry_manager {
     static constexpr size_t BATCH_SIZE_PRODUCTION = 10;  // Flush after 10 events in production
     static constexpr int64_t BATCH_TIMEOUT_MS = 5000;    // Flush after 5 seconds in production
     int64_t last_flush_time_ms = 0;                      // Track last flush time for timeout
+
+    // Delivery and retry
+    static constexpr int64_t FLUSHER_TICK_MS = 1000;   // Flusher re-checks timers this often
+    static constexpr int64_t ACK_TIMEOUT_MS = 30000;   // Unreported batches count as delivered
+    static constexpr int64_t RETRY_BASE_MS = 2000;     // First retry delay, doubled per failure
+    static constexpr int64_t RETRY_MAX_MS = 300000;    // Retry delay cap
 };
 
 // =============================================================================
@@ -97,17 +627,6 @@ std::string generate_uuid() {
     return uuid;
 }
 
-// Duplicate string (caller must free)
-char* dup_string(const char* s) {
-    if (!s)
-        return nullptr;
-    size_t len = strlen(s) + 1;
-    char* copy = (char*)malloc(len);
-    if (copy)
-        memcpy(copy, s, len);
-    return copy;
-}
-
 // Convert analytics event type to modality
 const char* event_type_to_modality(rac_event_type_t type) {
     if (type >= RAC_EVENT_LLM_MODEL_LOAD_STARTED && type <= RAC_EVENT_LLM_STREAMING_UPDATE) {
@@ -275,6 +794,10 @@ const char* event_type_to_string(rac_event_type_t type) {
             return "device.registered";
         case RAC_EVENT_DEVICE_REGISTRATION_FAILED:
             return "device.registration.failed";
+        case RAC_EVENT_DEVICE_PROFILED:
+            return "device.profiled";
+        case RAC_EVENT_DEVICE_PERF_SAMPLED:
+            return "device.perf.sampled";
 
         // Network Events (1000-1099)
         case RAC_EVENT_NETWORK_CONNECTIVITY_CHANGED:
@@ -320,6 +843,303 @@ const char* framework_to_string(rac_inference_framework_t framework) {
 
 }  // namespace
 
+// =============================================================================
+// SAMPLING POLICY
+// =============================================================================
+
+namespace {
+
+// Uniform in [0, 1); caller holds queue_mutex
+double next_random_locked(rac_telemetry_manager_t* manager) {
+    uint64_t x = manager->random_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    manager->random_state = x;
+    return static_cast<double>((x * 0x2545F4914F6CDD1Dull) >> 11) / 9007199254740992.0;
+}
+
+// Whether the policy keeps the event; caller holds queue_mutex
+bool admit_locked(rac_telemetry_manager_t* manager, const rac_telemetry_payload_t& payload,
+                  int64_t now) {
+    if (manager->sampling_rules.empty() || !payload.event_type) {
+        return true;
+    }
+    if (manager->keep_errors && is_failure(payload)) {
+        return true;
+    }
+
+    for (SamplingRule& rule : manager->sampling_rules) {
+        if (!rule.matches(payload.event_type)) {
+            continue;
+        }
+        if (rule.sample_rate < 1.0f && next_random_locked(manager) >= rule.sample_rate) {
+            return false;
+        }
+        if (rule.rate_per_second > 0.0f) {
+            double elapsed_s =
+                static_cast<double>(std::max<int64_t>(0, now - rule.refilled_ms)) / 1000.0;
+            rule.tokens = std::min(rule.burst, rule.tokens + elapsed_s * rule.rate_per_second);
+            rule.refilled_ms = now;
+            if (rule.tokens < 1.0) {
+                return false;
+            }
+            rule.tokens -= 1.0;
+        }
+        return true;
+    }
+    return true;
+}
+
+}  // namespace
+
+// =============================================================================
+// BACKGROUND FLUSHER
+// =============================================================================
+
+namespace {
+
+// Caller holds queue_mutex
+void settle_pending_locked(rac_telemetry_manager_t* manager, bool delivered, int64_t now) {
+    manager->pending_requests = 0;
+    if (delivered) {
+        manager->spool.acknowledge();
+        manager->consecutive_failures = 0;
+        manager->retry_after_ms = 0;
+        return;
+    }
+
+    static const rac::MetricCounter failed_batches("telemetry.failed_batches");
+    failed_batches.add();
+    manager->consecutive_failures++;
+    int shift = std::min(manager->consecutive_failures - 1, 16);
+    int64_t delay = std::min(rac_telemetry_manager::RETRY_MAX_MS,
+                             rac_telemetry_manager::RETRY_BASE_MS << shift);
+    manager->retry_after_ms = now + delay;
+    manager->retry_epoch = rac_outbound_queue_online_epoch();
+    // Without a spool the failed batch is gone; with one it is sent again
+    manager->reload_from_spool = manager->spool.is_open();
+    log_warning("Telemetry", "Telemetry batch failed (%d in a row), retrying in %lld ms",
+                manager->consecutive_failures, static_cast<long long>(delay));
+}
+
+// Caller holds queue_mutex
+bool flush_due_locked(const rac_telemetry_manager_t* manager, int64_t now) {
+    if (!manager->http_callback || (manager->queue.empty() && !manager->reload_from_spool)) {
+        return false;
+    }
+    if (manager->pending_requests > 0 &&
+        now - manager->pending_since_ms < rac_telemetry_manager::ACK_TIMEOUT_MS) {
+        return false;
+    }
+    // A reconnect since the last failure retries at once
+    if (now < manager->retry_after_ms &&
+        manager->retry_epoch == rac_outbound_queue_online_epoch()) {
+        return false;
+    }
+    // Offline, or registration and assignments still have to go out first
+    if (!rac_outbound_queue_may_send(RAC_REQUEST_PRIORITY_LOW)) {
+        return false;
+    }
+    if (manager->last_flush_time_ms > 0 &&
+        now - manager->last_flush_time_ms < manager->min_flush_interval_ms) {
+        return false;
+    }
+    // Development: immediate flush for real-time debugging. Production: on
+    // request (completion events), retry, batch size, timeout, or the first event.
+    if (manager->flush_requested || manager->reload_from_spool ||
+        manager->environment == RAC_ENV_DEVELOPMENT) {
+        return true;
+    }
+    return manager->queue.size() >= rac_telemetry_manager::BATCH_SIZE_PRODUCTION ||
+           manager->last_flush_time_ms == 0 ||
+           now - manager->last_flush_time_ms >= rac_telemetry_manager::BATCH_TIMEOUT_MS;
+}
+
+// Serializes the queued batch and hands it to the HTTP callback. forced
+// (explicit flush) sends even while a previous batch is unreported.
+rac_result_t send_queued(rac_telemetry_manager_t* manager, bool forced) {
+    // Take the queued batch with its arena; the spares become the new queue
+    std::vector<rac_telemetry_payload_t> events;
+    StringArena arena;
+    rac_telemetry_http_callback_t callback = nullptr;
+    void* user_data = nullptr;
+    rac_telemetry_encoding_t encoding = RAC_TELEMETRY_ENCODING_JSON;
+    {
+        std::lock_guard<std::mutex> lock(manager->queue_mutex);
+        callback = manager->http_callback;
+        user_data = manager->http_user_data;
+        encoding = manager->encoding;
+        if (!callback) {
+            return RAC_ERROR_NOT_INITIALIZED;
+        }
+        int64_t now = get_current_timestamp_ms();
+        if (manager->pending_requests > 0) {
+            if (!forced &&
+                now - manager->pending_since_ms < rac_telemetry_manager::ACK_TIMEOUT_MS) {
+                return RAC_SUCCESS;
+            }
+            settle_pending_locked(manager, true, now);
+        }
+        if (manager->reload_from_spool) {
+            manager->queue.clear();
+            manager->queue_arena.reset();
+            manager->spool.load(&manager->queue, &manager->queue_arena);
+            manager->reload_from_spool = false;
+        }
+        manager->flush_requested = false;
+        if (manager->queue.empty()) {
+            return RAC_SUCCESS;
+        }
+        events.swap(manager->queue);
+        std::swap(arena, manager->queue_arena);
+        manager->queue.swap(manager->spare_queue);
+        std::swap(manager->queue_arena, manager->spare_arena);
+        manager->spool.mark_sent();
+        manager->last_flush_time_ms = now;
+    }
+
+    log_debug("Telemetry", "Flushing %zu telemetry events", events.size());
+
+    // Get endpoint
+    const char* endpoint = rac_endpoint_telemetry_for_encoding(manager->environment, encoding);
+    bool requires_auth = (manager->environment != RAC_ENV_DEVELOPMENT);
+
+    // One request per modality in production unless merged, a single array in development
+    std::vector<std::pair<char*, size_t>> requests;
+    if (manager->environment == RAC_ENV_DEVELOPMENT) {
+        // Development: Send array directly to Supabase
+        rac_telemetry_batch_request_t batch = {};
+        batch.events = events.data();
+        batch.events_count = events.size();
+        batch.device_id = manager->device_id.c_str();
+        batch.timestamp_ms = get_current_timestamp_ms();
+        batch.modality = nullptr;  // Not used for development
+
+        char* json = nullptr;
+        size_t json_len = 0;
+        rac_result_t result =
+            rac_telemetry_manager_batch_to_json(&batch, manager->environment, &json, &json_len);
+        if (result == RAC_SUCCESS && json) {
+            requests.emplace_back(json, json_len);
+        }
+    } else {
+        // Production: Group by modality and send batch requests
+        std::map<std::string, std::vector<rac_telemetry_payload_t>> by_modality;
+
+        for (const auto& event : events) {
+            std::string modality = event.modality ? event.modality : "system";
+            // For "system" events, use V1 path (modality = nullptr)
+            if (manager->v2_modalities.find(modality) == manager->v2_modalities.end()) {
+                modality = "system";
+            }
+            by_modality[modality].push_back(event);
+        }
+
+        std::vector<rac_telemetry_batch_request_t> batches;
+        for (const auto& pair : by_modality) {
+            const std::string& modality = pair.first;
+            const auto& modality_events = pair.second;
+
+            rac_telemetry_batch_request_t batch = {};
+            batch.events = const_cast<rac_telemetry_payload_t*>(modality_events.data());
+            batch.events_count = modality_events.size();
+            batch.device_id = manager->device_id.c_str();
+            batch.timestamp_ms = get_current_timestamp_ms();
+            batch.modality = (modality == "system") ? nullptr : modality.c_str();
+            batches.push_back(batch);
+        }
+
+        if (encoding == RAC_TELEMETRY_ENCODING_JSON) {
+            for (const auto& batch : batches) {
+                char* json = nullptr;
+                size_t json_len = 0;
+                rac_result_t result = rac_telemetry_manager_batch_to_json(
+                    &batch, manager->environment, &json, &json_len);
+
+                if (result == RAC_SUCCESS && json) {
+                    // WARN: Log production telemetry payload for debugging (first 500 chars)
+                    log_debug("Telemetry",
+                              "Sending production telemetry (modality=%s, %zu bytes): %.500s",
+                              batch.modality ? batch.modality : "system", json_len, json);
+                    requests.emplace_back(json, json_len);
+                }
+            }
+        } else {
+            // All modalities in one request
+            char* body = nullptr;
+            size_t body_len = 0;
+            rac_result_t result = rac_telemetry_manager_encode_batches(
+                batches.data(), batches.size(), manager->device_id.c_str(),
+                get_current_timestamp_ms(), encoding, &body, &body_len);
+            if (result == RAC_SUCCESS && body) {
+                log_debug("Telemetry",
+                          "Sending merged production telemetry (%zu batches, %zu bytes)",
+                          batches.size(), body_len);
+                requests.emplace_back(body, body_len);
+            }
+        }
+    }
+
+    // The batch has been serialized: release its strings in one go and keep
+    // the buffers for the next batch. Results count against the requests
+    // from here on, so they are set before the first callback.
+    events.clear();
+    arena.reset();
+    {
+        std::lock_guard<std::mutex> lock(manager->queue_mutex);
+        manager->spare_queue.swap(events);
+        std::swap(manager->spare_arena, arena);
+        manager->pending_requests = static_cast<int32_t>(requests.size());
+        manager->pending_failed = false;
+        manager->pending_since_ms = get_current_timestamp_ms();
+        if (requests.empty()) {
+            // Nothing serialized; retrying would not help
+            settle_pending_locked(manager, true, manager->pending_since_ms);
+        }
+    }
+
+    for (auto& request : requests) {
+        callback(user_data, endpoint, request.first, request.second,
+                 requires_auth ? RAC_TRUE : RAC_FALSE);
+        rac_free(request.first);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(manager->queue_mutex);
+        if (!manager->acks_seen && manager->pending_requests > 0) {
+            settle_pending_locked(manager, true, get_current_timestamp_ms());
+        }
+    }
+
+    return RAC_SUCCESS;
+}
+
+void flusher_loop(rac_telemetry_manager_t* manager) {
+    std::unique_lock<std::mutex> lock(manager->queue_mutex);
+    while (!manager->stopping) {
+        if (flush_due_locked(manager, get_current_timestamp_ms())) {
+            lock.unlock();
+            send_queued(manager, false);
+            lock.lock();
+            continue;
+        }
+        manager->queue_cv.wait_for(
+            lock, std::chrono::milliseconds(rac_telemetry_manager::FLUSHER_TICK_MS));
+    }
+}
+
+// Wakes the flusher for an immediate send
+void request_flush(rac_telemetry_manager_t* manager) {
+    {
+        std::lock_guard<std::mutex> lock(manager->queue_mutex);
+        manager->flush_requested = true;
+    }
+    manager->queue_cv.notify_one();
+}
+
+}  // namespace
+
 // =============================================================================
 // LIFECYCLE
 // =============================================================================
@@ -335,9 +1155,16 @@ rac_telemetry_manager_t* rac_telemetry_manager_create(rac_environment_t env, con
     manager->device_id = device_id ? device_id : "";
     manager->platform = platform ? platform : "";
     manager->sdk_version = sdk_version ? sdk_version : "";
+    manager->interned_device_id = manager->intern(manager->device_id);
+    manager->interned_platform = manager->intern(manager->platform);
+    manager->interned_sdk_version = manager->intern(manager->sdk_version);
+    manager->interned_device_model = manager->intern(manager->device_model);
+    manager->interned_os_version = manager->intern(manager->os_version);
+    manager->queue.reserve(rac_telemetry_manager::BATCH_SIZE_PRODUCTION);
     manager->http_callback = nullptr;
     manager->http_user_data = nullptr;
     manager->last_flush_time_ms = 0;  // Initialize to 0 (will be set on first flush)
+    manager->flusher = std::thread(flusher_loop, manager);
 
     log_debug("Telemetry", "Telemetry manager created for environment %d", env);
 
@@ -348,6 +1175,13 @@ void rac_telemetry_manager_destroy(rac_telemetry_manager_t* manager) {
     if (!manager)
         return;
 
+    {
+        std::lock_guard<std::mutex> lock(manager->queue_mutex);
+        manager->stopping = true;
+    }
+    manager->queue_cv.notify_all();
+    manager->flusher.join();
+
     // Flush any remaining events
     rac_telemetry_manager_flush(manager);
 
@@ -360,8 +1194,11 @@ void rac_telemetry_manager_set_device_info(rac_telemetry_manager_t* manager,
     if (!manager)
         return;
 
+    std::lock_guard<std::mutex> lock(manager->queue_mutex);
     manager->device_model = device_model ? device_model : "";
     manager->os_version = os_version ? os_version : "";
+    manager->interned_device_model = manager->intern(manager->device_model);
+    manager->interned_os_version = manager->intern(manager->os_version);
 }
 
 void rac_telemetry_manager_set_http_callback(rac_telemetry_manager_t* manager,
@@ -370,96 +1207,192 @@ void rac_telemetry_manager_set_http_callback(rac_telemetry_manager_t* manager,
     if (!manager)
         return;
 
-    manager->http_callback = callback;
-    manager->http_user_data = user_data;
+    {
+        std::lock_guard<std::mutex> lock(manager->queue_mutex);
+        manager->http_callback = callback;
+        manager->http_user_data = user_data;
+    }
+    manager->queue_cv.notify_one();
 }
 
-// =============================================================================
-// EVENT TRACKING
-// =============================================================================
+rac_result_t rac_telemetry_manager_set_encoding(rac_telemetry_manager_t* manager,
+                                                rac_telemetry_encoding_t encoding) {
+    if (!manager || encoding < RAC_TELEMETRY_ENCODING_JSON ||
+        encoding > RAC_TELEMETRY_ENCODING_CBOR) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
 
-rac_result_t rac_telemetry_manager_track(rac_telemetry_manager_t* manager,
-                                         const rac_telemetry_payload_t* payload) {
-    if (!manager || !payload) {
+    std::lock_guard<std::mutex> lock(manager->queue_mutex);
+    manager->encoding = encoding;
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_telemetry_manager_set_policy(rac_telemetry_manager_t* manager,
+                                              const rac_telemetry_policy_t* policy) {
+    const rac_telemetry_policy_t& p = policy ? *policy : RAC_TELEMETRY_POLICY_DEFAULT;
+    if (!manager || (p.rule_count > 0 && !p.rules) || p.min_flush_interval_ms < 0) {
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    // Deep copy payload for queue
-    rac_telemetry_payload_t copy = *payload;
-    copy.id = dup_string(payload->id);
-    copy.event_type = dup_string(payload->event_type);
-    copy.modality = dup_string(payload->modality);
-    copy.device_id = dup_string(manager->device_id.c_str());
-    copy.session_id = dup_string(payload->session_id);
-    copy.model_id = dup_string(payload->model_id);
-    copy.model_name = dup_string(payload->model_name);
-    copy.framework = dup_string(payload->framework);
-    copy.device = dup_string(manager->device_model.c_str());
-    copy.os_version = dup_string(manager->os_version.c_str());
-    copy.platform = dup_string(manager->platform.c_str());
-    copy.sdk_version = dup_string(manager->sdk_version.c_str());
-    copy.error_message = dup_string(payload->error_message);
-    copy.error_code = dup_string(payload->error_code);
-    copy.language = dup_string(payload->language);
-    copy.voice = dup_string(payload->voice);
-    copy.archive_type = dup_string(payload->archive_type);
+    std::vector<SamplingRule> rules;
+    for (size_t i = 0; i < p.rule_count; i++) {
+        const rac_telemetry_sampling_rule_t& rule = p.rules[i];
+        if (!rule.event_type) {
+            return RAC_ERROR_INVALID_ARGUMENT;
+        }
+        add_rule(&rules, rule.event_type, rule.sample_rate, rule.rate_per_second, rule.burst);
+    }
 
-    {
-        std::lock_guard<std::mutex> lock(manager->queue_mutex);
-        manager->queue.push_back(copy);
+    std::lock_guard<std::mutex> lock(manager->queue_mutex);
+    manager->sampling_rules.swap(rules);
+    manager->keep_errors = p.keep_errors == RAC_TRUE;
+    manager->min_flush_interval_ms = p.min_flush_interval_ms;
+    log_debug("Telemetry", "Telemetry policy set: %zu rules, %llu events sampled out so far",
+              manager->sampling_rules.size(),
+              static_cast<unsigned long long>(manager->sampled_out));
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_telemetry_manager_set_policy_json(rac_telemetry_manager_t* manager,
+                                                   const char* json, size_t length) {
+    if (!manager || !json) {
+        return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    // Use WARN level for production visibility (INFO is filtered in production)
-    log_debug("Telemetry", "Telemetry event queued: %s", payload->event_type);
+    std::string top(json, length);
+    std::vector<SamplingRule> rules;
 
-    // Auto-flush logic
-    if (!manager->http_callback) {
-        log_debug("Telemetry", "HTTP callback not set, skipping auto-flush");
-        return RAC_SUCCESS;
+    // Cut the rules array out, so its keys are not mistaken for top-level ones
+    size_t rules_pos = top.find("\"rules\"");
+    if (rules_pos != std::string::npos) {
+        size_t open = top.find('[', rules_pos);
+        size_t close = open == std::string::npos ? open : top.find(']', open);
+        if (close == std::string::npos) {
+            return RAC_ERROR_INVALID_FORMAT;
+        }
+        std::string array = top.substr(open + 1, close - open - 1);
+        top.erase(rules_pos, close + 1 - rules_pos);
+
+        size_t pos = 0;
+        while ((pos = array.find('{', pos)) != std::string::npos) {
+            size_t end = array.find('}', pos);
+            if (end == std::string::npos) {
+                return RAC_ERROR_INVALID_FORMAT;
+            }
+            std::string object = array.substr(pos, end + 1 - pos);
+            std::string type = json_value(object, "event_type");
+            if (type.empty()) {
+                return RAC_ERROR_INVALID_FORMAT;
+            }
+            add_rule(&rules, type.c_str(),
+                     static_cast<float>(json_number(object, "sample_rate", 1.0)),
+                     static_cast<float>(json_number(object, "rate_per_second", 0.0)),
+                     static_cast<int32_t>(json_number(object, "burst", 0.0)));
+            pos = end + 1;
+        }
     }
 
-    bool should_flush = false;
-    size_t queue_size = 0;
-    int64_t current_time = get_current_timestamp_ms();
+    bool keep_errors = json_value(top, "keep_errors") != "false";
+    int64_t min_flush_interval_ms =
+        std::max<int64_t>(0, static_cast<int64_t>(json_number(top, "min_flush_interval_ms", 0.0)));
 
-    {
-        std::lock_guard<std::mutex> lock(manager->queue_mutex);
-        queue_size = manager->queue.size();
+    std::lock_guard<std::mutex> lock(manager->queue_mutex);
+    manager->sampling_rules.swap(rules);
+    manager->keep_errors = keep_errors;
+    manager->min_flush_interval_ms = min_flush_interval_ms;
+    log_debug("Telemetry", "Telemetry policy loaded: %zu rules", manager->sampling_rules.size());
+    return RAC_SUCCESS;
+}
+
+rac_result_t rac_telemetry_manager_set_spool_path(rac_telemetry_manager_t* manager,
+                                                  const char* path) {
+    if (!manager) {
+        return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    if (manager->environment == RAC_ENV_DEVELOPMENT) {
-        // Development: Immediate flush for real-time debugging
-        should_flush = true;
-        log_debug("Telemetry", "Development mode: auto-flushing immediately (queue size: %zu)",
-                  queue_size);
-    } else {
-        // Production: Flush based on batch size or timeout
-        // (completion events are handled in rac_telemetry_manager_track_analytics)
-        // Flush if queue reaches batch size
-        if (queue_size >= manager->BATCH_SIZE_PRODUCTION) {
-            should_flush = true;
-            log_debug("Telemetry", "Auto-flushing: queue size (%zu) >= batch size (%zu)",
-                      queue_size, manager->BATCH_SIZE_PRODUCTION);
+    {
+        std::lock_guard<std::mutex> lock(manager->queue_mutex);
+        manager->reload_from_spool = false;
+        if (!path) {
+            manager->spool.close();
+            return RAC_SUCCESS;
         }
-        // Flush if timeout reached (5 seconds since last flush)
-        else if (manager->last_flush_time_ms > 0 &&
-                 (current_time - manager->last_flush_time_ms) >= manager->BATCH_TIMEOUT_MS) {
-            should_flush = true;
-            log_debug("Telemetry", "Auto-flushing: timeout reached (%lld ms since last flush)",
-                      current_time - manager->last_flush_time_ms);
+        if (!manager->spool.open(path)) {
+            return RAC_ERROR_FILE_WRITE_FAILED;
         }
-        // First flush: start the timer by flushing immediately if we have events
-        else if (manager->last_flush_time_ms == 0 && queue_size > 0) {
-            should_flush = true;
-            log_debug("Telemetry", "Production: first flush to start timer (queue size: %zu)",
-                      queue_size);
+        // Events queued before the spool existed join the records of earlier
+        // runs; the next flush sends them all from the spool
+        for (const auto& event : manager->queue) {
+            manager->spool.append(event);
         }
+        manager->reload_from_spool = true;
+        manager->flush_requested = true;
     }
+    manager->queue_cv.notify_one();
+
+    log_debug("Telemetry", "Telemetry spool opened at %s", path);
+    return RAC_SUCCESS;
+}
 
-    if (should_flush) {
-        log_debug("Telemetry", "Triggering auto-flush (queue size: %zu)", queue_size);
-        rac_telemetry_manager_flush(manager);
-        // Note: last_flush_time_ms is updated inside flush()
+// =============================================================================
+// EVENT TRACKING
+// =============================================================================
+
+rac_result_t rac_telemetry_manager_track(rac_telemetry_manager_t* manager,
+                                         const rac_telemetry_payload_t* payload) {
+    if (!manager || !payload) {
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Copy payload for queue: device constants are interned, the rest goes to the batch arena
+    bool wake_flusher = false;
+    {
+        std::lock_guard<std::mutex> lock(manager->queue_mutex);
+        if (!admit_locked(manager, *payload, get_current_timestamp_ms())) {
+            manager->sampled_out++;
+            static const rac::MetricCounter sampled_out("telemetry.sampled_out");
+            sampled_out.add();
+            return RAC_SUCCESS;
+        }
+        StringArena& arena = manager->queue_arena;
+        rac_telemetry_payload_t copy = *payload;
+        copy.id = arena.copy(payload->id);
+        copy.event_type = arena.copy(payload->event_type);
+        copy.modality = arena.copy(payload->modality);
+        copy.device_id = manager->interned_device_id;
+        copy.session_id = arena.copy(payload->session_id);
+        copy.model_id = arena.copy(payload->model_id);
+        copy.model_name = arena.copy(payload->model_name);
+        copy.framework = arena.copy(payload->framework);
+        copy.device = manager->interned_device_model;
+        copy.os_version = manager->interned_os_version;
+        copy.platform = manager->interned_platform;
+        copy.sdk_version = manager->interned_sdk_version;
+        copy.error_message = arena.copy(payload->error_message);
+        copy.error_code = arena.copy(payload->error_code);
+        copy.language = arena.copy(payload->language);
+        copy.voice = arena.copy(payload->voice);
+        copy.archive_type = arena.copy(payload->archive_type);
+        copy.device_class = arena.copy(payload->device_class);
+        copy.subsystem = arena.copy(payload->subsystem);
+        copy.stage = arena.copy(payload->stage);
+        copy.thermal_state = arena.copy(payload->thermal_state);
+        copy.histogram = arena.copy(payload->histogram);
+        manager->queue.push_back(copy);
+        manager->spool.append(copy);
+        static const rac::MetricGauge queue_depth("telemetry.queue_depth");
+        queue_depth.set(static_cast<double>(manager->queue.size()));
+        wake_flusher = manager->environment == RAC_ENV_DEVELOPMENT ||
+                       manager->queue.size() >= manager->BATCH_SIZE_PRODUCTION ||
+                       manager->last_flush_time_ms == 0;
+    }
+
+    // Use WARN level for production visibility (INFO is filtered in production)
+    log_debug("Telemetry", "Telemetry event queued: %s", payload->event_type);
+
+    // The flusher sends the batch; timeouts are picked up by its timer
+    if (wake_flusher) {
+        manager->queue_cv.notify_one();
     }
 
     return RAC_SUCCESS;
@@ -513,6 +1446,9 @@ rac_result_t rac_telemetry_manager_track_analytics(rac_telemetry_manager_t* mana
                 payload.temperature = llm.temperature;
                 payload.max_tokens = llm.max_tokens;
                 payload.context_length = llm.context_length;
+                payload.peak_rss_bytes = llm.peak_rss_bytes;
+                payload.rss_delta_bytes = llm.rss_delta_bytes;
+                payload.backend_memory_bytes = llm.backend_memory_bytes;
                 if (llm.error_code != RAC_SUCCESS) {
                     payload.success = RAC_FALSE;
                     payload.has_success = RAC_TRUE;
@@ -568,6 +1504,9 @@ rac_result_t rac_telemetry_manager_track_analytics(rac_telemetry_manager_t* mana
                 payload.is_streaming = stt.is_streaming;
                 payload.has_is_streaming = RAC_TRUE;
                 payload.framework = framework_to_string(stt.framework);
+                payload.peak_rss_bytes = stt.peak_rss_bytes;
+                payload.rss_delta_bytes = stt.rss_delta_bytes;
+                payload.backend_memory_bytes = stt.backend_memory_bytes;
                 if (stt.error_code != RAC_SUCCESS) {
                     payload.success = RAC_FALSE;
                     payload.has_success = RAC_TRUE;
@@ -597,6 +1536,9 @@ rac_result_t rac_telemetry_manager_track_analytics(rac_telemetry_manager_t* mana
                 payload.characters_per_second = tts.characters_per_second;
                 payload.sample_rate = tts.sample_rate;
                 payload.framework = framework_to_string(tts.framework);
+                payload.peak_rss_bytes = tts.peak_rss_bytes;
+                payload.rss_delta_bytes = tts.rss_delta_bytes;
+                payload.backend_memory_bytes = tts.backend_memory_bytes;
                 if (tts.error_code != RAC_SUCCESS) {
                     payload.success = RAC_FALSE;
                     payload.has_success = RAC_TRUE;
@@ -628,6 +1570,63 @@ rac_result_t rac_telemetry_manager_track_analytics(rac_telemetry_manager_t* mana
                 break;
             }
 
+            // Voice agent turn events
+            case RAC_EVENT_VOICE_AGENT_TURN_COMPLETED:
+            case RAC_EVENT_VOICE_AGENT_TURN_FAILED: {
+                const auto& turn = data->data.voice_agent_turn;
+                payload.processing_time_ms = turn.total_ms;
+                if (turn.llm_first_token_ms >= 0) {
+                    payload.time_to_first_token_ms = turn.llm_first_token_ms;
+                }
+                payload.success = turn.error_code == RAC_SUCCESS ? RAC_TRUE : RAC_FALSE;
+                payload.has_success = RAC_TRUE;
+                break;
+            }
+
+            // SDK lifecycle events
+            case RAC_EVENT_SDK_INIT_COMPLETED:
+            case RAC_EVENT_SDK_INIT_FAILED: {
+                const auto& lifecycle = data->data.sdk_lifecycle;
+                payload.processing_time_ms = lifecycle.duration_ms;
+                payload.subsystem = lifecycle.subsystem;
+                payload.success = lifecycle.error_code == RAC_SUCCESS ? RAC_TRUE : RAC_FALSE;
+                payload.has_success = RAC_TRUE;
+                if (lifecycle.error_code != RAC_SUCCESS) {
+                    payload.error_message = lifecycle.error_message;
+                }
+                break;
+            }
+
+            // Device profile events
+            case RAC_EVENT_DEVICE_PROFILED: {
+                const auto& profile = data->data.device_profile;
+                payload.device_class = profile.device_class;
+                payload.matmul_gflops = profile.matmul_gflops;
+                payload.memory_bandwidth_gbps = profile.memory_bandwidth_gbps;
+                payload.prefill_tokens_per_second = profile.prefill_tokens_per_second;
+                payload.tokens_per_second = profile.decode_tokens_per_second;
+                payload.model_id = profile.reference_model_id;
+                payload.best_threads = profile.best_threads;
+                payload.processing_time_ms = profile.duration_ms;
+                break;
+            }
+
+            // Field performance samples
+            case RAC_EVENT_DEVICE_PERF_SAMPLED: {
+                const auto& sample = data->data.perf_sample;
+                payload.stage = sample.stage;
+                payload.thermal_state = sample.thermal_state;
+                payload.count = sample.count;
+                payload.p50_ms = sample.p50_ms;
+                payload.p95_ms = sample.p95_ms;
+                payload.p99_ms = sample.p99_ms;
+                payload.max_ms = sample.max_ms;
+                payload.histogram = sample.histogram;
+                payload.cpu_freq_mhz = sample.cpu_freq_mhz;
+                payload.window_ms = sample.window_ms;
+                break;
+            }
+
             default:
                 break;
         }
@@ -638,9 +1637,9 @@ rac_result_t rac_telemetry_manager_track_analytics(rac_telemetry_manager_t* mana
     // For completion/failure events in production, trigger immediate flush
     // This ensures important terminal events are captured before app exits
     if (result == RAC_SUCCESS && manager->environment != RAC_ENV_DEVELOPMENT &&
-        is_completion_event(event_type) && manager->http_callback) {
+        is_completion_event(event_type)) {
         log_debug("Telemetry", "Completion event detected, triggering immediate flush");
-        rac_telemetry_manager_flush(manager);
+        request_flush(manager);
     }
 
     return result;
@@ -655,115 +1654,11 @@ rac_result_t rac_telemetry_manager_flush(rac_telemetry_manager_t* manager) {
         return RAC_ERROR_INVALID_ARGUMENT;
     }
 
-    if (!manager->http_callback) {
+    rac_result_t result = send_queued(manager, true);
+    if (result == RAC_ERROR_NOT_INITIALIZED) {
         log_debug("Telemetry", "No HTTP callback registered, cannot flush telemetry");
-        return RAC_ERROR_NOT_INITIALIZED;
-    }
-
-    // Get events from queue
-    std::vector<rac_telemetry_payload_t> events;
-    {
-        std::lock_guard<std::mutex> lock(manager->queue_mutex);
-        events = std::move(manager->queue);
-        manager->queue.clear();
-    }
-
-    if (events.empty()) {
-        return RAC_SUCCESS;
-    }
-
-    log_debug("Telemetry", "Flushing %zu telemetry events", events.size());
-
-    // Update last flush time
-    manager->last_flush_time_ms = get_current_timestamp_ms();
-
-    // Get endpoint
-    const char* endpoint = rac_endpoint_telemetry(manager->environment);
-    bool requires_auth = (manager->environment != RAC_ENV_DEVELOPMENT);
-
-    if (manager->environment == RAC_ENV_DEVELOPMENT) {
-        // Development: Send array directly to Supabase
-        rac_telemetry_batch_request_t batch = {};
-        batch.events = events.data();
-        batch.events_count = events.size();
-        batch.device_id = manager->device_id.c_str();
-        batch.timestamp_ms = get_current_timestamp_ms();
-        batch.modality = nullptr;  // Not used for development
-
-        char* json = nullptr;
-        size_t json_len = 0;
-        rac_result_t result =
-            rac_telemetry_manager_batch_to_json(&batch, manager->environment, &json, &json_len);
-
-        if (result == RAC_SUCCESS && json) {
-            manager->http_callback(manager->http_user_data, endpoint, json, json_len,
-                                   requires_auth ? RAC_TRUE : RAC_FALSE);
-            free(json);
-        }
-    } else {
-        // Production: Group by modality and send batch requests
-        std::map<std::string, std::vector<rac_telemetry_payload_t>> by_modality;
-
-        for (const auto& event : events) {
-            std::string modality = event.modality ? event.modality : "system";
-            // For "system" events, use V1 path (modality = nullptr)
-            if (manager->v2_modalities.find(modality) == manager->v2_modalities.end()) {
-                modality = "system";
-            }
-            by_modality[modality].push_back(event);
-        }
-
-        for (const auto& pair : by_modality) {
-            const std::string& modality = pair.first;
-            const auto& modality_events = pair.second;
-
-            rac_telemetry_batch_request_t batch = {};
-            batch.events = const_cast<rac_telemetry_payload_t*>(modality_events.data());
-            batch.events_count = modality_events.size();
-            batch.device_id = manager->device_id.c_str();
-            batch.timestamp_ms = get_current_timestamp_ms();
-            batch.modality = (modality == "system") ? nullptr : modality.c_str();
-
-            char* json = nullptr;
-            size_t json_len = 0;
-            rac_result_t result =
-                rac_telemetry_manager_batch_to_json(&batch, manager->environment, &json, &json_len);
-
-            if (result == RAC_SUCCESS && json) {
-                // WARN: Log production telemetry payload for debugging (first 500 chars)
-                log_debug("Telemetry",
-                          "Sending production telemetry (modality=%s, %zu bytes): %.500s",
-                          modality.c_str(), json_len, json);
-                manager->http_callback(manager->http_user_data, endpoint, json, json_len,
-                                       RAC_TRUE  // Production always requires auth
-                );
-                free(json);
-            }
-        }
     }
-
-    // Free duplicated strings in events
-    for (auto& event : events) {
-        free((void*)event.id);
-        free((void*)event.event_type);
-        free((void*)event.modality);
-        free((void*)event.device_id);
-        free((void*)event.session_id);
-        free((void*)event.model_id);
-        free((void*)event.model_name);
-        free((void*)event.framework);
-        free((void*)event.device);
-        free((void*)event.os_version);
-        free((void*)event.platform);
-        free((void*)event.sdk_version);
-        free((void*)event.error_message);
-        free((void*)event.error_code);
-        free((void*)event.language);
-        free((void*)event.voice);
-        free((void*)event.archive_type);
-    }
-
-    return RAC_SUCCESS;
+    return result;
 }
 
 void rac_telemetry_manager_http_complete(rac_telemetry_manager_t* manager, rac_bool_t success,
@@ -778,5 +1673,17 @@ void rac_telemetry_manager_http_complete(rac_telemetry_manager_t* manager, rac_b
                     error_message ? error_message : "unknown");
     }
 
-    // Could parse response and handle retries here if needed
+    std::lock_guard<std::mutex> lock(manager->queue_mutex);
+    manager->acks_seen = true;
+    if (manager->pending_requests == 0) {
+        // The batch was already settled (explicit flush or ack timeout)
+        return;
+    }
+    if (!success) {
+        manager->pending_failed = true;
+    }
+    if (--manager->pending_requests == 0) {
+        settle_pending_locked(manager, !manager->pending_failed, get_current_timestamp_ms());
+        manager->queue_cv.notify_one();
+    }
 }
@@ -38,13 +38,13 @@ void rac_telemetry_batch_response_free(rac_telemetry_batch_response_t* response)
 
     if (response->errors) {
         for (size_t i = 0; i < response->errors_count; i++) {
-            free((void*)response->errors[i]);
+            rac_free((void*)response->errors[i]);
         }
-        free(response->errors);
+        rac_free(response->errors);
     }
 
     if (response->storage_version) {
-        free((void*)response->storage_version);
+        rac_free((void*)response->storage_version);
     }
 
     memset(response, 0, sizeof(*response));
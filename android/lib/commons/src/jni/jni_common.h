@@ -0,0 +1,238 @@
+/**
+ * RunAnywhere Commons JNI Bridge - Shared Internals
+ *
+ * Private to the commons JNI library. The bridge is split into one
+ * translation unit per feature (jni_llm.cpp, jni_stt.cpp, ...), all linked
+ * into librunanywhere_jni.so; this header holds what they share: the JavaVM,
+ * thread attachment, string conversion, cached class IDs and the binary
+ * result writer. Optional features are selected at configure time with the
+ * RAC_JNI_* options in CMakeLists.txt.
+ */
+
+#ifndef RAC_JNI_COMMON_H
+#define RAC_JNI_COMMON_H
+
+#include <jni.h>
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+#include "rac/core/rac_error.h"
+#include "rac/features/llm/rac_llm_types.h"
+#include "rac/features/stt/rac_stt_types.h"
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#define TAG "RACCommonsJNI"
+#define LOGi(...) __android_log_print(ANDROID_LOG_INFO, TAG, __VA_ARGS__)
+#define LOGe(...) __android_log_print(ANDROID_LOG_ERROR, TAG, __VA_ARGS__)
+#define LOGw(...) __android_log_print(ANDROID_LOG_WARN, TAG, __VA_ARGS__)
+#define LOGd(...) __android_log_print(ANDROID_LOG_DEBUG, TAG, __VA_ARGS__)
+#else
+#include <cstdio>
+#define LOGi(...)                           \
+    fprintf(stdout, "[INFO] " __VA_ARGS__); \
+    fprintf(stdout, "\n")
+#define LOGe(...)                            \
+    fprintf(stderr, "[ERROR] " __VA_ARGS__); \
+    fprintf(stderr, "\n")
+#define LOGw(...)                           \
+    fprintf(stdout, "[WARN] " __VA_ARGS__); \
+    fprintf(stdout, "\n")
+#define LOGd(...)                            \
+    fprintf(stdout, "[DEBUG] " __VA_ARGS__); \
+    fprintf(stdout, "\n")
+#endif
+
+// =============================================================================
+// Global State
+// =============================================================================
+
+extern JavaVM* g_jvm;
+
+// =============================================================================
+// Helper Functions
+// =============================================================================
+
+// The calling thread's JNIEnv. A native thread is attached on first use and
+// stays attached until it exits, when the pthread key destructor detaches it,
+// so callbacks on backend threads (per token, per telemetry flush) do not
+// attach and detach each time.
+JNIEnv* getThreadEnv(JavaVM* vm);
+JNIEnv* getJNIEnv();
+
+std::string getCString(JNIEnv* env, jstring str);
+const char* getNullableCString(JNIEnv* env, jstring str, std::string& storage);
+
+// =============================================================================
+// Cached Class IDs
+// =============================================================================
+// Callback and model classes are defined by the Kotlin SDK and are not known
+// at JNI_OnLoad, so their method and field IDs are resolved on first use and
+// cached under a global ref to the class. Later calls only compare classes;
+// an object of a different class resolves again.
+
+template <typename Ids>
+class ClassIdCache {
+   public:
+    using Resolver = bool (*)(JNIEnv* env, jclass cls, Ids* out_ids);
+
+    explicit ClassIdCache(Resolver resolve) : resolve_(resolve) {}
+
+    // IDs for obj's class, or false if a lookup failed (exception pending)
+    bool get(JNIEnv* env, jobject obj, Ids* out_ids) {
+        jclass cls = env->GetObjectClass(obj);
+        if (cls == nullptr)
+            return false;
+
+        bool found = true;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (cls_ == nullptr || !env->IsSameObject(cls, cls_)) {
+                Ids ids = {};
+                found = resolve_(env, cls, &ids);
+                if (found) {
+                    if (cls_ != nullptr)
+                        env->DeleteGlobalRef(cls_);
+                    cls_ = static_cast<jclass>(env->NewGlobalRef(cls));
+                    ids_ = ids;
+                }
+            }
+            if (found)
+                *out_ids = ids_;
+        }
+        env->DeleteLocalRef(cls);
+        return found;
+    }
+
+    void clear(JNIEnv* env) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cls_ != nullptr)
+            env->DeleteGlobalRef(cls_);
+        cls_ = nullptr;
+    }
+
+   private:
+    Resolver resolve_;
+    std::mutex mutex_;
+    jclass cls_ = nullptr;
+    Ids ids_ = {};
+};
+
+struct TokenCallbackIds {
+    jmethodID on_token;
+};
+
+struct ModelInfoIds {
+    jfieldID id;
+    jfieldID name;
+    jfieldID category;
+    jfieldID format;
+    jfieldID framework;
+    jfieldID download_url;
+    jfieldID local_path;
+    jfieldID download_size;
+    jfieldID context_length;
+    jfieldID supports_thinking;
+    jfieldID description;
+};
+
+struct RequestCallbackIds {
+    jmethodID on_complete;
+};
+
+// Cleared in JNI_OnUnload
+extern ClassIdCache<TokenCallbackIds> g_token_callback_ids;
+extern ClassIdCache<ModelInfoIds> g_model_info_ids;
+extern ClassIdCache<RequestCallbackIds> g_request_callback_ids;
+
+// Pops every local ref created in its scope, for code that creates a
+// variable number of them
+class ScopedLocalFrame {
+   public:
+    ScopedLocalFrame(JNIEnv* env, jint capacity)
+        : env_(env), pushed_(env->PushLocalFrame(capacity) == 0) {}
+    ~ScopedLocalFrame() {
+        if (pushed_)
+            env_->PopLocalFrame(nullptr);
+    }
+    ScopedLocalFrame(const ScopedLocalFrame&) = delete;
+    ScopedLocalFrame& operator=(const ScopedLocalFrame&) = delete;
+
+    bool pushed() const { return pushed_; }
+
+   private:
+    JNIEnv* env_;
+    bool pushed_;
+};
+
+// =============================================================================
+// Binary Results
+// =============================================================================
+// Hot-path results can be written into a caller-owned DirectByteBuffer instead
+// of a JSON string. Records are packed with no padding, in native byte order
+// (little-endian on every Android ABI), so Kotlin reads them with
+// ByteBuffer.order(ByteOrder.LITTLE_ENDIAN). A string is an int32 byte length
+// followed by that many UTF-8 bytes, with no terminator. Every record starts
+// with an int32 layout version; bump it whenever a layout changes.
+
+constexpr int32_t kBinaryLayoutVersion = 1;
+
+// Bounded writer over a DirectByteBuffer. Keeps counting past the end so the
+// caller can report the size a record needed.
+class BinaryWriter {
+   public:
+    BinaryWriter(void* data, size_t capacity)
+        : data_(static_cast<uint8_t*>(data)), capacity_(capacity) {}
+
+    void i32(int32_t value) { put(&value, sizeof(value)); }
+    void i64(int64_t value) { put(&value, sizeof(value)); }
+    void f32(float value) { put(&value, sizeof(value)); }
+
+    void str(const char* value) {
+        size_t length = value != nullptr ? strlen(value) : 0;
+        i32(static_cast<int32_t>(length));
+        put(value, length);
+    }
+
+    bool fits() const { return size_ <= capacity_; }
+    size_t size() const { return size_; }
+
+   private:
+    void put(const void* value, size_t length) {
+        if (length > 0 && size_ + length <= capacity_) {
+            memcpy(data_ + size_, value, length);
+        }
+        size_ += length;
+    }
+
+    uint8_t* data_;
+    size_t capacity_;
+    size_t size_ = 0;
+};
+
+// Resolves a DirectByteBuffer, or returns false for a heap buffer or null.
+bool getDirectBuffer(JNIEnv* env, jobject buffer, void** out_data, size_t* out_capacity);
+
+// Bytes written, or RAC_ERROR_BUFFER_TOO_SMALL when the record did not fit
+jlong finishBinaryRecord(const BinaryWriter& writer, const char* what);
+
+// =============================================================================
+// Cross-Feature Helpers
+// =============================================================================
+// Defined by one feature bridge and used by another; CMakeLists.txt enforces
+// the matching feature dependencies.
+
+// LLM result as the JSON the Kotlin bridge expects (jni_llm.cpp)
+std::string llmResultToJson(const rac_llm_result_t& result);
+
+// STT options from the Kotlin config JSON and STT result JSON (jni_stt.cpp)
+rac_stt_options_t sttOptionsFromConfig(JNIEnv* env, jstring configJson);
+std::string sttResultToJson(const rac_stt_result_t& result);
+
+// Telemetry policy from the model assignment response (jni_telemetry.cpp)
+void jni_telemetry_policy_callback(const char* policy_json, size_t length, void* user_data);
+
+#endif  // RAC_JNI_COMMON_H
@@ -0,0 +1,479 @@
+/**
+ * RunAnywhere Commons JNI Bridge - Device Manager
+ *
+ * Device registration callbacks and power state for the thermal governor.
+ */
+
+#include "jni_common.h"
+
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+#include "rac/core/rac_thermal_governor.h"
+#include "rac/infrastructure/device/rac_device_manager.h"
+
+extern "C" {
+
+// =============================================================================
+// JNI FUNCTIONS - Device Manager (rac_device_manager.h)
+// =============================================================================
+// Mirrors Swift SDK's CppBridge+Device.swift
+
+// Global state for device callbacks
+static struct {
+    jobject callback_obj;
+    jmethodID get_device_info_method;
+    jmethodID get_device_id_method;
+    jmethodID is_registered_method;
+    jmethodID set_registered_method;
+    jmethodID http_post_method;
+    std::mutex mtx;
+} g_device_jni_state = {};
+
+// Forward declarations for device C callbacks
+static void jni_device_get_info(rac_device_registration_info_t* out_info, void* user_data);
+static const char* jni_device_get_id(void* user_data);
+static rac_bool_t jni_device_is_registered(void* user_data);
+static void jni_device_set_registered(rac_bool_t registered, void* user_data);
+static rac_result_t jni_device_http_post(const char* endpoint, const char* json_body,
+                                         rac_bool_t requires_auth,
+                                         rac_device_http_response_t* out_response, void* user_data);
+
+// Static storage for device ID string (needs to persist across calls)
+// Protected by g_device_jni_state.mtx for thread safety
+static std::string g_cached_device_id;
+
+// Helper to extract a string value from JSON (simple parser for known keys)
+// Returns allocated string that must be stored persistently, or nullptr
+static std::string extract_json_string(const char* json, const char* key) {
+    if (!json || !key)
+        return "";
+
+    std::string search_key = "\"" + std::string(key) + "\":";
+    const char* pos = strstr(json, search_key.c_str());
+    if (!pos)
+        return "";
+
+    pos += search_key.length();
+    while (*pos == ' ')
+        pos++;
+
+    if (*pos == 'n' && strncmp(pos, "null", 4) == 0) {
+        return "";
+    }
+
+    if (*pos != '"')
+        return "";
+    pos++;
+
+    const char* end = strchr(pos, '"');
+    if (!end)
+        return "";
+
+    return std::string(pos, end - pos);
+}
+
+// Helper to extract an integer value from JSON
+static int64_t extract_json_int(const char* json, const char* key) {
+    if (!json || !key)
+        return 0;
+
+    std::string search_key = "\"" + std::string(key) + "\":";
+    const char* pos = strstr(json, search_key.c_str());
+    if (!pos)
+        return 0;
+
+    pos += search_key.length();
+    while (*pos == ' ')
+        pos++;
+
+    return strtoll(pos, nullptr, 10);
+}
+
+// Helper to extract a boolean value from JSON
+static bool extract_json_bool(const char* json, const char* key) {
+    if (!json || !key)
+        return false;
+
+    std::string search_key = "\"" + std::string(key) + "\":";
+    const char* pos = strstr(json, search_key.c_str());
+    if (!pos)
+        return false;
+
+    pos += search_key.length();
+    while (*pos == ' ')
+        pos++;
+
+    return strncmp(pos, "true", 4) == 0;
+}
+
+// Static storage for device info strings (need to persist for C callbacks)
+static struct {
+    std::string device_id;
+    std::string device_model;
+    std::string device_name;
+    std::string platform;
+    std::string os_version;
+    std::string form_factor;
+    std::string architecture;
+    std::string chip_name;
+    std::string gpu_family;
+    std::string battery_state;
+    std::string device_fingerprint;
+    std::string manufacturer;
+    std::mutex mtx;
+} g_device_info_strings = {};
+
+// Device callback implementations
+static void jni_device_get_info(rac_device_registration_info_t* out_info, void* user_data) {
+    JNIEnv* env = getJNIEnv();
+    if (!env || !g_device_jni_state.callback_obj || !g_device_jni_state.get_device_info_method) {
+        LOGe("jni_device_get_info: JNI not ready");
+        return;
+    }
+
+    // Call Java getDeviceInfo() which returns a JSON string
+    jstring jResult = (jstring)env->CallObjectMethod(g_device_jni_state.callback_obj,
+                                                     g_device_jni_state.get_device_info_method);
+
+    // Check for Java exception after CallObjectMethod
+    if (env->ExceptionCheck()) {
+        LOGe("jni_device_get_info: Java exception occurred in getDeviceInfo()");
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        return;
+    }
+
+    if (jResult && out_info) {
+        const char* json = env->GetStringUTFChars(jResult, nullptr);
+        LOGd("jni_device_get_info: parsing JSON: %.200s...", json);
+
+        // Parse JSON and extract all fields
+        std::lock_guard<std::mutex> lock(g_device_info_strings.mtx);
+
+        // Extract all string fields from Kotlin's getDeviceInfoCallback() JSON
+        g_device_info_strings.device_id = extract_json_string(json, "device_id");
+        g_device_info_strings.device_model = extract_json_string(json, "device_model");
+        g_device_info_strings.device_name = extract_json_string(json, "device_name");
+        g_device_info_strings.platform = extract_json_string(json, "platform");
+        g_device_info_strings.os_version = extract_json_string(json, "os_version");
+        g_device_info_strings.form_factor = extract_json_string(json, "form_factor");
+        g_device_info_strings.architecture = extract_json_string(json, "architecture");
+        g_device_info_strings.chip_name = extract_json_string(json, "chip_name");
+        g_device_info_strings.gpu_family = extract_json_string(json, "gpu_family");
+        g_device_info_strings.battery_state = extract_json_string(json, "battery_state");
+        g_device_info_strings.device_fingerprint = extract_json_string(json, "device_fingerprint");
+        g_device_info_strings.manufacturer = extract_json_string(json, "manufacturer");
+
+        // Assign pointers to out_info (C struct uses const char*)
+        out_info->device_id = g_device_info_strings.device_id.empty()
+                                  ? nullptr
+                                  : g_device_info_strings.device_id.c_str();
+        out_info->device_model = g_device_info_strings.device_model.empty()
+                                     ? nullptr
+                                     : g_device_info_strings.device_model.c_str();
+        out_info->device_name = g_device_info_strings.device_name.empty()
+                                    ? nullptr
+                                    : g_device_info_strings.device_name.c_str();
+        out_info->platform = g_device_info_strings.platform.empty()
+                                 ? "android"
+                                 : g_device_info_strings.platform.c_str();
+        out_info->os_version = g_device_info_strings.os_version.empty()
+                                   ? nullptr
+                                   : g_device_info_strings.os_version.c_str();
+        out_info->form_factor = g_device_info_strings.form_factor.empty()
+                                    ? nullptr
+                                    : g_device_info_strings.form_factor.c_str();
+        out_info->architecture = g_device_info_strings.architecture.empty()
+                                     ? nullptr
+                                     : g_device_info_strings.architecture.c_str();
+        out_info->chip_name = g_device_info_strings.chip_name.empty()
+                                  ? nullptr
+                                  : g_device_info_strings.chip_name.c_str();
+        out_info->gpu_family = g_device_info_strings.gpu_family.empty()
+                                   ? nullptr
+                                   : g_device_info_strings.gpu_family.c_str();
+        out_info->battery_state = g_device_info_strings.battery_state.empty()
+                                      ? nullptr
+                                      : g_device_info_strings.battery_state.c_str();
+        out_info->device_fingerprint = g_device_info_strings.device_fingerprint.empty()
+                                           ? nullptr
+                                           : g_device_info_strings.device_fingerprint.c_str();
+
+        // Extract integer fields
+        out_info->total_memory = extract_json_int(json, "total_memory");
+        out_info->available_memory = extract_json_int(json, "available_memory");
+        out_info->neural_engine_cores =
+            static_cast<int32_t>(extract_json_int(json, "neural_engine_cores"));
+        out_info->core_count = static_cast<int32_t>(extract_json_int(json, "core_count"));
+        out_info->performance_cores =
+            static_cast<int32_t>(extract_json_int(json, "performance_cores"));
+        out_info->efficiency_cores =
+            static_cast<int32_t>(extract_json_int(json, "efficiency_cores"));
+
+        // Extract boolean fields
+        out_info->has_neural_engine =
+            extract_json_bool(json, "has_neural_engine") ? RAC_TRUE : RAC_FALSE;
+        out_info->is_low_power_mode =
+            extract_json_bool(json, "is_low_power_mode") ? RAC_TRUE : RAC_FALSE;
+
+        // Extract float field for battery
+        out_info->battery_level = static_cast<float>(extract_json_int(json, "battery_level"));
+
+        LOGi("jni_device_get_info: parsed device_model=%s, os_version=%s, architecture=%s",
+             out_info->device_model ? out_info->device_model : "(null)",
+             out_info->os_version ? out_info->os_version : "(null)",
+             out_info->architecture ? out_info->architecture : "(null)");
+
+        env->ReleaseStringUTFChars(jResult, json);
+        env->DeleteLocalRef(jResult);
+    }
+}
+
+static const char* jni_device_get_id(void* user_data) {
+    JNIEnv* env = getJNIEnv();
+    if (!env || !g_device_jni_state.callback_obj || !g_device_jni_state.get_device_id_method) {
+        LOGe("jni_device_get_id: JNI not ready");
+        return "";
+    }
+
+    jstring jResult = (jstring)env->CallObjectMethod(g_device_jni_state.callback_obj,
+                                                     g_device_jni_state.get_device_id_method);
+
+    // Check for Java exception after CallObjectMethod
+    if (env->ExceptionCheck()) {
+        LOGe("jni_device_get_id: Java exception occurred in getDeviceId()");
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        return "";
+    }
+
+    if (jResult) {
+        const char* str = env->GetStringUTFChars(jResult, nullptr);
+
+        // Lock mutex to protect g_cached_device_id from concurrent access
+        std::lock_guard<std::mutex> lock(g_device_jni_state.mtx);
+        g_cached_device_id = str;
+        env->ReleaseStringUTFChars(jResult, str);
+        env->DeleteLocalRef(jResult);
+        return g_cached_device_id.c_str();
+    }
+    return "";
+}
+
+static rac_bool_t jni_device_is_registered(void* user_data) {
+    JNIEnv* env = getJNIEnv();
+    if (!env || !g_device_jni_state.callback_obj || !g_device_jni_state.is_registered_method) {
+        return RAC_FALSE;
+    }
+
+    jboolean result = env->CallBooleanMethod(g_device_jni_state.callback_obj,
+                                             g_device_jni_state.is_registered_method);
+
+    // Check for Java exception after CallBooleanMethod
+    if (env->ExceptionCheck()) {
+        LOGe("jni_device_is_registered: Java exception occurred in isRegistered()");
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        return RAC_FALSE;
+    }
+
+    return result ? RAC_TRUE : RAC_FALSE;
+}
+
+static void jni_device_set_registered(rac_bool_t registered, void* user_data) {
+    JNIEnv* env = getJNIEnv();
+    if (!env || !g_device_jni_state.callback_obj || !g_device_jni_state.set_registered_method) {
+        return;
+    }
+
+    env->CallVoidMethod(g_device_jni_state.callback_obj, g_device_jni_state.set_registered_method,
+                        registered == RAC_TRUE ? JNI_TRUE : JNI_FALSE);
+
+    // Check for Java exception after CallVoidMethod
+    if (env->ExceptionCheck()) {
+        LOGe("jni_device_set_registered: Java exception occurred in setRegistered()");
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+}
+
+static rac_result_t jni_device_http_post(const char* endpoint, const char* json_body,
+                                         rac_bool_t requires_auth,
+                                         rac_device_http_response_t* out_response,
+                                         void* user_data) {
+    JNIEnv* env = getJNIEnv();
+    if (!env || !g_device_jni_state.callback_obj || !g_device_jni_state.http_post_method) {
+        LOGe("jni_device_http_post: JNI not ready");
+        if (out_response) {
+            out_response->result = RAC_ERROR_ADAPTER_NOT_SET;
+            out_response->status_code = -1;
+        }
+        return RAC_ERROR_ADAPTER_NOT_SET;
+    }
+
+    jstring jEndpoint = env->NewStringUTF(endpoint ? endpoint : "");
+    jstring jBody = env->NewStringUTF(json_body ? json_body : "");
+
+    // Check for allocation failures (can throw OutOfMemoryError)
+    if (env->ExceptionCheck() || !jEndpoint || !jBody) {
+        LOGe("jni_device_http_post: Failed to create JNI strings");
+        if (env->ExceptionCheck()) {
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+        }
+        if (jEndpoint)
+            env->DeleteLocalRef(jEndpoint);
+        if (jBody)
+            env->DeleteLocalRef(jBody);
+        if (out_response) {
+            out_response->result = RAC_ERROR_OUT_OF_MEMORY;
+            out_response->status_code = -1;
+        }
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+
+    jint statusCode =
+        env->CallIntMethod(g_device_jni_state.callback_obj, g_device_jni_state.http_post_method,
+                           jEndpoint, jBody, requires_auth == RAC_TRUE ? JNI_TRUE : JNI_FALSE);
+
+    // Check for Java exception after CallIntMethod
+    if (env->ExceptionCheck()) {
+        LOGe("jni_device_http_post: Java exception occurred in httpPost()");
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        env->DeleteLocalRef(jEndpoint);
+        env->DeleteLocalRef(jBody);
+        if (out_response) {
+            out_response->result = RAC_ERROR_NETWORK_ERROR;
+            out_response->status_code = -1;
+        }
+        return RAC_ERROR_NETWORK_ERROR;
+    }
+
+    env->DeleteLocalRef(jEndpoint);
+    env->DeleteLocalRef(jBody);
+
+    if (out_response) {
+        out_response->status_code = statusCode;
+        out_response->result =
+            (statusCode >= 200 && statusCode < 300) ? RAC_SUCCESS : RAC_ERROR_NETWORK_ERROR;
+    }
+
+    return (statusCode >= 200 && statusCode < 300) ? RAC_SUCCESS : RAC_ERROR_NETWORK_ERROR;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racDeviceManagerSetCallbacks(
+    JNIEnv* env, jclass clazz, jobject callbacks) {
+    LOGi("racDeviceManagerSetCallbacks called");
+
+    std::lock_guard<std::mutex> lock(g_device_jni_state.mtx);
+
+    // Clean up previous callback
+    if (g_device_jni_state.callback_obj != nullptr) {
+        env->DeleteGlobalRef(g_device_jni_state.callback_obj);
+        g_device_jni_state.callback_obj = nullptr;
+    }
+
+    if (callbacks == nullptr) {
+        LOGw("racDeviceManagerSetCallbacks: null callbacks");
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Create global reference
+    g_device_jni_state.callback_obj = env->NewGlobalRef(callbacks);
+
+    // Cache method IDs
+    jclass cls = env->GetObjectClass(callbacks);
+    g_device_jni_state.get_device_info_method =
+        env->GetMethodID(cls, "getDeviceInfo", "()Ljava/lang/String;");
+    g_device_jni_state.get_device_id_method =
+        env->GetMethodID(cls, "getDeviceId", "()Ljava/lang/String;");
+    g_device_jni_state.is_registered_method = env->GetMethodID(cls, "isRegistered", "()Z");
+    g_device_jni_state.set_registered_method = env->GetMethodID(cls, "setRegistered", "(Z)V");
+    g_device_jni_state.http_post_method =
+        env->GetMethodID(cls, "httpPost", "(Ljava/lang/String;Ljava/lang/String;Z)I");
+    env->DeleteLocalRef(cls);
+
+    // Verify methods found
+    if (!g_device_jni_state.get_device_id_method || !g_device_jni_state.is_registered_method) {
+        LOGe("racDeviceManagerSetCallbacks: required methods not found");
+        env->DeleteGlobalRef(g_device_jni_state.callback_obj);
+        g_device_jni_state.callback_obj = nullptr;
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Set up C callbacks
+    rac_device_callbacks_t c_callbacks = {};
+    c_callbacks.get_device_info = jni_device_get_info;
+    c_callbacks.get_device_id = jni_device_get_id;
+    c_callbacks.is_registered = jni_device_is_registered;
+    c_callbacks.set_registered = jni_device_set_registered;
+    c_callbacks.http_post = jni_device_http_post;
+    c_callbacks.user_data = nullptr;
+
+    rac_result_t result = rac_device_manager_set_callbacks(&c_callbacks);
+
+    LOGi("racDeviceManagerSetCallbacks result: %d", result);
+    return static_cast<jint>(result);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racDeviceManagerRegisterIfNeeded(
+    JNIEnv* env, jclass clazz, jint environment, jstring buildToken) {
+    LOGi("racDeviceManagerRegisterIfNeeded called (env=%d)", environment);
+
+    std::string tokenStorage;
+    const char* token = getNullableCString(env, buildToken, tokenStorage);
+
+    rac_result_t result =
+        rac_device_manager_register_if_needed(static_cast<rac_environment_t>(environment), token);
+
+    LOGi("racDeviceManagerRegisterIfNeeded result: %d", result);
+    return static_cast<jint>(result);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racDeviceManagerIsRegistered(
+    JNIEnv* env, jclass clazz) {
+    return rac_device_manager_is_registered() == RAC_TRUE ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racDeviceManagerClearRegistration(
+    JNIEnv* env, jclass clazz) {
+    LOGi("racDeviceManagerClearRegistration called");
+    rac_device_manager_clear_registration();
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racDeviceManagerGetDeviceId(JNIEnv* env,
+                                                                                     jclass clazz) {
+    const char* deviceId = rac_device_manager_get_device_id();
+    if (deviceId) {
+        return env->NewStringUTF(deviceId);
+    }
+    return nullptr;
+}
+
+// =============================================================================
+// JNI FUNCTIONS - Power State (rac_thermal_governor.h)
+// =============================================================================
+// Battery and power-save changes from the Kotlin SDK. Thermal status is read
+// from AThermal on Android 11+; the thermal argument covers older releases.
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racThermalGovernorReport(
+    JNIEnv* env, jclass clazz, jint thermalState, jfloat batteryLevel, jboolean isCharging,
+    jboolean powerSaveMode) {
+    rac_power_state_t state = {};
+    state.thermal_state = static_cast<rac_thermal_state_t>(thermalState);
+    state.battery_level = batteryLevel;
+    state.is_charging = isCharging ? RAC_TRUE : RAC_FALSE;
+    state.power_save_mode = powerSaveMode ? RAC_TRUE : RAC_FALSE;
+    return static_cast<jint>(rac_thermal_governor_report(&state));
+}
+
+}  // extern "C"
@@ -0,0 +1,243 @@
+/**
+ * RunAnywhere Commons JNI Bridge - Request Executor
+ *
+ * Non-blocking LLM, STT and TTS requests on the native executor.
+ */
+
+#include "jni_common.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "rac/core/rac_executor.h"
+#include "rac/features/llm/rac_llm_component.h"
+#include "rac/features/stt/rac_stt_component.h"
+#include "rac/features/tts/rac_tts_component.h"
+
+extern "C" {
+
+// =============================================================================
+// JNI FUNCTIONS - Request Executor (rac_executor.h)
+// =============================================================================
+// The *Submit functions queue inference on the native executor and return a
+// request ID (or a negative rac_result_t) right away. The result arrives on
+// an executor worker, which stays attached to the JVM, through the callback's
+// onRequestComplete(requestId: Long, status: Int, result: String?,
+// audio: ByteArray?): JSON for LLM and STT, Float32 PCM for TTS. A request
+// cancelled before it runs completes with RAC_ERROR_CANCELLED on the thread
+// that cancelled it.
+
+struct JniRequest {
+    enum class Kind { LLM, STT, TTS };
+
+    Kind kind;
+    rac_handle_t handle;
+    std::string text;            // LLM prompt or TTS text
+    std::vector<uint8_t> audio;  // STT input
+    rac_stt_options_t stt_options;
+    jobject callback;  // global ref
+    jmethodID on_complete;
+};
+
+static void completeRequest(const JniRequest* request, rac_request_id_t id, rac_result_t status,
+                            const std::string* result, const void* audio, size_t audio_size) {
+    JNIEnv* env = getJNIEnv();
+    if (env == nullptr) {
+        LOGe("Request %llu: no JNIEnv for completion", static_cast<unsigned long long>(id));
+        return;
+    }
+
+    jstring jResult = result != nullptr ? env->NewStringUTF(result->c_str()) : nullptr;
+    jbyteArray jAudio = nullptr;
+    if (audio != nullptr) {
+        jAudio = env->NewByteArray(static_cast<jsize>(audio_size));
+        if (jAudio != nullptr) {
+            env->SetByteArrayRegion(jAudio, 0, static_cast<jsize>(audio_size),
+                                    static_cast<const jbyte*>(audio));
+        }
+    }
+
+    env->CallVoidMethod(request->callback, request->on_complete, static_cast<jlong>(id),
+                        static_cast<jint>(status), jResult, jAudio);
+    if (env->ExceptionCheck()) {
+        LOGe("Request %llu: exception in onRequestComplete", static_cast<unsigned long long>(id));
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+
+    if (jResult != nullptr)
+        env->DeleteLocalRef(jResult);
+    if (jAudio != nullptr)
+        env->DeleteLocalRef(jAudio);
+}
+
+static void runJniRequest(rac_request_id_t id, void* user_data) {
+    auto* request = static_cast<JniRequest*>(user_data);
+    rac_result_t status = RAC_SUCCESS;
+
+    switch (request->kind) {
+        case JniRequest::Kind::LLM: {
+            rac_llm_options_t options = {};
+            options.max_tokens = 512;
+            options.temperature = 0.7f;
+            options.top_p = 1.0f;
+            options.streaming_enabled = RAC_FALSE;
+
+            rac_llm_result_t result = {};
+            status = rac_llm_component_generate(request->handle, request->text.c_str(), &options,
+                                                &result);
+            if (status == RAC_SUCCESS && rac_executor_is_cancelled(id)) {
+                status = RAC_ERROR_CANCELLED;
+            }
+            if (status == RAC_SUCCESS) {
+                std::string json = llmResultToJson(result);
+                completeRequest(request, id, status, &json, nullptr, 0);
+            } else {
+                completeRequest(request, id, status, nullptr, nullptr, 0);
+            }
+            rac_llm_result_free(&result);
+            break;
+        }
+        case JniRequest::Kind::STT: {
+            rac_stt_result_t result = {};
+            status = rac_stt_component_transcribe(request->handle, request->audio.data(),
+                                                  request->audio.size(), &request->stt_options,
+                                                  &result);
+            if (status == RAC_SUCCESS && rac_executor_is_cancelled(id)) {
+                status = RAC_ERROR_CANCELLED;
+            }
+            if (status == RAC_SUCCESS) {
+                std::string json = sttResultToJson(result);
+                completeRequest(request, id, status, &json, nullptr, 0);
+            } else {
+                completeRequest(request, id, status, nullptr, nullptr, 0);
+            }
+            rac_stt_result_free(&result);
+            break;
+        }
+        case JniRequest::Kind::TTS: {
+            rac_tts_options_t options = {};
+            rac_tts_result_t result = {};
+            status = rac_tts_component_synthesize(request->handle, request->text.c_str(), &options,
+                                                  &result);
+            if (status == RAC_SUCCESS && rac_executor_is_cancelled(id)) {
+                status = RAC_ERROR_CANCELLED;
+            }
+            if (status == RAC_SUCCESS && result.audio_data != nullptr) {
+                completeRequest(request, id, status, nullptr, result.audio_data,
+                                result.audio_size);
+            } else {
+                completeRequest(request, id, status, nullptr, nullptr, 0);
+            }
+            rac_tts_result_free(&result);
+            break;
+        }
+    }
+}
+
+// Called with the executor lock held; only LLM generation can stop early
+static void cancelJniRequest(rac_request_id_t id, void* user_data) {
+    auto* request = static_cast<JniRequest*>(user_data);
+    if (request->kind == JniRequest::Kind::LLM) {
+        rac_llm_component_cancel(request->handle);
+    }
+}
+
+static void releaseJniRequest(rac_request_id_t id, rac_bool_t ran, void* user_data) {
+    auto* request = static_cast<JniRequest*>(user_data);
+    if (!ran) {
+        completeRequest(request, id, RAC_ERROR_CANCELLED, nullptr, nullptr, 0);
+    }
+    JNIEnv* env = getJNIEnv();
+    if (env != nullptr) {
+        env->DeleteGlobalRef(request->callback);
+    }
+    delete request;
+}
+
+// Queues a prepared request; takes ownership of it
+static jlong submitJniRequest(JNIEnv* env, JniRequest* request, jobject callback, jint priority) {
+    RequestCallbackIds ids = {};
+    if (!g_request_callback_ids.get(env, callback, &ids)) {
+        LOGe("Request callback has no onRequestComplete(JILjava/lang/String;[B)V");
+        delete request;
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+    request->callback = env->NewGlobalRef(callback);
+    request->on_complete = ids.on_complete;
+
+    rac_request_t desc = {};
+    desc.priority = static_cast<rac_request_priority_t>(
+        std::min<jint>(std::max<jint>(priority, RAC_REQUEST_PRIORITY_LOW),
+                       RAC_REQUEST_PRIORITY_HIGH));
+    desc.run = runJniRequest;
+    desc.cancel = cancelJniRequest;
+    desc.release = releaseJniRequest;
+    desc.user_data = request;
+
+    rac_request_id_t id = 0;
+    rac_result_t status = rac_executor_submit(&desc, &id);
+    if (status != RAC_SUCCESS) {
+        env->DeleteGlobalRef(request->callback);
+        delete request;
+        return static_cast<jlong>(status);
+    }
+    return static_cast<jlong>(id);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentGenerateSubmit(
+    JNIEnv* env, jclass clazz, jlong handle, jstring prompt, jstring configJson, jint priority,
+    jobject callback) {
+    if (handle == 0 || callback == nullptr)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* request = new JniRequest{};
+    request->kind = JniRequest::Kind::LLM;
+    request->handle = reinterpret_cast<rac_handle_t>(handle);
+    request->text = getCString(env, prompt);
+    return submitJniRequest(env, request, callback, priority);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentTranscribeSubmit(
+    JNIEnv* env, jclass clazz, jlong handle, jbyteArray audioData, jstring configJson,
+    jint priority, jobject callback) {
+    if (handle == 0 || audioData == nullptr || callback == nullptr)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* request = new JniRequest{};
+    request->kind = JniRequest::Kind::STT;
+    request->handle = reinterpret_cast<rac_handle_t>(handle);
+    request->audio.resize(static_cast<size_t>(env->GetArrayLength(audioData)));
+    env->GetByteArrayRegion(audioData, 0, static_cast<jsize>(request->audio.size()),
+                            reinterpret_cast<jbyte*>(request->audio.data()));
+    request->stt_options = sttOptionsFromConfig(env, configJson);
+    return submitJniRequest(env, request, callback, priority);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentSynthesizeSubmit(
+    JNIEnv* env, jclass clazz, jlong handle, jstring text, jstring configJson, jint priority,
+    jobject callback) {
+    if (handle == 0 || callback == nullptr)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    auto* request = new JniRequest{};
+    request->kind = JniRequest::Kind::TTS;
+    request->handle = reinterpret_cast<rac_handle_t>(handle);
+    request->text = getCString(env, text);
+    return submitJniRequest(env, request, callback, priority);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racRequestCancel(JNIEnv* env,
+                                                                          jclass clazz,
+                                                                          jlong requestId) {
+    if (requestId <= 0)
+        return RAC_ERROR_INVALID_ARGUMENT;
+    return static_cast<jint>(rac_executor_cancel(static_cast<rac_request_id_t>(requestId)));
+}
+
+}  // extern "C"
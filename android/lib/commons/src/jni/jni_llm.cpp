@@ -0,0 +1,769 @@
+/**
+ * RunAnywhere Commons JNI Bridge - LLM Component
+ *
+ * LLM component lifecycle, generation and token streaming.
+ */
+
+#include "jni_common.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rac/core/rac_core.h"
+#include "rac/features/llm/rac_llm_component.h"
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+// LLM result as the JSON the Kotlin bridge expects
+std::string llmResultToJson(const rac_llm_result_t& result) {
+    std::string json = "{";
+    json += "\"text\":\"";
+    // Escape special characters in text for JSON
+    for (const char* p = result.text; p != nullptr && *p; p++) {
+        switch (*p) {
+            case '"':
+                json += "\\\"";
+                break;
+            case '\\':
+                json += "\\\\";
+                break;
+            case '\n':
+                json += "\\n";
+                break;
+            case '\r':
+                json += "\\r";
+                break;
+            case '\t':
+                json += "\\t";
+                break;
+            default:
+                json += *p;
+                break;
+        }
+    }
+    json += "\",";
+    // Kotlin expects these keys:
+    json += "\"tokens_generated\":" + std::to_string(result.completion_tokens) + ",";
+    json += "\"tokens_evaluated\":" + std::to_string(result.prompt_tokens) + ",";
+    json += "\"stop_reason\":" + std::to_string(result.stop_reason) + ",";  // 0 = normal completion
+    json += "\"total_time_ms\":" + std::to_string(result.total_time_ms) + ",";
+    json += "\"tokens_per_second\":" + std::to_string(result.tokens_per_second);
+    json += "}";
+    return json;
+}
+
+extern "C" {
+
+// =============================================================================
+// JNI FUNCTIONS - LLM Component
+// =============================================================================
+
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentCreate(JNIEnv* env,
+                                                                               jclass clazz) {
+    rac_handle_t handle = RAC_INVALID_HANDLE;
+    rac_result_t result = rac_llm_component_create(&handle);
+    if (result != RAC_SUCCESS) {
+        LOGe("Failed to create LLM component: %d", result);
+        return 0;
+    }
+    return reinterpret_cast<jlong>(handle);
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentDestroy(JNIEnv* env,
+                                                                                jclass clazz,
+                                                                                jlong handle) {
+    if (handle != 0) {
+        rac_llm_component_destroy(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentLoadModel(
+    JNIEnv* env, jclass clazz, jlong handle, jstring modelPath, jstring modelId,
+    jstring modelName) {
+    LOGi("racLlmComponentLoadModel called with handle=%lld", (long long)handle);
+    if (handle == 0)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    std::string path = getCString(env, modelPath);
+    std::string id = getCString(env, modelId);
+    std::string name = getCString(env, modelName);
+    LOGi("racLlmComponentLoadModel path=%s, id=%s, name=%s", path.c_str(), id.c_str(),
+         name.c_str());
+
+    // Debug: List registered providers BEFORE loading
+    const char** provider_names = nullptr;
+    size_t provider_count = 0;
+    rac_result_t list_result = rac_service_list_providers(RAC_CAPABILITY_TEXT_GENERATION,
+                                                          &provider_names, &provider_count);
+    LOGi("Before load_model - TEXT_GENERATION providers: count=%zu, list_result=%d", provider_count,
+         list_result);
+    if (provider_names && provider_count > 0) {
+        for (size_t i = 0; i < provider_count; i++) {
+            LOGi("  Provider[%zu]: %s", i, provider_names[i] ? provider_names[i] : "NULL");
+        }
+    } else {
+        LOGw("NO providers registered for TEXT_GENERATION!");
+    }
+
+    // Pass model_path, model_id, and model_name separately to C++ lifecycle
+    rac_result_t result = rac_llm_component_load_model(
+        reinterpret_cast<rac_handle_t>(handle),
+        path.c_str(),                          // model_path
+        id.c_str(),                            // model_id (for telemetry)
+        name.empty() ? nullptr : name.c_str()  // model_name (optional, for telemetry)
+    );
+    LOGi("rac_llm_component_load_model returned: %d", result);
+
+    return static_cast<jint>(result);
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentUnload(JNIEnv* env,
+                                                                               jclass clazz,
+                                                                               jlong handle) {
+    if (handle != 0) {
+        rac_llm_component_unload(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentGenerate(
+    JNIEnv* env, jclass clazz, jlong handle, jstring prompt, jstring configJson) {
+    LOGi("racLlmComponentGenerate called with handle=%lld", (long long)handle);
+
+    if (handle == 0) {
+        LOGe("racLlmComponentGenerate: invalid handle");
+        return nullptr;
+    }
+
+    std::string promptStr = getCString(env, prompt);
+    LOGi("racLlmComponentGenerate prompt length=%zu", promptStr.length());
+
+    std::string configStorage;
+    const char* config = getNullableCString(env, configJson, configStorage);
+
+    rac_llm_options_t options = {};
+    options.max_tokens = 512;
+    options.temperature = 0.7f;
+    options.top_p = 1.0f;
+    options.streaming_enabled = RAC_FALSE;
+
+    rac_llm_result_t result = {};
+    LOGi("racLlmComponentGenerate calling rac_llm_component_generate...");
+
+    rac_result_t status = rac_llm_component_generate(reinterpret_cast<rac_handle_t>(handle),
+                                                     promptStr.c_str(), &options, &result);
+
+    LOGi("racLlmComponentGenerate status=%d", status);
+
+    if (status != RAC_SUCCESS) {
+        LOGe("racLlmComponentGenerate failed with status=%d", status);
+        return nullptr;
+    }
+
+    // Return result as JSON string
+    if (result.text != nullptr) {
+        LOGi("racLlmComponentGenerate result text length=%zu", strlen(result.text));
+
+        std::string json = llmResultToJson(result);
+
+        LOGi("racLlmComponentGenerate returning JSON: %zu bytes", json.length());
+
+        jstring jResult = env->NewStringUTF(json.c_str());
+        rac_llm_result_free(&result);
+        return jResult;
+    }
+
+    LOGw("racLlmComponentGenerate: result.text is null");
+    return env->NewStringUTF("{\"text\":\"\",\"completion_tokens\":0}");
+}
+
+// Generates into a DirectByteBuffer instead of JSON, with options passed as
+// arguments (non-positive max_tokens keeps the default of 512). Returns the
+// bytes written or a negative rac_result_t. Record layout:
+//   int32 version, int32 prompt_tokens, int32 completion_tokens,
+//   int64 time_to_first_token_ms, int64 total_time_ms, float tokens_per_second,
+//   string text
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentGenerateInto(
+    JNIEnv* env, jclass clazz, jlong handle, jstring prompt, jint maxTokens, jfloat temperature,
+    jfloat topP, jobject resultBuffer) {
+    void* buffer = nullptr;
+    size_t capacity = 0;
+    if (handle == 0 || !getDirectBuffer(env, resultBuffer, &buffer, &capacity))
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    std::string promptStr = getCString(env, prompt);
+
+    rac_llm_options_t options = {};
+    options.max_tokens = maxTokens > 0 ? maxTokens : 512;
+    options.temperature = temperature;
+    options.top_p = topP;
+    options.streaming_enabled = RAC_FALSE;
+
+    rac_llm_result_t result = {};
+    rac_result_t status = rac_llm_component_generate(reinterpret_cast<rac_handle_t>(handle),
+                                                     promptStr.c_str(), &options, &result);
+    if (status != RAC_SUCCESS) {
+        LOGe("racLlmComponentGenerateInto failed with status=%d", status);
+        return static_cast<jlong>(status);
+    }
+
+    BinaryWriter writer(buffer, capacity);
+    writer.i32(kBinaryLayoutVersion);
+    writer.i32(result.prompt_tokens);
+    writer.i32(result.completion_tokens);
+    writer.i64(result.time_to_first_token_ms);
+    writer.i64(result.total_time_ms);
+    writer.f32(result.tokens_per_second);
+    writer.str(result.text);
+    rac_llm_result_free(&result);
+    return finishBinaryRecord(writer, "LLM result");
+}
+
+// ========================================================================
+// STREAMING CONTEXT - for collecting tokens during stream generation
+// ========================================================================
+
+struct LLMStreamContext {
+    std::string accumulated_text;
+    int token_count = 0;
+    bool is_complete = false;
+    bool has_error = false;
+    rac_result_t error_code = RAC_SUCCESS;
+    std::string error_message;
+    rac_llm_result_t final_result = {};
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
+static rac_bool_t llm_stream_token_callback(const char* token, void* user_data) {
+    if (!user_data || !token)
+        return RAC_TRUE;
+
+    auto* ctx = static_cast<LLMStreamContext*>(user_data);
+    std::lock_guard<std::mutex> lock(ctx->mtx);
+
+    ctx->accumulated_text += token;
+    ctx->token_count++;
+
+    // Log every 10 tokens to avoid spam
+    if (ctx->token_count % 10 == 0) {
+        LOGi("Streaming: %d tokens accumulated", ctx->token_count);
+    }
+
+    return RAC_TRUE;  // Continue streaming
+}
+
+static void llm_stream_complete_callback(const rac_llm_result_t* result, void* user_data) {
+    if (!user_data)
+        return;
+
+    auto* ctx = static_cast<LLMStreamContext*>(user_data);
+    std::lock_guard<std::mutex> lock(ctx->mtx);
+
+    LOGi("Streaming complete: %d tokens", ctx->token_count);
+
+    // Copy final result metrics if available
+    if (result) {
+        ctx->final_result.completion_tokens =
+            result->completion_tokens > 0 ? result->completion_tokens : ctx->token_count;
+        ctx->final_result.prompt_tokens = result->prompt_tokens;
+        ctx->final_result.total_tokens = result->total_tokens;
+        ctx->final_result.total_time_ms = result->total_time_ms;
+        ctx->final_result.tokens_per_second = result->tokens_per_second;
+        ctx->final_result.stop_reason = result->stop_reason;
+    } else {
+        ctx->final_result.completion_tokens = ctx->token_count;
+    }
+
+    ctx->is_complete = true;
+    ctx->cv.notify_one();
+}
+
+static void llm_stream_error_callback(rac_result_t error_code, const char* error_message,
+                                      void* user_data) {
+    if (!user_data)
+        return;
+
+    auto* ctx = static_cast<LLMStreamContext*>(user_data);
+    std::lock_guard<std::mutex> lock(ctx->mtx);
+
+    LOGe("Streaming error: %d - %s", error_code, error_message ? error_message : "Unknown");
+
+    ctx->has_error = true;
+    ctx->error_code = error_code;
+    ctx->error_message = error_message ? error_message : "Unknown error";
+    ctx->is_complete = true;
+    ctx->cv.notify_one();
+}
+
+// ========================================================================
+// STREAMING WITH CALLBACK - Real-time token streaming to Kotlin
+// ========================================================================
+
+// Tokens are handed to Kotlin in batches: the first at once, then every
+// kTokenBatchSize tokens or kTokenBatchIntervalMs, whichever comes first
+static constexpr int kTokenBatchSize = 8;
+static constexpr int64_t kTokenBatchIntervalMs = 50;
+
+struct LLMStreamCallbackContext {
+    JavaVM* jvm = nullptr;
+    jobject callback = nullptr;
+    jmethodID onTokenMethod = nullptr;
+    std::string accumulated_text;
+    int token_count = 0;
+    std::string pending_text;  // Tokens not yet delivered; reused between batches
+    int pending_tokens = 0;
+    std::chrono::steady_clock::time_point last_delivery{};
+    bool cancelled = false;
+    bool is_complete = false;
+    bool has_error = false;
+    rac_result_t error_code = RAC_SUCCESS;
+    std::string error_message;
+    rac_llm_result_t final_result = {};
+};
+
+// Length of text without a trailing partial UTF-8 sequence, which
+// NewStringUTF would reject; the rest waits for the token that completes it
+static size_t completeUtf8Prefix(const std::string& text) {
+    size_t end = text.size();
+    size_t i = end;
+    while (i > 0 && end - i < 4 && (static_cast<unsigned char>(text[i - 1]) & 0xC0) == 0x80) {
+        --i;
+    }
+    if (i == 0) {
+        return end;
+    }
+    const auto lead = static_cast<unsigned char>(text[i - 1]);
+    const size_t needed = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+    return end - (i - 1) < needed ? i - 1 : end;
+}
+
+// Hands the pending tokens to Kotlin. Returns false if the callback asked to
+// stop generating.
+static bool deliverPendingTokens(LLMStreamCallbackContext* ctx, bool final) {
+    const size_t length = final ? ctx->pending_text.size() : completeUtf8Prefix(ctx->pending_text);
+    if (length == 0 || !ctx->callback || !ctx->onTokenMethod)
+        return true;
+
+    JNIEnv* env = getThreadEnv(ctx->jvm);
+    if (env == nullptr) {
+        LOGe("Failed to attach thread for streaming callback");
+        return true;
+    }
+
+    // Terminate in place at the batch end, holding back any partial character
+    std::string& text = ctx->pending_text;
+    const char held = text[length];
+    text[length] = '\0';
+    jstring jText = env->NewStringUTF(text.data());
+    text[length] = held;
+    jboolean continueGen = env->CallBooleanMethod(ctx->callback, ctx->onTokenMethod, jText);
+    env->DeleteLocalRef(jText);
+
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+
+    text.erase(0, length);
+    ctx->pending_tokens = 0;
+    ctx->last_delivery = std::chrono::steady_clock::now();
+    return continueGen;
+}
+
+static rac_bool_t llm_stream_callback_token(const char* token, void* user_data) {
+    if (!user_data || !token)
+        return RAC_TRUE;
+
+    auto* ctx = static_cast<LLMStreamCallbackContext*>(user_data);
+
+    // Accumulate token
+    ctx->accumulated_text += token;
+    ctx->token_count++;
+    ctx->pending_text += token;
+    ctx->pending_tokens++;
+
+    const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                std::chrono::steady_clock::now() - ctx->last_delivery)
+                                .count();
+    if (ctx->pending_tokens < kTokenBatchSize && elapsed_ms < kTokenBatchIntervalMs) {
+        return RAC_TRUE;
+    }
+
+    // Call back to Kotlin
+    if (!deliverPendingTokens(ctx, false)) {
+        LOGi("Streaming cancelled by callback");
+        ctx->cancelled = true;
+        return RAC_FALSE;  // Stop streaming
+    }
+
+    return RAC_TRUE;  // Continue streaming
+}
+
+static void llm_stream_callback_complete(const rac_llm_result_t* result, void* user_data) {
+    if (!user_data)
+        return;
+
+    auto* ctx = static_cast<LLMStreamCallbackContext*>(user_data);
+
+    LOGi("Streaming with callback complete: %d tokens", ctx->token_count);
+    if (!ctx->cancelled) {
+        deliverPendingTokens(ctx, true);
+    }
+
+    if (result) {
+        ctx->final_result.completion_tokens =
+            result->completion_tokens > 0 ? result->completion_tokens : ctx->token_count;
+        ctx->final_result.prompt_tokens = result->prompt_tokens;
+        ctx->final_result.total_tokens = result->total_tokens;
+        ctx->final_result.total_time_ms = result->total_time_ms;
+        ctx->final_result.tokens_per_second = result->tokens_per_second;
+        ctx->final_result.stop_reason = result->stop_reason;
+    } else {
+        ctx->final_result.completion_tokens = ctx->token_count;
+    }
+
+    ctx->is_complete = true;
+}
+
+static void llm_stream_callback_error(rac_result_t error_code, const char* error_message,
+                                      void* user_data) {
+    if (!user_data)
+        return;
+
+    auto* ctx = static_cast<LLMStreamCallbackContext*>(user_data);
+
+    LOGe("Streaming with callback error: %d - %s", error_code,
+         error_message ? error_message : "Unknown");
+    if (!ctx->cancelled) {
+        deliverPendingTokens(ctx, true);
+    }
+
+    ctx->has_error = true;
+    ctx->error_code = error_code;
+    ctx->error_message = error_message ? error_message : "Unknown error";
+    ctx->is_complete = true;
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentGenerateStream(
+    JNIEnv* env, jclass clazz, jlong handle, jstring prompt, jstring configJson) {
+    LOGi("racLlmComponentGenerateStream called with handle=%lld", (long long)handle);
+
+    if (handle == 0) {
+        LOGe("racLlmComponentGenerateStream: invalid handle");
+        return nullptr;
+    }
+
+    std::string promptStr = getCString(env, prompt);
+    LOGi("racLlmComponentGenerateStream prompt length=%zu", promptStr.length());
+
+    std::string configStorage;
+    const char* config = getNullableCString(env, configJson, configStorage);
+
+    // Parse config for options
+    rac_llm_options_t options = {};
+    options.max_tokens = 512;
+    options.temperature = 0.7f;
+    options.top_p = 1.0f;
+    options.streaming_enabled = RAC_TRUE;
+
+    // Create streaming context
+    LLMStreamContext ctx;
+
+    LOGi("racLlmComponentGenerateStream calling rac_llm_component_generate_stream...");
+
+    rac_result_t status = rac_llm_component_generate_stream(
+        reinterpret_cast<rac_handle_t>(handle), promptStr.c_str(), &options,
+        llm_stream_token_callback, llm_stream_complete_callback, llm_stream_error_callback, &ctx);
+
+    if (status != RAC_SUCCESS) {
+        LOGe("rac_llm_component_generate_stream failed with status=%d", status);
+        return nullptr;
+    }
+
+    // Wait for streaming to complete
+    {
+        std::unique_lock<std::mutex> lock(ctx.mtx);
+        ctx.cv.wait(lock, [&ctx] { return ctx.is_complete; });
+    }
+
+    if (ctx.has_error) {
+        LOGe("Streaming failed: %s", ctx.error_message.c_str());
+        return nullptr;
+    }
+
+    LOGi("racLlmComponentGenerateStream result text length=%zu, tokens=%d",
+         ctx.accumulated_text.length(), ctx.token_count);
+
+    // Build JSON result - keys must match what Kotlin expects
+    std::string json = "{";
+    json += "\"text\":\"";
+    // Escape special characters in text for JSON
+    for (char c : ctx.accumulated_text) {
+        switch (c) {
+            case '"':
+                json += "\\\"";
+                break;
+            case '\\':
+                json += "\\\\";
+                break;
+            case '\n':
+                json += "\\n";
+                break;
+            case '\r':
+                json += "\\r";
+                break;
+            case '\t':
+                json += "\\t";
+                break;
+            default:
+                json += c;
+                break;
+        }
+    }
+    json += "\",";
+    // Kotlin expects these keys:
+    json += "\"tokens_generated\":" + std::to_string(ctx.final_result.completion_tokens) + ",";
+    json += "\"tokens_evaluated\":" + std::to_string(ctx.final_result.prompt_tokens) + ",";
+    json += "\"stop_reason\":" + std::to_string(ctx.final_result.stop_reason) + ",";
+    json += "\"total_time_ms\":" + std::to_string(ctx.final_result.total_time_ms) + ",";
+    json += "\"tokens_per_second\":" + std::to_string(ctx.final_result.tokens_per_second);
+    json += "}";
+
+    LOGi("racLlmComponentGenerateStream returning JSON: %zu bytes", json.length());
+
+    return env->NewStringUTF(json.c_str());
+}
+
+// ========================================================================
+// STREAMING WITH KOTLIN CALLBACK - Real-time token-by-token streaming
+// ========================================================================
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentGenerateStreamWithCallback(
+    JNIEnv* env, jclass clazz, jlong handle, jstring prompt, jstring configJson,
+    jobject tokenCallback) {
+    LOGi("racLlmComponentGenerateStreamWithCallback called with handle=%lld", (long long)handle);
+
+    if (handle == 0) {
+        LOGe("racLlmComponentGenerateStreamWithCallback: invalid handle");
+        return nullptr;
+    }
+
+    if (!tokenCallback) {
+        LOGe("racLlmComponentGenerateStreamWithCallback: null callback");
+        return nullptr;
+    }
+
+    std::string promptStr = getCString(env, prompt);
+    LOGi("racLlmComponentGenerateStreamWithCallback prompt length=%zu", promptStr.length());
+
+    std::string configStorage;
+    const char* config = getNullableCString(env, configJson, configStorage);
+
+    // Get JVM and callback method
+    JavaVM* jvm = nullptr;
+    env->GetJavaVM(&jvm);
+
+    TokenCallbackIds callbackIds = {};
+    if (!g_token_callback_ids.get(env, tokenCallback, &callbackIds)) {
+        LOGe("racLlmComponentGenerateStreamWithCallback: could not find onToken method");
+        return nullptr;
+    }
+
+    // Create global ref to callback to ensure it survives across threads
+    jobject globalCallback = env->NewGlobalRef(tokenCallback);
+
+    // Parse config for options
+    rac_llm_options_t options = {};
+    options.max_tokens = 512;
+    options.temperature = 0.7f;
+    options.top_p = 1.0f;
+    options.streaming_enabled = RAC_TRUE;
+
+    // Create streaming callback context
+    LLMStreamCallbackContext ctx;
+    ctx.jvm = jvm;
+    ctx.callback = globalCallback;
+    ctx.onTokenMethod = callbackIds.on_token;
+    ctx.pending_text.reserve(256);
+
+    LOGi("racLlmComponentGenerateStreamWithCallback calling rac_llm_component_generate_stream...");
+
+    rac_result_t status = rac_llm_component_generate_stream(
+        reinterpret_cast<rac_handle_t>(handle), promptStr.c_str(), &options,
+        llm_stream_callback_token, llm_stream_callback_complete, llm_stream_callback_error, &ctx);
+
+    // Tokens still batched if the backend returned without completing
+    if (!ctx.cancelled) {
+        deliverPendingTokens(&ctx, true);
+    }
+
+    // Clean up global ref
+    env->DeleteGlobalRef(globalCallback);
+
+    if (status != RAC_SUCCESS) {
+        LOGe("rac_llm_component_generate_stream failed with status=%d", status);
+        return nullptr;
+    }
+
+    if (ctx.has_error) {
+        LOGe("Streaming failed: %s", ctx.error_message.c_str());
+        return nullptr;
+    }
+
+    LOGi("racLlmComponentGenerateStreamWithCallback result text length=%zu, tokens=%d",
+         ctx.accumulated_text.length(), ctx.token_count);
+
+    // Build JSON result
+    std::string json = "{";
+    json += "\"text\":\"";
+    for (char c : ctx.accumulated_text) {
+        switch (c) {
+            case '"':
+                json += "\\\"";
+                break;
+            case '\\':
+                json += "\\\\";
+                break;
+            case '\n':
+                json += "\\n";
+                break;
+            case '\r':
+                json += "\\r";
+                break;
+            case '\t':
+                json += "\\t";
+                break;
+            default:
+                json += c;
+                break;
+        }
+    }
+    json += "\",";
+    json += "\"tokens_generated\":" + std::to_string(ctx.final_result.completion_tokens) + ",";
+    json += "\"tokens_evaluated\":" + std::to_string(ctx.final_result.prompt_tokens) + ",";
+    json += "\"stop_reason\":" + std::to_string(ctx.final_result.stop_reason) + ",";
+    json += "\"total_time_ms\":" + std::to_string(ctx.final_result.total_time_ms) + ",";
+    json += "\"tokens_per_second\":" + std::to_string(ctx.final_result.tokens_per_second);
+    json += "}";
+
+    LOGi("racLlmComponentGenerateStreamWithCallback returning JSON: %zu bytes", json.length());
+
+    return env->NewStringUTF(json.c_str());
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentCancel(JNIEnv* env,
+                                                                               jclass clazz,
+                                                                               jlong handle) {
+    if (handle != 0) {
+        rac_llm_component_cancel(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentGetContextSize(
+    JNIEnv* env, jclass clazz, jlong handle) {
+    if (handle == 0)
+        return 0;
+    int32_t context_size = 0;
+    if (rac_llm_component_get_context_size(reinterpret_cast<rac_handle_t>(handle),
+                                           &context_size) != RAC_SUCCESS) {
+        return 4096;  // Default context size before a model is loaded
+    }
+    return static_cast<jint>(context_size);
+}
+
+// Token count of text; counts are cached natively per model and text
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentTokenize(JNIEnv* env,
+                                                                                 jclass clazz,
+                                                                                 jlong handle,
+                                                                                 jstring text) {
+    if (handle == 0)
+        return 0;
+    std::string textStr = getCString(env, text);
+    int32_t count = 0;
+    if (rac_llm_component_count_tokens(reinterpret_cast<rac_handle_t>(handle), textStr.c_str(),
+                                       &count) != RAC_SUCCESS) {
+        // No model loaded: rough estimate, ~4 chars per token
+        return static_cast<jint>(textStr.length() / 4);
+    }
+    return static_cast<jint>(count);
+}
+
+// Counts every string of `texts` in one crossing, writing per-text counts to
+// `outCounts` (at least as long as `texts`). Returns the total or a negative
+// rac_result_t. Pass chat turns separately so a growing history only
+// tokenizes its new turns.
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentTokenizeBatch(
+    JNIEnv* env, jclass clazz, jlong handle, jobjectArray texts, jintArray outCounts) {
+    if (handle == 0 || texts == nullptr || outCounts == nullptr)
+        return RAC_ERROR_INVALID_ARGUMENT;
+    const jsize count = env->GetArrayLength(texts);
+    if (env->GetArrayLength(outCounts) < count)
+        return RAC_ERROR_BUFFER_TOO_SMALL;
+
+    std::vector<std::string> storage(static_cast<size_t>(count));
+    std::vector<const char*> ptrs(static_cast<size_t>(count), nullptr);
+    for (jsize i = 0; i < count; ++i) {
+        auto text = static_cast<jstring>(env->GetObjectArrayElement(texts, i));
+        if (text != nullptr) {
+            storage[i] = getCString(env, text);
+            ptrs[i] = storage[i].c_str();
+            env->DeleteLocalRef(text);
+        }
+    }
+
+    std::vector<int32_t> counts(static_cast<size_t>(count), 0);
+    int64_t total = 0;
+    rac_result_t status = rac_llm_component_count_tokens_batch(
+        reinterpret_cast<rac_handle_t>(handle), ptrs.data(), ptrs.size(), counts.data(), &total);
+    if (status != RAC_SUCCESS)
+        return static_cast<jlong>(status);
+
+    if (count > 0) {
+        env->SetIntArrayRegion(outCounts, 0, count, reinterpret_cast<const jint*>(counts.data()));
+    }
+    return static_cast<jlong>(total);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentGetState(JNIEnv* env,
+                                                                                 jclass clazz,
+                                                                                 jlong handle) {
+    if (handle == 0)
+        return 0;
+    return static_cast<jint>(rac_llm_component_get_state(reinterpret_cast<rac_handle_t>(handle)));
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmComponentIsLoaded(JNIEnv* env,
+                                                                                 jclass clazz,
+                                                                                 jlong handle) {
+    if (handle == 0)
+        return JNI_FALSE;
+    return rac_llm_component_is_loaded(reinterpret_cast<rac_handle_t>(handle)) ? JNI_TRUE
+                                                                               : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racLlmSetCallbacks(
+    JNIEnv* env, jclass clazz, jobject streamCallback, jobject progressCallback) {
+    // TODO: Implement callback registration
+}
+
+}  // extern "C"
@@ -0,0 +1,568 @@
+/**
+ * RunAnywhere Commons JNI Bridge - Model Registry and Assignment
+ *
+ * Model registry queries and model assignment fetches.
+ */
+
+#include "jni_common.h"
+
+#include <mutex>
+#include <string>
+
+#include "rac/core/rac_allocator.h"
+#include "rac/core/rac_core.h"
+#include "rac/infrastructure/model_management/rac_model_assignment.h"
+#include "rac/infrastructure/model_management/rac_model_registry.h"
+#include "rac/infrastructure/model_management/rac_model_types.h"
+
+extern "C" {
+
+// =============================================================================
+// JNI FUNCTIONS - Model Registry (mirrors Swift CppBridge+ModelRegistry.swift)
+// =============================================================================
+
+// Helper to convert Java ModelInfo to C struct
+static rac_model_info_t* javaModelInfoToC(JNIEnv* env, jobject modelInfo) {
+    if (!modelInfo)
+        return nullptr;
+
+    ModelInfoIds ids = {};
+    if (!g_model_info_ids.get(env, modelInfo, &ids))
+        return nullptr;
+
+    // The field strings are local refs; the frame drops them all on return
+    ScopedLocalFrame frame(env, 8);
+    if (!frame.pushed())
+        return nullptr;
+
+    rac_model_info_t* model = rac_model_info_alloc();
+    if (!model)
+        return nullptr;
+
+    // Read and convert values
+    jstring jId = (jstring)env->GetObjectField(modelInfo, ids.id);
+    if (jId) {
+        const char* str = env->GetStringUTFChars(jId, nullptr);
+        model->id = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, str);
+        env->ReleaseStringUTFChars(jId, str);
+    }
+
+    jstring jName = (jstring)env->GetObjectField(modelInfo, ids.name);
+    if (jName) {
+        const char* str = env->GetStringUTFChars(jName, nullptr);
+        model->name = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, str);
+        env->ReleaseStringUTFChars(jName, str);
+    }
+
+    model->category = static_cast<rac_model_category_t>(env->GetIntField(modelInfo, ids.category));
+    model->format = static_cast<rac_model_format_t>(env->GetIntField(modelInfo, ids.format));
+    model->framework =
+        static_cast<rac_inference_framework_t>(env->GetIntField(modelInfo, ids.framework));
+
+    jstring jDownloadUrl = (jstring)env->GetObjectField(modelInfo, ids.download_url);
+    if (jDownloadUrl) {
+        const char* str = env->GetStringUTFChars(jDownloadUrl, nullptr);
+        model->download_url = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, str);
+        env->ReleaseStringUTFChars(jDownloadUrl, str);
+    }
+
+    jstring jLocalPath = (jstring)env->GetObjectField(modelInfo, ids.local_path);
+    if (jLocalPath) {
+        const char* str = env->GetStringUTFChars(jLocalPath, nullptr);
+        model->local_path = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, str);
+        env->ReleaseStringUTFChars(jLocalPath, str);
+    }
+
+    model->download_size = env->GetLongField(modelInfo, ids.download_size);
+    model->context_length = env->GetIntField(modelInfo, ids.context_length);
+    model->supports_thinking =
+        env->GetBooleanField(modelInfo, ids.supports_thinking) ? RAC_TRUE : RAC_FALSE;
+
+    jstring jDesc = (jstring)env->GetObjectField(modelInfo, ids.description);
+    if (jDesc) {
+        const char* str = env->GetStringUTFChars(jDesc, nullptr);
+        model->description = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, str);
+        env->ReleaseStringUTFChars(jDesc, str);
+    }
+
+    return model;
+}
+
+// Helper to convert C model info to JSON string for Kotlin
+static std::string modelInfoToJson(const rac_model_info_t* model) {
+    if (!model)
+        return "null";
+
+    std::string json = "{";
+    json += "\"model_id\":\"" + std::string(model->id ? model->id : "") + "\",";
+    json += "\"name\":\"" + std::string(model->name ? model->name : "") + "\",";
+    json += "\"category\":" + std::to_string(static_cast<int>(model->category)) + ",";
+    json += "\"format\":" + std::to_string(static_cast<int>(model->format)) + ",";
+    json += "\"framework\":" + std::to_string(static_cast<int>(model->framework)) + ",";
+    json += "\"download_url\":" +
+            (model->download_url ? ("\"" + std::string(model->download_url) + "\"") : "null") + ",";
+    json += "\"local_path\":" +
+            (model->local_path ? ("\"" + std::string(model->local_path) + "\"") : "null") + ",";
+    json += "\"download_size\":" + std::to_string(model->download_size) + ",";
+    json += "\"context_length\":" + std::to_string(model->context_length) + ",";
+    json +=
+        "\"supports_thinking\":" + std::string(model->supports_thinking ? "true" : "false") + ",";
+    json += "\"variant_of\":" +
+            (model->variant_of ? ("\"" + std::string(model->variant_of) + "\"") : "null") + ",";
+    json += "\"quantization\":" +
+            (model->quantization ? ("\"" + std::string(model->quantization) + "\"") : "null") + ",";
+    json += "\"expected_rtf\":" + std::to_string(model->expected_rtf) + ",";
+    json += "\"sha256\":" +
+            (model->sha256 ? ("\"" + std::string(model->sha256) + "\"") : "null") + ",";
+    json += "\"delta_manifest_url\":" +
+            (model->delta_manifest_url ? ("\"" + std::string(model->delta_manifest_url) + "\"")
+                                       : "null") +
+            ",";
+    json += "\"description\":" +
+            (model->description ? ("\"" + std::string(model->description) + "\"") : "null");
+    json += "}";
+
+    return json;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racModelRegistrySave(
+    JNIEnv* env, jclass clazz, jstring modelId, jstring name, jint category, jint format,
+    jint framework, jstring downloadUrl, jstring localPath, jlong downloadSize, jint contextLength,
+    jboolean supportsThinking, jstring description) {
+    LOGi("racModelRegistrySave called");
+
+    rac_model_registry_handle_t registry = rac_get_model_registry();
+    if (!registry) {
+        LOGe("Model registry not initialized");
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    // Allocate and populate model info
+    rac_model_info_t* model = rac_model_info_alloc();
+    if (!model) {
+        LOGe("Failed to allocate model info");
+        return RAC_ERROR_OUT_OF_MEMORY;
+    }
+
+    // Convert strings
+    const char* id_str = modelId ? env->GetStringUTFChars(modelId, nullptr) : nullptr;
+    const char* name_str = name ? env->GetStringUTFChars(name, nullptr) : nullptr;
+    const char* url_str = downloadUrl ? env->GetStringUTFChars(downloadUrl, nullptr) : nullptr;
+    const char* path_str = localPath ? env->GetStringUTFChars(localPath, nullptr) : nullptr;
+    const char* desc_str = description ? env->GetStringUTFChars(description, nullptr) : nullptr;
+
+    model->id = id_str ? rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, id_str) : nullptr;
+    model->name = name_str ? rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, name_str) : nullptr;
+    model->category = static_cast<rac_model_category_t>(category);
+    model->format = static_cast<rac_model_format_t>(format);
+    model->framework = static_cast<rac_inference_framework_t>(framework);
+    model->download_url = url_str ? rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, url_str) : nullptr;
+    model->local_path = path_str ? rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, path_str) : nullptr;
+    model->download_size = downloadSize;
+    model->context_length = contextLength;
+    model->supports_thinking = supportsThinking ? RAC_TRUE : RAC_FALSE;
+    model->description = desc_str ? rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, desc_str) : nullptr;
+
+    // Release Java strings
+    if (id_str)
+        env->ReleaseStringUTFChars(modelId, id_str);
+    if (name_str)
+        env->ReleaseStringUTFChars(name, name_str);
+    if (url_str)
+        env->ReleaseStringUTFChars(downloadUrl, url_str);
+    if (path_str)
+        env->ReleaseStringUTFChars(localPath, path_str);
+    if (desc_str)
+        env->ReleaseStringUTFChars(description, desc_str);
+
+    LOGi("Saving model to C++ registry: %s (framework=%d)", model->id, framework);
+
+    rac_result_t result = rac_model_registry_save(registry, model);
+
+    // Free the model info (registry makes a copy)
+    rac_model_info_free(model);
+
+    if (result != RAC_SUCCESS) {
+        LOGe("Failed to save model to registry: %d", result);
+    } else {
+        LOGi("Model saved to C++ registry successfully");
+    }
+
+    return static_cast<jint>(result);
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racModelRegistryGet(JNIEnv* env,
+                                                                             jclass clazz,
+                                                                             jstring modelId) {
+    if (!modelId)
+        return nullptr;
+
+    rac_model_registry_handle_t registry = rac_get_model_registry();
+    if (!registry) {
+        LOGe("Model registry not initialized");
+        return nullptr;
+    }
+
+    const char* id_str = env->GetStringUTFChars(modelId, nullptr);
+
+    // A view is enough to serialize the model
+    const rac_model_info_t* model = nullptr;
+    rac_result_t result = rac_model_registry_acquire(registry, id_str, &model);
+
+    env->ReleaseStringUTFChars(modelId, id_str);
+
+    if (result != RAC_SUCCESS || !model) {
+        return nullptr;
+    }
+
+    std::string json = modelInfoToJson(model);
+    rac_model_registry_release(registry, model);
+
+    return env->NewStringUTF(json.c_str());
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racModelRegistryGetAll(JNIEnv* env,
+                                                                                jclass clazz) {
+    rac_model_registry_handle_t registry = rac_get_model_registry();
+    if (!registry) {
+        LOGe("Model registry not initialized");
+        return env->NewStringUTF("[]");
+    }
+
+    // Serialized straight from a snapshot, without copying the models
+    rac_model_snapshot_handle_t snapshot = nullptr;
+    const rac_model_info_t* const* models = nullptr;
+    size_t count = 0;
+
+    rac_result_t result = rac_model_registry_snapshot(registry, &snapshot, &models, &count);
+
+    if (result != RAC_SUCCESS || !models || count == 0) {
+        rac_model_snapshot_release(snapshot);
+        return env->NewStringUTF("[]");
+    }
+
+    std::string json = "[";
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0)
+            json += ",";
+        json += modelInfoToJson(models[i]);
+    }
+    json += "]";
+
+    rac_model_snapshot_release(snapshot);
+
+    return env->NewStringUTF(json.c_str());
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racModelRegistryGetDownloaded(
+    JNIEnv* env, jclass clazz) {
+    rac_model_registry_handle_t registry = rac_get_model_registry();
+    if (!registry) {
+        return env->NewStringUTF("[]");
+    }
+
+    // Only the downloaded models are visited, through the snapshot's index
+    rac_model_query_t query = {};
+    query.downloaded_only = RAC_TRUE;
+    rac_model_snapshot_handle_t snapshot = nullptr;
+    const rac_model_info_t* const* models = nullptr;
+    size_t count = 0;
+
+    rac_result_t result =
+        rac_model_registry_snapshot_query(registry, &query, &snapshot, &models, &count);
+
+    if (result != RAC_SUCCESS) {
+        return env->NewStringUTF("[]");
+    }
+
+    std::string json = "[";
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0)
+            json += ",";
+        json += modelInfoToJson(models[i]);
+    }
+    json += "]";
+
+    rac_model_snapshot_release(snapshot);
+
+    return env->NewStringUTF(json.c_str());
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racModelRegistryRemove(JNIEnv* env,
+                                                                                jclass clazz,
+                                                                                jstring modelId) {
+    if (!modelId)
+        return RAC_ERROR_NULL_POINTER;
+
+    rac_model_registry_handle_t registry = rac_get_model_registry();
+    if (!registry) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    const char* id_str = env->GetStringUTFChars(modelId, nullptr);
+    rac_result_t result = rac_model_registry_remove(registry, id_str);
+    env->ReleaseStringUTFChars(modelId, id_str);
+
+    return static_cast<jint>(result);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racModelRegistryUpdateDownloadStatus(
+    JNIEnv* env, jclass clazz, jstring modelId, jstring localPath) {
+    if (!modelId)
+        return RAC_ERROR_NULL_POINTER;
+
+    rac_model_registry_handle_t registry = rac_get_model_registry();
+    if (!registry) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    const char* id_str = env->GetStringUTFChars(modelId, nullptr);
+    const char* path_str = localPath ? env->GetStringUTFChars(localPath, nullptr) : nullptr;
+
+    LOGi("Updating download status: %s -> %s", id_str, path_str ? path_str : "null");
+
+    rac_result_t result = rac_model_registry_update_download_status(registry, id_str, path_str);
+
+    env->ReleaseStringUTFChars(modelId, id_str);
+    if (path_str)
+        env->ReleaseStringUTFChars(localPath, path_str);
+
+    return static_cast<jint>(result);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racModelRegistryOpenIndex(
+    JNIEnv* env, jclass clazz, jstring indexPath) {
+    if (!indexPath)
+        return RAC_ERROR_NULL_POINTER;
+
+    rac_model_registry_handle_t registry = rac_get_model_registry();
+    if (!registry) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    const char* path_str = env->GetStringUTFChars(indexPath, nullptr);
+    rac_result_t result = rac_model_registry_open_index(registry, path_str);
+    env->ReleaseStringUTFChars(indexPath, path_str);
+
+    return static_cast<jint>(result);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racModelRegistryFlushIndex(
+    JNIEnv* env, jclass clazz) {
+    rac_model_registry_handle_t registry = rac_get_model_registry();
+    if (!registry) {
+        return RAC_ERROR_NOT_INITIALIZED;
+    }
+
+    return static_cast<jint>(rac_model_registry_flush_index(registry));
+}
+
+// =============================================================================
+// JNI FUNCTIONS - Model Assignment (rac_model_assignment.h)
+// =============================================================================
+// Mirrors Swift SDK's CppBridge+ModelAssignment.swift
+
+// Global state for model assignment callbacks
+// NOTE: Using recursive_mutex to allow callback re-entry during auto_fetch
+// The flow is: setCallbacks() -> rac_model_assignment_set_callbacks() -> fetch() -> http_get_callback()
+// All on the same thread, so a recursive mutex is required
+static struct {
+    JavaVM* jvm;
+    jobject callback_obj;
+    jmethodID http_get_method;
+    std::recursive_mutex mutex;  // Must be recursive to allow callback during auto_fetch
+    bool callbacks_registered;
+} g_model_assignment_state = {nullptr, nullptr, nullptr, {}, false};
+
+// HTTP GET callback for model assignment (called from C++)
+static rac_result_t model_assignment_http_get_callback(const char* endpoint,
+                                                        rac_bool_t requires_auth,
+                                                        rac_assignment_http_response_t* out_response,
+                                                        void* user_data) {
+    std::lock_guard<std::recursive_mutex> lock(g_model_assignment_state.mutex);
+
+    if (!g_model_assignment_state.jvm || !g_model_assignment_state.callback_obj) {
+        LOGe("model_assignment_http_get_callback: callbacks not registered");
+        if (out_response) {
+            out_response->result = RAC_ERROR_INVALID_STATE;
+        }
+        return RAC_ERROR_INVALID_STATE;
+    }
+
+    JNIEnv* env = getThreadEnv(g_model_assignment_state.jvm);
+    if (env == nullptr) {
+        LOGe("model_assignment_http_get_callback: failed to attach thread");
+        if (out_response) {
+            out_response->result = RAC_ERROR_INVALID_STATE;
+        }
+        return RAC_ERROR_INVALID_STATE;
+    }
+
+    // Call Kotlin callback: httpGet(endpoint: String, requiresAuth: Boolean): String
+    jstring jEndpoint = env->NewStringUTF(endpoint ? endpoint : "");
+    jboolean jRequiresAuth = requires_auth == RAC_TRUE ? JNI_TRUE : JNI_FALSE;
+
+    jstring jResponse =
+        (jstring)env->CallObjectMethod(g_model_assignment_state.callback_obj,
+                                       g_model_assignment_state.http_get_method, jEndpoint, jRequiresAuth);
+
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        LOGe("model_assignment_http_get_callback: exception in Kotlin callback");
+        env->DeleteLocalRef(jEndpoint);
+        if (out_response) {
+            out_response->result = RAC_ERROR_HTTP_REQUEST_FAILED;
+        }
+        return RAC_ERROR_HTTP_REQUEST_FAILED;
+    }
+
+    rac_result_t result = RAC_SUCCESS;
+    if (jResponse) {
+        const char* response_str = env->GetStringUTFChars(jResponse, nullptr);
+        if (response_str && out_response) {
+            // Check if response is an error (starts with "ERROR:")
+            if (strncmp(response_str, "ERROR:", 6) == 0) {
+                out_response->result = RAC_ERROR_HTTP_REQUEST_FAILED;
+                out_response->error_message =
+                    rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, response_str + 6);
+                result = RAC_ERROR_HTTP_REQUEST_FAILED;
+            } else {
+                out_response->result = RAC_SUCCESS;
+                out_response->status_code = 200;
+                out_response->response_body = rac_strdup_tagged(RAC_ALLOC_TAG_MODEL, response_str);
+                out_response->response_length = strlen(response_str);
+            }
+        }
+        env->ReleaseStringUTFChars(jResponse, response_str);
+        env->DeleteLocalRef(jResponse);
+    } else {
+        if (out_response) {
+            out_response->result = RAC_ERROR_HTTP_REQUEST_FAILED;
+        }
+        result = RAC_ERROR_HTTP_REQUEST_FAILED;
+    }
+
+    env->DeleteLocalRef(jEndpoint);
+
+    return result;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racModelAssignmentSetCallbacks(
+    JNIEnv* env, jclass clazz, jobject callback, jboolean autoFetch) {
+    LOGi("racModelAssignmentSetCallbacks called, autoFetch=%d", autoFetch);
+
+    std::lock_guard<std::recursive_mutex> lock(g_model_assignment_state.mutex);
+
+    // Clear previous callback if any
+    if (g_model_assignment_state.callback_obj) {
+        JNIEnv* env_local = nullptr;
+        if (g_model_assignment_state.jvm &&
+            g_model_assignment_state.jvm->GetEnv((void**)&env_local, JNI_VERSION_1_6) == JNI_OK) {
+            env_local->DeleteGlobalRef(g_model_assignment_state.callback_obj);
+        }
+        g_model_assignment_state.callback_obj = nullptr;
+    }
+
+    if (!callback) {
+        // Just clearing callbacks
+        g_model_assignment_state.callbacks_registered = false;
+        LOGi("racModelAssignmentSetCallbacks: callbacks cleared");
+        return RAC_SUCCESS;
+    }
+
+    // Store JVM reference
+    env->GetJavaVM(&g_model_assignment_state.jvm);
+
+    // Create global reference to callback object
+    g_model_assignment_state.callback_obj = env->NewGlobalRef(callback);
+
+    // Get method IDs
+    jclass callback_class = env->GetObjectClass(callback);
+    g_model_assignment_state.http_get_method =
+        env->GetMethodID(callback_class, "httpGet", "(Ljava/lang/String;Z)Ljava/lang/String;");
+    env->DeleteLocalRef(callback_class);
+
+    if (!g_model_assignment_state.http_get_method) {
+        LOGe("racModelAssignmentSetCallbacks: failed to get httpGet method ID");
+        env->DeleteGlobalRef(g_model_assignment_state.callback_obj);
+        g_model_assignment_state.callback_obj = nullptr;
+        return RAC_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Set up C++ callbacks
+    rac_assignment_callbacks_t callbacks = {};
+    callbacks.http_get = model_assignment_http_get_callback;
+    callbacks.user_data = nullptr;
+    callbacks.auto_fetch = autoFetch ? RAC_TRUE : RAC_FALSE;
+    callbacks.on_telemetry_policy = jni_telemetry_policy_callback;
+
+    rac_result_t result = rac_model_assignment_set_callbacks(&callbacks);
+
+    if (result == RAC_SUCCESS) {
+        g_model_assignment_state.callbacks_registered = true;
+        LOGi("racModelAssignmentSetCallbacks: registered successfully");
+    } else {
+        LOGe("racModelAssignmentSetCallbacks: failed with code %d", result);
+        env->DeleteGlobalRef(g_model_assignment_state.callback_obj);
+        g_model_assignment_state.callback_obj = nullptr;
+    }
+
+    return static_cast<jint>(result);
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racModelAssignmentFetch(
+    JNIEnv* env, jclass clazz, jboolean forceRefresh) {
+    LOGi("racModelAssignmentFetch called, forceRefresh=%d", forceRefresh);
+
+    rac_model_info_t** models = nullptr;
+    size_t count = 0;
+
+    rac_result_t result =
+        rac_model_assignment_fetch(forceRefresh ? RAC_TRUE : RAC_FALSE, &models, &count);
+
+    if (result != RAC_SUCCESS) {
+        LOGe("racModelAssignmentFetch: failed with code %d", result);
+        return env->NewStringUTF("[]");
+    }
+
+    // Build JSON array of models
+    std::string json = "[";
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) json += ",";
+
+        rac_model_info_t* m = models[i];
+        json += "{";
+        json += "\"id\":\"" + std::string(m->id ? m->id : "") + "\",";
+        json += "\"name\":\"" + std::string(m->name ? m->name : "") + "\",";
+        json += "\"category\":" + std::to_string(m->category) + ",";
+        json += "\"format\":" + std::to_string(m->format) + ",";
+        json += "\"framework\":" + std::to_string(m->framework) + ",";
+        json += "\"downloadUrl\":\"" + std::string(m->download_url ? m->download_url : "") + "\",";
+        json += "\"downloadSize\":" + std::to_string(m->download_size) + ",";
+        json += "\"contextLength\":" + std::to_string(m->context_length) + ",";
+        json +=
+            "\"supportsThinking\":" + std::string(m->supports_thinking == RAC_TRUE ? "true" : "false");
+        json += "}";
+    }
+    json += "]";
+
+    // Free models array
+    if (models) {
+        rac_model_info_array_free(models, count);
+    }
+
+    LOGi("racModelAssignmentFetch: returned %zu models", count);
+    return env->NewStringUTF(json.c_str());
+}
+
+}  // extern "C"
@@ -0,0 +1,361 @@
+/**
+ * RunAnywhere Commons JNI Bridge - STT Component
+ *
+ * STT component lifecycle and transcription.
+ */
+
+#include "jni_common.h"
+
+#include <cstdlib>
+#include <string>
+
+#include "rac/core/rac_core.h"
+#include "rac/features/stt/rac_stt_component.h"
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+// STT options from the Kotlin config JSON (only sample_rate is read)
+rac_stt_options_t sttOptionsFromConfig(JNIEnv* env, jstring configJson) {
+    // Use default options which properly initializes sample_rate to 16000
+    rac_stt_options_t options = RAC_STT_OPTIONS_DEFAULT;
+
+    // Parse configJson to override sample_rate if provided
+    if (configJson != nullptr) {
+        const char* json = env->GetStringUTFChars(configJson, nullptr);
+        if (json != nullptr) {
+            // Simple JSON parsing for sample_rate
+            const char* sample_rate_key = "\"sample_rate\":";
+            const char* pos = strstr(json, sample_rate_key);
+            if (pos != nullptr) {
+                pos += strlen(sample_rate_key);
+                int sample_rate = atoi(pos);
+                if (sample_rate > 0) {
+                    options.sample_rate = sample_rate;
+                    LOGd("Using sample_rate from config: %d", sample_rate);
+                }
+            }
+            env->ReleaseStringUTFChars(configJson, json);
+        }
+    }
+    return options;
+}
+
+// STT result as the JSON the Kotlin bridge expects
+std::string sttResultToJson(const rac_stt_result_t& result) {
+    std::string json_result = "{";
+    json_result += "\"text\":\"";
+    if (result.text != nullptr) {
+        // Escape special characters in text
+        for (const char* p = result.text; *p; ++p) {
+            switch (*p) {
+                case '"':
+                    json_result += "\\\"";
+                    break;
+                case '\\':
+                    json_result += "\\\\";
+                    break;
+                case '\n':
+                    json_result += "\\n";
+                    break;
+                case '\r':
+                    json_result += "\\r";
+                    break;
+                case '\t':
+                    json_result += "\\t";
+                    break;
+                default:
+                    json_result += *p;
+                    break;
+            }
+        }
+    }
+    json_result += "\",";
+    json_result += "\"language\":\"" +
+                   std::string(result.detected_language ? result.detected_language : "en") + "\",";
+    json_result += "\"duration_ms\":" + std::to_string(result.processing_time_ms) + ",";
+    json_result += "\"completion_reason\":1,";  // END_OF_AUDIO
+    json_result += "\"confidence\":" + std::to_string(result.confidence);
+    json_result += "}";
+    return json_result;
+}
+
+extern "C" {
+
+// =============================================================================
+// JNI FUNCTIONS - STT Component
+// =============================================================================
+
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentCreate(JNIEnv* env,
+                                                                               jclass clazz) {
+    rac_handle_t handle = RAC_INVALID_HANDLE;
+    rac_result_t result = rac_stt_component_create(&handle);
+    if (result != RAC_SUCCESS) {
+        LOGe("Failed to create STT component: %d", result);
+        return 0;
+    }
+    return reinterpret_cast<jlong>(handle);
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentDestroy(JNIEnv* env,
+                                                                                jclass clazz,
+                                                                                jlong handle) {
+    if (handle != 0) {
+        rac_stt_component_destroy(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentLoadModel(
+    JNIEnv* env, jclass clazz, jlong handle, jstring modelPath, jstring modelId,
+    jstring modelName) {
+    LOGi("racSttComponentLoadModel called with handle=%lld", (long long)handle);
+    if (handle == 0)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    std::string path = getCString(env, modelPath);
+    std::string id = getCString(env, modelId);
+    std::string name = getCString(env, modelName);
+    LOGi("racSttComponentLoadModel path=%s, id=%s, name=%s", path.c_str(), id.c_str(),
+         name.c_str());
+
+    // Debug: List registered providers BEFORE loading
+    const char** provider_names = nullptr;
+    size_t provider_count = 0;
+    rac_result_t list_result =
+        rac_service_list_providers(RAC_CAPABILITY_STT, &provider_names, &provider_count);
+    LOGi("Before load_model - STT providers: count=%zu, list_result=%d", provider_count,
+         list_result);
+    if (provider_names && provider_count > 0) {
+        for (size_t i = 0; i < provider_count; i++) {
+            LOGi("  Provider[%zu]: %s", i, provider_names[i] ? provider_names[i] : "NULL");
+        }
+    } else {
+        LOGw("NO providers registered for STT!");
+    }
+
+    // Pass model_path, model_id, and model_name separately to C++ lifecycle
+    rac_result_t result = rac_stt_component_load_model(
+        reinterpret_cast<rac_handle_t>(handle),
+        path.c_str(),                          // model_path
+        id.c_str(),                            // model_id (for telemetry)
+        name.empty() ? nullptr : name.c_str()  // model_name (optional, for telemetry)
+    );
+    LOGi("rac_stt_component_load_model returned: %d", result);
+
+    return static_cast<jint>(result);
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentUnload(JNIEnv* env,
+                                                                               jclass clazz,
+                                                                               jlong handle) {
+    if (handle != 0) {
+        rac_stt_component_unload(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentTranscribe(
+    JNIEnv* env, jclass clazz, jlong handle, jbyteArray audioData, jstring configJson) {
+    if (handle == 0 || audioData == nullptr)
+        return nullptr;
+
+    jsize len = env->GetArrayLength(audioData);
+    jbyte* data = env->GetByteArrayElements(audioData, nullptr);
+
+    rac_stt_options_t options = sttOptionsFromConfig(env, configJson);
+
+    LOGd("STT transcribe: %d bytes, sample_rate=%d", (int)len, options.sample_rate);
+
+    rac_stt_result_t result = {};
+
+    // Audio data is 16-bit PCM (ByteArray from Android AudioRecord)
+    // Pass the raw bytes - the audio_format in options tells C++ how to interpret it
+    rac_result_t status = rac_stt_component_transcribe(reinterpret_cast<rac_handle_t>(handle),
+                                                       data,  // Pass raw bytes (void*)
+                                                       static_cast<size_t>(len),  // Size in bytes
+                                                       &options, &result);
+
+    env->ReleaseByteArrayElements(audioData, data, JNI_ABORT);
+
+    if (status != RAC_SUCCESS) {
+        LOGe("STT transcribe failed with status: %d", status);
+        return nullptr;
+    }
+
+    std::string json_result = sttResultToJson(result);
+    rac_stt_result_free(&result);
+
+    LOGd("STT transcribe result: %s", json_result.c_str());
+    return env->NewStringUTF(json_result.c_str());
+}
+
+// Transcribes the first `length` bytes of a DirectByteBuffer in place, so mic
+// audio reaches the backend without a JNI array copy. Same result as
+// racSttComponentTranscribe.
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentTranscribeDirect(
+    JNIEnv* env, jclass clazz, jlong handle, jobject directBuffer, jint length,
+    jstring configJson) {
+    if (handle == 0 || directBuffer == nullptr || length < 0)
+        return nullptr;
+
+    void* data = env->GetDirectBufferAddress(directBuffer);
+    jlong capacity = env->GetDirectBufferCapacity(directBuffer);
+    if (data == nullptr || length > capacity)
+        return nullptr;
+
+    rac_stt_options_t options = sttOptionsFromConfig(env, configJson);
+    rac_stt_result_t result = {};
+    rac_result_t status = rac_stt_component_transcribe(reinterpret_cast<rac_handle_t>(handle),
+                                                       data, static_cast<size_t>(length),
+                                                       &options, &result);
+    if (status != RAC_SUCCESS) {
+        LOGe("STT transcribe failed with status: %d", status);
+        return nullptr;
+    }
+
+    std::string json_result = sttResultToJson(result);
+    rac_stt_result_free(&result);
+    return env->NewStringUTF(json_result.c_str());
+}
+
+// Transcribes a DirectByteBuffer of audio into a second DirectByteBuffer, with
+// the sample rate passed as an argument (non-positive keeps 16000) instead of
+// JSON config. Returns the bytes written or a negative rac_result_t. Record
+// layout:
+//   int32 version, float confidence, int64 processing_time_ms, string text,
+//   string language, int32 word_count, then per word:
+//   int64 start_ms, int64 end_ms, float confidence, string text
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentTranscribeInto(
+    JNIEnv* env, jclass clazz, jlong handle, jobject audioBuffer, jint length, jint sampleRate,
+    jobject resultBuffer) {
+    void* audio = nullptr;
+    size_t audio_capacity = 0;
+    void* buffer = nullptr;
+    size_t capacity = 0;
+    if (handle == 0 || length < 0 || !getDirectBuffer(env, audioBuffer, &audio, &audio_capacity) ||
+        !getDirectBuffer(env, resultBuffer, &buffer, &capacity) ||
+        static_cast<size_t>(length) > audio_capacity)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    rac_stt_options_t options = RAC_STT_OPTIONS_DEFAULT;
+    if (sampleRate > 0) {
+        options.sample_rate = sampleRate;
+    }
+
+    rac_stt_result_t result = {};
+    rac_result_t status = rac_stt_component_transcribe(reinterpret_cast<rac_handle_t>(handle),
+                                                       audio, static_cast<size_t>(length),
+                                                       &options, &result);
+    if (status != RAC_SUCCESS) {
+        LOGe("STT transcribe failed with status: %d", status);
+        return static_cast<jlong>(status);
+    }
+
+    BinaryWriter writer(buffer, capacity);
+    writer.i32(kBinaryLayoutVersion);
+    writer.f32(result.confidence);
+    writer.i64(result.processing_time_ms);
+    writer.str(result.text);
+    writer.str(result.detected_language ? result.detected_language : "en");
+    writer.i32(result.words != nullptr ? static_cast<int32_t>(result.num_words) : 0);
+    for (size_t i = 0; result.words != nullptr && i < result.num_words; ++i) {
+        const rac_stt_word_t& word = result.words[i];
+        writer.i64(word.start_ms);
+        writer.i64(word.end_ms);
+        writer.f32(word.confidence);
+        writer.str(word.text);
+    }
+    rac_stt_result_free(&result);
+    return finishBinaryRecord(writer, "STT result");
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentTranscribeFile(
+    JNIEnv* env, jclass clazz, jlong handle, jstring audioPath, jstring configJson) {
+    if (handle == 0 || audioPath == nullptr)
+        return nullptr;
+
+    std::string path = getCString(env, audioPath);
+    rac_stt_options_t options = sttOptionsFromConfig(env, configJson);
+
+    LOGd("STT transcribe file: %s", path.c_str());
+
+    rac_stt_result_t result = {};
+    rac_result_t status = rac_stt_component_transcribe_file(reinterpret_cast<rac_handle_t>(handle),
+                                                            path.c_str(), &options, &result);
+    if (status != RAC_SUCCESS) {
+        LOGe("STT transcribe file failed with status: %d", status);
+        return nullptr;
+    }
+
+    std::string json_result = sttResultToJson(result);
+    rac_stt_result_free(&result);
+    return env->NewStringUTF(json_result.c_str());
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentTranscribeStream(
+    JNIEnv* env, jclass clazz, jlong handle, jbyteArray audioData, jstring configJson) {
+    return Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentTranscribe(
+        env, clazz, handle, audioData, configJson);
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentCancel(JNIEnv* env,
+                                                                               jclass clazz,
+                                                                               jlong handle) {
+    // STT component doesn't have a cancel method, just unload
+    if (handle != 0) {
+        rac_stt_component_unload(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentGetState(JNIEnv* env,
+                                                                                 jclass clazz,
+                                                                                 jlong handle) {
+    if (handle == 0)
+        return 0;
+    return static_cast<jint>(rac_stt_component_get_state(reinterpret_cast<rac_handle_t>(handle)));
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentIsLoaded(JNIEnv* env,
+                                                                                 jclass clazz,
+                                                                                 jlong handle) {
+    if (handle == 0)
+        return JNI_FALSE;
+    return rac_stt_component_is_loaded(reinterpret_cast<rac_handle_t>(handle)) ? JNI_TRUE
+                                                                               : JNI_FALSE;
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentGetLanguages(JNIEnv* env,
+                                                                                     jclass clazz,
+                                                                                     jlong handle) {
+    // Return empty array for now
+    return env->NewStringUTF("[]");
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttComponentDetectLanguage(
+    JNIEnv* env, jclass clazz, jlong handle, jbyteArray audioData) {
+    // Return null for now - language detection not implemented
+    return nullptr;
+}
+
+JNIEXPORT void JNICALL Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racSttSetCallbacks(
+    JNIEnv* env, jclass clazz, jobject partialCallback, jobject progressCallback) {
+    // TODO: Implement callback registration
+}
+
+}  // extern "C"
@@ -0,0 +1,546 @@
+/**
+ * RunAnywhere Commons JNI Bridge - Telemetry, Metrics and Analytics
+ *
+ * Telemetry manager, metrics snapshots and analytics event routing.
+ */
+
+#include "jni_common.h"
+
+#include <mutex>
+#include <string>
+
+#include "rac/core/rac_analytics_events.h"
+#include "rac/core/rac_metrics.h"
+#include "rac/infrastructure/telemetry/rac_telemetry_manager.h"
+#include "rac/infrastructure/telemetry/rac_telemetry_types.h"
+
+// =============================================================================
+// Telemetry State
+// =============================================================================
+
+// Global state for telemetry
+static struct {
+    rac_telemetry_manager_t* manager;
+    jobject http_callback_obj;
+    jmethodID http_callback_method;
+    std::mutex mtx;
+} g_telemetry_jni_state = {};
+
+// Telemetry policy from the model assignment response
+void jni_telemetry_policy_callback(const char* policy_json, size_t length, void* /*user_data*/) {
+    std::lock_guard<std::mutex> lock(g_telemetry_jni_state.mtx);
+    if (g_telemetry_jni_state.manager) {
+        rac_telemetry_manager_set_policy_json(g_telemetry_jni_state.manager, policy_json, length);
+    }
+}
+
+extern "C" {
+
+// =============================================================================
+// JNI FUNCTIONS - Telemetry Manager (rac_telemetry_manager.h)
+// =============================================================================
+// Mirrors Swift SDK's CppBridge+Telemetry.swift
+
+// Telemetry HTTP callback from C++ to Java
+static void jni_telemetry_http_callback(void* user_data, const char* endpoint,
+                                        const char* json_body, size_t json_length,
+                                        rac_bool_t requires_auth) {
+    if (!g_jvm || !g_telemetry_jni_state.http_callback_obj ||
+        !g_telemetry_jni_state.http_callback_method) {
+        LOGw("jni_telemetry_http_callback: JNI not ready");
+        return;
+    }
+
+    // Runs on the telemetry flusher thread, which stays attached until it exits
+    JNIEnv* env = getThreadEnv(g_jvm);
+    if (env == nullptr) {
+        LOGw("jni_telemetry_http_callback: failed to attach thread");
+        return;
+    }
+
+    jstring jEndpoint = env->NewStringUTF(endpoint ? endpoint : "");
+    jstring jBody = env->NewStringUTF(json_body ? json_body : "");
+
+    // Check for NewStringUTF allocation failures
+    if (!jEndpoint || !jBody) {
+        LOGe("jni_telemetry_http_callback: failed to allocate JNI strings");
+        if (jEndpoint)
+            env->DeleteLocalRef(jEndpoint);
+        if (jBody)
+            env->DeleteLocalRef(jBody);
+        return;
+    }
+
+    env->CallVoidMethod(g_telemetry_jni_state.http_callback_obj,
+                        g_telemetry_jni_state.http_callback_method, jEndpoint, jBody,
+                        static_cast<jint>(json_length),
+                        requires_auth == RAC_TRUE ? JNI_TRUE : JNI_FALSE);
+
+    // Check for Java exception after CallVoidMethod
+    if (env->ExceptionCheck()) {
+        LOGe("jni_telemetry_http_callback: Java exception occurred in HTTP callback");
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+
+    // Always clean up local references
+    env->DeleteLocalRef(jEndpoint);
+    env->DeleteLocalRef(jBody);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTelemetryManagerCreate(
+    JNIEnv* env, jclass clazz, jint environment, jstring deviceId, jstring platform,
+    jstring sdkVersion) {
+    LOGi("racTelemetryManagerCreate called (env=%d)", environment);
+
+    std::string deviceIdStr = getCString(env, deviceId);
+    std::string platformStr = getCString(env, platform);
+    std::string versionStr = getCString(env, sdkVersion);
+
+    std::lock_guard<std::mutex> lock(g_telemetry_jni_state.mtx);
+
+    // Destroy existing manager if any
+    if (g_telemetry_jni_state.manager) {
+        rac_telemetry_manager_destroy(g_telemetry_jni_state.manager);
+    }
+
+    g_telemetry_jni_state.manager =
+        rac_telemetry_manager_create(static_cast<rac_environment_t>(environment),
+                                     deviceIdStr.c_str(), platformStr.c_str(), versionStr.c_str());
+
+    LOGi("racTelemetryManagerCreate: manager=%p", (void*)g_telemetry_jni_state.manager);
+    return reinterpret_cast<jlong>(g_telemetry_jni_state.manager);
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTelemetryManagerDestroy(JNIEnv* env,
+                                                                                    jclass clazz,
+                                                                                    jlong handle) {
+    LOGi("racTelemetryManagerDestroy called");
+
+    std::lock_guard<std::mutex> lock(g_telemetry_jni_state.mtx);
+
+    if (handle != 0 &&
+        reinterpret_cast<rac_telemetry_manager_t*>(handle) == g_telemetry_jni_state.manager) {
+        // Flush before destroying
+        rac_telemetry_manager_flush(g_telemetry_jni_state.manager);
+        rac_telemetry_manager_destroy(g_telemetry_jni_state.manager);
+        g_telemetry_jni_state.manager = nullptr;
+
+        // Clean up callback
+        if (g_telemetry_jni_state.http_callback_obj) {
+            env->DeleteGlobalRef(g_telemetry_jni_state.http_callback_obj);
+            g_telemetry_jni_state.http_callback_obj = nullptr;
+        }
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTelemetryManagerSetDeviceInfo(
+    JNIEnv* env, jclass clazz, jlong handle, jstring deviceModel, jstring osVersion) {
+    if (handle == 0)
+        return;
+
+    std::string modelStr = getCString(env, deviceModel);
+    std::string osStr = getCString(env, osVersion);
+
+    rac_telemetry_manager_set_device_info(reinterpret_cast<rac_telemetry_manager_t*>(handle),
+                                          modelStr.c_str(), osStr.c_str());
+
+    LOGi("racTelemetryManagerSetDeviceInfo: model=%s, os=%s", modelStr.c_str(), osStr.c_str());
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTelemetryManagerSetHttpCallback(
+    JNIEnv* env, jclass clazz, jlong handle, jobject callback) {
+    LOGi("racTelemetryManagerSetHttpCallback called");
+
+    if (handle == 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(g_telemetry_jni_state.mtx);
+
+    // Clean up previous callback
+    if (g_telemetry_jni_state.http_callback_obj) {
+        env->DeleteGlobalRef(g_telemetry_jni_state.http_callback_obj);
+        g_telemetry_jni_state.http_callback_obj = nullptr;
+    }
+
+    if (callback) {
+        g_telemetry_jni_state.http_callback_obj = env->NewGlobalRef(callback);
+
+        // Cache method ID
+        jclass cls = env->GetObjectClass(callback);
+        g_telemetry_jni_state.http_callback_method =
+            env->GetMethodID(cls, "onHttpRequest", "(Ljava/lang/String;Ljava/lang/String;IZ)V");
+        env->DeleteLocalRef(cls);
+
+        // Register C callback with telemetry manager
+        rac_telemetry_manager_set_http_callback(reinterpret_cast<rac_telemetry_manager_t*>(handle),
+                                                jni_telemetry_http_callback, nullptr);
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTelemetryManagerFlush(JNIEnv* env,
+                                                                                  jclass clazz,
+                                                                                  jlong handle) {
+    LOGi("racTelemetryManagerFlush called");
+
+    if (handle == 0)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    return static_cast<jint>(
+        rac_telemetry_manager_flush(reinterpret_cast<rac_telemetry_manager_t*>(handle)));
+}
+
+// =============================================================================
+// JNI FUNCTIONS - Metrics (rac_metrics.h)
+// =============================================================================
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racMetricsSnapshotJson(JNIEnv* env,
+                                                                                jclass clazz) {
+    char* json = nullptr;
+    if (rac_metrics_snapshot_json(&json) != RAC_SUCCESS || !json) {
+        return nullptr;
+    }
+    jstring result = env->NewStringUTF(json);
+    rac_free(json);
+    return result;
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racMetricsReset(JNIEnv* env,
+                                                                         jclass clazz) {
+    rac_metrics_reset();
+}
+
+// =============================================================================
+// JNI FUNCTIONS - Analytics Events (rac_analytics_events.h)
+// =============================================================================
+
+// Global telemetry manager pointer for analytics callback routing
+// The C callback routes events directly to the telemetry manager (same as Swift)
+static rac_telemetry_manager_t* g_analytics_telemetry_manager = nullptr;
+static std::mutex g_analytics_telemetry_mutex;
+
+// C callback that routes analytics events to telemetry manager
+// This mirrors Swift's analyticsEventCallback -> Telemetry.trackAnalyticsEvent()
+static void jni_analytics_event_callback(rac_event_type_t type,
+                                         const rac_analytics_event_data_t* data, void* user_data) {
+    LOGi("jni_analytics_event_callback called: event_type=%d", type);
+
+    std::lock_guard<std::mutex> lock(g_analytics_telemetry_mutex);
+    if (g_analytics_telemetry_manager && data) {
+        LOGi("jni_analytics_event_callback: routing to telemetry manager");
+        rac_telemetry_manager_track_analytics(g_analytics_telemetry_manager, type, data);
+    } else {
+        LOGw("jni_analytics_event_callback: manager=%p, data=%p",
+             (void*)g_analytics_telemetry_manager, (void*)data);
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventsSetCallback(
+    JNIEnv* env, jclass clazz, jlong telemetryHandle) {
+    LOGi("racAnalyticsEventsSetCallback called (telemetryHandle=%lld)", (long long)telemetryHandle);
+
+    std::lock_guard<std::mutex> lock(g_analytics_telemetry_mutex);
+
+    if (telemetryHandle != 0) {
+        // Store telemetry manager and register C callback
+        g_analytics_telemetry_manager = reinterpret_cast<rac_telemetry_manager_t*>(telemetryHandle);
+        rac_result_t result =
+            rac_analytics_events_set_callback(jni_analytics_event_callback, nullptr);
+        LOGi("Analytics callback registered, result=%d", result);
+        return static_cast<jint>(result);
+    } else {
+        // Unregister callback
+        g_analytics_telemetry_manager = nullptr;
+        rac_result_t result = rac_analytics_events_set_callback(nullptr, nullptr);
+        LOGi("Analytics callback unregistered, result=%d", result);
+        return static_cast<jint>(result);
+    }
+}
+
+// =============================================================================
+// JNI FUNCTIONS - Analytics Event Emission
+// =============================================================================
+// These functions allow Kotlin to emit analytics events (e.g., SDK lifecycle events
+// that originate from Kotlin code). They call rac_analytics_event_emit() which
+// routes events through the registered callback to the telemetry manager.
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventEmitDownload(
+    JNIEnv* env, jclass clazz, jint eventType, jstring modelId, jdouble progress,
+    jlong bytesDownloaded, jlong totalBytes, jdouble durationMs, jlong sizeBytes,
+    jstring archiveType, jint errorCode, jstring errorMessage) {
+    std::string modelIdStr = getCString(env, modelId);
+    std::string archiveTypeStorage;
+    std::string errorMsgStorage;
+    const char* archiveTypePtr = getNullableCString(env, archiveType, archiveTypeStorage);
+    const char* errorMsgPtr = getNullableCString(env, errorMessage, errorMsgStorage);
+
+    rac_analytics_event_data_t event_data = {};
+    event_data.type = static_cast<rac_event_type_t>(eventType);
+    event_data.data.model_download.model_id = modelIdStr.c_str();
+    event_data.data.model_download.progress = progress;
+    event_data.data.model_download.bytes_downloaded = bytesDownloaded;
+    event_data.data.model_download.total_bytes = totalBytes;
+    event_data.data.model_download.duration_ms = durationMs;
+    event_data.data.model_download.size_bytes = sizeBytes;
+    event_data.data.model_download.archive_type = archiveTypePtr;
+    event_data.data.model_download.error_code = static_cast<rac_result_t>(errorCode);
+    event_data.data.model_download.error_message = errorMsgPtr;
+
+    rac_analytics_event_emit(event_data.type, &event_data);
+    return RAC_SUCCESS;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventEmitSdkLifecycle(
+    JNIEnv* env, jclass clazz, jint eventType, jdouble durationMs, jint count, jint errorCode,
+    jstring errorMessage) {
+    std::string errorMsgStorage;
+    const char* errorMsgPtr = getNullableCString(env, errorMessage, errorMsgStorage);
+
+    rac_analytics_event_data_t event_data = {};
+    event_data.type = static_cast<rac_event_type_t>(eventType);
+    event_data.data.sdk_lifecycle.duration_ms = durationMs;
+    event_data.data.sdk_lifecycle.count = count;
+    event_data.data.sdk_lifecycle.error_code = static_cast<rac_result_t>(errorCode);
+    event_data.data.sdk_lifecycle.error_message = errorMsgPtr;
+
+    rac_analytics_event_emit(event_data.type, &event_data);
+    return RAC_SUCCESS;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventEmitStorage(
+    JNIEnv* env, jclass clazz, jint eventType, jlong freedBytes, jint errorCode,
+    jstring errorMessage) {
+    std::string errorMsgStorage;
+    const char* errorMsgPtr = getNullableCString(env, errorMessage, errorMsgStorage);
+
+    rac_analytics_event_data_t event_data = {};
+    event_data.type = static_cast<rac_event_type_t>(eventType);
+    event_data.data.storage.freed_bytes = freedBytes;
+    event_data.data.storage.error_code = static_cast<rac_result_t>(errorCode);
+    event_data.data.storage.error_message = errorMsgPtr;
+
+    rac_analytics_event_emit(event_data.type, &event_data);
+    return RAC_SUCCESS;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventEmitDevice(
+    JNIEnv* env, jclass clazz, jint eventType, jstring deviceId, jint errorCode,
+    jstring errorMessage) {
+    std::string deviceIdStr = getCString(env, deviceId);
+    std::string errorMsgStorage;
+    const char* errorMsgPtr = getNullableCString(env, errorMessage, errorMsgStorage);
+
+    rac_analytics_event_data_t event_data = {};
+    event_data.type = static_cast<rac_event_type_t>(eventType);
+    event_data.data.device.device_id = deviceIdStr.c_str();
+    event_data.data.device.error_code = static_cast<rac_result_t>(errorCode);
+    event_data.data.device.error_message = errorMsgPtr;
+
+    rac_analytics_event_emit(event_data.type, &event_data);
+    return RAC_SUCCESS;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventEmitSdkError(
+    JNIEnv* env, jclass clazz, jint eventType, jint errorCode, jstring errorMessage,
+    jstring operation, jstring context) {
+    std::string errorMsgStorage, opStorage, ctxStorage;
+    const char* errorMsgPtr = getNullableCString(env, errorMessage, errorMsgStorage);
+    const char* opPtr = getNullableCString(env, operation, opStorage);
+    const char* ctxPtr = getNullableCString(env, context, ctxStorage);
+
+    rac_analytics_event_data_t event_data = {};
+    event_data.type = static_cast<rac_event_type_t>(eventType);
+    event_data.data.sdk_error.error_code = static_cast<rac_result_t>(errorCode);
+    event_data.data.sdk_error.error_message = errorMsgPtr;
+    event_data.data.sdk_error.operation = opPtr;
+    event_data.data.sdk_error.context = ctxPtr;
+
+    rac_analytics_event_emit(event_data.type, &event_data);
+    return RAC_SUCCESS;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventEmitNetwork(
+    JNIEnv* env, jclass clazz, jint eventType, jboolean isOnline) {
+    rac_analytics_event_data_t event_data = {};
+    event_data.type = static_cast<rac_event_type_t>(eventType);
+    event_data.data.network.is_online = isOnline ? RAC_TRUE : RAC_FALSE;
+
+    rac_analytics_event_emit(event_data.type, &event_data);
+    return RAC_SUCCESS;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventEmitLlmGeneration(
+    JNIEnv* env, jclass clazz, jint eventType, jstring generationId, jstring modelId,
+    jstring modelName, jint inputTokens, jint outputTokens, jdouble durationMs,
+    jdouble tokensPerSecond, jboolean isStreaming, jdouble timeToFirstTokenMs, jint framework,
+    jfloat temperature, jint maxTokens, jint contextLength, jint errorCode, jstring errorMessage) {
+    std::string genIdStr = getCString(env, generationId);
+    std::string modelIdStr = getCString(env, modelId);
+    std::string modelNameStorage;
+    std::string errorMsgStorage;
+    const char* modelNamePtr = getNullableCString(env, modelName, modelNameStorage);
+    const char* errorMsgPtr = getNullableCString(env, errorMessage, errorMsgStorage);
+
+    rac_analytics_event_data_t event_data = {};
+    event_data.type = static_cast<rac_event_type_t>(eventType);
+    event_data.data.llm_generation.generation_id = genIdStr.c_str();
+    event_data.data.llm_generation.model_id = modelIdStr.c_str();
+    event_data.data.llm_generation.model_name = modelNamePtr;
+    event_data.data.llm_generation.input_tokens = inputTokens;
+    event_data.data.llm_generation.output_tokens = outputTokens;
+    event_data.data.llm_generation.duration_ms = durationMs;
+    event_data.data.llm_generation.tokens_per_second = tokensPerSecond;
+    event_data.data.llm_generation.is_streaming = isStreaming ? RAC_TRUE : RAC_FALSE;
+    event_data.data.llm_generation.time_to_first_token_ms = timeToFirstTokenMs;
+    event_data.data.llm_generation.framework = static_cast<rac_inference_framework_t>(framework);
+    event_data.data.llm_generation.temperature = temperature;
+    event_data.data.llm_generation.max_tokens = maxTokens;
+    event_data.data.llm_generation.context_length = contextLength;
+    event_data.data.llm_generation.error_code = static_cast<rac_result_t>(errorCode);
+    event_data.data.llm_generation.error_message = errorMsgPtr;
+
+    rac_analytics_event_emit(event_data.type, &event_data);
+    return RAC_SUCCESS;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventEmitLlmModel(
+    JNIEnv* env, jclass clazz, jint eventType, jstring modelId, jstring modelName,
+    jlong modelSizeBytes, jdouble durationMs, jint framework, jint errorCode,
+    jstring errorMessage) {
+    std::string modelIdStr = getCString(env, modelId);
+    std::string modelNameStorage;
+    std::string errorMsgStorage;
+    const char* modelNamePtr = getNullableCString(env, modelName, modelNameStorage);
+    const char* errorMsgPtr = getNullableCString(env, errorMessage, errorMsgStorage);
+
+    rac_analytics_event_data_t event_data = {};
+    event_data.type = static_cast<rac_event_type_t>(eventType);
+    event_data.data.llm_model.model_id = modelIdStr.c_str();
+    event_data.data.llm_model.model_name = modelNamePtr;
+    event_data.data.llm_model.model_size_bytes = modelSizeBytes;
+    event_data.data.llm_model.duration_ms = durationMs;
+    event_data.data.llm_model.framework = static_cast<rac_inference_framework_t>(framework);
+    event_data.data.llm_model.error_code = static_cast<rac_result_t>(errorCode);
+    event_data.data.llm_model.error_message = errorMsgPtr;
+
+    rac_analytics_event_emit(event_data.type, &event_data);
+    return RAC_SUCCESS;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventEmitSttTranscription(
+    JNIEnv* env, jclass clazz, jint eventType, jstring transcriptionId, jstring modelId,
+    jstring modelName, jstring text, jfloat confidence, jdouble durationMs, jdouble audioLengthMs,
+    jint audioSizeBytes, jint wordCount, jdouble realTimeFactor, jstring language, jint sampleRate,
+    jboolean isStreaming, jint framework, jint errorCode, jstring errorMessage) {
+    std::string transIdStr = getCString(env, transcriptionId);
+    std::string modelIdStr = getCString(env, modelId);
+    std::string modelNameStorage, textStorage, langStorage, errorMsgStorage;
+    const char* modelNamePtr = getNullableCString(env, modelName, modelNameStorage);
+    const char* textPtr = getNullableCString(env, text, textStorage);
+    const char* langPtr = getNullableCString(env, language, langStorage);
+    const char* errorMsgPtr = getNullableCString(env, errorMessage, errorMsgStorage);
+
+    rac_analytics_event_data_t event_data = {};
+    event_data.type = static_cast<rac_event_type_t>(eventType);
+    event_data.data.stt_transcription.transcription_id = transIdStr.c_str();
+    event_data.data.stt_transcription.model_id = modelIdStr.c_str();
+    event_data.data.stt_transcription.model_name = modelNamePtr;
+    event_data.data.stt_transcription.text = textPtr;
+    event_data.data.stt_transcription.confidence = confidence;
+    event_data.data.stt_transcription.duration_ms = durationMs;
+    event_data.data.stt_transcription.audio_length_ms = audioLengthMs;
+    event_data.data.stt_transcription.audio_size_bytes = audioSizeBytes;
+    event_data.data.stt_transcription.word_count = wordCount;
+    event_data.data.stt_transcription.real_time_factor = realTimeFactor;
+    event_data.data.stt_transcription.language = langPtr;
+    event_data.data.stt_transcription.sample_rate = sampleRate;
+    event_data.data.stt_transcription.is_streaming = isStreaming ? RAC_TRUE : RAC_FALSE;
+    event_data.data.stt_transcription.framework = static_cast<rac_inference_framework_t>(framework);
+    event_data.data.stt_transcription.error_code = static_cast<rac_result_t>(errorCode);
+    event_data.data.stt_transcription.error_message = errorMsgPtr;
+
+    rac_analytics_event_emit(event_data.type, &event_data);
+    return RAC_SUCCESS;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventEmitTtsSynthesis(
+    JNIEnv* env, jclass clazz, jint eventType, jstring synthesisId, jstring modelId,
+    jstring modelName, jint characterCount, jdouble audioDurationMs, jint audioSizeBytes,
+    jdouble processingDurationMs, jdouble charactersPerSecond, jint sampleRate, jint framework,
+    jint errorCode, jstring errorMessage) {
+    std::string synthIdStr = getCString(env, synthesisId);
+    std::string modelIdStr = getCString(env, modelId);
+    std::string modelNameStorage, errorMsgStorage;
+    const char* modelNamePtr = getNullableCString(env, modelName, modelNameStorage);
+    const char* errorMsgPtr = getNullableCString(env, errorMessage, errorMsgStorage);
+
+    rac_analytics_event_data_t event_data = {};
+    event_data.type = static_cast<rac_event_type_t>(eventType);
+    event_data.data.tts_synthesis.synthesis_id = synthIdStr.c_str();
+    event_data.data.tts_synthesis.model_id = modelIdStr.c_str();
+    event_data.data.tts_synthesis.model_name = modelNamePtr;
+    event_data.data.tts_synthesis.character_count = characterCount;
+    event_data.data.tts_synthesis.audio_duration_ms = audioDurationMs;
+    event_data.data.tts_synthesis.audio_size_bytes = audioSizeBytes;
+    event_data.data.tts_synthesis.processing_duration_ms = processingDurationMs;
+    event_data.data.tts_synthesis.characters_per_second = charactersPerSecond;
+    event_data.data.tts_synthesis.sample_rate = sampleRate;
+    event_data.data.tts_synthesis.framework = static_cast<rac_inference_framework_t>(framework);
+    event_data.data.tts_synthesis.error_code = static_cast<rac_result_t>(errorCode);
+    event_data.data.tts_synthesis.error_message = errorMsgPtr;
+
+    rac_analytics_event_emit(event_data.type, &event_data);
+    return RAC_SUCCESS;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventEmitVad(
+    JNIEnv* env, jclass clazz, jint eventType, jdouble speechDurationMs, jfloat energyLevel) {
+    rac_analytics_event_data_t event_data = {};
+    event_data.type = static_cast<rac_event_type_t>(eventType);
+    event_data.data.vad.speech_duration_ms = speechDurationMs;
+    event_data.data.vad.energy_level = energyLevel;
+
+    rac_analytics_event_emit(event_data.type, &event_data);
+    return RAC_SUCCESS;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAnalyticsEventEmitVoiceAgentState(
+    JNIEnv* env, jclass clazz, jint eventType, jstring component, jint state, jstring modelId,
+    jstring errorMessage) {
+    std::string componentStr = getCString(env, component);
+    std::string modelIdStorage, errorMsgStorage;
+    const char* modelIdPtr = getNullableCString(env, modelId, modelIdStorage);
+    const char* errorMsgPtr = getNullableCString(env, errorMessage, errorMsgStorage);
+
+    rac_analytics_event_data_t event_data = {};
+    event_data.type = static_cast<rac_event_type_t>(eventType);
+    event_data.data.voice_agent_state.component = componentStr.c_str();
+    event_data.data.voice_agent_state.state = static_cast<rac_voice_agent_component_state_t>(state);
+    event_data.data.voice_agent_state.model_id = modelIdPtr;
+    event_data.data.voice_agent_state.error_message = errorMsgPtr;
+
+    rac_analytics_event_emit(event_data.type, &event_data);
+    return RAC_SUCCESS;
+}
+
+}  // extern "C"
@@ -0,0 +1,215 @@
+/**
+ * RunAnywhere Commons JNI Bridge - TTS Component
+ *
+ * TTS component lifecycle and synthesis.
+ */
+
+#include "jni_common.h"
+
+#include "rac/features/tts/rac_tts_component.h"
+
+extern "C" {
+
+// =============================================================================
+// JNI FUNCTIONS - TTS Component
+// =============================================================================
+
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentCreate(JNIEnv* env,
+                                                                               jclass clazz) {
+    rac_handle_t handle = RAC_INVALID_HANDLE;
+    rac_result_t result = rac_tts_component_create(&handle);
+    if (result != RAC_SUCCESS) {
+        LOGe("Failed to create TTS component: %d", result);
+        return 0;
+    }
+    return reinterpret_cast<jlong>(handle);
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentDestroy(JNIEnv* env,
+                                                                                jclass clazz,
+                                                                                jlong handle) {
+    if (handle != 0) {
+        rac_tts_component_destroy(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentLoadModel(
+    JNIEnv* env, jclass clazz, jlong handle, jstring modelPath, jstring modelId,
+    jstring modelName) {
+    if (handle == 0)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    std::string voicePath = getCString(env, modelPath);
+    std::string voiceId = getCString(env, modelId);
+    std::string voiceName = getCString(env, modelName);
+    LOGi("racTtsComponentLoadModel path=%s, id=%s, name=%s", voicePath.c_str(), voiceId.c_str(),
+         voiceName.c_str());
+
+    // TTS component uses load_voice instead of load_model
+    // Pass voice_path, voice_id, and voice_name separately to C++ lifecycle
+    return static_cast<jint>(rac_tts_component_load_voice(
+        reinterpret_cast<rac_handle_t>(handle),
+        voicePath.c_str(),                               // voice_path
+        voiceId.c_str(),                                 // voice_id (for telemetry)
+        voiceName.empty() ? nullptr : voiceName.c_str()  // voice_name (optional, for telemetry)
+        ));
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentUnload(JNIEnv* env,
+                                                                               jclass clazz,
+                                                                               jlong handle) {
+    if (handle != 0) {
+        rac_tts_component_unload(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentSynthesize(
+    JNIEnv* env, jclass clazz, jlong handle, jstring text, jstring configJson) {
+    if (handle == 0)
+        return nullptr;
+
+    std::string textStr = getCString(env, text);
+    rac_tts_options_t options = {};
+    rac_tts_result_t result = {};
+
+    rac_result_t status = rac_tts_component_synthesize(reinterpret_cast<rac_handle_t>(handle),
+                                                       textStr.c_str(), &options, &result);
+
+    if (status != RAC_SUCCESS || result.audio_data == nullptr) {
+        return nullptr;
+    }
+
+    jbyteArray jResult = env->NewByteArray(static_cast<jsize>(result.audio_size));
+    env->SetByteArrayRegion(jResult, 0, static_cast<jsize>(result.audio_size),
+                            reinterpret_cast<const jbyte*>(result.audio_data));
+
+    rac_tts_result_free(&result);
+    return jResult;
+}
+
+// Synthesizes Float32 PCM directly into a DirectByteBuffer. Returns the bytes
+// written, or a negative rac_result_t (RAC_ERROR_BUFFER_TOO_SMALL when the
+// audio does not fit).
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentSynthesizeInto(
+    JNIEnv* env, jclass clazz, jlong handle, jstring text, jobject directBuffer,
+    jstring configJson) {
+    if (handle == 0 || directBuffer == nullptr)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    void* buffer = env->GetDirectBufferAddress(directBuffer);
+    jlong capacity = env->GetDirectBufferCapacity(directBuffer);
+    if (buffer == nullptr || capacity <= 0)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    std::string textStr = getCString(env, text);
+    rac_tts_options_t options = {};
+    size_t audio_size = 0;
+
+    rac_result_t status = rac_tts_component_synthesize_into(
+        reinterpret_cast<rac_handle_t>(handle), textStr.c_str(), &options, buffer,
+        static_cast<size_t>(capacity), &audio_size, nullptr);
+
+    if (status != RAC_SUCCESS) {
+        return static_cast<jlong>(status);
+    }
+    return static_cast<jlong>(audio_size);
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentSynthesizeStream(
+    JNIEnv* env, jclass clazz, jlong handle, jstring text, jstring configJson) {
+    return Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentSynthesize(
+        env, clazz, handle, text, configJson);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentSynthesizeToFile(
+    JNIEnv* env, jclass clazz, jlong handle, jstring text, jstring outputPath, jstring configJson) {
+    if (handle == 0)
+        return -1;
+
+    std::string textStr = getCString(env, text);
+    std::string pathStr = getCString(env, outputPath);
+    rac_tts_options_t options = {};
+    rac_tts_result_t result = {};
+
+    rac_result_t status = rac_tts_component_synthesize(reinterpret_cast<rac_handle_t>(handle),
+                                                       textStr.c_str(), &options, &result);
+
+    // TODO: Write result to file
+    rac_tts_result_free(&result);
+
+    return status == RAC_SUCCESS ? 0 : -1;
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentCancel(JNIEnv* env,
+                                                                               jclass clazz,
+                                                                               jlong handle) {
+    // TTS component doesn't have a cancel method, just unload
+    if (handle != 0) {
+        rac_tts_component_unload(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentGetState(JNIEnv* env,
+                                                                                 jclass clazz,
+                                                                                 jlong handle) {
+    if (handle == 0)
+        return 0;
+    return static_cast<jint>(rac_tts_component_get_state(reinterpret_cast<rac_handle_t>(handle)));
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentIsLoaded(JNIEnv* env,
+                                                                                 jclass clazz,
+                                                                                 jlong handle) {
+    if (handle == 0)
+        return JNI_FALSE;
+    return rac_tts_component_is_loaded(reinterpret_cast<rac_handle_t>(handle)) ? JNI_TRUE
+                                                                               : JNI_FALSE;
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentGetVoices(JNIEnv* env,
+                                                                                  jclass clazz,
+                                                                                  jlong handle) {
+    return env->NewStringUTF("[]");
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentSetVoice(JNIEnv* env,
+                                                                                 jclass clazz,
+                                                                                 jlong handle,
+                                                                                 jstring voiceId) {
+    if (handle == 0)
+        return RAC_ERROR_INVALID_HANDLE;
+    std::string voice = getCString(env, voiceId);
+    // voice_path, voice_id (use path as id), voice_name (optional)
+    return static_cast<jint>(rac_tts_component_load_voice(reinterpret_cast<rac_handle_t>(handle),
+                                                          voice.c_str(),  // voice_path
+                                                          voice.c_str(),  // voice_id
+                                                          nullptr         // voice_name (optional)
+                                                          ));
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsComponentGetLanguages(JNIEnv* env,
+                                                                                     jclass clazz,
+                                                                                     jlong handle) {
+    return env->NewStringUTF("[]");
+}
+
+JNIEXPORT void JNICALL Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racTtsSetCallbacks(
+    JNIEnv* env, jclass clazz, jobject audioCallback, jobject progressCallback) {
+    // TODO: Implement callback registration
+}
+
+}  // extern "C"
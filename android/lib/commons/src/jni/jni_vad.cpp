@@ -0,0 +1,382 @@
+/**
+ * RunAnywhere Commons JNI Bridge - VAD Component
+ *
+ * VAD component lifecycle and speech detection.
+ */
+
+#include "jni_common.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "rac/core/rac_audio_capture.h"
+#include "rac/features/vad/rac_vad_component.h"
+
+extern "C" {
+
+// =============================================================================
+// JNI FUNCTIONS - VAD Component
+// =============================================================================
+
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentCreate(JNIEnv* env,
+                                                                               jclass clazz) {
+    rac_handle_t handle = RAC_INVALID_HANDLE;
+    rac_result_t result = rac_vad_component_create(&handle);
+    if (result != RAC_SUCCESS) {
+        LOGe("Failed to create VAD component: %d", result);
+        return 0;
+    }
+    return reinterpret_cast<jlong>(handle);
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentDestroy(JNIEnv* env,
+                                                                                jclass clazz,
+                                                                                jlong handle) {
+    if (handle != 0) {
+        rac_vad_component_destroy(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentLoadModel(
+    JNIEnv* env, jclass clazz, jlong handle, jstring modelPath, jstring configJson) {
+    if (handle == 0)
+        return RAC_ERROR_INVALID_HANDLE;
+
+    // Initialize and configure the VAD component
+    return static_cast<jint>(rac_vad_component_initialize(reinterpret_cast<rac_handle_t>(handle)));
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentUnload(JNIEnv* env,
+                                                                               jclass clazz,
+                                                                               jlong handle) {
+    if (handle != 0) {
+        rac_vad_component_cleanup(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentProcess(
+    JNIEnv* env, jclass clazz, jlong handle, jbyteArray audioData, jstring configJson) {
+    if (handle == 0 || audioData == nullptr)
+        return nullptr;
+
+    jsize len = env->GetArrayLength(audioData);
+    jbyte* data = env->GetByteArrayElements(audioData, nullptr);
+
+    rac_bool_t out_is_speech = RAC_FALSE;
+    rac_result_t status = rac_vad_component_process(
+        reinterpret_cast<rac_handle_t>(handle), reinterpret_cast<const float*>(data),
+        static_cast<size_t>(len / sizeof(float)), &out_is_speech);
+
+    env->ReleaseByteArrayElements(audioData, data, JNI_ABORT);
+
+    if (status != RAC_SUCCESS) {
+        return nullptr;
+    }
+
+    // Return JSON result
+    char jsonBuf[256];
+    snprintf(jsonBuf, sizeof(jsonBuf), "{\"is_speech\":%s,\"probability\":%.4f}",
+             out_is_speech ? "true" : "false", out_is_speech ? 1.0f : 0.0f);
+
+    return env->NewStringUTF(jsonBuf);
+}
+
+// Runs VAD on the first `length` bytes (Float32 samples) of a DirectByteBuffer
+// in place. Per-frame path, so the result is a number rather than JSON: 1 for
+// speech, 0 for silence, or a negative rac_result_t.
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentProcessDirect(
+    JNIEnv* env, jclass clazz, jlong handle, jobject directBuffer, jint length,
+    jstring configJson) {
+    if (handle == 0 || directBuffer == nullptr || length < 0)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    void* data = env->GetDirectBufferAddress(directBuffer);
+    jlong capacity = env->GetDirectBufferCapacity(directBuffer);
+    if (data == nullptr || length > capacity)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    rac_bool_t out_is_speech = RAC_FALSE;
+    rac_result_t status = rac_vad_component_process(
+        reinterpret_cast<rac_handle_t>(handle), static_cast<const float*>(data),
+        static_cast<size_t>(length) / sizeof(float), &out_is_speech);
+    if (status != RAC_SUCCESS) {
+        return static_cast<jint>(status);
+    }
+    return out_is_speech ? 1 : 0;
+}
+
+// Runs the live detector over a region of a DirectByteBuffer ring of Float32
+// samples in one crossing: `numSamples` samples from `startSample`, wrapping at
+// the end of the buffer, split into `frameSamples` frames. Per-frame decisions
+// (1 speech, 0 silence) go into `decisions`. Returns the frames processed or a
+// negative rac_result_t.
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentProcessFrames(
+    JNIEnv* env, jclass clazz, jlong handle, jobject ringBuffer, jint startSample,
+    jint numSamples, jint frameSamples, jintArray decisions) {
+    static_assert(sizeof(rac_bool_t) == sizeof(jint), "decisions are copied out as jint");
+
+    void* data = nullptr;
+    size_t capacity = 0;
+    if (handle == 0 || decisions == nullptr || startSample < 0 || numSamples < 0 ||
+        frameSamples <= 0 || !getDirectBuffer(env, ringBuffer, &data, &capacity))
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    const float* ring = static_cast<const float*>(data);
+    const size_t ring_samples = capacity / sizeof(float);
+    const size_t start = static_cast<size_t>(startSample);
+    const size_t count = static_cast<size_t>(numSamples);
+    const size_t frame = static_cast<size_t>(frameSamples);
+    if (start >= ring_samples || count > ring_samples)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    const size_t max_frames =
+        std::min(count / frame, static_cast<size_t>(env->GetArrayLength(decisions)));
+    thread_local std::vector<rac_bool_t> out;
+    thread_local std::vector<float> seam;
+    out.resize(max_frames);
+
+    auto vad = reinterpret_cast<rac_handle_t>(handle);
+    const size_t head = std::min(count, ring_samples - start);
+    size_t frames = 0;
+    size_t n = 0;
+    rac_result_t status = rac_vad_component_process_frames(vad, ring + start, head, frame,
+                                                           out.data(), max_frames, &n);
+    frames += n;
+
+    if (status == RAC_SUCCESS && frames < max_frames) {
+        // The frame straddling the wrap point is the only one copied
+        const size_t before_wrap = head - frames * frame;
+        size_t wrapped = 0;
+        if (before_wrap > 0) {
+            wrapped = frame - before_wrap;
+            seam.resize(frame);
+            memcpy(seam.data(), ring + start + frames * frame, before_wrap * sizeof(float));
+            memcpy(seam.data() + before_wrap, ring, wrapped * sizeof(float));
+            status = rac_vad_component_process_frames(vad, seam.data(), frame, frame,
+                                                      out.data() + frames, 1, &n);
+            frames += n;
+        }
+        if (status == RAC_SUCCESS && frames < max_frames) {
+            status = rac_vad_component_process_frames(vad, ring + wrapped, count - head - wrapped,
+                                                      frame, out.data() + frames,
+                                                      max_frames - frames, &n);
+            frames += n;
+        }
+    }
+
+    if (frames > 0) {
+        env->SetIntArrayRegion(decisions, 0, static_cast<jsize>(frames),
+                               reinterpret_cast<const jint*>(out.data()));
+    }
+    if (status != RAC_SUCCESS) {
+        return static_cast<jint>(status);
+    }
+    return static_cast<jint>(frames);
+}
+
+// Starts the native frame pipeline. Its worker runs detection and the audio
+// callback at `priority` (rac_audio_thread_priority_t; real-time if allowed),
+// optionally pinned to the fastest core, independent of the Kotlin thread
+// that pushes the audio.
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentStartPipeline(
+    JNIEnv* env, jclass clazz, jlong handle, jint capacitySamples, jint priority,
+    jboolean pinToFastCore) {
+    if (handle == 0 || capacitySamples < 0)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    rac_audio_thread_config_t thread_config = RAC_AUDIO_THREAD_CONFIG_DEFAULT;
+    thread_config.priority = static_cast<rac_audio_thread_priority_t>(
+        std::min<jint>(std::max<jint>(priority, RAC_AUDIO_THREAD_PRIORITY_NORMAL),
+                       RAC_AUDIO_THREAD_PRIORITY_REALTIME));
+    thread_config.pin_to_fast_core = pinToFastCore ? RAC_TRUE : RAC_FALSE;
+
+    auto vad = reinterpret_cast<rac_handle_t>(handle);
+    rac_result_t status = rac_vad_component_set_pipeline_thread(vad, &thread_config);
+    if (status != RAC_SUCCESS)
+        return static_cast<jint>(status);
+    return static_cast<jint>(
+        rac_vad_component_start_pipeline(vad, static_cast<size_t>(capacitySamples)));
+}
+
+// Queues the first `length` bytes (Float32 samples) of a DirectByteBuffer for
+// the pipeline. Never blocks; RAC_ERROR_BUFFER_TOO_SMALL means samples were
+// dropped because the worker fell a ring behind.
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentPushAudio(
+    JNIEnv* env, jclass clazz, jlong handle, jobject directBuffer, jint length) {
+    void* data = nullptr;
+    size_t capacity = 0;
+    if (handle == 0 || length < 0 || !getDirectBuffer(env, directBuffer, &data, &capacity) ||
+        static_cast<size_t>(length) > capacity)
+        return RAC_ERROR_INVALID_ARGUMENT;
+
+    return static_cast<jint>(rac_vad_component_push_audio(reinterpret_cast<rac_handle_t>(handle),
+                                                          static_cast<const float*>(data),
+                                                          static_cast<size_t>(length) /
+                                                              sizeof(float)));
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentStopPipeline(
+    JNIEnv* env, jclass clazz, jlong handle) {
+    if (handle == 0)
+        return RAC_ERROR_INVALID_HANDLE;
+    return static_cast<jint>(
+        rac_vad_component_stop_pipeline(reinterpret_cast<rac_handle_t>(handle)));
+}
+
+// =============================================================================
+// JNI FUNCTIONS - Native Capture (rac_audio_capture.h)
+// =============================================================================
+
+static void capture_to_vad_pipeline(const float* samples, size_t num_samples, void* user_data) {
+    rac_vad_component_push_audio(static_cast<rac_handle_t>(user_data), samples, num_samples);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAudioCaptureIsAvailable(JNIEnv* env,
+                                                                                    jclass clazz) {
+    return rac_audio_capture_is_available() ? JNI_TRUE : JNI_FALSE;
+}
+
+// Records the microphone with AAudio straight into the VAD pipeline ring
+// (start it with racVadComponentStartPipeline first), so capture audio never
+// passes through Kotlin. Returns the capture handle, or 0 if AAudio is
+// unavailable or the microphone could not be opened; the app then keeps
+// pushing audio itself.
+JNIEXPORT jlong JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAudioCaptureStartVad(
+    JNIEnv* env, jclass clazz, jlong vadHandle, jint sampleRate, jint framesPerCallback,
+    jboolean lowLatency) {
+    if (vadHandle == 0 || sampleRate <= 0 || framesPerCallback < 0)
+        return 0;
+
+    rac_audio_capture_config_t config = RAC_AUDIO_CAPTURE_CONFIG_DEFAULT;
+    config.sample_rate = sampleRate;
+    config.frames_per_callback = framesPerCallback;
+    config.low_latency = lowLatency ? RAC_TRUE : RAC_FALSE;
+
+    rac_audio_capture_handle_t capture = nullptr;
+    rac_result_t result =
+        rac_audio_capture_create(&config, capture_to_vad_pipeline,
+                                 reinterpret_cast<rac_handle_t>(vadHandle), &capture);
+    if (result == RAC_SUCCESS)
+        result = rac_audio_capture_start(capture);
+    if (result != RAC_SUCCESS) {
+        LOGe("racAudioCaptureStartVad: native capture failed: %d", result);
+        rac_audio_capture_destroy(capture);
+        return 0;
+    }
+    return reinterpret_cast<jlong>(capture);
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAudioCaptureGetStats(JNIEnv* env,
+                                                                                 jclass clazz,
+                                                                                 jlong capture) {
+    rac_audio_capture_stats_t stats = {};
+    if (capture == 0 ||
+        rac_audio_capture_get_stats(reinterpret_cast<rac_audio_capture_handle_t>(capture),
+                                    &stats) != RAC_SUCCESS)
+        return nullptr;
+
+    char jsonBuf[256];
+    snprintf(jsonBuf, sizeof(jsonBuf),
+             "{\"backend\":%d,\"device_sample_rate\":%d,\"burst_frames\":%d,"
+             "\"samples_delivered\":%lld,\"xruns\":%d}",
+             static_cast<int>(stats.backend), stats.device_sample_rate, stats.burst_frames,
+             static_cast<long long>(stats.samples_delivered), stats.xruns);
+    return env->NewStringUTF(jsonBuf);
+}
+
+// Stops the microphone; the VAD pipeline keeps running until stopped itself
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racAudioCaptureDestroy(JNIEnv* env,
+                                                                                jclass clazz,
+                                                                                jlong capture) {
+    if (capture != 0) {
+        rac_audio_capture_destroy(reinterpret_cast<rac_audio_capture_handle_t>(capture));
+    }
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentProcessStream(
+    JNIEnv* env, jclass clazz, jlong handle, jbyteArray audioData, jstring configJson) {
+    return Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentProcess(
+        env, clazz, handle, audioData, configJson);
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentProcessFrame(
+    JNIEnv* env, jclass clazz, jlong handle, jbyteArray audioData, jstring configJson) {
+    return Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentProcess(
+        env, clazz, handle, audioData, configJson);
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentCancel(JNIEnv* env,
+                                                                               jclass clazz,
+                                                                               jlong handle) {
+    if (handle != 0) {
+        rac_vad_component_stop(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentReset(JNIEnv* env,
+                                                                              jclass clazz,
+                                                                              jlong handle) {
+    if (handle != 0) {
+        rac_vad_component_reset(reinterpret_cast<rac_handle_t>(handle));
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentGetState(JNIEnv* env,
+                                                                                 jclass clazz,
+                                                                                 jlong handle) {
+    if (handle == 0)
+        return 0;
+    return static_cast<jint>(rac_vad_component_get_state(reinterpret_cast<rac_handle_t>(handle)));
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentIsLoaded(JNIEnv* env,
+                                                                                 jclass clazz,
+                                                                                 jlong handle) {
+    if (handle == 0)
+        return JNI_FALSE;
+    return rac_vad_component_is_initialized(reinterpret_cast<rac_handle_t>(handle)) ? JNI_TRUE
+                                                                                    : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentGetMinFrameSize(
+    JNIEnv* env, jclass clazz, jlong handle) {
+    // Default minimum frame size: 512 samples at 16kHz = 32ms
+    if (handle == 0)
+        return 0;
+    return 512;
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadComponentGetSampleRates(
+    JNIEnv* env, jclass clazz, jlong handle) {
+    return env->NewStringUTF("[16000]");
+}
+
+JNIEXPORT void JNICALL Java_com_runanywhere_sdk_native_bridge_RunAnywhereBridge_racVadSetCallbacks(
+    JNIEnv* env, jclass clazz, jobject frameCallback, jobject speechStartCallback,
+    jobject speechEndCallback, jobject progressCallback) {
+    // TODO: Implement callback registration
+}
+
+}  // extern "C"
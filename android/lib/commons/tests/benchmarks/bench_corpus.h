@@ -0,0 +1,174 @@
+/**
+ * @file bench_corpus.h
+ * @brief RunAnywhere Commons - Benchmark Utterance Corpus
+ *
+ * Loads the speech corpus shared by the voice agent and STT benchmarks:
+ * 16 kHz mono Int16 WAV files (or headerless .pcm of the same format),
+ * given as a directory of them or a text file listing one path per line.
+ * A reference transcript next to an utterance (same name, .txt) is loaded
+ * with it, so benchmarks can score accuracy as well as speed.
+ */
+
+#ifndef RAC_BENCH_CORPUS_H
+#define RAC_BENCH_CORPUS_H
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace rac_bench {
+
+// Sample rate of every corpus utterance
+constexpr int32_t kCorpusSampleRate = 16000;
+
+struct Utterance {
+    std::string path;
+    std::vector<int16_t> samples;
+    std::string reference;  // Empty without a .txt transcript
+};
+
+inline bool ends_with(const std::string& s, const char* suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+inline uint32_t read_le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint16_t read_le16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline bool read_file(const std::string& path, std::vector<uint8_t>* out) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    uint8_t buffer[64 * 1024];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        out->insert(out->end(), buffer, buffer + n);
+    }
+    fclose(file);
+    return true;
+}
+
+// Reads <utterance without extension>.txt, trimmed, if present
+inline std::string load_reference(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    std::vector<uint8_t> bytes;
+    if (dot == std::string::npos || !read_file(path.substr(0, dot) + ".txt", &bytes)) {
+        return std::string();
+    }
+    std::string text(bytes.begin(), bytes.end());
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return begin == std::string::npos ? std::string() : text.substr(begin, end - begin + 1);
+}
+
+// Extracts the data chunk of a 16 kHz mono Int16 WAV; headerless .pcm is taken as is
+inline bool load_utterance(const std::string& path, Utterance* out) {
+    std::vector<uint8_t> bytes;
+    if (!read_file(path, &bytes)) {
+        fprintf(stderr, "Cannot read %s\n", path.c_str());
+        return false;
+    }
+
+    const uint8_t* pcm = bytes.data();
+    size_t pcm_size = bytes.size();
+    if (ends_with(path, ".wav")) {
+        if (bytes.size() < 12 || memcmp(bytes.data(), "RIFF", 4) != 0 ||
+            memcmp(bytes.data() + 8, "WAVE", 4) != 0) {
+            fprintf(stderr, "%s: not a RIFF/WAVE file\n", path.c_str());
+            return false;
+        }
+        pcm = nullptr;
+        size_t pos = 12;
+        while (pos + 8 <= bytes.size()) {
+            const uint8_t* chunk = bytes.data() + pos;
+            size_t size = read_le32(chunk + 4);
+            size_t body = pos + 8;
+            if (memcmp(chunk, "fmt ", 4) == 0 && body + 16 <= bytes.size()) {
+                uint16_t format = read_le16(bytes.data() + body);
+                uint16_t channels = read_le16(bytes.data() + body + 2);
+                uint32_t rate = read_le32(bytes.data() + body + 4);
+                uint16_t bits = read_le16(bytes.data() + body + 14);
+                if (format != 1 || channels != 1 || bits != 16 ||
+                    rate != static_cast<uint32_t>(kCorpusSampleRate)) {
+                    fprintf(stderr, "%s: expected 16 kHz mono 16-bit PCM\n", path.c_str());
+                    return false;
+                }
+            } else if (memcmp(chunk, "data", 4) == 0) {
+                pcm = bytes.data() + body;
+                pcm_size = std::min(size, bytes.size() - body);
+                break;
+            }
+            pos = body + size + (size & 1);
+        }
+        if (!pcm) {
+            fprintf(stderr, "%s: no data chunk\n", path.c_str());
+            return false;
+        }
+    }
+
+    out->path = path;
+    out->samples.resize(pcm_size / sizeof(int16_t));
+    memcpy(out->samples.data(), pcm, out->samples.size() * sizeof(int16_t));
+    out->reference = load_reference(path);
+    return !out->samples.empty();
+}
+
+inline bool load_corpus(const std::string& corpus, std::vector<Utterance>* out) {
+    std::vector<std::string> paths;
+    if (DIR* dir = opendir(corpus.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (ends_with(name, ".wav") || ends_with(name, ".pcm")) {
+                paths.push_back(corpus + "/" + name);
+            }
+        }
+        closedir(dir);
+        std::sort(paths.begin(), paths.end());
+    } else {
+        FILE* list = fopen(corpus.c_str(), "r");
+        if (!list) {
+            fprintf(stderr, "Cannot open corpus %s\n", corpus.c_str());
+            return false;
+        }
+        char line[4096];
+        while (fgets(line, sizeof(line), list)) {
+            std::string path = line;
+            while (!path.empty() && (path.back() == '\n' || path.back() == '\r')) {
+                path.pop_back();
+            }
+            if (!path.empty() && path[0] != '#') {
+                paths.push_back(path);
+            }
+        }
+        fclose(list);
+    }
+
+    for (const std::string& path : paths) {
+        Utterance utterance;
+        if (!load_utterance(path, &utterance)) {
+            return false;
+        }
+        out->push_back(std::move(utterance));
+    }
+    if (out->empty()) {
+        fprintf(stderr, "Corpus %s has no utterances\n", corpus.c_str());
+        return false;
+    }
+    return true;
+}
+
+}  // namespace rac_bench
+
+#endif /* RAC_BENCH_CORPUS_H */
@@ -0,0 +1,776 @@
+/**
+ * @file llm_bench.cpp
+ * @brief RunAnywhere Commons - End-to-End LLM Benchmark
+ *
+ * Loads a GGUF through rac_llm_component_load_model and sweeps a matrix of
+ * prompt lengths, generation lengths, thread counts, batch sizes and KV
+ * cache types. Every generation streams through the component, so events,
+ * analytics and metrics run as they do in an app. With --raw, each point is
+ * also measured through rac_llm_llamacpp_* directly, and the report carries
+ * the SDK's overhead next to it.
+ *
+ * Reported per point: prefill and decode tokens/s, time to first token,
+ * inter-token latency percentiles, peak RSS, events published and an energy
+ * estimate. Energy comes from RAPL on Linux hosts or from the battery fuel
+ * gauge on Android (run unplugged); it is the whole device's draw, so keep
+ * the device otherwise idle. The report is one JSON document.
+ *
+ * Usage:
+ *   rac_llm_bench --model <path.gguf> [--prompt-tokens 128,512] [--gen-tokens 64,128]
+ *                 [--threads 4] [--batch 512] [--kv f16,q8_0] [--repetitions N]
+ *                 [--warmup N] [--raw] [--output report.json] [--verbose]
+ */
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rac/backends/rac_llm_llamacpp.h"
+#include "rac/core/rac_core.h"
+#include "rac/core/rac_platform_adapter.h"
+#include "rac/features/llm/rac_llm_component.h"
+#include "rac/infrastructure/events/rac_events.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string model_path;
+    std::string output;
+    std::vector<int32_t> prompt_tokens = {128, 512};
+    std::vector<int32_t> gen_tokens = {64};
+    std::vector<int32_t> threads = {0};
+    std::vector<int32_t> batch_sizes = {512};
+    std::vector<std::string> kv_types = {"f16"};
+    int repetitions = 3;
+    int warmup = 1;
+    bool raw = false;
+};
+
+// One point of the matrix that needs its own load
+struct LoadConfig {
+    int32_t threads = 0;
+    int32_t batch_size = 512;
+    std::string kv_type;
+    int32_t context_size = 0;
+};
+
+// One measured generation
+struct Generation {
+    bool ok = false;
+    int32_t prompt_tokens = 0;
+    int32_t tokens = 0;
+    double ttft_ms = 0.0;
+    double decode_ms = 0.0;
+    std::vector<double> gaps_ms;
+};
+
+// =============================================================================
+// PLATFORM ADAPTER - Minimal host implementation
+// =============================================================================
+
+rac_log_level_t g_log_level = RAC_LOG_WARNING;
+
+void bench_log(rac_log_level_t level, const char* category, const char* message, void*) {
+    if (level >= g_log_level) {
+        fprintf(stderr, "[%s] %s\n", category ? category : "RAC", message ? message : "");
+    }
+}
+
+int64_t bench_now_ms(void*) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+double ms_since(Clock::time_point since, Clock::time_point now) {
+    return std::chrono::duration<double, std::milli>(now - since).count();
+}
+
+// =============================================================================
+// MEMORY AND ENERGY
+// =============================================================================
+
+// Starts a new peak RSS window where the kernel allows it (Linux, Android)
+void reset_peak_rss() {
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    if (file) {
+        fputs("5", file);
+        fclose(file);
+    }
+}
+
+// Peak RSS since reset_peak_rss, or of the whole process where it cannot be reset
+long peak_rss_kb() {
+    FILE* file = fopen("/proc/self/status", "r");
+    if (file) {
+        char line[256];
+        long kb = -1;
+        while (fgets(line, sizeof(line), file)) {
+            if (strncmp(line, "VmHWM:", 6) == 0) {
+                kb = atol(line + 6);
+                break;
+            }
+        }
+        fclose(file);
+        if (kb >= 0) {
+            return kb;
+        }
+    }
+    rusage usage = {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;  // bytes on Darwin
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+bool read_long(const char* path, long long* out) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    bool ok = fscanf(file, "%lld", out) == 1;
+    fclose(file);
+    return ok;
+}
+
+// Energy drawn between start and stop, in joules. Reads the package energy
+// counter where there is one, else integrates the battery's current and
+// voltage, sampled every 50 ms.
+class EnergyMeter {
+   public:
+    void start() {
+        joules_ = 0.0;
+        long long uj = 0;
+        rapl_ = read_long(kRaplPath, &uj);
+        if (rapl_) {
+            rapl_start_uj_ = uj;
+            return;
+        }
+        long long ua = 0;
+        long long uv = 0;
+        battery_ = read_long(kCurrentPath, &ua) && read_long(kVoltagePath, &uv);
+        if (battery_) {
+            running_ = true;
+            sampler_ = std::thread([this] { sample(); });
+        }
+    }
+
+    void stop() {
+        if (rapl_) {
+            long long uj = 0;
+            if (read_long(kRaplPath, &uj) && uj >= rapl_start_uj_) {
+                joules_ = static_cast<double>(uj - rapl_start_uj_) / 1e6;
+            } else {
+                rapl_ = false;  // Counter wrapped
+            }
+        }
+        if (sampler_.joinable()) {
+            running_ = false;
+            sampler_.join();
+        }
+    }
+
+    bool available() const { return rapl_ || battery_; }
+    double joules() const { return joules_; }
+    const char* source() const { return rapl_ ? "rapl" : battery_ ? "battery" : "none"; }
+
+   private:
+    static constexpr const char* kRaplPath = "/sys/class/powercap/intel-rapl:0/energy_uj";
+    static constexpr const char* kCurrentPath = "/sys/class/power_supply/battery/current_now";
+    static constexpr const char* kVoltagePath = "/sys/class/power_supply/battery/voltage_now";
+
+    void sample() {
+        Clock::time_point last = Clock::now();
+        while (running_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            long long ua = 0;
+            long long uv = 0;
+            Clock::time_point now = Clock::now();
+            if (read_long(kCurrentPath, &ua) && read_long(kVoltagePath, &uv)) {
+                // Sign of current_now differs between fuel gauges
+                double watts = std::abs(static_cast<double>(ua)) * 1e-6 *
+                               static_cast<double>(uv) * 1e-6;
+                joules_ += watts * ms_since(last, now) / 1000.0;
+            }
+            last = now;
+        }
+    }
+
+    bool rapl_ = false;
+    bool battery_ = false;
+    long long rapl_start_uj_ = 0;
+    std::atomic<bool> running_{false};
+    std::thread sampler_;
+    double joules_ = 0.0;
+};
+
+// =============================================================================
+// EVENTS
+// =============================================================================
+
+std::atomic<int64_t> g_events{0};
+
+void count_event(const rac_event_t*, void*) {
+    g_events.fetch_add(1, std::memory_order_relaxed);
+}
+
+// =============================================================================
+// PROMPTS
+// =============================================================================
+
+const char* const kFiller =
+    "The quick brown fox jumps over the lazy dog while the river runs past the old mill. ";
+
+// Builds a prompt of about target tokens with the component's tokenizer. The
+// run number goes first, so the backend's prompt prefix cache cannot skip
+// the prefill of a repeated prompt.
+std::string make_prompt(rac_handle_t component, int32_t target, int run, int32_t* out_tokens) {
+    const std::string head = "Run " + std::to_string(run) + ". Summarize the following text.\n";
+    const std::string tail = "\nSummary:";
+    std::string body;
+    int32_t tokens = 0;
+    for (;;) {
+        std::string prompt = head + body + tail;
+        if (rac_llm_component_count_tokens(component, prompt.c_str(), &tokens) != RAC_SUCCESS) {
+            tokens = static_cast<int32_t>(prompt.size() / 4);
+        }
+        if (tokens >= target) {
+            *out_tokens = tokens;
+            return prompt;
+        }
+        // Grow by the missing share of a filler sentence, at least one word
+        const int32_t missing = target - tokens;
+        const size_t filler_length = strlen(kFiller);
+        if (missing > 20) {
+            body += kFiller;
+        } else {
+            size_t cut = std::min(filler_length, static_cast<size_t>(missing) * 4);
+            body.append(kFiller, cut);
+        }
+    }
+}
+
+// =============================================================================
+// GENERATION
+// =============================================================================
+
+struct StreamState {
+    Clock::time_point start;
+    Clock::time_point last;
+    Generation* generation = nullptr;
+    rac_result_t error = RAC_SUCCESS;
+};
+
+void on_token(StreamState* state) {
+    Clock::time_point now = Clock::now();
+    Generation* g = state->generation;
+    if (g->tokens == 0) {
+        g->ttft_ms = ms_since(state->start, now);
+    } else {
+        g->gaps_ms.push_back(ms_since(state->last, now));
+        g->decode_ms += ms_since(state->last, now);
+    }
+    state->last = now;
+    g->tokens++;
+}
+
+rac_bool_t component_token(const char*, void* user_data) {
+    on_token(static_cast<StreamState*>(user_data));
+    return RAC_TRUE;
+}
+
+void component_complete(const rac_llm_result_t*, void*) {}
+
+void component_error(rac_result_t code, const char* message, void* user_data) {
+    static_cast<StreamState*>(user_data)->error = code;
+    fprintf(stderr, "Generation failed: %d %s\n", code, message ? message : "");
+}
+
+rac_bool_t raw_token(const char* token, rac_bool_t is_final, void* user_data) {
+    if (!is_final || (token && token[0] != '\0')) {
+        on_token(static_cast<StreamState*>(user_data));
+    }
+    return RAC_TRUE;
+}
+
+rac_llm_options_t generation_options(int32_t gen_tokens) {
+    rac_llm_options_t options = RAC_LLM_OPTIONS_DEFAULT;
+    options.max_tokens = gen_tokens;
+    options.temperature = 0.0f;
+    options.streaming_enabled = RAC_TRUE;
+    return options;
+}
+
+Generation run_component(rac_handle_t component, const std::string& prompt,
+                         int32_t prompt_tokens, int32_t gen_tokens) {
+    Generation generation;
+    generation.prompt_tokens = prompt_tokens;
+    StreamState state;
+    state.generation = &generation;
+    const rac_llm_options_t options = generation_options(gen_tokens);
+    state.start = Clock::now();
+    rac_result_t result = rac_llm_component_generate_stream(
+        component, prompt.c_str(), &options, component_token, component_complete,
+        component_error, &state);
+    generation.ok = result == RAC_SUCCESS && state.error == RAC_SUCCESS && generation.tokens > 0;
+    return generation;
+}
+
+Generation run_raw(rac_handle_t backend, const std::string& prompt, int32_t prompt_tokens,
+                   int32_t gen_tokens) {
+    Generation generation;
+    generation.prompt_tokens = prompt_tokens;
+    StreamState state;
+    state.generation = &generation;
+    rac_llm_options_t options = generation_options(gen_tokens);
+    state.start = Clock::now();
+    rac_result_t result =
+        rac_llm_llamacpp_generate_stream(backend, prompt.c_str(), &options, raw_token, &state);
+    generation.ok = result == RAC_SUCCESS && generation.tokens > 0;
+    return generation;
+}
+
+// =============================================================================
+// REPORT
+// =============================================================================
+
+struct Point {
+    LoadConfig config;
+    const char* path = "component";
+    int32_t prompt_target = 0;
+    int32_t gen_tokens = 0;
+    double load_ms = 0.0;
+    std::vector<Generation> generations;
+    long peak_rss_kb = -1;
+    int64_t events = 0;
+    bool energy_available = false;
+    const char* energy_source = "none";
+    double energy_j = 0.0;
+};
+
+double median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+// Nearest-rank percentile
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t i = static_cast<size_t>(p * static_cast<double>(values.size()) + 0.999999);
+    return values[std::min(values.size(), std::max<size_t>(i, 1)) - 1];
+}
+
+struct PointSummary {
+    size_t ok = 0;
+    double prompt_tokens = 0.0;
+    double gen_tokens = 0.0;
+    double ttft_ms = 0.0;
+    double prefill_tps = 0.0;
+    double decode_tps = 0.0;
+    double itl_p50_ms = 0.0;
+    double itl_p99_ms = 0.0;
+    int64_t total_tokens = 0;
+};
+
+PointSummary summarize(const Point& point) {
+    PointSummary s;
+    std::vector<double> prompt_tokens;
+    std::vector<double> gen_tokens;
+    std::vector<double> ttft;
+    std::vector<double> prefill;
+    std::vector<double> decode;
+    std::vector<double> gaps;
+    for (const Generation& g : point.generations) {
+        if (!g.ok) {
+            continue;
+        }
+        s.ok++;
+        s.total_tokens += g.prompt_tokens + g.tokens;
+        prompt_tokens.push_back(g.prompt_tokens);
+        gen_tokens.push_back(g.tokens);
+        ttft.push_back(g.ttft_ms);
+        if (g.ttft_ms > 0.0) {
+            prefill.push_back(g.prompt_tokens * 1000.0 / g.ttft_ms);
+        }
+        if (g.decode_ms > 0.0) {
+            decode.push_back((g.tokens - 1) * 1000.0 / g.decode_ms);
+        }
+        gaps.insert(gaps.end(), g.gaps_ms.begin(), g.gaps_ms.end());
+    }
+    s.prompt_tokens = median(prompt_tokens);
+    s.gen_tokens = median(gen_tokens);
+    s.ttft_ms = median(ttft);
+    s.prefill_tps = median(prefill);
+    s.decode_tps = median(decode);
+    s.itl_p50_ms = percentile(gaps, 0.50);
+    s.itl_p99_ms = percentile(gaps, 0.99);
+    return s;
+}
+
+const Point* find_raw(const std::vector<Point>& points, const Point& point) {
+    for (const Point& other : points) {
+        if (strcmp(other.path, "raw") == 0 && other.config.threads == point.config.threads &&
+            other.config.batch_size == point.config.batch_size &&
+            other.config.kv_type == point.config.kv_type &&
+            other.prompt_target == point.prompt_target && other.gen_tokens == point.gen_tokens) {
+            return &other;
+        }
+    }
+    return nullptr;
+}
+
+void write_report(FILE* out, const Options& options, const std::vector<Point>& points) {
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"llm\",\n");
+    fprintf(out, "  \"model\": \"%s\",\n", options.model_path.c_str());
+    fprintf(out, "  \"repetitions\": %d,\n", options.repetitions);
+    fprintf(out, "  \"points\": [\n");
+    for (size_t i = 0; i < points.size(); ++i) {
+        const Point& p = points[i];
+        const PointSummary s = summarize(p);
+        const size_t runs = p.generations.size();
+        fprintf(out, "    {\"path\": \"%s\", \"threads\": %d, \"batch_size\": %d, ", p.path,
+                p.config.threads, p.config.batch_size);
+        fprintf(out, "\"kv_type\": \"%s\", \"prompt_tokens\": %.0f, \"gen_tokens\": %d,\n",
+                p.config.kv_type.c_str(), s.prompt_tokens, p.gen_tokens);
+        fprintf(out, "     \"runs\": %zu, \"failures\": %zu, \"load_ms\": %.1f, ", runs,
+                runs - s.ok, p.load_ms);
+        fprintf(out, "\"generated_tokens\": %.0f,\n", s.gen_tokens);
+        fprintf(out, "     \"ttft_ms\": %.2f, \"prefill_tps\": %.2f, \"decode_tps\": %.2f, ",
+                s.ttft_ms, s.prefill_tps, s.decode_tps);
+        fprintf(out, "\"itl_p50_ms\": %.2f, \"itl_p99_ms\": %.2f,\n", s.itl_p50_ms,
+                s.itl_p99_ms);
+        fprintf(out, "     \"peak_rss_kb\": %ld, \"events\": %lld, ", p.peak_rss_kb,
+                static_cast<long long>(p.events));
+        if (p.energy_available && s.total_tokens > 0) {
+            fprintf(out,
+                    "\"energy\": {\"source\": \"%s\", \"joules\": %.3f, "
+                    "\"mj_per_token\": %.3f}",
+                    p.energy_source, p.energy_j, p.energy_j * 1000.0 / s.total_tokens);
+        } else {
+            fprintf(out, "\"energy\": null");
+        }
+
+        // SDK overhead against the same point measured without the component
+        const Point* raw = strcmp(p.path, "component") == 0 ? find_raw(points, p) : nullptr;
+        if (raw) {
+            const PointSummary r = summarize(*raw);
+            fprintf(out,
+                    ",\n     \"sdk_overhead\": {\"ttft_ms\": %.2f, \"decode_tps_pct\": %.2f, "
+                    "\"itl_p99_ms\": %.2f}",
+                    s.ttft_ms - r.ttft_ms,
+                    r.decode_tps > 0.0 ? (r.decode_tps - s.decode_tps) * 100.0 / r.decode_tps
+                                       : 0.0,
+                    s.itl_p99_ms - r.itl_p99_ms);
+        }
+        fprintf(out, "}%s\n", i + 1 < points.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n");
+    fprintf(out, "}\n");
+}
+
+// =============================================================================
+// SWEEP
+// =============================================================================
+
+std::string backend_config_json(const LoadConfig& config) {
+    std::string json = "{\"batch_size\": " + std::to_string(config.batch_size) +
+                       ", \"context_size\": " + std::to_string(config.context_size);
+    if (config.threads > 0) {
+        json += ", \"num_threads\": " + std::to_string(config.threads);
+    }
+    if (!config.kv_type.empty()) {
+        json += ", \"kv_cache_type_k\": \"" + config.kv_type + "\", \"kv_cache_type_v\": \"" +
+                config.kv_type + "\"";
+    }
+    return json + "}";
+}
+
+// Measures every prompt and generation length of one load config through one path
+template <typename RunFn>
+void sweep_lengths(const Options& options, rac_handle_t component, const LoadConfig& config,
+                   const char* path, double load_ms, RunFn run, std::vector<Point>* points) {
+    for (int32_t prompt_target : options.prompt_tokens) {
+        for (int32_t gen_tokens : options.gen_tokens) {
+            Point point;
+            point.config = config;
+            point.path = path;
+            point.prompt_target = prompt_target;
+            point.gen_tokens = gen_tokens;
+            point.load_ms = load_ms;
+
+            int run_number = 0;
+            for (int w = 0; w < options.warmup; ++w) {
+                int32_t tokens = 0;
+                std::string prompt = make_prompt(component, prompt_target, run_number++, &tokens);
+                run(prompt, tokens, gen_tokens);
+            }
+
+            // Prompts are built first, so tokenizing them is not measured
+            std::vector<std::string> prompts;
+            std::vector<int32_t> prompt_tokens;
+            for (int r = 0; r < options.repetitions; ++r) {
+                int32_t tokens = 0;
+                prompts.push_back(make_prompt(component, prompt_target, run_number++, &tokens));
+                prompt_tokens.push_back(tokens);
+            }
+
+            rac_event_flush(-1);
+            const int64_t events_before = g_events.load();
+            EnergyMeter energy;
+            reset_peak_rss();
+            energy.start();
+            for (int r = 0; r < options.repetitions; ++r) {
+                point.generations.push_back(run(prompts[r], prompt_tokens[r], gen_tokens));
+            }
+            energy.stop();
+            rac_event_flush(-1);
+            point.peak_rss_kb = peak_rss_kb();
+            point.events = g_events.load() - events_before;
+            point.energy_available = energy.available();
+            point.energy_source = energy.source();
+            point.energy_j = energy.joules();
+
+            fprintf(stderr, "%s threads=%d batch=%d kv=%s prompt=%d gen=%d: %.1f tok/s\n", path,
+                    config.threads, config.batch_size, config.kv_type.c_str(), prompt_target,
+                    gen_tokens, summarize(point).decode_tps);
+            points->push_back(std::move(point));
+        }
+    }
+}
+
+bool sweep_config(const Options& options, rac_handle_t component, const LoadConfig& config,
+                  std::vector<Point>* points) {
+    const std::string json = backend_config_json(config);
+    rac_llm_component_unload(component);
+    rac_llm_component_set_backend_config(component, json.c_str());
+
+    Clock::time_point start = Clock::now();
+    rac_result_t result = rac_llm_component_load_model(component, options.model_path.c_str(),
+                                                       "bench-model", "Bench Model");
+    const double load_ms = ms_since(start, Clock::now());
+    if (result != RAC_SUCCESS) {
+        fprintf(stderr, "Cannot load %s with %s: %d\n", options.model_path.c_str(), json.c_str(),
+                result);
+        return false;
+    }
+    sweep_lengths(
+        options, component, config, "component", load_ms,
+        [component](const std::string& prompt, int32_t tokens, int32_t gen) {
+            return run_component(component, prompt, tokens, gen);
+        },
+        points);
+
+    if (!options.raw) {
+        return true;
+    }
+
+    // Same config straight on the backend. The component stays loaded for its
+    // tokenizer; both map the same weights, so raw peak RSS mostly adds a
+    // second KV cache.
+    rac_llm_llamacpp_config_t raw_config = RAC_LLM_LLAMACPP_CONFIG_DEFAULT;
+    raw_config.num_threads = config.threads;
+    raw_config.batch_size = config.batch_size;
+    raw_config.context_size = config.context_size;
+    raw_config.kv_cache_type_k = config.kv_type.empty() ? nullptr : config.kv_type.c_str();
+    raw_config.kv_cache_type_v = raw_config.kv_cache_type_k;
+    rac_handle_t backend = nullptr;
+    start = Clock::now();
+    result = rac_llm_llamacpp_create(options.model_path.c_str(), &raw_config, &backend);
+    const double raw_load_ms = ms_since(start, Clock::now());
+    if (result != RAC_SUCCESS) {
+        fprintf(stderr, "Cannot create llama.cpp backend: %d\n", result);
+        return false;
+    }
+    sweep_lengths(
+        options, component, config, "raw", raw_load_ms,
+        [backend](const std::string& prompt, int32_t tokens, int32_t gen) {
+            return run_raw(backend, prompt, tokens, gen);
+        },
+        points);
+    rac_llm_llamacpp_destroy(backend);
+    return true;
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s --model <path.gguf> [--prompt-tokens 128,512] [--gen-tokens 64]\n"
+            "          [--threads 0] [--batch 512] [--kv f16,q8_0] [--repetitions N]\n"
+            "          [--warmup N] [--raw] [--output report.json] [--verbose]\n",
+            argv0);
+}
+
+bool parse_list(const char* value, std::vector<std::string>* out) {
+    out->clear();
+    std::string item;
+    for (const char* c = value;; ++c) {
+        if (*c == ',' || *c == '\0') {
+            if (!item.empty()) {
+                out->push_back(item);
+            }
+            item.clear();
+            if (*c == '\0') {
+                break;
+            }
+        } else {
+            item += *c;
+        }
+    }
+    return !out->empty();
+}
+
+bool parse_int_list(const char* value, std::vector<int32_t>* out, int32_t min_value) {
+    std::vector<std::string> items;
+    if (!parse_list(value, &items)) {
+        return false;
+    }
+    out->clear();
+    for (const std::string& item : items) {
+        int32_t n = atoi(item.c_str());
+        if (n < min_value) {
+            return false;
+        }
+        out->push_back(n);
+    }
+    return true;
+}
+
+bool parse_args(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verbose") {
+            g_log_level = RAC_LOG_INFO;
+            continue;
+        }
+        if (arg == "--raw") {
+            options->raw = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        bool ok = true;
+        if (arg == "--model") {
+            options->model_path = value;
+        } else if (arg == "--output") {
+            options->output = value;
+        } else if (arg == "--prompt-tokens") {
+            ok = parse_int_list(value, &options->prompt_tokens, 1);
+        } else if (arg == "--gen-tokens") {
+            ok = parse_int_list(value, &options->gen_tokens, 2);
+        } else if (arg == "--threads") {
+            ok = parse_int_list(value, &options->threads, 0);
+        } else if (arg == "--batch") {
+            ok = parse_int_list(value, &options->batch_sizes, 1);
+        } else if (arg == "--kv") {
+            ok = parse_list(value, &options->kv_types);
+        } else if (arg == "--repetitions") {
+            options->repetitions = atoi(value);
+        } else if (arg == "--warmup") {
+            options->warmup = atoi(value);
+        } else {
+            return false;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return !options->model_path.empty() && options->repetitions > 0 && options->warmup >= 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_args(argc, argv, &options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    rac_platform_adapter_t adapter = {};
+    adapter.log = bench_log;
+    adapter.now_ms = bench_now_ms;
+    rac_config_t config = {};
+    config.platform_adapter = &adapter;
+    config.log_level = g_log_level;
+    config.log_tag = "Bench";
+    if (rac_init(&config) != RAC_SUCCESS) {
+        fprintf(stderr, "rac_init failed\n");
+        return 1;
+    }
+    rac_backend_llamacpp_register();
+    const uint64_t subscription = rac_event_subscribe_all(count_event, nullptr);
+
+    rac_handle_t component = nullptr;
+    if (rac_llm_component_create(&component) != RAC_SUCCESS) {
+        fprintf(stderr, "Cannot create LLM component\n");
+        rac_shutdown();
+        return 1;
+    }
+
+    // Room for the longest prompt and reply, plus the chat template
+    const int32_t longest = *std::max_element(options.prompt_tokens.begin(),
+                                              options.prompt_tokens.end()) +
+                            *std::max_element(options.gen_tokens.begin(),
+                                              options.gen_tokens.end());
+
+    std::vector<Point> points;
+    bool ok = true;
+    for (int32_t threads : options.threads) {
+        for (int32_t batch_size : options.batch_sizes) {
+            for (const std::string& kv_type : options.kv_types) {
+                LoadConfig load;
+                load.threads = threads;
+                load.batch_size = batch_size;
+                load.kv_type = kv_type;
+                load.context_size = longest + 256;
+                ok = sweep_config(options, component, load, &points) && ok;
+            }
+        }
+    }
+
+    FILE* out = stdout;
+    if (!options.output.empty()) {
+        out = fopen(options.output.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "Cannot write %s\n", options.output.c_str());
+            out = stdout;
+        }
+    }
+    write_report(out, options, points);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    rac_llm_component_destroy(component);
+    rac_event_unsubscribe(subscription);
+    rac_shutdown();
+    return ok ? 0 : 1;
+}
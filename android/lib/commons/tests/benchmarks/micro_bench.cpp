@@ -0,0 +1,617 @@
+/**
+ * @file micro_bench.cpp
+ * @brief RunAnywhere Commons - Micro-Benchmarks of Hot Primitives
+ *
+ * Times the primitives on the per-frame and per-event paths (energy VAD,
+ * WAV encoding, resampling, event fan-out, telemetry tracking, JSON
+ * extraction, registry queries) and prints one JSON document in Google
+ * Benchmark's layout, so before/after runs of a change can be diffed with
+ * the usual tools. Needs no models; it runs on a host or on a device:
+ *
+ *   adb push rac_bench /data/local/tmp/ && adb shell /data/local/tmp/rac_bench
+ *
+ * Each benchmark runs its loop with a doubling iteration count until one
+ * run takes at least --min-time-ms, and reports that run.
+ *
+ * Usage:
+ *   rac_bench [--filter <substring>] [--min-time-ms N] [--output report.json] [--list]
+ */
+
+#include <sys/utsname.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rac/core/rac_audio_utils.h"
+#include "rac/core/rac_core.h"
+#include "rac/core/rac_platform_adapter.h"
+#include "rac/features/llm/rac_llm_structured_output.h"
+#include "rac/features/vad/rac_vad_energy.h"
+#include "rac/infrastructure/events/rac_events.h"
+#include "rac/infrastructure/model_management/rac_model_registry.h"
+#include "rac/infrastructure/model_management/rac_model_types.h"
+#include "rac/infrastructure/telemetry/rac_telemetry_manager.h"
+
+namespace {
+
+// =============================================================================
+// HARNESS
+// =============================================================================
+
+// Loop state handed to a benchmark body. The body does its setup, then runs
+// `while (state.keep_running())` around the measured work.
+class State {
+   public:
+    State(int64_t iterations, int64_t arg) : iterations_(iterations), arg_(arg) {}
+
+    bool keep_running() {
+        if (done_ == 0) {
+            start_timer();
+        }
+        if (done_ == iterations_) {
+            stop_timer();
+            return false;
+        }
+        ++done_;
+        return true;
+    }
+
+    int64_t iterations() const { return iterations_; }
+    int64_t arg() const { return arg_; }
+
+    void set_items_processed(int64_t items) { items_ = items; }
+    void set_bytes_processed(int64_t bytes) { bytes_ = bytes; }
+    void set_error(const char* message) { error_ = message; }
+
+    double real_ns() const { return real_ns_; }
+    double cpu_ns() const { return cpu_ns_; }
+    int64_t items() const { return items_; }
+    int64_t bytes() const { return bytes_; }
+    const std::string& error() const { return error_; }
+
+   private:
+    static double thread_cpu_ns() {
+        timespec ts = {};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<double>(ts.tv_sec) * 1e9 + static_cast<double>(ts.tv_nsec);
+    }
+
+    void start_timer() {
+        real_start_ = std::chrono::steady_clock::now();
+        cpu_start_ = thread_cpu_ns();
+        running_ = true;
+    }
+
+    void stop_timer() {
+        if (!running_) {
+            return;
+        }
+        real_ns_ += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() -
+                                                             real_start_)
+                        .count();
+        cpu_ns_ += thread_cpu_ns() - cpu_start_;
+        running_ = false;
+    }
+
+    int64_t iterations_;
+    int64_t arg_;
+    int64_t done_ = 0;
+    bool running_ = false;
+    std::chrono::steady_clock::time_point real_start_;
+    double cpu_start_ = 0.0;
+    double real_ns_ = 0.0;
+    double cpu_ns_ = 0.0;
+    int64_t items_ = 0;
+    int64_t bytes_ = 0;
+    std::string error_;
+};
+
+using BenchmarkFn = void (*)(State&);
+
+struct Benchmark {
+    const char* name;
+    BenchmarkFn fn;
+    std::vector<int64_t> args;  // One run per argument; empty runs once without one
+};
+
+// Prevents the compiler from discarding a result
+template <typename T>
+void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Deterministic speech-like test signal: a tone burst every other 100 ms over noise
+std::vector<float> make_signal(size_t samples, int32_t sample_rate) {
+    std::vector<float> signal(samples);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < samples; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = (static_cast<float>(seed >> 8) / 16777216.0f - 0.5f) * 0.002f;
+        bool voiced = (i / static_cast<size_t>(sample_rate / 10)) % 2 == 1;
+        float tone = voiced ? 0.3f * std::sin(static_cast<float>(i) * 0.0785f) : 0.0f;
+        signal[i] = tone + noise;
+    }
+    return signal;
+}
+
+// =============================================================================
+// AUDIO
+// =============================================================================
+
+// One 20 ms frame at 16 kHz per iteration, as the voice pipeline feeds it
+void bm_energy_vad_process_audio(State& state) {
+    rac_energy_vad_config_t config = RAC_ENERGY_VAD_CONFIG_DEFAULT;
+    config.mode = static_cast<rac_energy_vad_mode_t>(state.arg());
+    rac_energy_vad_handle_t vad = nullptr;
+    if (rac_energy_vad_create(&config, &vad) != RAC_SUCCESS ||
+        rac_energy_vad_initialize(vad) != RAC_SUCCESS || rac_energy_vad_start(vad) != RAC_SUCCESS) {
+        state.set_error("Cannot start energy VAD");
+        rac_energy_vad_destroy(vad);
+        return;
+    }
+
+    const size_t frame = 320;
+    const std::vector<float> signal = make_signal(16000 * 4, 16000);
+    size_t offset = 0;
+    rac_bool_t has_voice = RAC_FALSE;
+    while (state.keep_running()) {
+        rac_energy_vad_process_audio(vad, signal.data() + offset, frame, &has_voice);
+        do_not_optimize(has_voice);
+        offset = (offset + frame) % (signal.size() - frame);
+    }
+    state.set_items_processed(state.iterations() * static_cast<int64_t>(frame));
+    rac_energy_vad_destroy(vad);
+}
+
+// One second of 22.05 kHz TTS output per iteration
+void bm_audio_float32_to_wav(State& state) {
+    const int32_t rate = 22050;
+    const std::vector<float> pcm = make_signal(static_cast<size_t>(rate), rate);
+    const size_t pcm_size = pcm.size() * sizeof(float);
+    while (state.keep_running()) {
+        void* wav = nullptr;
+        size_t wav_size = 0;
+        rac_audio_float32_to_wav(pcm.data(), pcm_size, rate, &wav, &wav_size);
+        do_not_optimize(wav_size);
+        rac_free(wav);
+    }
+    state.set_bytes_processed(state.iterations() * static_cast<int64_t>(pcm_size));
+}
+
+// 10 ms frames from arg Hz to 16 kHz, with filter state carried across frames
+void bm_audio_resampler_process(State& state) {
+    const int32_t input_rate = static_cast<int32_t>(state.arg());
+    rac_audio_resampler_t resampler = nullptr;
+    if (rac_audio_resampler_create(input_rate, 16000, &resampler) != RAC_SUCCESS) {
+        state.set_error("Cannot create resampler");
+        return;
+    }
+    const size_t frame = static_cast<size_t>(input_rate / 100);
+    const std::vector<float> input = make_signal(frame * 100, input_rate);
+    std::vector<float> output(rac_audio_resampler_max_output(resampler, frame));
+    size_t offset = 0;
+    while (state.keep_running()) {
+        size_t written = 0;
+        rac_audio_resampler_process(resampler, input.data() + offset, frame, output.data(),
+                                    output.size(), &written);
+        do_not_optimize(written);
+        offset = (offset + frame) % input.size();
+    }
+    state.set_items_processed(state.iterations() * static_cast<int64_t>(frame));
+    rac_audio_resampler_destroy(resampler);
+}
+
+// =============================================================================
+// EVENTS
+// =============================================================================
+
+void count_event(const rac_event_t* event, void* user_data) {
+    do_not_optimize(event->type);
+    ++*static_cast<int64_t*>(user_data);
+}
+
+// Publish to arg subscribers, including delivery: the dispatcher is drained
+// every 256 events and at the end, so the result is sustained throughput
+void bm_event_publish(State& state) {
+    const int64_t subscribers = state.arg();
+    std::vector<int64_t> counts(static_cast<size_t>(subscribers), 0);
+    std::vector<uint64_t> ids;
+    for (int64_t i = 0; i < subscribers; ++i) {
+        ids.push_back(rac_event_subscribe(RAC_EVENT_CATEGORY_LLM, count_event, &counts[i]));
+    }
+
+    rac_event_t event = {};
+    event.id = "bench-event";
+    event.type = "llm.generation.streaming";
+    event.category = RAC_EVENT_CATEGORY_LLM;
+    event.destination = RAC_EVENT_DESTINATION_PUBLIC_ONLY;
+    event.properties_json = "{\"model_id\":\"bench\",\"tokens\":1}";
+    int64_t published = 0;
+    while (state.keep_running()) {
+        rac_event_publish(&event);
+        if (++published % 256 == 0) {
+            rac_event_flush(-1);
+        }
+    }
+    rac_event_flush(-1);
+
+    for (uint64_t id : ids) {
+        rac_event_unsubscribe(id);
+    }
+    state.set_items_processed(state.iterations());
+}
+
+// =============================================================================
+// TELEMETRY
+// =============================================================================
+
+// Production manager without an HTTP callback: full batches are handed to
+// the flusher and discarded, so this measures the caller's side of track
+void bm_telemetry_manager_track(State& state) {
+    rac_telemetry_manager_t* manager =
+        rac_telemetry_manager_create(RAC_ENV_PRODUCTION, "bench-device", "bench", "0.0.0");
+    if (!manager) {
+        state.set_error("Cannot create telemetry manager");
+        return;
+    }
+    rac_telemetry_manager_set_device_info(manager, "bench-model", "1.0");
+
+    rac_telemetry_payload_t payload = rac_telemetry_payload_default();
+    payload.id = "00000000-0000-4000-8000-000000000000";
+    payload.event_type = "llm.generation.completed";
+    payload.modality = "llm";
+    payload.model_id = "bench-model";
+    payload.framework = "llamacpp";
+    payload.processing_time_ms = 123.4;
+    payload.success = RAC_TRUE;
+    payload.has_success = RAC_TRUE;
+    payload.input_tokens = 64;
+    payload.output_tokens = 128;
+    payload.total_tokens = 192;
+    while (state.keep_running()) {
+        rac_telemetry_manager_track(manager, &payload);
+    }
+
+    rac_telemetry_manager_destroy(manager);
+    state.set_items_processed(state.iterations());
+}
+
+// =============================================================================
+// STRUCTURED OUTPUT
+// =============================================================================
+
+// A typical reply: prose, then a fenced JSON object with nesting and escapes
+void bm_structured_output_extract_json(State& state) {
+    std::string text =
+        "Sure! Here is the information you asked for, formatted as requested.\n\n```json\n";
+    text += "{\"name\": \"Ada \\\"Countess\\\" Lovelace\", \"born\": 1815, \"tags\": [";
+    for (int i = 0; i < 32; ++i) {
+        text += (i ? ", " : "") + std::string("{\"id\": ") + std::to_string(i) +
+                ", \"label\": \"item {" + std::to_string(i) + "}\"}";
+    }
+    text += "], \"notes\": null}\n```\nLet me know if you need anything else.";
+
+    while (state.keep_running()) {
+        char* json = nullptr;
+        size_t length = 0;
+        rac_structured_output_extract_json(text.c_str(), &json, &length);
+        do_not_optimize(length);
+        rac_free(json);
+    }
+    state.set_bytes_processed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+
+// =============================================================================
+// MODEL REGISTRY
+// =============================================================================
+
+// Registry with arg models across three frameworks, like a fetched catalog
+rac_model_registry_handle_t make_registry(int64_t models) {
+    rac_model_registry_handle_t registry = nullptr;
+    if (rac_model_registry_create(&registry) != RAC_SUCCESS) {
+        return nullptr;
+    }
+    static const rac_inference_framework_t kFrameworks[] = {
+        RAC_FRAMEWORK_LLAMACPP, RAC_FRAMEWORK_ONNX, RAC_FRAMEWORK_SYSTEM_TTS};
+    static const char* const kTags[] = {"chat", "small"};
+    for (int64_t i = 0; i < models; ++i) {
+        std::string id = "model-" + std::to_string(i);
+        std::string url = "https://example.com/models/" + id + ".gguf";
+        rac_model_info_t model = {};
+        model.id = const_cast<char*>(id.c_str());
+        model.name = const_cast<char*>(id.c_str());
+        model.category = RAC_MODEL_CATEGORY_LANGUAGE;
+        model.framework = kFrameworks[i % 3];
+        model.download_url = const_cast<char*>(url.c_str());
+        model.download_size = 512 * 1024 * 1024;
+        model.context_length = 4096;
+        model.tags = const_cast<char**>(kTags);
+        model.tag_count = 2;
+        rac_model_registry_save(registry, &model);
+    }
+    return registry;
+}
+
+void bm_model_registry_get(State& state) {
+    rac_model_registry_handle_t registry = make_registry(state.arg());
+    if (!registry) {
+        state.set_error("Cannot create registry");
+        return;
+    }
+    int64_t i = 0;
+    while (state.keep_running()) {
+        std::string id = "model-" + std::to_string(i++ % state.arg());
+        rac_model_info_t* model = nullptr;
+        rac_model_registry_get(registry, id.c_str(), &model);
+        do_not_optimize(model);
+        rac_model_info_free(model);
+    }
+    rac_model_registry_destroy(registry);
+    state.set_items_processed(state.iterations());
+}
+
+void bm_model_registry_acquire(State& state) {
+    rac_model_registry_handle_t registry = make_registry(state.arg());
+    if (!registry) {
+        state.set_error("Cannot create registry");
+        return;
+    }
+    int64_t i = 0;
+    while (state.keep_running()) {
+        std::string id = "model-" + std::to_string(i++ % state.arg());
+        const rac_model_info_t* model = nullptr;
+        if (rac_model_registry_acquire(registry, id.c_str(), &model) == RAC_SUCCESS) {
+            do_not_optimize(model->context_length);
+            rac_model_registry_release(registry, model);
+        }
+    }
+    rac_model_registry_destroy(registry);
+    state.set_items_processed(state.iterations());
+}
+
+void bm_model_registry_get_by_frameworks(State& state) {
+    rac_model_registry_handle_t registry = make_registry(state.arg());
+    if (!registry) {
+        state.set_error("Cannot create registry");
+        return;
+    }
+    const rac_inference_framework_t framework = RAC_FRAMEWORK_LLAMACPP;
+    while (state.keep_running()) {
+        rac_model_info_t** models = nullptr;
+        size_t count = 0;
+        rac_model_registry_get_by_frameworks(registry, &framework, 1, &models, &count);
+        do_not_optimize(count);
+        rac_model_info_array_free(models, count);
+    }
+    rac_model_registry_destroy(registry);
+    state.set_items_processed(state.iterations());
+}
+
+const Benchmark kBenchmarks[] = {
+    {"energy_vad_process_audio", bm_energy_vad_process_audio,
+     {RAC_ENERGY_VAD_MODE_RMS, RAC_ENERGY_VAD_MODE_SPECTRAL}},
+    {"audio_float32_to_wav", bm_audio_float32_to_wav, {}},
+    {"audio_resampler_process", bm_audio_resampler_process, {44100, 48000}},
+    {"event_publish", bm_event_publish, {0, 1, 4, 16}},
+    {"telemetry_manager_track", bm_telemetry_manager_track, {}},
+    {"structured_output_extract_json", bm_structured_output_extract_json, {}},
+    {"model_registry_get", bm_model_registry_get, {16, 256}},
+    {"model_registry_acquire", bm_model_registry_acquire, {16, 256}},
+    {"model_registry_get_by_frameworks", bm_model_registry_get_by_frameworks, {16, 256}},
+};
+
+// =============================================================================
+// RUNNER
+// =============================================================================
+
+struct Result {
+    std::string name;
+    int64_t iterations = 0;
+    double real_ns = 0.0;
+    double cpu_ns = 0.0;
+    int64_t items = 0;
+    int64_t bytes = 0;
+    std::string error;
+};
+
+Result run_benchmark(const Benchmark& benchmark, const int64_t* arg, double min_time_ms) {
+    Result result;
+    result.name = benchmark.name;
+    if (arg) {
+        result.name += "/" + std::to_string(*arg);
+    }
+
+    // Stop doubling past min time, or at a cap for primitives the compiler folds away
+    const int64_t kMaxIterations = 1000000000;
+    for (int64_t iterations = 1;; iterations *= 2) {
+        State state(iterations, arg ? *arg : 0);
+        benchmark.fn(state);
+        if (!state.error().empty()) {
+            result.error = state.error();
+            return result;
+        }
+        if (state.real_ns() >= min_time_ms * 1e6 || iterations >= kMaxIterations) {
+            result.iterations = iterations;
+            result.real_ns = state.real_ns();
+            result.cpu_ns = state.cpu_ns();
+            result.items = state.items();
+            result.bytes = state.bytes();
+            return result;
+        }
+    }
+}
+
+void write_escaped(FILE* out, const std::string& s) {
+    fputc('"', out);
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+        }
+        fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+void write_report(FILE* out, const std::vector<Result>& results) {
+    utsname system = {};
+    uname(&system);
+    char date[32] = {};
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"context\": {\n");
+    fprintf(out, "    \"date\": \"%s\",\n", date);
+    fprintf(out, "    \"host_name\": ");
+    write_escaped(out, system.nodename);
+    fprintf(out, ",\n    \"system\": ");
+    write_escaped(out, std::string(system.sysname) + " " + system.release + " " + system.machine);
+    fprintf(out, ",\n    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+#if defined(NDEBUG)
+    fprintf(out, "    \"library_build_type\": \"release\"\n");
+#else
+    fprintf(out, "    \"library_build_type\": \"debug\"\n");
+#endif
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        fprintf(out, "    {\n      \"name\": ");
+        write_escaped(out, r.name);
+        if (!r.error.empty()) {
+            fprintf(out, ",\n      \"error_occurred\": true,\n      \"error_message\": ");
+            write_escaped(out, r.error);
+        } else {
+            const double seconds = r.real_ns / 1e9;
+            fprintf(out, ",\n      \"iterations\": %lld,\n", static_cast<long long>(r.iterations));
+            fprintf(out, "      \"real_time\": %.3f,\n", r.real_ns / r.iterations);
+            fprintf(out, "      \"cpu_time\": %.3f,\n", r.cpu_ns / r.iterations);
+            fprintf(out, "      \"time_unit\": \"ns\"");
+            if (r.items > 0 && seconds > 0.0) {
+                fprintf(out, ",\n      \"items_per_second\": %.1f", r.items / seconds);
+            }
+            if (r.bytes > 0 && seconds > 0.0) {
+                fprintf(out, ",\n      \"bytes_per_second\": %.1f", r.bytes / seconds);
+            }
+        }
+        fprintf(out, "\n    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n");
+    fprintf(out, "}\n");
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+void bench_log(rac_log_level_t level, const char* category, const char* message, void*) {
+    if (level >= RAC_LOG_ERROR) {
+        fprintf(stderr, "[%s] %s\n", category ? category : "RAC", message ? message : "");
+    }
+}
+
+int64_t bench_now_ms(void*) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [--filter <substring>] [--min-time-ms N] [--output report.json] "
+            "[--list]\n",
+            argv0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string output;
+    double min_time_ms = 500.0;
+    bool list = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--list") {
+            list = true;
+        } else if (i + 1 < argc && arg == "--filter") {
+            filter = argv[++i];
+        } else if (i + 1 < argc && arg == "--output") {
+            output = argv[++i];
+        } else if (i + 1 < argc && arg == "--min-time-ms") {
+            min_time_ms = atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    rac_platform_adapter_t adapter = {};
+    adapter.log = bench_log;
+    adapter.now_ms = bench_now_ms;
+    rac_config_t config = {};
+    config.platform_adapter = &adapter;
+    config.log_level = RAC_LOG_ERROR;
+    config.log_tag = "Bench";
+    if (rac_init(&config) != RAC_SUCCESS) {
+        fprintf(stderr, "rac_init failed\n");
+        return 1;
+    }
+
+    std::vector<Result> results;
+    for (const Benchmark& benchmark : kBenchmarks) {
+        std::vector<const int64_t*> args;
+        for (const int64_t& arg : benchmark.args) {
+            args.push_back(&arg);
+        }
+        if (args.empty()) {
+            args.push_back(nullptr);
+        }
+        for (const int64_t* arg : args) {
+            std::string name = benchmark.name;
+            if (arg) {
+                name += "/" + std::to_string(*arg);
+            }
+            if (!filter.empty() && name.find(filter) == std::string::npos) {
+                continue;
+            }
+            if (list) {
+                printf("%s\n", name.c_str());
+                continue;
+            }
+            fprintf(stderr, "Running %s\n", name.c_str());
+            results.push_back(run_benchmark(benchmark, arg, min_time_ms));
+        }
+    }
+
+    if (!list) {
+        FILE* out = stdout;
+        if (!output.empty()) {
+            out = fopen(output.c_str(), "w");
+            if (!out) {
+                fprintf(stderr, "Cannot write %s\n", output.c_str());
+                out = stdout;
+            }
+        }
+        write_report(out, results);
+        if (out != stdout) {
+            fclose(out);
+        }
+    }
+
+    rac_shutdown();
+    for (const Result& r : results) {
+        if (!r.error.empty()) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,805 @@
+/**
+ * @file stt_bench.cpp
+ * @brief RunAnywhere Commons - STT Real-Time-Factor Benchmark
+ *
+ * Runs the same utterance corpus through the whisper.cpp and ONNX
+ * (sherpa-onnx) STT backends, in batch mode (one transcribe call per
+ * utterance) and streaming mode (audio fed in chunks, decoded as it
+ * arrives). Reports real-time factor, partial-result latency, final
+ * latency, word error rate against the corpus transcripts and peak RSS,
+ * tagged with the backend versions from VERSIONS.
+ *
+ * With --baseline, the run is compared with an earlier report and the exit
+ * code is 3 if RTF or final latency grew by more than --tolerance, or WER
+ * by more than --wer-tolerance, so a whisper.cpp or sherpa-onnx bump that
+ * regresses either shows up in CI.
+ *
+ * Partial latency is the time from feeding a chunk to the decode that
+ * updated the transcript; final latency is the time from the end of input
+ * to the final transcript. With --realtime, chunks are fed at the pace of
+ * the audio, as from a microphone; otherwise as fast as they are decoded.
+ *
+ * Usage:
+ *   rac_stt_bench --corpus <dir|list> [--whisper <model.bin>] [--onnx <model dir>]
+ *                 [--mode batch,stream] [--chunk-ms 100] [--step-ms 0] [--threads N]
+ *                 [--language en] [--realtime] [--iterations N] [--warmup N]
+ *                 [--output report.json] [--baseline old.json] [--tolerance 0.1]
+ *                 [--wer-tolerance 0.01] [--verbose]
+ */
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "rac/core/rac_core.h"
+#include "rac/core/rac_platform_adapter.h"
+#include "rac/features/stt/rac_stt_types.h"
+
+#if defined(RAC_BENCH_HAS_WHISPERCPP)
+#include "rac/backends/rac_stt_whispercpp.h"
+#endif
+#if defined(RAC_BENCH_HAS_ONNX)
+#include "rac/backends/rac_stt_onnx.h"
+#endif
+
+#include "bench_corpus.h"
+
+#if !defined(RAC_BENCH_WHISPERCPP_VERSION)
+#define RAC_BENCH_WHISPERCPP_VERSION "unknown"
+#endif
+#if !defined(RAC_BENCH_SHERPA_ONNX_VERSION)
+#define RAC_BENCH_SHERPA_ONNX_VERSION "unknown"
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using rac_bench::kCorpusSampleRate;
+using rac_bench::Utterance;
+
+struct Options {
+    std::string corpus;
+    std::string whisper_path;
+    std::string onnx_path;
+    std::string language = "en";
+    std::string output;
+    std::string baseline;
+    bool batch = true;
+    bool stream = true;
+    bool realtime = false;
+    int chunk_ms = 100;
+    int step_ms = 0;
+    int threads = 0;
+    int iterations = 1;
+    int warmup = 1;
+    double tolerance = 0.10;
+    double wer_tolerance = 0.01;
+};
+
+// One transcribed utterance
+struct Sample {
+    bool ok = false;
+    double audio_seconds = 0.0;
+    double compute_ms = 0.0;
+    double final_latency_ms = 0.0;
+    std::vector<double> partial_latency_ms;
+    std::string text;
+};
+
+double ms_since(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+// =============================================================================
+// PLATFORM ADAPTER - Minimal host implementation
+// =============================================================================
+
+rac_log_level_t g_log_level = RAC_LOG_WARNING;
+
+void bench_log(rac_log_level_t level, const char* category, const char* message, void*) {
+    if (level >= g_log_level) {
+        fprintf(stderr, "[%s] %s\n", category ? category : "RAC", message ? message : "");
+    }
+}
+
+int64_t bench_now_ms(void*) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// =============================================================================
+// MEMORY
+// =============================================================================
+
+// Starts a new peak RSS window where the kernel allows it (Linux, Android)
+void reset_peak_rss() {
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    if (file) {
+        fputs("5", file);
+        fclose(file);
+    }
+}
+
+// Peak RSS since reset_peak_rss, or of the whole process where it cannot be reset
+long peak_rss_kb() {
+    FILE* file = fopen("/proc/self/status", "r");
+    if (file) {
+        char line[256];
+        long kb = -1;
+        while (fgets(line, sizeof(line), file)) {
+            if (strncmp(line, "VmHWM:", 6) == 0) {
+                kb = atol(line + 6);
+                break;
+            }
+        }
+        fclose(file);
+        if (kb >= 0) {
+            return kb;
+        }
+    }
+    rusage usage = {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;  // bytes on Darwin
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+// =============================================================================
+// WORD ERROR RATE
+// =============================================================================
+
+// Lowercase words without punctuation, so formatting differences are not errors
+std::vector<std::string> normalize_words(const std::string& text) {
+    std::vector<std::string> words;
+    std::string word;
+    for (char c : text) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (std::isalnum(u) || c == '\'' || u >= 0x80) {
+            word += static_cast<char>(std::tolower(u));
+        } else if (!word.empty()) {
+            words.push_back(word);
+            word.clear();
+        }
+    }
+    if (!word.empty()) {
+        words.push_back(word);
+    }
+    return words;
+}
+
+// Word-level edit distance
+size_t word_errors(const std::vector<std::string>& reference,
+                   const std::vector<std::string>& hypothesis) {
+    std::vector<size_t> row(hypothesis.size() + 1);
+    for (size_t j = 0; j < row.size(); ++j) {
+        row[j] = j;
+    }
+    for (size_t i = 1; i <= reference.size(); ++i) {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= hypothesis.size(); ++j) {
+            size_t above = row[j];
+            size_t substitution = diagonal + (reference[i - 1] == hypothesis[j - 1] ? 0 : 1);
+            row[j] = std::min({above + 1, row[j - 1] + 1, substitution});
+            diagonal = above;
+        }
+    }
+    return row[hypothesis.size()];
+}
+
+// =============================================================================
+// BACKENDS
+// =============================================================================
+
+class SttBackend {
+   public:
+    virtual ~SttBackend() = default;
+    virtual const char* name() const = 0;
+    virtual const char* version() const = 0;
+    virtual bool supports_streaming() const = 0;
+    virtual Sample transcribe(const std::vector<float>& audio) = 0;
+    virtual Sample stream(const std::vector<float>& audio, const Options& options) = 0;
+};
+
+// Paces chunked input and records when each chunk went in
+class ChunkFeeder {
+   public:
+    ChunkFeeder(const std::vector<float>& audio, const Options& options)
+        : audio_(audio),
+          chunk_(static_cast<size_t>(kCorpusSampleRate) * options.chunk_ms / 1000),
+          realtime_(options.realtime),
+          start_(Clock::now()) {}
+
+    // Next chunk, or false at the end of the audio
+    bool next(const float** out_samples, size_t* out_count) {
+        if (offset_ >= audio_.size()) {
+            return false;
+        }
+        const size_t count = std::min(chunk_, audio_.size() - offset_);
+        if (realtime_) {
+            // A microphone delivers a chunk once all of it has been recorded
+            const double due_ms = static_cast<double>(offset_ + count) * 1000.0 / kCorpusSampleRate;
+            const double wait_ms = due_ms - ms_since(start_);
+            if (wait_ms > 0.0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(
+                    static_cast<int64_t>(wait_ms * 1000.0)));
+            }
+        }
+        *out_samples = audio_.data() + offset_;
+        *out_count = count;
+        offset_ += count;
+        fed_at_ = Clock::now();
+        return true;
+    }
+
+    Clock::time_point fed_at() const { return fed_at_; }
+
+   private:
+    const std::vector<float>& audio_;
+    size_t chunk_;
+    bool realtime_;
+    Clock::time_point start_;
+    Clock::time_point fed_at_;
+    size_t offset_ = 0;
+};
+
+#if defined(RAC_BENCH_HAS_WHISPERCPP)
+class WhisperBackend : public SttBackend {
+   public:
+    explicit WhisperBackend(rac_handle_t handle, const Options& options)
+        : handle_(handle), language_(options.language) {}
+    ~WhisperBackend() override { rac_stt_whispercpp_destroy(handle_); }
+
+    static std::unique_ptr<SttBackend> create(const Options& options) {
+        rac_stt_whispercpp_config_t config = RAC_STT_WHISPERCPP_CONFIG_DEFAULT;
+        config.num_threads = options.threads;
+        config.language = options.language.c_str();
+        config.warmup = RAC_FALSE;  // The bench warms up itself
+        rac_handle_t handle = nullptr;
+        if (rac_stt_whispercpp_create(options.whisper_path.c_str(), &config, &handle) !=
+            RAC_SUCCESS) {
+            fprintf(stderr, "Cannot load whisper.cpp model %s\n", options.whisper_path.c_str());
+            return nullptr;
+        }
+        return std::unique_ptr<SttBackend>(new WhisperBackend(handle, options));
+    }
+
+    const char* name() const override { return "whispercpp"; }
+    const char* version() const override { return RAC_BENCH_WHISPERCPP_VERSION; }
+    bool supports_streaming() const override { return true; }
+
+    Sample transcribe(const std::vector<float>& audio) override {
+        Sample sample;
+        rac_stt_options_t options = RAC_STT_OPTIONS_DEFAULT;
+        options.language = language_.c_str();
+        rac_stt_result_t result = {};
+        Clock::time_point start = Clock::now();
+        sample.ok = rac_stt_whispercpp_transcribe(handle_, audio.data(), audio.size(), &options,
+                                                  &result) == RAC_SUCCESS;
+        sample.compute_ms = ms_since(start);
+        sample.final_latency_ms = sample.compute_ms;
+        sample.text = result.text ? result.text : "";
+        rac_stt_result_free(&result);
+        return sample;
+    }
+
+    Sample stream(const std::vector<float>& audio, const Options& options) override {
+        Sample sample;
+        char* stream_id = nullptr;
+        if (rac_stt_whispercpp_stream_create(handle_, language_.c_str(), options.step_ms,
+                                             &stream_id) != RAC_SUCCESS) {
+            return sample;
+        }
+
+        std::string transcript;
+        ChunkFeeder feeder(audio, options);
+        const float* chunk = nullptr;
+        size_t count = 0;
+        bool ok = true;
+        while (ok && feeder.next(&chunk, &count)) {
+            Clock::time_point start = Clock::now();
+            ok = rac_stt_whispercpp_stream_feed(handle_, stream_id, chunk, count,
+                                                kCorpusSampleRate) == RAC_SUCCESS;
+            rac_stt_whispercpp_partial_t partial = {};
+            rac_result_t result = rac_stt_whispercpp_stream_decode(handle_, stream_id, &partial);
+            if (result == RAC_SUCCESS) {
+                std::string text = joined(partial);
+                if (text != transcript) {
+                    sample.partial_latency_ms.push_back(ms_since(feeder.fed_at()));
+                    transcript = text;
+                }
+                rac_stt_whispercpp_partial_free(&partial);
+            } else if (result != RAC_ERROR_BACKEND_NOT_READY) {
+                ok = false;
+            }
+            sample.compute_ms += ms_since(start);
+        }
+
+        Clock::time_point end_of_input = Clock::now();
+        rac_stt_whispercpp_stream_finish(handle_, stream_id);
+        bool final = false;
+        for (int step = 0; ok && !final && step < 1000; ++step) {
+            rac_stt_whispercpp_partial_t partial = {};
+            ok = rac_stt_whispercpp_stream_decode(handle_, stream_id, &partial) == RAC_SUCCESS;
+            if (ok) {
+                transcript = joined(partial);
+                final = partial.is_final == RAC_TRUE;
+                rac_stt_whispercpp_partial_free(&partial);
+            }
+        }
+        sample.final_latency_ms = ms_since(end_of_input);
+        sample.compute_ms += sample.final_latency_ms;
+        rac_stt_whispercpp_stream_destroy(handle_, stream_id);
+        rac_free(stream_id);
+
+        sample.ok = ok && final;
+        sample.text = transcript;
+        return sample;
+    }
+
+   private:
+    static std::string joined(const rac_stt_whispercpp_partial_t& partial) {
+        std::string text = partial.committed_text ? partial.committed_text : "";
+        if (partial.tentative_text && partial.tentative_text[0] != '\0') {
+            text += (text.empty() ? "" : " ") + std::string(partial.tentative_text);
+        }
+        return text;
+    }
+
+    rac_handle_t handle_;
+    std::string language_;
+};
+#endif
+
+#if defined(RAC_BENCH_HAS_ONNX)
+class OnnxBackend : public SttBackend {
+   public:
+    explicit OnnxBackend(rac_handle_t handle) : handle_(handle) {}
+    ~OnnxBackend() override { rac_stt_onnx_destroy(handle_); }
+
+    static std::unique_ptr<SttBackend> create(const Options& options) {
+        rac_stt_onnx_config_t config = RAC_STT_ONNX_CONFIG_DEFAULT;
+        config.num_threads = options.threads;
+        rac_handle_t handle = nullptr;
+        if (rac_stt_onnx_create(options.onnx_path.c_str(), &config, &handle) != RAC_SUCCESS) {
+            fprintf(stderr, "Cannot load ONNX STT model %s\n", options.onnx_path.c_str());
+            return nullptr;
+        }
+        return std::unique_ptr<SttBackend>(new OnnxBackend(handle));
+    }
+
+    const char* name() const override { return "onnx"; }
+    const char* version() const override { return RAC_BENCH_SHERPA_ONNX_VERSION; }
+    bool supports_streaming() const override {
+        return rac_stt_onnx_supports_streaming(handle_) == RAC_TRUE;
+    }
+
+    Sample transcribe(const std::vector<float>& audio) override {
+        Sample sample;
+        rac_stt_result_t result = {};
+        Clock::time_point start = Clock::now();
+        sample.ok = rac_stt_onnx_transcribe(handle_, audio.data(), audio.size(), nullptr,
+                                            &result) == RAC_SUCCESS;
+        sample.compute_ms = ms_since(start);
+        sample.final_latency_ms = sample.compute_ms;
+        sample.text = result.text ? result.text : "";
+        rac_stt_result_free(&result);
+        return sample;
+    }
+
+    // Online (transducer) models only: offline ones decode the whole input at once
+    Sample stream(const std::vector<float>& audio, const Options& options) override {
+        Sample sample;
+        rac_handle_t stream = nullptr;
+        if (rac_stt_onnx_create_stream(handle_, &stream) != RAC_SUCCESS) {
+            return sample;
+        }
+
+        std::string transcript;
+        ChunkFeeder feeder(audio, options);
+        const float* chunk = nullptr;
+        size_t count = 0;
+        bool ok = true;
+        while (ok && feeder.next(&chunk, &count)) {
+            Clock::time_point start = Clock::now();
+            ok = rac_stt_onnx_feed_audio(handle_, stream, chunk, count) == RAC_SUCCESS;
+            if (ok && decode_ready(stream, &transcript)) {
+                sample.partial_latency_ms.push_back(ms_since(feeder.fed_at()));
+            }
+            sample.compute_ms += ms_since(start);
+        }
+
+        Clock::time_point end_of_input = Clock::now();
+        rac_stt_onnx_input_finished(handle_, stream);
+        decode_ready(stream, &transcript);
+        char* text = nullptr;
+        if (ok && rac_stt_onnx_decode_stream(handle_, stream, &text) == RAC_SUCCESS && text) {
+            transcript = text;
+        }
+        rac_free(text);
+        sample.final_latency_ms = ms_since(end_of_input);
+        sample.compute_ms += sample.final_latency_ms;
+        rac_stt_onnx_destroy_stream(handle_, stream);
+
+        sample.ok = ok;
+        sample.text = transcript;
+        return sample;
+    }
+
+   private:
+    // Decodes while enough audio is buffered; true if the transcript changed
+    bool decode_ready(rac_handle_t stream, std::string* transcript) {
+        bool changed = false;
+        while (rac_stt_onnx_stream_is_ready(handle_, stream) == RAC_TRUE) {
+            char* text = nullptr;
+            if (rac_stt_onnx_decode_stream(handle_, stream, &text) != RAC_SUCCESS) {
+                break;
+            }
+            if (text && *transcript != text) {
+                *transcript = text;
+                changed = true;
+            }
+            rac_free(text);
+        }
+        return changed;
+    }
+
+    rac_handle_t handle_;
+};
+#endif
+
+// =============================================================================
+// REPORT
+// =============================================================================
+
+struct Run {
+    std::string backend;
+    std::string version;
+    std::string mode;
+    std::vector<Sample> samples;
+    size_t reference_words = 0;
+    size_t word_errors = 0;
+    long peak_rss_kb = -1;
+};
+
+// Nearest-rank percentile
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t i = static_cast<size_t>(p * static_cast<double>(values.size()) + 0.999999);
+    return values[std::min(values.size(), std::max<size_t>(i, 1)) - 1];
+}
+
+nlohmann::json summarize(const std::vector<double>& values) {
+    return {{"p50", percentile(values, 0.50)},
+            {"p95", percentile(values, 0.95)},
+            {"p99", percentile(values, 0.99)},
+            {"max", percentile(values, 1.0)}};
+}
+
+nlohmann::json run_to_json(const Run& run) {
+    double audio_seconds = 0.0;
+    double compute_ms = 0.0;
+    size_t failures = 0;
+    std::vector<double> rtf;
+    std::vector<double> partial;
+    std::vector<double> final;
+    for (const Sample& s : run.samples) {
+        if (!s.ok) {
+            failures++;
+            continue;
+        }
+        audio_seconds += s.audio_seconds;
+        compute_ms += s.compute_ms;
+        rtf.push_back(s.compute_ms / 1000.0 / s.audio_seconds);
+        final.push_back(s.final_latency_ms);
+        partial.insert(partial.end(), s.partial_latency_ms.begin(), s.partial_latency_ms.end());
+    }
+
+    nlohmann::json json = {{"backend", run.backend},
+                           {"version", run.version},
+                           {"mode", run.mode},
+                           {"utterances", run.samples.size()},
+                           {"failures", failures},
+                           {"audio_seconds", audio_seconds},
+                           {"rtf", audio_seconds > 0.0 ? compute_ms / 1000.0 / audio_seconds : 0.0},
+                           {"rtf_per_utterance", summarize(rtf)},
+                           {"final_latency_ms", summarize(final)},
+                           {"peak_rss_kb", run.peak_rss_kb}};
+    if (run.mode == "stream") {
+        json["partial_latency_ms"] = summarize(partial);
+        json["partials"] = partial.size();
+    }
+    if (run.reference_words > 0) {
+        json["wer"] = static_cast<double>(run.word_errors) / run.reference_words;
+    } else {
+        json["wer"] = nullptr;
+    }
+    return json;
+}
+
+// Lists the metrics of report that regressed against baseline
+std::vector<std::string> find_regressions(const nlohmann::json& report,
+                                          const nlohmann::json& baseline,
+                                          const Options& options) {
+    std::vector<std::string> regressions;
+    for (const auto& run : report["runs"]) {
+        for (const auto& old : baseline.value("runs", nlohmann::json::array())) {
+            if (old.value("backend", "") != run["backend"] ||
+                old.value("mode", "") != run["mode"]) {
+                continue;
+            }
+            const std::string label = run["backend"].get<std::string>() + "/" +
+                                      run["mode"].get<std::string>();
+            auto grew = [&](const char* metric, double before, double after) {
+                if (before > 0.0 && after > before * (1.0 + options.tolerance)) {
+                    char line[256];
+                    snprintf(line, sizeof(line), "%s %s: %.4f -> %.4f", label.c_str(), metric,
+                             before, after);
+                    regressions.push_back(line);
+                }
+            };
+            grew("rtf", old.value("rtf", 0.0), run["rtf"].get<double>());
+            if (old.contains("final_latency_ms")) {
+                grew("final_latency_ms p50", old["final_latency_ms"].value("p50", 0.0),
+                     run["final_latency_ms"]["p50"].get<double>());
+            }
+            if (old.contains("wer") && old["wer"].is_number() && run["wer"].is_number() &&
+                run["wer"].get<double>() > old["wer"].get<double>() + options.wer_tolerance) {
+                char line[256];
+                snprintf(line, sizeof(line), "%s wer: %.4f -> %.4f", label.c_str(),
+                         old["wer"].get<double>(), run["wer"].get<double>());
+                regressions.push_back(line);
+            }
+        }
+    }
+    return regressions;
+}
+
+// =============================================================================
+// BENCHMARK
+// =============================================================================
+
+Run run_mode(SttBackend* backend, const char* mode, const std::vector<Utterance>& corpus,
+             const std::vector<std::vector<float>>& audio, const Options& options) {
+    const bool streaming = strcmp(mode, "stream") == 0;
+    auto once = [&](size_t i) {
+        Sample sample = streaming ? backend->stream(audio[i], options)
+                                  : backend->transcribe(audio[i]);
+        sample.audio_seconds = static_cast<double>(audio[i].size()) / kCorpusSampleRate;
+        if (!sample.ok) {
+            fprintf(stderr, "%s %s failed for %s\n", backend->name(), mode,
+                    corpus[i].path.c_str());
+        }
+        return sample;
+    };
+
+    for (int w = 0; w < options.warmup; ++w) {
+        once(static_cast<size_t>(w) % corpus.size());
+    }
+
+    Run run;
+    run.backend = backend->name();
+    run.version = backend->version();
+    run.mode = mode;
+    reset_peak_rss();
+    for (int it = 0; it < options.iterations; ++it) {
+        for (size_t i = 0; i < corpus.size(); ++i) {
+            Sample sample = once(i);
+            if (sample.ok && !corpus[i].reference.empty()) {
+                const std::vector<std::string> reference = normalize_words(corpus[i].reference);
+                run.reference_words += reference.size();
+                run.word_errors += word_errors(reference, normalize_words(sample.text));
+            }
+            run.samples.push_back(std::move(sample));
+        }
+    }
+    run.peak_rss_kb = peak_rss_kb();
+    return run;
+}
+
+void bench_backend(std::unique_ptr<SttBackend> backend, const std::vector<Utterance>& corpus,
+                   const std::vector<std::vector<float>>& audio, const Options& options,
+                   std::vector<Run>* runs) {
+    if (!backend) {
+        return;
+    }
+    if (options.batch) {
+        runs->push_back(run_mode(backend.get(), "batch", corpus, audio, options));
+    }
+    if (options.stream) {
+        if (backend->supports_streaming()) {
+            runs->push_back(run_mode(backend.get(), "stream", corpus, audio, options));
+        } else {
+            fprintf(stderr, "%s model is offline; skipping stream mode\n", backend->name());
+        }
+    }
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s --corpus <dir|list> [--whisper <model.bin>] [--onnx <model dir>]\n"
+            "          [--mode batch,stream] [--chunk-ms 100] [--step-ms 0] [--threads N]\n"
+            "          [--language en] [--realtime] [--iterations N] [--warmup N]\n"
+            "          [--output report.json] [--baseline old.json] [--tolerance 0.1]\n"
+            "          [--wer-tolerance 0.01] [--verbose]\n",
+            argv0);
+}
+
+bool parse_args(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verbose") {
+            g_log_level = RAC_LOG_INFO;
+            continue;
+        }
+        if (arg == "--realtime") {
+            options->realtime = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--corpus") {
+            options->corpus = value;
+        } else if (arg == "--whisper") {
+            options->whisper_path = value;
+        } else if (arg == "--onnx") {
+            options->onnx_path = value;
+        } else if (arg == "--language") {
+            options->language = value;
+        } else if (arg == "--output") {
+            options->output = value;
+        } else if (arg == "--baseline") {
+            options->baseline = value;
+        } else if (arg == "--mode") {
+            std::string modes = value;
+            options->batch = modes.find("batch") != std::string::npos;
+            options->stream = modes.find("stream") != std::string::npos;
+        } else if (arg == "--chunk-ms") {
+            options->chunk_ms = atoi(value);
+        } else if (arg == "--step-ms") {
+            options->step_ms = atoi(value);
+        } else if (arg == "--threads") {
+            options->threads = atoi(value);
+        } else if (arg == "--iterations") {
+            options->iterations = atoi(value);
+        } else if (arg == "--warmup") {
+            options->warmup = atoi(value);
+        } else if (arg == "--tolerance") {
+            options->tolerance = atof(value);
+        } else if (arg == "--wer-tolerance") {
+            options->wer_tolerance = atof(value);
+        } else {
+            return false;
+        }
+    }
+    return !options->corpus.empty() &&
+           (!options->whisper_path.empty() || !options->onnx_path.empty()) &&
+           (options->batch || options->stream) && options->chunk_ms > 0 &&
+           options->iterations > 0 && options->warmup >= 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_args(argc, argv, &options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<Utterance> corpus;
+    if (!rac_bench::load_corpus(options.corpus, &corpus)) {
+        return 1;
+    }
+    std::vector<std::vector<float>> audio;
+    for (const Utterance& utterance : corpus) {
+        std::vector<float> samples(utterance.samples.size());
+        for (size_t i = 0; i < samples.size(); ++i) {
+            samples[i] = static_cast<float>(utterance.samples[i]) / 32768.0f;
+        }
+        audio.push_back(std::move(samples));
+    }
+
+    rac_platform_adapter_t adapter = {};
+    adapter.log = bench_log;
+    adapter.now_ms = bench_now_ms;
+    rac_config_t config = {};
+    config.platform_adapter = &adapter;
+    config.log_level = g_log_level;
+    config.log_tag = "Bench";
+    if (rac_init(&config) != RAC_SUCCESS) {
+        fprintf(stderr, "rac_init failed\n");
+        return 1;
+    }
+
+    std::vector<Run> runs;
+    bool missing_backend = false;
+    if (!options.whisper_path.empty()) {
+#if defined(RAC_BENCH_HAS_WHISPERCPP)
+        bench_backend(WhisperBackend::create(options), corpus, audio, options, &runs);
+#else
+        fprintf(stderr, "Built without the whisper.cpp backend\n");
+        missing_backend = true;
+#endif
+    }
+    if (!options.onnx_path.empty()) {
+#if defined(RAC_BENCH_HAS_ONNX)
+        bench_backend(OnnxBackend::create(options), corpus, audio, options, &runs);
+#else
+        fprintf(stderr, "Built without the ONNX backend\n");
+        missing_backend = true;
+#endif
+    }
+    rac_shutdown();
+
+    nlohmann::json report = {{"benchmark", "stt"},
+                             {"corpus", options.corpus},
+                             {"utterances", corpus.size()},
+                             {"chunk_ms", options.chunk_ms},
+                             {"realtime", options.realtime},
+                             {"runs", nlohmann::json::array()}};
+    size_t failures = 0;
+    for (const Run& run : runs) {
+        nlohmann::json json = run_to_json(run);
+        failures += json["failures"].get<size_t>();
+        report["runs"].push_back(std::move(json));
+    }
+
+    const std::string text = report.dump(2) + "\n";
+    FILE* out = stdout;
+    if (!options.output.empty()) {
+        out = fopen(options.output.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "Cannot write %s\n", options.output.c_str());
+            out = stdout;
+        }
+    }
+    fputs(text.c_str(), out);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    if (!options.baseline.empty()) {
+        std::ifstream file(options.baseline);
+        nlohmann::json baseline = nlohmann::json::parse(file, nullptr, false);
+        if (baseline.is_discarded()) {
+            fprintf(stderr, "Cannot parse baseline %s\n", options.baseline.c_str());
+            return 1;
+        }
+        const std::vector<std::string> regressions = find_regressions(report, baseline, options);
+        for (const std::string& line : regressions) {
+            fprintf(stderr, "Regression: %s\n", line.c_str());
+        }
+        if (!regressions.empty()) {
+            return 3;
+        }
+    }
+    return failures == 0 && !missing_backend && !runs.empty() ? 0 : 1;
+}
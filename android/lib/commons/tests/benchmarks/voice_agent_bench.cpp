@@ -0,0 +1,469 @@
+/**
+ * @file voice_agent_bench.cpp
+ * @brief RunAnywhere Commons - Voice Agent Load/Soak Benchmark
+ *
+ * Replays a corpus of recorded utterances through rac_voice_agent_* from
+ * several threads at once and reports per-stage latency percentiles (from
+ * the turn trace), real-time factors and peak RSS as one JSON document, for
+ * CI trend tracking.
+ *
+ * Utterances are 16 kHz mono Int16 WAV files (or headerless .pcm of the
+ * same format). --corpus takes a directory of them or a text file listing
+ * one path per line.
+ *
+ * Usage:
+ *   rac_voice_agent_bench --stt <model> --llm <model> --tts <voice> --corpus <dir|list>
+ *                         [--mode turn|stream|pipelined] [--concurrency N]
+ *                         [--iterations N] [--warmup N] [--output report.json]
+ */
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rac/core/rac_core.h"
+#include "rac/core/rac_platform_adapter.h"
+#include "rac/features/voice_agent/rac_voice_agent.h"
+
+#include "bench_corpus.h"
+
+#if defined(RAC_BENCH_HAS_LLAMACPP)
+#include "rac/backends/rac_llm_llamacpp.h"
+#endif
+#if defined(RAC_BENCH_HAS_ONNX)
+#include "rac/backends/rac_vad_onnx.h"
+#endif
+#if defined(RAC_BENCH_HAS_WHISPERCPP)
+#include "rac/backends/rac_stt_whispercpp.h"
+#endif
+
+namespace {
+
+using rac_bench::load_corpus;
+using rac_bench::Utterance;
+
+// Corpus audio format expected by rac_voice_agent_process_*
+constexpr int32_t kInputSampleRate = rac_bench::kCorpusSampleRate;
+
+// Names of the trace stages in the report, indexed by rac_voice_turn_stage_t
+const char* const kStageNames[RAC_VOICE_TURN_STAGE_COUNT] = {
+    "turn", "endpoint", "stt", "llm", "llm_first_token", "tts", "tts_first_chunk", "first_audio"};
+
+enum class Mode { Turn, Stream, Pipelined };
+
+struct Options {
+    std::string stt_path;
+    std::string llm_path;
+    std::string tts_path;
+    std::string corpus;
+    std::string output;
+    Mode mode = Mode::Pipelined;
+    int concurrency = 1;
+    int iterations = 1;
+    int warmup = 1;
+};
+
+// One measured turn
+struct TurnSample {
+    bool ok = false;
+    rac_voice_turn_trace_t trace = {};
+    double input_seconds = 0.0;
+    double output_seconds = 0.0;
+};
+
+// =============================================================================
+// PLATFORM ADAPTER - Minimal host implementation
+// =============================================================================
+
+rac_log_level_t g_log_level = RAC_LOG_WARNING;
+
+void bench_log(rac_log_level_t level, const char* category, const char* message, void*) {
+    if (level >= g_log_level) {
+        fprintf(stderr, "[%s] %s\n", category ? category : "RAC", message ? message : "");
+    }
+}
+
+int64_t bench_now_ms(void*) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// =============================================================================
+// TURNS
+// =============================================================================
+
+// Collects the trace and the amount of audio from streamed events
+struct StreamCollector {
+    TurnSample* sample;
+    size_t output_bytes = 0;
+};
+
+double audio_seconds(size_t bytes, rac_voice_audio_format_t format, int32_t sample_rate) {
+    if (sample_rate <= 0) {
+        return 0.0;
+    }
+    size_t bytes_per_sample = format == RAC_VOICE_AUDIO_FORMAT_PCM_F32 ? sizeof(float)
+                                                                       : sizeof(int16_t);
+    return static_cast<double>(bytes / bytes_per_sample) / sample_rate;
+}
+
+void collect_event(const rac_voice_agent_event_t* event, void* user_data) {
+    auto* collector = static_cast<StreamCollector*>(user_data);
+    switch (event->type) {
+        case RAC_VOICE_AGENT_EVENT_AUDIO_SYNTHESIZED:
+        case RAC_VOICE_AGENT_EVENT_AUDIO_CHUNK:
+            collector->sample->output_seconds +=
+                audio_seconds(event->data.audio.audio_size, event->data.audio.format,
+                              event->data.audio.sample_rate);
+            break;
+        case RAC_VOICE_AGENT_EVENT_PROCESSED:
+            collector->sample->trace = event->data.result.trace;
+            break;
+        default:
+            break;
+    }
+}
+
+TurnSample run_turn(rac_voice_agent_handle_t agent, Mode mode, const Utterance& utterance) {
+    TurnSample sample;
+    sample.input_seconds = static_cast<double>(utterance.samples.size()) / kInputSampleRate;
+    const void* audio = utterance.samples.data();
+    size_t audio_size = utterance.samples.size() * sizeof(int16_t);
+
+    rac_result_t result;
+    if (mode == Mode::Turn) {
+        rac_voice_agent_result_t turn = {};
+        result = rac_voice_agent_process_voice_turn(agent, audio, audio_size, &turn);
+        if (result == RAC_SUCCESS) {
+            sample.trace = turn.trace;
+            sample.output_seconds = audio_seconds(turn.synthesized_audio_size, turn.audio_format,
+                                                  turn.audio_sample_rate);
+        }
+        rac_voice_agent_result_free(&turn);
+    } else {
+        StreamCollector collector;
+        collector.sample = &sample;
+        result = mode == Mode::Stream
+                     ? rac_voice_agent_process_stream(agent, audio, audio_size, collect_event,
+                                                      &collector)
+                     : rac_voice_agent_process_stream_pipelined(agent, audio, audio_size,
+                                                                collect_event, &collector);
+    }
+
+    sample.ok = result == RAC_SUCCESS;
+    if (!sample.ok) {
+        fprintf(stderr, "Turn failed for %s: %d\n", utterance.path.c_str(), result);
+    }
+    return sample;
+}
+
+// =============================================================================
+// REPORT
+// =============================================================================
+
+struct Summary {
+    size_t count = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// Nearest-rank percentiles
+Summary summarize(std::vector<double> values) {
+    Summary s;
+    if (values.empty()) {
+        return s;
+    }
+    std::sort(values.begin(), values.end());
+    auto rank = [&values](double p) {
+        size_t i = static_cast<size_t>(p * static_cast<double>(values.size()) + 0.999999);
+        return values[std::min(values.size(), std::max<size_t>(i, 1)) - 1];
+    };
+    s.count = values.size();
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+    }
+    s.mean = sum / static_cast<double>(values.size());
+    s.p50 = rank(0.50);
+    s.p95 = rank(0.95);
+    s.p99 = rank(0.99);
+    s.max = values.back();
+    return s;
+}
+
+void write_summary(FILE* out, const char* name, const Summary& s, bool last) {
+    fprintf(out,
+            "    \"%s\": {\"count\": %zu, \"mean\": %.3f, \"p50\": %.3f, \"p95\": %.3f, "
+            "\"p99\": %.3f, \"max\": %.3f}%s\n",
+            name, s.count, s.mean, s.p50, s.p95, s.p99, s.max, last ? "" : ",");
+}
+
+long peak_rss_kb() {
+    rusage usage = {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;  // bytes on Darwin
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+const char* mode_name(Mode mode) {
+    switch (mode) {
+        case Mode::Turn:
+            return "turn";
+        case Mode::Stream:
+            return "stream";
+        default:
+            return "pipelined";
+    }
+}
+
+void write_report(FILE* out, const Options& options, const std::vector<TurnSample>& samples,
+                  double wall_ms) {
+    std::vector<double> stages[RAC_VOICE_TURN_STAGE_COUNT];
+    std::vector<double> rtf_stt;
+    std::vector<double> rtf_tts;
+    std::vector<double> rtf_turn;
+    size_t failures = 0;
+    double input_seconds = 0.0;
+
+    for (const TurnSample& sample : samples) {
+        if (!sample.ok) {
+            failures++;
+            continue;
+        }
+        input_seconds += sample.input_seconds;
+        for (int32_t s = 0; s < RAC_VOICE_TURN_STAGE_COUNT; ++s) {
+            double ms = rac_voice_turn_trace_stage_ms(&sample.trace,
+                                                      static_cast<rac_voice_turn_stage_t>(s));
+            if (ms >= 0.0) {
+                stages[s].push_back(ms);
+            }
+        }
+        // Processing time over the duration of the audio it consumed or produced
+        double stt_ms = rac_voice_turn_trace_stage_ms(&sample.trace, RAC_VOICE_TURN_STAGE_STT);
+        double tts_ms = rac_voice_turn_trace_stage_ms(&sample.trace, RAC_VOICE_TURN_STAGE_TTS);
+        double turn_ms = rac_voice_turn_trace_stage_ms(&sample.trace, RAC_VOICE_TURN_STAGE_TURN);
+        if (stt_ms >= 0.0 && sample.input_seconds > 0.0) {
+            rtf_stt.push_back(stt_ms / 1000.0 / sample.input_seconds);
+        }
+        if (tts_ms >= 0.0 && sample.output_seconds > 0.0) {
+            rtf_tts.push_back(tts_ms / 1000.0 / sample.output_seconds);
+        }
+        if (turn_ms >= 0.0 && sample.input_seconds > 0.0) {
+            rtf_turn.push_back(turn_ms / 1000.0 / sample.input_seconds);
+        }
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"voice_agent\",\n");
+    fprintf(out, "  \"mode\": \"%s\",\n", mode_name(options.mode));
+    fprintf(out, "  \"concurrency\": %d,\n", options.concurrency);
+    fprintf(out, "  \"turns\": %zu,\n", samples.size());
+    fprintf(out, "  \"failures\": %zu,\n", failures);
+    fprintf(out, "  \"wall_ms\": %.3f,\n", wall_ms);
+    fprintf(out, "  \"turns_per_second\": %.4f,\n",
+            wall_ms > 0.0 ? static_cast<double>(samples.size() - failures) * 1000.0 / wall_ms
+                          : 0.0);
+    fprintf(out, "  \"input_audio_seconds\": %.3f,\n", input_seconds);
+    fprintf(out, "  \"stage_ms\": {\n");
+    for (int32_t s = 0; s < RAC_VOICE_TURN_STAGE_COUNT; ++s) {
+        write_summary(out, kStageNames[s], summarize(stages[s]),
+                      s == RAC_VOICE_TURN_STAGE_COUNT - 1);
+    }
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"rtf\": {\n");
+    write_summary(out, "stt", summarize(rtf_stt), false);
+    write_summary(out, "tts", summarize(rtf_tts), false);
+    write_summary(out, "turn", summarize(rtf_turn), true);
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"peak_rss_kb\": %ld\n", peak_rss_kb());
+    fprintf(out, "}\n");
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s --stt <model> --llm <model> --tts <voice> --corpus <dir|list>\n"
+            "          [--mode turn|stream|pipelined] [--concurrency N] [--iterations N]\n"
+            "          [--warmup N] [--output report.json] [--verbose]\n",
+            argv0);
+}
+
+bool parse_args(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--verbose") {
+            g_log_level = RAC_LOG_INFO;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--stt") {
+            options->stt_path = value;
+        } else if (arg == "--llm") {
+            options->llm_path = value;
+        } else if (arg == "--tts") {
+            options->tts_path = value;
+        } else if (arg == "--corpus") {
+            options->corpus = value;
+        } else if (arg == "--output") {
+            options->output = value;
+        } else if (arg == "--concurrency") {
+            options->concurrency = atoi(value);
+        } else if (arg == "--iterations") {
+            options->iterations = atoi(value);
+        } else if (arg == "--warmup") {
+            options->warmup = atoi(value);
+        } else if (arg == "--mode") {
+            std::string mode = value;
+            if (mode == "turn") {
+                options->mode = Mode::Turn;
+            } else if (mode == "stream") {
+                options->mode = Mode::Stream;
+            } else if (mode == "pipelined") {
+                options->mode = Mode::Pipelined;
+            } else {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return !options->stt_path.empty() && !options->llm_path.empty() &&
+           !options->tts_path.empty() && !options->corpus.empty() && options->concurrency > 0 &&
+           options->iterations > 0 && options->warmup >= 0;
+}
+
+void register_backends() {
+#if defined(RAC_BENCH_HAS_LLAMACPP)
+    rac_backend_llamacpp_register();
+#endif
+#if defined(RAC_BENCH_HAS_ONNX)
+    rac_backend_onnx_register();
+#endif
+#if defined(RAC_BENCH_HAS_WHISPERCPP)
+    rac_backend_whispercpp_register();
+#endif
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_args(argc, argv, &options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<Utterance> corpus;
+    if (!load_corpus(options.corpus, &corpus)) {
+        return 1;
+    }
+
+    rac_platform_adapter_t adapter = {};
+    adapter.log = bench_log;
+    adapter.now_ms = bench_now_ms;
+    rac_config_t config = {};
+    config.platform_adapter = &adapter;
+    config.log_level = g_log_level;
+    config.log_tag = "Bench";
+    if (rac_init(&config) != RAC_SUCCESS) {
+        fprintf(stderr, "rac_init failed\n");
+        return 1;
+    }
+    register_backends();
+
+    rac_voice_agent_handle_t agent = nullptr;
+    if (rac_voice_agent_create_standalone(&agent) != RAC_SUCCESS) {
+        fprintf(stderr, "Cannot create voice agent\n");
+        rac_shutdown();
+        return 1;
+    }
+
+    rac_voice_agent_config_t agent_config = RAC_VOICE_AGENT_CONFIG_DEFAULT;
+    agent_config.stt_config.model_path = options.stt_path.c_str();
+    agent_config.stt_config.model_id = options.stt_path.c_str();
+    agent_config.llm_config.model_path = options.llm_path.c_str();
+    agent_config.llm_config.model_id = options.llm_path.c_str();
+    agent_config.tts_config.voice_path = options.tts_path.c_str();
+    agent_config.tts_config.voice_id = options.tts_path.c_str();
+    rac_result_t result = rac_voice_agent_initialize(agent, &agent_config);
+    if (result != RAC_SUCCESS) {
+        fprintf(stderr, "Cannot load models: %d\n", result);
+        rac_voice_agent_destroy(agent);
+        rac_shutdown();
+        return 1;
+    }
+
+    // Raw Float32 output, so the produced audio duration follows from its size
+    rac_voice_output_config_t output = RAC_VOICE_OUTPUT_CONFIG_DEFAULT;
+    output.format = RAC_VOICE_AUDIO_FORMAT_PCM_F32;
+    rac_voice_agent_set_output_config(agent, &output);
+
+    for (int i = 0; i < options.warmup; ++i) {
+        run_turn(agent, options.mode, corpus[static_cast<size_t>(i) % corpus.size()]);
+    }
+
+    // Workers take the next utterance from a shared counter until the passes are done
+    const size_t total = corpus.size() * static_cast<size_t>(options.iterations);
+    std::vector<TurnSample> samples(total);
+    std::atomic<size_t> next{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int w = 0; w < options.concurrency; ++w) {
+        workers.emplace_back([&] {
+            for (size_t i = next.fetch_add(1); i < total; i = next.fetch_add(1)) {
+                samples[i] = run_turn(agent, options.mode, corpus[i % corpus.size()]);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double wall_ms = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+
+    FILE* out = stdout;
+    if (!options.output.empty()) {
+        out = fopen(options.output.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "Cannot write %s\n", options.output.c_str());
+            out = stdout;
+        }
+    }
+    write_report(out, options, samples, wall_ms);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    size_t failures = static_cast<size_t>(
+        std::count_if(samples.begin(), samples.end(), [](const TurnSample& s) { return !s.ok; }));
+
+    rac_voice_agent_destroy(agent);
+    rac_shutdown();
+    return failures == 0 ? 0 : 1;
+}
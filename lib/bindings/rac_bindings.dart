@@ -29,6 +29,20 @@ final class RacLlmConfig extends Struct {
   external int streaming_enabled;
 }
 
+/// Pixel buffer handed to native code as is; conversion and resizing run in
+/// the native image kernels. format: 0 = RGB8, 1 = RGBA8, 2 = BGRA8.
+final class RacImage extends Struct {
+  external Pointer<Uint8> data;
+  @Int32()
+  external int width;
+  @Int32()
+  external int height;
+  @Int32()
+  external int stride;
+  @Int32()
+  external int format;
+}
+
 final class RacLlmOptions extends Struct {
   @Int32()
   external int max_tokens;
@@ -42,6 +56,38 @@ final class RacLlmOptions extends Struct {
   @Int32()
   external int streaming_enabled;
   external Pointer<Utf8> system_prompt;
+  external Pointer<Utf8> json_schema;
+  @Int32()
+  external int token_healing;
+  external Pointer<Utf8> lora_adapter;
+  @Float()
+  external double lora_scale;
+  @Int32()
+  external int prompt_lookup;
+  @Int32()
+  external int n_samples;
+  @Int32()
+  external int max_prefill_ms;
+  @Int32()
+  external int max_total_ms;
+  @Float()
+  external double min_tokens_per_second;
+  external Pointer<RacImage> images;
+  @Size()
+  external int num_images;
+}
+
+final class RacInferenceMemory extends Struct {
+  @Int64()
+  external int peak_rss_bytes;
+  @Int64()
+  external int rss_delta_bytes;
+  @Int64()
+  external int pss_delta_bytes;
+  @Int64()
+  external int backend_bytes;
+  @Int32()
+  external int peak_is_exact;
 }
 
 final class RacLlmResult extends Struct {
@@ -58,6 +104,83 @@ final class RacLlmResult extends Struct {
   external int total_time_ms;
   @Float()
   external double tokens_per_second;
+  external RacInferenceMemory memory;
+  @Int32()
+  external int stop_reason;
+}
+
+// rac_llm_stop_reason_t
+const int racLlmStopReasonEnd = 0;
+const int racLlmStopReasonMaxTokens = 1;
+const int racLlmStopReasonPrefillDeadline = 2;
+const int racLlmStopReasonDeadline = 3;
+const int racLlmStopReasonTooSlow = 4;
+
+final class RacLlmSample extends Struct {
+  external Pointer<Utf8> text;
+  @Int32()
+  external int completion_tokens;
+  @Double()
+  external double logprob;
+  @Double()
+  external double mean_logprob;
+  @Int32()
+  external int truncated;
+}
+
+final class RacLlmSamples extends Struct {
+  external Pointer<RacLlmSample> samples;
+  @Int32()
+  external int num_samples;
+  @Int32()
+  external int prompt_tokens;
+  @Int64()
+  external int total_time_ms;
+}
+
+final class RacLlmTool extends Struct {
+  external Pointer<Utf8> name;
+  external Pointer<Utf8> description;
+  external Pointer<Utf8> parameters_schema;
+}
+
+// rac_async_event_type_t
+const int racAsyncEventToken = 0;
+const int racAsyncEventPartialTranscript = 1;
+const int racAsyncEventFinalTranscript = 2;
+const int racAsyncEventAudioChunk = 3;
+const int racAsyncEventComplete = 4;
+const int racAsyncEventError = 5;
+const int racAsyncEventToolCall = 6;
+
+// rac_llm_tool_choice_t
+const int racLlmToolChoiceAuto = 0;
+const int racLlmToolChoiceRequired = 1;
+
+// RAC_ERROR_CANCELLED
+const int racErrorCancelled = -380;
+
+final class RacAsyncEvent extends Struct {
+  @Int32()
+  external int type;
+  @Int32()
+  external int error_code;
+  external Pointer<Utf8> text;
+  external Pointer<Uint8> audio_data;
+  @Size()
+  external int audio_size;
+  @Int32()
+  external int prompt_tokens;
+  @Int32()
+  external int completion_tokens;
+  @Int64()
+  external int time_to_first_token_ms;
+  @Int64()
+  external int total_time_ms;
+  @Float()
+  external double tokens_per_second;
+  @Int32()
+  external int stop_reason;
 }
 
 // =============================================================================
@@ -104,6 +227,165 @@ typedef RacLlmComponentGenerateDart = int Function(
 typedef RacLlmResultFreeC = Void Function(Pointer<RacLlmResult> result);
 typedef RacLlmResultFreeDart = void Function(Pointer<RacLlmResult> result);
 
+// rac_async_listener_fn: events arrive via NativeCallable.listener, so the
+// native worker never waits on this isolate
+typedef RacAsyncListenerC = Void Function(Pointer<RacAsyncEvent> event, Pointer<Void> userData);
+
+// rac_llm_component_generate_async
+typedef RacLlmComponentGenerateAsyncC = Int32 Function(
+    Pointer<Void> handle,
+    Pointer<Utf8> prompt,
+    Pointer<RacLlmOptions> options,
+    Pointer<NativeFunction<RacAsyncListenerC>> listener,
+    Pointer<Void> userData,
+    Pointer<Pointer<Void>> outStream);
+typedef RacLlmComponentGenerateAsyncDart = int Function(
+    Pointer<Void> handle,
+    Pointer<Utf8> prompt,
+    Pointer<RacLlmOptions> options,
+    Pointer<NativeFunction<RacAsyncListenerC>> listener,
+    Pointer<Void> userData,
+    Pointer<Pointer<Void>> outStream);
+
+// rac_stt_component_transcribe_async (default options)
+typedef RacSttComponentTranscribeAsyncC = Int32 Function(
+    Pointer<Void> handle,
+    Pointer<Uint8> audioData,
+    Size audioSize,
+    Pointer<Void> options,
+    Pointer<NativeFunction<RacAsyncListenerC>> listener,
+    Pointer<Void> userData,
+    Pointer<Pointer<Void>> outStream);
+typedef RacSttComponentTranscribeAsyncDart = int Function(
+    Pointer<Void> handle,
+    Pointer<Uint8> audioData,
+    int audioSize,
+    Pointer<Void> options,
+    Pointer<NativeFunction<RacAsyncListenerC>> listener,
+    Pointer<Void> userData,
+    Pointer<Pointer<Void>> outStream);
+
+// rac_tts_component_synthesize_async (default options)
+typedef RacTtsComponentSynthesizeAsyncC = Int32 Function(
+    Pointer<Void> handle,
+    Pointer<Utf8> text,
+    Pointer<Void> options,
+    Pointer<NativeFunction<RacAsyncListenerC>> listener,
+    Pointer<Void> userData,
+    Pointer<Pointer<Void>> outStream);
+typedef RacTtsComponentSynthesizeAsyncDart = int Function(
+    Pointer<Void> handle,
+    Pointer<Utf8> text,
+    Pointer<Void> options,
+    Pointer<NativeFunction<RacAsyncListenerC>> listener,
+    Pointer<Void> userData,
+    Pointer<Pointer<Void>> outStream);
+
+// rac_async_stream_cancel / rac_async_stream_release
+typedef RacAsyncStreamC = Void Function(Pointer<Void> stream);
+typedef RacAsyncStreamDart = void Function(Pointer<Void> stream);
+
+// rac_async_event_free
+typedef RacAsyncEventFreeC = Void Function(Pointer<RacAsyncEvent> event);
+typedef RacAsyncEventFreeDart = void Function(Pointer<RacAsyncEvent> event);
+
+// rac_llm_component_save_state / rac_llm_component_restore_state
+typedef RacLlmComponentStateC = Int32 Function(
+    Pointer<Void> handle,
+    Pointer<Utf8> path,
+    Pointer<Int32> out_token_count);
+typedef RacLlmComponentStateDart = int Function(
+    Pointer<Void> handle,
+    Pointer<Utf8> path,
+    Pointer<Int32> out_token_count);
+
+// rac_llm_component_load_lora
+typedef RacLlmComponentLoadLoraC = Int32 Function(
+    Pointer<Void> handle,
+    Pointer<Utf8> name,
+    Pointer<Utf8> path);
+typedef RacLlmComponentLoadLoraDart = int Function(
+    Pointer<Void> handle,
+    Pointer<Utf8> name,
+    Pointer<Utf8> path);
+
+// rac_llm_component_remove_lora
+typedef RacLlmComponentRemoveLoraC = Int32 Function(Pointer<Void> handle, Pointer<Utf8> name);
+typedef RacLlmComponentRemoveLoraDart = int Function(Pointer<Void> handle, Pointer<Utf8> name);
+
+// rac_llm_component_set_lora
+typedef RacLlmComponentSetLoraC = Int32 Function(
+    Pointer<Void> handle,
+    Pointer<Utf8> name,
+    Float scale);
+typedef RacLlmComponentSetLoraDart = int Function(
+    Pointer<Void> handle,
+    Pointer<Utf8> name,
+    double scale);
+
+// rac_llm_component_generate_samples
+typedef RacLlmComponentGenerateSamplesC = Int32 Function(
+    Pointer<Void> handle,
+    Pointer<Utf8> prompt,
+    Pointer<RacLlmOptions> options,
+    Pointer<RacLlmSamples> samples);
+typedef RacLlmComponentGenerateSamplesDart = int Function(
+    Pointer<Void> handle,
+    Pointer<Utf8> prompt,
+    Pointer<RacLlmOptions> options,
+    Pointer<RacLlmSamples> samples);
+
+// rac_llm_samples_free
+typedef RacLlmSamplesFreeC = Void Function(Pointer<RacLlmSamples> samples);
+typedef RacLlmSamplesFreeDart = void Function(Pointer<RacLlmSamples> samples);
+
+// rac_llm_toolset_create
+typedef RacLlmToolsetCreateC = Int32 Function(
+    Pointer<RacLlmTool> tools,
+    Size numTools,
+    Pointer<Pointer<Void>> outToolset);
+typedef RacLlmToolsetCreateDart = int Function(
+    Pointer<RacLlmTool> tools,
+    int numTools,
+    Pointer<Pointer<Void>> outToolset);
+
+// rac_llm_toolset_destroy
+typedef RacLlmToolsetDestroyC = Void Function(Pointer<Void> toolset);
+typedef RacLlmToolsetDestroyDart = void Function(Pointer<Void> toolset);
+
+// rac_llm_component_generate_with_tools_async: tool calls arrive as
+// racAsyncEventToolCall events whose text is {"name": ..., "arguments": ...}
+typedef RacLlmComponentGenerateWithToolsAsyncC = Int32 Function(
+    Pointer<Void> handle,
+    Pointer<Void> toolset,
+    Pointer<Utf8> prompt,
+    Pointer<RacLlmOptions> options,
+    Int32 choice,
+    Pointer<NativeFunction<RacAsyncListenerC>> listener,
+    Pointer<Void> userData,
+    Pointer<Pointer<Void>> outStream);
+typedef RacLlmComponentGenerateWithToolsAsyncDart = int Function(
+    Pointer<Void> handle,
+    Pointer<Void> toolset,
+    Pointer<Utf8> prompt,
+    Pointer<RacLlmOptions> options,
+    int choice,
+    Pointer<NativeFunction<RacAsyncListenerC>> listener,
+    Pointer<Void> userData,
+    Pointer<Pointer<Void>> outStream);
+
+// rac_metrics_snapshot_json
+typedef RacMetricsSnapshotJsonC = Int32 Function(Pointer<Pointer<Utf8>> outJson);
+typedef RacMetricsSnapshotJsonDart = int Function(Pointer<Pointer<Utf8>> outJson);
+
+// rac_metrics_reset
+typedef RacMetricsResetC = Void Function();
+typedef RacMetricsResetDart = void Function();
+
+// rac_free
+typedef RacFreeC = Void Function(Pointer<Void> ptr);
+typedef RacFreeDart = void Function(Pointer<Void> ptr);
+
 // =============================================================================
 // BINDINGS CLASS
 // =============================================================================
@@ -115,7 +397,8 @@ class RacBindings {
     if (_lib != null) return _lib!;
     
     if (Platform.isAndroid) {
-      _lib = DynamicLibrary.open('librac_commons.so');
+      // rac_commons is linked into the app's FFI library (one llama.cpp/ggml)
+      _lib = DynamicLibrary.open('libai_chat.so');
     } else if (Platform.isIOS || Platform.isMacOS) {
       _lib = DynamicLibrary.process();
     } else {
@@ -143,6 +426,63 @@ class RacBindings {
   late final RacLlmResultFreeDart racLlmResultFree = lib
       .lookupFunction<RacLlmResultFreeC, RacLlmResultFreeDart>('rac_llm_result_free');
 
+  late final RacLlmComponentGenerateAsyncDart racLlmComponentGenerateAsync = lib
+      .lookupFunction<RacLlmComponentGenerateAsyncC, RacLlmComponentGenerateAsyncDart>('rac_llm_component_generate_async');
+
+  late final RacSttComponentTranscribeAsyncDart racSttComponentTranscribeAsync = lib
+      .lookupFunction<RacSttComponentTranscribeAsyncC, RacSttComponentTranscribeAsyncDart>('rac_stt_component_transcribe_async');
+
+  late final RacTtsComponentSynthesizeAsyncDart racTtsComponentSynthesizeAsync = lib
+      .lookupFunction<RacTtsComponentSynthesizeAsyncC, RacTtsComponentSynthesizeAsyncDart>('rac_tts_component_synthesize_async');
+
+  late final RacAsyncStreamDart racAsyncStreamCancel = lib
+      .lookupFunction<RacAsyncStreamC, RacAsyncStreamDart>('rac_async_stream_cancel');
+
+  late final RacAsyncStreamDart racAsyncStreamRelease = lib
+      .lookupFunction<RacAsyncStreamC, RacAsyncStreamDart>('rac_async_stream_release');
+
+  late final RacAsyncEventFreeDart racAsyncEventFree = lib
+      .lookupFunction<RacAsyncEventFreeC, RacAsyncEventFreeDart>('rac_async_event_free');
+
+  late final RacLlmComponentStateDart racLlmComponentSaveState = lib
+      .lookupFunction<RacLlmComponentStateC, RacLlmComponentStateDart>('rac_llm_component_save_state');
+
+  late final RacLlmComponentStateDart racLlmComponentRestoreState = lib
+      .lookupFunction<RacLlmComponentStateC, RacLlmComponentStateDart>('rac_llm_component_restore_state');
+
+  late final RacLlmComponentLoadLoraDart racLlmComponentLoadLora = lib
+      .lookupFunction<RacLlmComponentLoadLoraC, RacLlmComponentLoadLoraDart>('rac_llm_component_load_lora');
+
+  late final RacLlmComponentRemoveLoraDart racLlmComponentRemoveLora = lib
+      .lookupFunction<RacLlmComponentRemoveLoraC, RacLlmComponentRemoveLoraDart>('rac_llm_component_remove_lora');
+
+  late final RacLlmComponentSetLoraDart racLlmComponentSetLora = lib
+      .lookupFunction<RacLlmComponentSetLoraC, RacLlmComponentSetLoraDart>('rac_llm_component_set_lora');
+
+  late final RacLlmComponentGenerateSamplesDart racLlmComponentGenerateSamples = lib
+      .lookupFunction<RacLlmComponentGenerateSamplesC, RacLlmComponentGenerateSamplesDart>('rac_llm_component_generate_samples');
+
+  late final RacLlmSamplesFreeDart racLlmSamplesFree = lib
+      .lookupFunction<RacLlmSamplesFreeC, RacLlmSamplesFreeDart>('rac_llm_samples_free');
+
+  late final RacLlmToolsetCreateDart racLlmToolsetCreate = lib
+      .lookupFunction<RacLlmToolsetCreateC, RacLlmToolsetCreateDart>('rac_llm_toolset_create');
+
+  late final RacLlmToolsetDestroyDart racLlmToolsetDestroy = lib
+      .lookupFunction<RacLlmToolsetDestroyC, RacLlmToolsetDestroyDart>('rac_llm_toolset_destroy');
+
+  late final RacLlmComponentGenerateWithToolsAsyncDart racLlmComponentGenerateWithToolsAsync = lib
+      .lookupFunction<RacLlmComponentGenerateWithToolsAsyncC, RacLlmComponentGenerateWithToolsAsyncDart>('rac_llm_component_generate_with_tools_async');
+
+  late final RacMetricsSnapshotJsonDart racMetricsSnapshotJson = lib
+      .lookupFunction<RacMetricsSnapshotJsonC, RacMetricsSnapshotJsonDart>('rac_metrics_snapshot_json');
+
+  late final RacMetricsResetDart racMetricsReset = lib
+      .lookupFunction<RacMetricsResetC, RacMetricsResetDart>('rac_metrics_reset');
+
+  late final RacFreeDart racFree = lib
+      .lookupFunction<RacFreeC, RacFreeDart>('rac_free');
+
   // Singleton
   static final RacBindings _instance = RacBindings._internal();
   factory RacBindings() => _instance;
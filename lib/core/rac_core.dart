@@ -37,4 +37,22 @@ class RacCore {
     _initialized = true;
     print("RAC SDK Initialized");
   }
+
+  /// Snapshot of the native metrics registry as JSON (counters, gauges and
+  /// histogram percentiles), or null if it could not be read.
+  static String? metricsSnapshotJson() {
+    final out = calloc<Pointer<Utf8>>();
+    try {
+      if (_bindings.racMetricsSnapshotJson(out) != 0 || out.value == nullptr) {
+        return null;
+      }
+      final json = out.value.toDartString();
+      _bindings.racFree(out.value.cast());
+      return json;
+    } finally {
+      calloc.free(out);
+    }
+  }
+
+  static void resetMetrics() => _bindings.racMetricsReset();
 }
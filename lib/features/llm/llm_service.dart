@@ -1,7 +1,28 @@
+import 'dart:async';
+import 'dart:convert';
 import 'dart:ffi';
+import 'dart:typed_data';
 import 'package:ffi/ffi.dart';
 import '../../bindings/rac_bindings.dart';
 
+/// Raw pixels for a vision model, as the platform hands them over. Native
+/// kernels convert and resize them; nothing is processed in Dart.
+class LlmImage {
+  static const int rgb8 = 0;
+  static const int rgba8 = 1;
+  static const int bgra8 = 2;
+
+  final Uint8List pixels;
+  final int width;
+  final int height;
+  /// Bytes per row, 0 if rows are tightly packed
+  final int stride;
+  final int format;
+
+  const LlmImage(this.pixels, this.width, this.height,
+      {this.stride = 0, this.format = rgba8});
+}
+
 class LlmService {
   Pointer<Pointer<Void>>? _handle;
 
@@ -52,7 +73,36 @@ class LlmService {
     }
   }
 
-  Future<String> generate(String prompt) async {
+  // Copies images into native memory and points the options at them;
+  // returns the allocations for _freeImages
+  List<Pointer<NativeType>> _setImages(
+      Pointer<RacLlmOptions> options, List<LlmImage> images) {
+    if (images.isEmpty) return const [];
+    final array = calloc<RacImage>(images.length);
+    final allocations = <Pointer<NativeType>>[array];
+    for (var i = 0; i < images.length; i++) {
+      final image = images[i];
+      final data = calloc<Uint8>(image.pixels.length);
+      data.asTypedList(image.pixels.length).setAll(0, image.pixels);
+      allocations.add(data);
+      array[i].data = data;
+      array[i].width = image.width;
+      array[i].height = image.height;
+      array[i].stride = image.stride;
+      array[i].format = image.format;
+    }
+    options.ref.images = array;
+    options.ref.num_images = images.length;
+    return allocations;
+  }
+
+  void _freeImages(List<Pointer<NativeType>> allocations) {
+    for (final allocation in allocations) {
+      calloc.free(allocation);
+    }
+  }
+
+  Future<String> generate(String prompt, {List<LlmImage> images = const []}) async {
     if (!isLoaded) throw Exception("LLM component not loaded");
 
     final bindings = RacBindings();
@@ -67,6 +117,7 @@ class LlmService {
     options.ref.stop_sequences = nullptr;
     options.ref.num_stop_sequences = 0;
     options.ref.system_prompt = nullptr;
+    final imageAllocations = _setImages(options, images);
 
     // Result struct
     final result = calloc<RacLlmResult>();
@@ -94,6 +145,100 @@ class LlmService {
       calloc.free(promptPtr);
       calloc.free(options);
       calloc.free(result);
+      _freeImages(imageAllocations);
+    }
+  }
+
+  /// Streams generated text as it is produced. Generation runs on a native
+  /// worker and posts each token to this isolate, so a busy event loop only
+  /// delays delivery. Cancelling the subscription stops generation.
+  Stream<String> generateStream(String prompt,
+      {int maxTokens = 256, List<LlmImage> images = const []}) {
+    if (!isLoaded) throw Exception("LLM component not loaded");
+
+    final bindings = RacBindings();
+    final controller = StreamController<String>();
+    // Tokens can split a multi-byte character, so decode across events
+    final text = const Utf8Decoder(allowMalformed: true)
+        .startChunkedConversion(_TokenSink(controller));
+    Pointer<Void> stream = nullptr;
+    var done = false;
+    late final NativeCallable<RacAsyncListenerC> listener;
+
+    void finish() {
+      done = true;
+      listener.close();
+      bindings.racAsyncStreamRelease(stream);
+    }
+
+    listener = NativeCallable<RacAsyncListenerC>.listener(
+        (Pointer<RacAsyncEvent> event, Pointer<Void> _) {
+      final type = event.ref.type;
+      if (type == racAsyncEventToken) {
+        final token = event.ref.text;
+        text.add(token.cast<Uint8>().asTypedList(token.length));
+        bindings.racAsyncEventFree(event);
+        return;
+      }
+
+      final errorCode = event.ref.error_code;
+      final message = type == racAsyncEventError ? event.ref.text.toDartString() : '';
+      bindings.racAsyncEventFree(event);
+      finish();
+      if (type == racAsyncEventError && errorCode != racErrorCancelled) {
+        controller.addError(Exception("Generation failed: $message ($errorCode)"));
+      }
+      text.close();
+    });
+
+    final promptPtr = prompt.toNativeUtf8();
+    final outStream = calloc<Pointer<Void>>();
+    final options = calloc<RacLlmOptions>();
+    options.ref.max_tokens = maxTokens;
+    options.ref.temperature = 0.7;
+    options.ref.top_p = 0.9;
+    options.ref.streaming_enabled = 1;
+    final imageAllocations = _setImages(options, images);
+
+    try {
+      // Inputs are copied natively, so they can be freed right away
+      final status = bindings.racLlmComponentGenerateAsync(
+        _handle!.value,
+        promptPtr,
+        options,
+        listener.nativeFunction,
+        nullptr,
+        outStream,
+      );
+      if (status != 0) {
+        listener.close();
+        throw Exception("Generation failed with status: $status");
+      }
+      stream = outStream.value;
+    } finally {
+      calloc.free(promptPtr);
+      calloc.free(outStream);
+      calloc.free(options);
+      _freeImages(imageAllocations);
     }
+
+    controller.onCancel = () {
+      if (!done) bindings.racAsyncStreamCancel(stream);
+    };
+    return controller.stream;
   }
 }
+
+class _TokenSink implements Sink<String> {
+  _TokenSink(this._controller);
+
+  final StreamController<String> _controller;
+
+  @override
+  void add(String data) {
+    if (data.isNotEmpty && !_controller.isClosed) _controller.add(data);
+  }
+
+  @override
+  void close() => _controller.close();
+}
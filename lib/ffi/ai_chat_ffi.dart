@@ -1,3 +1,4 @@
+import 'dart:convert';
 import 'dart:ffi' as ffi;
 import 'dart:io';
 import 'package:ffi/ffi.dart';
@@ -8,29 +9,80 @@ import 'package:ffi/ffi.dart';
 
 // Native function signatures
 typedef InitFFINative = ffi.Void Function(ffi.Pointer<Utf8>);
+typedef SetStateCacheDirFFINative = ffi.Void Function(ffi.Pointer<Utf8>);
 typedef LoadModelFFINative = ffi.Int32 Function(ffi.Pointer<Utf8>);
 typedef PrepareSessionFFINative = ffi.Int32 Function();
+typedef SetContextPolicyFFINative = ffi.Void Function(ffi.Int32, ffi.Int32);
+typedef SetSamplerFFINative = ffi.Int32 Function(ffi.Int32, ffi.Float, ffi.Float, ffi.Float,
+    ffi.Int32, ffi.Float, ffi.Float, ffi.Float, ffi.Pointer<Utf8>);
+typedef CreateSessionFFINative = ffi.Int32 Function();
+typedef SetActiveSessionFFINative = ffi.Int32 Function(ffi.Int32);
+typedef DestroySessionFFINative = ffi.Void Function(ffi.Int32);
 typedef ProcessSystemPromptFFINative = ffi.Int32 Function(ffi.Pointer<Utf8>);
 typedef ProcessUserPromptFFINative = ffi.Int32 Function(ffi.Pointer<Utf8>, ffi.Int32);
 typedef GenerateNextTokenFFINative = ffi.Pointer<Utf8> Function();
 typedef StopGenerationFFINative = ffi.Void Function();
+typedef TokenListenerNative = ffi.Void Function(ffi.Int32);
+typedef SetTokenListenerFFINative = ffi.Void Function(ffi.Pointer<ffi.NativeFunction<TokenListenerNative>>);
+typedef StartGenerationFFINative = ffi.Int32 Function();
+typedef SubmitUserPromptFFINative = ffi.Int32 Function(ffi.Pointer<Utf8>, ffi.Int32);
+typedef CancelGenerationFFINative = ffi.Void Function();
+typedef DrainTokensFFINative = ffi.Int32 Function(ffi.Pointer<ffi.Uint8>, ffi.Int32);
 typedef ResetConversationFFINative = ffi.Void Function();
 typedef UnloadFFINative = ffi.Void Function();
 typedef ShutdownFFINative = ffi.Void Function();
 typedef GetSystemInfoFFINative = ffi.Pointer<Utf8> Function();
+typedef GetKvCacheStatsFFINative = ffi.Void Function(
+    ffi.Pointer<ffi.Float>, ffi.Pointer<ffi.Int32>, ffi.Pointer<ffi.Double>);
 
 // Dart function signatures
 typedef InitFFIDart = void Function(ffi.Pointer<Utf8>);
+typedef SetStateCacheDirFFIDart = void Function(ffi.Pointer<Utf8>);
 typedef LoadModelFFIDart = int Function(ffi.Pointer<Utf8>);
 typedef PrepareSessionFFIDart = int Function();
+typedef SetContextPolicyFFIDart = void Function(int, int);
+typedef SetSamplerFFIDart = int Function(int, double, double, double, int, double, double, double,
+    ffi.Pointer<Utf8>);
+typedef CreateSessionFFIDart = int Function();
+typedef SetActiveSessionFFIDart = int Function(int);
+typedef DestroySessionFFIDart = void Function(int);
 typedef ProcessSystemPromptFFIDart = int Function(ffi.Pointer<Utf8>);
 typedef ProcessUserPromptFFIDart = int Function(ffi.Pointer<Utf8>, int);
 typedef GenerateNextTokenFFIDart = ffi.Pointer<Utf8> Function();
 typedef StopGenerationFFIDart = void Function();
+typedef SetTokenListenerFFIDart = void Function(ffi.Pointer<ffi.NativeFunction<TokenListenerNative>>);
+typedef StartGenerationFFIDart = int Function();
+typedef SubmitUserPromptFFIDart = int Function(ffi.Pointer<Utf8>, int);
+typedef CancelGenerationFFIDart = void Function();
+typedef DrainTokensFFIDart = int Function(ffi.Pointer<ffi.Uint8>, int);
 typedef ResetConversationFFIDart = void Function();
 typedef UnloadFFIDart = void Function();
 typedef ShutdownFFIDart = void Function();
 typedef GetSystemInfoFFIDart = ffi.Pointer<Utf8> Function();
+typedef GetKvCacheStatsFFIDart = void Function(
+    ffi.Pointer<ffi.Float>, ffi.Pointer<ffi.Int32>, ffi.Pointer<ffi.Double>);
+
+/// Events delivered by the native token stream listener
+class TokenStreamEvent {
+  static const int data = 0;
+  static const int done = 1;
+  static const int error = 2;
+  static const int cancelled = 3;
+}
+
+/// KV cache fragmentation and the idle-time compactions that repair it
+class KvCacheStats {
+  /// Share of the KV cells inside the sessions' used spans that are holes (0..1)
+  final double fragmentation;
+
+  /// Compactions run since the library was loaded
+  final int compactions;
+
+  /// Total time spent compacting, in milliseconds
+  final double compactionMs;
+
+  const KvCacheStats(this.fragmentation, this.compactions, this.compactionMs);
+}
 
 // ============================================================================
 // AIChatFFI - Main FFI Wrapper Class
@@ -42,16 +94,32 @@ class AIChatFFI {
 
   // Function pointers
   static late final InitFFIDart _initFFI;
+  static late final SetStateCacheDirFFIDart _setStateCacheDir;
   static late final LoadModelFFIDart _loadModel;
   static late final PrepareSessionFFIDart _prepareSession;
+  static late final SetContextPolicyFFIDart _setContextPolicy;
+  static late final SetSamplerFFIDart _setSampler;
+  static late final CreateSessionFFIDart _createSession;
+  static late final SetActiveSessionFFIDart _setActiveSession;
+  static late final DestroySessionFFIDart _destroySession;
   static late final ProcessSystemPromptFFIDart _processSystemPrompt;
   static late final ProcessUserPromptFFIDart _processUserPrompt;
   static late final GenerateNextTokenFFIDart _generateNextToken;
   static late final StopGenerationFFIDart _stopGeneration;
+  static late final SetTokenListenerFFIDart _setTokenListener;
+  static late final StartGenerationFFIDart _startGeneration;
+  static late final SubmitUserPromptFFIDart _submitUserPrompt;
+  static late final CancelGenerationFFIDart _cancelGeneration;
+  static late final DrainTokensFFIDart _drainTokens;
+
+  static const int _drainBufferSize = 16 * 1024;
+  static ffi.Pointer<ffi.Uint8>? _drainBuffer;
+  static ffi.NativeCallable<TokenListenerNative>? _tokenListener;
   static late final ResetConversationFFIDart _resetConversation;
   static late final UnloadFFIDart _unload;
   static late final ShutdownFFIDart _shutdown;
   static late final GetSystemInfoFFIDart _getSystemInfo;
+  static late final GetKvCacheStatsFFIDart _getKvCacheStats;
 
   /// Initialize FFI library
   static void initialize() {
@@ -68,16 +136,28 @@ class AIChatFFI {
 
     // Lookup functions
     _initFFI = _lib!.lookupFunction<InitFFINative, InitFFIDart>('init_ffi');
+    _setStateCacheDir = _lib!.lookupFunction<SetStateCacheDirFFINative, SetStateCacheDirFFIDart>('set_state_cache_dir_ffi');
     _loadModel = _lib!.lookupFunction<LoadModelFFINative, LoadModelFFIDart>('load_model_ffi');
     _prepareSession = _lib!.lookupFunction<PrepareSessionFFINative, PrepareSessionFFIDart>('prepare_session_ffi');
+    _setContextPolicy = _lib!.lookupFunction<SetContextPolicyFFINative, SetContextPolicyFFIDart>('set_context_policy_ffi');
+    _setSampler = _lib!.lookupFunction<SetSamplerFFINative, SetSamplerFFIDart>('set_sampler_ffi');
+    _createSession = _lib!.lookupFunction<CreateSessionFFINative, CreateSessionFFIDart>('create_session_ffi');
+    _setActiveSession = _lib!.lookupFunction<SetActiveSessionFFINative, SetActiveSessionFFIDart>('set_active_session_ffi');
+    _destroySession = _lib!.lookupFunction<DestroySessionFFINative, DestroySessionFFIDart>('destroy_session_ffi');
     _processSystemPrompt = _lib!.lookupFunction<ProcessSystemPromptFFINative, ProcessSystemPromptFFIDart>('process_system_prompt_ffi');
     _processUserPrompt = _lib!.lookupFunction<ProcessUserPromptFFINative, ProcessUserPromptFFIDart>('process_user_prompt_ffi');
     _generateNextToken = _lib!.lookupFunction<GenerateNextTokenFFINative, GenerateNextTokenFFIDart>('generate_next_token_ffi');
+    _setTokenListener = _lib!.lookupFunction<SetTokenListenerFFINative, SetTokenListenerFFIDart>('set_token_listener_ffi');
+    _startGeneration = _lib!.lookupFunction<StartGenerationFFINative, StartGenerationFFIDart>('start_generation_ffi');
+    _submitUserPrompt = _lib!.lookupFunction<SubmitUserPromptFFINative, SubmitUserPromptFFIDart>('submit_user_prompt_ffi');
+    _cancelGeneration = _lib!.lookupFunction<CancelGenerationFFINative, CancelGenerationFFIDart>('cancel_generation_ffi');
+    _drainTokens = _lib!.lookupFunction<DrainTokensFFINative, DrainTokensFFIDart>('drain_tokens_ffi');
     _stopGeneration = _lib!.lookupFunction<StopGenerationFFINative, StopGenerationFFIDart>('stop_generation_ffi');
     _resetConversation = _lib!.lookupFunction<ResetConversationFFINative, ResetConversationFFIDart>('reset_conversation_ffi');
     _unload = _lib!.lookupFunction<UnloadFFINative, UnloadFFIDart>('unload_ffi');
     _shutdown = _lib!.lookupFunction<ShutdownFFINative, ShutdownFFIDart>('shutdown_ffi');
     _getSystemInfo = _lib!.lookupFunction<GetSystemInfoFFINative, GetSystemInfoFFIDart>('get_system_info_ffi');
+    _getKvCacheStats = _lib!.lookupFunction<GetKvCacheStatsFFINative, GetKvCacheStatsFFIDart>('get_kv_cache_stats_ffi');
 
     _initialized = true;
   }
@@ -92,6 +172,16 @@ class AIChatFFI {
     }
   }
 
+  /// Set directory for persisted system-prompt KV snapshots (empty disables)
+  static void setStateCacheDir(String cacheDir) {
+    final dirPtr = cacheDir.toNativeUtf8();
+    try {
+      _setStateCacheDir(dirPtr);
+    } finally {
+      malloc.free(dirPtr);
+    }
+  }
+
   /// Load GGUF model from path
   static int loadModel(String modelPath) {
     final pathPtr = modelPath.toNativeUtf8();
@@ -107,6 +197,53 @@ class AIChatFFI {
     return _prepareSession();
   }
 
+  /// Configure context sliding: [sinkTokens] leading tokens are never evicted,
+  /// and the oldest history is dropped [evictChunk] tokens at a time.
+  static void setContextPolicy({int sinkTokens = 4, int evictChunk = 16}) {
+    _setContextPolicy(sinkTokens, evictChunk);
+  }
+
+  /// Rebuild the active session's sampler chain; new sessions inherit it.
+  /// A GBNF [grammar] constrains output at decode time (e.g. tool-call JSON),
+  /// `null` leaves it free-form. [temperature] <= 0 selects greedy decoding.
+  /// Returns false if the grammar fails to parse.
+  static bool setSampler({
+    int topK = 40,
+    double topP = 0.95,
+    double minP = 0.0,
+    double temperature = 0.7,
+    int penaltyLastN = 64,
+    double repeatPenalty = 1.0,
+    double frequencyPenalty = 0.0,
+    double presencePenalty = 0.0,
+    String? grammar,
+  }) {
+    final grammarPtr = grammar != null ? grammar.toNativeUtf8() : ffi.nullptr.cast<Utf8>();
+    try {
+      return _setSampler(topK, topP, minP, temperature, penaltyLastN, repeatPenalty,
+              frequencyPenalty, presencePenalty, grammarPtr) ==
+          0;
+    } finally {
+      if (grammar != null) malloc.free(grammarPtr);
+    }
+  }
+
+  /// Create a new conversation session sharing the loaded model.
+  /// Returns the session id, or -1 if no session slot is free.
+  static int createSession() {
+    return _createSession();
+  }
+
+  /// Make [sessionId] the target of prompt and generation calls
+  static int setActiveSession(int sessionId) {
+    return _setActiveSession(sessionId);
+  }
+
+  /// Destroy a session and drop its KV cache
+  static void destroySession(int sessionId) {
+    _destroySession(sessionId);
+  }
+
   /// Process system prompt
   static int processSystemPrompt(String prompt) {
     final promptPtr = prompt.toNativeUtf8();
@@ -138,6 +275,48 @@ class AIChatFFI {
     return token.isEmpty ? '' : token; // Return empty string for continuation
   }
 
+  /// Register [onEvent] for native token stream events (see [TokenStreamEvent]).
+  /// Events arrive asynchronously on the calling isolate's event loop.
+  static void setTokenListener(void Function(int event) onEvent) {
+    _tokenListener?.close();
+    _tokenListener = ffi.NativeCallable<TokenListenerNative>.listener(onEvent);
+    _setTokenListener(_tokenListener!.nativeFunction);
+  }
+
+  /// Start generating on a native thread; text is streamed through the token ring
+  static int startGeneration() {
+    return _startGeneration();
+  }
+
+  /// Queue prefill and generation of a user turn on the native worker.
+  /// Returns immediately; output arrives through the token listener.
+  static int submitUserPrompt(String prompt, {int maxTokens = 512}) {
+    final promptPtr = prompt.toNativeUtf8();
+    try {
+      return _submitUserPrompt(promptPtr, maxTokens);
+    } finally {
+      malloc.free(promptPtr);
+    }
+  }
+
+  /// Abort the current turn (even mid-prefill) and discard it from the context
+  static void cancelGeneration() {
+    _cancelGeneration();
+  }
+
+  /// Drain all text currently buffered by the native generation thread
+  static String drainTokens() {
+    final buffer = _drainBuffer ??= malloc<ffi.Uint8>(_drainBufferSize);
+    final out = StringBuffer();
+    while (true) {
+      final n = _drainTokens(buffer, _drainBufferSize);
+      if (n <= 0) break;
+      out.write(utf8.decode(buffer.asTypedList(n), allowMalformed: true));
+      if (n < _drainBufferSize) break;
+    }
+    return out.toString();
+  }
+
   /// Stop current generation
   static void stopGeneration() {
     _stopGeneration();
@@ -151,6 +330,13 @@ class AIChatFFI {
   /// Unload model and free resources
   static void unload() {
     _unload();
+    _setTokenListener(ffi.nullptr);
+    _tokenListener?.close();
+    _tokenListener = null;
+    if (_drainBuffer != null) {
+      malloc.free(_drainBuffer!);
+      _drainBuffer = null;
+    }
   }
 
   /// Shutdown backend completely
@@ -163,4 +349,19 @@ class AIChatFFI {
     final infoPtr = _getSystemInfo();
     return infoPtr.toDartString();
   }
+
+  /// KV cache fragmentation and compaction totals; safe to poll while generating
+  static KvCacheStats getKvCacheStats() {
+    final fragmentation = malloc<ffi.Float>();
+    final compactions = malloc<ffi.Int32>();
+    final compactionMs = malloc<ffi.Double>();
+    try {
+      _getKvCacheStats(fragmentation, compactions, compactionMs);
+      return KvCacheStats(fragmentation.value, compactions.value, compactionMs.value);
+    } finally {
+      malloc.free(fragmentation);
+      malloc.free(compactions);
+      malloc.free(compactionMs);
+    }
+  }
 }
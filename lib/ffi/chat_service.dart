@@ -2,6 +2,7 @@ import 'dart:async';
 import 'dart:io';
 import 'dart:isolate';
 import 'package:flutter/services.dart';
+import 'package:path_provider/path_provider.dart';
 import 'ai_chat_ffi.dart';
 import 'chat_message.dart';
 
@@ -11,8 +12,13 @@ enum ChatCommand {
   loadModel,
   setSystemPrompt,
   processUserPrompt,
+  setSampler,
   generateNextToken,
+  createSession,
+  switchSession,
+  destroySession,
   stopGeneration,
+  cancelGeneration,
   resetConversation,
   getSystemInfo,
   dispose
@@ -70,8 +76,12 @@ class ChatService {
     
     _receivePort!.listen(_handleIsolateMessage);
     
+    // KV snapshots live in app support storage so they survive restarts
+    final cacheDir = Directory('${(await getApplicationSupportDirectory()).path}/kv_cache');
+    await cacheDir.create(recursive: true);
+
     // Send initialize command
-    await _sendCommand(ChatCommand.initialize, null);
+    await _sendCommand(ChatCommand.initialize, cacheDir.path);
 
     _isInitialized = true;
     print('[ChatService] Service initialized');
@@ -231,6 +241,40 @@ class ChatService {
     print('[ChatService] Generation complete');
   }
 
+  /// Configure sampling for the active session. Pass a GBNF [grammar] before a
+  /// tool-call turn to force well-formed output, and `null` to lift it again.
+  Future<bool> setSampler({
+    double temperature = 0.7,
+    double repeatPenalty = 1.0,
+    String? grammar,
+  }) async {
+    if (!_modelLoaded || _isGenerating) return false;
+    return await _sendCommand(ChatCommand.setSampler, {
+      'temperature': temperature,
+      'repeatPenalty': repeatPenalty,
+      'grammar': grammar,
+    }) as bool;
+  }
+
+  /// Create a session that keeps its own KV cache on the shared model.
+  /// Returns the session id, or -1 if all session slots are in use.
+  Future<int> createSession() async {
+    if (!_modelLoaded) return -1;
+    return await _sendCommand(ChatCommand.createSession, null) as int;
+  }
+
+  /// Switch prompts and generation to another session without re-prefilling it
+  Future<bool> switchSession(int sessionId) async {
+    if (!_modelLoaded || _isGenerating) return false;
+    return await _sendCommand(ChatCommand.switchSession, sessionId) as bool;
+  }
+
+  /// Destroy a session and free its KV cache
+  Future<void> destroySession(int sessionId) async {
+    if (!_modelLoaded) return;
+    await _sendCommand(ChatCommand.destroySession, sessionId);
+  }
+
   /// Stop current generation
   void stopGeneration() {
     if (!_isGenerating) return;
@@ -239,6 +283,14 @@ class ChatService {
     _isGenerating = false;
   }
 
+  /// Cancel current generation and drop the unfinished turn from the context
+  void cancelGeneration() {
+    if (!_isGenerating) return;
+    print('[ChatService] Cancelling generation');
+    _sendPort!.send({'command': ChatCommand.cancelGeneration});
+    _isGenerating = false;
+  }
+
   /// Reset conversation
   void resetConversation() {
     print('[ChatService] Resetting conversation');
@@ -320,6 +372,10 @@ void _isolateLoop(ReceivePort commandPort, SendPort responsePort) {
         case ChatCommand.initialize:
           AIChatFFI.initialize();
           AIChatFFI.initBackend();
+          if (args is String) {
+            AIChatFFI.setStateCacheDir(args);
+          }
+          _registerTokenListener(responsePort);
           responsePort.send({'type': 'response', 'data': true});
           break;
           
@@ -345,15 +401,42 @@ void _isolateLoop(ReceivePort commandPort, SendPort responsePort) {
           final prompt = args['prompt'] as String;
           final maxTokens = args['maxTokens'] as int;
           
-          final result = AIChatFFI.processUserPrompt(prompt, maxTokens: maxTokens);
+          // Prefill and decode both run on the native worker thread
+          final result = AIChatFFI.submitUserPrompt(prompt, maxTokens: maxTokens);
           if (result != 0) {
             responsePort.send({'type': 'error', 'data': 'Process prompt failed $result'});
-          } else {
-            // Start generation loop inside isolate
-            _generateTokensLoop(responsePort);
+            responsePort.send({'type': 'generation_done'});
           }
           break;
           
+        case ChatCommand.createSession:
+          responsePort.send({'type': 'response', 'data': AIChatFFI.createSession()});
+          break;
+
+        case ChatCommand.setSampler:
+          final spec = args as Map<String, dynamic>;
+          final ok = AIChatFFI.setSampler(
+            temperature: spec['temperature'] as double,
+            repeatPenalty: spec['repeatPenalty'] as double,
+            grammar: spec['grammar'] as String?,
+          );
+          responsePort.send({'type': 'response', 'data': ok});
+          break;
+
+        case ChatCommand.switchSession:
+          final result = AIChatFFI.setActiveSession(args as int);
+          responsePort.send({'type': 'response', 'data': result == 0});
+          break;
+
+        case ChatCommand.destroySession:
+          AIChatFFI.destroySession(args as int);
+          responsePort.send({'type': 'response', 'data': null});
+          break;
+
+        case ChatCommand.cancelGeneration:
+          AIChatFFI.cancelGeneration();
+          break;
+
         case ChatCommand.stopGeneration:
           AIChatFFI.stopGeneration();
           // The loop breaks automatically? No, we check condition in loop.
@@ -384,69 +467,20 @@ void _isolateLoop(ReceivePort commandPort, SendPort responsePort) {
   });
 }
 
-// Helper to run the generation loop synchronously in the isolate
-void _generateTokensLoop(SendPort responsePort) {
-  while (true) {
-    // We can add a check for stop flag? 
-    // AIChatFFI.generateNextToken() returns null when done or stopped.
-    // If stopGeneration was called, the C++ state 'stop_generation_position' or internal flag might be set?
-    // In current ai_chat.cpp: stop_generation_ffi resets short term states.
-    // generate_next_token_ffi checks stop_generation_position. 
-    // So if we call stopGeneration from another event?
-    // Wait. Isolates are single threaded event loops.
-    // If we are in this while(true) loop, we CANNOT process the 'stopGeneration' message from the port!
-    // THIS IS A PROBLEM.
-    // We need to yield to the event loop or check the port?
-    // Dart isolates don't support checking port synchronously easily without blocking?
-    // Actually, we can use `Future.delayed(Duration.zero)` to yield, but that makes it async.
-    // Better: generate one token, send it, then schedule next generation as a microtask or just async loop.
-    
-    // BUT we want blocking speed if possible? No, async is fine for 20-30 tokens/sec.
-    
-    // Changing to async loop allows processing "stop" command in between.
-    
-    // However, for this simple implementation, let's just loop with a small yield.
-    // But yield won't help if we are in a tight loop unless we return to event loop.
-    
-    // Let's make this _generateTokensLoop NOT a loop, but a recursive future or loop with await.
-    // But we are inside the message handler...
-    // We should NOT block the message handler.
-    
-    // We can spawn a separate runner? No.
-    // We just return from the handler, but kick off an async operation.
-    
-    _generateNextTokenAsync(responsePort);
-    break;
-  }
-}
-
-Future<void> _generateNextTokenAsync(SendPort responsePort) async {
-  // Generate one token
-  final token = AIChatFFI.generateNextToken();
-  
-  if (token == null) {
-    responsePort.send({'type': 'generation_done'});
-    return;
-  }
-  
-  if (token.isNotEmpty) {
-    responsePort.send({'type': 'token', 'data': token});
-  }
-  
-  // Yield to allow processing other events (like Stop)
-  await Future.delayed(Duration.zero);
-  
-  // Recursively call for next (or loop)
-  // Check if we should stop?
-  // C++ side handles stop logic via `stop_generation_ffi` which resets state, so `generateNextToken` will return null or empty? 
-  // Let's verify ai_chat.cpp. 
-  // `stop_generation_ffi` calls `reset_short_term_states`. 
-  // `reset_short_term_states` sets `stop_generation_position = 0`.
-  // `generate_next_token_ffi` checks `current_position >= stop_generation_position`.
-  // If we reset to 0, and current is > 0, it returns nullptr.
-  // So yes, calling stopGeneration works, IF the command is processed.
-  // By using `await Future.delayed(Duration.zero)`, we allow the Isolate event loop to process the 'stopGeneration' command message.
-  
-  _generateNextTokenAsync(responsePort);
+// Tokens are produced on a native thread. The listener only fires when new
+// text is buffered (or generation ends), so the isolate stays idle between
+// batches and can process stop commands immediately.
+void _registerTokenListener(SendPort responsePort) {
+  AIChatFFI.setTokenListener((event) {
+    final text = AIChatFFI.drainTokens();
+    if (text.isNotEmpty) {
+      responsePort.send({'type': 'token', 'data': text});
+    }
+    if (event == TokenStreamEvent.error) {
+      responsePort.send({'type': 'error', 'data': 'Generation failed'});
+    }
+    if (event != TokenStreamEvent.data) {
+      responsePort.send({'type': 'generation_done'});
+    }
+  });
 }
-